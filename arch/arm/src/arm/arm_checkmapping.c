@@ -106,4 +106,31 @@ bool up_checkmapping(struct tcb_s *tcb)
   return (*pte != 0);
 }
 
+/****************************************************************************
+ * Name: up_readahead()
+ *
+ * Description:
+ *  Set up the fault address of ratcb to the page following the fault
+ *  address of tcb.  See include/nuttx/page.h.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_READAHEAD > 0
+bool up_readahead(struct tcb_s *tcb, struct tcb_s *ratcb)
+{
+  uintptr_t vaddr;
+
+  DEBUGASSERT(tcb && ratcb);
+
+  vaddr = (tcb->xcp.far & ~PAGEMASK) + PAGESIZE;
+  if (vaddr < PG_PAGED_VBASE || vaddr >= PG_PAGED_VEND)
+    {
+      return false;
+    }
+
+  ratcb->xcp.far = vaddr;
+  return true;
+}
+#endif
+
 #endif /* CONFIG_LEGACY_PAGING */
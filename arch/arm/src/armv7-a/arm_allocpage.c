@@ -165,7 +165,7 @@ int arm_allocpage(struct tcb_s *tcb, void **vpage)
    */
 
   pgndx = g_pgndx++;
-  if (g_pgndx >= CONFIG_LEGACY_PAGING)
+  if (g_pgndx >= CONFIG_PAGING_NPPAGED)
     {
       g_pgndx  = 0;
       g_pgwrap = true;
@@ -42,6 +42,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/cache.h>
+#include <sys/uio.h>
 #include <arch/barriers.h>
 
 #include "arm_internal.h"
@@ -191,6 +192,60 @@ static size_t up_get_cache_size(bool icache)
 }
 #endif
 
+/****************************************************************************
+ * Name: arm_invalidate_dcache_lines
+ *
+ * Description:
+ *   Invalidate the D-Cache lines of a region without any barrier.  The
+ *   partial lines at both ends are cleaned first, so that the data next to
+ *   the region is not lost.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+static void arm_invalidate_dcache_lines(uintptr_t start, uintptr_t end,
+                                        uint32_t ssize)
+{
+  if ((start & (ssize - 1)) != 0)
+    {
+      start &= ~(ssize - 1);
+      putreg32(start, NVIC_DCCIMVAC);
+      start += ssize;
+    }
+
+  while (start + ssize <= end)
+    {
+      putreg32(start, NVIC_DCIMVAC);
+      start += ssize;
+    }
+
+  if (start < end)
+    {
+      putreg32(start, NVIC_DCCIMVAC);
+    }
+}
+
+/****************************************************************************
+ * Name: arm_dcache_lines
+ *
+ * Description:
+ *   Apply a by-address cache maintenance operation to each D-Cache line of
+ *   a region without any barrier.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+static void arm_dcache_lines(uintptr_t start, uintptr_t end,
+                             uint32_t ssize, uint32_t regaddr)
+{
+  for (start &= ~(ssize - 1); start < end; start += ssize)
+    {
+      putreg32(start, regaddr);
+    }
+}
+#endif
+#endif /* CONFIG_ARMV7M_DCACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1101,3 +1156,116 @@ void up_coherent_dcache(uintptr_t addr, size_t len)
     }
 }
 #endif
+
+/****************************************************************************
+ * Name: up_invalidate_dcache_iov
+ *
+ * Description:
+ *   Invalidate the data cache over a list of buffers with a single pair of
+ *   barriers around the whole list.
+ *
+ * Input Parameters:
+ *   iov    - The buffers
+ *   iovcnt - The number of buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+void up_invalidate_dcache_iov(const struct iovec *iov, int iovcnt)
+{
+  uint32_t ssize = up_get_dcache_linesize();
+  uintptr_t start;
+  int i;
+
+  UP_DSB();
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      start = (uintptr_t)iov[i].iov_base;
+      arm_invalidate_dcache_lines(start, start + iov[i].iov_len, ssize);
+    }
+
+  UP_MB();
+}
+#endif /* CONFIG_ARMV7M_DCACHE */
+
+/****************************************************************************
+ * Name: up_clean_dcache_iov
+ *
+ * Description:
+ *   Clean the data cache over a list of buffers with a single pair of
+ *   barriers around the whole list.
+ *
+ * Input Parameters:
+ *   iov    - The buffers
+ *   iovcnt - The number of buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+void up_clean_dcache_iov(const struct iovec *iov, int iovcnt)
+{
+#ifndef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+  uint32_t ssize = up_get_dcache_linesize();
+  uintptr_t start;
+  int i;
+
+  UP_DSB();
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      start = (uintptr_t)iov[i].iov_base;
+      arm_dcache_lines(start, start + iov[i].iov_len, ssize,
+                       NVIC_DCCMVAC);
+    }
+#endif /* !CONFIG_ARMV7M_DCACHE_WRITETHROUGH */
+
+  UP_MB();
+}
+#endif /* CONFIG_ARMV7M_DCACHE */
+
+/****************************************************************************
+ * Name: up_flush_dcache_iov
+ *
+ * Description:
+ *   Flush the data cache over a list of buffers with a single pair of
+ *   barriers around the whole list.
+ *
+ * Input Parameters:
+ *   iov    - The buffers
+ *   iovcnt - The number of buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_DCACHE
+void up_flush_dcache_iov(const struct iovec *iov, int iovcnt)
+{
+#ifndef CONFIG_ARMV7M_DCACHE_WRITETHROUGH
+  uint32_t ssize = up_get_dcache_linesize();
+  uintptr_t start;
+  int i;
+
+  UP_DSB();
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      start = (uintptr_t)iov[i].iov_base;
+      arm_dcache_lines(start, start + iov[i].iov_len, ssize,
+                       NVIC_DCCIMVAC);
+    }
+
+  UP_MB();
+#else
+  up_invalidate_dcache_iov(iov, iovcnt);
+#endif /* !CONFIG_ARMV7M_DCACHE_WRITETHROUGH */
+}
+#endif /* CONFIG_ARMV7M_DCACHE */
@@ -53,6 +53,15 @@
 
 #endif /* CONFIG_ARCH_ADDRENV */
 
+/* With __thread support TPIDR_EL0 of each thread points right past its
+ * struct tls_info_s, so tls_get_info() needs no call into the OS.
+ */
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+#  define up_tls_info() \
+     ((struct tls_info_s *)__builtin_thread_pointer() - 1)
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -96,6 +105,12 @@ struct arch_addrenv_s
   /* The page directory root (ttbr0) value */
 
   uintptr_t ttbr0;
+
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+  /* The address space identifier, 0 if none was free */
+
+  uint16_t  asid;
+#endif
 };
 
 typedef struct arch_addrenv_s arch_addrenv_t;
@@ -67,6 +67,7 @@
 #include <nuttx/compiler.h>
 #include <nuttx/irq.h>
 #include <nuttx/pgalloc.h>
+#include <nuttx/spinlock.h>
 
 #include <arch/barriers.h>
 
@@ -92,6 +93,12 @@
 
 #define ENTRIES_PER_PGT     (MMU_PAGE_ENTRIES)
 
+/* 8-bit ASIDs (TCR_EL1.AS = 0), ASID 0 is shared by the kernel mappings
+ * and by the processes created while no other ASID was free.
+ */
+
+#define ASID_NUM            256
+
 /* Make sure the address environment virtual address boundary is valid */
 
 static_assert((ARCH_ADDRENV_VBASE & MMU_L2_PAGE_SIZE) == 0,
@@ -103,10 +110,84 @@ static_assert((ARCH_ADDRENV_VBASE & MMU_L2_PAGE_SIZE) == 0,
 
 extern uintptr_t            g_kernel_mappings;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+static uint32_t   g_asid_map[ASID_NUM / 32];
+static uint16_t   g_asid_next = 1;
+static spinlock_t g_asid_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: asid_alloc
+ *
+ * Description:
+ *   Allocate an ASID.  The search starts after the last allocation so that
+ *   a released ASID is reused as late as possible.
+ *
+ * Returned Value:
+ *   The ASID, or 0 if none is free.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+static uint16_t asid_alloc(void)
+{
+  irqstate_t flags;
+  uint16_t asid = 0;
+  uint16_t next;
+  int i;
+
+  flags = spin_lock_irqsave(&g_asid_lock);
+
+  for (i = 1, next = g_asid_next; i < ASID_NUM; i++)
+    {
+      if ((g_asid_map[next / 32] & (1u << (next % 32))) == 0)
+        {
+          g_asid_map[next / 32] |= 1u << (next % 32);
+          g_asid_next = next + 1 < ASID_NUM ? next + 1 : 1;
+          asid = next;
+          break;
+        }
+
+      next = next + 1 < ASID_NUM ? next + 1 : 1;
+    }
+
+  spin_unlock_irqrestore(&g_asid_lock, flags);
+  return asid;
+}
+
+/****************************************************************************
+ * Name: asid_free
+ *
+ * Description:
+ *   Drop the TLB entries of an ASID and release it.
+ *
+ ****************************************************************************/
+
+static void asid_free(uint16_t asid)
+{
+  irqstate_t flags;
+
+  if (asid == 0)
+    {
+      return;
+    }
+
+  mmu_invalidate_tlb_by_asid(asid);
+
+  flags = spin_lock_irqsave(&g_asid_lock);
+  g_asid_map[asid / 32] &= ~(1u << (asid % 32));
+  spin_unlock_irqrestore(&g_asid_lock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: map_spgtables
  *
@@ -513,7 +594,12 @@ int up_addrenv_create(size_t textsize, size_t datasize, size_t heapsize,
   /* Provide the ttbr0 value for context switch */
 
   l0 = mmu_get_base_pgt_level();
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+  addrenv->asid  = asid_alloc();
+  addrenv->ttbr0 = mmu_ttbr_reg(addrenv->spgtables[l0], addrenv->asid);
+#else
   addrenv->ttbr0 = mmu_ttbr_reg(addrenv->spgtables[l0], 0);
+#endif
 
   /* Synchronize data and instruction pipelines */
 
@@ -603,6 +689,12 @@ int up_addrenv_destroy(arch_addrenv_t *addrenv)
         }
     }
 
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+  /* No TLB entry of the old pages may survive into the next owner */
+
+  asid_free(addrenv->asid);
+#endif
+
   /* Synchronize data and instruction pipelines */
 
   UP_MB();
@@ -742,6 +834,20 @@ ssize_t up_addrenv_heapsize(const arch_addrenv_t *addrenv)
 int up_addrenv_select(const arch_addrenv_t *addrenv)
 {
   DEBUGASSERT(addrenv && addrenv->ttbr0);
+
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+  /* The TLB entries of the other processes are tagged with their ASIDs,
+   * only the processes sharing ASID 0 need the flush.
+   */
+
+  if (addrenv->asid != 0)
+    {
+      write_sysreg(addrenv->ttbr0, ttbr0_el1);
+      UP_ISB();
+      return OK;
+    }
+#endif
+
   mmu_write_ttbr0(addrenv->ttbr0);
   return OK;
 }
@@ -230,6 +230,7 @@ void arm64_boot_secondary_c_routine(void)
   /* Init idle task to percpu reg */
 
   up_update_task(current_task(this_cpu()));
+  arm64_tls_switch(current_task(this_cpu()));
 
   arm64_gic_secondary_init();
 
@@ -142,6 +142,7 @@ uint64_t *arm64_doirq(int irq, uint64_t * regs)
 
       *running_task = tcb;
       regs = tcb->xcp.regs;
+      arm64_tls_switch(tcb);
     }
 
   /* Clear irq flag */
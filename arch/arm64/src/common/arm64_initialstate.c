@@ -153,6 +153,7 @@ void up_initial_state(struct tcb_s *tcb)
        */
 
       write_sysreg(0, tpidrro_el0);
+      arm64_tls_switch(tcb);
 
 #ifdef CONFIG_STACK_COLORATION
 
@@ -35,6 +35,9 @@
 #  include <sys/types.h>
 #  include <stdint.h>
 #  include <syscall.h>
+#  ifdef CONFIG_SCHED_THREAD_LOCAL
+#    include <nuttx/tls.h>
+#  endif
 #endif
 
 #include "arm64_arch.h"
@@ -234,6 +237,12 @@ EXTERN uint8_t _ebss[];             /* End+1 of .bss */
 EXTERN uint8_t _szdata[];           /* Size of data(.data + .bss) */
 EXTERN uint8_t _e_initstack[];      /* End+1 of .initstack */
 EXTERN uint8_t g_idle_topstack[];   /* End+1 of heap */
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+EXTERN uint8_t _stdata[];           /* Start of .tdata */
+EXTERN uint8_t _etdata[];           /* End+1 of .tdata */
+EXTERN uint8_t _stbss[];            /* Start of .tbss */
+EXTERN uint8_t _etbss[];            /* End+1 of .tbss */
+#endif
 
 #  define _START_TEXT  _stext
 #  define _END_TEXT    _etext
@@ -242,6 +251,28 @@ EXTERN uint8_t g_idle_topstack[];   /* End+1 of heap */
 #  define _DATA_INIT   _eronly
 #  define _START_DATA  _sdata
 #  define _END_DATA    _edata
+#  define _START_TDATA _stdata
+#  define _END_TDATA   _etdata
+#  define _START_TBSS  _stbss
+#  define _END_TBSS    _etbss
+
+/* The AArch64 TLS ABI reserves two pointers at the thread pointer, ahead
+ * of the TLS block.
+ */
+
+#define ARM64_TLS_TCB_SIZE (2 * sizeof(void *))
+
+/* TPIDR_EL0 is not part of the saved context, it is derived from the TCB
+ * each time a thread is switched in.
+ */
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+#  define arm64_tls_switch(tcb) \
+     write_sysreg((uintptr_t)(tcb)->stack_alloc_ptr + \
+                  sizeof(struct tls_info_s), tpidr_el0)
+#else
+#  define arm64_tls_switch(tcb)
+#endif
 
 /****************************************************************************
  * Inline Functions
@@ -408,10 +408,16 @@ static inline uintptr_t mmu_ttbr_reg(uintptr_t pgbase, uint16_t asid)
 
 static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
 {
+  /* With ASIDs the user entries of vaddr may belong to any process */
+
   __asm__ __volatile__
     (
       "dsb ishst\n"
+#ifdef CONFIG_ARM64_ADDRENV_ASID
+      "tlbi vaale1is, %0\n"
+#else
       "tlbi vale1is, %0\n"
+#endif
       "dsb ish\n"
       "isb"
       :
@@ -420,6 +426,31 @@ static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
     );
 }
 
+/****************************************************************************
+ * Name: mmu_invalidate_tlb_by_asid
+ *
+ * Description:
+ *   Flush the TLB entries of an address space on all CPUs
+ *
+ * Input Parameters:
+ *   asid - The address space identifier
+ *
+ ****************************************************************************/
+
+static inline void mmu_invalidate_tlb_by_asid(uint16_t asid)
+{
+  __asm__ __volatile__
+    (
+      "dsb ishst\n"
+      "tlbi aside1is, %0\n"
+      "dsb ish\n"
+      "isb"
+      :
+      : "r" (TLBI_ARG(0, asid))
+      : "memory"
+    );
+}
+
 /****************************************************************************
  * Name: mmu_invalidate_tlbs
  *
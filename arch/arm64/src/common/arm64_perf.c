@@ -24,7 +24,10 @@
  * Included Files
  ****************************************************************************/
 
+#include <errno.h>
+
 #include <nuttx/clock.h>
+#include <nuttx/drivers/perf.h>
 
 #include "arm64_pmu.h"
 
@@ -37,6 +40,22 @@
 
 static unsigned long g_cpu_freq = ULONG_MAX;
 
+#ifdef CONFIG_DEV_PERF
+/* ARMv8 common architectural event numbers of the PERF_EVENT_* events,
+ * 0 if unsupported.
+ */
+
+static const uint16_t g_perf_events[PERF_EVENT_NEVENTS] =
+{
+  [PERF_EVENT_CYCLES]           = 0x11,  /* CPU_CYCLES */
+  [PERF_EVENT_INSTRUCTIONS]     = 0x08,  /* INST_RETIRED */
+  [PERF_EVENT_CACHE_REFERENCES] = 0x04,  /* L1D_CACHE */
+  [PERF_EVENT_CACHE_MISSES]     = 0x03,  /* L1D_CACHE_REFILL */
+  [PERF_EVENT_BRANCHES]         = 0x21,  /* BR_RETIRED */
+  [PERF_EVENT_BRANCH_MISSES]    = 0x10,  /* BR_MIS_PRED */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -73,6 +92,42 @@ void up_perf_convert(clock_t elapsed, struct timespec *ts)
   left        = elapsed - ts->tv_sec * g_cpu_freq;
   ts->tv_nsec = NSEC_PER_SEC * left / g_cpu_freq;
 }
+
+#ifdef CONFIG_DEV_PERF
+int up_perf_counter_start(int index, int event)
+{
+  if (event < 0 || event >= PERF_EVENT_NEVENTS ||
+      g_perf_events[event] == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  if (index < 0 || (unsigned int)index >= pmu_get_ncntrs())
+    {
+      return -ENOSPC;
+    }
+
+  /* Use the same exception level filter as the cycle counter */
+
+  pmu_cntr_disable(1ul << index);
+  pmu_cntr_select(index);
+  pmu_cntr_set_xevtyper(PMCCFILTR_EL0_NSH | g_perf_events[event]);
+  pmu_cntr_set_xevcntr(0);
+  pmu_cntr_enable(1ul << index);
+  return 0;
+}
+
+void up_perf_counter_stop(int index)
+{
+  pmu_cntr_disable(1ul << index);
+}
+
+uint32_t up_perf_counter_read(int index)
+{
+  pmu_cntr_select(index);
+  return (uint32_t)pmu_cntr_get_xevcntr();
+}
+#endif
 #  endif /* CONFIG_BUILD_FLAT || __KERNEL__ */
 
 clock_t up_perf_gettime(void)
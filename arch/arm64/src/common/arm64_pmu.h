@@ -56,6 +56,8 @@
 
 /* PMCR_EL0 */
 
+#define PMCR_EL0_N_SHIFT         (11)         /* Number of event counters */
+#define PMCR_EL0_N_MASK          (0x1ful << PMCR_EL0_N_SHIFT)
 #define PMCR_EL0_LC              (1ul << 6)   /* Long cycle counter enable */
 #define PMCR_EL0_DP              (1ul << 5)   /* Disable cycle counter when event counting is prohibited */
 #define PMCR_EL0_X               (1ul << 4)   /* Enable export of events */
@@ -269,6 +271,80 @@ static inline void pmu_cntr_irq_disable(uint64_t mask)
   write_sysreg(mask, pmintenclr_el1);
 }
 
+/****************************************************************************
+ * Name: pmu_cntr_disable
+ *
+ * Description:
+ *   Disable counters.
+ *
+ * Parameters:
+ *   mask - Counters to disable.
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_disable(uint64_t mask)
+{
+  write_sysreg(mask, pmcntenclr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_get_ncntrs
+ *
+ * Description:
+ *   Read the number of implemented event counters.
+ *
+ * Return Value:
+ *   The number of event counters, not counting the cycle counter.
+ *
+ ****************************************************************************/
+
+static inline unsigned int pmu_get_ncntrs(void)
+{
+  return (read_sysreg(pmcr_el0) & PMCR_EL0_N_MASK) >> PMCR_EL0_N_SHIFT;
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_set_xevtyper
+ *
+ * Description:
+ *   Set the event counted by the event counter selected by pmselr_el0.
+ *
+ * Parameters:
+ *   mask - Event number and filter flags.
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_set_xevtyper(uint64_t mask)
+{
+  write_sysreg(mask, pmxevtyper_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_get_xevcntr
+ *
+ * Description:
+ *   Read the event counter selected by pmselr_el0.
+ *
+ ****************************************************************************/
+
+static inline uint64_t pmu_cntr_get_xevcntr(void)
+{
+  return read_sysreg(pmxevcntr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_set_xevcntr
+ *
+ * Description:
+ *   Write the event counter selected by pmselr_el0.
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_set_xevcntr(uint64_t value)
+{
+  write_sysreg(value, pmxevcntr_el0);
+}
+
 #ifdef CONFIG_ARCH_CLUSTER_PMU
 
 /****************************************************************************
@@ -334,6 +334,7 @@ uint64_t *arm64_syscall(uint64_t *regs)
         break;
     }
 
+  arm64_tls_switch(tcb);
   regs = tcb->xcp.regs;
 
   /* (*running_task)->xcp.regs is about to become invalid
@@ -74,6 +74,24 @@ do { \
 
 #endif /* CONFIG_PIC */
 
+/* With __thread support the thread pointer (tp) of each thread points
+ * right past its struct tls_info_s, so tls_get_info() is a subtraction
+ * instead of a call into the OS.  The kernel keeps the TCB in tp when it
+ * has system calls, so then only user space can use it.
+ */
+
+#if defined(CONFIG_SCHED_THREAD_LOCAL) && \
+    (!defined(CONFIG_LIB_SYSCALL) || !defined(__KERNEL__))
+
+#define up_tls_info() \
+  ({ \
+    uintptr_t _tp; \
+    __asm__ ("mv %0, tp" : "=r"(_tp)); \
+    (struct tls_info_s *)_tp - 1; \
+  })
+
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -97,6 +97,19 @@ int riscv_exception(int mcause, void *regs, void *args)
 #endif
   uintreg_t cause = mcause & RISCV_IRQ_MASK;
 
+#ifdef CONFIG_SCHED_LAZYFPU
+  /* An FPU instruction with the FPU off, give the task its FPU state and
+   * retry the instruction.
+   */
+
+  if (cause == RISCV_IRQ_IINSTRUCTION &&
+      (((uintreg_t *)regs)[REG_INT_CTX] & MSTATUS_FS) == 0 &&
+      nxsched_fpu_trap(this_task()))
+    {
+      return 0;
+    }
+#endif
+
   _alert("EXCEPTION: %s. MCAUSE: %" PRIxREG ", EPC: %" PRIxREG
          ", MTVAL: %" PRIxREG "\n",
          mcause > RISCV_MAX_EXCEPTION ? "Unknown" : g_reasons_str[cause],
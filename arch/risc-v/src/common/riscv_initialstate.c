@@ -120,6 +120,12 @@ void up_initial_state(struct tcb_s *tcb)
       /* Update current thread pointer */
 
       __asm__ __volatile__("mv tp, %0" : : "r"(tcb));
+#elif defined(CONFIG_SCHED_THREAD_LOCAL)
+      /* The idle thread is already running, point tp at its TLS */
+
+      __asm__ __volatile__("mv tp, %0" : : "r"((uintptr_t)
+                           tcb->stack_alloc_ptr +
+                           sizeof(struct tls_info_s)));
 #endif
       return;
     }
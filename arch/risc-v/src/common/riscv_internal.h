@@ -269,8 +269,10 @@ static inline void riscv_savecontext(struct tcb_s *tcb)
 
 static inline void riscv_restorecontext(struct tcb_s *tcb)
 {
-#ifdef CONFIG_ARCH_FPU
-  /* Restore FPU state for next process */
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_SCHED_LAZYFPU)
+  /* Restore FPU state for next process.  With SCHED_LAZYFPU that is left
+   * to nxsched_switch_fpu() and to the first FPU instruction.
+   */
 
   riscv_restorefpu(tcb->xcp.regs, riscv_fpuregs(tcb));
 #endif
@@ -0,0 +1,81 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_lazyfpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <arch/csr.h>
+#include <arch/mode.h>
+
+#include "riscv_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_fpu_access
+ *
+ * Description:
+ *   Set the FS field of the status the task resumes with.  FS off makes
+ *   its first FPU instruction an illegal instruction exception, clean
+ *   grants access and lets riscv_savefpu() skip the save unless the task
+ *   writes an FPU register.
+ *
+ ****************************************************************************/
+
+void up_fpu_access(struct tcb_s *tcb, bool enable)
+{
+  uintreg_t *regs = tcb->xcp.regs;
+
+  regs[REG_INT_CTX] &= ~MSTATUS_FS;
+  if (enable)
+    {
+      regs[REG_INT_CTX] |= MSTATUS_FS_CLEAN;
+    }
+}
+
+/****************************************************************************
+ * Name: up_fpu_restore
+ *
+ * Description:
+ *   Load the saved FPU registers of the task.
+ *
+ ****************************************************************************/
+
+void up_fpu_restore(struct tcb_s *tcb)
+{
+  /* The handler runs with the FS field of the interrupted task, which may
+   * be off.  The status of the task is reloaded on exception return.
+   */
+
+  SET_CSR(CSR_STATUS, MSTATUS_FS_INIT);
+
+  up_fpu_access(tcb, true);
+  riscv_restorefpu(tcb->xcp.regs, riscv_fpuregs(tcb));
+}
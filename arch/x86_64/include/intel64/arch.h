@@ -58,6 +58,17 @@
 
 #define X86_64_PGPOOL_BASE             (CONFIG_RAM_SIZE - X86_64_PGPOOL_SIZE)
 
+/* With __thread support FS points to the thread control block at the end
+ * of the TLS block of each thread: a pointer to itself, as the x86_64 ABI
+ * requires, then a pointer to the struct tls_info_s of the thread, so
+ * that tls_get_info() is a single load.
+ */
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+#  define X86_64_TLS_TCB_SIZE          (2 * sizeof(void *))
+#  define up_tls_info()                x86_64_tls_info()
+#endif
+
 /* RFLAGS bits */
 
 #define X86_64_RFLAGS_CF               (1 << 0)  /* Bit 0:  Carry Flag */
@@ -218,6 +229,7 @@
 #define X86_64_CPUID_VENDOR            0x00
 #define X86_64_CPUID_CAP               0x01
 #  define X86_64_CPUID_01_SSE3         (1 << 0)
+#  define X86_64_CPUID_01_PCLMUL       (1 << 1)
 #  define X86_64_CPUID_01_SSSE3        (1 << 9)
 #  define X86_64_CPUID_01_FMA          (1 << 12)
 #  define X86_64_CPUID_01_PCID         (1 << 17)
@@ -546,6 +558,21 @@ extern volatile uint64_t *g_pt;
 extern volatile struct ist_s       *g_ist64;
 extern volatile struct gdt_entry_s *g_gdt64;
 
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+struct tls_info_s;
+static inline_function struct tls_info_s *x86_64_tls_info(void)
+{
+  struct tls_info_s *info;
+
+  __asm__ ("movq %%fs:8, %0" : "=r"(info));
+  return info;
+}
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -48,7 +48,7 @@
 int up_tls_size(void)
 {
   return sizeof(struct tls_info_s) +
-         _END_TBSS - _START_TDATA + sizeof(void *);
+         _END_TBSS - _START_TDATA + X86_64_TLS_TCB_SIZE;
 }
 
 /****************************************************************************
@@ -67,7 +67,13 @@ void up_tls_initialize(struct tls_info_s *info)
   uint8_t  *tls_data  = (uint8_t *)(info + 1);
   uint32_t  tdata_len = _END_TDATA - _START_TDATA;
   uint32_t  tbss_len  = _END_TBSS - _START_TBSS;
+  uint64_t *tcb       = (uint64_t *)(tls_data + (_END_TBSS - _START_TDATA));
 
   memcpy(tls_data, _START_TDATA, tdata_len);
   memset(tls_data + tdata_len, 0, tbss_len);
+
+  /* The thread control block that FS points to */
+
+  tcb[0] = (uintptr_t)tcb;
+  tcb[1] = (uintptr_t)info;
 }
@@ -98,6 +98,12 @@ void x86_64_check_and_enable_capability(void)
   require |= X86_64_CPUID_01_SSE42;
 #endif
 
+  /* Check carry-less multiplication availability */
+
+#ifdef CONFIG_X86_64_CRC32
+  require |= X86_64_CPUID_01_PCLMUL;
+#endif
+
   /* Check x2APIC availability */
 
   require |= X86_64_CPUID_01_X2APIC;
@@ -797,6 +797,23 @@ int up_connect_irq(const int *irq, int num, uintptr_t *mar, uint32_t *mdr)
   return OK;
 }
 
+/****************************************************************************
+ * Name: up_affinity_irq_msi
+ *
+ * Description:
+ *   Get the MSI/MSI-X message that delivers irq to a given CPU
+ *
+ ****************************************************************************/
+
+int up_affinity_irq_msi(int irq, int cpu, uintptr_t *mar, uint32_t *mdr)
+{
+  *mar = X86_64_MAR_DEST |
+    (x86_64_cpu_to_loapic(cpu) << PCI_MSI_DATA_CPUID_SHIFT);
+  *mdr = X86_64_MDR_TYPE | irq;
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: up_set_irq_type
  *
@@ -37,6 +37,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <poll.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
@@ -61,6 +62,10 @@
 #  define AUDIO_MAX_DEVICE_PATH 32
 #endif
 
+#ifndef CONFIG_AUDIO_NPOLLWAITERS
+#  define CONFIG_AUDIO_NPOLLWAITERS 2
+#endif
+
 #ifndef CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO
 #  define CONFIG_AUDIO_BUFFER_DEQUEUE_PRIO  1
 #endif
@@ -78,6 +83,9 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_MMAP
+  FAR struct pollfd *fds[CONFIG_AUDIO_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -95,6 +103,12 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MMAP
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds, bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,6 +137,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_MMAP
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -292,6 +311,121 @@ static ssize_t audio_write(FAR struct file *filep,
   return 0;
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+/****************************************************************************
+ * Name: audio_ring_events
+ *
+ * Description:
+ *   Return the poll events that are ready on the period ring: POLLOUT if a
+ *   playback period is free, POLLIN if a capture period is filled.
+ *
+ ****************************************************************************/
+
+static pollevent_t audio_ring_events(FAR struct audio_ring_s *ring)
+{
+  uint32_t used;
+
+  if (ring == NULL)
+    {
+      return 0;
+    }
+
+  if (ring->flags & AUDIO_RING_PLAYBACK)
+    {
+      used = ring->appl_period - ring->hw_period;
+      return (int32_t)used < 0 || used < ring->nperiods ? POLLOUT : 0;
+    }
+
+  return ring->hw_period != ring->appl_period ? POLLIN : 0;
+}
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the period ring of a lower half that supports it.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  int ret;
+
+  if (lower->ops->mmap == NULL)
+    {
+      return -ENODEV;
+    }
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = lower->ops->mmap(lower, map);
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for a free playback or a filled capture period of the ring.
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep,
+                      FAR struct pollfd *fds, bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct pollfd **slot = NULL;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = enter_critical_section();
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_AUDIO_NPOLLWAITERS; i++)
+        {
+          if (upper->fds[i] == NULL)
+            {
+              slot = &upper->fds[i];
+              break;
+            }
+        }
+
+      if (slot == NULL)
+        {
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      *slot = fds;
+      fds->priv = slot;
+
+      poll_notify(&fds, 1, audio_ring_events(upper->dev->ring));
+    }
+  else if (fds->priv != NULL)
+    {
+      slot = (FAR struct pollfd **)fds->priv;
+      *slot = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: audio_start
  *
@@ -970,6 +1104,17 @@ static void audio_callback(FAR void *handle, uint16_t reason,
         }
         break;
 
+#ifdef CONFIG_AUDIO_MMAP
+      /* Lower-half driver has advanced the period ring */
+
+      case AUDIO_CALLBACK_PERIOD:
+        {
+          poll_notify(upper->fds, CONFIG_AUDIO_NPOLLWAITERS,
+                      audio_ring_events(upper->dev->ring));
+        }
+        break;
+#endif
+
       default:
         {
           auderr("ERROR: Unknown callback reason code %d\n", reason);
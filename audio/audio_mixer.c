@@ -0,0 +1,1299 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The mixer sits between N stream devices and one output lower half.
+ * While more than one stream plays, or the only stream needs rate
+ * conversion or scaling, the worker sums all streams into output buffers
+ * owned by the mixer.  A single stream in the output format is handed to
+ * the lower half as is, without a copy, provided the lower half accepts
+ * buffers it did not allocate.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+#  define MIXER_WORK          HPWORK
+#else
+#  define MIXER_WORK          LPWORK
+#endif
+
+#define MIXER_ONE             0x10000  /* 1.0 in Q16 resampler phase */
+#define MIXER_UNITY           32768    /* 1.0 in Q15 gain */
+#define MIXER_FRAMEBYTES      4        /* 16-bit stereo output frame */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* One input stream, registered as its own audio device */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the outside world.  This *MUST* be the
+   * first element of the structure.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer;
+  struct dq_queue_s pendq;        /* Buffers waiting to be mixed */
+  uint32_t samprate;              /* Input sample rate */
+  uint32_t step;                  /* Input frames per output frame, Q16 */
+  uint32_t phase;                 /* Position between prev and next, Q16 */
+  int32_t gain;                   /* Volume, Q15 */
+  int16_t prev[2];                /* Resampler history */
+  int16_t next[2];
+  uint8_t nchannels;
+  bool started;
+  bool paused;
+};
+
+/* The mixer state */
+
+struct audio_mixer_s
+{
+  /* The output device */
+
+  FAR struct audio_lowerhalf_s *lower;
+
+  mutex_t lock;                   /* Serializes streams and the worker */
+  struct work_s work;             /* Refills the output buffers */
+  struct dq_queue_s freeq;        /* Output buffers owned by the mixer */
+  FAR struct ap_buffer_s **outbuf;
+  FAR int32_t *acc;               /* Mixing accumulator */
+
+  /* The stream whose buffers are passed through, and its final buffer */
+
+  FAR struct audio_mixer_stream_s *ptowner;
+  FAR struct ap_buffer_s *ptfinal;
+
+  uint32_t samprate;              /* Output sample rate */
+  uint16_t ptcount;               /* Passed through buffers in the lower */
+  uint8_t nbufs;
+  uint8_t nstreams;
+  uint8_t nstarted;
+  bool ptactive;                  /* ptowner passes through */
+  volatile bool ptdone;           /* ptfinal came back */
+  volatile bool running;          /* The lower half is started */
+  volatile bool draining;         /* The last output buffer is queued */
+  struct audio_mixer_stream_s stream[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps);
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps);
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+static int mixer_start(FAR struct audio_lowerhalf_s *dev);
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb);
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg);
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int mixer_release(FAR struct audio_lowerhalf_s *dev);
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  mixer_getcaps,            /* getcaps        */
+  mixer_configure,          /* configure      */
+  mixer_shutdown,           /* shutdown       */
+  mixer_start,              /* start          */
+  mixer_stop,               /* stop           */
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  mixer_pause,              /* pause          */
+  mixer_resume,             /* resume         */
+#endif
+  NULL,                     /* allocbuffer    */
+  NULL,                     /* freebuffer     */
+  mixer_enqueuebuffer,      /* enqueue_buffer */
+  NULL,                     /* cancel_buffer  */
+  mixer_ioctl,              /* ioctl          */
+  NULL,                     /* read           */
+  NULL,                     /* write          */
+  mixer_reserve,            /* reserve        */
+  mixer_release             /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mixer_accum_stereo, mixer_accum_mono, mixer_clip
+ *
+ * Description:
+ *   The mixing kernels.  They are straight loops over restrict pointers
+ *   without branches so that the compiler can vectorize them for the
+ *   target's SIMD unit.
+ *
+ ****************************************************************************/
+
+static void mixer_accum_stereo(FAR int32_t *restrict acc,
+                               FAR const int16_t *restrict in,
+                               size_t nsamples, int32_t gain)
+{
+  size_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      acc[i] += (in[i] * gain) >> 15;
+    }
+}
+
+static void mixer_accum_mono(FAR int32_t *restrict acc,
+                             FAR const int16_t *restrict in,
+                             size_t nframes, int32_t gain)
+{
+  int32_t v;
+  size_t i;
+
+  for (i = 0; i < nframes; i++)
+    {
+      v = (in[i] * gain) >> 15;
+      acc[2 * i]     += v;
+      acc[2 * i + 1] += v;
+    }
+}
+
+static void mixer_clip(FAR int16_t *restrict out,
+                       FAR const int32_t *restrict acc, size_t nsamples)
+{
+  int32_t v;
+  size_t i;
+
+  for (i = 0; i < nsamples; i++)
+    {
+      v = acc[i];
+      v = v < INT16_MIN ? INT16_MIN : v;
+      v = v > INT16_MAX ? INT16_MAX : v;
+      out[i] = (int16_t)v;
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_resample
+ *
+ * Description:
+ *   Linear interpolation from the stream rate to the output rate.  Returns
+ *   the number of output frames produced before apb ran out.
+ *
+ ****************************************************************************/
+
+static uint32_t mixer_resample(FAR struct audio_mixer_stream_s *stream,
+                               FAR struct ap_buffer_s *apb,
+                               FAR int32_t *acc, uint32_t nframes)
+{
+  apb_samp_t framebytes = stream->nchannels * sizeof(int16_t);
+  FAR const int16_t *src;
+  int32_t frac;
+  int32_t l;
+  int32_t r;
+  uint32_t n;
+
+  for (n = 0; n < nframes; n++)
+    {
+      while (stream->phase >= MIXER_ONE)
+        {
+          if (apb->curbyte + framebytes > apb->nbytes)
+            {
+              return n;
+            }
+
+          src = (FAR const int16_t *)(apb->samp + apb->curbyte);
+          stream->prev[0] = stream->next[0];
+          stream->prev[1] = stream->next[1];
+          stream->next[0] = src[0];
+          stream->next[1] = src[stream->nchannels - 1];
+          apb->curbyte   += framebytes;
+          stream->phase  -= MIXER_ONE;
+        }
+
+      /* Interpolate in Q15 so that the product fits in 32 bits */
+
+      frac = stream->phase >> 1;
+      l = stream->prev[0] +
+          (((stream->next[0] - stream->prev[0]) * frac) >> 15);
+      r = stream->prev[1] +
+          (((stream->next[1] - stream->prev[1]) * frac) >> 15);
+
+      acc[2 * n]     += (l * stream->gain) >> 15;
+      acc[2 * n + 1] += (r * stream->gain) >> 15;
+      stream->phase  += stream->step;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: mixer_flush
+ *
+ * Description:
+ *   Return all buffers that are still waiting to be mixed.
+ *
+ ****************************************************************************/
+
+static void mixer_flush(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)
+                dq_remfirst(&stream->pendq)) != NULL)
+    {
+      stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                           apb, OK);
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_lower_stop
+ *
+ * Description:
+ *   Stop the output device.  The buffers it holds come back through
+ *   mixer_callback().
+ *
+ ****************************************************************************/
+
+static void mixer_lower_stop(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  if (mixer->running)
+    {
+      lower->ops->stop(lower);
+      mixer->running  = false;
+      mixer->draining = false;
+    }
+
+  mixer->ptactive = false;
+}
+
+/****************************************************************************
+ * Name: mixer_complete
+ *
+ * Description:
+ *   A stream has played its final buffer or was stopped.
+ *
+ ****************************************************************************/
+
+static void mixer_complete(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  if (!stream->started)
+    {
+      return;
+    }
+
+  stream->started = false;
+  mixer->nstarted--;
+  if (mixer->ptowner == stream)
+    {
+      mixer->ptactive = false;
+    }
+
+  mixer_flush(stream);
+  stream->export.upper(stream->export.priv, AUDIO_CALLBACK_COMPLETE,
+                       NULL, OK);
+}
+
+/****************************************************************************
+ * Name: mixer_mix
+ *
+ * Description:
+ *   Add nframes output frames of one stream to the accumulator.  A stream
+ *   that runs dry contributes silence for the rest of the buffer.
+ *
+ ****************************************************************************/
+
+static void mixer_mix(FAR struct audio_mixer_stream_s *stream,
+                      FAR int32_t *acc, uint32_t nframes)
+{
+  apb_samp_t framebytes = stream->nchannels * sizeof(int16_t);
+  FAR struct ap_buffer_s *apb;
+  FAR const int16_t *src;
+  uint32_t count;
+  uint32_t n = 0;
+  bool final;
+
+  while (n < nframes)
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq);
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      if (stream->step == MIXER_ONE)
+        {
+          /* No rate conversion, mix whole runs of the buffer */
+
+          src   = (FAR const int16_t *)(apb->samp + apb->curbyte);
+          count = (apb->nbytes - apb->curbyte) / framebytes;
+          if (count > nframes - n)
+            {
+              count = nframes - n;
+            }
+
+          if (stream->nchannels == 2)
+            {
+              mixer_accum_stereo(acc + 2 * n, src, 2 * count,
+                                 stream->gain);
+            }
+          else
+            {
+              mixer_accum_mono(acc + 2 * n, src, count, stream->gain);
+            }
+
+          apb->curbyte += count * framebytes;
+          n += count;
+        }
+      else
+        {
+          n += mixer_resample(stream, apb, acc + 2 * n, nframes - n);
+        }
+
+      if (apb->curbyte + framebytes > apb->nbytes)
+        {
+          /* This buffer is used up, give it back */
+
+          dq_remfirst(&stream->pendq);
+          final = (apb->flags & AUDIO_APB_FINAL) != 0;
+          stream->export.upper(stream->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                               apb, OK);
+          if (final)
+            {
+              mixer_complete(stream);
+              break;
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_fill
+ *
+ * Description:
+ *   Mix one output buffer and queue it to the output device.
+ *
+ ****************************************************************************/
+
+static int mixer_fill(FAR struct audio_mixer_s *mixer,
+                      FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct audio_mixer_stream_s *stream;
+  uint32_t nframes = apb->nmaxbytes / MIXER_FRAMEBYTES;
+  int i;
+
+  memset(mixer->acc, 0, nframes * 2 * sizeof(int32_t));
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      stream = &mixer->stream[i];
+      if (stream->started && !stream->paused)
+        {
+          mixer_mix(stream, mixer->acc, nframes);
+        }
+    }
+
+  mixer_clip((FAR int16_t *)apb->samp, mixer->acc, nframes * 2);
+
+  apb->nbytes  = nframes * MIXER_FRAMEBYTES;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  /* Let the output device stop by itself after the last stream ended,
+   * so that the buffers still queued are played out.
+   */
+
+  if (mixer->nstarted == 0)
+    {
+      apb->flags      |= AUDIO_APB_FINAL;
+      mixer->draining  = true;
+    }
+
+  return lower->ops->enqueuebuffer(lower, apb);
+}
+
+/****************************************************************************
+ * Name: mixer_refill
+ *
+ * Description:
+ *   Mix into all free output buffers.  Called with the mixer lock held.
+ *
+ ****************************************************************************/
+
+static void mixer_refill(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+
+  while (mixer->running && !mixer->draining && !mixer->ptactive)
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      if (mixer_fill(mixer, apb) < 0)
+        {
+          flags = enter_critical_section();
+          dq_addfirst(&apb->dq_entry, &mixer->freeq);
+          leave_critical_section(flags);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mixer_worker
+ ****************************************************************************/
+
+static void mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+
+  nxmutex_lock(&mixer->lock);
+
+  /* The final buffer of a passed through stream came back */
+
+  if (mixer->ptdone)
+    {
+      mixer->ptdone = false;
+      mixer_complete(mixer->ptowner);
+      if (mixer->nstarted == 0)
+        {
+          mixer_lower_stop(mixer);
+        }
+    }
+
+  mixer_refill(mixer);
+  nxmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: mixer_can_passthru
+ *
+ * Description:
+ *   True if the stream can hand its buffers to the output device as is.
+ *
+ ****************************************************************************/
+
+static bool mixer_can_passthru(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  return mixer->lower->ops->allocbuffer == NULL &&
+         mixer->nstarted == 1 && mixer->ptcount == 0 &&
+         stream->started && !stream->paused &&
+         stream->step == MIXER_ONE && stream->nchannels == 2 &&
+         stream->gain == MIXER_UNITY;
+}
+
+/****************************************************************************
+ * Name: mixer_passthru
+ *
+ * Description:
+ *   Queue a stream buffer directly to the output device.  The final flag
+ *   is kept from the output device, which must not stop on its own if
+ *   another stream starts meanwhile.
+ *
+ ****************************************************************************/
+
+static int mixer_passthru(FAR struct audio_mixer_s *mixer,
+                          FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+  if ((apb->flags & AUDIO_APB_FINAL) != 0)
+    {
+      apb->flags    &= ~AUDIO_APB_FINAL;
+      mixer->ptfinal = apb;
+    }
+
+  mixer->ptcount++;
+  leave_critical_section(flags);
+
+  ret = lower->ops->enqueuebuffer(lower, apb);
+  if (ret < 0)
+    {
+      flags = enter_critical_section();
+      mixer->ptcount--;
+      if (mixer->ptfinal == apb)
+        {
+          apb->flags    |= AUDIO_APB_FINAL;
+          mixer->ptfinal = NULL;
+        }
+
+      leave_critical_section(flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_lower_start
+ *
+ * Description:
+ *   Configure and start the output device.  Called with the mixer lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static int mixer_lower_start(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_caps_s caps;
+  int ret;
+
+  if (mixer->draining)
+    {
+      mixer_lower_stop(mixer);
+    }
+
+  if (mixer->running)
+    {
+      return OK;
+    }
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len             = sizeof(caps);
+  caps.ac_type            = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels        = 2;
+  caps.ac_controls.hw[0]  = mixer->samprate & 0xffff;
+  caps.ac_controls.b[2]   = 16;
+  caps.ac_controls.b[3]   = mixer->samprate >> 16;
+
+  ret = lower->ops->configure(lower, &caps);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mixer->running = true;
+  mixer_refill(mixer);
+
+  ret = lower->ops->start(lower);
+  if (ret < 0)
+    {
+      mixer->running = false;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_alloc
+ *
+ * Description:
+ *   Allocate the output buffers from the output device when possible, so
+ *   that they satisfy its DMA constraints.
+ *
+ ****************************************************************************/
+
+static int mixer_alloc(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct ap_buffer_info_s info;
+  struct audio_buf_desc_s desc;
+  int ret;
+  int i;
+
+  info.nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+  info.buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+  if (lower->ops->ioctl != NULL)
+    {
+      lower->ops->ioctl(lower, AUDIOIOC_GETBUFFERINFO,
+                        (unsigned long)&info);
+    }
+#endif
+
+  if (info.nbuffers == 0 || info.nbuffers > UINT8_MAX ||
+      info.buffer_size < MIXER_FRAMEBYTES)
+    {
+      return -EINVAL;
+    }
+
+  mixer->outbuf = kmm_zalloc(info.nbuffers * sizeof(*mixer->outbuf));
+  mixer->acc    = kmm_malloc(info.buffer_size / MIXER_FRAMEBYTES *
+                             2 * sizeof(int32_t));
+  if (mixer->outbuf == NULL || mixer->acc == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (i = 0; i < info.nbuffers; i++)
+    {
+      desc.numbytes  = info.buffer_size;
+      desc.u.pbuffer = &mixer->outbuf[i];
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &desc);
+        }
+      else
+        {
+          ret = apb_alloc(&desc);
+        }
+
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      dq_addlast(&mixer->outbuf[i]->dq_entry, &mixer->freeq);
+      mixer->nbufs++;
+    }
+
+  return OK;
+
+errout:
+  while (mixer->nbufs > 0)
+    {
+      desc.u.buffer = mixer->outbuf[--mixer->nbufs];
+      if (lower->ops->freebuffer != NULL)
+        {
+          lower->ops->freebuffer(lower, &desc);
+        }
+      else
+        {
+          apb_free(desc.u.buffer);
+        }
+    }
+
+  dq_init(&mixer->freeq);
+  kmm_free(mixer->outbuf);
+  kmm_free(mixer->acc);
+  mixer->outbuf = NULL;
+  mixer->acc    = NULL;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_isoutbuf
+ ****************************************************************************/
+
+static bool mixer_isoutbuf(FAR struct audio_mixer_s *mixer,
+                           FAR struct ap_buffer_s *apb)
+{
+  int i;
+
+  for (i = 0; i < mixer->nbufs; i++)
+    {
+      if (mixer->outbuf[i] == apb)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mixer_getcaps
+ *
+ * Description: Get the capabilities of a stream.
+ *
+ ****************************************************************************/
+
+static int mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                         FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT |
+                                     AUDIO_TYPE_FEATURE;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = 0x12;         /* One or two channels */
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_DEF_ALL;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: mixer_configure
+ *
+ * Description: Set the format or the volume of a stream.
+ *
+ ****************************************************************************/
+
+static int mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                           FAR const struct audio_caps_s *caps)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  uint32_t samprate;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw != AUDIO_FU_VOLUME ||
+            caps->ac_controls.hw[0] > 1000)
+          {
+            ret = -EINVAL;
+            break;
+          }
+
+        stream->gain = caps->ac_controls.hw[0] * MIXER_UNITY / 1000;
+
+        /* Scaling needs the mix path */
+
+        if (mixer->ptactive && mixer->ptowner == stream &&
+            stream->gain != MIXER_UNITY)
+          {
+            mixer->ptactive = false;
+            mixer_refill(mixer);
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        samprate = caps->ac_controls.hw[0] |
+                   (caps->ac_controls.b[3] << 16);
+        if (stream->started)
+          {
+            ret = -EBUSY;
+          }
+        else if ((caps->ac_channels != 1 && caps->ac_channels != 2) ||
+                 caps->ac_controls.b[2] != 16 || samprate == 0)
+          {
+            ret = -ERANGE;
+          }
+        else
+          {
+            stream->samprate  = samprate;
+            stream->nchannels = caps->ac_channels;
+            stream->step      = ((uint64_t)samprate << 16) /
+                                mixer->samprate;
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_shutdown
+ *
+ * Description:
+ *   The last reference to a stream was closed.  The output device is shut
+ *   down when no stream plays any more.
+ *
+ ****************************************************************************/
+
+static int mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+
+  mixer_stop(dev);
+
+  nxmutex_lock(&mixer->lock);
+  mixer_flush(stream);
+  if (!mixer->running && mixer->ptcount == 0)
+    {
+      lower->ops->shutdown(lower);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_start
+ *
+ * Description: Start a stream.
+ *
+ ****************************************************************************/
+
+static int mixer_start(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct ap_buffer_s *apb;
+  int ret = OK;
+
+  if (stream->nchannels == 0)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&mixer->lock);
+  if (stream->started)
+    {
+      goto out;
+    }
+
+  if (mixer->nbufs == 0)
+    {
+      ret = mixer_alloc(mixer);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  stream->started = true;
+  stream->paused  = false;
+  stream->phase   = MIXER_ONE;
+  memset(stream->prev, 0, sizeof(stream->prev));
+  memset(stream->next, 0, sizeof(stream->next));
+  mixer->nstarted++;
+
+  if (mixer_can_passthru(stream))
+    {
+      mixer->ptactive = true;
+      mixer->ptowner  = stream;
+      while ((apb = (FAR struct ap_buffer_s *)
+                    dq_remfirst(&stream->pendq)) != NULL)
+        {
+          mixer_passthru(mixer, apb);
+        }
+    }
+  else if (mixer->ptactive)
+    {
+      /* Another stream joins, switch to the mix path */
+
+      mixer->ptactive = false;
+      mixer_refill(mixer);
+    }
+
+  ret = mixer_lower_start(mixer);
+  if (ret < 0)
+    {
+      mixer_complete(stream);
+    }
+
+out:
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_stop
+ *
+ * Description: Stop a stream.
+ *
+ ****************************************************************************/
+
+static int mixer_stop(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  if (stream->started)
+    {
+      mixer_complete(stream);
+      if (mixer->nstarted == 0)
+        {
+          mixer_lower_stop(mixer);
+        }
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return OK;
+}
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+/****************************************************************************
+ * Name: mixer_pause
+ *
+ * Description:
+ *   Pause a stream.  A mixed stream is silenced, a passed through stream
+ *   pauses the output device.
+ *
+ ****************************************************************************/
+
+static int mixer_pause(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+  if (stream->started && !stream->paused)
+    {
+      stream->paused = true;
+      if (mixer->ptactive && mixer->ptowner == stream)
+        {
+          ret = lower->ops->pause(lower);
+        }
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_resume
+ *
+ * Description: Resume a paused stream.
+ *
+ ****************************************************************************/
+
+static int mixer_resume(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+  if (stream->started && stream->paused)
+    {
+      stream->paused = false;
+      if (mixer->ptactive && mixer->ptowner == stream)
+        {
+          ret = lower->ops->resume(lower);
+        }
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: mixer_enqueuebuffer
+ *
+ * Description:
+ *   Queue a stream buffer.  The only playing stream goes back to the zero
+ *   copy path as soon as nothing of it is left in the mix path.
+ *
+ ****************************************************************************/
+
+static int mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                               FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!mixer->ptactive && dq_empty(&stream->pendq) &&
+      !mixer->draining && mixer_can_passthru(stream))
+    {
+      mixer->ptactive = true;
+      mixer->ptowner  = stream;
+    }
+
+  if (mixer->ptactive && mixer->ptowner == stream)
+    {
+      ret = mixer_passthru(mixer, apb);
+    }
+  else
+    {
+      apb->curbyte = 0;
+      apb->flags  |= AUDIO_APB_OUTPUT_ENQUEUED;
+      dq_addlast(&apb->dq_entry, &stream->pendq);
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mixer_ioctl
+ ****************************************************************************/
+
+static int mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                       unsigned long arg)
+{
+#ifdef CONFIG_AUDIO_DRIVER_SPECIFIC_BUFFERS
+  FAR struct ap_buffer_info_s *bufinfo;
+
+  if (cmd == AUDIOIOC_GETBUFFERINFO)
+    {
+      bufinfo              = (FAR struct ap_buffer_info_s *)arg;
+      bufinfo->nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+      bufinfo->buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+      return OK;
+    }
+#endif
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: mixer_reserve, mixer_release
+ *
+ * Description: Each stream device is a single session.
+ *
+ ****************************************************************************/
+
+static int mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+static int mixer_release(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mixer_callback
+ *
+ * Description:
+ *   Callback of the output device.  Output buffers go back to the free
+ *   queue and wake up the worker, passed through buffers go back to the
+ *   stream that owns them.  This may run in interrupt context.
+ *
+ ****************************************************************************/
+
+static void mixer_callback(FAR void *arg, uint16_t reason,
+                           FAR struct ap_buffer_s *apb, uint16_t status)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  FAR struct audio_mixer_stream_s *owner;
+  irqstate_t flags;
+  bool final = false;
+  int i;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        if (mixer_isoutbuf(mixer, apb))
+          {
+            dq_addlast(&apb->dq_entry, &mixer->freeq);
+            leave_critical_section(flags);
+            break;
+          }
+
+        mixer->ptcount--;
+        if (apb == mixer->ptfinal)
+          {
+            apb->flags    |= AUDIO_APB_FINAL;
+            mixer->ptfinal = NULL;
+            final          = true;
+          }
+
+        owner = mixer->ptowner;
+        leave_critical_section(flags);
+
+        owner->export.upper(owner->export.priv, AUDIO_CALLBACK_DEQUEUE,
+                            apb, status);
+        if (!final)
+          {
+            return;
+          }
+
+        mixer->ptdone = true;
+        break;
+
+      case AUDIO_CALLBACK_COMPLETE:
+        mixer->running  = false;
+        mixer->draining = false;
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        for (i = 0; i < mixer->nstreams; i++)
+          {
+            owner = &mixer->stream[i];
+            if (owner->started)
+              {
+                owner->export.upper(owner->export.priv, reason, apb,
+                                    status);
+              }
+          }
+
+        return;
+
+      default:
+        return;
+    }
+
+  work_queue(MIXER_WORK, &mixer->work, mixer_worker, mixer, 0);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Put a software mixer in front of an output device.  The mixer
+ *   registers nstreams audio devices named <name>0, <name>1, ... that
+ *   each accept 16-bit mono or stereo PCM at any sample rate and volume.
+ *
+ * Input Parameters:
+ *   name     - The base name of the stream devices.
+ *   lower    - The output device.  It is owned by the mixer from now on.
+ *   nstreams - The number of stream devices to register.
+ *   samprate - The sample rate of the output device.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name,
+                           FAR struct audio_lowerhalf_s *lower,
+                           int nstreams, uint32_t samprate)
+{
+  FAR struct audio_mixer_stream_s *stream;
+  FAR struct audio_mixer_s *mixer;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && lower != NULL);
+
+  if (nstreams < 1 || nstreams > UINT8_MAX || samprate == 0)
+    {
+      return -EINVAL;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     sizeof(struct audio_mixer_stream_s) * (nstreams - 1));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&mixer->lock);
+  dq_init(&mixer->freeq);
+  mixer->lower    = lower;
+  mixer->samprate = samprate;
+  mixer->nstreams = nstreams;
+
+  lower->upper = mixer_callback;
+  lower->priv  = mixer;
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream             = &mixer->stream[i];
+      stream->export.ops = &g_audio_mixer_ops;
+      stream->mixer      = mixer;
+      stream->gain       = MIXER_UNITY;
+      dq_init(&stream->pendq);
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &stream->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
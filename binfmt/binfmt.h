@@ -230,6 +230,21 @@ void binfmt_freeactions(FAR const posix_spawn_file_actions_t *copy);
 
 int builtin_initialize(void);
 
+/****************************************************************************
+ * Name: builtin_loadmodule
+ *
+ * Description:
+ *   Get the load information of the builtin application named by the last
+ *   component of filename, without any file system access.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned if the
+ *   name is not a builtin application.
+ *
+ ****************************************************************************/
+
+int builtin_loadmodule(FAR struct binary_s *binp, FAR const char *filename);
+
 /****************************************************************************
  * Name: builtin_uninitialize
  *
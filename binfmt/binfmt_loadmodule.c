@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sched.h>
+#include <string.h>
 #include <debug.h>
 #include <errno.h>
 
@@ -176,6 +177,21 @@ int load_module(FAR struct binary_s *bin, FAR const char *filename,
           return ret;
         }
 
+#ifdef CONFIG_BINFMT_BUILTIN_FIRST
+      /* A builtin application needs neither the PATH search nor the probing
+       * of the other binary formats, which open the file for each try.
+       */
+
+      if (builtin_loadmodule(bin, filename) == OK)
+        {
+          binfo("Successfully loaded builtin %s\n", filename);
+#ifdef CONFIG_BINFMT_STORE_FILENAME
+          strlcpy(bin->fname, filename, sizeof(bin->fname));
+#endif
+          return OK;
+        }
+#endif
+
       /* Were we given a relative path?  Or an absolute path to the file to
        * be loaded?  Absolute paths start with '/'.
        */
@@ -34,6 +34,8 @@
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/lib/builtin.h>
 
+#include "binfmt.h"
+
 #ifdef CONFIG_BUILTIN
 
 /****************************************************************************
@@ -72,13 +74,40 @@ static int builtin_loadbinary(FAR struct binary_s *binp,
                               FAR const char *filename,
                               FAR const struct symtab_s *exports,
                               int nexports)
+{
+  int ret;
+
+  binfo("Loading file: %s\n", filename);
+
+  ret = builtin_loadmodule(binp, filename);
+  if (ret < 0)
+    {
+      berr("ERROR: %s is not a builtin application\n", filename);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: builtin_loadmodule
+ *
+ * Description:
+ *   Return the load information of the builtin application named by the
+ *   last component of filename.  Unlike the binary format load() method,
+ *   a name that is not a builtin application is not reported as an error.
+ *
+ ****************************************************************************/
+
+int builtin_loadmodule(FAR struct binary_s *binp, FAR const char *filename)
 {
   FAR const struct builtin_s *builtin;
   FAR char *name;
   int index;
 
-  binfo("Loading file: %s\n", filename);
-
   name = strrchr(filename, '/');
   if (name != NULL)
     {
@@ -90,7 +119,6 @@ static int builtin_loadbinary(FAR struct binary_s *binp,
   index = builtin_isavail(filename);
   if (index < 0)
     {
-      berr("ERROR: %s is not a builtin application\n", filename);
       return index;
     }
 
@@ -101,7 +129,6 @@ static int builtin_loadbinary(FAR struct binary_s *binp,
   builtin = builtin_for_index(index);
   if (builtin == NULL)
     {
-      berr("ERROR: %s is not a builtin application\n", filename);
       return -ENOENT;
     }
 
@@ -117,10 +144,6 @@ static int builtin_loadbinary(FAR struct binary_s *binp,
   return OK;
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Name: builtin_initialize
  *
@@ -901,8 +901,7 @@ int boardctl(unsigned int cmd, uintptr_t arg)
       case BOARDIOC_IRQ_AFFINITY:
         {
           FAR unsigned int *affinity = (FAR unsigned int *)arg;
-          up_affinity_irq(affinity[0], affinity[1]);
-          ret = OK;
+          ret = irq_set_affinity(affinity[0], affinity[1]);
         }
         break;
 #endif
@@ -36,6 +36,8 @@
 #include <sys/types.h>
 #include <crypto/aes.h>
 
+#include "arm64_ce.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -845,6 +847,24 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
 
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  /* The instructions use the plain key schedule in sk, and the inverse
+   * cipher schedule in sk_exp instead of the bitsliced one.
+   */
+
+  if (arm64_ce_have_aes())
+    {
+      ctx->num_rounds = aes_keysched_base(ctx->sk, key, len);
+      if (ctx->num_rounds == 0)
+        {
+          return -1;
+        }
+
+      arm64_ce_aes_deckey(ctx->sk_exp, ctx->sk, ctx->num_rounds);
+      return 0;
+    }
+#endif
+
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -858,6 +878,14 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_have_aes())
+    {
+      arm64_ce_aes_encrypt(ctx->sk, ctx->num_rounds, src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -908,6 +936,15 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_have_aes())
+    {
+      arm64_ce_aes_decrypt(ctx->sk_exp, ctx->num_rounds, src, dst,
+                           num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -0,0 +1,264 @@
+/****************************************************************************
+ * crypto/arm64_ce.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* AES and GHASH with the ARMv8 Cryptography Extensions.  The instructions
+ * are enabled for this file only, the CPU support is checked at run time.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef __clang__
+#  pragma clang attribute push (__attribute__((target("aes"))), \
+                                apply_to = function)
+#else
+#  pragma GCC target ("+crypto")
+#endif
+
+#include <arm_neon.h>
+
+#include <crypto/aes.h>
+
+#include "arm64_ce.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ID_AA64ISAR0_EL1.AES: 1 = AESE/AESD/AESMC/AESIMC, 2 = also PMULL */
+
+#define ISAR0_AES_SHIFT   4
+#define ISAR0_AES_MASK    0xf
+#define ISAR0_AES         1
+#define ISAR0_PMULL       2
+
+/* x^128 = x^7 + x^2 + x + 1 in GF(2^128) */
+
+#define GHASH_POLY        0x87
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static int g_arm64_ce_aes = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int arm64_ce_level(void)
+{
+  uint64_t isar0;
+
+  if (g_arm64_ce_aes < 0)
+    {
+      __asm__ volatile ("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+      g_arm64_ce_aes = (isar0 >> ISAR0_AES_SHIFT) & ISAR0_AES_MASK;
+    }
+
+  return g_arm64_ce_aes;
+}
+
+static inline uint8x16_t aes_enc_block(FAR const uint8x16_t *rk,
+                                       unsigned int rounds, uint8x16_t b)
+{
+  unsigned int i;
+
+  for (i = 0; i < rounds - 1; i++)
+    {
+      b = vaesmcq_u8(vaeseq_u8(b, rk[i]));
+    }
+
+  return veorq_u8(vaeseq_u8(b, rk[rounds - 1]), rk[rounds]);
+}
+
+static inline uint8x16_t aes_dec_block(FAR const uint8x16_t *dk,
+                                       unsigned int rounds, uint8x16_t b)
+{
+  unsigned int i;
+
+  for (i = 0; i < rounds - 1; i++)
+    {
+      b = vaesimcq_u8(vaesdq_u8(b, dk[i]));
+    }
+
+  return veorq_u8(vaesdq_u8(b, dk[rounds - 1]), dk[rounds]);
+}
+
+static inline uint64x2_t clmul(uint64_t a, uint64_t b)
+{
+  return vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+}
+
+/* Multiply in GF(2^128) with the bits in polynomial order, bit n of the
+ * vector is the coefficient of x^n.  GCM numbers the bits of each byte
+ * the other way round, ghash_update() reverses them on load and store.
+ */
+
+static uint64x2_t ghash_mul(uint64x2_t a, uint64x2_t b)
+{
+  uint64x2_t zero = vdupq_n_u64(0);
+  uint64x2_t lo;
+  uint64x2_t hi;
+  uint64x2_t mid;
+  uint64x2_t t;
+
+  lo  = clmul(vgetq_lane_u64(a, 0), vgetq_lane_u64(b, 0));
+  hi  = clmul(vgetq_lane_u64(a, 1), vgetq_lane_u64(b, 1));
+  mid = veorq_u64(clmul(vgetq_lane_u64(a, 0), vgetq_lane_u64(b, 1)),
+                  clmul(vgetq_lane_u64(a, 1), vgetq_lane_u64(b, 0)));
+
+  /* The 256-bit product is hi:lo with mid added at bit 64 */
+
+  lo = veorq_u64(lo, vextq_u64(zero, mid, 1));
+  hi = veorq_u64(hi, vextq_u64(mid, zero, 1));
+
+  /* Fold hi into lo twice, the second fold is at most 14 bits wide */
+
+  t  = clmul(vgetq_lane_u64(hi, 1), GHASH_POLY);
+  lo = veorq_u64(lo, clmul(vgetq_lane_u64(hi, 0), GHASH_POLY));
+  lo = veorq_u64(lo, vextq_u64(zero, t, 1));
+  lo = veorq_u64(lo, clmul(vgetq_lane_u64(t, 1), GHASH_POLY));
+
+  return lo;
+}
+
+static inline uint64x2_t ghash_load(FAR const uint8_t *p)
+{
+  return vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(p)));
+}
+
+static inline void ghash_store(FAR uint8_t *p, uint64x2_t v)
+{
+  vst1q_u8(p, vrbitq_u8(vreinterpretq_u8_u64(v)));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+bool arm64_ce_have_aes(void)
+{
+  return arm64_ce_level() >= ISAR0_AES;
+}
+
+bool arm64_ce_have_pmull(void)
+{
+  return arm64_ce_level() >= ISAR0_PMULL;
+}
+
+void arm64_ce_aes_deckey(FAR uint32_t *dk, FAR const uint32_t *rk,
+                         unsigned int rounds)
+{
+  FAR const uint8_t *src = (FAR const uint8_t *)rk;
+  FAR uint8_t *dst = (FAR uint8_t *)dk;
+  unsigned int i;
+
+  vst1q_u8(dst, vld1q_u8(src + rounds * 16));
+  for (i = 1; i < rounds; i++)
+    {
+      vst1q_u8(dst + i * 16,
+               vaesimcq_u8(vld1q_u8(src + (rounds - i) * 16)));
+    }
+
+  vst1q_u8(dst + rounds * 16, vld1q_u8(src));
+}
+
+void arm64_ce_aes_encrypt(FAR const uint32_t *rk, unsigned int rounds,
+                          FAR const uint8_t *src, FAR uint8_t *dst,
+                          size_t nblocks)
+{
+  uint8x16_t k[AES_MAXROUNDS + 1];
+  unsigned int i;
+
+  for (i = 0; i <= rounds; i++)
+    {
+      k[i] = vld1q_u8((FAR const uint8_t *)rk + i * 16);
+    }
+
+  /* Four independent blocks keep the AES pipeline busy */
+
+  for (; nblocks >= 4; nblocks -= 4, src += 64, dst += 64)
+    {
+      uint8x16_t b0 = vld1q_u8(src);
+      uint8x16_t b1 = vld1q_u8(src + 16);
+      uint8x16_t b2 = vld1q_u8(src + 32);
+      uint8x16_t b3 = vld1q_u8(src + 48);
+
+      for (i = 0; i < rounds - 1; i++)
+        {
+          b0 = vaesmcq_u8(vaeseq_u8(b0, k[i]));
+          b1 = vaesmcq_u8(vaeseq_u8(b1, k[i]));
+          b2 = vaesmcq_u8(vaeseq_u8(b2, k[i]));
+          b3 = vaesmcq_u8(vaeseq_u8(b3, k[i]));
+        }
+
+      vst1q_u8(dst, veorq_u8(vaeseq_u8(b0, k[i]), k[rounds]));
+      vst1q_u8(dst + 16, veorq_u8(vaeseq_u8(b1, k[i]), k[rounds]));
+      vst1q_u8(dst + 32, veorq_u8(vaeseq_u8(b2, k[i]), k[rounds]));
+      vst1q_u8(dst + 48, veorq_u8(vaeseq_u8(b3, k[i]), k[rounds]));
+    }
+
+  for (; nblocks > 0; nblocks--, src += 16, dst += 16)
+    {
+      vst1q_u8(dst, aes_enc_block(k, rounds, vld1q_u8(src)));
+    }
+}
+
+void arm64_ce_aes_decrypt(FAR const uint32_t *dk, unsigned int rounds,
+                          FAR const uint8_t *src, FAR uint8_t *dst,
+                          size_t nblocks)
+{
+  uint8x16_t k[AES_MAXROUNDS + 1];
+  unsigned int i;
+
+  for (i = 0; i <= rounds; i++)
+    {
+      k[i] = vld1q_u8((FAR const uint8_t *)dk + i * 16);
+    }
+
+  for (; nblocks > 0; nblocks--, src += 16, dst += 16)
+    {
+      vst1q_u8(dst, aes_dec_block(k, rounds, vld1q_u8(src)));
+    }
+}
+
+void arm64_ce_ghash_update(FAR GHASH_CTX *ctx, FAR uint8_t *x, size_t len)
+{
+  uint64x2_t h = ghash_load(ctx->H);
+  uint64x2_t z = ghash_load(ctx->Z);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN, x += GMAC_BLOCK_LEN)
+    {
+      z = ghash_mul(veorq_u64(z, ghash_load(x)), h);
+    }
+
+  ghash_store(ctx->S, z);
+  ghash_store(ctx->Z, z);
+}
+
+#ifdef __clang__
+#  pragma clang attribute pop
+#endif
@@ -0,0 +1,66 @@
+/****************************************************************************
+ * crypto/arm64_ce.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_ARM64_CE_H
+#define __CRYPTO_ARM64_CE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+#include <crypto/gmac.h>
+
+#ifdef CONFIG_CRYPTO_ARM64_CE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* CPU feature detection, the result is read once from ID_AA64ISAR0_EL1 */
+
+bool arm64_ce_have_aes(void);
+bool arm64_ce_have_pmull(void);
+
+/* AES with the standard key schedule of aes_keysched_base() in rk, the
+ * decryption path uses the equivalent inverse cipher schedule in dk.
+ */
+
+void arm64_ce_aes_deckey(FAR uint32_t *dk, FAR const uint32_t *rk,
+                         unsigned int rounds);
+void arm64_ce_aes_encrypt(FAR const uint32_t *rk, unsigned int rounds,
+                          FAR const uint8_t *src, FAR uint8_t *dst,
+                          size_t nblocks);
+void arm64_ce_aes_decrypt(FAR const uint32_t *dk, unsigned int rounds,
+                          FAR const uint8_t *src, FAR uint8_t *dst,
+                          size_t nblocks);
+
+/* Drop-in replacement of ghash_update_mi() */
+
+void arm64_ce_ghash_update(FAR GHASH_CTX *ctx, FAR uint8_t *x, size_t len);
+
+#endif /* CONFIG_CRYPTO_ARM64_CE */
+#endif /* __CRYPTO_ARM64_CE_H */
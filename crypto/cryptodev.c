@@ -47,11 +47,25 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 
 #include <crypto/xform.h>
 #include <crypto/cryptodev.h>
 #include <crypto/cryptosoft.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+#  ifdef CONFIG_SCHED_LPWORK
+#    define CRYPTODEV_WORK LPWORK
+#  else
+#    define CRYPTODEV_WORK HPWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -72,6 +86,20 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* A queued operation of CIOCNCRYPTM */
+
+struct cryptodev_req
+{
+  TAILQ_ENTRY(cryptodev_req) next;
+  struct crypt_op cop;
+  uint32_t reqid;
+  int status;
+};
+
+TAILQ_HEAD(cryptodev_reqlist, cryptodev_req);
+#endif
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
@@ -90,6 +118,13 @@ struct csession
   caddr_t mackey;
   int mackeylen;
   int error;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Queued requests, nreqs also counts the one being processed */
+
+  struct cryptodev_reqlist pending;
+  unsigned int nreqs;
+#endif
 };
 
 struct fcrypt
@@ -98,6 +133,16 @@ struct fcrypt
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
   int sesn;
   FAR struct pollfd *fds;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* lock protects the session list against the worker, the session
+   * request queues and the completed requests in done.
+   */
+
+  mutex_t lock;
+  struct work_s work;
+  struct cryptodev_reqlist done;
+#endif
 };
 
 /****************************************************************************
@@ -141,6 +186,12 @@ static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
                                   FAR struct crypt_kop *);
+static int cryptodev_mop(FAR struct fcrypt *, FAR struct crypt_mop *);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static void cryptodev_fcrinit(FAR struct fcrypt *);
+static int cryptodev_nmop(FAR struct fcrypt *, FAR struct crypt_mop *);
+static int cryptodev_nmopret(FAR struct fcrypt *, FAR struct crypt_mop *);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -358,6 +409,13 @@ bail:
             return -EINVAL;
           }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        if (cse->nreqs > 0)
+          {
+            return -EBUSY;
+          }
+#endif
+
         csedelete(fcr, cse);
         error = csefree(cse);
         break;
@@ -371,6 +429,17 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCCRYPTMULTI:
+        error = cryptodev_mop(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCNCRYPTM:
+        error = cryptodev_nmop(fcr, (FAR struct crypt_mop *)arg);
+        break;
+      case CIOCNCRYPTRETM:
+        error = cryptodev_nmopret(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -499,6 +568,181 @@ static int cryptodev_op(FAR struct csession *cse,
   return error;
 }
 
+/* Perform a batch of operations, the result of each is returned in its
+ * status field.
+ */
+
+static int cryptodev_mop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct crypt_n_op *nop;
+  FAR struct csession *cse;
+  unsigned int i;
+
+  if (mop == NULL || (mop->count > 0 && mop->reqs == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < mop->count; i++)
+    {
+      nop = &mop->reqs[i];
+      cse = csefind(fcr, nop->cop.ses);
+      nop->status = cse != NULL ? cryptodev_op(cse, &nop->cop) : -EINVAL;
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static void cryptodev_fcrinit(FAR struct fcrypt *fcr)
+{
+  nxmutex_init(&fcr->lock);
+  TAILQ_INIT(&fcr->done);
+}
+
+/* Run the queued requests of all sessions, one request of each session
+ * per round, so that a long batch does not starve the other sessions.
+ */
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct fcrypt *fcr = arg;
+  FAR struct cryptodev_req *req;
+  FAR struct csession *cse;
+  bool found;
+
+  nxmutex_lock(&fcr->lock);
+  do
+    {
+      found = false;
+      TAILQ_FOREACH(cse, &fcr->csessions, next)
+        {
+          req = TAILQ_FIRST(&cse->pending);
+          if (req == NULL)
+            {
+              continue;
+            }
+
+          /* The session cannot go away while nreqs is not zero */
+
+          TAILQ_REMOVE(&cse->pending, req, next);
+          nxmutex_unlock(&fcr->lock);
+
+          req->status = cryptodev_op(cse, &req->cop);
+
+          nxmutex_lock(&fcr->lock);
+          cse->nreqs--;
+          TAILQ_INSERT_TAIL(&fcr->done, req, next);
+          if (fcr->fds != NULL)
+            {
+              poll_notify(&fcr->fds, 1, POLLIN);
+            }
+
+          found = true;
+        }
+    }
+  while (found);
+
+  nxmutex_unlock(&fcr->lock);
+}
+
+/* Queue a batch of operations.  The status of each is 0 if it was queued,
+ * or a negated errno value if it was rejected.
+ */
+
+static int cryptodev_nmop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_req *req;
+  FAR struct crypt_n_op *nop;
+  FAR struct csession *cse;
+  unsigned int i;
+
+  if (mop == NULL || (mop->count > 0 && mop->reqs == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < mop->count; i++)
+    {
+      nop = &mop->reqs[i];
+      cse = csefind(fcr, nop->cop.ses);
+      if (cse == NULL)
+        {
+          nop->status = -EINVAL;
+          continue;
+        }
+
+      req = kmm_malloc(sizeof(struct cryptodev_req));
+      if (req == NULL)
+        {
+          nop->status = -ENOMEM;
+          continue;
+        }
+
+      req->cop    = nop->cop;
+      req->reqid  = nop->reqid;
+      req->status = 0;
+      nop->status = 0;
+
+      nxmutex_lock(&fcr->lock);
+      TAILQ_INSERT_TAIL(&cse->pending, req, next);
+      cse->nreqs++;
+      nxmutex_unlock(&fcr->lock);
+    }
+
+  /* A worker that is already running picks up the new requests, or runs
+   * once more if it just finished its last round.
+   */
+
+  if (work_available(&fcr->work))
+    {
+      work_queue(CRYPTODEV_WORK, &fcr->work, cryptodev_worker, fcr, 0);
+    }
+
+  return OK;
+}
+
+/* Collect up to count completed requests, count returns their number.
+ * Each returned entry holds the original operation, its reqid and status.
+ */
+
+static int cryptodev_nmopret(FAR struct fcrypt *fcr,
+                             FAR struct crypt_mop *mop)
+{
+  FAR struct cryptodev_req *req;
+  FAR struct crypt_n_op *nop;
+  unsigned int i;
+
+  if (mop == NULL || (mop->count > 0 && mop->reqs == NULL))
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&fcr->lock);
+  for (i = 0; i < mop->count; i++)
+    {
+      req = TAILQ_FIRST(&fcr->done);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      TAILQ_REMOVE(&fcr->done, req, next);
+
+      nop         = &mop->reqs[i];
+      nop->cop    = req->cop;
+      nop->reqid  = req->reqid;
+      nop->status = req->status;
+      kmm_free(req);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+
+  mop->count = i;
+  return i > 0 ? OK : -EAGAIN;
+}
+#endif
+
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
 {
   FAR struct cryptkop *krp_async = NULL;
@@ -848,7 +1092,11 @@ static int cryptof_poll(FAR struct file *filep,
 
   if (setup)
     {
-      if (!TAILQ_EMPTY(&fcr->crpk_ret))
+      if (!TAILQ_EMPTY(&fcr->crpk_ret)
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+          || !TAILQ_EMPTY(&fcr->done)
+#endif
+         )
         {
           poll_notify(&fds, 1, POLLIN);
           return OK;
@@ -875,6 +1123,31 @@ static int cryptof_close(FAR struct file *filep)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_req *req;
+
+  /* Drop the requests that did not run yet and the completions */
+
+  nxmutex_lock(&fcr->lock);
+  TAILQ_FOREACH(cse, &fcr->csessions, next)
+    {
+      while ((req = TAILQ_FIRST(&cse->pending)) != NULL)
+        {
+          TAILQ_REMOVE(&cse->pending, req, next);
+          cse->nreqs--;
+          kmm_free(req);
+        }
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  work_cancel_sync(CRYPTODEV_WORK, &fcr->work);
+
+  while ((req = TAILQ_FIRST(&fcr->done)) != NULL)
+    {
+      TAILQ_REMOVE(&fcr->done, req, next);
+      kmm_free(req);
+    }
+#endif
 
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
@@ -882,6 +1155,10 @@ static int cryptof_close(FAR struct file *filep)
       (void)csefree(cse);
     }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxmutex_destroy(&fcr->lock);
+#endif
+
   kmm_free(fcr);
   filep->f_priv = NULL;
   return 0;
@@ -921,6 +1198,11 @@ static int cryptof_open(FAR struct file *filep)
     }
 
   TAILQ_INIT(&fcrd->csessions);
+  TAILQ_INIT(&fcrd->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_fcrinit(fcrd);
+#endif
+
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1048,6 +1330,9 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         TAILQ_INIT(&fcr->csessions);
         TAILQ_INIT(&fcr->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        cryptodev_fcrinit(fcr);
+#endif
 
         fd = file_allocate_from_inode(&g_cryptoinode, 0, 0, fcr, 0);
         if (fd < 0)
@@ -1088,7 +1373,13 @@ static int csedelete(FAR struct fcrypt *fcr, FAR struct csession *cse_del)
     {
       if (cse == cse_del)
         {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+          nxmutex_lock(&fcr->lock);
+          TAILQ_REMOVE(&fcr->csessions, cse, next);
+          nxmutex_unlock(&fcr->lock);
+#else
           TAILQ_REMOVE(&fcr->csessions, cse, next);
+#endif
           return 1;
         }
     }
@@ -1099,7 +1390,16 @@ static int csedelete(FAR struct fcrypt *fcr, FAR struct csession *cse_del)
 static FAR struct csession *cseadd(FAR struct fcrypt *fcr,
                                    FAR struct csession *cse)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_INIT(&cse->pending);
+  cse->nreqs = 0;
+
+  nxmutex_lock(&fcr->lock);
+  TAILQ_INSERT_TAIL(&fcr->csessions, cse, next);
+  nxmutex_unlock(&fcr->lock);
+#else
   TAILQ_INSERT_TAIL(&fcr->csessions, cse, next);
+#endif
   cse->ses = fcr->sesn++;
   return cse;
 }
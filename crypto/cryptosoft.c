@@ -45,6 +45,8 @@
 #include <crypto/xform.h>
 #include <sys/param.h>
 
+#include "arm64_ce.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -2319,6 +2321,15 @@ void swcr_init(void)
       PANIC();
     }
 
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  /* AES selects its implementation itself, as the key schedule differs */
+
+  if (arm64_ce_have_pmull())
+    {
+      ghash_update = arm64_ce_ghash_update;
+    }
+#endif
+
   algs[CRYPTO_3DES_CBC] = CRYPTO_ALG_FLAG_SUPPORTED;
   algs[CRYPTO_BLF_CBC] = CRYPTO_ALG_FLAG_SUPPORTED;
   algs[CRYPTO_CAST_CBC] = CRYPTO_ALG_FLAG_SUPPORTED;
@@ -41,7 +41,6 @@
  ****************************************************************************/
 
 void ghash_gfmul(FAR uint32_t *, FAR uint32_t *, FAR uint32_t *);
-void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
 
 /* Allow overriding with optimized MD function */
 
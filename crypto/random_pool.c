@@ -40,6 +40,13 @@
 #include <nuttx/mutex.h>
 #include <nuttx/crypto/blake2s.h>
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  include <nuttx/irq.h>
+#  include <nuttx/sched.h>
+
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -47,6 +54,13 @@
 #define ROTL_32(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
 #define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  define RNG_CPU_KEYLEN      32   /* ChaCha20 key */
+#  define RNG_CPU_STREAMLEN   256  /* Four ChaCha20 blocks */
+#  define RNG_CPU_INTERVAL \
+     SEC2TICK(CONFIG_CRYPTO_RANDOM_POOL_PERCPU_INTERVAL)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -73,8 +87,27 @@ struct rng_s
   volatile uint16_t rd_prev_irq;
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  volatile uint32_t generation; /* Incremented by each rng_reseed() */
+#endif
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* Fast key erasure generator of one CPU.  The first RNG_CPU_KEYLEN bytes
+ * of each ChaCha20 output become the next key, the rest is handed out
+ * once and erased.  Only accessed by its CPU with interrupts disabled.
+ */
+
+struct rng_cpu_s
+{
+  uint8_t stream[RNG_CPU_STREAMLEN]; /* Key, then the unused output */
+  uint32_t pos;                      /* First unused byte of stream */
+  uint32_t generation;               /* g_rng.generation when seeded */
+  clock_t reseed;                    /* Time of the last reseed */
+  bool seeded;
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -93,6 +126,10 @@ static struct rng_s g_rng =
   NXMUTEX_INITIALIZER,
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_cpu_s g_rng_cpu[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -306,6 +343,12 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  /* Make the per-CPU generators pick up the new root */
+
+  g_rng.generation++;
+#endif
 }
 
 static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
@@ -359,6 +402,69 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static void rng_cpu_refill(FAR struct rng_cpu_s *cpu)
+{
+  static const uint8_t iv[8];
+  chacha_ctx ctx;
+
+  /* The key is used once, so a fixed nonce and counter are fine */
+
+  chacha_keysetup(&ctx, cpu->stream, RNG_CPU_KEYLEN * 8);
+  chacha_ivsetup(&ctx, iv, NULL);
+
+  memset(cpu->stream, 0, sizeof(cpu->stream));
+  chacha_encrypt_bytes(&ctx, cpu->stream, cpu->stream,
+                       sizeof(cpu->stream));
+  explicit_bzero(&ctx, sizeof(ctx));
+
+  cpu->pos = RNG_CPU_KEYLEN;
+}
+
+static bool rng_cpu_stale(FAR struct rng_cpu_s *cpu)
+{
+  return !cpu->seeded || cpu->generation != g_rng.generation ||
+         g_rng.rd_newentr >= MAX_SEED_NEW_ENTROPY_WORDS ||
+         clock_systime_ticks() - cpu->reseed >= RNG_CPU_INTERVAL;
+}
+
+/* Mix fresh output of the pool generator into the key of the current
+ * CPU.  The task may have moved to another CPU after taking the seed,
+ * the seed is then simply used there.
+ */
+
+static void rng_cpu_reseed(void)
+{
+  uint8_t seed[RNG_CPU_KEYLEN];
+  FAR struct rng_cpu_s *cpu;
+  irqstate_t flags;
+  uint32_t generation;
+  int i;
+
+  nxmutex_lock(&g_rng.rd_lock);
+  rng_buf_internal(seed, sizeof(seed));
+  generation = g_rng.generation;
+  nxmutex_unlock(&g_rng.rd_lock);
+
+  flags = up_irq_save();
+  cpu = &g_rng_cpu[this_cpu()];
+  for (i = 0; i < RNG_CPU_KEYLEN; i++)
+    {
+      cpu->stream[i] ^= seed[i];
+    }
+
+  /* Drop the output that was derived from the previous key */
+
+  rng_cpu_refill(cpu);
+  cpu->generation = generation;
+  cpu->reseed     = clock_systime_ticks();
+  cpu->seeded     = true;
+  up_irq_restore(flags);
+
+  explicit_bzero(seed, sizeof(seed));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -526,7 +632,49 @@ void up_randompool_initialize(void)
 
 void up_rngbuf(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  FAR uint8_t *dst = bytes;
+  FAR struct rng_cpu_s *cpu;
+  irqstate_t flags;
+  size_t chunk;
+
+  if (rng_cpu_stale(&g_rng_cpu[this_cpu()]))
+    {
+      rng_cpu_reseed();
+    }
+
+  /* Copy out in pieces of at most one refill, so that interrupts are not
+   * held off for long and the task may move between the pieces.
+   */
+
+  while (nbytes > 0)
+    {
+      flags = up_irq_save();
+      cpu = &g_rng_cpu[this_cpu()];
+      if (!cpu->seeded)
+        {
+          up_irq_restore(flags);
+          rng_cpu_reseed();
+          continue;
+        }
+
+      if (cpu->pos >= RNG_CPU_STREAMLEN)
+        {
+          rng_cpu_refill(cpu);
+        }
+
+      chunk = MIN(nbytes, RNG_CPU_STREAMLEN - cpu->pos);
+      memcpy(dst, cpu->stream + cpu->pos, chunk);
+      explicit_bzero(cpu->stream + cpu->pos, chunk);
+      cpu->pos += chunk;
+      up_irq_restore(flags);
+
+      dst    += chunk;
+      nbytes -= chunk;
+    }
+#else
   nxmutex_lock(&g_rng.rd_lock);
   rng_buf_internal(bytes, nbytes);
   nxmutex_unlock(&g_rng.rd_lock);
+#endif
 }
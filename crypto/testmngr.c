@@ -32,21 +32,38 @@
 #include <poll.h>
 #include <errno.h>
 #include <debug.h>
+#include <endian.h>
 
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#include <crypto/aes.h>
+#include <crypto/gmac.h>
+
 #ifdef CONFIG_CRYPTO_ALGTEST
 
+#include "arm64_ce.h"
 #include "testmngr.h"
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#define GCM_IV_LEN        12
+
+#define BENCH_BUFSIZE     4096
+#define BENCH_ROUNDS      64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE void (*ghash_func_t)(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+
 #if defined(CONFIG_CRYPTO_AES)
 
 /****************************************************************************
@@ -108,6 +125,173 @@ static int test_aes(void)
 }
 #endif
 
+#ifdef CONFIG_CRYPTO_SW_AES
+
+/* AES-GCM without additional data, built from the software AES and the
+ * given GHASH implementation so that each implementation is checked.
+ */
+
+static int do_test_aes_gcm(FAR struct cipher_testvec *test,
+                           ghash_func_t ghash)
+{
+  FAR const uint8_t *input = (FAR const uint8_t *)test->input;
+  FAR const uint8_t *result = (FAR const uint8_t *)test->result;
+  uint8_t block[GMAC_BLOCK_LEN];
+  uint8_t ctrblk[GMAC_BLOCK_LEN];
+  GHASH_CTX gctx;
+  AES_CTX actx;
+  FAR uint8_t *out;
+  size_t padlen;
+  uint64_t bits;
+  uint32_t ctr;
+  int res;
+  int i;
+  int n;
+
+  padlen = roundup(test->ilen, GMAC_BLOCK_LEN);
+  out = kmm_zalloc(padlen);
+  if (out == NULL || aes_setkey(&actx, (FAR uint8_t *)test->key,
+                                test->klen) < 0)
+    {
+      kmm_free(out);
+      return -1;
+    }
+
+  memset(&gctx, 0, sizeof(gctx));
+  aes_encrypt(&actx, gctx.H, gctx.H);
+
+  /* Counter mode from the block after J0 = IV || 1 */
+
+  memcpy(ctrblk, test->iv, GCM_IV_LEN);
+  for (i = 0; i < test->ilen; i += GMAC_BLOCK_LEN)
+    {
+      ctr = htobe32(i / GMAC_BLOCK_LEN + 2);
+      memcpy(ctrblk + GCM_IV_LEN, &ctr, sizeof(ctr));
+      aes_encrypt(&actx, ctrblk, block);
+      for (n = i; n < test->ilen && n < i + GMAC_BLOCK_LEN; n++)
+        {
+          out[n] = input[n] ^ block[n - i];
+        }
+    }
+
+  /* GHASH of the zero padded ciphertext and the length block */
+
+  ghash(&gctx, out, padlen);
+  memset(block, 0, sizeof(block));
+  bits = htobe64((uint64_t)test->ilen * 8);
+  memcpy(block + 8, &bits, sizeof(bits));
+  ghash(&gctx, block, GMAC_BLOCK_LEN);
+
+  ctr = htobe32(1);
+  memcpy(ctrblk + GCM_IV_LEN, &ctr, sizeof(ctr));
+  aes_encrypt(&actx, ctrblk, block);
+  for (i = 0; i < GMAC_BLOCK_LEN; i++)
+    {
+      block[i] ^= gctx.S[i];
+    }
+
+  res = memcmp(out, result, test->ilen) ||
+        memcmp(block, result + test->ilen, GMAC_BLOCK_LEN);
+
+  kmm_free(out);
+  return res;
+}
+
+static int test_aes_gcm(void)
+{
+  int i;
+
+  for (i = 0; i < nitems(aes_gcm_enc_tv_template); i++)
+    {
+      if (do_test_aes_gcm(aes_gcm_enc_tv_template + i, ghash_update_mi))
+        {
+          crypterr("ERROR: Failed GCM encrypt test #%i\n", i);
+          return -1;
+        }
+
+#ifdef CONFIG_CRYPTO_ARM64_CE
+      if (arm64_ce_have_pmull() &&
+          do_test_aes_gcm(aes_gcm_enc_tv_template + i,
+                          arm64_ce_ghash_update))
+        {
+          crypterr("ERROR: Failed GCM (PMULL) encrypt test #%i\n", i);
+          return -1;
+        }
+#endif
+    }
+
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+static unsigned long bench_kibps(clock_t start)
+{
+  struct timespec ts;
+  uint64_t us;
+
+  perf_convert(perf_gettime() - start, &ts);
+  us = ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+  return us > 0 ? (uint64_t)BENCH_BUFSIZE * BENCH_ROUNDS *
+                  USEC_PER_SEC / 1024 / us : 0;
+}
+
+static void bench_ghash(FAR const char *name, ghash_func_t ghash,
+                        FAR uint8_t *buf)
+{
+  GHASH_CTX gctx;
+  clock_t start;
+  int i;
+
+  memset(&gctx, 0, sizeof(gctx));
+  memset(gctx.H, 0x5a, sizeof(gctx.H));
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_ROUNDS; i++)
+    {
+      ghash(&gctx, buf, BENCH_BUFSIZE);
+    }
+
+  cryptinfo("%-16s %8lu KiB/s\n", name, bench_kibps(start));
+}
+
+/* Report the throughput of the building blocks of AES-GCM */
+
+static void bench_aes_gcm(void)
+{
+  FAR uint8_t *buf;
+  AES_CTX actx;
+  clock_t start;
+  int i;
+
+  buf = kmm_zalloc(BENCH_BUFSIZE);
+  if (buf == NULL)
+    {
+      return;
+    }
+
+  aes_setkey(&actx, buf, 16);
+
+  start = perf_gettime();
+  for (i = 0; i < BENCH_ROUNDS; i++)
+    {
+      aes_encrypt_ecb(&actx, buf, buf, BENCH_BUFSIZE / 16);
+    }
+
+  cryptinfo("%-16s %8lu KiB/s\n", "aes-128-ecb", bench_kibps(start));
+
+  bench_ghash("ghash", ghash_update_mi, buf);
+#ifdef CONFIG_CRYPTO_ARM64_CE
+  if (arm64_ce_have_pmull())
+    {
+      bench_ghash("ghash-pmull", arm64_ce_ghash_update, buf);
+    }
+#endif
+
+  kmm_free(buf);
+}
+#endif /* CONFIG_CRYPTO_ALGTEST_BENCH */
+#endif /* CONFIG_CRYPTO_SW_AES */
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -117,6 +301,17 @@ int crypto_test(void)
     }
 #endif
 
+#ifdef CONFIG_CRYPTO_SW_AES
+  if (test_aes_gcm())
+    {
+      return -1;
+    }
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+  bench_aes_gcm();
+#endif
+#endif
+
   return OK;
 }
 
@@ -29,9 +29,22 @@
 #include <nuttx/irq.h>
 #include <nuttx/audio/audio_dma.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
 
 #include <debug.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The periods follow the ring control block on a cache line boundary */
+
+#define AUDIO_DMA_RING_ALIGN  32
+#define AUDIO_DMA_RING_HDRLEN ALIGN_UP(sizeof(struct audio_ring_s), \
+                                       AUDIO_DMA_RING_ALIGN)
 
 /****************************************************************************
  * Private Types
@@ -51,6 +64,9 @@ struct audio_dma_s
   struct dq_queue_s pendq;
   apb_samp_t buffer_size;
   apb_samp_t buffer_num;
+#ifdef CONFIG_AUDIO_MMAP
+  uint32_t cleaned;   /* Playback periods written back from the cache */
+#endif
 };
 
 /****************************************************************************
@@ -103,6 +119,10 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
                            unsigned long arg);
 static void audio_dma_callback(struct dma_chan_s *chan, void *arg,
                                ssize_t len);
+#ifdef CONFIG_AUDIO_MMAP
+static int audio_dma_mmap(struct audio_lowerhalf_s *dev,
+                          struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -127,12 +147,170 @@ static const struct audio_ops_s g_audio_dma_ops =
   .ioctl = audio_dma_ioctl,
   .reserve = audio_dma_reserve,
   .release = audio_dma_release,
+#ifdef CONFIG_AUDIO_MMAP
+  .mmap = audio_dma_mmap,
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_AUDIO_MMAP
+static uint8_t *audio_dma_period_addr(struct audio_dma_s *audio_dma,
+                                      uint32_t period)
+{
+  struct audio_ring_s *ring = audio_dma->dev.ring;
+
+  return (uint8_t *)ring + ring->data_offset +
+         (period % ring->nperiods) * ring->period_bytes;
+}
+
+/* Write back the playback periods committed since the last call.  This
+ * runs from the period interrupt, so a period must be committed at least
+ * one period before the DMA reaches it.
+ */
+
+static void audio_dma_clean_periods(struct audio_dma_s *audio_dma)
+{
+  struct audio_ring_s *ring = audio_dma->dev.ring;
+  uint32_t appl = ring->appl_period;
+  uint8_t *addr;
+
+  if ((int32_t)(audio_dma->cleaned - ring->hw_period) < 0)
+    {
+      audio_dma->cleaned = ring->hw_period;
+    }
+
+  if ((int32_t)(appl - ring->hw_period) > (int32_t)ring->nperiods)
+    {
+      appl = ring->hw_period + ring->nperiods;
+    }
+
+  for (; (int32_t)(appl - audio_dma->cleaned) > 0; audio_dma->cleaned++)
+    {
+      addr = audio_dma_period_addr(audio_dma, audio_dma->cleaned);
+      up_clean_dcache((uintptr_t)addr,
+                      (uintptr_t)addr + ring->period_bytes);
+    }
+}
+
+/* The DMA has completed one period of the mapped ring */
+
+static void audio_dma_period(struct audio_dma_s *audio_dma)
+{
+  struct audio_ring_s *ring = audio_dma->dev.ring;
+  uint8_t *addr;
+
+  if (audio_dma->playback)
+    {
+      ring->hw_period++;
+      if ((int32_t)(ring->appl_period - ring->hw_period) < 0)
+        {
+          ring->xruns++;
+        }
+
+      audio_dma_clean_periods(audio_dma);
+    }
+  else
+    {
+      addr = audio_dma_period_addr(audio_dma, ring->hw_period);
+      up_invalidate_dcache((uintptr_t)addr,
+                           (uintptr_t)addr + ring->period_bytes);
+
+      ring->hw_period++;
+      if (ring->hw_period - ring->appl_period > ring->nperiods)
+        {
+          ring->xruns++;
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_PERIOD,
+                       NULL, OK, NULL);
+#else
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_PERIOD,
+                       NULL, OK);
+#endif
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+static int audio_dma_munmap(struct task_group_s *group,
+                            struct mm_map_entry_s *entry,
+                            void *start, size_t length)
+{
+  if (group && entry)
+    {
+      vm_unmap_region(entry->vaddr, entry->length);
+      mm_map_remove(get_current_mm(), entry);
+    }
+
+  return OK;
+}
+#endif
+
+/* Map the whole cyclic DMA buffer behind a ring control block.  This
+ * replaces the Audio Pipeline Buffers until the device is shut down.
+ */
+
+static int audio_dma_mmap(struct audio_lowerhalf_s *dev,
+                          struct mm_map_entry_s *map)
+{
+  struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
+  struct audio_ring_s *ring = dev->ring;
+  size_t len;
+  uintptr_t pa;
+
+  len = AUDIO_DMA_RING_HDRLEN +
+        (size_t)audio_dma->buffer_num * audio_dma->buffer_size;
+  if (map->offset != 0 || map->length == 0 || map->length > len)
+    {
+      return -EINVAL;
+    }
+
+  if (ring == NULL)
+    {
+      if (audio_dma->alloc_index != 0)
+        {
+          return -EBUSY;
+        }
+
+      ring = kumm_memalign(AUDIO_DMA_RING_ALIGN, len);
+      if (ring == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(ring, 0, len);
+      ring->flags        = audio_dma->playback ? AUDIO_RING_PLAYBACK : 0;
+      ring->period_bytes = audio_dma->buffer_size;
+      ring->nperiods     = audio_dma->buffer_num;
+      ring->data_offset  = AUDIO_DMA_RING_HDRLEN;
+      up_clean_dcache((uintptr_t)ring, (uintptr_t)ring + len);
+
+      pa = up_addrenv_va_to_pa((uint8_t *)ring + AUDIO_DMA_RING_HDRLEN);
+      if (audio_dma->playback)
+        audio_dma->src_addr = pa;
+      else
+        audio_dma->dst_addr = pa;
+
+      audio_dma->cleaned = 0;
+      dev->ring = ring;
+    }
+
+#ifdef CONFIG_BUILD_KERNEL
+  map->vaddr  = vm_map_region(up_addrenv_va_to_pa(ring), len);
+  map->length = len;
+  map->munmap = audio_dma_munmap;
+  mm_map_add(get_current_mm(), map);
+#else
+  map->vaddr  = ring;
+#endif
+
+  return OK;
+}
+#endif
+
 static int audio_dma_getcaps(struct audio_lowerhalf_s *dev, int type,
                              struct audio_caps_s *caps)
 {
@@ -273,6 +451,14 @@ static int audio_dma_shutdown(struct audio_lowerhalf_s *dev)
 #endif
 #endif
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (dev->ring != NULL)
+    {
+      kumm_free(dev->ring);
+      dev->ring = NULL;
+    }
+#endif
+
   return OK;
 }
 
@@ -284,6 +470,13 @@ static int audio_dma_start(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->dev.ring != NULL && audio_dma->playback)
+    {
+      audio_dma_clean_periods(audio_dma);
+    }
+#endif
+
   return DMA_START_CYCLIC(audio_dma->chan, audio_dma_callback, audio_dma,
                           audio_dma->dst_addr, audio_dma->src_addr,
                           audio_dma->buffer_num * audio_dma->buffer_size,
@@ -366,6 +559,13 @@ static int audio_dma_allocbuffer(struct audio_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->dev.ring != NULL)
+    {
+      return -EBUSY;
+    }
+#endif
+
   if (audio_dma->alloc_index == audio_dma->buffer_num)
     {
       return -ENOMEM;
@@ -476,6 +676,13 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
 
       case AUDIOIOC_SETBUFFERINFO:
         audinfo("AUDIOIOC_GETBUFFERINFO:\n");
+#ifdef CONFIG_AUDIO_MMAP
+        if (audio_dma->dev.ring != NULL)
+          {
+            return -EBUSY;
+          }
+#endif
+
         bufinfo                = (struct ap_buffer_info_s *)arg;
         audio_dma->buffer_size = bufinfo->buffer_size;
         audio_dma->buffer_num  = bufinfo->nbuffers;
@@ -514,6 +721,14 @@ static void audio_dma_callback(struct dma_chan_s *chan,
   struct ap_buffer_s *apb;
   bool final = false;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->dev.ring != NULL)
+    {
+      audio_dma_period(audio_dma);
+      return;
+    }
+#endif
+
   apb = (struct ap_buffer_s *)dq_remfirst(&audio_dma->pendq);
   if (!apb)
     {
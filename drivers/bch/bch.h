@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 
 /****************************************************************************
@@ -42,10 +43,38 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#ifdef CONFIG_BCH_CACHE
+#  define BCH_CACHE_NLINES  (CONFIG_BCH_CACHE_NSETS * CONFIG_BCH_CACHE_NWAYS)
+#  define BCH_LINE_NSECTORS CONFIG_BCH_CACHE_LINESECTORS
+#  if (CONFIG_BCH_CACHE_NSETS & (CONFIG_BCH_CACHE_NSETS - 1)) != 0
+#    error CONFIG_BCH_CACHE_NSETS must be a power of two
+#  endif
+#  if defined(CONFIG_SCHED_WORKQUEUE) && CONFIG_BCH_CACHE_FLUSH_MSEC > 0
+#    define BCH_CACHE_FLUSHER 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_BCH_CACHE
+/* One line of the sector cache: BCH_LINE_NSECTORS consecutive sectors,
+ * starting at a multiple of BCH_LINE_NSECTORS.  Lines are grouped into
+ * CONFIG_BCH_CACHE_NSETS sets of CONFIG_BCH_CACHE_NWAYS lines, the set of
+ * a line being chosen by the low bits of its line number.
+ */
+
+struct bch_cacheline_s
+{
+  size_t block;            /* Line number, (size_t)-1 if unused */
+  uint32_t stamp;          /* Time of last use, for LRU replacement */
+  uint32_t valid;          /* Bitmap of the sectors in the line */
+  uint32_t dirty;          /* Bitmap of the sectors to write back */
+  FAR uint8_t *data;       /* The sectors of the line */
+};
+#endif
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
@@ -59,6 +88,20 @@ struct bchlib_s
   bool unlinked;           /* true: The driver has been unlinked */
   FAR uint8_t *buffer;     /* One sector buffer */
 
+#ifdef CONFIG_BCH_CACHE
+  /* With the cache, 'buffer' and 'sector' refer to the last sector
+   * returned by bchlib_readsector() within its cache line.
+   */
+
+  FAR struct bch_cacheline_s *line;  /* The line holding 'sector' */
+  FAR struct bch_cacheline_s *lines; /* All of the cache lines */
+  FAR uint8_t *cache;                /* Data of all of the cache lines */
+  uint32_t stamp;                    /* Use counter for the LRU */
+#  ifdef BCH_CACHE_FLUSHER
+  struct work_s work;                /* Delayed write back */
+#  endif
+#endif
+
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
 #endif
@@ -85,6 +128,10 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool discard);
+EXTERN void bchlib_freecache(FAR struct bchlib_s *bch);
 
 #undef EXTERN
 #if defined(__cplusplus)
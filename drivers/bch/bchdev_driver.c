@@ -437,9 +437,9 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case BIOC_DISCARD:
         {
-          /* Invalidate the sector so next read is from the device- */
+          /* Invalidate the sectors so next read is from the device */
 
-          bch->sector = (size_t)-1;
+          bchlib_flushsector(bch, true);
           goto ioctl_default;
         }
 
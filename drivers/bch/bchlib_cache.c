@@ -27,12 +27,16 @@
 #include <nuttx/config.h>
 #include <nuttx/kmalloc.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+
 #include "bch.h"
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -62,10 +66,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -73,7 +78,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -91,6 +96,213 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+#ifdef CONFIG_BCH_CACHE
+/****************************************************************************
+ * Name: bch_writeline
+ *
+ * Description:
+ *   Write back the dirty sectors of a cache line, each run of adjacent
+ *   dirty sectors with a single multi-sector write.
+ *
+ ****************************************************************************/
+
+static int bch_writeline(FAR struct bchlib_s *bch,
+                         FAR struct bch_cacheline_s *line)
+{
+  FAR struct inode *inode = bch->inode;
+  size_t first = line->block * BCH_LINE_NSECTORS;
+  FAR uint8_t *data;
+  ssize_t ret;
+  int start;
+  int end;
+#if defined(CONFIG_BCH_ENCRYPTION)
+  int i;
+#endif
+
+  for (start = 0; line->dirty != 0; start = end)
+    {
+      /* Find the next run of dirty sectors [start, end) */
+
+      while ((line->dirty & (UINT32_C(1) << start)) == 0)
+        {
+          start++;
+        }
+
+      for (end = start + 1; end < BCH_LINE_NSECTORS &&
+           (line->dirty & (UINT32_C(1) << end)) != 0; end++)
+        {
+        }
+
+      data = line->data + start * bch->sectsize;
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+      for (i = start; i < end; i++)
+        {
+          bch_cypher(bch, line->data + i * bch->sectsize, first + i,
+                     CYPHER_ENCRYPT);
+        }
+#endif
+
+      nxsched_iowait_enter();
+      ret = inode->u.i_bops->write(inode, data, first + start, end - start);
+      nxsched_iowait_leave();
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+      for (i = start; i < end; i++)
+        {
+          bch_cypher(bch, line->data + i * bch->sectsize, first + i,
+                     CYPHER_DECRYPT);
+        }
+#endif
+
+      if (ret < 0)
+        {
+          ferr("Write failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+      line->dirty &= ~(((UINT32_C(1) << (end - start)) - 1) << start);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bch_invalidate
+ ****************************************************************************/
+
+static void bch_invalidate(FAR struct bch_cacheline_s *line)
+{
+  line->block = (size_t)-1;
+  line->valid = 0;
+  line->dirty = 0;
+}
+
+/****************************************************************************
+ * Name: bch_allocache
+ ****************************************************************************/
+
+static int bch_allocache(FAR struct bchlib_s *bch)
+{
+  size_t linesize = BCH_LINE_NSECTORS * bch->sectsize;
+  int i;
+
+  bch->lines = kmm_malloc(BCH_CACHE_NLINES *
+                          sizeof(struct bch_cacheline_s));
+  if (bch->lines == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+  bch->cache = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                            BCH_CACHE_NLINES * linesize);
+#else
+  bch->cache = kmm_malloc(BCH_CACHE_NLINES * linesize);
+#endif
+  if (bch->cache == NULL)
+    {
+      kmm_free(bch->lines);
+      bch->lines = NULL;
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < BCH_CACHE_NLINES; i++)
+    {
+      bch->lines[i].data  = bch->cache + i * linesize;
+      bch->lines[i].stamp = 0;
+      bch_invalidate(&bch->lines[i]);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bch_getline
+ *
+ * Description:
+ *   Return the cache line of a line number.  On a miss, the least recently
+ *   used line of the set is written back and reused.
+ *
+ ****************************************************************************/
+
+static int bch_getline(FAR struct bchlib_s *bch, size_t block,
+                       FAR struct bch_cacheline_s **pline)
+{
+  FAR struct bch_cacheline_s *set;
+  FAR struct bch_cacheline_s *victim;
+  int ret;
+  int i;
+
+  set = &bch->lines[(block & (CONFIG_BCH_CACHE_NSETS - 1)) *
+                    CONFIG_BCH_CACHE_NWAYS];
+  victim = set;
+
+  for (i = 0; i < CONFIG_BCH_CACHE_NWAYS; i++)
+    {
+      if (set[i].block == block)
+        {
+          victim = &set[i];
+          goto found;
+        }
+
+      if (set[i].block == (size_t)-1)
+        {
+          if (victim->block != (size_t)-1)
+            {
+              victim = &set[i];
+            }
+        }
+      else if (victim->block != (size_t)-1 &&
+               (int32_t)(set[i].stamp - victim->stamp) < 0)
+        {
+          victim = &set[i];
+        }
+    }
+
+  ret = bch_writeline(bch, victim);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  bch_invalidate(victim);
+  victim->block = block;
+
+found:
+  victim->stamp = ++bch->stamp;
+  *pline = victim;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bch_flushwork
+ *
+ * Description:
+ *   The work item writing back the dirty sectors some time after they
+ *   were written.
+ *
+ ****************************************************************************/
+
+#ifdef BCH_CACHE_FLUSHER
+static void bch_flushwork(FAR void *arg)
+{
+  FAR struct bchlib_s *bch = arg;
+
+  nxmutex_lock(&bch->lock);
+  if (bchlib_flushsector(bch, false) < 0)
+    {
+      /* Try again later */
+
+      work_queue(LPWORK, &bch->work, bch_flushwork, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_FLUSH_MSEC));
+    }
+
+  nxmutex_unlock(&bch->lock);
+}
+#endif
+#endif /* CONFIG_BCH_CACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,7 +311,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the current contents of the sector buffer (if dirty), or of all
+ *   of the sector cache.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -108,6 +321,32 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 
 int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 {
+#ifdef CONFIG_BCH_CACHE
+  int result = OK;
+  int ret;
+  int i;
+
+  for (i = 0; bch->lines != NULL && i < BCH_CACHE_NLINES; i++)
+    {
+      ret = bch_writeline(bch, &bch->lines[i]);
+      if (ret < 0 && result == OK)
+        {
+          result = ret;
+        }
+
+      if (discard)
+        {
+          bch_invalidate(&bch->lines[i]);
+        }
+    }
+
+  if (discard)
+    {
+      bch->sector = (size_t)-1;
+    }
+
+  return result;
+#else
   FAR struct inode *inode;
   ssize_t ret = OK;
 
@@ -122,12 +361,14 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
 
+      nxsched_iowait_enter();
       ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+      nxsched_iowait_leave();
       if (ret < 0)
         {
           ferr("Write failed: %zd\n", ret);
@@ -139,7 +380,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -153,6 +394,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
     }
 
   return (int)ret;
+#endif
 }
 
 /****************************************************************************
@@ -168,6 +410,53 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
+#ifdef CONFIG_BCH_CACHE
+  FAR struct bch_cacheline_s *line;
+  FAR struct inode *inode = bch->inode;
+  uint32_t bit = UINT32_C(1) << (sector % BCH_LINE_NSECTORS);
+  FAR uint8_t *data;
+  ssize_t ret;
+
+  if (bch->lines == NULL)
+    {
+      ret = bch_allocache(bch);
+      if (ret < 0)
+        {
+          ferr("Failed to allocate sector cache\n");
+          return (int)ret;
+        }
+    }
+
+  ret = bch_getline(bch, sector / BCH_LINE_NSECTORS, &line);
+  if (ret < 0)
+    {
+      ferr("Flush failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  data = line->data + (sector % BCH_LINE_NSECTORS) * bch->sectsize;
+  if ((line->valid & bit) == 0)
+    {
+      nxsched_iowait_enter();
+      ret = inode->u.i_bops->read(inode, data, sector, 1);
+      nxsched_iowait_leave();
+      if (ret < 0)
+        {
+          ferr("Read failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+      bch_cypher(bch, data, sector, CYPHER_DECRYPT);
+#endif
+      line->valid |= bit;
+    }
+
+  bch->line   = line;
+  bch->buffer = data;
+  bch->sector = sector;
+  return OK;
+#else
   FAR struct inode *inode;
   ssize_t ret = OK;
 
@@ -196,7 +485,9 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
           return (int)ret;
         }
 
+      nxsched_iowait_enter();
       ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      nxsched_iowait_leave();
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
@@ -205,9 +496,148 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 
       bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
     }
 
   return (int)ret;
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Mark the sector returned by the last bchlib_readsector() as modified.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch)
+{
+#ifdef CONFIG_BCH_CACHE
+  bch->line->dirty |= UINT32_C(1) << (bch->sector % BCH_LINE_NSECTORS);
+
+#  ifdef BCH_CACHE_FLUSHER
+  if (work_available(&bch->work))
+    {
+      work_queue(LPWORK, &bch->work, bch_flushwork, bch,
+                 MSEC2TICK(CONFIG_BCH_CACHE_FLUSH_MSEC));
+    }
+#  endif
+#else
+  bch->dirty = true;
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Prepare for a direct transfer of the sectors [sector, sector +
+ *   nsectors) between the block driver and the user buffer: write back the
+ *   cached changes to those sectors, and with 'discard', forget the cached
+ *   copies of the sectors that the transfer is going to overwrite.
+ *
+ *   Without the cache, the dirty sector is always written back before a
+ *   direct write to keep the sector sequence.  With the cache, the other
+ *   dirty sectors are left for later, so that they may still be written
+ *   together.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool discard)
+{
+#ifdef CONFIG_BCH_CACHE
+  FAR struct bch_cacheline_s *line;
+  uint32_t mask;
+  size_t first;
+  size_t lo;
+  size_t hi;
+  int ret;
+  int i;
+
+  for (i = 0; bch->lines != NULL && i < BCH_CACHE_NLINES; i++)
+    {
+      line = &bch->lines[i];
+      if (line->block == (size_t)-1)
+        {
+          continue;
+        }
+
+      first = line->block * BCH_LINE_NSECTORS;
+      lo    = MAX(first, sector);
+      hi    = MIN(first + BCH_LINE_NSECTORS, sector + nsectors);
+      if (lo >= hi)
+        {
+          continue;
+        }
+
+      mask = (hi - lo == 32 ? UINT32_MAX :
+              (UINT32_C(1) << (hi - lo)) - 1) << (lo - first);
+
+      if (discard)
+        {
+          line->valid &= ~mask;
+          line->dirty &= ~mask;
+        }
+      else if ((line->dirty & mask) != 0)
+        {
+          ret = bch_writeline(bch, line);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+#else
+  bool overlap = sector <= bch->sector && bch->sector < sector + nsectors;
+
+  if (!discard && !overlap)
+    {
+      return OK;
+    }
+
+  return bchlib_flushsector(bch, discard && overlap);
+#endif
+}
+
+/****************************************************************************
+ * Name: bchlib_freecache
+ *
+ * Description:
+ *   Release the sector buffer or cache.  The dirty sectors should have
+ *   been flushed.
+ *
+ ****************************************************************************/
+
+void bchlib_freecache(FAR struct bchlib_s *bch)
+{
+#ifdef CONFIG_BCH_CACHE
+#  ifdef BCH_CACHE_FLUSHER
+  work_cancel_sync(LPWORK, &bch->work);
+#  endif
+
+  if (bch->lines != NULL)
+    {
+      kmm_free(bch->cache);
+      kmm_free(bch->lines);
+      bch->lines = NULL;
+    }
+#else
+  if (bch->buffer)
+    {
+      kmm_free(bch->buffer);
+    }
+#endif
+
+  bch->buffer = NULL;
 }
@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/drivers/drivers.h>
 
 #include "bch.h"
@@ -148,8 +149,19 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* Write back any cached change to those sectors first */
+
+      ret = bchlib_flushrange(bch, sector, nsectors, false);
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
+      nxsched_iowait_enter();
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
+      nxsched_iowait_leave();
       if (ret < 0)
         {
           ferr("ERROR: Read failed: %d\n", ret);
@@ -72,11 +72,7 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
-  if (bch->buffer)
-    {
-      kmm_free(bch->buffer);
-    }
-
+  bchlib_freecache(bch);
   nxmutex_destroy(&bch->lock);
   kmm_free(bch);
   return OK;
@@ -34,6 +34,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/drivers/drivers.h>
 
@@ -107,7 +108,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust pointers and counts */
 
@@ -144,8 +145,9 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       nbytes = len > bch->sectsize ? bch->sectsize : len;
       memcpy(bch->buffer, buffer, nbytes);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
+#ifndef CONFIG_BCH_CACHE
       /* Write the sector back to the block device */
 
       ret = bchlib_flushsector(bch, false);
@@ -154,6 +156,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           ferr("ERROR: Flush failed: %d\n", ret);
           return ret;
         }
+#endif
 
       /* Adjust pointers and counts */
 
@@ -177,8 +180,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Flush the dirty sector to keep the sector sequence */
 
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
+      ret = bchlib_flushrange(bch, sector, nsectors, true);
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -187,8 +189,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Write the contiguous sectors */
 
+      nxsched_iowait_enter();
       ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
                                         sector, nsectors);
+      nxsched_iowait_leave();
       if (ret < 0)
         {
           ferr("ERROR: Write failed: %d\n", ret);
@@ -225,7 +229,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       /* Copy the head end of the sector from the user buffer */
 
       memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      bchlib_dirtysector(bch);
 
       /* Adjust counts */
 
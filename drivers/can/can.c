@@ -96,6 +96,13 @@
 #ifdef CONFIG_CAN_TXREADY
 static void           can_txready_work(FAR void *arg);
 #endif
+static void           can_rxflush(FAR struct can_rxfifo_s *fifo);
+#if CONFIG_CAN_NSWFILTERS > 0
+static int            can_swfilter_ioctl(FAR struct can_dev_s *dev,
+                                         int cmd, unsigned long arg);
+static bool           can_swfilter_match(FAR struct can_dev_s *dev,
+                                         FAR const struct can_hdr_s *hdr);
+#endif
 
 /* Character driver methods */
 
@@ -188,6 +195,188 @@ static void can_txready_work(FAR void *arg)
 }
 #endif
 
+/****************************************************************************
+ * Name: can_rxflush
+ *
+ * Description:
+ *   Discard the messages in a reader's FIFO.  If a reader is copying
+ *   messages out, it does the flush when it updates the head.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+static void can_rxflush(FAR struct can_rxfifo_s *fifo)
+{
+  if (fifo->rx_busy)
+    {
+      fifo->rx_flush = true;
+    }
+  else
+    {
+      fifo->rx_head = fifo->rx_tail;
+      nxsem_trywait(&fifo->rx_sem);
+    }
+}
+
+#if CONFIG_CAN_NSWFILTERS > 0
+/****************************************************************************
+ * Name: can_swfilter_ioctl
+ *
+ * Description:
+ *   Handle the filter ioctl commands for a lower half that does not
+ *   implement them.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+static int can_swfilter_ioctl(FAR struct can_dev_s *dev, int cmd,
+                              unsigned long arg)
+{
+  FAR struct can_swfilter_s *filter;
+  uint32_t id1;
+  uint32_t id2;
+  uint8_t type;
+  bool extid = (cmd == CANIOC_ADD_EXTFILTER || cmd == CANIOC_DEL_EXTFILTER);
+  int i;
+
+  if (cmd == CANIOC_DEL_STDFILTER || cmd == CANIOC_DEL_EXTFILTER)
+    {
+      if (arg >= CONFIG_CAN_NSWFILTERS)
+        {
+          return -EINVAL;
+        }
+
+      filter = &dev->cd_filters[arg];
+      if (filter->sw_type == 0 || filter->sw_extid != extid)
+        {
+          return -EINVAL;
+        }
+
+      filter->sw_type = 0;
+      return OK;
+    }
+
+#ifdef CONFIG_CAN_EXTID
+  if (extid)
+    {
+      FAR const struct canioc_extfilter_s *xf =
+        (FAR const struct canioc_extfilter_s *)((uintptr_t)arg);
+
+      id1  = xf->xf_id1;
+      id2  = xf->xf_id2;
+      type = xf->xf_type;
+    }
+  else
+#endif
+    {
+      FAR const struct canioc_stdfilter_s *sf =
+        (FAR const struct canioc_stdfilter_s *)((uintptr_t)arg);
+
+      id1  = sf->sf_id1;
+      id2  = sf->sf_id2;
+      type = sf->sf_type;
+    }
+
+  if (type > CAN_FILTER_RANGE)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < CONFIG_CAN_NSWFILTERS; i++)
+    {
+      filter = &dev->cd_filters[i];
+      if (filter->sw_type == 0)
+        {
+          filter->sw_id1   = id1;
+          filter->sw_id2   = id2;
+          filter->sw_extid = extid;
+          filter->sw_type  = type + 1;
+          return i;
+        }
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: can_swfilter_match
+ *
+ * Description:
+ *   Return true if the message passes the upper half filters.  With no
+ *   filter set every message passes, error messages always do.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled
+ *
+ ****************************************************************************/
+
+static bool can_swfilter_match(FAR struct can_dev_s *dev,
+                               FAR const struct can_hdr_s *hdr)
+{
+  FAR const struct can_swfilter_s *filter;
+  uint32_t id = hdr->ch_id;
+  bool extid = false;
+  bool used = false;
+  int i;
+
+#ifdef CONFIG_CAN_ERRORS
+  if (hdr->ch_error)
+    {
+      return true;
+    }
+#endif
+
+#ifdef CONFIG_CAN_EXTID
+  extid = hdr->ch_extid;
+#endif
+
+  for (i = 0; i < CONFIG_CAN_NSWFILTERS; i++)
+    {
+      filter = &dev->cd_filters[i];
+      if (filter->sw_type == 0)
+        {
+          continue;
+        }
+
+      used = true;
+      if (filter->sw_extid != extid)
+        {
+          continue;
+        }
+
+      switch (filter->sw_type - 1)
+        {
+          case CAN_FILTER_MASK:
+            if (((id ^ filter->sw_id1) & filter->sw_id2) == 0)
+              {
+                return true;
+              }
+            break;
+
+          case CAN_FILTER_DUAL:
+            if (id == filter->sw_id1 || id == filter->sw_id2)
+              {
+                return true;
+              }
+            break;
+
+          default:
+            if (id >= filter->sw_id1 && id <= filter->sw_id2)
+              {
+                return true;
+              }
+            break;
+        }
+    }
+
+  return !used;
+}
+#endif
+
 static FAR struct can_reader_s *init_can_reader(FAR struct file *filep)
 {
   FAR struct can_reader_s *reader = kmm_zalloc(sizeof(struct can_reader_s));
@@ -384,6 +573,8 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
   FAR struct can_rxfifo_s *fifo;
   unsigned int             msgalign;
   irqstate_t               flags;
+  uint16_t                 head;
+  uint16_t                 tail;
   int                      ret = 0;
 
   caninfo("buflen: %zu\n", buflen);
@@ -465,14 +656,21 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
         }
 
       /* The cd_recv FIFO is not empty.  Copy all buffered data that will fit
-       * in the user buffer.
+       * in the user buffer.  Holding rx_sem keeps the other readers out and
+       * can_receive() only writes behind the tail, so the copy is done with
+       * interrupts enabled.
        */
 
+      head = fifo->rx_head;
+      tail = fifo->rx_tail;
+      fifo->rx_busy = true;
+      leave_critical_section(flags);
+
       do
         {
           /* Will the next message in the FIFO fit into the user buffer? */
 
-          FAR struct can_msg_s *msg = &fifo->rx_buffer[fifo->rx_head];
+          FAR struct can_msg_s *msg = &fifo->rx_buffer[head];
           int nbytes = can_dlc2bytes(msg->cm_hdr.ch_dlc);
           int msglen = CAN_MSGLEN(nbytes);
 
@@ -495,13 +693,24 @@ static ssize_t can_read(FAR struct file *filep, FAR char *buffer,
 
           /* Increment the head of the circular message buffer */
 
-          if (++fifo->rx_head >= CONFIG_CAN_RXFIFOSIZE)
+          if (++head >= CONFIG_CAN_RXFIFOSIZE)
             {
-              fifo->rx_head = 0;
+              head = 0;
             }
         }
-      while (fifo->rx_head != fifo->rx_tail && msgalign != 0);
+      while (head != tail && msgalign != 0);
+
+      /* Release the copied messages, or all of them if a flush came in */
+
+      flags = enter_critical_section();
+      fifo->rx_busy = false;
+      if (fifo->rx_flush)
+        {
+          fifo->rx_flush = false;
+          head = fifo->rx_tail;
+        }
 
+      fifo->rx_head = head;
       if (fifo->rx_head != fifo->rx_tail)
         {
           /* The user's buffer was too small, so some messages remain in the
@@ -953,8 +1162,7 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case CANIOC_IFLUSH:
         {
-          reader->fifo.rx_head = 0;
-          reader->fifo.rx_tail = 0;
+          can_rxflush(&reader->fifo);
 
           /* invoke lower half ioctl */
 
@@ -981,9 +1189,7 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case CANIOC_IOFLUSH:
         {
           can_sender_init(&dev->cd_sender);
-
-          reader->fifo.rx_head = 0;
-          reader->fifo.rx_tail = 0;
+          can_rxflush(&reader->fifo);
 
           /* invoke lower half ioctl */
 
@@ -1004,11 +1210,17 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       case FIONREAD:
         {
-          *(FAR uint8_t *)arg =
+          int count = reader->fifo.rx_tail - reader->fifo.rx_head;
+
+          if (count < 0)
+            {
+              count += CONFIG_CAN_RXFIFOSIZE;
+            }
+
 #ifdef CONFIG_CAN_ERRORS
-                            (reader->fifo.rx_error != 0) +
+          count += reader->fifo.rx_error != 0;
 #endif
-                            reader->fifo.rx_tail - reader->fifo.rx_head;
+          *(FAR uint8_t *)arg = MIN(count, UINT8_MAX);
         }
         break;
 
@@ -1075,6 +1287,27 @@ static int can_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#if CONFIG_CAN_NSWFILTERS > 0
+      /* Acceptance filters: Set up in the hardware if the lower half can,
+       * else kept by the upper half and applied in can_receive().
+       */
+
+      case CANIOC_ADD_STDFILTER:
+      case CANIOC_DEL_STDFILTER:
+#ifdef CONFIG_CAN_EXTID
+      case CANIOC_ADD_EXTFILTER:
+      case CANIOC_DEL_EXTFILTER:
+#endif
+        {
+          ret = dev_ioctl(dev, cmd, arg);
+          if (ret == -ENOTTY)
+            {
+              ret = can_swfilter_ioctl(dev, cmd, arg);
+            }
+        }
+        break;
+#endif
+
       /* Not a "built-in" ioctl command.. perhaps it is unique to this
        * lower-half, device driver.
        */
@@ -1285,9 +1518,23 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
   int                      i;
   int                      sval;
   bool                     was_empty;
+#ifdef CONFIG_CAN_TIMESTAMP
+  struct timespec          ts;
+  bool                     stamp;
+#endif
 
   caninfo("ID: %" PRId32 " DLC: %d\n", (uint32_t)hdr->ch_id, hdr->ch_dlc);
 
+#ifdef CONFIG_CAN_TIMESTAMP
+  /* Stamp the message now if the lower half has no hardware timestamp */
+
+  stamp = hdr->ch_ts.tv_sec == 0 && hdr->ch_ts.tv_usec == 0;
+  if (stamp)
+    {
+      clock_systime_timespec(&ts);
+    }
+#endif
+
   flags = enter_critical_section();
 
   /* Check if adding this new message would over-run the drivers ability to
@@ -1345,6 +1592,18 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
         }
     }
 
+#if CONFIG_CAN_NSWFILTERS > 0
+  /* Drop the message here, before it is copied to every reader, if the
+   * upper half filters reject it.
+   */
+
+  if (!can_swfilter_match(dev, hdr))
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+#endif
+
   list_for_every(&dev->cd_readers, node)
     {
       FAR struct can_reader_s *reader = (FAR struct can_reader_s *)node;
@@ -1376,6 +1635,16 @@ int can_receive(FAR struct can_dev_s *dev, FAR struct can_hdr_s *hdr,
           memcpy(&fifo->rx_buffer[fifo->rx_tail].cm_hdr, hdr,
                  sizeof(struct can_hdr_s));
 
+#ifdef CONFIG_CAN_TIMESTAMP
+          if (stamp)
+            {
+              fifo->rx_buffer[fifo->rx_tail].cm_hdr.ch_ts.tv_sec  =
+                ts.tv_sec;
+              fifo->rx_buffer[fifo->rx_tail].cm_hdr.ch_ts.tv_usec =
+                ts.tv_nsec / 1000;
+            }
+#endif
+
           nbytes = can_dlc2bytes(hdr->ch_dlc);
           if (nbytes)
             {
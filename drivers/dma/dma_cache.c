@@ -0,0 +1,87 @@
+/****************************************************************************
+ * drivers/dma/dma_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+#include <nuttx/cache.h>
+
+#include <sys/uio.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* These are the defaults for the architectures whose per-range operations
+ * cannot be split from their barriers.  Each buffer then pays for its own.
+ */
+
+/****************************************************************************
+ * Name: up_invalidate_dcache_iov
+ ****************************************************************************/
+
+void weak_function up_invalidate_dcache_iov(FAR const struct iovec *iov,
+                                            int iovcnt)
+{
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      up_invalidate_dcache((uintptr_t)iov[i].iov_base,
+                           (uintptr_t)iov[i].iov_base + iov[i].iov_len);
+    }
+}
+
+/****************************************************************************
+ * Name: up_clean_dcache_iov
+ ****************************************************************************/
+
+void weak_function up_clean_dcache_iov(FAR const struct iovec *iov,
+                                       int iovcnt)
+{
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      up_clean_dcache((uintptr_t)iov[i].iov_base,
+                      (uintptr_t)iov[i].iov_base + iov[i].iov_len);
+    }
+}
+
+/****************************************************************************
+ * Name: up_flush_dcache_iov
+ ****************************************************************************/
+
+void weak_function up_flush_dcache_iov(FAR const struct iovec *iov,
+                                       int iovcnt)
+{
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      up_flush_dcache((uintptr_t)iov[i].iov_base,
+                      (uintptr_t)iov[i].iov_base + iov[i].iov_len);
+    }
+}
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * drivers/dma/dma_pool.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/dma/dma_pool.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dma_pool_s
+{
+  sq_queue_t free;     /* The free blocks, linked through their first word */
+  spinlock_t lock;     /* Protects free */
+  uintptr_t  start;    /* The first block */
+  uintptr_t  end;      /* The end of the last block */
+  size_t     blksize;  /* The size of one block */
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_pool_initialize
+ *
+ * Description:
+ *   Create a pool of fixed size blocks in a memory region set aside for
+ *   DMA.
+ *
+ ****************************************************************************/
+
+FAR struct dma_pool_s *dma_pool_initialize(FAR void *base, size_t size,
+                                           size_t blksize)
+{
+  FAR struct dma_pool_s *pool;
+  size_t align = up_get_dcache_linesize();
+  uintptr_t start;
+  uintptr_t end;
+  uintptr_t blk;
+
+  if (align < sizeof(uintptr_t))
+    {
+      align = sizeof(uintptr_t);
+    }
+
+  if (blksize < sizeof(sq_entry_t))
+    {
+      blksize = sizeof(sq_entry_t);
+    }
+
+  blksize = ALIGN_UP(blksize, align);
+  start   = ALIGN_UP((uintptr_t)base, align);
+  end     = (uintptr_t)base + size;
+
+  if (start >= end || end - start < blksize)
+    {
+      return NULL;
+    }
+
+  pool = kmm_zalloc(sizeof(struct dma_pool_s));
+  if (pool == NULL)
+    {
+      return NULL;
+    }
+
+  sq_init(&pool->free);
+  spin_lock_init(&pool->lock);
+  pool->start   = start;
+  pool->blksize = blksize;
+
+  for (blk = start; end - blk >= blksize; blk += blksize)
+    {
+      sq_addlast((FAR sq_entry_t *)blk, &pool->free);
+    }
+
+  pool->end = blk;
+  return pool;
+}
+
+/****************************************************************************
+ * Name: dma_pool_uninitialize
+ *
+ * Description:
+ *   Release a pool.
+ *
+ ****************************************************************************/
+
+void dma_pool_uninitialize(FAR struct dma_pool_s *pool)
+{
+  kmm_free(pool);
+}
+
+/****************************************************************************
+ * Name: dma_pool_alloc
+ *
+ * Description:
+ *   Take a block from a pool.
+ *
+ ****************************************************************************/
+
+FAR void *dma_pool_alloc(FAR struct dma_pool_s *pool)
+{
+  FAR void *blk;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&pool->lock);
+  blk   = sq_remfirst(&pool->free);
+  spin_unlock_irqrestore(&pool->lock, flags);
+
+  return blk;
+}
+
+/****************************************************************************
+ * Name: dma_pool_free
+ *
+ * Description:
+ *   Return a block to its pool.
+ *
+ ****************************************************************************/
+
+void dma_pool_free(FAR struct dma_pool_s *pool, FAR void *blk)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT((uintptr_t)blk >= pool->start &&
+              (uintptr_t)blk < pool->end &&
+              ((uintptr_t)blk - pool->start) % pool->blksize == 0);
+
+  flags = spin_lock_irqsave(&pool->lock);
+  sq_addfirst((FAR sq_entry_t *)blk, &pool->free);
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
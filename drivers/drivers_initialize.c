@@ -144,6 +144,14 @@ void drivers_initialize(void)
   devmem_register();
 #endif
 
+#ifdef CONFIG_DEV_PERF
+  devperf_register();
+#endif
+
+#ifdef CONFIG_DEV_BENCH
+  devbench_register();
+#endif
+
 #if defined(CONFIG_DEV_LOOP)
   loop_register();      /* Standard /dev/loop */
 #endif
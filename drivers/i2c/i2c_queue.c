@@ -0,0 +1,318 @@
+/****************************************************************************
+ * drivers/i2c/i2c_queue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/i2c/i2c_master.h>
+
+#ifdef CONFIG_I2C_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct i2c_queue_s
+{
+  FAR struct i2c_master_s *i2c;  /* The bus served by this queue */
+  sq_queue_t            pending; /* Requests by decreasing priority */
+  spinlock_t            lock;    /* Protects pending */
+  sem_t                 sem;     /* Posted once per submitted request */
+  pid_t                 pid;     /* The queue thread */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_wakeup
+ *
+ * Description:
+ *   Completion callback of i2c_queue_transfer().
+ *
+ ****************************************************************************/
+
+static void i2c_queue_wakeup(FAR struct i2c_request_s *req, FAR void *arg)
+{
+  nxsem_post((FAR sem_t *)arg);
+}
+
+/****************************************************************************
+ * Name: i2c_queue_thread
+ *
+ * Description:
+ *   Serve the requests of one bus back to back, the next one is taken as
+ *   soon as the previous transfer is done.
+ *
+ ****************************************************************************/
+
+static int i2c_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct i2c_queue_s *queue;
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+
+  queue = (FAR struct i2c_queue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&queue->sem);
+
+      flags = spin_lock_irqsave(&queue->lock);
+      req   = (FAR struct i2c_request_s *)sq_remfirst(&queue->pending);
+      spin_unlock_irqrestore(&queue->lock, flags);
+
+      /* The request may have been cancelled */
+
+      if (req == NULL)
+        {
+          continue;
+        }
+
+      req->result = I2C_TRANSFER(queue->i2c, req->msgv, req->msgc);
+      if (req->result < 0)
+        {
+          i2cerr("ERROR: I2C_TRANSFER failed: %d\n", req->result);
+        }
+
+      if (req->callback != NULL)
+        {
+          req->callback(req, req->arg);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Create a request queue for an I2C bus and the kernel thread that
+ *   serves it.
+ *
+ * Input Parameters:
+ *   i2c - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *i2c)
+{
+  FAR struct i2c_queue_s *queue;
+  FAR char *argv[2];
+  char arg1[32];
+
+  DEBUGASSERT(i2c != NULL);
+
+  queue = kmm_zalloc(sizeof(struct i2c_queue_s));
+  if (queue == NULL)
+    {
+      return NULL;
+    }
+
+  queue->i2c = i2c;
+  sq_init(&queue->pending);
+  spin_lock_init(&queue->lock);
+  nxsem_init(&queue->sem, 0, 0);
+
+  snprintf(arg1, sizeof(arg1), "%p", queue);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  queue->pid = kthread_create("i2cq", CONFIG_I2C_QUEUE_PRIORITY,
+                              CONFIG_I2C_QUEUE_STACKSIZE,
+                              i2c_queue_thread, argv);
+  if (queue->pid < 0)
+    {
+      i2cerr("ERROR: kthread_create failed: %d\n", queue->pid);
+      nxsem_destroy(&queue->sem);
+      kmm_free(queue);
+      return NULL;
+    }
+
+  return queue;
+}
+
+/****************************************************************************
+ * Name: i2c_queue_submit
+ *
+ * Description:
+ *   Queue a request for asynchronous transfer.
+ *
+ * Input Parameters:
+ *   queue - The queue of the bus
+ *   req   - The request to transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_queue_submit(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+
+  if (queue == NULL || req == NULL || req->msgv == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Insert behind all requests of the same or a higher priority */
+
+  flags = spin_lock_irqsave(&queue->lock);
+  for (curr = sq_peek(&queue->pending); curr != NULL; curr = sq_next(curr))
+    {
+      if (((FAR struct i2c_request_s *)curr)->priority < req->priority)
+        {
+          break;
+        }
+
+      prev = curr;
+    }
+
+  if (prev == NULL)
+    {
+      sq_addfirst(&req->flink, &queue->pending);
+    }
+  else
+    {
+      sq_addafter(prev, &req->flink, &queue->pending);
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  return nxsem_post(&queue->sem);
+}
+
+/****************************************************************************
+ * Name: i2c_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not been started yet from the queue.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was removed; -EBUSY if it is in progress or
+ *   done.
+ *
+ ****************************************************************************/
+
+int i2c_queue_cancel(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  flags = spin_lock_irqsave(&queue->lock);
+  for (curr = sq_peek(&queue->pending); curr != NULL; curr = sq_next(curr))
+    {
+      if (curr == &req->flink)
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst(&queue->pending);
+            }
+          else
+            {
+              sq_remafter(prev, &queue->pending);
+            }
+
+          ret = OK;
+          break;
+        }
+
+      prev = curr;
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  /* The semaphore count stays ahead of the requests, the thread skips the
+   * extra wakeup.
+   */
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: i2c_queue_transfer
+ *
+ * Description:
+ *   Queue messages with the given priority and wait for them.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_queue_transfer(FAR struct i2c_queue_s *queue,
+                       FAR struct i2c_msg_s *msgv, int msgc,
+                       uint8_t priority)
+{
+  struct i2c_request_s req;
+  sem_t done;
+  int ret;
+
+  nxsem_init(&done, 0, 0);
+
+  req.msgv     = msgv;
+  req.msgc     = msgc;
+  req.priority = priority;
+  req.callback = i2c_queue_wakeup;
+  req.arg      = &done;
+
+  ret = i2c_queue_submit(queue, &req);
+  if (ret >= 0)
+    {
+      nxsem_wait_uninterruptible(&done);
+      ret = req.result;
+    }
+
+  nxsem_destroy(&done);
+  return ret;
+}
+
+#endif /* CONFIG_I2C_QUEUE */
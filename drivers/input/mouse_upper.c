@@ -29,13 +29,28 @@
 #include <debug.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/input/mouse.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
 #include <nuttx/circbuf.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/map.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define MOUSE_WORK LPWORK
+#else
+#  define MOUSE_WORK HPWORK
+#endif
 
 /****************************************************************************
  * Private Types
@@ -48,6 +63,20 @@ struct mouse_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+#ifdef CONFIG_INPUT_COALESCE
+  struct work_s      work;     /* Delayed wakeup at the end of an interval */
+  clock_t            interval; /* Minimum ticks between wakeups, 0 if none */
+  clock_t            lastwake; /* Time of the last wakeup */
+  bool               latest;   /* Latest-sample-wins is enabled */
+  bool               haspending;
+
+  /* The newest unread report, not yet in circbuf, with latest-sample-wins */
+
+  struct mouse_report_s pending;
+#endif
+#ifdef CONFIG_INPUT_MMAP
+  FAR struct mouse_ring_s *ring; /* Mapped event ring, if any */
+#endif
 };
 
 /* This structure is for mouse upper half driver */
@@ -72,6 +101,10 @@ static int     mouse_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int     mouse_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup);
+#ifdef CONFIG_INPUT_MMAP
+static int     mouse_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -85,7 +118,11 @@ static const struct file_operations g_mouse_fops =
   NULL,           /* write */
   NULL,           /* seek */
   mouse_ioctl,    /* ioctl */
+#ifdef CONFIG_INPUT_MMAP
+  mouse_mmap,     /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   mouse_poll      /* poll */
 };
@@ -94,6 +131,229 @@ static const struct file_operations g_mouse_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mouse_notify
+ *
+ * Description:
+ *   Wake up the reader and the poll waiter.  Called with openpriv->lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static void mouse_notify(FAR struct mouse_openpriv_s *openpriv)
+{
+  int semcount;
+
+  nxsem_get_value(&openpriv->waitsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&openpriv->waitsem);
+    }
+
+  if (openpriv->fds && openpriv->fds->fd >= 0)
+    {
+      poll_notify(&openpriv->fds, 1, POLLIN);
+    }
+}
+
+/****************************************************************************
+ * Name: mouse_available
+ *
+ * Description:
+ *   Return true if there are reports to read.  Called with openpriv->lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static bool mouse_available(FAR struct mouse_openpriv_s *openpriv)
+{
+#ifdef CONFIG_INPUT_MMAP
+  if (openpriv->ring != NULL)
+    {
+      return openpriv->ring->head != openpriv->ring->tail;
+    }
+#endif
+
+#ifdef CONFIG_INPUT_COALESCE
+  if (openpriv->haspending)
+    {
+      return true;
+    }
+#endif
+
+  return !circbuf_is_empty(&openpriv->circbuf);
+}
+
+#ifdef CONFIG_INPUT_COALESCE
+/****************************************************************************
+ * Name: mouse_coalesce_worker
+ *
+ * Description:
+ *   Wake up the reader at the end of a coalescing interval.
+ *
+ ****************************************************************************/
+
+static void mouse_coalesce_worker(FAR void *arg)
+{
+  FAR struct mouse_openpriv_s *openpriv = arg;
+
+  nxmutex_lock(&openpriv->lock);
+  openpriv->lastwake = clock_systime_ticks();
+  mouse_notify(openpriv);
+  nxmutex_unlock(&openpriv->lock);
+}
+
+/****************************************************************************
+ * Name: mouse_flush_pending
+ *
+ * Description:
+ *   Move the pending report into circbuf.  Called with openpriv->lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static void mouse_flush_pending(FAR struct mouse_openpriv_s *openpriv)
+{
+  if (openpriv->haspending)
+    {
+      circbuf_overwrite(&openpriv->circbuf, &openpriv->pending,
+                        sizeof(struct mouse_report_s));
+      openpriv->haspending = false;
+    }
+}
+
+/****************************************************************************
+ * Name: mouse_set_coalesce
+ ****************************************************************************/
+
+static int mouse_set_coalesce(FAR struct mouse_openpriv_s *openpriv,
+                              FAR const struct mouse_coalesce_s *coalesce)
+{
+  int ret;
+
+  if (coalesce == NULL || (coalesce->flags & ~MOUSE_COALESCE_LATEST) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&openpriv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mouse_flush_pending(openpriv);
+  openpriv->latest   = (coalesce->flags & MOUSE_COALESCE_LATEST) != 0;
+  openpriv->interval = USEC2TICK(coalesce->interval);
+  nxmutex_unlock(&openpriv->lock);
+  return OK;
+}
+#endif /* CONFIG_INPUT_COALESCE */
+
+#ifdef CONFIG_INPUT_MMAP
+/****************************************************************************
+ * Name: mouse_ring_put
+ *
+ * Description:
+ *   Add a report to the mapped ring.  Called with openpriv->lock held.
+ *
+ ****************************************************************************/
+
+static void mouse_ring_put(FAR struct mouse_ring_s *ring,
+                           FAR const struct mouse_report_s *sample)
+{
+  uint32_t head = ring->head;
+
+  if (head - ring->tail >= ring->nslots)
+    {
+      ring->dropped++;
+      return;
+    }
+
+  memcpy(MOUSE_RING_SLOT(ring, head), sample,
+         sizeof(struct mouse_report_s));
+  ring->head = head + 1;
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+/****************************************************************************
+ * Name: mouse_munmap
+ ****************************************************************************/
+
+static int mouse_munmap(FAR struct task_group_s *group,
+                        FAR struct mm_map_entry_s *entry,
+                        FAR void *start, size_t length)
+{
+  if (group && entry)
+    {
+      vm_unmap_region(entry->vaddr, entry->length);
+      mm_map_remove(get_current_mm(), entry);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: mouse_mmap
+ *
+ * Description:
+ *   Map the event ring of this open file.  The ring is created on the
+ *   first call and holds as many reports as the circle buffer.
+ *
+ ****************************************************************************/
+
+static int mouse_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct mouse_openpriv_s  *openpriv = filep->f_priv;
+  FAR struct inode             *inode    = filep->f_inode;
+  FAR struct mouse_upperhalf_s *upper    = inode->i_private;
+  FAR struct mouse_ring_s      *ring;
+  size_t len;
+  int ret;
+
+  len = sizeof(struct mouse_ring_s) +
+        upper->nums * sizeof(struct mouse_report_s);
+  if (map->offset != 0 || map->length == 0 || map->length > len)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&openpriv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ring = openpriv->ring;
+  if (ring == NULL)
+    {
+      ring = kumm_zalloc(len);
+      if (ring == NULL)
+        {
+          nxmutex_unlock(&openpriv->lock);
+          return -ENOMEM;
+        }
+
+      ring->nslots   = upper->nums;
+      ring->slotsize = sizeof(struct mouse_report_s);
+      openpriv->ring = ring;
+    }
+
+#ifdef CONFIG_BUILD_KERNEL
+  map->vaddr  = vm_map_region(up_addrenv_va_to_pa(ring), len);
+  map->length = len;
+  map->munmap = mouse_munmap;
+  mm_map_add(get_current_mm(), map);
+#else
+  map->vaddr  = ring;
+#endif
+
+  nxmutex_unlock(&openpriv->lock);
+  return OK;
+}
+#endif /* CONFIG_INPUT_MMAP */
+
 /****************************************************************************
  * Name: mouse_open
  ****************************************************************************/
@@ -170,6 +430,12 @@ static int mouse_close(FAR struct file *filep)
     }
 
   list_delete(&openpriv->node);
+#ifdef CONFIG_INPUT_COALESCE
+  work_cancel_sync(MOUSE_WORK, &openpriv->work);
+#endif
+#ifdef CONFIG_INPUT_MMAP
+  kumm_free(openpriv->ring);
+#endif
   circbuf_uninit(&openpriv->circbuf);
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
@@ -200,7 +466,15 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  while (circbuf_is_empty(&openpriv->circbuf))
+#ifdef CONFIG_INPUT_MMAP
+  if (openpriv->ring != NULL)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+#endif
+
+  while (!mouse_available(openpriv))
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
@@ -224,6 +498,9 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_INPUT_COALESCE
+  mouse_flush_pending(openpriv);
+#endif
   ret = circbuf_read(&openpriv->circbuf, buffer, len);
 
 out:
@@ -242,6 +519,14 @@ static int mouse_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct mouse_lowerhalf_s *lower = upper->lower;
   int ret;
 
+#ifdef CONFIG_INPUT_COALESCE
+  if (cmd == MSIOC_SETCOALESCE)
+    {
+      return mouse_set_coalesce(filep->f_priv,
+                  (FAR const struct mouse_coalesce_s *)((uintptr_t)arg));
+    }
+#endif
+
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
@@ -291,7 +576,7 @@ static int mouse_poll(FAR struct file *filep,
           goto errout;
         }
 
-      if (!circbuf_is_empty(&openpriv->circbuf))
+      if (mouse_available(openpriv))
         {
           eventset |= POLLIN;
         }
@@ -321,7 +606,14 @@ void mouse_event(FAR void *priv, FAR const struct mouse_report_s *sample)
 {
   FAR struct mouse_upperhalf_s *upper = priv;
   FAR struct mouse_openpriv_s  *openpriv;
-  int semcount;
+  struct mouse_report_s         report;
+  struct timespec               ts;
+
+  /* Time stamp the report on arrival */
+
+  report = *sample;
+  clock_systime_timespec(&ts);
+  report.timestamp = 1000000ull * ts.tv_sec + ts.tv_nsec / 1000;
 
   if (nxmutex_lock(&upper->lock) < 0)
     {
@@ -330,19 +622,63 @@ void mouse_event(FAR void *priv, FAR const struct mouse_report_s *sample)
 
   list_for_every_entry(&upper->head, openpriv, struct mouse_openpriv_s, node)
     {
-      circbuf_overwrite(&openpriv->circbuf, sample,
-                        sizeof(struct mouse_report_s));
+      nxmutex_lock(&openpriv->lock);
+#ifdef CONFIG_INPUT_MMAP
+      if (openpriv->ring != NULL)
+        {
+          mouse_ring_put(openpriv->ring, &report);
+        }
+      else
+#endif
+#ifdef CONFIG_INPUT_COALESCE
+      if (openpriv->latest)
+        {
+          /* Latest sample wins: replace an unread report with the same
+           * buttons.
+           */
 
-      nxsem_get_value(&openpriv->waitsem, &semcount);
-      if (semcount < 1)
+          if (openpriv->haspending &&
+              openpriv->pending.buttons != report.buttons)
+            {
+              mouse_flush_pending(openpriv);
+            }
+
+          openpriv->pending    = report;
+          openpriv->haspending = true;
+        }
+      else
+#endif
         {
-          nxsem_post(&openpriv->waitsem);
+          circbuf_overwrite(&openpriv->circbuf, &report,
+                            sizeof(struct mouse_report_s));
         }
 
-      if (openpriv->fds && openpriv->fds->fd >= 0)
+#ifdef CONFIG_INPUT_COALESCE
+      /* Batch delivery: wake the reader at most once per interval */
+
+      if (openpriv->interval > 0)
         {
-          poll_notify(&openpriv->fds, 1, POLLIN);
+          clock_t next = openpriv->lastwake + openpriv->interval;
+          clock_t now  = clock_systime_ticks();
+
+          if (!clock_compare(next, now))
+            {
+              if (work_available(&openpriv->work))
+                {
+                  work_queue(MOUSE_WORK, &openpriv->work,
+                             mouse_coalesce_worker, openpriv, next - now);
+                }
+
+              nxmutex_unlock(&openpriv->lock);
+              continue;
+            }
+
+          openpriv->lastwake = now;
         }
+#endif
+
+      mouse_notify(openpriv);
+      nxmutex_unlock(&openpriv->lock);
     }
 
   nxmutex_unlock(&upper->lock);
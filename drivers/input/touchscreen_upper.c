@@ -36,11 +36,25 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/input/touchscreen.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
 #include <nuttx/circbuf.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/map.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define TOUCH_WORK LPWORK
+#else
+#  define TOUCH_WORK HPWORK
+#endif
 
 /****************************************************************************
  * Private Types
@@ -53,6 +67,18 @@ struct touch_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+#ifdef CONFIG_INPUT_COALESCE
+  struct work_s      work;     /* Delayed wakeup at the end of an interval */
+  clock_t            interval; /* Minimum ticks between wakeups, 0 if none */
+  clock_t            lastwake; /* Time of the last wakeup */
+
+  /* The newest unread move, not yet in circbuf, with latest-sample-wins */
+
+  FAR struct touch_sample_s *pending;
+#endif
+#ifdef CONFIG_INPUT_MMAP
+  FAR struct touch_ring_s   *ring;    /* Mapped event ring, if any */
+#endif
 };
 
 /* This structure is for touchscreen upper half driver */
@@ -80,6 +106,10 @@ static int     touch_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int     touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup);
+#ifdef CONFIG_INPUT_MMAP
+static int     touch_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
+#endif
 
 static void    touch_event_notify(FAR struct touch_upperhalf_s *upper,
                                   FAR struct touch_openpriv_s  *openpriv,
@@ -97,7 +127,11 @@ static const struct file_operations g_touch_fops =
   touch_write,    /* write */
   NULL,           /* seek */
   touch_ioctl,    /* ioctl */
+#ifdef CONFIG_INPUT_MMAP
+  touch_mmap,     /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   touch_poll      /* poll */
 };
@@ -106,6 +140,298 @@ static const struct file_operations g_touch_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: touch_notify
+ *
+ * Description:
+ *   Wake up the reader and the poll waiter.  Called with openpriv->lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static void touch_notify(FAR struct touch_openpriv_s *openpriv)
+{
+  int semcount;
+
+  nxsem_get_value(&openpriv->waitsem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&openpriv->waitsem);
+    }
+
+  poll_notify(&openpriv->fds, 1, POLLIN);
+}
+
+/****************************************************************************
+ * Name: touch_available
+ *
+ * Description:
+ *   Return true if there are samples to read.  Called with openpriv->lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static bool touch_available(FAR struct touch_openpriv_s *openpriv)
+{
+#ifdef CONFIG_INPUT_MMAP
+  if (openpriv->ring != NULL)
+    {
+      return openpriv->ring->head != openpriv->ring->tail;
+    }
+#endif
+
+#ifdef CONFIG_INPUT_COALESCE
+  if (openpriv->pending != NULL && openpriv->pending->npoints > 0)
+    {
+      return true;
+    }
+#endif
+
+  return !circbuf_is_empty(&openpriv->circbuf);
+}
+
+#ifdef CONFIG_INPUT_COALESCE
+/****************************************************************************
+ * Name: touch_coalesce_worker
+ *
+ * Description:
+ *   Wake up the reader at the end of a coalescing interval.
+ *
+ ****************************************************************************/
+
+static void touch_coalesce_worker(FAR void *arg)
+{
+  FAR struct touch_openpriv_s *openpriv = arg;
+
+  nxmutex_lock(&openpriv->lock);
+  openpriv->lastwake = clock_systime_ticks();
+  touch_notify(openpriv);
+  nxmutex_unlock(&openpriv->lock);
+}
+
+/****************************************************************************
+ * Name: touch_flush_pending
+ *
+ * Description:
+ *   Move the pending move into circbuf.  Called with openpriv->lock held.
+ *
+ ****************************************************************************/
+
+static void touch_flush_pending(FAR struct touch_openpriv_s *openpriv)
+{
+  FAR struct touch_sample_s *pending = openpriv->pending;
+
+  if (pending != NULL && pending->npoints > 0)
+    {
+      circbuf_overwrite(&openpriv->circbuf, pending,
+                        SIZEOF_TOUCH_SAMPLE_S(pending->npoints));
+      pending->npoints = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: touch_is_move
+ *
+ * Description:
+ *   Return true if the sample only moves contacts that are already down.
+ *
+ ****************************************************************************/
+
+static bool touch_is_move(FAR const struct touch_sample_s *sample)
+{
+  int n;
+
+  for (n = 0; n < sample->npoints; n++)
+    {
+      if ((sample->point[n].flags & (TOUCH_DOWN | TOUCH_UP | TOUCH_MOVE))
+          != TOUCH_MOVE)
+        {
+          return false;
+        }
+    }
+
+  return sample->npoints > 0;
+}
+
+/****************************************************************************
+ * Name: touch_same_contacts
+ ****************************************************************************/
+
+static bool touch_same_contacts(FAR const struct touch_sample_s *a,
+                                FAR const struct touch_sample_s *b)
+{
+  int n;
+
+  if (a->npoints != b->npoints)
+    {
+      return false;
+    }
+
+  for (n = 0; n < a->npoints; n++)
+    {
+      if (a->point[n].id != b->point[n].id)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: touch_set_coalesce
+ ****************************************************************************/
+
+static int touch_set_coalesce(FAR struct touch_upperhalf_s *upper,
+                              FAR struct touch_openpriv_s *openpriv,
+                              FAR const struct touch_coalesce_s *coalesce)
+{
+  FAR struct touch_sample_s *pending = NULL;
+  int ret;
+
+  if (coalesce == NULL || (coalesce->flags & ~TOUCH_COALESCE_LATEST) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if ((coalesce->flags & TOUCH_COALESCE_LATEST) != 0)
+    {
+      pending = kmm_zalloc(SIZEOF_TOUCH_SAMPLE_S(upper->lower->maxpoint));
+      if (pending == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  ret = nxmutex_lock(&openpriv->lock);
+  if (ret < 0)
+    {
+      kmm_free(pending);
+      return ret;
+    }
+
+  touch_flush_pending(openpriv);
+  if (pending == NULL || openpriv->pending == NULL)
+    {
+      FAR struct touch_sample_s *old = openpriv->pending;
+
+      openpriv->pending = pending;
+      pending = old;
+    }
+
+  openpriv->interval = USEC2TICK(coalesce->interval);
+  nxmutex_unlock(&openpriv->lock);
+
+  kmm_free(pending);
+  return OK;
+}
+#endif /* CONFIG_INPUT_COALESCE */
+
+#ifdef CONFIG_INPUT_MMAP
+/****************************************************************************
+ * Name: touch_ring_put
+ *
+ * Description:
+ *   Add a sample to the mapped ring.  Called with openpriv->lock held.
+ *
+ ****************************************************************************/
+
+static void touch_ring_put(FAR struct touch_ring_s *ring,
+                           FAR const struct touch_sample_s *sample)
+{
+  uint32_t head = ring->head;
+
+  if (head - ring->tail >= ring->nslots)
+    {
+      ring->dropped++;
+      return;
+    }
+
+  memcpy(TOUCH_RING_SLOT(ring, head), sample,
+         SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+  ring->head = head + 1;
+}
+
+#ifdef CONFIG_BUILD_KERNEL
+/****************************************************************************
+ * Name: touch_munmap
+ ****************************************************************************/
+
+static int touch_munmap(FAR struct task_group_s *group,
+                        FAR struct mm_map_entry_s *entry,
+                        FAR void *start, size_t length)
+{
+  if (group && entry)
+    {
+      vm_unmap_region(entry->vaddr, entry->length);
+      mm_map_remove(get_current_mm(), entry);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: touch_mmap
+ *
+ * Description:
+ *   Map the event ring of this open file.  The ring is created on the
+ *   first call and holds as many samples as the circle buffer.
+ *
+ ****************************************************************************/
+
+static int touch_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct touch_openpriv_s  *openpriv = filep->f_priv;
+  FAR struct inode             *inode    = filep->f_inode;
+  FAR struct touch_upperhalf_s *upper    = inode->i_private;
+  FAR struct touch_ring_s      *ring;
+  size_t slotsize;
+  size_t len;
+  int ret;
+
+  slotsize = SIZEOF_TOUCH_SAMPLE_S(upper->lower->maxpoint);
+  len      = sizeof(struct touch_ring_s) + upper->nums * slotsize;
+  if (map->offset != 0 || map->length == 0 || map->length > len)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&openpriv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ring = openpriv->ring;
+  if (ring == NULL)
+    {
+      ring = kumm_zalloc(len);
+      if (ring == NULL)
+        {
+          nxmutex_unlock(&openpriv->lock);
+          return -ENOMEM;
+        }
+
+      ring->nslots   = upper->nums;
+      ring->slotsize = slotsize;
+      openpriv->ring = ring;
+    }
+
+#ifdef CONFIG_BUILD_KERNEL
+  map->vaddr  = vm_map_region(up_addrenv_va_to_pa(ring), len);
+  map->length = len;
+  map->munmap = touch_munmap;
+  mm_map_add(get_current_mm(), map);
+#else
+  map->vaddr  = ring;
+#endif
+
+  nxmutex_unlock(&openpriv->lock);
+  return OK;
+}
+#endif /* CONFIG_INPUT_MMAP */
+
 /****************************************************************************
  * Name: touch_open
  ****************************************************************************/
@@ -182,6 +508,13 @@ static int touch_close(FAR struct file *filep)
     }
 
   list_delete(&openpriv->node);
+#ifdef CONFIG_INPUT_COALESCE
+  work_cancel_sync(TOUCH_WORK, &openpriv->work);
+  kmm_free(openpriv->pending);
+#endif
+#ifdef CONFIG_INPUT_MMAP
+  kumm_free(openpriv->ring);
+#endif
   circbuf_uninit(&openpriv->circbuf);
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
@@ -236,7 +569,15 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  while (circbuf_is_empty(&openpriv->circbuf))
+#ifdef CONFIG_INPUT_MMAP
+  if (openpriv->ring != NULL)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+#endif
+
+  while (!touch_available(openpriv))
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
@@ -260,6 +601,9 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_INPUT_COALESCE
+  touch_flush_pending(openpriv);
+#endif
   ret = circbuf_read(&openpriv->circbuf, buffer, len);
 
 out:
@@ -315,6 +659,14 @@ static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
         }
         break;
+#ifdef CONFIG_INPUT_COALESCE
+      case TSIOC_SETCOALESCE:
+        {
+          ret = touch_set_coalesce(upper, openpriv,
+                  (FAR const struct touch_coalesce_s *)((uintptr_t)arg));
+        }
+        break;
+#endif
       default:
         {
           if (lower->control)
@@ -363,7 +715,7 @@ static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
           goto errout;
         }
 
-      if (!circbuf_is_empty(&openpriv->circbuf))
+      if (touch_available(openpriv))
         {
           eventset |= POLLIN;
         }
@@ -414,16 +766,62 @@ static void touch_event_notify(FAR struct touch_upperhalf_s *upper,
     }
 
   nxmutex_lock(&openpriv->lock);
-  circbuf_overwrite(&openpriv->circbuf, sample,
-                    SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+#ifdef CONFIG_INPUT_MMAP
+  if (openpriv->ring != NULL)
+    {
+      touch_ring_put(openpriv->ring, sample);
+    }
+  else
+#endif
+#ifdef CONFIG_INPUT_COALESCE
+  if (openpriv->pending != NULL && sample->npoints <= lower->maxpoint &&
+      touch_is_move(sample))
+    {
+      /* Latest sample wins: replace an unread move of the same contacts */
+
+      if (!touch_same_contacts(openpriv->pending, sample))
+        {
+          touch_flush_pending(openpriv);
+        }
 
-  nxsem_get_value(&openpriv->waitsem, &n);
-  if (n < 1)
+      memcpy(openpriv->pending, sample,
+             SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+    }
+  else
+#endif
     {
-      nxsem_post(&openpriv->waitsem);
+#ifdef CONFIG_INPUT_COALESCE
+      touch_flush_pending(openpriv);
+#endif
+      circbuf_overwrite(&openpriv->circbuf, sample,
+                        SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
     }
 
-  poll_notify(&openpriv->fds, 1, POLLIN);
+#ifdef CONFIG_INPUT_COALESCE
+  /* Batch delivery: wake the reader at most once per interval */
+
+  if (openpriv->interval > 0)
+    {
+      clock_t next = openpriv->lastwake + openpriv->interval;
+      clock_t now  = clock_systime_ticks();
+
+      if (!clock_compare(next, now))
+        {
+          if (work_available(&openpriv->work))
+            {
+              work_queue(TOUCH_WORK, &openpriv->work,
+                         touch_coalesce_worker, openpriv, next - now);
+            }
+
+          nxmutex_unlock(&openpriv->lock);
+          return;
+        }
+
+      openpriv->lastwake = now;
+    }
+#endif
+
+  touch_notify(openpriv);
   nxmutex_unlock(&openpriv->lock);
 }
 
@@ -439,6 +837,23 @@ void touch_event(FAR void *priv, FAR struct touch_sample_s *sample)
 {
   FAR struct touch_upperhalf_s *upper = priv;
   FAR struct touch_openpriv_s  *openpriv;
+  uint64_t now = 0;
+  int n;
+
+  /* Time stamp the points the lower half did not */
+
+  for (n = 0; n < sample->npoints; n++)
+    {
+      if (sample->point[n].timestamp == 0)
+        {
+          if (now == 0)
+            {
+              now = touch_get_time();
+            }
+
+          sample->point[n].timestamp = now;
+        }
+    }
 
   if (nxmutex_lock(&upper->lock) < 0)
     {
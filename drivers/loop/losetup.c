@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
@@ -52,6 +53,7 @@
  ****************************************************************************/
 
 #define MAX_OPENCNT     (255)                  /* Limit of uint8_t */
+#define MAX_ZEROSECTS   (8)                    /* Zeroed sectors per write */
 
 /****************************************************************************
  * Private Types
@@ -66,6 +68,13 @@ struct loop_struct_s
   uint8_t      opencnt;      /* Count of open references to the loop device */
   bool         writeenabled; /* true: can write to device */
   struct file  devfile;      /* File struct of char device/file */
+#ifdef CONFIG_DEV_LOOP_DIRECT
+  blkcnt_t     blkstart;     /* First sector of the device on blkinode */
+
+  /* The backing block driver, NULL if devfile is used */
+
+  FAR struct inode *blkinode;
+#endif
 };
 
 /****************************************************************************
@@ -81,6 +90,8 @@ static ssize_t loop_write(FAR struct inode *inode,
                           blkcnt_t start_sector, unsigned int nsectors);
 static int     loop_geometry(FAR struct inode *inode,
                              FAR struct geometry *geometry);
+static int     loop_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
 
 /****************************************************************************
  * Private Data
@@ -93,6 +104,7 @@ static const struct block_operations g_bops =
   loop_read,     /* read */
   loop_write,    /* write */
   loop_geometry, /* geometry */
+  loop_ioctl,    /* ioctl */
 };
 
 /****************************************************************************
@@ -197,6 +209,15 @@ static ssize_t loop_read(FAR struct inode *inode, FAR unsigned char *buffer,
       return -EIO;
     }
 
+#ifdef CONFIG_DEV_LOOP_DIRECT
+  if (dev->blkinode != NULL)
+    {
+      return dev->blkinode->u.i_bops->read(dev->blkinode, buffer,
+                                           dev->blkstart + start_sector,
+                                           nsectors);
+    }
+#endif
+
   /* Calculate the offset to read the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -245,6 +266,21 @@ static ssize_t loop_write(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#ifdef CONFIG_DEV_LOOP_DIRECT
+  if (dev->blkinode != NULL)
+    {
+      if (start_sector + nsectors > dev->nsectors)
+        {
+          ferr("ERROR: Write past end of device\n");
+          return -EIO;
+        }
+
+      return dev->blkinode->u.i_bops->write(dev->blkinode, buffer,
+                                            dev->blkstart + start_sector,
+                                            nsectors);
+    }
+#endif
+
   /* Calculate the offset to write the sectors and seek to the position */
 
   offset = start_sector * dev->sectsize + dev->offset;
@@ -302,6 +338,274 @@ static int loop_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: loop_zeroout
+ *
+ * Description:
+ *   Write zeros to a range of sectors of a backing file
+ *
+ ****************************************************************************/
+
+static int loop_zeroout(FAR struct inode *inode, blkcnt_t start,
+                        blkcnt_t nsectors)
+{
+  FAR struct loop_struct_s *dev = inode->i_private;
+  FAR unsigned char *zeros;
+  unsigned int count;
+  ssize_t ret = OK;
+
+  zeros = kmm_zalloc(MIN(nsectors, MAX_ZEROSECTS) * dev->sectsize);
+  if (zeros == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  while (nsectors > 0)
+    {
+      count = MIN(nsectors, MAX_ZEROSECTS);
+      ret   = loop_write(inode, zeros, start, count);
+      if (ret < 0)
+        {
+          break;
+        }
+      else if (ret == 0)
+        {
+          ret = -ENOSPC;
+          break;
+        }
+
+      start    += ret;
+      nsectors -= ret;
+      ret       = OK;
+    }
+
+  kmm_free(zeros);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: loop_ioctl
+ *
+ * Description:
+ *   Trim or zero a range of sectors, or return the base address of a
+ *   backing device that supports access in place.
+ *
+ ****************************************************************************/
+
+static int loop_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct loop_struct_s *dev;
+  FAR blkcnt_t *range = (FAR blkcnt_t *)((uintptr_t)arg);
+#ifdef CONFIG_DEV_LOOP_DIRECT
+  FAR const struct block_operations *bops;
+  blkcnt_t blkrange[2];
+  FAR uint8_t *base;
+  int ret;
+#endif
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+  switch (cmd)
+    {
+      case BIOC_TRIM:
+      case BIOC_ZEROOUT:
+        if (!dev->writeenabled)
+          {
+            return -EACCES;
+          }
+        else if (range == NULL || range[0] >= dev->nsectors ||
+                 range[1] > dev->nsectors - range[0])
+          {
+            return -EINVAL;
+          }
+
+#ifdef CONFIG_DEV_LOOP_DIRECT
+        /* Translate the range to the sectors of the backing device and
+         * let it release or zero them.
+         */
+
+        if (dev->blkinode != NULL)
+          {
+            bops = dev->blkinode->u.i_bops;
+            blkrange[0] = dev->blkstart + range[0];
+            blkrange[1] = range[1];
+
+            ret = -ENOTTY;
+            if (bops->ioctl != NULL)
+              {
+                ret = bops->ioctl(dev->blkinode, cmd,
+                                  (unsigned long)((uintptr_t)blkrange));
+              }
+
+            /* A device that cannot zero a range is written instead */
+
+            if (ret == -ENOTTY && cmd == BIOC_ZEROOUT)
+              {
+                ret = loop_zeroout(inode, range[0], range[1]);
+              }
+
+            return ret;
+          }
+#endif
+
+        /* The file systems cannot release the space in the middle of a
+         * file, only zeroing is supported.
+         */
+
+        if (cmd == BIOC_TRIM)
+          {
+            return -ENOTTY;
+          }
+
+        return loop_zeroout(inode, range[0], range[1]);
+
+#ifdef CONFIG_DEV_LOOP_DIRECT
+      case BIOC_XIPBASE:
+        bops = dev->blkinode != NULL ? dev->blkinode->u.i_bops : NULL;
+        if (bops == NULL || bops->ioctl == NULL)
+          {
+            return -ENOTTY;
+          }
+
+        ret = bops->ioctl(dev->blkinode, BIOC_XIPBASE,
+                          (unsigned long)((uintptr_t)&base));
+        if (ret >= 0)
+          {
+            *(FAR void **)((uintptr_t)arg) =
+              base + dev->blkstart * dev->sectsize;
+          }
+
+        return ret;
+#endif
+    }
+
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: loop_open_direct
+ *
+ * Description:
+ *   Open a block driver that holds the device as it is.  The sectors are
+ *   then read and written by the block driver without the copy through
+ *   the buffer of the character driver proxy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_LOOP_DIRECT
+static int loop_open_direct(FAR struct loop_struct_s *dev,
+                            FAR const char *filename, bool readonly)
+{
+  FAR struct inode *inode;
+  struct geometry geo;
+  bool writeenabled;
+  int ret = -ENOSYS;
+
+  if (dev->offset % dev->sectsize != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (!readonly)
+    {
+      ret = open_blockdriver(filename, 0, &inode);
+    }
+
+  writeenabled = ret >= 0;
+  if (ret < 0)
+    {
+      ret = open_blockdriver(filename, MS_RDONLY, &inode);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ret = -ENOTTY;
+  if (inode->u.i_bops->geometry != NULL)
+    {
+      ret = inode->u.i_bops->geometry(inode, &geo);
+    }
+
+  if (ret < 0 || !geo.geo_available ||
+      geo.geo_sectorsize != dev->sectsize)
+    {
+      close_blockdriver(inode);
+      return ret < 0 ? ret : -EINVAL;
+    }
+
+  dev->blkinode     = inode;
+  dev->blkstart     = dev->offset / dev->sectsize;
+  dev->writeenabled = writeenabled && geo.geo_writeenabled;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: loop_open_file
+ *
+ * Description:
+ *   Open the file or character device that holds the device
+ *
+ ****************************************************************************/
+
+static int loop_open_file(FAR struct loop_struct_s *dev,
+                          FAR const char *filename, bool readonly)
+{
+  int ret = -ENOSYS;
+
+  /* First try to open the device R/W access (unless we are asked
+   * to open it readonly).
+   */
+
+  if (!readonly)
+    {
+      ret = file_open(&dev->devfile, filename, O_RDWR | O_CLOEXEC);
+    }
+
+  if (ret >= 0)
+    {
+      dev->writeenabled = true; /* Success */
+    }
+  else
+    {
+      /* If that fails, then try to open the device read-only */
+
+      ret = file_open(&dev->devfile, filename, O_RDONLY | O_CLOEXEC);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to open %s: %d\n", filename, ret);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: loop_close_file
+ *
+ * Description:
+ *   Close the file or block driver that holds the device
+ *
+ ****************************************************************************/
+
+static void loop_close_file(FAR struct loop_struct_s *dev)
+{
+#ifdef CONFIG_DEV_LOOP_DIRECT
+  if (dev->blkinode != NULL)
+    {
+      close_blockdriver(dev->blkinode);
+      dev->blkinode = NULL;
+    }
+#endif
+
+  if (dev->devfile.f_inode != NULL)
+    {
+      file_close(&dev->devfile);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -364,30 +668,18 @@ int losetup(FAR const char *devname, FAR const char *filename,
   dev->sectsize  = sectsize;
   dev->offset    = offset;
 
-  /* Open the file. */
-
-  /* First try to open the device R/W access (unless we are asked
-   * to open it readonly).
+  /* Open the file.  A block driver is used directly when its sectors
+   * line up with those of the loop device.
    */
 
-  ret = -ENOSYS;
-  if (!readonly)
-    {
-      ret = file_open(&dev->devfile, filename, O_RDWR | O_CLOEXEC);
-    }
-
-  if (ret >= 0)
-    {
-      dev->writeenabled = true; /* Success */
-    }
-  else
+#ifdef CONFIG_DEV_LOOP_DIRECT
+  ret = loop_open_direct(dev, filename, readonly);
+  if (ret < 0)
+#endif
     {
-      /* If that fails, then try to open the device read-only */
-
-      ret = file_open(&dev->devfile, filename, O_RDONLY | O_CLOEXEC);
+      ret = loop_open_file(dev, filename, readonly);
       if (ret < 0)
         {
-          ferr("ERROR: Failed to open %s: %d\n", filename, ret);
           goto errout_with_dev;
         }
     }
@@ -404,7 +696,7 @@ int losetup(FAR const char *devname, FAR const char *filename,
   return OK;
 
 errout_with_file:
-  file_close(&dev->devfile);
+  loop_close_file(dev);
 
 errout_with_dev:
   nxmutex_destroy(&dev->lock);
@@ -466,10 +758,7 @@ int loteardown(FAR const char *devname)
 
   /* Release the device structure */
 
-  if (dev->devfile.f_inode != NULL)
-    {
-      file_close(&dev->devfile);
-    }
+  loop_close_file(dev);
 
   nxmutex_destroy(&dev->lock);
   kmm_free(dev);
@@ -0,0 +1,699 @@
+/****************************************************************************
+ * drivers/misc/blkqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BLKQUEUE_READ_EXPIRE  MSEC2TICK(CONFIG_DRVR_BLKQUEUE_READ_EXPIRE)
+#define BLKQUEUE_WRITE_EXPIRE MSEC2TICK(CONFIG_DRVR_BLKQUEUE_WRITE_EXPIRE)
+
+#define BLKQUEUE_SORT(e)      container_of(e, struct blkqueue_req_s, sort)
+#define BLKQUEUE_FIFO(e)      container_of(e, struct blkqueue_req_s, fifo)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One read or write call waiting in the queue, it lives on the stack of
+ * the caller until the dispatcher completes it.
+ */
+
+struct blkqueue_req_s
+{
+  dq_entry_t        sort;       /* Entry in the list sorted by sector */
+  dq_entry_t        fifo;       /* Entry in the list in arrival order */
+  FAR uint8_t      *buffer;     /* Caller's buffer */
+  blkcnt_t          start;      /* First sector */
+  unsigned int      nsectors;   /* Number of sectors */
+  bool              write;      /* True: write request */
+  clock_t           expire;     /* Deadline of the request */
+  ssize_t           result;     /* Sectors transferred or negated errno */
+  sem_t             done;       /* Posted when the request completes */
+};
+
+struct blkqueue_s
+{
+  FAR struct inode *inode;      /* Lower block driver */
+  mutex_t           lock;       /* Protects the request lists */
+  sem_t             wake;       /* Wakes up the dispatcher */
+  sem_t             exitsem;    /* Posted when the dispatcher exits */
+  dq_queue_t        sorted;     /* Pending requests sorted by sector */
+  dq_queue_t        fifo;       /* Pending requests in arrival order */
+  unsigned int      nreqs;      /* Number of pending requests */
+  blkcnt_t          position;   /* Sector following the last dispatch */
+  FAR uint8_t      *buffer;     /* Bounce buffer of merged requests */
+  unsigned int      bufsectors; /* Size of the bounce buffer in sectors */
+  uint16_t          sectsize;   /* Sector size of the lower driver */
+  uint8_t           policy;     /* BLKQUEUE_POLICY_* */
+  uint8_t           crefs;      /* Open references */
+  volatile bool     exit;       /* Request the dispatcher to exit */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     blkqueue_open(FAR struct inode *inode);
+static int     blkqueue_close(FAR struct inode *inode);
+static ssize_t blkqueue_read(FAR struct inode *inode,
+                             FAR unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t blkqueue_write(FAR struct inode *inode,
+                              FAR const unsigned char *buffer,
+                              blkcnt_t start_sector, unsigned int nsectors);
+static int     blkqueue_geometry(FAR struct inode *inode,
+                                 FAR struct geometry *geometry);
+static int     blkqueue_ioctl(FAR struct inode *inode, int cmd,
+                              unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_blkqueue_bops =
+{
+  blkqueue_open,     /* open     */
+  blkqueue_close,    /* close    */
+  blkqueue_read,     /* read     */
+  blkqueue_write,    /* write    */
+  blkqueue_geometry, /* geometry */
+  blkqueue_ioctl     /* ioctl    */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkqueue_insert
+ *
+ * Description:
+ *   Add a request to the arrival ordered list and to the sector sorted
+ *   list.  Requests for the same sector keep their arrival order.
+ *
+ ****************************************************************************/
+
+static void blkqueue_insert(FAR struct blkqueue_s *queue,
+                            FAR struct blkqueue_req_s *req)
+{
+  FAR dq_entry_t *entry;
+
+  dq_addlast(&req->fifo, &queue->fifo);
+
+  for (entry = dq_tail(&queue->sorted); entry != NULL;
+       entry = dq_prev(entry))
+    {
+      if (BLKQUEUE_SORT(entry)->start <= req->start)
+        {
+          dq_addafter(entry, &req->sort, &queue->sorted);
+          return;
+        }
+    }
+
+  dq_addfirst(&req->sort, &queue->sorted);
+}
+
+/****************************************************************************
+ * Name: blkqueue_remove
+ ****************************************************************************/
+
+static void blkqueue_remove(FAR struct blkqueue_s *queue,
+                            FAR struct blkqueue_req_s *req)
+{
+  dq_rem(&req->fifo, &queue->fifo);
+  dq_rem(&req->sort, &queue->sorted);
+  queue->nreqs--;
+}
+
+/****************************************************************************
+ * Name: blkqueue_first
+ *
+ * Description:
+ *   Select the request to dispatch next.  The none policy serves the
+ *   requests in arrival order.  The deadline policy sweeps the sorted list
+ *   upwards from the last dispatched sector, unless the oldest request has
+ *   passed its deadline.
+ *
+ ****************************************************************************/
+
+static FAR struct blkqueue_req_s *
+blkqueue_first(FAR struct blkqueue_s *queue)
+{
+  FAR struct blkqueue_req_s *req;
+  FAR dq_entry_t *entry;
+
+  req = BLKQUEUE_FIFO(dq_peek(&queue->fifo));
+  if (queue->policy == BLKQUEUE_POLICY_NONE ||
+      (sclock_t)(clock_systime_ticks() - req->expire) >= 0)
+    {
+      return req;
+    }
+
+  for (entry = dq_peek(&queue->sorted); entry != NULL;
+       entry = dq_next(entry))
+    {
+      if (BLKQUEUE_SORT(entry)->start >= queue->position)
+        {
+          return BLKQUEUE_SORT(entry);
+        }
+    }
+
+  return BLKQUEUE_SORT(dq_peek(&queue->sorted));
+}
+
+/****************************************************************************
+ * Name: blkqueue_pick
+ *
+ * Description:
+ *   Remove the next request and the requests contiguous to it from the
+ *   queue.  Requests are merged while they go in the same direction, start
+ *   where the previous one ends and the whole still fits in the bounce
+ *   buffer.
+ *
+ * Returned Value:
+ *   The number of requests saved in 'batch'.
+ *
+ ****************************************************************************/
+
+static int blkqueue_pick(FAR struct blkqueue_s *queue,
+                         FAR struct blkqueue_req_s **batch)
+{
+  FAR struct blkqueue_req_s *req;
+  FAR struct blkqueue_req_s *next;
+  FAR dq_entry_t *entry;
+  unsigned int nsectors;
+  int nreqs = 1;
+
+  if (queue->nreqs == 0)
+    {
+      return 0;
+    }
+
+  req = blkqueue_first(queue);
+  entry = queue->policy == BLKQUEUE_POLICY_NONE ?
+          dq_next(&req->fifo) : dq_next(&req->sort);
+
+  blkqueue_remove(queue, req);
+  batch[0] = req;
+  nsectors = req->nsectors;
+
+  while (entry != NULL && nreqs < CONFIG_DRVR_BLKQUEUE_BATCH)
+    {
+      next = queue->policy == BLKQUEUE_POLICY_NONE ?
+             BLKQUEUE_FIFO(entry) : BLKQUEUE_SORT(entry);
+      if (next->write != req->write ||
+          next->start != req->start + req->nsectors ||
+          nsectors + next->nsectors > queue->bufsectors)
+        {
+          break;
+        }
+
+      entry = dq_next(entry);
+      blkqueue_remove(queue, next);
+      batch[nreqs++] = next;
+      nsectors += next->nsectors;
+      req = next;
+    }
+
+  queue->position = req->start + req->nsectors;
+  return nreqs;
+}
+
+/****************************************************************************
+ * Name: blkqueue_dispatch
+ *
+ * Description:
+ *   Issue the requests picked by blkqueue_pick() as one transfer to the
+ *   lower driver and complete them.
+ *
+ ****************************************************************************/
+
+static void blkqueue_dispatch(FAR struct blkqueue_s *queue,
+                              FAR struct blkqueue_req_s **batch, int nreqs)
+{
+  FAR struct inode *inode = queue->inode;
+  FAR struct blkqueue_req_s *req = batch[0];
+  FAR uint8_t *buffer = req->buffer;
+  unsigned int nsectors = 0;
+  unsigned int offset = 0;
+  ssize_t ret;
+  int i;
+
+  /* A single request is transferred from the caller's buffer directly,
+   * merged requests go through the bounce buffer.
+   */
+
+  if (nreqs > 1)
+    {
+      buffer = queue->buffer;
+    }
+
+  for (i = 0; i < nreqs; i++)
+    {
+      if (nreqs > 1 && req->write)
+        {
+          memcpy(buffer + nsectors * queue->sectsize, batch[i]->buffer,
+                 batch[i]->nsectors * queue->sectsize);
+        }
+
+      nsectors += batch[i]->nsectors;
+    }
+
+  if (!req->write)
+    {
+      ret = inode->u.i_bops->read(inode, buffer, req->start, nsectors);
+    }
+  else if (inode->u.i_bops->write != NULL)
+    {
+      ret = inode->u.i_bops->write(inode, buffer, req->start, nsectors);
+    }
+  else
+    {
+      ret = -EACCES;
+    }
+
+  /* Split the result among the requests, a short transfer completes the
+   * leading requests and fails the remaining ones.
+   */
+
+  for (i = 0; i < nreqs; i++)
+    {
+      req = batch[i];
+      if (ret < 0)
+        {
+          req->result = ret;
+        }
+      else if ((size_t)ret > offset)
+        {
+          req->result = MIN((size_t)ret - offset, req->nsectors);
+          if (nreqs > 1 && !req->write)
+            {
+              memcpy(req->buffer, buffer + offset * queue->sectsize,
+                     req->result * queue->sectsize);
+            }
+        }
+      else
+        {
+          req->result = -EIO;
+        }
+
+      offset += req->nsectors;
+      nxsem_post(&req->done);
+    }
+}
+
+/****************************************************************************
+ * Name: blkqueue_thread
+ *
+ * Description:
+ *   The dispatcher.  On the first request it waits for the plug delay so
+ *   that more requests can gather, then dispatches until the queue is
+ *   empty.
+ *
+ ****************************************************************************/
+
+static int blkqueue_thread(int argc, FAR char *argv[])
+{
+  FAR struct blkqueue_req_s *batch[CONFIG_DRVR_BLKQUEUE_BATCH];
+  FAR struct blkqueue_s *queue;
+  int nreqs;
+
+  queue = (FAR struct blkqueue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&queue->wake);
+      if (queue->exit)
+        {
+          break;
+        }
+
+#if CONFIG_DRVR_BLKQUEUE_PLUG_USEC > 0
+      if (queue->nreqs < CONFIG_DRVR_BLKQUEUE_BATCH)
+        {
+          nxsched_usleep(CONFIG_DRVR_BLKQUEUE_PLUG_USEC);
+        }
+#endif
+
+      nxmutex_lock(&queue->lock);
+      while ((nreqs = blkqueue_pick(queue, batch)) > 0)
+        {
+          nxmutex_unlock(&queue->lock);
+          blkqueue_dispatch(queue, batch, nreqs);
+          nxmutex_lock(&queue->lock);
+        }
+
+      nxmutex_unlock(&queue->lock);
+    }
+
+  nxsem_post(&queue->exitsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkqueue_submit
+ *
+ * Description:
+ *   Queue a read or write request and wait for its completion.
+ *
+ ****************************************************************************/
+
+static ssize_t blkqueue_submit(FAR struct blkqueue_s *queue,
+                               FAR uint8_t *buffer, blkcnt_t start_sector,
+                               unsigned int nsectors, bool write)
+{
+  struct blkqueue_req_s req;
+
+  if (nsectors == 0)
+    {
+      return 0;
+    }
+
+  req.buffer   = buffer;
+  req.start    = start_sector;
+  req.nsectors = nsectors;
+  req.write    = write;
+  req.expire   = clock_systime_ticks() +
+                 (write ? BLKQUEUE_WRITE_EXPIRE : BLKQUEUE_READ_EXPIRE);
+  nxsem_init(&req.done, 0, 0);
+
+  nxmutex_lock(&queue->lock);
+  blkqueue_insert(queue, &req);
+  if (queue->nreqs++ == 0)
+    {
+      nxsem_post(&queue->wake);
+    }
+
+  nxmutex_unlock(&queue->lock);
+
+  nxsem_wait_uninterruptible(&req.done);
+  nxsem_destroy(&req.done);
+  return req.result;
+}
+
+/****************************************************************************
+ * Name: blkqueue_open
+ ****************************************************************************/
+
+static int blkqueue_open(FAR struct inode *inode)
+{
+  FAR struct blkqueue_s *queue = inode->i_private;
+
+  nxmutex_lock(&queue->lock);
+  queue->crefs++;
+  nxmutex_unlock(&queue->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkqueue_close
+ ****************************************************************************/
+
+static int blkqueue_close(FAR struct inode *inode)
+{
+  FAR struct blkqueue_s *queue = inode->i_private;
+
+  nxmutex_lock(&queue->lock);
+  DEBUGASSERT(queue->crefs > 0);
+  queue->crefs--;
+  nxmutex_unlock(&queue->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkqueue_read
+ ****************************************************************************/
+
+static ssize_t blkqueue_read(FAR struct inode *inode,
+                             FAR unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors)
+{
+  return blkqueue_submit(inode->i_private, buffer, start_sector, nsectors,
+                         false);
+}
+
+/****************************************************************************
+ * Name: blkqueue_write
+ ****************************************************************************/
+
+static ssize_t blkqueue_write(FAR struct inode *inode,
+                              FAR const unsigned char *buffer,
+                              blkcnt_t start_sector, unsigned int nsectors)
+{
+  return blkqueue_submit(inode->i_private, (FAR uint8_t *)buffer,
+                         start_sector, nsectors, true);
+}
+
+/****************************************************************************
+ * Name: blkqueue_geometry
+ ****************************************************************************/
+
+static int blkqueue_geometry(FAR struct inode *inode,
+                             FAR struct geometry *geometry)
+{
+  FAR struct blkqueue_s *queue = inode->i_private;
+
+  return queue->inode->u.i_bops->geometry(queue->inode, geometry);
+}
+
+/****************************************************************************
+ * Name: blkqueue_ioctl
+ ****************************************************************************/
+
+static int blkqueue_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg)
+{
+  FAR struct blkqueue_s *queue = inode->i_private;
+
+  if (queue->inode->u.i_bops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return queue->inode->u.i_bops->ioctl(queue->inode, cmd, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkqueue_register
+ *
+ * Description:
+ *   Export the block driver 'blkdev' as the block driver 'qdev', whose
+ *   read and write requests go through a request queue.
+ *
+ * Input Parameters:
+ *   blkdev - The path to the lower block driver
+ *   qdev   - The path to the block driver to create
+ *   policy - The dispatch policy, BLKQUEUE_POLICY_NONE or
+ *            BLKQUEUE_POLICY_DEADLINE
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkqueue_register(FAR const char *blkdev, FAR const char *qdev,
+                      int policy)
+{
+  FAR struct blkqueue_s *queue;
+  FAR char *argv[2];
+  struct geometry geo;
+  char arg1[32];
+  int ret;
+
+  DEBUGASSERT(blkdev != NULL && qdev != NULL);
+
+  if (policy != BLKQUEUE_POLICY_NONE && policy != BLKQUEUE_POLICY_DEADLINE)
+    {
+      return -EINVAL;
+    }
+
+  queue = kmm_zalloc(sizeof(struct blkqueue_s));
+  if (queue == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = open_blockdriver(blkdev, 0, &queue->inode);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to open %s: %d\n", blkdev, ret);
+      goto errout_with_queue;
+    }
+
+  ret = queue->inode->u.i_bops->geometry(queue->inode, &geo);
+  if (ret < 0 || !geo.geo_available || geo.geo_sectorsize == 0)
+    {
+      ferr("ERROR: geometry failed: %d\n", ret);
+      ret = -ENODEV;
+      goto errout_with_inode;
+    }
+
+  queue->sectsize   = geo.geo_sectorsize;
+  queue->policy     = policy;
+  queue->bufsectors = CONFIG_DRVR_BLKQUEUE_MERGE_SIZE / geo.geo_sectorsize;
+  if (queue->bufsectors > 1)
+    {
+      queue->buffer = kmm_malloc(queue->bufsectors * geo.geo_sectorsize);
+      if (queue->buffer == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_inode;
+        }
+    }
+  else
+    {
+      queue->bufsectors = 0;
+    }
+
+  nxmutex_init(&queue->lock);
+  nxsem_init(&queue->wake, 0, 0);
+  nxsem_init(&queue->exitsem, 0, 0);
+  dq_init(&queue->sorted);
+  dq_init(&queue->fifo);
+
+  snprintf(arg1, sizeof(arg1), "%p", queue);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  ret = kthread_create("blkqueue", CONFIG_DRVR_BLKQUEUE_PRIORITY,
+                       CONFIG_DRVR_BLKQUEUE_STACKSIZE, blkqueue_thread,
+                       argv);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to create the dispatcher: %d\n", ret);
+      goto errout_with_sem;
+    }
+
+  ret = register_blockdriver(qdev, &g_blkqueue_bops, 0666, queue);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to register %s: %d\n", qdev, ret);
+      queue->exit = true;
+      nxsem_post(&queue->wake);
+      nxsem_wait_uninterruptible(&queue->exitsem);
+      goto errout_with_sem;
+    }
+
+  return OK;
+
+errout_with_sem:
+  nxsem_destroy(&queue->exitsem);
+  nxsem_destroy(&queue->wake);
+  nxmutex_destroy(&queue->lock);
+  kmm_free(queue->buffer);
+errout_with_inode:
+  close_blockdriver(queue->inode);
+errout_with_queue:
+  kmm_free(queue);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: blkqueue_unregister
+ *
+ * Description:
+ *   Remove a request queue created by a previous call to
+ *   blkqueue_register().
+ *
+ ****************************************************************************/
+
+int blkqueue_unregister(FAR const char *qdev)
+{
+  FAR struct blkqueue_s *queue;
+  FAR struct inode *inode;
+  int ret;
+
+  ret = open_blockdriver(qdev, 0, &inode);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (inode->u.i_bops != &g_blkqueue_bops)
+    {
+      close_blockdriver(inode);
+      return -EINVAL;
+    }
+
+  queue = inode->i_private;
+  nxmutex_lock(&queue->lock);
+  if (queue->crefs > 1)
+    {
+      nxmutex_unlock(&queue->lock);
+      close_blockdriver(inode);
+      return -EBUSY;
+    }
+
+  nxmutex_unlock(&queue->lock);
+  close_blockdriver(inode);
+
+  ret = unregister_blockdriver(qdev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  queue->exit = true;
+  nxsem_post(&queue->wake);
+  nxsem_wait_uninterruptible(&queue->exitsem);
+
+  nxsem_destroy(&queue->exitsem);
+  nxsem_destroy(&queue->wake);
+  nxmutex_destroy(&queue->lock);
+  close_blockdriver(queue->inode);
+  kmm_free(queue->buffer);
+  kmm_free(queue);
+  return OK;
+}
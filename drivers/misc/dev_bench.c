@@ -0,0 +1,960 @@
+/****************************************************************************
+ * drivers/misc/dev_bench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_NITER     CONFIG_DEV_BENCH_ITERATIONS
+#define BENCH_BUFSIZE   2048
+#define BENCH_MQNAME    "devbench"
+
+#if !defined(CONFIG_DISABLE_MQUEUE) && defined(CONFIG_MQ_MAXMSGSIZE) && \
+    CONFIG_MQ_MAXMSGSIZE > 0
+#  define BENCH_MQUEUE
+#  define BENCH_MSGSIZE MIN(16, CONFIG_MQ_MAXMSGSIZE)
+#endif
+
+#if defined(CONFIG_NET_LOOPBACK) && defined(CONFIG_NET_IPv4)
+#  ifdef CONFIG_NET_TCP
+#    define BENCH_TCP
+#  endif
+#  ifdef CONFIG_NET_UDP
+#    define BENCH_UDP
+#  endif
+#  define BENCH_PORT    5471
+#  define BENCH_CHUNK   1024
+#endif
+
+#if defined(CONFIG_SCHED_HPWORK)
+#  define BENCH_WORK    HPWORK
+#elif defined(CONFIG_SCHED_LPWORK)
+#  define BENCH_WORK    LPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one run, shared with the peer threads and the callbacks */
+
+struct bench_s
+{
+  sem_t           ping;       /* Posted to the peer */
+  sem_t           pong;       /* Posted back by the peer or a callback */
+  sem_t           exit;       /* Posted when the peer is gone */
+  volatile bool   stop;       /* Tells the peer to exit */
+  volatile bool   yield;      /* The peer yields instead of waiting ping */
+#ifdef BENCH_TCP
+  volatile bool   echo;       /* The TCP server echoes what it receives */
+  struct socket   listener;   /* The TCP server socket */
+#endif
+  clock_t         stamp;      /* When the work was queued */
+  clock_t         latency;    /* Sum of the work queue latencies */
+  uint32_t        nexhausted; /* IOB exhaustion count at test start */
+  FAR char       *buffer;     /* The results */
+  size_t          buflen;     /* Bytes in buffer */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     devbench_close(FAR struct file *filep);
+static ssize_t devbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_devbench_fops =
+{
+  NULL,                  /* open */
+  devbench_close,        /* close */
+  devbench_read,         /* read */
+};
+
+/* One run at a time, the peer thread and mqueue name are shared */
+
+static mutex_t g_devbench_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_ns
+ ****************************************************************************/
+
+static unsigned long bench_ns(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: bench_start
+ *
+ * Description:
+ *   Start the statistics reported along with a test and return the start
+ *   time.
+ *
+ ****************************************************************************/
+
+static clock_t bench_start(FAR struct bench_s *bench)
+{
+#ifdef CONFIG_NET_LOCK_STATS
+  struct net_lockstats_s lockstats;
+#endif
+#ifdef CONFIG_MM_IOB
+  struct iob_stats_s iobstats;
+#endif
+
+#ifdef CONFIG_NET_LOCK_STATS
+  net_lockstats(&lockstats, true);
+#endif
+
+#ifdef CONFIG_MM_IOB
+  iob_getstats(&iobstats);
+  bench->nexhausted = iobstats.nexhausted;
+#endif
+
+  return perf_gettime();
+}
+
+/****************************************************************************
+ * Name: bench_report
+ *
+ * Description:
+ *   Append one result line: name, iterations, total and per iteration
+ *   time, then the net_lock() hold time, longest hold and IOB exhaustion
+ *   count during the test.  Times are in nanoseconds.
+ *
+ ****************************************************************************/
+
+static void bench_report(FAR struct bench_s *bench, FAR const char *name,
+                         int niter, clock_t elapsed)
+{
+  unsigned long lockns = 0;
+  unsigned long lockmax = 0;
+  unsigned long exhausted = 0;
+  unsigned long ns;
+#ifdef CONFIG_NET_LOCK_STATS
+  struct net_lockstats_s lockstats;
+#endif
+#ifdef CONFIG_MM_IOB
+  struct iob_stats_s iobstats;
+#endif
+
+  ns = bench_ns(elapsed);
+
+#ifdef CONFIG_NET_LOCK_STATS
+  net_lockstats(&lockstats, false);
+  lockns  = bench_ns(lockstats.total);
+  lockmax = bench_ns(lockstats.max);
+#endif
+
+#ifdef CONFIG_MM_IOB
+  iob_getstats(&iobstats);
+  exhausted = iobstats.nexhausted - bench->nexhausted;
+#endif
+
+  bench->buflen += snprintf(bench->buffer + bench->buflen,
+                            BENCH_BUFSIZE - bench->buflen,
+                            "%s,%d,%lu,%lu,%lu,%lu,%lu\n", name, niter,
+                            ns, niter > 0 ? ns / niter : 0, lockns,
+                            lockmax, exhausted);
+  bench->buflen = MIN(bench->buflen, BENCH_BUFSIZE - 1);
+}
+
+/****************************************************************************
+ * Name: bench_spawn
+ *
+ * Description:
+ *   Start a peer thread at the priority of the reader.  The thread posts
+ *   bench->exit when it is done.
+ *
+ ****************************************************************************/
+
+static int bench_spawn(FAR struct bench_s *bench, main_t entry)
+{
+  FAR char *argv[2];
+  char arg1[32];
+
+  snprintf(arg1, sizeof(arg1), "%p", bench);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  return kthread_create("bench", nxsched_self()->sched_priority,
+                        CONFIG_DEFAULT_TASK_STACKSIZE, entry, argv);
+}
+
+/****************************************************************************
+ * Name: bench_peer
+ *
+ * Description:
+ *   The other side of the context switch tests, it runs at the priority
+ *   of the reader.
+ *
+ ****************************************************************************/
+
+static int bench_peer(int argc, FAR char *argv[])
+{
+  FAR struct bench_s *bench;
+
+  bench = (FAR struct bench_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  while (!bench->stop)
+    {
+      if (bench->yield)
+        {
+          sched_yield();
+        }
+      else
+        {
+          nxsem_wait_uninterruptible(&bench->ping);
+          if (!bench->stop)
+            {
+              nxsem_post(&bench->pong);
+            }
+        }
+    }
+
+  nxsem_post(&bench->exit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_switch
+ *
+ * Description:
+ *   sched_yield() and semaphore ping-pong to a thread of the same
+ *   priority, each iteration is a round trip of two context switches.
+ *
+ ****************************************************************************/
+
+static void bench_switch(FAR struct bench_s *bench)
+{
+  clock_t start;
+  int i;
+
+  bench->stop  = false;
+  bench->yield = true;
+  if (bench_spawn(bench, bench_peer) < 0)
+    {
+      return;
+    }
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      sched_yield();
+    }
+
+  bench_report(bench, "sched_yield", BENCH_NITER,
+               perf_gettime() - start);
+
+  /* The peer may be in sched_yield() or about to wait ping already */
+
+  bench->yield = false;
+  nxsem_post(&bench->ping);
+  nxsem_wait_uninterruptible(&bench->pong);
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      nxsem_post(&bench->ping);
+      nxsem_wait_uninterruptible(&bench->pong);
+    }
+
+  bench_report(bench, "sem_pingpong", BENCH_NITER,
+               perf_gettime() - start);
+
+  bench->stop = true;
+  nxsem_post(&bench->ping);
+  nxsem_wait_uninterruptible(&bench->exit);
+}
+
+/****************************************************************************
+ * Name: bench_sem
+ ****************************************************************************/
+
+static void bench_sem(FAR struct bench_s *bench)
+{
+  clock_t start;
+  sem_t sem;
+  int i;
+
+  nxsem_init(&sem, 0, 0);
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      nxsem_post(&sem);
+      nxsem_wait(&sem);
+    }
+
+  bench_report(bench, "nxsem_post_wait", BENCH_NITER,
+               perf_gettime() - start);
+  nxsem_destroy(&sem);
+}
+
+/****************************************************************************
+ * Name: bench_mq
+ ****************************************************************************/
+
+#ifdef BENCH_MQUEUE
+static void bench_mq(FAR struct bench_s *bench)
+{
+  char msg[BENCH_MSGSIZE];
+  struct mq_attr attr;
+  struct file mq;
+  clock_t start;
+  int ret;
+  int i;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = BENCH_MSGSIZE;
+
+  ret = file_mq_open(&mq, BENCH_MQNAME, O_RDWR | O_CREAT, 0600, &attr);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  memset(msg, 0, sizeof(msg));
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      file_mq_send(&mq, msg, sizeof(msg), 0);
+      file_mq_receive(&mq, msg, sizeof(msg), NULL);
+    }
+
+  bench_report(bench, "mq_send_receive", BENCH_NITER,
+               perf_gettime() - start);
+
+  file_mq_close(&mq);
+  file_mq_unlink(BENCH_MQNAME);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_malloc
+ ****************************************************************************/
+
+static void bench_malloc(FAR struct bench_s *bench)
+{
+  static const size_t sizes[] =
+  {
+    16, 64, 256, 1024, 4096
+  };
+
+  char name[32];
+  clock_t start;
+  FAR void *mem;
+  size_t j;
+  int i;
+
+  for (j = 0; j < nitems(sizes); j++)
+    {
+      start = bench_start(bench);
+      for (i = 0; i < BENCH_NITER; i++)
+        {
+          mem = kmm_malloc(sizes[j]);
+          kmm_free(mem);
+        }
+
+      snprintf(name, sizeof(name), "malloc_free_%zu", sizes[j]);
+      bench_report(bench, name, BENCH_NITER,
+                   perf_gettime() - start);
+    }
+}
+
+/****************************************************************************
+ * Name: bench_wdog
+ ****************************************************************************/
+
+static void bench_wdentry(wdparm_t arg)
+{
+}
+
+static void bench_wdog(FAR struct bench_s *bench)
+{
+  struct wdog_s wdog;
+  clock_t start;
+  int i;
+
+  memset(&wdog, 0, sizeof(wdog));
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      wd_start(&wdog, SEC2TICK(10), bench_wdentry, 0);
+      wd_cancel(&wdog);
+    }
+
+  bench_report(bench, "wd_start_cancel", BENCH_NITER,
+               perf_gettime() - start);
+}
+
+/****************************************************************************
+ * Name: bench_work
+ *
+ * Description:
+ *   The time from work_queue() until the worker runs.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_WORK
+static void bench_worker(FAR void *arg)
+{
+  FAR struct bench_s *bench = arg;
+
+  bench->latency += perf_gettime() - bench->stamp;
+  nxsem_post(&bench->pong);
+}
+
+static void bench_work(FAR struct bench_s *bench)
+{
+  struct work_s work;
+  int i;
+
+  memset(&work, 0, sizeof(work));
+  bench->latency = 0;
+  bench_start(bench);
+
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      bench->stamp = perf_gettime();
+      work_queue(BENCH_WORK, &work, bench_worker, bench, 0);
+      nxsem_wait_uninterruptible(&bench->pong);
+    }
+
+  bench_report(bench, "work_queue_latency", BENCH_NITER, bench->latency);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_iob
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+static void bench_iob(FAR struct bench_s *bench)
+{
+  FAR struct iob_s *iob;
+  clock_t start;
+  int i;
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          return;
+        }
+
+      iob_free(iob);
+    }
+
+  bench_report(bench, "iob_alloc_free", BENCH_NITER,
+               perf_gettime() - start);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_epoll
+ *
+ * Description:
+ *   epoll_wait() of a descriptor that is always ready.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_NULL
+static void bench_epoll(FAR struct bench_s *bench)
+{
+  struct epoll_event ev;
+  clock_t start;
+  int epfd;
+  int fd;
+  int i;
+
+  fd = nx_open("/dev/null", O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    {
+      return;
+    }
+
+  epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (epfd < 0)
+    {
+      goto errout_with_fd;
+    }
+
+  ev.events  = EPOLLIN;
+  ev.data.fd = fd;
+  if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+      goto errout_with_epfd;
+    }
+
+  start = bench_start(bench);
+  for (i = 0; i < BENCH_NITER; i++)
+    {
+      epoll_wait(epfd, &ev, 1, 0);
+    }
+
+  bench_report(bench, "epoll_wait", BENCH_NITER,
+               perf_gettime() - start);
+
+errout_with_epfd:
+  nx_close(epfd);
+
+errout_with_fd:
+  nx_close(fd);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_addr
+ ****************************************************************************/
+
+#if defined(BENCH_TCP) || defined(BENCH_UDP)
+static void bench_addr(FAR struct sockaddr_in *addr, int port)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family      = AF_INET;
+  addr->sin_port        = HTONS(port);
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_tcp_server
+ *
+ * Description:
+ *   Serve the TCP tests one connection at a time, sinking or echoing the
+ *   data until the client closes.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_TCP
+static int bench_tcp_server(int argc, FAR char *argv[])
+{
+  FAR struct bench_s *bench;
+  struct socket conn;
+  FAR char *buf;
+  ssize_t n;
+
+  bench = (FAR struct bench_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  buf   = kmm_malloc(BENCH_CHUNK);
+
+  while (buf != NULL && !bench->stop &&
+         psock_accept(&bench->listener, NULL, NULL, &conn, 0) >= 0)
+    {
+      while ((n = psock_recv(&conn, buf, BENCH_CHUNK, 0)) > 0)
+        {
+          if (bench->echo)
+            {
+              psock_send(&conn, buf, n, 0);
+            }
+        }
+
+      psock_close(&conn);
+    }
+
+  kmm_free(buf);
+  nxsem_post(&bench->exit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bench_tcp_connect
+ ****************************************************************************/
+
+static int bench_tcp_connect(FAR struct socket *sock,
+                             FAR const struct sockaddr_in *addr)
+{
+  int ret;
+
+  ret = psock_socket(AF_INET, SOCK_STREAM, 0, sock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = psock_connect(sock, (FAR const struct sockaddr *)addr,
+                      sizeof(*addr));
+  if (ret < 0)
+    {
+      psock_close(sock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bench_tcp
+ *
+ * Description:
+ *   TCP connection setup and teardown, a 1 KiB stream and one byte
+ *   request/response over the loopback device.
+ *
+ ****************************************************************************/
+
+static void bench_tcp(FAR struct bench_s *bench)
+{
+  struct sockaddr_in addr;
+  struct socket sock;
+  clock_t start;
+  FAR char *buf;
+  int n;
+
+  buf = kmm_zalloc(BENCH_CHUNK);
+  if (buf == NULL)
+    {
+      return;
+    }
+
+  bench_addr(&addr, BENCH_PORT);
+  if (psock_socket(AF_INET, SOCK_STREAM, 0, &bench->listener) < 0)
+    {
+      goto errout_with_buf;
+    }
+
+  bench->stop = false;
+  bench->echo = false;
+  if (psock_bind(&bench->listener, (FAR struct sockaddr *)&addr,
+                 sizeof(addr)) < 0 ||
+      psock_listen(&bench->listener, 4) < 0 ||
+      bench_spawn(bench, bench_tcp_server) < 0)
+    {
+      goto errout_with_listener;
+    }
+
+  start = bench_start(bench);
+  for (n = 0; n < BENCH_NITER; n++)
+    {
+      if (bench_tcp_connect(&sock, &addr) < 0)
+        {
+          break;
+        }
+
+      psock_close(&sock);
+    }
+
+  bench_report(bench, "tcp_connect", n, perf_gettime() - start);
+
+  if (bench_tcp_connect(&sock, &addr) >= 0)
+    {
+      start = bench_start(bench);
+      for (n = 0; n < BENCH_NITER; n++)
+        {
+          if (psock_send(&sock, buf, BENCH_CHUNK, 0) != BENCH_CHUNK)
+            {
+              break;
+            }
+        }
+
+      bench_report(bench, "tcp_stream_1k", n, perf_gettime() - start);
+      psock_close(&sock);
+    }
+
+  bench->echo = true;
+  if (bench_tcp_connect(&sock, &addr) >= 0)
+    {
+      start = bench_start(bench);
+      for (n = 0; n < BENCH_NITER; n++)
+        {
+          if (psock_send(&sock, buf, 1, 0) != 1 ||
+              psock_recv(&sock, buf, 1, 0) != 1)
+            {
+              break;
+            }
+        }
+
+      bench_report(bench, "tcp_rr", n, perf_gettime() - start);
+      psock_close(&sock);
+    }
+
+  /* One more connection gets the server out of accept() */
+
+  bench->stop = true;
+  if (bench_tcp_connect(&sock, &addr) >= 0)
+    {
+      psock_close(&sock);
+      nxsem_wait_uninterruptible(&bench->exit);
+    }
+
+errout_with_listener:
+  psock_close(&bench->listener);
+
+errout_with_buf:
+  kmm_free(buf);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_udp
+ *
+ * Description:
+ *   Small UDP datagrams over the loopback device, one way and request/
+ *   response.
+ *
+ ****************************************************************************/
+
+#ifdef BENCH_UDP
+static void bench_udp(FAR struct bench_s *bench)
+{
+  struct sockaddr_in addr[2];
+  struct socket sock[2];
+  char buf[64];
+  clock_t start;
+  int n;
+
+  bench_addr(&addr[0], BENCH_PORT);
+  bench_addr(&addr[1], BENCH_PORT + 1);
+  memset(buf, 0, sizeof(buf));
+
+  if (psock_socket(AF_INET, SOCK_DGRAM, 0, &sock[0]) < 0)
+    {
+      return;
+    }
+
+  if (psock_socket(AF_INET, SOCK_DGRAM, 0, &sock[1]) < 0)
+    {
+      goto errout_with_sock0;
+    }
+
+  if (psock_bind(&sock[0], (FAR struct sockaddr *)&addr[0],
+                 sizeof(addr[0])) < 0 ||
+      psock_bind(&sock[1], (FAR struct sockaddr *)&addr[1],
+                 sizeof(addr[1])) < 0)
+    {
+      goto errout_with_sock1;
+    }
+
+  start = bench_start(bench);
+  for (n = 0; n < BENCH_NITER; n++)
+    {
+      if (psock_sendto(&sock[0], buf, sizeof(buf), 0,
+                       (FAR struct sockaddr *)&addr[1],
+                       sizeof(addr[1])) < 0 ||
+          psock_recv(&sock[1], buf, sizeof(buf), 0) < 0)
+        {
+          break;
+        }
+    }
+
+  bench_report(bench, "udp_64", n, perf_gettime() - start);
+
+  start = bench_start(bench);
+  for (n = 0; n < BENCH_NITER; n++)
+    {
+      if (psock_sendto(&sock[0], buf, sizeof(buf), 0,
+                       (FAR struct sockaddr *)&addr[1],
+                       sizeof(addr[1])) < 0 ||
+          psock_recv(&sock[1], buf, sizeof(buf), 0) < 0 ||
+          psock_sendto(&sock[1], buf, sizeof(buf), 0,
+                       (FAR struct sockaddr *)&addr[0],
+                       sizeof(addr[0])) < 0 ||
+          psock_recv(&sock[0], buf, sizeof(buf), 0) < 0)
+        {
+          break;
+        }
+    }
+
+  bench_report(bench, "udp_rr", n, perf_gettime() - start);
+
+errout_with_sock1:
+  psock_close(&sock[1]);
+
+errout_with_sock0:
+  psock_close(&sock[0]);
+}
+#endif
+
+/****************************************************************************
+ * Name: bench_run
+ ****************************************************************************/
+
+static FAR char *bench_run(void)
+{
+  struct bench_s bench;
+
+  memset(&bench, 0, sizeof(bench));
+  bench.buffer = kmm_malloc(BENCH_BUFSIZE);
+  if (bench.buffer == NULL)
+    {
+      return NULL;
+    }
+
+  nxsem_init(&bench.ping, 0, 0);
+  nxsem_init(&bench.pong, 0, 0);
+  nxsem_init(&bench.exit, 0, 0);
+
+  bench.buflen = snprintf(bench.buffer, BENCH_BUFSIZE,
+                          "test,iterations,total_ns,ns_per_iteration,"
+                          "netlock_ns,netlock_max_ns,iob_exhausted\n");
+
+  bench_switch(&bench);
+  bench_sem(&bench);
+#ifdef BENCH_MQUEUE
+  bench_mq(&bench);
+#endif
+  bench_malloc(&bench);
+  bench_wdog(&bench);
+#ifdef BENCH_WORK
+  bench_work(&bench);
+#endif
+#ifdef CONFIG_MM_IOB
+  bench_iob(&bench);
+#endif
+#ifdef CONFIG_DEV_NULL
+  bench_epoll(&bench);
+#endif
+#ifdef BENCH_TCP
+  bench_tcp(&bench);
+#endif
+#ifdef BENCH_UDP
+  bench_udp(&bench);
+#endif
+
+  nxsem_destroy(&bench.ping);
+  nxsem_destroy(&bench.pong);
+  nxsem_destroy(&bench.exit);
+  return bench.buffer;
+}
+
+/****************************************************************************
+ * Name: devbench_close
+ ****************************************************************************/
+
+static int devbench_close(FAR struct file *filep)
+{
+  if (filep->f_priv != NULL)
+    {
+      kmm_free(filep->f_priv);
+      filep->f_priv = NULL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devbench_read
+ *
+ * Description:
+ *   The first read of an open file runs the tests, the results are then
+ *   read as CSV text.
+ *
+ ****************************************************************************/
+
+static ssize_t devbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR const char *results;
+  size_t len;
+  int ret;
+
+  if (filep->f_priv == NULL)
+    {
+      ret = nxmutex_lock(&g_devbench_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      filep->f_priv = bench_run();
+      nxmutex_unlock(&g_devbench_lock);
+
+      if (filep->f_priv == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  results = filep->f_priv;
+  len     = strlen(results);
+  if (filep->f_pos >= (off_t)len)
+    {
+      return 0;
+    }
+
+  len = MIN(buflen, len - filep->f_pos);
+  memcpy(buffer, results + filep->f_pos, len);
+  filep->f_pos += len;
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devbench_register
+ *
+ * Description:
+ *   Register /dev/bench driver
+ *
+ ****************************************************************************/
+
+int devbench_register(void)
+{
+  return register_driver("/dev/bench", &g_devbench_fops, 0444, NULL);
+}
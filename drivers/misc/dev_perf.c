@@ -0,0 +1,579 @@
+/****************************************************************************
+ * drivers/misc/dev_perf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/drivers/perf.h>
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The counters of one open file.  All of the fields are protected by the
+ * critical section, as they are touched on every context switch of the
+ * attached thread.
+ */
+
+struct perf_group_s
+{
+  pid_t    pid;                               /* Attached thread */
+  bool     attached;                          /* PERFIOC_ATTACH done */
+  bool     enabled;                           /* PERFIOC_ENABLE done */
+  bool     running;                           /* Counting on a CPU now */
+  uint8_t  nevents;                           /* Number of events */
+  uint8_t  events[CONFIG_DEV_PERF_NEVENTS];   /* PERF_EVENT_* values */
+  uint64_t counts[CONFIG_DEV_PERF_NEVENTS];   /* Counts up to 'starts' */
+  uint64_t starts[CONFIG_DEV_PERF_NEVENTS];   /* Counter values at resume */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     devperf_open(FAR struct file *filep);
+static int     devperf_close(FAR struct file *filep);
+static ssize_t devperf_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static int     devperf_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_devperf_fops =
+{
+  devperf_open,          /* open */
+  devperf_close,         /* close */
+  devperf_read,          /* read */
+  NULL,                  /* write */
+  NULL,                  /* seek */
+  devperf_ioctl,         /* ioctl */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devperf_now
+ *
+ * Description:
+ *   Return the current value of the counter backing event 'i' of a group.
+ *   Hardware events use one programmable counter each, in the order they
+ *   appear in the group.
+ *
+ ****************************************************************************/
+
+static uint64_t devperf_now(FAR struct perf_group_s *group, int i,
+                            int hw)
+{
+  switch (group->events[i])
+    {
+      case PERF_EVENT_CPU_CLOCK:
+        return perf_gettime();
+
+      case PERF_EVENT_CONTEXT_SWITCHES:
+        return 0;
+
+      default:
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTERS
+        return up_perf_counter_read(hw);
+#else
+        return 0;
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: devperf_delta
+ *
+ * Description:
+ *   Return the count of event 'i' since its thread was last resumed.
+ *
+ ****************************************************************************/
+
+static uint64_t devperf_delta(FAR struct perf_group_s *group, int i,
+                              int hw)
+{
+  uint64_t now = devperf_now(group, i, hw);
+
+  if (group->events[i] >= PERF_EVENT_FIRST_HW)
+    {
+      /* The hardware counters are only 32 bits wide */
+
+      return (uint32_t)(now - group->starts[i]);
+    }
+
+  return (clock_t)(now - group->starts[i]);
+}
+
+/****************************************************************************
+ * Name: devperf_start
+ *
+ * Description:
+ *   Start the counters of a group on the current CPU.
+ *
+ ****************************************************************************/
+
+static void devperf_start(FAR struct perf_group_s *group)
+{
+  int hw = 0;
+  int i;
+
+  for (i = 0; i < group->nevents; i++)
+    {
+      if (group->events[i] == PERF_EVENT_CONTEXT_SWITCHES)
+        {
+          group->counts[i]++;
+        }
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTERS
+      else if (group->events[i] >= PERF_EVENT_FIRST_HW)
+        {
+          up_perf_counter_start(hw, group->events[i]);
+        }
+#endif
+
+      group->starts[i] = devperf_now(group, i, hw);
+      if (group->events[i] >= PERF_EVENT_FIRST_HW)
+        {
+          hw++;
+        }
+    }
+
+  group->running = true;
+}
+
+/****************************************************************************
+ * Name: devperf_stop
+ *
+ * Description:
+ *   Stop the counters of a group on the current CPU and accumulate them.
+ *
+ ****************************************************************************/
+
+static void devperf_stop(FAR struct perf_group_s *group)
+{
+  int hw = 0;
+  int i;
+
+  for (i = 0; i < group->nevents; i++)
+    {
+      group->counts[i] += devperf_delta(group, i, hw);
+      if (group->events[i] >= PERF_EVENT_FIRST_HW)
+        {
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTERS
+          up_perf_counter_stop(hw);
+#endif
+          hw++;
+        }
+    }
+
+  group->running = false;
+}
+
+/****************************************************************************
+ * Name: devperf_probe
+ *
+ * Description:
+ *   Check that the hardware can count all of the events of a group by
+ *   programming them once on the current CPU.  The counters of the calling
+ *   thread, if any, are saved and restored around the probe.
+ *
+ ****************************************************************************/
+
+static int devperf_probe(FAR const struct perf_attr_s *attr)
+{
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTERS
+  FAR struct perf_group_s *self = nxsched_self()->perf;
+  int ret = OK;
+  int hw = 0;
+#endif
+  int i;
+
+  for (i = 0; i < attr->nevents; i++)
+    {
+      if (attr->events[i] >= PERF_EVENT_NEVENTS)
+        {
+          return -EINVAL;
+        }
+
+#ifndef CONFIG_ARCH_HAVE_PERF_COUNTERS
+      if (attr->events[i] >= PERF_EVENT_FIRST_HW)
+        {
+          return -ENOTSUP;
+        }
+#endif
+    }
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTERS
+  if (self != NULL && self->running)
+    {
+      devperf_stop(self);
+    }
+
+  for (i = 0; i < attr->nevents && ret >= 0; i++)
+    {
+      if (attr->events[i] >= PERF_EVENT_FIRST_HW)
+        {
+          ret = up_perf_counter_start(hw, attr->events[i]);
+          up_perf_counter_stop(hw++);
+        }
+    }
+
+  if (self != NULL && self->enabled)
+    {
+      devperf_start(self);
+    }
+
+  return ret;
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: devperf_attach
+ ****************************************************************************/
+
+static int devperf_attach(FAR struct perf_group_s *group,
+                          FAR const struct perf_attr_s *attr)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  pid_t pid;
+  int ret;
+
+  if (attr == NULL || attr->nevents == 0 ||
+      attr->nevents > CONFIG_DEV_PERF_NEVENTS)
+    {
+      return -EINVAL;
+    }
+
+  pid = attr->pid != 0 ? attr->pid : nxsched_gettid();
+
+  flags = enter_critical_section();
+
+  if (group->attached)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  tcb = nxsched_get_tcb(pid);
+  if (tcb == NULL)
+    {
+      ret = -ESRCH;
+      goto out;
+    }
+
+  if (tcb->perf != NULL)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  ret = devperf_probe(attr);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  group->pid      = pid;
+  group->nevents  = attr->nevents;
+  memcpy(group->events, attr->events, attr->nevents);
+  memset(group->counts, 0, sizeof(group->counts));
+  group->attached = true;
+  tcb->perf       = group;
+
+out:
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: devperf_enable
+ *
+ * Description:
+ *   Enable or disable the counters of a group.  The counters of the caller
+ *   change at once; those of a thread running on another CPU change when
+ *   it is next suspended or resumed.
+ *
+ ****************************************************************************/
+
+static int devperf_enable(FAR struct perf_group_s *group, bool enable)
+{
+  FAR struct tcb_s *self = nxsched_self();
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (!group->attached)
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  group->enabled = enable;
+  if (self->perf == group)
+    {
+      if (enable && !group->running)
+        {
+          devperf_start(group);
+        }
+      else if (!enable && group->running)
+        {
+          devperf_stop(group);
+        }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devperf_reset
+ ****************************************************************************/
+
+static int devperf_reset(FAR struct perf_group_s *group)
+{
+  int hw = 0;
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+
+  memset(group->counts, 0, sizeof(group->counts));
+  if (group->running && nxsched_self()->perf == group)
+    {
+      for (i = 0; i < group->nevents; i++)
+        {
+          group->starts[i] = devperf_now(group, i, hw);
+          if (group->events[i] >= PERF_EVENT_FIRST_HW)
+            {
+              hw++;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devperf_open
+ ****************************************************************************/
+
+static int devperf_open(FAR struct file *filep)
+{
+  FAR struct perf_group_s *group;
+
+  group = kmm_zalloc(sizeof(struct perf_group_s));
+  if (group == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = group;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devperf_close
+ ****************************************************************************/
+
+static int devperf_close(FAR struct file *filep)
+{
+  FAR struct perf_group_s *group = filep->f_priv;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (group->attached)
+    {
+      /* The thread may have exited and its pid been reused */
+
+      tcb = nxsched_get_tcb(group->pid);
+      if (tcb != NULL && tcb->perf == group)
+        {
+          if (group->running && tcb == nxsched_self())
+            {
+              devperf_stop(group);
+            }
+
+          tcb->perf = NULL;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  kmm_free(group);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: devperf_read
+ *
+ * Description:
+ *   Return the counts of the group.  The counts of the caller include the
+ *   events up to now; those of a thread running on another CPU only
+ *   include the events up to its last context switch.
+ *
+ ****************************************************************************/
+
+static ssize_t devperf_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct perf_group_s *group = filep->f_priv;
+  FAR struct perf_values_s *values = (FAR struct perf_values_s *)buffer;
+  irqstate_t flags;
+  int hw = 0;
+  int i;
+
+  if (buflen < sizeof(struct perf_values_s))
+    {
+      return -EINVAL;
+    }
+
+  memset(values, 0, sizeof(struct perf_values_s));
+
+  flags = enter_critical_section();
+
+  if (!group->attached)
+    {
+      leave_critical_section(flags);
+      return -EINVAL;
+    }
+
+  values->nevents = group->nevents;
+  for (i = 0; i < group->nevents; i++)
+    {
+      values->values[i] = group->counts[i];
+      if (group->running && nxsched_self()->perf == group)
+        {
+          values->values[i] += devperf_delta(group, i, hw);
+        }
+
+      if (group->events[i] >= PERF_EVENT_FIRST_HW)
+        {
+          hw++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return sizeof(struct perf_values_s);
+}
+
+/****************************************************************************
+ * Name: devperf_ioctl
+ ****************************************************************************/
+
+static int devperf_ioctl(FAR struct file *filep, int cmd,
+                         unsigned long arg)
+{
+  FAR struct perf_group_s *group = filep->f_priv;
+  FAR const struct perf_attr_s *attr;
+
+  switch (cmd)
+    {
+      case PERFIOC_ATTACH:
+        attr = (FAR const struct perf_attr_s *)(uintptr_t)arg;
+        return devperf_attach(group, attr);
+
+      case PERFIOC_ENABLE:
+        return devperf_enable(group, true);
+
+      case PERFIOC_DISABLE:
+        return devperf_enable(group, false);
+
+      case PERFIOC_RESET:
+        return devperf_reset(group);
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devperf_switch
+ *
+ * Description:
+ *   Account the counters of the thread being suspended and start those of
+ *   the thread being resumed.
+ *
+ * Input Parameters:
+ *   from - The TCB of the thread being suspended.
+ *   to   - The TCB of the thread being resumed.
+ *
+ * Assumptions:
+ *   Called by the scheduler, on the CPU doing the switch, with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+void devperf_switch(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+  if (from->perf != NULL && from->perf->running)
+    {
+      devperf_stop(from->perf);
+    }
+
+  if (to->perf != NULL && to->perf->enabled)
+    {
+      devperf_start(to->perf);
+    }
+}
+
+/****************************************************************************
+ * Name: devperf_register
+ *
+ * Description:
+ *   Register the /dev/perf driver.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int devperf_register(void)
+{
+  return register_driver("/dev/perf", &g_devperf_fops, 0666, NULL);
+}
@@ -337,7 +337,8 @@ static int rd_geometry(FAR struct inode *inode,
  * Name: rd_ioctl
  *
  * Description:
- *   Return device geometry
+ *   Return the base address of the RAM disk for execute/access in place,
+ *   or zero a range of sectors that is no longer in use.
  *
  ****************************************************************************/
 
@@ -345,19 +346,45 @@ static int rd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 {
   FAR struct rd_struct_s *dev;
   FAR void **ppv = (FAR void **)((uintptr_t)arg);
+  FAR blkcnt_t *range = (FAR blkcnt_t *)((uintptr_t)arg);
 
   finfo("Entry\n");
 
-  /* Only one ioctl command is supported */
-
   DEBUGASSERT(inode->i_private);
-  if (cmd == BIOC_XIPBASE && ppv)
-    {
-      dev  = inode->i_private;
-      *ppv = (FAR void *)dev->rd_buffer;
+  dev = inode->i_private;
 
-      finfo("ppv: %p\n", *ppv);
-      return OK;
+  switch (cmd)
+    {
+      case BIOC_XIPBASE:
+        if (ppv == NULL)
+          {
+            return -EINVAL;
+          }
+
+        *ppv = (FAR void *)dev->rd_buffer;
+
+        finfo("ppv: %p\n", *ppv);
+        return OK;
+
+      /* The memory has no erased state, a trimmed range reads as zeros so
+       * that the two commands are the same here.
+       */
+
+      case BIOC_TRIM:
+      case BIOC_ZEROOUT:
+        if (!RDFLAG_IS_WRENABLED(dev->rd_flags))
+          {
+            return -EACCES;
+          }
+        else if (range == NULL || range[0] >= dev->rd_nsectors ||
+                 range[1] > dev->rd_nsectors - range[0])
+          {
+            return -EINVAL;
+          }
+
+        memset(&dev->rd_buffer[range[0] * dev->rd_sectsize], 0,
+               range[1] * dev->rd_sectsize);
+        return OK;
     }
 
   return -ENOTTY;
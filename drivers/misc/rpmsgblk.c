@@ -34,6 +34,8 @@
 #include <limits.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -145,6 +147,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_WRITE]    = rpmsgblk_default_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+#ifdef CONFIG_BLK_RPMSG_BULK
+  [RPMSGBLK_READ_BULK]  = rpmsgblk_default_handler,
+  [RPMSGBLK_WRITE_BULK] = rpmsgblk_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -288,6 +294,35 @@ static ssize_t rpmsgblk_read(FAR struct inode *inode,
       return ret;
     }
 
+#ifdef CONFIG_BLK_RPMSG_BULK
+  if (nsectors * priv->geo.geo_sectorsize >=
+      CONFIG_BLK_RPMSG_BULK_THRESHOLD)
+    {
+      size_t nbytes = nsectors * priv->geo.geo_sectorsize;
+      struct rpmsgblk_bulk_s bulk;
+
+      /* The server reads straight into buffer: drop our view of it, and
+       * pick up whatever the server wrote once it is done.
+       */
+
+      bulk.startsector = start_sector;
+      bulk.nsectors    = nsectors;
+      bulk.sectorsize  = priv->geo.geo_sectorsize;
+      bulk.addr        = up_addrenv_va_to_pa(buffer);
+
+      up_flush_dcache((uintptr_t)buffer, (uintptr_t)buffer + nbytes);
+      ret = rpmsgblk_send_recv(priv, RPMSGBLK_READ_BULK, true,
+                               &bulk.header, sizeof(bulk), NULL);
+      if (ret > 0)
+        {
+          up_invalidate_dcache((uintptr_t)buffer, (uintptr_t)buffer +
+                               ret * priv->geo.geo_sectorsize);
+        }
+
+      return ret;
+    }
+#endif
+
   /* In block read, iov_len represent the received block number */
 
   iov.iov_base = buffer;
@@ -351,6 +386,26 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
       return ret;
     }
 
+#ifdef CONFIG_BLK_RPMSG_BULK
+  if (nsectors * priv->geo.geo_sectorsize >=
+      CONFIG_BLK_RPMSG_BULK_THRESHOLD)
+    {
+      struct rpmsgblk_bulk_s bulk;
+
+      /* The server writes straight from buffer, make it visible first */
+
+      bulk.startsector = start_sector;
+      bulk.nsectors    = nsectors;
+      bulk.sectorsize  = priv->geo.geo_sectorsize;
+      bulk.addr        = up_addrenv_va_to_pa((FAR void *)buffer);
+
+      up_clean_dcache((uintptr_t)buffer, (uintptr_t)buffer +
+                      nsectors * priv->geo.geo_sectorsize);
+      return rpmsgblk_send_recv(priv, RPMSGBLK_WRITE_BULK, true,
+                                &bulk.header, sizeof(bulk), NULL);
+    }
+#endif
+
   /* Perform the rpmsg write */
 
   memset(&cookie, 0, sizeof(cookie));
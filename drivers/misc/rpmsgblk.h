@@ -45,6 +45,8 @@
 #define RPMSGBLK_WRITE           4
 #define RPMSGBLK_GEOMETRY        5
 #define RPMSGBLK_IOCTL           6
+#define RPMSGBLK_READ_BULK       7
+#define RPMSGBLK_WRITE_BULK      8
 
 /****************************************************************************
  * Public Types
@@ -87,6 +89,19 @@ begin_packed_struct struct rpmsgblk_geometry_s
   char                     model[RPMSGBLK_NAME_MAX + 1];
 } end_packed_struct;
 
+/* Large reads and writes transfer the sectors in place through shared
+ * memory: addr is the physical address of the client's buffer.
+ */
+
+begin_packed_struct struct rpmsgblk_bulk_s
+{
+  struct rpmsgblk_header_s header;
+  uint32_t                 startsector;
+  uint32_t                 nsectors;
+  int32_t                  sectorsize;
+  uint64_t                 addr;
+} end_packed_struct;
+
 begin_packed_struct struct rpmsgblk_ioctl_s
 {
   struct rpmsgblk_header_s header;
@@ -28,6 +28,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mmcsd.h>
 #include <nuttx/fs/fs.h>
@@ -75,6 +77,11 @@ static int rpmsgblk_geometry_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgblk_ioctl_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
+#ifdef CONFIG_BLK_RPMSG_BULK
+static int rpmsgblk_bulk_handler(FAR struct rpmsg_endpoint *ept,
+                                 FAR void *data, size_t len,
+                                 uint32_t src, FAR void *priv);
+#endif
 
 /* Functions for creating communication with client cpu */
 
@@ -100,6 +107,10 @@ static const rpmsg_ept_cb g_rpmsgblk_handler[] =
   [RPMSGBLK_WRITE]    = rpmsgblk_write_handler,
   [RPMSGBLK_GEOMETRY] = rpmsgblk_geometry_handler,
   [RPMSGBLK_IOCTL]    = rpmsgblk_ioctl_handler,
+#ifdef CONFIG_BLK_RPMSG_BULK
+  [RPMSGBLK_READ_BULK]  = rpmsgblk_bulk_handler,
+  [RPMSGBLK_WRITE_BULK] = rpmsgblk_bulk_handler,
+#endif
 };
 
 /****************************************************************************
@@ -285,6 +296,63 @@ static int rpmsgblk_write_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+/****************************************************************************
+ * Name: rpmsgblk_bulk_handler
+ *
+ * Description:
+ *   Read or write the sectors in place in the client's buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BLK_RPMSG_BULK
+static int rpmsgblk_bulk_handler(FAR struct rpmsg_endpoint *ept,
+                                 FAR void *data, size_t len,
+                                 uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgblk_server_s *server = ept->priv;
+  FAR struct rpmsgblk_bulk_s *msg = data;
+  FAR unsigned char *buf = up_addrenv_pa_to_va(msg->addr);
+  uintptr_t end = (uintptr_t)buf + msg->nsectors * msg->sectorsize;
+  ssize_t ret;
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  if (server->blknode->i_peer == NULL)
+    {
+      msg->header.result = -ENODEV;
+      return rpmsg_send(ept, msg, sizeof(*msg));
+    }
+#endif
+
+  if (msg->header.command == RPMSGBLK_READ_BULK)
+    {
+      ret = server->bops->read(server->blknode, buf, msg->startsector,
+                               msg->nsectors);
+
+      /* Push the sectors out to the client */
+
+      up_clean_dcache((uintptr_t)buf, end);
+    }
+  else
+    {
+      /* Don't look at stale lines of the client's buffer */
+
+      up_invalidate_dcache((uintptr_t)buf, end);
+      ret = server->bops->write(server->blknode, buf, msg->startsector,
+                                msg->nsectors);
+    }
+
+  if (ret <= 0)
+    {
+      ferr("bulk %s failed, ret=%zd\n",
+           msg->header.command == RPMSGBLK_READ_BULK ? "read" : "write",
+           ret);
+    }
+
+  msg->header.result = ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 /****************************************************************************
  * Name: rpmsgblk_ioctl_handler
  ****************************************************************************/
@@ -93,12 +93,18 @@ struct mmcsd_state_s
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
+#ifdef CONFIG_MMCSD_CMDQ
+  uint8_t cmdqen:1;                /* true: CMDQ mode enabled in the card */
+#endif
 
   uint8_t mode:4;                  /* (See MMCSDMODE_* definitions) */
   uint8_t type:4;                  /* Card type (See MMCSD_CARDTYPE_* definitions) */
   uint8_t buswidth:4;              /* Bus widths supported (SD only) */
   uint8_t cmd23support:1;          /* CMD23 supported (SD only) */
   sdio_capset_t caps;              /* SDIO driver capabilities/limitations */
+#ifdef CONFIG_MMCSD_CMDQ
+  uint8_t cmdqdepth;               /* Command queue depth, 0: not supported */
+#endif
   uint32_t cid[4];                 /* CID register */
   uint32_t csd[4];                 /* CSD register */
   uint16_t selblocklen;            /* The currently selected block length */
@@ -32,6 +32,7 @@
 
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/param.h>
 
 #include <inttypes.h>
 #include <stdint.h>
@@ -104,6 +105,14 @@
 #  define MMCSD_MULTIBLOCK_LIMIT CONFIG_MMCSD_MULTIBLOCK_LIMIT
 #endif
 
+/* eMMC command queue task arguments */
+
+#define MMCSD_CMDQ_READ         (1 << 30)  /* CMD44: Read task */
+#define MMCSD_CMDQ_TASKID(id)   ((uint32_t)(id) << 16)
+#define MMCSD_CMDQ_MAXBLOCKS    0xffff     /* CMD44: Max blocks of a task */
+#define MMCSD_CMDQ_SQS          (1 << 15)  /* CMD13: Send queue status */
+#define MMCSD_CMDQ_DISCARD      1          /* CMD48: Discard the queue */
+
 #define MMCSD_CAPACITY(b, s)    ((s) >= 10 ? (b) << ((s) - 10) : (b) >> (10 - (s)))
 
 #ifdef CONFIG_BOARD_COREDUMP_BLKDEV
@@ -193,6 +202,13 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
                                    off_t startblock,
                                    size_t nblocks);
 #endif
+#ifdef CONFIG_MMCSD_CMDQ
+static int     mmcsd_cmdq_enable(FAR struct mmcsd_state_s *priv,
+                                 bool enable);
+static ssize_t mmcsd_cmdq_transfer(FAR struct mmcsd_part_s *part,
+                                   FAR uint8_t *buffer, off_t startblock,
+                                   size_t nblocks, bool write);
+#endif
 
 /* Block driver methods *****************************************************/
 
@@ -2292,6 +2308,365 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_part_s *part,
 }
 #endif
 
+#ifdef CONFIG_MMCSD_CMDQ
+/****************************************************************************
+ * Name: mmcsd_cmdq_enable
+ *
+ * Description:
+ *   Enable or disable the eMMC command queue.  The legacy block transfer
+ *   commands are illegal while the command queue is enabled.
+ *
+ ****************************************************************************/
+
+static int mmcsd_cmdq_enable(FAR struct mmcsd_state_s *priv, bool enable)
+{
+  int ret;
+
+  if (priv->cmdqen == enable)
+    {
+      return OK;
+    }
+
+  ret = mmcsd_switch(priv, MMC_CMD6_MODE(MMC_CMD6_MODE_WRITE_BYTE) |
+                           MMC_CMD6_INDEX(MMCSD_EXTCSD_CMDQ_MODE_EN) |
+                           MMC_CMD6_VALUE(enable));
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_switch failed: %d\n", ret);
+      return ret;
+    }
+
+  priv->cmdqen = enable;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmcsd_cmdq_queue
+ *
+ * Description:
+ *   Queue one task with CMD44 (QUEUED_TASK_PARAMS) and CMD45
+ *   (QUEUED_TASK_ADDRESS).  Neither command uses the data lines, so tasks
+ *   may be queued while the card is still busy with an earlier one.
+ *
+ ****************************************************************************/
+
+static int mmcsd_cmdq_queue(FAR struct mmcsd_state_s *priv, int id,
+                            off_t startblock, size_t nblocks, bool write)
+{
+  off_t offset;
+  int ret;
+
+  if (IS_BLOCK(priv->type))
+    {
+      offset = startblock;
+    }
+  else
+    {
+      offset = startblock << priv->blockshift;
+    }
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD44, (write ? 0 : MMCSD_CMDQ_READ) |
+                                     MMCSD_CMDQ_TASKID(id) | nblocks);
+  ret = mmcsd_recv_r1(priv, MMC_CMD44);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recv_r1 for CMD44 failed: %d\n", ret);
+      return ret;
+    }
+
+  mmcsd_sendcmdpoll(priv, MMC_CMD45, offset);
+  ret = mmcsd_recv_r1(priv, MMC_CMD45);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recv_r1 for CMD45 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mmcsd_cmdq_execute
+ *
+ * Description:
+ *   Transfer the data of one ready task with CMD46 (EXECUTE_READ_TASK) or
+ *   CMD47 (EXECUTE_WRITE_TASK).
+ *
+ ****************************************************************************/
+
+static int mmcsd_cmdq_execute(FAR struct mmcsd_state_s *priv, int id,
+                              FAR uint8_t *buffer, size_t nblocks,
+                              bool write)
+{
+  size_t nbytes = nblocks << priv->blockshift;
+  uint32_t cmd = write ? MMC_CMD47 : MMC_CMD46;
+  bool cmdfirst = write && (priv->caps & SDIO_CAPS_DMABEFOREWRITE) == 0;
+  int ret;
+
+  /* The card may still be programming the previous write task */
+
+  ret = mmcsd_transferready(priv);
+  if (ret != OK)
+    {
+      ferr("ERROR: Card not ready: %d\n", ret);
+      return ret;
+    }
+
+  if (cmdfirst)
+    {
+      mmcsd_sendcmdpoll(priv, cmd, MMCSD_CMDQ_TASKID(id));
+      ret = mmcsd_recv_r1(priv, cmd);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_recv_r1 for CMD%d failed: %d\n",
+               write ? 47 : 46, ret);
+          return ret;
+        }
+    }
+
+  /* Configure SDIO controller hardware for the transfer */
+
+  SDIO_BLOCKSETUP(priv->dev, priv->blocksize, nblocks);
+  SDIO_WAITENABLE(priv->dev,
+                  SDIOWAIT_TRANSFERDONE | SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR,
+                  nblocks * (write ? MMCSD_BLOCK_WDATADELAY :
+                                     MMCSD_BLOCK_RDATADELAY));
+
+#ifdef CONFIG_SDIO_DMA
+  if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
+    {
+      if (write)
+        {
+          ret = SDIO_DMASENDSETUP(priv->dev, buffer, nbytes);
+        }
+      else
+        {
+          ret = SDIO_DMARECVSETUP(priv->dev, buffer, nbytes);
+        }
+
+      if (ret != OK)
+        {
+          ferr("ERROR: SDIO DMA setup failed: %d\n", ret);
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+  else
+#endif
+  if (write)
+    {
+      SDIO_SENDSETUP(priv->dev, buffer, nbytes);
+    }
+  else
+    {
+      SDIO_RECVSETUP(priv->dev, buffer, nbytes);
+    }
+
+  if (!cmdfirst)
+    {
+      mmcsd_sendcmdpoll(priv, cmd, MMCSD_CMDQ_TASKID(id));
+      ret = mmcsd_recv_r1(priv, cmd);
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_recv_r1 for CMD%d failed: %d\n",
+               write ? 47 : 46, ret);
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+
+  /* Wait for the transfer to complete */
+
+  ret = mmcsd_eventwait(priv, SDIOWAIT_TIMEOUT | SDIOWAIT_ERROR);
+  if (ret != OK)
+    {
+      ferr("ERROR: CMD%d transfer failed: %d\n", write ? 47 : 46, ret);
+      return ret;
+    }
+
+  if (write)
+    {
+      priv->wrbusy = true;
+
+#if defined(CONFIG_MMCSD_SDIOWAIT_WRCOMPLETE)
+      /* Arm the write complete detection with timeout */
+
+      SDIO_WAITENABLE(priv->dev, SDIOWAIT_WRCOMPLETE | SDIOWAIT_TIMEOUT,
+                      nblocks * MMCSD_BLOCK_WDATADELAY);
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mmcsd_cmdq_transfer
+ *
+ * Description:
+ *   Read or write the user data area through the eMMC command queue.  The
+ *   transfer is split into tasks which are all queued up front, as far as
+ *   the queue depth allows.  The card prepares the queued tasks in the
+ *   background and reports the ready ones in its queue status register,
+ *   and the data lines only carry the transfers of ready tasks.  Freed
+ *   task IDs are refilled with the rest of the transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_cmdq_transfer(FAR struct mmcsd_part_s *part,
+                                   FAR uint8_t *buffer, off_t startblock,
+                                   size_t nblocks, bool write)
+{
+  FAR struct mmcsd_state_s *priv = part->priv;
+  FAR uint8_t *taskbuf[CONFIG_MMCSD_CMDQ_DEPTH];
+  size_t tasklen[CONFIG_MMCSD_CMDQ_DEPTH];
+  size_t remain = nblocks;
+  uint32_t pending = 0;
+  uint32_t ready;
+  uint32_t qsr;
+  clock_t starttime;
+  size_t n;
+  int ret;
+  int id;
+
+  finfo("startblock=%jd nblocks=%zu write=%d\n",
+        (intmax_t)startblock, nblocks, write);
+
+  if (write ? mmcsd_wrprotected(priv) : priv->locked)
+    {
+      ferr("ERROR: Card is locked or write protected\n");
+      return -EPERM;
+    }
+
+  /* The command queue only works on the user data area */
+
+  if (priv->partnum != MMCSD_PART_UDATA)
+    {
+      ret = mmcsd_switch(priv, MMC_CMD6_MODE(MMC_CMD6_MODE_WRITE_BYTE) |
+                               MMC_CMD6_INDEX(EXT_CSD_PART_CONF) |
+                               MMC_CMD6_VALUE(MMCSD_PART_UDATA));
+      if (ret != OK)
+        {
+          ferr("ERROR: mmcsd_switch failed: %d\n", ret);
+          return ret;
+        }
+
+      priv->partnum = MMCSD_PART_UDATA;
+    }
+
+#if defined(CONFIG_SDIO_DMA) && defined(CONFIG_ARCH_HAVE_SDIO_PREFLIGHT)
+  if ((priv->caps & SDIO_CAPS_DMASUPPORTED) != 0)
+    {
+      ret = SDIO_DMAPREFLIGHT(priv->dev, buffer,
+                              nblocks << priv->blockshift);
+      if (ret != OK)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  ret = mmcsd_cmdq_enable(priv, true);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  starttime = clock_systime_ticks();
+  while (remain > 0 || pending != 0)
+    {
+      /* Queue the rest of the transfer in the free task IDs */
+
+      for (id = 0; remain > 0 && id < priv->cmdqdepth; id++)
+        {
+          if ((pending & (1 << id)) != 0)
+            {
+              continue;
+            }
+
+          n = MIN(remain, MMCSD_CMDQ_MAXBLOCKS);
+          n = MIN(n, MMCSD_MULTIBLOCK_LIMIT);
+          ret = mmcsd_cmdq_queue(priv, id, startblock, n, write);
+          if (ret != OK)
+            {
+              goto errout;
+            }
+
+          taskbuf[id] = buffer;
+          tasklen[id] = n;
+          pending    |= 1 << id;
+          buffer     += n << priv->blockshift;
+          startblock += n;
+          remain     -= n;
+        }
+
+      /* Send CMD13 with SQS set to read the queue status register */
+
+      mmcsd_sendcmdpoll(priv, MMCSD_CMD13,
+                        (uint32_t)priv->rca << 16 | MMCSD_CMDQ_SQS);
+      ret = SDIO_RECVR1(priv->dev, MMCSD_CMD13, &qsr);
+      if (ret != OK)
+        {
+          ferr("ERROR: SDIO_RECVR1 for CMD13 failed: %d\n", ret);
+          goto errout;
+        }
+
+      ready = qsr & pending;
+      if (ready == 0)
+        {
+          if (clock_systime_ticks() - starttime >= TICK_PER_SEC)
+            {
+              ret = -ETIMEDOUT;
+              goto errout;
+            }
+
+#ifdef CONFIG_MMCSD_CHECK_READY_STATUS_WITHOUT_SLEEP
+          sched_yield();
+#else
+          MMCSD_USLEEP(1000);
+#endif
+          continue;
+        }
+
+      /* Execute every ready task */
+
+      for (id = 0; ready != 0; id++)
+        {
+          if ((ready & (1 << id)) != 0)
+            {
+              ret = mmcsd_cmdq_execute(priv, id, taskbuf[id], tasklen[id],
+                                       write);
+              if (ret != OK)
+                {
+                  goto errout;
+                }
+
+              pending &= ~(1 << id);
+              ready   &= ~(1 << id);
+            }
+        }
+
+      starttime = clock_systime_ticks();
+    }
+
+  return nblocks;
+
+errout:
+  if (pending != 0)
+    {
+      /* Send CMD48, CMDQ_TASK_MGMT, to discard the tasks left queued */
+
+      mmcsd_sendcmdpoll(priv, MMC_CMD48, MMCSD_CMDQ_DISCARD);
+      if (mmcsd_recv_r1(priv, MMC_CMD48) != OK)
+        {
+          ferr("ERROR: Failed to discard the command queue\n");
+        }
+
+      priv->wrbusy = true;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: mmcsd_open
  *
@@ -2391,6 +2766,23 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
           return ret;
         }
 
+#ifdef CONFIG_MMCSD_CMDQ
+      if (priv->cmdqdepth > 0 && part == &priv->part[MMCSD_PART_UDATA])
+        {
+          ret = mmcsd_cmdq_transfer(part, buffer, startsector, nsectors,
+                                    false);
+          mmcsd_unlock(priv);
+          return ret;
+        }
+
+      ret = mmcsd_cmdq_enable(priv, false);
+      if (ret != OK)
+        {
+          mmcsd_unlock(priv);
+          return ret;
+        }
+#endif
+
       ret = nsectors;
       endsector = startsector + nsectors;
       for (sector = startsector; sector < endsector; sector += nread)
@@ -2472,6 +2864,23 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
           return ret;
         }
 
+#ifdef CONFIG_MMCSD_CMDQ
+      if (priv->cmdqdepth > 0 && part == &priv->part[MMCSD_PART_UDATA])
+        {
+          ret = mmcsd_cmdq_transfer(part, (FAR uint8_t *)buffer,
+                                    startsector, nsectors, true);
+          mmcsd_unlock(priv);
+          return ret;
+        }
+
+      ret = mmcsd_cmdq_enable(priv, false);
+      if (ret != OK)
+        {
+          mmcsd_unlock(priv);
+          return ret;
+        }
+#endif
+
       ret = nsectors;
       endsector = startsector + nsectors;
       for (sector = startsector; sector < endsector; sector += nwrite)
@@ -2647,6 +3056,14 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     case MMC_IOC_CMD: /* MMCSD device ioctl commands */
       {
         finfo("MMC_IOC_CMD\n");
+#ifdef CONFIG_MMCSD_CMDQ
+        ret = mmcsd_cmdq_enable(priv, false);
+        if (ret != OK)
+          {
+            break;
+          }
+#endif
+
         ret = mmcsd_iocmd(part, (FAR struct mmc_ioc_cmd *)arg);
         if (ret != OK)
           {
@@ -2658,6 +3075,14 @@ static int mmcsd_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     case MMC_IOC_MULTI_CMD: /* MMCSD device ioctl multi commands */
       {
         finfo("MMC_IOC_MULTI_CMD\n");
+#ifdef CONFIG_MMCSD_CMDQ
+        ret = mmcsd_cmdq_enable(priv, false);
+        if (ret != OK)
+          {
+            break;
+          }
+#endif
+
         ret = mmcsd_multi_iocmd(part, (FAR struct mmc_ioc_multi_cmd *)arg);
         if (ret != OK)
           {
@@ -2983,6 +3408,21 @@ static void mmcsd_decode_extcsd(FAR struct mmcsd_state_s *priv,
                 hc_erase_grp_sz * hc_wp_grp_sz * MCSD_SZ_512K / MCSD_SZ_512;
         }
     }
+
+#ifdef CONFIG_MMCSD_CMDQ
+  /* The card resets CMDQ_MODE_EN, the queue is enabled on the first user
+   * data area transfer.
+   */
+
+  priv->cmdqen    = false;
+  priv->cmdqdepth = 0;
+  if ((extcsd[MMCSD_EXTCSD_CMDQ_SUPPORT] & 1) != 0)
+    {
+      priv->cmdqdepth = MIN((extcsd[MMCSD_EXTCSD_CMDQ_DEPTH] & 0x1f) + 1,
+                            CONFIG_MMCSD_CMDQ_DEPTH);
+      finfo("MMC command queue depth %d\n", priv->cmdqdepth);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -4445,6 +4885,10 @@ static int mmcsd_removed(FAR struct mmcsd_state_s *priv)
   priv->type         = MMCSD_CARDTYPE_UNKNOWN;
   priv->rca          = 0;
   priv->selblocklen  = 0;
+#ifdef CONFIG_MMCSD_CMDQ
+  priv->cmdqen       = false;
+  priv->cmdqdepth    = 0;
+#endif
 
   /* Go back to the default 1-bit data bus. */
 
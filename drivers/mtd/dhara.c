@@ -29,9 +29,12 @@
 #include <errno.h>
 #include <debug.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <nuttx/nuttx.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/lib/lib.h>
 
@@ -55,6 +58,14 @@ struct dhara_pagecache_s
 
 typedef struct dhara_pagecache_s dhara_pagecache_t;
 
+struct dhara_mapcache_s
+{
+  dhara_sector_t sector;
+  dhara_page_t   page;
+};
+
+typedef struct dhara_mapcache_s dhara_mapcache_t;
+
 struct dhara_dev_s
 {
   struct dhara_nand     nand;
@@ -77,6 +88,16 @@ struct dhara_dev_s
 
   struct dq_queue_s readcache;
   dhara_pagecache_t readpage[CONFIG_DHARA_READ_NCACHES];
+
+#if CONFIG_DHARA_MAP_NCACHES > 0
+  /* Direct mapped cache of the sector to page map */
+
+  dhara_mapcache_t mapcache[CONFIG_DHARA_MAP_NCACHES];
+#endif
+
+#ifdef CONFIG_DHARA_IDLE_GC
+  struct work_s gcwork;           /* Idle time checkpoint and collection */
+#endif
 };
 
 typedef struct dhara_dev_s dhara_dev_t;
@@ -288,6 +309,163 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+#if CONFIG_DHARA_MAP_NCACHES > 0
+static void dhara_init_mapcache(FAR dhara_dev_t *dev)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_DHARA_MAP_NCACHES; i++)
+    {
+      dev->mapcache[i].sector = DHARA_SECTOR_NONE;
+    }
+}
+
+static void dhara_discard_mapcache(FAR dhara_dev_t *dev,
+                                   dhara_sector_t sector)
+{
+  FAR dhara_mapcache_t *entry;
+
+  entry = &dev->mapcache[sector % CONFIG_DHARA_MAP_NCACHES];
+  if (entry->sector == sector)
+    {
+      entry->sector = DHARA_SECTOR_NONE;
+    }
+}
+
+/* Garbage collection and journal recovery move live pages: follow them */
+
+static void dhara_move_mapcache(FAR dhara_dev_t *dev,
+                                dhara_page_t src, dhara_page_t dst)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_DHARA_MAP_NCACHES; i++)
+    {
+      if (dev->mapcache[i].sector != DHARA_SECTOR_NONE &&
+          dev->mapcache[i].page == src)
+        {
+          dev->mapcache[i].page = dst;
+        }
+    }
+}
+
+static void dhara_erase_mapcache(FAR dhara_dev_t *dev, dhara_block_t bno)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_DHARA_MAP_NCACHES; i++)
+    {
+      if (dev->mapcache[i].sector != DHARA_SECTOR_NONE &&
+          dev->mapcache[i].page != DHARA_PAGE_NONE &&
+          (dev->mapcache[i].page >> dev->nand.log2_ppb) == bno)
+        {
+          dev->mapcache[i].sector = DHARA_SECTOR_NONE;
+        }
+    }
+}
+#else
+#  define dhara_init_mapcache(dev)
+#  define dhara_discard_mapcache(dev, sector)
+#  define dhara_move_mapcache(dev, src, dst)
+#  define dhara_erase_mapcache(dev, bno)
+#endif
+
+/* Look up the page holding a sector, DHARA_PAGE_NONE if it is unmapped */
+
+static int dhara_find_page(FAR dhara_dev_t *dev, dhara_sector_t sector,
+                           FAR dhara_page_t *page, FAR dhara_error_t *err)
+{
+#if CONFIG_DHARA_MAP_NCACHES > 0
+  FAR dhara_mapcache_t *entry;
+
+  entry = &dev->mapcache[sector % CONFIG_DHARA_MAP_NCACHES];
+  if (entry->sector == sector)
+    {
+      *page = entry->page;
+      return 0;
+    }
+#endif
+
+  if (dhara_map_find(&dev->map, sector, page, err) < 0)
+    {
+      if (*err != DHARA_E_NOT_FOUND)
+        {
+          return -1;
+        }
+
+      *page = DHARA_PAGE_NONE;
+    }
+
+#if CONFIG_DHARA_MAP_NCACHES > 0
+  entry->sector = sector;
+  entry->page = *page;
+#endif
+
+  return 0;
+}
+
+#ifdef CONFIG_DHARA_IDLE_GC
+static void dhara_idle_gc(FAR void *arg)
+{
+  FAR dhara_dev_t *dev = arg;
+  dhara_page_t size;
+  dhara_error_t err;
+  int steps;
+
+  nxmutex_lock(&dev->lock);
+
+  if (dhara_map_sync(&dev->map, &err) < 0)
+    {
+      ferr("Idle sync failed: %s\n", dhara_strerror(err));
+      dhara_init_mapcache(dev);
+      goto out;
+    }
+
+  /* Collect until writes have DHARA_IDLE_GC_RESERVE pages to go before
+   * they start collecting themselves.
+   */
+
+  size = dhara_journal_size(&dev->map.journal);
+  for (steps = 0; steps < CONFIG_DHARA_IDLE_GC_STEPS &&
+       dhara_journal_size(&dev->map.journal) +
+       CONFIG_DHARA_IDLE_GC_RESERVE > dhara_map_capacity(&dev->map);
+       steps++)
+    {
+      if (dhara_map_gc(&dev->map, &err) < 0)
+        {
+          ferr("Idle gc failed: %s\n", dhara_strerror(err));
+          dhara_init_mapcache(dev);
+          goto out;
+        }
+    }
+
+  /* Come back later if there is more to do and this round made progress,
+   * i.e. did not just move live pages around.
+   */
+
+  if (steps == CONFIG_DHARA_IDLE_GC_STEPS &&
+      dhara_journal_size(&dev->map.journal) < size)
+    {
+      work_queue(LPWORK, &dev->gcwork, dhara_idle_gc, dev,
+                 MSEC2TICK(CONFIG_DHARA_IDLE_GC_DELAY));
+    }
+
+out:
+  nxmutex_unlock(&dev->lock);
+}
+#endif
+
+static void dhara_free(FAR dhara_dev_t *dev)
+{
+#ifdef CONFIG_DHARA_IDLE_GC
+  work_cancel_sync(LPWORK, &dev->gcwork);
+#endif
+  nxmutex_destroy(&dev->lock);
+  dhara_deinit_readcache(dev);
+  kmm_free(dev->pagebuf);
+  kmm_free(dev);
+}
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -319,18 +497,25 @@ static int dhara_close(FAR struct inode *inode)
 {
   FAR dhara_dev_t *dev;
 
+  dhara_error_t err;
+
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
   nxmutex_lock(&dev->lock);
   dev->refs--;
+
+  /* Checkpoint the writes still pending */
+
+  if (dev->refs == 0 && dhara_map_sync(&dev->map, &err) < 0)
+    {
+      ferr("Sync on close failed: %s\n", dhara_strerror(err));
+    }
+
   nxmutex_unlock(&dev->lock);
 
   if (dev->refs == 0 && dev->unlinked)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_free(dev);
     }
 
   return 0;
@@ -359,10 +544,22 @@ static ssize_t dhara_read(FAR struct inode *inode,
   while (nsectors-- > 0)
     {
       dhara_error_t err;
-      ret = dhara_map_read(&dev->map,
-                           start_sector,
-                           buffer,
-                           &err);
+      dhara_page_t page;
+
+      ret = dhara_find_page(dev, start_sector, &page, &err);
+      if (ret == 0)
+        {
+          if (page == DHARA_PAGE_NONE)
+            {
+              memset(buffer, 0xff, dev->geo.blocksize);
+            }
+          else
+            {
+              ret = dhara_nand_read(&dev->nand, page, 0,
+                                    dev->geo.blocksize, buffer, &err);
+            }
+        }
+
       if (ret < 0)
         {
           ret = dhara_convert_result(err);
@@ -403,12 +600,16 @@ static ssize_t dhara_write(FAR struct inode *inode,
   while (nsectors-- > 0)
     {
       dhara_error_t err;
+      dhara_discard_mapcache(dev, start_sector);
       ret = dhara_map_write(&dev->map,
                             start_sector,
                             buffer,
                             &err);
       if (ret < 0)
         {
+          /* The map may have moved on partially, forget all of it */
+
+          dhara_init_mapcache(dev);
           ret = dhara_convert_result(err);
           ferr("Write starting at block %lld failed nwrite %zu err %s\n",
                (long long)start_sector, nwrite, dhara_strerror(err));
@@ -420,6 +621,13 @@ static ssize_t dhara_write(FAR struct inode *inode,
       buffer += dev->geo.blocksize;
     }
 
+#ifdef CONFIG_DHARA_IDLE_GC
+  /* (Re)start the idle period */
+
+  work_queue(LPWORK, &dev->gcwork, dhara_idle_gc, dev,
+             MSEC2TICK(CONFIG_DHARA_IDLE_GC_DELAY));
+#endif
+
   nxmutex_unlock(&dev->lock);
   return nwrite ? nwrite : ret;
 }
@@ -472,6 +680,22 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+  if (cmd == BIOC_FLUSH)
+    {
+      dhara_error_t err;
+
+      nxmutex_lock(&dev->lock);
+      ret = dhara_map_sync(&dev->map, &err);
+      if (ret < 0)
+        {
+          dhara_init_mapcache(dev);
+          ret = dhara_convert_result(err);
+        }
+
+      nxmutex_unlock(&dev->lock);
+      return ret;
+    }
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -506,10 +730,7 @@ static int dhara_unlink(FAR struct inode *inode)
 
   if (dev->refs == 0)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_free(dev);
     }
 
   return 0;
@@ -557,6 +778,7 @@ int dhara_nand_erase(FAR const struct dhara_nand *n,
       dhara_discard_readcache(dev, pno + i);
     }
 
+  dhara_erase_mapcache(dev, bno);
   return 0;
 }
 
@@ -662,6 +884,7 @@ int dhara_nand_copy(FAR const struct dhara_nand *n,
       return ret;
     }
 
+  dhara_move_mapcache(dev, src, dst);
   return 0;
 }
 
@@ -744,6 +967,8 @@ int dhara_initialize_by_path(FAR const char *path,
       goto err;
     }
 
+  dhara_init_mapcache(dev);
+
   dhara_map_init(&dev->map, &dev->nand,
                  dev->pagebuf + dev->geo.blocksize,
                  CONFIG_DHARA_GC_RATIO);
@@ -106,6 +106,8 @@ static ssize_t ftl_write(FAR struct inode *inode,
                  unsigned int nsectors);
 static int     ftl_geometry(FAR struct inode *inode,
                  FAR struct geometry *geometry);
+static int     ftl_trim(FAR struct ftl_struct_s *dev, blkcnt_t start,
+                 blkcnt_t nsectors);
 static int     ftl_ioctl(FAR struct inode *inode, int cmd,
                  unsigned long arg);
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
@@ -802,6 +804,54 @@ static int ftl_geometry(FAR struct inode *inode,
   return -EINVAL;
 }
 
+/****************************************************************************
+ * Name: ftl_trim
+ *
+ * Description:
+ *   Erase the erase blocks that lie entirely within a range of sectors
+ *   that is no longer in use.  A partially covered erase block is left
+ *   alone, since erasing it would lose the sectors that are still in use.
+ *
+ ****************************************************************************/
+
+static int ftl_trim(FAR struct ftl_struct_s *dev, blkcnt_t start,
+                    blkcnt_t nsectors)
+{
+  off_t eblock;
+  off_t eend;
+  ssize_t ret;
+
+  if (start + nsectors > (blkcnt_t)dev->geo.neraseblocks * dev->blkper)
+    {
+      return -EINVAL;
+    }
+
+  /* Write out the buffered sectors first, the erase must not be undone by
+   * a later flush of a stale write buffer.
+   */
+
+#ifdef CONFIG_FTL_WRITEBUFFER
+  rwb_flush(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_READAHEAD
+  rwb_discard(&dev->rwb);
+#endif
+
+  eblock = (start + dev->blkper - 1) / dev->blkper;
+  eend   = (start + nsectors) / dev->blkper;
+
+  for (; eblock < eend; eblock++)
+    {
+      ret = ftl_mtd_erase(dev, eblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: ftl_ioctl
  *
@@ -819,6 +869,13 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
   dev = inode->i_private;
 
+  if (cmd == BIOC_TRIM)
+    {
+      FAR blkcnt_t *range = (FAR blkcnt_t *)((uintptr_t)arg);
+
+      return ftl_trim(dev, range[0], range[1]);
+    }
+
   if (cmd == BIOC_DISCARD)
     {
 #ifdef CONFIG_FTL_READAHEAD
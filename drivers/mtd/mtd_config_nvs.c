@@ -40,11 +40,16 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mtd/configdata.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD
+#  define CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD 0
+#endif
+
 /* MASKS AND SHIFT FOR ADDRESSES
  * an address in nvs is an uint32_t where:
  *   high 2 bytes represent the block number
@@ -59,6 +64,8 @@
 
 #define NVS_HASH_INITIAL_VALUE          2166136261
 
+#define NVS_INDEX_INITIAL_SIZE          64
+
 #if CONFIG_MTD_CONFIG_BUFFER_SIZE > 0
 #  define NVS_BUFFER_SIZE(fs)           CONFIG_MTD_CONFIG_BUFFER_SIZE
 #  define NVS_ATE(name, size) \
@@ -75,6 +82,16 @@
  * Private Types
  ****************************************************************************/
 
+/* RAM index entry: the address of the ate of an item */
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+struct nvs_index_s
+{
+  uint32_t              id;            /* Hash id of the item key */
+  uint32_t              addr;          /* Address of the ate */
+};
+#endif
+
 /* Non-volatile Storage File system structure */
 
 struct nvs_fs
@@ -95,6 +112,17 @@ struct nvs_fs
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   uint32_t              cache[CONFIG_MTD_CONFIG_CACHE_SIZE];
 #endif
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  FAR struct nvs_index_s *index;       /* Valid items sorted by id, NULL
+                                        * if the index is not available
+                                        */
+  size_t                nindex;        /* Number of index entries */
+  size_t                index_size;    /* Allocated index entries */
+#endif
+#if CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD > 0
+  struct work_s         gc_work;       /* Background gc */
+  uint32_t              gc_block;      /* Block closed by the last one */
+#endif
 };
 
 /* Allocation Table Entry */
@@ -180,6 +208,147 @@ static void nvs_invalid_cache(struct nvs_fs *fs, uint32_t sector)
 }
 #endif /* CONFIG_MTD_CONFIG_CACHE_SIZE */
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+
+/****************************************************************************
+ * Name: nvs_index_bound
+ *
+ * Description:
+ *   Find the first index entry with an id greater than (upper) or not
+ *   less than (!upper) id.
+ *
+ ****************************************************************************/
+
+static size_t nvs_index_bound(FAR struct nvs_fs *fs, uint32_t id,
+                              bool upper)
+{
+  size_t low = 0;
+  size_t high = fs->nindex;
+  size_t mid;
+
+  while (low < high)
+    {
+      mid = low + (high - low) / 2;
+      if (fs->index[mid].id < id || (upper && fs->index[mid].id == id))
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  return low;
+}
+
+/****************************************************************************
+ * Name: nvs_index_free
+ ****************************************************************************/
+
+static void nvs_index_free(FAR struct nvs_fs *fs)
+{
+  kmm_free(fs->index);
+  fs->index = NULL;
+  fs->nindex = 0;
+  fs->index_size = 0;
+}
+
+/****************************************************************************
+ * Name: nvs_index_add
+ *
+ * Description:
+ *   Add the ate of an item to the index.  If the index cannot grow, it is
+ *   dropped and the items are looked up in flash again.
+ *
+ ****************************************************************************/
+
+static void nvs_index_add(FAR struct nvs_fs *fs, uint32_t id,
+                          uint32_t addr)
+{
+  FAR struct nvs_index_s *index;
+  size_t pos;
+
+  if (fs->index == NULL)
+    {
+      return;
+    }
+
+  if (fs->nindex == fs->index_size)
+    {
+      index = kmm_realloc(fs->index,
+                          2 * fs->index_size * sizeof(*index));
+      if (index == NULL)
+        {
+          ferr("Index allocation failed, nindex=%zu\n", fs->nindex);
+          nvs_index_free(fs);
+          return;
+        }
+
+      fs->index = index;
+      fs->index_size *= 2;
+    }
+
+  /* Entries of the same id keep the order in which they are added */
+
+  pos = nvs_index_bound(fs, id, true);
+  memmove(&fs->index[pos + 1], &fs->index[pos],
+          (fs->nindex - pos) * sizeof(*fs->index));
+  fs->index[pos].id = id;
+  fs->index[pos].addr = addr;
+  fs->nindex++;
+}
+
+/****************************************************************************
+ * Name: nvs_index_remove
+ *
+ * Description:
+ *   Remove the ate at addr from the index.
+ *
+ ****************************************************************************/
+
+static void nvs_index_remove(FAR struct nvs_fs *fs, uint32_t addr)
+{
+  size_t i;
+
+  for (i = 0; i < fs->nindex; i++)
+    {
+      if (fs->index[i].addr == addr)
+        {
+          fs->nindex--;
+          memmove(&fs->index[i], &fs->index[i + 1],
+                  (fs->nindex - i) * sizeof(*fs->index));
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nvs_index_remove_block
+ *
+ * Description:
+ *   Remove the ates of an erased block from the index.
+ *
+ ****************************************************************************/
+
+static void nvs_index_remove_block(FAR struct nvs_fs *fs, uint32_t block)
+{
+  size_t i;
+  size_t j;
+
+  for (i = j = 0; i < fs->nindex; i++)
+    {
+      if ((fs->index[i].addr >> NVS_ADDR_BLOCK_SHIFT) != block)
+        {
+          fs->index[j++] = fs->index[i];
+        }
+    }
+
+  fs->nindex = j;
+}
+
+#endif /* CONFIG_MTD_CONFIG_NVS_INDEX */
+
 /****************************************************************************
  * Name: nvs_fnv_hash_part
  ****************************************************************************/
@@ -447,6 +616,13 @@ static int nvs_flash_ate_wrt(FAR struct nvs_fs *fs,
     }
 #endif
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (entry->id != nvs_special_ate_id(fs))
+    {
+      nvs_index_add(fs, entry->id, fs->ate_wra);
+    }
+#endif
+
   rc = nvs_flash_wrt(fs, fs->ate_wra, entry, ate_size);
   fs->ate_wra -= ate_size;
 
@@ -686,6 +862,12 @@ static int nvs_flash_erase_block(FAR struct nvs_fs *fs, uint32_t addr)
   nvs_invalid_cache(fs, addr >> NVS_ADDR_BLOCK_SHIFT);
 #endif
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  /* The valid ates of the block were moved by gc */
+
+  nvs_index_remove_block(fs, addr >> NVS_ADDR_BLOCK_SHIFT);
+#endif
+
   rc = MTD_ERASE(fs->mtd,
                  CONFIG_MTD_CONFIG_BLOCKSIZE_MULTIPLE *
                  (addr >> NVS_ADDR_BLOCK_SHIFT),
@@ -1063,6 +1245,111 @@ static int nvs_prev_ate(FAR struct nvs_fs *fs, FAR uint32_t *addr,
   return nvs_recover_last_ate(fs, addr);
 }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+
+/****************************************************************************
+ * Name: nvs_index_find
+ *
+ * Description:
+ *   Find the ate of the item with the given key through the index.
+ *
+ * Returned Value:
+ *   0 with the ate and its address if found, -ENOENT if the item does not
+ *   exist or is deleted, or another -ERRNO code on flash errors.
+ *
+ ****************************************************************************/
+
+static int nvs_index_find(FAR struct nvs_fs *fs, uint32_t id,
+                          FAR const uint8_t *key, size_t key_size,
+                          FAR struct nvs_ate *ate, FAR uint32_t *addr)
+{
+  size_t i;
+  int rc;
+
+  for (i = nvs_index_bound(fs, id, false);
+       i < fs->nindex && fs->index[i].id == id; i++)
+    {
+      rc = nvs_flash_ate_rd(fs, fs->index[i].addr, ate);
+      if (rc)
+        {
+          return rc;
+        }
+
+      if (!nvs_ate_valid(fs, ate) || ate->key_len != key_size)
+        {
+          continue;
+        }
+
+      rc = nvs_flash_block_cmp(fs, (fs->index[i].addr &
+                                    NVS_ADDR_BLOCK_MASK) + ate->offset,
+                               key, key_size);
+      if (rc < 0)
+        {
+          return rc;
+        }
+      else if (rc == 0)
+        {
+          *addr = fs->index[i].addr;
+          return 0;
+        }
+
+      fwarn("hash conflict\n");
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nvs_index_build
+ *
+ * Description:
+ *   Walk once through all ates, from newest to oldest, and index the
+ *   valid items.  Without memory for the index the items are looked up
+ *   in flash.
+ *
+ ****************************************************************************/
+
+static int nvs_index_build(FAR struct nvs_fs *fs)
+{
+  NVS_ATE(wlk_ate, nvs_ate_size(fs));
+  uint32_t wlk_addr;
+  uint32_t addr;
+  int rc;
+
+  nvs_index_free(fs);
+  fs->index = kmm_malloc(NVS_INDEX_INITIAL_SIZE * sizeof(*fs->index));
+  if (fs->index == NULL)
+    {
+      return 0;
+    }
+
+  fs->index_size = NVS_INDEX_INITIAL_SIZE;
+
+  wlk_addr = fs->ate_wra;
+  do
+    {
+      addr = wlk_addr;
+      rc = nvs_prev_ate(fs, &wlk_addr, wlk_ate);
+      if (rc)
+        {
+          nvs_index_free(fs);
+          return rc;
+        }
+
+      if (nvs_ate_valid(fs, wlk_ate) && !nvs_ate_expired(fs, wlk_ate) &&
+          wlk_ate->id != nvs_special_ate_id(fs))
+        {
+          nvs_index_add(fs, wlk_ate->id, addr);
+        }
+    }
+  while (wlk_addr != fs->ate_wra && fs->index != NULL);
+
+  finfo("%zu items indexed\n", fs->nindex);
+  return 0;
+}
+
+#endif /* CONFIG_MTD_CONFIG_NVS_INDEX */
+
 /****************************************************************************
  * Name: nvs_block_advance
  ****************************************************************************/
@@ -1146,6 +1433,10 @@ static int nvs_expire_ate(FAR struct nvs_fs *fs, uint32_t addr)
   uint8_t expired[NVS_BUFFER_SIZE(fs)];
   memset(expired, ~fs->erasestate, fs->progsize);
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  nvs_index_remove(fs, addr);
+#endif
+
   return nvs_flash_wrt(fs, addr + nvs_align_up(fs, sizeof(struct nvs_ate)),
                        expired, fs->progsize);
 }
@@ -1310,6 +1601,12 @@ static int nvs_startup(FAR struct nvs_fs *fs)
   fs->events = 0;
   fs->fds = NULL;
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  /* The index is built again once the recovery below is done */
+
+  nvs_index_free(fs);
+#endif
+
   /* Get the device geometry. (Casting to uintptr_t first eliminates
    * complaints on some architectures where the sizeof long is different
    * from the size of a pointer).
@@ -1654,6 +1951,13 @@ end:
       rc = nvs_add_gc_done_ate(fs);
     }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (!rc)
+    {
+      rc = nvs_index_build(fs);
+    }
+#endif
+
   finfo("%" PRIu32 " Eraseblocks of %" PRIu32 " bytes\n",
         fs->nblocks, fs->blocksize);
   finfo("alloc wra: %" PRIu32 ", 0x%" PRIx32 "\n",
@@ -1703,6 +2007,21 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
   int rc;
 
   hash_id = nvs_fnv_hash_id(nvs_fnv_hash(key, key_size));
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (fs->index != NULL)
+    {
+      rc = nvs_index_find(fs, hash_id, key, key_size, wlk_ate, &hist_addr);
+      if (rc)
+        {
+          return rc;
+        }
+
+      rd_addr = hist_addr;
+      goto found;
+    }
+#endif
+
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   wlk_addr = fs->cache[nvs_cache_index(hash_id)];
   if (wlk_addr == NVS_CACHE_NO_ADDR)
@@ -1766,6 +2085,9 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
     }
   while (true);
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+found:
+#endif
   if (data && len)
     {
       rd_addr &= NVS_ADDR_BLOCK_MASK;
@@ -1801,6 +2123,115 @@ static ssize_t nvs_read_entry(FAR struct nvs_fs *fs, FAR const uint8_t *key,
   return wlk_ate->len;
 }
 
+#if CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD > 0
+
+/****************************************************************************
+ * Name: nvs_gc_worker
+ *
+ * Description:
+ *   Close the block being written and gc the oldest one, ahead of the
+ *   write that would otherwise do it.
+ *
+ ****************************************************************************/
+
+static void nvs_gc_worker(FAR void *arg)
+{
+  FAR struct nvs_fs *fs = arg;
+  int rc;
+
+  if (nxmutex_lock(&fs->nvs_lock) < 0)
+    {
+      return;
+    }
+
+  if (fs->ate_wra - fs->data_wra < CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD &&
+      (fs->ate_wra >> NVS_ADDR_BLOCK_SHIFT) != fs->gc_block)
+    {
+      rc = nvs_block_close(fs);
+      if (rc == 0)
+        {
+          fs->gc_block = fs->ate_wra >> NVS_ADDR_BLOCK_SHIFT;
+          rc = nvs_gc(fs);
+        }
+
+      if (rc < 0)
+        {
+          ferr("Background gc failed, rc=%d\n", rc);
+        }
+    }
+
+  nxmutex_unlock(&fs->nvs_lock);
+}
+
+/****************************************************************************
+ * Name: nvs_gc_schedule
+ *
+ * Description:
+ *   Queue the background gc if the block being written is nearly full.
+ *   A block that the background gc started is left to fill up, as the gc
+ *   may have filled it with the moved items already.
+ *
+ ****************************************************************************/
+
+static void nvs_gc_schedule(FAR struct nvs_fs *fs)
+{
+  if (fs->ate_wra - fs->data_wra < CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD &&
+      (fs->ate_wra >> NVS_ADDR_BLOCK_SHIFT) != fs->gc_block &&
+      work_available(&fs->gc_work))
+    {
+      work_queue(LPWORK, &fs->gc_work, nvs_gc_worker, fs, 0);
+    }
+}
+
+#endif /* CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD */
+
+/****************************************************************************
+ * Name: nvs_check_data
+ *
+ * Description:
+ *   Check that an item can be written.
+ *
+ * Input Parameters:
+ *   fs    - Pointer to file system.
+ *   pdata - Pointer to data buffer.
+ *
+ * Returned Value:
+ *   0 if the item can be written, -EINVAL otherwise.
+ *
+ ****************************************************************************/
+
+static int nvs_check_data(FAR struct nvs_fs *fs,
+                          FAR const struct config_data_s *pdata)
+{
+  size_t data_size;
+  size_t key_size;
+
+#ifdef CONFIG_MTD_CONFIG_NAMED
+  key_size = strlen(pdata->name) + 1;
+#else
+  key_size = sizeof(pdata->id) + sizeof(pdata->instance);
+#endif
+
+  /* Data now contains input data and input key, input key first. */
+
+  data_size = nvs_align_up(fs, key_size + pdata->len);
+
+  /* The maximum data size is block size - 3 ate
+   * where: 1 ate for data, 1 ate for block close, 1 ate for gc done.
+   */
+
+  finfo("key_size=%zu, len=%zu, data_size = %zu\n", key_size,
+                                                    pdata->len, data_size);
+
+  if ((data_size > (fs->blocksize - 3 * nvs_ate_size(fs))) ||
+      ((pdata->len > 0) && (pdata->configdata == NULL)))
+    {
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: nvs_write
  *
@@ -1850,29 +2281,38 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
   key_size = sizeof(pdata->id) + sizeof(pdata->instance);
 #endif
 
-  /* Data now contains input data and input key, input key first. */
-
-  data_size = nvs_align_up(fs, key_size + pdata->len);
-
-  /* The maximum data size is block size - 3 ate
-   * where: 1 ate for data, 1 ate for block close, 1 ate for gc done.
-   */
-
-  finfo("key_size=%zu, len=%zu, data_size = %zu\n", key_size,
-                                                    pdata->len, data_size);
-
-  if ((data_size > (fs->blocksize - 3 * ate_size)) ||
-      ((pdata->len > 0) && (pdata->configdata == NULL)))
+  rc = nvs_check_data(fs, pdata);
+  if (rc < 0)
     {
-      return -EINVAL;
+      return rc;
     }
 
+  data_size = nvs_align_up(fs, key_size + pdata->len);
+
   /* Calc hash id of key. */
 
   hash_id = nvs_fnv_hash_id(nvs_fnv_hash(key, key_size));
 
   /* Find latest entry with same id. */
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  if (fs->index != NULL)
+    {
+      rc = nvs_index_find(fs, hash_id, key, key_size, wlk_ate, &hist_addr);
+      if (rc == 0)
+        {
+          rd_addr = hist_addr;
+          prev_found = true;
+        }
+      else if (rc != -ENOENT)
+        {
+          return rc;
+        }
+
+      goto found;
+    }
+#endif
+
 #if CONFIG_MTD_CONFIG_CACHE_SIZE > 0
   wlk_addr = fs->cache[nvs_cache_index(hash_id)];
   if (wlk_addr == NVS_CACHE_NO_ADDR)
@@ -1927,6 +2367,9 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
         }
     }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+found:
+#endif
   if (prev_found)
     {
       finfo("Previous found\n");
@@ -2084,6 +2527,10 @@ static ssize_t nvs_write(FAR struct nvs_fs *fs,
       finfo("Gc count=%d\n", gc_count);
     }
 
+#if CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD > 0
+  nvs_gc_schedule(fs);
+#endif
+
   finfo("nvs_write success\n");
   return 0;
 }
@@ -2113,6 +2560,55 @@ static int nvs_delete(FAR struct nvs_fs *fs, FAR struct config_data_s *pdata)
   return nvs_write(fs, pdata);
 }
 
+/****************************************************************************
+ * Name: nvs_write_batch
+ *
+ * Description:
+ *   Write a list of entries under one hold of the lock, so that readers
+ *   see either none or all of them.  Every entry is checked before any is
+ *   written.
+ *
+ * Input Parameters:
+ *   fs    - Pointer to file system.
+ *   batch - Pointer to the list of entries.
+ *
+ * Returned Value:
+ *   0 on success, -ERRNO errno code if error.
+ *
+ ****************************************************************************/
+
+static int nvs_write_batch(FAR struct nvs_fs *fs,
+                           FAR struct config_batch_s *batch)
+{
+  size_t i;
+  int rc;
+
+  if (batch == NULL || (batch->nitems > 0 && batch->items == NULL))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < batch->nitems; i++)
+    {
+      rc = nvs_check_data(fs, &batch->items[i]);
+      if (rc < 0)
+        {
+          return rc;
+        }
+    }
+
+  for (i = 0; i < batch->nitems; i++)
+    {
+      rc = nvs_write(fs, &batch->items[i]);
+      if (rc < 0)
+        {
+          return rc;
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: nvs_read
  *
@@ -2374,6 +2870,18 @@ static int mtdconfig_ioctl(FAR struct file *filep, int cmd,
 
         break;
 
+      case CFGDIOC_SETCONFIGS:
+
+        /* Write a list of nvs items. */
+
+        rc = nvs_write_batch(fs, (FAR struct config_batch_s *)arg);
+        if (rc >= 0)
+          {
+            mtdconfig_notify(fs, POLLPRI);
+          }
+
+        break;
+
       case CFGDIOC_DELCONFIG:
 
         /* Delete a nvs item. */
@@ -2482,6 +2990,17 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
       goto errout;
     }
 
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  fs->index = NULL;
+  fs->nindex = 0;
+  fs->index_size = 0;
+#endif
+
+#if CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD > 0
+  memset(&fs->gc_work, 0, sizeof(fs->gc_work));
+  fs->gc_block = UINT32_MAX;
+#endif
+
   rc = nvs_startup(fs);
   if (rc < 0)
     {
@@ -2499,6 +3018,10 @@ int mtdconfig_register_by_path(FAR struct mtd_dev_s *mtd,
   return rc;
 
 mutex_err:
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  nvs_index_free(fs);
+#endif
+
   nxmutex_destroy(&fs->nvs_lock);
 
 errout:
@@ -2543,6 +3066,15 @@ int mtdconfig_unregister_by_path(FAR const char *path)
 
   inode = file.f_inode;
   fs = inode->i_private;
+
+#if CONFIG_MTD_CONFIG_NVS_GC_THRESHOLD > 0
+  work_cancel_sync(LPWORK, &fs->gc_work);
+#endif
+
+#ifdef CONFIG_MTD_CONFIG_NVS_INDEX
+  nvs_index_free(fs);
+#endif
+
   nxmutex_destroy(&fs->nvs_lock);
   kmm_free(fs);
   file_close(&file);
@@ -229,16 +229,17 @@
 
 struct mx25l_dev_s
 {
-  struct mtd_dev_s mtd;              /* MTD interface */
-  FAR struct spi_dev_s *dev;         /* Saved SPI interface instance */
+  struct mtd_dev_s mtd;               /* MTD interface */
+  FAR struct spi_dev_s *dev;          /* Saved SPI interface instance */
   uint8_t               sectorshift;
   uint8_t               pageshift;
   uint8_t               addressbytes; /* Number of address bytes required */
+  uint8_t               prev_instr;   /* Last program or erase instruction */
   uint16_t              nsectors;
 #if defined(CONFIG_MX25L_SECTOR512)
-  uint8_t               flags;       /* Buffered sector flags */
-  uint16_t              esectno;     /* Erase sector number in the cache */
-  FAR uint8_t          *sector;      /* Allocated sector data */
+  uint8_t               flags;        /* Buffered sector flags */
+  uint16_t              esectno;      /* Erase sector number in the cache */
+  FAR uint8_t          *sector;       /* Allocated sector data */
 #endif
 };
 
@@ -456,10 +457,11 @@ static void mx25l_waitwritecomplete(FAR struct mx25l_dev_s *priv)
       /* Given that writing could take up to few tens of milliseconds, and
        * erasing could take more.
        * The following short delay in the "busy" case will allow other
-       * peripherals to access the SPI bus.
+       * peripherals to access the SPI bus.  A page program completes well
+       * within the delay, so just keep polling in that case.
        */
 
-      if ((status & MX25L_SR_WIP) != 0)
+      if (priv->prev_instr != MX25L_PP && (status & MX25L_SR_WIP) != 0)
         {
           mx25l_unlock(priv->dev);
           nxsched_usleep(1000);
@@ -477,6 +479,14 @@ static void mx25l_waitwritecomplete(FAR struct mx25l_dev_s *priv)
 
 static void mx25l_writeenable(FAR struct mx25l_dev_s *priv)
 {
+  /* Program and erase return as soon as the instruction has been sent, so
+   * that the caller (and other users of the SPI bus) can go on while the
+   * FLASH is busy.  The device ignores WREN until then, so this is where
+   * we wait for the preceding operation to complete.
+   */
+
+  mx25l_waitwritecomplete(priv);
+
   /* Select this FLASH part */
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(0), true);
@@ -566,11 +576,12 @@ static void mx25l_sectorerase(FAR struct mx25l_dev_s *priv, off_t sector)
       SPI_SEND(priv->dev, offset & 0xff);
     }
 
-  /* Deselect the FLASH */
+  /* Deselect the FLASH.  The next instruction waits for the erase to
+   * complete.
+   */
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
-
-  mx25l_waitwritecomplete(priv);
+  priv->prev_instr = MX25L_SE;
 
   mxlinfo("Erased\n");
 }
@@ -598,6 +609,7 @@ static inline int mx25l_chiperase(FAR struct mx25l_dev_s *priv)
   /* Deselect the FLASH */
 
   SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
+  priv->prev_instr = MX25L_CE;
 
   mx25l_waitwritecomplete(priv);
 
@@ -722,10 +734,7 @@ static inline void mx25l_pagewrite(FAR struct mx25l_dev_s *priv,
       /* Deselect the FLASH and setup for the next pass through the loop */
 
       SPI_SELECT(priv->dev, SPIDEV_FLASH(0), false);
-
-      /* Wait for any preceding write or erase operation to complete. */
-
-      mx25l_waitwritecomplete(priv);
+      priv->prev_instr = MX25L_PP;
 
       /* Update addresses */
 
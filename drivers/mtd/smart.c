@@ -45,6 +45,8 @@
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -138,6 +140,26 @@
 #define SMART_WEAR_MIN_LEVEL                5
 #define SMART_WEAR_FORCE_REORG_THRESHOLD    1
 #define SMART_WEAR_BIT_DIVIDE               1
+
+/* The foreground collection keeps at least one erase block worth of free
+ * sectors (plus a few) so that a block can always be relocated.  The
+ * background collection is started when the free sectors fall below the
+ * low watermark and runs until the reserve above that limit is restored.
+ */
+
+#define SMART_GC_LIMIT(d)         ((d)->sectorsperblk + 4)
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  if CONFIG_MTD_SMART_BGGC_RESERVE < CONFIG_MTD_SMART_BGGC_LOWWATER
+#    error CONFIG_MTD_SMART_BGGC_RESERVE below the low watermark
+#  endif
+#  define SMART_BGGC_LOW(d)       (SMART_GC_LIMIT(d) + \
+                                   CONFIG_MTD_SMART_BGGC_LOWWATER * \
+                                   (d)->availsectperblk)
+#  define SMART_BGGC_HIGH(d)      (SMART_GC_LIMIT(d) + \
+                                   CONFIG_MTD_SMART_BGGC_RESERVE * \
+                                   (d)->availsectperblk)
+#endif
 #define SMART_WEAR_ZERO_MASK                0x0f
 #define SMART_WEAR_BLOCK_MASK               0x01
 
@@ -245,6 +267,11 @@ struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
   struct mtd_geometry_s geo;              /* Device geometry */
+  mutex_t               lock;             /* Serializes device access */
+#ifdef CONFIG_MTD_SMART_BGGC
+  struct work_s         gcwork;           /* Background garbage collection */
+  bool                  gcerase;          /* Released blocks wait for erase */
+#endif
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
   uint32_t              unusedsectors;    /* Count of unused sectors (i.e. free when erased) */
@@ -902,6 +929,7 @@ static ssize_t smart_read(FAR struct inode *inode, FAR unsigned char *buffer,
                           blkcnt_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %" PRIuOFF " nsectors: %u\n",
         start_sector, nsectors);
@@ -912,7 +940,16 @@ static ssize_t smart_read(FAR struct inode *inode, FAR unsigned char *buffer,
 #else
   dev = inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  nxmutex_unlock(&dev->lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -949,7 +986,11 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -990,10 +1031,7 @@ static ssize_t smart_write(FAR struct inode *inode,
             {
               ferr("ERROR: Erase block=%" PRIdOFF " failed: %d\n",
                    eraseblock, ret);
-
-              /* Unlock the mutex if we add one */
-
-              return ret;
+              goto errout;
             }
         }
 
@@ -1021,10 +1059,8 @@ static ssize_t smart_write(FAR struct inode *inode,
 
           ferr("ERROR: Write block %" PRIdOFF " failed: %zd.\n",
                nextblock, nxfrd);
-
-          /* Unlock the mutex if we add one */
-
-          return -EIO;
+          ret = -EIO;
+          goto errout;
         }
 
       /* Then update for amount written */
@@ -1035,7 +1071,11 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdblkspererase;
     }
 
-  return nsectors;
+  ret = nsectors;
+
+errout:
+  nxmutex_unlock(&dev->lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -2787,6 +2827,62 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
     }
 }
 
+/****************************************************************************
+ * Name: smart_block_released
+ *
+ * Description:  Tests if the specified erase block holds released sectors
+ *               only, i.e. it can be erased without relocating anything.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_block_released(FAR struct smart_struct_s *dev,
+                                 uint16_t block)
+{
+  uint16_t freecount;
+  uint16_t releasecount;
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  releasecount = smart_get_count(dev, dev->releasecount, block);
+  freecount = smart_get_count(dev, dev->freecount, block);
+#else
+  releasecount = dev->releasecount[block];
+  freecount = dev->freecount[block];
+#endif
+
+  return freecount == 0 && releasecount == dev->availsectperblk;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_erase_released_block
+ *
+ * Description:  Called after a sector of the specified erase block has been
+ *               released.  Erases the block if it holds released sectors
+ *               only.  With background garbage collection the erase is left
+ *               to the collection work unless the device is short of free
+ *               sectors.
+ *
+ ****************************************************************************/
+
+static void smart_erase_released_block(FAR struct smart_struct_s *dev,
+                                       uint16_t block)
+{
+#ifdef CONFIG_MTD_SMART_BGGC
+  if (dev->freesectors > SMART_BGGC_LOW(dev))
+    {
+      if (smart_block_released(dev, block))
+        {
+          dev->gcerase = true;
+        }
+
+      return;
+    }
+#endif
+
+  smart_erase_block_if_empty(dev, block, false);
+}
+
 /****************************************************************************
  * Name: smart_relocate_static_data
  *
@@ -4014,6 +4110,49 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_find_collectblock
+ *
+ * Description:  Returns the erase block with the most released sectors and
+ *               its count of released sectors, or 0xffff if no block has
+ *               released sectors.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_find_collectblock(FAR struct smart_struct_s *dev,
+                                        FAR uint16_t *releasemax)
+{
+  uint16_t collectblock = 0xffff;
+  uint16_t count;
+  int x;
+
+  *releasemax = 0;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+#else
+      count = dev->releasecount[x];
+#endif
+      if (count > *releasemax)
+        {
+          *releasemax = count;
+          collectblock = x;
+        }
+    }
+
+  return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -4028,11 +4167,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
   uint16_t collectblock;
   uint16_t releasemax;
   bool collect = true;
-  int x;
   int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t count;
-#endif
 
   while (collect)
     {
@@ -4050,7 +4185,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 
       /* Test if we have more reached our reserved free sector limit */
 
-      if (dev->freesectors <= (dev->sectorsperblk << 0) + 4)
+      if (dev->freesectors <= SMART_GC_LIMIT(dev))
         {
           collect = true;
         }
@@ -4061,39 +4196,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
-
-#if 0
-          releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-#endif
-
+          collectblock = smart_find_collectblock(dev, &releasemax);
           if (collectblock == 0xffff)
             {
               /* Need to collect, but no sectors with released blocks! */
@@ -4914,7 +5017,7 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 
       /* Test if releasing the sector created an empty erase block */
 
-      smart_erase_block_if_empty(dev, block, false);
+      smart_erase_released_block(dev, block);
 
       /* Since we performed a relocation, do garbage collection to
        * ensure we don't fill up our flash with released blocks.
@@ -5138,7 +5241,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
    * on hand to do released sector garbage collection.
    */
 
-  if (dev->freesectors <= (dev->sectorsperblk << 0) + 4)
+  if (dev->freesectors <= SMART_GC_LIMIT(dev))
     {
       /* Do a garbage collect and then test freesectors again */
 
@@ -5470,13 +5573,141 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
 
   /* If this block has only released blocks, then erase it */
 
-  smart_erase_block_if_empty(dev, block, false);
+  smart_erase_released_block(dev, block);
   ret = OK;
 
 errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_bggc_collect
+ *
+ * Description:  Relocates the erase block with the most released sectors
+ *               if the free sectors are below the reserve.  Blocks that
+ *               would free less than a quarter of their sectors are left
+ *               alone, as moving them costs more wear than it gains.
+ *               Returns true if a block was collected.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_collect(FAR struct smart_struct_s *dev)
+{
+  uint16_t collectblock;
+  uint16_t releasemax;
+  uint16_t mingain;
+
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      dev->freesectors >= SMART_BGGC_HIGH(dev))
+    {
+      return false;
+    }
+
+  mingain = dev->availsectperblk >> 2;
+  if (mingain == 0)
+    {
+      mingain = 1;
+    }
+
+  collectblock = smart_find_collectblock(dev, &releasemax);
+  if (collectblock == 0xffff || releasemax < mingain)
+    {
+      return false;
+    }
+
+  finfo("Background collecting block %d, released=%d, totalfree=%d\n",
+        collectblock, releasemax, dev->freesectors);
+
+  return smart_relocate_block(dev, collectblock) == OK;
+}
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Background garbage collection.  Erases the blocks left
+ *               with released sectors only, then collects blocks until the
+ *               reserve of free sectors is restored.  The device lock is
+ *               released after every erase block so that foreground
+ *               requests are never held off for more than one block.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = arg;
+  bool erase;
+  bool more;
+  int x;
+
+  nxmutex_lock(&dev->lock);
+  erase = dev->gcerase;
+  dev->gcerase = false;
+  nxmutex_unlock(&dev->lock);
+
+  for (x = 0; erase && x < dev->neraseblocks; x++)
+    {
+      if (!smart_block_released(dev, x))
+        {
+          continue;
+        }
+
+      nxmutex_lock(&dev->lock);
+      if (dev->formatstatus == SMART_FMT_STAT_FORMATTED)
+        {
+          smart_erase_block_if_empty(dev, x, false);
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+            {
+              smart_write_wearstatus(dev);
+            }
+#endif
+        }
+
+      nxmutex_unlock(&dev->lock);
+    }
+
+  do
+    {
+      nxmutex_lock(&dev->lock);
+      more = smart_bggc_collect(dev);
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+        {
+          smart_write_wearstatus(dev);
+        }
+#endif
+
+      nxmutex_unlock(&dev->lock);
+    }
+  while (more);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_kick
+ *
+ * Description:  Queues the background garbage collection if there are
+ *               released blocks to erase or the free sectors have fallen
+ *               below the low watermark.  Called with the device locked.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_kick(FAR struct smart_struct_s *dev)
+{
+  if (dev->formatstatus != SMART_FMT_STAT_FORMATTED ||
+      !work_available(&dev->gcwork))
+    {
+      return;
+    }
+
+  if (dev->gcerase || (dev->freesectors < SMART_BGGC_LOW(dev) &&
+                       dev->releasesectors >= dev->availsectperblk >> 2))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, 0);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -5502,6 +5733,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = inode->i_private;
 #endif
 
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5641,6 +5878,10 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BGGC
+  smart_bggc_kick(dev);
+#endif
+  nxmutex_unlock(&dev->lock);
   return ret;
 }
 
@@ -6183,6 +6424,7 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+      nxmutex_init(&dev->lock);
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6332,6 +6574,7 @@ errout:
     }
 #endif
 
+  nxmutex_destroy(&dev->lock);
   kmm_free(dev);
   return ret;
 }
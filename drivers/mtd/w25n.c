@@ -119,6 +119,7 @@
 #define W25N_SR3_ECC_OK         (0x00)
 #define W25N_SR3_ECC_CORRECTED  (W25N_SR3_ECC0)
 #define W25N_SR3_ECC_ERROR      (W25N_SR3_ECC1)
+#define W25N_SR3_ECC_MULTIERR   (W25N_SR3_ECC1 | W25N_SR3_ECC0)
 
 /* Device Identification ****************************************************/
 
@@ -147,6 +148,7 @@ struct w25n_dev_s
   uint8_t                blockshift;  /* Block size shift (17 = 128KB) */
   uint8_t                pageshift;   /* Page size shift (11 = 2KB) */
   uint8_t                eccstatus;   /* Last ECC status */
+  uint8_t                sr2;         /* Configuration register value */
 };
 
 /****************************************************************************
@@ -173,6 +175,11 @@ static int     w25n_waitready_erase(FAR struct w25n_dev_s *priv);
 /* Page operations */
 
 static int     w25n_read_page(FAR struct w25n_dev_s *priv, uint32_t page);
+#ifdef CONFIG_W25N_CONTINUOUS_READ
+static int     w25n_read_continuous(FAR struct w25n_dev_s *priv,
+                                    uint32_t page, FAR uint8_t *buf,
+                                    size_t npages);
+#endif
 static void    w25n_read_buffer(FAR struct w25n_dev_s *priv, uint16_t col,
                                 FAR uint8_t *buf, size_t len);
 static void    w25n_load_buffer(FAR struct w25n_dev_s *priv, uint16_t col,
@@ -442,6 +449,57 @@ static int w25n_read_page(FAR struct w25n_dev_s *priv, uint32_t page)
   return OK;
 }
 
+/****************************************************************************
+ * Name: w25n_read_continuous
+ *
+ * Description:
+ *   Read the main area of npages consecutive pages in continuous read mode.
+ *   Read Data then starts at column 0 of the page loaded by Page Data Read
+ *   and runs on through the following pages, which the device loads while
+ *   the previous one is being clocked out, until CS is released.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_W25N_CONTINUOUS_READ
+static int w25n_read_continuous(FAR struct w25n_dev_s *priv, uint32_t page,
+                                FAR uint8_t *buf, size_t npages)
+{
+  int ret;
+
+  w25n_write_status(priv, W25N_SR2_ADDR, priv->sr2 & ~W25N_SR2_BUF);
+
+  ret = w25n_read_page(priv, page);
+  if (ret >= 0)
+    {
+      /* The column address is replaced by dummy bytes in this mode */
+
+      SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), true);
+      SPI_SEND(priv->spi, W25N_READ_DATA);
+      SPI_SEND(priv->spi, W25N_DUMMY);
+      SPI_SEND(priv->spi, W25N_DUMMY);
+      SPI_SEND(priv->spi, W25N_DUMMY);
+      SPI_RECVBLOCK(priv->spi, buf, npages << priv->pageshift);
+      SPI_SELECT(priv->spi, SPIDEV_FLASH(priv->spi_devid), false);
+
+      /* The ECC status now covers all pages of the run */
+
+      ret = w25n_waitready(priv);
+      if (ret >= 0 && (priv->eccstatus == W25N_SR3_ECC_ERROR ||
+                       priv->eccstatus == W25N_SR3_ECC_MULTIERR))
+        {
+          ferr("ERROR: Uncorrectable ECC error in pages %lu-%lu\n",
+               (unsigned long)page, (unsigned long)(page + npages - 1));
+          ret = -EIO;
+        }
+    }
+
+  /* Back to buffer read mode for the single page accesses */
+
+  w25n_write_status(priv, W25N_SR2_ADDR, priv->sr2);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: w25n_read_buffer
  *
@@ -583,9 +641,14 @@ static void w25n_enable_ecc(FAR struct w25n_dev_s *priv)
 {
   uint8_t sr2;
 
+  /* Also select buffer read mode, which is the default on some but not all
+   * of the parts: the page reads below address the data buffer by column.
+   */
+
   sr2 = w25n_read_status(priv, W25N_SR2_ADDR);
-  sr2 |= W25N_SR2_ECCE;
+  sr2 |= W25N_SR2_ECCE | W25N_SR2_BUF;
   w25n_write_status(priv, W25N_SR2_ADDR, sr2);
+  priv->sr2 = sr2;
 
   finfo("ECC enabled\n");
 }
@@ -654,6 +717,20 @@ static ssize_t w25n_bread(FAR struct mtd_dev_s *dev, off_t startblock,
 
   w25n_lock(priv);
 
+#ifdef CONFIG_W25N_CONTINUOUS_READ
+  if (nblocks > 1)
+    {
+      ret = w25n_read_continuous(priv, startblock, buf, nblocks);
+      w25n_unlock(priv);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return nblocks;
+    }
+#endif
+
   for (i = 0; i < nblocks; i++)
     {
       uint32_t page = startblock + i;
@@ -76,6 +76,13 @@
 #define E1000_TX_QUOTA        E1000_TX_DESC
 #define E1000_RX_QUOTA        (E1000_RX_DESC + CONFIG_NET_E1000_RXSPARE)
 
+/* The RX tail is only moved once this many descriptors were refilled,
+ * which saves most of the register writes.  The NIC still owns the rest
+ * of the ring meanwhile.
+ */
+
+#define E1000_RX_REFILL       (E1000_RX_DESC >= 64 ? 16 : 1)
+
 /* NOTE: CONFIG_IOB_ALIGNMENT must match system D-CACHE line size */
 
 #if CONFIG_IOB_NBUFFERS < (E1000_RX_QUOTA + E1000_TX_QUOTA)
@@ -691,9 +698,12 @@ static FAR netpkt_t *e1000_receive(FAR struct netdev_lowerhalf_s *dev)
   rx->len    = 0;
   rx->status = 0;
 
-  /* Update RX tail */
+  /* Update RX tail, once per batch of refilled descriptors */
 
-  e1000_putreg_mem(priv, E1000_RDT, desc);
+  if ((desc + 1) % E1000_RX_REFILL == 0)
+    {
+      e1000_putreg_mem(priv, E1000_RDT, desc);
+    }
 
   /* Handle errors */
 
@@ -76,6 +76,13 @@
 #define IGB_TX_QUOTA           IGB_TX_DESC
 #define IGB_RX_QUOTA           (IGB_RX_DESC + CONFIG_NET_IGB_RXSPARE)
 
+/* The RX tail is only moved once this many descriptors were refilled,
+ * which saves most of the register writes.  The NIC still owns the rest
+ * of the ring meanwhile.
+ */
+
+#define IGB_RX_REFILL          (IGB_RX_DESC >= 64 ? 16 : 1)
+
 /* NOTE: CONFIG_IOB_ALIGNMENT must match system D-CACHE line size */
 
 #if CONFIG_IOB_NBUFFERS < IGB_RX_QUOTA + IGB_TX_QUOTA
@@ -666,9 +673,12 @@ static FAR netpkt_t *igb_receive(FAR struct netdev_lowerhalf_s *dev)
   rx->len    = 0;
   rx->status = 0;
 
-  /* Update RX tail */
+  /* Update RX tail, once per batch of refilled descriptors */
 
-  igb_putreg_mem(priv, IGB_RDT0, desc);
+  if ((desc + 1) % IGB_RX_REFILL == 0)
+    {
+      igb_putreg_mem(priv, IGB_RDT0, desc);
+    }
 
   /* Handle errors */
 
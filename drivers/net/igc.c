@@ -76,6 +76,13 @@
 #define IGC_TX_QUOTA           IGC_TX_DESC
 #define IGC_RX_QUOTA           (IGC_RX_DESC + CONFIG_NET_IGC_RXSPARE)
 
+/* The RX tail is only moved once this many descriptors were refilled,
+ * which saves most of the register writes.  The NIC still owns the rest
+ * of the ring meanwhile.
+ */
+
+#define IGC_RX_REFILL          (IGC_RX_DESC >= 64 ? 16 : 1)
+
 /* NOTE: CONFIG_IOB_ALIGNMENT must match system D-CACHE line size */
 
 #if CONFIG_IOB_NBUFFERS < IGC_RX_QUOTA + IGC_TX_QUOTA
@@ -104,6 +111,26 @@
 #define IGC_MSIX_IVAR0         (IGC_IVAR0_RXQ0_VAL | IGC_IVAR0_TXQ0_VAL)
 #define IGC_MSIX_IVARMSC       (IGC_IVARMSC_OTHER_VAL)
 
+/* If the device provides enough vectors, RX queue, TX queue and other
+ * causes each get an MSI-X vector of their own.
+ */
+
+#define IGC_MSIX_RX            0
+#define IGC_MSIX_TX            1
+#define IGC_MSIX_OTHER         2
+#define IGC_MSIX_NIRQ          3
+
+#define IGC_GPIE_MSIX_MULTI    (IGC_GPIE_NSICR | IGC_GPIE_MSIX | \
+                                IGC_GPIE_PBASUPPORT)
+#define IGC_MSIX_MULTI_IMS     (IGC_IC_LSC | IGC_IC_RXMISS)
+#define IGC_MSIX_MULTI_EIMS    ((1 << IGC_MSIX_RX) | (1 << IGC_MSIX_TX) | \
+                                (1 << IGC_MSIX_OTHER))
+#define IGC_MSIX_MULTI_IVAR0   (IGC_IVAR0_RXQ0_VAL | IGC_IVAR0_TXQ0_VAL | \
+                                (IGC_MSIX_RX << IGC_IVAR0_RXQ0_SHIFT) | \
+                                (IGC_MSIX_TX << IGC_IVAR0_TXQ0_SHIFT))
+#define IGC_MSIX_MULTI_IVARMSC (IGC_IVARMSC_OTHER_VAL | \
+                                (IGC_MSIX_OTHER << IGC_IVARMSC_OTHER_SHIFT))
+
 /*****************************************************************************
  * Private Types
  *****************************************************************************/
@@ -143,7 +170,10 @@ struct igc_driver_s
 
   FAR struct pci_device_s     *pcidev;
   FAR const struct igc_type_s *type;
-  int                          irq;
+  int                          irq[IGC_MSIX_NIRQ];
+  int                          nirq;
+  uint32_t                     ims;
+  uint32_t                     eims;
   uint64_t                     base;
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -191,6 +221,8 @@ static void igc_txdone(FAR struct netdev_lowerhalf_s *dev);
 
 static void igc_msix_interrupt(FAR struct igc_driver_s *priv);
 static int igc_interrupt(int irq, FAR void *context, FAR void *arg);
+static int igc_rx_interrupt(int irq, FAR void *context, FAR void *arg);
+static int igc_tx_interrupt(int irq, FAR void *context, FAR void *arg);
 
 /* NuttX callback functions */
 
@@ -643,9 +675,12 @@ static FAR netpkt_t *igc_receive(FAR struct netdev_lowerhalf_s *dev)
   rx->len    = 0;
   rx->status = 0;
 
-  /* Update RX tail */
+  /* Update RX tail, once per batch of refilled descriptors */
 
-  igc_putreg_mem(priv, IGC_RDT0, desc);
+  if ((desc + 1) % IGC_RX_REFILL == 0)
+    {
+      igc_putreg_mem(priv, IGC_RDT0, desc);
+    }
 
   /* Handle errors */
 
@@ -847,6 +882,42 @@ static int igc_interrupt(int irq, FAR void *context, FAR void *arg)
   return OK;
 }
 
+/*****************************************************************************
+ * Name: igc_rx_interrupt
+ *
+ * Description:
+ *   RX queue interrupt handler, used when the queue has its own vector
+ *
+ *****************************************************************************/
+
+static int igc_rx_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)arg;
+
+  DEBUGASSERT(priv != NULL);
+
+  netdev_lower_rxready(&priv->dev);
+  return OK;
+}
+
+/*****************************************************************************
+ * Name: igc_tx_interrupt
+ *
+ * Description:
+ *   TX queue interrupt handler, used when the queue has its own vector
+ *
+ *****************************************************************************/
+
+static int igc_tx_interrupt(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct igc_driver_s *priv = (FAR struct igc_driver_s *)arg;
+
+  DEBUGASSERT(priv != NULL);
+
+  igc_txdone(&priv->dev);
+  return OK;
+}
+
 /*****************************************************************************
  * Name: igc_ifup
  *
@@ -1069,9 +1140,13 @@ static void igc_disable(FAR struct igc_driver_s *priv)
 
   /* Disable interrupts */
 
-  igc_putreg_mem(priv, IGC_EIMC, IGC_MSIX_EIMS);
-  igc_putreg_mem(priv, IGC_IMC, IGC_MSIX_IMS);
-  up_disable_irq(priv->irq);
+  igc_putreg_mem(priv, IGC_EIMC, priv->eims);
+  igc_putreg_mem(priv, IGC_IMC, priv->ims);
+
+  for (i = 0; i < priv->nirq; i++)
+    {
+      up_disable_irq(priv->irq[i]);
+    }
 
   /* Disable Transmitter */
 
@@ -1203,9 +1278,13 @@ static void igc_enable(FAR struct igc_driver_s *priv)
 
   /* Enable interrupts */
 
-  igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
-  igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
-  up_enable_irq(priv->irq);
+  igc_putreg_mem(priv, IGC_EIMS, priv->eims);
+  igc_putreg_mem(priv, IGC_IMS, priv->ims);
+
+  for (i = 0; i < priv->nirq; i++)
+    {
+      up_enable_irq(priv->irq[i]);
+    }
 
   /* Set link up */
 
@@ -1265,24 +1344,47 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
 
   /* Allocate MSI */
 
-  ret = pci_alloc_irq(priv->pcidev, &priv->irq, 1);
-  if (ret != 1)
+  ret = pci_alloc_irq(priv->pcidev, priv->irq, IGC_MSIX_NIRQ);
+  if (ret < 1)
     {
       nerr("Failed to allocate MSI %d\n", ret);
-      return ret;
+      return ret < 0 ? ret : -ENOTSUP;
+    }
+
+  if (ret < IGC_MSIX_NIRQ)
+    {
+      /* Not enough vectors, all interrupts share vector 0 */
+
+      if (ret > 1)
+        {
+          pci_release_irq(priv->pcidev, &priv->irq[1], ret - 1);
+        }
+
+      ret = 1;
     }
 
+  priv->nirq = ret;
+
   /* Attach IRQ */
 
-  irq_attach(priv->irq, igc_interrupt, priv);
+  if (priv->nirq == 1)
+    {
+      irq_attach(priv->irq[0], igc_interrupt, priv);
+    }
+  else
+    {
+      irq_attach(priv->irq[IGC_MSIX_RX], igc_rx_interrupt, priv);
+      irq_attach(priv->irq[IGC_MSIX_TX], igc_tx_interrupt, priv);
+      irq_attach(priv->irq[IGC_MSIX_OTHER], igc_interrupt, priv);
+    }
 
   /* Connect MSI */
 
-  ret = pci_connect_irq(priv->pcidev, &priv->irq, 1);
+  ret = pci_connect_irq(priv->pcidev, priv->irq, priv->nirq);
   if (ret != OK)
     {
       nerr("Failed to connect MSI %d\n", ret);
-      pci_release_irq(priv->pcidev, &priv->irq, 1);
+      pci_release_irq(priv->pcidev, priv->irq, priv->nirq);
 
       return -ENOTSUP;
     }
@@ -1292,23 +1394,70 @@ static int igc_initialize(FAR struct igc_driver_s *priv)
   igc_putreg_mem(priv, IGC_EIMC, 0xffffffff);
   igc_putreg_mem(priv, IGC_IMC, 0xffffffff);
 
-  /* Configure MSI-X */
+  if (priv->nirq == 1)
+    {
+      priv->ims  = IGC_MSIX_IMS;
+      priv->eims = IGC_MSIX_EIMS;
 
-  igc_putreg_mem(priv, IGC_IVAR0, IGC_MSIX_IVAR0);
-  igc_putreg_mem(priv, IGC_IVARMSC, IGC_MSIX_IVARMSC);
+      /* Configure MSI-X */
 
-  /* Enable MSI-X Single Vector */
+      igc_putreg_mem(priv, IGC_IVAR0, IGC_MSIX_IVAR0);
+      igc_putreg_mem(priv, IGC_IVARMSC, IGC_MSIX_IVARMSC);
 
-  igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_SINGLE);
-  igc_putreg_mem(priv, IGC_EIMS, IGC_MSIX_EIMS);
+      /* Enable MSI-X Single Vector */
 
-  /* Configure Other causes */
+      igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_SINGLE);
+
+      /* Configure Interrupt Throttle */
 
-  igc_putreg_mem(priv, IGC_IMS, IGC_MSIX_IMS);
+      igc_putreg_mem(priv, IGC_EITR0, (CONFIG_NET_IGC_INT_INTERVAL << 2));
+    }
+  else
+    {
+      priv->ims  = IGC_MSIX_MULTI_IMS;
+      priv->eims = IGC_MSIX_MULTI_EIMS;
+
+      /* Route the queues and the other causes to their own vectors */
+
+      igc_putreg_mem(priv, IGC_IVAR0, IGC_MSIX_MULTI_IVAR0);
+      igc_putreg_mem(priv, IGC_IVARMSC, IGC_MSIX_MULTI_IVARMSC);
+
+      /* Enable MSI-X Multiple Vector, cause bits cleared on delivery */
+
+      igc_putreg_mem(priv, IGC_GPIE, IGC_GPIE_MSIX_MULTI);
+      igc_putreg_mem(priv, IGC_EIAC, IGC_MSIX_MULTI_EIMS);
+
+      /* Each queue vector is throttled on its own */
+
+      igc_putreg_mem(priv, IGC_EITR(IGC_MSIX_RX),
+                     (CONFIG_NET_IGC_INT_INTERVAL << 2));
+      igc_putreg_mem(priv, IGC_EITR(IGC_MSIX_TX),
+                     (CONFIG_NET_IGC_TX_INT_INTERVAL << 2));
+
+#ifdef CONFIG_SMP
+      /* Bind the queue vectors */
 
-  /* Configure Interrupt Throttle */
+      ret = pci_affinity_irq(priv->pcidev, IGC_MSIX_RX,
+                             priv->irq[IGC_MSIX_RX], CONFIG_NET_IGC_RX_CPU);
+      if (ret == OK)
+        {
+          ret = pci_affinity_irq(priv->pcidev, IGC_MSIX_TX,
+                                 priv->irq[IGC_MSIX_TX],
+                                 CONFIG_NET_IGC_TX_CPU);
+        }
+
+      if (ret != OK)
+        {
+          nwarn("Failed to bind queue vectors %d\n", ret);
+        }
+#endif
+    }
+
+  igc_putreg_mem(priv, IGC_EIMS, priv->eims);
+
+  /* Configure Other causes */
 
-  igc_putreg_mem(priv, IGC_EITR0, (CONFIG_NET_IGC_INT_INTERVAL << 2));
+  igc_putreg_mem(priv, IGC_IMS, priv->ims);
 
   /* Get MAC if valid */
 
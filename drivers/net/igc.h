@@ -83,6 +83,7 @@
 #define IGC_IVAR0                 (0x1700)   /* Interrupt Vector Allocation Registers  */
 #define IGC_IVARMSC               (0x1740)   /* Interrupt Vector Allocation Registers - MISC */
 #define IGC_EITR0                 (0x1680)   /* Extended Interrupt Throttling Rate 0 - 24 */
+#define IGC_EITR(n)               (IGC_EITR0 + ((n) << 2))
 #define IGC_GPIE                  (0x1514)   /* General Purpose Interrupt Enable */
 #define IGC_PBACL                 (0x5b68)   /* MSI-X PBA Clear */
 #define IGC_PICAUSE               (0x5b88)   /* PCIe Interrupt Cause */
@@ -423,7 +424,7 @@
 #define IGC_IVAR0_RXQ0_SHIFT      (0)        /* Bits 0-4: MSI-X vector assigned to RxQ0 */
 #define IGC_IVAR0_RXQ0_VAL        (1 << 7)   /* Bit 7: Valid bit for RxQ0 */
 #define IGC_IVAR0_TXQ0_SHIFT      (8)        /* Bits 8-12: MSI-X vector assigned to TxQ0 */
-#define IGC_IVAR0_TXQ0_VAL        (1 << 7)   /* Bit 7: Valid bit for TxQ0 */
+#define IGC_IVAR0_TXQ0_VAL        (1 << 15)  /* Bit 15: Valid bit for TxQ0 */
 
 /* Interrupt Vector Allocation Registers - Misc */
 
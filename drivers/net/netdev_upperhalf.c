@@ -29,6 +29,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -36,9 +37,11 @@
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -51,6 +54,24 @@
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
 
+#ifndef CONFIG_NETDEV_RX_BUDGET
+#  define CONFIG_NETDEV_RX_BUDGET 0
+#endif
+
+#ifndef CONFIG_NETDEV_RX_POOL
+#  define CONFIG_NETDEV_RX_POOL 0
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+#  define NETDEV_NQUEUES(lower) ((lower)->nqueues)
+#else
+#  define NETDEV_NQUEUES(lower) 1
+#endif
+
+/* Room for the L2, IP and TCP headers (with options) of a GSO packet */
+
+#define NETDEV_GSO_HDRSIZE 128
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,6 +91,18 @@ struct netdev_thread_s
   sem_t sem_exit;
 };
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+/* The state of one RX queue of a multi-queue device */
+
+struct netdev_queue_s
+{
+  FAR struct netdev_upperhalf_s *upper;
+  struct work_s work;  /* Polls this queue in NETDEV_RX_WORK mode */
+  int qid;             /* The work queue that work was last queued on */
+  uint8_t index;
+};
+#endif
+
 /* This structure describes the state of the upper half driver */
 
 struct netdev_upperhalf_s
@@ -88,6 +121,37 @@ struct netdev_upperhalf_s
 
   bool txing;
 
+#if CONFIG_NETDEV_RX_POOL > 0
+  /* RX buffers kept for reuse, linked through io_flink */
+
+  spinlock_t rxpool_lock;
+  FAR netpkt_t *rxpool;
+  uint16_t rxpool_count;
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  /* The TCP segment train being coalesced within an RX poll */
+
+  FAR netpkt_t *gro_pkt;
+  uint16_t gro_iphdrlen;
+  uint16_t gro_hdrlen;
+  uint16_t gro_segs;
+#endif
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  struct netdev_queue_s queue[CONFIG_NETDEV_MAX_QUEUES];
+#endif
+
+#ifdef CONFIG_NET_XDP
+  /* AF_XDP hooks of the RX queues */
+
+#  ifdef CONFIG_NETDEV_MULTIQUEUE
+  FAR struct netdev_xdp_s *xdp[CONFIG_NETDEV_MAX_QUEUES];
+#  else
+  FAR struct netdev_xdp_s *xdp[1];
+#  endif
+#endif
+
   /* Deferring process to work queue or thread */
 
   union
@@ -102,6 +166,7 @@ struct netdev_upperhalf_s
  ****************************************************************************/
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev);
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev);
 
 /****************************************************************************
  * Private Functions
@@ -125,6 +190,8 @@ static bool quota_is_valid(FAR struct netdev_lowerhalf_s *lower)
       total += netdev_lower_quota_load(lower, type);
     }
 
+  total += CONFIG_NETDEV_RX_POOL;
+
   if (total > NETPKT_BUFNUM)
     {
       nerr("ERROR: Too big quota when registering device: %d\n", total);
@@ -141,6 +208,149 @@ static bool quota_is_valid(FAR struct netdev_lowerhalf_s *lower)
   return true;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_rxpool_put
+ *
+ * Description:
+ *   Keep a buffer that is done with in the RX pool of the device.
+ *
+ * Returned Value:
+ *   true if the buffer was taken, false if it must be freed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDEV_RX_POOL > 0
+static bool netdev_upper_rxpool_put(FAR struct netdev_upperhalf_s *upper,
+                                    FAR netpkt_t *pkt)
+{
+  irqstate_t flags;
+  bool ret = false;
+
+  /* Only single buffers of the IOB pool are reused */
+
+  if (upper == NULL || pkt->io_flink != NULL ||
+      IOB_BUFSIZE(pkt) != CONFIG_IOB_BUFSIZE
+#ifdef CONFIG_IOB_ALLOC
+      || pkt->io_free != NULL
+#endif
+#ifdef CONFIG_NET_CAN
+      || upper->lower->netdev.d_lltype == NET_LL_CAN
+#endif
+      )
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&upper->rxpool_lock);
+  if (upper->rxpool_count < CONFIG_NETDEV_RX_POOL)
+    {
+      pkt->io_flink = upper->rxpool;
+      upper->rxpool = pkt;
+      upper->rxpool_count++;
+      ret = true;
+    }
+
+  spin_unlock_irqrestore(&upper->rxpool_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxpool_get
+ *
+ * Description:
+ *   Take a buffer from the RX pool of the device, initialized as
+ *   iob_tryalloc() does.
+ *
+ * Returned Value:
+ *   The buffer, NULL if the pool is empty.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *
+netdev_upper_rxpool_get(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR netpkt_t *pkt;
+  irqstate_t flags;
+
+  if (upper == NULL)
+    {
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave(&upper->rxpool_lock);
+  pkt = upper->rxpool;
+  if (pkt != NULL)
+    {
+      upper->rxpool = pkt->io_flink;
+      upper->rxpool_count--;
+    }
+
+  spin_unlock_irqrestore(&upper->rxpool_lock, flags);
+
+  if (pkt != NULL)
+    {
+      pkt->io_flink  = NULL;
+      pkt->io_len    = 0;
+      pkt->io_offset = 0;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      pkt->io_csum   = 0;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      pkt->io_tstamp = 0;
+#endif
+      pkt->io_pktlen = 0;
+    }
+
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxpool_drain
+ *
+ * Description:
+ *   Give the buffers of the RX pool back to the IOB pool.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpool_drain(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR netpkt_t *pkt;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&upper->rxpool_lock);
+  pkt = upper->rxpool;
+  upper->rxpool = NULL;
+  upper->rxpool_count = 0;
+  spin_unlock_irqrestore(&upper->rxpool_lock, flags);
+
+  if (pkt != NULL)
+    {
+      iob_free_chain(pkt);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_rxpool_reclaim
+ *
+ * Description:
+ *   Recycle the frame left in d_iob by the last input, which the stack
+ *   neither queued nor replied with.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxpool_reclaim(FAR struct net_driver_s *dev)
+{
+  if (dev->d_iob != NULL &&
+      netdev_upper_rxpool_put(dev->d_private, dev->d_iob))
+    {
+      netdev_iob_clear(dev);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: netpkt_get
  *
@@ -197,6 +407,14 @@ static void netpkt_put(FAR struct net_driver_s *dev, FAR netpkt_t *pkt,
   DEBUGASSERT(dev && pkt);
 
   atomic_fetch_add(&upper->lower->quota_ptr[type], 1);
+
+#if CONFIG_NETDEV_RX_POOL > 0
+  if (type == NETPKT_RX)
+    {
+      netdev_upper_rxpool_reclaim(dev);
+    }
+#endif
+
   netdev_iob_replace_l2(dev, pkt);
 }
 
@@ -256,192 +474,544 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 }
 
 /****************************************************************************
- * Name: netdev_upper_txpoll
+ * Name: netdev_upper_select_queue
  *
  * Description:
- *   The transmitter is available, check if the network has any outgoing
- *   packets ready to send.  This is a callback from devif_poll().
- *   devif_poll() may be called:
- *
- *   1. When the preceding TX packet send is complete
- *   2. When the preceding TX packet send times out and the interface is
- *      reset
- *   3. During normal TX polling
+ *   Choose the TX queue of a packet from the Toeplitz hash of its flow,
+ *   taken with the source and destination swapped so that it is the RSS
+ *   hash that the hardware computes for the replies: TCP/UDP over IP are
+ *   hashed with their ports, other IP packets with the addresses only and
+ *   anything else goes to the first queue.
  *
  * Input Parameters:
  *   dev - Reference to the NuttX driver state structure
+ *   pkt - The packet to send
  *
  * Returned Value:
- *   Negated errno value - Error number that occurs.
- *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
- *
- * Assumptions:
- *   Called with the network locked.
+ *   The index of the TX queue.
  *
  ****************************************************************************/
 
-static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static unsigned int netdev_upper_select_queue(FAR struct net_driver_s *dev,
+                                              FAR netpkt_t *pkt)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR netpkt_t                  *pkt;
-  int                            ret;
+  FAR const uint8_t             *l3    = IOB_DATA(pkt);
+  uint8_t                        tuple[36];
+  unsigned int                   iphdrlen;
+  unsigned int                   len;
+  uint8_t                        proto;
 
-  DEBUGASSERT(dev->d_len > 0);
-
-  NETDEV_TXPACKETS(dev);
+  if (pkt->io_len == 0)
+    {
+      return 0;
+    }
 
-#ifdef CONFIG_NET_PKT
-  /* When packet sockets are enabled, feed the tx frame into it */
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] >> 4) == 4 && pkt->io_len >= IPv4_HDRLEN)
+    {
+      FAR const struct ipv4_hdr_s *ipv4 = (FAR const struct ipv4_hdr_s *)l3;
 
-  pkt_input(dev);
-#endif
+      memcpy(tuple, ipv4->destipaddr, 4);
+      memcpy(tuple + 4, ipv4->srcipaddr, 4);
+      len      = 8;
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto    = ipv4->proto;
 
-  pkt = netpkt_get(dev, NETPKT_TX);
+      /* Only the first fragment has the ports */
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+      if ((ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+        {
+          proto = 0;
+        }
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((l3[0] >> 4) == 6 && pkt->io_len >= IPv6_HDRLEN)
     {
-      nerr("ERROR: Packet too long to send!\n");
-      ret = -EMSGSIZE;
+      FAR const struct ipv6_hdr_s *ipv6 = (FAR const struct ipv6_hdr_s *)l3;
+
+      memcpy(tuple, ipv6->destipaddr, 16);
+      memcpy(tuple + 16, ipv6->srcipaddr, 16);
+      len      = 32;
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ipv6->proto;
     }
   else
+#endif
     {
-      ret = lower->ops->transmit(lower, pkt);
+      return 0;
     }
 
-  if (ret != OK)
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      pkt->io_len >= iphdrlen + 4)
     {
-      /* Stop polling on any error
-       * REVISIT: maybe store the pkt in upper half and retry later?
-       */
-
-      NETDEV_TXERRORS(dev);
-      nerr("ERROR: Transmit failed: %d\n", ret);
-      netpkt_put(dev, pkt, NETPKT_TX);
-      return ret;
+      tuple[len++] = l3[iphdrlen + 2];
+      tuple[len++] = l3[iphdrlen + 3];
+      tuple[len++] = l3[iphdrlen];
+      tuple[len++] = l3[iphdrlen + 1];
     }
 
-  return NETDEV_TX_CONTINUE;
+  return net_toeplitz_hash(tuple, len) % upper->lower->nqueues;
 }
+#endif
 
 /****************************************************************************
- * Name: netdev_upper_tx
+ * Name: netdev_upper_transmit
  *
  * Description:
- *   Do the actual transmission of packets, including pre-queued packets and
- *   packets from the network stack.
+ *   Hand a packet to the lower half, on its TX queue if the device has
+ *   more than one.
  *
  * Input Parameters:
  *   dev - Reference to the NuttX driver state structure
+ *   pkt - The packet to send
  *
  * Returned Value:
- *   Negated errno value - Error number that occurs.
- *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
- *
- * Assumptions:
- *   Called with the network locked.
+ *   The return value of the transmit operation of the lower half.
  *
  ****************************************************************************/
 
-static int netdev_upper_tx(FAR struct net_driver_s *dev)
+static int netdev_upper_transmit(FAR struct net_driver_s *dev,
+                                 FAR netpkt_t *pkt)
 {
-#if CONFIG_IOB_NCHAINS > 0
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
 
-  if (!IOB_QEMPTY(&upper->txq))
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
     {
-      /* Put the packet back to the device */
-
-      netdev_iob_replace_l2(dev, iob_remove_queue(&upper->txq));
-      return netdev_upper_txpoll(dev);
+      return lower->ops->transmit_queue(lower, pkt,
+                                        netdev_upper_select_queue(dev, pkt));
     }
 #endif
 
-  /* No more TX packets in queue, poll the net stack to get more packets */
-
-  return devif_poll(dev, netdev_upper_txpoll);
+  return lower->ops->transmit(lower, pkt);
 }
 
 /****************************************************************************
- * Name: netdev_upper_txavail_work
+ * Name: netdev_upper_gso
  *
  * Description:
- *   Perform an out-of-cycle tx poll on the worker thread.
+ *   Software GSO: split a TCP packet larger than the MTU into segments of
+ *   at most 'mss' bytes of payload and transmit them one by one.  Each
+ *   segment gets a copy of the headers with the lengths, the IPv4 ID, the
+ *   sequence number and the checksums fixed up, and FIN/PSH only on the
+ *   last one.
  *
  * Input Parameters:
- *   upper - Reference to the upper half driver structure
+ *   dev - Reference to the NuttX driver state structure
+ *   pkt - The GSO packet, released on success
+ *   mss - The maximum payload of a segment
+ *
+ * Returned Value:
+ *   OK on success, or a negated errno value on failure, in which case the
+ *   caller still owns the packet.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
+#ifdef CONFIG_NET_GSO
+static int netdev_upper_gso(FAR struct net_driver_s *dev,
+                            FAR netpkt_t *pkt, uint16_t mss)
 {
-  FAR struct net_driver_s *dev = &upper->lower->netdev;
-
-  /* Ignore the notification if the interface is not yet up */
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR uint8_t                   *l3;
+  FAR struct tcp_hdr_s          *tcp;
+  FAR netpkt_t                  *seg;
+  uint8_t                        hdr[NETDEV_GSO_HDRSIZE] aligned_data(4);
+  unsigned int                   llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int                   iphdrlen;
+  unsigned int                   hdrlen;
+  unsigned int                   datalen;
+  unsigned int                   offset;
+  unsigned int                   seglen;
+  uint32_t                       seqno;
+  uint16_t                       ipid = 0;
+  uint8_t                        tcpflags;
+  uint8_t                        proto;
+  int                            ret;
 
-  netdev_lock(dev);
-  if (IFF_IS_UP(dev->d_flags) && !upper->txing)
+  datalen = netpkt_getdatalen(lower, pkt);
+  hdrlen  = MIN(datalen, sizeof(hdr));
+  ret     = netpkt_copyout(lower, hdr, pkt, hdrlen, 0);
+  if (ret < 0)
     {
-      DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
-      upper->txing = true;
-      while (netdev_upper_can_tx(upper) &&
-             netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
-      upper->txing = false;
+      return ret;
     }
 
-  netdev_unlock(dev);
-}
-
-/****************************************************************************
- * Name: netdev_upper_queue_tx
- *
- * Description:
- *   Queue a TX packet to the upper half for sending later.
- *
- * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
- *
- * Assumptions:
- *   Called with the network locked.
- *
- ****************************************************************************/
-
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
-static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
-{
-#if CONFIG_IOB_NCHAINS > 0
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  int ret;
-
-  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+  l3 = hdr + llhdrlen;
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] >> 4) == 4)
     {
-      netdev_iob_clear(dev);
-      netdev_upper_txavail(dev);
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto    = ipv4->proto;
+      ipid     = ((uint16_t)ipv4->ipid[0] << 8) | ipv4->ipid[1];
     }
   else
+#endif
     {
-      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
-    }
+#ifdef CONFIG_NET_IPv6
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ((FAR struct ipv6_hdr_s *)l3)->proto;
 #else
-  /* Fall back to send the packet directly if we don't have IOB queue. */
-
-  netdev_upper_txpoll(dev);
-#endif
-}
+      return -EMSGSIZE;
 #endif
+    }
 
-/****************************************************************************
- * Name: netdev_upper_vlan_dev
- *
- * Description:
- *   Get the VLAN device for the VID.
- *
- * Input Parameters:
- *   upper - Reference to the upper half driver structure
+  tcp = (FAR struct tcp_hdr_s *)(l3 + iphdrlen);
+  if (proto != IP_PROTO_TCP ||
+      llhdrlen + iphdrlen + TCP_HDRLEN > hdrlen ||
+      llhdrlen + iphdrlen + ((tcp->tcpoffset >> 4) << 2) > hdrlen)
+    {
+      nerr("ERROR: Not a TCP packet, cannot segment\n");
+      return -EMSGSIZE;
+    }
+
+  hdrlen   = llhdrlen + iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  tcpflags = tcp->flags;
+  seqno    = ((uint32_t)tcp->seqno[0] << 24) |
+             ((uint32_t)tcp->seqno[1] << 16) |
+             ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+
+  for (offset = 0; hdrlen + offset < datalen; offset += seglen)
+    {
+      uint32_t seq = seqno + offset;
+      unsigned int l3len;
+
+      seglen = MIN(mss, datalen - hdrlen - offset);
+      l3len  = hdrlen - llhdrlen + seglen;
+
+      /* Fix up the headers of this segment */
+
+      tcp->seqno[0] = seq >> 24;
+      tcp->seqno[1] = seq >> 16;
+      tcp->seqno[2] = seq >> 8;
+      tcp->seqno[3] = seq;
+      tcp->flags    = tcpflags;
+      if (hdrlen + offset + seglen < datalen)
+        {
+          tcp->flags &= ~(TCP_FIN | TCP_PSH);
+        }
+
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_IPv4
+      if ((l3[0] >> 4) == 4)
+        {
+          FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+          ipv4->len[0]   = l3len >> 8;
+          ipv4->len[1]   = l3len & 0xff;
+          ipv4->ipid[0]  = ipid >> 8;
+          ipv4->ipid[1]  = ipid & 0xff;
+          ipv4->ipchksum = 0;
+          ipv4->ipchksum = ~ipv4_chksum(ipv4);
+          ipid++;
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if ((l3[0] >> 4) == 6)
+        {
+          FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+          ipv6->len[0] = (l3len - IPv6_HDRLEN) >> 8;
+          ipv6->len[1] = (l3len - IPv6_HDRLEN) & 0xff;
+        }
+#endif
+
+      /* Build the segment: the headers, then the slice of the payload */
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      ret = netpkt_copyin(lower, seg, hdr, hdrlen, 0);
+      if (ret >= 0)
+        {
+          ret = iob_clone_partial(pkt, seglen, hdrlen - llhdrlen + offset,
+                                  seg, hdrlen - llhdrlen, false, false);
+        }
+
+      if (ret < 0)
+        {
+          iob_free_chain(seg);
+          return ret;
+        }
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      seg->io_csum = pkt->io_csum;
+#endif
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+        {
+          uint16_t chksum = 0;
+
+          /* The checksum helpers work on the device buffer */
+
+          dev->d_iob = seg;
+#  ifdef CONFIG_NET_IPv4
+          if ((l3[0] >> 4) == 4)
+            {
+              chksum = ~ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
+            }
+#  endif
+
+#  ifdef CONFIG_NET_IPv6
+          if ((l3[0] >> 4) == 6)
+            {
+              chksum = ~ipv6_upperlayer_chksum(dev, IP_PROTO_TCP,
+                                               IPv6_HDRLEN);
+            }
+#  endif
+
+          dev->d_iob = NULL;
+          iob_copyin(seg, (FAR const uint8_t *)&chksum, sizeof(chksum),
+                     iphdrlen + offsetof(struct tcp_hdr_s, tcpchksum),
+                     false);
+        }
+#endif
+
+      /* Like netpkt_get(), allow temporarily exceeding the quota */
+
+      atomic_fetch_sub(&lower->quota_ptr[NETPKT_TX], 1);
+      ret = netdev_upper_transmit(dev, seg);
+      if (ret != OK)
+        {
+          netpkt_free(lower, seg, NETPKT_TX);
+          return ret;
+        }
+    }
+
+  netpkt_free(lower, pkt, NETPKT_TX);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_txpoll
+ *
+ * Description:
+ *   The transmitter is available, check if the network has any outgoing
+ *   packets ready to send.  This is a callback from devif_poll().
+ *   devif_poll() may be called:
+ *
+ *   1. When the preceding TX packet send is complete
+ *   2. When the preceding TX packet send times out and the interface is
+ *      reset
+ *   3. During normal TX polling
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t                  *pkt;
+  int                            ret;
+
+  DEBUGASSERT(dev->d_len > 0);
+
+  NETDEV_TXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the tx frame into it */
+
+  pkt_input(dev);
+#endif
+
+  pkt = netpkt_get(dev, NETPKT_TX);
+
+#ifdef CONFIG_NET_GSO
+  /* d_gso_size may be left over from a GSO packet that was replaced on
+   * its way here (e.g. by an ARP request), only keep it for a real one.
+   */
+
+  if (netpkt_getdatalen(lower, pkt) <= NETDEV_PKTSIZE(dev))
+    {
+      dev->d_gso_size = 0;
+    }
+
+  if (dev->d_gso_size != 0)
+    {
+      if ((dev->d_features & NETDEV_TX_TSO) != 0)
+        {
+          ret = netdev_upper_transmit(dev, pkt);
+        }
+      else
+        {
+          ret = netdev_upper_gso(dev, pkt, dev->d_gso_size);
+        }
+
+      dev->d_gso_size = 0;
+    }
+  else
+#endif
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+    {
+      nerr("ERROR: Packet too long to send!\n");
+      ret = -EMSGSIZE;
+    }
+  else
+    {
+      ret = netdev_upper_transmit(dev, pkt);
+    }
+
+  if (ret != OK)
+    {
+      /* Stop polling on any error
+       * REVISIT: maybe store the pkt in upper half and retry later?
+       */
+
+      NETDEV_TXERRORS(dev);
+      nerr("ERROR: Transmit failed: %d\n", ret);
+      netpkt_put(dev, pkt, NETPKT_TX);
+      return ret;
+    }
+
+  return NETDEV_TX_CONTINUE;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_tx
+ *
+ * Description:
+ *   Do the actual transmission of packets, including pre-queued packets and
+ *   packets from the network stack.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   Negated errno value - Error number that occurs.
+ *   NETDEV_TX_CONTINUE  - Driver can send more, continue the poll.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  if (!IOB_QEMPTY(&upper->txq))
+    {
+      /* Put the packet back to the device */
+
+      netdev_iob_replace_l2(dev, iob_remove_queue(&upper->txq));
+      return netdev_upper_txpoll(dev);
+    }
+#endif
+
+  /* No more TX packets in queue, poll the net stack to get more packets */
+
+  return devif_poll(dev, netdev_upper_txpoll);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_txavail_work
+ *
+ * Description:
+ *   Perform an out-of-cycle tx poll on the worker thread.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  /* Ignore the notification if the interface is not yet up */
+
+  netdev_lock(dev);
+  if (IFF_IS_UP(dev->d_flags) && !upper->txing)
+    {
+      DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
+      upper->txing = true;
+      while (netdev_upper_can_tx(upper) &&
+             netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
+      upper->txing = false;
+    }
+
+  netdev_unlock(dev);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_queue_tx
+ *
+ * Description:
+ *   Queue a TX packet to the upper half for sending later.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
+static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
+{
+#if CONFIG_IOB_NCHAINS > 0
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
+
+  if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
+    {
+      netdev_iob_clear(dev);
+      netdev_upper_txavail(dev);
+    }
+  else
+    {
+      nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
+    }
+#else
+  /* Fall back to send the packet directly if we don't have IOB queue. */
+
+  netdev_upper_txpoll(dev);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_vlan_dev
+ *
+ * Description:
+ *   Get the VLAN device for the VID.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
  *   vid   - VLAN ID
  *
  * Returned Value:
@@ -449,243 +1019,675 @@ static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_VLAN
-static FAR struct netdev_lowerhalf_s *
-netdev_upper_vlan_dev(FAR struct netdev_upperhalf_s *upper, uint16_t vid)
-{
-  int i;
+#ifdef CONFIG_NET_VLAN
+static FAR struct netdev_lowerhalf_s *
+netdev_upper_vlan_dev(FAR struct netdev_upperhalf_s *upper, uint16_t vid)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+    {
+      if (upper->vlan[i].vid == vid)
+        {
+          return upper->vlan[i].dev;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_vlan_foreach
+ *
+ * Description:
+ *   Call the callback for each VLAN device.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   cb    - The callback function
+ *
+ ****************************************************************************/
+
+static void
+netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
+                          CODE void (*cb)(FAR struct netdev_lowerhalf_s *))
+{
+  int i;
+
+  net_lock();
+  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+    {
+      if (upper->vlan[i].dev)
+        {
+          cb(upper->vlan[i].dev);
+        }
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: eth_input
+ *
+ * Description:
+ *   Handle L2 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+static void eth_input(FAR struct net_driver_s *dev)
+{
+  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+
+  /* Check if this is an 802.1Q VLAN tagged packet */
+
+#ifdef CONFIG_NET_VLAN
+  if (eth_hdr->type == HTONS(ETHERTYPE_VLAN))
+    {
+      FAR struct netdev_upperhalf_s *upper = dev->d_private;
+      FAR struct netdev_lowerhalf_s *vlan;
+      FAR struct eth_8021qhdr_s *vlan_hdr = NETLLBUF;
+      uint16_t vid = NTOHS(vlan_hdr->tci) & VLAN_VID_MASK;
+
+      vlan = netdev_upper_vlan_dev(upper, vid);
+      if (vlan)
+        {
+          /* Need to remove the 4 octet VLAN Tag, by moving src and dest
+           * addresses 4 octets to the right, and then read the actual
+           * ethertype.
+           */
+
+          netdev_lock(&vlan->netdev);
+          memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
+                  offsetof(struct eth_hdr_s, type));
+          netdev_iob_release(&vlan->netdev);
+          vlan->netdev.d_iob = iob_trimhead(dev->d_iob, 4);
+          vlan->netdev.d_len = dev->d_len - 4;
+          netdev_iob_clear(dev);
+
+          /* Then call eth_input again with the new dev */
+
+#ifdef CONFIG_NET_PKT
+          pkt_input(&vlan->netdev);
+#endif
+          eth_input(&vlan->netdev);
+          netdev_unlock(&vlan->netdev);
+        }
+      else
+        {
+          ninfo("INFO: Dropped, unknown vlan id: %d\n", vid);
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+        }
+    }
+  else
+#endif
+
+  /* We only accept IP packets of the configured type and ARP packets */
+
+#ifdef CONFIG_NET_IPv4
+  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_ARP
+  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
+    {
+      ninfo("ARP frame\n");
+      NETDEV_RXARP(dev);
+
+      /* Handle ARP packet */
+
+      arp_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+      netdev_iob_release(dev);
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ip_input
+ *
+ * Description:
+ *   Handle L3 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MBIM
+static void ip_input(FAR struct net_driver_s *dev)
+{
+  /* We only accept IP packets of the configured type */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
 
-  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
     {
-      if (upper->vlan[i].vid == vid)
-        {
-          return upper->vlan[i].dev;
-        }
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
     }
 
-  return NULL;
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
 }
+#endif
 
 /****************************************************************************
- * Name: netdev_upper_vlan_foreach
+ * Name: netdev_upper_input
  *
  * Description:
- *   Call the callback for each VLAN device.
+ *   Hand one received packet to the network stack.
  *
  * Input Parameters:
- *   upper - Reference to the upper half driver structure
- *   cb    - The callback function
+ *   dev - Reference to the NuttX network driver state structure
+ *   pkt - The received packet
+ *
+ * Assumptions:
+ *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void
-netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
-                          CODE void (*cb)(FAR struct netdev_lowerhalf_s *))
+static void netdev_upper_input(FAR struct net_driver_s *dev,
+                               FAR netpkt_t *pkt)
 {
-  int i;
+  netpkt_put(dev, pkt, NETPKT_RX);
 
-  net_lock();
-  for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
     {
-      if (upper->vlan[i].dev)
-        {
-          cb(upper->vlan[i].dev);
-        }
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
     }
+}
 
-  net_unlock();
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Name: netdev_upper_gro_seqno
+ *
+ * Description:
+ *   Read the sequence number of a TCP header.
+ *
+ ****************************************************************************/
+
+static inline uint32_t
+netdev_upper_gro_seqno(FAR const struct tcp_hdr_s *tcp)
+{
+  return ((uint32_t)tcp->seqno[0] << 24) | ((uint32_t)tcp->seqno[1] << 16) |
+         ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
 }
-#endif
 
 /****************************************************************************
- * Name: eth_input
+ * Name: netdev_upper_gro_hdrlen
  *
  * Description:
- *   Handle L2 packet input.
+ *   Check whether a received packet may be coalesced: an untagged IPv4
+ *   (without options or fragmentation) or IPv6 TCP segment carrying data,
+ *   with only ACK and maybe PSH set, and with all of its headers in the
+ *   first IOB.  Unless the hardware did it, the checksums are verified
+ *   here, since a merged packet is not checked again by the stack.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   dev      - Reference to the NuttX network driver state structure
+ *   pkt      - The received packet, not yet relayed to dev
+ *   iphdrlen - Returns the length of the IP header
  *
- * Assumptions:
- *   Called with the network locked.
+ * Returned Value:
+ *   The length of the IP and TCP headers, or zero if the packet must be
+ *   passed up on its own.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-static void eth_input(FAR struct net_driver_s *dev)
+static unsigned int netdev_upper_gro_hdrlen(FAR struct net_driver_s *dev,
+                                            FAR netpkt_t *pkt,
+                                            FAR uint16_t *iphdrlen)
 {
-  FAR struct eth_hdr_s *eth_hdr = (FAR struct eth_hdr_s *)NETLLBUF;
+  FAR uint8_t          *l3 = IOB_DATA(pkt);
+  FAR struct eth_hdr_s *eth;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int          tcphdrlen;
+  unsigned int          l3len;
+  bool                  verified;
+
+  verified = (dev->d_features & NETDEV_RX_CSUM) != 0;
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  verified |= (pkt->io_csum & IOB_CSUM_VERIFIED) != 0;
+#endif
 
-  /* Check if this is an 802.1Q VLAN tagged packet */
+  if (dev->d_lltype != NET_LL_ETHERNET &&
+      dev->d_lltype != NET_LL_IEEE80211)
+    {
+      return 0;
+    }
 
-#ifdef CONFIG_NET_VLAN
-  if (eth_hdr->type == HTONS(ETHERTYPE_VLAN))
+  eth = (FAR struct eth_hdr_s *)(l3 - ETH_HDRLEN);
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
     {
-      FAR struct netdev_upperhalf_s *upper = dev->d_private;
-      FAR struct netdev_lowerhalf_s *vlan;
-      FAR struct eth_8021qhdr_s *vlan_hdr = NETLLBUF;
-      uint16_t vid = NTOHS(vlan_hdr->tci) & VLAN_VID_MASK;
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
 
-      vlan = netdev_upper_vlan_dev(upper, vid);
-      if (vlan)
+      if (pkt->io_len < IPv4_HDRLEN ||
+          ipv4->vhl != (IPv4_VERSION | (IPv4_HDRLEN >> 2)) ||
+          ipv4->proto != IP_PROTO_TCP ||
+          (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
         {
-          /* Need to remove the 4 octet VLAN Tag, by moving src and dest
-           * addresses 4 octets to the right, and then read the actual
-           * ethertype.
-           */
+          return 0;
+        }
 
-          netdev_lock(&vlan->netdev);
-          memmove((FAR uint8_t *)eth_hdr + 4, eth_hdr,
-                  offsetof(struct eth_hdr_s, type));
-          netdev_iob_release(&vlan->netdev);
-          vlan->netdev.d_iob = iob_trimhead(dev->d_iob, 4);
-          vlan->netdev.d_len = dev->d_len - 4;
-          netdev_iob_clear(dev);
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      if (!verified && ipv4_chksum(ipv4) != 0xffff)
+        {
+          return 0;
+        }
+#endif
 
-          /* Then call eth_input again with the new dev */
+      *iphdrlen = IPv4_HDRLEN;
+      l3len    = ((uint16_t)ipv4->len[0] << 8) | ipv4->len[1];
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
 
-#ifdef CONFIG_NET_PKT
-          pkt_input(&vlan->netdev);
+      if (pkt->io_len < IPv6_HDRLEN || ipv6->proto != IP_PROTO_TCP)
+        {
+          return 0;
+        }
+
+      *iphdrlen = IPv6_HDRLEN;
+      l3len    = (((uint16_t)ipv6->len[0] << 8) | ipv6->len[1]) +
+                 IPv6_HDRLEN;
+    }
+  else
 #endif
-          eth_input(&vlan->netdev);
-          netdev_unlock(&vlan->netdev);
+    {
+      return 0;
+    }
+
+  if (pkt->io_len < *iphdrlen + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  tcp       = (FAR struct tcp_hdr_s *)(l3 + *iphdrlen);
+  tcphdrlen = (tcp->tcpoffset >> 4) << 2;
+
+  /* The length must be exact: a padded frame is too short to bother */
+
+  if (tcphdrlen < TCP_HDRLEN || pkt->io_len < *iphdrlen + tcphdrlen ||
+      l3len != pkt->io_pktlen || l3len <= *iphdrlen + tcphdrlen ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+  if (!verified)
+    {
+      FAR struct iob_s *iob = dev->d_iob;
+      uint16_t chksum = 0;
+
+      /* The checksum helpers work on the device buffer */
+
+      dev->d_iob = pkt;
+#  ifdef CONFIG_NET_IPv4
+      if (*iphdrlen == IPv4_HDRLEN)
+        {
+          chksum = ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
         }
-      else
+#  endif
+
+#  ifdef CONFIG_NET_IPv6
+      if (*iphdrlen == IPv6_HDRLEN)
         {
-          ninfo("INFO: Dropped, unknown vlan id: %d\n", vid);
-          NETDEV_RXDROPPED(dev);
-          dev->d_len = 0;
+          chksum = ipv6_upperlayer_chksum(dev, IP_PROTO_TCP, IPv6_HDRLEN);
+        }
+#  endif
+
+      dev->d_iob = iob;
+      if (chksum != 0xffff)
+        {
+          return 0;
         }
     }
-  else
 #endif
 
-  /* We only accept IP packets of the configured type and ARP packets */
+  return *iphdrlen + tcphdrlen;
+}
 
-#ifdef CONFIG_NET_IPv4
-  if (eth_hdr->type == HTONS(ETHTYPE_IP))
+/****************************************************************************
+ * Name: netdev_upper_gro_merge
+ *
+ * Description:
+ *   Append the payload of a segment to the held packet if it is the next
+ *   in-order segment of the same flow, with identical headers apart from
+ *   the lengths, the IPv4 ID, the window and the checksums.
+ *
+ * Input Parameters:
+ *   upper  - Reference to the upper half driver structure
+ *   pkt    - A segment accepted by netdev_upper_gro_hdrlen()
+ *   hdrlen - The IP and TCP header length of pkt
+ *
+ * Returned Value:
+ *   true if pkt was merged and consumed, false if it was left untouched.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_merge(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *pkt, unsigned int hdrlen)
+{
+  FAR netpkt_t         *head     = upper->gro_pkt;
+  FAR uint8_t          *h3       = IOB_DATA(head);
+  FAR uint8_t          *l3       = IOB_DATA(pkt);
+  unsigned int          iphdrlen = upper->gro_iphdrlen;
+  FAR struct tcp_hdr_s *htcp     = (FAR struct tcp_hdr_s *)(h3 + iphdrlen);
+  FAR struct tcp_hdr_s *tcp      = (FAR struct tcp_hdr_s *)(l3 + iphdrlen);
+  unsigned int          pktlen;
+  uint8_t               flags;
+  uint8_t               wnd[2];
+
+  pktlen = head->io_pktlen + pkt->io_pktlen - hdrlen;
+  if (hdrlen != upper->gro_hdrlen || (htcp->flags & TCP_PSH) != 0 ||
+      pktlen > CONFIG_NETDEV_GRO_MAXSIZE)
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
+      return false;
+    }
 
-      /* Receive an IPv4 packet from the network device */
+#ifdef CONFIG_NET_IPv4
+  if (iphdrlen == IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *h4 = (FAR struct ipv4_hdr_s *)h3;
+      FAR struct ipv4_hdr_s *l4 = (FAR struct ipv4_hdr_s *)l3;
 
-      ipv4_input(dev);
+      if (h4->tos != l4->tos || h4->ttl != l4->ttl ||
+          h4->ipoffset[0] != l4->ipoffset[0] ||
+          memcmp(h4->srcipaddr, l4->srcipaddr,
+                 2 * sizeof(in_addr_t)) != 0)
+        {
+          return false;
+        }
     }
-  else
 #endif
+
 #ifdef CONFIG_NET_IPv6
-  if (eth_hdr->type == HTONS(ETHTYPE_IP6))
+  if (iphdrlen == IPv6_HDRLEN)
     {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
-
-      /* Give the IPv6 packet to the network layer */
+      FAR struct ipv6_hdr_s *h6 = (FAR struct ipv6_hdr_s *)h3;
+      FAR struct ipv6_hdr_s *l6 = (FAR struct ipv6_hdr_s *)l3;
 
-      ipv6_input(dev);
+      if (memcmp(h6, l6, offsetof(struct ipv6_hdr_s, len)) != 0 ||
+          h6->ttl != l6->ttl ||
+          memcmp(h6->srcipaddr, l6->srcipaddr,
+                 2 * sizeof(net_ipv6addr_t)) != 0)
+        {
+          return false;
+        }
     }
-  else
 #endif
-#ifdef CONFIG_NET_ARP
-  if (eth_hdr->type == HTONS(ETHTYPE_ARP))
+
+  if (htcp->srcport != tcp->srcport || htcp->destport != tcp->destport ||
+      memcmp(htcp->ackno, tcp->ackno, sizeof(tcp->ackno)) != 0 ||
+      memcmp(htcp->optdata, tcp->optdata,
+             hdrlen - iphdrlen - TCP_HDRLEN) != 0 ||
+      netdev_upper_gro_seqno(tcp) != netdev_upper_gro_seqno(htcp) +
+                                     head->io_pktlen - hdrlen)
     {
-      ninfo("ARP frame\n");
-      NETDEV_RXARP(dev);
+      return false;
+    }
 
-      /* Handle ARP packet */
+  /* Take the payload, leaving the headers of the held packet in charge,
+   * and give the quota of the merged packet back.
+   */
 
-      arp_input(dev);
+  flags = tcp->flags;
+  memcpy(wnd, tcp->wnd, sizeof(wnd));
+
+  iob_concat(head, iob_trimhead(pkt, hdrlen));
+  atomic_fetch_add(&upper->lower->quota_ptr[NETPKT_RX], 1);
+  upper->gro_segs++;
+
+  htcp->flags |= flags & TCP_PSH;
+  memcpy(htcp->wnd, wnd, sizeof(wnd));
+
+#ifdef CONFIG_NET_IPv4
+  if (iphdrlen == IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *h4 = (FAR struct ipv4_hdr_s *)h3;
+
+      h4->len[0]   = pktlen >> 8;
+      h4->len[1]   = pktlen & 0xff;
+      h4->ipchksum = 0;
+      h4->ipchksum = ~ipv4_chksum(h4);
     }
-  else
 #endif
+
+#ifdef CONFIG_NET_IPv6
+  if (iphdrlen == IPv6_HDRLEN)
     {
-      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
-      netdev_iob_release(dev);
+      FAR struct ipv6_hdr_s *h6 = (FAR struct ipv6_hdr_s *)h3;
+
+      h6->len[0] = (pktlen - IPv6_HDRLEN) >> 8;
+      h6->len[1] = (pktlen - IPv6_HDRLEN) & 0xff;
     }
+#endif
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+  return true;
+}
 
-  if (dev->d_len > 0)
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Pass the held packet, if any, up to the network stack.  The segments
+ *   of a merged packet were verified one by one, so the stack is told to
+ *   skip the checksums, which no longer match.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  FAR netpkt_t            *pkt = upper->gro_pkt;
+  uint8_t                  features = dev->d_features;
+
+  if (pkt == NULL)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
+      return;
+    }
 
-      netdev_upper_queue_tx(dev);
+  upper->gro_pkt = NULL;
+  if (upper->gro_segs > 1)
+    {
+      dev->d_features |= NETDEV_RX_CSUM;
     }
+
+  netdev_upper_input(dev, pkt);
+  dev->d_features = features;
 }
-#endif
 
 /****************************************************************************
- * Name: ip_input
+ * Name: netdev_upper_gro_receive
  *
  * Description:
- *   Handle L3 packet input.
+ *   Run a received packet through GRO: consecutive in-order segments of
+ *   the same TCP flow within one RX poll are merged into one IOB chain
+ *   before they reach tcp_input(), so that the whole train costs one pass
+ *   through the stack and one ACK.  A segment with PSH, a non-matching
+ *   segment or the end of the poll flushes the held packet.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet, not yet relayed to dev
+ *
+ * Returned Value:
+ *   true if GRO took the packet, false if the caller must pass it up
+ *   itself (the held packet has been flushed first, to keep the order).
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_MBIM
-static void ip_input(FAR struct net_driver_s *dev)
+static bool netdev_upper_gro_receive(FAR struct netdev_upperhalf_s *upper,
+                                     FAR netpkt_t *pkt)
 {
-  /* We only accept IP packets of the configured type */
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int          hdrlen;
+  uint16_t              iphdrlen;
 
-#ifdef CONFIG_NET_IPv4
-  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+  hdrlen = netdev_upper_gro_hdrlen(&upper->lower->netdev, pkt, &iphdrlen);
+  if (hdrlen == 0)
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
-
-      /* Receive an IPv4 packet from the network device */
-
-      ipv4_input(dev);
+      netdev_upper_gro_flush(upper);
+      return false;
     }
-  else
-#endif
-#ifdef CONFIG_NET_IPv6
-  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
-    {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
-
-      /* Give the IPv6 packet to the network layer */
 
-      ipv6_input(dev);
-    }
-  else
-#endif
+  if (upper->gro_pkt == NULL || iphdrlen != upper->gro_iphdrlen ||
+      !netdev_upper_gro_merge(upper, pkt, hdrlen))
     {
-      ninfo("INFO: Dropped, Unknown type\n");
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
-    }
+      netdev_upper_gro_flush(upper);
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+      upper->gro_pkt      = pkt;
+      upper->gro_hdrlen   = hdrlen;
+      upper->gro_iphdrlen = iphdrlen;
+      upper->gro_segs     = 1;
+    }
 
-  if (dev->d_len > 0)
+  tcp = (FAR struct tcp_hdr_s *)(IOB_DATA(upper->gro_pkt) +
+                                 upper->gro_iphdrlen);
+  if ((tcp->flags & TCP_PSH) != 0)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
-
-      netdev_upper_queue_tx(dev);
+      netdev_upper_gro_flush(upper);
     }
+
+  return true;
 }
-#endif
+#endif /* CONFIG_NETDEV_GRO */
 
 /****************************************************************************
  * Function: netdev_upper_rxpoll_work
@@ -694,25 +1696,59 @@ static void ip_input(FAR struct net_driver_s *dev)
  *   Try to receive packets from device and pass packets into IP
  *   stack and send packets which is from IP stack if necessary.
  *
+ *   At most CONFIG_NETDEV_RX_BUDGET packets are taken in one call, all
+ *   of them under a single hold of the device lock.
+ *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   queue - The RX queue to poll, zero for a single queue device
+ *
+ * Returned Value:
+ *   true if the budget was used up and the device may still hold packets,
+ *   false if the device was drained.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     unsigned int queue)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
   FAR netpkt_t                  *pkt;
+  unsigned int                   npkts = 0;
+  bool                           more  = false;
 
   /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
   netdev_lock(dev);
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  for (; ; )
     {
+      if (CONFIG_NETDEV_RX_BUDGET > 0 && npkts >= CONFIG_NETDEV_RX_BUDGET)
+        {
+          more = true;
+          break;
+        }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+      if (lower->nqueues > 1)
+        {
+          pkt = lower->ops->receive_queue(lower, queue);
+        }
+      else
+#endif
+        {
+          pkt = lower->ops->receive(lower);
+        }
+
+      if (pkt == NULL)
+        {
+          break;
+        }
+
+      npkts++;
       if (!IFF_IS_UP(dev->d_flags))
         {
           /* Interface down, drop frame */
@@ -723,56 +1759,108 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
           continue;
         }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
       NETDEV_RXPACKETS(dev);
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
-
-      pkt_input(dev);
+#ifdef CONFIG_NET_XDP
+      if (upper->xdp[queue] != NULL &&
+          upper->xdp[queue]->rx(upper->xdp[queue], dev, pkt))
+        {
+          netpkt_free(lower, pkt, NETPKT_RX);
+          continue;
+        }
 #endif
 
-      switch (dev->d_lltype)
+#ifdef CONFIG_NETDEV_GRO
+      if (netdev_upper_gro_receive(upper, pkt))
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+          continue;
+        }
 #endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+
+      netdev_upper_input(dev, pkt);
+    }
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Nothing is held across polls */
+
+  netdev_upper_gro_flush(upper);
 #endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
+
+  if (npkts > 0)
+    {
+      NETDEV_RXBATCH(dev, npkts);
+#if CONFIG_NETDEV_RX_POOL > 0
+      netdev_upper_rxpool_reclaim(dev);
 #endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
-        }
     }
 
   netdev_unlock(dev);
+
+  /* Only let the device interrupt again once it has been drained, else
+   * the rest of the packets are left to the rescheduled poll.
+   */
+
+  if (more)
+    {
+      return true;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      if (lower->ops->rxenable_queue != NULL)
+        {
+          lower->ops->rxenable_queue(lower, queue);
+        }
+    }
+  else
+#endif
+  if (lower->ops->rxenable != NULL)
+    {
+      lower->ops->rxenable(lower);
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_poll
+ *
+ * Description:
+ *   Poll the RX queues first, first + step, ... and then TX.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   first - The first RX queue to poll
+ *   step  - The distance between the RX queues to poll
+ *
+ * Returned Value:
+ *   true if any of the RX queues used up its budget.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_poll(FAR struct netdev_upperhalf_s *upper,
+                              unsigned int first, unsigned int step)
+{
+  unsigned int queue;
+  bool more = false;
+
+  /* RX may release quota and driver buffer, so do RX first. */
+
+  for (queue = first; queue < NETDEV_NQUEUES(upper->lower); queue += step)
+    {
+      more |= netdev_upper_rxpoll_work(upper, queue);
+    }
+
+  netdev_upper_txavail_work(upper);
+  return more;
 }
 
 /****************************************************************************
  * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll of all queues on the worker thread.
  *
  * Input Parameters:
  *   arg - Reference to the upper half driver structure (cast to void *)
@@ -783,17 +1871,66 @@ static void netdev_upper_work(FAR void *arg)
 {
   FAR struct netdev_upperhalf_s *upper = arg;
 
-  /* RX may release quota and driver buffer, so do RX first. */
+  /* The RX budget was used up, come back for the rest after the others
+   * on the same work queue had a chance to run.
+   */
 
-  netdev_upper_rxpoll_work(upper);
-  netdev_upper_txavail_work(upper);
+  if (netdev_upper_poll(upper, 0, 1))
+    {
+      netdev_upper_queue_work(&upper->lower->netdev);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_queue_rxwork
+ *
+ * Description:
+ *   Perform an out-of-cycle poll of one RX queue on the worker thread.
+ *
+ * Input Parameters:
+ *   arg - Reference to the queue structure (cast to void *)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+static void netdev_upper_queue_rxwork(FAR void *arg)
+{
+  FAR struct netdev_queue_s *queue = arg;
+  FAR struct netdev_upperhalf_s *upper = queue->upper;
+
+  if (netdev_upper_poll(upper, queue->index, NETDEV_NQUEUES(upper->lower)))
+    {
+      work_queue(queue->qid, &queue->work,
+                 netdev_upper_queue_rxwork, queue, 0);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_wake_thread
+ *
+ * Description:
+ *   Wake up a dedicated thread unless it is already going to run.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_wake_thread(FAR struct netdev_thread_s *t)
+{
+  int semcount;
+
+  if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
+    {
+      nxsem_post(&t->sem);
+    }
 }
 
 /****************************************************************************
  * Name: netdev_upper_loop
  *
  * Description:
- *   The loop for dedicated thread.
+ *   The loop for dedicated thread.  In NETDEV_RX_THREAD_RSS mode, the
+ *   thread of CPU n polls the RX queues n, n + CONFIG_SMP_NCPUS, ... of a
+ *   multi-queue device.
  *
  ****************************************************************************/
 
@@ -803,6 +1940,8 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
   int cpu = atoi(argv[2]);
   FAR struct netdev_thread_s *t = &upper->thread[cpu];
+  unsigned int first = 0;
+  unsigned int step = 1;
 
   if (upper->lower->rxtype == NETDEV_RX_THREAD_RSS)
     {
@@ -811,80 +1950,244 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
       CPU_ZERO(&cpuset);
       CPU_SET(cpu, &cpuset);
       sched_setaffinity(t->tid, sizeof(cpu_set_t), &cpuset);
+
+      if (NETDEV_NQUEUES(upper->lower) > 1)
+        {
+          first = cpu;
+          step  = CONFIG_SMP_NCPUS;
+        }
+    }
+
+  while (nxsem_wait(&t->sem) == OK && t->tid != INVALID_PROCESS_ID)
+    {
+      /* The RX budget was used up, come back for the rest after the
+       * others on the same CPU had a chance to run.
+       */
+
+      if (netdev_upper_poll(upper, first, step))
+        {
+          netdev_upper_wake_thread(t);
+        }
+    }
+
+  nwarn("WARNING: Netdev work thread quitting.");
+  nxsem_post(&t->sem_exit);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_queue_work
+ *
+ * Description:
+ *   Called when there is any work to do.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ ****************************************************************************/
+
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int cpu = 0;
+
+  switch (upper->lower->rxtype)
+    {
+      case NETDEV_RX_WORK:
+        {
+          FAR struct work_s *work = upper->work;
+          if (work_available(work))
+            {
+              /* Schedule to serialize the poll on the worker thread. */
+
+              work_queue(upper->lower->priority, work, netdev_upper_work,
+                         upper, 0);
+            }
+        }
+        break;
+      case NETDEV_RX_THREAD_RSS:
+        cpu = this_cpu();
+      case NETDEV_RX_THREAD:
+        netdev_upper_wake_thread(&upper->thread[cpu]);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_txavail
+ *
+ * Description:
+ *   Called when new TX data is available.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txavail(FAR struct net_driver_s *dev)
+{
+  netdev_upper_txavail_work(dev->d_private);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_busypoll
+ *
+ * Description:
+ *   Called by a socket busy polling in receive: drain the RX queues in the
+ *   caller's context instead of waiting for the poll work or thread.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+static int netdev_upper_busypoll(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  unsigned int queue;
+
+  if (!IFF_IS_UP(dev->d_flags))
+    {
+      return -ENETDOWN;
     }
 
-  while (nxsem_wait(&t->sem) == OK && t->tid != INVALID_PROCESS_ID)
+  for (queue = 0; queue < NETDEV_NQUEUES(upper->lower); queue++)
     {
-      netdev_upper_work(upper);
+      netdev_upper_rxpoll_work(upper, queue);
     }
 
-  nwarn("WARNING: Netdev work thread quitting.");
-  nxsem_post(&t->sem_exit);
-  return 0;
+  return OK;
 }
+#endif
 
 /****************************************************************************
- * Name: netdev_upper_queue_work
+ * Name: netdev_upper_xdpattach
  *
  * Description:
- *   Called when there is any work to do.
+ *   Attach an AF_XDP hook to an RX queue, or detach it if xdp is NULL.
+ *   Once this returns, a detached hook is no longer called.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   dev   - Reference to the NuttX driver state structure
+ *   queue - The RX queue
+ *   xdp   - The hook, or NULL
+ *
+ * Returned Value:
+ *   OK on success, -EINVAL for a bad queue or -EBUSY if another hook is
+ *   attached to the queue.
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+#ifdef CONFIG_NET_XDP
+static int netdev_upper_xdpattach(FAR struct net_driver_s *dev,
+                                  unsigned int queue,
+                                  FAR struct netdev_xdp_s *xdp)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  int cpu = 0;
+  int ret = OK;
 
-  switch (upper->lower->rxtype)
+  if (queue >= NETDEV_NQUEUES(upper->lower))
     {
-      case NETDEV_RX_WORK:
-        {
-          FAR struct work_s *work = upper->work;
-          if (work_available(work))
-            {
-              /* Schedule to serialize the poll on the worker thread. */
-
-              work_queue(upper->lower->priority, work, netdev_upper_work,
-                         upper, 0);
-            }
-        }
-        break;
-      case NETDEV_RX_THREAD_RSS:
-        cpu = this_cpu();
-      case NETDEV_RX_THREAD:
-        {
-          FAR struct netdev_thread_s *t = &upper->thread[cpu];
-          int semcount;
+      return -EINVAL;
+    }
 
-          if (nxsem_get_value(&t->sem, &semcount) == OK && semcount <= 0)
-            {
-              nxsem_post(&t->sem);
-            }
-        }
-        break;
+  netdev_lock(dev);
+  if (xdp != NULL && upper->xdp[queue] != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      upper->xdp[queue] = xdp;
     }
+
+  netdev_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
- * Name: netdev_upper_txavail
+ * Name: netdev_upper_xdpxmit
  *
  * Description:
- *   Called when new TX data is available.
+ *   Send a whole L2 frame from an AF_XDP socket straight to the lower half.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   dev   - Reference to the NuttX driver state structure
+ *   queue - The TX queue to use on a multi-queue device
+ *   frame - The frame, starting with its L2 header
+ *   len   - The length of the frame
+ *
+ * Returned Value:
+ *   OK on success, -EAGAIN if out of TX buffers, or another negated errno
+ *   value on failure.
  *
  ****************************************************************************/
 
-static int netdev_upper_txavail(FAR struct net_driver_s *dev)
+static int netdev_upper_xdpxmit(FAR struct net_driver_s *dev,
+                                unsigned int queue,
+                                FAR const uint8_t *frame, unsigned int len)
 {
-  netdev_upper_txavail_work(dev->d_private);
-  return OK;
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR netpkt_t *pkt;
+  int ret;
+
+  if (len <= NET_LL_HDRLEN(dev) || len > NETDEV_PKTSIZE(dev))
+    {
+      return -EMSGSIZE;
+    }
+
+  netdev_lock(dev);
+
+  if (!IFF_IS_UP(dev->d_flags))
+    {
+      ret = -ENETDOWN;
+      goto out;
+    }
+
+  if (!netdev_upper_can_tx(upper) ||
+      (pkt = netpkt_alloc(lower, NETPKT_TX)) == NULL)
+    {
+      ret = -EAGAIN;
+      goto out;
+    }
+
+  ret = netpkt_copyin(lower, pkt, frame, len, 0);
+  if (ret < 0)
+    {
+      netpkt_free(lower, pkt, NETPKT_TX);
+      ret = -EAGAIN;
+      goto out;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (lower->nqueues > 1)
+    {
+      ret = lower->ops->transmit_queue(lower, pkt, queue % lower->nqueues);
+    }
+  else
+#endif
+    {
+      ret = lower->ops->transmit(lower, pkt);
+    }
+
+  if (ret == OK)
+    {
+      NETDEV_TXPACKETS(dev);
+    }
+  else
+    {
+      NETDEV_TXERRORS(dev);
+      netpkt_free(lower, pkt, NETPKT_TX);
+    }
+
+out:
+  netdev_unlock(dev);
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wireless_ioctl
@@ -1259,11 +2562,21 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  unsigned int queue;
+#endif
 
   switch (upper->lower->rxtype)
     {
       case NETDEV_RX_WORK:
         work_cancel_sync(upper->lower->priority, upper->work);
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+        for (queue = 0; queue < NETDEV_NQUEUES(upper->lower); queue++)
+          {
+            work_cancel_sync(upper->queue[queue].qid,
+                             &upper->queue[queue].work);
+          }
+#endif
         break;
       case NETDEV_RX_THREAD:
       case NETDEV_RX_THREAD_RSS:
@@ -1271,6 +2584,10 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
         break;
     }
 
+#if CONFIG_NETDEV_RX_POOL > 0
+  netdev_upper_rxpool_drain(upper);
+#endif
+
   if (upper->lower->ops->ifdown)
     {
       return upper->lower->ops->ifdown(upper->lower);
@@ -1371,11 +2688,36 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct netdev_upperhalf_s *upper;
   size_t extra_size;
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  unsigned int queue;
+#endif
   int cpu = 0;
   int ret;
 
-  if (dev == NULL || dev->ops == NULL ||
+  if (dev == NULL || dev->ops == NULL)
+    {
+      nerr("ERROR: Invalid lower half device\n");
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->nqueues == 0)
+    {
+      dev->nqueues = 1;
+    }
+
+  if (dev->nqueues > CONFIG_NETDEV_MAX_QUEUES)
+    {
+      nerr("ERROR: Too many queues: %u\n", dev->nqueues);
+      return -EINVAL;
+    }
+
+  if (dev->nqueues > 1 ?
+      dev->ops->transmit_queue == NULL || dev->ops->receive_queue == NULL :
       dev->ops->transmit == NULL || dev->ops->receive == NULL)
+#else
+  if (dev->ops->transmit == NULL || dev->ops->receive == NULL)
+#endif
     {
       nerr("ERROR: Invalid lower half device\n");
       return -EINVAL;
@@ -1419,6 +2761,15 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 
   upper->txing = false;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  for (queue = 0; queue < dev->nqueues; queue++)
+    {
+      upper->queue[queue].upper = upper;
+      upper->queue[queue].qid   = dev->priority;
+      upper->queue[queue].index = queue;
+    }
+#endif
+
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
@@ -1428,9 +2779,27 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #endif
 #ifdef CONFIG_NETDEV_IOCTL
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
+#endif
+#ifdef CONFIG_NET_BUSY_POLL
+  dev->netdev.d_busypoll = netdev_upper_busypoll;
+#endif
+#ifdef CONFIG_NET_XDP
+  dev->netdev.d_xdpattach = netdev_upper_xdpattach;
+  dev->netdev.d_xdpxmit   = netdev_upper_xdpxmit;
 #endif
   dev->netdev.d_private = upper;
 
+#ifdef CONFIG_NET_GSO
+  /* Large TCP packets are segmented either by the hardware or by
+   * netdev_upper_gso().
+   */
+
+  if (lltype == NET_LL_ETHERNET || lltype == NET_LL_IEEE80211)
+    {
+      dev->netdev.d_features |= NETDEV_TX_GSO;
+    }
+#endif
+
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
     {
@@ -1512,6 +2881,10 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
   iob_free_queue(&upper->txq);
 #endif
 
+#if CONFIG_NETDEV_RX_POOL > 0
+  netdev_upper_rxpool_drain(upper);
+#endif
+
   kmm_free(upper);
   dev->netdev.d_private = NULL;
 
@@ -1579,13 +2952,33 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
+  bool more;
+
   /* Note: Don't need to handle VLAN here, because RX of VLAN is handled
    * in eth_input.
    */
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (dev->nqueues > 1)
+    {
+      unsigned int queue;
+
+      for (queue = 0; queue < dev->nqueues; queue++)
+        {
+          netdev_lower_rxready_queue(dev, queue);
+        }
+    }
+  else
+#endif
   if (dev->rxtype == NETDEV_RX_DIRECT)
     {
-      netdev_upper_rxpoll_work(dev->netdev.d_private);
+      /* There is nowhere to defer to, keep polling until drained */
+
+      do
+        {
+          more = netdev_upper_rxpoll_work(dev->netdev.d_private, 0);
+        }
+      while (more);
     }
   else
     {
@@ -1593,6 +2986,90 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one RX queue of a multi-queue device.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the RX queue
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                unsigned int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(queue < NETDEV_NQUEUES(dev));
+
+  switch (dev->rxtype)
+    {
+      case NETDEV_RX_WORK:
+        {
+          FAR struct netdev_queue_s *q = &upper->queue[queue];
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+          int qid;
+#endif
+
+          if (NETDEV_NQUEUES(dev) <= 1)
+            {
+              netdev_upper_queue_work(&dev->netdev);
+            }
+          else if (work_available(&q->work))
+            {
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+              /* Poll the queue on the CPU that took its interrupt, unless
+               * the worker of that CPU is saturated.  The rescheduled
+               * polls stay on the same work queue.
+               */
+
+              if (dev->priority == HPWORK)
+                {
+                  qid = work_queue_on(-1, &q->work,
+                                      netdev_upper_queue_rxwork, q, 0);
+                  if (qid >= 0)
+                    {
+                      q->qid = qid;
+                    }
+                }
+              else
+#endif
+                {
+                  work_queue(dev->priority, &q->work,
+                             netdev_upper_queue_rxwork, q, 0);
+                }
+            }
+        }
+        break;
+      case NETDEV_RX_DIRECT:
+        while (netdev_upper_rxpoll_work(upper, queue));
+        break;
+      case NETDEV_RX_THREAD:
+        netdev_upper_wake_thread(&upper->thread[0]);
+        break;
+      case NETDEV_RX_THREAD_RSS:
+
+        /* Keep the queue, and so its flows, on the same CPU */
+
+        if (NETDEV_NQUEUES(dev) <= 1)
+          {
+            netdev_upper_queue_work(&dev->netdev);
+          }
+        else
+          {
+            netdev_upper_wake_thread(
+              &upper->thread[queue % CONFIG_SMP_NCPUS]);
+          }
+        break;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -1622,6 +3099,30 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
   NETDEV_TXDONE(&dev->netdev);
 }
 
+/****************************************************************************
+ * Name: netdev_lower_txtstamp
+ *
+ * Description:
+ *   Report the hardware transmit timestamp of a packet for which
+ *   netpkt_tstamp_requested() was true, before the packet is freed.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet that was sent
+ *   ns  - The time the packet left the wire, in ns of the NIC clock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void netdev_lower_txtstamp(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt, uint64_t ns)
+{
+  netdev_lock(&dev->netdev);
+  pkt_txtstamp(&dev->netdev, pkt, ns);
+  netdev_unlock(&dev->netdev);
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_vlan_add
  *
@@ -1729,6 +3230,15 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
       return NULL;
     }
 
+#if CONFIG_NETDEV_RX_POOL > 0
+  if (type == NETPKT_RX &&
+      (pkt = netdev_upper_rxpool_get(dev->netdev.d_private)) != NULL)
+    {
+      iob_reserve(pkt, CONFIG_NET_LL_GUARDSIZE);
+      return pkt;
+    }
+#endif
+
 #ifdef CONFIG_NET_CAN
   if (dev->netdev.d_lltype == NET_LL_CAN)
     {
@@ -1750,6 +3260,52 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
   return pkt;
 }
 
+/****************************************************************************
+ * Name: netpkt_alloc_size
+ *
+ * Description:
+ *   Allocate a netpkt structure whose first buffer holds len bytes of data
+ *   in one piece, e.g. a whole jumbo frame.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   type - Whether used for TX or RX
+ *   len  - The contiguous data length required
+ *
+ * Returned Value:
+ *   Pointer to the packet, NULL on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ALLOC
+FAR netpkt_t *netpkt_alloc_size(FAR struct netdev_lowerhalf_s *dev,
+                                enum netpkt_type_e type, uint16_t len)
+{
+  FAR netpkt_t *pkt;
+
+  if (len > UINT16_MAX - CONFIG_NET_LL_GUARDSIZE)
+    {
+      return NULL;
+    }
+
+  if (atomic_fetch_sub(&dev->quota_ptr[type], 1) <= 0)
+    {
+      atomic_fetch_add(&dev->quota_ptr[type], 1);
+      return NULL;
+    }
+
+  pkt = iob_tryalloc_size(len + CONFIG_NET_LL_GUARDSIZE, false);
+  if (pkt == NULL)
+    {
+      atomic_fetch_add(&dev->quota_ptr[type], 1);
+      return NULL;
+    }
+
+  iob_reserve(pkt, CONFIG_NET_LL_GUARDSIZE);
+  return pkt;
+}
+#endif
+
 /****************************************************************************
  * Name: netpkt_free
  *
@@ -1767,6 +3323,15 @@ void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                  enum netpkt_type_e type)
 {
   atomic_fetch_add(&dev->quota_ptr[type], 1);
+
+#if CONFIG_NETDEV_RX_POOL > 0
+  if (type == NETPKT_RX &&
+      netdev_upper_rxpool_put(dev->netdev.d_private, pkt))
+    {
+      return;
+    }
+#endif
+
   iob_free_chain(pkt);
 }
 
@@ -1895,6 +3460,33 @@ unsigned int netpkt_getdatalen(FAR struct netdev_lowerhalf_s *dev,
   return pkt->io_pktlen + NET_LL_HDRLEN(&dev->netdev);
 }
 
+/****************************************************************************
+ * Name: netpkt_gso_size
+ *
+ * Description:
+ *   Get the MSS that a TCP packet larger than the MTU must be segmented
+ *   into, for drivers that set NETDEV_TX_TSO.  Only valid for the packet
+ *   being passed to transmit(), during that call.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   The MSS of the segments, or zero if the packet is sent as it is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_GSO
+uint16_t netpkt_gso_size(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt)
+{
+  /* netdev_upper_txpoll() clears it for all but GSO packets */
+
+  return dev->netdev.d_gso_size;
+}
+#endif
+
 /****************************************************************************
  * Name: netpkt_reset_reserved
  *
@@ -34,9 +34,11 @@
 #include <errno.h>
 #include <time.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
+#include <nuttx/wdog.h>
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notelog_driver.h>
@@ -57,6 +59,12 @@
 #  error "Maximum channel number exceeds. "
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+#  define NOTE_SAMPLE_WORDS                                                  \
+  ((SIZEOF_NOTE_SAMPLE(CONFIG_SCHED_INSTRUMENTATION_SAMPLE_DEPTH) +          \
+    sizeof(uintptr_t) - 1) / sizeof(uintptr_t))
+#endif
+
 #define note_add(drv, note, notelen)                                         \
   ((drv)->ops->add(drv, note, notelen))
 #define note_start(drv, tcb)                                                 \
@@ -176,6 +184,17 @@ static struct note_taskname_s g_note_taskname;
 static spinlock_t g_note_lock;
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+static int note_sample_cpu(FAR void *arg);
+
+static struct wdog_s g_note_sample_wdog;
+static clock_t g_note_sample_period;
+#  ifdef CONFIG_SMP
+static struct smp_call_data_s g_note_sample_call =
+  SMP_CALL_INITIALIZER(note_sample_cpu, NULL);
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -562,6 +581,41 @@ static void note_record_taskname(pid_t pid, FAR const char *name)
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+/****************************************************************************
+ * Name: note_sample_cpu
+ *
+ * Description:
+ *   Take a sample on the CPU running the timer or on another CPU through
+ *   an SMP call.
+ *
+ ****************************************************************************/
+
+static int note_sample_cpu(FAR void *arg)
+{
+  sched_note_sample();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: note_sample_timer
+ ****************************************************************************/
+
+static void note_sample_timer(wdparm_t arg)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call_async(cpus, &g_note_sample_call);
+#endif
+
+  note_sample_cpu(NULL);
+  wd_start_next(&g_note_sample_wdog, g_note_sample_period,
+                note_sample_timer, 0);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1478,6 +1532,97 @@ void sched_note_heap(uint8_t event, FAR void *heap, FAR void *mem,
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+/****************************************************************************
+ * Name: sched_note_sample
+ *
+ * Description:
+ *   Record a backtrace of the thread running on this CPU.  This is called
+ *   from interrupt context, either by the sampling timer or by an
+ *   architecture specific source such as a performance counter overflow
+ *   interrupt, and the backtrace then starts at the interrupted code.
+ *
+ ****************************************************************************/
+
+void sched_note_sample(void)
+{
+  FAR struct note_driver_s **driver;
+  FAR struct note_sample_s *note;
+  uintptr_t data[NOTE_SAMPLE_WORDS];
+  bool formatted = false;
+  FAR struct tcb_s *tcb = this_task();
+  unsigned int length;
+  int depth;
+
+  note = (FAR struct note_sample_s *)data;
+  for (driver = g_note_drivers; *driver; driver++)
+    {
+      if (!note_isenabled(*driver))
+        {
+          continue;
+        }
+
+      if ((*driver)->ops->add == NULL)
+        {
+          continue;
+        }
+
+      if (!formatted)
+        {
+          formatted = true;
+          depth = up_backtrace(tcb, (FAR void **)note->nsm_pc,
+                               CONFIG_SCHED_INSTRUMENTATION_SAMPLE_DEPTH, 0);
+          if (depth <= 0)
+            {
+              return;
+            }
+
+          length = SIZEOF_NOTE_SAMPLE(depth);
+          note_common(tcb, &note->nsm_cmn, length, NOTE_SAMPLE);
+        }
+
+      /* Add the note to circular buffer */
+
+      note_add(*driver, note, length);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_note_sample_rate
+ *
+ * Description:
+ *   Start sampling all CPUs from the system timer at the given rate, or
+ *   stop if the rate is zero.  The rate cannot exceed the system tick
+ *   rate; faster sources can call sched_note_sample() directly.
+ *
+ * Input Parameters:
+ *   rate - Samples per second on each CPU, or zero
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int sched_note_sample_rate(unsigned int rate)
+{
+  clock_t period;
+
+  if (rate == 0)
+    {
+      return wd_cancel(&g_note_sample_wdog);
+    }
+
+  period = NSEC2TICK((clock_t)(NSEC_PER_SEC / rate));
+  if (period == 0)
+    {
+      return -EINVAL;
+    }
+
+  g_note_sample_period = period;
+  return wd_start(&g_note_sample_wdog, period, note_sample_timer, 0);
+}
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
 void sched_note_event_ip(uint32_t tag, uintptr_t ip, uint8_t event,
                          FAR const void *buf, size_t len)
@@ -209,6 +209,17 @@ static int notectl_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+      /* NOTECTL_SETSAMPLERATE
+       *      - Start or stop the sampling profiler
+       *        Argument: Samples per second on each CPU, 0 to stop
+       */
+
+      case NOTECTL_SETSAMPLERATE:
+        ret = sched_note_sample_rate((unsigned int)arg);
+        break;
+#endif
+
       default:
           break;
     }
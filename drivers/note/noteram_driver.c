@@ -79,10 +79,32 @@
 #  define TASK_NAME_SIZE 16
 #endif
 
+/* With CONFIG_DRIVERS_NOTERAM_PERCPU, the buffer is split into one ring per
+ * CPU.  Each CPU only ever writes to its own ring, so the CPUs no longer
+ * contend for a lock when adding notes; readers merge the rings by
+ * timestamp.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  define NOTERAM_NRINGS NCPUS
+#  define noteram_this_ring(drv) (&(drv)->ni_ring[this_cpu()])
+#else
+#  define NOTERAM_NRINGS 1
+#  define noteram_this_ring(drv) (&(drv)->ni_ring[0])
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+struct noteram_ring_s
+{
+  volatile unsigned int nr_head;
+  volatile unsigned int nr_tail;
+  volatile unsigned int nr_read;
+  spinlock_t nr_lock;
+};
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
@@ -90,10 +112,7 @@ struct noteram_driver_s
   size_t ni_bufsize;
   unsigned int ni_overwrite;
   unsigned int threshold;
-  volatile unsigned int ni_head;
-  volatile unsigned int ni_tail;
-  volatile unsigned int ni_read;
-  spinlock_t lock;
+  struct noteram_ring_s ni_ring[NOTERAM_NRINGS];
   FAR struct pollfd *pfd;
   struct notifier_block nb;
 };
@@ -196,6 +215,62 @@ struct noteram_driver_s g_noteram_driver =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: noteram_lock
+ *
+ * Description:
+ *   Disable interrupts and take the locks of all rings, for the readers
+ *   and the control interfaces.  Writers only take the lock of their own
+ *   ring.
+ *
+ ****************************************************************************/
+
+static irqstate_t noteram_lock(FAR struct noteram_driver_s *drv)
+{
+  irqstate_t flags = up_irq_save();
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      spin_lock_notrace(&drv->ni_ring[i].nr_lock);
+    }
+
+  return flags;
+}
+
+static void noteram_unlock(FAR struct noteram_driver_s *drv,
+                           irqstate_t flags)
+{
+  int i;
+
+  for (i = NOTERAM_NRINGS - 1; i >= 0; i--)
+    {
+      spin_unlock_notrace(&drv->ni_ring[i].nr_lock);
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: noteram_ringsize
+ *
+ * Description:
+ *   Return the size of each ring, which is kept a multiple of the note
+ *   alignment.
+ *
+ ****************************************************************************/
+
+static inline size_t noteram_ringsize(FAR struct noteram_driver_s *drv)
+{
+  return (drv->ni_bufsize / NOTERAM_NRINGS) & ~(sizeof(uintptr_t) - 1);
+}
+
+static inline FAR uint8_t *noteram_ringbuf(FAR struct noteram_driver_s *drv,
+                                           FAR struct noteram_ring_s *ring)
+{
+  return drv->ni_buffer + (ring - drv->ni_ring) * noteram_ringsize(drv);
+}
+
 /****************************************************************************
  * Name: noteram_buffer_clear
  *
@@ -212,8 +287,13 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
-  drv->ni_tail = drv->ni_head;
-  drv->ni_read = drv->ni_head;
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].nr_tail = drv->ni_ring[i].nr_head;
+      drv->ni_ring[i].nr_read = drv->ni_ring[i].nr_head;
+    }
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -240,10 +320,12 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
                                         unsigned int ndx,
                                         unsigned int offset)
 {
+  size_t ringsize = noteram_ringsize(drv);
+
   ndx += offset;
-  if (ndx >= drv->ni_bufsize)
+  if (ndx >= ringsize)
     {
-      ndx -= drv->ni_bufsize;
+      ndx -= ringsize;
     }
 
   return ndx;
@@ -263,14 +345,15 @@ static inline unsigned int noteram_next(FAR struct noteram_driver_s *drv,
  *
  ****************************************************************************/
 
-static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_length(FAR struct noteram_driver_s *drv,
+                                   FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int tail = drv->ni_tail;
+  unsigned int head = ring->nr_head;
+  unsigned int tail = ring->nr_tail;
 
   if (tail > head)
     {
-      head += drv->ni_bufsize;
+      head += noteram_ringsize(drv);
     }
 
   return head - tail;
@@ -290,19 +373,53 @@ static unsigned int noteram_length(FAR struct noteram_driver_s *drv)
  *
  ****************************************************************************/
 
-static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv,
+                                          FAR struct noteram_ring_s *ring)
 {
-  unsigned int head = drv->ni_head;
-  unsigned int read = drv->ni_read;
+  unsigned int head = ring->nr_head;
+  unsigned int read = ring->nr_read;
 
   if (read > head)
     {
-      head += drv->ni_bufsize;
+      head += noteram_ringsize(drv);
     }
 
   return head - read;
 }
 
+static unsigned int noteram_unread_total(FAR struct noteram_driver_s *drv)
+{
+  unsigned int total = 0;
+  int i;
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      total += noteram_unread_length(drv, &drv->ni_ring[i]);
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: noteram_copy
+ *
+ * Description:
+ *   Copy data out of a ring, handling wraparound
+ *
+ ****************************************************************************/
+
+static void noteram_copy(FAR struct noteram_driver_s *drv,
+                         FAR struct noteram_ring_s *ring, unsigned int ndx,
+                         FAR void *dest, size_t len)
+{
+  FAR uint8_t *buffer = noteram_ringbuf(drv, ring);
+  size_t space = noteram_ringsize(drv) - ndx;
+
+  space = space < len ? space : len;
+  memcpy(dest, buffer + ndx, space);
+  memcpy((FAR uint8_t *)dest + space, buffer, len - space);
+}
+
 /****************************************************************************
  * Name: noteram_remove
  *
@@ -316,44 +433,47 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
  *   None
  *
  * Assumptions:
- *   We are within a critical section.
+ *   We hold the lock of the ring.
  *
  ****************************************************************************/
 
-static void noteram_remove(FAR struct noteram_driver_s *drv)
+static void noteram_remove(FAR struct noteram_driver_s *drv,
+                           FAR struct noteram_ring_s *ring)
 {
   unsigned int tail;
   unsigned int length;
 
   /* Get the tail index of the circular buffer */
 
-  tail = drv->ni_tail;
-  DEBUGASSERT(tail < drv->ni_bufsize);
+  tail = ring->nr_tail;
+  DEBUGASSERT(tail < noteram_ringsize(drv));
 
   /* Get the length of the note at the tail index */
 
-  length = NOTE_ALIGN(drv->ni_buffer[tail]);
-  DEBUGASSERT(length <= noteram_length(drv));
+  length = NOTE_ALIGN(noteram_ringbuf(drv, ring)[tail]);
+  DEBUGASSERT(length <= noteram_length(drv, ring));
 
   /* Increment the tail index to remove the entire note from the circular
    * buffer.
    */
 
-  if (drv->ni_read == drv->ni_tail)
+  if (ring->nr_read == ring->nr_tail)
     {
       /* The read index also needs increment. */
 
-      drv->ni_read = noteram_next(drv, tail, length);
+      ring->nr_read = noteram_next(drv, tail, length);
     }
 
-  drv->ni_tail = noteram_next(drv, tail, length);
+  ring->nr_tail = noteram_next(drv, tail, length);
 }
 
 /****************************************************************************
  * Name: noteram_get
  *
  * Description:
- *   Get the next note from the read index of the circular buffer.
+ *   Get the next note from the read index of the circular buffer.  With
+ *   several rings, this is the oldest of the unread notes at the read
+ *   index of each ring.
  *
  * Input Parameters:
  *   buffer - Location to return the next note
@@ -364,37 +484,63 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
  *   provided.  Zero is returned only if the circular buffer is empty.  A
  *   negated errno value is returned in the event of any failure.
  *
+ * Assumptions:
+ *   We hold the locks of all rings.
+ *
  ****************************************************************************/
 
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
-  unsigned int remaining;
+  FAR struct noteram_ring_s *ring = NULL;
+  struct note_common_s note;
   unsigned int read;
   ssize_t notelen;
-  size_t circlen;
+  size_t circlen = 0;
+  clock_t systime = 0;
+  int i;
 
   DEBUGASSERT(buffer != NULL);
 
+  /* Find the ring with the oldest unread note */
+
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      FAR struct noteram_ring_s *candidate = &drv->ni_ring[i];
+      size_t len = noteram_unread_length(drv, candidate);
+
+      if (len == 0)
+        {
+          continue;
+        }
+
+      noteram_copy(drv, candidate, candidate->nr_read, &note,
+                   sizeof(note));
+      if (ring == NULL || (sclock_t)(note.nc_systime - systime) < 0)
+        {
+          ring    = candidate;
+          circlen = len;
+          systime = note.nc_systime;
+        }
+    }
+
   /* Verify that the circular buffer is not empty */
 
-  circlen = noteram_unread_length(drv);
-  if (circlen <= 0)
+  if (ring == NULL)
     {
       return 0;
     }
 
   /* Get the read index of the circular buffer */
 
-  read = drv->ni_read;
-  DEBUGASSERT(read < drv->ni_bufsize);
+  read = ring->nr_read;
+  DEBUGASSERT(read < noteram_ringsize(drv));
 
   /* Get the length of the note at the read index */
 
-  note = (FAR struct note_common_s *)&drv->ni_buffer[read];
-  notelen = note->nc_length;
+  notelen = noteram_ringbuf(drv, ring)[read];
   DEBUGASSERT(notelen <= circlen);
+  UNUSED(circlen);
 
   /* Is the user buffer large enough to hold the note? */
 
@@ -402,29 +548,17 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
     {
       /* Skip the large note so that we do not get constipated. */
 
-      drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
+      ring->nr_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
 
       /* and return an error */
 
       return -EFBIG;
     }
 
-  /* Loop until the note has been transferred to the user buffer */
-
-  remaining = (unsigned int)notelen;
-  while (remaining > 0)
-    {
-      /* Copy the next byte at the read index */
-
-      *buffer++ = drv->ni_buffer[read];
-
-      /* Adjust indices and counts */
+  /* Transfer the note to the user buffer */
 
-      read = noteram_next(drv, read, 1);
-      remaining--;
-    }
-
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
+  noteram_copy(drv, ring, read, buffer, notelen);
+  ring->nr_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
 
   return notelen;
 }
@@ -438,10 +572,15 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+  int i;
 
   /* Reset the read index of the circular buffer */
 
-  drv->ni_read = drv->ni_tail;
+  for (i = 0; i < NOTERAM_NRINGS; i++)
+    {
+      drv->ni_ring[i].nr_read = drv->ni_ring[i].nr_tail;
+    }
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -478,9 +617,9 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 
   if (ctx->mode == NOTERAM_MODE_READ_BINARY)
     {
-      flags = spin_lock_irqsave_notrace(&drv->lock);
+      flags = noteram_lock(drv);
       ret = noteram_get(drv, (FAR uint8_t *)buffer, buflen);
-      spin_unlock_irqrestore_notrace(&drv->lock, flags);
+      noteram_unlock(drv, flags);
     }
   else
     {
@@ -492,9 +631,9 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
 
           /* Get the next note (removing it from the buffer) */
 
-          flags = spin_lock_irqsave_notrace(&drv->lock);
+          flags = noteram_lock(drv);
           ret = noteram_get(drv, note, sizeof(note));
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
+          noteram_unlock(drv, flags);
           if (ret <= 0)
             {
               return ret;
@@ -519,7 +658,7 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   int ret = -ENOSYS;
   FAR struct noteram_driver_s *drv = filep->f_inode->i_private;
-  irqstate_t flags = spin_lock_irqsave_notrace(&drv->lock);
+  irqstate_t flags = noteram_lock(drv);
 
   /* Handle the ioctl commands */
 
@@ -614,7 +753,7 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           }
         else
           {
-            *(FAR unsigned int *)arg = noteram_unread_length(drv);
+            *(FAR unsigned int *)arg = noteram_unread_total(drv);
             ret = OK;
           }
         break;
@@ -628,7 +767,7 @@ static int noteram_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           break;
     }
 
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  noteram_unlock(drv, flags);
   return ret;
 }
 
@@ -650,7 +789,7 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
   DEBUGASSERT(inode != NULL && inode->i_private != NULL);
   drv = inode->i_private;
 
-  flags = spin_lock_irqsave_notrace(&drv->lock);
+  flags = noteram_lock(drv);
 
   /* Ignore waits that do not include POLLIN */
 
@@ -681,9 +820,9 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * don't wait for RX.
        */
 
-      if (noteram_unread_length(drv) >= drv->threshold)
+      if (noteram_unread_total(drv) >= drv->threshold)
         {
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
+          noteram_unlock(drv, flags);
           poll_notify(&drv->pfd, 1, POLLIN);
           return ret;
         }
@@ -694,7 +833,7 @@ static int noteram_poll(FAR struct file *filep, FAR struct pollfd *fds,
     }
 
 errout:
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  noteram_unlock(drv, flags);
   return ret;
 }
 
@@ -721,21 +860,29 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_ring_s *ring;
+  FAR uint8_t *buffer;
+  size_t ringsize = noteram_ringsize(drv);
   unsigned int head;
   unsigned int remain;
   unsigned int space;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave_notrace(&drv->lock);
+  /* Only this CPU writes to its ring, so the lock is only ever contended
+   * by a reader.
+   */
+
+  flags = up_irq_save();
+  ring = noteram_this_ring(drv);
+  spin_lock_notrace(&ring->nr_lock);
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
-      spin_unlock_irqrestore_notrace(&drv->lock, flags);
-      return;
+      goto out;
     }
 
-  DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
-  remain = drv->ni_bufsize - noteram_length(drv);
+  DEBUGASSERT(note != NULL && notelen < ringsize);
+  remain = ringsize - noteram_length(drv, ring);
 
   if (remain <= NOTE_ALIGN(notelen))
     {
@@ -744,8 +891,7 @@ static void noteram_add(FAR struct note_driver_s *driver,
           /* Stop recording if not in overwrite mode */
 
           drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
-          spin_unlock_irqrestore_notrace(&drv->lock, flags);
-          return;
+          goto out;
         }
 
       /* Remove the note at the tail index , make sure there is enough space
@@ -753,21 +899,25 @@ static void noteram_add(FAR struct note_driver_s *driver,
 
       do
         {
-          noteram_remove(drv);
-          remain = drv->ni_bufsize - noteram_length(drv);
+          noteram_remove(drv, ring);
+          remain = ringsize - noteram_length(drv, ring);
         }
       while (remain <= NOTE_ALIGN(notelen));
     }
 
-  head = drv->ni_head;
-  space = drv->ni_bufsize - head;
+  buffer = noteram_ringbuf(drv, ring);
+  head = ring->nr_head;
+  space = ringsize - head;
   space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  memcpy(buffer + head, note, space);
+  memcpy(buffer, buf + space, notelen - space);
+  ring->nr_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+
+out:
+  spin_unlock_notrace(&ring->nr_lock);
+  up_irq_restore(flags);
 
-  if (drv->pfd && (noteram_unread_length(drv) >= drv->threshold))
+  if (drv->pfd && (noteram_unread_total(drv) >= drv->threshold))
     {
       poll_notify(&drv->pfd, 1, POLLIN);
     }
@@ -1249,6 +1399,27 @@ static int noteram_dump_one(FAR uint8_t *p, FAR struct lib_outstream_s *s,
       }
       break;
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+    case NOTE_SAMPLE:
+      {
+        FAR struct note_sample_s *nsm = (FAR struct note_sample_s *)p;
+        int depth = (note->nc_length - SIZEOF_NOTE_SAMPLE(0)) /
+                    sizeof(uintptr_t);
+
+        /* Print the stack outermost first, as in the collapsed stack
+         * format used by flame graph tools.
+         */
+
+        ret += noteram_dump_header(s, &nsm->nsm_cmn, ctx);
+        ret += lib_sprintf(s, "sched_sample: ");
+        while (depth-- > 0)
+          {
+            ret += lib_sprintf(s, "%pS%c", (FAR void *)nsm->nsm_pc[depth],
+                               depth > 0 ? ';' : '\n');
+          }
+      }
+      break;
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION_HEAP
     case NOTE_HEAP_ADD:
     case NOTE_HEAP_REMOVE:
@@ -1420,9 +1591,7 @@ noteram_initialize(FAR const char *devpath, size_t bufsize,
   drv->ni_bufsize = bufsize;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
-  drv->ni_head = 0;
-  drv->ni_tail = 0;
-  drv->ni_read = 0;
+  memset(drv->ni_ring, 0, sizeof(drv->ni_ring));
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
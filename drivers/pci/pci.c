@@ -1245,6 +1245,52 @@ static int pci_enable_msi(FAR struct pci_device_s *dev, FAR int *irq,
 }
 
 #ifdef CONFIG_PCI_MSIX
+/****************************************************************************
+ * Name: pci_get_msix_table
+ *
+ * Description:
+ *  Get the mapped address of the MSI-X table.
+ *
+ * Input Parameters:
+ *   dev     - device
+ *   msix    - MSI-X base address
+ *   tblsize - returned number of table entries
+ *
+ * Return value:
+ *   Address of the first table entry
+ *
+ ****************************************************************************/
+
+static uintptr_t pci_get_msix_table(FAR struct pci_device_s *dev,
+                                    uint8_t msix, FAR uint16_t *tblsize)
+{
+  uint16_t  flags   = 0;
+  uintptr_t tbladdr = 0;
+  uint32_t  tbl     = 0;
+
+  /* Table Size is N - 1 encoded */
+
+  pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+  *tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
+
+  /* Extract table address */
+
+  pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
+  tbladdr = pci_resource_start(dev, tbl & PCI_MSIX_TABLE_BIR);
+  tbladdr += tbl & PCI_MSIX_TABLE_OFFSET;
+
+  /* Map MSI-X table */
+
+  if (dev->bus->ctrl->ops->map)
+    {
+      tbladdr = dev->bus->ctrl->ops->map(dev->bus, tbladdr,
+                                         tbladdr + *tblsize *
+                                         PCI_MSIX_ENTRY_SIZE);
+    }
+
+  return tbladdr;
+}
+
 /****************************************************************************
  * Name: pci_disable_msi
  *
@@ -1307,18 +1353,15 @@ static void pci_disable_msix(FAR struct pci_device_s *dev, uint8_t msix,
 {
   uint16_t  flags     = 0;
   uintptr_t tbladdr   = 0;
-  uint32_t  tbloffset = 0;
-  uint32_t  tblbar    = 0;
-  uint32_t  tbl       = 0;
+  uint16_t  tblsize   = 0;
   int       i         = 0;
 
   pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
-  pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
-
-  tblbar = tbl & PCI_MSIX_TABLE_BIR;
-  tbladdr = pci_resource_start(dev, tblbar);
-  tbloffset = tbl & PCI_MSIX_TABLE_OFFSET;
-  tbladdr += tbloffset;
+  tbladdr = pci_get_msix_table(dev, msix, &tblsize);
+  if (num > tblsize)
+    {
+      num = tblsize;
+    }
 
   for (i = 0; i < num; i++)
     {
@@ -1360,10 +1403,6 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
   uint16_t  flags     = 0;
   uintptr_t mar       = 0;
   uintptr_t tbladdr   = 0;
-  uintptr_t tblend    = 0;
-  uint32_t  tbloffset = 0;
-  uint32_t  tblbar    = 0;
-  uint32_t  tbl       = 0;
   uint16_t  tblsize   = 0;
   int       i         = 0;
   int       ret       = OK;
@@ -1372,29 +1411,9 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
 
   pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
 
-  /* Table Size is N - 1 encoded */
-
-  tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
-
   /* Get MSI-X table */
 
-  pci_read_config_dword(dev, msix + PCI_MSIX_TABLE, &tbl);
-
-  /* Extract table address */
-
-  tblbar = tbl & PCI_MSIX_TABLE_BIR;
-  tbladdr = pci_resource_start(dev, tblbar);
-  tbloffset = tbl & PCI_MSIX_TABLE_OFFSET;
-  tbladdr += tbloffset;
-
-  /* Map MSI-X table */
-
-  tblend = tbladdr + tblsize * PCI_MSIX_ENTRY_SIZE;
-
-  if (dev->bus->ctrl->ops->map)
-    {
-      tbladdr = dev->bus->ctrl->ops->map(dev->bus, tbladdr, tblend);
-    }
+  tbladdr = pci_get_msix_table(dev, msix, &tblsize);
 
   /* Limit tblsize */
 
@@ -2035,6 +2054,149 @@ int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num)
     }
 }
 
+/****************************************************************************
+ * Name: pci_affinity_irq
+ *
+ * Description:
+ *   Deliver a connected MSI-X vector to a given CPU.  Controllers that
+ *   encode the destination in the message get the entry rewritten, the
+ *   others route the interrupt in the interrupt controller.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - MSI-X table entry of the vector
+ *   irq   - interrupt connected to the entry
+ *   cpu   - destination CPU
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_affinity_irq(FAR struct pci_device_s *dev, int index, int irq,
+                     int cpu)
+{
+#ifdef CONFIG_PCI_MSIX
+  uintptr_t tbladdr = 0;
+  uint16_t  tblsize = 0;
+  uintptr_t mar     = 0;
+  uint32_t  mdr     = 0;
+  uint32_t  ctrl    = 0;
+  uint8_t   msix    = 0;
+  int       ret     = OK;
+#endif
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_PCI_MSIX
+  if (dev->bus->ctrl->ops->affinity_irq != NULL)
+    {
+      pci_get_msi_base(dev, NULL, &msix);
+      if (msix == 0)
+        {
+          return -ENOTSUP;
+        }
+
+      tbladdr = pci_get_msix_table(dev, msix, &tblsize);
+      if (index < 0 || index >= tblsize)
+        {
+          return -EINVAL;
+        }
+
+      ret = dev->bus->ctrl->ops->affinity_irq(dev->bus, irq, cpu,
+                                              &mar, &mdr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The entry may only be changed while it is masked */
+
+      tbladdr += index * PCI_MSIX_ENTRY_SIZE;
+      pci_read_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL, &ctrl);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL,
+                           ctrl | PCI_MSIX_ENTRY_CTRL_MASKBIT);
+
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_LOWER_ADDR, mar);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_UPPER_ADDR,
+                           ((uint64_t)mar >> 32));
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_DATA, mdr);
+
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL, ctrl);
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_SMP
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  up_affinity_irq(irq, cpuset);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pci_mask_irq
+ *
+ * Description:
+ *   Mask or unmask a single MSI-X vector.  While masked the device only
+ *   records the pending message, which is sent on unmask.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - MSI-X table entry of the vector
+ *   mask  - true to mask the vector, false to unmask it
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_mask_irq(FAR struct pci_device_s *dev, int index, bool mask)
+{
+#ifdef CONFIG_PCI_MSIX
+  uintptr_t tbladdr = 0;
+  uint16_t  tblsize = 0;
+  uint32_t  ctrl    = 0;
+  uint8_t   msix    = 0;
+
+  pci_get_msi_base(dev, NULL, &msix);
+  if (msix == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  tbladdr = pci_get_msix_table(dev, msix, &tblsize);
+  if (index < 0 || index >= tblsize)
+    {
+      return -EINVAL;
+    }
+
+  tbladdr += index * PCI_MSIX_ENTRY_SIZE + PCI_MSIX_ENTRY_VECTOR_CTRL;
+  pci_read_mmio_dword(dev, tbladdr, &ctrl);
+  if (mask)
+    {
+      ctrl |= PCI_MSIX_ENTRY_CTRL_MASKBIT;
+    }
+  else
+    {
+      ctrl &= ~PCI_MSIX_ENTRY_CTRL_MASKBIT;
+    }
+
+  pci_write_mmio_dword(dev, tbladdr, ctrl);
+  return OK;
+#else
+  return -ENOTSUP;
+#endif
+}
+
 /****************************************************************************
  * Name: pci_enable_irq
  *
@@ -85,6 +85,41 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_rdwant
+ *
+ * Description:
+ *   Return the number of bytes a blocking read of len bytes waits for: the
+ *   low watermark, but no more than requested or than the pipe can hold.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_rdwant(FAR struct pipe_dev_s *dev, size_t len)
+{
+  size_t want = MAX(dev->d_rdlowat, 1);
+
+  want = MIN(want, dev->d_bufsize);
+  return MIN(want, len);
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdnotify
+ *
+ * Description:
+ *   Wake up the blocked readers if the pipe now holds as much data as the
+ *   least demanding of them waits for.
+ *
+ ****************************************************************************/
+
+static void pipecommon_rdnotify(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) >= dev->d_rdwant)
+    {
+      dev->d_rdwant = 0;
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -417,6 +452,10 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
   ssize_t                nread = 0;
+  size_t                 want;
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+  bool                   handoff = false;
+#endif
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -438,31 +477,91 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* Wait until the pipe holds at least the low watermark worth of data */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  for (; ; )
     {
-      /* If there are no writers on the pipe, then return end of file */
+      want = pipecommon_rdwant(dev, len);
+      if (circbuf_used(&dev->d_buffer) >= want)
+        {
+          break;
+        }
+
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+      /* Has a writer copied its data straight into our buffer? */
+
+      if (handoff && dev->d_rdfilled > 0)
+        {
+          break;
+        }
+#endif
+
+      /* If there are no writers on the pipe, then return what is left or
+       * end of file.
+       */
 
       if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
         {
-          nxrmutex_unlock(&dev->d_bflock);
-          return 0;
+          break;
         }
 
-      /* If O_NONBLOCK was set, then return EGAIN */
+      /* If O_NONBLOCK was set, then return what is available or EGAIN */
 
       if (filep->f_oflags & O_NONBLOCK)
         {
-          nxrmutex_unlock(&dev->d_bflock);
-          return -EAGAIN;
+          if (circbuf_is_empty(&dev->d_buffer))
+            {
+              nxrmutex_unlock(&dev->d_bflock);
+              return -EAGAIN;
+            }
+
+          break;
         }
 
-      /* Otherwise, wait for something to be written to the pipe */
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+      /* Offer our buffer to the writers while the pipe is empty */
+
+      if (!handoff && dev->d_rdbuf == NULL &&
+          circbuf_is_empty(&dev->d_buffer))
+        {
+          dev->d_rdbuf    = buffer;
+          dev->d_rdsize   = len;
+          dev->d_rdfilled = 0;
+          handoff         = true;
+        }
+#endif
+
+      /* Otherwise, wait for enough to be written to the pipe */
+
+      if (dev->d_rdwant == 0 || dev->d_rdwant > want)
+        {
+          dev->d_rdwant = want;
+        }
 
       nxrmutex_unlock(&dev->d_bflock);
       ret = nxsem_wait(&dev->d_rdsem);
 
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+      if (handoff)
+        {
+          /* The offered buffer must be withdrawn before returning.  That
+           * is always possible since a mutex wait is never interrupted by
+           * a signal nor canceled.
+           */
+
+          nxrmutex_lock(&dev->d_bflock);
+          if (ret < 0)
+            {
+              nread = dev->d_rdfilled;
+              dev->d_rdbuf = NULL;
+              nxrmutex_unlock(&dev->d_bflock);
+              return nread > 0 ? nread : (ssize_t)ret;
+            }
+
+          continue;
+        }
+#endif
+
       if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
         {
           /* May fail because a signal was received or if the task was
@@ -473,6 +572,30 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
         }
     }
 
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+  if (handoff)
+    {
+      dev->d_rdbuf = NULL;
+      if (dev->d_rdfilled > 0)
+        {
+          /* The data never went through the pipe buffer */
+
+          nread = dev->d_rdfilled;
+          nxrmutex_unlock(&dev->d_bflock);
+          pipe_dumpbuffer("From PIPE:", buffer, nread);
+          return nread;
+        }
+    }
+#endif
+
+  if (circbuf_is_empty(&dev->d_buffer))
+    {
+      /* End of file */
+
+      nxrmutex_unlock(&dev->d_bflock);
+      return 0;
+    }
+
   /* Then return whatever is available in the pipe (which is at least one
    * byte).
    */
@@ -566,6 +689,27 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+      /* If a reader is blocked on the empty pipe with room for all of the
+       * remaining data, and that is enough to satisfy it, copy the data
+       * straight into the reader's buffer.
+       */
+
+      if (dev->d_rdbuf != NULL && dev->d_rdsize >= len - nwritten &&
+          len - nwritten >= pipecommon_rdwant(dev, dev->d_rdsize) &&
+          circbuf_is_empty(&dev->d_buffer))
+        {
+          memcpy(dev->d_rdbuf, buffer + nwritten, len - nwritten);
+          dev->d_rdfilled = len - nwritten;
+          dev->d_rdsize   = 0;
+          dev->d_rdwant   = 0;
+
+          pipecommon_wakeup(&dev->d_rdsem);
+          nxrmutex_unlock(&dev->d_bflock);
+          return len;
+        }
+#endif
+
       /* Would the next write overflow the circular buffer? */
 
       if (!circbuf_is_full(&dev->d_buffer))
@@ -587,11 +731,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                               POLLIN);
                 }
 
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
+              /* Yes.. Notify the waiting readers if enough data is
+               * available for them.
                */
 
-              pipecommon_wakeup(&dev->d_rdsem);
+              pipecommon_rdnotify(dev);
 
               /* Return the number of bytes written */
 
@@ -614,9 +758,10 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
               poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
 
               /* Yes.. Notify all of the waiting readers that more data is
-               * available.
+               * available: the buffer is full, which is all they can get.
                */
 
+              dev->d_rdwant = 0;
               pipecommon_wakeup(&dev->d_rdsem);
             }
 
@@ -848,6 +993,30 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case PIPEIOC_SETLOWAT:
+        {
+          if (arg > dev->d_bufsize)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          dev->d_rdlowat = (pipe_ndx_t)arg;
+
+          /* Blocked readers may be satisfied by a lower watermark */
+
+          dev->d_rdwant = 0;
+          pipecommon_wakeup(&dev->d_rdsem);
+          ret = OK;
+        }
+        break;
+
+      case PIPEIOC_GETLOWAT:
+        {
+          ret = MAX(dev->d_rdlowat, 1);
+        }
+        break;
+
       case PIPEIOC_PEEK:
         {
           FAR struct pipe_peek_s *peek = (FAR struct pipe_peek_s *)arg;
@@ -877,6 +1046,11 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
             }
 
           dev->d_bufsize = size;
+
+          /* The blocked readers may be waiting for more than now fits */
+
+          dev->d_rdwant = 0;
+          pipecommon_wakeup(&dev->d_rdsem);
         }
         break;
 
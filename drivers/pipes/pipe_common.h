@@ -125,12 +125,25 @@ struct pipe_dev_s
   pipe_ndx_t       d_bufsize;     /* allocated size of d_buffer in bytes */
   pipe_ndx_t       d_pollinthrd;  /* Buffer threshold for POLLIN to occur */
   pipe_ndx_t       d_polloutthrd; /* Buffer threshold for POLLOUT to occur */
+  pipe_ndx_t       d_rdlowat;     /* Bytes a blocking read waits for */
+  pipe_ndx_t       d_rdwant;      /* Least bytes any blocked reader waits for,
+                                   * 0 if no reader is blocked */
   uint8_t          d_nwriters;    /* Number of reference counts for write access */
   uint8_t          d_nreaders;    /* Number of reference counts for read access */
   uint8_t          d_flags;       /* See PIPE_FLAG_* definitions */
   int16_t          d_crefs;       /* References to dev */
   struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
 
+#ifdef CONFIG_DEV_PIPE_HANDOFF
+  /* Buffer offered by a reader blocked on the empty pipe (NULL if none),
+   * its size (0 once filled) and the number of bytes copied into it.
+   */
+
+  FAR char        *d_rdbuf;
+  size_t           d_rdsize;
+  size_t           d_rdfilled;
+#endif
+
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
    * retained in the f_priv field of the 'struct file'.
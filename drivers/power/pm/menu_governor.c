@@ -0,0 +1,445 @@
+/****************************************************************************
+ * drivers/power/pm/menu_governor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The correction factors are fixed point ratios of the measured idle time
+ * to the time left before the next timer, averaged over about MENU_DECAY
+ * idle periods.
+ */
+
+#define MENU_RESOLUTION  1024
+#define MENU_DECAY       8
+#define MENU_UNITY       (MENU_RESOLUTION * MENU_DECAY)
+
+/* Idle periods are classed by the time left before the next timer, as the
+ * wakeup sources differ with the order of magnitude (1, 10, 100us ...).
+ */
+
+#define MENU_NBUCKETS    6
+
+/* The number of recent idle periods looked at for a repeating pattern */
+
+#define MENU_NINTERVALS  8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct menu_governor_domain_s
+{
+  /* The costs of the power states */
+
+  FAR const struct pm_idlestate_s *states;
+
+  /* Measured against expected idle time, by bucket */
+
+  uint32_t correction[MENU_NBUCKETS];
+
+  /* The last idle periods in microseconds */
+
+  uint32_t intervals[MENU_NINTERVALS];
+  unsigned int index;
+
+  /* The idle period in progress */
+
+  unsigned int bucket;
+  uint32_t next_timer;
+  clock_t start;
+  bool idle;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void menu_governor_initialize(void);
+static void menu_governor_statechanged(int domain,
+                                       enum pm_state_e newstate);
+static enum pm_state_e menu_governor_checkstate(int domain);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_menu_governor_ops =
+{
+  menu_governor_initialize,   /* initialize */
+  NULL,                       /* deinitialize */
+  menu_governor_statechanged, /* statechanged */
+  menu_governor_checkstate,   /* checkstate */
+  NULL,                       /* activity */
+  NULL                        /* priv */
+};
+
+static const struct pm_idlestate_s g_menu_governor_states[PM_COUNT] =
+{
+  {
+    0, 0
+  },
+  {
+    CONFIG_PM_GOVERNOR_MENU_IDLE_LATENCY,
+    CONFIG_PM_GOVERNOR_MENU_IDLE_RESIDENCY
+  },
+  {
+    CONFIG_PM_GOVERNOR_MENU_STANDBY_LATENCY,
+    CONFIG_PM_GOVERNOR_MENU_STANDBY_RESIDENCY
+  },
+  {
+    CONFIG_PM_GOVERNOR_MENU_SLEEP_LATENCY,
+    CONFIG_PM_GOVERNOR_MENU_SLEEP_RESIDENCY
+  },
+};
+
+static struct menu_governor_domain_s g_menu_governor[CONFIG_PM_NDOMAINS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: menu_governor_bucket
+ ****************************************************************************/
+
+static unsigned int menu_governor_bucket(uint32_t us)
+{
+  unsigned int bucket = 0;
+  uint32_t limit = 10;
+
+  while (bucket < MENU_NBUCKETS - 1 && us >= limit)
+    {
+      limit *= 10;
+      bucket++;
+    }
+
+  return bucket;
+}
+
+/****************************************************************************
+ * Name: menu_governor_typical
+ *
+ * Description:
+ *   Look for a repeating idle period in the history, as left by a periodic
+ *   interrupt that is not a timer.  The outliers above the average are
+ *   dropped one by one as long as enough samples remain.
+ *
+ * Returned Value:
+ *   The typical period in microseconds, or UINT32_MAX if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t
+menu_governor_typical(FAR struct menu_governor_domain_s *gdom)
+{
+  uint32_t thresh = UINT32_MAX;
+  uint64_t variance;
+  uint64_t avg;
+  uint32_t max;
+  int count;
+  int i;
+
+  for (; ; )
+    {
+      avg   = 0;
+      max   = 0;
+      count = 0;
+
+      for (i = 0; i < MENU_NINTERVALS; i++)
+        {
+          if (gdom->intervals[i] <= thresh)
+            {
+              avg += gdom->intervals[i];
+              count++;
+              if (gdom->intervals[i] > max)
+                {
+                  max = gdom->intervals[i];
+                }
+            }
+        }
+
+      if (count == 0)
+        {
+          return UINT32_MAX;
+        }
+
+      avg /= count;
+
+      variance = 0;
+      for (i = 0; i < MENU_NINTERVALS; i++)
+        {
+          if (gdom->intervals[i] <= thresh)
+            {
+              int64_t diff = (int64_t)gdom->intervals[i] - (int64_t)avg;
+              variance += diff * diff;
+            }
+        }
+
+      variance /= count;
+
+      /* Accept a standard deviation under a sixth of the average, or under
+       * 20us for the short periods.
+       */
+
+      if (avg * avg > variance * 36 || variance <= 400)
+        {
+          return (uint32_t)avg;
+        }
+
+      if (count * 4 <= MENU_NINTERVALS * 3)
+        {
+          return UINT32_MAX;
+        }
+
+      thresh = max - 1;
+    }
+}
+
+/****************************************************************************
+ * Name: menu_governor_update
+ *
+ * Description:
+ *   Account for an idle period that just ended.
+ *
+ ****************************************************************************/
+
+static void menu_governor_update(FAR struct menu_governor_domain_s *gdom,
+                                 uint32_t measured)
+{
+  FAR uint32_t *factor = &gdom->correction[gdom->bucket];
+
+  *factor -= *factor / MENU_DECAY;
+
+  if (measured < gdom->next_timer)
+    {
+      *factor += (uint32_t)((uint64_t)MENU_RESOLUTION * measured /
+                            gdom->next_timer);
+    }
+  else
+    {
+      *factor += MENU_RESOLUTION;
+    }
+
+  /* Never predict zero, the factor would not get back up */
+
+  if (*factor == 0)
+    {
+      *factor = 1;
+    }
+
+  gdom->intervals[gdom->index] = measured;
+  gdom->index = (gdom->index + 1) % MENU_NINTERVALS;
+}
+
+/****************************************************************************
+ * Name: menu_governor_initialize
+ ****************************************************************************/
+
+static void menu_governor_initialize(void)
+{
+  FAR struct menu_governor_domain_s *gdom;
+  int domain;
+  int i;
+
+  for (domain = 0; domain < CONFIG_PM_NDOMAINS; domain++)
+    {
+      gdom = &g_menu_governor[domain];
+
+      /* This runs again for each domain given to the governor, keep the
+       * tables set by the board.
+       */
+
+      if (gdom->states == NULL)
+        {
+          gdom->states = g_menu_governor_states;
+        }
+
+      for (i = 0; i < MENU_NBUCKETS; i++)
+        {
+          gdom->correction[i] = MENU_UNITY;
+        }
+
+      for (i = 0; i < MENU_NINTERVALS; i++)
+        {
+          gdom->intervals[i] = UINT32_MAX;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: menu_governor_statechanged
+ ****************************************************************************/
+
+static void menu_governor_statechanged(int domain,
+                                       enum pm_state_e newstate)
+{
+  FAR struct menu_governor_domain_s *gdom = &g_menu_governor[domain];
+  struct timespec ts;
+  uint64_t measured;
+
+  if (newstate != PM_RESTORE)
+    {
+      gdom->start = perf_gettime();
+      gdom->idle  = true;
+    }
+  else if (gdom->idle)
+    {
+      gdom->idle = false;
+
+      perf_convert(perf_gettime() - gdom->start, &ts);
+      measured = (uint64_t)ts.tv_sec * USEC_PER_SEC +
+                 ts.tv_nsec / NSEC_PER_USEC;
+
+      menu_governor_update(gdom, measured < UINT32_MAX ?
+                                 (uint32_t)measured : UINT32_MAX);
+    }
+}
+
+/****************************************************************************
+ * Name: menu_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e menu_governor_checkstate(int domain)
+{
+  FAR struct menu_governor_domain_s *gdom = &g_menu_governor[domain];
+  FAR struct pm_domain_s *pdom = &g_pmdomains[domain];
+  uint64_t predicted = UINT32_MAX;
+  uint64_t us = UINT32_MAX;
+  uint32_t typical;
+  uint32_t latency;
+  irqstate_t flags;
+  sclock_t next;
+  int limit;
+  int state;
+
+  latency = pm_qos_latency(domain);
+
+  /* The next timer bounds the idle period, but an interrupt usually comes
+   * earlier by a rate learnt per order of magnitude.
+   */
+
+  next = wd_getnext();
+  if (next >= 0)
+    {
+      us = TICK2USEC((uint64_t)next);
+    }
+
+  gdom->next_timer = us < UINT32_MAX ? (uint32_t)us : UINT32_MAX;
+
+  gdom->bucket = menu_governor_bucket(gdom->next_timer);
+
+  if (gdom->next_timer != UINT32_MAX)
+    {
+      predicted = (uint64_t)gdom->next_timer *
+                  gdom->correction[gdom->bucket] / MENU_UNITY;
+    }
+
+  typical = menu_governor_typical(gdom);
+  if (typical < predicted)
+    {
+      predicted = typical;
+    }
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = spin_lock_irqsave(&pdom->lock);
+
+  /* Find the lowest power-level which is not locked. */
+
+  limit = PM_NORMAL;
+  while (dq_empty(&pdom->wakelock[limit]) && limit < (PM_COUNT - 1))
+    {
+      limit++;
+    }
+
+  spin_unlock_irqrestore(&pdom->lock, flags);
+
+  /* Go as deep as the idle period pays for and the constraints allow */
+
+  for (state = PM_NORMAL; state < limit; state++)
+    {
+      if (gdom->states[state + 1].residency > predicted ||
+          gdom->states[state + 1].latency > latency)
+        {
+          break;
+        }
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_menu_governor_setstates
+ *
+ * Description:
+ *   Replace the exit latency and target residency of the power states of a
+ *   domain.
+ *
+ ****************************************************************************/
+
+void pm_menu_governor_setstates(int domain,
+                                FAR const struct pm_idlestate_s *states)
+{
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  g_menu_governor[domain].states = states != NULL ?
+                                   states : g_menu_governor_states;
+}
+
+/****************************************************************************
+ * Name: pm_menu_governor_initialize
+ *
+ * Description:
+ *   Return the menu governor instance.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_menu_governor_initialize(void)
+{
+  return &g_menu_governor_ops;
+}
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * drivers/power/pm/pm_qos.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+#ifdef CONFIG_PM_QOS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Declare the longest wakeup latency a driver can accept in a domain.
+ *
+ * Input Parameters:
+ *   qos     - The constraint, owned by the caller until pm_qos_remove()
+ *   domain  - The PM domain
+ *   latency - The latency in microseconds
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency)
+{
+  irqstate_t flags;
+
+  if (qos == NULL || domain < 0 || domain >= CONFIG_PM_NDOMAINS)
+    {
+      return -EINVAL;
+    }
+
+  qos->domain  = domain;
+  qos->latency = latency;
+
+  flags = pm_domain_lock(domain);
+  dq_addlast(&qos->node, &g_pmdomains[domain].qos);
+  pm_domain_unlock(domain, flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a constraint added with pm_qos_add().
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency)
+{
+  DEBUGASSERT(qos != NULL);
+
+  /* A single word store, the governor sees the old or the new value */
+
+  qos->latency = latency;
+}
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Drop a constraint added with pm_qos_add().
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+
+  flags = pm_domain_lock(qos->domain);
+  dq_rem(&qos->node, &g_pmdomains[qos->domain].qos);
+  pm_domain_unlock(qos->domain, flags);
+}
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the tightest latency constraint of a domain in microseconds, or
+ *   UINT32_MAX if there is none.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain)
+{
+  FAR struct pm_qos_s *qos;
+  FAR dq_entry_t *entry;
+  uint32_t latency = UINT32_MAX;
+  irqstate_t flags;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  flags = pm_domain_lock(domain);
+  for (entry = dq_peek(&g_pmdomains[domain].qos); entry != NULL;
+       entry = dq_next(entry))
+    {
+      qos = container_of(entry, struct pm_qos_s, node);
+      if (qos->latency < latency)
+        {
+          latency = qos->latency;
+        }
+    }
+
+  pm_domain_unlock(domain, flags);
+  return latency;
+}
+
+#endif /* CONFIG_PM_QOS */
@@ -81,9 +81,42 @@ struct regmap_s
 
   int reg_stride;
 
+  /* Register cache, see regmap_cache.c.  cache holds val_bytes per
+   * register from 0 to max_register, followed by the valid and the dirty
+   * bitmaps.
+   */
+
+  unsigned int max_register;
+  volatile_reg_t volatile_reg;
+  bool cache_only;
+  FAR uint8_t *cache;
+  FAR uint8_t *cache_valid;
+  FAR uint8_t *cache_dirty;
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Register cache, called with the regmap locked */
+
+int  regcache_init(FAR struct regmap_s *map,
+                   FAR const struct regmap_config_s *config);
+void regcache_exit(FAR struct regmap_s *map);
+bool regcache_cacheable(FAR struct regmap_s *map, unsigned int reg);
+bool regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                   FAR unsigned int *val);
+void regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                    unsigned int val, bool dirty);
+
+/* Raw helpers of regmap.c, called with the regmap locked */
+
+bool regmap_can_raw_write(FAR struct regmap_s *map);
+int  regmap_raw_write(FAR struct regmap_s *map, unsigned int reg,
+                      FAR const uint8_t *val, unsigned int count);
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
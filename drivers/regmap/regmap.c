@@ -28,7 +28,9 @@
 #include <nuttx/lib/math32.h>
 #include <nuttx/kmalloc.h>
 
+#include <sys/param.h>
 #include <debug.h>
+#include <string.h>
 
 #include "internal.h"
 
@@ -41,6 +43,10 @@
 
 #define REGMAP_DEFAULT_BIT 8
 
+/* Longest burst sent by regmap_raw_write() in one bus write */
+
+#define REGMAP_RAW_CHUNK 32
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -61,10 +67,139 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+static unsigned int regmap_get_val(FAR struct regmap_s *map,
+                                   FAR const void *ptr)
+{
+  switch (map->val_bytes)
+    {
+      case 4:
+        return *(FAR const uint32_t *)ptr;
+      case 2:
+        return *(FAR const uint16_t *)ptr;
+      default:
+        return *(FAR const uint8_t *)ptr;
+    }
+}
+
+static void regmap_put_val(FAR struct regmap_s *map, FAR void *ptr,
+                           unsigned int val)
+{
+  switch (map->val_bytes)
+    {
+      case 4:
+        *(FAR uint32_t *)ptr = val;
+        break;
+      case 2:
+        *(FAR uint16_t *)ptr = val;
+        break;
+      default:
+        *(FAR uint8_t *)ptr = val;
+        break;
+    }
+}
+
+/* Read and write one register with the regmap locked.  Cached registers
+ * are read from the cache, and only written to the cache while the map is
+ * in cache only mode.
+ */
+
+static int regmap_read_locked(FAR struct regmap_s *map, unsigned int reg,
+                              FAR unsigned int *val)
+{
+  unsigned int ival = 0;
+  int ret;
+
+  if (regcache_read(map, reg, val))
+    {
+      return OK;
+    }
+
+  ret = map->reg_read(map->bus, reg, &ival);
+  if (ret >= 0)
+    {
+      *val = regmap_get_val(map, &ival);
+      regcache_write(map, reg, *val, false);
+    }
+
+  return ret;
+}
+
+static int regmap_write_locked(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val)
+{
+  int ret;
+
+  if (map->cache_only && regcache_cacheable(map, reg))
+    {
+      regcache_write(map, reg, val, true);
+      return OK;
+    }
+
+  ret = map->reg_write(map->bus, reg, val);
+  if (ret >= 0)
+    {
+      regcache_write(map, reg, val, false);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: regmap_can_raw_write
+ *
+ * Description:
+ *   Return true if consecutive registers can be written with one bus write
+ *   of the register address followed by the values.
+ *
+ ****************************************************************************/
+
+bool regmap_can_raw_write(FAR struct regmap_s *map)
+{
+  return map->write != NULL && map->reg_bytes == 1 &&
+         map->val_bytes == 1 && map->reg_stride == 1;
+}
+
+/****************************************************************************
+ * Name: regmap_raw_write
+ *
+ * Description:
+ *   Write count 8-bit registers starting at reg in bursts of up to
+ *   REGMAP_RAW_CHUNK values, relying on the register address auto
+ *   increment of the device.
+ *
+ ****************************************************************************/
+
+int regmap_raw_write(FAR struct regmap_s *map, unsigned int reg,
+                     FAR const uint8_t *val, unsigned int count)
+{
+  uint8_t buf[REGMAP_RAW_CHUNK + 1];
+  unsigned int n;
+  int ret;
+
+  while (count > 0)
+    {
+      n      = MIN(count, REGMAP_RAW_CHUNK);
+      buf[0] = reg;
+      memcpy(&buf[1], val, n);
+
+      ret = map->write(map->bus, buf, n + 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      reg   += n;
+      val   += n;
+      count -= n;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: regmap_init
  *
@@ -140,6 +275,17 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+  if (regcache_init(map, config) < 0)
+    {
+      if (!config->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+
   return map;
 }
 
@@ -173,7 +319,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_locked(map, reg, val);
 
   map->unlock(map);
 
@@ -214,9 +360,15 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
-  if (map->write != NULL)
+  if (regmap_can_raw_write(map) && !map->cache_only)
     {
-      ret = map->write(map->bus, val, val_bytes * val_count);
+      ret = regmap_raw_write(map, reg, val, val_count);
+      for (i = 0; ret >= 0 && i < val_count; i++)
+        {
+          regcache_write(map, reg + i, ((FAR const uint8_t *)val)[i],
+                         false);
+        }
+
       goto out;
     }
 
@@ -239,7 +391,7 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
             goto out;
         }
 
-      ret = map->reg_write(map->bus, reg + (i * map->reg_stride), ival);
+      ret = regmap_write_locked(map, reg + (i * map->reg_stride), ival);
       if (ret < 0)
         {
           break;
@@ -274,13 +426,18 @@ out:
 
 int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 {
+  unsigned int ival;
   int ret;
 
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+  ret = regmap_read_locked(map, reg, &ival);
+  if (ret >= 0)
+    {
+      regmap_put_val(map, val, ival);
+    }
 
   map->unlock(map);
   return ret;
@@ -322,15 +479,40 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  if (map->read != NULL)
+  /* Serve the whole range from the cache if it is all cached, otherwise
+   * read it in one burst and refresh the cache.
+   */
+
+  for (i = 0; i < val_count; i++)
     {
-      ret = map->read(map->bus, &reg, map->reg_bytes, val, val_count);
+      if (!regcache_read(map, reg + (i * map->reg_stride), &ival))
+        {
+          break;
+        }
+
+      regmap_put_val(map, u8 + i * map->val_bytes, ival);
+    }
+
+  if (i == val_count)
+    {
+      ret = OK;
+    }
+  else if (map->read != NULL)
+    {
+      ret = map->read(map->bus, &reg, map->reg_bytes, val,
+                      val_count * map->val_bytes);
+      for (i = 0; ret >= 0 && i < val_count; i++)
+        {
+          regcache_write(map, reg + (i * map->reg_stride),
+                         regmap_get_val(map, u8 + i * map->val_bytes),
+                         false);
+        }
     }
   else
     {
       for (i = 0; i < val_count; i++)
         {
-          ret = map->reg_read(map->bus, reg + (i * map->reg_stride), &ival);
+          ret = regmap_read_locked(map, reg + (i * map->reg_stride), &ival);
           if (ret < 0)
             {
               break;
@@ -359,6 +541,52 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write the bits of mask in a register.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to be updated.
+ *   val  - new value of the bits in mask.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_read_locked(map, reg, &orig);
+  if (ret >= 0)
+    {
+      tmp = (orig & ~mask) | (val & mask);
+      if (tmp != orig || !regcache_cacheable(map, reg))
+        {
+          ret = regmap_write_locked(map, reg, tmp);
+        }
+      else
+        {
+          ret = OK;
+        }
+    }
+
+  map->unlock(map);
+  return ret;
+}
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -374,6 +602,8 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
 void regmap_exit(FAR struct regmap_s *map)
 {
+  regcache_exit(map);
+
   if (!map->disable_locking)
     {
       nxmutex_destroy(&map->mutex[0]);
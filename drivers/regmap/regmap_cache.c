@@ -0,0 +1,310 @@
+/****************************************************************************
+ * drivers/regmap/regmap_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/regmap/regmap.h>
+#include <nuttx/kmalloc.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include "internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define REGCACHE_BIT(map, n)   ((map)[(n) >> 3] & (1 << ((n) & 7)))
+#define REGCACHE_SET(map, n)   ((map)[(n) >> 3] |= (1 << ((n) & 7)))
+#define REGCACHE_CLR(map, n)   ((map)[(n) >> 3] &= ~(1 << ((n) & 7)))
+
+/* Longest run of registers combined into one write by regmap_cache_sync */
+
+#define REGCACHE_SYNC_RUN      32
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static unsigned int regcache_count(FAR struct regmap_s *map)
+{
+  return map->max_register / map->reg_stride + 1;
+}
+
+static unsigned int regcache_get(FAR struct regmap_s *map, unsigned int idx)
+{
+  FAR uint8_t *ptr = map->cache + idx * map->val_bytes;
+
+  switch (map->val_bytes)
+    {
+      case 4:
+        return *(FAR uint32_t *)ptr;
+      case 2:
+        return *(FAR uint16_t *)ptr;
+      default:
+        return *ptr;
+    }
+}
+
+static void regcache_set(FAR struct regmap_s *map, unsigned int idx,
+                         unsigned int val)
+{
+  FAR uint8_t *ptr = map->cache + idx * map->val_bytes;
+
+  switch (map->val_bytes)
+    {
+      case 4:
+        *(FAR uint32_t *)ptr = val;
+        break;
+      case 2:
+        *(FAR uint16_t *)ptr = val;
+        break;
+      default:
+        *ptr = val;
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ *
+ * Description:
+ *   Allocate the register cache if the configuration asks for one.
+ *
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  unsigned int count;
+  size_t bitmap;
+
+  map->max_register = config->max_register;
+  map->volatile_reg = config->volatile_reg;
+  if (map->max_register == 0)
+    {
+      return OK;
+    }
+
+  if (map->val_bytes != 1 && map->val_bytes != 2 && map->val_bytes != 4)
+    {
+      return -EINVAL;
+    }
+
+  count  = regcache_count(map);
+  bitmap = (count + 7) / 8;
+
+  map->cache = kmm_zalloc(count * map->val_bytes + 2 * bitmap);
+  if (map->cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->cache_valid = map->cache + count * map->val_bytes;
+  map->cache_dirty = map->cache_valid + bitmap;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache);
+  map->cache = NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_cacheable
+ ****************************************************************************/
+
+bool regcache_cacheable(FAR struct regmap_s *map, unsigned int reg)
+{
+  return map->cache != NULL && reg <= map->max_register &&
+         (map->volatile_reg == NULL || !map->volatile_reg(reg));
+}
+
+/****************************************************************************
+ * Name: regcache_read
+ *
+ * Description:
+ *   Return true and the cached value if reg is cached.
+ *
+ ****************************************************************************/
+
+bool regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                   FAR unsigned int *val)
+{
+  unsigned int idx = reg / map->reg_stride;
+
+  if (!regcache_cacheable(map, reg) || !REGCACHE_BIT(map->cache_valid, idx))
+    {
+      return false;
+    }
+
+  *val = regcache_get(map, idx);
+  return true;
+}
+
+/****************************************************************************
+ * Name: regcache_write
+ *
+ * Description:
+ *   Update the cached value of reg.  A dirty value is written to the
+ *   device by regmap_cache_sync().
+ *
+ ****************************************************************************/
+
+void regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                    unsigned int val, bool dirty)
+{
+  unsigned int idx = reg / map->reg_stride;
+
+  if (!regcache_cacheable(map, reg))
+    {
+      return;
+    }
+
+  regcache_set(map, idx, val);
+  REGCACHE_SET(map->cache_valid, idx);
+  if (dirty)
+    {
+      REGCACHE_SET(map->cache_dirty, idx);
+    }
+  else
+    {
+      REGCACHE_CLR(map->cache_dirty, idx);
+    }
+}
+
+/****************************************************************************
+ * Name: regmap_cache_only
+ *
+ * Description:
+ *   While enabled, writes of cacheable registers only update the cache.
+ *
+ ****************************************************************************/
+
+void regmap_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  map->cache_only = enable && map->cache != NULL;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regmap_cache_sync
+ *
+ * Description:
+ *   Write all dirty registers of the cache to the device.
+ *
+ ****************************************************************************/
+
+int regmap_cache_sync(FAR struct regmap_s *map)
+{
+  uint8_t run[REGCACHE_SYNC_RUN];
+  unsigned int count;
+  unsigned int idx;
+  unsigned int n;
+  int ret = OK;
+
+  map->lock(map);
+  if (map->cache == NULL)
+    {
+      goto out;
+    }
+
+  count = regcache_count(map);
+  for (idx = 0; idx < count; idx++)
+    {
+      if (!REGCACHE_BIT(map->cache_dirty, idx))
+        {
+          continue;
+        }
+
+      if (regmap_can_raw_write(map))
+        {
+          /* Gather the run of dirty registers starting here */
+
+          for (n = 0; n < REGCACHE_SYNC_RUN && idx + n < count &&
+               REGCACHE_BIT(map->cache_dirty, idx + n); n++)
+            {
+              run[n] = regcache_get(map, idx + n);
+            }
+
+          ret = regmap_raw_write(map, idx, run, n);
+        }
+      else
+        {
+          n   = 1;
+          ret = map->reg_write(map->bus, idx * map->reg_stride,
+                               regcache_get(map, idx));
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      for (; n > 0; n--, idx++)
+        {
+          REGCACHE_CLR(map->cache_dirty, idx);
+        }
+
+      idx--;
+      ret = OK;
+    }
+
+out:
+  map->unlock(map);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: regmap_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached values.
+ *
+ ****************************************************************************/
+
+void regmap_cache_invalidate(FAR struct regmap_s *map)
+{
+  size_t bitmap;
+
+  map->lock(map);
+  if (map->cache != NULL)
+    {
+      bitmap = (regcache_count(map) + 7) / 8;
+      memset(map->cache_valid, 0, 2 * bitmap);
+    }
+
+  map->unlock(map);
+}
@@ -232,6 +232,26 @@ int rpmsg_get_timestamp(FAR struct rpmsg_device *rdev, FAR const void *data,
   return rpmsg->ops->get_timestamp(rpmsg, data, ts);
 }
 
+void rpmsg_batch_begin(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_s *rpmsg = rpmsg_get_by_rdev(ept->rdev);
+
+  if (rpmsg && rpmsg->ops->batch)
+    {
+      rpmsg->ops->batch(rpmsg, true);
+    }
+}
+
+void rpmsg_batch_end(FAR struct rpmsg_endpoint *ept)
+{
+  FAR struct rpmsg_s *rpmsg = rpmsg_get_by_rdev(ept->rdev);
+
+  if (rpmsg && rpmsg->ops->batch)
+    {
+      rpmsg->ops->batch(rpmsg, false);
+    }
+}
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
@@ -54,6 +54,7 @@ static void rpmsg_port_dump(FAR struct rpmsg_s *rpmsg);
 static int rpmsg_port_get_timestamp(FAR struct rpmsg_s *rpmsg,
                                     FAR const void *data,
                                     FAR struct rpmsg_timestamp_s *ts);
+static void rpmsg_port_batch(FAR struct rpmsg_s *rpmsg, bool begin);
 
 /****************************************************************************
  * Private Data
@@ -67,6 +68,7 @@ static const struct rpmsg_ops_s g_rpmsg_port_ops =
   NULL,
   rpmsg_port_dump,
   rpmsg_port_get_timestamp,
+  rpmsg_port_batch,
 };
 
 /****************************************************************************
@@ -290,6 +292,18 @@ static int rpmsg_port_send_offchannel_nocopy(FAR struct rpmsg_device *rdev,
   rpmsg_port_queue_add_buffer(&port->txq, hdr);
   if (port->ops->notify_tx_ready)
     {
+      /* Hold the notification back while a batch is open */
+
+      irqstate_t flags = spin_lock_irqsave(&port->batchlock);
+
+      if (port->batch > 0)
+        {
+          port->kick = true;
+          spin_unlock_irqrestore(&port->batchlock, flags);
+          return len;
+        }
+
+      spin_unlock_irqrestore(&port->batchlock, flags);
       port->ops->notify_tx_ready(port);
     }
 
@@ -427,6 +441,41 @@ static int rpmsg_port_get_timestamp(FAR struct rpmsg_s *rpmsg,
   return RPMSG_SUCCESS;
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_batch
+ ****************************************************************************/
+
+static void rpmsg_port_batch(FAR struct rpmsg_s *rpmsg, bool begin)
+{
+  FAR struct rpmsg_port_s *port = (FAR struct rpmsg_port_s *)rpmsg;
+  irqstate_t flags;
+  bool kick = false;
+
+  flags = spin_lock_irqsave(&port->batchlock);
+  if (begin)
+    {
+      port->batch++;
+    }
+  else
+    {
+      DEBUGASSERT(port->batch > 0);
+      if (--port->batch == 0)
+        {
+          kick = port->kick;
+          port->kick = false;
+        }
+    }
+
+  spin_unlock_irqrestore(&port->batchlock, flags);
+
+  /* The driver sends everything queued in txq on one notification */
+
+  if (kick)
+    {
+      port->ops->notify_tx_ready(port);
+    }
+}
+
 /****************************************************************************
  * Name: rpmsg_port_rx_callback
  ****************************************************************************/
@@ -603,6 +652,9 @@ int rpmsg_port_initialize(FAR struct rpmsg_port_s *port,
     }
 
   port->ops = ops;
+  spin_lock_init(&port->batchlock);
+  port->batch = 0;
+  port->kick = false;
   strlcpy(port->rpmsg.cpuname, cfg->remotecpu, RPMSG_NAME_SIZE);
 
   rdev = &port->rdev;
@@ -140,6 +140,12 @@ struct rpmsg_port_s
   /* Ops need implemented by drivers under port layer */
 
   const FAR struct rpmsg_port_ops_s *ops;
+
+  /* Notification batching, see rpmsg_batch_begin() */
+
+  spinlock_t                        batchlock;
+  int                               batch;  /* Nesting of open batches */
+  bool                              kick;   /* notify_tx_ready held back */
 };
 
 #ifndef __ASSEMBLY__
@@ -49,7 +49,14 @@
 #define RPMSG_VIRTIO_FEATURES        (1 << VIRTIO_RPMSG_F_NS | \
                                       1 << VIRTIO_RPMSG_F_ACK | \
                                       1 << VIRTIO_RPMSG_F_BUFSZ | \
-                                      1 << VIRTIO_RPMSG_F_CPUNAME)
+                                      1 << VIRTIO_RPMSG_F_CPUNAME | \
+                                      RPMSG_VIRTIO_EVENT_IDX)
+
+#ifdef CONFIG_RPMSG_VIRTIO_EVENT_IDX
+#  define RPMSG_VIRTIO_EVENT_IDX     (1 << VIRTIO_RING_F_EVENT_IDX)
+#else
+#  define RPMSG_VIRTIO_EVENT_IDX     0
+#endif
 
 #ifdef CONFIG_OPENAMP_CACHE
 #  define RPMSG_VIRTIO_INVALIDATE(x) metal_cache_invalidate(&x, sizeof(x))
@@ -74,6 +81,9 @@ struct rpmsg_virtio_priv_s
   vq_callback                  cbtx;
   vq_notify                    notifytx;
   uint16_t                     headrx;
+  spinlock_t                   batchlock;
+  int                          batch;     /* Nesting of open batches */
+  bool                         kick;      /* Notification held by batch */
 #ifdef CONFIG_RPMSG_VIRTIO_PM
   spinlock_t                   lock;
   struct pm_wakelock_s         wakelock;
@@ -91,6 +101,7 @@ static void rpmsg_virtio_wakeup_tx(FAR struct rpmsg_virtio_priv_s *priv);
 static int rpmsg_virtio_wait(FAR struct rpmsg_s *rpmsg, FAR sem_t *sem);
 static int rpmsg_virtio_post(FAR struct rpmsg_s *rpmsg, FAR sem_t *sem);
 static void rpmsg_virtio_dump(FAR struct rpmsg_s *rpmsg);
+static void rpmsg_virtio_batch(FAR struct rpmsg_s *rpmsg, bool begin);
 
 static void rpmsg_virtio_rx_callback(FAR struct virtqueue *vq);
 static void rpmsg_virtio_tx_callback(FAR struct virtqueue *vq);
@@ -107,6 +118,8 @@ static const struct rpmsg_ops_s g_rpmsg_virtio_ops =
   NULL,
   NULL,
   rpmsg_virtio_dump,
+  NULL,
+  rpmsg_virtio_batch,
 };
 
 /****************************************************************************
@@ -499,6 +512,7 @@ static void rpmsg_virtio_tx_notify(FAR struct virtqueue *vq)
 {
   FAR struct rpmsg_virtio_priv_s *priv =
     metal_container_of(vq->vq_dev->priv, struct rpmsg_virtio_priv_s, rvdev);
+  irqstate_t flags;
 
   /* rpmsg_virtio_tx_notify() called normally means send the buffer to peer,
    * so call rpmsg_virtio_pm_action(true) to hold the pm wakelock to avoid to
@@ -506,9 +520,57 @@ static void rpmsg_virtio_tx_notify(FAR struct virtqueue *vq)
    */
 
   rpmsg_virtio_pm_action(priv, true);
+
+  /* Hold the notification back while a batch is open */
+
+  flags = spin_lock_irqsave(&priv->batchlock);
+  if (priv->batch > 0)
+    {
+      priv->kick = true;
+      spin_unlock_irqrestore(&priv->batchlock, flags);
+      return;
+    }
+
+  spin_unlock_irqrestore(&priv->batchlock, flags);
   priv->notifytx(vq);
 }
 
+/****************************************************************************
+ * Name: rpmsg_virtio_batch
+ ****************************************************************************/
+
+static void rpmsg_virtio_batch(FAR struct rpmsg_s *rpmsg, bool begin)
+{
+  FAR struct rpmsg_virtio_priv_s *priv =
+    (FAR struct rpmsg_virtio_priv_s *)rpmsg;
+  irqstate_t flags;
+  bool kick = false;
+
+  flags = spin_lock_irqsave(&priv->batchlock);
+  if (begin)
+    {
+      priv->batch++;
+    }
+  else
+    {
+      DEBUGASSERT(priv->batch > 0);
+      if (--priv->batch == 0)
+        {
+          kick = priv->kick;
+          priv->kick = false;
+        }
+    }
+
+  spin_unlock_irqrestore(&priv->batchlock, flags);
+
+  /* Send the notifications held by the batch at once */
+
+  if (kick)
+    {
+      priv->notifytx(priv->rvdev.svq);
+    }
+}
+
 /****************************************************************************
  * Name: rpmsg_virtio_notify_wait
  ****************************************************************************/
@@ -623,6 +685,7 @@ int rpmsg_virtio_probe(FAR struct virtio_device *vdev)
     }
 
   priv->vdev = vdev;
+  spin_lock_init(&priv->batchlock);
   nxsem_init(&priv->semrx, 0, 0);
   nxsem_init(&priv->semtx, 0, 0);
 
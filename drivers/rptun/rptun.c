@@ -32,6 +32,7 @@
 #include <stdbool.h>
 #include <sys/boardctl.h>
 #include <sys/param.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 
 #include <metal/utilities.h>
@@ -42,6 +43,7 @@
 #include <nuttx/nuttx.h>
 #include <nuttx/rpmsg/rpmsg_virtio.h>
 #include <nuttx/rptun/rptun.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/vhost/vhost.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/panic_notifier.h>
@@ -74,13 +76,22 @@ struct rptun_priv_s
   struct notifier_block       nbpanic;
   bool                        rpanic;
   bool                        stop;
+  volatile bool               booting;
+  sem_t                       bootsem;
   pid_t                       pid;
+#ifdef CONFIG_RPTUN_LOADER_CACHE
+  FAR char                   *fw;
+  size_t                      fwsize;
+#endif
 };
 
 struct rptun_store_s
 {
   struct file file;
   FAR char   *buf;
+#ifdef CONFIG_RPTUN_LOADER_CACHE
+  FAR struct rptun_priv_s *priv;
+#endif
 };
 
 /****************************************************************************
@@ -777,6 +788,20 @@ static void rptun_check_command(FAR struct rptun_priv_s *priv)
 static int rptun_callback(FAR void *arg, uint32_t vqid)
 {
   FAR struct rptun_priv_s *priv = arg;
+  int semcount;
+
+  /* Any notification while the devices are being created may mean that
+   * the remote has brought up its side, so retry right away.
+   */
+
+  if (priv->booting)
+    {
+      nxsem_get_value(&priv->bootsem, &semcount);
+      if (semcount < 1)
+        {
+          nxsem_post(&priv->bootsem);
+        }
+    }
 
   rptun_check_command(priv);
   return remoteproc_get_notification(&priv->rproc, vqid);
@@ -803,11 +828,21 @@ static int rptun_do_start(FAR struct remoteproc *rproc)
         0
       };
 
+#ifdef CONFIG_RPTUN_LOADER_CACHE
+      store.priv = priv;
+#endif
+
       ret = remoteproc_load(rproc, RPTUN_GET_FIRMWARE(priv->dev),
                             &store, &g_rptun_store_ops, NULL);
       if (ret < 0)
         {
           rptunerr("remoteproc load failed, ret=%d\n", ret);
+#ifdef CONFIG_RPTUN_LOADER_CACHE
+          /* Read the image again next time, it may have been replaced */
+
+          kmm_free(priv->fw);
+          priv->fw = NULL;
+#endif
           return ret;
         }
 
@@ -861,6 +896,11 @@ static int rptun_start_thread(int argc, FAR char *argv[])
       return ret;
     }
 
+  /* Devices whose other side is not ready yet are retried when the remote
+   * notifies us, or after RPTUN_RETRY_PERIOD_US at the latest.
+   */
+
+  priv->booting = true;
   while (!priv->stop)
     {
       ret = rptun_create_devices(priv);
@@ -869,9 +909,10 @@ static int rptun_start_thread(int argc, FAR char *argv[])
           break;
         }
 
-      nxsig_usleep(RPTUN_RETRY_PERIOD_US);
+      nxsem_tickwait(&priv->bootsem, USEC2TICK(RPTUN_RETRY_PERIOD_US));
     }
 
+  priv->booting = false;
   return ret;
 }
 
@@ -928,6 +969,7 @@ static int rptun_dev_stop(FAR struct remoteproc *rproc)
       nxsig_kill(priv->pid, SIGKILL);
       nxsched_waitpid(priv->pid, NULL, WEXITED);
       priv->stop = false;
+      priv->booting = false;
       priv->pid = -EINVAL;
     }
 
@@ -1053,6 +1095,120 @@ static int rptun_ioctl_foreach(FAR const char *cpuname, int cmd,
 }
 
 #ifdef CONFIG_RPTUN_LOADER
+#ifdef CONFIG_RPTUN_LOADER_CACHE
+static int rptun_store_cache(FAR struct rptun_priv_s *priv,
+                             FAR const char *path)
+{
+  struct file file;
+  struct stat st;
+  ssize_t nread;
+  size_t pos;
+  int ret;
+
+  ret = file_open(&file, path, O_RDONLY | O_CLOEXEC);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_fstat(&file, &st);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  if (st.st_size <= 0)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  priv->fw = kmm_malloc(st.st_size);
+  if (priv->fw == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  for (pos = 0; pos < st.st_size; pos += nread)
+    {
+      nread = file_read(&file, priv->fw + pos, st.st_size - pos);
+      if (nread <= 0)
+        {
+          ret = nread < 0 ? nread : -EIO;
+          kmm_free(priv->fw);
+          priv->fw = NULL;
+          goto out;
+        }
+    }
+
+  priv->fwsize = st.st_size;
+
+out:
+  file_close(&file);
+  return ret;
+}
+
+static int rptun_store_open(FAR void *store_, FAR const char *path,
+                            FAR const void **img_data)
+{
+  FAR struct rptun_store_s *store = store_;
+  FAR struct rptun_priv_s *priv = store->priv;
+  int ret;
+
+  /* The image is read once, every later start loads it from RAM */
+
+  if (priv->fw == NULL)
+    {
+      ret = rptun_store_cache(priv, path);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  *img_data = priv->fw;
+  return priv->fwsize;
+}
+
+static void rptun_store_close(FAR void *store_)
+{
+}
+
+static int rptun_store_load(FAR void *store_, size_t offset,
+                            size_t size, FAR const void **data,
+                            metal_phys_addr_t pa,
+                            FAR struct metal_io_region *io,
+                            char is_blocking)
+{
+  FAR struct rptun_store_s *store = store_;
+  FAR struct rptun_priv_s *priv = store->priv;
+  FAR char *tmp;
+
+  if (offset > priv->fwsize || size > priv->fwsize - offset)
+    {
+      return -EINVAL;
+    }
+
+  if (pa == METAL_BAD_PHYS)
+    {
+      *data = priv->fw + offset;
+      return size;
+    }
+
+  /* Copy the segment straight to its load address */
+
+  tmp = metal_io_phys_to_virt(io, pa);
+  if (!tmp)
+    {
+      return -EINVAL;
+    }
+
+  memcpy(tmp, priv->fw + offset, size);
+  metal_cache_flush(tmp, size);
+  return size;
+}
+#else
 static int rptun_store_open(FAR void *store_,
                             FAR const char *path,
                             FAR const void **img_data)
@@ -1134,6 +1290,7 @@ static int rptun_store_load(FAR void *store_, size_t offset,
   return ret;
 }
 #endif
+#endif
 
 static metal_phys_addr_t rptun_pa_to_da(FAR struct rptun_dev_s *dev,
                                         metal_phys_addr_t pa)
@@ -1215,6 +1372,7 @@ int rptun_initialize(FAR struct rptun_dev_s *dev)
 
   priv->dev = dev;
   priv->pid = -EINVAL;
+  nxsem_init(&priv->bootsem, 0, 0);
   remoteproc_init(&priv->rproc, &g_rptun_ops, priv);
 
   snprintf(name, sizeof(name), "/dev/rptun/%s", RPTUN_GET_CPUNAME(dev));
@@ -1246,6 +1404,7 @@ int rptun_initialize(FAR struct rptun_dev_s *dev)
 err_start:
   unregister_driver(name);
 err_driver:
+  nxsem_destroy(&priv->bootsem);
   kmm_free(priv);
   return ret;
 }
@@ -37,6 +37,7 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <nuttx/arch.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
@@ -123,6 +124,9 @@ struct sensor_upperhalf_s
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
   char               name[NAME_MAX];     /* Upper topic name */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *mmap;        /* Header of the mapped buffer */
+#endif
 };
 
 /****************************************************************************
@@ -139,6 +143,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -231,7 +239,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -498,6 +510,93 @@ static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t bytes = lower->nbuffer * upper->state.esize;
+  FAR void *base = NULL;
+  int ret;
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* The data buffer lives right behind the header subscribers map */
+
+  upper->mmap = kmm_zalloc(sizeof(struct sensor_mmap_s) + bytes);
+  if (upper->mmap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->mmap->esize = upper->state.esize;
+  upper->mmap->nbuffer = lower->nbuffer;
+  base = upper->mmap + 1;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, bytes);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+#ifdef CONFIG_SENSORS_MMAP
+  kmm_free(upper->mmap);
+  upper->mmap = NULL;
+#endif
+  return ret;
+}
+
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_set_readpos(FAR struct sensor_upperhalf_s *upper,
+                              FAR struct sensor_user_s *user,
+                              uint32_t pos)
+{
+  uint32_t interval = upper->state.min_interval != UINT32_MAX ?
+                      upper->state.min_interval : 1;
+  uint32_t head;
+  uint32_t generation;
+
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      return pos == 0 ? OK : -ERANGE;
+    }
+
+  head = upper->timing.head / TIMING_BUF_ESIZE;
+  if (head - pos > upper->lower->nbuffer)
+    {
+      return -ERANGE;
+    }
+
+  /* Keep the generation in step with the position, as sensor_read()
+   * does, so that poll() only reports events after pos.
+   */
+
+  if (pos == head)
+    {
+      generation = upper->state.generation;
+    }
+  else
+    {
+      circbuf_peekat(&upper->timing, pos * TIMING_BUF_ESIZE,
+                     &generation, TIMING_BUF_ESIZE);
+      generation -= interval;
+    }
+
+  user->bufferpos = pos;
+  user->state.generation = generation;
+  return OK;
+}
+#endif
+
 static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
                               FAR struct sensor_user_s *user)
 {
@@ -1057,6 +1156,16 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_MMAP
+      case SNIOC_SET_READPOS:
+        {
+          nxrmutex_lock(&upper->lock);
+          ret = sensor_set_readpos(upper, user, arg1);
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       case SNIOC_UPDATED:
         {
           nxrmutex_lock(&upper->lock);
@@ -1158,6 +1267,50 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size;
+  int ret = OK;
+
+  /* Fetch sensors read the hardware directly, there is no buffer */
+
+  if (lower->ops->fetch || lower->nbuffer == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_init_buffer(upper);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  size = sizeof(struct sensor_mmap_s) + circbuf_size(&upper->buffer);
+  if (map->offset >= 0 && map->offset < size &&
+      map->length && map->offset + map->length <= size)
+    {
+      map->vaddr = (FAR char *)upper->mmap + map->offset;
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+errout:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -1226,7 +1379,6 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1262,26 +1414,30 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
+      ret = sensor_init_buffer(upper);
       if (ret < 0)
         {
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
     }
 
   smdebug(upper->name, "the number of write event is:%lu", envcount);
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Tell mapped readers which events are about to be overwritten */
+
+  upper->mmap->begin = upper->mmap->head + envcount;
+  SMP_WMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
+
+#ifdef CONFIG_SENSORS_MMAP
+  SMP_WMB();
+  upper->mmap->head += envcount;
+#endif
+
   sensor_generate_timing(upper, envcount);
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
@@ -1587,6 +1743,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
     {
       circbuf_uninit(&upper->buffer);
       circbuf_uninit(&upper->timing);
+#ifdef CONFIG_SENSORS_MMAP
+      kmm_free(upper->mmap);
+#endif
     }
 
   kmm_free(upper);
@@ -0,0 +1,525 @@
+/****************************************************************************
+ * drivers/sensors/sensor_group.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+#include <fcntl.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/sensors/sensor.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SENSOR_GROUP_DEPTH   CONFIG_SENSORS_GROUP_HISTORY
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one topic the group subscribes to */
+
+struct sensor_group_sub_s
+{
+  struct file      file;       /* The subscription of the topic */
+  FAR const char  *path;       /* The path of the topic */
+  size_t           esize;      /* The element size of the topic */
+  size_t           offset;     /* The offset of the event in the bundle */
+  uint8_t          nfloat;     /* The number of float fields to interpolate */
+  unsigned int     count;      /* The number of samples in history */
+  unsigned int     next;       /* The history slot of the next sample */
+  FAR uint8_t     *history;    /* The latest samples, oldest first */
+};
+
+/* This structure describes a sensor group */
+
+struct sensor_group_s
+{
+  struct sensor_lowerhalf_s lower;    /* The lower half of the bundle topic */
+  FAR char                 *path;     /* The path of the bundle topic */
+  sem_t                     run;      /* Wakes up the worker thread */
+  sem_t                     exited;   /* Posted when the worker has exited */
+  volatile bool             enabled;  /* The bundle topic has subscribers */
+  volatile bool             exiting;  /* The group is being unregistered */
+  bool                      opened;   /* The topics are subscribed */
+  uint32_t                  interval; /* The bundle interval, in us */
+  uint64_t                  last;     /* The timestamp of the last bundle */
+  size_t                    bsize;    /* The size of a bundle */
+  FAR uint8_t              *bundle;   /* The bundle being assembled */
+  int                       nsubs;    /* The number of topics */
+  struct sensor_group_sub_s sub[1];   /* The topics */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int sensor_group_activate(FAR struct sensor_lowerhalf_s *lower,
+                                 FAR struct file *filep, bool enable);
+static int sensor_group_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                     FAR struct file *filep,
+                                     FAR uint32_t *period_us);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct sensor_ops_s g_sensor_group_ops =
+{
+  .activate     = sensor_group_activate,
+  .set_interval = sensor_group_set_interval,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR uint8_t *sensor_group_sample(FAR struct sensor_group_sub_s *sub,
+                                        unsigned int i)
+{
+  i += sub->next + SENSOR_GROUP_DEPTH - sub->count;
+  return sub->history + (i % SENSOR_GROUP_DEPTH) * sub->esize;
+}
+
+static uint64_t sensor_group_time(FAR struct sensor_group_sub_s *sub,
+                                  unsigned int i)
+{
+  return *(FAR uint64_t *)sensor_group_sample(sub, i);
+}
+
+static void sensor_group_close(FAR struct sensor_group_s *group)
+{
+  int i;
+
+  for (i = 0; i < group->nsubs; i++)
+    {
+      if (group->sub[i].file.f_inode != NULL)
+        {
+          file_close(&group->sub[i].file);
+          memset(&group->sub[i].file, 0, sizeof(struct file));
+        }
+    }
+
+  group->opened = false;
+}
+
+static int sensor_group_open(FAR struct sensor_group_s *group)
+{
+  FAR struct sensor_group_sub_s *sub;
+  struct sensor_state_s state;
+  int ret;
+  int i;
+
+  for (i = 0; i < group->nsubs; i++)
+    {
+      sub = &group->sub[i];
+      ret = file_open(&sub->file, sub->path, O_RDONLY | O_NONBLOCK);
+      if (ret < 0)
+        {
+          snerr("ERROR: failed to open %s: %d\n", sub->path, ret);
+          goto errout;
+        }
+
+      ret = file_ioctl(&sub->file, SNIOC_GET_STATE,
+                       (unsigned long)(uintptr_t)&state);
+      if (ret >= 0 && state.esize != sub->esize)
+        {
+          snerr("ERROR: %s has %" PRIu32 " bytes events, not %zu\n",
+                sub->path, state.esize, sub->esize);
+          ret = -EINVAL;
+        }
+
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      sub->count = 0;
+      sub->next = 0;
+    }
+
+  group->last = 0;
+  group->opened = true;
+  return OK;
+
+errout:
+  sensor_group_close(group);
+  return ret;
+}
+
+/* Read every event published since the previous round into history */
+
+static void sensor_group_collect(FAR struct sensor_group_s *group)
+{
+  FAR struct sensor_group_sub_s *sub;
+  int i;
+
+  for (i = 0; i < group->nsubs; i++)
+    {
+      sub = &group->sub[i];
+      while (file_read(&sub->file, sub->history + sub->next * sub->esize,
+                       sub->esize) == sub->esize)
+        {
+          sub->next = (sub->next + 1) % SENSOR_GROUP_DEPTH;
+          if (sub->count < SENSOR_GROUP_DEPTH)
+            {
+              sub->count++;
+            }
+        }
+    }
+}
+
+/* Produce the sample of one topic at time t.  The two samples around t
+ * are linearly interpolated in their leading nfloat float fields and the
+ * rest is taken from the nearer one; when t is outside of the history, the
+ * nearest sample is used as it is.
+ */
+
+static void sensor_group_align(FAR struct sensor_group_sub_s *sub,
+                               uint64_t t, FAR uint8_t *out)
+{
+  FAR const float *fa;
+  FAR const float *fb;
+  FAR float *fo;
+  uint64_t ta;
+  uint64_t tb;
+  unsigned int i;
+  float w;
+
+  for (i = sub->count - 1; i > 0; i--)
+    {
+      if (sensor_group_time(sub, i - 1) <= t)
+        {
+          break;
+        }
+    }
+
+  tb = sensor_group_time(sub, i);
+  if (i == 0 || tb <= t)
+    {
+      memcpy(out, sensor_group_sample(sub, i), sub->esize);
+      return;
+    }
+
+  ta = sensor_group_time(sub, i - 1);
+  w = (float)(t - ta) / (float)(tb - ta);
+  memcpy(out, sensor_group_sample(sub, w < 0.5f ? i - 1 : i), sub->esize);
+  if (sub->nfloat == 0)
+    {
+      return;
+    }
+
+  fa = (FAR const float *)(sensor_group_sample(sub, i - 1) +
+                           sizeof(uint64_t));
+  fb = (FAR const float *)(sensor_group_sample(sub, i) + sizeof(uint64_t));
+  fo = (FAR float *)(out + sizeof(uint64_t));
+  for (i = 0; i < sub->nfloat; i++)
+    {
+      fo[i] = fa[i] + (fb[i] - fa[i]) * w;
+    }
+
+  *(FAR uint64_t *)out = t;
+}
+
+/* Publish a bundle at the latest time that every topic has reached */
+
+static void sensor_group_emit(FAR struct sensor_group_s *group)
+{
+  FAR struct sensor_group_sub_s *sub;
+  uint64_t t = UINT64_MAX;
+  int i;
+
+  for (i = 0; i < group->nsubs; i++)
+    {
+      sub = &group->sub[i];
+      if (sub->count == 0)
+        {
+          return;
+        }
+
+      t = MIN(t, sensor_group_time(sub, sub->count - 1));
+    }
+
+  if (t <= group->last)
+    {
+      return;
+    }
+
+  group->last = t;
+  *(FAR uint64_t *)group->bundle = t;
+  for (i = 0; i < group->nsubs; i++)
+    {
+      sub = &group->sub[i];
+      sensor_group_align(sub, t, group->bundle + sub->offset);
+    }
+
+  group->lower.push_event(group->lower.priv, group->bundle, group->bsize);
+}
+
+static int sensor_group_thread(int argc, FAR char *argv[])
+{
+  FAR struct sensor_group_s *group = (FAR struct sensor_group_s *)
+        ((uintptr_t)strtoul(argv[1], NULL, 16));
+  clock_t start;
+  clock_t delay;
+  clock_t elapsed;
+
+  while (!group->exiting)
+    {
+      if (group->enabled != group->opened)
+        {
+          if (group->opened)
+            {
+              sensor_group_close(group);
+            }
+          else if (sensor_group_open(group) < 0)
+            {
+              group->enabled = false;
+            }
+        }
+
+      if (!group->opened)
+        {
+          nxsem_wait_uninterruptible(&group->run);
+          continue;
+        }
+
+      start = clock_systime_ticks();
+      sensor_group_collect(group);
+      sensor_group_emit(group);
+
+      /* Sleep for the rest of the period, activate() and unregister()
+       * cut it short.
+       */
+
+      delay = USEC2TICK(group->interval);
+      elapsed = clock_systime_ticks() - start;
+      nxsem_tickwait(&group->run, elapsed < delay ? delay - elapsed : 1);
+    }
+
+  sensor_group_close(group);
+  nxsem_post(&group->exited);
+  return OK;
+}
+
+static int sensor_group_activate(FAR struct sensor_lowerhalf_s *lower,
+                                 FAR struct file *filep, bool enable)
+{
+  FAR struct sensor_group_s *group =
+    container_of(lower, struct sensor_group_s, lower);
+
+  group->enabled = enable;
+  nxsem_post(&group->run);
+  return OK;
+}
+
+static int sensor_group_set_interval(FAR struct sensor_lowerhalf_s *lower,
+                                     FAR struct file *filep,
+                                     FAR uint32_t *period_us)
+{
+  FAR struct sensor_group_s *group =
+    container_of(lower, struct sensor_group_s, lower);
+
+  group->interval = MAX(*period_us, TICK2USEC(1));
+  *period_us = group->interval;
+  return OK;
+}
+
+static void sensor_group_free(FAR struct sensor_group_s *group)
+{
+  int i;
+
+  for (i = 0; i < group->nsubs; i++)
+    {
+      kmm_free(group->sub[i].history);
+    }
+
+  nxsem_destroy(&group->run);
+  nxsem_destroy(&group->exited);
+  kmm_free(group->bundle);
+  kmm_free(group);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sensor_group_register
+ *
+ * Description:
+ *   This function registers a topic that publishes the samples of several
+ *   other topics aligned to one timestamp, at the given interval.
+ *
+ * Input Parameters:
+ *   path     - The path of the bundle topic, ex: /dev/uorb/xxx.
+ *   topics   - The topics to bundle, in bundle order.
+ *   ntopics  - The number of topics.
+ *   interval - The default bundle interval, in us.
+ *
+ * Returned Value:
+ *   The group handle on success, NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct sensor_group_s *
+sensor_group_register(FAR const char *path,
+                      FAR const struct sensor_group_topic_s *topics,
+                      int ntopics, uint32_t interval)
+{
+  FAR struct sensor_group_s *group;
+  FAR struct sensor_group_sub_s *sub;
+  FAR char *argv[2];
+  char arg1[32];
+  size_t offset;
+  size_t size;
+  int ret;
+  int i;
+
+  DEBUGASSERT(path != NULL && topics != NULL && ntopics > 0);
+
+  size = sizeof(struct sensor_group_s) +
+         (ntopics - 1) * sizeof(struct sensor_group_sub_s) +
+         strlen(path) + 1;
+  for (i = 0; i < ntopics; i++)
+    {
+      size += strlen(topics[i].path) + 1;
+    }
+
+  group = kmm_zalloc(size);
+  if (group == NULL)
+    {
+      return NULL;
+    }
+
+  nxsem_init(&group->run, 0, 0);
+  nxsem_init(&group->exited, 0, 0);
+  group->interval = MAX(interval, TICK2USEC(1));
+  group->nsubs = ntopics;
+  group->path = (FAR char *)&group->sub[ntopics];
+  strcpy(group->path, path);
+
+  /* The bundle is the timestamp followed by every event, each one 8 bytes
+   * aligned.
+   */
+
+  offset = sizeof(uint64_t);
+  size = strlen(path) + 1;
+  for (i = 0; i < ntopics; i++)
+    {
+      DEBUGASSERT(topics[i].esize >= sizeof(uint64_t) +
+                  topics[i].nfloat * sizeof(float));
+
+      sub = &group->sub[i];
+      sub->path = group->path + size;
+      strcpy((FAR char *)sub->path, topics[i].path);
+      size += strlen(topics[i].path) + 1;
+
+      sub->esize = topics[i].esize;
+      sub->nfloat = topics[i].nfloat;
+      sub->offset = offset;
+      offset += ALIGN_UP(sub->esize, sizeof(uint64_t));
+
+      sub->history = kmm_malloc(SENSOR_GROUP_DEPTH * sub->esize);
+      if (sub->history == NULL)
+        {
+          goto errout;
+        }
+    }
+
+  group->bsize = offset;
+  group->bundle = kmm_zalloc(offset);
+  if (group->bundle == NULL)
+    {
+      goto errout;
+    }
+
+  group->lower.ops = &g_sensor_group_ops;
+  group->lower.nbuffer = 1;
+  ret = sensor_custom_register(&group->lower, group->path, group->bsize);
+  if (ret < 0)
+    {
+      snerr("ERROR: failed to register %s: %d\n", path, ret);
+      goto errout;
+    }
+
+  snprintf(arg1, sizeof(arg1), "%p", group);
+  argv[0] = arg1;
+  argv[1] = NULL;
+  ret = kthread_create("sensor_group", CONFIG_SENSORS_GROUP_PRIORITY,
+                       CONFIG_SENSORS_GROUP_STACKSIZE,
+                       sensor_group_thread, argv);
+  if (ret < 0)
+    {
+      sensor_custom_unregister(&group->lower, group->path);
+      goto errout;
+    }
+
+  return group;
+
+errout:
+  sensor_group_free(group);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: sensor_group_unregister
+ *
+ * Description:
+ *   This function unregisters the bundle topic, stops the group and
+ *   releases it.  This API corresponds to the sensor_group_register.
+ *
+ * Input Parameters:
+ *   group - The group handle returned by sensor_group_register.
+ *
+ ****************************************************************************/
+
+void sensor_group_unregister(FAR struct sensor_group_s *group)
+{
+  DEBUGASSERT(group != NULL);
+
+  /* Stop the worker first, it pushes to the bundle topic */
+
+  group->exiting = true;
+  nxsem_post(&group->run);
+  nxsem_wait_uninterruptible(&group->exited);
+
+  sensor_custom_unregister(&group->lower, group->path);
+  sensor_group_free(group);
+}
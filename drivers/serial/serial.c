@@ -852,6 +852,9 @@ static int uart_close(FAR struct file *filep)
 
   flags = enter_critical_section();  /* Disable interrupts */
   uart_detach(dev);                  /* Detach interrupts */
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+  wd_cancel(&dev->rxidle);           /* Stop the RX idle timer */
+#endif
 
   /* Check for the serial console UART */
 
@@ -901,13 +904,14 @@ static ssize_t uart_readv(FAR struct file *filep, FAR struct uio *uio)
 #ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
   unsigned int nbuffered;
   unsigned int watermark;
-  sbuf_size_t head;
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
   ssize_t buflen;
   bool echoed = false;
+  sbuf_size_t head;
   sbuf_size_t tail;
+  size_t ncopy;
   char ch;
   int ret;
 
@@ -964,8 +968,35 @@ static ssize_t uart_readv(FAR struct file *filep, FAR struct uio *uio)
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      head = rxbuf->head;
+      if (head != tail)
         {
+          /* Without any input processing, copy the whole contiguous
+           * segment up to the head or the end of the buffer at once.
+           */
+
+          if ((dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0 &&
+              (dev->tc_lflag & (ICANON | ECHO)) == 0)
+            {
+              ncopy = (head > tail ? head : rxbuf->size) - tail;
+              if (ncopy > buflen - recvd)
+                {
+                  ncopy = buflen - recvd;
+                }
+
+              uio_copyfrom(uio, recvd, &rxbuf->buffer[tail], ncopy);
+              recvd += ncopy;
+
+              tail += ncopy;
+              if (tail >= rxbuf->size)
+                {
+                  tail = 0;
+                }
+
+              rxbuf->tail = tail;
+              continue;
+            }
+
           /* Take the next character from the tail of the buffer */
 
           ch = rxbuf->buffer[tail];
@@ -1405,6 +1436,10 @@ static ssize_t uart_writev(FAR struct file *filep, FAR struct uio *uio)
   ssize_t           nwritten;
   ssize_t           buflen;
   bool              oktoblock;
+  bool              raw;
+  sbuf_size_t       head;
+  sbuf_size_t       tail;
+  size_t            ncopy;
   int               ret;
   char              ch;
 
@@ -1470,6 +1505,13 @@ static ssize_t uart_writev(FAR struct file *filep, FAR struct uio *uio)
 
   oktoblock = ((filep->f_oflags & O_NONBLOCK) == 0);
 
+  /* Without any output post-processing, the data can be copied into the
+   * TX buffer a contiguous segment at a time.
+   */
+
+  raw = (dev->tc_oflag & OPOST) == 0 ||
+        (dev->tc_oflag & (OCRNL | ONLCR | ONLRET)) == 0;
+
   /* Loop while we still have data to copy to the transmit buffer.
    * we add data to the head of the buffer; uart_xmitchars takes the
    * data from the end of the buffer.
@@ -1478,6 +1520,49 @@ static ssize_t uart_writev(FAR struct file *filep, FAR struct uio *uio)
   uart_disabletxint(dev);
   for (; buflen; uio_advance(uio, 1), buflen--)
     {
+      if (raw)
+        {
+          /* Fill the free space up to the tail or the end of the buffer,
+           * leaving one byte free to tell a full buffer from an empty one.
+           * If the buffer is full, fall back to uart_putxmitchar() below
+           * to wait for space.
+           */
+
+          head = dev->xmit.head;
+          tail = dev->xmit.tail;
+          if (head >= tail)
+            {
+              ncopy = dev->xmit.size - head - (tail == 0);
+            }
+          else
+            {
+              ncopy = tail - head - 1;
+            }
+
+          if (ncopy > 1)
+            {
+              if (ncopy > buflen)
+                {
+                  ncopy = buflen;
+                }
+
+              /* Copy all but the last byte, which the loop handles */
+
+              ncopy--;
+              uio_copyto(uio, 0, &dev->xmit.buffer[head], ncopy);
+              uio_advance(uio, ncopy);
+              buflen -= ncopy;
+
+              head += ncopy;
+              if (head >= dev->xmit.size)
+                {
+                  head = 0;
+                }
+
+              dev->xmit.head = head;
+            }
+        }
+
       uio_copyto(uio, 0, &ch, 1);
       ret = OK;
 
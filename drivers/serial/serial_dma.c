@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <debug.h>
 #include <nuttx/signal.h>
+#include <nuttx/wdog.h>
 
 #include <nuttx/serial/serial.h>
 
@@ -40,6 +41,50 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: uart_rxdma_nbuffered
+ *
+ * Description:
+ *   Return the number of bytes waiting in the RX circular buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+static size_t uart_rxdma_nbuffered(FAR struct uart_buffer_s *rxbuf)
+{
+  if (rxbuf->head >= rxbuf->tail)
+    {
+      return rxbuf->head - rxbuf->tail;
+    }
+  else
+    {
+      return rxbuf->size - rxbuf->tail + rxbuf->head;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_rxidle_timeout
+ *
+ * Description:
+ *   The RX line stayed quiet for CONFIG_SERIAL_RXDMA_IDLE_TIMEOUT after the
+ *   last DMA completion left data below the watermark: wake up the readers
+ *   so that the tail of a burst is not held back.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+static void uart_rxidle_timeout(wdparm_t arg)
+{
+  FAR uart_dev_t *dev = (FAR uart_dev_t *)arg;
+
+  if (uart_rxdma_nbuffered(&dev->recv) > 0)
+    {
+      uart_datareceived(dev);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: uart_recvchars_check_special
  *
@@ -330,16 +375,25 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
    * incoming data available.
    */
 
-  if (rxbuf->head >= rxbuf->tail)
+  nbytes = uart_rxdma_nbuffered(rxbuf);
+
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+  /* Only wake the readers once a watermark worth of data has accumulated,
+   * and leave anything less to the idle timer (or the lower half's
+   * idle-line detection through uart_recvchars_idle()).
+   */
+
+  if (nbytes >= CONFIG_SERIAL_RXDMA_WATERMARK)
     {
-      nbytes = rxbuf->head - rxbuf->tail;
+      wd_cancel(&dev->rxidle);
+      uart_datareceived(dev);
     }
-  else
+  else if (nbytes > 0)
     {
-      nbytes = rxbuf->size - rxbuf->tail + rxbuf->head;
+      wd_start(&dev->rxidle, USEC2TICK(CONFIG_SERIAL_RXDMA_IDLE_TIMEOUT),
+               uart_rxidle_timeout, (wdparm_t)dev);
     }
-
-#ifdef CONFIG_SERIAL_TERMIOS
+#elif defined(CONFIG_SERIAL_TERMIOS)
   if (nbytes >= dev->minrecv)
 #else
   if (nbytes)
@@ -360,4 +414,25 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *   Called by the lower half when it detects that the RX line went idle,
+ *   after it has updated the RX circular buffer by uart_recvchars_done().
+ *   Wakes up any readers waiting for data still below the watermark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+void uart_recvchars_idle(FAR uart_dev_t *dev)
+{
+  wd_cancel(&dev->rxidle);
+  if (uart_rxdma_nbuffered(&dev->recv) > 0)
+    {
+      uart_datareceived(dev);
+    }
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
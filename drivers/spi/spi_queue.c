@@ -0,0 +1,316 @@
+/****************************************************************************
+ * drivers/spi/spi_queue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct spi_queue_s
+{
+  FAR struct spi_dev_s *spi;     /* The bus served by this queue */
+  sq_queue_t            pending; /* Messages by decreasing priority */
+  spinlock_t            lock;    /* Protects pending */
+  sem_t                 sem;     /* Posted once per submitted message */
+  pid_t                 pid;     /* The queue thread */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_wakeup
+ *
+ * Description:
+ *   Completion callback of spi_queue_transfer().
+ *
+ ****************************************************************************/
+
+static void spi_queue_wakeup(FAR struct spi_message_s *msg, FAR void *arg)
+{
+  nxsem_post((FAR sem_t *)arg);
+}
+
+/****************************************************************************
+ * Name: spi_queue_thread
+ *
+ * Description:
+ *   Serve the messages of one bus back to back, the next one is taken as
+ *   soon as the previous sequence is done.
+ *
+ ****************************************************************************/
+
+static int spi_queue_thread(int argc, FAR char *argv[])
+{
+  FAR struct spi_queue_s *queue;
+  FAR struct spi_message_s *msg;
+  irqstate_t flags;
+
+  queue = (FAR struct spi_queue_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&queue->sem);
+
+      flags = spin_lock_irqsave(&queue->lock);
+      msg   = (FAR struct spi_message_s *)sq_remfirst(&queue->pending);
+      spin_unlock_irqrestore(&queue->lock, flags);
+
+      /* The message may have been cancelled */
+
+      if (msg == NULL)
+        {
+          continue;
+        }
+
+      msg->result = spi_transfer(queue->spi, msg->seq);
+      if (msg->result < 0)
+        {
+          spierr("ERROR: spi_transfer failed: %d\n", msg->result);
+        }
+
+      if (msg->callback != NULL)
+        {
+          msg->callback(msg, msg->arg);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Create a message queue for an SPI bus and the kernel thread that
+ *   serves it.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi)
+{
+  FAR struct spi_queue_s *queue;
+  FAR char *argv[2];
+  char arg1[32];
+
+  DEBUGASSERT(spi != NULL);
+
+  queue = kmm_zalloc(sizeof(struct spi_queue_s));
+  if (queue == NULL)
+    {
+      return NULL;
+    }
+
+  queue->spi = spi;
+  sq_init(&queue->pending);
+  spin_lock_init(&queue->lock);
+  nxsem_init(&queue->sem, 0, 0);
+
+  snprintf(arg1, sizeof(arg1), "%p", queue);
+  argv[0] = arg1;
+  argv[1] = NULL;
+
+  queue->pid = kthread_create("spiq", CONFIG_SPI_QUEUE_PRIORITY,
+                              CONFIG_SPI_QUEUE_STACKSIZE,
+                              spi_queue_thread, argv);
+  if (queue->pid < 0)
+    {
+      spierr("ERROR: kthread_create failed: %d\n", queue->pid);
+      nxsem_destroy(&queue->sem);
+      kmm_free(queue);
+      return NULL;
+    }
+
+  return queue;
+}
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Queue a message for asynchronous transfer.
+ *
+ * Input Parameters:
+ *   queue - The queue of the bus
+ *   msg   - The message to transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_message_s *msg)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+
+  if (queue == NULL || msg == NULL || msg->seq == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Insert behind all messages of the same or a higher priority */
+
+  flags = spin_lock_irqsave(&queue->lock);
+  for (curr = sq_peek(&queue->pending); curr != NULL; curr = sq_next(curr))
+    {
+      if (((FAR struct spi_message_s *)curr)->priority < msg->priority)
+        {
+          break;
+        }
+
+      prev = curr;
+    }
+
+  if (prev == NULL)
+    {
+      sq_addfirst(&msg->flink, &queue->pending);
+    }
+  else
+    {
+      sq_addafter(prev, &msg->flink, &queue->pending);
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  return nxsem_post(&queue->sem);
+}
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a message that has not been started yet from the queue.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was removed; -EBUSY if it is in progress or
+ *   done.
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_message_s *msg)
+{
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+  int ret = -EBUSY;
+
+  flags = spin_lock_irqsave(&queue->lock);
+  for (curr = sq_peek(&queue->pending); curr != NULL; curr = sq_next(curr))
+    {
+      if (curr == &msg->flink)
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst(&queue->pending);
+            }
+          else
+            {
+              sq_remafter(prev, &queue->pending);
+            }
+
+          ret = OK;
+          break;
+        }
+
+      prev = curr;
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
+  /* The semaphore count stays ahead of the messages, the thread skips the
+   * extra wakeup.
+   */
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spi_queue_transfer
+ *
+ * Description:
+ *   Queue a sequence with the given priority and wait for it.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_transfer(FAR struct spi_queue_s *queue,
+                       FAR struct spi_sequence_s *seq, uint8_t priority)
+{
+  struct spi_message_s msg;
+  sem_t done;
+  int ret;
+
+  nxsem_init(&done, 0, 0);
+
+  msg.seq      = seq;
+  msg.priority = priority;
+  msg.callback = spi_queue_wakeup;
+  msg.arg      = &done;
+
+  ret = spi_queue_submit(queue, &msg);
+  if (ret >= 0)
+    {
+      nxsem_wait_uninterruptible(&done);
+      ret = msg.result;
+    }
+
+  nxsem_destroy(&done);
+  return ret;
+}
+
+#endif /* CONFIG_SPI_QUEUE */
@@ -30,6 +30,7 @@
 #include <sys/ioctl.h>
 
 #include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -40,14 +41,18 @@
 #include <assert.h>
 #include <debug.h>
 #include <ctype.h>
+#include <syslog.h>
 #include <sys/boardctl.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/streams.h>
 #include <nuttx/syslog/ramlog.h>
 #include <nuttx/compiler.h>
 #include <nuttx/list.h>
@@ -111,6 +116,31 @@ struct ramlog_dev_s
   struct ramlog_ratelimit_s  rl_ratelimit; /* The ratelimit for ramlog */
 };
 
+#ifdef CONFIG_RAMLOG_DEFERRED
+/* A syslog message recorded unformatted.  In the deferred ring, the header
+ * is followed by the arguments of the message packed by lib_vbspack().
+ */
+
+struct ramlog_record_s
+{
+  FAR const IPTR char *rr_fmt;      /* Format string, referenced in place */
+  clock_t              rr_time;     /* System time in ticks */
+  pid_t                rr_pid;      /* Thread that logged the message */
+  uint16_t             rr_len;      /* Size of the packed arguments */
+  uint8_t              rr_priority; /* Priority of the message */
+  uint8_t              rr_cpu;      /* CPU that logged the message */
+};
+
+struct ramlog_deferred_s
+{
+  spinlock_t        rd_lock;     /* Protects the head and the tail */
+  mutex_t           rd_expand;   /* Serializes the formatting of records */
+  volatile uint32_t rd_head;     /* Where records are added */
+  volatile uint32_t rd_tail;     /* Where records are formatted from */
+  uint8_t           rd_buffer[CONFIG_RAMLOG_DEFERRED_BUFSIZE];
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -132,6 +162,10 @@ static ssize_t ramlog_file_write(FAR struct file *filep,
                                  FAR const char *buffer, size_t buflen);
 static int     ramlog_file_ioctl(FAR struct file *filep, int cmd,
                                  unsigned long arg);
+#ifdef CONFIG_RAMLOG_MMAP
+static int     ramlog_file_mmap(FAR struct file *filep,
+                                FAR struct mm_map_entry_s *map);
+#endif
 static int     ramlog_file_poll(FAR struct file *filep,
                                 FAR struct pollfd *fds, bool setup);
 
@@ -147,7 +181,11 @@ static const struct file_operations g_ramlogfops =
   ramlog_file_write, /* write */
   NULL,              /* seek */
   ramlog_file_ioctl, /* ioctl */
+#ifdef CONFIG_RAMLOG_MMAP
+  ramlog_file_mmap,  /* mmap */
+#else
   NULL,              /* mmap */
+#endif
   NULL,              /* truncate */
   ramlog_file_poll   /* poll */
 };
@@ -178,6 +216,24 @@ static struct ramlog_dev_s g_sysdev =
 
 #endif
 
+#ifdef CONFIG_RAMLOG_DEFERRED
+/* syslog() messages waiting to be formatted into g_sysdev */
+
+static struct ramlog_deferred_s g_ramlog_deferred =
+{
+  SP_UNLOCKED,                                          /* rd_lock */
+  NXMUTEX_INITIALIZER,                                  /* rd_expand */
+};
+
+#  ifdef CONFIG_SYSLOG_PRIORITY
+static FAR const char * const g_ramlog_priority[] =
+{
+  "EMERG", "ALERT", "CRIT", "ERROR",
+  "WARN", "NOTICE", "INFO", "DEBUG"
+};
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -249,7 +305,19 @@ static uint32_t ramlog_bufferused(FAR struct ramlog_dev_s *priv,
                                   FAR struct ramlog_user_s *upriv)
 {
   uint32_t used = priv->rl_header->rl_head - upriv->rl_tail;
-  return used > priv->rl_bufsize ? priv->rl_bufsize : used;
+
+  used = used > priv->rl_bufsize ? priv->rl_bufsize : used;
+
+#ifdef CONFIG_RAMLOG_DEFERRED
+  /* Count the messages not formatted yet by their size in the ring */
+
+  if (priv == &g_sysdev)
+    {
+      used += g_ramlog_deferred.rd_head - g_ramlog_deferred.rd_tail;
+    }
+#endif
+
+  return used;
 }
 
 /****************************************************************************
@@ -311,6 +379,16 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv)
 static void ramlog_bufferflush(FAR struct ramlog_dev_s *priv)
 {
   FAR struct ramlog_user_s *upriv;
+#ifdef CONFIG_RAMLOG_DEFERRED
+  irqstate_t flags;
+
+  if (priv == &g_sysdev)
+    {
+      flags = spin_lock_irqsave_notrace(&g_ramlog_deferred.rd_lock);
+      g_ramlog_deferred.rd_tail = g_ramlog_deferred.rd_head;
+      spin_unlock_irqrestore_notrace(&g_ramlog_deferred.rd_lock, flags);
+    }
+#endif
 
   priv->rl_header->rl_head = 0;
   list_for_every_entry(&priv->rl_list, upriv, struct ramlog_user_s, rl_node)
@@ -352,6 +430,41 @@ static void ramlog_copybuf(FAR struct ramlog_dev_s *priv,
   header->rl_head += len;
 }
 
+/****************************************************************************
+ * Name: ramlog_notify
+ *
+ * Description:
+ *   Wake up the readers after something was added to the log.  Called
+ *   within a critical section.
+ *
+ ****************************************************************************/
+
+static void ramlog_notify(FAR struct ramlog_dev_s *priv)
+{
+  /* Lock the scheduler do NOT switch out */
+
+  if (!up_interrupt_context())
+    {
+      sched_lock();
+    }
+
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+  /* Are there threads waiting for read data? */
+
+  ramlog_readnotify(priv);
+#endif
+  /* Notify all poll/select waiters that they can read from the FIFO */
+
+  ramlog_pollnotify(priv);
+
+  /* Unlock the scheduler */
+
+  if (!up_interrupt_context())
+    {
+      sched_unlock();
+    }
+}
+
 /****************************************************************************
  * Name: ramlog_addbuf
  ****************************************************************************/
@@ -395,39 +508,162 @@ static ssize_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
 
   if (len > 0)
     {
-      /* Lock the scheduler do NOT switch out */
+      ramlog_notify(priv);
+    }
 
-      if (!up_interrupt_context())
-        {
-          sched_lock();
-        }
+  /* We always have to return the number of bytes requested and NOT the
+   * number of bytes that were actually written.  Otherwise, callers
+   * probably retry, causing same error condition again.
+   */
 
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      /* Are there threads waiting for read data? */
+  leave_critical_section(flags);
+  return len;
+}
+
+#ifdef CONFIG_RAMLOG_DEFERRED
+
+/****************************************************************************
+ * Name: ramlog_deferred_copyin / ramlog_deferred_copyout
+ *
+ * Description:
+ *   Copy bytes into or out of the deferred ring, wrapping around its end.
+ *
+ ****************************************************************************/
+
+static void ramlog_deferred_copyin(uint32_t pos, FAR const void *src,
+                                   size_t len)
+{
+  FAR uint8_t *buf = g_ramlog_deferred.rd_buffer;
+  uint32_t offset = pos % CONFIG_RAMLOG_DEFERRED_BUFSIZE;
+  uint32_t tail = CONFIG_RAMLOG_DEFERRED_BUFSIZE - offset;
+
+  if (len > tail)
+    {
+      memcpy(&buf[offset], src, tail);
+      memcpy(buf, (FAR const uint8_t *)src + tail, len - tail);
+    }
+  else
+    {
+      memcpy(&buf[offset], src, len);
+    }
+}
+
+static void ramlog_deferred_copyout(uint32_t pos, FAR void *dest,
+                                    size_t len)
+{
+  FAR const uint8_t *buf = g_ramlog_deferred.rd_buffer;
+  uint32_t offset = pos % CONFIG_RAMLOG_DEFERRED_BUFSIZE;
+  uint32_t tail = CONFIG_RAMLOG_DEFERRED_BUFSIZE - offset;
+
+  if (len > tail)
+    {
+      memcpy(dest, &buf[offset], tail);
+      memcpy((FAR uint8_t *)dest + tail, buf, len - tail);
+    }
+  else
+    {
+      memcpy(dest, &buf[offset], len);
+    }
+}
+
+/****************************************************************************
+ * Name: ramlog_deferred_pop
+ *
+ * Description:
+ *   Remove the oldest record from the deferred ring.  The unused part of
+ *   the argument buffer is zeroed, so that a message whose arguments were
+ *   truncated still formats safely.
+ *
+ ****************************************************************************/
+
+static bool ramlog_deferred_pop(FAR struct ramlog_record_s *rec,
+                                FAR char *args)
+{
+  FAR struct ramlog_deferred_s *rd = &g_ramlog_deferred;
+  irqstate_t flags;
+  bool ret = false;
+
+  flags = spin_lock_irqsave_notrace(&rd->rd_lock);
+
+  if (rd->rd_head != rd->rd_tail)
+    {
+      ramlog_deferred_copyout(rd->rd_tail, rec, sizeof(*rec));
+      ramlog_deferred_copyout(rd->rd_tail + sizeof(*rec), args,
+                              rec->rr_len);
+      memset(args + rec->rr_len, 0,
+             CONFIG_RAMLOG_DEFERRED_ARGSIZE - rec->rr_len);
+      rd->rd_tail += sizeof(*rec) + rec->rr_len;
+      ret = true;
+    }
 
-      ramlog_readnotify(priv);
+  spin_unlock_irqrestore_notrace(&rd->rd_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ramlog_deferred_expand
+ *
+ * Description:
+ *   Format all of the deferred records into the text of the syslog RAM
+ *   log, in the reader's context.
+ *
+ ****************************************************************************/
+
+static void ramlog_deferred_expand(void)
+{
+  struct lib_memoutstream_s stream;
+  struct ramlog_record_s rec;
+  char args[CONFIG_RAMLOG_DEFERRED_ARGSIZE];
+  char line[CONFIG_RAMLOG_DEFERRED_LINESIZE];
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;
 #endif
-      /* Notify all poll/select waiters that they can read from the FIFO */
 
-      ramlog_pollnotify(priv);
+  nxmutex_lock(&g_ramlog_deferred.rd_expand);
 
-      /* Unlock the scheduler */
+  while (ramlog_deferred_pop(&rec, args))
+    {
+      lib_memoutstream(&stream, line, sizeof(line));
 
-      if (!up_interrupt_context())
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      clock_ticks2time(&ts, rec.rr_time);
+      lib_sprintf(&stream.common, "[%5ju.%06ld] ",
+                  (uintmax_t)ts.tv_sec, ts.tv_nsec / NSEC_PER_USEC);
+#endif
+#ifdef CONFIG_SMP
+      lib_sprintf(&stream.common, "[CPU%d] ", rec.rr_cpu);
+#endif
+#ifdef CONFIG_SYSLOG_PROCESSID
+      lib_sprintf(&stream.common, "[%2d] ", rec.rr_pid);
+#endif
+#ifdef CONFIG_SYSLOG_PRIORITY
+      lib_sprintf(&stream.common, "[%6s] ",
+                  g_ramlog_priority[rec.rr_priority]);
+#endif
+
+      lib_bsprintf(&stream.common, rec.rr_fmt, args);
+
+      /* Terminate the line, even if it was truncated */
+
+      if (stream.common.nput == 0 ||
+          line[stream.common.nput - 1] != '\n')
         {
-          sched_unlock();
+          if (stream.common.nput == stream.buflen)
+            {
+              stream.common.nput--;
+            }
+
+          line[stream.common.nput++] = '\n';
         }
-    }
 
-  /* We always have to return the number of bytes requested and NOT the
-   * number of bytes that were actually written.  Otherwise, callers
-   * probably retry, causing same error condition again.
-   */
+      ramlog_addbuf(&g_sysdev, line, stream.common.nput);
+    }
 
-  leave_critical_section(flags);
-  return len;
+  nxmutex_unlock(&g_ramlog_deferred.rd_expand);
 }
 
+#endif /* CONFIG_RAMLOG_DEFERRED */
+
 /****************************************************************************
  * Name: ramlog_read
  ****************************************************************************/
@@ -463,6 +699,19 @@ static ssize_t ramlog_file_read(FAR struct file *filep, FAR char *buffer,
 
       if (header->rl_head == upriv->rl_tail)
         {
+#ifdef CONFIG_RAMLOG_DEFERRED
+          /* Format the pending syslog messages first */
+
+          if (priv == &g_sysdev &&
+              g_ramlog_deferred.rd_head != g_ramlog_deferred.rd_tail)
+            {
+              leave_critical_section(flags);
+              ramlog_deferred_expand();
+              flags = enter_critical_section();
+              continue;
+            }
+#endif
+
           /* The circular buffer is empty. */
 
 #ifdef CONFIG_RAMLOG_NONBLOCKING
@@ -582,6 +831,15 @@ static int ramlog_file_ioctl(FAR struct file *filep, int cmd,
   irqstate_t flags;
   int ret = 0;
 
+#if defined(CONFIG_RAMLOG_MMAP) && defined(CONFIG_RAMLOG_DEFERRED)
+  /* Format the pending syslog messages, so that they are in the mapping */
+
+  if (cmd == RAMLOGIOC_GETCURSOR && priv == &g_sysdev)
+    {
+      ramlog_deferred_expand();
+    }
+#endif
+
   flags = enter_critical_section();
 
   switch (cmd)
@@ -628,6 +886,57 @@ static int ramlog_file_ioctl(FAR struct file *filep, int cmd,
           }
         break;
 
+#ifdef CONFIG_RAMLOG_MMAP
+      case RAMLOGIOC_GETCURSOR:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            FAR struct ramlog_cursor_s *cursor =
+              (FAR struct ramlog_cursor_s *)arg;
+            uint32_t head = priv->rl_header->rl_head;
+
+            cursor->lost = 0;
+            if (head - upriv->rl_tail > priv->rl_bufsize)
+              {
+                cursor->lost   = head - priv->rl_bufsize - upriv->rl_tail;
+                upriv->rl_tail = head - priv->rl_bufsize;
+              }
+
+            cursor->offset = offsetof(struct ramlog_header_s, rl_buffer);
+            cursor->size   = priv->rl_bufsize;
+            cursor->head   = head;
+            cursor->tail   = upriv->rl_tail;
+          }
+        break;
+
+      case RAMLOGIOC_ADVANCE:
+        {
+          uint32_t head = priv->rl_header->rl_head;
+          uint32_t nbytes = (uint32_t)arg;
+          uint32_t lost;
+
+          if (nbytes > head - upriv->rl_tail)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          /* Report the consumed bytes that the writer has overrun */
+
+          if (head - upriv->rl_tail > priv->rl_bufsize)
+            {
+              lost = head - priv->rl_bufsize - upriv->rl_tail;
+              ret  = lost > nbytes ? nbytes : lost;
+            }
+
+          upriv->rl_tail += nbytes;
+        }
+        break;
+#endif
+
       default:
         ret = -ENOTTY;
         break;
@@ -637,6 +946,35 @@ static int ramlog_file_ioctl(FAR struct file *filep, int cmd,
   return ret;
 }
 
+/****************************************************************************
+ * Name: ramlog_file_mmap
+ *
+ * Description:
+ *   Map the RAM log header and ring into the reader, see
+ *   RAMLOGIOC_GETCURSOR for the layout.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_MMAP
+static int ramlog_file_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct ramlog_dev_s *priv = inode->i_private;
+  size_t maplen = offsetof(struct ramlog_header_s, rl_buffer) +
+                  priv->rl_bufsize;
+
+  if (map->offset >= 0 && map->offset < maplen &&
+      map->length && map->offset + map->length <= maplen)
+    {
+      map->vaddr = (FAR char *)priv->rl_header + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+#endif
+
 /****************************************************************************
  * Name: ramlog_file_poll
  ****************************************************************************/
@@ -845,4 +1183,66 @@ ssize_t ramlog_write(FAR syslog_channel_t *channel,
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vsyslog
+ *
+ * Description:
+ *   Record a syslog message in the syslog RAM log without formatting it:
+ *   only the format string pointer and the raw arguments are stored, and
+ *   the message is formatted when the log is read.  The oldest messages
+ *   not read yet are discarded when the deferred ring is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_DEFERRED
+int ramlog_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  FAR struct ramlog_deferred_s *rd = &g_ramlog_deferred;
+  struct ramlog_record_s rec;
+  struct ramlog_record_s old;
+  char args[CONFIG_RAMLOG_DEFERRED_ARGSIZE];
+  irqstate_t flags;
+  uint32_t size;
+
+  rec.rr_fmt      = fmt;
+  rec.rr_time     = clock_systime_ticks();
+  rec.rr_pid      = nxsched_gettid();
+  rec.rr_len      = lib_vbspack(args, sizeof(args), fmt, *ap);
+  rec.rr_priority = LOG_PRI(priority);
+#ifdef CONFIG_SMP
+  rec.rr_cpu      = up_cpu_index();
+#else
+  rec.rr_cpu      = 0;
+#endif
+
+  size = sizeof(rec) + rec.rr_len;
+
+  flags = spin_lock_irqsave_notrace(&rd->rd_lock);
+
+  while (CONFIG_RAMLOG_DEFERRED_BUFSIZE - (rd->rd_head - rd->rd_tail) <
+         size)
+    {
+      ramlog_deferred_copyout(rd->rd_tail, &old, sizeof(old));
+      rd->rd_tail += sizeof(old) + old.rr_len;
+    }
+
+  ramlog_deferred_copyin(rd->rd_head, &rec, sizeof(rec));
+  ramlog_deferred_copyin(rd->rd_head + sizeof(rec), args, rec.rr_len);
+  rd->rd_head += size;
+
+  spin_unlock_irqrestore_notrace(&rd->rd_lock, flags);
+
+  /* Wake up the readers, if any */
+
+  if (!list_is_empty(&g_sysdev.rl_list))
+    {
+      flags = enter_critical_section();
+      ramlog_notify(&g_sysdev);
+      leave_critical_section(flags);
+    }
+
+  return 0;
+}
+#endif
+
 #endif /* CONFIG_RAMLOG */
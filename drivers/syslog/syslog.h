@@ -229,6 +229,58 @@ void syslog_add_intbuffer(FAR const char *buffer, size_t buflen);
 void syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_stage_initialize
+ *
+ * Description:
+ *   Start the syslog flusher thread that drains the per-CPU staging
+ *   buffers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STAGING
+int syslog_stage_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: syslog_stage_write
+ *
+ * Description:
+ *   Stage a message in the buffer of the current CPU for the flusher
+ *   thread, without ever blocking on a channel.
+ *
+ * Input Parameters:
+ *   buffer   - The buffer containing the data to be output
+ *   buflen   - The number of bytes in the buffer
+ *   canblock - The caller may wait for space in the buffer
+ *
+ * Returned Value:
+ *   The number of bytes accepted, or -EAGAIN if the caller must write the
+ *   message to the channels itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STAGING
+ssize_t syslog_stage_write(FAR const char *buffer, size_t buflen,
+                           bool canblock);
+#endif
+
+/****************************************************************************
+ * Name: syslog_stage_flush
+ *
+ * Description:
+ *   Write out everything staged so far from the calling context, with the
+ *   force() method of the channels.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_STAGING
+void syslog_stage_flush(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_write_foreach
  *
@@ -76,6 +76,12 @@ int syslog_flush(void)
   syslog_flush_intbuffer(true);
 #endif
 
+#ifdef CONFIG_SYSLOG_STAGING
+  /* Write out the messages not yet taken by the flusher thread */
+
+  syslog_stage_flush();
+#endif
+
   for (i = 0; i < CONFIG_SYSLOG_MAX_CHANNELS; i++)
     {
       FAR syslog_channel_t *channel = g_syslog_channel[i];
@@ -0,0 +1,462 @@
+/****************************************************************************
+ * drivers/syslog/syslog_staging.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_STAGING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_STAGING_BUFSIZE & (CONFIG_SYSLOG_STAGING_BUFSIZE - 1))
+#  error CONFIG_SYSLOG_STAGING_BUFSIZE must be a power of two
+#endif
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_STAGE_NRINGS  CONFIG_SMP_NCPUS
+#  define SYSLOG_STAGE_CPU()   up_cpu_index()
+#else
+#  define SYSLOG_STAGE_NRINGS  1
+#  define SYSLOG_STAGE_CPU()   0
+#endif
+
+#define SYSLOG_STAGE_MASK      (CONFIG_SYSLOG_STAGING_BUFSIZE - 1)
+#define SYSLOG_STAGE_HDRSIZE   sizeof(struct syslog_stage_hdr_s)
+#define SYSLOG_STAGE_MAXLEN    (CONFIG_SYSLOG_STAGING_BUFSIZE - \
+                                SYSLOG_STAGE_HDRSIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every syslog_write() is staged as one record: a header followed by the
+ * message bytes, wrapping around the end of the ring.
+ */
+
+struct syslog_stage_hdr_s
+{
+  uint32_t seq;               /* Global order of the record */
+  uint32_t len;               /* Number of message bytes */
+};
+
+/* Each CPU owns one ring and is its only producer, with its interrupts
+ * disabled; the flusher is the only consumer.  The head and tail are free
+ * running, so the two sides never need a common lock.
+ */
+
+struct syslog_stage_s
+{
+  atomic_t head;              /* Written by the producer CPU */
+  atomic_t tail;              /* Written by the consumer */
+  uint8_t  buffer[CONFIG_SYSLOG_STAGING_BUFSIZE];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_stage_s g_syslog_stage[SYSLOG_STAGE_NRINGS];
+
+static atomic_t g_syslog_stage_seq;       /* Next record number */
+static atomic_t g_syslog_stage_dropped;   /* Bytes dropped since reported */
+static atomic_t g_syslog_stage_waiters;   /* Writers waiting for space */
+static pid_t    g_syslog_stage_pid = -1;  /* The flusher thread */
+
+static sem_t    g_syslog_stage_wake = SEM_INITIALIZER(0);
+static sem_t    g_syslog_stage_space = SEM_INITIALIZER(0);
+static mutex_t  g_syslog_stage_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_stage_copyin / syslog_stage_copyout
+ *
+ * Description:
+ *   Copy bytes into or out of a ring at a free running position.
+ *
+ ****************************************************************************/
+
+static void syslog_stage_copyin(FAR struct syslog_stage_s *stage,
+                                uint32_t pos, FAR const void *src,
+                                size_t len)
+{
+  size_t off = pos & SYSLOG_STAGE_MASK;
+  size_t n = CONFIG_SYSLOG_STAGING_BUFSIZE - off;
+
+  if (n > len)
+    {
+      n = len;
+    }
+
+  memcpy(&stage->buffer[off], src, n);
+  memcpy(stage->buffer, (FAR const uint8_t *)src + n, len - n);
+}
+
+static void syslog_stage_copyout(FAR struct syslog_stage_s *stage,
+                                 uint32_t pos, FAR void *dest, size_t len)
+{
+  size_t off = pos & SYSLOG_STAGE_MASK;
+  size_t n = CONFIG_SYSLOG_STAGING_BUFSIZE - off;
+
+  if (n > len)
+    {
+      n = len;
+    }
+
+  memcpy(dest, &stage->buffer[off], n);
+  memcpy((FAR uint8_t *)dest + n, stage->buffer, len - n);
+}
+
+/****************************************************************************
+ * Name: syslog_stage_put
+ *
+ * Description:
+ *   Append one record to the ring of the current CPU.
+ *
+ * Returned Value:
+ *   true if the record was staged; false if the ring is full.
+ *
+ ****************************************************************************/
+
+static bool syslog_stage_put(FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_stage_s *stage;
+  struct syslog_stage_hdr_s hdr;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  bool staged = false;
+
+  flags = up_irq_save();
+
+  stage = &g_syslog_stage[SYSLOG_STAGE_CPU()];
+  head  = atomic_read(&stage->head);
+  tail  = atomic_read_acquire(&stage->tail);
+
+  if (CONFIG_SYSLOG_STAGING_BUFSIZE - (head - tail) >=
+      SYSLOG_STAGE_HDRSIZE + buflen)
+    {
+      hdr.seq = atomic_fetch_add(&g_syslog_stage_seq, 1);
+      hdr.len = buflen;
+
+      syslog_stage_copyin(stage, head, &hdr, SYSLOG_STAGE_HDRSIZE);
+      syslog_stage_copyin(stage, head + SYSLOG_STAGE_HDRSIZE,
+                          buffer, buflen);
+      atomic_set_release(&stage->head,
+                         head + SYSLOG_STAGE_HDRSIZE + buflen);
+      staged = true;
+    }
+
+  up_irq_restore(flags);
+  return staged;
+}
+
+/****************************************************************************
+ * Name: syslog_stage_drain
+ *
+ * Description:
+ *   Write all of the staged records to the channels, oldest first.
+ *
+ * Input Parameters:
+ *   force - Use the force() method of the channels.
+ *
+ ****************************************************************************/
+
+static void syslog_stage_drain(bool force)
+{
+  FAR struct syslog_stage_s *stage;
+  struct syslog_stage_hdr_s hdr;
+  struct syslog_stage_hdr_s oldest;
+  char msg[48];
+  uint32_t dropped;
+  uint32_t tail;
+  size_t off;
+  size_t n;
+  int next;
+  int i;
+
+  for (; ; )
+    {
+      next = -1;
+      for (i = 0; i < SYSLOG_STAGE_NRINGS; i++)
+        {
+          stage = &g_syslog_stage[i];
+          tail  = atomic_read(&stage->tail);
+          if (atomic_read_acquire(&stage->head) == tail)
+            {
+              continue;
+            }
+
+          syslog_stage_copyout(stage, tail, &hdr, SYSLOG_STAGE_HDRSIZE);
+          if (next < 0 || (int32_t)(hdr.seq - oldest.seq) < 0)
+            {
+              next   = i;
+              oldest = hdr;
+            }
+        }
+
+      if (next < 0)
+        {
+          break;
+        }
+
+      /* Write the record in place, in two pieces if it wraps */
+
+      stage = &g_syslog_stage[next];
+      tail  = atomic_read(&stage->tail) + SYSLOG_STAGE_HDRSIZE;
+      off   = tail & SYSLOG_STAGE_MASK;
+      n     = CONFIG_SYSLOG_STAGING_BUFSIZE - off;
+
+      if (n > oldest.len)
+        {
+          n = oldest.len;
+        }
+
+      syslog_write_foreach((FAR const char *)&stage->buffer[off], n,
+                           force);
+      if (n < oldest.len)
+        {
+          syslog_write_foreach((FAR const char *)stage->buffer,
+                               oldest.len - n, force);
+        }
+
+      atomic_set_release(&stage->tail, tail + oldest.len);
+    }
+
+  dropped = atomic_xchg(&g_syslog_stage_dropped, 0);
+  if (dropped > 0)
+    {
+      n = snprintf(msg, sizeof(msg), "[syslog: %" PRIu32
+                   " bytes dropped]\n", dropped);
+      syslog_write_foreach(msg, n, force);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_stage_release
+ *
+ * Description:
+ *   Wake up the writers waiting for space in the rings.
+ *
+ ****************************************************************************/
+
+static void syslog_stage_release(void)
+{
+  int waiters = atomic_xchg(&g_syslog_stage_waiters, 0);
+
+  while (waiters-- > 0)
+    {
+      nxsem_post(&g_syslog_stage_space);
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_stage_thread
+ *
+ * Description:
+ *   The flusher: the only thread that writes staged records to the
+ *   channels, so that only it blocks on slow channel devices.
+ *
+ ****************************************************************************/
+
+static int syslog_stage_thread(int argc, FAR char *argv[])
+{
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_syslog_stage_wake);
+
+#ifdef CONFIG_SYSLOG_INTBUFFER
+      /* Also write out what was buffered before the flusher started */
+
+      syslog_flush_intbuffer(false);
+#endif
+
+      nxmutex_lock(&g_syslog_stage_lock);
+      syslog_stage_drain(false);
+      nxmutex_unlock(&g_syslog_stage_lock);
+
+      syslog_stage_release();
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_stage_kick
+ *
+ * Description:
+ *   Wake up the flusher unless it is already due to run.
+ *
+ ****************************************************************************/
+
+static void syslog_stage_kick(void)
+{
+  int semcount;
+
+  if (nxsem_get_value(&g_syslog_stage_wake, &semcount) >= 0 &&
+      semcount <= 0)
+    {
+      nxsem_post(&g_syslog_stage_wake);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_stage_initialize
+ *
+ * Description:
+ *   Start the syslog flusher thread.  Until it runs, syslog_stage_write()
+ *   declines all writes and they go straight to the channels.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int syslog_stage_initialize(void)
+{
+  int pid;
+
+  pid = kthread_create("syslog", CONFIG_SYSLOG_STAGING_PRIORITY,
+                       CONFIG_SYSLOG_STAGING_STACKSIZE,
+                       syslog_stage_thread, NULL);
+  if (pid < 0)
+    {
+      return pid;
+    }
+
+  g_syslog_stage_pid = pid;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_stage_write
+ *
+ * Description:
+ *   Stage a message for the flusher thread.  The caller only pays for the
+ *   copy into the ring of its CPU and never blocks on a channel.  When the
+ *   ring is full, a caller that may block waits for the flusher to make
+ *   room (if CONFIG_SYSLOG_STAGING_BLOCK); otherwise the message is
+ *   dropped and counted, and the flusher reports the count in the log.
+ *
+ * Input Parameters:
+ *   buffer   - The message
+ *   buflen   - The length of the message
+ *   canblock - The caller is allowed to block
+ *
+ * Returned Value:
+ *   The number of bytes accepted (staged or dropped), or -EAGAIN if the
+ *   message must be written directly: before the flusher runs, after a
+ *   panic or when written by the flusher itself.
+ *
+ ****************************************************************************/
+
+ssize_t syslog_stage_write(FAR const char *buffer, size_t buflen,
+                           bool canblock)
+{
+  size_t len = buflen;
+
+  if (g_syslog_stage_pid < 0 || OSINIT_IS_PANIC() ||
+      (!up_interrupt_context() && nxsched_gettid() == g_syslog_stage_pid))
+    {
+      return -EAGAIN;
+    }
+
+  /* A message larger than a whole ring is truncated */
+
+  if (len > SYSLOG_STAGE_MAXLEN)
+    {
+      atomic_fetch_add(&g_syslog_stage_dropped, len - SYSLOG_STAGE_MAXLEN);
+      len = SYSLOG_STAGE_MAXLEN;
+    }
+
+  while (!syslog_stage_put(buffer, len))
+    {
+#ifdef CONFIG_SYSLOG_STAGING_BLOCK
+      if (canblock)
+        {
+          /* Register as a waiter before the flusher can run, so that its
+           * release cannot be missed.
+           */
+
+          atomic_fetch_add(&g_syslog_stage_waiters, 1);
+          nxsem_post(&g_syslog_stage_wake);
+          nxsem_wait_uninterruptible(&g_syslog_stage_space);
+          continue;
+        }
+#endif
+
+      atomic_fetch_add(&g_syslog_stage_dropped, len);
+      break;
+    }
+
+  syslog_stage_kick();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: syslog_stage_flush
+ *
+ * Description:
+ *   Write out everything staged so far from the calling context, with the
+ *   force() method of the channels.
+ *
+ * Assumptions:
+ *   Called from the panic paths through syslog_flush().  The flusher lock
+ *   is not taken, as the flusher may never run again.
+ *
+ ****************************************************************************/
+
+void syslog_stage_flush(void)
+{
+  syslog_stage_drain(true);
+}
+
+#endif /* CONFIG_SYSLOG_STAGING */
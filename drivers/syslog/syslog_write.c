@@ -244,6 +244,15 @@ ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 {
   bool force = !syslog_safe_to_block();
 
+#ifdef CONFIG_SYSLOG_STAGING
+  /* Hand the message over to the flusher thread if it is running */
+
+  if (syslog_stage_write(buffer, buflen, !force) >= 0)
+    {
+      return buflen;
+    }
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   if (force)
     {
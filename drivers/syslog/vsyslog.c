@@ -34,6 +34,7 @@
 #include <nuttx/init.h>
 #include <nuttx/clock.h>
 #include <nuttx/streams.h>
+#include <nuttx/syslog/ramlog.h>
 #include <nuttx/syslog/syslog.h>
 
 #include "syslog.h"
@@ -96,6 +97,12 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  endif
 #endif
 
+#ifdef CONFIG_RAMLOG_DEFERRED
+  /* Leave the formatting to the reader of the RAM log */
+
+  return ramlog_vsyslog(priority, fmt, ap);
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.
    */
@@ -72,14 +72,40 @@
 #  define CONFIG_CDCECM_NINTERFACES 1
 #endif
 
+/* Number of bulk requests kept in flight and NTB aggregation tuning */
+
+#ifndef CONFIG_CDCNCM_NRDREQS
+#  define CONFIG_CDCNCM_NRDREQS 2
+#endif
+
+#ifndef CONFIG_CDCNCM_NWRREQS
+#  define CONFIG_CDCNCM_NWRREQS 2
+#endif
+
+#ifndef CONFIG_CDCNCM_NTB_INSIZE
+#  define CONFIG_CDCNCM_NTB_INSIZE 16384
+#endif
+
+#ifndef CONFIG_CDCNCM_NTB_OUTSIZE
+#  define CONFIG_CDCNCM_NTB_OUTSIZE 16384
+#endif
+
+#ifndef CONFIG_CDCNCM_TX_MAXDGRAMS
+#  define CONFIG_CDCNCM_TX_MAXDGRAMS 32
+#endif
+
+#ifndef CONFIG_CDCNCM_TX_COMBINE_MSEC
+#  define CONFIG_CDCNCM_TX_COMBINE_MSEC 1
+#endif
+
 /* TX timeout = 1 minute */
 
 #define CDCNCM_TXTIMEOUT             (60*CLK_TCK)
-#define CDCNCM_DGRAM_COMBINE_PERIOD   1
+#define CDCNCM_DGRAM_COMBINE_PERIOD  CONFIG_CDCNCM_TX_COMBINE_MSEC
 
-#define NTB_DEFAULT_IN_SIZE           16384
-#define NTB_OUT_SIZE                  16384
-#define TX_MAX_NUM_DPE                32
+#define NTB_DEFAULT_IN_SIZE          CONFIG_CDCNCM_NTB_INSIZE
+#define NTB_OUT_SIZE                 CONFIG_CDCNCM_NTB_OUTSIZE
+#define TX_MAX_NUM_DPE               CONFIG_CDCNCM_TX_MAXDGRAMS
 
 /* NCM Transfer Block Parameter Structure */
 
@@ -307,11 +333,12 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  struct usbdev_reqpool_s     rdpool;      /* Read requests */
+  sq_queue_t                  rdready;     /* Received NTBs to be parsed */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  struct usbdev_reqpool_s     wrpool;      /* Write requests */
+  FAR struct usbdev_req_s    *wrreq;       /* NTB being filled, or NULL */
+  sem_t                       wrreq_idle;  /* Counts the free wrpool NTBs */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -371,7 +398,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *priv,
+                           FAR struct usbdev_req_s *req);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -855,6 +883,17 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 
   if (self->dgramcount == 0)
     {
+      /* Start a new NTB in a free write request.  The previous ones may
+       * still be in flight.
+       */
+
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+
+      self->wrreq = usbdev_reqpool_get(&self->wrpool);
+      DEBUGASSERT(self->wrreq != NULL);
+
       /* Fill NCB */
 
       tmp = self->wrreq->buf;
@@ -918,12 +957,11 @@ static void cdcncm_transmit_work(FAR void *arg)
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
+  /* The NTB may have been sent already by cdcncm_send() */
 
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->dgramcount == 0 || self->wrreq == NULL)
     {
+      return;
     }
 
   ncblen   = opts->nthsize;
@@ -949,7 +987,13 @@ static void cdcncm_transmit_work(FAR void *arg)
 
   self->wrreq->len = totallen;
 
-  EP_SUBMIT(self->epbulkin, self->wrreq);
+  if (EP_SUBMIT(self->epbulkin, self->wrreq) < 0)
+    {
+      usbdev_reqpool_put(&self->wrpool, self->wrreq);
+      nxsem_post(&self->wrreq_idle);
+    }
+
+  self->wrreq = NULL;
 }
 
 /****************************************************************************
@@ -1007,10 +1051,11 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = req->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1021,7 +1066,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", req->xfrd);
       return;
     }
 
@@ -1061,7 +1106,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1105,7 +1150,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, req->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1155,19 +1200,33 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct usbdev_poolreq_s *preq;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Parse the received NTBs in order of arrival and give each read request
+   * back to the endpoint.  The other read requests stay queued in the
+   * meantime, so the host can keep sending.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
-      cdcncm_receive(self);
-      netdev_lower_rxready(&self->dev);
-
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      preq  = (FAR struct usbdev_poolreq_s *)sq_remfirst(&self->rdready);
       leave_critical_section(flags);
+
+      if (preq == NULL)
+        {
+          break;
+        }
+
+      cdcncm_receive(self, preq->req);
+      netdev_lower_rxready(&self->dev);
+
+      if (self->config == CDCECM_CONFIGID_NONE ||
+          EP_SUBMIT(self->epbulkout, preq->req) < 0)
+        {
+          usbdev_reqpool_put(&self->rdpool, preq->req);
+        }
     }
 
   /* Check if a packet transmission just completed.  If so, call
@@ -1294,7 +1353,7 @@ static int cdcncm_send(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
   cdcncm_transmit_format(self, pkt);
   netpkt_free(dev, pkt, NETPKT_TX);
 
-  if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
+  if ((self->wrreq->buf + NTB_DEFAULT_IN_SIZE - self->dgramaddr <
        self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
     {
       work_cancel(ETHWORK, &self->delaywork);
@@ -1474,6 +1533,8 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  FAR struct usbdev_poolreq_s *preq = req->priv;
+  irqstate_t flags;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
@@ -1482,20 +1543,26 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          flags = enter_critical_section();
+          sq_addlast(&preq->flink, &self->rdready);
+          leave_critical_section(flags);
+
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
         break;
 
       case -ESHUTDOWN:  /* Disconnection */
+        usbdev_reqpool_put(&self->rdpool, req);
         break;
 
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          if (EP_SUBMIT(self->epbulkout, req) < 0)
+            {
+              usbdev_reqpool_put(&self->rdpool, req);
+            }
         }
         break;
     }
@@ -1519,10 +1586,9 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
-   */
+  /* The write request is available for upcoming NTBs again */
 
+  usbdev_reqpool_put(&self->wrpool, req);
   rc = nxsem_post(&self->wrreq_idle);
 
   if (rc != OK)
@@ -1635,13 +1701,10 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   self->epbulkout->priv = self;
 
-  /* Queue read requests in the bulk OUT endpoint */
+  /* Queue all read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
-
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  ret = usbdev_reqpool_submit(&self->rdpool);
+  if (ret < 0)
     {
       uerr("EP_SUBMIT failed. ret %d\n", ret);
       goto error;
@@ -2535,33 +2598,38 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   self->notifyreq->callback = cdcncm_intcomplete;
 
-  /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
+  /* Pre-allocate read requests. The host sends NTBs of up to
+   * NTB_OUT_SIZE bytes.
+   */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  sq_init(&self->rdready);
+  ret = usbdev_reqpool_init(&self->rdpool, self->epbulkout,
+                            CONFIG_CDCNCM_NRDREQS, NTB_OUT_SIZE,
+                            cdcncm_rdcomplete);
+  if (ret < 0)
     {
       uerr("Out of memory\n");
-      ret = -ENOMEM;
       goto error;
     }
 
-  self->rdreq->callback = cdcncm_rdcomplete;
-
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+  /* Pre-allocate write requests. We send NTBs of up to
+   * NTB_DEFAULT_IN_SIZE bytes.
+   */
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
+  ret = usbdev_reqpool_init(&self->wrpool, self->epbulkin,
+                            CONFIG_CDCNCM_NWRREQS, NTB_DEFAULT_IN_SIZE,
+                            cdcncm_wrcomplete);
+  if (ret < 0)
     {
       uerr("Out of memory\n");
-      ret = -ENOMEM;
       goto error;
     }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
+  /* All write requests just allocated are available now. */
 
-  /* The single write request just allocated is available now. */
-
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  self->wrreq      = NULL;
+  self->dgramcount = 0;
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCNCM_NWRREQS);
 
   if (ret != OK)
     {
@@ -2633,11 +2701,8 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
-    {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
-    }
+  sq_init(&self->rdready);
+  usbdev_reqpool_uninit(&self->rdpool);
 
   /* Free the bulk OUT endpoint */
 
@@ -2651,11 +2716,9 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
-    {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
-    }
+  self->wrreq      = NULL;
+  self->dgramcount = 0;
+  usbdev_reqpool_uninit(&self->wrpool);
 
   /* Free the bulk IN endpoint */
 
@@ -24,11 +24,12 @@
  * Included Files
  ****************************************************************************/
 
-#include <nuttx/usb/usbdev.h>
+#include <assert.h>
+#include <errno.h>
 
-#ifndef CONFIG_USBDEV_DMA
-#  include <nuttx/kmalloc.h>
-#endif
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/usb/usbdev.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -112,3 +113,159 @@ void usbdev_freereq(FAR struct usbdev_ep_s *ep,
       EP_FREEREQ(ep, req);
     }
 }
+
+/****************************************************************************
+ * Name: usbdev_reqpool_init
+ *
+ * Description:
+ *   Allocate nreqs requests of len bytes for ep and put them in the free
+ *   list of the pool.
+ *
+ ****************************************************************************/
+
+int usbdev_reqpool_init(FAR struct usbdev_reqpool_s *pool,
+                        FAR struct usbdev_ep_s *ep, int nreqs, size_t len,
+                        CODE void (*callback)(FAR struct usbdev_ep_s *ep,
+                                              FAR struct usbdev_req_s *req))
+{
+  FAR struct usbdev_poolreq_s *preq;
+  int i;
+
+  DEBUGASSERT(pool != NULL && ep != NULL && nreqs > 0 && nreqs <= 65535);
+
+  pool->ep    = ep;
+  pool->nreqs = 0;
+  pool->nfree = 0;
+  sq_init(&pool->freeq);
+
+  pool->reqs = kmm_zalloc(nreqs * sizeof(struct usbdev_poolreq_s));
+  if (pool->reqs == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < nreqs; i++)
+    {
+      preq      = &pool->reqs[i];
+      preq->req = usbdev_allocreq(ep, len);
+      if (preq->req == NULL)
+        {
+          usbdev_reqpool_uninit(pool);
+          return -ENOMEM;
+        }
+
+      preq->req->callback = callback;
+      preq->req->priv     = preq;
+      sq_addlast(&preq->flink, &pool->freeq);
+      pool->nreqs++;
+      pool->nfree++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usbdev_reqpool_uninit
+ *
+ * Description:
+ *   Free all requests of the pool.  The endpoint must have been disabled,
+ *   requests that are still owned by the class driver are freed as well.
+ *
+ ****************************************************************************/
+
+void usbdev_reqpool_uninit(FAR struct usbdev_reqpool_s *pool)
+{
+  int i;
+
+  if (pool->reqs == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < pool->nreqs; i++)
+    {
+      usbdev_freereq(pool->ep, pool->reqs[i].req);
+    }
+
+  kmm_free(pool->reqs);
+  pool->reqs  = NULL;
+  pool->nreqs = 0;
+  pool->nfree = 0;
+  sq_init(&pool->freeq);
+}
+
+/****************************************************************************
+ * Name: usbdev_reqpool_get
+ *
+ * Description:
+ *   Take a request from the free list, or return NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR struct usbdev_req_s *usbdev_reqpool_get(
+                                      FAR struct usbdev_reqpool_s *pool)
+{
+  FAR struct usbdev_poolreq_s *preq;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  preq  = (FAR struct usbdev_poolreq_s *)sq_remfirst(&pool->freeq);
+  if (preq != NULL)
+    {
+      pool->nfree--;
+    }
+
+  leave_critical_section(flags);
+  return preq != NULL ? preq->req : NULL;
+}
+
+/****************************************************************************
+ * Name: usbdev_reqpool_put
+ *
+ * Description:
+ *   Return a request to the free list.
+ *
+ ****************************************************************************/
+
+void usbdev_reqpool_put(FAR struct usbdev_reqpool_s *pool,
+                        FAR struct usbdev_req_s *req)
+{
+  FAR struct usbdev_poolreq_s *preq = req->priv;
+  irqstate_t flags;
+
+  DEBUGASSERT(preq != NULL && preq->req == req);
+
+  flags = enter_critical_section();
+  sq_addlast(&preq->flink, &pool->freeq);
+  pool->nfree++;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: usbdev_reqpool_submit
+ *
+ * Description:
+ *   Submit every request of the free list to the endpoint.
+ *
+ ****************************************************************************/
+
+int usbdev_reqpool_submit(FAR struct usbdev_reqpool_s *pool)
+{
+  FAR struct usbdev_req_s *req;
+  int nsubmitted = 0;
+  int ret = -ENOENT;
+
+  while ((req = usbdev_reqpool_get(pool)) != NULL)
+    {
+      ret = EP_SUBMIT(pool->ep, req);
+      if (ret < 0)
+        {
+          usbdev_reqpool_put(pool, req);
+          break;
+        }
+
+      nsubmitted++;
+    }
+
+  return nsubmitted > 0 ? nsubmitted : ret;
+}
@@ -2251,6 +2251,20 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR uint8_t *dest;
   int nbytes;
   int ret;
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+  uint32_t nsectors;
+
+  /* Whole sectors can be read straight into a request when the sector is
+   * a multiple of the packet size, so that only the last request of the
+   * transfer ends with a short packet.
+   */
+
+  nsectors = CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize;
+  if (lun->sectorsize % priv->epbulkin->maxpacket != 0)
+    {
+      nsectors = 0;
+    }
+#endif
 
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have used up all of the write requests that we
@@ -2261,6 +2275,60 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
+#ifdef CONFIG_USBMSC_RDMULTIPLE
+      /* Read as many sectors as fit directly into the next free request
+       * and submit it.  The block driver reads the following sectors while
+       * the DCD sends the requests already queued on the bulk IN endpoint.
+       */
+
+      if (nsectors > 0 && priv->nsectbytes <= 0 && priv->nreqbytes == 0)
+        {
+          privreq = (FAR struct usbmsc_req_s *)sq_peek(&priv->wrreqlist);
+          if (!privreq)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+              return -ENOMEM;
+            }
+
+          req   = privreq->req;
+          nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector,
+                                   MIN(priv->u.xfrlen, nsectors));
+          if (nread <= 0)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
+                       -nread);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          priv->u.xfrlen -= nread;
+          priv->sector   += nread;
+
+          flags = spin_lock_irqsave(&priv->spinlock);
+          sq_remfirst(&priv->wrreqlist);
+          spin_unlock_irqrestore(&priv->spinlock, flags);
+
+          req->len      = nread * lun->sectorsize;
+          req->priv     = privreq;
+          req->callback = usbmsc_wrcomplete;
+          req->flags    = 0;
+
+          ret           = EP_SUBMIT(priv->epbulkin, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADSUBMIT),
+                       (uint16_t)-ret);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          priv->residue -= req->len;
+          continue;
+        }
+#endif
+
       /* Is the I/O buffer empty? */
 
       if (priv->nsectbytes <= 0)
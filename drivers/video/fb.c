@@ -101,6 +101,10 @@ struct fb_paninfo_s
   FAR struct circbuf_s     buf;        /* Pan buffer queued list             */
   struct wdog_s            wdog;       /* VSync offset timer                 */
   FAR struct fb_chardev_s *dev;
+  uint32_t                 queued;     /* Frames added to the queue          */
+  uint32_t                 retired;    /* Frames removed from the queue      */
+  uint32_t                 xoffset;    /* Pan offset of last retired frame   */
+  uint32_t                 yoffset;
 };
 
 /* This structure defines one framebuffer device.  Note that which is
@@ -114,6 +118,7 @@ struct fb_chardev_s
   FAR struct fb_vtable_s  *vtable;         /* Framebuffer interface          */
   uint8_t                  plane;          /* Video plan number              */
   clock_t                  vsyncoffset;    /* VSync offset ticks             */
+  uint32_t                 vsyncs;         /* VSync count                    */
   FAR struct fb_priv_s    *head;
   FAR struct fb_paninfo_s *paninfo;       /* Pan info array                  */
   size_t                   paninfo_count; /* Pan info count                  */
@@ -136,6 +141,8 @@ static FAR struct circbuf_s *fb_get_panbuf(FAR struct fb_chardev_s *fb,
 static int     fb_add_paninfo(FAR struct fb_chardev_s *fb,
                               FAR const union fb_paninfo_u *info,
                               int overlay);
+static int     fb_get_panstate(FAR struct fb_chardev_s *fb,
+                               FAR struct fb_panstate_s *state);
 static int     fb_clear_paninfo(FAR struct fb_chardev_s *fb,
                                 int overlay);
 static int     fb_open(FAR struct file *filep);
@@ -374,6 +381,10 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
     {
       gwarn("WARNING: circbuf_write(panbuf) failed\n");
     }
+  else
+    {
+      fb->paninfo[overlay + 1].queued++;
+    }
 
   /* Re-enable interrupts */
 
@@ -381,6 +392,38 @@ static int fb_add_paninfo(FAR struct fb_chardev_s *fb,
   return ret <= 0 ? -ENOSPC : OK;
 }
 
+/****************************************************************************
+ * Name: fb_get_panstate
+ ****************************************************************************/
+
+static int fb_get_panstate(FAR struct fb_chardev_s *fb,
+                           FAR struct fb_panstate_s *state)
+{
+  FAR struct fb_paninfo_s *paninfo;
+  irqstate_t flags;
+
+  DEBUGASSERT(fb != NULL && state != NULL);
+
+  if (state->overlay < FB_NO_OVERLAY ||
+      state->overlay + 1 >= (int)fb->paninfo_count)
+    {
+      return -EINVAL;
+    }
+
+  paninfo = &fb->paninfo[state->overlay + 1];
+
+  flags = enter_critical_section();
+
+  state->queued  = paninfo->queued;
+  state->retired = paninfo->retired;
+  state->vsyncs  = fb->vsyncs;
+  state->xoffset = paninfo->xoffset;
+  state->yoffset = paninfo->yoffset;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
 /****************************************************************************
  * Name: fb_clear_paninfo
  ****************************************************************************/
@@ -408,6 +451,10 @@ static int fb_clear_paninfo(FAR struct fb_chardev_s *fb,
 
   circbuf_reset(panbuf);
 
+  /* The dropped frames will never be shown, release their buffers */
+
+  fb->paninfo[overlay + 1].retired = fb->paninfo[overlay + 1].queued;
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
@@ -1314,6 +1361,13 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case FBIOGET_PANSTATE:
+        {
+          ret = fb_get_panstate(fb,
+                           (FAR struct fb_panstate_s *)((uintptr_t)arg));
+        }
+        break;
+
       default:
         if (fb->vtable->ioctl != NULL)
           {
@@ -1699,6 +1753,7 @@ void fb_notify_vsync(FAR struct fb_vtable_s *vtable)
   if (fb != NULL)
     {
       flags = enter_critical_section();
+      fb->vsyncs++;
       for (priv = fb->head; priv; priv = priv->flink)
         {
           /* Notify that the vsync comes. */
@@ -1777,8 +1832,10 @@ int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
 
 int fb_remove_paninfo(FAR struct fb_vtable_s *vtable, int overlay)
 {
+  FAR struct fb_paninfo_s *paninfo;
   FAR struct circbuf_s    *panbuf;
   FAR struct fb_chardev_s *fb;
+  union fb_paninfo_u       info;
   irqstate_t               flags;
   ssize_t                  ret;
   bool                     full;
@@ -1803,9 +1860,29 @@ int fb_remove_paninfo(FAR struct fb_vtable_s *vtable, int overlay)
 
   /* Attempt to take a frame from the pan info. */
 
-  ret = circbuf_skip(panbuf, sizeof(union fb_paninfo_u));
+  ret = circbuf_read(panbuf, &info, sizeof(union fb_paninfo_u));
   DEBUGASSERT(ret <= 0 || ret == sizeof(union fb_paninfo_u));
 
+  /* Its buffer is no longer scanned out */
+
+  if (ret == sizeof(union fb_paninfo_u))
+    {
+      paninfo = &fb->paninfo[overlay + 1];
+      paninfo->retired++;
+#ifdef CONFIG_FB_OVERLAY
+      if (overlay != FB_NO_OVERLAY)
+        {
+          paninfo->xoffset = info.overlayinfo.xoffset;
+          paninfo->yoffset = info.overlayinfo.yoffset;
+        }
+      else
+#endif
+        {
+          paninfo->xoffset = info.planeinfo.xoffset;
+          paninfo->yoffset = info.planeinfo.yoffset;
+        }
+    }
+
   /* Re-enable interrupts */
 
   leave_critical_section(flags);
@@ -27,6 +27,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -46,15 +47,26 @@
 
 /* Block feature bits */
 
+#define VIRTIO_BLK_F_SIZE_MAX       1  /* Max size of any single segment */
+#define VIRTIO_BLK_F_SEG_MAX        2  /* Max number of segments */
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE ZEROES */
+
+/* Discard/write zeroes segment flags */
+
+#define VIRTIO_BLK_WRITE_ZEROES_FLAG_UNMAP (1 << 0)
 
 /* Block request return status */
 
@@ -67,6 +79,21 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* One request queue per CPU at most */
+
+#ifdef CONFIG_SMP
+#  define VIRTIO_BLK_MAX_QUEUES     CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_BLK_MAX_QUEUES     1
+#endif
+
+/* Max data segments of one read/write request, the out and in headers
+ * take two more descriptors.
+ */
+
+#define VIRTIO_BLK_MAX_SEGS         16
+#define VIRTIO_BLK_MAX_DESCS        (VIRTIO_BLK_MAX_SEGS + 2)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -115,10 +142,35 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* Discard/write zeroes segment */
+
+begin_packed_struct struct virtio_blk_discard_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
+/* Request queue, the requests of every queue are submitted and completed
+ * independently, so the callers running on different CPUs don't contend.
+ */
+
+struct virtio_blk_queue_s
+{
+  FAR struct virtqueue         *vq;             /* Virtqueue */
+  spinlock_t                    lock;           /* Lock */
+  sem_t                         slots;          /* Free request slots */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio device */
-  spinlock_t                    lock;           /* Lock */
+  struct virtio_blk_queue_s     queue[VIRTIO_BLK_MAX_QUEUES];
+  uint8_t                       nqueues;        /* Request queue numbers */
+  uint8_t                       nsegs;          /* Max data segments */
+  uint32_t                      size_max;       /* Max segment size */
+  uint32_t                      max_discard;    /* Max discard sectors */
+  uint32_t                      max_zeroes;     /* Max zeroes sectors */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
   char                          name[NAME_MAX]; /* Device name */
@@ -146,6 +198,9 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+static int     virtio_blk_trim(FAR struct virtio_blk_priv_s *priv,
+                               uint32_t type, blkcnt_t startsector,
+                               blkcnt_t nsectors);
 
 /* Other functions */
 
@@ -184,6 +239,20 @@ static int g_virtio_blk_idx = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_blk_queue
+ *
+ * Description:
+ *   Select the request queue of the calling CPU
+ *
+ ****************************************************************************/
+
+static inline FAR struct virtio_blk_queue_s *
+virtio_blk_queue(FAR struct virtio_blk_priv_s *priv)
+{
+  return &priv->queue[this_cpu() % priv->nqueues];
+}
+
 /****************************************************************************
  * Name: virtio_blk_wait_complete
  *
@@ -192,17 +261,17 @@ static int g_virtio_blk_idx = 0;
  *
  ****************************************************************************/
 
-static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
+static void virtio_blk_wait_complete(FAR struct virtio_blk_queue_s *queue,
                                      FAR sem_t *respsem)
 {
-  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
   FAR sem_t *sem;
 
   if (up_interrupt_context() || OSINIT_IS_PANIC())
     {
       for (; ; )
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+          sem = virtqueue_get_buffer_lock(queue->vq, NULL, NULL,
+                                          &queue->lock);
           if (sem == respsem)
             {
               break;
@@ -220,84 +289,143 @@ static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
 }
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_submit
  *
  * Description:
- *   Common function for read and write
+ *   Submit one request to the queue of the calling CPU and wait for its
+ *   completion.  The caller waits for a free request slot first, so that
+ *   as many requests as the virtqueue can hold are in flight at the same
+ *   time instead of failing when the virtqueue is full.
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             FAR struct virtqueue_buf *vb,
+                             int readnum, int writenum)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  FAR struct virtio_blk_queue_s *queue = virtio_blk_queue(priv);
+  bool polling = up_interrupt_context() || OSINIT_IS_PANIC();
   irqstate_t flags;
   sem_t respsem;
-  ssize_t ret;
-  int readnum;
-
-  nxsem_init(&respsem, 0, 0);
-
-  /* Build the block request */
-
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
+  int ret;
 
-  /* Fill the virtqueue buffer:
-   * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
-   */
+  if (!polling)
+    {
+      nxsem_wait_uninterruptible(&queue->slots);
+    }
 
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  readnum = write ? 2 : 1;
+  nxsem_init(&respsem, 0, 0);
 
   if (up_interrupt_context())
     {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
+      virtqueue_disable_cb_lock(queue->vq, &queue->lock);
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  flags = spin_lock_irqsave(&queue->lock);
+  ret = virtqueue_add_buffer(queue->vq, vb, readnum, writenum, &respsem);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
+      spin_unlock_irqrestore(&queue->lock, flags);
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
       goto err;
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  virtqueue_kick(queue->vq);
+  spin_unlock_irqrestore(&queue->lock, flags);
 
   /* Wait for the request completion */
 
-  virtio_blk_wait_complete(vq, &respsem);
+  virtio_blk_wait_complete(queue, &respsem);
 
-  if (resp.status != VIRTIO_BLK_S_OK)
+err:
+  if (up_interrupt_context())
     {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
+      virtqueue_enable_cb_lock(queue->vq, &queue->lock);
     }
 
-err:
-  if (up_interrupt_context())
+  if (!polling)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      nxsem_post(&queue->slots);
     }
 
-  return ret >= 0 ? nsectors : ret;
+  nxsem_destroy(&respsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write
+ *
+ ****************************************************************************/
+
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  FAR struct virtqueue_buf vb[VIRTIO_BLK_MAX_DESCS];
+  FAR uint8_t *buf = buffer;
+  struct virtio_blk_resp_s resp;
+  struct virtio_blk_req_s req;
+  size_t remain = (size_t)nsectors * priv->block_size;
+  uint64_t sector;
+  size_t reqlen;
+  size_t seglen;
+  int nsegs;
+  int ret;
+
+  sector = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+
+  while (remain > 0)
+    {
+      /* Build the block request */
+
+      req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+      req.reserved = 0;
+      req.sector   = sector;
+      resp.status  = VIRTIO_BLK_S_IOERR;
+
+      /* Fill the virtqueue buffer:
+       * Buffer 0: the block out header;
+       * Buffer 1~n: the read/write buffer, split into the segments allowed
+       *             by the device;
+       * Buffer n+1: the block in header, return the status.
+       */
+
+      vb[0].buf = &req;
+      vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+
+      for (nsegs = 0, reqlen = 0; remain > 0 && nsegs < priv->nsegs; )
+        {
+          seglen = MIN(remain, priv->size_max);
+          vb[++nsegs].buf = buf;
+          vb[nsegs].len   = seglen;
+          buf            += seglen;
+          remain         -= seglen;
+          reqlen         += seglen;
+        }
+
+      vb[nsegs + 1].buf = &resp;
+      vb[nsegs + 1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+      ret = virtio_blk_submit(priv, vb, write ? nsegs + 1 : 1,
+                              write ? 1 : nsegs + 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (resp.status != VIRTIO_BLK_S_OK)
+        {
+          vrterr("%s Error\n", write ? "Write" : "Read");
+          return -EIO;
+        }
+
+      sector += reqlen >> VIRTIO_BLK_SECTOR_BITS;
+    }
+
+  return nsectors;
 }
 
 /****************************************************************************
@@ -402,22 +530,16 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: virtio_blk_ioctl
+ * Name: virtio_blk_flush
  ****************************************************************************/
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[2];
   struct virtio_blk_resp_s resp;
   struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
-
   /* Build the block request */
 
   req.type     = VIRTIO_BLK_T_FLUSH;
@@ -430,27 +552,86 @@ static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
   vb[1].buf = &resp;
   vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
-  if (ret < 0)
+  ret = virtio_blk_submit(priv, vb, 1, 1);
+  if (ret >= 0 && resp.status != VIRTIO_BLK_S_OK)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      vrterr("Flush Error\n");
+      ret = -EIO;
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  return ret;
+}
 
-  /* Wait for the request completion */
+/****************************************************************************
+ * Name: virtio_blk_trim
+ *
+ * Description:
+ *   Discard or write zeroes to the specified sectors, the range is split
+ *   into the requests allowed by the device.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_trim(FAR struct virtio_blk_priv_s *priv,
+                           uint32_t type, blkcnt_t startsector,
+                           blkcnt_t nsectors)
+{
+  FAR struct virtqueue_buf vb[3];
+  struct virtio_blk_discard_s seg;
+  struct virtio_blk_resp_s resp;
+  struct virtio_blk_req_s req;
+  uint64_t sector;
+  uint64_t remain;
+  uint32_t maxsectors;
+  int ret;
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+  if (startsector < 0 || nsectors < 0 ||
+      startsector + nsectors > priv->nsectors)
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      return -EINVAL;
     }
 
-  return ret;
+  maxsectors = type == VIRTIO_BLK_T_DISCARD ? priv->max_discard :
+                                              priv->max_zeroes;
+  sector = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+  remain = nsectors * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
+
+  while (remain > 0)
+    {
+      /* Build the block request with one segment */
+
+      req.type        = type;
+      req.reserved    = 0;
+      req.sector      = 0;
+      seg.sector      = sector;
+      seg.num_sectors = MIN(remain, maxsectors);
+      seg.flags       = 0;
+      resp.status     = VIRTIO_BLK_S_IOERR;
+
+      vb[0].buf = &req;
+      vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+      vb[1].buf = &seg;
+      vb[1].len = sizeof(seg);
+      vb[2].buf = &resp;
+      vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+      ret = virtio_blk_submit(priv, vb, 2, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (resp.status != VIRTIO_BLK_S_OK)
+        {
+          vrterr("%s Error\n", type == VIRTIO_BLK_T_DISCARD ?
+                 "Discard" : "Write zeroes");
+          return resp.status == VIRTIO_BLK_S_UNSUPP ? -ENOTSUP : -EIO;
+        }
+
+      sector += seg.num_sectors;
+      remain -= seg.num_sectors;
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -461,6 +642,7 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                             unsigned long arg)
 {
   FAR struct virtio_blk_priv_s *priv;
+  FAR blkcnt_t *range = (FAR blkcnt_t *)((uintptr_t)arg);
   int ret = -ENOTTY;
 
   DEBUGASSERT(inode->i_private);
@@ -474,6 +656,26 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
             ret = virtio_blk_flush(priv);
           }
         break;
+
+      case BIOC_TRIM:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD))
+          {
+            ret = virtio_blk_trim(priv, VIRTIO_BLK_T_DISCARD,
+                                  range[0], range[1]);
+          }
+        break;
+
+      case BIOC_ZEROOUT:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
+          {
+            ret = -EPERM;
+          }
+        else if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+          {
+            ret = virtio_blk_trim(priv, VIRTIO_BLK_T_WRITE_ZEROES,
+                                  range[0], range[1]);
+          }
+        break;
     }
 
   return ret;
@@ -486,11 +688,12 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
+  FAR struct virtio_blk_queue_s *queue = &priv->queue[vq->vq_queue_index];
   FAR sem_t *respsem;
 
   for (; ; )
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &queue->lock);
       if (respsem == NULL)
         {
           break;
@@ -507,33 +710,126 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_MAX_QUEUES];
+  vq_callback callback[VIRTIO_BLK_MAX_QUEUES];
+  FAR struct virtqueue *vq;
+  uint16_t num_queues = 1;
+  uint32_t size_max;
+  uint32_t seg_max;
+  int nslots;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SIZE_MAX) |
+                                  (1UL << VIRTIO_BLK_F_SEG_MAX) |
+                                  (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  /* The segment limits of the read/write requests, the segment size is
+   * kept a multiple of the sector size.
+   */
+
+  priv->nsegs    = VIRTIO_BLK_MAX_SEGS;
+  priv->size_max = INT32_MAX & ~(VIRTIO_BLK_SECTOR_SIZE - 1);
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SEG_MAX))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s, seg_max,
+                                &seg_max);
+      if (seg_max > 0 && seg_max < priv->nsegs)
+        {
+          priv->nsegs = seg_max;
+        }
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SIZE_MAX))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s, size_max,
+                                &size_max);
+      size_max &= ~(VIRTIO_BLK_SECTOR_SIZE - 1);
+      if (size_max > 0 && size_max < priv->size_max)
+        {
+          priv->size_max = size_max;
+        }
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->max_discard);
+      if (priv->max_discard == 0)
+        {
+          priv->max_discard = UINT32_MAX;
+        }
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors,
+                                &priv->max_zeroes);
+      if (priv->max_zeroes == 0)
+        {
+          priv->max_zeroes = UINT32_MAX;
+        }
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &num_queues);
+    }
+
+  priv->nqueues = MAX(MIN(num_queues, VIRTIO_BLK_MAX_QUEUES), 1);
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, priv->nqueues, vqname, callback,
+                                 NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
       return ret;
     }
 
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      vq = vdev->vrings_info[i].vq;
+
+      /* Every request takes at most nsegs + 2 descriptors */
+
+      priv->nsegs = MIN(priv->nsegs, vq->vq_nentries - 2);
+      nslots      = MAX(vq->vq_nentries / (priv->nsegs + 2), 1);
+
+      priv->queue[i].vq = vq;
+      spin_lock_init(&priv->queue[i].lock);
+      nxsem_init(&priv->queue[i].slots, 0, nslots);
+    }
+
+  vrtinfo("Virtio blk queues=%u segs=%u size_max=%" PRIu32 "\n",
+          priv->nqueues, priv->nsegs, priv->size_max);
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtqueue_enable_cb(priv->queue[i].vq);
+    }
+
   return ret;
 }
 
@@ -544,9 +840,15 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
 static void virtio_blk_uninit(FAR struct virtio_blk_priv_s *priv)
 {
   FAR struct virtio_device *vdev = priv->vdev;
+  int i;
 
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      nxsem_destroy(&priv->queue[i].slots);
+    }
 }
 
 /****************************************************************************
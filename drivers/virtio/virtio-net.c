@@ -26,14 +26,19 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/sched.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
 
@@ -45,31 +50,104 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_HOST_TSO6  12
+#define VIRTIO_NET_F_MRG_RXBUF  15
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM  1
+#define VIRTIO_NET_HDR_F_DATA_VALID  2
+
+#define VIRTIO_NET_HDR_GSO_NONE      0
+#define VIRTIO_NET_HDR_GSO_TCPV4     1
+#define VIRTIO_NET_HDR_GSO_TCPV6     4
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_OK                0
+#define VIRTIO_NET_ERR               1
+
+#define VIRTIO_NET_CTRL_MQ           4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+#define VIRTIO_NET_CTRL_RETRY        1000
+
+/* Checksum offload needs the per-packet state, and TSO is only allowed
+ * together with the checksum offload.
+ */
+
+#if defined(CONFIG_NETDEV_CSUM_OFFLOAD) && defined(CONFIG_NET_GSO)
+#  define VIRTIO_NET_HAVE_TSO
+#endif
+
+/* One queue pair per CPU at most */
+
+#if defined(CONFIG_NETDEV_MULTIQUEUE) && defined(CONFIG_SMP)
+#  define VIRTIO_NET_HAVE_MQ
+#  define VIRTIO_NET_MAX_PAIRS \
+     MIN(CONFIG_SMP_NCPUS, CONFIG_NETDEV_MAX_QUEUES)
+#else
+#  define VIRTIO_NET_MAX_PAIRS  1
+#endif
+
+/* Virtio net header size and packet buffer size, the header is 2 bytes
+ * shorter (without num_buffers) if VIRTIO_NET_F_MRG_RXBUF is not
+ * negotiated.
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
-#define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
+#define VIRTIO_NET_LEGACY_HDRSIZE \
+    (offsetof(struct virtio_net_hdr_s, num_buffers))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* The mergeable RX buffer is the data room of a single IOB */
+
+#define VIRTIO_NET_MRG_BUFSIZE \
+    (CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN)
+
+/* Virtio net virtqueue index and number, the RX and TX virtqueues of the
+ * queue pairs are interleaved, followed by the control virtqueue.
+ */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+#define VIRTIO_NET_RXQ(q)     ((q) * VIRTIO_NET_NUM + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     ((q) * VIRTIO_NET_NUM + VIRTIO_NET_TX)
+#define VIRTIO_NET_IS_RXQ(id) ((id) % VIRTIO_NET_NUM == VIRTIO_NET_RX)
+#define VIRTIO_NET_QUEUE(vq)  ((vq)->vq_queue_index / VIRTIO_NET_NUM)
+#define VIRTIO_NET_MAX_VQS    (VIRTIO_NET_MAX_PAIRS * VIRTIO_NET_NUM)
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* A TSO packet is limited to 64KiB of IP datagram */
+
+#ifdef VIRTIO_NET_HAVE_TSO
+#  define VIRTIO_NET_GSO_PKTSIZE \
+     MIN(CONFIG_NET_GSO_MAXSEGS * CONFIG_NET_ETH_PKTSIZE, ETH_HDRLEN + 65535)
+#  define VIRTIO_NET_TX_NIOB \
+     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN + VIRTIO_NET_GSO_PKTSIZE + \
+       CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+#else
+#  define VIRTIO_NET_TX_NIOB  VIRTIO_NET_MAX_NIOB
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
+/* Virtio net header, num_buffers only exists if VIRTIO_NET_F_MRG_RXBUF
+ * is negotiated.
  */
 
 begin_packed_struct struct virtio_net_hdr_s
@@ -80,6 +158,17 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t gso_size;
   uint16_t csum_start;
   uint16_t csum_offset;
+  uint16_t num_buffers;
+} end_packed_struct;
+
+/* Virtio net control command of VIRTIO_NET_CTRL_MQ class */
+
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t virtqueue_pairs;
+  uint8_t  ack;                        /* Written by the device */
 } end_packed_struct;
 
 /* The definition of the struct virtio_net_config refers to the link
@@ -113,38 +202,56 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_MAX_VQS];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       rxbufnum;  /* RX buffer number per queue */
+  uint16_t                  rxbufsize; /* RX buffer data length */
+  uint8_t                   hdrsize;   /* Virtio net header size */
+  uint8_t                   npairs;    /* Queue pairs in use */
+  bool                      mergeable; /* Single IOB RX buffers */
+
+  /* RX buffers posted to the RX virtqueue of each queue pair */
+
+  int                       rxnum[VIRTIO_NET_MAX_PAIRS];
+
+#ifdef VIRTIO_NET_HAVE_MQ
+  struct virtio_net_ctrl_mq_s ctrl;    /* Control command */
+#endif
+
+  /* Buffer lists of the packet being added, all of the lower half
+   * operations are serialized by the netdev lock of the upper half.
+   */
+
+  struct virtqueue_buf      vb[VIRTIO_NET_TX_NIOB + 1];
+  struct iovec              iov[VIRTIO_NET_TX_NIOB];
 };
 
-/* Virtio Link Layer Header, follow shows the iob buffer layout:
+/* Follow shows the iob buffer layout, the virtio net header is put right in
+ * front of the ETH header, and the netpkt itself is the virtqueue cookie:
+ *
+ * |<------- CONFIG_NET_LL_GUARDSIZE ------>|
+ * +------+---------------+---------------+------------+------+     +------+
+ * | free | Virtio Header |  ETH Header   |    data    | free | --> | next |
+ * +------+---------------+---------------+------------+------+     +------+
+ * |                      |<--------- datalen -------->|
+ * ^base                  ^data
  *
- * |<-- CONFIG_NET_LL_GUARDSIZE -->|
- * +---------------+---------------+------------+------+     +-------------+
- * | Virtio Header |  ETH Header   |    data    | free | --> | next netpkt |
- * +---------------+---------------+------------+------+     +-------------+
- * |               |<--------- datalen -------->|
- * ^base           ^data
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_HDRSIZE + ETH_HDR_SIZE
+ *                          = 12 + 14
+ *                          = 26
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
- *                          = sizeof(uintptr) + 10 + 14
- *                          = 32 (64-Bit)
- *                          = 28 (32-Bit)
+ * With VIRTIO_NET_F_MRG_RXBUF, the device writes a packet across several
+ * RX buffers and only the first one starts with the virtio net header, the
+ * data of the others starts right at the virtio header position.
  */
 
-begin_packed_struct struct virtio_net_llhdr_s
-{
-  FAR netpkt_t           *pkt;         /* Netpaket pointer */
-  struct virtio_net_hdr_s vhdr;        /* Virtio net header */
-} end_packed_struct;
-
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_HDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
-              " + VIRTIO_NET_LLHDRSIZE");
+              " + VIRTIO_NET_HDRSIZE");
 
 /****************************************************************************
  * Private Function Prototypes
@@ -155,6 +262,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, unsigned int queue);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       unsigned int queue);
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -195,7 +306,13 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  NULL,                   /* rxenable */
+  virtio_net_send_queue,
+  virtio_net_recv_queue,
+  NULL                    /* rxenable_queue */
+#endif
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -206,6 +323,111 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_net_txoffload
+ *
+ * Description:
+ *   Fill the checksum and segmentation offload fields of the virtio net
+ *   header of a TX packet.  The device checksums the packet from
+ *   csum_start to the end into the TCP/UDP checksum field, which has to
+ *   hold the checksum of the pseudo header before.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+static void virtio_net_txoffload(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt,
+                                 FAR struct virtio_net_hdr_s *hdr)
+{
+  FAR uint8_t *l3 = IOB_DATA(pkt);
+  FAR uint8_t *l4;
+  uint16_t gso_size = 0;
+  uint16_t iphdrlen;
+  uint16_t offset;
+  uint32_t sum;
+  uint8_t gso_type;
+  uint8_t proto;
+
+#ifdef VIRTIO_NET_HAVE_TSO
+  gso_size = netpkt_gso_size(dev, pkt);
+#endif
+
+  if (!netpkt_csum_needed(pkt) && gso_size == 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((l3[0] >> 4) == 4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)l3;
+
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      proto    = ipv4->proto;
+      gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+      sum      = ((ipv4->len[0] << 8) + ipv4->len[1]) - iphdrlen + proto;
+      sum      = chksum(sum, (FAR const uint8_t *)ipv4->srcipaddr,
+                        2 * sizeof(in_addr_t));
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((l3[0] >> 4) == 6)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)l3;
+
+      /* The payload length of a TSO packet may reach 64KiB */
+
+      iphdrlen = IPv6_HDRLEN;
+      proto    = ipv6->proto;
+      gso_type = VIRTIO_NET_HDR_GSO_TCPV6;
+      sum      = ((ipv6->len[0] << 8) + ipv6->len[1]) + proto;
+      sum      = chksum((sum & 0xffff) + (sum >> 16),
+                        (FAR const uint8_t *)ipv6->srcipaddr,
+                        2 * sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+      return;
+    }
+
+  if (proto == IP_PROTO_TCP)
+    {
+      offset = offsetof(struct tcp_hdr_s, tcpchksum);
+    }
+  else if (proto == IP_PROTO_UDP && gso_size == 0)
+    {
+      offset = offsetof(struct udp_hdr_s, udpchksum);
+    }
+  else
+    {
+      return;
+    }
+
+  /* The stack builds all of the headers in the first IOB */
+
+  DEBUGASSERT(pkt->io_len >= iphdrlen + offset + sizeof(uint16_t));
+
+  l4              = l3 + iphdrlen;
+  l4[offset]      = (uint8_t)(sum >> 8);
+  l4[offset + 1]  = (uint8_t)sum;
+
+  hdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  hdr->csum_start  = NET_LL_HDRLEN(&dev->netdev) + iphdrlen;
+  hdr->csum_offset = offset;
+
+  if (gso_size != 0)
+    {
+      FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)l4;
+
+      hdr->gso_type = gso_type;
+      hdr->gso_size = gso_size;
+      hdr->hdr_len  = hdr->csum_start + ((tcp->tcpoffset >> 4) << 2);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
@@ -215,23 +437,31 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
                                 unsigned int vq_id)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  FAR struct virtqueue_buf *vb = priv->vb;
+  FAR struct iovec *iov = priv->iov;
+  FAR struct virtio_net_hdr_s *hdr;
+  irqstate_t flags;
   int iov_cnt;
+  int ret;
   int i;
 
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_TX_NIOB);
 
-  /* Alloc cookie and net header from transport layer */
+  /* Put the net header in front of the packet data */
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)iov[0].iov_base - VIRTIO_NET_LLHDRSIZE);
+  hdr = (FAR struct virtio_net_hdr_s *)
+          ((FAR uint8_t *)iov[0].iov_base - priv->hdrsize);
   DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
-  hdr->pkt = pkt;
+  memset(hdr, 0, priv->hdrsize);
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  if (!VIRTIO_NET_IS_RXQ(vq_id))
+    {
+      virtio_net_txoffload(dev, pkt, hdr);
+    }
+#endif
 
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
@@ -239,23 +469,21 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     {
       /* Append the virtio net header to the first buffer */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
+      vb[0].buf = hdr;
+      vb[0].len = iov[0].iov_len + priv->hdrsize;
 
-#if VIRTIO_NET_MAX_NIOB > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
           vb[i].len = iov[i].iov_len;
         }
-#endif
     }
   else
     {
       /* Buffer 0 is only for virtio net header */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len = VIRTIO_NET_HDRSIZE;
+      vb[0].buf = hdr;
+      vb[0].len = priv->hdrsize;
 
       for (i = 0; i < iov_cnt; i++)
         {
@@ -267,30 +495,41 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+
+  /* A TSO packet may need more descriptors than those left */
+
+  flags = spin_lock_irqsave(&priv->lock[vq_id]);
+  if (vq->vq_free_cnt < iov_cnt)
+    {
+      ret = -ENOSPC;
+    }
+  else if (VIRTIO_NET_IS_RXQ(vq_id))
     {
-      return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
-                                       &priv->lock[vq_id]);
+      ret = virtqueue_add_buffer(vq, vb, 0, iov_cnt, pkt);
     }
   else
     {
-      return virtqueue_add_buffer_lock(vq, vb, iov_cnt, 0, hdr,
-                                       &priv->lock[vq_id]);
+      ret = virtqueue_add_buffer(vq, vb, iov_cnt, 0, pkt);
     }
+
+  spin_unlock_irqrestore(&priv->lock[vq_id], flags);
+  return ret;
 }
 
 /****************************************************************************
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev,
+                              unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  unsigned int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; priv->rxnum[queue] < priv->rxbufnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -303,8 +542,7 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, priv->rxbufsize) < priv->rxbufsize)
         {
           vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
           netpkt_free(dev, pkt, NETPKT_RX);
@@ -313,12 +551,18 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, vq, pkt, vq_id) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxnum[queue]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
@@ -329,22 +573,30 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct virtqueue *vq;
+  FAR netpkt_t *pkt;
+  unsigned int vq_id;
+  unsigned int i;
 
-  while (1)
+  for (i = 0; i < priv->npairs; i++)
     {
-      /* Get buffer from tx virtqueue */
+      vq_id = VIRTIO_NET_TXQ(i);
+      vq = priv->vdev->vrings_info[vq_id].vq;
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
-      if (hdr == NULL)
+      while (1)
         {
-          break;
-        }
+          /* Get buffer from tx virtqueue */
+
+          pkt = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                          &priv->lock[vq_id]);
+          if (pkt == NULL)
+            {
+              break;
+            }
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+          netpkt_free(dev, pkt, NETPKT_TX);
+          vrtinfo("Free, vq=%u, pkt: %p\n", vq_id, pkt);
+        }
     }
 }
 
@@ -355,6 +607,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  unsigned int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -371,9 +624,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+                               &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -396,7 +652,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->npairs * VIRTIO_NET_NUM; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -416,82 +672,188 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_send_queue
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  unsigned int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  unsigned int i;
+  int ret;
 
   /* Check the send length */
 
+#ifdef VIRTIO_NET_HAVE_TSO
+  if (netpkt_gso_size(dev, pkt) != 0)
+    {
+      if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_GSO_PKTSIZE ||
+          iob_count(pkt) > VIRTIO_NET_TX_NIOB)
+        {
+          vrterr("net send TSO buffer too large\n");
+          return -EINVAL;
+        }
+    }
+  else
+#endif
   if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
     }
 
-  /* Add buffer to vq and notify the other side */
+  /* Add buffer to vq and notify the other side, reclaim the sent buffers
+   * first if the descriptors have run out.
+   */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  ret = virtio_net_addbuffer(dev, vq, pkt, vq_id);
+  if (ret == -ENOSPC)
+    {
+      virtio_net_txfree(dev);
+      ret = virtio_net_addbuffer(dev, vq, pkt, vq_id);
+    }
+
+  if (ret < 0)
+    {
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]);
+      return ret;
+    }
+
+  virtqueue_kick_lock(vq, &priv->lock[vq_id]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
   virtio_net_txfree(dev);
 
-  /* If we have no buffer left, enable TX done callback. */
+  /* If we have no buffer left, enable TX done callback, the buffers may
+   * be held by any of the TX queues.
+   */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      for (i = 0; i < priv->npairs; i++)
+        {
+          vq_id = VIRTIO_NET_TXQ(i);
+          virtqueue_enable_cb_lock(priv->vdev->vrings_info[vq_id].vq,
+                                   &priv->lock[vq_id]);
+        }
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       unsigned int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  unsigned int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  FAR struct virtio_net_hdr_s *hdr;
+  FAR netpkt_t *pkt;
   irqstate_t flags;
   uint32_t len;
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  FAR netpkt_t *seg;
+  uint16_t nbufs;
+#endif
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, queue);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  flags = spin_lock_irqsave(&priv->lock[vq_id]);
+  pkt = virtqueue_get_buffer(vq, &len, NULL);
+  if (pkt == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(&priv->lock[vq_id], flags);
     }
 
+  priv->rxnum[queue]--;
+
   /* Set the received pkt length */
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+  hdr = (FAR struct virtio_net_hdr_s *)
+          (netpkt_getdata(dev, pkt) - priv->hdrsize);
+  netpkt_setdatalen(dev, pkt, len - priv->hdrsize);
+  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, pkt, len);
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  /* A packet needing the checksum comes from the host itself, its data
+   * is as safe as one already verified.
+   */
+
+  if ((hdr->flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                     VIRTIO_NET_HDR_F_DATA_VALID)) != 0)
+    {
+      netpkt_set_csum_verified(pkt);
+    }
+#endif
+
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  /* Chain the IOBs of the other buffers of the packet, whose data starts
+   * where the virtio net header would be, and give the quota of their
+   * netpkts back.
+   */
+
+  for (nbufs = priv->mergeable ? hdr->num_buffers : 1; nbufs > 1; nbufs--)
+    {
+      seg = virtqueue_get_buffer_lock(vq, &len, NULL, &priv->lock[vq_id]);
+      if (seg == NULL)
+        {
+          vrterr("Missing %u buffers of the packet\n", nbufs - 1);
+          netpkt_free(dev, pkt, NETPKT_RX);
+          return virtio_net_recv_queue(dev, queue);
+        }
+
+      priv->rxnum[queue]--;
+
+      seg->io_offset -= NET_LL_HDRLEN(&dev->netdev) + priv->hdrsize;
+      seg->io_len     = len;
+      seg->io_pktlen  = len;
+
+      iob_concat(pkt, seg);
+      atomic_fetch_add(&dev->quota_ptr[NETPKT_RX], 1);
+    }
+#endif
+
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_queue(dev, 0);
 }
 
 #ifdef CONFIG_NET_MCASTGROUP
@@ -536,8 +898,19 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
-  netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                                 VIRTIO_NET_QUEUE(vq));
+    }
+  else
+#endif
+    {
+      netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+    }
 }
 
 /****************************************************************************
@@ -548,10 +921,61 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_queues
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used, it only uses the first
+ *   one until then.  The command is only sent once at probe time, so
+ *   simply poll the control virtqueue for the reply.
+ *
+ ****************************************************************************/
+
+#ifdef VIRTIO_NET_HAVE_MQ
+static int virtio_net_set_queues(FAR struct virtio_net_priv_s *priv,
+                                 FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_ctrl_mq_s *ctrl = &priv->ctrl;
+  struct virtqueue_buf vb[2];
+  int retry;
+  int ret;
+
+  ctrl->class           = VIRTIO_NET_CTRL_MQ;
+  ctrl->cmd             = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  ctrl->virtqueue_pairs = priv->npairs;
+  ctrl->ack             = VIRTIO_NET_ERR;
+
+  vb[0].buf = ctrl;
+  vb[0].len = offsetof(struct virtio_net_ctrl_mq_s, ack);
+  vb[1].buf = &ctrl->ack;
+  vb[1].len = sizeof(ctrl->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 1, 1, ctrl);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+
+  for (retry = 0; virtqueue_get_buffer(vq, NULL, NULL) == NULL; retry++)
+    {
+      if (retry >= VIRTIO_NET_CTRL_RETRY)
+        {
+          return -ETIMEDOUT;
+        }
+
+      nxsched_usleep(1000);
+    }
+
+  return ctrl->ack == VIRTIO_NET_OK ? OK : -EIO;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -559,50 +983,159 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint64_t features;
+  unsigned int nvqs = VIRTIO_NET_NUM;
+  unsigned int i;
   int ret;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
-  priv->vdev = vdev;
-  vdev->priv = priv;
+  for (i = 0; i < VIRTIO_NET_MAX_VQS; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
+
+  priv->vdev   = vdev;
+  priv->npairs = 1;
+  vdev->priv   = priv;
 
   /* Initialize the virtio device */
 
+  features = (1UL << VIRTIO_NET_F_MAC) | (1UL << VIRTIO_F_ANY_LAYOUT);
+#ifdef CONFIG_DRIVERS_VIRTIO_NET_MRG_RXBUF
+  features |= 1UL << VIRTIO_NET_F_MRG_RXBUF;
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  features |= (1UL << VIRTIO_NET_F_CSUM) | (1UL << VIRTIO_NET_F_GUEST_CSUM);
+#endif
+#ifdef VIRTIO_NET_HAVE_TSO
+  features |= (1UL << VIRTIO_NET_F_HOST_TSO4) |
+              (1UL << VIRTIO_NET_F_HOST_TSO6);
+#endif
+#ifdef VIRTIO_NET_HAVE_MQ
+  features |= (1UL << VIRTIO_NET_F_CTRL_VQ) | (1UL << VIRTIO_NET_F_MQ);
+#endif
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
-                                  (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
+  virtio_negotiate_features(vdev, features, NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  /* The header has num_buffers with VIRTIO_NET_F_MRG_RXBUF, but the small
+   * RX buffers need the header and data in one descriptor.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      priv->hdrsize   = VIRTIO_NET_HDRSIZE;
+      priv->mergeable = virtio_has_feature(vdev, VIRTIO_F_ANY_LAYOUT);
+    }
+  else
+    {
+      priv->hdrsize   = VIRTIO_NET_LEGACY_HDRSIZE;
+    }
+
+  priv->rxbufsize = priv->mergeable ? VIRTIO_NET_MRG_BUFSIZE :
+                                      VIRTIO_NET_BUFSIZE;
+
+#ifdef VIRTIO_NET_HAVE_MQ
+  /* The control virtqueue follows all of the queue pairs of the device,
+   * even if only some of them are used.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      uint16_t maxpairs = 1;
+
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      if (maxpairs > 1)
+        {
+          priv->npairs = MIN(maxpairs, VIRTIO_NET_MAX_PAIRS);
+          nvqs         = maxpairs * VIRTIO_NET_NUM + 1;
+        }
+    }
+#endif
+
+  vqnames   = kmm_malloc(nvqs * sizeof(*vqnames));
+  callbacks = kmm_malloc(nvqs * sizeof(*callbacks));
+  if (vqnames == NULL || callbacks == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  for (i = 0; i < nvqs; i++)
+    {
+      if (i == nvqs - 1 && nvqs % VIRTIO_NET_NUM != 0)
+        {
+          vqnames[i]   = "virtio_net_ctrl";
+          callbacks[i] = NULL;
+        }
+      else if (VIRTIO_NET_IS_RXQ(i))
+        {
+          vqnames[i]   = "virtio_net_rx";
+          callbacks[i] = i < priv->npairs * VIRTIO_NET_NUM ?
+                         virtio_net_rxready : NULL;
+        }
+      else
+        {
+          vqnames[i]   = "virtio_net_tx";
+          callbacks[i] = i < priv->npairs * VIRTIO_NET_NUM ?
+                         virtio_net_txdone : NULL;
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
-      return ret;
+      goto out;
     }
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#ifdef VIRTIO_NET_HAVE_MQ
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_set_queues(priv, vdev->vrings_info[nvqs - 1].vq);
+      if (ret < 0)
+        {
+          vrtwarn("Set %u queue pairs failed, ret=%d\n", priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts, shared by the queues.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = MAX(CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4 /
+                     priv->npairs, 1);
 #endif
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
                      (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  return OK;
+
+  /* The single IOB RX buffers take the same IOBs as the full ones */
+
+  priv->rxbufnum = priv->bufnum;
+  if (priv->mergeable)
+    {
+      priv->rxbufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs,
+                           priv->bufnum * VIRTIO_NET_MAX_NIOB);
+    }
+
+  ret = OK;
+
+out:
+  kmm_free(callbacks);
+  kmm_free(vqnames);
+  return ret;
 }
 
 static void virtio_net_set_macaddr(FAR struct virtio_net_priv_s *priv)
@@ -631,6 +1164,44 @@ static void virtio_net_set_macaddr(FAR struct virtio_net_priv_s *priv)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_offload
+ ****************************************************************************/
+
+static void virtio_net_set_offload(FAR struct virtio_net_priv_s *priv)
+{
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  FAR struct net_driver_s *dev =
+                   &((FAR struct netdev_lowerhalf_s *)&priv->lower)->netdev;
+  FAR struct virtio_device *vdev = priv->vdev;
+
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      return;
+    }
+
+  dev->d_features |= NETDEV_TX_CSUM;
+
+#  ifdef VIRTIO_NET_HAVE_TSO
+#    ifdef CONFIG_NET_IPv4
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4))
+    {
+      return;
+    }
+#    endif
+
+#    ifdef CONFIG_NET_IPv6
+  if (!virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO6))
+    {
+      return;
+    }
+#    endif
+
+  dev->d_features |= NETDEV_TX_TSO;
+#  endif
+#endif
+}
+
 /****************************************************************************
  * Name: virtio_net_probe
  ****************************************************************************/
@@ -658,10 +1229,22 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxbufnum * priv->npairs;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->npairs;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Poll the RX queue of each pair on the thread of its own CPU */
+
+  netdev->nqueues = priv->npairs;
+  if (priv->npairs > 1)
+    {
+      netdev->rxtype = NETDEV_RX_THREAD_RSS;
+    }
+#endif
+
+  virtio_net_set_offload(priv);
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
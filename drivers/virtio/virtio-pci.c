@@ -482,7 +482,8 @@ uint64_t
 virtio_pci_negotiate_features(FAR struct virtio_device *vdev,
                               uint64_t features)
 {
-  features = features & vdev->func->get_features(vdev);
+  features |= VIRTIO_TRANSPORT_FEATURES;
+  features &= vdev->func->get_features(vdev);
   vdev->func->set_features(vdev, features);
   return features;
 }
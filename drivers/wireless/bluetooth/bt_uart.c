@@ -97,6 +97,8 @@ static void btuart_rxwork(FAR void *arg)
   FAR struct btuart_upperhalf_s *upper;
   enum bt_buf_type_e type;
   unsigned int pktlen;
+  unsigned int offset = 0;
+  FAR uint8_t *pkt;
   ssize_t nread;
   union
     {
@@ -119,18 +121,23 @@ static void btuart_rxwork(FAR void *arg)
 
   upper->rxlen += (uint16_t)nread;
 
-  while (upper->rxlen)
+  /* Pass all complete packets received so far to the stack, then move the
+   * trailing partial packet to the beginning of the buffer once.
+   */
+
+  while (offset < upper->rxlen)
     {
-      hdr = (FAR void *)&upper->rxbuf[H4_HEADER_SIZE];
+      pkt = &upper->rxbuf[offset];
+      hdr = (FAR void *)&pkt[H4_HEADER_SIZE];
 
-      switch (upper->rxbuf[0])
+      switch (pkt[0])
         {
         case H4_EVT:
-          if (upper->rxlen < H4_HEADER_SIZE +
+          if (upper->rxlen - offset < H4_HEADER_SIZE +
               sizeof(struct bt_hci_evt_hdr_s))
             {
               wlwarn("WARNING: Incomplete HCI event header\n");
-              return;
+              goto out;
             }
 
           type = BT_EVT;
@@ -139,11 +146,11 @@ static void btuart_rxwork(FAR void *arg)
           break;
 
         case H4_ACL:
-          if (upper->rxlen < H4_HEADER_SIZE +
+          if (upper->rxlen - offset < H4_HEADER_SIZE +
               sizeof(struct bt_hci_acl_hdr_s))
             {
               wlwarn("WARNING: Incomplete HCI ACL header\n");
-              return;
+              goto out;
             }
 
           type = BT_ACL_IN;
@@ -152,11 +159,11 @@ static void btuart_rxwork(FAR void *arg)
           break;
 
         case H4_ISO:
-          if (upper->rxlen < H4_HEADER_SIZE +
+          if (upper->rxlen - offset < H4_HEADER_SIZE +
               sizeof(struct bt_hci_iso_hdr_s))
             {
               wlwarn("WARNING: Incomplete HCI ISO header\n");
-              return;
+              goto out;
             }
 
           type = BT_ISO_IN;
@@ -165,25 +172,31 @@ static void btuart_rxwork(FAR void *arg)
           break;
 
         default:
-          wlerr("ERROR: Unknown H4 type %u\n", upper->rxbuf[0]);
-          return;
+          wlerr("ERROR: Unknown H4 type %u\n", pkt[0]);
+          goto out;
         }
 
-      if (upper->rxlen < pktlen)
+      if (upper->rxlen - offset < pktlen)
         {
           wlwarn("WARNING: Incomplete packet: rxlen=%u, pktlen=%u\n",
-                 upper->rxlen, pktlen);
-          return;
+                 upper->rxlen - offset, pktlen);
+          break;
         }
 
       /* Pass buffer to the stack */
 
-      BT_DUMP("Received", upper->rxbuf, pktlen);
-      bt_netdev_receive(&upper->dev, type, &upper->rxbuf[H4_HEADER_SIZE],
+      BT_DUMP("Received", pkt, pktlen);
+      bt_netdev_receive(&upper->dev, type, &pkt[H4_HEADER_SIZE],
                         pktlen - H4_HEADER_SIZE);
 
-      upper->rxlen -= pktlen;
-      memmove(upper->rxbuf, upper->rxbuf + pktlen, upper->rxlen);
+      offset += pktlen;
+    }
+
+out:
+  if (offset > 0)
+    {
+      upper->rxlen -= offset;
+      memmove(upper->rxbuf, upper->rxbuf + offset, upper->rxlen);
     }
 }
 
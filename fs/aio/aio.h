@@ -33,6 +33,7 @@
 
 #include <nuttx/queue.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/fs/ioring.h>
 
 #ifdef CONFIG_FS_AIO
 
@@ -60,13 +61,14 @@
 struct file;
 struct aio_container_s
 {
-  dq_entry_t aioc_link;            /* Supports a doubly linked list */
-  FAR struct aiocb *aioc_aiocbp;   /* The contained AIO control block */
-  FAR struct file *aioc_filep;     /* File structure to use with the I/O */
-  struct work_s aioc_work;         /* Used to defer I/O to the work thread */
-  pid_t aioc_pid;                  /* ID of the waiting task */
+  dq_entry_t aioc_link;             /* Supports a doubly linked list */
+  FAR struct aiocb *aioc_aiocbp;    /* The contained AIO control block */
+  FAR struct file *aioc_filep;      /* File structure to use with the I/O */
+  struct work_s aioc_work;          /* Used to defer I/O to the work thread */
+  struct ioring_async_s aioc_async; /* Used to hand I/O to the driver */
+  pid_t aioc_pid;                   /* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t aioc_prio;               /* Priority of the waiting task */
+  uint8_t aioc_prio;                /* Priority of the waiting task */
 #endif
 };
 
@@ -220,6 +222,46 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Offer the asynchronous I/O to the driver with FIOC_AIOSUBMIT.  If the
+ *   driver does not complete transfers on its own, the I/O is scheduled
+ *   on the low priority work queue with aio_queue().
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   opcode - IORING_OP_READ, IORING_OP_WRITE or IORING_OP_FSYNC
+ *   worker - The worker of the work queue fallback
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_submit(FAR struct aio_container_s *aioc, uint8_t opcode,
+               worker_t worker);
+
+#ifdef CONFIG_FS_IORING
+/****************************************************************************
+ * Name: aio_ring_initialize
+ *
+ * Description:
+ *   Register the /dev/ioring submission/completion ring driver.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_ring_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
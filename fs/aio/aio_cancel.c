@@ -128,10 +128,16 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * is no longer queued, or (2) the work has not been started
                * and is still in the work queue.  Only the second case can
                * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * first case.  Transfers handed to a driver are never on the
+               * work queue.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = -EBUSY;
+              if (aioc->aioc_async.complete == NULL)
+                {
+                  status = work_cancel(LPWORK, &aioc->aioc_work);
+                }
+
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending
@@ -185,10 +191,16 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * is no longer queued, or (2) the work has not been started
                * and is still in the work queue.  Only the second case can
                * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * first case.  Transfers handed to a driver are never on the
+               * work queue.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = -EBUSY;
+              if (aioc->aioc_async.complete == NULL)
+                {
+                  status = work_cancel(LPWORK, &aioc->aioc_work);
+                }
+
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending
@@ -100,6 +100,12 @@ void aio_initialize(void)
 
       dq_addlast(&g_aioc_alloc[i].aioc_link, &g_aioc_free);
     }
+
+#ifdef CONFIG_FS_IORING
+  /* Register the submission/completion ring driver */
+
+  aio_ring_initialize();
+#endif
 }
 
 /****************************************************************************
@@ -32,6 +32,11 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <fcntl.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioring.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/wqueue.h>
 
 #include "aio/aio.h"
@@ -42,6 +47,36 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_complete
+ *
+ * Description:
+ *   Completion callback of a transfer that was handed to the driver
+ *
+ ****************************************************************************/
+
+static void aio_complete(FAR struct ioring_async_s *async, ssize_t result)
+{
+  FAR struct aio_container_s *aioc =
+    container_of(async, struct aio_container_s, aioc_async);
+  FAR struct aiocb *aiocbp;
+  pid_t pid;
+
+  pid    = aioc->aioc_pid;
+  aiocbp = aioc_decant(aioc);
+  DEBUGASSERT(aiocbp);
+
+  aiocbp->aio_result = result;
+
+  /* Signal the client */
+
+  aio_signal(pid, aiocbp);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
@@ -98,4 +133,68 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_submit
+ *
+ * Description:
+ *   Offer the asynchronous I/O to the driver, falling back to the low
+ *   priority work queue
+ *
+ * Input Parameters:
+ *   aioc   - Pointer to the AIO control block container
+ *   opcode - IORING_OP_READ, IORING_OP_WRITE or IORING_OP_FSYNC
+ *   worker - The worker of the work queue fallback
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_submit(FAR struct aio_container_s *aioc, uint8_t opcode,
+               worker_t worker)
+{
+  FAR struct ioring_async_s *async = &aioc->aioc_async;
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+  int ret;
+
+  async->filep  = aioc->aioc_filep;
+  async->opcode = opcode;
+  async->buf    = (FAR void *)aiocbp->aio_buf;
+  async->len    = aiocbp->aio_nbytes;
+  async->off    = aiocbp->aio_offset;
+
+  if (opcode == IORING_OP_WRITE &&
+      (aioc->aioc_filep->f_oflags & O_APPEND) != 0)
+    {
+      async->off = -1;
+    }
+
+  /* Hold the lock so that aio_cancel() never sees a transfer that is
+   * being handed over.  The container belongs to the driver as soon as it
+   * accepts it: it may even have completed it already.
+   */
+
+  ret = aio_lock();
+  if (ret >= 0)
+    {
+      async->complete = aio_complete;
+      ret = file_ioctl(aioc->aioc_filep, FIOC_AIOSUBMIT,
+                       (unsigned long)(uintptr_t)async);
+      if (ret != OK)
+        {
+          async->complete = NULL;
+        }
+
+      aio_unlock();
+    }
+
+  if (ret == OK)
+    {
+      return OK;
+    }
+
+  return aio_queue(aioc, worker);
+}
+
 #endif /* CONFIG_FS_AIO */
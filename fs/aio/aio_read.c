@@ -268,9 +268,9 @@ int aio_read(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
-  /* Defer the work to the worker thread */
+  /* Hand the transfer to the driver or defer it to the worker thread */
 
-  ret = aio_queue(aioc, aio_read_worker);
+  ret = aio_submit(aioc, IORING_OP_READ, aio_read_worker);
   if (ret < 0)
     {
       /* The result and the errno have already been set */
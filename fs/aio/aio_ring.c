@@ -0,0 +1,1074 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioring.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_IORING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Request states */
+
+#define IORING_REQ_ACTIVE    0 /* Owned by a driver or a worker thread */
+#define IORING_REQ_QUEUED    1 /* Waiting on the low priority work queue */
+#define IORING_REQ_CANCELED  2 /* Canceled while still queued */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ioring_s;
+
+/* One in-flight operation.  The ring has one request per completion entry
+ * and each request reserves its completion entry when it is submitted, so
+ * the completion ring can never overflow.
+ */
+
+struct ioring_req_s
+{
+  struct ioring_async_s async;    /* The transfer, as seen by a driver */
+  dq_entry_t node;                /* In the free or the in-flight list */
+  struct work_s work;             /* Defers the transfer to LPWORK */
+  FAR struct ioring_s *ring;      /* The ring of the request */
+  uint64_t user_data;             /* Copied to the completion entry */
+  uint32_t msg_flags;             /* Flags of the SEND and RECV operations */
+  uint8_t state;                  /* See IORING_REQ_* */
+};
+
+/* One ring, created by each open of /dev/ioring */
+
+struct ioring_s
+{
+  mutex_t sqlock;                 /* Serializes the submitters */
+  mutex_t cqlock;                 /* Protects the CQ and the request lists */
+  sem_t cqsem;                    /* Completion waiters wait here */
+  atomic_t crefs;                 /* Open, mappings and in-flight requests */
+  FAR struct ioring_rings_s *rings;
+  FAR struct ioring_sqe_s *sqes;
+  FAR struct ioring_cqe_s *cqes;
+  size_t ringsize;                /* Size of the shared memory */
+  uint32_t sqmask;                /* Submission ring size - 1 */
+  uint32_t cqmask;                /* Completion ring size - 1 */
+  uint32_t sqhead;                /* Private copy of rings->sq_head */
+  uint32_t cqtail;                /* Private copy of rings->cq_tail */
+  uint32_t ninflight;             /* Requests not yet completed */
+  uint16_t ncqwaiters;            /* Threads waiting on cqsem */
+  FAR struct ioring_req_s *reqs;  /* One request per completion entry */
+  dq_queue_t freereqs;            /* Available requests */
+  dq_queue_t inflight;            /* Requests not yet completed */
+  FAR struct pollfd *fds[CONFIG_FS_IORING_NPOLLWAITERS];
+  struct iovec bufs[CONFIG_FS_IORING_NBUFFERS];
+  unsigned int nbufs;             /* Number of registered buffers */
+
+  /* Submission queue polling thread */
+
+  FAR struct fdlist *sqlist;      /* Files of the ring's creator */
+  sem_t sqwake;                   /* The idle thread sleeps here */
+  sem_t sqexit;                   /* Posted when the thread exits */
+  clock_t sqidle;                 /* Ticks to poll before sleeping */
+  pid_t sqpid;                    /* The thread, 0 if none */
+  volatile bool sqstop;           /* Asks the thread to exit */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ioring_open(FAR struct file *filep);
+static int ioring_close(FAR struct file *filep);
+static int ioring_ioctl(FAR struct file *filep, int cmd,
+                        unsigned long arg);
+static int ioring_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map);
+static int ioring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ioring_fops =
+{
+  ioring_open,   /* open */
+  ioring_close,  /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  ioring_ioctl,  /* ioctl */
+  ioring_mmap,   /* mmap */
+  NULL,          /* truncate */
+  ioring_poll,   /* poll */
+  NULL,          /* readv */
+  NULL           /* writev */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_release
+ *
+ * Description:
+ *   Drop a reference to a ring, freeing it with the last one.
+ *
+ ****************************************************************************/
+
+static void ioring_release(FAR struct ioring_s *ring)
+{
+  if (atomic_fetch_sub(&ring->crefs, 1) == 1)
+    {
+      nxmutex_destroy(&ring->sqlock);
+      nxmutex_destroy(&ring->cqlock);
+      nxsem_destroy(&ring->cqsem);
+      nxsem_destroy(&ring->sqwake);
+      nxsem_destroy(&ring->sqexit);
+
+      if (ring->rings != NULL)
+        {
+          kumm_free(ring->rings);
+        }
+
+      kmm_free(ring->reqs);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_complete
+ *
+ * Description:
+ *   Post the completion entry of a request and recycle the request.  This
+ *   is also the completion callback handed to the drivers.
+ *
+ ****************************************************************************/
+
+static void ioring_complete(FAR struct ioring_async_s *async,
+                            ssize_t result)
+{
+  FAR struct ioring_req_s *req =
+    container_of(async, struct ioring_req_s, async);
+  FAR struct ioring_s *ring = req->ring;
+  FAR struct ioring_cqe_s *cqe;
+
+  if (async->filep != NULL)
+    {
+      file_put(async->filep);
+    }
+
+  nxmutex_lock(&ring->cqlock);
+
+  cqe            = &ring->cqes[ring->cqtail & ring->cqmask];
+  cqe->user_data = req->user_data;
+  cqe->res       = (int32_t)result;
+  cqe->flags     = 0;
+
+  /* The entry must be visible before the new tail */
+
+  SMP_MB();
+  ring->rings->cq_tail = ++ring->cqtail;
+
+  dq_rem(&req->node, &ring->inflight);
+  dq_addlast(&req->node, &ring->freereqs);
+  ring->ninflight--;
+
+  while (ring->ncqwaiters > 0)
+    {
+      ring->ncqwaiters--;
+      nxsem_post(&ring->cqsem);
+    }
+
+  /* A sleeping SQ thread may have given up on a full completion ring */
+
+  if (ring->sqpid > 0 &&
+      (ring->rings->sq_flags & IORING_SQ_NEED_WAKEUP) != 0)
+    {
+      nxsem_post(&ring->sqwake);
+    }
+
+  poll_notify(ring->fds, CONFIG_FS_IORING_NPOLLWAITERS, POLLIN);
+  nxmutex_unlock(&ring->cqlock);
+
+  ioring_release(ring);
+}
+
+/****************************************************************************
+ * Name: ioring_worker
+ *
+ * Description:
+ *   Perform a transfer that the driver could not take from the low
+ *   priority work queue.
+ *
+ ****************************************************************************/
+
+static void ioring_worker(FAR void *arg)
+{
+  FAR struct ioring_req_s *req = arg;
+  FAR struct ioring_async_s *async = &req->async;
+  FAR struct ioring_s *ring = req->ring;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+#endif
+  ssize_t ret;
+
+  /* A request canceled by ioring_close() is completed there */
+
+  nxmutex_lock(&ring->cqlock);
+  if (req->state == IORING_REQ_CANCELED)
+    {
+      nxmutex_unlock(&ring->cqlock);
+      return;
+    }
+
+  req->state = IORING_REQ_ACTIVE;
+  nxmutex_unlock(&ring->cqlock);
+
+  switch (async->opcode)
+    {
+      case IORING_OP_READ:
+        if (async->off < 0)
+          {
+            ret = file_read(async->filep, async->buf, async->len);
+          }
+        else
+          {
+            ret = file_pread(async->filep, async->buf, async->len,
+                             async->off);
+          }
+        break;
+
+      case IORING_OP_WRITE:
+        if (async->off < 0)
+          {
+            ret = file_write(async->filep, async->buf, async->len);
+          }
+        else
+          {
+            ret = file_pwrite(async->filep, async->buf, async->len,
+                              async->off);
+          }
+        break;
+
+      case IORING_OP_FSYNC:
+        ret = file_fsync(async->filep);
+        break;
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+      case IORING_OP_RECV:
+        psock = file_socket(async->filep);
+        if (psock == NULL)
+          {
+            ret = -ENOTSOCK;
+          }
+        else if (async->opcode == IORING_OP_SEND)
+          {
+            ret = psock_send(psock, async->buf, async->len,
+                             req->msg_flags);
+          }
+        else
+          {
+            ret = psock_recv(psock, async->buf, async->len,
+                             req->msg_flags);
+          }
+        break;
+#endif
+
+      default:
+        ret = -ENOSYS;
+        break;
+    }
+
+  ioring_complete(async, ret);
+}
+
+/****************************************************************************
+ * Name: ioring_issue
+ *
+ * Description:
+ *   Start the operation of one submission entry.  The request is always
+ *   completed, immediately if the entry is invalid.
+ *
+ ****************************************************************************/
+
+static void ioring_issue(FAR struct ioring_s *ring,
+                         FAR struct ioring_req_s *req,
+                         FAR const struct ioring_sqe_s *sqe,
+                         FAR struct fdlist *list)
+{
+  FAR struct ioring_async_s *async = &req->async;
+  FAR struct iovec *iov;
+  uintptr_t addr;
+  int ret;
+
+  memset(async, 0, sizeof(struct ioring_async_s));
+  async->opcode   = sqe->opcode;
+  async->buf      = sqe->addr;
+  async->len      = sqe->len;
+  async->off      = sqe->off < 0 ? -1 : (off_t)sqe->off;
+  async->complete = ioring_complete;
+  req->user_data  = sqe->user_data;
+  req->msg_flags  = sqe->msg_flags;
+  req->state      = IORING_REQ_ACTIVE;
+
+  if (sqe->flags != 0 || sqe->opcode > IORING_OP_WRITE_FIXED)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (sqe->opcode == IORING_OP_NOP)
+    {
+      ret = OK;
+      goto errout;
+    }
+
+  if (sqe->opcode == IORING_OP_READ_FIXED ||
+      sqe->opcode == IORING_OP_WRITE_FIXED)
+    {
+      /* The transfer must lie within the registered buffer */
+
+      if (sqe->buf_index >= ring->nbufs)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      iov  = &ring->bufs[sqe->buf_index];
+      addr = (uintptr_t)sqe->addr;
+      if (addr < (uintptr_t)iov->iov_base ||
+          addr + sqe->len > (uintptr_t)iov->iov_base + iov->iov_len)
+        {
+          ret = -EFAULT;
+          goto errout;
+        }
+
+      async->opcode = sqe->opcode == IORING_OP_READ_FIXED ?
+                      IORING_OP_READ : IORING_OP_WRITE;
+    }
+
+  /* The SQ thread looks the descriptor up in the creator's list */
+
+  if (list != NULL)
+    {
+      ret = fdlist_get(list, sqe->fd, &async->filep);
+    }
+  else
+    {
+      ret = file_get(sqe->fd, &async->filep);
+    }
+
+  if (ret < 0)
+    {
+      async->filep = NULL;
+      goto errout;
+    }
+
+  /* Let the driver complete the transfer by itself if it can */
+
+  if (async->opcode == IORING_OP_READ ||
+      async->opcode == IORING_OP_WRITE ||
+      async->opcode == IORING_OP_FSYNC)
+    {
+      if (file_ioctl(async->filep, FIOC_AIOSUBMIT,
+                     (unsigned long)(uintptr_t)async) == OK)
+        {
+          return;
+        }
+    }
+
+  req->state = IORING_REQ_QUEUED;
+  ret = work_queue(LPWORK, &req->work, ioring_worker, req, 0);
+  if (ret >= 0)
+    {
+      return;
+    }
+
+  req->state = IORING_REQ_ACTIVE;
+
+errout:
+  ioring_complete(async, ret);
+}
+
+/****************************************************************************
+ * Name: ioring_submit
+ *
+ * Description:
+ *   Consume up to 'to_submit' entries of the submission ring.  Entries are
+ *   left on the ring while the completion ring has no room for them.
+ *
+ * Returned Value:
+ *   The number of entries consumed, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int ioring_submit(FAR struct ioring_s *ring,
+                         FAR struct fdlist *list, uint32_t to_submit)
+{
+  FAR struct ioring_rings_s *rings = ring->rings;
+  FAR struct ioring_req_s *req;
+  struct ioring_sqe_s sqe;
+  uint32_t nsubmit = 0;
+  uint32_t ncqes;
+  uint32_t tail;
+  int ret;
+
+  ret = nxmutex_lock(&ring->sqlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Read the entries only after the tail that published them */
+
+  tail = rings->sq_tail;
+  SMP_MB();
+
+  while (ring->sqhead != tail && nsubmit < to_submit)
+    {
+      nxmutex_lock(&ring->cqlock);
+
+      ncqes = ring->cqtail - rings->cq_head;
+      if (ncqes > ring->cqmask || ring->ninflight > ring->cqmask - ncqes)
+        {
+          nxmutex_unlock(&ring->cqlock);
+          break;
+        }
+
+      req = (FAR struct ioring_req_s *)dq_remfirst(&ring->freereqs);
+      DEBUGASSERT(req != NULL);
+
+      dq_addlast(&req->node, &ring->inflight);
+      ring->ninflight++;
+      nxmutex_unlock(&ring->cqlock);
+
+      atomic_fetch_add(&ring->crefs, 1);
+
+      /* Work on a private copy, the application owns the entry again as
+       * soon as sq_head moves past it.
+       */
+
+      memcpy(&sqe, &ring->sqes[ring->sqhead & ring->sqmask],
+             sizeof(struct ioring_sqe_s));
+
+      SMP_MB();
+      rings->sq_head = ++ring->sqhead;
+
+      ioring_issue(ring, req, &sqe, list);
+      nsubmit++;
+    }
+
+  nxmutex_unlock(&ring->sqlock);
+  return (int)nsubmit;
+}
+
+/****************************************************************************
+ * Name: ioring_wait
+ *
+ * Description:
+ *   Wait until the completion ring holds at least 'min_complete' entries,
+ *   or until there is nothing left in flight.
+ *
+ ****************************************************************************/
+
+static int ioring_wait(FAR struct ioring_s *ring, uint32_t min_complete)
+{
+  int ret = OK;
+
+  nxmutex_lock(&ring->cqlock);
+
+  while (ring->cqtail - ring->rings->cq_head < min_complete &&
+         ring->ninflight > 0)
+    {
+      ring->ncqwaiters++;
+      nxmutex_unlock(&ring->cqlock);
+
+      ret = nxsem_wait(&ring->cqsem);
+
+      nxmutex_lock(&ring->cqlock);
+      if (ret < 0)
+        {
+          if (ring->ncqwaiters > 0)
+            {
+              ring->ncqwaiters--;
+            }
+
+          break;
+        }
+    }
+
+  nxmutex_unlock(&ring->cqlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_sqthread
+ *
+ * Description:
+ *   Submission queue polling thread of an IORING_SETUP_SQPOLL ring.  It
+ *   polls the submission ring until it has been idle for sq_thread_idle,
+ *   then sets IORING_SQ_NEED_WAKEUP and sleeps until IORING_ENTER_SQ_WAKEUP.
+ *
+ ****************************************************************************/
+
+static int ioring_sqthread(int argc, FAR char *argv[])
+{
+  FAR struct ioring_s *ring =
+    (FAR struct ioring_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct ioring_rings_s *rings = ring->rings;
+  clock_t start = clock_systime_ticks();
+
+  while (!ring->sqstop)
+    {
+      if (ioring_submit(ring, ring->sqlist, UINT32_MAX) > 0)
+        {
+          start = clock_systime_ticks();
+        }
+      else if (clock_systime_ticks() - start < ring->sqidle)
+        {
+          sched_yield();
+        }
+      else
+        {
+          /* Look once more after raising the flag:  an entry queued
+           * before the application could see the flag is picked up here,
+           * any later one comes with a wake up.
+           */
+
+          rings->sq_flags |= IORING_SQ_NEED_WAKEUP;
+          SMP_MB();
+
+          if (ioring_submit(ring, ring->sqlist, UINT32_MAX) <= 0 &&
+              !ring->sqstop)
+            {
+              nxsem_wait_uninterruptible(&ring->sqwake);
+            }
+
+          rings->sq_flags &= ~IORING_SQ_NEED_WAKEUP;
+          start = clock_systime_ticks();
+        }
+    }
+
+  nxsem_post(&ring->sqexit);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_setup
+ ****************************************************************************/
+
+static int ioring_setup(FAR struct ioring_s *ring,
+                        FAR struct ioring_params_s *params)
+{
+  FAR struct ioring_rings_s *rings;
+  FAR char *argv[2];
+  char arg1[32];
+  uint32_t sqentries;
+  uint32_t cqentries;
+  uint32_t i;
+  int ret;
+
+  if (params == NULL || params->sq_entries == 0 ||
+      params->sq_entries > CONFIG_FS_IORING_MAXENTRIES ||
+      (params->flags & ~IORING_SETUP_SQPOLL) != 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&ring->sqlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ring->rings != NULL)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  sqentries = 1;
+  while (sqentries < params->sq_entries)
+    {
+      sqentries <<= 1;
+    }
+
+  cqentries = 2 * sqentries;
+
+  params->sq_entries = sqentries;
+  params->cq_entries = cqentries;
+  params->sqe_off    = sizeof(struct ioring_rings_s);
+  params->cqe_off    = params->sqe_off +
+                       sqentries * sizeof(struct ioring_sqe_s);
+  params->ring_size  = params->cqe_off +
+                       cqentries * sizeof(struct ioring_cqe_s);
+
+  ring->reqs = kmm_zalloc(cqentries * sizeof(struct ioring_req_s));
+  if (ring->reqs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  /* The rings are read and written directly by the application */
+
+  rings = kumm_zalloc(params->ring_size);
+  if (rings == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_reqs;
+    }
+
+  rings->sq_mask = sqentries - 1;
+  rings->cq_mask = cqentries - 1;
+
+  ring->sqes     = IORING_SQES(rings, params);
+  ring->cqes     = IORING_CQES(rings, params);
+  ring->ringsize = params->ring_size;
+  ring->sqmask   = sqentries - 1;
+  ring->cqmask   = cqentries - 1;
+
+  for (i = 0; i < cqentries; i++)
+    {
+      ring->reqs[i].ring = ring;
+      dq_addlast(&ring->reqs[i].node, &ring->freereqs);
+    }
+
+  ring->rings = rings;
+
+  if ((params->flags & IORING_SETUP_SQPOLL) != 0)
+    {
+      ring->sqlist = nxsched_get_fdlist();
+      ring->sqidle = MSEC2TICK(params->sq_thread_idle);
+
+      snprintf(arg1, sizeof(arg1), "%p", ring);
+      argv[0] = arg1;
+      argv[1] = NULL;
+
+      ret = kthread_create("ioring_sq", CONFIG_FS_IORING_SQPOLL_PRIORITY,
+                           CONFIG_FS_IORING_SQPOLL_STACKSIZE,
+                           ioring_sqthread, argv);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to start the SQ thread: %d\n", ret);
+          goto errout_with_rings;
+        }
+
+      ring->sqpid = ret;
+    }
+
+  nxmutex_unlock(&ring->sqlock);
+  return OK;
+
+errout_with_rings:
+  ring->rings = NULL;
+  dq_init(&ring->freereqs);
+  kumm_free(rings);
+
+errout_with_reqs:
+  kmm_free(ring->reqs);
+  ring->reqs = NULL;
+
+errout_with_lock:
+  nxmutex_unlock(&ring->sqlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_enter
+ ****************************************************************************/
+
+static int ioring_enter(FAR struct ioring_s *ring,
+                        FAR const struct ioring_enter_s *enter)
+{
+  int ret;
+
+  if (enter == NULL || ring->rings == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (ring->sqpid > 0)
+    {
+      /* The SQ thread does the submitting */
+
+      if ((enter->flags & IORING_ENTER_SQ_WAKEUP) != 0)
+        {
+          nxsem_post(&ring->sqwake);
+        }
+
+      ret = 0;
+    }
+  else
+    {
+      ret = ioring_submit(ring, NULL, enter->to_submit);
+    }
+
+  if (ret >= 0 && (enter->flags & IORING_ENTER_GETEVENTS) != 0)
+    {
+      int wret = ioring_wait(ring, enter->min_complete);
+      if (wret < 0 && ret == 0)
+        {
+          ret = wret;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_register_buffers
+ ****************************************************************************/
+
+static int ioring_register_buffers(FAR struct ioring_s *ring,
+                                   FAR const struct ioring_buffers_s *bufs)
+{
+  int ret;
+
+  if (bufs == NULL || bufs->nr == 0 || bufs->iov == NULL ||
+      bufs->nr > CONFIG_FS_IORING_NBUFFERS)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&ring->sqlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (ring->nbufs > 0)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      memcpy(ring->bufs, bufs->iov, bufs->nr * sizeof(struct iovec));
+      ring->nbufs = bufs->nr;
+    }
+
+  nxmutex_unlock(&ring->sqlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_unregister_buffers
+ ****************************************************************************/
+
+static int ioring_unregister_buffers(FAR struct ioring_s *ring)
+{
+  int ret;
+
+  ret = nxmutex_lock(&ring->sqlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* An in-flight fixed transfer may still be using the buffers */
+
+  nxmutex_lock(&ring->cqlock);
+  if (ring->ninflight > 0)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      ring->nbufs = 0;
+    }
+
+  nxmutex_unlock(&ring->cqlock);
+  nxmutex_unlock(&ring->sqlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_munmap
+ ****************************************************************************/
+
+static int ioring_munmap(FAR struct task_group_s *group,
+                         FAR struct mm_map_entry_s *entry,
+                         FAR void *start, size_t length)
+{
+  FAR struct ioring_s *ring = entry->priv.p;
+  int ret;
+
+  /* The rings are only ever unmapped as a whole */
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  ioring_release(ring);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_open
+ ****************************************************************************/
+
+static int ioring_open(FAR struct file *filep)
+{
+  FAR struct ioring_s *ring;
+
+  ring = kmm_zalloc(sizeof(struct ioring_s));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&ring->sqlock);
+  nxmutex_init(&ring->cqlock);
+  nxsem_init(&ring->cqsem, 0, 0);
+  nxsem_init(&ring->sqwake, 0, 0);
+  nxsem_init(&ring->sqexit, 0, 0);
+  atomic_set(&ring->crefs, 1);
+
+  filep->f_priv = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_close
+ ****************************************************************************/
+
+static int ioring_close(FAR struct file *filep)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  FAR struct ioring_req_s *canceled;
+  FAR struct ioring_req_s *req;
+  FAR dq_entry_t *node;
+
+  if (ring->sqpid > 0)
+    {
+      ring->sqstop = true;
+      nxsem_post(&ring->sqwake);
+      nxsem_wait_uninterruptible(&ring->sqexit);
+      ring->sqpid = 0;
+    }
+
+  /* Complete the requests that are still waiting for a worker thread.
+   * Those already owned by a driver or a worker complete on their own and
+   * keep the ring alive until they do.
+   */
+
+  do
+    {
+      canceled = NULL;
+
+      nxmutex_lock(&ring->cqlock);
+      dq_for_every(&ring->inflight, node)
+        {
+          req = container_of(node, struct ioring_req_s, node);
+          if (req->state == IORING_REQ_QUEUED)
+            {
+              req->state = IORING_REQ_CANCELED;
+              work_cancel(LPWORK, &req->work);
+              canceled = req;
+              break;
+            }
+        }
+
+      nxmutex_unlock(&ring->cqlock);
+
+      if (canceled != NULL)
+        {
+          ioring_complete(&canceled->async, -ECANCELED);
+        }
+    }
+  while (canceled != NULL);
+
+  ioring_release(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_ioctl
+ ****************************************************************************/
+
+static int ioring_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  int ret;
+
+  switch (cmd)
+    {
+      case IORINGIOC_SETUP:
+        ret = ioring_setup(ring,
+                           (FAR struct ioring_params_s *)(uintptr_t)arg);
+        break;
+
+      case IORINGIOC_ENTER:
+        ret = ioring_enter(ring,
+                       (FAR const struct ioring_enter_s *)(uintptr_t)arg);
+        break;
+
+      case IORINGIOC_REGISTER_BUFFERS:
+        ret = ioring_register_buffers(ring,
+                       (FAR const struct ioring_buffers_s *)(uintptr_t)arg);
+        break;
+
+      case IORINGIOC_UNREGISTER_BUFFERS:
+        ret = ioring_unregister_buffers(ring);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_mmap
+ ****************************************************************************/
+
+static int ioring_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  int ret = -EINVAL;
+
+  nxmutex_lock(&ring->sqlock);
+
+  if (ring->rings != NULL && map->offset == 0 &&
+      map->length <= ring->ringsize)
+    {
+      map->vaddr  = ring->rings;
+      map->priv.p = ring;
+      map->munmap = ioring_munmap;
+
+      atomic_fetch_add(&ring->crefs, 1);
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret < 0)
+        {
+          ioring_release(ring);
+        }
+    }
+
+  nxmutex_unlock(&ring->sqlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_poll
+ *
+ * Description:
+ *   The ring is readable while the completion ring is not empty.
+ *
+ ****************************************************************************/
+
+static int ioring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                       bool setup)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  FAR struct pollfd **slot;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&ring->cqlock);
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_FS_IORING_NPOLLWAITERS; i++)
+        {
+          if (ring->fds[i] == NULL)
+            {
+              ring->fds[i] = fds;
+              fds->priv    = &ring->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_FS_IORING_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else if (ring->rings != NULL &&
+               ring->cqtail != ring->rings->cq_head)
+        {
+          poll_notify(&fds, 1, POLLIN);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+  nxmutex_unlock(&ring->cqlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_ring_initialize
+ *
+ * Description:
+ *   Register the /dev/ioring driver.  Each open of the driver creates an
+ *   independent pair of submission and completion rings.
+ *
+ ****************************************************************************/
+
+void aio_ring_initialize(void)
+{
+  register_driver("/dev/ioring", &g_ioring_fops, 0666, NULL);
+}
+
+#endif /* CONFIG_FS_IORING */
@@ -305,9 +305,9 @@ int aio_write(FAR struct aiocb *aiocbp)
       return ERROR;
     }
 
-  /* Defer the work to the worker thread */
+  /* Hand the transfer to the driver or defer it to the worker thread */
 
-  ret = aio_queue(aioc, aio_write_worker);
+  ret = aio_submit(aioc, IORING_OP_WRITE, aio_write_worker);
   if (ret < 0)
     {
       /* The result and the errno have already been set */
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/statfs.h>
 #include <sys/stat.h>
 
@@ -46,6 +47,7 @@
 
 #include "cromfs.h"
 #include "fs_heap.h"
+#include "mmap/fs_rammap.h"
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
@@ -147,6 +149,8 @@ static ssize_t  cromfs_read(FAR struct file *filep,
                             FAR char *buffer, size_t buflen);
 static int      cromfs_ioctl(FAR struct file *filep,
                              int cmd, unsigned long arg);
+static int      cromfs_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map);
 
 static int      cromfs_dup(FAR const struct file *oldp,
                            FAR struct file *newp);
@@ -191,7 +195,7 @@ const struct mountpt_operations g_cromfs_operations =
   NULL,              /* write */
   NULL,              /* seek */
   cromfs_ioctl,      /* ioctl */
-  NULL,              /* mmap */
+  cromfs_mmap,       /* mmap */
   NULL,              /* truncate */
   NULL,              /* poll */
   NULL,              /* readv */
@@ -1091,6 +1095,84 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return -ENOTTY;
 }
 
+/****************************************************************************
+ * Name: cromfs_mmap
+ *
+ * Description:
+ *   A mapping that lies inside of one uncompressed block is served from the
+ *   CROMFS image in place.  All other read-only mappings share a single,
+ *   decompressed copy per file region;  writable ones fall back to a
+ *   private RAM copy.
+ *
+ ****************************************************************************/
+
+static int cromfs_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR const struct cromfs_volume_s *fs;
+  FAR struct cromfs_file_s *ff;
+  FAR struct lzf_header_s *hdr;
+  uint32_t blkoffs = 0;
+  uint32_t blksize;
+  uint16_t ulen;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  fs = filep->f_inode->i_private;
+  ff = filep->f_priv;
+
+  if (map->offset < 0 || map->offset >= ff->ff_node->cn_size ||
+      (map->prot & PROT_WRITE) != 0)
+    {
+      return -ENOTTY;
+    }
+
+  /* Find the block containing the start of the mapping */
+
+  hdr = cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+  for (; ; )
+    {
+      if (hdr->lzf_type == LZF_TYPE0_HDR)
+        {
+          FAR struct lzf_type0_header_s *hdr0 =
+            (FAR struct lzf_type0_header_s *)hdr;
+
+          ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
+                    (uint16_t)hdr0->lzf_len[1];
+          blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
+        }
+      else
+        {
+          FAR struct lzf_type1_header_s *hdr1 =
+            (FAR struct lzf_type1_header_s *)hdr;
+
+          ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+                    (uint16_t)hdr1->lzf_ulen[1];
+          blksize = (uint32_t)((uint16_t)hdr1->lzf_clen[0] << 8 |
+                               (uint16_t)hdr1->lzf_clen[1]) +
+                    LZF_TYPE1_HDR_SIZE;
+        }
+
+      if (map->offset < blkoffs + ulen)
+        {
+          break;
+        }
+
+      blkoffs += ulen;
+      hdr      = (FAR struct lzf_header_s *)((FAR uint8_t *)hdr + blksize);
+    }
+
+  if (hdr->lzf_type == LZF_TYPE0_HDR &&
+      map->offset + map->length <= blkoffs + ulen)
+    {
+      map->vaddr = (FAR uint8_t *)hdr + LZF_TYPE0_HDR_SIZE +
+                   (map->offset - blkoffs);
+      return OK;
+    }
+
+  return rammap_shared(filep, map, cromfs_addr2offset(fs, ff->ff_node));
+}
+
 /****************************************************************************
  * Name: cromfs_dup
  *
@@ -0,0 +1,1857 @@
+/****************************************************************************
+ * fs/exfat/fs_exfat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/mount.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "vfs/vfs.h"
+#include "fs_exfat.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_LARGEFILE)
+#  define OFF_MAX INT64_MAX
+#else
+#  define OFF_MAX INT32_MAX
+#endif
+
+/* The page cache key of the file whose entry set is at an offset of the
+ * directory starting at a cluster.
+ */
+
+#define EXFAT_PAGEKEY(first, offset) ((uint64_t)(first) << 32 | (offset))
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     exfat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     exfat_close(FAR struct file *filep);
+static ssize_t exfat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t exfat_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static off_t   exfat_seek(FAR struct file *filep, off_t offset,
+                 int whence);
+static int     exfat_truncate(FAR struct file *filep, off_t length);
+
+static int     exfat_sync(FAR struct file *filep);
+static int     exfat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     exfat_fstat(FAR const struct file *filep,
+                 FAR struct stat *buf);
+
+static int     exfat_opendir(FAR struct inode *mountpt,
+                 FAR const char *relpath, FAR struct fs_dirent_s **dir);
+static int     exfat_closedir(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir);
+static int     exfat_readdir(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir,
+                 FAR struct dirent *entry);
+static int     exfat_rewinddir(FAR struct inode *mountpt,
+                 FAR struct fs_dirent_s *dir);
+
+static int     exfat_bind(FAR struct inode *blkdriver,
+                 FAR const void *data, FAR void **handle);
+static int     exfat_unbind(FAR void *handle,
+                 FAR struct inode **blkdriver, unsigned int flags);
+static int     exfat_statfs(FAR struct inode *mountpt,
+                 FAR struct statfs *buf);
+
+static int     exfat_unlink(FAR struct inode *mountpt,
+                 FAR const char *relpath);
+static int     exfat_mkdir(FAR struct inode *mountpt,
+                 FAR const char *relpath, mode_t mode);
+static int     exfat_rmdir(FAR struct inode *mountpt,
+                 FAR const char *relpath);
+static int     exfat_rename(FAR struct inode *mountpt,
+                 FAR const char *oldrelpath, FAR const char *newrelpath);
+static int     exfat_stat(FAR struct inode *mountpt,
+                 FAR const char *relpath, FAR struct stat *buf);
+static int     exfat_syncfs(FAR struct inode *mountpt);
+
+#ifdef CONFIG_FS_PAGECACHE
+static int     exfat_pagekey(FAR const struct file *filep,
+                 FAR uint64_t *key);
+static ssize_t exfat_readpage(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen, off_t offset);
+static ssize_t exfat_writepage(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen, off_t offset);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct mountpt_operations g_exfat_operations =
+{
+  exfat_open,        /* open */
+  exfat_close,       /* close */
+  exfat_read,        /* read */
+  exfat_write,       /* write */
+  exfat_seek,        /* seek */
+  NULL,              /* ioctl */
+  NULL,              /* mmap */
+  exfat_truncate,    /* truncate */
+  NULL,              /* poll */
+  NULL,              /* readv */
+  NULL,              /* writev */
+
+  exfat_sync,        /* sync */
+  exfat_dup,         /* dup */
+  exfat_fstat,       /* fstat */
+  NULL,              /* fchstat */
+
+  exfat_opendir,     /* opendir */
+  exfat_closedir,    /* closedir */
+  exfat_readdir,     /* readdir */
+  exfat_rewinddir,   /* rewinddir */
+
+  exfat_bind,        /* bind */
+  exfat_unbind,      /* unbind */
+  exfat_statfs,      /* statfs */
+
+  exfat_unlink,      /* unlink */
+  exfat_mkdir,       /* mkdir */
+  exfat_rmdir,       /* rmdir */
+  exfat_rename,      /* rename */
+  exfat_stat,        /* stat */
+  NULL,              /* chstat */
+  exfat_syncfs,      /* syncfs */
+#ifdef CONFIG_FS_PAGECACHE
+  exfat_pagekey,     /* pagekey */
+  exfat_readpage,    /* readpage */
+  exfat_writepage    /* writepage */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: exfat_lock
+ *
+ * Description:
+ *   Lock the mountpoint of an open file and check that it is still
+ *   healthy.
+ *
+ ****************************************************************************/
+
+static int exfat_lock(FAR const struct file *filep,
+                      FAR struct exfat_mountpt_s **fsp)
+{
+  FAR struct exfat_file_s *ef = filep->f_priv;
+  FAR struct exfat_mountpt_s *fs = filep->f_inode->i_private;
+  int ret;
+
+  DEBUGASSERT(ef != NULL && fs != NULL);
+
+  if ((ef->ef_bflags & EXFAT_UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&fs->fs_lock);
+      return ret;
+    }
+
+  *fsp = fs;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_findopen
+ *
+ * Description:
+ *   Find the open file of an entry set.
+ *
+ ****************************************************************************/
+
+static FAR struct exfat_file_s *
+exfat_findopen(FAR struct exfat_mountpt_s *fs,
+               FAR const struct exfat_dirinfo_s *dirinfo)
+{
+  FAR struct exfat_file_s *ef;
+
+  for (ef = fs->fs_head; ef != NULL; ef = ef->ef_next)
+    {
+      if (ef->ef_dirpos.dp_dir.ec_first == dirinfo->di_dir.ec_first &&
+          ef->ef_dirpos.dp_offset == dirinfo->di_offset)
+        {
+          return ef;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: exfat_ffcacheflush
+ *
+ * Description:
+ *   Write the sector buffer of a file back if it was modified.
+ *
+ ****************************************************************************/
+
+static int exfat_ffcacheflush(FAR struct exfat_mountpt_s *fs,
+                              FAR struct exfat_file_s *ef)
+{
+  int ret;
+
+  if ((ef->ef_bflags & EXFAT_BUFFER_DIRTY) != 0)
+    {
+      ret = exfat_hwwrite(fs, ef->ef_buffer, ef->ef_cachesector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ef->ef_bflags &= ~EXFAT_BUFFER_DIRTY;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_filesectors
+ *
+ * Description:
+ *   Map a sector aligned position of a file to a media sector, and limit
+ *   a number of sectors from there to those that are contiguous.
+ *
+ ****************************************************************************/
+
+static int exfat_filesectors(FAR struct exfat_mountpt_s *fs,
+                             FAR struct exfat_file_s *ef, uint64_t pos,
+                             FAR off_t *sector, FAR size_t *nsectors)
+{
+  uint32_t spc = (uint32_t)1 << fs->fs_clustershift;
+  uint32_t index = pos >> EXFAT_CLUSTERSHIFT(fs);
+  uint32_t first = (pos >> fs->fs_sectorshift) & (spc - 1);
+  uint32_t cluster;
+  uint32_t n;
+  int ret;
+
+  ret = exfat_chaincluster(fs, &ef->ef_chain, index, &cluster);
+  if (ret < 0)
+    {
+      return ret == -ENOENT ? -EIO : ret;
+    }
+
+  *sector = exfat_cluster2sector(fs, cluster) + first;
+
+  if (*nsectors > spc - first)
+    {
+      n = (*nsectors - (spc - first) + spc - 1) >> fs->fs_clustershift;
+      n = exfat_chaincontig(fs, &ef->ef_chain, index, cluster, n + 1);
+      if (*nsectors > ((size_t)n << fs->fs_clustershift) - first)
+        {
+          *nsectors = ((size_t)n << fs->fs_clustershift) - first;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_readat
+ *
+ * Description:
+ *   Read from a file at a position.  The data past ValidDataLength, which
+ *   was allocated but never written, reads as zeros.  Whole sectors go
+ *   straight to the user buffer, in one request per contiguous run.
+ *
+ ****************************************************************************/
+
+static ssize_t exfat_readat(FAR struct exfat_mountpt_s *fs,
+                            FAR struct exfat_file_s *ef,
+                            FAR char *buffer, size_t buflen, uint64_t pos)
+{
+  size_t nread = 0;
+  size_t avail;
+  size_t nsectors;
+  size_t n;
+  off_t sector;
+  uint32_t sectoroff;
+  int ret;
+
+  if (pos >= ef->ef_size)
+    {
+      return 0;
+    }
+
+  if (buflen > ef->ef_size - pos)
+    {
+      buflen = ef->ef_size - pos;
+    }
+
+  while (nread < buflen)
+    {
+      if (pos >= ef->ef_validsize)
+        {
+          memset(buffer + nread, 0, buflen - nread);
+          nread = buflen;
+          break;
+        }
+
+      avail = buflen - nread;
+      if (avail > ef->ef_validsize - pos)
+        {
+          avail = ef->ef_validsize - pos;
+        }
+
+      sectoroff = pos & EXFAT_SECTORMASK(fs);
+      if (sectoroff == 0 && avail >= fs->fs_sectorsize)
+        {
+          nsectors = avail >> fs->fs_sectorshift;
+          ret = exfat_filesectors(fs, ef, pos, &sector, &nsectors);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          /* The sector buffer may hold newer data for the range */
+
+          if (ef->ef_cachesector >= sector &&
+              ef->ef_cachesector < sector + nsectors)
+            {
+              ret = exfat_ffcacheflush(fs, ef);
+              if (ret < 0)
+                {
+                  goto errout;
+                }
+            }
+
+          ret = exfat_hwread(fs, (FAR uint8_t *)buffer + nread, sector,
+                             nsectors);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          n = nsectors << fs->fs_sectorshift;
+        }
+      else
+        {
+          nsectors = 1;
+          ret = exfat_filesectors(fs, ef, pos, &sector, &nsectors);
+          if (ret >= 0 && ef->ef_cachesector != sector)
+            {
+              ret = exfat_ffcacheflush(fs, ef);
+              if (ret >= 0)
+                {
+                  ef->ef_cachesector = -1;
+                  ret = exfat_hwread(fs, ef->ef_buffer, sector, 1);
+                }
+
+              if (ret >= 0)
+                {
+                  ef->ef_cachesector = sector;
+                }
+            }
+
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          n = fs->fs_sectorsize - sectoroff;
+          if (n > avail)
+            {
+              n = avail;
+            }
+
+          memcpy(buffer + nread, ef->ef_buffer + sectoroff, n);
+        }
+
+      nread += n;
+      pos   += n;
+    }
+
+  return nread;
+
+errout:
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: exfat_writeat
+ *
+ * Description:
+ *   Write to a file at a position, or write zeros if buffer is NULL.  A
+ *   gap between ValidDataLength and the position is filled with zeros
+ *   first.  Clusters are allocated as needed, keeping the file contiguous
+ *   where the clusters after it are free.
+ *
+ ****************************************************************************/
+
+static ssize_t exfat_writeat(FAR struct exfat_mountpt_s *fs,
+                             FAR struct exfat_file_s *ef,
+                             FAR const char *buffer, size_t buflen,
+                             uint64_t pos)
+{
+  size_t nwritten = 0;
+  size_t nsectors;
+  size_t n;
+  uint64_t avail;
+  off_t sector;
+  uint32_t sectoroff;
+  ssize_t nzeros;
+  int ret;
+
+  if (buflen == 0)
+    {
+      return 0;
+    }
+
+  if (pos >= (uint64_t)OFF_MAX || buflen > (uint64_t)OFF_MAX - pos)
+    {
+      return -EFBIG;
+    }
+
+  if (pos > ef->ef_validsize)
+    {
+      nzeros = exfat_writeat(fs, ef, NULL, pos - ef->ef_validsize,
+                             ef->ef_validsize);
+      if (nzeros < 0)
+        {
+          return nzeros;
+        }
+      else if (pos > ef->ef_validsize)
+        {
+          return -ENOSPC;
+        }
+    }
+
+  /* Allocate the clusters up to the end of the write, or as many as
+   * possible.
+   */
+
+  ret = exfat_chainextend(fs, &ef->ef_chain,
+                          EXFAT_NCLUSTERS(fs, pos + buflen), false);
+  ef->ef_bflags |= EXFAT_FILE_DIRTY;
+  avail = (uint64_t)ef->ef_chain.ec_nclusters << EXFAT_CLUSTERSHIFT(fs);
+  if (ret < 0)
+    {
+      if (avail <= pos)
+        {
+          return ret;
+        }
+
+      buflen = avail - pos;
+    }
+
+  while (nwritten < buflen)
+    {
+      sectoroff = pos & EXFAT_SECTORMASK(fs);
+      if (buffer != NULL && sectoroff == 0 &&
+          buflen - nwritten >= fs->fs_sectorsize)
+        {
+          nsectors = (buflen - nwritten) >> fs->fs_sectorshift;
+          ret = exfat_filesectors(fs, ef, pos, &sector, &nsectors);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          /* The sector buffer is overwritten by the new data */
+
+          if (ef->ef_cachesector >= sector &&
+              ef->ef_cachesector < sector + nsectors)
+            {
+              ef->ef_cachesector = -1;
+              ef->ef_bflags &= ~EXFAT_BUFFER_DIRTY;
+            }
+
+          ret = exfat_hwwrite(fs, (FAR const uint8_t *)buffer + nwritten,
+                              sector, nsectors);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          n = nsectors << fs->fs_sectorshift;
+        }
+      else
+        {
+          n = fs->fs_sectorsize - sectoroff;
+          if (n > buflen - nwritten)
+            {
+              n = buflen - nwritten;
+            }
+
+          nsectors = 1;
+          ret = exfat_filesectors(fs, ef, pos, &sector, &nsectors);
+          if (ret >= 0 && ef->ef_cachesector != sector)
+            {
+              ret = exfat_ffcacheflush(fs, ef);
+              if (ret >= 0)
+                {
+                  /* Only the sectors below ValidDataLength have data */
+
+                  ef->ef_cachesector = -1;
+                  if (pos - sectoroff < ef->ef_validsize &&
+                      n < fs->fs_sectorsize)
+                    {
+                      ret = exfat_hwread(fs, ef->ef_buffer, sector, 1);
+                    }
+                  else
+                    {
+                      memset(ef->ef_buffer, 0, fs->fs_sectorsize);
+                    }
+                }
+
+              if (ret >= 0)
+                {
+                  ef->ef_cachesector = sector;
+                }
+            }
+
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (buffer != NULL)
+            {
+              memcpy(ef->ef_buffer + sectoroff, buffer + nwritten, n);
+            }
+          else
+            {
+              memset(ef->ef_buffer + sectoroff, 0, n);
+            }
+
+          ef->ef_bflags |= EXFAT_BUFFER_DIRTY;
+        }
+
+      nwritten += n;
+      pos      += n;
+
+      if (pos > ef->ef_validsize)
+        {
+          ef->ef_validsize = pos;
+        }
+
+      if (pos > ef->ef_size)
+        {
+          ef->ef_size = pos;
+        }
+    }
+
+  return nwritten;
+
+errout:
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: exfat_settruncate
+ *
+ * Description:
+ *   Change the size of a file.  Extending it only allocates clusters: the
+ *   new data past ValidDataLength reads as zeros without being written.
+ *
+ ****************************************************************************/
+
+static int exfat_settruncate(FAR struct exfat_mountpt_s *fs,
+                             FAR struct exfat_file_s *ef, uint64_t length)
+{
+  int ret;
+
+  if (length > ef->ef_size)
+    {
+      ret = exfat_chainextend(fs, &ef->ef_chain,
+                              EXFAT_NCLUSTERS(fs, length), false);
+    }
+  else
+    {
+      ret = exfat_ffcacheflush(fs, ef);
+      if (ret >= 0)
+        {
+          ef->ef_cachesector = -1;
+          ret = exfat_chaintruncate(fs, &ef->ef_chain,
+                                    EXFAT_NCLUSTERS(fs, length));
+        }
+
+      if (ef->ef_validsize > length)
+        {
+          ef->ef_validsize = length;
+        }
+    }
+
+  ef->ef_bflags |= EXFAT_FILE_DIRTY;
+  if (ret >= 0)
+    {
+      ef->ef_size = length;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_filesync
+ *
+ * Description:
+ *   Write all of the cached state of a file to the media, including its
+ *   entry set.
+ *
+ ****************************************************************************/
+
+static int exfat_filesync(FAR struct exfat_mountpt_s *fs,
+                          FAR struct exfat_file_s *ef)
+{
+  FAR uint8_t *file = fs->fs_set;
+  FAR uint8_t *stream = fs->fs_set + EXFAT_DIRENT_SIZE;
+  int nentries;
+  int ret;
+
+  ret = exfat_ffcacheflush(fs, ef);
+  if (ret < 0 || (ef->ef_bflags & EXFAT_FILE_DIRTY) == 0)
+    {
+      return ret;
+    }
+
+  nentries = exfat_readset(fs, &ef->ef_dirpos.dp_dir,
+                           ef->ef_dirpos.dp_offset);
+  if (nentries < 0)
+    {
+      return nentries;
+    }
+
+  ef->ef_attr |= EXFAT_ATTR_ARCHIVE;
+  exfat_putuint16(file + FILE_ATTRIBUTES, ef->ef_attr);
+  exfat_putuint32(file + FILE_MODIFYTIME, exfat_systime2time());
+  file[FILE_MODIFY10MS] = 0;
+  file[FILE_MODIFYUTC]  = EXFAT_UTC_VALID;
+
+  stream[STREAM_FLAGS] = ef->ef_chain.ec_flags;
+  exfat_putuint64(stream + STREAM_VALIDLENGTH, ef->ef_validsize);
+  exfat_putuint32(stream + STREAM_FIRSTCLUSTER, ef->ef_chain.ec_first);
+  exfat_putuint64(stream + STREAM_DATALENGTH, ef->ef_size);
+
+  ret = exfat_writeset(fs, &ef->ef_dirpos.dp_dir, ef->ef_dirpos.dp_offset,
+                       nentries);
+  if (ret >= 0)
+    {
+      ret = exfat_fscacheflush(fs);
+    }
+
+  if (ret >= 0)
+    {
+      ef->ef_bflags &= ~EXFAT_FILE_DIRTY;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_stat_common
+ ****************************************************************************/
+
+static void exfat_stat_common(FAR struct exfat_mountpt_s *fs,
+                              FAR const struct exfat_dirinfo_s *dirinfo,
+                              FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+
+  /* Files are always readable by everyone but may be writeable by no-one */
+
+  buf->st_mode = S_IROTH | S_IRGRP | S_IRUSR;
+  if ((dirinfo->di_attr & EXFAT_ATTR_READONLY) == 0)
+    {
+      buf->st_mode |= S_IWOTH | S_IWGRP | S_IWUSR;
+    }
+
+  if (dirinfo->di_root || (dirinfo->di_attr & EXFAT_ATTR_DIRECTORY) != 0)
+    {
+      buf->st_mode |= S_IFDIR;
+    }
+  else
+    {
+      buf->st_mode |= S_IFREG;
+    }
+
+  buf->st_size    = dirinfo->di_size;
+  buf->st_blksize = EXFAT_CLUSTERSIZE(fs);
+  buf->st_blocks  = EXFAT_NCLUSTERS(fs, dirinfo->di_size);
+  buf->st_mtime   = dirinfo->di_mtime;
+  buf->st_atime   = dirinfo->di_atime;
+  buf->st_ctime   = dirinfo->di_ctime;
+}
+
+/****************************************************************************
+ * Name: exfat_open
+ ****************************************************************************/
+
+static int exfat_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  struct exfat_dirinfo_s dirinfo;
+  FAR struct exfat_mountpt_s *fs;
+  FAR struct exfat_file_s *ef;
+  bool truncate = false;
+  int ret;
+
+  DEBUGASSERT(filep->f_priv == NULL);
+
+  fs = filep->f_inode->i_private;
+  DEBUGASSERT(fs != NULL);
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  ret = exfat_finddirentry(fs, &dirinfo, relpath);
+  if (ret >= 0)
+    {
+      if (dirinfo.di_root ||
+          (dirinfo.di_attr & EXFAT_ATTR_DIRECTORY) != 0)
+        {
+          ret = -EISDIR;
+          goto errout_with_lock;
+        }
+
+      if ((oflags & (O_CREAT | O_EXCL)) == (O_CREAT | O_EXCL))
+        {
+          ret = -EEXIST;
+          goto errout_with_lock;
+        }
+
+      if ((oflags & O_WROK) != 0 &&
+          (dirinfo.di_attr & EXFAT_ATTR_READONLY) != 0)
+        {
+          ret = -EACCES;
+          goto errout_with_lock;
+        }
+
+      truncate = (oflags & (O_TRUNC | O_WROK)) == (O_TRUNC | O_WROK);
+    }
+  else if (ret == -ENOENT && dirinfo.di_last && (oflags & O_CREAT) != 0)
+    {
+      ret = exfat_dircreate(fs, &dirinfo, EXFAT_ATTR_ARCHIVE);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+  else
+    {
+      goto errout_with_lock;
+    }
+
+  /* All of the opens of a file share its state */
+
+  ef = exfat_findopen(fs, &dirinfo);
+  if (ef == NULL)
+    {
+      ef = fs_heap_zalloc(sizeof(struct exfat_file_s));
+      if (ef == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      ef->ef_buffer = fs_heap_malloc(fs->fs_sectorsize);
+      if (ef->ef_buffer == NULL)
+        {
+          fs_heap_free(ef);
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      ef->ef_dirpos.dp_dir       = dirinfo.di_dir;
+      ef->ef_dirpos.dp_offset    = dirinfo.di_offset;
+      ef->ef_chain.ec_first      = dirinfo.di_first;
+      ef->ef_chain.ec_flags      = dirinfo.di_flags;
+      ef->ef_chain.ec_nclusters  = EXFAT_NCLUSTERS(fs, dirinfo.di_size);
+      ef->ef_size                = dirinfo.di_size;
+      ef->ef_validsize           = dirinfo.di_validsize;
+      ef->ef_attr                = dirinfo.di_attr;
+      ef->ef_cachesector         = -1;
+
+      if (ef->ef_validsize > ef->ef_size)
+        {
+          ef->ef_validsize = ef->ef_size;
+        }
+
+      ef->ef_next = fs->fs_head;
+      fs->fs_head = ef;
+    }
+
+  if (truncate && ef->ef_size > 0)
+    {
+      ret = exfat_settruncate(fs, ef, 0);
+      if (ret >= 0)
+        {
+          ret = exfat_filesync(fs, ef);
+        }
+
+      if (ret < 0)
+        {
+          if (ef->ef_crefs == 0)
+            {
+              fs->fs_head = ef->ef_next;
+              fs_heap_free(ef->ef_buffer);
+              fs_heap_free(ef);
+            }
+
+          goto errout_with_lock;
+        }
+    }
+  else
+    {
+      truncate = false;
+    }
+
+  ef->ef_crefs++;
+  filep->f_priv = ef;
+
+  if ((oflags & O_APPEND) != 0)
+    {
+      filep->f_pos = ef->ef_size;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+
+  /* The pages of the former content must go */
+
+  if (truncate)
+    {
+      pagecache_forget(filep->f_inode,
+                       EXFAT_PAGEKEY(ef->ef_dirpos.dp_dir.ec_first,
+                                     ef->ef_dirpos.dp_offset));
+    }
+
+  return OK;
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_close
+ ****************************************************************************/
+
+static int exfat_close(FAR struct file *filep)
+{
+  FAR struct exfat_mountpt_s *fs = filep->f_inode->i_private;
+  FAR struct exfat_file_s *ef = filep->f_priv;
+  FAR struct exfat_file_s **prev;
+  int ret = OK;
+
+  DEBUGASSERT(ef != NULL && fs != NULL);
+
+  nxmutex_lock(&fs->fs_lock);
+
+  if ((ef->ef_bflags & EXFAT_UMOUNT_FORCED) == 0)
+    {
+      ret = exfat_filesync(fs, ef);
+    }
+
+  if (--ef->ef_crefs == 0)
+    {
+      for (prev = &fs->fs_head; *prev != NULL; prev = &(*prev)->ef_next)
+        {
+          if (*prev == ef)
+            {
+              *prev = ef->ef_next;
+              break;
+            }
+        }
+
+      fs_heap_free(ef->ef_buffer);
+      fs_heap_free(ef);
+    }
+
+  filep->f_priv = NULL;
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_read
+ ****************************************************************************/
+
+static ssize_t exfat_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct exfat_mountpt_s *fs;
+  ssize_t nread;
+  int ret;
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nread = exfat_readat(fs, filep->f_priv, buffer, buflen, filep->f_pos);
+  if (nread > 0)
+    {
+      filep->f_pos += nread;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: exfat_write
+ ****************************************************************************/
+
+static ssize_t exfat_write(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen)
+{
+  FAR struct exfat_mountpt_s *fs;
+  FAR struct exfat_file_s *ef = filep->f_priv;
+  ssize_t nwritten;
+  int ret;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EACCES;
+    }
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((filep->f_oflags & O_APPEND) != 0)
+    {
+      filep->f_pos = ef->ef_size;
+    }
+
+  nwritten = exfat_writeat(fs, ef, buffer, buflen, filep->f_pos);
+  if (nwritten > 0)
+    {
+      filep->f_pos += nwritten;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: exfat_seek
+ ****************************************************************************/
+
+static off_t exfat_seek(FAR struct file *filep, off_t offset, int whence)
+{
+  FAR struct exfat_mountpt_s *fs;
+  FAR struct exfat_file_s *ef = filep->f_priv;
+  off_t position;
+  int ret;
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (whence)
+    {
+      case SEEK_SET:
+        position = offset;
+        break;
+
+      case SEEK_CUR:
+        position = filep->f_pos + offset;
+        break;
+
+      case SEEK_END:
+        position = ef->ef_size + offset;
+        break;
+
+      default:
+        position = -EINVAL;
+        break;
+    }
+
+  if (position >= 0)
+    {
+      filep->f_pos = position;
+    }
+  else
+    {
+      position = -EINVAL;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return position;
+}
+
+/****************************************************************************
+ * Name: exfat_truncate
+ ****************************************************************************/
+
+static int exfat_truncate(FAR struct file *filep, off_t length)
+{
+  FAR struct exfat_mountpt_s *fs;
+  int ret;
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EBADF;
+    }
+
+  if (length < 0)
+    {
+      return -EINVAL;
+    }
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_settruncate(fs, filep->f_priv, length);
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_sync
+ *
+ * Description: Synchronize the file state on disk to match internal, in-
+ *   memory state.
+ *
+ ****************************************************************************/
+
+static int exfat_sync(FAR struct file *filep)
+{
+  FAR struct exfat_mountpt_s *fs;
+  int ret;
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_filesync(fs, filep->f_priv);
+  if (ret >= 0)
+    {
+      ret = exfat_fscacheflush(fs);
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_dup
+ *
+ * Description: Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int exfat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct exfat_mountpt_s *fs;
+  FAR struct exfat_file_s *ef = oldp->f_priv;
+  int ret;
+
+  DEBUGASSERT(newp->f_priv == NULL);
+
+  ret = exfat_lock(oldp, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ef->ef_crefs++;
+  newp->f_priv = ef;
+
+  nxmutex_unlock(&fs->fs_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_fstat
+ *
+ * Description:
+ *   Obtain information about an open file associated with the file
+ *   descriptor 'fd', and will write it to the area pointed to by 'buf'.
+ *
+ ****************************************************************************/
+
+static int exfat_fstat(FAR const struct file *filep, FAR struct stat *buf)
+{
+  struct exfat_dirinfo_s dirinfo;
+  FAR struct exfat_mountpt_s *fs;
+  FAR struct exfat_file_s *ef = filep->f_priv;
+  int ret;
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The times come from the entry set, the rest from the open file */
+
+  ret = exfat_readset(fs, &ef->ef_dirpos.dp_dir, ef->ef_dirpos.dp_offset);
+  if (ret >= 0)
+    {
+      memset(&dirinfo, 0, sizeof(dirinfo));
+      dirinfo.di_attr   = ef->ef_attr;
+      dirinfo.di_size   = ef->ef_size;
+      dirinfo.di_ctime  =
+        exfat_time2systime(exfat_getuint32(fs->fs_set + FILE_CREATETIME),
+                           fs->fs_set[FILE_CREATEUTC]);
+      dirinfo.di_mtime  =
+        exfat_time2systime(exfat_getuint32(fs->fs_set + FILE_MODIFYTIME),
+                           fs->fs_set[FILE_MODIFYUTC]);
+      dirinfo.di_atime  =
+        exfat_time2systime(exfat_getuint32(fs->fs_set + FILE_ACCESSTIME),
+                           fs->fs_set[FILE_ACCESSUTC]);
+
+      exfat_stat_common(fs, &dirinfo, buf);
+      ret = OK;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_opendir
+ *
+ * Description: Open a directory for read access
+ *
+ ****************************************************************************/
+
+static int exfat_opendir(FAR struct inode *mountpt, FAR const char *relpath,
+                         FAR struct fs_dirent_s **dir)
+{
+  struct exfat_dirinfo_s dirinfo;
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  FAR struct exfat_dirent_s *edir;
+  int ret;
+
+  DEBUGASSERT(fs != NULL);
+
+  edir = fs_heap_zalloc(sizeof(struct exfat_dirent_s));
+  if (edir == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      goto errout_with_edir;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  ret = exfat_finddirentry(fs, &dirinfo, relpath);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  if (dirinfo.di_root)
+    {
+      edir->ed_dir = fs->fs_root;
+    }
+  else if ((dirinfo.di_attr & EXFAT_ATTR_DIRECTORY) != 0)
+    {
+      edir->ed_dir.ec_first     = dirinfo.di_first;
+      edir->ed_dir.ec_flags     = dirinfo.di_flags;
+      edir->ed_dir.ec_nclusters = EXFAT_NCLUSTERS(fs, dirinfo.di_size);
+    }
+  else
+    {
+      ret = -ENOTDIR;
+      goto errout_with_lock;
+    }
+
+  *dir = &edir->base;
+  nxmutex_unlock(&fs->fs_lock);
+  return OK;
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+
+errout_with_edir:
+  fs_heap_free(edir);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_closedir
+ *
+ * Description: Close directory
+ *
+ ****************************************************************************/
+
+static int exfat_closedir(FAR struct inode *mountpt,
+                          FAR struct fs_dirent_s *dir)
+{
+  DEBUGASSERT(dir != NULL);
+
+  fs_heap_free(dir);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_readdir
+ *
+ * Description: Read the next directory entry
+ *
+ ****************************************************************************/
+
+static int exfat_readdir(FAR struct inode *mountpt,
+                         FAR struct fs_dirent_s *dir,
+                         FAR struct dirent *entry)
+{
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret >= 0)
+    {
+      ret = exfat_nextdirentry(fs, (FAR struct exfat_dirent_s *)dir, entry);
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_rewinddir
+ *
+ * Description: Reset directory read to the first entry
+ *
+ ****************************************************************************/
+
+static int exfat_rewinddir(FAR struct inode *mountpt,
+                           FAR struct fs_dirent_s *dir)
+{
+  FAR struct exfat_dirent_s *edir = (FAR struct exfat_dirent_s *)dir;
+
+  edir->ed_offset = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_bind
+ *
+ * Description: This implements a portion of the mount operation. This
+ *  function allocates and initializes the mountpoint private data and
+ *  binds the blockdriver inode to the filesystem private data.  The final
+ *  binding of the private data (containing the blockdriver) to the
+ *  mountpoint is performed by mount().
+ *
+ ****************************************************************************/
+
+static int exfat_bind(FAR struct inode *blkdriver, FAR const void *data,
+                      FAR void **handle)
+{
+  FAR struct exfat_mountpt_s *fs;
+  int ret;
+
+  if (blkdriver == NULL || blkdriver->u.i_bops == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (blkdriver->u.i_bops->open != NULL &&
+      blkdriver->u.i_bops->open(blkdriver) != OK)
+    {
+      return -ENODEV;
+    }
+
+  fs = fs_heap_zalloc(sizeof(struct exfat_mountpt_s));
+  if (fs == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_open;
+    }
+
+  /* The file system is responsible for one reference on the blkdriver
+   * inode and does not have to addref() here, but does have to release it
+   * in unbind().
+   */
+
+  fs->fs_blkdriver = blkdriver;
+  nxmutex_init(&fs->fs_lock);
+
+  ret = exfat_mount(fs, true);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&fs->fs_lock);
+      fs_heap_free(fs);
+      goto errout_with_open;
+    }
+
+  *handle = fs;
+  return OK;
+
+errout_with_open:
+  if (blkdriver->u.i_bops->close != NULL)
+    {
+      blkdriver->u.i_bops->close(blkdriver);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_unbind
+ *
+ * Description: This implements the filesystem portion of the umount
+ *   operation.
+ *
+ ****************************************************************************/
+
+static int exfat_unbind(FAR void *handle, FAR struct inode **blkdriver,
+                        unsigned int flags)
+{
+  FAR struct exfat_mountpt_s *fs = handle;
+  FAR struct exfat_file_s *ef;
+  FAR struct inode *inode;
+  int ret;
+
+  if (fs == NULL)
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (fs->fs_head != NULL)
+    {
+      /* There are open files.  We unmount now only if we are forced with
+       * the MNT_FORCE flag, which loses the data they did not sync.
+       */
+
+      if ((flags & MNT_FORCE) == 0)
+        {
+          nxmutex_unlock(&fs->fs_lock);
+          return (flags != 0) ? -ENOSYS : -EBUSY;
+        }
+
+      for (ef = fs->fs_head; ef != NULL; ef = ef->ef_next)
+        {
+          ef->ef_bflags |= EXFAT_UMOUNT_FORCED;
+        }
+    }
+
+  /* Leave a clean volume marked as such */
+
+  if (fs->fs_mounted && exfat_fscacheflush(fs) >= 0 && fs->fs_voldirty &&
+      (fs->fs_volflags & BS_VOLFLAG_DIRTY) == 0)
+    {
+      exfat_setvoldirty(fs, false);
+    }
+
+  inode = fs->fs_blkdriver;
+  if (inode != NULL)
+    {
+      if (inode->u.i_bops != NULL && inode->u.i_bops->close != NULL)
+        {
+          inode->u.i_bops->close(inode);
+        }
+
+      if (blkdriver != NULL)
+        {
+          *blkdriver = inode;
+        }
+    }
+
+  exfat_unmount(fs);
+  nxmutex_unlock(&fs->fs_lock);
+  nxmutex_destroy(&fs->fs_lock);
+  fs_heap_free(fs);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_statfs
+ *
+ * Description: Return filesystem statistics
+ *
+ ****************************************************************************/
+
+static int exfat_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
+{
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret >= 0)
+    {
+      buf->f_type    = EXFAT_SUPER_MAGIC;
+      buf->f_bsize   = EXFAT_CLUSTERSIZE(fs);
+      buf->f_blocks  = fs->fs_nclusters;
+      buf->f_namelen = EXFAT_NAME_MAX;
+
+      ret = exfat_nfreeclusters(fs, &buf->f_bfree);
+      buf->f_bavail  = buf->f_bfree;
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_remove
+ *
+ * Description:
+ *   Remove a file or an empty directory.  Open files cannot be removed.
+ *
+ ****************************************************************************/
+
+static int exfat_remove(FAR struct inode *mountpt, FAR const char *relpath,
+                        bool directory)
+{
+  struct exfat_dirinfo_s dirinfo;
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  uint64_t key = 0;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  ret = exfat_finddirentry(fs, &dirinfo, relpath);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  if (dirinfo.di_root)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  if (directory)
+    {
+      ret = (dirinfo.di_attr & EXFAT_ATTR_DIRECTORY) == 0 ? -ENOTDIR :
+            exfat_dirempty(fs, &dirinfo);
+    }
+  else
+    {
+      ret = (dirinfo.di_attr & EXFAT_ATTR_DIRECTORY) != 0 ? -EISDIR :
+            exfat_findopen(fs, &dirinfo) != NULL ? -EBUSY : OK;
+    }
+
+  if (ret >= 0)
+    {
+      key = EXFAT_PAGEKEY(dirinfo.di_dir.ec_first, dirinfo.di_offset);
+      ret = exfat_dirremove(fs, &dirinfo);
+    }
+
+  if (ret >= 0)
+    {
+      ret = exfat_fscacheflush(fs);
+    }
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+
+  if (ret >= 0 && !directory)
+    {
+      pagecache_forget(mountpt, key);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_unlink
+ *
+ * Description: Remove a file
+ *
+ ****************************************************************************/
+
+static int exfat_unlink(FAR struct inode *mountpt, FAR const char *relpath)
+{
+  return exfat_remove(mountpt, relpath, false);
+}
+
+/****************************************************************************
+ * Name: exfat_mkdir
+ *
+ * Description: Create a directory
+ *
+ ****************************************************************************/
+
+static int exfat_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
+                       mode_t mode)
+{
+  struct exfat_dirinfo_s dirinfo;
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  ret = exfat_finddirentry(fs, &dirinfo, relpath);
+  if (ret >= 0)
+    {
+      ret = -EEXIST;
+    }
+  else if (ret == -ENOENT && dirinfo.di_last)
+    {
+      ret = exfat_dircreate(fs, &dirinfo, EXFAT_ATTR_DIRECTORY);
+      if (ret >= 0)
+        {
+          ret = exfat_fscacheflush(fs);
+        }
+    }
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_rmdir
+ *
+ * Description: Remove a directory
+ *
+ ****************************************************************************/
+
+static int exfat_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
+{
+  return exfat_remove(mountpt, relpath, true);
+}
+
+/****************************************************************************
+ * Name: exfat_rename
+ *
+ * Description: Rename a file or directory
+ *
+ ****************************************************************************/
+
+static int exfat_rename(FAR struct inode *mountpt,
+                        FAR const char *oldrelpath,
+                        FAR const char *newrelpath)
+{
+  struct exfat_dirinfo_s olddir;
+  struct exfat_dirinfo_s newdir;
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  FAR struct exfat_file_s *ef;
+  uint64_t key = 0;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  ret = exfat_finddirentry(fs, &olddir, oldrelpath);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  if (olddir.di_root)
+    {
+      ret = -EXDEV;
+      goto errout_with_lock;
+    }
+
+  /* The new name is left in fs_name by the failed lookup */
+
+  ret = exfat_finddirentry(fs, &newdir, newrelpath);
+  if (ret >= 0)
+    {
+      ret = -EEXIST;
+      goto errout_with_lock;
+    }
+  else if (ret != -ENOENT || !newdir.di_last)
+    {
+      goto errout_with_lock;
+    }
+
+  /* An open file follows its entry set, and its pages go to its new key */
+
+  ef  = exfat_findopen(fs, &olddir);
+  key = EXFAT_PAGEKEY(olddir.di_dir.ec_first, olddir.di_offset);
+
+  ret = exfat_dirrename(fs, &olddir, &newdir);
+  if (ret >= 0)
+    {
+      if (ef != NULL)
+        {
+          ef->ef_dirpos.dp_dir    = newdir.di_dir;
+          ef->ef_dirpos.dp_offset = newdir.di_offset;
+        }
+
+      ret = exfat_fscacheflush(fs);
+    }
+
+errout_with_lock:
+  nxmutex_unlock(&fs->fs_lock);
+
+  if (ret >= 0)
+    {
+      pagecache_forget(mountpt, key);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int exfat_stat(FAR struct inode *mountpt, FAR const char *relpath,
+                      FAR struct stat *buf)
+{
+  struct exfat_dirinfo_s dirinfo;
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  FAR struct exfat_file_s *ef;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  if (ret >= 0)
+    {
+      ret = exfat_finddirentry(fs, &dirinfo, relpath);
+    }
+
+  if (ret >= 0)
+    {
+      /* An open file may be ahead of its entry set */
+
+      ef = dirinfo.di_root ? NULL : exfat_findopen(fs, &dirinfo);
+      if (ef != NULL)
+        {
+          dirinfo.di_size = ef->ef_size;
+        }
+
+      exfat_stat_common(fs, &dirinfo, buf);
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_syncfs
+ *
+ * Description:
+ *   Write all of the open files and the metadata to the media.
+ *
+ ****************************************************************************/
+
+static int exfat_syncfs(FAR struct inode *mountpt)
+{
+  FAR struct exfat_mountpt_s *fs = mountpt->i_private;
+  FAR struct exfat_file_s *ef;
+  int ret;
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_checkmount(fs);
+  for (ef = fs->fs_head; ret >= 0 && ef != NULL; ef = ef->ef_next)
+    {
+      ret = exfat_filesync(fs, ef);
+    }
+
+  if (ret >= 0)
+    {
+      ret = exfat_fscacheflush(fs);
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ret;
+}
+
+#ifdef CONFIG_FS_PAGECACHE
+/****************************************************************************
+ * Name: exfat_pagekey
+ *
+ * Description:
+ *   Files are identified by the location of their entry sets.
+ *
+ ****************************************************************************/
+
+static int exfat_pagekey(FAR const struct file *filep, FAR uint64_t *key)
+{
+  FAR struct exfat_file_s *ef = filep->f_priv;
+
+  *key = EXFAT_PAGEKEY(ef->ef_dirpos.dp_dir.ec_first,
+                       ef->ef_dirpos.dp_offset);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_readpage
+ ****************************************************************************/
+
+static ssize_t exfat_readpage(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  FAR struct exfat_mountpt_s *fs;
+  ssize_t nread;
+  int ret;
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nread = exfat_readat(fs, filep->f_priv, buffer, buflen, offset);
+  nxmutex_unlock(&fs->fs_lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: exfat_writepage
+ ****************************************************************************/
+
+static ssize_t exfat_writepage(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen,
+                               off_t offset)
+{
+  FAR struct exfat_mountpt_s *fs;
+  ssize_t nwritten;
+  int ret;
+
+  ret = exfat_lock(filep, &fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nwritten = exfat_writeat(fs, filep->f_priv, buffer, buflen, offset);
+  nxmutex_unlock(&fs->fs_lock);
+  return nwritten;
+}
+#endif
@@ -0,0 +1,386 @@
+/****************************************************************************
+ * fs/exfat/fs_exfat.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_EXFAT_FS_EXFAT_H
+#define __FS_EXFAT_FS_EXFAT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These offsets describe the exFAT boot sector */
+
+#define BS_FILESYSTEMNAME     3 /*  8@3:   "EXFAT   " */
+#define BS_PARTITIONOFFSET   64 /*  8@64:  Media-relative sector of volume */
+#define BS_VOLUMELENGTH      72 /*  8@72:  Size of the volume in sectors */
+#define BS_FATOFFSET         80 /*  4@80:  Volume-relative sector of FAT */
+#define BS_FATLENGTH         84 /*  4@84:  Sectors in one FAT */
+#define BS_HEAPOFFSET        88 /*  4@88:  Volume-relative sector of heap */
+#define BS_CLUSTERCOUNT      92 /*  4@92:  Clusters in the cluster heap */
+#define BS_ROOTCLUSTER       96 /*  4@96:  First cluster of the root dir */
+#define BS_REVISION         104 /*  2@104: File system revision (1.00) */
+#define BS_VOLUMEFLAGS      106 /*  2@106: Volume flags */
+#define BS_SECTORSHIFT      108 /*  1@108: log2 of bytes per sector */
+#define BS_CLUSTERSHIFT     109 /*  1@109: log2 of sectors per cluster */
+#define BS_NUMBEROFFATS     110 /*  1@110: Number of FATs (1 or 2) */
+#define BS_SIGNATURE        510 /*  2@510: 0xaa55 */
+
+#define BS_SIGNATURE_VALUE  0xaa55
+#define BS_VOLFLAG_ACTIVEFAT 0x0001 /* Second FAT is the active one */
+#define BS_VOLFLAG_DIRTY     0x0002 /* Volume may be inconsistent */
+
+/* Partition table entries of a master boot record */
+
+#define MBR_TABLE           446 /* 16@446: Four partition table entries */
+#define MBR_ENTRYSIZE        16
+#define MBR_STARTLBA          8 /*  4@8:   First sector of the partition */
+
+/* Directory entries are 32 bytes.  An entry set is a file entry followed
+ * by a stream extension entry and by up to 17 file name entries.
+ */
+
+#define EXFAT_DIRENT_SHIFT    5
+#define EXFAT_DIRENT_SIZE    (1 << EXFAT_DIRENT_SHIFT)
+#define EXFAT_NAME_MAX      255 /* UTF-16 units in a file name */
+#define EXFAT_NAME_PERENTRY  15 /* UTF-16 units in a file name entry */
+#define EXFAT_MAXSET         (2 + (EXFAT_NAME_MAX + 14) / 15)
+
+#define EXFAT_TYPE_EOD     0x00 /* End of directory */
+#define EXFAT_TYPE_INUSE   0x80 /* Set in all entries that are in use */
+#define EXFAT_TYPE_BITMAP  0x81 /* Allocation bitmap */
+#define EXFAT_TYPE_UPCASE  0x82 /* Up-case table */
+#define EXFAT_TYPE_LABEL   0x83 /* Volume label */
+#define EXFAT_TYPE_FILE    0x85 /* File or directory */
+#define EXFAT_TYPE_STREAM  0xc0 /* Stream extension */
+#define EXFAT_TYPE_NAME    0xc1 /* File name */
+
+/* File directory entry */
+
+#define FILE_SECONDARYCOUNT   1 /*  1@1:   Number of secondary entries */
+#define FILE_SETCHECKSUM      2 /*  2@2:   Checksum of the entry set */
+#define FILE_ATTRIBUTES       4 /*  2@4:   File attributes */
+#define FILE_CREATETIME       8 /*  4@8:   Creation timestamp */
+#define FILE_MODIFYTIME      12 /*  4@12:  Last modification timestamp */
+#define FILE_ACCESSTIME      16 /*  4@16:  Last access timestamp */
+#define FILE_CREATE10MS      20 /*  1@20:  Creation time, 10ms units */
+#define FILE_MODIFY10MS      21 /*  1@21:  Modification time, 10ms units */
+#define FILE_CREATEUTC       22 /*  1@22:  Creation time UTC offset */
+#define FILE_MODIFYUTC       23 /*  1@23:  Modification time UTC offset */
+#define FILE_ACCESSUTC       24 /*  1@24:  Access time UTC offset */
+
+/* Stream extension directory entry */
+
+#define STREAM_FLAGS          1 /*  1@1:   General secondary flags */
+#define STREAM_NAMELENGTH     3 /*  1@3:   Length of the name in UTF-16 */
+#define STREAM_NAMEHASH       4 /*  2@4:   Hash of the up-cased name */
+#define STREAM_VALIDLENGTH    8 /*  8@8:   Bytes of valid data */
+#define STREAM_FIRSTCLUSTER  20 /*  4@20:  First cluster of the data */
+#define STREAM_DATALENGTH    24 /*  8@24:  Size of the data in bytes */
+
+/* Allocation bitmap and up-case table directory entries share the layout
+ * of the stream extension for their clusters.
+ */
+
+#define TABLE_FIRSTCLUSTER   20 /*  4@20:  First cluster of the table */
+#define TABLE_DATALENGTH     24 /*  8@24:  Size of the table in bytes */
+
+#define EXFAT_UTC_VALID    0x80 /* The UTC offset field is valid */
+
+/* File name directory entry */
+
+#define NAME_FILENAME         2 /* 30@2:   15 UTF-16 characters */
+
+/* General secondary flags of the stream extension */
+
+#define EXFAT_FLAG_ALLOCPOSSIBLE 0x01 /* Clusters may be allocated */
+#define EXFAT_FLAG_NOFATCHAIN    0x02 /* Clusters are contiguous and are
+                                       * not described by the FAT */
+
+/* File attributes */
+
+#define EXFAT_ATTR_READONLY  0x0001
+#define EXFAT_ATTR_HIDDEN    0x0002
+#define EXFAT_ATTR_SYSTEM    0x0004
+#define EXFAT_ATTR_DIRECTORY 0x0010
+#define EXFAT_ATTR_ARCHIVE   0x0020
+
+/* FAT entries */
+
+#define EXFAT_FIRST_CLUSTER  2
+#define EXFAT_BAD_CLUSTER    0xfffffff7
+#define EXFAT_EOC            0xffffffff
+
+/* File flags */
+
+#define EXFAT_FILE_DIRTY     0x01 /* The entry set must be updated */
+#define EXFAT_BUFFER_DIRTY   0x02 /* ef_buffer must be written back */
+#define EXFAT_UMOUNT_FORCED  0x04 /* The volume was unmounted */
+
+/* Geometry helpers */
+
+#define EXFAT_CLUSTERSHIFT(fs) ((fs)->fs_sectorshift + (fs)->fs_clustershift)
+#define EXFAT_CLUSTERSIZE(fs)  ((uint32_t)1 << EXFAT_CLUSTERSHIFT(fs))
+#define EXFAT_SECTORMASK(fs)   ((fs)->fs_sectorsize - 1)
+#define EXFAT_NCLUSTERS(fs, n) \
+  ((uint32_t)(((n) + EXFAT_CLUSTERSIZE(fs) - 1) >> EXFAT_CLUSTERSHIFT(fs)))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes the clusters of a file or a directory, and
+ * caches the last cluster that was looked up in them so that sequential
+ * accesses to a FAT chain do not have to walk it from its start.
+ */
+
+struct exfat_chain_s
+{
+  uint32_t ec_first;               /* First cluster, or 0 if none */
+  uint32_t ec_nclusters;           /* Number of clusters allocated */
+  uint32_t ec_last;                /* Last cluster, or 0 if not known */
+  uint32_t ec_index;               /* Index of ec_cluster in the chain */
+  uint32_t ec_cluster;             /* Cluster last looked up, or 0 */
+  uint8_t  ec_flags;               /* EXFAT_FLAG_* of the stream */
+};
+
+/* This structure locates an entry set: the directory holding the set and
+ * the byte offset of its file entry in that directory.
+ */
+
+struct exfat_dirpos_s
+{
+  struct exfat_chain_s dp_dir;     /* The directory holding the set */
+  uint32_t dp_offset;              /* Byte offset of the file entry */
+};
+
+/* This structure represents the overall mountpoint state.  An instance of
+ * this structure is retained as inode private data on each mountpoint that
+ * is mounted with an exFAT file system.
+ */
+
+struct exfat_file_s;
+struct exfat_mountpt_s
+{
+  FAR struct inode *fs_blkdriver;   /* The block driver of the volume */
+  FAR struct exfat_file_s *fs_head; /* All files open on the mountpoint */
+
+  mutex_t  fs_lock;                /* Serializes access to the volume */
+  off_t    fs_hwnsectors;          /* Sectors reported by the driver */
+  off_t    fs_volstart;            /* Media sector of the boot sector */
+  off_t    fs_fatstart;            /* Media sector of the active FAT */
+  off_t    fs_heapstart;           /* Media sector of cluster 2 */
+  off_t    fs_bitmapstart;         /* Media sector of the bitmap */
+  off_t    fs_cachesector;         /* Sector held in fs_buffer */
+  uint32_t fs_nclusters;           /* Clusters in the cluster heap */
+  uint32_t fs_nfreeclusters;       /* Free clusters, UINT32_MAX if not yet
+                                    * counted */
+  uint32_t fs_nextfree;            /* Where to start looking for clusters */
+  struct exfat_chain_s fs_root;    /* Root directory clusters */
+  uint16_t fs_sectorsize;          /* Bytes per sector */
+  uint16_t fs_volflags;            /* Volume flags at mount time */
+  uint8_t  fs_sectorshift;         /* log2 of fs_sectorsize */
+  uint8_t  fs_clustershift;        /* log2 of sectors per cluster */
+  bool     fs_mounted;             /* true: The file system is ready */
+  bool     fs_dirty;               /* true: fs_buffer must be written */
+  bool     fs_voldirty;            /* true: The dirty flag is on disk */
+  uint8_t  fs_namelen;             /* UTF-16 units in fs_name */
+  FAR uint8_t *fs_buffer;          /* Sector cache for metadata */
+  FAR uint16_t *fs_upcase;         /* First entries of the up-case table */
+
+  /* Scratch space of the directory code, protected by fs_lock */
+
+  uint16_t fs_name[EXFAT_NAME_MAX];
+  uint8_t  fs_set[EXFAT_MAXSET * EXFAT_DIRENT_SIZE];
+};
+
+/* This structure represents an open file under the mountpoint.  All of the
+ * struct file instances that refer to the same file share one instance,
+ * retained as their private data, so that they agree on the size and the
+ * clusters of the file.
+ */
+
+struct exfat_file_s
+{
+  FAR struct exfat_file_s *ef_next; /* Next file open on the mountpoint */
+  struct exfat_dirpos_s ef_dirpos;  /* Location of the entry set */
+  struct exfat_chain_s ef_chain;    /* Clusters of the file */
+  uint64_t ef_size;                 /* DataLength: size of the file */
+  uint64_t ef_validsize;            /* ValidDataLength: bytes written */
+  off_t    ef_cachesector;          /* Sector held in ef_buffer, or -1 */
+  uint16_t ef_crefs;                /* Number of struct file references */
+  uint16_t ef_attr;                 /* File attributes */
+  uint8_t  ef_bflags;               /* EXFAT_FILE_*, EXFAT_BUFFER_DIRTY and
+                                     * EXFAT_UMOUNT_FORCED */
+  FAR uint8_t *ef_buffer;           /* Sector buffer for partial accesses */
+};
+
+/* This structure is used for opendir, readdir, ... */
+
+struct exfat_dirent_s
+{
+  struct fs_dirent_s base;         /* VFS directory structure */
+  struct exfat_chain_s ed_dir;     /* The directory being read */
+  uint32_t ed_offset;              /* Offset of the next entry to read */
+};
+
+/* This structure is used internally for describing directory entries */
+
+struct exfat_dirinfo_s
+{
+  struct exfat_chain_s di_dir;     /* The directory searched last */
+  struct exfat_dirpos_s di_dirpos; /* Entry set of that directory, unless
+                                    * di_dir is the root directory */
+  bool     di_root;                /* The path named the root directory */
+  bool     di_parent;              /* di_dir is not the root directory */
+  bool     di_last;                /* Failed looking up the last name */
+  uint32_t di_offset;              /* Offset of the entry set found */
+  uint32_t di_free;                /* Offset of free entries, UINT32_MAX
+                                    * if more must be allocated */
+  uint8_t  di_nentries;            /* Entries in the set found */
+
+  /* The fields of the entry set found */
+
+  uint16_t di_attr;                /* File attributes */
+  uint8_t  di_flags;               /* EXFAT_FLAG_* of the stream */
+  uint32_t di_first;               /* First cluster */
+  uint64_t di_size;                /* DataLength */
+  uint64_t di_validsize;           /* ValidDataLength */
+  time_t   di_ctime;               /* Creation time */
+  time_t   di_mtime;               /* Modification time */
+  time_t   di_atime;               /* Access time */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Utilities to handle unaligned little-endian accesses */
+
+EXTERN uint16_t exfat_getuint16(FAR const uint8_t *ptr);
+EXTERN uint32_t exfat_getuint32(FAR const uint8_t *ptr);
+EXTERN uint64_t exfat_getuint64(FAR const uint8_t *ptr);
+EXTERN void     exfat_putuint16(FAR uint8_t *ptr, uint16_t value16);
+EXTERN void     exfat_putuint32(FAR uint8_t *ptr, uint32_t value32);
+EXTERN void     exfat_putuint64(FAR uint8_t *ptr, uint64_t value64);
+
+/* Timestamps */
+
+EXTERN uint32_t exfat_systime2time(void);
+EXTERN time_t   exfat_time2systime(uint32_t timestamp, uint8_t utcoffset);
+
+/* Mounting and low-level hardware access */
+
+EXTERN int      exfat_mount(FAR struct exfat_mountpt_s *fs,
+                            bool writeable);
+EXTERN void     exfat_unmount(FAR struct exfat_mountpt_s *fs);
+EXTERN int      exfat_checkmount(FAR struct exfat_mountpt_s *fs);
+EXTERN int      exfat_setvoldirty(FAR struct exfat_mountpt_s *fs,
+                                  bool dirty);
+EXTERN int      exfat_hwread(FAR struct exfat_mountpt_s *fs,
+                             FAR uint8_t *buffer, off_t sector,
+                             unsigned int nsectors);
+EXTERN int      exfat_hwwrite(FAR struct exfat_mountpt_s *fs,
+                              FAR const uint8_t *buffer, off_t sector,
+                              unsigned int nsectors);
+EXTERN int      exfat_fscacheflush(FAR struct exfat_mountpt_s *fs);
+EXTERN int      exfat_fscacheread(FAR struct exfat_mountpt_s *fs,
+                                  off_t sector);
+
+/* Clusters and cluster chains */
+
+EXTERN off_t    exfat_cluster2sector(FAR struct exfat_mountpt_s *fs,
+                                     uint32_t cluster);
+EXTERN int      exfat_chaincluster(FAR struct exfat_mountpt_s *fs,
+                                   FAR struct exfat_chain_s *chain,
+                                   uint32_t index, FAR uint32_t *cluster);
+EXTERN uint32_t exfat_chaincontig(FAR struct exfat_mountpt_s *fs,
+                                  FAR struct exfat_chain_s *chain,
+                                  uint32_t index, uint32_t cluster,
+                                  uint32_t maxclusters);
+EXTERN int      exfat_chainextend(FAR struct exfat_mountpt_s *fs,
+                                  FAR struct exfat_chain_s *chain,
+                                  uint32_t nclusters, bool zero);
+EXTERN int      exfat_chaintruncate(FAR struct exfat_mountpt_s *fs,
+                                    FAR struct exfat_chain_s *chain,
+                                    uint32_t nclusters);
+EXTERN int      exfat_nfreeclusters(FAR struct exfat_mountpt_s *fs,
+                                    FAR fsblkcnt_t *pfreeclusters);
+
+/* Directories and entry sets */
+
+EXTERN int      exfat_chainptr(FAR struct exfat_mountpt_s *fs,
+                               FAR struct exfat_chain_s *chain,
+                               uint32_t offset, FAR uint8_t **ptr);
+EXTERN int      exfat_readset(FAR struct exfat_mountpt_s *fs,
+                              FAR struct exfat_chain_s *dir,
+                              uint32_t offset);
+EXTERN int      exfat_writeset(FAR struct exfat_mountpt_s *fs,
+                               FAR struct exfat_chain_s *dir,
+                               uint32_t offset, int nentries);
+EXTERN int      exfat_finddirentry(FAR struct exfat_mountpt_s *fs,
+                                   FAR struct exfat_dirinfo_s *dirinfo,
+                                   FAR const char *relpath);
+EXTERN int      exfat_nextdirentry(FAR struct exfat_mountpt_s *fs,
+                                   FAR struct exfat_dirent_s *edir,
+                                   FAR struct dirent *entry);
+EXTERN int      exfat_dircreate(FAR struct exfat_mountpt_s *fs,
+                                FAR struct exfat_dirinfo_s *dirinfo,
+                                uint16_t attr);
+EXTERN int      exfat_dirrename(FAR struct exfat_mountpt_s *fs,
+                                FAR struct exfat_dirinfo_s *olddir,
+                                FAR struct exfat_dirinfo_s *newdir);
+EXTERN int      exfat_dirremove(FAR struct exfat_mountpt_s *fs,
+                                FAR struct exfat_dirinfo_s *dirinfo);
+EXTERN int      exfat_dirempty(FAR struct exfat_mountpt_s *fs,
+                               FAR struct exfat_dirinfo_s *dirinfo);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __FS_EXFAT_FS_EXFAT_H */
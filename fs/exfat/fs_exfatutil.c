@@ -0,0 +1,2440 @@
+/****************************************************************************
+ * fs/exfat/fs_exfatutil.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+#include <dirent.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <time.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/sched.h>
+
+#include "fs_exfat.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Timestamps carry the year from 1980, the month, the day, the hour, the
+ * minute and the seconds / 2.  This is 1980-01-01 00:00:00.
+ */
+
+#define EXFAT_TIME_1980      0x00210000
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: exfat_rawwrite
+ *
+ * Description:
+ *   Write sectors to the block driver, without marking the volume dirty.
+ *
+ ****************************************************************************/
+
+static int exfat_rawwrite(FAR struct exfat_mountpt_s *fs,
+                          FAR const uint8_t *buffer, off_t sector,
+                          unsigned int nsectors)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  ssize_t nwritten;
+
+  if (inode == NULL || inode->u.i_bops == NULL ||
+      inode->u.i_bops->write == NULL)
+    {
+      return -ENODEV;
+    }
+
+  nxsched_iowait_enter();
+  nwritten = inode->u.i_bops->write(inode, buffer, sector, nsectors);
+  nxsched_iowait_leave();
+  if (nwritten < 0)
+    {
+      return (int)nwritten;
+    }
+
+  return nwritten == nsectors ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: exfat_checkboot
+ *
+ * Description:
+ *   Check if fs_buffer holds an exFAT boot sector that this implementation
+ *   can use.
+ *
+ ****************************************************************************/
+
+static bool exfat_checkboot(FAR struct exfat_mountpt_s *fs)
+{
+  FAR const uint8_t *bs = fs->fs_buffer;
+  uint8_t sectorshift;
+  uint8_t clustershift;
+  uint32_t nclusters;
+  uint32_t root;
+
+  if (exfat_getuint16(bs + BS_SIGNATURE) != BS_SIGNATURE_VALUE ||
+      memcmp(bs + BS_FILESYSTEMNAME, "EXFAT   ", 8) != 0)
+    {
+      return false;
+    }
+
+  /* The sector size of the file system must be the one of the media, and
+   * clusters cannot be larger than 32MiB.
+   */
+
+  sectorshift  = bs[BS_SECTORSHIFT];
+  clustershift = bs[BS_CLUSTERSHIFT];
+  nclusters    = exfat_getuint32(bs + BS_CLUSTERCOUNT);
+  root         = exfat_getuint32(bs + BS_ROOTCLUSTER);
+
+  if (sectorshift < 9 || sectorshift > 12 ||
+      (1 << sectorshift) != fs->fs_sectorsize ||
+      sectorshift + clustershift > 25 ||
+      bs[BS_NUMBEROFFATS] < 1 || bs[BS_NUMBEROFFATS] > 2 ||
+      nclusters == 0 || nclusters > EXFAT_BAD_CLUSTER - 2 ||
+      root < EXFAT_FIRST_CLUSTER || root >= nclusters + 2)
+    {
+      ferr("ERROR: Unsupported exFAT geometry\n");
+      return false;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: exfat_getfat
+ *
+ * Description:
+ *   Get the FAT entry of a cluster, which is the next cluster of its chain.
+ *
+ ****************************************************************************/
+
+static int exfat_getfat(FAR struct exfat_mountpt_s *fs, uint32_t cluster,
+                        FAR uint32_t *next)
+{
+  off_t byteoff = (off_t)cluster << 2;
+  int ret;
+
+  ret = exfat_fscacheread(fs, fs->fs_fatstart +
+                              (byteoff >> fs->fs_sectorshift));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *next = exfat_getuint32(fs->fs_buffer + (byteoff & EXFAT_SECTORMASK(fs)));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_putfat
+ ****************************************************************************/
+
+static int exfat_putfat(FAR struct exfat_mountpt_s *fs, uint32_t cluster,
+                        uint32_t next)
+{
+  off_t byteoff = (off_t)cluster << 2;
+  int ret;
+
+  ret = exfat_fscacheread(fs, fs->fs_fatstart +
+                              (byteoff >> fs->fs_sectorshift));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  exfat_putuint32(fs->fs_buffer + (byteoff & EXFAT_SECTORMASK(fs)), next);
+  fs->fs_dirty = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_validcluster
+ ****************************************************************************/
+
+static inline bool exfat_validcluster(FAR struct exfat_mountpt_s *fs,
+                                      uint32_t cluster)
+{
+  return cluster >= EXFAT_FIRST_CLUSTER &&
+         cluster < fs->fs_nclusters + EXFAT_FIRST_CLUSTER;
+}
+
+/****************************************************************************
+ * Name: exfat_bitmapptr
+ *
+ * Description:
+ *   Return the byte of the allocation bitmap that holds the bit of a
+ *   cluster.
+ *
+ ****************************************************************************/
+
+static int exfat_bitmapptr(FAR struct exfat_mountpt_s *fs, uint32_t cluster,
+                           FAR uint8_t **ptr)
+{
+  uint32_t byteoff = (cluster - EXFAT_FIRST_CLUSTER) >> 3;
+  int ret;
+
+  ret = exfat_fscacheread(fs, fs->fs_bitmapstart +
+                              (byteoff >> fs->fs_sectorshift));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *ptr = fs->fs_buffer + (byteoff & EXFAT_SECTORMASK(fs));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_setbits
+ *
+ * Description:
+ *   Mark a range of clusters as used or as free in the allocation bitmap.
+ *
+ ****************************************************************************/
+
+static int exfat_setbits(FAR struct exfat_mountpt_s *fs, uint32_t cluster,
+                         uint32_t count, bool used)
+{
+  FAR uint8_t *ptr;
+  uint32_t i;
+  uint8_t mask;
+  int ret;
+
+  for (i = 0; i < count; i++, cluster++)
+    {
+      ret = exfat_bitmapptr(fs, cluster, &ptr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      mask = 1 << ((cluster - EXFAT_FIRST_CLUSTER) & 7);
+      if (used)
+        {
+          *ptr |= mask;
+        }
+      else
+        {
+          *ptr &= ~mask;
+        }
+
+      fs->fs_dirty = true;
+    }
+
+  if (fs->fs_nfreeclusters != UINT32_MAX)
+    {
+      /* The callers never change the state of a cluster twice */
+
+      fs->fs_nfreeclusters += used ? -count : count;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_isfree
+ ****************************************************************************/
+
+static int exfat_isfree(FAR struct exfat_mountpt_s *fs, uint32_t cluster)
+{
+  FAR uint8_t *ptr;
+  int ret;
+
+  if (!exfat_validcluster(fs, cluster))
+    {
+      return 0;
+    }
+
+  ret = exfat_bitmapptr(fs, cluster, &ptr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return (*ptr & (1 << ((cluster - EXFAT_FIRST_CLUSTER) & 7))) == 0;
+}
+
+/****************************************************************************
+ * Name: exfat_scanfree
+ *
+ * Description:
+ *   Find the first free cluster of the bitmap between two bit indices.
+ *   Whole bytes of used clusters are skipped at once.
+ *
+ ****************************************************************************/
+
+static int exfat_scanfree(FAR struct exfat_mountpt_s *fs, uint32_t from,
+                          uint32_t to, FAR uint32_t *cluster)
+{
+  FAR uint8_t *ptr;
+  int ret;
+
+  while (from < to)
+    {
+      ret = exfat_bitmapptr(fs, from + EXFAT_FIRST_CLUSTER, &ptr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if ((from & 7) == 0 && *ptr == 0xff)
+        {
+          from += 8;
+        }
+      else if ((*ptr & (1 << (from & 7))) == 0)
+        {
+          *cluster = from + EXFAT_FIRST_CLUSTER;
+          return OK;
+        }
+      else
+        {
+          from++;
+        }
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: exfat_findfree
+ *
+ * Description:
+ *   Find a free cluster, looking from a hint up to the end of the heap and
+ *   then from its start.
+ *
+ ****************************************************************************/
+
+static int exfat_findfree(FAR struct exfat_mountpt_s *fs, uint32_t hint,
+                          FAR uint32_t *cluster)
+{
+  uint32_t start;
+  int ret;
+
+  if (fs->fs_nfreeclusters == 0)
+    {
+      return -ENOSPC;
+    }
+
+  start = exfat_validcluster(fs, hint) ? hint - EXFAT_FIRST_CLUSTER : 0;
+  ret   = exfat_scanfree(fs, start, fs->fs_nclusters, cluster);
+  if (ret == -ENOSPC)
+    {
+      ret = exfat_scanfree(fs, 0, start, cluster);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_zerocluster
+ *
+ * Description:
+ *   Clear the sectors of a new directory cluster through fs_buffer, which
+ *   is left holding its last sector.
+ *
+ ****************************************************************************/
+
+static int exfat_zerocluster(FAR struct exfat_mountpt_s *fs,
+                             uint32_t cluster)
+{
+  off_t sector = exfat_cluster2sector(fs, cluster);
+  unsigned int i;
+  int ret;
+
+  ret = exfat_fscacheflush(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(fs->fs_buffer, 0, fs->fs_sectorsize);
+  fs->fs_cachesector = -1;
+
+  for (i = 0; i < (1 << fs->fs_clustershift); i++)
+    {
+      ret = exfat_hwwrite(fs, fs->fs_buffer, sector + i, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  fs->fs_cachesector = sector + i - 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_upcase
+ ****************************************************************************/
+
+static inline uint16_t exfat_upcase(FAR struct exfat_mountpt_s *fs,
+                                    uint16_t ch)
+{
+  return ch < CONFIG_EXFAT_UPCASE_CHARS ? fs->fs_upcase[ch] : ch;
+}
+
+/****************************************************************************
+ * Name: exfat_loadupcase
+ *
+ * Description:
+ *   Load the first entries of the up-case table.  The table may be
+ *   compressed: 0xffff followed by a count stands for that many characters
+ *   that are their own up-case.
+ *
+ ****************************************************************************/
+
+static int exfat_loadupcase(FAR struct exfat_mountpt_s *fs,
+                            uint32_t first, uint64_t length)
+{
+  struct exfat_chain_s chain;
+  FAR uint8_t *ptr;
+  uint32_t offset;
+  uint32_t ch;
+  uint16_t value;
+  bool run = false;
+  int ret;
+
+  fs->fs_upcase = fs_heap_malloc(CONFIG_EXFAT_UPCASE_CHARS *
+                                 sizeof(uint16_t));
+  if (fs->fs_upcase == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (ch = 0; ch < CONFIG_EXFAT_UPCASE_CHARS; ch++)
+    {
+      fs->fs_upcase[ch] = ch;
+    }
+
+  memset(&chain, 0, sizeof(chain));
+  chain.ec_first     = first;
+  chain.ec_nclusters = EXFAT_NCLUSTERS(fs, length);
+
+  for (offset = 0, ch = 0;
+       offset + 1 < length && ch < CONFIG_EXFAT_UPCASE_CHARS;
+       offset += 2)
+    {
+      ret = exfat_chainptr(fs, &chain, offset, &ptr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      value = exfat_getuint16(ptr);
+      if (run)
+        {
+          ch += value;
+          run = false;
+        }
+      else if (value == 0xffff)
+        {
+          run = true;
+        }
+      else
+        {
+          fs->fs_upcase[ch++] = value;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_findtables
+ *
+ * Description:
+ *   Find the allocation bitmap and the up-case table in the root directory
+ *   and load them.
+ *
+ ****************************************************************************/
+
+static int exfat_findtables(FAR struct exfat_mountpt_s *fs)
+{
+  FAR uint8_t *ent;
+  uint32_t bitmap = 0;
+  uint64_t bitmaplen = 0;
+  uint32_t upcase = 0;
+  uint64_t upcaselen = 0;
+  uint32_t offset;
+  uint32_t cluster;
+  uint32_t next;
+  uint32_t n;
+  uint8_t active;
+  int ret;
+
+  /* With two FATs there are two bitmaps, and the volume flags say which of
+   * them is active.
+   */
+
+  active = fs->fs_volflags & BS_VOLFLAG_ACTIVEFAT;
+
+  for (offset = 0; ; offset += EXFAT_DIRENT_SIZE)
+    {
+      ret = exfat_chainptr(fs, &fs->fs_root, offset, &ent);
+      if (ret == -ENOENT || (ret >= 0 && ent[0] == EXFAT_TYPE_EOD))
+        {
+          break;
+        }
+      else if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (ent[0] == EXFAT_TYPE_BITMAP && (ent[1] & 1) == active)
+        {
+          bitmap    = exfat_getuint32(ent + TABLE_FIRSTCLUSTER);
+          bitmaplen = exfat_getuint64(ent + TABLE_DATALENGTH);
+        }
+      else if (ent[0] == EXFAT_TYPE_UPCASE)
+        {
+          upcase    = exfat_getuint32(ent + TABLE_FIRSTCLUSTER);
+          upcaselen = exfat_getuint64(ent + TABLE_DATALENGTH);
+        }
+    }
+
+  if (!exfat_validcluster(fs, bitmap) ||
+      bitmaplen < (fs->fs_nclusters + 7) / 8 ||
+      !exfat_validcluster(fs, upcase))
+    {
+      ferr("ERROR: No allocation bitmap or up-case table\n");
+      return -EINVAL;
+    }
+
+  /* The bitmap is accessed through its first sector, which needs it to be
+   * contiguous.  Every formatter allocates it so.
+   */
+
+  for (cluster = bitmap, n = EXFAT_NCLUSTERS(fs, bitmaplen); n > 1; n--)
+    {
+      ret = exfat_getfat(fs, cluster, &next);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (next != cluster + 1)
+        {
+          ferr("ERROR: Fragmented allocation bitmap\n");
+          return -EINVAL;
+        }
+
+      cluster = next;
+    }
+
+  fs->fs_bitmapstart = exfat_cluster2sector(fs, bitmap);
+  return exfat_loadupcase(fs, upcase, upcaselen);
+}
+
+/****************************************************************************
+ * Name: exfat_namehash
+ *
+ * Description:
+ *   Compute the hash of the up-cased name in fs_name.
+ *
+ ****************************************************************************/
+
+static uint16_t exfat_namehash(FAR struct exfat_mountpt_s *fs)
+{
+  uint16_t hash = 0;
+  uint16_t ch;
+  int i;
+
+  for (i = 0; i < fs->fs_namelen; i++)
+    {
+      ch   = exfat_upcase(fs, fs->fs_name[i]);
+      hash = ((hash & 1) ? 0x8000 : 0) + (hash >> 1) + (ch & 0xff);
+      hash = ((hash & 1) ? 0x8000 : 0) + (hash >> 1) + (ch >> 8);
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: exfat_setchecksum
+ *
+ * Description:
+ *   Compute the checksum of an entry set.  It covers all of the entries of
+ *   the set but for the checksum field itself.
+ *
+ ****************************************************************************/
+
+static uint16_t exfat_setchecksum(FAR const uint8_t *set, int nentries)
+{
+  uint16_t chksum = 0;
+  int i;
+
+  for (i = 0; i < nentries * EXFAT_DIRENT_SIZE; i++)
+    {
+      if (i == FILE_SETCHECKSUM || i == FILE_SETCHECKSUM + 1)
+        {
+          continue;
+        }
+
+      chksum = ((chksum & 1) ? 0x8000 : 0) + (chksum >> 1) + set[i];
+    }
+
+  return chksum;
+}
+
+/****************************************************************************
+ * Name: exfat_setname
+ *
+ * Description:
+ *   Return a pointer to the name entry character of an entry set.
+ *
+ ****************************************************************************/
+
+static inline FAR uint8_t *exfat_setname(FAR uint8_t *set, int i)
+{
+  return set + (2 + i / EXFAT_NAME_PERENTRY) * EXFAT_DIRENT_SIZE +
+         NAME_FILENAME + (i % EXFAT_NAME_PERENTRY) * 2;
+}
+
+/****************************************************************************
+ * Name: exfat_parsename
+ *
+ * Description:
+ *   Convert the next component of a UTF-8 path to UTF-16 in fs_name.
+ *
+ ****************************************************************************/
+
+static int exfat_parsename(FAR struct exfat_mountpt_s *fs,
+                           FAR const char **path)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)*path;
+  uint32_t ch;
+  int extra;
+  int len = 0;
+
+  while (*ptr != '\0' && *ptr != '/')
+    {
+      /* Decode one UTF-8 sequence */
+
+      ch = *ptr++;
+      if (ch < 0x80)
+        {
+          extra = 0;
+        }
+      else if ((ch & 0xe0) == 0xc0)
+        {
+          ch &= 0x1f;
+          extra = 1;
+        }
+      else if ((ch & 0xf0) == 0xe0)
+        {
+          ch &= 0x0f;
+          extra = 2;
+        }
+      else if ((ch & 0xf8) == 0xf0)
+        {
+          ch &= 0x07;
+          extra = 3;
+        }
+      else
+        {
+          return -EINVAL;
+        }
+
+      for (; extra > 0; extra--)
+        {
+          if ((*ptr & 0xc0) != 0x80)
+            {
+              return -EINVAL;
+            }
+
+          ch = (ch << 6) | (*ptr++ & 0x3f);
+        }
+
+      /* And append it as one or two UTF-16 units */
+
+      if (ch >= 0x10000)
+        {
+          if (ch > 0x10ffff || len + 2 > EXFAT_NAME_MAX)
+            {
+              return ch > 0x10ffff ? -EINVAL : -ENAMETOOLONG;
+            }
+
+          ch -= 0x10000;
+          fs->fs_name[len++] = 0xd800 | (ch >> 10);
+          fs->fs_name[len++] = 0xdc00 | (ch & 0x3ff);
+        }
+      else
+        {
+          if (len + 1 > EXFAT_NAME_MAX)
+            {
+              return -ENAMETOOLONG;
+            }
+
+          fs->fs_name[len++] = ch;
+        }
+    }
+
+  fs->fs_namelen = len;
+  *path = (FAR const char *)ptr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_name2utf8
+ *
+ * Description:
+ *   Convert the name of the entry set in fs_set to a UTF-8 string.  Names
+ *   that do not fit are truncated at a character boundary.
+ *
+ ****************************************************************************/
+
+static void exfat_name2utf8(FAR struct exfat_mountpt_s *fs,
+                            FAR char *buffer, size_t buflen)
+{
+  int namelen = fs->fs_set[EXFAT_DIRENT_SIZE + STREAM_NAMELENGTH];
+  uint32_t ch;
+  size_t len = 0;
+  size_t n;
+  int i;
+
+  for (i = 0; i < namelen; i++)
+    {
+      ch = exfat_getuint16(exfat_setname(fs->fs_set, i));
+      if ((ch & 0xfc00) == 0xd800 && i + 1 < namelen)
+        {
+          uint32_t low = exfat_getuint16(exfat_setname(fs->fs_set, i + 1));
+
+          if ((low & 0xfc00) == 0xdc00)
+            {
+              ch = 0x10000 + ((ch & 0x3ff) << 10) + (low & 0x3ff);
+              i++;
+            }
+        }
+
+      n = ch < 0x80 ? 1 : ch < 0x800 ? 2 : ch < 0x10000 ? 3 : 4;
+      if (len + n >= buflen)
+        {
+          break;
+        }
+
+      switch (n)
+        {
+          case 1:
+            buffer[len++] = ch;
+            break;
+
+          case 2:
+            buffer[len++] = 0xc0 | (ch >> 6);
+            buffer[len++] = 0x80 | (ch & 0x3f);
+            break;
+
+          case 3:
+            buffer[len++] = 0xe0 | (ch >> 12);
+            buffer[len++] = 0x80 | ((ch >> 6) & 0x3f);
+            buffer[len++] = 0x80 | (ch & 0x3f);
+            break;
+
+          default:
+            buffer[len++] = 0xf0 | (ch >> 18);
+            buffer[len++] = 0x80 | ((ch >> 12) & 0x3f);
+            buffer[len++] = 0x80 | ((ch >> 6) & 0x3f);
+            buffer[len++] = 0x80 | (ch & 0x3f);
+            break;
+        }
+    }
+
+  buffer[len] = '\0';
+}
+
+/****************************************************************************
+ * Name: exfat_namematch
+ *
+ * Description:
+ *   Compare the name of the entry set in fs_set with fs_name, without
+ *   regard to case.
+ *
+ ****************************************************************************/
+
+static bool exfat_namematch(FAR struct exfat_mountpt_s *fs, uint16_t hash)
+{
+  FAR const uint8_t *stream = fs->fs_set + EXFAT_DIRENT_SIZE;
+  uint16_t ch;
+  int i;
+
+  if (stream[STREAM_NAMELENGTH] != fs->fs_namelen ||
+      exfat_getuint16(stream + STREAM_NAMEHASH) != hash)
+    {
+      return false;
+    }
+
+  for (i = 0; i < fs->fs_namelen; i++)
+    {
+      ch = exfat_getuint16(exfat_setname(fs->fs_set, i));
+      if (exfat_upcase(fs, ch) != exfat_upcase(fs, fs->fs_name[i]))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: exfat_parseset
+ *
+ * Description:
+ *   Copy the fields of the entry set in fs_set to a dirinfo.
+ *
+ ****************************************************************************/
+
+static void exfat_parseset(FAR struct exfat_mountpt_s *fs,
+                           FAR struct exfat_dirinfo_s *dirinfo,
+                           uint32_t offset, int nentries)
+{
+  FAR const uint8_t *file = fs->fs_set;
+  FAR const uint8_t *stream = fs->fs_set + EXFAT_DIRENT_SIZE;
+
+  dirinfo->di_offset    = offset;
+  dirinfo->di_nentries  = nentries;
+  dirinfo->di_attr      = exfat_getuint16(file + FILE_ATTRIBUTES);
+  dirinfo->di_flags     = stream[STREAM_FLAGS];
+  dirinfo->di_first     = exfat_getuint32(stream + STREAM_FIRSTCLUSTER);
+  dirinfo->di_size      = exfat_getuint64(stream + STREAM_DATALENGTH);
+  dirinfo->di_validsize = exfat_getuint64(stream + STREAM_VALIDLENGTH);
+  dirinfo->di_ctime     =
+    exfat_time2systime(exfat_getuint32(file + FILE_CREATETIME),
+                       file[FILE_CREATEUTC]);
+  dirinfo->di_mtime     =
+    exfat_time2systime(exfat_getuint32(file + FILE_MODIFYTIME),
+                       file[FILE_MODIFYUTC]);
+  dirinfo->di_atime     =
+    exfat_time2systime(exfat_getuint32(file + FILE_ACCESSTIME),
+                       file[FILE_ACCESSUTC]);
+}
+
+/****************************************************************************
+ * Name: exfat_findname
+ *
+ * Description:
+ *   Look the name in fs_name up in the directory dirinfo->di_dir.  If it is
+ *   not there, di_free is set to where an entry set of nentries could be
+ *   created, possibly after the directory is extended.
+ *
+ ****************************************************************************/
+
+static int exfat_findname(FAR struct exfat_mountpt_s *fs,
+                          FAR struct exfat_dirinfo_s *dirinfo,
+                          int nentries)
+{
+  FAR struct exfat_chain_s *dir = &dirinfo->di_dir;
+  FAR uint8_t *ent;
+  uint32_t offset = 0;
+  uint32_t freestart = 0;
+  uint16_t hash;
+  int nfree = 0;
+  int ret;
+
+  hash = exfat_namehash(fs);
+  dirinfo->di_free = UINT32_MAX;
+
+  for (; ; )
+    {
+      ret = exfat_chainptr(fs, dir, offset, &ent);
+      if (ret == -ENOENT)
+        {
+          /* The end of the directory: a run of free entries at its end may
+           * be extended together with the directory.
+           */
+
+          if (dirinfo->di_free == UINT32_MAX)
+            {
+              dirinfo->di_free = nfree > 0 ? freestart : offset;
+            }
+
+          return -ENOENT;
+        }
+      else if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (ent[0] == EXFAT_TYPE_EOD)
+        {
+          if (dirinfo->di_free == UINT32_MAX)
+            {
+              dirinfo->di_free = nfree > 0 ? freestart : offset;
+            }
+
+          return -ENOENT;
+        }
+
+      if ((ent[0] & EXFAT_TYPE_INUSE) == 0)
+        {
+          if (nfree++ == 0)
+            {
+              freestart = offset;
+            }
+
+          if (nfree >= nentries && dirinfo->di_free == UINT32_MAX)
+            {
+              dirinfo->di_free = freestart;
+            }
+
+          offset += EXFAT_DIRENT_SIZE;
+          continue;
+        }
+
+      nfree = 0;
+      if (ent[0] == EXFAT_TYPE_FILE)
+        {
+          ret = exfat_readset(fs, dir, offset);
+          if (ret > 0)
+            {
+              if (exfat_namematch(fs, hash))
+                {
+                  exfat_parseset(fs, dirinfo, offset, ret);
+                  return OK;
+                }
+
+              offset += ret * EXFAT_DIRENT_SIZE;
+              continue;
+            }
+          else if (ret != -EINVAL)
+            {
+              return ret;
+            }
+        }
+
+      offset += EXFAT_DIRENT_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: exfat_dirreserve
+ *
+ * Description:
+ *   Make sure that the directory of a dirinfo has room for nentries at
+ *   di_free, extending the directory if needed.
+ *
+ ****************************************************************************/
+
+static int exfat_dirreserve(FAR struct exfat_mountpt_s *fs,
+                            FAR struct exfat_dirinfo_s *dirinfo,
+                            int nentries)
+{
+  FAR struct exfat_chain_s *dir = &dirinfo->di_dir;
+  FAR uint8_t *stream;
+  uint64_t end;
+  int ret;
+
+  end = (uint64_t)dirinfo->di_free + nentries * EXFAT_DIRENT_SIZE;
+  if (end <= (uint64_t)dir->ec_nclusters << EXFAT_CLUSTERSHIFT(fs))
+    {
+      return OK;
+    }
+
+  /* Directories are limited to 256MiB */
+
+  if (end > 256 * 1024 * 1024)
+    {
+      return -ENOSPC;
+    }
+
+  ret = exfat_chainextend(fs, dir, EXFAT_NCLUSTERS(fs, end), true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!dirinfo->di_parent)
+    {
+      fs->fs_root = *dir;
+      return OK;
+    }
+
+  /* Record the new size and clusters in the entry set of the directory */
+
+  ret = exfat_readset(fs, &dirinfo->di_dirpos.dp_dir,
+                      dirinfo->di_dirpos.dp_offset);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  end    = (uint64_t)dir->ec_nclusters << EXFAT_CLUSTERSHIFT(fs);
+  stream = fs->fs_set + EXFAT_DIRENT_SIZE;
+  stream[STREAM_FLAGS] = dir->ec_flags;
+  exfat_putuint32(stream + STREAM_FIRSTCLUSTER, dir->ec_first);
+  exfat_putuint64(stream + STREAM_VALIDLENGTH, end);
+  exfat_putuint64(stream + STREAM_DATALENGTH, end);
+
+  return exfat_writeset(fs, &dirinfo->di_dirpos.dp_dir,
+                        dirinfo->di_dirpos.dp_offset, ret);
+}
+
+/****************************************************************************
+ * Name: exfat_setnewname
+ *
+ * Description:
+ *   Complete the entry set in fs_set, whose file and stream entries are
+ *   set up, with the name in fs_name.  Returns the number of entries.
+ *
+ ****************************************************************************/
+
+static int exfat_setnewname(FAR struct exfat_mountpt_s *fs)
+{
+  FAR uint8_t *stream = fs->fs_set + EXFAT_DIRENT_SIZE;
+  int nentries;
+  int i;
+
+  nentries = 2 + (fs->fs_namelen + EXFAT_NAME_PERENTRY - 1) /
+             EXFAT_NAME_PERENTRY;
+
+  memset(fs->fs_set + 2 * EXFAT_DIRENT_SIZE, 0,
+         (nentries - 2) * EXFAT_DIRENT_SIZE);
+  for (i = 2; i < nentries; i++)
+    {
+      fs->fs_set[i * EXFAT_DIRENT_SIZE] = EXFAT_TYPE_NAME;
+    }
+
+  for (i = 0; i < fs->fs_namelen; i++)
+    {
+      exfat_putuint16(exfat_setname(fs->fs_set, i), fs->fs_name[i]);
+    }
+
+  fs->fs_set[FILE_SECONDARYCOUNT] = nentries - 1;
+  stream[STREAM_NAMELENGTH] = fs->fs_namelen;
+  exfat_putuint16(stream + STREAM_NAMEHASH, exfat_namehash(fs));
+  return nentries;
+}
+
+/****************************************************************************
+ * Name: exfat_checkname
+ *
+ * Description:
+ *   Check that the name in fs_name may be given to a new file.
+ *
+ ****************************************************************************/
+
+static int exfat_checkname(FAR struct exfat_mountpt_s *fs)
+{
+  uint16_t ch;
+  int i;
+
+  if (fs->fs_namelen == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < fs->fs_namelen; i++)
+    {
+      ch = fs->fs_name[i];
+      if (ch < 0x20 || (ch < 0x80 && strchr("\"*/:<>?\\|", ch) != NULL))
+        {
+          return -EINVAL;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_dirclear
+ *
+ * Description:
+ *   Mark the entries of an entry set as no longer in use.
+ *
+ ****************************************************************************/
+
+static int exfat_dirclear(FAR struct exfat_mountpt_s *fs,
+                          FAR struct exfat_chain_s *dir, uint32_t offset,
+                          int nentries)
+{
+  FAR uint8_t *ent;
+  int ret;
+
+  for (; nentries > 0; nentries--, offset += EXFAT_DIRENT_SIZE)
+    {
+      ret = exfat_chainptr(fs, dir, offset, &ent);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ent[0] &= ~EXFAT_TYPE_INUSE;
+      fs->fs_dirty = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: exfat_getuint16, exfat_getuint32, exfat_getuint64
+ ****************************************************************************/
+
+uint16_t exfat_getuint16(FAR const uint8_t *ptr)
+{
+  return (uint16_t)ptr[1] << 8 | ptr[0];
+}
+
+uint32_t exfat_getuint32(FAR const uint8_t *ptr)
+{
+  return (uint32_t)exfat_getuint16(ptr + 2) << 16 | exfat_getuint16(ptr);
+}
+
+uint64_t exfat_getuint64(FAR const uint8_t *ptr)
+{
+  return (uint64_t)exfat_getuint32(ptr + 4) << 32 | exfat_getuint32(ptr);
+}
+
+/****************************************************************************
+ * Name: exfat_putuint16, exfat_putuint32, exfat_putuint64
+ ****************************************************************************/
+
+void exfat_putuint16(FAR uint8_t *ptr, uint16_t value16)
+{
+  ptr[0] = value16 & 0xff;
+  ptr[1] = value16 >> 8;
+}
+
+void exfat_putuint32(FAR uint8_t *ptr, uint32_t value32)
+{
+  exfat_putuint16(ptr, value32 & 0xffff);
+  exfat_putuint16(ptr + 2, value32 >> 16);
+}
+
+void exfat_putuint64(FAR uint8_t *ptr, uint64_t value64)
+{
+  exfat_putuint32(ptr, value64 & 0xffffffff);
+  exfat_putuint32(ptr + 4, value64 >> 32);
+}
+
+/****************************************************************************
+ * Name: exfat_systime2time
+ *
+ * Description:
+ *   Get the current time as an exFAT timestamp.  The time is UTC.
+ *
+ ****************************************************************************/
+
+uint32_t exfat_systime2time(void)
+{
+  struct timespec ts;
+  struct tm tm;
+
+  if (clock_gettime(CLOCK_REALTIME, &ts) < 0 ||
+      gmtime_r(&ts.tv_sec, &tm) == NULL || tm.tm_year < 80)
+    {
+      return EXFAT_TIME_1980;
+    }
+
+  return (uint32_t)(tm.tm_year - 80) << 25 |
+         (uint32_t)(tm.tm_mon + 1) << 21 |
+         (uint32_t)tm.tm_mday << 16 |
+         (uint32_t)tm.tm_hour << 11 |
+         (uint32_t)tm.tm_min << 5 |
+         (uint32_t)(tm.tm_sec >> 1);
+}
+
+/****************************************************************************
+ * Name: exfat_time2systime
+ *
+ * Description:
+ *   Convert an exFAT timestamp and its UTC offset, in units of 15 minutes,
+ *   to seconds since the epoch.
+ *
+ ****************************************************************************/
+
+time_t exfat_time2systime(uint32_t timestamp, uint8_t utcoffset)
+{
+  struct tm tm;
+  time_t time;
+
+  memset(&tm, 0, sizeof(tm));
+  tm.tm_year = (timestamp >> 25) + 80;
+  tm.tm_mon  = ((timestamp >> 21) & 0x0f) - 1;
+  tm.tm_mday = (timestamp >> 16) & 0x1f;
+  tm.tm_hour = (timestamp >> 11) & 0x1f;
+  tm.tm_min  = (timestamp >> 5) & 0x3f;
+  tm.tm_sec  = (timestamp & 0x1f) << 1;
+
+  time = timegm(&tm);
+  if ((utcoffset & EXFAT_UTC_VALID) != 0)
+    {
+      /* Sign extend the 7 bit offset */
+
+      time -= (time_t)((int8_t)(utcoffset << 1) >> 1) * 15 * 60;
+    }
+
+  return time;
+}
+
+/****************************************************************************
+ * Name: exfat_hwread
+ ****************************************************************************/
+
+int exfat_hwread(FAR struct exfat_mountpt_s *fs, FAR uint8_t *buffer,
+                 off_t sector, unsigned int nsectors)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  ssize_t nread;
+
+  if (inode == NULL || inode->u.i_bops == NULL ||
+      inode->u.i_bops->read == NULL)
+    {
+      return -ENODEV;
+    }
+
+  nxsched_iowait_enter();
+  nread = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+  nxsched_iowait_leave();
+  if (nread < 0)
+    {
+      return (int)nread;
+    }
+
+  return nread == nsectors ? OK : -EIO;
+}
+
+/****************************************************************************
+ * Name: exfat_hwwrite
+ *
+ * Description:
+ *   Write sectors to the block driver.  The volume is marked dirty before
+ *   it is first modified.
+ *
+ ****************************************************************************/
+
+int exfat_hwwrite(FAR struct exfat_mountpt_s *fs, FAR const uint8_t *buffer,
+                  off_t sector, unsigned int nsectors)
+{
+  int ret;
+
+  if (!fs->fs_voldirty)
+    {
+      ret = exfat_setvoldirty(fs, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return exfat_rawwrite(fs, buffer, sector, nsectors);
+}
+
+/****************************************************************************
+ * Name: exfat_setvoldirty
+ *
+ * Description:
+ *   Set or clear the dirty flag in the boot sector of the volume.
+ *
+ ****************************************************************************/
+
+int exfat_setvoldirty(FAR struct exfat_mountpt_s *fs, bool dirty)
+{
+  FAR uint8_t *buffer;
+  uint16_t flags;
+  int ret;
+
+  buffer = fs_heap_malloc(fs->fs_sectorsize);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = exfat_hwread(fs, buffer, fs->fs_volstart, 1);
+  if (ret >= 0)
+    {
+      flags = exfat_getuint16(buffer + BS_VOLUMEFLAGS);
+      flags = dirty ? flags | BS_VOLFLAG_DIRTY : flags & ~BS_VOLFLAG_DIRTY;
+      exfat_putuint16(buffer + BS_VOLUMEFLAGS, flags);
+
+      ret = exfat_rawwrite(fs, buffer, fs->fs_volstart, 1);
+      if (ret >= 0)
+        {
+          fs->fs_voldirty = dirty;
+        }
+    }
+
+  fs_heap_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_fscacheflush
+ *
+ * Description:
+ *   Write fs_buffer back to the media if it was modified.
+ *
+ ****************************************************************************/
+
+int exfat_fscacheflush(FAR struct exfat_mountpt_s *fs)
+{
+  int ret;
+
+  if (fs->fs_dirty)
+    {
+      ret = exfat_hwwrite(fs, fs->fs_buffer, fs->fs_cachesector, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      fs->fs_dirty = false;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_fscacheread
+ *
+ * Description:
+ *   Read a metadata sector into fs_buffer, writing back the sector that
+ *   it held before if that was modified.
+ *
+ ****************************************************************************/
+
+int exfat_fscacheread(FAR struct exfat_mountpt_s *fs, off_t sector)
+{
+  int ret;
+
+  if (fs->fs_cachesector == sector)
+    {
+      return OK;
+    }
+
+  ret = exfat_fscacheflush(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = exfat_hwread(fs, fs->fs_buffer, sector, 1);
+  if (ret < 0)
+    {
+      fs->fs_cachesector = -1;
+      return ret;
+    }
+
+  fs->fs_cachesector = sector;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_checkmount
+ *
+ * Description:
+ *   Check if the mountpoint is still valid.
+ *
+ *   The caller should hold the mountpoint semaphore
+ *
+ ****************************************************************************/
+
+int exfat_checkmount(FAR struct exfat_mountpt_s *fs)
+{
+  FAR struct inode *inode;
+  struct geometry geo;
+
+  if (fs->fs_mounted)
+    {
+      inode = fs->fs_blkdriver;
+      if (inode != NULL && inode->u.i_bops != NULL &&
+          inode->u.i_bops->geometry != NULL &&
+          inode->u.i_bops->geometry(inode, &geo) == OK &&
+          geo.geo_available && !geo.geo_mediachanged)
+        {
+          return OK;
+        }
+
+      fs->fs_mounted = false;
+    }
+
+  return -ENODEV;
+}
+
+/****************************************************************************
+ * Name: exfat_mount
+ *
+ * Description:
+ *   This function is called only when the mountpoint is first established.
+ *   It initializes the mountpoint structure and verifies that a valid
+ *   exFAT file system is provided by the block driver.
+ *
+ *   The caller should hold the mountpoint semaphore
+ *
+ ****************************************************************************/
+
+int exfat_mount(FAR struct exfat_mountpt_s *fs, bool writeable)
+{
+  FAR struct inode *inode = fs->fs_blkdriver;
+  FAR uint8_t *bs;
+  struct geometry geo;
+  uint32_t cluster;
+  uint32_t next;
+  uint32_t n;
+  int ret;
+  int i;
+
+  if (inode == NULL || inode->u.i_bops == NULL ||
+      inode->u.i_bops->geometry == NULL ||
+      inode->u.i_bops->geometry(inode, &geo) != OK || !geo.geo_available)
+    {
+      return -ENODEV;
+    }
+
+  if (writeable && !geo.geo_writeenabled)
+    {
+      return -EACCES;
+    }
+
+  if (geo.geo_sectorsize < 512 || geo.geo_sectorsize > 4096 ||
+      (geo.geo_sectorsize & (geo.geo_sectorsize - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  fs->fs_sectorsize  = geo.geo_sectorsize;
+  fs->fs_hwnsectors  = geo.geo_nsectors;
+  fs->fs_cachesector = -1;
+
+  fs->fs_buffer = fs_heap_malloc(fs->fs_sectorsize);
+  if (fs->fs_buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The boot sector is either the first sector of the media or the first
+   * sector of one of the partitions of an MBR.
+   */
+
+  bs  = fs->fs_buffer;
+  ret = exfat_hwread(fs, bs, 0, 1);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (!exfat_checkboot(fs))
+    {
+      uint32_t starts[4];
+
+      ret = -EINVAL;
+      if (exfat_getuint16(bs + BS_SIGNATURE) != BS_SIGNATURE_VALUE)
+        {
+          goto errout;
+        }
+
+      for (i = 0; i < 4; i++)
+        {
+          starts[i] = exfat_getuint32(bs + MBR_TABLE + i * MBR_ENTRYSIZE +
+                                      MBR_STARTLBA);
+        }
+
+      for (i = 0; i < 4; i++)
+        {
+          if (starts[i] == 0 || starts[i] >= fs->fs_hwnsectors)
+            {
+              continue;
+            }
+
+          ret = exfat_hwread(fs, bs, starts[i], 1);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          if (exfat_checkboot(fs))
+            {
+              fs->fs_volstart = starts[i];
+              break;
+            }
+        }
+
+      if (i >= 4)
+        {
+          ferr("ERROR: No exFAT file system found\n");
+          ret = -EINVAL;
+          goto errout;
+        }
+    }
+
+  fs->fs_sectorshift  = bs[BS_SECTORSHIFT];
+  fs->fs_clustershift = bs[BS_CLUSTERSHIFT];
+  fs->fs_volflags     = exfat_getuint16(bs + BS_VOLUMEFLAGS);
+  fs->fs_nclusters    = exfat_getuint32(bs + BS_CLUSTERCOUNT);
+  fs->fs_heapstart    = fs->fs_volstart +
+                        exfat_getuint32(bs + BS_HEAPOFFSET);
+  fs->fs_fatstart     = fs->fs_volstart +
+                        exfat_getuint32(bs + BS_FATOFFSET);
+
+  if (bs[BS_NUMBEROFFATS] == 2 &&
+      (fs->fs_volflags & BS_VOLFLAG_ACTIVEFAT) != 0)
+    {
+      fs->fs_fatstart += exfat_getuint32(bs + BS_FATLENGTH);
+    }
+  else
+    {
+      fs->fs_volflags &= ~BS_VOLFLAG_ACTIVEFAT;
+    }
+
+  /* A volume that was left dirty stays so, as it was not checked */
+
+  fs->fs_voldirty      = (fs->fs_volflags & BS_VOLFLAG_DIRTY) != 0;
+  fs->fs_nfreeclusters = UINT32_MAX;
+  fs->fs_nextfree      = EXFAT_FIRST_CLUSTER;
+
+  /* The root directory always has a FAT chain; count its clusters */
+
+  cluster = exfat_getuint32(bs + BS_ROOTCLUSTER);
+  memset(&fs->fs_root, 0, sizeof(fs->fs_root));
+  fs->fs_root.ec_first = cluster;
+
+  for (n = 1; ; n++)
+    {
+      ret = exfat_getfat(fs, cluster, &next);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      if (next == EXFAT_EOC)
+        {
+          break;
+        }
+
+      if (!exfat_validcluster(fs, next) || n >= fs->fs_nclusters)
+        {
+          ferr("ERROR: Bad root directory chain\n");
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      cluster = next;
+    }
+
+  fs->fs_root.ec_nclusters = n;
+  fs->fs_root.ec_last      = cluster;
+
+  ret = exfat_findtables(fs);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  fs->fs_mounted = true;
+  return OK;
+
+errout:
+  exfat_unmount(fs);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: exfat_unmount
+ *
+ * Description:
+ *   Release the resources of the mountpoint structure.
+ *
+ ****************************************************************************/
+
+void exfat_unmount(FAR struct exfat_mountpt_s *fs)
+{
+  fs->fs_mounted = false;
+
+  if (fs->fs_upcase != NULL)
+    {
+      fs_heap_free(fs->fs_upcase);
+      fs->fs_upcase = NULL;
+    }
+
+  if (fs->fs_buffer != NULL)
+    {
+      fs_heap_free(fs->fs_buffer);
+      fs->fs_buffer = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: exfat_cluster2sector
+ ****************************************************************************/
+
+off_t exfat_cluster2sector(FAR struct exfat_mountpt_s *fs, uint32_t cluster)
+{
+  return fs->fs_heapstart +
+         ((off_t)(cluster - EXFAT_FIRST_CLUSTER) << fs->fs_clustershift);
+}
+
+/****************************************************************************
+ * Name: exfat_chaincluster
+ *
+ * Description:
+ *   Get the cluster at an index of a chain.  That is immediate for the
+ *   contiguous chains that need no FAT; FAT chains are walked from the
+ *   cluster looked up last, if not from their start.
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if the index is beyond the chain, or another
+ *   negated errno value on failures.
+ *
+ ****************************************************************************/
+
+int exfat_chaincluster(FAR struct exfat_mountpt_s *fs,
+                       FAR struct exfat_chain_s *chain, uint32_t index,
+                       FAR uint32_t *cluster)
+{
+  uint32_t current;
+  uint32_t next;
+  uint32_t i;
+  int ret;
+
+  if (index >= chain->ec_nclusters)
+    {
+      return -ENOENT;
+    }
+
+  if ((chain->ec_flags & EXFAT_FLAG_NOFATCHAIN) != 0)
+    {
+      *cluster = chain->ec_first + index;
+      return OK;
+    }
+
+  if (index == chain->ec_nclusters - 1 && chain->ec_last != 0)
+    {
+      *cluster = chain->ec_last;
+      return OK;
+    }
+
+  if (chain->ec_cluster != 0 && chain->ec_index <= index)
+    {
+      current = chain->ec_cluster;
+      i       = chain->ec_index;
+    }
+  else
+    {
+      current = chain->ec_first;
+      i       = 0;
+    }
+
+  for (; i < index; i++)
+    {
+      ret = exfat_getfat(fs, current, &next);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (!exfat_validcluster(fs, next))
+        {
+          ferr("ERROR: Chain of %" PRIu32 " ends early\n", chain->ec_first);
+          return -EIO;
+        }
+
+      current = next;
+    }
+
+  chain->ec_index   = index;
+  chain->ec_cluster = current;
+  if (index == chain->ec_nclusters - 1)
+    {
+      chain->ec_last = current;
+    }
+
+  *cluster = current;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_chaincontig
+ *
+ * Description:
+ *   Count the clusters of a chain from an index, whose cluster is given,
+ *   that are adjacent on the media, up to maxclusters.
+ *
+ ****************************************************************************/
+
+uint32_t exfat_chaincontig(FAR struct exfat_mountpt_s *fs,
+                           FAR struct exfat_chain_s *chain, uint32_t index,
+                           uint32_t cluster, uint32_t maxclusters)
+{
+  uint32_t next;
+  uint32_t n;
+
+  if (maxclusters > chain->ec_nclusters - index)
+    {
+      maxclusters = chain->ec_nclusters - index;
+    }
+
+  if ((chain->ec_flags & EXFAT_FLAG_NOFATCHAIN) != 0)
+    {
+      return maxclusters;
+    }
+
+  for (n = 1; n < maxclusters; n++, cluster = next)
+    {
+      if (exfat_getfat(fs, cluster, &next) < 0 || next != cluster + 1)
+        {
+          break;
+        }
+
+      chain->ec_index   = index + n;
+      chain->ec_cluster = next;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: exfat_chainextend
+ *
+ * Description:
+ *   Extend a chain to a number of clusters.  A chain stays contiguous
+ *   without a FAT chain as long as the cluster that follows it is free;
+ *   otherwise, its FAT chain is written and it goes on wherever free
+ *   clusters are found.
+ *
+ ****************************************************************************/
+
+int exfat_chainextend(FAR struct exfat_mountpt_s *fs,
+                      FAR struct exfat_chain_s *chain, uint32_t nclusters,
+                      bool zero)
+{
+  uint32_t last = 0;
+  uint32_t cluster;
+  uint32_t c;
+  int ret;
+
+  while (chain->ec_nclusters < nclusters)
+    {
+      if (chain->ec_nclusters > 0)
+        {
+          ret = exfat_chaincluster(fs, chain, chain->ec_nclusters - 1,
+                                   &last);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      /* Prefer the cluster right after the chain */
+
+      ret = last != 0 ? exfat_isfree(fs, last + 1) : 0;
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret > 0)
+        {
+          cluster = last + 1;
+        }
+      else
+        {
+          ret = exfat_findfree(fs, fs->fs_nextfree, &cluster);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          if (last != 0 && (chain->ec_flags & EXFAT_FLAG_NOFATCHAIN) != 0)
+            {
+              /* The chain can no longer go without the FAT */
+
+              for (c = chain->ec_first; c < last; c++)
+                {
+                  ret = exfat_putfat(fs, c, c + 1);
+                  if (ret < 0)
+                    {
+                      return ret;
+                    }
+                }
+
+              ret = exfat_putfat(fs, last, EXFAT_EOC);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              chain->ec_flags &= ~EXFAT_FLAG_NOFATCHAIN;
+            }
+        }
+
+      ret = exfat_setbits(fs, cluster, 1, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (last == 0)
+        {
+          chain->ec_first = cluster;
+          chain->ec_flags = EXFAT_FLAG_ALLOCPOSSIBLE |
+                            EXFAT_FLAG_NOFATCHAIN;
+        }
+      else if ((chain->ec_flags & EXFAT_FLAG_NOFATCHAIN) == 0)
+        {
+          ret = exfat_putfat(fs, cluster, EXFAT_EOC);
+          if (ret >= 0)
+            {
+              ret = exfat_putfat(fs, last, cluster);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (zero)
+        {
+          ret = exfat_zerocluster(fs, cluster);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      chain->ec_nclusters++;
+      chain->ec_last  = cluster;
+      fs->fs_nextfree = cluster + 1;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_chaintruncate
+ *
+ * Description:
+ *   Free the clusters of a chain beyond a number of clusters.
+ *
+ ****************************************************************************/
+
+int exfat_chaintruncate(FAR struct exfat_mountpt_s *fs,
+                        FAR struct exfat_chain_s *chain, uint32_t nclusters)
+{
+  uint32_t cluster;
+  uint32_t next;
+  uint32_t n;
+  int ret;
+
+  if (nclusters >= chain->ec_nclusters)
+    {
+      return OK;
+    }
+
+  /* fs_buffer might hold a modified sector of the clusters */
+
+  ret = exfat_fscacheflush(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((chain->ec_flags & EXFAT_FLAG_NOFATCHAIN) != 0)
+    {
+      ret = exfat_setbits(fs, chain->ec_first + nclusters,
+                          chain->ec_nclusters - nclusters, false);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+  else
+    {
+      if (nclusters == 0)
+        {
+          cluster = chain->ec_first;
+        }
+      else
+        {
+          ret = exfat_chaincluster(fs, chain, nclusters - 1, &next);
+          if (ret >= 0)
+            {
+              chain->ec_last = next;
+              ret = exfat_getfat(fs, next, &cluster);
+            }
+
+          if (ret >= 0)
+            {
+              ret = exfat_putfat(fs, next, EXFAT_EOC);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      for (n = nclusters; n < chain->ec_nclusters; n++, cluster = next)
+        {
+          if (!exfat_validcluster(fs, cluster))
+            {
+              return -EIO;
+            }
+
+          ret = exfat_getfat(fs, cluster, &next);
+          if (ret >= 0)
+            {
+              ret = exfat_setbits(fs, cluster, 1, false);
+            }
+
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  if (nclusters == 0)
+    {
+      chain->ec_first = 0;
+      chain->ec_flags = EXFAT_FLAG_ALLOCPOSSIBLE;
+      chain->ec_last  = 0;
+    }
+  else if ((chain->ec_flags & EXFAT_FLAG_NOFATCHAIN) != 0)
+    {
+      chain->ec_last  = chain->ec_first + nclusters - 1;
+    }
+
+  if (chain->ec_index >= nclusters)
+    {
+      chain->ec_cluster = 0;
+    }
+
+  chain->ec_nclusters = nclusters;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_nfreeclusters
+ *
+ * Description:
+ *   Get the number of free clusters, counting them in the allocation
+ *   bitmap the first time that it is needed.
+ *
+ ****************************************************************************/
+
+int exfat_nfreeclusters(FAR struct exfat_mountpt_s *fs,
+                        FAR fsblkcnt_t *pfreeclusters)
+{
+  FAR uint8_t *ptr;
+  uint32_t nused = 0;
+  uint32_t i;
+  int ret;
+
+  if (fs->fs_nfreeclusters == UINT32_MAX)
+    {
+      for (i = 0; i < fs->fs_nclusters; i += 8)
+        {
+          ret = exfat_bitmapptr(fs, i + EXFAT_FIRST_CLUSTER, &ptr);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          if (fs->fs_nclusters - i < 8)
+            {
+              nused += popcount(*ptr & ((1 << (fs->fs_nclusters - i)) - 1));
+            }
+          else
+            {
+              nused += popcount(*ptr);
+            }
+        }
+
+      fs->fs_nfreeclusters = fs->fs_nclusters - nused;
+    }
+
+  *pfreeclusters = fs->fs_nfreeclusters;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_chainptr
+ *
+ * Description:
+ *   Read the sector that holds a byte offset of a chain into fs_buffer and
+ *   return a pointer to that byte.
+ *
+ ****************************************************************************/
+
+int exfat_chainptr(FAR struct exfat_mountpt_s *fs,
+                   FAR struct exfat_chain_s *chain, uint32_t offset,
+                   FAR uint8_t **ptr)
+{
+  uint32_t cluster;
+  off_t sector;
+  int ret;
+
+  ret = exfat_chaincluster(fs, chain, offset >> EXFAT_CLUSTERSHIFT(fs),
+                           &cluster);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sector = exfat_cluster2sector(fs, cluster) +
+           ((offset >> fs->fs_sectorshift) &
+            ((1 << fs->fs_clustershift) - 1));
+
+  ret = exfat_fscacheread(fs, sector);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  *ptr = fs->fs_buffer + (offset & EXFAT_SECTORMASK(fs));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_readset
+ *
+ * Description:
+ *   Read the entry set at an offset of a directory into fs_set.
+ *
+ * Returned Value:
+ *   The number of entries of the set, -EINVAL if there is no valid entry
+ *   set at the offset, or another negated errno value on failures.
+ *
+ ****************************************************************************/
+
+int exfat_readset(FAR struct exfat_mountpt_s *fs,
+                  FAR struct exfat_chain_s *dir, uint32_t offset)
+{
+  FAR uint8_t *set = fs->fs_set;
+  FAR uint8_t *ent;
+  int nentries;
+  int i;
+  int ret;
+
+  for (i = 0, nentries = 1; i < nentries; i++)
+    {
+      ret = exfat_chainptr(fs, dir, offset + i * EXFAT_DIRENT_SIZE, &ent);
+      if (ret < 0)
+        {
+          return ret == -ENOENT ? -EINVAL : ret;
+        }
+
+      memcpy(set + i * EXFAT_DIRENT_SIZE, ent, EXFAT_DIRENT_SIZE);
+
+      if (i == 0)
+        {
+          nentries = ent[FILE_SECONDARYCOUNT] + 1;
+          if (ent[0] != EXFAT_TYPE_FILE || nentries < 3 ||
+              nentries > EXFAT_MAXSET)
+            {
+              return -EINVAL;
+            }
+        }
+      else if (ent[0] != (i == 1 ? EXFAT_TYPE_STREAM : EXFAT_TYPE_NAME))
+        {
+          return -EINVAL;
+        }
+    }
+
+  if (set[EXFAT_DIRENT_SIZE + STREAM_NAMELENGTH] == 0 ||
+      set[EXFAT_DIRENT_SIZE + STREAM_NAMELENGTH] >
+      (nentries - 2) * EXFAT_NAME_PERENTRY ||
+      exfat_getuint16(set + FILE_SETCHECKSUM) !=
+      exfat_setchecksum(set, nentries))
+    {
+      return -EINVAL;
+    }
+
+  return nentries;
+}
+
+/****************************************************************************
+ * Name: exfat_writeset
+ *
+ * Description:
+ *   Write the entry set in fs_set to an offset of a directory, with a new
+ *   checksum.
+ *
+ ****************************************************************************/
+
+int exfat_writeset(FAR struct exfat_mountpt_s *fs,
+                   FAR struct exfat_chain_s *dir, uint32_t offset,
+                   int nentries)
+{
+  FAR uint8_t *ent;
+  int i;
+  int ret;
+
+  exfat_putuint16(fs->fs_set + FILE_SETCHECKSUM,
+                  exfat_setchecksum(fs->fs_set, nentries));
+
+  for (i = 0; i < nentries; i++)
+    {
+      ret = exfat_chainptr(fs, dir, offset + i * EXFAT_DIRENT_SIZE, &ent);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      memcpy(ent, fs->fs_set + i * EXFAT_DIRENT_SIZE, EXFAT_DIRENT_SIZE);
+      fs->fs_dirty = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_finddirentry
+ *
+ * Description:
+ *   Find the entry set of a path.  If the last name of the path is not
+ *   found, -ENOENT is returned with di_last set, and with fs_name, di_dir
+ *   and di_free set up for exfat_dircreate().
+ *
+ ****************************************************************************/
+
+int exfat_finddirentry(FAR struct exfat_mountpt_s *fs,
+                       FAR struct exfat_dirinfo_s *dirinfo,
+                       FAR const char *relpath)
+{
+  int ret;
+
+  memset(dirinfo, 0, sizeof(*dirinfo));
+  dirinfo->di_dir = fs->fs_root;
+
+  while (*relpath == '/')
+    {
+      relpath++;
+    }
+
+  if (*relpath == '\0')
+    {
+      dirinfo->di_root = true;
+      return OK;
+    }
+
+  for (; ; )
+    {
+      ret = exfat_parsename(fs, &relpath);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      while (*relpath == '/')
+        {
+          relpath++;
+        }
+
+      dirinfo->di_last = *relpath == '\0';
+
+      ret = exfat_findname(fs, dirinfo,
+                           2 + (fs->fs_namelen + EXFAT_NAME_PERENTRY - 1) /
+                           EXFAT_NAME_PERENTRY);
+      if (ret < 0 || dirinfo->di_last)
+        {
+          return ret;
+        }
+
+      if ((dirinfo->di_attr & EXFAT_ATTR_DIRECTORY) == 0)
+        {
+          return -ENOTDIR;
+        }
+
+      /* Go down into the directory found */
+
+      dirinfo->di_dirpos.dp_dir    = dirinfo->di_dir;
+      dirinfo->di_dirpos.dp_offset = dirinfo->di_offset;
+      dirinfo->di_parent           = true;
+
+      memset(&dirinfo->di_dir, 0, sizeof(dirinfo->di_dir));
+      dirinfo->di_dir.ec_first     = dirinfo->di_first;
+      dirinfo->di_dir.ec_flags     = dirinfo->di_flags;
+      dirinfo->di_dir.ec_nclusters = EXFAT_NCLUSTERS(fs, dirinfo->di_size);
+    }
+}
+
+/****************************************************************************
+ * Name: exfat_nextdirentry
+ *
+ * Description:
+ *   Read the next file or directory of an open directory.
+ *
+ ****************************************************************************/
+
+int exfat_nextdirentry(FAR struct exfat_mountpt_s *fs,
+                       FAR struct exfat_dirent_s *edir,
+                       FAR struct dirent *entry)
+{
+  FAR uint8_t *ent;
+  uint16_t attr;
+  int ret;
+
+  for (; ; )
+    {
+      ret = exfat_chainptr(fs, &edir->ed_dir, edir->ed_offset, &ent);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (ent[0] == EXFAT_TYPE_EOD)
+        {
+          return -ENOENT;
+        }
+
+      if (ent[0] == EXFAT_TYPE_FILE)
+        {
+          ret = exfat_readset(fs, &edir->ed_dir, edir->ed_offset);
+          if (ret > 0)
+            {
+              edir->ed_offset += ret * EXFAT_DIRENT_SIZE;
+
+              attr = exfat_getuint16(fs->fs_set + FILE_ATTRIBUTES);
+              entry->d_type = (attr & EXFAT_ATTR_DIRECTORY) != 0 ?
+                              DTYPE_DIRECTORY : DTYPE_FILE;
+              exfat_name2utf8(fs, entry->d_name, sizeof(entry->d_name));
+              return OK;
+            }
+          else if (ret != -EINVAL)
+            {
+              return ret;
+            }
+        }
+
+      edir->ed_offset += EXFAT_DIRENT_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: exfat_dircreate
+ *
+ * Description:
+ *   Create the entry set of a new file or directory after a failed
+ *   exfat_finddirentry().  A directory gets one cluster.  The dirinfo is
+ *   then updated to describe the new entry set.
+ *
+ ****************************************************************************/
+
+int exfat_dircreate(FAR struct exfat_mountpt_s *fs,
+                    FAR struct exfat_dirinfo_s *dirinfo, uint16_t attr)
+{
+  struct exfat_chain_s chain;
+  FAR uint8_t *file = fs->fs_set;
+  FAR uint8_t *stream = fs->fs_set + EXFAT_DIRENT_SIZE;
+  uint64_t size = 0;
+  uint32_t now;
+  int nentries;
+  int ret;
+
+  ret = exfat_checkname(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* exfat_dirreserve() and exfat_chainextend() may use fs_name and fs_set,
+   * so the name is copied to the new entry set last.
+   */
+
+  nentries = 2 + (fs->fs_namelen + EXFAT_NAME_PERENTRY - 1) /
+             EXFAT_NAME_PERENTRY;
+  ret = exfat_dirreserve(fs, dirinfo, nentries);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(&chain, 0, sizeof(chain));
+  chain.ec_flags = EXFAT_FLAG_ALLOCPOSSIBLE;
+
+  if ((attr & EXFAT_ATTR_DIRECTORY) != 0)
+    {
+      ret = exfat_chainextend(fs, &chain, 1, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      size = EXFAT_CLUSTERSIZE(fs);
+    }
+
+  now = exfat_systime2time();
+  memset(fs->fs_set, 0, 2 * EXFAT_DIRENT_SIZE);
+
+  file[0] = EXFAT_TYPE_FILE;
+  exfat_putuint16(file + FILE_ATTRIBUTES, attr);
+  exfat_putuint32(file + FILE_CREATETIME, now);
+  exfat_putuint32(file + FILE_MODIFYTIME, now);
+  exfat_putuint32(file + FILE_ACCESSTIME, now);
+  file[FILE_CREATEUTC] = EXFAT_UTC_VALID;
+  file[FILE_MODIFYUTC] = EXFAT_UTC_VALID;
+  file[FILE_ACCESSUTC] = EXFAT_UTC_VALID;
+
+  stream[0] = EXFAT_TYPE_STREAM;
+  stream[STREAM_FLAGS] = chain.ec_flags;
+  exfat_putuint64(stream + STREAM_VALIDLENGTH, size);
+  exfat_putuint32(stream + STREAM_FIRSTCLUSTER, chain.ec_first);
+  exfat_putuint64(stream + STREAM_DATALENGTH, size);
+
+  nentries = exfat_setnewname(fs);
+  ret = exfat_writeset(fs, &dirinfo->di_dir, dirinfo->di_free, nentries);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  exfat_parseset(fs, dirinfo, dirinfo->di_free, nentries);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: exfat_dirrename
+ *
+ * Description:
+ *   Move the entry set of olddir to where the failed lookup of newdir
+ *   would create it, with the name in fs_name.  newdir is then updated to
+ *   describe the moved entry set.
+ *
+ ****************************************************************************/
+
+int exfat_dirrename(FAR struct exfat_mountpt_s *fs,
+                    FAR struct exfat_dirinfo_s *olddir,
+                    FAR struct exfat_dirinfo_s *newdir)
+{
+  int nentries;
+  int ret;
+
+  ret = exfat_checkname(fs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nentries = 2 + (fs->fs_namelen + EXFAT_NAME_PERENTRY - 1) /
+             EXFAT_NAME_PERENTRY;
+  ret = exfat_dirreserve(fs, newdir, nentries);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The file and stream entries move unchanged but for the name */
+
+  ret = exfat_readset(fs, &olddir->di_dir, olddir->di_offset);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nentries = exfat_setnewname(fs);
+  ret = exfat_writeset(fs, &newdir->di_dir, newdir->di_free, nentries);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  exfat_parseset(fs, newdir, newdir->di_free, nentries);
+  return exfat_dirclear(fs, &olddir->di_dir, olddir->di_offset,
+                        olddir->di_nentries);
+}
+
+/****************************************************************************
+ * Name: exfat_dirremove
+ *
+ * Description:
+ *   Remove the entry set of a dirinfo and free its clusters.
+ *
+ ****************************************************************************/
+
+int exfat_dirremove(FAR struct exfat_mountpt_s *fs,
+                    FAR struct exfat_dirinfo_s *dirinfo)
+{
+  struct exfat_chain_s chain;
+  int ret;
+
+  ret = exfat_dirclear(fs, &dirinfo->di_dir, dirinfo->di_offset,
+                       dirinfo->di_nentries);
+  if (ret < 0 || dirinfo->di_first == 0)
+    {
+      return ret;
+    }
+
+  memset(&chain, 0, sizeof(chain));
+  chain.ec_first     = dirinfo->di_first;
+  chain.ec_flags     = dirinfo->di_flags;
+  chain.ec_nclusters = EXFAT_NCLUSTERS(fs, dirinfo->di_size);
+
+  return exfat_chaintruncate(fs, &chain, 0);
+}
+
+/****************************************************************************
+ * Name: exfat_dirempty
+ *
+ * Description:
+ *   Return OK if the directory of a dirinfo holds no files, -ENOTEMPTY if
+ *   it does.
+ *
+ ****************************************************************************/
+
+int exfat_dirempty(FAR struct exfat_mountpt_s *fs,
+                   FAR struct exfat_dirinfo_s *dirinfo)
+{
+  struct exfat_chain_s chain;
+  FAR uint8_t *ent;
+  uint32_t offset;
+  int ret;
+
+  memset(&chain, 0, sizeof(chain));
+  chain.ec_first     = dirinfo->di_first;
+  chain.ec_flags     = dirinfo->di_flags;
+  chain.ec_nclusters = EXFAT_NCLUSTERS(fs, dirinfo->di_size);
+
+  for (offset = 0; ; offset += EXFAT_DIRENT_SIZE)
+    {
+      ret = exfat_chainptr(fs, &chain, offset, &ent);
+      if (ret == -ENOENT || (ret >= 0 && ent[0] == EXFAT_TYPE_EOD))
+        {
+          return OK;
+        }
+      else if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (ent[0] == EXFAT_TYPE_FILE)
+        {
+          return -ENOTEMPTY;
+        }
+    }
+}
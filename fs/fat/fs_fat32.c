@@ -744,6 +744,84 @@ out:
   return 0;
 }
 
+/****************************************************************************
+ * Name: fat_contig_sectors
+ *
+ * Description:
+ *   Get how many of the next 'nsectors' sectors, starting at
+ *   ->ff_currentsector, are contiguous on the media.  The run continues
+ *   past the current cluster for as long as the following clusters of the
+ *   chain are adjacent to it.  When writing, the clusters that the chain
+ *   does not have yet are allocated on the way.
+ *
+ * Returned Value:
+ *   The number of contiguous sectors, at most 'nsectors';  A negated errno
+ *   value is returned on any failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int fat_contig_sectors(FAR struct fat_mountpt_s *fs,
+                              FAR struct fat_file_s *ff,
+                              unsigned int nsectors, bool read)
+{
+  unsigned int avail = ff->ff_sectorsincluster;
+  off_t cluster = ff->ff_currentcluster;
+  off_t next;
+
+  while (avail < nsectors)
+    {
+      next = read ? fat_getcluster(fs, cluster) :
+                    fat_extendchain(fs, cluster);
+      if (next < 0)
+        {
+          return next;
+        }
+      else if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = next;
+      avail  += fs->fs_fatsecperclus;
+    }
+
+  return avail < nsectors ? avail : nsectors;
+}
+
+/****************************************************************************
+ * Name: fat_skip_sectors
+ *
+ * Description:
+ *   Advance the file past 'nsectors' contiguous sectors, as counted by
+ *   fat_contig_sectors(), leaving ->ff_currentcluster on the cluster that
+ *   holds the last of them.
+ *
+ ****************************************************************************/
+
+static void fat_skip_sectors(FAR struct fat_mountpt_s *fs,
+                             FAR struct fat_file_s *ff,
+                             unsigned int nsectors)
+{
+  unsigned int remaining = ff->ff_sectorsincluster;
+  unsigned int nclusters;
+
+  if (nsectors > remaining)
+    {
+      nclusters = (nsectors - remaining + fs->fs_fatsecperclus - 1) /
+                  fs->fs_fatsecperclus;
+
+      ff->ff_currentcluster += nclusters;
+      ff->ff_pos            += (off_t)nclusters * fs->fs_fatsecperclus *
+                               fs->fs_hwsectorsize;
+      remaining             += nclusters * fs->fs_fatsecperclus;
+    }
+
+  ff->ff_sectorsincluster = remaining - nsectors;
+  ff->ff_currentsector   += nsectors;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_read
  ****************************************************************************/
@@ -869,12 +947,18 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and the adjacent clusters that follow it
            */
 
           if (nsectors > ff->ff_sectorsincluster)
             {
-              nsectors = ff->ff_sectorsincluster;
+              ret = fat_contig_sectors(fs, ff, nsectors, true);
+              if (ret < 0)
+                {
+                  goto errout_with_lock;
+                }
+
+              nsectors = ret;
             }
 
           /* We are not sure of the state of the file buffer so
@@ -909,9 +993,8 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_skip_sectors(fs, ff, nsectors);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -1067,12 +1150,19 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and the adjacent clusters that follow it,
+           * allocating those that the file does not have yet
            */
 
           if (nsectors > ff->ff_sectorsincluster)
             {
-              nsectors = ff->ff_sectorsincluster;
+              ret = fat_contig_sectors(fs, ff, nsectors, false);
+              if (ret < 0)
+                {
+                  goto errout_with_lock;
+                }
+
+              nsectors = ret;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -1108,10 +1198,9 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_skip_sectors(fs, ff, nsectors);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -2771,6 +2860,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fs_heap_free(fs->fs_freemap);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
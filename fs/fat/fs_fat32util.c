@@ -38,12 +38,35 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+/* The free cluster summary covers the FAT16 and FAT32 entries only: the
+ * FAT sector holding the entry of a cluster, and the last cluster with its
+ * entry in a FAT sector.
+ */
+
+#  define FREEMAP_SHIFT(f)     ((f)->fs_type == FSTYPE_FAT16 ? 1 : 2)
+#  define FREEMAP_SECTOR(f,c)  SEC_NSECTORS(f, (c) << FREEMAP_SHIFT(f))
+#  define FREEMAP_LAST(f,s) \
+     ((((s) + 1) * ((f)->fs_hwsectorsize >> FREEMAP_SHIFT(f))) - 1)
+
+#  define FREEMAP_BYTE(f,s)    ((f)->fs_freemap[(s) >> 3])
+#  define FREEMAP_BIT(s)       (1 << ((s) & 7))
+#  define FREEMAP_TEST(f,s)    ((FREEMAP_BYTE(f,s) & FREEMAP_BIT(s)) != 0)
+#  define FREEMAP_SET(f,s)     (FREEMAP_BYTE(f,s) |= FREEMAP_BIT(s))
+#  define FREEMAP_CLEAR(f,s)   (FREEMAP_BYTE(f,s) &= ~FREEMAP_BIT(s))
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -636,6 +659,25 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
     }
 #endif
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Nothing is known about the FAT yet, so every sector may hold free
+   * clusters until a search finds it full.  The allocator works without
+   * the summary if there is no memory for it.  The FAT12 FAT is too small
+   * to need one.
+   */
+
+  if (fs->fs_type != FSTYPE_FAT12)
+    {
+      size_t size = (fs->fs_nfatsects + 7) >> 3;
+
+      fs->fs_freemap = fs_heap_malloc(size);
+      if (fs->fs_freemap != NULL)
+        {
+          memset(fs->fs_freemap, 0xff, size);
+        }
+    }
+#endif
+
   /* We did it! */
 
   finfo("FAT%d:\n", fs->fs_type == 0 ? 12 : fs->fs_type == 1  ? 16 : 32);
@@ -728,8 +770,13 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
-          ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
-                                                       sector, nsectors);
+          ssize_t nsectorsread;
+
+          nxsched_iowait_enter();
+          nsectorsread = inode->u.i_bops->read(inode, buffer, sector,
+                                               nsectors);
+          nxsched_iowait_leave();
+
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -761,8 +808,12 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
-          ssize_t nsectorswritten =
-              inode->u.i_bops->write(inode, buffer, sector, nsectors);
+          ssize_t nsectorswritten;
+
+          nxsched_iowait_enter();
+          nsectorswritten = inode->u.i_bops->write(inode, buffer, sector,
+                                                   nsectors);
+          nxsched_iowait_leave();
 
           if (nsectorswritten == nsectors)
             {
@@ -1100,6 +1151,15 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* A freed cluster makes its FAT sector worth searching again */
+
+      if (nextcluster == 0 && fs->fs_freemap != NULL)
+        {
+          FREEMAP_SET(fs, FREEMAP_SECTOR(fs, clusterno));
+        }
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1177,6 +1237,11 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   off_t    startsector;
   uint32_t newcluster;
   uint32_t startcluster;
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t runstart = 0;
+  uint32_t fatsector = 0;
+  uint32_t last = 0;
+#endif
   int      ret;
 
   /* The special value 0 is used when the new chain should start */
@@ -1256,6 +1321,41 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
             }
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      if (fs->fs_freemap != NULL)
+        {
+          fatsector = FREEMAP_SECTOR(fs, newcluster);
+          last      = FREEMAP_LAST(fs, fatsector);
+          if (last >= fs->fs_nclusters + 2)
+            {
+              last = fs->fs_nclusters + 1;
+            }
+
+          if (!FREEMAP_TEST(fs, fatsector))
+            {
+              /* The FAT sector is full, skip all of its clusters.  If
+               * that passes the starting cluster, there is no free cluster.
+               */
+
+              if (newcluster <= startcluster && startcluster <= last)
+                {
+                  return 0;
+                }
+
+              newcluster = last;
+              continue;
+            }
+
+          /* Remember where the search of each FAT sector started */
+
+          if (newcluster == 2 ||
+              FREEMAP_SECTOR(fs, newcluster - 1) != fatsector)
+            {
+              runstart = newcluster;
+            }
+        }
+#endif
+
       /* We have a candidate cluster.  Check if the cluster number is
        * mapped to a group of sectors.
        */
@@ -1274,6 +1374,18 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
           return startsector;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* A FAT sector searched from its first cluster to its last one
+       * without finding a free cluster is full.
+       */
+
+      if (fs->fs_freemap != NULL && newcluster == last && runstart != 0 &&
+          FREEMAP_SECTOR(fs, runstart) == fatsector)
+        {
+          FREEMAP_CLEAR(fs, fatsector);
+        }
+#endif
+
       /* We wrap all the back to the starting cluster?  If so, then
        * there are no free clusters.
        */
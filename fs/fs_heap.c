@@ -147,4 +147,9 @@ struct mallinfo_task fs_heap_mallinfo_task(FAR const struct malltask *task)
   return mm_mallinfo_task(g_fs_heap, task);
 }
 
+struct mallinfo fs_heap_mallinfo(void)
+{
+  return mm_mallinfo(g_fs_heap);
+}
+
 #endif
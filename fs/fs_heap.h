@@ -52,6 +52,7 @@ FAR char *fs_heap_strndup(FAR const char *s, size_t size) malloc_like;
 int       fs_heap_asprintf(FAR char **strp, FAR const char *fmt, ...)
           printf_like(2, 3);
 struct mallinfo_task fs_heap_mallinfo_task(FAR const struct malltask *task);
+struct mallinfo fs_heap_mallinfo(void);
 #else
 #  define fs_heap_initialize()
 #  define fs_heap_zalloc        kmm_zalloc
@@ -61,6 +62,7 @@ struct mallinfo_task fs_heap_mallinfo_task(FAR const struct malltask *task);
 #  define fs_heap_memalign      kmm_memalign
 #  define fs_heap_free          kmm_free
 #  define fs_heap_mallinfo_task kmm_mallinfo_task
+#  define fs_heap_mallinfo      kmm_mallinfo
 #  define fs_heap_strdup        strdup
 #  define fs_heap_strndup       strndup
 #  define fs_heap_asprintf      asprintf
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 
@@ -38,6 +39,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -240,6 +242,157 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+/****************************************************************************
+ * Name: hostfs_invalidate
+ *
+ * Description: Forget the cached data of a mount after a change.
+ *
+ ****************************************************************************/
+
+static void hostfs_invalidate(FAR struct hostfs_mountpt_s *fs)
+{
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  FAR struct hostfs_ofile_s *hf;
+#endif
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+  int i;
+#endif
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      hf->buflen = 0;
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+  for (i = 0; i < CONFIG_FS_HOSTFS_STAT_CACHE; i++)
+    {
+      fs->fs_stat[i].path[0] = '\0';
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: hostfs_stat_cached
+ *
+ * Description: Stat a host path through the stat cache.  If the file is
+ *   open, fd is used on a miss instead of the path.
+ *
+ ****************************************************************************/
+
+static int hostfs_stat_cached(FAR struct hostfs_mountpt_s *fs,
+                              FAR const char *path, int fd,
+                              FAR struct stat *buf)
+{
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+  FAR struct hostfs_stat_s *entry;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_STAT_CACHE; i++)
+    {
+      entry = &fs->fs_stat[i];
+      if (entry->path[0] != '\0' &&
+          now - entry->stamp < MSEC2TICK(CONFIG_FS_HOSTFS_STAT_TIMEOUT) &&
+          strcmp(entry->path, path) == 0)
+        {
+          memcpy(buf, &entry->st, sizeof(struct stat));
+          return entry->result;
+        }
+    }
+
+  entry = &fs->fs_stat[fs->fs_statnext];
+  fs->fs_statnext = (fs->fs_statnext + 1) % CONFIG_FS_HOSTFS_STAT_CACHE;
+
+  entry->result = fd >= 0 ? host_fstat(fd, &entry->st) :
+                            host_stat(path, &entry->st);
+  entry->stamp  = now;
+  strlcpy(entry->path, path, sizeof(entry->path));
+
+  memcpy(buf, &entry->st, sizeof(struct stat));
+  return entry->result;
+#else
+  return fd >= 0 ? host_fstat(fd, buf) : host_stat(path, buf);
+#endif
+}
+
+/****************************************************************************
+ * Name: hostfs_bufread
+ *
+ * Description: Read a file opened read-only through its buffer.  Reads of
+ *   at least a buffer go straight to the caller.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+static ssize_t hostfs_bufread(FAR struct hostfs_ofile_s *hf, off_t pos,
+                              FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+  bool eof = false;
+  size_t n;
+
+  while (buflen > 0)
+    {
+      if (pos < hf->bufpos || pos >= hf->bufpos + (off_t)hf->buflen)
+        {
+          /* A short read already found the end of the file */
+
+          if (eof)
+            {
+              break;
+            }
+
+          if (hf->hostpos != pos)
+            {
+              ret = host_lseek(hf->fd, hf->hostpos, pos, SEEK_SET);
+              if (ret < 0)
+                {
+                  hf->hostpos = -1;
+                  break;
+                }
+
+              hf->hostpos = pos;
+            }
+
+          if (buflen >= CONFIG_FS_HOSTFS_BUFFER_SIZE)
+            {
+              ret = host_read(hf->fd, buffer, buflen);
+              if (ret > 0)
+                {
+                  hf->hostpos += ret;
+                  nread += ret;
+                }
+
+              break;
+            }
+
+          ret = host_read(hf->fd, hf->buffer, CONFIG_FS_HOSTFS_BUFFER_SIZE);
+          if (ret <= 0)
+            {
+              break;
+            }
+
+          hf->hostpos += ret;
+          hf->bufpos   = pos;
+          hf->buflen   = ret;
+          eof          = ret < CONFIG_FS_HOSTFS_BUFFER_SIZE;
+        }
+
+      n = MIN(buflen, hf->bufpos + hf->buflen - pos);
+      memcpy(buffer, hf->buffer + (pos - hf->bufpos), n);
+      buffer += n;
+      buflen -= n;
+      pos    += n;
+      nread  += n;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -300,6 +453,25 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_invalidate(fs);
+    }
+
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  /* Only files that cannot change through this handle are buffered */
+
+  hf->buffer  = NULL;
+  hf->bufpos  = 0;
+  hf->buflen  = 0;
+  hf->hostpos = 0;
+
+  if ((oflags & O_WROK) == 0)
+    {
+      hf->buffer = fs_heap_malloc(CONFIG_FS_HOSTFS_BUFFER_SIZE);
+    }
+#endif
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -431,6 +603,13 @@ static int hostfs_close(FAR struct file *filep)
   /* Now free the pointer */
 
   filep->f_priv = NULL;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hf->buffer != NULL)
+    {
+      fs_heap_free(hf->buffer);
+    }
+#endif
+
   fs_heap_free(hf);
 
 okout:
@@ -472,7 +651,17 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
-  ret = host_read(hf->fd, buffer, buflen);
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hf->buffer != NULL)
+    {
+      ret = hostfs_bufread(hf, filep->f_pos, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = host_read(hf->fd, buffer, buflen);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -530,6 +719,8 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       filep->f_pos += ret;
     }
 
+  hostfs_invalidate(fs);
+
 errout_with_lock:
   nxmutex_unlock(&g_lock);
   return ret;
@@ -568,7 +759,27 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call our internal routine to perform the seek */
 
-  ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  if (hf->buffer != NULL && (whence == SEEK_SET || whence == SEEK_CUR))
+    {
+      /* The host file is moved by the next read that needs it */
+
+      if (whence == SEEK_CUR)
+        {
+          offset += filep->f_pos;
+        }
+
+      ret = offset < 0 ? -EINVAL : offset;
+    }
+  else
+#endif
+    {
+      ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+      hf->hostpos = ret;
+#endif
+    }
+
   if (ret >= 0)
     {
       filep->f_pos = ret;
@@ -745,9 +956,21 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
-  /* Call the host to perform the read */
+  /* Call the host to perform the read, the attributes of a file opened
+   * read-only are cached like those of a path.
+   */
 
-  ret = host_fstat(hf->fd, buf);
+  if ((hf->oflags & O_WROK) == 0)
+    {
+      char path[HOSTFS_MAX_PATH];
+
+      hostfs_mkpath(fs, hf->relpath, path, sizeof(path));
+      ret = hostfs_stat_cached(fs, path, hf->fd, buf);
+    }
+  else
+    {
+      ret = host_fstat(hf->fd, buf);
+    }
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -794,6 +1017,7 @@ static int hostfs_fchstat(FAR const struct file *filep,
   /* Call the host to perform the change */
 
   ret = host_fchstat(hf->fd, buf, flags);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -835,6 +1059,7 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
   /* Call the host to perform the truncate */
 
   ret = host_ftruncate(hf->fd, length);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1228,6 +1453,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1268,6 +1494,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1309,6 +1536,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1353,6 +1581,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1392,7 +1621,7 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
-  ret = host_stat(path, buf);
+  ret = hostfs_stat_cached(fs, path, -1, buf);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1433,6 +1662,7 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the chstat operation */
 
   ret = host_chstat(path, buf, flags);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
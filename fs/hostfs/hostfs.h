@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <sys/stat.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -39,6 +40,14 @@
 
 #define HOSTFS_MAX_PATH     256
 
+#ifndef CONFIG_FS_HOSTFS_BUFFER_SIZE
+#  define CONFIG_FS_HOSTFS_BUFFER_SIZE 0
+#endif
+
+#ifndef CONFIG_FS_HOSTFS_STAT_CACHE
+#  define CONFIG_FS_HOSTFS_STAT_CACHE 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -53,9 +62,27 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_BUFFER_SIZE > 0
+  FAR char                 *buffer;  /* Read buffer, read-only files only */
+  off_t                     bufpos;  /* File position of buffer[0] */
+  size_t                    buflen;  /* Valid bytes in the buffer */
+  off_t                     hostpos; /* Position of the host file */
+#endif
   char                      relpath[1];
 };
 
+/* This structure holds one cached stat() result */
+
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+struct hostfs_stat_s
+{
+  clock_t                   stamp;   /* When the result was obtained */
+  int                       result;  /* OK or the negated errno */
+  struct stat               st;
+  char                      path[HOSTFS_MAX_PATH]; /* Empty if unused */
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a hostfs filesystem.
@@ -65,6 +92,10 @@ struct hostfs_mountpt_s
 {
   FAR struct hostfs_ofile_s *fs_head;      /* A singly-linked list of open files */
   char                       fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_STAT_CACHE > 0
+  struct hostfs_stat_s       fs_stat[CONFIG_FS_HOSTFS_STAT_CACHE];
+  int                        fs_statnext;  /* Next entry to replace */
+#endif
 };
 
 /****************************************************************************
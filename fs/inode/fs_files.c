@@ -36,7 +36,11 @@
 #include <debug.h>
 #include <stdio.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/ioctl.h>
@@ -54,12 +58,145 @@
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Keep the lookup sequence counts of the CPUs in separate cache lines */
+
+#ifdef CONFIG_SMP
+#  define FDLIST_READERS_ALIGN 64
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+struct aligned_data(FDLIST_READERS_ALIGN) fdlist_readers_s
+{
+  atomic_t seq;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+/* fd lookups do not take fl_lock.  They run with interrupts disabled and
+ * make the sequence count of their CPU odd while they run.  Memory that a
+ * lookup may still be reading, a replaced fl_fds array or a struct file
+ * whose last reference is gone, is only freed after each CPU was seen
+ * outside of a lookup, see fdlist_synchronize().
+ */
+
+static struct fdlist_readers_s g_fdlist_readers[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fdlist_read_begin/fdlist_read_end
+ *
+ * Description:
+ *   Enter and leave a lock-free fd lookup.  The caller may not block in
+ *   between.
+ *
+ ****************************************************************************/
+
+static inline_function irqstate_t fdlist_read_begin(void)
+{
+  irqstate_t flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  atomic_fetch_add(&g_fdlist_readers[this_cpu()].seq, 1);
+  SMP_MB();
+#endif
+
+  return flags;
+}
+
+static inline_function void fdlist_read_end(irqstate_t flags)
+{
+#ifdef CONFIG_SMP
+  SMP_MB();
+  atomic_fetch_add(&g_fdlist_readers[this_cpu()].seq, 1);
+#endif
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: fdlist_synchronize
+ *
+ * Description:
+ *   Wait until all of the lookups that may have seen memory which was
+ *   unlinked before this call have finished.  Lookups are a handful of
+ *   instructions with interrupts disabled, so this never waits long.
+ *
+ ****************************************************************************/
+
+static void fdlist_synchronize(void)
+{
+#ifdef CONFIG_SMP
+  int32_t seq[CONFIG_SMP_NCPUS];
+  int cpu;
+
+  SMP_MB();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      seq[cpu] = atomic_read(&g_fdlist_readers[cpu].seq);
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* An odd count is a lookup in progress, wait for it to move on */
+
+      while ((seq[cpu] & 1) != 0 &&
+             atomic_read(&g_fdlist_readers[cpu].seq) == seq[cpu])
+        {
+          SMP_MB();
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: file_tryref
+ *
+ * Description:
+ *   Take a reference to a file unless its last one is already gone.
+ *
+ ****************************************************************************/
+
+static bool file_tryref(FAR struct file *filep)
+{
+  int32_t refs = atomic_read(&filep->f_refs);
+
+  while (refs > 0)
+    {
+      if (atomic_try_cmpxchg(&filep->f_refs, &refs, refs + 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: fdlist_get_by_index
+ *
+ * Description:
+ *   Look a file up without taking fl_lock.  A file found in the list is
+ *   still allocated, but its reference count may have dropped to zero
+ *   already if it was just closed:  the slot is then read again, it no
+ *   longer holds the file.
+ *
  ****************************************************************************/
 
 static void fdlist_get_by_index(FAR struct fdlist *list,
@@ -70,15 +207,15 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
   FAR struct fd *fdp1;
   irqstate_t flags;
 
-  flags = spin_lock_irqsave_notrace(&list->fl_lock);
+  flags = fdlist_read_begin();
   fdp1 = &list->fl_fds[l1][l2];
-  *filep = fdp1->f_file;
-  if (*filep != NULL)
+  do
     {
-      atomic_fetch_add(&(*filep)->f_refs, 1);
+      *filep = fdp1->f_file;
     }
+  while (*filep != NULL && !file_tryref(*filep));
 
-  spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
+  fdlist_read_end(flags);
   if (fdp != NULL)
     {
       *fdp = fdp1;
@@ -161,14 +298,23 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
       memcpy(fds, list->fl_fds, list->fl_rows * sizeof(FAR struct fd *));
     }
 
+  /* Publish the new array before the new row count: a lookup that sees
+   * the new count must see the array that has that many rows.
+   */
+
   tmp = list->fl_fds;
+  SMP_MB();
   list->fl_fds = fds;
+  SMP_MB();
   list->fl_rows = row;
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
 
   if (tmp != NULL && tmp != &list->fl_prefd)
     {
+      /* Lookups may still be reading the old array */
+
+      fdlist_synchronize();
       fs_heap_free(tmp);
     }
 
@@ -870,6 +1016,9 @@ int file_put(FAR struct file *filep)
           ferr("ERROR: fs putfilep file_close() failed: %d\n", ret);
         }
 
+      /* A lookup may still be looking at the file, see file_tryref() */
+
+      fdlist_synchronize();
       fs_heap_free(filep);
     }
 
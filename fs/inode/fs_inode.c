@@ -24,8 +24,13 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rwsem.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 
 #include "inode/inode.h"
 
@@ -33,16 +38,82 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Keep the reader counts of the CPUs in separate cache lines */
+
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+#  define INODE_READERS_ALIGN 64
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+struct aligned_data(INODE_READERS_ALIGN) inode_readers_s
+{
+  atomic_t count;
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 static rw_semaphore_t g_inode_lock = RWSEM_INITIALIZER;
 
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+/* Readers only touch the count of their CPU and read g_inode_writer,
+ * which is shared by all of the caches as long as there is no writer.
+ * The counts may go negative when a reader migrates between lock and
+ * unlock, only their sum is the number of readers.  Writers are still
+ * serialized by g_inode_lock, and wait on g_inode_drain for the readers
+ * to leave after raising g_inode_writer.  Readers that find a writer
+ * wait for it on g_inode_lock.
+ */
+
+static struct inode_readers_s g_inode_readers[CONFIG_SMP_NCPUS];
+static atomic_t g_inode_writer;
+static sem_t g_inode_drain = SEM_INITIALIZER(0);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+/****************************************************************************
+ * Name: inode_nreaders
+ ****************************************************************************/
+
+static int inode_nreaders(void)
+{
+  int nreaders = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      nreaders += atomic_read(&g_inode_readers[cpu].count);
+    }
+
+  return nreaders;
+}
+
+/****************************************************************************
+ * Name: inode_isholder
+ *
+ * Description:
+ *   Return true if the caller holds the write lock.  The holder field can
+ *   only be equal to the caller's id if the caller wrote it, so it does not
+ *   need the protection of the rwsem here.
+ *
+ ****************************************************************************/
+
+static bool inode_isholder(void)
+{
+  return g_inode_lock.holder == nxsched_gettid();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -74,6 +145,27 @@ void inode_initialize(void)
 void inode_lock(void)
 {
   down_write(&g_inode_lock);
+
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+  if (g_inode_lock.writer == 1)
+    {
+      /* Stop new readers, then wait for the current ones to leave */
+
+      atomic_set(&g_inode_writer, 1);
+      SMP_MB();
+
+      while (inode_nreaders() != 0)
+        {
+          nxsem_wait_uninterruptible(&g_inode_drain);
+        }
+
+      /* Consume the wake-ups of the readers that raced */
+
+      while (nxsem_trywait(&g_inode_drain) == OK)
+        {
+        }
+    }
+#endif
 }
 
 /****************************************************************************
@@ -86,7 +178,40 @@ void inode_lock(void)
 
 void inode_rlock(void)
 {
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+  FAR atomic_t *count;
+
+  if (inode_isholder())
+    {
+      /* A writer reading the tree, this nests in the write lock */
+
+      down_read(&g_inode_lock);
+      return;
+    }
+
+  for (; ; )
+    {
+      count = &g_inode_readers[this_cpu()].count;
+      atomic_fetch_add(count, 1);
+      SMP_MB();
+
+      if (atomic_read(&g_inode_writer) == 0)
+        {
+          return;
+        }
+
+      /* Back off and wait for the writer to finish */
+
+      atomic_fetch_sub(count, 1);
+      SMP_MB();
+      nxsem_post(&g_inode_drain);
+
+      down_read(&g_inode_lock);
+      up_read(&g_inode_lock);
+    }
+#else
   down_read(&g_inode_lock);
+#endif
 }
 
 /****************************************************************************
@@ -99,6 +224,14 @@ void inode_rlock(void)
 
 void inode_unlock(void)
 {
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+  if (g_inode_lock.writer == 1)
+    {
+      atomic_set(&g_inode_writer, 0);
+      SMP_MB();
+    }
+#endif
+
   up_write(&g_inode_lock);
 }
 
@@ -112,5 +245,23 @@ void inode_unlock(void)
 
 void inode_runlock(void)
 {
+#ifdef CONFIG_FS_INODE_PERCPU_LOCK
+  if (inode_isholder())
+    {
+      up_read(&g_inode_lock);
+      return;
+    }
+
+  atomic_fetch_sub(&g_inode_readers[this_cpu()].count, 1);
+  SMP_MB();
+
+  if (atomic_read(&g_inode_writer) != 0)
+    {
+      /* Let the writer waiting for the readers check again */
+
+      nxsem_post(&g_inode_drain);
+    }
+#else
   up_read(&g_inode_lock);
+#endif
 }
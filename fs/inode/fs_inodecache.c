@@ -0,0 +1,195 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INODE_CACHE_MASK (CONFIG_FS_INODE_CACHE_NENTRIES - 1)
+
+#if (CONFIG_FS_INODE_CACHE_NENTRIES & INODE_CACHE_MASK) != 0
+#  error CONFIG_FS_INODE_CACHE_NENTRIES must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The cached lookup of the child 'name' of 'parent'.  Entries of an older
+ * generation than g_inode_cache_gen are stale.
+ */
+
+struct inode_cache_s
+{
+  FAR struct inode *parent;     /* The inode searched */
+  FAR struct inode *node;       /* The child found, NULL if none */
+  FAR struct inode *peer;       /* The peer to the left of the child */
+  uint32_t          gen;        /* Generation of the entry */
+  uint8_t           len;        /* Length of the name */
+  char              name[CONFIG_FS_INODE_CACHE_NAMELEN];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Lookups run concurrently under the read lock of the inode tree, the
+ * spinlock only keeps the entries consistent.  Invalidation holds the
+ * write lock, so it never races with a lookup.
+ */
+
+static struct inode_cache_s g_inode_cache[CONFIG_FS_INODE_CACHE_NENTRIES];
+static uint32_t g_inode_cache_gen = 1;
+static spinlock_t g_inode_cache_lock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_hash
+ *
+ * Description:
+ *   Hash the parent and the first component of the name, and return the
+ *   length of the component.
+ *
+ ****************************************************************************/
+
+static size_t inode_cache_hash(FAR struct inode *parent,
+                               FAR const char *name, FAR uint32_t *hash)
+{
+  uint32_t h = (uint32_t)(uintptr_t)parent * 0x9e3779b1u;
+  size_t len;
+
+  for (len = 0; name[len] != '\0' && name[len] != '/'; len++)
+    {
+      h = (h ^ (uint8_t)name[len]) * 0x01000193u;
+    }
+
+  *hash = h ^ (h >> 16);
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ ****************************************************************************/
+
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node, FAR struct inode **peer)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+  bool hit;
+
+  len = inode_cache_hash(parent, name, &hash);
+  if (len > CONFIG_FS_INODE_CACHE_NAMELEN)
+    {
+      return false;
+    }
+
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  hit = entry->gen == g_inode_cache_gen && entry->parent == parent &&
+        entry->len == len && memcmp(entry->name, name, len) == 0;
+  if (hit)
+    {
+      *node = entry->node;
+      *peer = entry->peer;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+  return hit;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ ****************************************************************************/
+
+void inode_cache_insert(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode *node, FAR struct inode *peer)
+{
+  FAR struct inode_cache_s *entry;
+  irqstate_t flags;
+  uint32_t hash;
+  size_t len;
+
+  len = inode_cache_hash(parent, name, &hash);
+  if (len > CONFIG_FS_INODE_CACHE_NAMELEN)
+    {
+      return;
+    }
+
+  entry = &g_inode_cache[hash & INODE_CACHE_MASK];
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  entry->parent = parent;
+  entry->node   = node;
+  entry->peer   = peer;
+  entry->gen    = g_inode_cache_gen;
+  entry->len    = len;
+  memcpy(entry->name, name, len);
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ ****************************************************************************/
+
+void inode_cache_invalidate(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_inode_cache_lock);
+
+  /* Skip the generation of the never used entries on wrap around */
+
+  if (++g_inode_cache_gen == 0)
+    {
+      memset(g_inode_cache, 0, sizeof(g_inode_cache));
+      g_inode_cache_gen = 1;
+    }
+
+  spin_unlock_irqrestore(&g_inode_cache_lock, flags);
+}
@@ -107,6 +107,7 @@ static FAR struct inode *inode_unlink(FAR const char *path)
 
       inode->i_peer   = NULL;
       inode->i_parent = NULL;
+      inode_cache_invalidate();
       atomic_fetch_sub(&inode->i_crefs, 1);
     }
 
@@ -43,6 +43,10 @@
  ****************************************************************************/
 
 static int _inode_compare(FAR const char *fname, FAR struct inode *inode);
+static FAR struct inode *_inode_findpeer(FAR struct inode *parent,
+                                         FAR struct inode *inode,
+                                         FAR const char *name,
+                                         FAR struct inode **peer);
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
 static int _inode_linktarget(FAR struct inode *inode,
                              FAR struct inode_search_s *desc);
@@ -131,6 +135,74 @@ static int _inode_compare(FAR const char *fname, FAR struct inode *inode)
     }
 }
 
+/****************************************************************************
+ * Name: _inode_findpeer
+ *
+ * Description:
+ *   Find the node named by the first component of 'name' among 'inode' and
+ *   its peers, the children of 'parent'.  Return the node (NULL if there is
+ *   none) and in 'peer', the node to its left (or to the left of where it
+ *   would be inserted).
+ *
+ ****************************************************************************/
+
+static FAR struct inode *_inode_findpeer(FAR struct inode *parent,
+                                         FAR struct inode *inode,
+                                         FAR const char *name,
+                                         FAR struct inode **peer)
+{
+  FAR struct inode *left = NULL;
+
+#ifdef CONFIG_FS_INODE_CACHE
+  if (parent != NULL && inode_cache_lookup(parent, name, &inode, peer))
+    {
+      return inode;
+    }
+#endif
+
+  while (inode != NULL)
+    {
+      int result = _inode_compare(name, inode);
+
+      /* Case 1:  The name is less than the name of the node.
+       * Since the names are ordered, these means that there
+       * is no peer node with this name and that there can be
+       * no match in the filesystem.
+       */
+
+      if (result < 0)
+        {
+          inode = NULL;
+          break;
+        }
+
+      /* Case 2: The names match */
+
+      else if (result == 0)
+        {
+          break;
+        }
+
+      /* Case 3: the name is greater than the name of the node.
+       * In this case, the name may still be in the list to the
+       * "right"
+       */
+
+      left  = inode;
+      inode = inode->i_peer;
+    }
+
+#ifdef CONFIG_FS_INODE_CACHE
+  if (parent != NULL)
+    {
+      inode_cache_insert(parent, name, inode, left);
+    }
+#endif
+
+  *peer = left;
+  return inode;
+}
+
 /****************************************************************************
  * Name: _inode_linktarget
  *
@@ -240,154 +312,122 @@ static int _inode_search(FAR struct inode_search_s *desc)
    * matching node is found.
    */
 
-  while (inode != NULL)
+  while ((inode = _inode_findpeer(above, inode, name, &left)) != NULL)
     {
-      int result = _inode_compare(name, inode);
-
-      /* Case 1:  The name is less than the name of the node.
-       * Since the names are ordered, these means that there
-       * is no peer node with this name and that there can be
-       * no match in the filesystem.
+      /* Now there are three remaining possibilities:
+       *   (1) This is the node that we are looking for.
+       *   (2) The node we are looking for is "below" this one.
+       *   (3) This node is a mountpoint and will absorb all requests
+       *       below this one
        */
 
-      if (result < 0)
-        {
-          inode = NULL;
-          break;
-        }
-
-      /* Case 2: the name is greater than the name of the node.
-       * In this case, the name may still be in the list to the
-       * "right"
-       */
-
-      else if (result > 0)
+      name = inode_nextname(name);
+      if (*name == '\0' || INODE_IS_MOUNTPT(inode))
         {
-          /* Continue looking to the "right" of this inode. */
+          /* Either (1) we are at the end of the path, so this must be
+           * the node we are looking for or else (2) this node is a
+           * mountpoint and will handle the remaining part of the
+           * pathname
+           */
 
-          left  = inode;
-          inode = inode->i_peer;
+          relpath = name;
+          ret = OK;
+          break;
         }
-
-      /* The names match */
-
       else
         {
-          /* Now there are three remaining possibilities:
-           *   (1) This is the node that we are looking for.
-           *   (2) The node we are looking for is "below" this one.
-           *   (3) This node is a mountpoint and will absorb all requests
-           *       below this one
-           */
+          /* More nodes to be examined in the path "below" this one. */
 
-          name = inode_nextname(name);
-          if (*name == '\0' || INODE_IS_MOUNTPT(inode))
-            {
-              /* Either (1) we are at the end of the path, so this must be
-               * the node we are looking for or else (2) this node is a
-               * mountpoint and will handle the remaining part of the
-               * pathname
-               */
+#ifdef CONFIG_PSEUDOFS_SOFTLINKS
+          /* Was the node a soft link?  If so, then we need need to
+           * continue below the target of the link, not the link itself.
+           */
 
-              relpath = name;
-              ret = OK;
-              break;
-            }
-          else
+          if (INODE_IS_SOFTLINK(inode))
             {
-              /* More nodes to be examined in the path "below" this one. */
+              int status;
 
-#ifdef CONFIG_PSEUDOFS_SOFTLINKS
-              /* Was the node a soft link?  If so, then we need need to
-               * continue below the target of the link, not the link itself.
+              /* If this intermediate inode in the is a soft link, then
+               * (1) recursively look-up the inode referenced by the
+               * soft link, and (2) continue searching with that inode
+               * instead.
                */
 
-              if (INODE_IS_SOFTLINK(inode))
+              status = _inode_linktarget(inode, desc);
+              if (status < 0)
                 {
-                  int status;
-
-                  /* If this intermediate inode in the is a soft link, then
-                   * (1) recursively look-up the inode referenced by the
-                   * soft link, and (2) continue searching with that inode
-                   * instead.
+                  /* Probably means that the target of the symbolic link
+                   * does not exist.
                    */
 
-                  status = _inode_linktarget(inode, desc);
-                  if (status < 0)
+                  ret = status;
+                  break;
+                }
+              else
+                {
+                  FAR struct inode *newnode = desc->node;
+
+                  if (newnode != inode)
                     {
-                      /* Probably means that the target of the symbolic link
-                       * does not exist.
+                      /* The node was a valid symbolic link and we have
+                       * jumped to a different, spot in the pseudo file
+                       * system tree.
                        */
 
-                      ret = status;
-                      break;
-                    }
-                  else
-                    {
-                      FAR struct inode *newnode = desc->node;
+                      /* Check if this took us to a mountpoint. */
 
-                      if (newnode != inode)
+                      if (INODE_IS_MOUNTPT(newnode))
                         {
-                          /* The node was a valid symbolic link and we have
-                           * jumped to a different, spot in the pseudo file
-                           * system tree.
+                          /* Return the mountpoint information.
+                           * NOTE that the last path to the link target
+                           * was already set by _inode_linktarget().
                            */
 
-                          /* Check if this took us to a mountpoint. */
+                          inode   = newnode;
+                          above   = desc->parent;
+                          left    = desc->peer;
+                          ret     = OK;
 
-                          if (INODE_IS_MOUNTPT(newnode))
+                          if (*desc->relpath != '\0')
                             {
-                              /* Return the mountpoint information.
-                               * NOTE that the last path to the link target
-                               * was already set by _inode_linktarget().
-                               */
-
-                              inode   = newnode;
-                              above   = desc->parent;
-                              left    = desc->peer;
-                              ret     = OK;
+                              FAR char *buffer = NULL;
 
-                              if (*desc->relpath != '\0')
+                              ret = fs_heap_asprintf(&buffer, "%s/%s",
+                                                     desc->relpath,
+                                                     name);
+                              if (ret > 0)
                                 {
-                                  FAR char *buffer = NULL;
-
-                                  ret = fs_heap_asprintf(&buffer, "%s/%s",
-                                                         desc->relpath,
-                                                         name);
-                                  if (ret > 0)
-                                    {
-                                      fs_heap_free(desc->buffer);
-                                      desc->buffer = buffer;
-                                      relpath = buffer;
-                                      ret = OK;
-                                    }
-                                  else
-                                    {
-                                      ret = -ENOMEM;
-                                    }
+                                  fs_heap_free(desc->buffer);
+                                  desc->buffer = buffer;
+                                  relpath = buffer;
+                                  ret = OK;
                                 }
                               else
                                 {
-                                  relpath = name;
+                                  ret = -ENOMEM;
                                 }
-
-                              break;
+                            }
+                          else
+                            {
+                              relpath = name;
                             }
 
-                          /* Continue from this new inode. */
-
-                          inode = newnode;
+                          break;
                         }
+
+                      /* Continue from this new inode. */
+
+                      inode = newnode;
                     }
                 }
+            }
 #endif
 
-              /* Keep looking at the next level "down" */
+          /* Keep looking at the next level "down" */
 
-              above = inode;
-              left  = NULL;
-              inode = inode->i_child;
-            }
+          above = inode;
+          left  = NULL;
+          inode = inode->i_child;
         }
     }
 
@@ -237,6 +237,54 @@ void inode_runlock(void);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the child named by the first component of 'name' of the inode
+ *   'parent' in the path component cache.  On a hit, return true and set
+ *   'node' to the child (NULL if there is no such child) and 'peer' to the
+ *   peer on its left (or to the left of where it would be inserted).
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, at least for reading.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_CACHE
+bool inode_cache_lookup(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode **node, FAR struct inode **peer);
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Add the result of a lookup to the path component cache.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock, at least for reading.
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(FAR struct inode *parent, FAR const char *name,
+                        FAR struct inode *node, FAR struct inode *peer);
+
+/****************************************************************************
+ * Name: inode_cache_invalidate
+ *
+ * Description:
+ *   Forget all of the cached lookups, after the inode tree was changed.
+ *
+ * Assumptions:
+ *   The caller holds the inode tree lock for writing.
+ *
+ ****************************************************************************/
+
+void inode_cache_invalidate(void);
+#else
+#  define inode_cache_invalidate()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
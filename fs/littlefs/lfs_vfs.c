@@ -28,6 +28,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
 #include <string.h>
 
 #include <nuttx/crc16.h>
@@ -36,6 +37,13 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+
+#ifdef CONFIG_FS_LITTLEFS_STATS
+#  include <nuttx/fs/procfs.h>
+#endif
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -53,6 +61,14 @@
 #  error littlefs requires CONFIG_C99_BOOL to be selected
 #endif
 
+/* Block number of an unused metadata cache line */
+
+#define LITTLEFS_NOBLOCK     ((lfs_block_t)-1)
+
+/* Longest line of /proc/fs/littlefs */
+
+#define LITTLEFS_LINELEN     80
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,10 +81,60 @@ struct littlefs_dir_s
 
 struct littlefs_file_s
 {
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+  sq_entry_t            node;     /* Entry in the cache of closed files */
+  FAR char             *path;     /* Path if opened read-only, else NULL */
+#endif
   struct lfs_file       file;
   int                   refs;
 };
 
+/* The kinds of operations that flash reads are accounted to */
+
+enum littlefs_op_e
+{
+  LITTLEFS_OP_MOUNT = 0,          /* mount and unmount */
+  LITTLEFS_OP_OPEN,
+  LITTLEFS_OP_CLOSE,
+  LITTLEFS_OP_READ,
+  LITTLEFS_OP_WRITE,
+  LITTLEFS_OP_SEEK,
+  LITTLEFS_OP_IOCTL,
+  LITTLEFS_OP_SYNC,
+  LITTLEFS_OP_TRUNCATE,
+  LITTLEFS_OP_FSTAT,
+  LITTLEFS_OP_DIR,                /* opendir, readdir, ... */
+  LITTLEFS_OP_STATFS,
+  LITTLEFS_OP_UNLINK,
+  LITTLEFS_OP_MKDIR,
+  LITTLEFS_OP_RENAME,
+  LITTLEFS_OP_STAT,
+  LITTLEFS_OP_CHSTAT,
+  LITTLEFS_NOPS
+};
+
+#ifdef CONFIG_FS_LITTLEFS_STATS
+struct littlefs_stats_s
+{
+  uint32_t              calls;    /* Number of operations */
+  uint32_t              reads;    /* Number of flash reads */
+  uint64_t              bytes;    /* Number of bytes read from flash */
+  uint32_t              hits;     /* Reads served by the metadata cache */
+};
+#endif
+
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+/* One line of the metadata cache */
+
+struct littlefs_mdline_s
+{
+  lfs_block_t           block;    /* Block of the line or LITTLEFS_NOBLOCK */
+  lfs_off_t             off;      /* Offset of the line in the block */
+  uint32_t              used;     /* Time of the last use, 0 if unused */
+  FAR uint8_t          *buffer;   /* cfg.cache_size bytes of the block */
+};
+#endif
+
 /* This structure represents the overall mountpoint state. An instance of
  * this structure is retained as inode private data on each mountpoint that
  * is mounted with a littlefs filesystem.
@@ -82,6 +148,28 @@ struct littlefs_mountpt_s
   struct lfs_config     cfg;
   struct lfs            lfs;
   bool                  readonly;
+
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+  /* Pieces of blocks read through the littlefs read cache, used for the
+   * metadata pair fetches of path lookups.
+   */
+
+  struct littlefs_mdline_s mdcache[CONFIG_FS_LITTLEFS_MDCACHE_LINES];
+  uint32_t              mdclock;  /* Counter for the LRU replacement */
+#endif
+
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+  /* Closed read-only files still open in littlefs, the oldest first */
+
+  sq_queue_t            closed;
+  int                   nclosed;
+#endif
+
+#ifdef CONFIG_FS_LITTLEFS_STATS
+  sq_entry_t            node;     /* Entry in g_littlefs_mounts */
+  int                   op;       /* Operation in progress */
+  struct littlefs_stats_s stats[LITTLEFS_NOPS];
+#endif
 };
 
 /* NuttX specific file attributes.
@@ -164,6 +252,37 @@ static int     littlefs_chstat(FAR struct inode *mountpt,
                                FAR const struct stat *buf, int flags);
 #endif
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+static int     littlefs_procfs_open(FAR struct file *filep,
+                                    FAR const char *relpath,
+                                    int oflags, mode_t mode);
+static int     littlefs_procfs_close(FAR struct file *filep);
+static ssize_t littlefs_procfs_read(FAR struct file *filep,
+                                    FAR char *buffer, size_t buflen);
+static int     littlefs_procfs_dup(FAR const struct file *oldp,
+                                   FAR struct file *newp);
+static int     littlefs_procfs_stat(FAR const char *relpath,
+                                    FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_LITTLEFS_STATS
+/* All of the littlefs mounts, for /proc/fs/littlefs */
+
+static sq_queue_t g_littlefs_mounts;
+static mutex_t g_littlefs_mountlock = NXMUTEX_INITIALIZER;
+
+static FAR const char * const g_littlefs_opnames[LITTLEFS_NOPS] =
+{
+  "mount", "open", "close", "read", "write", "seek", "ioctl", "sync",
+  "truncate", "fstat", "dir", "statfs", "unlink", "mkdir", "rename",
+  "stat", "chstat"
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -217,6 +336,28 @@ const struct mountpt_operations g_littlefs_operations =
 #endif
 };
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+/* See fs_procfs.c -- this structure is explicitly extern'ed there. */
+
+const struct procfs_operations g_littlefs_procfs_operations =
+{
+  littlefs_procfs_open,   /* open */
+  littlefs_procfs_close,  /* close */
+  littlefs_procfs_read,   /* read */
+  NULL,                   /* write */
+  NULL,                   /* poll */
+
+  littlefs_procfs_dup,    /* dup */
+
+  NULL,                   /* opendir */
+  NULL,                   /* closedir */
+  NULL,                   /* readdir */
+  NULL,                   /* rewinddir */
+
+  littlefs_procfs_stat    /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -336,6 +477,133 @@ static FAR const char *littlefs_convert_path(FAR const char *path)
   return path;
 }
 
+/****************************************************************************
+ * Name: littlefs_lock
+ *
+ * Description:
+ *   Take the mount lock for an operation of the kind 'op'.  Flash reads
+ *   done until the lock is released are accounted to that kind.
+ *
+ ****************************************************************************/
+
+static int littlefs_lock(FAR struct littlefs_mountpt_s *fs, int op)
+{
+  int ret;
+
+  ret = nxmutex_lock(&fs->lock);
+#ifdef CONFIG_FS_LITTLEFS_STATS
+  if (ret >= 0)
+    {
+      fs->op = op;
+      fs->stats[op].calls++;
+    }
+#else
+  UNUSED(op);
+#endif
+
+  return ret;
+}
+
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+
+/****************************************************************************
+ * Name: littlefs_closed_flush
+ *
+ * Description:
+ *   Really close all of the cached closed files.  This is called with the
+ *   lock held before anything that modifies the file system, so that a
+ *   cached file never goes stale.
+ *
+ ****************************************************************************/
+
+static void littlefs_closed_flush(FAR struct littlefs_mountpt_s *fs)
+{
+  FAR struct littlefs_file_s *priv;
+
+  while ((priv = (FAR struct littlefs_file_s *)
+                 sq_remfirst(&fs->closed)) != NULL)
+    {
+      lfs_file_close(&fs->lfs, &priv->file);
+      fs_heap_free(priv->path);
+      fs_heap_free(priv);
+    }
+
+  fs->nclosed = 0;
+}
+
+/****************************************************************************
+ * Name: littlefs_closed_take
+ *
+ * Description:
+ *   Remove the cached closed file opened for 'path' from the cache and
+ *   return it, or return NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct littlefs_file_s *
+littlefs_closed_take(FAR struct littlefs_mountpt_s *fs,
+                     FAR const char *path)
+{
+  FAR struct littlefs_file_s *priv;
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *node;
+
+  for (node = sq_peek(&fs->closed); node != NULL;
+       prev = node, node = sq_next(node))
+    {
+      priv = (FAR struct littlefs_file_s *)node;
+      if (strcmp(priv->path, path) == 0)
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst(&fs->closed);
+            }
+          else
+            {
+              sq_remafter(prev, &fs->closed);
+            }
+
+          fs->nclosed--;
+          return priv;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: littlefs_closed_add
+ *
+ * Description:
+ *   Keep a read-only file that is being closed open in the cache,
+ *   really closing the oldest cached file if the cache is full.
+ *
+ ****************************************************************************/
+
+static void littlefs_closed_add(FAR struct littlefs_mountpt_s *fs,
+                                FAR struct littlefs_file_s *priv)
+{
+  FAR struct littlefs_file_s *oldest;
+
+  if (fs->nclosed >= CONFIG_FS_LITTLEFS_FILECACHE_SIZE)
+    {
+      oldest = (FAR struct littlefs_file_s *)sq_remfirst(&fs->closed);
+      lfs_file_close(&fs->lfs, &oldest->file);
+      fs_heap_free(oldest->path);
+      fs_heap_free(oldest);
+    }
+  else
+    {
+      fs->nclosed++;
+    }
+
+  sq_addlast(&priv->node, &fs->closed);
+}
+
+#else
+#  define littlefs_closed_flush(fs)
+#endif /* CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0 */
+
 /****************************************************************************
  * Name: littlefs_open
  ****************************************************************************/
@@ -364,10 +632,13 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
     }
 
   priv->refs = 1;
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+  priv->path = NULL;
+#endif
 
   /* Lock */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_OPEN);
   if (ret < 0)
     {
       goto errlock;
@@ -386,6 +657,36 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
         }
     }
 
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+  /* A read-only file closed not long ago may still be open */
+
+  if (oflags == LFS_O_RDONLY)
+    {
+      FAR struct littlefs_file_s *closed;
+
+      closed = littlefs_closed_take(fs, relpath);
+      if (closed != NULL)
+        {
+          fs_heap_free(priv);
+          priv = closed;
+          priv->refs = 1;
+
+          ret = littlefs_convert_result(lfs_file_rewind(&fs->lfs,
+                                                        &priv->file));
+          if (ret < 0)
+            {
+              goto errout_with_file;
+            }
+
+          goto out;
+        }
+    }
+  else
+    {
+      littlefs_closed_flush(fs);
+    }
+#endif
+
   ret = littlefs_convert_result(lfs_file_open(&fs->lfs, &priv->file,
                                               relpath, oflags));
   if (ret < 0)
@@ -395,6 +696,17 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout;
     }
 
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+  if (oflags == LFS_O_RDONLY)
+    {
+      /* Remember the path to cache the file when it is closed.  Not
+       * having the memory just means not caching it.
+       */
+
+      priv->path = fs_heap_strdup(relpath);
+    }
+#endif
+
 #ifdef CONFIG_FS_LITTLEFS_ATTR_UPDATE
   if (oflags & LFS_O_CREAT)
     {
@@ -455,6 +767,9 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
       lfs_file_sync(&fs->lfs, &priv->file);
     }
 
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+out:
+#endif
   nxmutex_unlock(&fs->lock);
 
   /* Attach the private date to the struct file instance */
@@ -464,6 +779,9 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
 
 errout_with_file:
   lfs_file_close(&fs->lfs, &priv->file);
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+  fs_heap_free(priv->path);
+#endif
 errout:
   nxmutex_unlock(&fs->lock);
 errlock:
@@ -490,7 +808,7 @@ static int littlefs_close(FAR struct file *filep)
 
   /* Close the file */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_CLOSE);
   if (ret < 0)
     {
       return ret;
@@ -498,6 +816,22 @@ static int littlefs_close(FAR struct file *filep)
 
   if (--priv->refs <= 0)
     {
+#if CONFIG_FS_LITTLEFS_FILECACHE_SIZE > 0
+      if (priv->path != NULL)
+        {
+          /* Keep a read-only file open for the next open of its path */
+
+          littlefs_closed_add(fs, priv);
+          nxmutex_unlock(&fs->lock);
+          return OK;
+        }
+#endif
+
+      if ((priv->file.flags & LFS_O_WRONLY) != 0)
+        {
+          littlefs_closed_flush(fs);
+        }
+
       ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
     }
 
@@ -530,7 +864,7 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call LFS to perform the read */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_READ);
   if (ret < 0)
     {
       return ret;
@@ -579,12 +913,14 @@ static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
 
   /* Call LFS to perform the write */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_WRITE);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   if (filep->f_pos != priv->file.pos)
     {
       ret = littlefs_convert_result(lfs_file_seek(&fs->lfs, &priv->file,
@@ -627,7 +963,7 @@ static off_t littlefs_seek(FAR struct file *filep, off_t offset, int whence)
 
   /* Call LFS to perform the seek */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_SEEK);
   if (ret < 0)
     {
       return ret;
@@ -667,7 +1003,7 @@ static int littlefs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   fs    = inode->i_private;
   drv   = fs->drv;
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_IOCTL);
   if (ret < 0)
     {
       return ret;
@@ -742,12 +1078,17 @@ static int littlefs_sync(FAR struct file *filep)
   inode = filep->f_inode;
   fs    = inode->i_private;
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_SYNC);
   if (ret < 0)
     {
       return ret;
     }
 
+  if ((priv->file.flags & LFS_O_WRONLY) != 0)
+    {
+      littlefs_closed_flush(fs);
+    }
+
   ret = littlefs_convert_result(lfs_file_sync(&fs->lfs, &priv->file));
   nxmutex_unlock(&fs->lock);
 
@@ -816,7 +1157,7 @@ static int littlefs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call LFS to get file size */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_FSTAT);
   if (ret < 0)
     {
       return ret;
@@ -881,12 +1222,14 @@ static int littlefs_fchstat(FAR const struct file *filep,
 
   /* Call LFS to get file size */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_CHSTAT);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   ret = littlefs_convert_result(lfs_file_getattr(&fs->lfs, &priv->file,
                                                  0, &attr, sizeof(attr)));
   if (ret < 0)
@@ -967,12 +1310,14 @@ static int littlefs_truncate(FAR struct file *filep, off_t length)
 
   /* Call LFS to perform the truncate */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_TRUNCATE);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   ret = littlefs_convert_result(lfs_file_truncate(&fs->lfs, &priv->file,
                                                   length));
   nxmutex_unlock(&fs->lock);
@@ -1009,7 +1354,7 @@ static int littlefs_opendir(FAR struct inode *mountpt,
 
   /* Take the lock */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_DIR);
   if (ret < 0)
     {
       goto errlock;
@@ -1056,7 +1401,7 @@ static int littlefs_closedir(FAR struct inode *mountpt,
 
   /* Call the LFS's closedir function */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_DIR);
   if (ret < 0)
     {
       return ret;
@@ -1092,7 +1437,7 @@ static int littlefs_readdir(FAR struct inode *mountpt,
 
   /* Call the LFS's readdir function */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_DIR);
   if (ret < 0)
     {
       return ret;
@@ -1142,7 +1487,7 @@ static int littlefs_rewinddir(FAR struct inode *mountpt,
 
   /* Call the LFS's rewinddir function */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_DIR);
   if (ret < 0)
     {
       return ret;
@@ -1198,21 +1543,26 @@ static void littlefs_check(FAR struct inode *drv, lfs_block_t block,
 #endif
 
 /****************************************************************************
- * Name: littlefs_read_block
+ * Name: littlefs_read_raw
  ****************************************************************************/
 
-static int littlefs_read_block(FAR const struct lfs_config *c,
-                               lfs_block_t block, lfs_off_t off,
-                               FAR void *buffer, lfs_size_t size)
+static int littlefs_read_raw(FAR struct littlefs_mountpt_s *fs,
+                             lfs_block_t block, lfs_off_t off,
+                             FAR void *buffer, lfs_size_t size)
 {
-  FAR struct littlefs_mountpt_s *fs = c->context;
   FAR struct mtd_geometry_s *geo = &fs->geo;
   FAR struct inode *drv = fs->drv;
   int ret;
 
-  block = (block * c->block_size + off) / geo->blocksize;
+#ifdef CONFIG_FS_LITTLEFS_STATS
+  fs->stats[fs->op].reads++;
+  fs->stats[fs->op].bytes += size;
+#endif
+
+  block = (block * fs->cfg.block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  nxsched_iowait_enter();
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BREAD(drv->u.i_mtd, block, size, buffer);
@@ -1222,12 +1572,164 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
       ret = drv->u.i_bops->read(drv, buffer, block, size);
     }
 
+  nxsched_iowait_leave();
+
 #ifdef CONFIG_FS_LITTLEFS_DEBUG
   littlefs_check(drv, block, size, buffer, geo);
 #endif
   return ret >= 0 ? OK : ret;
 }
 
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+
+/****************************************************************************
+ * Name: littlefs_mdcache_line
+ *
+ * Description:
+ *   Return the metadata cache line holding the cache size aligned piece of
+ *   'block' at 'off', or the least recently used line if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct littlefs_mdline_s *
+littlefs_mdcache_line(FAR struct littlefs_mountpt_s *fs,
+                      lfs_block_t block, lfs_off_t off)
+{
+  FAR struct littlefs_mdline_s *victim = &fs->mdcache[0];
+  FAR struct littlefs_mdline_s *line;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_MDCACHE_LINES; i++)
+    {
+      line = &fs->mdcache[i];
+      if (line->block == block && line->off == off)
+        {
+          return line;
+        }
+
+      if (line->used < victim->used)
+        {
+          victim = line;
+        }
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: littlefs_mdcache_read
+ *
+ * Description:
+ *   Read through the metadata cache, a whole line at a time.
+ *
+ ****************************************************************************/
+
+static int littlefs_mdcache_read(FAR struct littlefs_mountpt_s *fs,
+                                 lfs_block_t block, lfs_off_t off,
+                                 FAR uint8_t *buffer, lfs_size_t size)
+{
+  lfs_size_t linesize = fs->cfg.cache_size;
+  FAR struct littlefs_mdline_s *line;
+  lfs_off_t lineoff;
+  lfs_size_t nbytes;
+  int ret;
+
+  while (size > 0)
+    {
+      lineoff = off - off % linesize;
+      nbytes  = lfs_min(lineoff + linesize - off, size);
+
+      line = littlefs_mdcache_line(fs, block, lineoff);
+      if (line->block == block && line->off == lineoff)
+        {
+#ifdef CONFIG_FS_LITTLEFS_STATS
+          fs->stats[fs->op].hits++;
+#endif
+        }
+      else
+        {
+          line->block = LITTLEFS_NOBLOCK;
+          line->used  = 0;
+
+          ret = littlefs_read_raw(fs, block, lineoff, line->buffer,
+                                  linesize);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          line->block = block;
+          line->off   = lineoff;
+        }
+
+      line->used = ++fs->mdclock;
+      memcpy(buffer, line->buffer + (off - lineoff), nbytes);
+
+      buffer += nbytes;
+      off    += nbytes;
+      size   -= nbytes;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_mdcache_drop
+ *
+ * Description:
+ *   Drop the metadata cache lines overlapping a range of a block that is
+ *   about to be programmed or erased.
+ *
+ ****************************************************************************/
+
+static void littlefs_mdcache_drop(FAR struct littlefs_mountpt_s *fs,
+                                  lfs_block_t block, lfs_off_t off,
+                                  lfs_size_t size)
+{
+  FAR struct littlefs_mdline_s *line;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_MDCACHE_LINES; i++)
+    {
+      line = &fs->mdcache[i];
+      if (line->block == block && line->off < off + size &&
+          off < line->off + fs->cfg.cache_size)
+        {
+          line->block = LITTLEFS_NOBLOCK;
+          line->used  = 0;
+        }
+    }
+}
+
+#else
+#  define littlefs_mdcache_drop(fs, block, off, size)
+#endif /* CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0 */
+
+/****************************************************************************
+ * Name: littlefs_read_block
+ ****************************************************************************/
+
+static int littlefs_read_block(FAR const struct lfs_config *c,
+                               lfs_block_t block, lfs_off_t off,
+                               FAR void *buffer, lfs_size_t size)
+{
+  FAR struct littlefs_mountpt_s *fs = c->context;
+
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+  /* The metadata pairs are fetched through the read cache of littlefs,
+   * while file data goes through the file caches or straight to the
+   * user buffer.
+   */
+
+  if (buffer == fs->lfs.rcache.buffer)
+    {
+      return littlefs_mdcache_read(fs, block, off, buffer, size);
+    }
+#endif
+
+  return littlefs_read_raw(fs, block, off, buffer, size);
+}
+
 /****************************************************************************
  * Name: littlefs_write_block
  ****************************************************************************/
@@ -1246,9 +1748,12 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
       return -EROFS;
     }
 
+  littlefs_mdcache_drop(fs, block, off, size);
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
+  nxsched_iowait_enter();
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_BWRITE(drv->u.i_mtd, block, size, buffer);
@@ -1258,6 +1763,8 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
       ret = drv->u.i_bops->write(drv, buffer, block, size);
     }
 
+  nxsched_iowait_leave();
+
 #ifdef CONFIG_FS_LITTLEFS_DEBUG
   littlefs_check(drv, block, size, buffer, geo);
 #endif
@@ -1280,6 +1787,8 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
       return -EROFS;
     }
 
+  littlefs_mdcache_drop(fs, block, 0, c->block_size);
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -1341,6 +1850,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+  int i;
+#endif
   int ret;
 
   /* Open the block driver */
@@ -1445,6 +1957,25 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.disk_version   = CONFIG_FS_LITTLEFS_DISK_VERSION;
 #endif
 
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+  /* Allocate the metadata cache lines in one piece */
+
+  fs->mdcache[0].buffer = fs_heap_malloc(CONFIG_FS_LITTLEFS_MDCACHE_LINES *
+                                         fs->cfg.cache_size);
+  if (fs->mdcache[0].buffer == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_fs;
+    }
+
+  for (i = 0; i < CONFIG_FS_LITTLEFS_MDCACHE_LINES; i++)
+    {
+      fs->mdcache[i].block  = LITTLEFS_NOBLOCK;
+      fs->mdcache[i].buffer = fs->mdcache[0].buffer +
+                              i * fs->cfg.cache_size;
+    }
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -1490,10 +2021,19 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
         }
     }
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+  nxmutex_lock(&g_littlefs_mountlock);
+  sq_addlast(&fs->node, &g_littlefs_mounts);
+  nxmutex_unlock(&g_littlefs_mountlock);
+#endif
+
   *handle = fs;
   return OK;
 
 errout_with_fs:
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+  fs_heap_free(fs->mdcache[0].buffer);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1522,12 +2062,14 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
   /* Unmount */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_MOUNT);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   ret = littlefs_convert_result(lfs_unmount(&fs->lfs));
   nxmutex_unlock(&fs->lock);
 
@@ -1551,8 +2093,17 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
           *driver = drv;
         }
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+      nxmutex_lock(&g_littlefs_mountlock);
+      sq_rem(&fs->node, &g_littlefs_mounts);
+      nxmutex_unlock(&g_littlefs_mountlock);
+#endif
+
       /* Release the mountpoint private data */
 
+#if CONFIG_FS_LITTLEFS_MDCACHE_LINES > 0
+      fs_heap_free(fs->mdcache[0].buffer);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
@@ -1585,7 +2136,7 @@ static int littlefs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
   buf->f_bfree   = fs->cfg.block_count;
   buf->f_bavail  = fs->cfg.block_count;
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_STATFS);
   if (ret < 0)
     {
       return ret;
@@ -1635,12 +2186,14 @@ static int littlefs_unlink(FAR struct inode *mountpt,
 
   /* Call the LFS to perform the unlink */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_UNLINK);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   relpath = littlefs_convert_path(relpath);
   ret = littlefs_convert_result(lfs_remove(&fs->lfs, relpath));
   nxmutex_unlock(&fs->lock);
@@ -1691,12 +2244,14 @@ static int littlefs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call LFS to do the mkdir */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_MKDIR);
   if (ret < 0)
     {
       goto errout;
     }
 
+  littlefs_closed_flush(fs);
+
   ret = littlefs_convert_result(lfs_mkdir(&fs->lfs, path));
   if (ret >= 0)
     {
@@ -1777,12 +2332,14 @@ static int littlefs_rename(FAR struct inode *mountpt,
 
   /* Call LFS to do the rename */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_RENAME);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   oldrelpath = littlefs_convert_path(oldrelpath);
   newrelpath = littlefs_convert_path(newrelpath);
   ret = littlefs_convert_result(lfs_rename(&fs->lfs, oldrelpath,
@@ -1815,7 +2372,7 @@ static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the LFS to do the stat operation */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_STAT);
   if (ret < 0)
     {
       return ret;
@@ -1886,12 +2443,14 @@ static int littlefs_chstat(FAR struct inode *mountpt,
 
   /* Call LFS to get file size */
 
-  ret = nxmutex_lock(&fs->lock);
+  ret = littlefs_lock(fs, LITTLEFS_OP_CHSTAT);
   if (ret < 0)
     {
       return ret;
     }
 
+  littlefs_closed_flush(fs);
+
   relpath = littlefs_convert_path(relpath);
   ret = littlefs_convert_result(lfs_getattr(&fs->lfs, relpath, 0,
                                             &attr, sizeof(attr)));
@@ -1947,3 +2506,139 @@ errout:
   return ret;
 }
 #endif
+
+#ifdef CONFIG_FS_LITTLEFS_STATS
+
+/****************************************************************************
+ * Name: littlefs_procfs_open
+ ****************************************************************************/
+
+static int littlefs_procfs_open(FAR struct file *filep,
+                                FAR const char *relpath,
+                                int oflags, mode_t mode)
+{
+  FAR struct procfs_file_s *priv;
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  priv = fs_heap_zalloc(sizeof(struct procfs_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_close
+ ****************************************************************************/
+
+static int littlefs_procfs_close(FAR struct file *filep)
+{
+  fs_heap_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_read
+ *
+ * Description:
+ *   Show, for every mount and every kind of operation that has been used,
+ *   the number of operations, of flash reads, of bytes read from flash and
+ *   of reads served by the metadata cache.
+ *
+ ****************************************************************************/
+
+static ssize_t littlefs_procfs_read(FAR struct file *filep,
+                                    FAR char *buffer, size_t buflen)
+{
+  FAR struct littlefs_mountpt_s *fs;
+  FAR struct littlefs_stats_s *stats;
+  FAR sq_entry_t *node;
+  char line[LITTLEFS_LINELEN];
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  int op;
+
+  offset    = filep->f_pos;
+  linesize  = procfs_snprintf(line, LITTLEFS_LINELEN,
+                              "%-12s %-8s %10s %10s %12s %10s\n",
+                              "DEVICE", "OP", "CALLS", "READS", "BYTES",
+                              "HITS");
+  totalsize = procfs_memcpy(line, linesize, buffer, buflen, &offset);
+
+  nxmutex_lock(&g_littlefs_mountlock);
+  sq_for_every(&g_littlefs_mounts, node)
+    {
+      fs = container_of(node, struct littlefs_mountpt_s, node);
+      for (op = 0; op < LITTLEFS_NOPS && totalsize < buflen; op++)
+        {
+          stats = &fs->stats[op];
+          if (stats->calls == 0 && stats->reads == 0)
+            {
+              continue;
+            }
+
+          linesize   = procfs_snprintf(line, LITTLEFS_LINELEN,
+                                       "%-12s %-8s %10" PRIu32
+                                       " %10" PRIu32 " %12" PRIu64
+                                       " %10" PRIu32 "\n",
+                                       fs->drv->i_name,
+                                       g_littlefs_opnames[op],
+                                       stats->calls, stats->reads,
+                                       stats->bytes, stats->hits);
+          totalsize += procfs_memcpy(line, linesize, buffer + totalsize,
+                                     buflen - totalsize, &offset);
+        }
+    }
+
+  nxmutex_unlock(&g_littlefs_mountlock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_dup
+ ****************************************************************************/
+
+static int littlefs_procfs_dup(FAR const struct file *oldp,
+                               FAR struct file *newp)
+{
+  FAR struct procfs_file_s *priv;
+
+  priv = fs_heap_malloc(sizeof(struct procfs_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(priv, oldp->f_priv, sizeof(struct procfs_file_s));
+  newp->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_stat
+ ****************************************************************************/
+
+static int littlefs_procfs_stat(FAR const char *relpath,
+                                FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_LITTLEFS_STATS */
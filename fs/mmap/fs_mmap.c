@@ -38,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 
 #include "inode/inode.h"
+#include "vfs/vfs.h"
 #include "fs_rammap.h"
 
 /****************************************************************************
@@ -61,7 +62,9 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
 
   struct mm_map_entry_s entry =
     {
-     NULL,     /* sq_entry_t */
+     {
+       { NULL }
+     },        /* node */
      start,
      length,
      offset,
@@ -158,6 +161,14 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
   if (filep->f_inode &&
       filep->f_inode->u.i_ops->mmap != NULL)
     {
+      /* A direct mapping bypasses the page cache, so write it back */
+
+      ret = pagecache_sync(filep);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
       ret = filep->f_inode->u.i_ops->mmap(filep, &entry);
     }
 
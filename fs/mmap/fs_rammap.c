@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 
 #include <assert.h>
 #include <debug.h>
@@ -37,12 +38,40 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
 #include <nuttx/sched.h>
 
 #include "fs_rammap.h"
+#include "inode/inode.h"
 #include "sched/sched.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One file region shared by the read-only mappings of rammap_shared() */
+
+struct rammap_region_s
+{
+  struct list_node node;        /* Link in g_rammap_regions */
+  FAR struct inode *inode;      /* The mountpoint, held against unmount */
+  uint64_t key;                 /* Identifies the file in the mountpoint */
+  off_t offset;                 /* File offset of the region */
+  size_t length;                /* Length of the region */
+  FAR uint8_t *vaddr;           /* The file data */
+  unsigned int refs;            /* Number of mappings of the region */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct list_node g_rammap_regions =
+  LIST_INITIAL_VALUE(g_rammap_regions);
+static mutex_t g_rammap_lock = NXMUTEX_INITIALIZER;
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -205,6 +234,135 @@ static int unmap_rammap(FAR struct task_group_s *group,
   return ret;
 }
 
+/****************************************************************************
+ * Name: rammap_release
+ *
+ * Description:
+ *   Drop a reference to a shared region, freeing it with the last one.
+ *   The caller holds g_rammap_lock.
+ *
+ ****************************************************************************/
+
+static void rammap_release(FAR struct rammap_region_s *region)
+{
+  if (--region->refs == 0)
+    {
+      list_delete(&region->node);
+      inode_release(region->inode);
+      kumm_free(region->vaddr);
+      fs_heap_free(region);
+    }
+}
+
+/****************************************************************************
+ * Name: unmap_shared
+ ****************************************************************************/
+
+static int unmap_shared(FAR struct task_group_s *group,
+                        FAR struct mm_map_entry_s *entry,
+                        FAR void *start,
+                        size_t length)
+{
+  FAR struct rammap_region_s *region = entry->priv.p;
+  off_t offset;
+
+  /* As with unmap_rammap(), the mapping can only be cut back from the
+   * end.  The region itself stays whole until its last mapping is gone.
+   */
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  if (offset > 0)
+    {
+      entry->length = offset;
+      return OK;
+    }
+
+  nxmutex_lock(&g_rammap_lock);
+  rammap_release(region);
+  nxmutex_unlock(&g_rammap_lock);
+
+  return mm_map_remove(get_group_mm(group), entry);
+}
+
+/****************************************************************************
+ * Name: rammap_read
+ *
+ * Description:
+ *   Read the file data at entry->offset into 'rdbuffer', zero filling past
+ *   the end of the file.
+ *
+ ****************************************************************************/
+
+static int rammap_read(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *entry,
+                       FAR uint8_t *rdbuffer)
+{
+  size_t length = entry->length;
+  ssize_t nread;
+  off_t fpos;
+
+  /* Seek to the specified file offset */
+
+  fpos = file_seek(filep, entry->offset, SEEK_SET);
+  if (fpos < 0)
+    {
+      /* Seek failed... errno has already been set, but EINVAL is probably
+       * the correct response.
+       */
+
+      ferr("ERROR: Seek to position %zu failed\n", (size_t)entry->offset);
+      return fpos;
+    }
+
+  /* Read the file data into the memory region */
+
+  while (length > 0)
+    {
+      nread = file_read(filep, rdbuffer, length);
+      if (nread < 0)
+        {
+          /* Handle the special case where the read was interrupted by a
+           * signal.
+           */
+
+          if (nread != -EINTR)
+            {
+              /* All other read errors are bad. */
+
+              ferr("ERROR: Read failed: offset=%zu ret=%zd\n",
+                   (size_t)entry->offset, nread);
+
+              return nread;
+            }
+
+          continue;
+        }
+
+      /* Check for end of file. */
+
+      if (nread == 0)
+        {
+          break;
+        }
+
+      /* Increment number of bytes read */
+
+      rdbuffer += nread;
+      length   -= nread;
+    }
+
+  /* Zero any memory beyond the amount read from the file */
+
+  memset(rdbuffer, 0, length);
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -238,8 +396,6 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
            enum mm_map_type_e type)
 {
   FAR uint8_t *rdbuffer;
-  ssize_t nread;
-  off_t fpos;
   int ret;
   size_t length = entry->length;
 
@@ -275,60 +431,12 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
 
   entry->vaddr = rdbuffer; /* save the buffer firstly */
 
-  /* Seek to the specified file offset */
-
-  fpos = file_seek(filep, entry->offset, SEEK_SET);
-  if (fpos < 0)
+  ret = rammap_read(filep, entry, rdbuffer);
+  if (ret < 0)
     {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %zu failed\n", (size_t)entry->offset);
-      ret = fpos;
       goto errout_with_region;
     }
 
-  /* Read the file data into the memory region */
-
-  while (length > 0)
-    {
-      nread = file_read(filep, rdbuffer, length);
-      if (nread < 0)
-        {
-          /* Handle the special case where the read was interrupted by a
-           * signal.
-           */
-
-          if (nread != -EINTR)
-            {
-              /* All other read errors are bad. */
-
-              ferr("ERROR: Read failed: offset=%zu ret=%zd\n",
-                   (size_t)entry->offset, nread);
-
-              ret = nread;
-              goto errout_with_region;
-            }
-        }
-
-      /* Check for end of file. */
-
-      if (nread == 0)
-        {
-          break;
-        }
-
-      /* Increment number of bytes read */
-
-      rdbuffer += nread;
-      length   -= nread;
-    }
-
-  /* Zero any memory beyond the amount read from the file */
-
-  memset(rdbuffer, 0, length);
-
   /* Add the buffer to the list of regions */
 
 out:
@@ -357,3 +465,115 @@ errout_with_region:
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: rammap_shared
+ *
+ * Description:
+ *   Like rammap(), but lets all of the read-only mappings of a file share
+ *   one copy of its data.  This is meant for file systems that must
+ *   decompress their files to map them (cromfs, zipfs):  each region is
+ *   decompressed once, when it is first mapped, and stays in memory until
+ *   it is no longer mapped by anyone.
+ *
+ *   Writable mappings are not shared;  -ENOTTY sends them to rammap().
+ *
+ * Input Parameters:
+ *   filep   file descriptor of the backing file -- required.
+ *   entry   mmap entry information.
+ *           field offset and length must be initialized correctly.
+ *   key     identifies the file inside of its mountpoint, e.g. the offset
+ *           of the file node in the file system image.
+ *
+ * Returned Value:
+ *   On success, rammap_shared returns 0 and entry->vaddr points to memory
+ *   mapped.  Otherwise a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int rammap_shared(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
+                  uint64_t key)
+{
+  FAR struct rammap_region_s *region;
+  int ret;
+
+  if ((entry->prot & PROT_WRITE) != 0)
+    {
+      return -ENOTTY;
+    }
+
+  ret = nxmutex_lock(&g_rammap_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Is the range already mapped? */
+
+  list_for_every_entry(&g_rammap_regions, region, struct rammap_region_s,
+                       node)
+    {
+      if (region->inode == filep->f_inode && region->key == key &&
+          region->offset <= entry->offset &&
+          entry->offset - region->offset + entry->length <= region->length)
+        {
+          region->refs++;
+          goto out;
+        }
+    }
+
+  /* No.. read it in */
+
+  region = fs_heap_zalloc(sizeof(struct rammap_region_s));
+  if (region == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  region->vaddr = kumm_malloc(entry->length);
+  if (region->vaddr == NULL)
+    {
+      ferr("ERROR: Region allocation failed, length: %zu\n",
+           entry->length);
+      ret = -ENOMEM;
+      goto errout_with_region;
+    }
+
+  ret = rammap_read(filep, entry, region->vaddr);
+  if (ret < 0)
+    {
+      goto errout_with_vaddr;
+    }
+
+  inode_addref(filep->f_inode);
+  region->inode  = filep->f_inode;
+  region->key    = key;
+  region->offset = entry->offset;
+  region->length = entry->length;
+  region->refs   = 1;
+  list_add_head(&g_rammap_regions, &region->node);
+
+out:
+  entry->vaddr  = region->vaddr + (entry->offset - region->offset);
+  entry->priv.p = region;
+  entry->munmap = unmap_shared;
+  entry->msync  = NULL;
+
+  ret = mm_map_add(get_current_mm(), entry);
+  if (ret < 0)
+    {
+      rammap_release(region);
+    }
+
+  nxmutex_unlock(&g_rammap_lock);
+  return ret;
+
+errout_with_vaddr:
+  kumm_free(region->vaddr);
+errout_with_region:
+  fs_heap_free(region);
+errout_with_lock:
+  nxmutex_unlock(&g_rammap_lock);
+  return ret;
+}
@@ -99,8 +99,23 @@ enum mm_map_type_e
 
 int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
            enum mm_map_type_e type);
+
+/****************************************************************************
+ * Name: rammap_shared
+ *
+ * Description:
+ *   Like rammap(), but all of the read-only mappings of the file identified
+ *   by 'key' in the mountpoint of 'filep' share one copy of its data.  The
+ *   copy is made on the first mapping and freed on the last unmapping.
+ *   -ENOTTY is returned for writable mappings, which need a private copy.
+ *
+ ****************************************************************************/
+
+int rammap_shared(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
+                  uint64_t key);
 #else
 #  define rammap(file, entry, type) (-ENOSYS)
+#  define rammap_shared(file, entry, key) (-ENOTTY)
 #endif /* CONFIG_FS_RAMMAP */
 
 #endif /* __FS_MMAP_FS_RAMMAP_H */
@@ -162,6 +162,11 @@ static int     mnemofs_rename(FAR struct inode *mountpt,
 static int     mnemofs_stat(FAR struct inode *mountpt,
                             FAR const char *relpath, FAR struct stat *buf);
 
+#ifdef MFS_COMMIT_DEFER
+static void    mnemofs_commit_work(FAR void *arg);
+#endif
+static int     mnemofs_commit(FAR struct mfs_sb_s *sb);
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -218,6 +223,79 @@ const struct mountpt_operations g_mnemofs_operations =
  * Private Functions
  ****************************************************************************/
 
+#ifdef MFS_COMMIT_DEFER
+
+/****************************************************************************
+ * Name: mnemofs_commit_work
+ *
+ * Description:
+ *   Flush the changes gathered in the LRU since the commit was requested.
+ *
+ * Input Parameters:
+ *   arg - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+static void mnemofs_commit_work(FAR void *arg)
+{
+  FAR struct mfs_sb_s *sb = arg;
+  int                  ret;
+
+  ret = nxmutex_lock(&MFS_LOCK(sb));
+  if (predict_false(ret < 0))
+    {
+      return;
+    }
+
+  ret = mnemofs_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      MFS_LOG("COMMIT", "Deferred commit failed with %d.", ret);
+    }
+
+  nxmutex_unlock(&MFS_LOCK(sb));
+}
+
+#endif /* MFS_COMMIT_DEFER */
+
+/****************************************************************************
+ * Name: mnemofs_commit
+ *
+ * Description:
+ *   Commit the changes in the LRU to the flash. With a commit latency, the
+ *   flush is deferred so that the changes to all files made in the
+ *   meantime reach the flash, and the journal, together. Sync still
+ *   flushes right away.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ * Assumptions/Limitations:
+ *   This assumes a locked environment when called.
+ *
+ ****************************************************************************/
+
+static int mnemofs_commit(FAR struct mfs_sb_s *sb)
+{
+#ifdef MFS_COMMIT_DEFER
+  if (!mfs_lru_isempty(sb) && work_available(&sb->commit_work))
+    {
+      /* The first change after a commit starts the latency bound. */
+
+      return work_queue(LPWORK, &sb->commit_work, mnemofs_commit_work, sb,
+                        MSEC2TICK(CONFIG_MNEMOFS_COMMIT_LATENCY));
+    }
+
+  return OK;
+#else
+  return mnemofs_flush(sb);
+#endif
+}
+
 /****************************************************************************
  * Name: mnemofs_open
  *
@@ -557,7 +635,7 @@ static int mnemofs_close(FAR struct file *filep)
     {
       MFS_EXTRA_LOG("CLOSE", "Reference Counter is 0.");
 
-      ret = mnemofs_flush(sb);
+      ret = mnemofs_commit(sb);
       if (predict_false(ret < 0))
         {
           MFS_LOG("CLOSE", "Could not flush file system.");
@@ -783,6 +861,15 @@ static ssize_t mnemofs_write(FAR struct file *filep, FAR const char *buffer,
   f->com->sz   = MAX(f->com->sz, f->com->off);
   ret          = buflen;
 
+  MFS_WRSTAT(sb).lwr++;
+  MFS_WRSTAT(sb).lwr_bytes += buflen;
+
+#ifdef MFS_COMMIT_DEFER
+  /* Bound the time the data of a file kept open stays in RAM. */
+
+  mnemofs_commit(sb);
+#endif
+
   MFS_EXTRA_LOG("WRITE", "Updated file offset and size.");
   MFS_EXTRA_LOG_F(f);
 
@@ -1992,6 +2079,19 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("UNBIND", "Driver %p.", driver);
 
+#ifdef MFS_COMMIT_DEFER
+  work_cancel_sync(LPWORK, &sb->commit_work);
+#endif
+
+  /* Commit what the LRU still holds. */
+
+  mnemofs_flush(sb);
+
+  MFS_LOG("UNBIND", "%" PRIu64 " pages written for %" PRIu64
+          " logical writes of %" PRIu64 " bytes in %" PRIu64 " commits.",
+          MFS_WRSTAT(sb).pg_wr, MFS_WRSTAT(sb).lwr, MFS_WRSTAT(sb).lwr_bytes,
+          MFS_WRSTAT(sb).commits);
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
@@ -2633,6 +2733,11 @@ int mnemofs_flush(FAR struct mfs_sb_s *sb)
 
   finfo("Flush operation started.");
 
+  if (!mfs_lru_isempty(sb))
+    {
+      MFS_WRSTAT(sb).commits++;
+    }
+
   for (; ; )
     {
       change = false;
@@ -2670,6 +2775,9 @@ int mnemofs_flush(FAR struct mfs_sb_s *sb)
       finfo("Finished Iteration.");
     }
 
+  finfo("Flush done, %" PRIu64 " pages written for %" PRIu64
+        " logical writes so far.", MFS_WRSTAT(sb).pg_wr, MFS_WRSTAT(sb).lwr);
+
 errout:
   return ret;
 }
@@ -61,6 +61,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -90,6 +91,7 @@
 #define MFS_NBLKS(sb)              ((sb)->n_blks)
 #define MFS_OFILES(sb)             ((sb)->of)
 #define MFS_FLUSH(sb)              ((sb)->flush)
+#define MFS_WRSTAT(sb)             ((sb)->wrstat)
 #define MFS_NPGS(sb)               (MFS_NBLKS(sb) * MFS_PGINBLK(sb))
 
 #define MFS_HASHSZ                 16
@@ -108,6 +110,15 @@
 #endif
 #define MFS_STRLITCMP(a, lit)      strncmp(a, lit, strlen(lit))
 
+/* Commits are deferred, and grouped across files, for up to
+ * CONFIG_MNEMOFS_COMMIT_LATENCY milliseconds.
+ */
+
+#if defined(CONFIG_MNEMOFS_COMMIT_LATENCY) && \
+    CONFIG_MNEMOFS_COMMIT_LATENCY > 0
+#  define MFS_COMMIT_DEFER
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -187,6 +198,16 @@ struct mfs_jrnl_state_s
   uint16_t n_blks;        /* TODO: Does not include the master node. */
 };
 
+/* Write amplification counters */
+
+struct mfs_wrstat_s
+{
+  uint64_t lwr;          /* Logical writes */
+  uint64_t lwr_bytes;    /* Bytes of the logical writes */
+  uint64_t pg_wr;        /* Flash pages written */
+  uint64_t commits;      /* Flushes of the LRU to the flash */
+};
+
 struct mfs_sb_s
 {
   FAR uint8_t             *rw_buf;
@@ -207,6 +228,12 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+  mfs_t                   lru_nnodes;    /* LRU node limit */
+  mfs_t                   lru_ndeltas;   /* LRU delta limit per node */
+#ifdef MFS_COMMIT_DEFER
+  struct work_s           commit_work;   /* Deferred commit */
+#endif
+  struct mfs_wrstat_s     wrstat;        /* Write amplification counters */
 };
 
 /* This is for *dir VFS methods. */
@@ -963,7 +990,7 @@ int mfs_markbadblk(FAR const struct mfs_sb_s * const sb, mfs_t blk);
  *
  ****************************************************************************/
 
-ssize_t mfs_write_page(FAR const struct mfs_sb_s * const sb,
+ssize_t mfs_write_page(FAR struct mfs_sb_s * const sb,
                        FAR const char *data, const mfs_t datalen,
                        const off_t page, const mfs_t pgoff);
 
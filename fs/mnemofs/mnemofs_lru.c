@@ -226,7 +226,7 @@ static void lru_nodesearch(FAR const struct mfs_sb_s * const sb,
 
 static bool lru_islrufull(FAR struct mfs_sb_s * const sb)
 {
-  return !MFS_FLUSH(sb) && list_length(&MFS_LRU(sb)) == CONFIG_MNEMOFS_NLRU;
+  return !MFS_FLUSH(sb) && list_length(&MFS_LRU(sb)) >= sb->lru_nnodes;
 }
 
 /****************************************************************************
@@ -251,7 +251,7 @@ static bool lru_islrufull(FAR struct mfs_sb_s * const sb)
 static bool lru_isnodefull(FAR struct mfs_sb_s * const sb,
                            FAR struct mfs_node_s *node)
 {
-  return !MFS_FLUSH(sb) && node->n_list == CONFIG_MNEMOFS_NLRUDELTA;
+  return !MFS_FLUSH(sb) && node->n_list >= sb->lru_ndeltas;
 }
 
 /****************************************************************************
@@ -853,9 +853,33 @@ int mfs_lru_wr(FAR struct mfs_sb_s * const sb, const mfs_t data_off,
 
 void mfs_lru_init(FAR struct mfs_sb_s * const sb)
 {
+#ifdef CONFIG_MNEMOFS_LRU_ADAPTIVE
+  struct mallinfo info;
+  size_t          budget;
+  size_t          ndeltas;
+#endif
+
   list_initialize(&MFS_LRU(sb));
 
-  finfo("LRU Initialized\n");
+  sb->lru_nnodes  = CONFIG_MNEMOFS_NLRU;
+  sb->lru_ndeltas = CONFIG_MNEMOFS_NLRUDELTA;
+
+#ifdef CONFIG_MNEMOFS_LRU_ADAPTIVE
+  /* Let every node hold about a page per delta, from the given share of
+   * the free heap. A full node flushes the whole LRU, so it is the delta
+   * limit that sets how often the flash is written.
+   */
+
+  info    = fs_heap_mallinfo();
+  budget  = (size_t)info.fordblks / 100 * CONFIG_MNEMOFS_LRU_RAM_PERCENT;
+  ndeltas = budget / (CONFIG_MNEMOFS_NLRU *
+                      (sizeof(struct mfs_delta_s) + MFS_PGSZ(sb)));
+
+  sb->lru_ndeltas = MAX(sb->lru_ndeltas, MIN(ndeltas, UINT16_MAX));
+#endif
+
+  finfo("LRU Initialized with %" PRIu32 " nodes of %" PRIu32 " deltas.\n",
+        sb->lru_nnodes, sb->lru_ndeltas);
 }
 
 int mfs_lru_rdfromoff(FAR const struct mfs_sb_s * const sb,
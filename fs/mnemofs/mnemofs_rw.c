@@ -110,7 +110,7 @@ int mfs_markbadblk(FAR const struct mfs_sb_s * const sb, mfs_t blk)
  * they enforce it.
  */
 
-ssize_t mfs_write_page(FAR const struct mfs_sb_s * const sb,
+ssize_t mfs_write_page(FAR struct mfs_sb_s * const sb,
                        FAR const char *data, const mfs_t datalen,
                        const off_t page, const mfs_t pgoff)
 {
@@ -129,6 +129,8 @@ ssize_t mfs_write_page(FAR const struct mfs_sb_s * const sb,
       goto errout_with_reset;
     }
 
+  MFS_WRSTAT(sb).pg_wr++;
+
 errout_with_reset:
   memset(MFS_RWBUF(sb), 0, MFS_PGSZ(sb));
 
@@ -65,6 +65,12 @@ FAR const char *fs_gettype(FAR struct statfs *statbuf)
         break;
 #endif
 
+#ifdef CONFIG_FS_EXFAT
+      case EXFAT_SUPER_MAGIC:
+        fstype = "exfat";
+        break;
+#endif
+
 #ifdef CONFIG_FS_ROMFS
       case ROMFS_MAGIC:
         fstype = "romfs";
@@ -54,7 +54,8 @@
  */
 
 #if defined(CONFIG_FS_FAT) || defined(CONFIG_FS_ROMFS) || \
-    defined(CONFIG_FS_SMARTFS) || defined(CONFIG_FS_LITTLEFS)
+    defined(CONFIG_FS_SMARTFS) || defined(CONFIG_FS_LITTLEFS) || \
+    defined(CONFIG_FS_EXFAT)
 #  define BDFS_SUPPORT 1
 #endif
 
@@ -96,6 +97,9 @@ struct fsmap_t
 #ifdef CONFIG_FS_FAT
 extern const struct mountpt_operations g_fat_operations;
 #endif
+#ifdef CONFIG_FS_EXFAT
+extern const struct mountpt_operations g_exfat_operations;
+#endif
 #ifdef CONFIG_FS_ROMFS
 extern const struct mountpt_operations g_romfs_operations;
 #endif
@@ -111,6 +115,9 @@ static const struct fsmap_t g_bdfsmap[] =
 #ifdef CONFIG_FS_FAT
     { "vfat", &g_fat_operations },
 #endif
+#ifdef CONFIG_FS_EXFAT
+    { "exfat", &g_exfat_operations },
+#endif
 #ifdef CONFIG_FS_ROMFS
     { "romfs", &g_romfs_operations },
 #endif
@@ -127,10 +127,13 @@ int nx_umount2(FAR const char *target, unsigned int flags)
       goto errout_with_lock;
     }
 
-  /* Successfully unbound.  Convert the mountpoint inode to regular
-   * pseudo-file inode.
+  /* Successfully unbound, so there are no open files left.  Forget their
+   * cached pages and convert the mountpoint inode to regular pseudo-file
+   * inode.
    */
 
+  pagecache_unmount(mountpt_inode);
+
   mountpt_inode->i_flags  &= ~FSNODEFLAG_TYPE_MASK;
   mountpt_inode->i_private = NULL;
   mountpt_inode->u.i_mops  = NULL;
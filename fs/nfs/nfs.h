@@ -78,6 +78,10 @@
 #  define nfs_statistics(n)
 #endif
 
+#if CONFIG_NFS_ATTRCACHE_NENTRIES == 0
+#  define nfs_attrcache_flush(nmp)
+#endif
+
 /****************************************************************************
  *  Public Data
  ****************************************************************************/
@@ -113,6 +117,7 @@ extern "C"
 EXTERN int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *request, size_t reqlen,
                 FAR void *response, size_t resplen);
+EXTERN int nfs_checkreply(FAR void *response);
 EXTERN int  nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
               FAR struct file_handle *fhandle,
               FAR struct nfs_fattr *obj_attributes,
@@ -126,6 +131,14 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+EXTERN void nfs_attrcache_add(FAR struct nfsmount *nmp,
+              FAR const char *dirpath, FAR const char *name,
+              FAR const struct file_handle *fhandle,
+              FAR const struct nfs_fattr *obj_attributes,
+              FAR const struct nfs_fattr *dir_attributes);
+EXTERN void nfs_attrcache_flush(FAR struct nfsmount *nmp);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
@@ -50,6 +50,8 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <sys/types.h>
+#include <stdbool.h>
 #include <nuttx/mutex.h>
 
 #include "rpc.h"
@@ -58,10 +60,38 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NFS_ATTRCACHE_NENTRIES
+#  define CONFIG_NFS_ATTRCACHE_NENTRIES 0
+#endif
+
+#ifndef CONFIG_NFS_ATTRCACHE_TIMEOUT
+#  define CONFIG_NFS_ATTRCACHE_TIMEOUT 3000
+#endif
+
+#ifndef CONFIG_NFS_MAXOUTSTANDING
+#  define CONFIG_NFS_MAXOUTSTANDING 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One cached path lookup.  The cache saves the LOOKUP round trips of
+ * nfs_findnode() for recently used paths.
+ */
+
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+struct nfs_attrcache_s
+{
+  FAR char                 *ac_path;          /* Path in the mount */
+  clock_t                   ac_expiry;        /* Stale from this tick on */
+  bool                      ac_hasdir;        /* ac_dirattrs is valid */
+  struct file_handle        ac_fhandle;       /* File handle of the object */
+  struct nfs_fattr          ac_attrs;         /* Attributes of the object */
+  struct nfs_fattr          ac_dirattrs;      /* Of its directory */
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -80,6 +110,13 @@ struct nfsmount
   uint16_t                  nm_wsize;         /* Max size of write RPC */
   uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
   uint16_t                  nm_buflen;        /* Size of I/O buffer */
+#ifdef CONFIG_NFS_READDIRPLUS
+  bool                      nm_readdirplus;   /* READDIRPLUS works */
+#endif
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  uint8_t                   nm_acnext;        /* Next entry to evict */
+  struct nfs_attrcache_s    nm_attrcache[CONFIG_NFS_ATTRCACHE_NENTRIES];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.
    * NOTE that for the case of the write call message, it is the reply
@@ -96,6 +133,7 @@ struct nfsmount
     struct rpc_call_mkdir   mkdir;
     struct rpc_call_rmdir   rmdir;
     struct rpc_call_readdir readdir;
+    struct rpc_call_readdirplus readdirplus;
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fsinfo;
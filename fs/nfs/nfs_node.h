@@ -71,6 +71,11 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_READAHEAD
+  FAR uint8_t        *n_rabuf;      /* Read-ahead buffer of nm_rsize bytes */
+  uint64_t            n_raoffset;   /* File offset of the buffered data */
+  uint16_t            n_ralen;      /* Bytes of valid data in n_rabuf */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
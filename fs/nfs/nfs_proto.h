@@ -526,6 +526,15 @@ struct READDIR3args
   uint32_t           count;
 };
 
+struct READDIRPLUS3args
+{
+  struct file_handle dir;                           /* Variable length */
+  nfsuint64          cookie;
+  uint8_t            cookieverf[NFSX_V3COOKIEVERF];
+  uint32_t           dircount;
+  uint32_t           maxcount;
+};
+
 /* The READDIR reply is variable length and consists of multiple entries,
  *  each of form:
  *
@@ -536,6 +545,14 @@ struct READDIR3args
  *  Name string (variable size but in multiples of 4 bytes)
  *  Cookie (8 bytes)
  *  next entry (4 bytes)
+ *
+ * The READDIRPLUS reply has the same header, its entries carry the
+ * attributes and file handle of the object after the cookie:
+ *
+ *  Attributes follow (4 bytes)
+ *  Attributes (sizeof(struct nfs_fattr), if they follow)
+ *  Handle follows (4 bytes)
+ *  Handle length (4 bytes) and handle (multiples of 4 bytes, if follows)
  */
 
 struct READDIR3resok
@@ -31,6 +31,7 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
@@ -38,6 +39,9 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
+#include "fs_heap.h"
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -101,6 +105,36 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_attrcache_find
+ *
+ * Description:
+ *   Return the unexpired attribute cache entry of a path, if any.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+static FAR struct nfs_attrcache_s *
+nfs_attrcache_find(FAR struct nfsmount *nmp, FAR const char *relpath)
+{
+  FAR struct nfs_attrcache_s *ac;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      ac = &nmp->nm_attrcache[i];
+      if (ac->ac_path != NULL && (sclock_t)(ac->ac_expiry - now) > 0 &&
+          strcmp(ac->ac_path, relpath) == 0)
+        {
+          return ac;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,7 +156,6 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
                 FAR void *response, size_t resplen)
 {
   FAR struct rpcclnt *clnt = nmp->nm_rpcclnt;
-  struct nfs_reply_header replyh;
   int error;
 
   error = rpcclnt_request(clnt, procnum, NFS_PROG, NFS_VER3,
@@ -158,6 +191,25 @@ int nfs_request(FAR struct nfsmount *nmp, int procnum,
         }
     }
 
+  return nfs_checkreply(response);
+}
+
+/****************************************************************************
+ * Name: nfs_checkreply
+ *
+ * Description:
+ *   Check the NFS status of a reply that passed the RPC level checks.
+ *
+ * Returned Value:
+ *   Zero on success; a negative errno value on failure.
+ *
+ ****************************************************************************/
+
+int nfs_checkreply(FAR void *response)
+{
+  struct nfs_reply_header replyh;
+  int error;
+
   memcpy(&replyh, response, sizeof(struct nfs_reply_header));
 
   if (replyh.nfs_status != 0)
@@ -324,6 +376,9 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
   char            terminator;
   uint32_t         tmp;
   int             error;
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  FAR struct nfs_attrcache_s *ac;
+#endif
 
   /* Start with the file handle of the root directory.  */
 
@@ -351,6 +406,29 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
       return OK;
     }
 
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  /* Try the attribute cache before walking the path on the server */
+
+  ac = nfs_attrcache_find(nmp, relpath);
+  if (ac != NULL && (dir_attributes == NULL || ac->ac_hasdir))
+    {
+      memcpy(fhandle, &ac->ac_fhandle, sizeof(struct file_handle));
+
+      if (obj_attributes)
+        {
+          memcpy(obj_attributes, &ac->ac_attrs, sizeof(struct nfs_fattr));
+        }
+
+      if (dir_attributes)
+        {
+          memcpy(dir_attributes, &ac->ac_dirattrs,
+                 sizeof(struct nfs_fattr));
+        }
+
+      return OK;
+    }
+#endif
+
   /* This is not the root directory. Loop until the directory entry
    * corresponding to the path is found.
    */
@@ -392,6 +470,14 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
            * dir_attributes.
            */
 
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+          if (obj_attributes)
+            {
+              nfs_attrcache_add(nmp, relpath, NULL, fhandle,
+                                obj_attributes, dir_attributes);
+            }
+#endif
+
           return OK;
         }
 
@@ -528,3 +614,127 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
 }
+
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+/****************************************************************************
+ * Name: nfs_attrcache_add
+ *
+ * Description:
+ *   Remember the file handle and attributes of the object at dirpath/name
+ *   (or dirpath alone if name is NULL) for CONFIG_NFS_ATTRCACHE_TIMEOUT
+ *   milliseconds.  dir_attributes may be NULL.
+ *
+ * Returned Value:
+ *   None.  The entry is silently dropped if no memory is available.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_add(FAR struct nfsmount *nmp, FAR const char *dirpath,
+                       FAR const char *name,
+                       FAR const struct file_handle *fhandle,
+                       FAR const struct nfs_fattr *obj_attributes,
+                       FAR const struct nfs_fattr *dir_attributes)
+{
+  FAR struct nfs_attrcache_s *ac = NULL;
+  FAR char *path;
+  clock_t now = clock_systime_ticks();
+  size_t dirlen;
+  size_t len;
+  int i;
+
+  /* Build the path of the object */
+
+  dirlen = strlen(dirpath);
+  len    = dirlen + 1;
+  if (name != NULL)
+    {
+      len += strlen(name) + 1;
+    }
+
+  path = fs_heap_malloc(len);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  if (name == NULL)
+    {
+      memcpy(path, dirpath, len);
+    }
+  else if (dirlen == 0)
+    {
+      strlcpy(path, name, len);
+    }
+  else
+    {
+      snprintf(path, len, "%s/%s", dirpath, name);
+    }
+
+  /* Reuse the entry of the same path, or else a free or expired entry,
+   * or else the next one in turn.
+   */
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      FAR struct nfs_attrcache_s *curr = &nmp->nm_attrcache[i];
+
+      if (curr->ac_path == NULL || (sclock_t)(curr->ac_expiry - now) <= 0)
+        {
+          if (ac == NULL)
+            {
+              ac = curr;
+            }
+        }
+      else if (strcmp(curr->ac_path, path) == 0)
+        {
+          ac = curr;
+          break;
+        }
+    }
+
+  if (ac == NULL)
+    {
+      ac = &nmp->nm_attrcache[nmp->nm_acnext];
+      if (++nmp->nm_acnext >= CONFIG_NFS_ATTRCACHE_NENTRIES)
+        {
+          nmp->nm_acnext = 0;
+        }
+    }
+
+  fs_heap_free(ac->ac_path);
+
+  ac->ac_path   = path;
+  ac->ac_expiry = now + MSEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT);
+  memcpy(&ac->ac_fhandle, fhandle, sizeof(struct file_handle));
+  memcpy(&ac->ac_attrs, obj_attributes, sizeof(struct nfs_fattr));
+
+  ac->ac_hasdir = dir_attributes != NULL;
+  if (dir_attributes != NULL)
+    {
+      memcpy(&ac->ac_dirattrs, dir_attributes, sizeof(struct nfs_fattr));
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_flush
+ *
+ * Description:
+ *   Forget all cached lookups.  This is called by every operation that
+ *   changes the name space or the attributes of an object on the server.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void nfs_attrcache_flush(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      fs_heap_free(nmp->nm_attrcache[i].ac_path);
+      nmp->nm_attrcache[i].ac_path = NULL;
+    }
+}
+#endif
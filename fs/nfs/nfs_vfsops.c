@@ -105,6 +105,18 @@
  * Private Types
  ****************************************************************************/
 
+/* One READ or WRITE RPC of a pipelined transfer */
+
+#if CONFIG_NFS_MAXOUTSTANDING > 1
+struct nfs_inflight_s
+{
+  uint32_t xid;     /* Transaction id of the call */
+  size_t   offset;  /* Offset in the caller buffer */
+  size_t   len;     /* Requested length */
+  ssize_t  result;  /* Bytes done, -EINPROGRESS or a negated errno */
+};
+#endif
+
 struct nfs_dir_s
 {
   struct fs_dirent_s nfs_base;                /* VFS directory structure */
@@ -112,6 +124,15 @@ struct nfs_dir_s
   uint8_t  nfs_fhandle[DIRENT_NFS_MAXHANDLE]; /* File handle (max size allocated) */
   uint8_t  nfs_verifier[DIRENT_NFS_VERFLEN];  /* Cookie verifier */
   uint32_t nfs_cookie[2];                     /* Cookie */
+  FAR uint32_t *nfs_entries;                  /* Entries of the last reply */
+  uint16_t nfs_nwords;                        /* Valid words in nfs_entries */
+  uint16_t nfs_next;                          /* Word index of next entry */
+#ifdef CONFIG_NFS_READDIRPLUS
+  bool     nfs_plus;                          /* nfs_entries is READDIRPLUS */
+#endif
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  FAR char *nfs_path;                         /* Path of the directory */
+#endif
 };
 
 /****************************************************************************
@@ -336,6 +357,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Send the NFS request. */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_CREATE);
   ret = nfs_request(nmp, NFSPROC_CREATE,
                     &nmp->nm_msgbuffer.create, reqlen,
@@ -503,6 +525,10 @@ static int nfs_filechstat(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Perform the SETATTR RPC */
 
+  nfs_attrcache_flush(nmp);
+#ifdef CONFIG_NFS_READAHEAD
+  np->n_ralen = 0;
+#endif
   nfs_statistics(NFSPROC_SETATTR);
   ret = nfs_request(nmp, NFSPROC_SETATTR,
                     &nmp->nm_msgbuffer.setattr, reqlen,
@@ -850,6 +876,9 @@ static int nfs_close(FAR struct file *filep)
 
               /* Then deallocate the file structure and return success */
 
+#ifdef CONFIG_NFS_READAHEAD
+              fs_heap_free(np->n_rabuf);
+#endif
               fs_heap_free(np);
               ret = OK;
               break;
@@ -863,346 +892,902 @@ static int nfs_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: nfs_read
+ * Name: nfs_readsize
  *
- * Returned Value:
- *   The (non-negative) number of bytes read on success; a negated errno
- *   value on failure.
+ * Description:
+ *   Limit the size of one READ to the RPC maximum and to what fits in the
+ *   I/O buffer.
  *
  ****************************************************************************/
 
-static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+static size_t nfs_readsize(FAR struct nfsmount *nmp, size_t readsize)
 {
-  FAR struct nfsmount       *nmp;
-  FAR struct nfsnode        *np;
-  ssize_t                    readsize;
-  ssize_t                    tmp;
-  ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
-  int                        ret = 0;
-
-  finfo("Read %zu bytes from offset %jd\n",
-        buflen, (intmax_t)filep->f_pos);
-
-  /* Sanity checks */
-
-  DEBUGASSERT(filep->f_priv != NULL);
-
-  /* Recover our private data from the struct file instance */
-
-  nmp = filep->f_inode->i_private;
-  np  = (FAR struct nfsnode *)filep->f_priv;
-
-  DEBUGASSERT(nmp != NULL);
+  size_t tmp;
 
-  ret = nxmutex_lock(&nmp->nm_lock);
-  if (ret < 0)
+  if (readsize > nmp->nm_rsize)
     {
-      return (ssize_t)ret;
+      readsize = nmp->nm_rsize;
     }
 
-  /* Get the number of bytes left in the file and truncate read count so that
-   * it does not exceed the number of bytes left in the file.
-   */
-
-  tmp = np->n_size - filep->f_pos;
-  if (buflen > tmp)
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
     {
-      buflen = tmp;
-      finfo("Read size truncated to %zu\n", buflen);
+      readsize -= (tmp - nmp->nm_buflen);
     }
 
-  /* Now loop until we fill the user buffer (or hit the end of the file) */
-
-  for (bytesread = 0; bytesread < buflen; )
-    {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
-
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
-        {
-          readsize -= (tmp - nmp->nm_buflen);
-        }
-
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
+  return readsize;
+}
 
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
+/****************************************************************************
+ * Name: nfs_fmtread
+ *
+ * Description:
+ *   Format the READ call message of one chunk in nm_msgbuffer.
+ *
+ * Returned Value:
+ *   The length of the call arguments.
+ *
+ ****************************************************************************/
 
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
+static size_t nfs_fmtread(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                          uint64_t offset, size_t readsize)
+{
+  FAR uint32_t *ptr;
+  size_t reqlen;
 
-      /* Copy the file offset */
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
 
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
+  /* Copy the variable length, file handle */
 
-      /* Set the readsize */
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
 
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
 
-      /* Perform the read */
+  /* Copy the file offset */
 
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
-        }
+  txdr_hyper(offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
-       */
+  /* Set the readsize */
 
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+  *ptr    = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
 
-      /* Check if attributes are included in the responses */
+  return reqlen;
+}
 
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
+/****************************************************************************
+ * Name: nfs_parseread
+ *
+ * Description:
+ *   Copy the data of the READ reply in nm_iobuffer to the caller buffer.
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
+static ssize_t nfs_parseread(FAR struct nfsmount *nmp,
+                             FAR struct nfsnode *np, FAR char *buffer,
+                             size_t readsize, FAR bool *eof)
+{
+  FAR uint32_t *ptr;
+  uint32_t tmp;
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
+  /* Get a pointer to the beginning of the NFS response data */
 
-      ptr++;
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
 
-      /* Next comes an EOF indication.  Save that in tmp for now. */
+  /* Check if attributes are included in the responses */
 
-      tmp = *ptr++;
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
 
-      /* Then the length of the read data followed by the read data itself */
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
 
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
 
-      /* Copy the read data into the user buffer */
+  ptr++;
 
-      memcpy(buffer, ptr, readsize);
+  /* Next comes an EOF indication */
 
-      /* Update the read state data */
+  *eof = *ptr++ != 0;
 
-      filep->f_pos += readsize;
-      bytesread    += readsize;
-      buffer       += readsize;
+  /* Then the length of the read data followed by the read data itself */
 
-      /* Check if we hit the end of file */
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
 
-      if (tmp != 0)
-        {
-          break;
-        }
+  if (tmp > readsize)
+    {
+      ferr("ERROR: Server returned %" PRIu32 " bytes\n", tmp);
+      return -EIO;
     }
 
-errout_with_lock:
-  nxmutex_unlock(&nmp->nm_lock);
-  return bytesread > 0 ? bytesread : ret;
+  /* Copy the read data into the user buffer */
+
+  memcpy(buffer, ptr, tmp);
+  return tmp;
 }
 
 /****************************************************************************
- * Name: nfs_write
+ * Name: nfs_readchunk
+ *
+ * Description:
+ *   Read one chunk of the file with a synchronous READ RPC.
  *
  * Returned Value:
- *   The (non-negative) number of bytes written on success; a negated errno
+ *   The (non-negative) number of bytes read on success; a negated errno
  *   value on failure.
  *
  ****************************************************************************/
 
-static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static ssize_t nfs_readchunk(FAR struct nfsmount *nmp,
+                             FAR struct nfsnode *np, uint64_t offset,
+                             FAR char *buffer, size_t readsize,
+                             FAR bool *eof)
 {
-  FAR struct nfsmount *nmp;
-  FAR struct nfsnode  *np;
-  ssize_t              writesize;
-  ssize_t              bufsize;
-  ssize_t              byteswritten = 0;
-  size_t               reqlen;
-  FAR uint32_t        *ptr;
-  uint32_t             tmp;
-  int                  commit = 0;
-  int                  committed = NFSV3WRITE_FILESYNC;
-  int                  ret;
-
-  finfo("Write %zu bytes to offset %jd\n",
-        buflen, (intmax_t)filep->f_pos);
+  size_t reqlen;
+  int ret;
 
-  /* Sanity checks */
+  reqlen = nfs_fmtread(nmp, np, offset, readsize);
 
-  DEBUGASSERT(filep->f_priv != NULL);
+  finfo("Reading %zu bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  ret = nfs_request(nmp, NFSPROC_READ,
+                    &nmp->nm_msgbuffer.read, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
 
-  /* Recover our private data from the struct file instance */
+  return nfs_parseread(nmp, np, buffer, readsize, eof);
+}
 
-  nmp = filep->f_inode->i_private;
-  np  = (FAR struct nfsnode *)filep->f_priv;
+/****************************************************************************
+ * Name: nfs_readahead
+ *
+ * Description:
+ *   Copy what the read-ahead buffer of the node holds at offset.
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero if offset is not buffered.
+ *
+ ****************************************************************************/
 
-  DEBUGASSERT(nmp != NULL);
+#ifdef CONFIG_NFS_READAHEAD
+static size_t nfs_readahead(FAR struct nfsnode *np, uint64_t offset,
+                            FAR char *buffer, size_t buflen)
+{
+  size_t nbytes;
 
-  ret = nxmutex_lock(&nmp->nm_lock);
-  if (ret < 0)
+  if (offset < np->n_raoffset || offset >= np->n_raoffset + np->n_ralen)
     {
-      return (ssize_t)ret;
+      return 0;
     }
 
-  /* Check if the file size would exceed the range of off_t */
-
-  if (np->n_size + buflen < np->n_size)
+  nbytes = np->n_raoffset + np->n_ralen - offset;
+  if (nbytes > buflen)
     {
-      ret = -EFBIG;
-      goto errout_with_lock;
+      nbytes = buflen;
     }
 
-  /* Now loop until we send the entire user buffer */
+  memcpy(buffer, np->n_rabuf + (offset - np->n_raoffset), nbytes);
+  return nbytes;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_readmulti
+ *
+ * Description:
+ *   Read a large request with up to CONFIG_NFS_MAXOUTSTANDING READ RPCs in
+ *   flight on the stream socket, so that the throughput is no longer
+ *   bounded by one chunk per round trip.  The replies may complete in any
+ *   order, the data of each is copied straight to its place in the caller
+ *   buffer.
+ *
+ *   Any failure or short chunk stops the pipeline.  The outstanding
+ *   replies are then drained and only the contiguous prefix that was read
+ *   is reported, the caller completes the rest synchronously.
+ *
+ * Returned Value:
+ *   The number of bytes read from the start of the buffer.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_MAXOUTSTANDING > 1
+static size_t nfs_readmulti(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, uint64_t offset,
+                            FAR char *buffer, size_t buflen)
+{
+  struct nfs_inflight_s slot[CONFIG_NFS_MAXOUTSTANDING];
+  FAR struct nfs_inflight_s *s;
+  unsigned int npending = 0;
+  unsigned int head = 0;
+  unsigned int next = 0;
+  unsigned int i;
+  size_t issued = 0;
+  size_t done = 0;
+  size_t readsize;
+  size_t reqlen;
+  uint32_t xid;
+  bool stop = false;
+  bool hole = false;
+  bool eof;
+  int ret;
 
-  for (byteswritten = 0; byteswritten < buflen; )
+  for (; ; )
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
-       */
+      /* Keep the pipeline full */
 
-      writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
+      while (!stop && issued < buflen &&
+             next - head < CONFIG_NFS_MAXOUTSTANDING)
         {
-          writesize = nmp->nm_wsize;
-        }
+          readsize = nfs_readsize(nmp, buflen - issued);
+          reqlen   = nfs_fmtread(nmp, np, offset + issued, readsize);
+          s        = &slot[next % CONFIG_NFS_MAXOUTSTANDING];
+
+          nfs_statistics(NFSPROC_READ);
+          ret = rpcclnt_sendcall(nmp->nm_rpcclnt, NFSPROC_READ, NFS_PROG,
+                                 NFS_VER3, &nmp->nm_msgbuffer.read, reqlen,
+                                 &s->xid);
+          if (ret < 0)
+            {
+              stop = true;
+              break;
+            }
 
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
+          s->offset = issued;
+          s->len    = readsize;
+          s->result = -EINPROGRESS;
+          issued   += readsize;
+          next++;
+          npending++;
+        }
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+      if (npending == 0)
         {
-          writesize -= (bufsize - nmp->nm_buflen);
+          break;
         }
 
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
+      /* Wait for the next reply, whichever call it belongs to */
 
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
+      ret = rpcclnt_recvreply(nmp->nm_rpcclnt, nmp->nm_iobuffer,
+                              nmp->nm_buflen, &xid);
+      if (ret < 0 && ret != -EOPNOTSUPP)
+        {
+          /* The state of the socket is unknown, give up on the rest */
 
-      /* Perform the write */
+          ferr("ERROR: rpcclnt_recvreply failed: %d\n", ret);
+          break;
+        }
 
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
-      if (ret)
+      for (i = head; i != next; i++)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
+          s = &slot[i % CONFIG_NFS_MAXOUTSTANDING];
+          if (s->xid == xid && s->result == -EINPROGRESS)
+            {
+              break;
+            }
         }
 
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
-
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (i == next)
         {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
+          /* A late reply of an earlier, abandoned call */
 
-          ptr += uint32_increment(sizeof(struct wcc_attr));
+          continue;
         }
 
-      /* Check if normal file attributes follow */
+      npending--;
 
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (ret == OK)
         {
-          /* Yes.. Update the cached file status in the file structure. */
+          ret = nfs_checkreply(nmp->nm_iobuffer);
+        }
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+      if (ret == OK)
+        {
+          ret = nfs_parseread(nmp, np, buffer + s->offset, s->len, &eof);
+          if (ret >= 0 && eof)
+            {
+              stop = true;
+            }
         }
 
-      /* Get the count of bytes actually written */
+      s->result = ret;
 
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
+      /* Retire the completed chunks at the head of the pipeline */
 
-      if (tmp < 1 || tmp > writesize)
+      while (!hole && head != next)
         {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
+          s = &slot[head % CONFIG_NFS_MAXOUTSTANDING];
+          if (s->result == -EINPROGRESS)
+            {
+              break;
+            }
 
-      writesize = tmp;
+          if (s->result > 0)
+            {
+              done += s->result;
+            }
 
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
+          if ((size_t)s->result != s->len)
+            {
+              /* An error or a short read, the rest is not contiguous */
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
+              hole = true;
+              stop = true;
+            }
+
+          head++;
+        }
+    }
+
+  return done;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_fmtwrite
+ *
+ * Description:
+ *   Format the WRITE call message of one chunk in nm_iobuffer.  Write is
+ *   unique among the RPC calls in that the call message lies in the I/O
+ *   buffer.
+ *
+ * Returned Value:
+ *   The length of the call arguments.
+ *
+ ****************************************************************************/
+
+static size_t nfs_fmtwrite(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                           uint64_t offset, FAR const char *buffer,
+                           size_t writesize, int committed)
+{
+  FAR uint32_t *ptr;
+  size_t reqlen;
+
+  /* Here we need an offset pointer to the write arguments, skipping over
+   * the RPC header.
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+              nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper(offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(writesize);
+  *ptr++  = txdr_unsigned(committed);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(writesize);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, writesize);
+  reqlen += uint32_alignup(writesize);
+
+  return reqlen;
+}
+
+/****************************************************************************
+ * Name: nfs_parsewrite
+ *
+ * Description:
+ *   Parse the WRITE reply in nm_msgbuffer.
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_parsewrite(FAR struct nfsmount *nmp,
+                              FAR struct nfsnode *np, size_t writesize,
+                              FAR int *commit)
+{
+  FAR uint32_t *ptr;
+  uint32_t tmp;
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp < 1 || tmp > writesize)
+    {
+      return -EIO;
+    }
+
+  *commit = fxdr_unsigned(int, *ptr);
+  return tmp;
+}
+
+/****************************************************************************
+ * Name: nfs_writesize
+ *
+ * Description:
+ *   Limit the size of one WRITE to the RPC maximum and to what fits in the
+ *   I/O buffer.
+ *
+ ****************************************************************************/
+
+static size_t nfs_writesize(FAR struct nfsmount *nmp, size_t writesize)
+{
+  size_t bufsize;
+
+  if (writesize > nmp->nm_wsize)
+    {
+      writesize = nmp->nm_wsize;
+    }
+
+  bufsize = SIZEOF_rpc_call_write(writesize);
+  if (bufsize > nmp->nm_buflen)
+    {
+      writesize -= (bufsize - nmp->nm_buflen);
+    }
+
+  return writesize;
+}
+
+/****************************************************************************
+ * Name: nfs_writemulti
+ *
+ * Description:
+ *   The write counterpart of nfs_readmulti().  Up to
+ *   CONFIG_NFS_MAXOUTSTANDING FILE_SYNC WRITE RPCs are kept in flight,
+ *   each call is formatted in the I/O buffer and may be overwritten as
+ *   soon as it is sent.
+ *
+ * Returned Value:
+ *   The number of bytes written from the start of the buffer.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_MAXOUTSTANDING > 1
+static size_t nfs_writemulti(FAR struct nfsmount *nmp,
+                             FAR struct nfsnode *np, uint64_t offset,
+                             FAR const char *buffer, size_t buflen)
+{
+  struct nfs_inflight_s slot[CONFIG_NFS_MAXOUTSTANDING];
+  FAR struct nfs_inflight_s *s;
+  unsigned int npending = 0;
+  unsigned int head = 0;
+  unsigned int next = 0;
+  unsigned int i;
+  size_t issued = 0;
+  size_t done = 0;
+  size_t writesize;
+  size_t reqlen;
+  uint32_t xid;
+  bool stop = false;
+  bool hole = false;
+  int commit;
+  int ret;
+
+  for (; ; )
+    {
+      /* Keep the pipeline full */
+
+      while (!stop && issued < buflen &&
+             next - head < CONFIG_NFS_MAXOUTSTANDING)
+        {
+          writesize = nfs_writesize(nmp, buflen - issued);
+          reqlen    = nfs_fmtwrite(nmp, np, offset + issued,
+                                   buffer + issued, writesize,
+                                   NFSV3WRITE_FILESYNC);
+          s         = &slot[next % CONFIG_NFS_MAXOUTSTANDING];
+
+          nfs_statistics(NFSPROC_WRITE);
+          ret = rpcclnt_sendcall(nmp->nm_rpcclnt, NFSPROC_WRITE, NFS_PROG,
+                                 NFS_VER3, nmp->nm_iobuffer, reqlen,
+                                 &s->xid);
+          if (ret < 0)
+            {
+              stop = true;
+              break;
+            }
+
+          s->offset = issued;
+          s->len    = writesize;
+          s->result = -EINPROGRESS;
+          issued   += writesize;
+          next++;
+          npending++;
+        }
+
+      if (npending == 0)
+        {
+          break;
+        }
+
+      /* Wait for the next reply, whichever call it belongs to */
+
+      ret = rpcclnt_recvreply(nmp->nm_rpcclnt, &nmp->nm_msgbuffer.write,
+                              sizeof(struct rpc_reply_write), &xid);
+      if (ret < 0 && ret != -EOPNOTSUPP)
+        {
+          /* The state of the socket is unknown, give up on the rest */
+
+          ferr("ERROR: rpcclnt_recvreply failed: %d\n", ret);
+          break;
+        }
+
+      for (i = head; i != next; i++)
+        {
+          s = &slot[i % CONFIG_NFS_MAXOUTSTANDING];
+          if (s->xid == xid && s->result == -EINPROGRESS)
+            {
+              break;
+            }
+        }
+
+      if (i == next)
+        {
+          /* A late reply of an earlier, abandoned call */
+
+          continue;
+        }
+
+      npending--;
+
+      if (ret == OK)
+        {
+          ret = nfs_checkreply(&nmp->nm_msgbuffer.write);
+        }
+
+      if (ret == OK)
+        {
+          ret = nfs_parsewrite(nmp, np, s->len, &commit);
+        }
+
+      s->result = ret;
+
+      /* The replies may come out of order, never let an older size in the
+       * post-operation attributes shrink the file.
+       */
+
+      if (ret > 0 && np->n_size < offset + s->offset + ret)
+        {
+          np->n_size = offset + s->offset + ret;
+        }
+
+      /* Retire the completed chunks at the head of the pipeline */
+
+      while (!hole && head != next)
+        {
+          s = &slot[head % CONFIG_NFS_MAXOUTSTANDING];
+          if (s->result == -EINPROGRESS)
+            {
+              break;
+            }
+
+          if (s->result > 0)
+            {
+              done += s->result;
+            }
+
+          if ((size_t)s->result != s->len)
+            {
+              /* An error or a short write, the rest is not contiguous */
+
+              hole = true;
+              stop = true;
+            }
+
+          head++;
+        }
+    }
+
+  return done;
+}
+#endif
+
+/****************************************************************************
+ * Name: nfs_read
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  FAR struct nfsmount       *nmp;
+  FAR struct nfsnode        *np;
+  ssize_t                    readsize;
+  ssize_t                    tmp;
+  ssize_t                    bytesread = 0;
+  bool                       eof;
+  int                        ret = 0;
+
+  finfo("Read %zu bytes from offset %jd\n",
+        buflen, (intmax_t)filep->f_pos);
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return (ssize_t)ret;
+    }
+
+  /* Get the number of bytes left in the file and truncate read count so that
+   * it does not exceed the number of bytes left in the file.
+   */
+
+  tmp = np->n_size - filep->f_pos;
+  if (buflen > tmp)
+    {
+      buflen = tmp;
+      finfo("Read size truncated to %zu\n", buflen);
+    }
+
+#if CONFIG_NFS_MAXOUTSTANDING > 1
+  /* Pipeline the reads of more than one chunk over TCP */
+
+  if (nmp->nm_rpcclnt->rc_sotype == SOCK_STREAM &&
+      buflen > nfs_readsize(nmp, buflen))
+    {
+      bytesread = nfs_readmulti(nmp, np, filep->f_pos, buffer, buflen);
+    }
+#endif
+
+  /* Now loop until we fill the user buffer (or hit the end of the file) */
+
+  while (bytesread < buflen)
+    {
+#ifdef CONFIG_NFS_READAHEAD
+      /* Serve what we can from the read-ahead buffer */
+
+      readsize = nfs_readahead(np, filep->f_pos + bytesread,
+                               buffer + bytesread, buflen - bytesread);
+      if (readsize > 0)
+        {
+          bytesread += readsize;
+          continue;
+        }
+#endif
+
+      /* Make sure that the attempted read size does not exceed the RPC
+       * maximum or the IO buffer size
+       */
+
+      readsize = nfs_readsize(nmp, buflen - bytesread);
+
+#ifdef CONFIG_NFS_READAHEAD
+      /* A partial chunk reads the whole chunk into the read-ahead buffer,
+       * the next small sequential reads are then served from memory.
+       */
+
+      if (readsize < nfs_readsize(nmp, nmp->nm_rsize))
+        {
+          if (np->n_rabuf == NULL)
+            {
+              np->n_rabuf = fs_heap_malloc(nmp->nm_rsize);
+            }
+
+          if (np->n_rabuf != NULL)
+            {
+              np->n_ralen = 0;
+              ret = nfs_readchunk(nmp, np, filep->f_pos + bytesread,
+                                  (FAR char *)np->n_rabuf,
+                                  nfs_readsize(nmp, nmp->nm_rsize), &eof);
+              if (ret <= 0)
+                {
+                  break;
+                }
+
+              np->n_raoffset = filep->f_pos + bytesread;
+              np->n_ralen    = ret;
+              continue;
+            }
+        }
+#endif
+
+      ret = nfs_readchunk(nmp, np, filep->f_pos + bytesread,
+                          buffer + bytesread, readsize, &eof);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      bytesread += ret;
+
+      /* Check if we hit the end of file */
+
+      if (eof)
+        {
+          break;
+        }
+    }
+
+  /* Update the read state data */
+
+  filep->f_pos += bytesread;
+
+  nxmutex_unlock(&nmp->nm_lock);
+  return bytesread > 0 ? bytesread : ret;
+}
+
+/****************************************************************************
+ * Name: nfs_write
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes written on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  ssize_t              writesize;
+  ssize_t              byteswritten = 0;
+  size_t               reqlen;
+  int                  commit = 0;
+  int                  committed = NFSV3WRITE_FILESYNC;
+  int                  ret;
+
+  finfo("Write %zu bytes to offset %jd\n",
+        buflen, (intmax_t)filep->f_pos);
+
+  /* Sanity checks */
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return (ssize_t)ret;
+    }
+
+  /* Check if the file size would exceed the range of off_t */
+
+  if (np->n_size + buflen < np->n_size)
+    {
+      ret = -EFBIG;
+      goto errout_with_lock;
+    }
+
+  /* The cached attributes and data of the file become stale */
+
+  nfs_attrcache_flush(nmp);
+#ifdef CONFIG_NFS_READAHEAD
+  np->n_ralen = 0;
+#endif
+
+#if CONFIG_NFS_MAXOUTSTANDING > 1
+  /* Pipeline the writes of more than one chunk over TCP */
+
+  if (nmp->nm_rpcclnt->rc_sotype == SOCK_STREAM &&
+      buflen > nfs_writesize(nmp, buflen))
+    {
+      byteswritten = nfs_writemulti(nmp, np, filep->f_pos, buffer, buflen);
+      filep->f_pos += byteswritten;
+      buffer       += byteswritten;
+    }
+#endif
+
+  /* Now loop until we send the entire user buffer */
+
+  while (byteswritten < buflen)
+    {
+      /* Make sure that the attempted write size does not exceed the RPC
+       * maximum or the IO buffer size.
+       */
+
+      writesize = nfs_writesize(nmp, buflen - byteswritten);
+
+      /* Initialize the request */
+
+      reqlen = nfs_fmtwrite(nmp, np, filep->f_pos, buffer, writesize,
+                            committed);
+
+      /* Perform the write */
+
+      nfs_statistics(NFSPROC_WRITE);
+      ret = nfs_request(nmp, NFSPROC_WRITE,
+                        nmp->nm_iobuffer, reqlen,
+                        &nmp->nm_msgbuffer.write,
+                        sizeof(struct rpc_reply_write));
+      if (ret)
+        {
+          ferr("ERROR: nfs_request failed: %d\n", ret);
+          goto errout_with_lock;
+        }
+
+      ret = nfs_parsewrite(nmp, np, writesize, &commit);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+
+      writesize = ret;
+
+      /* Determine the lowest commitment level obtained by any of the RPCs. */
+
+      if (committed == NFSV3WRITE_FILESYNC)
+        {
           committed = commit;
         }
       else if (committed == NFSV3WRITE_DATASYNC &&
@@ -1480,6 +2065,152 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_readdirrpc
+ *
+ * Description:
+ *   Request the next block of directory entries from the saved cookie and
+ *   keep them in the directory structure, so that the following readdir()
+ *   calls are served without another round trip.  READDIRPLUS is used
+ *   while the server supports it.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_readdirrpc(FAR struct nfsmount *nmp,
+                          FAR struct nfs_dir_s *ndir)
+{
+  FAR uint32_t *ptr;
+  uint32_t readsize;
+  uint32_t tmp;
+  size_t avail;
+  int procnum;
+  int reqlen;
+  int ret;
+
+#ifdef CONFIG_NFS_READDIRPLUS
+retry:
+  ndir->nfs_plus = nmp->nm_readdirplus;
+#endif
+
+  /* Request a block directory entries, copying directory information from
+   * the dirent structure.  The READDIRPLUS arguments only add the maximum
+   * reply size at the end.
+   */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdir.readdir;
+  reqlen  = 0;
+
+  /* Copy the variable length, directory file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)ndir->nfs_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, ndir->nfs_fhandle, ndir->nfs_fhsize);
+  reqlen += uint32_alignup(ndir->nfs_fhsize);
+  ptr    += uint32_increment(ndir->nfs_fhsize);
+
+  /* Cookie and cookie verifier */
+
+  ptr[0] = ndir->nfs_cookie[0];
+  ptr[1] = ndir->nfs_cookie[1];
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  memcpy(ptr, ndir->nfs_verifier, DIRENT_NFS_VERFLEN);
+  ptr    += uint32_increment(DIRENT_NFS_VERFLEN);
+  reqlen += DIRENT_NFS_VERFLEN;
+
+  /* Size of the block of directory entries */
+
+  readsize = nmp->nm_readdirsize;
+  tmp      = SIZEOF_rpc_reply_readdir(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  *ptr++   = txdr_unsigned(readsize);
+  reqlen  += sizeof(uint32_t);
+  procnum  = NFSPROC_READDIR;
+
+#ifdef CONFIG_NFS_READDIRPLUS
+  if (ndir->nfs_plus)
+    {
+      *ptr     = txdr_unsigned(readsize);
+      reqlen  += sizeof(uint32_t);
+      procnum  = NFSPROC_READDIRPLUS;
+    }
+#endif
+
+  /* And read the directory */
+
+  nfs_statistics(procnum);
+  ret = nfs_request(nmp, procnum,
+                    &nmp->nm_msgbuffer.readdir, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+
+#ifdef CONFIG_NFS_READDIRPLUS
+  if (ndir->nfs_plus && (ret == -EOPNOTSUPP || ret == -NFSERR_NOTSUPP))
+    {
+      /* Fall back to READDIR and LOOKUP for the rest of the mount */
+
+      finfo("READDIRPLUS is not supported\n");
+      nmp->nm_readdirplus = false;
+      goto retry;
+    }
+#endif
+
+  if (ret != OK)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* A new group of entries was successfully read.  Process the
+   * information contained in the response header.  This information
+   * includes:
+   *
+   * 1) Attributes follow indication - 4 bytes
+   * 2) Directory attributes         - sizeof(struct nfs_fattr)
+   * 3) Cookie verifier              - NFSX_V3COOKIEVERF bytes
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_readdir *)nmp->nm_iobuffer)->readdir;
+
+  /* Check if attributes follow, if 0 so Skip over the attributes */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Attributes are not currently used */
+
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Save the verification cookie */
+
+  memcpy(ndir->nfs_verifier, ptr, DIRENT_NFS_VERFLEN);
+  ptr += uint32_increment(DIRENT_NFS_VERFLEN);
+
+  /* Keep the entries.  They never extend beyond the requested size. */
+
+  avail = (FAR uint8_t *)nmp->nm_iobuffer + nmp->nm_buflen -
+          (FAR uint8_t *)ptr;
+  if (avail > readsize)
+    {
+      avail = readsize;
+    }
+
+  memcpy(ndir->nfs_entries, ptr, avail);
+  ndir->nfs_nwords = avail / sizeof(uint32_t);
+  ndir->nfs_next   = 0;
+  return OK;
+}
+
 /****************************************************************************
  * Name: nfs_opendir
  *
@@ -1541,6 +2272,26 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_lock;
     }
 
+  /* Allocate the buffer of directory entries */
+
+  ndir->nfs_entries = fs_heap_malloc(nmp->nm_readdirsize);
+  if (ndir->nfs_entries == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  /* The path names the entries in the attribute cache */
+
+  ndir->nfs_path = fs_heap_strdup(relpath);
+  if (ndir->nfs_path == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_entries;
+    }
+#endif
+
   /* Save the directory information in struct fs_dirent_s so that it can be
    * used later when readdir() is called.
    */
@@ -1553,6 +2304,10 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
   nxmutex_unlock(&nmp->nm_lock);
   return 0;
 
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+errout_with_entries:
+  fs_heap_free(ndir->nfs_entries);
+#endif
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
 errout_with_ndir:
@@ -1574,8 +2329,15 @@ errout_with_ndir:
 static int nfs_closedir(FAR struct inode *mountpt,
                         FAR struct fs_dirent_s *dir)
 {
+  FAR struct nfs_dir_s *ndir = (FAR struct nfs_dir_s *)dir;
+
   DEBUGASSERT(dir);
-  fs_heap_free(dir);
+
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  fs_heap_free(ndir->nfs_path);
+#endif
+  fs_heap_free(ndir->nfs_entries);
+  fs_heap_free(ndir);
   return 0;
 }
 
@@ -1595,14 +2357,14 @@ static int nfs_readdir(FAR struct inode *mountpt,
 {
   FAR struct nfsmount *nmp;
   FAR struct nfs_dir_s *ndir;
+  FAR struct nfs_fattr *attributes;
   struct file_handle fhandle;
   struct nfs_fattr obj_attributes;
-  uint32_t readsize;
   uint32_t tmp;
   FAR uint32_t *ptr;
+  FAR uint32_t *end;
   FAR uint8_t *name;
   unsigned int length;
-  int reqlen;
   int ret;
 
   finfo("Entry\n");
@@ -1622,184 +2384,191 @@ static int nfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
-read_dir:
-  /* Request a block directory entries, copying directory information from
-   * the dirent structure.
-   */
-
-  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdir.readdir;
-  reqlen  = 0;
-
-  /* Copy the variable length, directory file handle */
-
-  *ptr++  = txdr_unsigned((uint32_t)ndir->nfs_fhsize);
-  reqlen += sizeof(uint32_t);
-
-  memcpy(ptr, ndir->nfs_fhandle, ndir->nfs_fhsize);
-  reqlen += uint32_alignup(ndir->nfs_fhsize);
-  ptr    += uint32_increment(ndir->nfs_fhsize);
+  for (; ; )
+    {
+      /* Get the next block of entries once the buffered one is consumed */
 
-  /* Cookie and cookie verifier */
+      if (ndir->nfs_next >= ndir->nfs_nwords)
+        {
+          ret = nfs_readdirrpc(nmp, ndir);
+          if (ret != OK)
+            {
+              goto errout_with_lock;
+            }
+        }
 
-  ptr[0] = ndir->nfs_cookie[0];
-  ptr[1] = ndir->nfs_cookie[1];
-  ptr    += 2;
-  reqlen += 2*sizeof(uint32_t);
+      ptr = ndir->nfs_entries + ndir->nfs_next;
+      end = ndir->nfs_entries + ndir->nfs_nwords;
 
-  memcpy(ptr, ndir->nfs_verifier, DIRENT_NFS_VERFLEN);
-  ptr    += uint32_increment(DIRENT_NFS_VERFLEN);
-  reqlen += DIRENT_NFS_VERFLEN;
+      /* Check if values follow.  If no values follow, then the EOF
+       * indication will appear next.
+       */
 
-  /* Number of directory entries (We currently only process one entry at a
-   * time)
-   */
+      tmp = *ptr++;
+      if (tmp == 0)
+        {
+          if (ptr < end && *ptr != 0)
+            {
+              finfo("End of directory\n");
+              ret = -ENOENT;
+              goto errout_with_lock;
+            }
 
-  readsize = nmp->nm_readdirsize;
-  tmp      = SIZEOF_rpc_reply_readdir(readsize);
-  if (tmp > nmp->nm_buflen)
-    {
-      readsize -= (tmp - nmp->nm_buflen);
-    }
+          /* A block without a single entry would never make progress */
 
-  *ptr     = txdr_unsigned(readsize);
-  reqlen  += sizeof(uint32_t);
+          if (ndir->nfs_next == 0)
+            {
+              ferr("ERROR: No data but not end of directory\n");
+              ret = -EIO;
+              goto errout_with_lock;
+            }
 
-  /* And read the directory */
+          /* Continue with the next block */
 
-  nfs_statistics(NFSPROC_READDIR);
-  ret = nfs_request(nmp, NFSPROC_READDIR,
-                    &nmp->nm_msgbuffer.readdir, reqlen,
-                    nmp->nm_iobuffer, nmp->nm_buflen);
-  if (ret != OK)
-    {
-      ferr("ERROR: nfs_request failed: %d\n", ret);
-      goto errout_with_lock;
-    }
+          ndir->nfs_nwords = 0;
+          continue;
+        }
 
-  /* A new group of entries was successfully read.  Process the
-   * information contained in the response header.  This information
-   * includes:
-   *
-   * 1) Attributes follow indication - 4 bytes
-   * 2) Directory attributes         - sizeof(struct nfs_fattr)
-   * 3) Cookie verifier              - NFSX_V3COOKIEVERF bytes
-   * 4) Values follows indication    - 4 bytes
-   */
+      /* If we are not at the end of the directory listing, then a set of
+       * entries will follow the header.  Each entry is of the form:
+       *
+       *    File ID (8 bytes)
+       *    Name length (4 bytes)
+       *    Name string (variable size but in multiples of 4 bytes)
+       *    Cookie (8 bytes)
+       *    Attributes and file handle (READDIRPLUS only)
+       *    next entry (4 bytes)
+       *
+       * There is an entry. Skip over the file ID and point to the length
+       */
 
-  ptr = (FAR uint32_t *)
-    &((FAR struct rpc_reply_readdir *)nmp->nm_iobuffer)->readdir;
+      ptr += 2;
+      if (ptr >= end)
+        {
+          goto errout_truncated;
+        }
 
-  /* Check if attributes follow, if 0 so Skip over the attributes */
+      /* Get the length and point to the name */
 
-  tmp = *ptr++;
-  if (tmp != 0)
-    {
-      /* Attributes are not currently used */
+      tmp    = *ptr++;
+      length = fxdr_unsigned(uint32_t, tmp);
+      name   = (FAR uint8_t *)ptr;
 
-      ptr += uint32_increment(sizeof(struct nfs_fattr));
-    }
+      /* Increment the pointer past the name (allowing for padding). ptr
+       * now points to the cookie.
+       */
 
-  /* Save the verification cookie */
+      ptr += uint32_increment(length);
+      if (ptr + 2 > end)
+        {
+          goto errout_truncated;
+        }
 
-  memcpy(ndir->nfs_verifier, ptr, DIRENT_NFS_VERFLEN);
-  ptr += uint32_increment(DIRENT_NFS_VERFLEN);
+      /* Save the cookie and increment the pointer to the next entry */
 
-next_entry:
-  /* Check if values follow.  If no values follow, then the EOF indication
-   * will appear next.
-   */
+      ndir->nfs_cookie[0] = *ptr++;
+      ndir->nfs_cookie[1] = *ptr++;
 
-  tmp = *ptr++;
-  if (tmp == 0)
-    {
-      /* No values follow, then the reply should consist only of a 4-byte
-       * end-of-directory indication.
-       */
+      attributes     = NULL;
+      fhandle.length = 0;
 
-      tmp = *ptr++;
-      if (tmp != 0)
+#ifdef CONFIG_NFS_READDIRPLUS
+      if (ndir->nfs_plus)
         {
-          finfo("End of directory\n");
-          ret = -ENOENT;
-          goto errout_with_lock;
-        }
+          /* The attributes of the object, if they follow */
 
-      /* What would it mean if there were not data and we not at the end of
-       * file?
-       */
+          if (ptr >= end)
+            {
+              goto errout_truncated;
+            }
 
-       else
-        {
-          finfo("No data but not end of directory???\n");
-          goto read_dir;
-        }
-    }
+          if (*ptr++ != 0)
+            {
+              attributes = (FAR struct nfs_fattr *)ptr;
+              ptr += uint32_increment(sizeof(struct nfs_fattr));
+            }
 
-  /* If we are not at the end of the directory listing, then a set of entries
-   * will follow the header.  Each entry is of the form:
-   *
-   *    File ID (8 bytes)
-   *    Name length (4 bytes)
-   *    Name string (variable size but in multiples of 4 bytes)
-   *    Cookie (8 bytes)
-   *    next entry (4 bytes)
-   */
+          /* And its file handle, if it follows */
 
-  /* There is an entry. Skip over the file ID and point to the length */
+          if (ptr >= end)
+            {
+              goto errout_truncated;
+            }
 
-  ptr += 2;
+          if (*ptr++ != 0)
+            {
+              tmp = fxdr_unsigned(uint32_t, *ptr++);
+              if (tmp > NFSX_V3FHMAX)
+                {
+                  goto errout_truncated;
+                }
 
-  /* Get the length and point to the name */
+              fhandle.length = tmp;
+              memcpy(&fhandle.handle, ptr, tmp);
+              ptr += uint32_increment(tmp);
+            }
 
-  tmp    = *ptr++;
-  length = fxdr_unsigned(uint32_t, tmp);
-  name   = (FAR uint8_t *)ptr;
+          if (ptr > end)
+            {
+              goto errout_truncated;
+            }
+        }
+#endif
 
-  /* Increment the pointer past the name (allowing for padding). ptr
-   * now points to the cookie.
-   */
+      ndir->nfs_next = ptr - ndir->nfs_entries;
 
-  ptr += uint32_increment(length);
+      /* Return the name of the node to the caller */
 
-  /* Save the cookie and increment the pointer to the next entry */
+      if (length > NAME_MAX)
+        {
+          length = NAME_MAX;
+        }
 
-  ndir->nfs_cookie[0] = *ptr++;
-  ndir->nfs_cookie[1] = *ptr++;
+      memcpy(entry->d_name, name, length);
+      entry->d_name[length] = '\0';
+      finfo("name: \"%s\"\n", entry->d_name);
 
-  /* Return the name of the node to the caller */
+      if (strcmp(entry->d_name, ".") != 0 &&
+          strcmp(entry->d_name, "..") != 0)
+        {
+          break;
+        }
 
-  if (length > NAME_MAX)
-    {
-      length = NAME_MAX;
+      /* Skip . and .. */
     }
 
-  memcpy(entry->d_name, name, length);
-  entry->d_name[length] = '\0';
-  finfo("name: \"%s\"\n", entry->d_name);
+#if CONFIG_NFS_ATTRCACHE_NENTRIES > 0
+  /* Save the following stat() of the entry a LOOKUP */
 
-  if (strcmp(entry->d_name, ".") == 0 ||
-      strcmp(entry->d_name, "..") == 0)
+  if (attributes != NULL && fhandle.length > 0)
     {
-      goto next_entry; /* Skip . and .. */
+      nfs_attrcache_add(nmp, ndir->nfs_path, entry->d_name, &fhandle,
+                        attributes, NULL);
     }
+#endif
 
-  /* Get the file attributes associated with this name and return
-   * the file type.
-   */
+  if (attributes == NULL)
+    {
+      /* Get the file attributes associated with this name and return
+       * the file type.
+       */
 
-  fhandle.length = (uint32_t)ndir->nfs_fhsize;
-  memcpy(&fhandle.handle, ndir->nfs_fhandle, fhandle.length);
+      fhandle.length = (uint32_t)ndir->nfs_fhsize;
+      memcpy(&fhandle.handle, ndir->nfs_fhandle, fhandle.length);
 
-  ret = nfs_lookup(nmp, entry->d_name, &fhandle, &obj_attributes, NULL);
-  if (ret != OK)
-    {
-      ferr("ERROR: nfs_lookup failed: %d\n", ret);
-      goto errout_with_lock;
+      ret = nfs_lookup(nmp, entry->d_name, &fhandle, &obj_attributes, NULL);
+      if (ret != OK)
+        {
+          ferr("ERROR: nfs_lookup failed: %d\n", ret);
+          goto errout_with_lock;
+        }
+
+      attributes = &obj_attributes;
     }
 
   /* Set the dirent file type */
 
-  tmp = fxdr_unsigned(uint32_t, obj_attributes.fa_type);
+  tmp = fxdr_unsigned(uint32_t, attributes->fa_type);
   switch (tmp)
     {
     default:
@@ -1836,6 +2605,13 @@ next_entry:
     }
 
   finfo("type: %d->%d\n", (int)tmp, entry->d_type);
+  nxmutex_unlock(&nmp->nm_lock);
+  return OK;
+
+errout_truncated:
+  ferr("ERROR: Truncated directory entry\n");
+  ndir->nfs_nwords = 0;
+  ret = -EIO;
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
@@ -1874,6 +2650,8 @@ static int nfs_rewinddir(FAR struct inode *mountpt,
   memset(&ndir->nfs_verifier, 0, DIRENT_NFS_VERFLEN);
   ndir->nfs_cookie[0] = 0;
   ndir->nfs_cookie[1] = 0;
+  ndir->nfs_nwords    = 0;
+  ndir->nfs_next      = 0;
   return OK;
 }
 
@@ -2124,6 +2902,9 @@ static int nfs_bind(FAR struct inode *blkdriver, FAR const void *data,
   nmp->nm_wsize       = nprmt.wsize;
   nmp->nm_rsize       = nprmt.rsize;
   nmp->nm_readdirsize = nprmt.readdirsize;
+#ifdef CONFIG_NFS_READDIRPLUS
+  nmp->nm_readdirplus = true;
+#endif
 
   strlcpy(nmp->nm_path, argp->path, sizeof(nmp->nm_path));
   memcpy(&nmp->nm_nam, &argp->addr, argp->addrlen);
@@ -2245,6 +3026,7 @@ static int nfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
 
   /* And free any allocated resources */
 
+  nfs_attrcache_flush(nmp);
   nxmutex_destroy(&nmp->nm_lock);
   fs_heap_free(nmp->nm_rpcclnt);
   fs_heap_free(nmp);
@@ -2507,6 +3289,7 @@ static int nfs_remove(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the REMOVE RPC call */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_REMOVE);
   ret = nfs_request(nmp, NFSPROC_REMOVE,
                     &nmp->nm_msgbuffer.removef, reqlen,
@@ -2630,6 +3413,7 @@ static int nfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Perform the MKDIR RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_MKDIR);
   ret = nfs_request(nmp, NFSPROC_MKDIR,
                     &nmp->nm_msgbuffer.mkdir, reqlen,
@@ -2717,6 +3501,7 @@ static int nfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the RMDIR RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_RMDIR);
   ret = nfs_request(nmp, NFSPROC_RMDIR,
                     &nmp->nm_msgbuffer.rmdir, reqlen,
@@ -2830,6 +3615,7 @@ static int nfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Perform the RENAME RPC */
 
+  nfs_attrcache_flush(nmp);
   nfs_statistics(NFSPROC_RENAME);
   ret = nfs_request(nmp, NFSPROC_RENAME,
                     &nmp->nm_msgbuffer.renamef, reqlen,
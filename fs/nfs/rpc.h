@@ -317,6 +317,12 @@ struct rpc_call_readdir
   struct READDIR3args readdir;
 };
 
+struct rpc_call_readdirplus
+{
+  struct rpc_call_header ch;
+  struct READDIRPLUS3args readdirplus;
+};
+
 struct rpc_call_setattr
 {
   struct rpc_call_header ch;
@@ -472,5 +478,10 @@ void rpcclnt_disconnect(FAR struct rpcclnt *rpc);
 int  rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                      int version, FAR void *request, size_t reqlen,
                      FAR void *response, size_t resplen);
+int  rpcclnt_sendcall(FAR struct rpcclnt *rpc, int procnum, int prog,
+                      int version, FAR void *request, size_t reqlen,
+                      FAR uint32_t *xid);
+int  rpcclnt_recvreply(FAR struct rpcclnt *rpc, FAR void *response,
+                       size_t resplen, FAR uint32_t *xid);
 
 #endif /* __FS_NFS_RPC_H */
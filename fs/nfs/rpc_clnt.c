@@ -153,6 +153,7 @@ static int rpcclnt_reply(FAR struct rpcclnt *rpc, uint32_t xid,
                          FAR void *reply, size_t resplen);
 static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
                               uint32_t xid, int procid, int prog, int vers);
+static int rpcclnt_checkreply(FAR void *response);
 
 /****************************************************************************
  * Private Functions
@@ -504,6 +505,41 @@ static void rpcclnt_fmtheader(FAR struct rpc_call_header *ch,
   ch->rpc_verf.authlen   = 0;
 }
 
+/****************************************************************************
+ * Name: rpcclnt_checkreply
+ *
+ * Description:
+ *   Verify the RPC level of a reply header.
+ *
+ ****************************************************************************/
+
+static int rpcclnt_checkreply(FAR void *response)
+{
+  FAR struct rpc_reply_header *replymsg;
+  uint32_t tmp;
+
+  replymsg = (FAR struct rpc_reply_header *)response;
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->type);
+  if (tmp != RPC_MSGACCEPTED)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  tmp = fxdr_unsigned(uint32_t, replymsg->status);
+  if (tmp == RPC_SUCCESS)
+    {
+      finfo("RPC_SUCCESS\n");
+    }
+  else
+    {
+      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
+      return -EOPNOTSUPP;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -766,8 +802,6 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
                     int version, FAR void *request, size_t reqlen,
                     FAR void *response, size_t resplen)
 {
-  FAR struct rpc_reply_header *replymsg;
-  uint32_t tmp;
   uint32_t xid;
   int retries = 0;
   int error = 0;
@@ -843,24 +877,94 @@ int rpcclnt_request(FAR struct rpcclnt *rpc, int procnum, int prog,
 
   /* Break down the RPC header and check if it is OK */
 
-  replymsg = (FAR struct rpc_reply_header *)response;
+  return rpcclnt_checkreply(response);
+}
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->type);
-  if (tmp != RPC_MSGACCEPTED)
+/****************************************************************************
+ * Name: rpcclnt_sendcall
+ *
+ * Description:
+ *   Format and send an RPC CALL message without waiting for the reply.
+ *   This lets the caller keep several calls outstanding on a stream socket
+ *   and collect the replies with rpcclnt_recvreply() in any order.
+ *
+ *   The transaction id of the call is returned in xid.  Nothing is
+ *   retransmitted by this layer.
+ *
+ ****************************************************************************/
+
+int rpcclnt_sendcall(FAR struct rpcclnt *rpc, int procnum, int prog,
+                     int version, FAR void *request, size_t reqlen,
+                     FAR uint32_t *xid)
+{
+  int error;
+
+  *xid = ++rpc->rc_xid;
+
+  rpcclnt_fmtheader((FAR struct rpc_call_header *)request,
+                    *xid, prog, version, procnum);
+
+  rpc_statistics(rpcrequests);
+
+  error = rpcclnt_send(rpc, request,
+                       reqlen + sizeof(struct rpc_call_header));
+  if (error != OK)
     {
-      return -EOPNOTSUPP;
+      ferr("ERROR: rpcclnt_send failed: %d\n", error);
     }
 
-  tmp = fxdr_unsigned(uint32_t, replymsg->status);
-  if (tmp == RPC_SUCCESS)
+  return error;
+}
+
+/****************************************************************************
+ * Name: rpcclnt_recvreply
+ *
+ * Description:
+ *   Receive the next RPC REPLY message from the socket, whatever call it
+ *   belongs to.  The transaction id of the reply is returned in xid so
+ *   that the caller can match it to one of its outstanding calls.
+ *
+ *   A timeout is waited out up to the retry count of the client, but the
+ *   call is not sent again.
+ *
+ ****************************************************************************/
+
+int rpcclnt_recvreply(FAR struct rpcclnt *rpc, FAR void *response,
+                      size_t resplen, FAR uint32_t *xid)
+{
+  FAR struct rpc_reply_header *replyheader;
+  int retries = 0;
+  int error;
+
+  for (; ; )
     {
-      finfo("RPC_SUCCESS\n");
+      error = rpcclnt_receive(rpc, response, resplen);
+      if (error != -EAGAIN && error != -ETIMEDOUT)
+        {
+          break;
+        }
+
+      rpc_statistics(rpctimeouts);
+      if (++retries >= rpc->rc_retry)
+        {
+          break;
+        }
     }
-  else
+
+  if (error != OK)
     {
-      ferr("ERROR: Unsupported RPC type: %" PRId32 "\n", tmp);
-      return -EOPNOTSUPP;
+      ferr("ERROR: rpcclnt_receive returned: %d\n", error);
+      return error;
     }
 
-  return OK;
+  replyheader = (FAR struct rpc_reply_header *)response;
+  if (replyheader->rp_direction != rpc_reply)
+    {
+      ferr("ERROR: Different RPC REPLY returned\n");
+      rpc_statistics(rpcinvalid);
+      return -EPROTO;
+    }
+
+  *xid = fxdr_unsigned(uint32_t, replyheader->rp_xid);
+  return rpcclnt_checkreply(response);
 }
@@ -263,6 +263,18 @@ struct nxffs_wrfile_s
   uint32_t                  crc;        /* Accumulated data block CRC */
 };
 
+/* One entry of the in-memory inode index: the FLASH offset of the header
+ * of a valid inode, found by the CRC-32 of its name.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  uint32_t                  hash;      /* CRC-32 of the inode name */
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+};
+#endif
+
 /* This structure represents the overall state of on NXFFS instance. */
 
 struct nxffs_volume_s
@@ -281,6 +293,14 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+  uint32_t                  nhits;     /* Block reads served by the cache */
+  uint32_t                  nmisses;   /* Block reads from FLASH */
+#ifdef CONFIG_NXFFS_INDEX
+  FAR struct nxffs_index_s *index;     /* Index of the valid inodes */
+  int                       nindex;    /* Number of entries in index[] */
+  int                       naindex;   /* Number of entries allocated */
+  bool                      indexed;   /* index[] holds every valid inode */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -601,7 +621,8 @@ int nxffs_nextentry(FAR struct nxffs_volume_s *volume, off_t offset,
  * Description:
  *   Search for an inode with the provided name starting with the first
  *   valid inode and proceeding to the end FLASH or until the matching
- *   inode is found.
+ *   inode is found.  With CONFIG_NXFFS_INDEX, the inode index is used
+ *   instead whenever it is complete.
  *
  * Input Parameters:
  *   volume - Describes the NXFFS volume
@@ -646,6 +667,110 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
 off_t nxffs_inodeend(FAR struct nxffs_volume_s *volume,
                      FAR struct nxffs_entry_s *entry);
 
+/****************************************************************************
+ * Name: nxffs_indexreset
+ *
+ * Description:
+ *   Empty the inode index and mark it complete.  Called when the volume is
+ *   scanned from the start (nxffs_limits()) or reformatted.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_indexreset(FAR struct nxffs_volume_s *volume);
+
+/****************************************************************************
+ * Name: nxffs_indexinval
+ *
+ * Description:
+ *   Mark the inode index incomplete, so that it is rebuilt by the next
+ *   nxffs_findinode().  Called when inodes are moved by packing.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+void nxffs_indexinval(FAR struct nxffs_volume_s *volume);
+
+/****************************************************************************
+ * Name: nxffs_indexadd
+ *
+ * Description:
+ *   Add a valid inode to a complete inode index.  If memory runs out the
+ *   index is marked incomplete instead.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   entry  - Describes the inode, with its name and header offset
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+void nxffs_indexadd(FAR struct nxffs_volume_s *volume,
+                    FAR const struct nxffs_entry_s *entry);
+
+/****************************************************************************
+ * Name: nxffs_indexremove
+ *
+ * Description:
+ *   Remove the inode with the header at 'hoffset' from the inode index.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   hoffset - FLASH offset to the header of the deleted inode
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+void nxffs_indexremove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+
+/****************************************************************************
+ * Name: nxffs_indexbuild
+ *
+ * Description:
+ *   Rebuild an incomplete inode index by scanning the inodes on FLASH.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero if the index is complete.  Otherwise, a negated errno value is
+ *   returned and the index stays incomplete.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+int nxffs_indexbuild(FAR struct nxffs_volume_s *volume);
+#else
+#  define nxffs_indexreset(v)
+#  define nxffs_indexinval(v)
+#  define nxffs_indexadd(v,e)
+#  define nxffs_indexremove(v,o)
+#endif
+
 /****************************************************************************
  * Name: nxffs_verifyblock
  *
@@ -64,6 +64,8 @@ int nxffs_rdcache(FAR struct nxffs_volume_s *volume, off_t block)
 
   if (block != volume->cblock)
     {
+      volume->nmisses++;
+
       /* Read the specified blocks into cache */
 
       nxfrd = MTD_BREAD(volume->mtd, block, 1, volume->cache);
@@ -78,6 +80,10 @@ int nxffs_rdcache(FAR struct nxffs_volume_s *volume, off_t block)
 
       volume->cblock  = block;
     }
+  else
+    {
+      volume->nhits++;
+    }
 
   return OK;
 }
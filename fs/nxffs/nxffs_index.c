@@ -0,0 +1,188 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/crc32.h>
+
+#include "nxffs.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The index grows by doubling, starting with this many entries */
+
+#define NXFFS_INDEX_MINENTRIES 16
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_indexreset
+ *
+ * Description:
+ *   Empty the inode index and mark it complete.  Called when the volume is
+ *   scanned from the start (nxffs_limits()) or reformatted.
+ *
+ ****************************************************************************/
+
+void nxffs_indexreset(FAR struct nxffs_volume_s *volume)
+{
+  volume->nindex  = 0;
+  volume->indexed = true;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexinval
+ *
+ * Description:
+ *   Mark the inode index incomplete, so that it is rebuilt by the next
+ *   nxffs_findinode().  Called when inodes are moved by packing.
+ *
+ ****************************************************************************/
+
+void nxffs_indexinval(FAR struct nxffs_volume_s *volume)
+{
+  volume->nindex  = 0;
+  volume->indexed = false;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexadd
+ *
+ * Description:
+ *   Add a valid inode to a complete inode index.  If memory runs out the
+ *   index is marked incomplete instead.
+ *
+ ****************************************************************************/
+
+void nxffs_indexadd(FAR struct nxffs_volume_s *volume,
+                    FAR const struct nxffs_entry_s *entry)
+{
+  FAR struct nxffs_index_s *index;
+  int naindex;
+
+  if (!volume->indexed)
+    {
+      return;
+    }
+
+  if (volume->nindex >= volume->naindex)
+    {
+      naindex = volume->naindex > 0 ? 2 * volume->naindex :
+                NXFFS_INDEX_MINENTRIES;
+      index   = fs_heap_realloc(volume->index,
+                                naindex * sizeof(struct nxffs_index_s));
+      if (index == NULL)
+        {
+          fwarn("WARNING: No memory for the inode index\n");
+          nxffs_indexinval(volume);
+          return;
+        }
+
+      volume->index   = index;
+      volume->naindex = naindex;
+    }
+
+  index          = &volume->index[volume->nindex++];
+  index->hash    = crc32((FAR const uint8_t *)entry->name,
+                         strlen(entry->name));
+  index->hoffset = entry->hoffset;
+}
+
+/****************************************************************************
+ * Name: nxffs_indexremove
+ *
+ * Description:
+ *   Remove the inode with the header at 'hoffset' from the inode index.
+ *
+ ****************************************************************************/
+
+void nxffs_indexremove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  int i;
+
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          /* The order does not matter, move the last entry here */
+
+          volume->index[i] = volume->index[--volume->nindex];
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_indexbuild
+ *
+ * Description:
+ *   Rebuild an incomplete inode index by scanning the inodes on FLASH.
+ *
+ ****************************************************************************/
+
+int nxffs_indexbuild(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  nxffs_indexreset(volume);
+
+  /* Visit every valid inode, as nxffs_findinode() does */
+
+  offset = volume->inoffset;
+  while ((ret = nxffs_nextentry(volume, offset, &entry)) == OK)
+    {
+      nxffs_indexadd(volume, &entry);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+    }
+
+  /* -ENOENT is the end of the inodes */
+
+  if (ret != -ENOENT)
+    {
+      nxffs_indexinval(volume);
+      return ret;
+    }
+
+  return volume->indexed ? OK : -ENOMEM;
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
@@ -307,6 +307,9 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ferr("ERROR: Failed to calculate file system limits: %d\n", -ret);
 
 errout_with_buffer:
+#ifdef CONFIG_NXFFS_INDEX
+  fs_heap_free(volume->index);
+#endif
   fs_heap_free(volume->pack);
 errout_with_cache:
   fs_heap_free(volume->cache);
@@ -353,6 +356,10 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
   int nerased;
   int ret;
 
+  /* The scan below visits every valid inode, index them on the way */
+
+  nxffs_indexreset(volume);
+
   /* Get the offset to the first valid block on the FLASH */
 
   block = 0;
@@ -395,6 +402,7 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
 
       volume->inoffset = entry.hoffset;
       finfo("First inode at offset %jd\n", (intmax_t)volume->inoffset);
+      nxffs_indexadd(volume, &entry);
 
       /* Discard this entry and set the next offset. */
 
@@ -408,6 +416,8 @@ int nxffs_limits(FAR struct nxffs_volume_s *volume)
     {
       while (nxffs_nextentry(volume, offset, &entry) == OK)
         {
+          nxffs_indexadd(volume, &entry);
+
           /* Discard the entry and guess the next offset. */
 
           offset = nxffs_inodeend(volume, &entry);
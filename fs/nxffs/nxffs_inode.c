@@ -47,8 +47,8 @@
  * Name: nxffs_rdentry
  *
  * Description:
- *   Read the inode entry at this offset.  Called only from
- *   nxffs_nextentry().
+ *   Read the inode entry at this offset.  Called from nxffs_nextentry()
+ *   and nxffs_lookupinode().
  *
  * Input Parameters:
  *   volume - Describes the current volume.
@@ -187,6 +187,77 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: nxffs_lookupinode
+ *
+ * Description:
+ *   Find an inode through the inode index, reading only the inode headers
+ *   whose name has the same hash.  The index is rebuilt first if it is
+ *   not complete.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOENT if there is no such inode and -EAGAIN if the
+ *   index cannot be used, in which case the inodes must be scanned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+static int nxffs_lookupinode(FAR struct nxffs_volume_s *volume,
+                             FAR const char *name,
+                             FAR struct nxffs_entry_s *entry)
+{
+  uint32_t hash;
+  off_t hoffset;
+  int ret;
+  int i;
+
+  if (!volume->indexed && nxffs_indexbuild(volume) < 0)
+    {
+      return -EAGAIN;
+    }
+
+  hash = crc32((FAR const uint8_t *)name, strlen(name));
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hash != hash)
+        {
+          continue;
+        }
+
+      /* The header must be in the cache for nxffs_rdentry() */
+
+      hoffset = volume->index[i].hoffset;
+      nxffs_ioseek(volume, hoffset);
+      ret = nxffs_rdcache(volume, volume->ioblock);
+      if (ret >= 0)
+        {
+          ret = nxffs_rdentry(volume, hoffset, entry);
+        }
+
+      if (ret < 0)
+        {
+          /* The index is out of date, fall back to scanning */
+
+          fwarn("WARNING: Stale inode index entry at %jd: %d\n",
+                (intmax_t)hoffset, ret);
+          nxffs_indexinval(volume);
+          return -EAGAIN;
+        }
+
+      if (strcmp(name, entry->name) == 0)
+        {
+          return OK;
+        }
+
+      /* Only the hash matched */
+
+      nxffs_freeentry(entry);
+    }
+
+  return -ENOENT;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -372,6 +443,16 @@ int nxffs_findinode(FAR struct nxffs_volume_s *volume, FAR const char *name,
   off_t offset;
   int ret;
 
+#ifdef CONFIG_NXFFS_INDEX
+  /* Prefer the inode index to a scan of all the inodes */
+
+  ret = nxffs_lookupinode(volume, name, entry);
+  if (ret != -EAGAIN)
+    {
+      return ret;
+    }
+#endif
+
   /* Start with the first valid inode that was discovered when the volume
    * was created (or modified after the last file system re-packing).
    */
@@ -76,7 +76,9 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       goto errout;
     }
 
-  /* Only a reformat and optimize commands are supported */
+  /* Only the reformat, optimize and cache statistics commands are
+   * supported
+   */
 
   if (cmd == FIOC_REFORMAT)
     {
@@ -104,6 +106,25 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
       ret = nxffs_pack(volume);
     }
+
+  else if (cmd == FIOC_CACHESTATS)
+    {
+      FAR struct fs_cachestats_s *stats =
+        (FAR struct fs_cachestats_s *)((uintptr_t)arg);
+
+      if (stats == NULL)
+        {
+          ret = -EINVAL;
+          goto errout_with_lock;
+        }
+
+      /* NXFFS caches one read/write block */
+
+      stats->hits   = volume->nhits;
+      stats->misses = volume->nmisses;
+      stats->size   = volume->geo.blocksize;
+      ret           = OK;
+    }
   else
     {
       /* Command not recognized, forward to the MTD driver */
@@ -1282,6 +1282,10 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   wrfile = NULL;
   packed = false;
 
+  /* Packing moves the inodes, the index is rebuilt when next needed */
+
+  nxffs_indexinval(volume);
+
   iooffset = nxffs_mediacheck(volume, &pack);
   if (iooffset == 0)
     {
@@ -272,8 +272,9 @@ int nxffs_reformat(FAR struct nxffs_volume_s *volume)
 {
   int ret;
 
-  /* Erase and reformat the entire volume */
+  /* Erase and reformat the entire volume, there are no inodes left */
 
+  nxffs_indexreset(volume);
   ret = nxffs_format(volume);
   if (ret < 0)
     {
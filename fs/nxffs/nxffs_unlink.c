@@ -115,6 +115,10 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %jd: %d\n",
            (intmax_t)volume->ioblock, ret);
     }
+  else
+    {
+      nxffs_indexremove(volume, entry.hoffset);
+    }
 
 errout_with_entry:
   nxffs_freeentry(&entry);
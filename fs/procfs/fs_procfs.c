@@ -66,9 +66,13 @@ extern const struct procfs_operations g_irq_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
+extern const struct procfs_operations g_memstat_operations;
+extern const struct procfs_operations g_migration_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_snapshot_operations;
+extern const struct procfs_operations g_spinlock_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
@@ -86,6 +90,7 @@ extern const struct procfs_operations g_net_operations;
 extern const struct procfs_operations g_netroute_operations;
 extern const struct procfs_operations g_part_operations;
 extern const struct procfs_operations g_smartfs_procfs_operations;
+extern const struct procfs_operations g_littlefs_procfs_operations;
 
 /****************************************************************************
  * Private Types
@@ -129,6 +134,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_FS_LITTLEFS_STATS
+  { "fs/littlefs",  &g_littlefs_procfs_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MOUNT
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -160,6 +169,16 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "mempool",      &g_mempool_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO) && \
+    defined(CONFIG_MM_HEAP_TELEMETRY)
+  { "memstat",      &g_memstat_operations,  PROCFS_FILE_TYPE   },
+#endif
+
+#if defined(CONFIG_SCHED_SMP_BALANCE) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_MIGRATION)
+  { "migration",    &g_migration_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",      &g_module_operations,   PROCFS_FILE_TYPE   },
 #endif
@@ -192,6 +211,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+  { "snapshot",     &g_snapshot_operations, PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  { "spinlocks",    &g_spinlock_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_TCBINFO) && !defined(CONFIG_FS_PROCFS_EXCLUDE_TCBINFO)
   { "tcbinfo",      &g_tcbinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
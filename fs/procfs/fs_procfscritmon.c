@@ -41,6 +41,7 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
@@ -59,7 +60,11 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+#  define CRITMON_LINELEN (24 + CRITMON_WAKEUP_NBUCKETS * 11)
+#else
+#  define CRITMON_LINELEN 64
+#endif
 
 /****************************************************************************
  * Private Types
@@ -360,6 +365,158 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_holders
+ *
+ * Description:
+ *   Generate one line per ranked critical section holder, sorted by the
+ *   maximum holding time: caller, max time, total time and count.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_HOLDERS > 0
+static ssize_t critmon_read_holders(FAR struct critmon_file_s *attr,
+                                    FAR char *buffer, size_t buflen,
+                                    FAR off_t *offset)
+{
+  struct critmon_holder_s holders[CONFIG_SCHED_CRITMONITOR_HOLDERS];
+  struct critmon_holder_s tmp;
+  struct timespec maxtime;
+  struct timespec alltime;
+  irqstate_t flags;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int i;
+  int j;
+
+  /* Take a snapshot of the table, it is updated within the section */
+
+  flags = enter_critical_section();
+  memcpy(holders, g_crit_holders, sizeof(holders));
+  leave_critical_section(flags);
+
+  /* Sort by descending maximum holding time */
+
+  for (i = 1; i < CONFIG_SCHED_CRITMONITOR_HOLDERS; i++)
+    {
+      tmp = holders[i];
+      for (j = i; j > 0 && holders[j - 1].max < tmp.max; j--)
+        {
+          holders[j] = holders[j - 1];
+        }
+
+      holders[j] = tmp;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_HOLDERS; i++)
+    {
+      if (holders[i].caller == NULL)
+        {
+          break;
+        }
+
+      perf_convert(holders[i].max, &maxtime);
+      perf_convert(holders[i].total, &alltime);
+
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                 "%p,%lu.%09lu,%lu.%09lu,%" PRIu32 "\n",
+                                 holders[i].caller,
+                                 (unsigned long)maxtime.tv_sec,
+                                 (unsigned long)maxtime.tv_nsec,
+                                 (unsigned long)alltime.tv_sec,
+                                 (unsigned long)alltime.tv_nsec,
+                                 holders[i].count);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      if (buflen <= 0)
+        {
+          break;
+        }
+    }
+
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: critmon_read_wakeup
+ *
+ * Description:
+ *   One line per priority band with the counts of the latency histogram,
+ *   followed by the worst wakeup since the last read:
+ *
+ *     wakeup,<band>,<count <1us>,<count <2us>,...
+ *     worst,<pid>,<priority>,<latency>,<holder pid>,<csection>,<lock>
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+static ssize_t critmon_read_wakeup(FAR struct critmon_file_s *attr,
+                                   FAR char *buffer, size_t buflen,
+                                   FAR off_t *offset)
+{
+  struct critmon_wakeup_s worst;
+  struct timespec latency;
+  irqstate_t flags;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int band;
+  int i;
+
+  for (band = 0; band < CRITMON_WAKEUP_NBANDS; band++)
+    {
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN, "wakeup,%d",
+                                 band);
+      for (i = 0; i < CRITMON_WAKEUP_NBUCKETS; i++)
+        {
+          linesize += procfs_snprintf(attr->line + linesize,
+                                      CRITMON_LINELEN - linesize,
+                                      ",%" PRIu32, g_wakeup_hist[band][i]);
+        }
+
+      linesize += procfs_snprintf(attr->line + linesize,
+                                  CRITMON_LINELEN - linesize, "\n");
+      copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                                offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      if (buflen <= 0)
+        {
+          return totalsize;
+        }
+    }
+
+  /* Take the worst wakeup and reset it */
+
+  flags = enter_critical_section();
+  worst = g_wakeup_worst;
+  memset(&g_wakeup_worst, 0, sizeof(g_wakeup_worst));
+  leave_critical_section(flags);
+
+  perf_convert(worst.latency, &latency);
+  linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                             "worst,%d,%u,%lu.%09lu,%d,%p,%p\n",
+                             worst.pid, worst.priority,
+                             (unsigned long)latency.tv_sec,
+                             (unsigned long)latency.tv_nsec,
+                             worst.holder, worst.csection,
+                             worst.preemption);
+  copysize = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+
+  return totalsize + copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -396,6 +553,25 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#if CONFIG_SCHED_CRITMONITOR_HOLDERS > 0
+  /* Followed by the ranking of the critical section holders */
+
+  if (ret < buflen)
+    {
+      ret += critmon_read_holders(attr, buffer + ret, buflen - ret,
+                                  &offset);
+    }
+#endif
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+  /* And the wakeup latencies */
+
+  if (ret < buflen)
+    {
+      ret += critmon_read_wakeup(attr, buffer + ret, buflen - ret, &offset);
+    }
+#endif
+
   if (ret > 0)
     {
       filep->f_pos += ret;
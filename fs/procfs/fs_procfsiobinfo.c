@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -187,6 +188,9 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
   size_t copysize;
   size_t totalsize;
   off_t offset;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  int cpu;
+#endif
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -223,6 +227,44 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Then the per-CPU caches and their hit rates */
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                               "%10s%10s%10s%10s%10s\n",
+                               "cpu", "ncached", "hits", "misses", "hit%");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      uint64_t total = (uint64_t)stats.cpu[cpu].hits +
+                       stats.cpu[cpu].misses;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
+                                   "%10d%10d%10" PRIu32 "%10" PRIu32
+                                   "%10u\n",
+                                   cpu, stats.cpu[cpu].ncached,
+                                   stats.cpu[cpu].hits,
+                                   stats.cpu[cpu].misses,
+                                   total != 0 ? (unsigned int)
+                                   (stats.cpu[cpu].hits * 100 / total) :
+                                   0);
+
+      copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -108,6 +108,10 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
 #endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                             size_t buflen);
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+static ssize_t memstat_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+#endif
 static int     meminfo_dup(FAR const struct file *oldp,
                            FAR struct file *newp);
 static int     meminfo_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -153,6 +157,23 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+const struct procfs_operations g_memstat_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memstat_read,   /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -346,6 +367,68 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+  /* Followed by the latencies and the free chunk histogram of each heap */
+
+  if (buflen > 0)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                   "\n%11s%11s%11s%11s%11s%11s%s\n",
+                                   "malloc_p50", "malloc_p99", "malloc_max",
+                                   "free_p50", "free_p99", "free_max",
+                                   " name (ns)");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (buflen > 0 && entry->mallinfo == NULL)
+        {
+          struct mm_telemetry_s stat;
+          int i;
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          mm_telemetry(entry->heap, &stat);
+
+          linesize   = procfs_snprintf(procfile->line, MEMINFO_LINELEN,
+                                       "%11lu%11lu%11lu%11lu%11lu%11lu"
+                                       " %s\n  free chunks:",
+                                       stat.malloc_p50, stat.malloc_p99,
+                                       stat.malloc_max, stat.free_p50,
+                                       stat.free_p99, stat.free_max,
+                                       entry->name);
+
+          for (i = 0; i < MM_TELEMETRY_NBUCKETS; i++)
+            {
+              if (stat.freehist[i] != 0)
+                {
+                  linesize += procfs_snprintf(procfile->line + linesize,
+                                              MEMINFO_LINELEN - linesize,
+                                              " %lu:%lu",
+                                              1ul << i,
+                                              (unsigned long)
+                                              stat.freehist[i]);
+                }
+            }
+
+          linesize  += procfs_snprintf(procfile->line + linesize,
+                                       MEMINFO_LINELEN - linesize,
+                                       "\n  largest free: %lu\n",
+                                       (unsigned long)stat.mxordblk);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+#endif
+
 #ifdef CONFIG_MM_PGALLOC
   if (buflen > 0)
     {
@@ -410,6 +493,47 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: memstat_read
+ *
+ * Description:
+ *   Return one binary struct mm_telemetry_s per heap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+static ssize_t memstat_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  struct mm_telemetry_s stat;
+  size_t copysize;
+  size_t totalsize = 0;
+  off_t offset = filep->f_pos;
+
+  for (entry = g_procfs_meminfo; entry != NULL && buflen > 0;
+       entry = entry->next)
+    {
+      if (entry->mallinfo != NULL)
+        {
+          continue;
+        }
+
+      mm_telemetry(entry->heap, &stat);
+      strlcpy(stat.name, entry->name, sizeof(stat.name));
+
+      copysize   = procfs_memcpy((FAR const char *)&stat, sizeof(stat),
+                                 buffer, buflen, &offset);
+      buffer    += copysize;
+      buflen    -= copysize;
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: memdump_read
  ****************************************************************************/
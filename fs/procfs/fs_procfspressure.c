@@ -26,9 +26,12 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <poll.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 
 #include <nuttx/fs/procfs.h>
@@ -36,14 +39,31 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
 #include <nuttx/spinlock.h>
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The files of the pressure directory */
+
+#define PRESSURE_RES_MEMORY 0
+#define PRESSURE_RES_CPU    1
+#define PRESSURE_RES_IO     2
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* A memory file notifies when the largest free block drops below
+ * threshold, at most once per interval.  A cpu or io file notifies when
+ * the stall time of its state reaches threshold within the current
+ * window of interval ticks, at most once per window.
+ */
+
 struct pressure_file_s
 {
   struct procfs_file_s base;        /* Base open file structure */
@@ -52,13 +72,31 @@ struct pressure_file_s
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
   clock_t interval;                 /* Notification interval in us */
+  uint8_t res;                      /* See PRESSURE_RES_* definitions */
+#ifdef CONFIG_SCHED_PRESSURE
+  uint8_t state;                    /* Stall state of the trigger */
+  bool fired;                       /* Notified in the current window */
+  uint64_t stall;                   /* Stall total at the window start */
+#endif
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+static FAR const char * const g_pressure_names[] =
+{
+  "memory",
+#ifdef CONFIG_SCHED_PRESSURE
+  "cpu",
+  "io",
+#endif
+};
+
 static dq_queue_t g_pressure_memory_queue;
+#ifdef CONFIG_SCHED_PRESSURE
+static dq_queue_t g_pressure_stall_queue;
+#endif
 static spinlock_t g_pressure_lock;
 static size_t g_remaining;
 static size_t g_largest;
@@ -109,6 +147,171 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_find
+ *
+ * Description:
+ *   Return the PRESSURE_RES_* index of a file relpath or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int pressure_find(FAR const char *relpath)
+{
+  int res;
+
+  if (strncmp(relpath, "pressure/", 9) == 0)
+    {
+      for (res = 0; res < nitems(g_pressure_names); res++)
+        {
+          if (strcmp(relpath + 9, g_pressure_names[res]) == 0)
+            {
+              return res;
+            }
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: pressure_queue
+ ****************************************************************************/
+
+static FAR dq_queue_t *pressure_queue(FAR struct pressure_file_s *priv)
+{
+#ifdef CONFIG_SCHED_PRESSURE
+  if (priv->res != PRESSURE_RES_MEMORY)
+    {
+      return &g_pressure_stall_queue;
+    }
+#endif
+
+  return &g_pressure_memory_queue;
+}
+
+#ifdef CONFIG_SCHED_PRESSURE
+/****************************************************************************
+ * Name: pressure_format
+ *
+ * Description:
+ *   Format one "some" or "full" line of a cpu or io file.
+ *
+ ****************************************************************************/
+
+static size_t pressure_format(FAR char *buf, size_t buflen,
+                              FAR const char *name, int state)
+{
+  struct pressure_s pressure;
+
+  nxsched_get_pressure(state, &pressure);
+  return procfs_snprintf(buf, buflen,
+                         "%s avg10=%" PRIu32 ".%02" PRIu32
+                         " avg60=%" PRIu32 ".%02" PRIu32
+                         " avg300=%" PRIu32 ".%02" PRIu32
+                         " total=%" PRIu64 "\n", name,
+                         pressure.avg10 / 100, pressure.avg10 % 100,
+                         pressure.avg60 / 100, pressure.avg60 % 100,
+                         pressure.avg300 / 100, pressure.avg300 % 100,
+                         pressure.total);
+}
+
+/****************************************************************************
+ * Name: pressure_stall_write
+ *
+ * Description:
+ *   Set up the trigger of a cpu or io file, "some <stall> <window>" or
+ *   "full <stall> <window>" with both times in microseconds.
+ *
+ ****************************************************************************/
+
+static ssize_t pressure_stall_write(FAR struct pressure_file_s *priv,
+                                    FAR const char *buffer, size_t buflen)
+{
+  struct pressure_s pressure;
+  FAR char *endptr;
+  unsigned long threshold;
+  unsigned long window;
+  char buf[48];
+  uint32_t flags;
+  int state;
+
+  memcpy(buf, buffer, MIN(buflen, sizeof(buf) - 1));
+  buf[MIN(buflen, sizeof(buf) - 1)] = '\0';
+
+  if (strncmp(buf, "some ", 5) == 0)
+    {
+      state = priv->res == PRESSURE_RES_CPU ? PRESSURE_CPU_SOME :
+                                              PRESSURE_IO_SOME;
+    }
+  else if (strncmp(buf, "full ", 5) == 0 && priv->res == PRESSURE_RES_IO)
+    {
+      state = PRESSURE_IO_FULL;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  threshold = strtoul(buf + 5, &endptr, 0);
+  window    = strtoul(endptr, NULL, 0);
+  if (threshold == 0 || window == 0 || threshold > window)
+    {
+      return -EINVAL;
+    }
+
+  nxsched_get_pressure(state, &pressure);
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  priv->state     = state;
+  priv->threshold = threshold;
+  priv->interval  = USEC2TICK(window);
+  priv->lasttick  = clock_systime_ticks();
+  priv->stall     = pressure.total;
+  priv->fired     = false;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: pressure_stall_check
+ *
+ * Description:
+ *   Start a new window of a cpu or io trigger when the current one is over
+ *   and return true if the trigger should notify now.  Called with
+ *   g_pressure_lock held.
+ *
+ ****************************************************************************/
+
+static bool pressure_stall_check(FAR struct pressure_file_s *priv,
+                                 FAR const uint64_t *total, clock_t current)
+{
+  if (priv->threshold == 0)
+    {
+      return false;
+    }
+
+  if (current - priv->lasttick >= priv->interval)
+    {
+      priv->lasttick = current;
+      priv->stall    = total[priv->state];
+      priv->fired    = false;
+    }
+
+  /* If fds is NULL, it means no one is listening for the event and
+   * we should delay sending the notification.
+   */
+
+  if (priv->fired || priv->fds == NULL ||
+      total[priv->state] - priv->stall < priv->threshold)
+    {
+      return false;
+    }
+
+  priv->fired = true;
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -118,8 +321,10 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct pressure_file_s *priv;
   uint32_t flags;
+  int res;
 
-  if (strcmp(relpath, "pressure/memory") != 0)
+  res = pressure_find(relpath);
+  if (res < 0)
     {
       ferr("ERROR: relpath is invalid: %s\n", relpath);
       return -ENOENT;
@@ -133,8 +338,9 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   priv->interval = CLOCK_MAX;
-  filep->f_priv = priv;
-  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+  priv->res      = res;
+  filep->f_priv  = priv;
+  dq_addfirst(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
 }
@@ -149,7 +355,7 @@ static int pressure_close(FAR struct file *filep)
   uint32_t flags;
 
   flags = spin_lock_irqsave(&g_pressure_lock);
-  dq_rem(&priv->entry, &g_pressure_memory_queue);
+  dq_rem(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   fs_heap_free(priv);
   return OK;
@@ -162,20 +368,37 @@ static int pressure_close(FAR struct file *filep)
 static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen)
 {
-  char buf[128];
+  FAR struct pressure_file_s *priv = filep->f_priv;
+  char buf[192];
   uint32_t flags;
   size_t remain;
   size_t largest;
   off_t offset;
   ssize_t ret;
 
-  flags   = spin_lock_irqsave(&g_pressure_lock);
-  remain  = g_remaining;
-  largest = g_largest;
-  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  if (priv->res == PRESSURE_RES_MEMORY)
+    {
+      flags   = spin_lock_irqsave(&g_pressure_lock);
+      remain  = g_remaining;
+      largest = g_largest;
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
 
-  ret = procfs_snprintf(buf, sizeof(buf), "remaining %zu, largest:%zu\n",
-                        remain, largest);
+      ret = procfs_snprintf(buf, sizeof(buf),
+                            "remaining %zu, largest:%zu\n",
+                            remain, largest);
+    }
+#ifdef CONFIG_SCHED_PRESSURE
+  else if (priv->res == PRESSURE_RES_CPU)
+    {
+      ret = pressure_format(buf, sizeof(buf), "some", PRESSURE_CPU_SOME);
+    }
+  else
+    {
+      ret  = pressure_format(buf, sizeof(buf), "some", PRESSURE_IO_SOME);
+      ret += pressure_format(buf + ret, sizeof(buf) - ret, "full",
+                             PRESSURE_IO_FULL);
+    }
+#endif
 
   if (ret > buflen)
     {
@@ -207,6 +430,13 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_PRESSURE
+  if (priv->res != PRESSURE_RES_MEMORY)
+    {
+      return pressure_stall_write(priv, buffer, buflen);
+    }
+#endif
+
   threshold = strtoul(buffer, &endptr, 0);
   if (threshold == 0)
     {
@@ -247,6 +477,21 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
   FAR struct pressure_file_s *priv = filep->f_priv;
   clock_t current = clock_systime_ticks();
   uint32_t flags;
+  bool notify;
+#ifdef CONFIG_SCHED_PRESSURE
+  uint64_t total[PRESSURE_NSTATES];
+  struct pressure_s pressure;
+  int i;
+
+  if (setup && priv->res != PRESSURE_RES_MEMORY)
+    {
+      for (i = 0; i < PRESSURE_NSTATES; i++)
+        {
+          nxsched_get_pressure(i, &pressure);
+          total[i] = pressure.total;
+        }
+    }
+#endif
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   if (setup)
@@ -256,15 +501,30 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
           priv->fds = fds;
           fds->priv = &priv->fds;
 
-          /* If the remaining memory is less than the threshold and
-           * lasttick is CLOCK_MAX, it means the event is triggered for
-           * the first time and we should always send a notification.
-           */
+#ifdef CONFIG_SCHED_PRESSURE
+          if (priv->res != PRESSURE_RES_MEMORY)
+            {
+              notify = pressure_stall_check(priv, total, current);
+            }
+          else
+#endif
+            {
+              /* If the remaining memory is less than the threshold and
+               * lasttick is CLOCK_MAX, it means the event is triggered for
+               * the first time and we should always send a notification.
+               */
+
+              notify = g_remaining <= priv->threshold &&
+                       (priv->lasttick == CLOCK_MAX ||
+                        current - priv->lasttick >= priv->interval);
+              if (notify)
+                {
+                  priv->lasttick = current;
+                }
+            }
 
-          if (g_remaining <= priv->threshold && (priv->lasttick ==
-              CLOCK_MAX || current - priv->lasttick >= priv->interval))
+          if (notify)
             {
-              priv->lasttick = current;
               spin_unlock_irqrestore(&g_pressure_lock, flags);
               poll_notify(&priv->fds, 1, POLLPRI);
               return OK;
@@ -304,7 +564,7 @@ static int pressure_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   memcpy(newpriv, oldpriv, sizeof(struct pressure_file_s));
-  dq_addfirst(&newpriv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&newpriv->entry, pressure_queue(newpriv));
   newpriv->fds = NULL;
   newp->f_priv = newpriv;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
@@ -330,7 +590,7 @@ static int pressure_opendir(FAR const char *relpath,
     }
 
   level->level    = 1;
-  level->nentries = 1;
+  level->nentries = nitems(g_pressure_names);
 
   *dir = (FAR struct fs_dirent_s *)level;
   return OK;
@@ -365,7 +625,8 @@ static int pressure_readdir(FAR struct fs_dirent_s *dir,
     }
 
   entry->d_type = DTYPE_FILE;
-  strncpy(entry->d_name, "memory", sizeof(entry->d_name));
+  strlcpy(entry->d_name, g_pressure_names[level->index],
+          sizeof(entry->d_name));
   level->index++;
   return OK;
 }
@@ -396,7 +657,7 @@ static int pressure_stat(const char *relpath, struct stat *buf)
     {
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
-  else if (strcmp(relpath, "pressure/memory") == 0)
+  else if (pressure_find(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
                      S_IWGRP | S_IWUSR;
@@ -471,3 +732,35 @@ void mm_notify_pressure(size_t remaining, size_t largest)
   spin_unlock_irqrestore(&g_pressure_lock, flags);
 }
 
+#ifdef CONFIG_SCHED_PRESSURE
+/****************************************************************************
+ * nxsched_notify_pressure
+ ****************************************************************************/
+
+void nxsched_notify_pressure(FAR const uint64_t *total)
+{
+  clock_t current = clock_systime_ticks();
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *tmp;
+  uint32_t flags;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+
+  dq_for_every_safe(&g_pressure_stall_queue, entry, tmp)
+    {
+      FAR struct pressure_file_s *pressure =
+          container_of(entry, struct pressure_file_s, entry);
+
+      if (!pressure_stall_check(pressure, total, current))
+        {
+          continue;
+        }
+
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
+      poll_notify(&pressure->fds, 1, POLLPRI);
+      flags = spin_lock_irqsave(&g_pressure_lock);
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+#endif
@@ -768,6 +768,9 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
   size_t linesize;
   size_t copysize;
   size_t totalsize;
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+  int i;
+#endif
 
   remaining = buflen;
   totalsize = 0;
@@ -938,8 +941,39 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                            &offset);
 
   totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0 */
 
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* The maximum wakeup-to-run latency followed by the histogram */
+
+  perf_convert(tcb->wakeup_max, &maxtime);
+  tcb->wakeup_max = 0;
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN, "%lu.%09lu",
+                             (unsigned long)maxtime.tv_sec,
+                             (unsigned long)maxtime.tv_nsec);
+  for (i = 0; i < CRITMON_WAKEUP_NBUCKETS; i++)
+    {
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  STATUS_LINELEN - linesize, ",%" PRIu32,
+                                  tcb->wakeup_hist[i]);
+    }
+
+  linesize += procfs_snprintf(procfile->line + linesize,
+                              STATUS_LINELEN - linesize, "\n");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                            &offset);
+
+  totalsize += copysize;
+#endif
+
   return totalsize;
 }
 #endif
@@ -1197,6 +1231,10 @@ static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
   size_t linesize;
   size_t copysize;
   size_t totalsize;
+#ifdef CONFIG_SCHED_PRESSURE
+  uint64_t cpustall;
+  uint64_t iostall;
+#endif
 #ifdef HAVE_GROUP_MEMBERS
   FAR sq_entry_t *curr;
   FAR sq_entry_t *next;
@@ -1245,6 +1283,27 @@ static ssize_t proc_groupstatus(FAR struct proc_file_s *procfile,
   buffer    += copysize;
   remaining -= copysize;
 
+#ifdef CONFIG_SCHED_PRESSURE
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Total time in microseconds with at least one member stalled */
+
+  nxsched_get_grouppressure(group, &cpustall, &iostall);
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu64 "\n%-12s%" PRIu64 "\n",
+                               "CPU stall:", cpustall,
+                               "IO stall:", iostall);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                             remaining, &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+#endif
+
 #ifdef HAVE_GROUP_MEMBERS
   if (totalsize >= buflen)
     {
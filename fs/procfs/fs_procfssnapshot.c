@@ -0,0 +1,417 @@
+/****************************************************************************
+ * fs/procfs/fs_procfssnapshot.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SNAPSHOT_HDRSIZE   sizeof(struct procfs_snapshot_s)
+#define SNAPSHOT_TASKSIZE  sizeof(struct procfs_snapshot_task_s)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct snapshot_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  size_t size;                /* Size of the collected snapshot */
+  size_t alloc;               /* Allocated size of buffer */
+  FAR uint8_t *buffer;        /* The collected snapshot */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     snapshot_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     snapshot_close(FAR struct file *filep);
+static ssize_t snapshot_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+
+static int     snapshot_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+
+static int     snapshot_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_snapshot_operations =
+{
+  snapshot_open,      /* open */
+  snapshot_close,     /* close */
+  snapshot_read,      /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  snapshot_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  snapshot_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: snapshot_task
+ *
+ * Description:
+ *   Fill in the record of one task.  Called from within a critical
+ *   section, so it only copies fields.
+ *
+ ****************************************************************************/
+
+static void snapshot_task(FAR struct tcb_s *tcb,
+                          FAR struct procfs_snapshot_task_s *task)
+{
+  task->pid       = tcb->pid;
+  task->group     = tcb->group != NULL ? tcb->group->tg_pid : tcb->pid;
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  task->cputicks  = tcb->ticks;
+#else
+  task->cputicks  = 0;
+#endif
+  task->stacksize = tcb->adj_stack_size;
+  task->state     = tcb->task_state;
+  task->priority  = tcb->sched_priority;
+  task->type      = (tcb->flags & TCB_FLAG_TTYPE_MASK) >>
+                    TCB_FLAG_TTYPE_SHIFT;
+#ifdef CONFIG_SMP
+  task->cpu       = tcb->cpu;
+#else
+  task->cpu       = 0;
+#endif
+
+  strlcpy(task->name, get_task_name(tcb), PROCFS_SNAPSHOT_NAMELEN);
+}
+
+/****************************************************************************
+ * Name: snapshot_collect
+ *
+ * Description:
+ *   Collect a new snapshot into the open file buffer.  The task records
+ *   are copied in a single pass over the PID hash table with interrupts
+ *   disabled; the buffer is sized before, and the heap statistics are
+ *   gathered after, that critical section.
+ *
+ ****************************************************************************/
+
+static int snapshot_collect(FAR struct snapshot_file_s *attr)
+{
+  FAR struct procfs_snapshot_s *hdr;
+  FAR struct procfs_snapshot_task_s *task;
+  struct mallinfo info;
+  irqstate_t flags;
+  FAR uint8_t *buffer;
+  uint32_t ntasks;
+  size_t needed;
+  int ndx;
+
+  flags = enter_critical_section();
+
+  /* The PID hash table size bounds the number of tasks.  It may grow when
+   * the critical section is released to allocate memory, so check again.
+   */
+
+  while ((needed = SNAPSHOT_HDRSIZE +
+                   g_npidhash * SNAPSHOT_TASKSIZE) > attr->alloc)
+    {
+      leave_critical_section(flags);
+
+      buffer = fs_heap_realloc(attr->buffer, needed);
+      if (buffer == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      attr->buffer = buffer;
+      attr->alloc  = needed;
+
+      flags = enter_critical_section();
+    }
+
+  hdr  = (FAR struct procfs_snapshot_s *)attr->buffer;
+  task = (FAR struct procfs_snapshot_task_s *)(hdr + 1);
+
+  for (ndx = 0, ntasks = 0; ndx < g_npidhash; ndx++)
+    {
+      if (g_pidhash[ndx] != NULL)
+        {
+          snapshot_task(g_pidhash[ndx], &task[ntasks++]);
+        }
+    }
+
+#ifndef CONFIG_SCHED_CPULOAD_NONE
+  hdr->cputotal = g_cpuload_total;
+#else
+  hdr->cputotal = 0;
+#endif
+  hdr->systicks = clock_systime_ticks();
+
+  leave_critical_section(flags);
+
+  info = kmm_mallinfo();
+
+  hdr->version      = PROCFS_SNAPSHOT_VERSION;
+  hdr->hdrsize      = SNAPSHOT_HDRSIZE;
+  hdr->tasksize     = SNAPSHOT_TASKSIZE;
+#ifdef CONFIG_SMP
+  hdr->ncpus        = CONFIG_SMP_NCPUS;
+#else
+  hdr->ncpus        = 1;
+#endif
+  hdr->ntasks       = ntasks;
+  hdr->heap_arena   = info.arena;
+  hdr->heap_used    = info.uordblks;
+  hdr->heap_free    = info.fordblks;
+  hdr->heap_largest = info.mxordblk;
+
+  attr->size = SNAPSHOT_HDRSIZE + ntasks * SNAPSHOT_TASKSIZE;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_open
+ ****************************************************************************/
+
+static int snapshot_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct snapshot_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct snapshot_file_s));
+  if (attr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_close
+ ****************************************************************************/
+
+static int snapshot_close(FAR struct file *filep)
+{
+  FAR struct snapshot_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the snapshot and the file attributes structure */
+
+  fs_heap_free(attr->buffer);
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_read
+ ****************************************************************************/
+
+static ssize_t snapshot_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct snapshot_file_s *attr;
+  off_t offset;
+  ssize_t ret;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Collect a new snapshot when reading from the start.  Otherwise keep
+   * returning the one collected before, so that it stays consistent
+   * however small the reads are.
+   */
+
+  if (filep->f_pos == 0)
+    {
+      ret = snapshot_collect(attr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  offset = filep->f_pos;
+  ret = procfs_memcpy((FAR const char *)attr->buffer, attr->size,
+                      buffer, buflen, &offset);
+
+  /* Update the file offset */
+
+  if (ret > 0)
+    {
+      filep->f_pos += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snapshot_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int snapshot_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct snapshot_file_s *oldattr;
+  FAR struct snapshot_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_zalloc(sizeof(struct snapshot_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Copy the snapshot collected so far */
+
+  if (oldattr->size > 0)
+    {
+      newattr->buffer = fs_heap_malloc(oldattr->size);
+      if (newattr->buffer == NULL)
+        {
+          fs_heap_free(newattr);
+          return -ENOMEM;
+        }
+
+      memcpy(newattr->buffer, oldattr->buffer, oldattr->size);
+      newattr->size  = oldattr->size;
+      newattr->alloc = oldattr->size;
+    }
+
+  newattr->base = oldattr->base;
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snapshot_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int snapshot_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "snapshot" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* CONFIG_FS_PROCFS_INCLUDE_SNAPSHOT */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <sys/statfs.h>
 #include <sys/stat.h>
 
@@ -71,6 +72,8 @@ struct romfs_dir_s
 static int     romfs_open(FAR struct file *filep, FAR const char *relpath,
                           int oflags, mode_t mode);
 static int     romfs_close(FAR struct file *filep);
+static ssize_t romfs_readat(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen, FAR off_t *pos);
 static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen);
 static off_t   romfs_seek(FAR struct file *filep, off_t offset, int whence);
@@ -107,6 +110,13 @@ static int     romfs_stat_common(uint8_t type, uint32_t size,
 static int     romfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                           FAR struct stat *buf);
 
+#ifdef CONFIG_FS_PAGECACHE
+static int     romfs_pagekey(FAR const struct file *filep,
+                             FAR uint64_t *key);
+static ssize_t romfs_readpage(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen, off_t offset);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -149,7 +159,13 @@ const struct mountpt_operations g_romfs_operations =
   NULL,            /* rmdir */
   NULL,            /* rename */
   romfs_stat,      /* stat */
-  NULL             /* chstat */
+  NULL,            /* chstat */
+  NULL,            /* syncfs */
+#ifdef CONFIG_FS_PAGECACHE
+  romfs_pagekey,   /* pagekey */
+  romfs_readpage,  /* readpage */
+  NULL             /* writepage */
+#endif
 };
 
 /****************************************************************************
@@ -358,11 +374,15 @@ static int romfs_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: romfs_read
+ * Name: romfs_readat
+ *
+ * Description:
+ *   Read from an open file at *pos, and move *pos past the data.
+ *
  ****************************************************************************/
 
-static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
-                          size_t buflen)
+static ssize_t romfs_readat(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen, FAR off_t *pos)
 {
   FAR struct romfs_mountpt_s *rm;
   FAR struct romfs_file_s    *rf;
@@ -376,7 +396,7 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
   int                         sectorndx;
   int                         ret;
 
-  finfo("Read %zu bytes from offset %jd\n", buflen, (intmax_t)filep->f_pos);
+  finfo("Read %zu bytes from offset %jd\n", buflen, (intmax_t)*pos);
 
   /* Sanity checks */
 
@@ -406,7 +426,7 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Get the number of bytes left in the file */
 
-  bytesleft = rf->rf_size - filep->f_pos;
+  bytesleft = rf->rf_size - *pos;
 
   /* Truncate read count so that it does not exceed the number
    * of bytes left in the file.
@@ -425,7 +445,7 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
     {
       /* Get the first sector and index to read from. */
 
-      offset    = rf->rf_startoffset + filep->f_pos;
+      offset    = rf->rf_startoffset + *pos;
       sector    = SEC_NSECTORS(rm, offset);
       sectorndx = offset & SEC_NDXMASK(rm);
 
@@ -488,10 +508,10 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
 
       /* Set up for the next sector read */
 
-      userbuffer   += bytesread;
-      filep->f_pos += bytesread;
-      readsize     += bytesread;
-      buflen       -= bytesread;
+      userbuffer += bytesread;
+      *pos       += bytesread;
+      readsize   += bytesread;
+      buflen     -= bytesread;
     }
 
 errout_with_lock:
@@ -499,6 +519,58 @@ errout_with_lock:
   return readsize ? readsize : ret;
 }
 
+/****************************************************************************
+ * Name: romfs_read
+ ****************************************************************************/
+
+static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  return romfs_readat(filep, buffer, buflen, &filep->f_pos);
+}
+
+#ifdef CONFIG_FS_PAGECACHE
+/****************************************************************************
+ * Name: romfs_pagekey
+ *
+ * Description:
+ *   Images in directly addressable memory are not worth caching, otherwise
+ *   the start of the file data identifies a file.
+ *
+ ****************************************************************************/
+
+static int romfs_pagekey(FAR const struct file *filep, FAR uint64_t *key)
+{
+  FAR struct romfs_mountpt_s *rm = filep->f_inode->i_private;
+  FAR struct romfs_file_s    *rf = filep->f_priv;
+
+  if (rm->rm_xipbase != NULL)
+    {
+      return -ENOSYS;
+    }
+
+  *key = rf->rf_startoffset;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: romfs_readpage
+ ****************************************************************************/
+
+static ssize_t romfs_readpage(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  FAR struct romfs_file_s *rf = filep->f_priv;
+
+  if (offset >= rf->rf_size)
+    {
+      return 0;
+    }
+
+  return romfs_readat(filep, buffer, buflen, &offset);
+}
+#endif
+
 /****************************************************************************
  * Name: romfs_seek
  ****************************************************************************/
@@ -641,9 +713,15 @@ static int romfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   rm = filep->f_inode->i_private;
 
   /* Return the address on the media corresponding to the start of
-   * the file.
+   * the file.  The media is read-only, so a private writable mapping
+   * needs a copy in RAM.
    */
 
+  if ((map->prot & PROT_WRITE) != 0 && (map->flags & MAP_PRIVATE) != 0)
+    {
+      return -ENOTTY;
+    }
+
   if (rm->rm_xipbase && map->offset >= 0 && map->offset < rf->rf_size &&
       map->length != 0 && map->offset + map->length <= rf->rf_size)
     {
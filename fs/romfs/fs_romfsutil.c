@@ -38,6 +38,7 @@
 
 #include <nuttx/crc16.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
 #include <nuttx/fs/ioctl.h>
 
 #include "fs_romfs.h"
@@ -575,8 +576,11 @@ int romfs_hwread(FAR struct romfs_mountpt_s *rm, FAR uint8_t *buffer,
       /* In non-XIP mode, we have to read the data from the device */
 
       FAR struct inode *inode = rm->rm_blkdriver;
-      ssize_t nsectorsread =
-        inode->u.i_bops->read(inode, buffer, sector, nsectors);
+      ssize_t nsectorsread;
+
+      nxsched_iowait_enter();
+      nsectorsread = inode->u.i_bops->read(inode, buffer, sector, nsectors);
+      nxsched_iowait_leave();
 
       if (nsectorsread < 0)
         {
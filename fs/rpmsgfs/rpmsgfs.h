@@ -60,6 +60,8 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READ_BULK       23
+#define RPMSGFS_WRITE_BULK      24
 
 /****************************************************************************
  * Public Types
@@ -216,6 +218,18 @@ begin_packed_struct struct rpmsgfs_fchstat_s
 
 #define rpmsgfs_chstat_s rpmsgfs_fchstat_s
 
+/* Large reads and writes transfer the data in place through shared
+ * memory: addr is the physical address of the client's buffer.
+ */
+
+begin_packed_struct struct rpmsgfs_bulk_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                count;
+  uint64_t                addr;
+} end_packed_struct;
+
 /****************************************************************************
  * Internal function prototypes
  ****************************************************************************/
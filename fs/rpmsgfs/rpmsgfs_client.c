@@ -32,6 +32,8 @@
 #include <termios.h>
 #include <fcntl.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rpmsg/rpmsg.h>
@@ -120,6 +122,10 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+#ifdef CONFIG_FS_RPMSGFS_BULK
+  [RPMSGFS_READ_BULK]  = rpmsgfs_default_handler,
+  [RPMSGFS_WRITE_BULK] = rpmsgfs_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -479,6 +485,31 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_BULK
+  if (count >= CONFIG_FS_RPMSGFS_BULK_THRESHOLD)
+    {
+      struct rpmsgfs_bulk_s bulk;
+
+      /* The server reads straight into buf: drop our view of it, and pick
+       * up whatever the server wrote once it is done.
+       */
+
+      bulk.fd    = fd;
+      bulk.count = count;
+      bulk.addr  = up_addrenv_va_to_pa(buf);
+
+      up_flush_dcache((uintptr_t)buf, (uintptr_t)buf + count);
+      ret = rpmsgfs_send_recv(priv, RPMSGFS_READ_BULK, true,
+                              &bulk.header, sizeof(bulk), NULL);
+      if (ret > 0)
+        {
+          up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + ret);
+        }
+
+      return ret;
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
 
   nxsem_init(&cookie.sem, 0, 0);
@@ -522,6 +553,23 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_BULK
+  if (count >= CONFIG_FS_RPMSGFS_BULK_THRESHOLD)
+    {
+      struct rpmsgfs_bulk_s bulk;
+
+      /* The server writes straight from buf, make it visible first */
+
+      bulk.fd    = fd;
+      bulk.count = count;
+      bulk.addr  = up_addrenv_va_to_pa((FAR void *)buf);
+
+      up_clean_dcache((uintptr_t)buf, (uintptr_t)buf + count);
+      return rpmsgfs_send_recv(priv, RPMSGFS_WRITE_BULK, true,
+                               &bulk.header, sizeof(bulk), NULL);
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
   nxsem_init(&cookie.sem, 0, 0);
 
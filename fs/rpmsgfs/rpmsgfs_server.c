@@ -34,6 +34,8 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -126,6 +128,14 @@ static int rpmsgfs_fchstat_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_chstat_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
+#ifdef CONFIG_FS_RPMSGFS_BULK
+static int rpmsgfs_read_bulk_handler(FAR struct rpmsg_endpoint *ept,
+                                     FAR void *data, size_t len,
+                                     uint32_t src, FAR void *priv);
+static int rpmsgfs_write_bulk_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv);
+#endif
 
 static bool rpmsgfs_ns_match(FAR struct rpmsg_device *rdev,
                              FAR void *priv_, FAR const char *name,
@@ -165,6 +175,10 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+#ifdef CONFIG_FS_RPMSGFS_BULK
+  [RPMSGFS_READ_BULK]  = rpmsgfs_read_bulk_handler,
+  [RPMSGFS_WRITE_BULK] = rpmsgfs_write_bulk_handler,
+#endif
 };
 
 /****************************************************************************
@@ -443,6 +457,73 @@ static int rpmsgfs_write_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+#ifdef CONFIG_FS_RPMSGFS_BULK
+static int rpmsgfs_read_bulk_handler(FAR struct rpmsg_endpoint *ept,
+                                     FAR void *data, size_t len,
+                                     uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_bulk_s *msg = data;
+  FAR char *buf = up_addrenv_pa_to_va(msg->addr);
+  FAR struct file *filep;
+  size_t nread = 0;
+  int ret = -ENOENT;
+
+  filep = rpmsgfs_get_file(priv, msg->fd);
+  if (filep != NULL)
+    {
+      while (nread < msg->count)
+        {
+          ret = file_read(filep, buf + nread, msg->count - nread);
+          if (ret <= 0)
+            {
+              break;
+            }
+
+          nread += ret;
+        }
+
+      /* Push the data out to the client */
+
+      up_clean_dcache((uintptr_t)buf, (uintptr_t)buf + nread);
+    }
+
+  msg->header.result = nread > 0 ? nread : ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+
+static int rpmsgfs_write_bulk_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_bulk_s *msg = data;
+  FAR char *buf = up_addrenv_pa_to_va(msg->addr);
+  FAR struct file *filep;
+  size_t written = 0;
+  int ret = -ENOENT;
+
+  filep = rpmsgfs_get_file(priv, msg->fd);
+  if (filep != NULL)
+    {
+      /* Don't look at stale lines of the client's buffer */
+
+      up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + msg->count);
+      while (written < msg->count)
+        {
+          ret = file_write(filep, buf + written, msg->count - written);
+          if (ret <= 0)
+            {
+              break;
+            }
+
+          written += ret;
+        }
+    }
+
+  msg->header.result = written > 0 ? written : ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 static int rpmsgfs_lseek_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv)
@@ -84,6 +84,23 @@ const struct file_operations g_shmfs_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: shmfs_populate
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+static int shmfs_populate(FAR struct shmfs_object_s *object)
+{
+  int ret;
+
+  inode_lock();
+  ret = shmfs_populate_object(object);
+  inode_unlock();
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: shmfs_read
  ****************************************************************************/
@@ -95,6 +112,9 @@ static ssize_t shmfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+  int ret;
+#endif
 
   DEBUGASSERT(filep->f_inode->i_private != NULL);
 
@@ -105,6 +125,14 @@ static ssize_t shmfs_read(FAR struct file *filep, FAR char *buffer,
       return 0;
     }
 
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+  ret = shmfs_populate(sho);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Handle attempts to read beyond the end of the file. */
 
   startpos = filep->f_pos;
@@ -143,6 +171,9 @@ static ssize_t shmfs_write(FAR struct file *filep, FAR const char *buffer,
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+  int ret;
+#endif
 
   DEBUGASSERT(filep->f_inode->i_private != NULL);
 
@@ -161,6 +192,14 @@ static ssize_t shmfs_write(FAR struct file *filep, FAR const char *buffer,
       return -EFBIG;
     }
 
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+  ret = shmfs_populate(sho);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Copy data from the user buffer to the memory object */
 
   if (sho->paddr != NULL)
@@ -355,7 +394,13 @@ static int shmfs_mmap(FAR struct file *filep,
   object = filep->f_inode->i_private;
   if (object)
     {
-      ret = shmfs_map_object(object, &entry->vaddr);
+#ifdef CONFIG_FS_SHMFS_LAZY_ALLOC
+      ret = shmfs_populate(object);
+      if (ret >= 0)
+#endif
+        {
+          ret = shmfs_map_object(object, &entry->vaddr);
+        }
     }
 
   if (ret < 0 ||
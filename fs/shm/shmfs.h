@@ -69,4 +69,8 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length);
 
 void shmfs_free_object(FAR struct shmfs_object_s *object);
 
+#ifdef CONFIG_BUILD_KERNEL
+int shmfs_populate_object(FAR struct shmfs_object_s *object);
+#endif
+
 #endif
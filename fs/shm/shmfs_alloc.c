@@ -107,8 +107,6 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
    * physical address
    */
 
-  size_t i = 0;
-  FAR void **pages;
   size_t n_pages = MM_NPAGES(length);
 
   object = fs_heap_zalloc(sizeof(struct shmfs_object_s) +
@@ -116,26 +114,16 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
 
   if (object)
     {
-      pages = &object->paddr;
-      for (; i < n_pages; i++)
-        {
-          pages[i] = (FAR void *)mm_pgalloc(1);
-          if (!pages[i])
-            {
-              break;
-            }
-          else
-            {
-              /* Clear the page memory (requirement for truncate) */
+      object->length = length;
 
-              up_addrenv_page_wipe((uintptr_t)pages[i]);
-            }
-        }
-    }
+      /* With lazy allocation the pages are populated on first use */
 
-  if (i == n_pages)
-    {
-      allocated = true;
+#ifndef CONFIG_FS_SHMFS_LAZY_ALLOC
+      if (shmfs_populate_object(object) >= 0)
+#endif
+        {
+          allocated = true;
+        }
     }
 #endif
 
@@ -154,6 +142,87 @@ FAR struct shmfs_object_s *shmfs_alloc_object(size_t length)
   return object;
 }
 
+#ifdef CONFIG_BUILD_KERNEL
+/****************************************************************************
+ * Name: shmfs_populate_object
+ *
+ * Description:
+ *   Allocate and zero the physical pages of the object that are not yet
+ *   allocated.  The pages are taken in aligned runs of
+ *   CONFIG_FS_SHMFS_LARGE_PAGES where possible.  Pages allocated before a
+ *   failure are kept, a later call continues with the missing ones.
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if not all pages could be allocated.
+ *
+ ****************************************************************************/
+
+int shmfs_populate_object(FAR struct shmfs_object_s *object)
+{
+  FAR void **pages = &object->paddr;
+  size_t n_pages = MM_NPAGES(object->length);
+  uintptr_t paddr;
+  size_t i = 0;
+  size_t j;
+  size_t n;
+
+  while (i < n_pages)
+    {
+      if (pages[i] != NULL)
+        {
+          i++;
+          continue;
+        }
+
+      paddr = 0;
+      n     = 1;
+
+#if CONFIG_FS_SHMFS_LARGE_PAGES > 1
+      if (i % CONFIG_FS_SHMFS_LARGE_PAGES == 0 &&
+          n_pages - i >= CONFIG_FS_SHMFS_LARGE_PAGES)
+        {
+          for (n = 1; n < CONFIG_FS_SHMFS_LARGE_PAGES; n++)
+            {
+              if (pages[i + n] != NULL)
+                {
+                  break;
+                }
+            }
+
+          if (n == CONFIG_FS_SHMFS_LARGE_PAGES)
+            {
+              paddr = mm_pgalloc_align(n, n);
+            }
+
+          if (paddr == 0)
+            {
+              n = 1;
+            }
+        }
+#endif
+
+      if (paddr == 0)
+        {
+          paddr = mm_pgalloc(1);
+          if (paddr == 0)
+            {
+              return -ENOMEM;
+            }
+        }
+
+      /* Clear the page memory (requirement for truncate) */
+
+      for (j = 0; j < n; j++, i++)
+        {
+          pages[i] = (FAR void *)(paddr + j * MM_PGSIZE);
+          up_addrenv_page_wipe((uintptr_t)pages[i]);
+        }
+    }
+
+  return OK;
+}
+#endif
+
 void shmfs_free_object(FAR struct shmfs_object_s *object)
 {
   if (object)
@@ -137,10 +137,8 @@ struct spiffs_s
   uint32_t stats_gc_runs;
 #endif
   uint32_t cache_size;              /* Cache size */
-#ifdef CONFIG_SPIFFS_CACHEDBG
   uint32_t cache_hits;              /* Number of cache hits */
   uint32_t cache_misses;            /* Number of cache misses */
-#endif
   int16_t free_blkndx;              /* Cursor for free blocks, block index */
   int16_t lu_blkndx;                /* Cursor when searching, block index */
   int16_t max_erase_count;          /* Max erase count amongst all blocks */
@@ -415,9 +415,7 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
 
       /* We've already got a cache page */
 
-#ifdef CONFIG_SPIFFS_CACHEDBG
       fs->cache_hits++;
-#endif
 
       cp->last_access = cache->last_access;
       mem             = spiffs_get_cache_page(fs, cache, cp->cpndx);
@@ -437,9 +435,7 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
         }
       else
         {
-#ifdef CONFIG_SPIFFS_CACHEDBG
           fs->cache_misses++;
-#endif
 
           /* This operation will always free one cache page (unless all
            * already free), the result code stems from the write operation
@@ -1030,6 +1030,30 @@ static int spiffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+      /* Return the read cache statistics.
+       * IN:  FAR struct fs_cachestats_s *
+       * OUT: None
+       */
+
+      case FIOC_CACHESTATS:
+        {
+          FAR struct fs_cachestats_s *stats =
+            (FAR struct fs_cachestats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              stats->hits   = fs->cache_hits;
+              stats->misses = fs->cache_misses;
+              stats->size   = fs->cache_size;
+              ret           = OK;
+            }
+        }
+        break;
+
       default:
 
         /* Pass through to the contained MTD driver */
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -58,6 +59,10 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+/* Number of extent descriptors added to a file at a time */
+
+#define TMPFS_EXTENT_GROW 8
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -94,6 +99,14 @@ struct tmpfs_dir_s
 
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
+static void tmpfs_free_extents(FAR struct tmpfs_file_s *tfo);
+static unsigned int tmpfs_find_extent(FAR struct tmpfs_file_s *tfo,
+                                      size_t pos, FAR size_t *offset);
+static void tmpfs_copyout_file(FAR struct tmpfs_file_s *tfo, size_t pos,
+                               FAR uint8_t *buffer, size_t nbytes);
+static void tmpfs_copyin_file(FAR struct tmpfs_file_s *tfo, size_t pos,
+                              FAR const uint8_t *buffer, size_t nbytes);
+static int  tmpfs_extend_file(FAR struct tmpfs_file_s *tfo, size_t newsize);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
@@ -269,80 +282,305 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_free_extents
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
-                              size_t newsize)
+static void tmpfs_free_extents(FAR struct tmpfs_file_s *tfo)
 {
-  FAR uint8_t *newdata;
-  size_t allocsize;
-  size_t delta;
+  while (tfo->tfo_nextents > 0)
+    {
+      fs_heap_free(tfo->tfo_extents[--tfo->tfo_nextents].tex_data);
+    }
 
-  /* Are we growing or shrinking the object? */
+  fs_heap_free(tfo->tfo_extents);
+  tfo->tfo_extents    = NULL;
+  tfo->tfo_maxextents = 0;
+  tfo->tfo_alloc      = 0;
+  tfo->tfo_size       = 0;
+}
 
-  if (newsize <= tfo->tfo_alloc)
+/****************************************************************************
+ * Name: tmpfs_find_extent
+ *
+ * Description:
+ *   Return the index of the extent holding the file byte at 'pos', which
+ *   must be below tfo_alloc, and the offset of that byte in the extent.
+ *
+ ****************************************************************************/
+
+static unsigned int tmpfs_find_extent(FAR struct tmpfs_file_s *tfo,
+                                      size_t pos, FAR size_t *offset)
+{
+  unsigned int i;
+
+  for (i = 0; pos >= tfo->tfo_extents[i].tex_size; i++)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      pos -= tfo->tfo_extents[i].tex_size;
+    }
 
-      if (newsize == 0)
-        {
-          /* Free the file object */
+  DEBUGASSERT(i < tfo->tfo_nextents);
+  *offset = pos;
+  return i;
+}
+
+/****************************************************************************
+ * Name: tmpfs_copyout_file
+ ****************************************************************************/
+
+static void tmpfs_copyout_file(FAR struct tmpfs_file_s *tfo, size_t pos,
+                               FAR uint8_t *buffer, size_t nbytes)
+{
+  FAR struct tmpfs_extent_s *tex;
+  unsigned int i;
+  size_t offset;
+  size_t ncopy;
+
+  if (nbytes == 0)
+    {
+      return;
+    }
+
+  for (i = tmpfs_find_extent(tfo, pos, &offset); nbytes > 0; i++)
+    {
+      tex   = &tfo->tfo_extents[i];
+      ncopy = MIN(nbytes, tex->tex_size - offset);
+      memcpy(buffer, tex->tex_data + offset, ncopy);
+
+      buffer += ncopy;
+      nbytes -= ncopy;
+      offset  = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_copyin_file
+ *
+ * Description:
+ *   Copy data into allocated file memory, or zero it if buffer is NULL.
+ *
+ ****************************************************************************/
+
+static void tmpfs_copyin_file(FAR struct tmpfs_file_s *tfo, size_t pos,
+                              FAR const uint8_t *buffer, size_t nbytes)
+{
+  FAR struct tmpfs_extent_s *tex;
+  unsigned int i;
+  size_t offset;
+  size_t ncopy;
+
+  if (nbytes == 0)
+    {
+      return;
+    }
 
-          fs_heap_free(tfo->tfo_data);
-          tfo->tfo_data = NULL;
-          tfo->tfo_alloc = 0;
-          tfo->tfo_size = 0;
-          return OK;
+  for (i = tmpfs_find_extent(tfo, pos, &offset); nbytes > 0; i++)
+    {
+      tex   = &tfo->tfo_extents[i];
+      ncopy = MIN(nbytes, tex->tex_size - offset);
+      if (buffer != NULL)
+        {
+          memcpy(tex->tex_data + offset, buffer, ncopy);
+          buffer += ncopy;
         }
-      else if (newsize > 0)
+      else
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          memset(tex->tex_data + offset, 0, ncopy);
+        }
 
-          delta = tfo->tfo_alloc - newsize;
+      nbytes -= ncopy;
+      offset  = 0;
+    }
+}
 
-          /* We should make sure the shrunked memory be zero */
+/****************************************************************************
+ * Name: tmpfs_extend_file
+ *
+ * Description:
+ *   Add extents until the file has at least newsize bytes of memory.  The
+ *   file size and the new memory are left untouched.
+ *
+ ****************************************************************************/
 
-          memset(tfo->tfo_data + newsize, 0, delta);
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+static int tmpfs_extend_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
+{
+  FAR struct tmpfs_extent_s *extents;
+  FAR uint8_t *data;
+  size_t needed;
+  size_t extsize;
+
+  while (tfo->tfo_alloc < newsize)
+    {
+      if (tfo->tfo_nextents >= tfo->tfo_maxextents)
+        {
+          if (tfo->tfo_maxextents > UINT16_MAX - TMPFS_EXTENT_GROW)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              return -ENOMEM;
+            }
 
-              tfo->tfo_size = newsize;
-              return OK;
+          extents = fs_heap_realloc(tfo->tfo_extents,
+                                    (tfo->tfo_maxextents +
+                                     TMPFS_EXTENT_GROW) *
+                                    sizeof(struct tmpfs_extent_s));
+          if (extents == NULL)
+            {
+              return -ENOMEM;
             }
+
+          tfo->tfo_extents     = extents;
+          tfo->tfo_maxextents += TMPFS_EXTENT_GROW;
+        }
+
+      /* Added some additional amount to the needed size to account
+       * frequent appends, but never make an extent smaller than a quarter
+       * of the memory the file already has.  The number of extents then
+       * only grows with the logarithm of the file size.
+       */
+
+      needed  = newsize - tfo->tfo_alloc;
+      extsize = needed + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+      if (extsize < needed)
+        {
+          /* There must have been an integer overflow */
+
+          return -ENOMEM;
+        }
+
+      if (extsize < tfo->tfo_alloc / 4)
+        {
+          extsize = tfo->tfo_alloc / 4;
+        }
+
+      data = fs_heap_malloc(extsize);
+      if (data == NULL && extsize > needed)
+        {
+          /* Fragmented heap?  Try again with what is really needed */
+
+          extsize = needed;
+          data    = fs_heap_malloc(extsize);
+        }
+
+      if (data == NULL)
+        {
+          return -ENOMEM;
         }
+
+      tfo->tfo_extents[tfo->tfo_nextents].tex_data = data;
+      tfo->tfo_extents[tfo->tfo_nextents].tex_size = extsize;
+      tfo->tfo_nextents++;
+      tfo->tfo_alloc += extsize;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the file size.  Memory added to the file is zeroed.
+ *
+ ****************************************************************************/
+
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR struct tmpfs_extent_s *tex;
+  FAR uint8_t *newdata;
+  unsigned int last;
+  size_t offset;
+  size_t used;
+  int ret;
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
-  if (allocsize < newsize)
+  if (newsize == 0)
     {
-      /* There must have been an integer overflow */
+      /* Free all of the file memory */
 
-      return -ENOMEM;
+      tmpfs_free_extents(tfo);
+      return OK;
+    }
+
+  if (newsize > tfo->tfo_size)
+    {
+      /* Growing ... Add memory as needed and zero the new part */
+
+      ret = tmpfs_extend_file(tfo, newsize);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      tmpfs_copyin_file(tfo, tfo->tfo_size, NULL, newsize - tfo->tfo_size);
+      tfo->tfo_size = newsize;
+      return OK;
+    }
+
+  /* Shrinking ... Free the extents past the new end of file */
+
+  last = tmpfs_find_extent(tfo, newsize - 1, &offset);
+  while (tfo->tfo_nextents > last + 1)
+    {
+      tex = &tfo->tfo_extents[--tfo->tfo_nextents];
+      tfo->tfo_alloc -= tex->tex_size;
+      fs_heap_free(tex->tex_data);
+    }
+
+  /* Don't realloc the new last extent unless it has shrunk by a lot */
+
+  tex  = &tfo->tfo_extents[last];
+  used = offset + 1;
+  if (tex->tex_size - used > CONFIG_FS_TMPFS_FILE_FREEGUARD)
+    {
+      newdata = fs_heap_realloc(tex->tex_data,
+                                used + CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
+      if (newdata != NULL)
+        {
+          tfo->tfo_alloc -= tex->tex_size;
+          tex->tex_data   = newdata;
+          tex->tex_size   = used + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+          tfo->tfo_alloc += tex->tex_size;
+        }
     }
 
-  /* Realloc the file object */
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_flatten_file
+ *
+ * Description:
+ *   Gather the file data into a single extent, as needed for mapping it.
+ *
+ ****************************************************************************/
+
+static int tmpfs_flatten_file(FAR struct tmpfs_file_s *tfo)
+{
+  FAR uint8_t *data;
+  size_t allocsize;
+
+  if (tfo->tfo_nextents <= 1)
+    {
+      return OK;
+    }
 
-  newdata = fs_heap_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  allocsize = tfo->tfo_size + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  data = fs_heap_malloc(allocsize);
+  if (data == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Return the new address of the reallocated file object */
+  tmpfs_copyout_file(tfo, 0, data, tfo->tfo_size);
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
+  while (tfo->tfo_nextents > 0)
+    {
+      fs_heap_free(tfo->tfo_extents[--tfo->tfo_nextents].tex_data);
+    }
+
+  tfo->tfo_extents[0].tex_data = data;
+  tfo->tfo_extents[0].tex_size = allocsize;
+  tfo->tfo_nextents = 1;
+  tfo->tfo_alloc    = allocsize;
   return OK;
 }
 
@@ -383,7 +621,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_extents(tfo);
       fs_heap_free(tfo);
     }
 
@@ -582,7 +820,10 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
-  tfo->tfo_data   = NULL;
+
+  tfo->tfo_nextents   = 0;
+  tfo->tfo_maxextents = 0;
+  tfo->tfo_extents    = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1265,7 +1506,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_extents(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1586,15 +1827,8 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  tmpfs_copyout_file(tfo, startpos, (FAR uint8_t *)buffer, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1647,26 +1881,30 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   if (endpos > tfo->tfo_size)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Add memory to handle the write past the end of the file.  There is
+       * no need to zero what is about to be overwritten, only the gap left
+       * by a seek past the end of the file.
+       */
 
-      ret = tmpfs_realloc_file(tfo, (size_t)endpos);
+      ret = tmpfs_extend_file(tfo, (size_t)endpos);
       if (ret < 0)
         {
           goto errout_with_lock;
         }
-    }
 
-  /* Copy data from the memory object to the user buffer */
+      if (startpos > tfo->tfo_size)
+        {
+          tmpfs_copyin_file(tfo, tfo->tfo_size, NULL,
+                            startpos - tfo->tfo_size);
+        }
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      tfo->tfo_size = endpos;
     }
 
+  /* Copy data from the user buffer to the memory object */
+
+  tmpfs_copyin_file(tfo, startpos, (FAR const uint8_t *)buffer, nwritten);
+
   filep->f_pos = endpos;
 
   /* Release the lock on the file */
@@ -1785,22 +2023,31 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
 
   DEBUGASSERT(tfo != NULL);
 
+  tmpfs_lock_file(tfo);
+
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
-      map->priv.p = tfo;
-      map->munmap = tmpfs_unmap;
-      ret = mm_map_add(get_current_mm(), map);
+      /* The mapping needs the file data in one piece.  Appends made later
+       * go to new extents, so the mapped memory will not move.
+       */
+
+      ret = tmpfs_flatten_file(tfo);
+      if (ret >= 0)
+        {
+          map->vaddr = tfo->tfo_extents[0].tex_data + map->offset;
+          map->priv.p = tfo;
+          map->munmap = tmpfs_unmap;
+          ret = mm_map_add(get_current_mm(), map);
+        }
 
       if (ret >= 0)
         {
-          tmpfs_lock_file(tfo);
           tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
         }
     }
 
+  tmpfs_unlock_file(tfo);
   return ret;
 }
 
@@ -1842,8 +2089,21 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
-      *ptr = (uintptr_t)tfo->tfo_data;
-      return OK;
+      ret = tmpfs_lock_file(tfo);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ret = tmpfs_flatten_file(tfo);
+      if (ret >= 0)
+        {
+          *ptr = tfo->tfo_nextents > 0 ?
+                 (uintptr_t)tfo->tfo_extents[0].tex_data : 0;
+        }
+
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   return ret;
@@ -1968,7 +2228,9 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
+      /* The size is changing.. up or down.  Reallocate the file memory.
+       * Any newly added memory is zeroed.
+       */
 
       ret = tmpfs_realloc_file(tfo, (size_t)length);
       if (ret < 0)
@@ -1976,15 +2238,6 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
-       */
-
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
       ret = OK;
     }
 
@@ -2430,7 +2683,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_extents(tfo);
       fs_heap_free(tfo);
     }
 
@@ -105,6 +105,17 @@ struct tmpfs_directory_s
 
 #define SIZEOF_TMPFS_DIRECTORY(n) ((n) * sizeof(struct tmpfs_dirent_s))
 
+/* File data is held in a list of separately allocated extents.  All but
+ * the last extent are completely filled, so growing a file never moves the
+ * data already written.
+ */
+
+struct tmpfs_extent_s
+{
+  FAR uint8_t *tex_data;   /* Extent data */
+  size_t       tex_size;   /* Allocated size of the extent */
+};
+
 /* The form of a regular file memory object
  *
  * NOTE that in this very simplified implementation, there is no per-open
@@ -126,9 +137,11 @@ struct tmpfs_file_s
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;                /* See TFO_FLAG_* definitions */
+  uint16_t      tfo_nextents;             /* Number of extents in use */
+  uint16_t      tfo_maxextents;           /* Capacity of tfo_extents */
+  size_t        tfo_size;                 /* Valid file size */
+  FAR struct tmpfs_extent_s *tfo_extents; /* File data extents */
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -46,12 +46,27 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_UNIONFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_CACHE
+#  define CONFIG_FS_UNIONFS_LOOKUP_CACHE 0
+#endif
+
+/* Lookup cache results, the path is known to be missing on file system 1 */
+
+#define UNIONFS_LOOKUP_NONE    -1  /* On neither file system */
+#define UNIONFS_LOOKUP_UNKNOWN  0  /* Not cached, probe both */
+#define UNIONFS_LOOKUP_FS2      1  /* On file system 2 only */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -74,6 +89,17 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+/* This structure describes one lookup cache entry */
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Relative path, NULL if unused */
+  uint32_t ul_gen;                   /* Valid while it is ui_lookupgen */
+  int ul_result;                     /* UNIONFS_LOOKUP_NONE or _FS2 */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -82,6 +108,11 @@ struct unionfs_inode_s
   mutex_t ui_lock;                   /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  spinlock_t ui_lookuplock;          /* Protects the lookup cache */
+  uint32_t ui_lookupgen;             /* Bumped when the cache is dropped */
+  struct unionfs_lookup_s ui_lookup[CONFIG_FS_UNIONFS_LOOKUP_CACHE];
+#endif
 };
 
 /* This structure describes one opened file */
@@ -138,6 +169,19 @@ static int     unionfs_trystatdir(FAR struct inode *inode,
 static int     unionfs_trystatfile(FAR struct inode *inode,
                                    FAR const char *relpath,
                                    FAR const char *prefix);
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+static int     unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath,
+                              FAR uint32_t *gen);
+static void    unionfs_remember(FAR struct unionfs_inode_s *ui,
+                                FAR const char *relpath, int result,
+                                uint32_t gen);
+static void    unionfs_forget(FAR struct unionfs_inode_s *ui);
+#else
+#  define unionfs_lookup(ui, relpath, gen) (*(gen) = 0, 0)
+#  define unionfs_remember(ui, relpath, result, gen)
+#  define unionfs_forget(ui)
+#endif
 static FAR char *unionfs_relpath(FAR const char *path,
                                  FAR const char *name);
 
@@ -715,6 +759,123 @@ static int unionfs_tryunlink(FAR struct inode *inode,
   return ops->unlink(inode, trypath);
 }
 
+/****************************************************************************
+ * Name: unionfs_lookup_slot
+ *
+ * Description:
+ *   The cache is direct mapped by an FNV-1a hash of the path.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+static FAR struct unionfs_lookup_s *
+unionfs_lookup_slot(FAR struct unionfs_inode_s *ui, FAR const char *relpath)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*relpath != '\0')
+    {
+      hash = (hash ^ (uint8_t)*relpath++) * 16777619u;
+    }
+
+  return &ui->ui_lookup[hash % CONFIG_FS_UNIONFS_LOOKUP_CACHE];
+}
+
+/****************************************************************************
+ * Name: unionfs_lookup
+ *
+ * Description:
+ *   Return what the cache knows about a path, UNIONFS_LOOKUP_UNKNOWN if
+ *   both file systems have to be probed.  gen receives the cache
+ *   generation to pass to unionfs_remember() with the probe result.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                          FAR const char *relpath, FAR uint32_t *gen)
+{
+  FAR struct unionfs_lookup_s *ul;
+  int result = UNIONFS_LOOKUP_UNKNOWN;
+  irqstate_t flags;
+
+  ul = unionfs_lookup_slot(ui, relpath);
+
+  flags = spin_lock_irqsave(&ui->ui_lookuplock);
+  if (ul->ul_path != NULL && ul->ul_gen == ui->ui_lookupgen &&
+      strcmp(ul->ul_path, relpath) == 0)
+    {
+      result = ul->ul_result;
+    }
+
+  *gen = ui->ui_lookupgen;
+  spin_unlock_irqrestore(&ui->ui_lookuplock, flags);
+  return result;
+}
+
+/****************************************************************************
+ * Name: unionfs_remember
+ *
+ * Description:
+ *   Record that a path is missing on file system 1.  Nothing is recorded
+ *   if the cache was dropped since the unionfs_lookup() that returned gen,
+ *   the probe may predate the change.
+ *
+ ****************************************************************************/
+
+static void unionfs_remember(FAR struct unionfs_inode_s *ui,
+                             FAR const char *relpath, int result,
+                             uint32_t gen)
+{
+  FAR struct unionfs_lookup_s *ul;
+  FAR char *path;
+  irqstate_t flags;
+
+  path = fs_heap_strdup(relpath);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  ul = unionfs_lookup_slot(ui, relpath);
+
+  flags = spin_lock_irqsave(&ui->ui_lookuplock);
+  if (gen == ui->ui_lookupgen)
+    {
+      FAR char *old = ul->ul_path;
+
+      ul->ul_path   = path;
+      ul->ul_gen    = gen;
+      ul->ul_result = result;
+      path          = old;
+    }
+
+  spin_unlock_irqrestore(&ui->ui_lookuplock, flags);
+
+  if (path != NULL)
+    {
+      fs_heap_free(path);
+    }
+}
+
+/****************************************************************************
+ * Name: unionfs_forget
+ *
+ * Description:
+ *   Drop the lookup cache after a path was created, removed or renamed.
+ *   The stale entries are freed as they are replaced.
+ *
+ ****************************************************************************/
+
+static void unionfs_forget(FAR struct unionfs_inode_s *ui)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&ui->ui_lookuplock);
+  ui->ui_lookupgen++;
+  spin_unlock_irqrestore(&ui->ui_lookuplock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: unionfs_relpath
  ****************************************************************************/
@@ -832,6 +993,10 @@ static int unionfs_unbind_child(FAR struct unionfs_mountpt_s *um)
 
 static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
 {
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  int i;
+#endif
+
   DEBUGASSERT(ui != NULL && ui->ui_fs[0].um_node != NULL &&
               ui->ui_fs[1].um_node != NULL && ui->ui_nopen == 0);
 
@@ -852,6 +1017,16 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       fs_heap_free(ui->ui_fs[1].um_prefix);
     }
 
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_CACHE; i++)
+    {
+      if (ui->ui_lookup[i].ul_path != NULL)
+        {
+          fs_heap_free(ui->ui_lookup[i].ul_path);
+        }
+    }
+#endif
+
   /* And finally free the allocated unionfs state structure as well */
 
   nxmutex_destroy(&ui->ui_lock);
@@ -868,6 +1043,9 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  int cached = UNIONFS_LOOKUP_UNKNOWN;
+  uint32_t gen = 0;
+  int ret1 = OK;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -876,6 +1054,17 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
 
   finfo("Opening: ui_nopen=%d\n", ui->ui_nopen);
 
+  /* An O_CREAT open may create the file on file system 1 */
+
+  if ((oflags & O_CREAT) == 0)
+    {
+      cached = unionfs_lookup(ui, relpath, &gen);
+      if (cached == UNIONFS_LOOKUP_NONE)
+        {
+          return -ENOENT;
+        }
+    }
+
   /* Get exclusive access to the file system data structures */
 
   ret = nxmutex_lock(&ui->ui_lock);
@@ -894,16 +1083,24 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_lock;
     }
 
-  /* Try to open the file on file system 1 */
+  /* Try to open the file on file system 1, unless it is known to be
+   * missing there.
+   */
 
-  um = &ui->ui_fs[0];
-  DEBUGASSERT(um != NULL && um->um_node != NULL &&
-              um->um_node->u.i_mops != NULL);
+  ret = -ENOENT;
+  if (cached == UNIONFS_LOOKUP_UNKNOWN)
+    {
+      um = &ui->ui_fs[0];
+      DEBUGASSERT(um != NULL && um->um_node != NULL &&
+                  um->um_node->u.i_mops != NULL);
+
+      uf->uf_file.f_oflags = filep->f_oflags;
+      uf->uf_file.f_inode  = um->um_node;
 
-  uf->uf_file.f_oflags = filep->f_oflags;
-  uf->uf_file.f_inode  = um->um_node;
+      ret = ret1 = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix,
+                                   oflags, mode);
+    }
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
   if (ret >= 0)
     {
       /* Successfully opened on file system 1 */
@@ -912,7 +1109,7 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
     }
   else
     {
-      /* Try to open the file on file system 1 */
+      /* Try to open the file on file system 2 */
 
       um  = &ui->ui_fs[1];
 
@@ -921,16 +1118,29 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
 
       ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
                             mode);
+
+      if ((oflags & O_CREAT) == 0 && cached == UNIONFS_LOOKUP_UNKNOWN &&
+          ret1 == -ENOENT && (ret >= 0 || ret == -ENOENT))
+        {
+          unionfs_remember(ui, relpath, ret >= 0 ? UNIONFS_LOOKUP_FS2 :
+                           UNIONFS_LOOKUP_NONE, gen);
+        }
+
       if (ret < 0)
         {
-          goto errout_with_lock;
+          goto errout_with_uf;
         }
 
-      /* Successfully opened on file system 1 */
+      /* Successfully opened on file system 2 */
 
       uf->uf_ndx = 1;
     }
 
+  if ((oflags & O_CREAT) != 0)
+    {
+      unionfs_forget(ui);
+    }
+
   /* Increment the open reference count */
 
   ui->ui_nopen++;
@@ -939,7 +1149,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Save our private data in the file structure */
 
   filep->f_priv = (FAR void *)uf;
-  ret = OK;
+  nxmutex_unlock(&ui->ui_lock);
+  return OK;
+
+errout_with_uf:
+  fs_heap_free(uf);
 
 errout_with_lock:
   nxmutex_unlock(&ui->ui_lock);
@@ -2220,6 +2434,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
         }
     }
 
+  unionfs_forget(ui);
   return ret;
 }
 
@@ -2269,6 +2484,8 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   um  = &ui->ui_fs[1];
   ret2 = unionfs_trymkdir(um->um_node, relpath, um->um_prefix, mode);
 
+  unionfs_forget(ui);
+
   /* We will say we were successful if we were able to create the
    * directory on either file system.  Perhaps one file system is
    * read-only and the other is write-able?
@@ -2311,6 +2528,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
 
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
+      unionfs_forget(ui);
       if (ret < 0)
         {
           return ret;
@@ -2330,6 +2548,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        */
 
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
+      unionfs_forget(ui);
 
       /* REVISIT:  Should we try to restore the directory on file system 1
        * if we failure to removed the directory on file system 2?
@@ -2373,6 +2592,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
       ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
                               um->um_prefix);
+      unionfs_forget(ui);
       if (ret >= 0)
         {
           /* Return immediately on success.  In the event that the file
@@ -2400,6 +2620,7 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
       ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
                               um->um_prefix);
+      unionfs_forget(ui);
     }
 
   return ret;
@@ -2414,6 +2635,9 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  uint32_t gen;
+  int cached;
+  int ret1 = OK;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2424,30 +2648,47 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = mountpt->i_private;
 
-  /* stat this path on file system 1 */
+  /* stat this path on file system 1, unless it is known to be missing */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  ret    = -ENOENT;
+  cached = unionfs_lookup(ui, relpath, &gen);
+  if (cached == UNIONFS_LOOKUP_UNKNOWN)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um  = &ui->ui_fs[0];
+      ret = ret1 = unionfs_trystat(um->um_node, relpath, um->um_prefix,
+                                   buf);
+      if (ret >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
 
-      return OK;
+          return OK;
+        }
     }
 
   /* stat failed on the file system 1.  Try again on file system 2. */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
+  if (cached != UNIONFS_LOOKUP_NONE)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
 
-      return OK;
+      if (cached == UNIONFS_LOOKUP_UNKNOWN && ret1 == -ENOENT &&
+          (ret >= 0 || ret == -ENOENT))
+        {
+          unionfs_remember(ui, relpath, ret >= 0 ? UNIONFS_LOOKUP_FS2 :
+                           UNIONFS_LOOKUP_NONE, gen);
+        }
+
+      if (ret >= 0)
+        {
+          /* Return on the first success.  The first instance of the file
+           * will shadow the second anyway.
+           */
+
+          return OK;
+        }
     }
 
   /* Special case the unionfs root directory when both file systems are
@@ -2608,6 +2849,9 @@ static int unionfs_dobind(FAR const char *fspath1, FAR const char *prefix1,
     }
 
   nxmutex_init(&ui->ui_lock);
+#if CONFIG_FS_UNIONFS_LOOKUP_CACHE > 0
+  spin_lock_init(&ui->ui_lookuplock);
+#endif
 
   /* Get the inodes associated with fspath1 and fspath2 */
 
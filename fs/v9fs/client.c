@@ -374,6 +374,17 @@ struct v9fs_fid_s
   char relpath[1];
 };
 
+/* One Tread or Twrite of a pipelined transfer, both share the layout */
+
+struct v9fs_io_s
+{
+  struct v9fs_payload_s payload;
+  struct v9fs_write_s   request;
+  struct v9fs_rwrite_s  response;
+  struct iovec          wiov[2];
+  struct iovec          riov[2];
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -537,6 +548,58 @@ static void v9fs_fid_destroy(FAR struct v9fs_client_s *client,
   fs_heap_free(fidp);
 }
 
+/****************************************************************************
+ * v9fs_client_submit
+ *
+ * Description:
+ *   Hand a request to the transport without waiting for the response.
+ *   Every request carries its own tag, so several of them may be in
+ *   flight and complete in any order.
+ *
+ ****************************************************************************/
+
+static int v9fs_client_submit(FAR struct v9fs_transport_s *transport,
+                              FAR struct v9fs_payload_s *payload,
+                              FAR struct iovec *wiov, size_t wcount,
+                              FAR struct iovec *riov, size_t rcount,
+                              uint16_t tag)
+{
+  int ret;
+
+  nxsem_init(&payload->resp, 0, 0);
+  payload->wiov = wiov;
+  payload->riov = riov;
+  payload->wcount = wcount;
+  payload->rcount = rcount;
+  payload->tag = tag;
+  payload->ret = -EIO;
+
+  ret = v9fs_transport_request(transport, payload);
+  if (ret < 0)
+    {
+      nxsem_destroy(&payload->resp);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * v9fs_client_wait
+ *
+ * Description:
+ *   Wait for the response of a submitted request.  The payload belongs to
+ *   the transport until then, so the wait cannot be interrupted.
+ *
+ ****************************************************************************/
+
+static int v9fs_client_wait(FAR struct v9fs_payload_s *payload)
+{
+  nxsem_wait_uninterruptible(&payload->resp);
+  nxsem_destroy(&payload->resp);
+
+  return payload->ret;
+}
+
 /****************************************************************************
  * v9fs_client_rpc
  ****************************************************************************/
@@ -549,25 +612,14 @@ static int v9fs_client_rpc(FAR struct v9fs_transport_s *transport,
   struct v9fs_payload_s payload;
   int ret;
 
-  nxsem_init(&payload.resp, 0, 0);
-  payload.wiov = wiov;
-  payload.riov = riov;
-  payload.wcount = wcount;
-  payload.rcount = rcount;
-  payload.tag = tag;
-  payload.ret = -EIO;
-
-  ret = v9fs_transport_request(transport, &payload);
+  ret = v9fs_client_submit(transport, &payload, wiov, wcount, riov, rcount,
+                           tag);
   if (ret < 0)
     {
-      nxsem_destroy(&payload.resp);
       return ret;
     }
 
-  nxsem_wait(&payload.resp);
-  nxsem_destroy(&payload.resp);
-
-  return payload.ret;
+  return v9fs_client_wait(&payload);
 }
 
 /****************************************************************************
@@ -724,6 +776,129 @@ static int v9fs_client_version(FAR struct v9fs_client_s *client)
   return 0;
 }
 
+/****************************************************************************
+ * v9fs_client_io
+ *
+ * Description:
+ *   Transfer buflen bytes with Tread or Twrite of at most one iounit each.
+ *   Up to CONFIG_V9FS_MAX_INFLIGHT requests are kept in flight and their
+ *   responses are consumed in order.  After an error or a short count no
+ *   more requests are sent, the outstanding ones are drained and only the
+ *   contiguous part transferred before is reported.
+ *
+ ****************************************************************************/
+
+static ssize_t v9fs_client_io(FAR struct v9fs_client_s *client,
+                              uint32_t fid, uint8_t type,
+                              FAR void *buffer, off_t offset, size_t buflen)
+{
+  struct v9fs_io_s io[CONFIG_V9FS_MAX_INFLIGHT];
+  FAR struct v9fs_fid_s *fidp;
+  FAR struct v9fs_io_s *r;
+  unsigned int head = 0;
+  unsigned int tail = 0;
+  size_t issued = 0;
+  size_t ndone = 0;
+  bool stop = false;
+  bool drain = false;
+  int ret = 0;
+  int err;
+
+  fidp = idr_find(client->fids, fid);
+  if (fidp == NULL)
+    {
+      return -ENOENT;
+    }
+
+  for (; ; )
+    {
+      while (!stop && issued < buflen &&
+             tail - head < CONFIG_V9FS_MAX_INFLIGHT)
+        {
+          r = &io[tail % CONFIG_V9FS_MAX_INFLIGHT];
+          r->request.count = MIN(buflen - issued, fidp->iounit);
+          r->request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ +
+                                   V9FS_BIT64SZ + V9FS_BIT32SZ;
+          r->request.header.type = type;
+          r->request.header.tag = v9fs_get_tagid(client);
+          r->request.fid = fid;
+          r->request.offset = offset + issued;
+
+          r->wiov[0].iov_base = &r->request;
+          r->wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
+                               V9FS_BIT32SZ;
+          r->riov[0].iov_base = &r->response;
+          r->riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
+
+          /* The data follows the Twrite header or the Rread header */
+
+          if (type == V9FS_TWRITE)
+            {
+              r->request.header.size += r->request.count;
+              r->wiov[1].iov_base = (FAR uint8_t *)buffer + issued;
+              r->wiov[1].iov_len = r->request.count;
+              ret = v9fs_client_submit(client->transport, &r->payload,
+                                       r->wiov, 2, r->riov, 1,
+                                       r->request.header.tag);
+            }
+          else
+            {
+              r->riov[1].iov_base = (FAR uint8_t *)buffer + issued;
+              r->riov[1].iov_len = r->request.count;
+              ret = v9fs_client_submit(client->transport, &r->payload,
+                                       r->wiov, 1, r->riov, 2,
+                                       r->request.header.tag);
+            }
+
+          /* A full transport is retried once a response is back */
+
+          if (ret < 0)
+            {
+              if (tail != head)
+                {
+                  ret = 0;
+                }
+              else
+                {
+                  stop = true;
+                }
+
+              break;
+            }
+
+          issued += r->request.count;
+          tail++;
+        }
+
+      if (head == tail)
+        {
+          break;
+        }
+
+      r = &io[head++ % CONFIG_V9FS_MAX_INFLIGHT];
+      err = v9fs_client_wait(&r->payload);
+      if (drain)
+        {
+          continue;
+        }
+
+      if (err < 0)
+        {
+          ret = err;
+          stop = drain = true;
+          continue;
+        }
+
+      ndone += MIN(r->response.count, r->request.count);
+      if (r->response.count < r->request.count)
+        {
+          stop = drain = true;
+        }
+    }
+
+  return ndone ? ndone : ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -902,61 +1077,11 @@ int v9fs_client_chstat(FAR struct v9fs_client_s *client, uint32_t fid,
 ssize_t v9fs_client_read(FAR struct v9fs_client_s *client, uint32_t fid,
                          FAR void *buffer, off_t offset, size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_read_s request;
-  struct v9fs_rread_s response;
-  struct iovec wiov[1];
-  struct iovec riov[2];
-  size_t nread = 0;
-  int ret = 0;
-
   /* size[4] Tread tag[2] fid[4] offset[8] count[4]
    * size[4] Rread tag[2] count[4] data[count]
    */
 
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ;
-      request.header.type = V9FS_TREAD;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-      riov[1].iov_base = (FAR void *)buffer;
-      riov[1].iov_len = request.count;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 1, riov, 2,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      if (response.count == 0)
-        {
-          break;
-        }
-
-      nread += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nread ? nread : ret;
+  return v9fs_client_io(client, fid, V9FS_TREAD, buffer, offset, buflen);
 }
 
 /****************************************************************************
@@ -1078,56 +1203,12 @@ ssize_t v9fs_client_write(FAR struct v9fs_client_s *client, uint32_t fid,
                           FAR const void *buffer, off_t offset,
                           size_t buflen)
 {
-  FAR struct v9fs_fid_s *fidp;
-  struct v9fs_write_s request;
-  struct v9fs_rwrite_s response;
-  struct iovec wiov[2];
-  struct iovec riov[1];
-  size_t nwrite = 0;
-  int ret = 0;
-
   /* size[4] Twrite tag[2] fid[4] offset[8] count[4] data[count]
    * size[4] Rwrite tag[2] count[4]
    */
 
-  fidp = idr_find(client->fids, fid);
-  if (fidp == NULL)
-    {
-      return -ENOENT;
-    }
-
-  while (buflen > 0)
-    {
-      request.count = buflen > fidp->iounit ? fidp->iounit : buflen;
-      request.header.size = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                            V9FS_BIT32SZ + request.count;
-      request.header.type = V9FS_TWRITE;
-      request.header.tag = v9fs_get_tagid(client);
-      request.fid = fid;
-      request.offset = offset;
-
-      wiov[0].iov_base = &request;
-      wiov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ + V9FS_BIT64SZ +
-                        V9FS_BIT32SZ;
-      wiov[1].iov_base = (FAR void *)buffer;
-      wiov[1].iov_len = request.count;
-      riov[0].iov_base = &response;
-      riov[0].iov_len = V9FS_HDRSZ + V9FS_BIT32SZ;
-
-      ret = v9fs_client_rpc(client->transport, wiov, 2, riov, 1,
-                            request.header.tag);
-      if (ret < 0)
-        {
-          break;
-        }
-
-      nwrite += response.count;
-      offset += response.count;
-      buffer += response.count;
-      buflen -= response.count;
-    }
-
-  return nwrite ? nwrite : ret;
+  return v9fs_client_io(client, fid, V9FS_TWRITE, (FAR void *)buffer,
+                        offset, buflen);
 }
 
 /****************************************************************************
@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -39,6 +40,14 @@
 #include "client.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The directory buffer does not have to grow with a large msize */
+
+#define V9FS_DIRBUF_SIZE(c) MIN((c)->msize, CONFIG_V9FS_READDIR_BUFSIZE)
+
 /****************************************************************************
  * Private Type
  ****************************************************************************/
@@ -536,7 +545,8 @@ static int v9fs_vfs_opendir(FAR struct inode *mountpt,
 
   client = mountpt->i_private;
 
-  fsdir = fs_heap_zalloc(sizeof(struct v9fs_vfs_dirent_s) + client->msize);
+  fsdir = fs_heap_zalloc(sizeof(struct v9fs_vfs_dirent_s) +
+                         V9FS_DIRBUF_SIZE(client));
   if (fsdir == NULL)
     {
       return -ENOMEM;
@@ -620,7 +630,8 @@ static int v9fs_vfs_readdir(FAR struct inode *mountpt,
       if (fsdir->head == fsdir->size)
         {
           ret = v9fs_client_readdir(client, fsdir->fid, fsdir->buffer,
-                                    fsdir->offset, client->msize);
+                                    fsdir->offset,
+                                    V9FS_DIRBUF_SIZE(client));
           if (ret < 0)
             {
               break;
@@ -91,6 +91,11 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
   filep2->f_priv   = NULL;
   filep2->f_pos    = filep1->f_pos;
   filep2->f_inode  = inode;
+#ifdef CONFIG_FS_READAHEAD
+  filep2->f_ranext = 0;
+  filep2->f_raend  = 0;
+  filep2->f_rawin  = 0;
+#endif
 
   /* Call the open method on the file, driver, mountpoint so that it
    * can maintain the correct open counts.
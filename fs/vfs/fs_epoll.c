@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/tls.h>
 
 #include "inode/inode.h"
@@ -53,9 +54,10 @@
 
 struct epoll_node_s
 {
-  struct list_node         node;
+  struct list_node         node;  /* In the setup, oneshot or free list */
+  struct list_node         rnode; /* In the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     ready; /* Linked in the ready list */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -69,13 +71,17 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rlock;    /* Protects the ready list, which is
+                                   * updated from the poll callbacks.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+                                   * epoll node.  The nodes stay setup
+                                   * across epoll_wait() calls.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      ready;    /* The ready list, store the setuped epoll
+                                   * nodes notified since they were last
+                                   * reported, so that epoll_wait() only
+                                   * looks at these.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -102,7 +108,6 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents);
 
@@ -204,11 +209,6 @@ static int epoll_do_close(FAR struct file *filep)
           file_put(epn->filep);
         }
 
-      list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-        {
-          file_put(epn->filep);
-        }
-
       list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
         {
           file_put(epn->filep);
@@ -255,8 +255,9 @@ static int epoll_do_create(int size, int flags)
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
+  spin_lock_init(&eph->rlock);
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
+  list_initialize(&eph->ready);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -282,61 +283,70 @@ static int epoll_do_create(int size, int flags)
 }
 
 /****************************************************************************
- * Name: epoll_setup
+ * Name: epoll_wakeup
  *
  * Description:
- *   Setup all the fd.
- *
- * Input Parameters:
- *   eph       - The epoll head pointer
- *
- * Returned Value:
- *   Positive on success, negative on fail
+ *   Wake up the epoll_wait() callers, or only one of them if exclusive.
+ *   Either way a count is left for the next caller if nobody is waiting.
  *
  ****************************************************************************/
 
-static int epoll_setup(FAR epoll_head_t *eph)
+static void epoll_wakeup(FAR epoll_head_t *eph, bool exclusive)
 {
-  FAR epoll_node_t *tepn;
-  FAR epoll_node_t *epn;
-  int ret;
-
-  ret = nxmutex_lock(&eph->lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
+  int semcount = 0;
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  nxsem_get_value(&eph->sem, &semcount);
+  do
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = file_poll(epn->filep, &epn->pfd, true);
-      if (ret < 0)
+      if (semcount >= 1)
         {
-          ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
-               "ret=%d\n", epn->filep, epn->pfd.events, ret);
           break;
         }
 
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+      nxsem_post(&eph->sem);
+      semcount++;
     }
+  while (!exclusive);
+}
 
-  nxmutex_unlock(&eph->lock);
-  return ret;
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Take a node off the ready list.  The node must have been torn down
+ *   already, so that it cannot be notified again.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (epn->ready)
+    {
+      list_delete(&epn->rnode);
+      epn->ready = false;
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
 }
 
 /****************************************************************************
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   Report the nodes of the ready list and check the notified fd's event
+ *   with user expected event.  Only the nodes that were notified are
+ *   visited:  the cost does not depend on the number of registered fds.
+ *
+ *   A level-triggered node is setup again before being reported, which
+ *   refreshes its events:  a fd that is no longer ready (e.g. its data was
+ *   consumed since the notification) is skipped, and a fd that is still
+ *   ready goes right back onto the ready list for the next call.  An
+ *   EPOLLET node stays setup and is reported with the events of its
+ *   notifications, and an EPOLLONESHOT node is torn down until it is
+ *   re-armed by EPOLL_CTL_MOD.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -352,45 +362,82 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  size_t nready;
+  int ret;
   int i = 0;
 
-  nxmutex_lock(&eph->lock);
-
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  ret = nxmutex_lock(&eph->lock);
+  if (ret < 0)
     {
-      /* Only check the notified fd */
+      return ret;
+    }
 
-      if (!epn->notified)
-        {
-          continue;
-        }
+  /* Level-triggered nodes may be queued again while the list is walked,
+   * only look at those that were there to begin with.
+   */
 
-      /* Teradown all the notified fd */
+  flags  = spin_lock_irqsave(&eph->rlock);
+  nready = list_length(&eph->ready);
+  spin_unlock_irqrestore(&eph->rlock, flags);
 
-      file_poll(epn->filep, &epn->pfd, false);
-      list_delete(&epn->node);
+  while (nready-- > 0 && i < maxevents)
+    {
+      flags = spin_lock_irqsave(&eph->rlock);
+      epn   = list_remove_head_type(&eph->ready, epoll_node_t, rnode);
+      DEBUGASSERT(epn != NULL);
+
+      epn->ready       = false;
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+      spin_unlock_irqrestore(&eph->rlock, flags);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if ((epn->pfd.events & EPOLLET) == 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
+          /* The notification may be stale, get the current events by
+           * setting the node up again.  The driver queues it again right
+           * away if it is still ready.
+           */
+
+          file_poll(epn->filep, &epn->pfd, false);
+          ret = file_poll(epn->filep, &epn->pfd, true);
+          if (ret < 0)
             {
-              list_add_tail(&eph->teardown, &epn->node);
+              ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
+                   "ret=%d\n", epn->filep, epn->pfd.events, ret);
             }
+
+          flags   = spin_lock_irqsave(&eph->rlock);
+          revents = epn->pfd.revents;
+          spin_unlock_irqrestore(&eph->rlock, flags);
+        }
+
+      if (revents == 0)
+        {
+          continue;
         }
-      else
+
+      evs[i].data     = epn->data;
+      evs[i++].events = revents;
+
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          file_poll(epn->filep, &epn->pfd, false);
+          epoll_unready(eph, epn);
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
         }
     }
 
+  /* Pass the remaining ready nodes on to the next caller */
+
+  if (!list_is_empty(&eph->ready))
+    {
+      epoll_wakeup(eph, true);
+    }
+
   nxmutex_unlock(&eph->lock);
   return i;
 }
@@ -426,17 +473,28 @@ static void epoll_cleanup(FAR void *arg)
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
-  int semcount = 0;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&epn->eph->sem);
-        }
+      return;
     }
+
+  /* Queue the node once, it is reported with all of the events that
+   * accumulate until then.
+   */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->ready)
+    {
+      list_add_tail(&eph->ready, &epn->rnode);
+      epn->ready = true;
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  epoll_wakeup(eph, (fds->events & EPOLLEXCLUSIVE) != 0);
 }
 
 /****************************************************************************
@@ -540,15 +598,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               }
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
         list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
@@ -585,7 +634,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
+        epn->ready       = false;
         epn->pfd.events  = ev->events | POLLALWAYS;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
@@ -617,17 +666,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 file_poll(epn->filep, &epn->pfd, false);
-                file_put(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
+                epoll_unready(eph, epn);
                 file_put(epn->filep);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
@@ -657,8 +696,8 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     file_poll(epn->filep, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
-                    epn->notified    = false;
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
                     epn->pfd.revents = 0;
@@ -674,36 +713,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               }
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
-
-                    ret = file_poll(epn->filep, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
-          }
-
         list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
               {
-                epn->notified    = false;
                 epn->data        = ev->data;
                 epn->pfd.events  = ev->events | POLLALWAYS;
                 epn->pfd.revents = 0;
@@ -758,12 +771,6 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
   /* Wait the poll ready */
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
@@ -780,7 +787,11 @@ retry:
     }
   else if (timeout > 0)
     {
+#ifdef CONFIG_HRTIMER
+      ret = nxsem_nsecwait(&eph->sem, (uint64_t)timeout * NSEC_PER_MSEC);
+#else
       ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
+#endif
     }
   else
     {
@@ -805,6 +816,10 @@ retry:
         }
 
       ret = num;
+      if (ret < 0)
+        {
+          goto err;
+        }
     }
 
   file_put(filep);
@@ -843,12 +858,6 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
   /* Push a cancellation point onto the stack.  This will be called if
    * the thread is canceled.
    */
@@ -863,7 +872,11 @@ retry:
     }
   else if (timeout > 0)
     {
+#ifdef CONFIG_HRTIMER
+      ret = nxsem_nsecwait(&eph->sem, (uint64_t)timeout * NSEC_PER_MSEC);
+#else
       ret = nxsem_tickwait(&eph->sem, MSEC2TICK(timeout));
+#endif
     }
   else
     {
@@ -887,6 +900,10 @@ retry:
         }
 
       ret = num;
+      if (ret < 0)
+        {
+          goto err;
+        }
     }
 
   file_put(filep);
@@ -222,6 +222,25 @@ static int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
           ret = file_ioctl(filep, PIPEIOC_GETSIZE);
         }
 
+        break;
+      case F_SETPIPE_LOWAT:
+        /* Make a blocking read of the pipe wait until arg bytes (or the
+         * number of bytes requested, if less) are available.
+         */
+
+        {
+          ret = file_ioctl(filep, PIPEIOC_SETLOWAT, va_arg(ap, int));
+        }
+
+        break;
+      case F_GETPIPE_LOWAT:
+
+        /* Return the read low watermark of the pipe */
+
+        {
+          ret = file_ioctl(filep, PIPEIOC_GETLOWAT);
+        }
+
         break;
       default:
         break;
@@ -37,6 +37,7 @@
 #include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Public Functions
@@ -68,6 +69,14 @@ int file_fsync(FAR struct file *filep)
 #ifndef CONFIG_DISABLE_MOUNTPOINT
       if (INODE_IS_MOUNTPT(inode))
         {
+          /* Write back the data left in the page cache first */
+
+          ret = pagecache_sync(filep);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
           if (inode->u.i_mops && inode->u.i_mops->sync)
             {
               /* Yes, then tell the mountpoint to sync this file */
@@ -75,8 +75,10 @@ struct inotify_event_s
 
 struct inotify_watch_list_s
 {
-  struct list_node watches;
-  FAR char        *path;
+  struct list_node  watches;
+  struct list_node  i_node;    /* Add to inode index */
+  FAR struct inode *inode;     /* Inode of the path, never dereferenced */
+  FAR char         *path;
 };
 
 struct inotify_watch_s
@@ -96,7 +98,15 @@ struct inotify_global_s
   int      watch_cookie;       /* Watch cookie */
   uint32_t read_count;         /* Number of read events */
   uint32_t write_count;        /* Number of write events */
+  uint32_t unindexed;          /* Number of watch lists without inode */
   struct   hsearch_data hash;  /* Hash table for watch lists */
+
+  /* Watch lists hashed by the inode of their path, so that read and write
+   * events of files that nobody watches are dropped without looking up
+   * the path of the file.
+   */
+
+  struct list_node inodes[CONFIG_FS_NOTIFY_BUCKET_SIZE];
 };
 
 /****************************************************************************
@@ -193,6 +203,132 @@ static int notify_check_mask(uint32_t mask)
           -EBADF : OK;
 }
 
+/****************************************************************************
+ * Name: inotify_inode_bucket
+ *
+ * Description:
+ *   Get the inode index bucket of an inode.
+ *
+ ****************************************************************************/
+
+static FAR struct list_node *inotify_inode_bucket(FAR struct inode *inode)
+{
+  return &g_inotify.inodes[((uintptr_t)inode / sizeof(uintptr_t)) %
+                           CONFIG_FS_NOTIFY_BUCKET_SIZE];
+}
+
+/****************************************************************************
+ * Name: inotify_find_inode
+ *
+ * Description:
+ *   Check if a watch list is indexed by the inode.
+ *
+ ****************************************************************************/
+
+static bool inotify_find_inode(FAR struct inode *inode)
+{
+  FAR struct inotify_watch_list_s *list;
+
+  list_for_every_entry(inotify_inode_bucket(inode), list,
+                       struct inotify_watch_list_s, i_node)
+    {
+      if (list->inode == inode)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: notify_check_index
+ *
+ * Description:
+ *   Check if the file may be watched.  The file is watched either through
+ *   the inode it was opened from, which is the mount point for the files
+ *   of a file system, or through its parent directory in the pseudo file
+ *   system.
+ *
+ ****************************************************************************/
+
+static int notify_check_index(FAR struct inode *inode)
+{
+  return (g_inotify.unindexed == 0 && !inotify_find_inode(inode) &&
+          (inode->i_parent == NULL ||
+           !inotify_find_inode(inode->i_parent))) ? -EBADF : OK;
+}
+
+/****************************************************************************
+ * Name: inotify_index_watch_list
+ *
+ * Description:
+ *   Add the watch list to the inode index, or move it if the inode of its
+ *   path has changed.  Only the address of the inode is kept, without a
+ *   reference, and it is refreshed whenever the path is created again.
+ *
+ ****************************************************************************/
+
+static void inotify_index_watch_list(FAR struct inotify_watch_list_s *list)
+{
+  FAR struct inode *inode = NULL;
+  struct inode_search_s desc;
+
+  SETUP_SEARCH(&desc, list->path, false);
+  if (inode_find(&desc) >= 0)
+    {
+      inode = desc.node;
+      inode_release(inode);
+    }
+
+  RELEASE_SEARCH(&desc);
+
+  if (list_in_list(&list->i_node))
+    {
+      if (list->inode == inode)
+        {
+          return;
+        }
+
+      list_delete(&list->i_node);
+      g_inotify.unindexed -= list->inode == NULL;
+    }
+
+  list->inode = inode;
+  g_inotify.unindexed += inode == NULL;
+  list_add_tail(inotify_inode_bucket(inode), &list->i_node);
+}
+
+/****************************************************************************
+ * Name: inotify_reindex_watch_lists
+ *
+ * Description:
+ *   Update the inode index of the watch lists at or below a path that was
+ *   just created, e.g. a mount point that replaced an older one.
+ *
+ ****************************************************************************/
+
+static void inotify_reindex_watch_lists(FAR const char *path)
+{
+  FAR struct inotify_watch_list_s *list;
+  FAR struct inotify_watch_list_s *l_tmp;
+  size_t len = strlen(path);
+  int i;
+
+  for (i = 0; i < CONFIG_FS_NOTIFY_BUCKET_SIZE; i++)
+    {
+      list_for_every_entry_safe(&g_inotify.inodes[i], list, l_tmp,
+                                struct inotify_watch_list_s, i_node)
+        {
+          if (strncmp(list->path, path, len) == 0 &&
+              (list->path[len] == '\0' || list->path[len] == '/'))
+            {
+              inotify_index_watch_list(list);
+            }
+        }
+    }
+}
+
 /****************************************************************************
  * Name: inotify_alloc_event
  *
@@ -767,6 +903,7 @@ inotify_alloc_watch_list(FAR const char *path)
       return NULL;
     }
 
+  inotify_index_watch_list(list);
   return list;
 }
 
@@ -907,6 +1044,11 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
       cookie = g_inotify.event_cookie;
     }
 
+  if (mask & IN_CREATE)
+    {
+      inotify_reindex_watch_lists(abspath);
+    }
+
   list = inotify_get_watch_list(abspath);
   inotify_queue_parent_event(abspath, mask, cookie);
   lib_put_pathbuffer(pathbuffer);
@@ -985,6 +1127,11 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
 
   nxmutex_lock(&g_inotify.lock);
   ret = notify_check_mask(mask);
+  if (ret >= 0)
+    {
+      ret = notify_check_index(filep->f_inode);
+    }
+
   nxmutex_unlock(&g_inotify.lock);
   if (ret < 0)
     {
@@ -1025,6 +1172,14 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
 
 static void notify_free_entry(FAR ENTRY *entry)
 {
+  FAR struct inotify_watch_list_s *list = entry->data;
+
+  if (list_in_list(&list->i_node))
+    {
+      list_delete(&list->i_node);
+      g_inotify.unindexed -= list->inode == NULL;
+    }
+
   /* Key is allocated by lib_malloc, value is allocated by fs_heap_malloc */
 
   fs_heap_free(entry->key);
@@ -1303,6 +1458,12 @@ int inotify_init(void)
 void notify_initialize(void)
 {
   int ret;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_NOTIFY_BUCKET_SIZE; i++)
+    {
+      list_initialize(&g_inotify.inodes[i]);
+    }
 
   g_inotify.hash.free_entry = notify_free_entry;
   ret = hcreate_r(CONFIG_FS_NOTIFY_BUCKET_SIZE, &g_inotify.hash);
@@ -28,11 +28,12 @@
 
 #include <fcntl.h>
 #include <errno.h>
-#include <search.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/hashmap.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
@@ -80,19 +81,51 @@ struct file_lock_bucket_s
   size_t           nwaiter;      /* Indicates how many blocking locks are
                                   * currently blocked.
                                   */
+  char             path[1];      /* The path of the file (variable) */
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static struct hsearch_data g_file_lock_table;
+static struct hashmap_s g_file_lock_table;
 static mutex_t g_protect_lock = NXMUTEX_INITIALIZER;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: file_lock_hash
+ *
+ * Description:
+ *   The FNV-1a hash of a path.
+ *
+ ****************************************************************************/
+
+static uint32_t file_lock_hash(FAR const char *filepath)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*filepath != '\0')
+    {
+      hash = (hash ^ (uint8_t)*filepath++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: file_lock_match
+ ****************************************************************************/
+
+static bool file_lock_match(FAR const void *entry, FAR const void *key)
+{
+  FAR const struct file_lock_bucket_s *bucket = entry;
+
+  return strcmp(bucket->path, key) == 0;
+}
+
 /****************************************************************************
  * Name: file_lock_get_path
  ****************************************************************************/
@@ -235,8 +268,6 @@ static void file_lock_delete(FAR struct file_lock_s *file_lock)
 static void file_lock_delete_bucket(FAR struct file_lock_bucket_s *bucket,
                                     FAR const char *filepath)
 {
-  ENTRY item;
-
   /* If there is still a lock on the chain table at this point, it means
    * that there is still someone else holding it, so it doesn't need to be
    * released
@@ -245,13 +276,14 @@ static void file_lock_delete_bucket(FAR struct file_lock_bucket_s *bucket,
   if (list_is_empty(&bucket->list) && bucket->nwaiter == 0)
     {
       /* At this point, the file has no lock information context, so we can
-       * remove it from the hash table, and the return result is 0 or 1 means
-       * that the node does not exist, so we do not need to care about the
-       * final return results
+       * remove it from the hash table.  The lookups all run under
+       * g_protect_lock, so the bucket can be freed at once.
        */
 
-      item.key = (FAR char *)filepath;
-      hsearch_r(item, DELETE, NULL, &g_file_lock_table);
+      hashmap_remove(&g_file_lock_table, file_lock_hash(filepath),
+                     filepath);
+      nxsem_destroy(&bucket->wait);
+      fs_heap_free(bucket);
     }
 }
 
@@ -285,28 +317,8 @@ static bool file_lock_is_conflict(FAR struct flock *request,
 static FAR struct file_lock_bucket_s *
 file_lock_find_bucket(FAR const char *filepath)
 {
-  FAR ENTRY *hretvalue;
-  ENTRY item;
-
-  item.key = (FAR char *)filepath;
-  item.data = NULL;
-
-  if (hsearch_r(item, FIND, &hretvalue, &g_file_lock_table) == 1)
-    {
-      return hretvalue->data;
-    }
-
-  return NULL;
-}
-
-/****************************************************************************
- * Name: file_lock_free_entry
- ****************************************************************************/
-
-static void file_lock_free_entry(FAR ENTRY *entry)
-{
-  fs_heap_free(entry->key);
-  fs_heap_free(entry->data);
+  return hashmap_find(&g_file_lock_table, file_lock_hash(filepath),
+                      filepath);
 }
 
 /****************************************************************************
@@ -317,29 +329,21 @@ static FAR struct file_lock_bucket_s *
 file_lock_create_bucket(FAR const char *filepath)
 {
   FAR struct file_lock_bucket_s *bucket;
-  FAR ENTRY *hretvalue;
-  ENTRY item;
-
-  bucket = fs_heap_zalloc(sizeof(*bucket));
-  if (bucket == NULL)
-    {
-      return NULL;
-    }
+  size_t len = strlen(filepath);
 
-  /* Creating an instance store */
+  /* The path is kept with the bucket, one allocation for both */
 
-  item.key = fs_heap_strdup(filepath);
-  if (item.key == NULL)
+  bucket = fs_heap_zalloc(sizeof(*bucket) + len);
+  if (bucket == NULL)
     {
-      fs_heap_free(bucket);
       return NULL;
     }
 
-  item.data = bucket;
+  memcpy(bucket->path, filepath, len + 1);
 
-  if (hsearch_r(item, ENTER, &hretvalue, &g_file_lock_table) == 0)
+  if (hashmap_insert(&g_file_lock_table, file_lock_hash(filepath),
+                     bucket) < 0)
     {
-      fs_heap_free(item.key);
       fs_heap_free(bucket);
       return NULL;
     }
@@ -841,6 +845,6 @@ void file_initlk(void)
 {
   /* Initialize file lock context hash table */
 
-  g_file_lock_table.free_entry = file_lock_free_entry;
-  hcreate_r(CONFIG_FS_LOCK_BUCKET_SIZE, &g_file_lock_table);
+  hashmap_init(&g_file_lock_table, CONFIG_FS_LOCK_BUCKET_SIZE,
+               file_lock_match);
 }
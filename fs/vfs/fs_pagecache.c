@@ -0,0 +1,969 @@
+/****************************************************************************
+ * fs/vfs/fs_pagecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "vfs.h"
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGE_SIZE       CONFIG_FS_PAGECACHE_PAGESIZE
+#define PAGE_MASK       (PAGE_SIZE - 1)
+#define PAGE_MAXPAGES   MAX(CONFIG_FS_PAGECACHE_SIZE / PAGE_SIZE, 1)
+#define PAGE_DATA(pg)   ((FAR uint8_t *)((pg) + 1))
+#define PAGE_FLUSHTICKS MSEC2TICK(CONFIG_FS_PAGECACHE_FLUSH_MSEC)
+
+#if (PAGE_SIZE & PAGE_MASK) != 0
+#  error CONFIG_FS_PAGECACHE_PAGESIZE must be a power of two
+#endif
+
+#if (CONFIG_FS_PAGECACHE_NBUCKETS & (CONFIG_FS_PAGECACHE_NBUCKETS - 1)) != 0
+#  error CONFIG_FS_PAGECACHE_NBUCKETS must be a power of two
+#endif
+
+/* The readahead window never exceeds half of the cache, so that it does
+ * not evict the pages which the reader has not consumed yet.
+ */
+
+#ifdef CONFIG_FS_READAHEAD
+#  define RA_MINPAGES   CONFIG_FS_READAHEAD_MINPAGES
+#  define RA_MAXPAGES   MAX(MIN(CONFIG_FS_READAHEAD_MAXPAGES, \
+                                PAGE_MAXPAGES / 2), RA_MINPAGES)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached page of a file, followed by its PAGE_SIZE bytes of data.  A
+ * page is dirty while pg_filep is set: that is the last open file which
+ * wrote to it, which is always writable and still open, and which the
+ * write back goes through.
+ */
+
+struct pagecache_page_s
+{
+  dq_entry_t        pg_hnode;   /* Hash bucket chain */
+  dq_entry_t        pg_lnode;   /* LRU list, least recently used first */
+  dq_entry_t        pg_dnode;   /* Dirty list */
+  FAR struct inode *pg_inode;   /* The mountpoint of the file */
+  uint64_t          pg_key;     /* The file within the mountpoint */
+  off_t             pg_offset;  /* Offset of the page in the file */
+  FAR struct file  *pg_filep;   /* The file to write back through */
+  uint16_t          pg_valid;   /* Bytes of file data, less at the end */
+  uint16_t          pg_dirtylo; /* Dirty range of the data */
+  uint16_t          pg_dirtyhi;
+};
+
+#ifdef CONFIG_FS_READAHEAD
+/* A pending readahead of the pages [ra_offset, ra_end) of a file, read
+ * through ra_filep.  Requests are free when ra_filep is NULL.
+ */
+
+struct pagecache_ra_s
+{
+  dq_entry_t        ra_node;    /* Pending requests list */
+  FAR struct file  *ra_filep;   /* The open file to read through */
+  uint64_t          ra_key;     /* The file within the mountpoint */
+  off_t             ra_offset;  /* Next page to read */
+  off_t             ra_end;     /* End of the readahead */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_pagecache_lock = NXMUTEX_INITIALIZER;
+static dq_queue_t g_pagecache_hash[CONFIG_FS_PAGECACHE_NBUCKETS];
+static dq_queue_t g_pagecache_lru;
+static dq_queue_t g_pagecache_dirty;
+static unsigned int g_pagecache_npages;
+static struct work_s g_pagecache_work;
+
+#ifdef CONFIG_FS_READAHEAD
+static struct pagecache_ra_s g_pagecache_ra[CONFIG_FS_READAHEAD_NREQUESTS];
+static dq_queue_t g_pagecache_rapending;
+static struct work_s g_pagecache_rawork;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_bucket
+ ****************************************************************************/
+
+static FAR dq_queue_t *pagecache_bucket(FAR struct inode *inode,
+                                        uint64_t key, off_t offset)
+{
+  uint32_t hash = (uint32_t)(uintptr_t)inode;
+
+  hash ^= (uint32_t)key ^ (uint32_t)(key >> 32);
+  hash ^= (uint32_t)(offset / PAGE_SIZE) * 0x9e3779b1u;
+  hash ^= hash >> 16;
+  return &g_pagecache_hash[hash & (CONFIG_FS_PAGECACHE_NBUCKETS - 1)];
+}
+
+/****************************************************************************
+ * Name: pagecache_getkey
+ ****************************************************************************/
+
+static int pagecache_getkey(FAR struct file *filep, FAR uint64_t *key)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  if (inode == NULL || !INODE_IS_MOUNTPT(inode) ||
+      inode->u.i_mops == NULL || inode->u.i_mops->pagekey == NULL ||
+      inode->u.i_mops->readpage == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  return inode->u.i_mops->pagekey(filep, key);
+}
+
+/****************************************************************************
+ * Name: pagecache_writeback
+ *
+ * Description:
+ *   Write the dirty range of a page back to its file system.  The page
+ *   stays dirty if that fails.
+ *
+ ****************************************************************************/
+
+static int pagecache_writeback(FAR struct pagecache_page_s *pg)
+{
+  FAR struct file *filep = pg->pg_filep;
+  size_t len;
+  ssize_t ret;
+
+  if (filep == NULL)
+    {
+      return OK;
+    }
+
+  len = pg->pg_dirtyhi - pg->pg_dirtylo;
+  ret = pg->pg_inode->u.i_mops->writepage(filep,
+                        (FAR const char *)PAGE_DATA(pg) + pg->pg_dirtylo,
+                        len, pg->pg_offset + pg->pg_dirtylo);
+  if (ret >= 0 && ret != len)
+    {
+      ret = -EIO;
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Write back at %jd failed: %zd\n",
+           (intmax_t)(pg->pg_offset + pg->pg_dirtylo), ret);
+      return (int)ret;
+    }
+
+  dq_rem(&pg->pg_dnode, &g_pagecache_dirty);
+  pg->pg_filep = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_free
+ ****************************************************************************/
+
+static void pagecache_free(FAR struct pagecache_page_s *pg)
+{
+  if (pg->pg_filep != NULL)
+    {
+      dq_rem(&pg->pg_dnode, &g_pagecache_dirty);
+    }
+
+  dq_rem(&pg->pg_hnode,
+         pagecache_bucket(pg->pg_inode, pg->pg_key, pg->pg_offset));
+  dq_rem(&pg->pg_lnode, &g_pagecache_lru);
+  g_pagecache_npages--;
+  kmm_free(pg);
+}
+
+/****************************************************************************
+ * Name: pagecache_drop
+ *
+ * Description:
+ *   Write back and free the pages of a file (or of all of the files of the
+ *   mountpoint if 'key' is NULL).  With 'partial', only the pages that end
+ *   before PAGE_SIZE, i.e. the last page of the file, are concerned.  A
+ *   page that cannot be written back is still dropped.
+ *
+ ****************************************************************************/
+
+static int pagecache_drop(FAR struct inode *inode, FAR const uint64_t *key,
+                          bool partial)
+{
+  FAR struct pagecache_page_s *pg;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  int result = OK;
+  int ret;
+
+  dq_for_every_safe(&g_pagecache_lru, entry, next)
+    {
+      pg = container_of(entry, struct pagecache_page_s, pg_lnode);
+      if (pg->pg_inode != inode || (key != NULL && pg->pg_key != *key) ||
+          (partial && pg->pg_valid == PAGE_SIZE))
+        {
+          continue;
+        }
+
+      ret = pagecache_writeback(pg);
+      if (ret < 0 && result == OK)
+        {
+          result = ret;
+        }
+
+      pagecache_free(pg);
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: pagecache_alloc
+ *
+ * Description:
+ *   Allocate a new page within the memory budget, else reuse the least
+ *   recently used page that could be written back.
+ *
+ ****************************************************************************/
+
+static FAR struct pagecache_page_s *pagecache_alloc(void)
+{
+  FAR struct pagecache_page_s *pg;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+
+  if (g_pagecache_npages < PAGE_MAXPAGES)
+    {
+      pg = kmm_malloc(sizeof(struct pagecache_page_s) + PAGE_SIZE);
+      if (pg != NULL)
+        {
+          g_pagecache_npages++;
+          return pg;
+        }
+    }
+
+  dq_for_every_safe(&g_pagecache_lru, entry, next)
+    {
+      pg = container_of(entry, struct pagecache_page_s, pg_lnode);
+      if (pagecache_writeback(pg) >= 0)
+        {
+          dq_rem(&pg->pg_hnode,
+                 pagecache_bucket(pg->pg_inode, pg->pg_key, pg->pg_offset));
+          dq_rem(&pg->pg_lnode, &g_pagecache_lru);
+          return pg;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_get
+ *
+ * Description:
+ *   Get a page of a file, reading it in on a miss.  'ppg' is set to NULL if
+ *   the page is past the end of the file; such pages are not cached.
+ *
+ ****************************************************************************/
+
+static int pagecache_get(FAR struct file *filep, uint64_t key,
+                         off_t offset, FAR struct pagecache_page_s **ppg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR dq_queue_t *bucket = pagecache_bucket(inode, key, offset);
+  FAR struct pagecache_page_s *pg;
+  FAR dq_entry_t *entry;
+  ssize_t nread;
+
+  dq_for_every(bucket, entry)
+    {
+      pg = container_of(entry, struct pagecache_page_s, pg_hnode);
+      if (pg->pg_inode == inode && pg->pg_key == key &&
+          pg->pg_offset == offset)
+        {
+          /* Make it the most recently used one */
+
+          dq_rem(&pg->pg_lnode, &g_pagecache_lru);
+          dq_addlast(&pg->pg_lnode, &g_pagecache_lru);
+          *ppg = pg;
+          return OK;
+        }
+    }
+
+  pg = pagecache_alloc();
+  if (pg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nread = inode->u.i_mops->readpage(filep, (FAR char *)PAGE_DATA(pg),
+                                    PAGE_SIZE, offset);
+  if (nread <= 0)
+    {
+      g_pagecache_npages--;
+      kmm_free(pg);
+      *ppg = NULL;
+      return (int)nread;
+    }
+
+  pg->pg_inode  = inode;
+  pg->pg_key    = key;
+  pg->pg_offset = offset;
+  pg->pg_filep  = NULL;
+  pg->pg_valid  = MIN(nread, PAGE_SIZE);
+
+  dq_addlast(&pg->pg_hnode, bucket);
+  dq_addlast(&pg->pg_lnode, &g_pagecache_lru);
+  *ppg = pg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_flusher
+ *
+ * Description:
+ *   The work item writing the dirty pages back.
+ *
+ ****************************************************************************/
+
+static void pagecache_flusher(FAR void *arg)
+{
+  FAR struct pagecache_page_s *pg;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+
+  nxmutex_lock(&g_pagecache_lock);
+
+  dq_for_every_safe(&g_pagecache_dirty, entry, next)
+    {
+      pg = container_of(entry, struct pagecache_page_s, pg_dnode);
+      pagecache_writeback(pg);
+    }
+
+  /* Try again later for the ones that failed */
+
+  if (!dq_empty(&g_pagecache_dirty))
+    {
+      work_queue(LPWORK, &g_pagecache_work, pagecache_flusher, NULL,
+                 PAGE_FLUSHTICKS);
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_dirty
+ ****************************************************************************/
+
+static void pagecache_dirty(FAR struct pagecache_page_s *pg,
+                            FAR struct file *filep,
+                            size_t lo, size_t hi)
+{
+  if (pg->pg_filep == NULL)
+    {
+      dq_addlast(&pg->pg_dnode, &g_pagecache_dirty);
+      pg->pg_dirtylo = lo;
+      pg->pg_dirtyhi = hi;
+    }
+  else
+    {
+      pg->pg_dirtylo = MIN(pg->pg_dirtylo, lo);
+      pg->pg_dirtyhi = MAX(pg->pg_dirtyhi, hi);
+    }
+
+  pg->pg_filep = filep;
+
+  if (work_available(&g_pagecache_work))
+    {
+      work_queue(LPWORK, &g_pagecache_work, pagecache_flusher, NULL,
+                 PAGE_FLUSHTICKS);
+    }
+}
+
+#ifdef CONFIG_FS_READAHEAD
+/****************************************************************************
+ * Name: pagecache_raworker
+ *
+ * Description:
+ *   The work item reading the pending readahead requests in.  The cache
+ *   lock is released between the pages, so that readers are not held up
+ *   for more than one page read.
+ *
+ ****************************************************************************/
+
+static void pagecache_raworker(FAR void *arg)
+{
+  FAR struct pagecache_page_s *pg;
+  FAR struct pagecache_ra_s *ra;
+  FAR dq_entry_t *entry;
+  int ret;
+
+  for (; ; )
+    {
+      nxmutex_lock(&g_pagecache_lock);
+
+      entry = dq_peek(&g_pagecache_rapending);
+      if (entry == NULL)
+        {
+          nxmutex_unlock(&g_pagecache_lock);
+          break;
+        }
+
+      ra  = container_of(entry, struct pagecache_ra_s, ra_node);
+      ret = pagecache_get(ra->ra_filep, ra->ra_key, ra->ra_offset, &pg);
+
+      /* Stop at an error or at the end of the file */
+
+      ra->ra_offset += PAGE_SIZE;
+      if (ret < 0 || pg == NULL || pg->pg_valid < PAGE_SIZE ||
+          ra->ra_offset >= ra->ra_end)
+        {
+          dq_rem(&ra->ra_node, &g_pagecache_rapending);
+          ra->ra_filep = NULL;
+        }
+
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_readahead
+ *
+ * Description:
+ *   Account for a read of [start, end) of a file.  Sequential reads grow
+ *   the readahead window of the open file, from RA_MINPAGES up to
+ *   RA_MAXPAGES pages, and queue the read of the pages of the window that
+ *   were not requested yet.  Any other read closes the window.
+ *
+ ****************************************************************************/
+
+static void pagecache_readahead(FAR struct file *filep, uint64_t key,
+                                off_t start, off_t end)
+{
+  FAR struct pagecache_ra_s *ra = NULL;
+  FAR dq_entry_t *entry;
+  off_t from;
+  off_t to;
+  int i;
+
+  if (start != filep->f_ranext)
+    {
+      filep->f_ranext = end;
+      filep->f_raend  = 0;
+      filep->f_rawin  = 0;
+      return;
+    }
+
+  filep->f_ranext = end;
+  if (start == end)
+    {
+      return;
+    }
+
+  filep->f_rawin = filep->f_rawin == 0 ? RA_MINPAGES :
+                   MIN(filep->f_rawin * 2, RA_MAXPAGES);
+
+  from = MAX(filep->f_raend, (end + PAGE_MASK) & ~(off_t)PAGE_MASK);
+  to   = (end & ~(off_t)PAGE_MASK) + (off_t)filep->f_rawin * PAGE_SIZE;
+  if (to <= from)
+    {
+      return;
+    }
+
+  /* Extend the pending request of the file if it ends right there */
+
+  dq_for_every(&g_pagecache_rapending, entry)
+    {
+      ra = container_of(entry, struct pagecache_ra_s, ra_node);
+      if (ra->ra_filep == filep && ra->ra_end == from)
+        {
+          break;
+        }
+
+      ra = NULL;
+    }
+
+  for (i = 0; ra == NULL && i < CONFIG_FS_READAHEAD_NREQUESTS; i++)
+    {
+      if (g_pagecache_ra[i].ra_filep == NULL)
+        {
+          ra            = &g_pagecache_ra[i];
+          ra->ra_filep  = filep;
+          ra->ra_key    = key;
+          ra->ra_offset = from;
+          dq_addlast(&ra->ra_node, &g_pagecache_rapending);
+        }
+    }
+
+  if (ra == NULL)
+    {
+      /* Out of requests, retry at the next read */
+
+      return;
+    }
+
+  ra->ra_end     = to;
+  filep->f_raend = to;
+
+  if (work_available(&g_pagecache_rawork))
+    {
+      work_queue(LPWORK, &g_pagecache_rawork, pagecache_raworker, NULL, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_racancel
+ *
+ * Description:
+ *   Cancel the pending readahead through an open file, or of a file of a
+ *   mountpoint if filep is NULL.
+ *
+ ****************************************************************************/
+
+static void pagecache_racancel(FAR struct file *filep,
+                               FAR struct inode *inode, uint64_t key)
+{
+  FAR struct pagecache_ra_s *ra;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+
+  dq_for_every_safe(&g_pagecache_rapending, entry, next)
+    {
+      ra = container_of(entry, struct pagecache_ra_s, ra_node);
+      if (filep != NULL ? ra->ra_filep == filep :
+          ra->ra_filep->f_inode == inode && ra->ra_key == key)
+        {
+          dq_rem(&ra->ra_node, &g_pagecache_rapending);
+          ra->ra_filep = NULL;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_cached
+ *
+ * Description:
+ *   Return true if the data of the open file goes through the page cache.
+ *
+ ****************************************************************************/
+
+bool pagecache_cached(FAR struct file *filep)
+{
+  uint64_t key;
+
+  return pagecache_getkey(filep, &key) >= 0;
+}
+
+/****************************************************************************
+ * Name: pagecache_readv
+ *
+ * Description:
+ *   Read a cached file at f_pos, and move f_pos past the data.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_readv(FAR struct file *filep,
+                        FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct pagecache_page_s *pg;
+  ssize_t ntotal = 0;
+  uint64_t key;
+  off_t pos;
+  int ret;
+  int i;
+
+  ret = pagecache_getkey(filep, &key);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0, pos = filep->f_pos; i < iovcnt; i++)
+    {
+      FAR uint8_t *buffer = iov[i].iov_base;
+      size_t buflen = iov[i].iov_len;
+
+      while (buflen > 0)
+        {
+          off_t offset = pos & ~(off_t)PAGE_MASK;
+          size_t inpage = pos - offset;
+          size_t ncopy;
+
+          ret = pagecache_get(filep, key, offset, &pg);
+          if (ret < 0 || pg == NULL || inpage >= pg->pg_valid)
+            {
+              goto out;
+            }
+
+          ncopy = MIN(buflen, pg->pg_valid - inpage);
+          memcpy(buffer, PAGE_DATA(pg) + inpage, ncopy);
+
+          buffer += ncopy;
+          buflen -= ncopy;
+          pos    += ncopy;
+          ntotal += ncopy;
+        }
+    }
+
+out:
+#ifdef CONFIG_FS_READAHEAD
+  pagecache_readahead(filep, key, filep->f_pos, pos);
+#endif
+
+  filep->f_pos = pos;
+  nxmutex_unlock(&g_pagecache_lock);
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_writev
+ *
+ * Description:
+ *   Write a cached file at f_pos (or at its end with O_APPEND), and move
+ *   f_pos past the data.  The data within the file is only written to the
+ *   cache; the data extending the file is written through.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_writev(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt)
+{
+  FAR const struct mountpt_operations *mops = filep->f_inode->u.i_mops;
+  FAR struct pagecache_page_s *pg;
+  ssize_t ntotal = 0;
+  ssize_t nwritten;
+  uint64_t key;
+  off_t pos;
+  int ret;
+  int i;
+
+  ret = pagecache_getkey(filep, &key);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (mops->writepage == NULL)
+    {
+      return -EBADF;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* As the data extending a file is written through, the file system knows
+   * where the file ends.
+   */
+
+  pos = filep->f_pos;
+  if ((filep->f_oflags & O_APPEND) != 0)
+    {
+      pos = mops->seek != NULL ? mops->seek(filep, 0, SEEK_END) : -ESPIPE;
+      if (pos < 0)
+        {
+          ret = (int)pos;
+          goto errout_with_lock;
+        }
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      FAR const uint8_t *buffer = iov[i].iov_base;
+      size_t buflen = iov[i].iov_len;
+
+      while (buflen > 0)
+        {
+          off_t offset = pos & ~(off_t)PAGE_MASK;
+          size_t inpage = pos - offset;
+          size_t ncopy = MIN(buflen, PAGE_SIZE - inpage);
+
+          ret = pagecache_get(filep, key, offset, &pg);
+          if (ret < 0)
+            {
+              goto out;
+            }
+
+          if (pg != NULL && inpage + ncopy <= pg->pg_valid)
+            {
+              memcpy(PAGE_DATA(pg) + inpage, buffer, ncopy);
+              pagecache_dirty(pg, filep, inpage, inpage + ncopy);
+              nwritten = ncopy;
+            }
+          else
+            {
+              /* Write through, after any older data of the page */
+
+              if (pg != NULL)
+                {
+                  ret = pagecache_writeback(pg);
+                  if (ret < 0)
+                    {
+                      goto out;
+                    }
+                }
+
+              nwritten = mops->writepage(filep, (FAR const char *)buffer,
+                                         ncopy, pos);
+              if (nwritten < 0)
+                {
+                  ret = (int)nwritten;
+                  goto out;
+                }
+
+              if (pg != NULL && inpage <= pg->pg_valid)
+                {
+                  memcpy(PAGE_DATA(pg) + inpage, buffer, nwritten);
+                  pg->pg_valid = MAX(pg->pg_valid, inpage + nwritten);
+                }
+              else
+                {
+                  /* The write left a hole behind the former end of the
+                   * file, whose page is no longer the last one.
+                   */
+
+                  if (pg != NULL)
+                    {
+                      pagecache_free(pg);
+                    }
+
+                  pagecache_drop(filep->f_inode, &key, true);
+                }
+            }
+
+          buffer += nwritten;
+          buflen -= nwritten;
+          pos    += nwritten;
+          ntotal += nwritten;
+
+          if (nwritten < ncopy)
+            {
+              goto out;
+            }
+        }
+    }
+
+out:
+  filep->f_pos = pos;
+
+errout_with_lock:
+  nxmutex_unlock(&g_pagecache_lock);
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_sync
+ *
+ * Description:
+ *   Write back the dirty pages of a file.
+ *
+ ****************************************************************************/
+
+int pagecache_sync(FAR struct file *filep)
+{
+  FAR struct pagecache_page_s *pg;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  uint64_t key;
+  int result = OK;
+  int ret;
+
+  if (pagecache_getkey(filep, &key) < 0)
+    {
+      return OK;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dq_for_every_safe(&g_pagecache_dirty, entry, next)
+    {
+      pg = container_of(entry, struct pagecache_page_s, pg_dnode);
+      if (pg->pg_inode == filep->f_inode && pg->pg_key == key)
+        {
+          ret = pagecache_writeback(pg);
+          if (ret < 0 && result == OK)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return result;
+}
+
+/****************************************************************************
+ * Name: pagecache_close
+ *
+ * Description:
+ *   Write back the pages last written through an open file being closed,
+ *   and cancel its pending readahead.
+ *
+ ****************************************************************************/
+
+void pagecache_close(FAR struct file *filep)
+{
+  FAR struct pagecache_page_s *pg;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+
+  if (!pagecache_cached(filep))
+    {
+      return;
+    }
+
+  nxmutex_lock(&g_pagecache_lock);
+
+#ifdef CONFIG_FS_READAHEAD
+  pagecache_racancel(filep, NULL, 0);
+#endif
+
+  dq_for_every_safe(&g_pagecache_dirty, entry, next)
+    {
+      pg = container_of(entry, struct pagecache_page_s, pg_dnode);
+      if (pg->pg_filep == filep && pagecache_writeback(pg) < 0)
+        {
+          /* The file to write through goes away, forget the data rather
+           * than keep a page which differs from the file system.
+           */
+
+          pagecache_free(pg);
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_truncate
+ *
+ * Description:
+ *   Write back and drop the pages of a file about to be truncated.
+ *
+ ****************************************************************************/
+
+int pagecache_truncate(FAR struct file *filep)
+{
+  uint64_t key;
+  int ret;
+
+  if (pagecache_getkey(filep, &key) < 0)
+    {
+      return OK;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret >= 0)
+    {
+#ifdef CONFIG_FS_READAHEAD
+      pagecache_racancel(NULL, filep->f_inode, key);
+#endif
+      ret = pagecache_drop(filep->f_inode, &key, false);
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_unmount
+ *
+ * Description:
+ *   Drop the pages of all of the files of a mountpoint.
+ *
+ ****************************************************************************/
+
+void pagecache_unmount(FAR struct inode *mountpt)
+{
+  nxmutex_lock(&g_pagecache_lock);
+  pagecache_drop(mountpt, NULL, false);
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_forget
+ *
+ * Description:
+ *   Drop the pages cached under a key of a mountpoint.
+ *
+ ****************************************************************************/
+
+void pagecache_forget(FAR struct inode *mountpt, uint64_t key)
+{
+  nxmutex_lock(&g_pagecache_lock);
+#ifdef CONFIG_FS_READAHEAD
+  pagecache_racancel(NULL, mountpt, key);
+#endif
+  pagecache_drop(mountpt, &key, false);
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+#endif /* CONFIG_FS_PAGECACHE */
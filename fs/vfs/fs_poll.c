@@ -477,7 +477,8 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
            * actual timeout interval will be rounded up to the next
            * supported value." -- opengroup.org
            *
-           * Round timeout up to next full tick.
+           * Round timeout up to next full tick, unless the high resolution
+           * timer can keep the exact delay.
            */
 
           /* Either wait for either a poll event(s), for a signal to occur,
@@ -488,7 +489,11 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
            * will return immediately.
            */
 
+#ifdef CONFIG_HRTIMER
+          ret = nxsem_nsecwait(&sem, (uint64_t)timeout * NSEC_PER_MSEC);
+#else
           ret = nxsem_tickwait(&sem, MSEC2TICK((clock_t)timeout));
+#endif
           if (ret < 0)
             {
               if (ret == -ETIMEDOUT)
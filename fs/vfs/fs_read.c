@@ -206,6 +206,13 @@ ssize_t file_readv(FAR struct file *filep,
 
   else if (inode != NULL && inode->u.i_ops)
     {
+#ifdef CONFIG_FS_PAGECACHE
+      if (pagecache_cached(filep))
+        {
+          ret = pagecache_readv(filep, iov, iovcnt);
+        }
+      else
+#endif
       if (inode->u.i_ops->readv)
         {
           struct uio uio;
@@ -37,7 +37,10 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 
 #include "inode/inode.h"
 #include "fs_heap.h"
@@ -53,169 +56,90 @@
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_SELECT_CACHE
+/* The poll setups of the last select() of a thread.  pfds[i] stays armed
+ * with the driver while filep[i] holds a reference to the file.
+ */
+
+struct select_cache_s
+{
+  sem_t sem;                    /* Posted by the armed pollfds */
+  int npfds;                    /* Number of pollfds in use */
+  int nalloc;                   /* Number of pollfds allocated */
+  FAR struct pollfd *pfds;      /* In the order of the fds */
+  FAR struct file **filep;      /* The armed files, NULL if not armed */
+};
+#endif
+
 /****************************************************************************
- * Name: select
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: select_events
  *
  * Description:
- *   select() allows a program to monitor multiple file descriptors, waiting
- *   until one or more of the file descriptors become "ready" for some class
- *   of I/O operation (e.g., input possible).  A file descriptor is
- *   considered  ready if it is possible to perform the corresponding I/O
- *   operation (e.g., read(2)) without blocking.
- *
- *   NOTE: poll() is the fundamental API for performing such monitoring
- *   operation under NuttX.  select() is provided for compatibility and
- *   is simply a layer of added logic on top of poll().  As such, select()
- *   is more wasteful of resources and poll() is the recommended API to be
- *   used.
- *
- * Input Parameters:
- *   nfds - the maximum fd number (+1) of any descriptor in any of the
- *     three sets.
- *   readfds - the set of descriptions to monitor for read-ready events
- *   writefds - the set of descriptions to monitor for write-ready events
- *   exceptfds - the set of descriptions to monitor for error events
- *   timeout - Return at this time if none of these events of interest
- *     occur.
- *
- *  Returned Value:
- *   0: Timer expired
- *  >0: The number of bits set in the three sets of descriptors
- *  -1: An error occurred (errno will be set appropriately)
+ *   Return the poll events select() monitors on 'fd', or -1 if the fd is
+ *   in none of the sets.  Note that POLLHUP and POLLERR are reported
+ *   whether they are requested or not, so exceptfds needs no event.
  *
  ****************************************************************************/
 
-int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
-           FAR fd_set *exceptfds, FAR struct timeval *timeout)
+static int select_events(int fd, FAR fd_set *readfds, FAR fd_set *writefds,
+                         FAR fd_set *exceptfds)
 {
-  struct pollfd *pollset = NULL;
-  int fd;
-  int npfds;
-  int msec;
-  int ndx;
-  int ret;
-
-  if (nfds < 0)
-    {
-      set_errno(EINVAL);
-      return ERROR;
-    }
-
-#ifdef CONFIG_FDCHECK
-  nfds = fdcheck_restore(nfds - 1) + 1;
-#endif
-
-  /* How many pollfd structures do we need to allocate? */
-
-  /* Initialize the descriptor list for poll() */
-
-  for (fd = 0, npfds = 0; fd < nfds; fd++)
-    {
-      /* Check if any monitor operation is requested on this fd */
-
-      if ((readfds   && FD_ISSET(fd, readfds))  ||
-          (writefds  && FD_ISSET(fd, writefds)) ||
-          (exceptfds && FD_ISSET(fd, exceptfds)))
-        {
-          /* Yes.. increment the count of pollfds structures needed */
+  int events = -1;
 
-          npfds++;
-        }
-    }
+  /* The readfs set holds the set of FDs that the caller can be assured
+   * of reading from without blocking.  Note that POLLHUP is included as
+   * a read-able condition.  POLLHUP will be reported at the end-of-file
+   * or when a connection is lost.  In either case, the read() can then
+   * be performed without blocking.
+   */
 
-  /* Allocate the descriptor list for poll() */
-
-  if (npfds > 0)
+  if (readfds && FD_ISSET(fd, readfds))
     {
-      pollset = (FAR struct pollfd *)
-        fs_heap_zalloc(npfds * sizeof(struct pollfd));
-
-      if (pollset == NULL)
-        {
-          set_errno(ENOMEM);
-          return ERROR;
-        }
+      events = POLLIN;
     }
 
-  /* Initialize the descriptor list for poll() */
+  /* The writefds set holds the set of FDs that the caller can be assured
+   * of writing to without blocking.
+   */
 
-  for (fd = 0, ndx = 0; fd < nfds; fd++)
+  if (writefds && FD_ISSET(fd, writefds))
     {
-      int incr = 0;
-
-      /* The readfs set holds the set of FDs that the caller can be assured
-       * of reading from without blocking.  Note that POLLHUP is included as
-       * a read-able condition.  POLLHUP will be reported at the end-of-file
-       * or when a connection is lost.  In either case, the read() can then
-       * be performed without blocking.
-       */
-
-      if (readfds && FD_ISSET(fd, readfds))
-        {
-#ifdef CONFIG_FDCHECK
-          pollset[ndx].fd      = fdcheck_protect(fd);
-#else
-          pollset[ndx].fd      = fd;
-#endif
-          pollset[ndx].events |= POLLIN;
-          incr                 = 1;
-        }
-
-      /* The writefds set holds the set of FDs that the caller can be assured
-       * of writing to without blocking.
-       */
-
-      if (writefds && FD_ISSET(fd, writefds))
-        {
-#ifdef CONFIG_FDCHECK
-          pollset[ndx].fd      = fdcheck_protect(fd);
-#else
-          pollset[ndx].fd      = fd;
-#endif
-          pollset[ndx].events |= POLLOUT;
-          incr                 = 1;
-        }
-
-      /* The exceptfds set holds the set of FDs that are watched for
-       * exceptions
-       */
-
-      if (exceptfds && FD_ISSET(fd, exceptfds))
-        {
-#ifdef CONFIG_FDCHECK
-          pollset[ndx].fd      = fdcheck_protect(fd);
-#else
-          pollset[ndx].fd      = fd;
-#endif
-          incr                  = 1;
-        }
-
-      ndx += incr;
+      events = events < 0 ? POLLOUT : events | POLLOUT;
     }
 
-  DEBUGASSERT(ndx == npfds);
+  /* The exceptfds set holds the set of FDs that are watched for
+   * exceptions
+   */
 
-  /* Convert the timeout to milliseconds */
-
-  if (timeout)
+  if (exceptfds && FD_ISSET(fd, exceptfds) && events < 0)
     {
-      /* Calculate the timeout in milliseconds */
-
-      msec = timeout->tv_sec * 1000 + (timeout->tv_usec + 999) / 1000;
+      events = 0;
     }
-  else
-    {
-      /* Any negative value of msec means no timeout */
 
-      msec = -1;
-    }
+  return events;
+}
 
-  /* Then let poll do all of the real work. */
+/****************************************************************************
+ * Name: select_result
+ *
+ * Description:
+ *   Convert the poll descriptor list back into the three bitsets of
+ *   select() and return the number of bits set.
+ *
+ ****************************************************************************/
 
-  ret = poll(pollset, npfds, msec);
+static int select_result(FAR struct pollfd *pollset, int npfds, int ret,
+                         FAR fd_set *readfds, FAR fd_set *writefds,
+                         FAR fd_set *exceptfds)
+{
+  int ndx;
 
   /* Now set up the return values */
 
@@ -280,6 +204,505 @@ int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
         }
     }
 
+  return ret;
+}
+
+#ifdef CONFIG_FS_SELECT_CACHE
+
+/****************************************************************************
+ * Name: select_disarm
+ *
+ * Description:
+ *   Tear down the poll setup of pollfd 'ndx' of the cache, if armed.
+ *
+ ****************************************************************************/
+
+static void select_disarm(FAR struct select_cache_s *cache, int ndx)
+{
+  if (cache->filep[ndx] != NULL)
+    {
+      file_poll(cache->filep[ndx], &cache->pfds[ndx], false);
+      file_put(cache->filep[ndx]);
+      cache->filep[ndx] = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: select_arm
+ *
+ * Description:
+ *   (Re)arm pollfd 'ndx' of the cache.  The driver reports the current
+ *   state of the file at the setup, so a failed setup or a ready file
+ *   leave revents non-zero.
+ *
+ ****************************************************************************/
+
+static void select_arm(FAR struct select_cache_s *cache, int ndx)
+{
+  FAR struct pollfd *pfd = &cache->pfds[ndx];
+  FAR struct file *filep;
+  int ret;
+
+  select_disarm(cache, ndx);
+
+  pfd->arg     = &cache->sem;
+  pfd->cb      = poll_default_cb;
+  pfd->revents = 0;
+  pfd->priv    = NULL;
+
+  ret = file_get(pfd->fd, &filep);
+  if (ret >= 0)
+    {
+      ret = file_poll(filep, pfd, true);
+      if (ret < 0)
+        {
+          file_put(filep);
+        }
+      else
+        {
+          cache->filep[ndx] = filep;
+        }
+    }
+
+  if (ret < 0)
+    {
+      pfd->revents |= POLLERR;
+    }
+}
+
+/****************************************************************************
+ * Name: select_rebuild
+ *
+ * Description:
+ *   Replace the cached pollfds by the 'npfds' fds of the three sets.  The
+ *   new pollfds are armed by select_rearm().
+ *
+ ****************************************************************************/
+
+static int select_rebuild(FAR struct select_cache_s *cache, int nfds,
+                          FAR fd_set *readfds, FAR fd_set *writefds,
+                          FAR fd_set *exceptfds, int npfds)
+{
+  int events;
+  int fd;
+  int ndx;
+
+  for (ndx = 0; ndx < cache->npfds; ndx++)
+    {
+      select_disarm(cache, ndx);
+    }
+
+  cache->npfds = 0;
+
+  if (npfds > cache->nalloc)
+    {
+      FAR struct pollfd *pfds;
+      FAR struct file **filep;
+
+      pfds  = fs_heap_malloc(npfds * sizeof(*pfds));
+      filep = fs_heap_malloc(npfds * sizeof(*filep));
+      if (pfds == NULL || filep == NULL)
+        {
+          fs_heap_free(pfds);
+          fs_heap_free(filep);
+          return -ENOMEM;
+        }
+
+      fs_heap_free(cache->pfds);
+      fs_heap_free(cache->filep);
+      cache->pfds   = pfds;
+      cache->filep  = filep;
+      cache->nalloc = npfds;
+    }
+
+  for (fd = 0, ndx = 0; fd < nfds; fd++)
+    {
+      events = select_events(fd, readfds, writefds, exceptfds);
+      if (events >= 0)
+        {
+          memset(&cache->pfds[ndx], 0, sizeof(struct pollfd));
+#ifdef CONFIG_FDCHECK
+          cache->pfds[ndx].fd = fdcheck_protect(fd);
+#else
+          cache->pfds[ndx].fd = fd;
+#endif
+          cache->pfds[ndx].events = events;
+
+          /* Not armed yet: select_rearm() arms the pollfds that fired */
+
+          cache->pfds[ndx].revents = POLLERR;
+          cache->filep[ndx]        = NULL;
+          ndx++;
+        }
+    }
+
+  DEBUGASSERT(ndx == npfds);
+  cache->npfds = npfds;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: select_rearm
+ *
+ * Description:
+ *   Re-arm the cached pollfds that fired since they were armed, or whose
+ *   fd was closed or now refers to another file, and return the number of
+ *   pollfds that are ready.  A pollfd that did not fire stays armed: the
+ *   state of its file did not change since its setup reported it, or the
+ *   driver would have notified it.
+ *
+ ****************************************************************************/
+
+static int select_rearm(FAR struct select_cache_s *cache)
+{
+  FAR struct file *filep;
+  int count = 0;
+  int ndx;
+
+  for (ndx = 0; ndx < cache->npfds; ndx++)
+    {
+      if (cache->pfds[ndx].revents == 0)
+        {
+          if (file_get(cache->pfds[ndx].fd, &filep) >= 0)
+            {
+              file_put(filep);
+              if (filep == cache->filep[ndx])
+                {
+                  continue;
+                }
+            }
+        }
+
+      select_arm(cache, ndx);
+      if (cache->pfds[ndx].revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: select_cached
+ *
+ * Description:
+ *   Implement select() with the poll setups cached per thread.  If the
+ *   sets are those of the last call, only the fds that fired are set up
+ *   again, which makes waiting on a large stable set roughly O(ready)
+ *   instead of O(n) driver calls.  The sets may differ in any way, the
+ *   cache is then rebuilt.
+ *
+ *   The setups stay armed between the calls and hold a reference to each
+ *   file, so the final close of a file that is still in the cached set
+ *   happens at the next select() without it, or when the thread exits.
+ *
+ ****************************************************************************/
+
+static int select_cached(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
+                         FAR fd_set *exceptfds, int msec)
+{
+  FAR struct tcb_s *tcb = nxsched_self();
+  FAR struct select_cache_s *cache = tcb->selcache;
+  bool match = true;
+  int events;
+  int count;
+  int npfds;
+  int pfdfd;
+  int ret = OK;
+  int ndx;
+  int fd;
+
+  /* select() is a cancellation point */
+
+  enter_cancellation_point();
+
+  if (cache == NULL)
+    {
+      cache = fs_heap_zalloc(sizeof(*cache));
+      if (cache == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      nxsem_init(&cache->sem, 0, 0);
+      tcb->selcache = cache;
+    }
+
+  /* Are these the sets of the last call? */
+
+  for (fd = 0, npfds = 0; fd < nfds; fd++)
+    {
+      events = select_events(fd, readfds, writefds, exceptfds);
+      if (events >= 0)
+        {
+#ifdef CONFIG_FDCHECK
+          pfdfd = fdcheck_protect(fd);
+#else
+          pfdfd = fd;
+#endif
+          if (npfds >= cache->npfds ||
+              cache->pfds[npfds].events != events ||
+              cache->pfds[npfds].fd != pfdfd)
+            {
+              match = false;
+            }
+
+          npfds++;
+        }
+    }
+
+  if (!match || npfds != cache->npfds)
+    {
+      ret = select_rebuild(cache, nfds, readfds, writefds, exceptfds,
+                           npfds);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  /* Any notification from now on wakes up the wait below, the ones that
+   * came before are seen in revents by select_rearm().
+   */
+
+  nxsem_reset(&cache->sem, 0);
+
+  count = select_rearm(cache);
+  if (count == 0 && msec != 0)
+    {
+      if (msec > 0)
+        {
+#ifdef CONFIG_HRTIMER
+          ret = nxsem_nsecwait(&cache->sem, (uint64_t)msec * NSEC_PER_MSEC);
+#else
+          ret = nxsem_tickwait(&cache->sem, MSEC2TICK((clock_t)msec));
+#endif
+          if (ret == -ETIMEDOUT)
+            {
+              /* Return zero (OK) in the event of a timeout */
+
+              ret = OK;
+            }
+        }
+      else
+        {
+          /* Wait for the poll event or signal with no timeout */
+
+          ret = nxsem_wait(&cache->sem);
+        }
+
+      for (ndx = 0; ndx < cache->npfds; ndx++)
+        {
+          if (cache->pfds[ndx].revents != 0)
+            {
+              count++;
+            }
+        }
+    }
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return select_result(cache->pfds, cache->npfds, count,
+                       readfds, writefds, exceptfds);
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
+
+#else /* CONFIG_FS_SELECT_CACHE */
+
+/****************************************************************************
+ * Name: select_poll
+ *
+ * Description:
+ *   Implement select() by converting the sets into a pollfd list for
+ *   poll().
+ *
+ ****************************************************************************/
+
+static int select_poll(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
+                       FAR fd_set *exceptfds, int msec)
+{
+  FAR struct pollfd *pollset = NULL;
+  int events;
+  int fd;
+  int npfds;
+  int ndx;
+  int ret;
+
+  /* How many pollfd structures do we need to allocate? */
+
+  for (fd = 0, npfds = 0; fd < nfds; fd++)
+    {
+      /* Check if any monitor operation is requested on this fd */
+
+      if (select_events(fd, readfds, writefds, exceptfds) >= 0)
+        {
+          /* Yes.. increment the count of pollfds structures needed */
+
+          npfds++;
+        }
+    }
+
+  /* Allocate the descriptor list for poll() */
+
+  if (npfds > 0)
+    {
+      pollset = (FAR struct pollfd *)
+        fs_heap_zalloc(npfds * sizeof(struct pollfd));
+
+      if (pollset == NULL)
+        {
+          set_errno(ENOMEM);
+          return ERROR;
+        }
+    }
+
+  /* Initialize the descriptor list for poll() */
+
+  for (fd = 0, ndx = 0; fd < nfds; fd++)
+    {
+      events = select_events(fd, readfds, writefds, exceptfds);
+      if (events >= 0)
+        {
+#ifdef CONFIG_FDCHECK
+          pollset[ndx].fd     = fdcheck_protect(fd);
+#else
+          pollset[ndx].fd     = fd;
+#endif
+          pollset[ndx].events = events;
+          ndx++;
+        }
+    }
+
+  DEBUGASSERT(ndx == npfds);
+
+  /* Then let poll do all of the real work. */
+
+  ret = poll(pollset, npfds, msec);
+  if (ret >= 0)
+    {
+      ret = select_result(pollset, npfds, ret, readfds, writefds,
+                          exceptfds);
+    }
+
   fs_heap_free(pollset);
   return ret;
 }
+
+#endif /* CONFIG_FS_SELECT_CACHE */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: select
+ *
+ * Description:
+ *   select() allows a program to monitor multiple file descriptors, waiting
+ *   until one or more of the file descriptors become "ready" for some class
+ *   of I/O operation (e.g., input possible).  A file descriptor is
+ *   considered  ready if it is possible to perform the corresponding I/O
+ *   operation (e.g., read(2)) without blocking.
+ *
+ *   NOTE: poll() is the fundamental API for performing such monitoring
+ *   operation under NuttX.  select() is provided for compatibility and
+ *   is simply a layer of added logic on top of poll().  As such, select()
+ *   is more wasteful of resources and poll() is the recommended API to be
+ *   used.
+ *
+ * Input Parameters:
+ *   nfds - the maximum fd number (+1) of any descriptor in any of the
+ *     three sets.
+ *   readfds - the set of descriptions to monitor for read-ready events
+ *   writefds - the set of descriptions to monitor for write-ready events
+ *   exceptfds - the set of descriptions to monitor for error events
+ *   timeout - Return at this time if none of these events of interest
+ *     occur.
+ *
+ *  Returned Value:
+ *   0: Timer expired
+ *  >0: The number of bits set in the three sets of descriptors
+ *  -1: An error occurred (errno will be set appropriately)
+ *
+ ****************************************************************************/
+
+int select(int nfds, FAR fd_set *readfds, FAR fd_set *writefds,
+           FAR fd_set *exceptfds, FAR struct timeval *timeout)
+{
+  int msec;
+
+  if (nfds < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+#ifdef CONFIG_FDCHECK
+  nfds = fdcheck_restore(nfds - 1) + 1;
+#endif
+
+  /* Convert the timeout to milliseconds */
+
+  if (timeout)
+    {
+      /* Calculate the timeout in milliseconds */
+
+      msec = timeout->tv_sec * 1000 + (timeout->tv_usec + 999) / 1000;
+    }
+  else
+    {
+      /* Any negative value of msec means no timeout */
+
+      msec = -1;
+    }
+
+#ifdef CONFIG_FS_SELECT_CACHE
+  return select_cached(nfds, readfds, writefds, exceptfds, msec);
+#else
+  return select_poll(nfds, readfds, writefds, exceptfds, msec);
+#endif
+}
+
+#ifdef CONFIG_FS_SELECT_CACHE
+
+/****************************************************************************
+ * Name: select_cache_release
+ *
+ * Description:
+ *   Tear down the poll setups cached by the select() calls of a thread and
+ *   free the cache.  Called when the thread exits.
+ *
+ * Input Parameters:
+ *   cache - The cache of the thread, may be NULL
+ *
+ ****************************************************************************/
+
+void select_cache_release(FAR struct select_cache_s *cache)
+{
+  int ndx;
+
+  if (cache != NULL)
+    {
+      for (ndx = 0; ndx < cache->npfds; ndx++)
+        {
+          select_disarm(cache, ndx);
+        }
+
+      nxsem_destroy(&cache->sem);
+      fs_heap_free(cache->pfds);
+      fs_heap_free(cache->filep);
+      fs_heap_free(cache);
+    }
+}
+
+#endif /* CONFIG_FS_SELECT_CACHE */
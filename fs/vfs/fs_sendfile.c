@@ -27,11 +27,13 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 #include "fs_heap.h"
@@ -40,6 +42,103 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: xipcopy
+ *
+ * Description:
+ *   Transfer from a file whose contents are directly addressable (a romfs
+ *   XIP image or a tmpfs file, as reported by FIOC_XIPBASE).  The data is
+ *   written to the outfile straight from the file's memory, without the
+ *   read into a bounce buffer.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, -ENOSYS if the infile is not directly
+ *   addressable, or another negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t xipcopy(FAR struct file *outfile, FAR struct file *infile,
+                       FAR off_t *offset, size_t count)
+{
+  FAR const uint8_t *base;
+  uintptr_t xipbase = 0;
+  struct stat buf;
+  size_t ntransferred = 0;
+  ssize_t nwritten;
+  off_t pos;
+  int ret;
+
+  ret = file_ioctl(infile, FIOC_XIPBASE, (unsigned long)(uintptr_t)&xipbase);
+  if (ret < 0 || xipbase == 0)
+    {
+      return -ENOSYS;
+    }
+
+  ret = file_fstat(infile, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pos = offset != NULL ? *offset : file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return offset != NULL ? -EINVAL : pos;
+    }
+
+  /* Stop at the end of the file, as reads would */
+
+  if (pos >= buf.st_size)
+    {
+      count = 0;
+    }
+  else if (count > buf.st_size - pos)
+    {
+      count = buf.st_size - pos;
+    }
+
+  base = (FAR const uint8_t *)xipbase + pos;
+  while (ntransferred < count)
+    {
+      nwritten = file_write(outfile, base + ntransferred,
+                            count - ntransferred);
+      if (nwritten < 0)
+        {
+          /* Report the bytes written before the error, if any */
+
+          if (ntransferred == 0)
+            {
+              return nwritten;
+            }
+
+          break;
+        }
+
+      ntransferred += nwritten;
+    }
+
+  /* Leave the file position where the reads would have left it */
+
+  if (offset != NULL)
+    {
+      *offset = pos + ntransferred;
+    }
+  else
+    {
+      pos = file_seek(infile, pos + ntransferred, SEEK_SET);
+      if (pos < 0)
+        {
+          return pos;
+        }
+    }
+
+  return ntransferred;
+}
+
+/****************************************************************************
+ * Name: copyfile
+ ****************************************************************************/
+
 static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
                         FAR off_t *offset, size_t count)
 {
@@ -249,6 +348,8 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
+  ssize_t ret;
+
   if (count == 0)
     {
       nwarn("WARNING: sendfile count is zero\n");
@@ -267,7 +368,7 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     {
       /* Then let psock_sendfile do the work. */
 
-      int ret = psock_sendfile(psock, infile, offset, count);
+      ret = psock_sendfile(psock, infile, offset, count);
       if (ret >= 0 || ret != -ENOSYS)
         {
           return ret;
@@ -279,10 +380,17 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
-  /* No... then this is probably a file-to-file transfer.  The generic
-   * copyfile() can handle that case.
+  /* No... then this is probably a file-to-file transfer.  Files that are
+   * directly addressable are written out from their memory, the generic
+   * copyfile() can handle all of the others.
    */
 
+  ret = xipcopy(outfile, infile, offset, count);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
   return copyfile(outfile, infile, offset, count);
 }
 
@@ -0,0 +1,299 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t count, unsigned int flags)
+{
+  off_t outpos = 0;
+  ssize_t ret;
+  off_t pos;
+
+  UNUSED(flags);
+
+  /* Write at *outoff, leaving the file position of the outfile alone.
+   * Pipes and sockets fail the seek with ESPIPE.
+   */
+
+  if (outoff != NULL)
+    {
+      if (*outoff < 0)
+        {
+          return -EINVAL;
+        }
+
+      outpos = file_seek(outfile, 0, SEEK_CUR);
+      if (outpos < 0)
+        {
+          return outpos;
+        }
+
+      pos = file_seek(outfile, *outoff, SEEK_SET);
+      if (pos < 0)
+        {
+          return pos;
+        }
+    }
+
+  /* file_sendfile() picks the cheapest path between the two files */
+
+  ret = file_sendfile(outfile, infile, inoff, count);
+
+  if (outoff != NULL)
+    {
+      pos = file_seek(outfile, 0, SEEK_CUR);
+      if (pos >= 0)
+        {
+          *outoff = pos;
+        }
+
+      file_seek(outfile, outpos, SEEK_SET);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors.  If infd is a pipe,
+ *   'inoff' must be NULL;  otherwise it is used and updated as the offset
+ *   of sendfile() is, leaving the file offset of 'infd' alone.  'outoff'
+ *   is handled the same way for 'outfd'.
+ *
+ *   NOTE: Unlike Linux, neither descriptor needs to be a pipe.  The data
+ *   takes the same path as with sendfile(): straight from the file's
+ *   memory for romfs XIP images and tmpfs files, straight into the
+ *   network buffers for TCP sockets.
+ *
+ * Input Parameters:
+ *   infd   - A descriptor opened for reading
+ *   inoff  - The offset to read at, or NULL
+ *   outfd  - A descriptor opened for writing
+ *   outoff - The offset to write at, or NULL
+ *   count  - The number of bytes to move
+ *   flags  - SPLICE_F_* flags, which are hints only
+ *
+ * Returned Value:
+ *   The number of bytes moved on success.  On error, -1 is returned, and
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int infd, FAR off_t *inoff, int outfd, FAR off_t *outoff,
+               size_t count, unsigned int flags)
+{
+  FAR struct file *outfile;
+  FAR struct file *infile;
+  ssize_t ret;
+
+  ret = file_get(infd, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(outfd, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, inoff, outfile, outoff, count, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t count, unsigned int flags)
+{
+  struct pipe_peek_s peek;
+  FAR uint8_t *buffer;
+  size_t ntransferred = 0;
+  ssize_t nwritten;
+  ssize_t ret = 0;
+  size_t npeeked;
+  size_t nsent;
+
+  UNUSED(flags);
+
+  buffer = fs_heap_malloc(CONFIG_SENDFILE_BUFSIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Copy the data at the head of the input pipe without consuming it */
+
+  while (ntransferred < count)
+    {
+      peek.buf    = buffer;
+      peek.offset = ntransferred;
+      peek.size   = count - ntransferred;
+      if (peek.size > CONFIG_SENDFILE_BUFSIZE)
+        {
+          peek.size = CONFIG_SENDFILE_BUFSIZE;
+        }
+
+      ret = file_ioctl(infile, PIPEIOC_PEEK,
+                       (unsigned long)(uintptr_t)&peek);
+      if (ret <= 0)
+        {
+          /* Only pipes can be peeked */
+
+          if (ret == -ENOTTY)
+            {
+              ret = -EINVAL;
+            }
+
+          break;
+        }
+
+      npeeked = ret;
+      for (nsent = 0; nsent < npeeked; nsent += nwritten)
+        {
+          nwritten = file_write(outfile, buffer + nsent, npeeked - nsent);
+          if (nwritten < 0)
+            {
+              ret = nwritten;
+              goto out;
+            }
+
+          ntransferred += nwritten;
+        }
+
+      if (npeeked < peek.size)
+        {
+          break;
+        }
+    }
+
+out:
+  fs_heap_free(buffer);
+  return ntransferred > 0 || ret >= 0 ? (ssize_t)ntransferred : ret;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() duplicates up to 'count' bytes of the data in the pipe 'infd'
+ *   into 'outfd', without consuming them:  they can still be read from
+ *   'infd' afterwards.
+ *
+ *   NOTE: tee() does not wait for data, it returns 0 if the input pipe is
+ *   empty.  'outfd' does not need to be a pipe.
+ *
+ * Input Parameters:
+ *   infd   - A pipe opened for reading
+ *   outfd  - A descriptor opened for writing
+ *   count  - The maximum number of bytes to duplicate
+ *   flags  - SPLICE_F_* flags, which are hints only
+ *
+ * Returned Value:
+ *   The number of bytes duplicated on success.  On error, -1 is returned,
+ *   and errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t tee(int infd, int outfd, size_t count, unsigned int flags)
+{
+  FAR struct file *outfile;
+  FAR struct file *infile;
+  ssize_t ret;
+
+  ret = file_get(infd, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(outfd, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, count, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -35,6 +35,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mutex.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/clock_notifier.h>
@@ -50,6 +51,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_HRTIMER
+#  define timerfd_stop(dev) \
+     do \
+       { \
+         hrtimer_cancel(&(dev)->hrtimer); \
+         (dev)->expire = 0; \
+       } \
+     while (0)
+#else
+#  define timerfd_stop(dev) wd_cancel(&(dev)->wdog)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -67,9 +80,16 @@ struct timerfd_priv_s
   mutex_t                   lock;    /* Enforces device exclusive access */
   FAR timerfd_waiter_sem_t *rdsems;  /* List of blocking readers */
   int                       clock;   /* Clock to use as the timing base */
+#ifdef CONFIG_HRTIMER
+  uint64_t                  delay;   /* If non-zero, the interval (ns) of
+                                      * repetitive timers */
+  uint64_t                  expire;  /* Next expiration (ns), zero if none */
+  hrtimer_t                 hrtimer; /* The timer that provides the timing */
+#else
   clock_t                   delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
   struct notifier_block     nb;      /* The clock notifier node */
@@ -105,7 +125,12 @@ static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
 static FAR struct timerfd_priv_s *timerfd_allocdev(void);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
+#ifdef CONFIG_HRTIMER
+static uint64_t timerfd_timeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired);
+#else
 static void timerfd_timeout(wdparm_t arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -173,7 +198,11 @@ timerfd_unregister_clock_notifier(FAR struct timerfd_priv_s *dev)
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
   timerfd_unregister_clock_notifier(dev);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel_sync(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
   nxmutex_unlock(&dev->lock);
   nxmutex_destroy(&dev->lock);
   fs_heap_free(dev);
@@ -283,6 +312,24 @@ static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
   return ret;
 }
 
+#ifdef CONFIG_HRTIMER
+static void timerfd_catchup(FAR struct timerfd_priv_s *dev, uint64_t now)
+{
+  uint64_t missed;
+
+  /* A repetitive timer stops after the expiration that made the counter
+   * non-zero, the later ones are counted when the counter is needed.
+   */
+
+  if (dev->delay > 0 && dev->counter > 0 && dev->expire <= now)
+    {
+      missed        = (now - dev->expire) / dev->delay + 1;
+      dev->counter += missed;
+      dev->expire  += missed * dev->delay;
+    }
+}
+#endif
+
 static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
                             size_t len)
 {
@@ -344,9 +391,26 @@ static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
       nxsem_destroy(&sem.sem);
     }
 
+#ifdef CONFIG_HRTIMER
+  /* Count the expirations of a repetitive timer since it stopped */
+
+  timerfd_catchup(dev, clock_systime_nsec());
+#endif
+
   *(FAR timerfd_t *)buffer = dev->counter;
   dev->counter = 0;
 
+#ifdef CONFIG_HRTIMER
+  /* Restart the repetitive timer so that the next expiration wakes up the
+   * readers again.
+   */
+
+  if (dev->delay > 0)
+    {
+      hrtimer_start_absolute(&dev->hrtimer, timerfd_timeout, dev->expire);
+    }
+#endif
+
   leave_critical_section(intflags);
 
   return sizeof(timerfd_t);
@@ -433,16 +497,6 @@ static void timerfd_notify(FAR struct timerfd_priv_s *dev)
     }
 
   dev->rdsems = NULL;
-
-  if (dev->delay > 0)
-    {
-      wd_start(&dev->wdog, dev->delay, timerfd_timeout,
-               (wdparm_t)dev);
-    }
-  else
-    {
-      timerfd_unregister_clock_notifier(dev);
-    }
 }
 
 static int timerfd_changed_handler(FAR struct notifier_block *nb,
@@ -454,13 +508,97 @@ static int timerfd_changed_handler(FAR struct notifier_block *nb,
 
       dev = container_of(nb, struct timerfd_priv_s, nb);
       dev->cancel = true;
-      wd_cancel(&dev->wdog);
+      timerfd_stop(dev);
       timerfd_notify(dev);
+
+      if (dev->delay == 0)
+        {
+          timerfd_unregister_clock_notifier(dev);
+        }
+    }
+
+  return 0;
+}
+
+#ifdef CONFIG_HRTIMER
+static uint64_t timerfd_timeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired)
+{
+  FAR struct timerfd_priv_s *dev;
+  irqstate_t intflags;
+
+  dev = container_of(hrtimer, struct timerfd_priv_s, hrtimer);
+
+  intflags = enter_critical_section();
+
+  /* Ignore an expiration that raced with timerfd_settime() */
+
+  if (dev->cancel || expired != dev->expire)
+    {
+      leave_critical_section(intflags);
+      return 0;
+    }
+
+  dev->counter++;
+  timerfd_notify(dev);
+
+  /* The timer is not restarted: the readers are already woken up, so the
+   * next expirations are counted by timerfd_catchup() and the timer is
+   * restarted when the counter is read.
+   */
+
+  if (dev->delay > 0)
+    {
+      dev->expire = expired + dev->delay;
+    }
+  else
+    {
+      dev->expire = 0;
+      timerfd_unregister_clock_notifier(dev);
     }
 
+  leave_critical_section(intflags);
   return 0;
 }
 
+static void timerfd_gettimes(FAR struct timerfd_priv_s *dev,
+                             FAR struct itimerspec *value)
+{
+  uint64_t now = clock_systime_nsec();
+
+  timerfd_catchup(dev, now);
+  clock_nsec2time(&value->it_value,
+                  dev->expire > now ? dev->expire - now : 0);
+  clock_nsec2time(&value->it_interval, dev->delay);
+}
+
+static int timerfd_arm(FAR struct timerfd_priv_s *dev, int flags,
+                       FAR const struct itimerspec *new_value)
+{
+  struct timespec now;
+  int64_t delay;
+
+  dev->delay = clock_time2nsec(&new_value->it_interval);
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      /* Move the absolute time of the clock to the system time */
+
+      nxclock_gettime(dev->clock, &now);
+      delay = clock_time2nsec(&new_value->it_value) -
+              clock_time2nsec(&now);
+      dev->expire = clock_systime_nsec() + (delay > 0 ? delay : 0);
+    }
+  else
+    {
+      dev->expire = clock_systime_nsec() +
+                    clock_time2nsec(&new_value->it_value);
+    }
+
+  return hrtimer_start_absolute(&dev->hrtimer, timerfd_timeout,
+                                dev->expire);
+}
+#else
 static void timerfd_timeout(wdparm_t arg)
 {
   FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
@@ -484,9 +622,73 @@ static void timerfd_timeout(wdparm_t arg)
 
   timerfd_notify(dev);
 
+  if (dev->delay > 0)
+    {
+      wd_start(&dev->wdog, dev->delay, timerfd_timeout,
+               (wdparm_t)dev);
+    }
+  else
+    {
+      timerfd_unregister_clock_notifier(dev);
+    }
+
   leave_critical_section(intflags);
 }
 
+static void timerfd_gettimes(FAR struct timerfd_priv_s *dev,
+                             FAR struct itimerspec *value)
+{
+  /* Get the number of ticks before the underlying watchdog expires and
+   * convert that to a struct timespec.
+   */
+
+  clock_ticks2time(&value->it_value, wd_gettime(&dev->wdog));
+  clock_ticks2time(&value->it_interval, dev->delay);
+}
+
+static int timerfd_arm(FAR struct timerfd_priv_s *dev, int flags,
+                       FAR const struct itimerspec *new_value)
+{
+  clock_t delay;
+
+  /* Setup up any repetitive timer */
+
+  delay = clock_time2ticks(&new_value->it_interval);
+  dev->delay = delay;
+
+  /* Check if abstime is selected */
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      /* Calculate a delay corresponding to the absolute time in 'value' */
+
+      clock_abstime2ticks(dev->clock, &new_value->it_value, &delay);
+    }
+  else
+    {
+      /* Calculate a delay assuming that 'value' holds the relative time
+       * to wait.  We have internal knowledge that clock_time2ticks always
+       * returns success.
+       */
+
+      delay = clock_time2ticks(&new_value->it_value);
+    }
+
+  /* If the time is in the past or now, then set up the next interval
+   * instead (assuming a repetitive timer).
+   */
+
+  if ((sclock_t)delay <= 0)
+    {
+      delay = dev->delay;
+    }
+
+  /* Then start the watchdog */
+
+  return wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -550,7 +752,6 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
   irqstate_t intflags;
-  clock_t delay;
   int ret;
 
   /* Some sanity checks */
@@ -590,21 +791,14 @@ int timerfd_settime(int fd, int flags,
 
   if (old_value)
     {
-      /* Get the number of ticks before the underlying watchdog expires */
-
-      delay = wd_gettime(&dev->wdog);
-
-      /* Convert that to a struct timespec and return it */
-
-      clock_ticks2time(&old_value->it_value, delay);
-      clock_ticks2time(&old_value->it_interval, dev->delay);
+      timerfd_gettimes(dev, old_value);
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timerfd_settime() is called).
    */
 
-  wd_cancel(&dev->wdog);
+  timerfd_stop(dev);
 
   /* Unregister notifier cb if it exists */
 
@@ -623,51 +817,17 @@ int timerfd_settime(int fd, int flags,
       goto errout_with_csection;
     }
 
-  /* Setup up any repetitive timer */
-
-  delay = clock_time2ticks(&new_value->it_interval);
-  dev->delay = delay;
-
-  /* We need to disable timer interrupts through the following section so
-   * that the system timer is stable.
-   */
-
-  /* Check if abstime is selected */
-
-  if ((flags & TFD_TIMER_ABSTIME) != 0)
-    {
-      /* Calculate a delay corresponding to the absolute time in 'value' */
-
-      clock_abstime2ticks(dev->clock, &new_value->it_value, &delay);
-    }
-  else
-    {
-      /* Calculate a delay assuming that 'value' holds the relative time
-       * to wait.  We have internal knowledge that clock_time2ticks always
-       * returns success.
-       */
-
-      delay = clock_time2ticks(&new_value->it_value);
-    }
-
-  /* If the time is in the past or now, then set up the next interval
-   * instead (assuming a repetitive timer).
-   */
-
-  if ((sclock_t)delay <= 0)
-    {
-      delay = dev->delay;
-    }
-
   if (flags & TFD_TIMER_CANCEL_ON_SET)
     {
       dev->nb.notifier_call = timerfd_changed_handler;
       register_clock_notifier(&dev->nb);
     }
 
-  /* Then start the watchdog */
+  /* We need to disable timer interrupts through the following section so
+   * that the system timer is stable.
+   */
 
-  ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+  ret = timerfd_arm(dev, flags, new_value);
   if (ret < 0)
     {
       timerfd_unregister_clock_notifier(dev);
@@ -692,7 +852,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
-  sclock_t ticks;
+  irqstate_t intflags;
   int ret;
 
   /* Some sanity checks */
@@ -719,14 +879,10 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
-  /* Get the number of ticks before the underlying watchdog expires */
-
-  ticks = wd_gettime(&dev->wdog);
-
-  /* Convert that to a struct timespec and return it */
+  intflags = enter_critical_section();
+  timerfd_gettimes(dev, curr_value);
+  leave_critical_section(intflags);
 
-  clock_ticks2time(&curr_value->it_value, ticks);
-  clock_ticks2time(&curr_value->it_interval, dev->delay);
   file_put(filep);
   return OK;
 
@@ -54,6 +54,7 @@
 int file_truncate(FAR struct file *filep, off_t length)
 {
   struct inode *inode;
+  int ret;
 
   /* Was this file opened for write access? */
 
@@ -100,6 +101,14 @@ int file_truncate(FAR struct file *filep, off_t length)
       return -ENOSYS;
     }
 
+  /* Drop the cached pages of the file, writing back the dirty ones */
+
+  ret = pagecache_truncate(filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Yes, then tell the file system to truncate this file */
 
   return inode->u.i_ops->truncate(filep, length);
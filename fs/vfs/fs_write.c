@@ -188,6 +188,13 @@ ssize_t file_writev(FAR struct file *filep,
   inode = filep->f_inode;
   if (inode != NULL && inode->u.i_ops)
     {
+#ifdef CONFIG_FS_PAGECACHE
+      if (pagecache_cached(filep))
+        {
+          ret = pagecache_writev(filep, iov, iovcnt);
+        }
+      else
+#endif
       if (inode->u.i_ops->writev)
         {
           struct uio uio;
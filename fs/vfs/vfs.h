@@ -107,6 +107,98 @@ int file_setlk(FAR struct file *filep, FAR struct flock *flock,
 
 #endif /* CONFIG_FS_LOCK_BUCKET_SIZE */
 
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Name: pagecache_cached
+ *
+ * Description:
+ *   Return true if the data of the open file goes through the page cache.
+ *
+ ****************************************************************************/
+
+bool pagecache_cached(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: pagecache_readv and pagecache_writev
+ *
+ * Description:
+ *   Read or write a cached file at f_pos, and move f_pos past the data.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_readv(FAR struct file *filep,
+                        FAR const struct iovec *iov, int iovcnt);
+ssize_t pagecache_writev(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
+
+/****************************************************************************
+ * Name: pagecache_sync
+ *
+ * Description:
+ *   Write back the dirty pages of a file, before it is synchronized or
+ *   mapped by its file system.
+ *
+ ****************************************************************************/
+
+int pagecache_sync(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: pagecache_close
+ *
+ * Description:
+ *   Write back the pages last written through an open file being closed.
+ *   Write back errors are only logged, as for the caches of the file
+ *   systems; fsync() reports them.
+ *
+ ****************************************************************************/
+
+void pagecache_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: pagecache_truncate
+ *
+ * Description:
+ *   Write back and drop the pages of a file about to be truncated.
+ *
+ ****************************************************************************/
+
+int pagecache_truncate(FAR struct file *filep);
+
+/****************************************************************************
+ * Name: pagecache_unmount
+ *
+ * Description:
+ *   Drop the pages of all of the files of a mountpoint.
+ *
+ ****************************************************************************/
+
+void pagecache_unmount(FAR struct inode *mountpt);
+
+/****************************************************************************
+ * Name: pagecache_forget
+ *
+ * Description:
+ *   Drop the pages cached under a key of a mountpoint, after its file
+ *   system removed or moved the file that the key identified.  This must
+ *   not be called with a lock of the file system held.
+ *
+ ****************************************************************************/
+
+void pagecache_forget(FAR struct inode *mountpt, uint64_t key);
+
+#else
+#  define pagecache_cached(filep) false
+#  define pagecache_sync(filep) OK
+#  define pagecache_close(filep)
+#  define pagecache_truncate(filep) OK
+#  define pagecache_unmount(mountpt)
+#  define pagecache_forget(mountpt, key) ((void)(key))
+#endif /* CONFIG_FS_PAGECACHE */
+
 #ifdef CONFIG_FS_NOTIFY
 void notify_open(FAR const char *path, int oflags);
 void notify_close(FAR const char *path, int oflags);
@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <nuttx/mutex.h>
@@ -36,13 +37,33 @@
 #include <nuttx/fs/ioctl.h>
 
 #include <unzip.h>
+#include <zlib.h>
 
 #include "fs_heap.h"
+#include "mmap/fs_rammap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ZIPFS_METHOD_STORE  0
+#define ZIPFS_WINDOW_SIZE   32768
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* An inflate checkpoint, the stream can resume here after a reset */
+
+struct zipfs_point_s
+{
+  off_t        out;              /* Uncompressed offset */
+  off_t        in;               /* Offset of the next compressed byte */
+  int          bits;             /* Unused bits of the byte before in */
+  unsigned int wsize;            /* Valid bytes in window */
+  FAR uint8_t *window;           /* The inflate history */
+};
+
 struct zipfs_dir_s
 {
   struct fs_dirent_s base;
@@ -61,6 +82,28 @@ struct zipfs_file_s
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+
+  /* The entry's data is read from the archive and inflated here, so that
+   * a seek can restart from a checkpoint or, if stored, read in place.
+   */
+
+  struct file zfile;             /* The archive */
+  off_t zbase;                   /* Offset of the entry data in zfile */
+  off_t zsize;                   /* Compressed size */
+  off_t zpos;                    /* Next compressed offset to read */
+  off_t usize;                   /* Uncompressed size */
+  off_t upos;                    /* Uncompressed position */
+  uLong crc;                     /* Expected CRC-32 */
+  uLong crcsum;                  /* CRC-32 of the data from the start */
+  bool crcok;                    /* crcsum covers all data before upos */
+  int method;                    /* ZIPFS_METHOD_STORE or Z_DEFLATED */
+  z_stream zs;
+  FAR uint8_t *inbuf;
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+  int npoints;
+  struct zipfs_point_s points[CONFIG_ZIPFS_SEEK_POINTS];
+#endif
+
   char relpath[1];
 };
 
@@ -85,6 +128,8 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen);
 static off_t   zipfs_seek(FAR struct file *filep, off_t offset,
                           int whence);
+static int     zipfs_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int     zipfs_dup(FAR const struct file *oldp,
                          FAR struct file *newp);
 static int     zipfs_fstat(FAR const struct file *filep,
@@ -136,7 +181,7 @@ const struct mountpt_operations g_zipfs_operations =
   NULL,                /* write */
   zipfs_seek,          /* seek */
   NULL,                /* ioctl */
-  NULL,                /* mmap */
+  zipfs_mmap,          /* mmap */
   NULL,                /* truncate */
   NULL,                /* poll */
   NULL,                /* readv */
@@ -243,6 +288,296 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+static int zipfs_data_open(FAR struct zipfs_file_s *fp,
+                           FAR const char *abspath)
+{
+  unz_file_info64 file_info;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info,
+                                NULL, 0, NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Encrypted entries are not supported, the raw data is read as is */
+
+  if ((file_info.compression_method != ZIPFS_METHOD_STORE &&
+       file_info.compression_method != Z_DEFLATED) ||
+      (file_info.flag & 1) != 0)
+    {
+      return -ENOSYS;
+    }
+
+  fp->method = file_info.compression_method;
+  fp->zbase  = unzGetCurrentFileZStreamPos64(fp->uf);
+  fp->zsize  = file_info.compressed_size;
+  fp->usize  = file_info.uncompressed_size;
+  fp->crc    = file_info.crc;
+  fp->crcsum = crc32(0, Z_NULL, 0);
+  fp->crcok  = true;
+
+  fp->inbuf = fs_heap_malloc(CONFIG_ZIPFS_READ_BUFSIZE);
+  if (fp->inbuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = file_open(&fp->zfile, abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      goto err_with_buf;
+    }
+
+  if (fp->method == Z_DEFLATED &&
+      inflateInit2(&fp->zs, -MAX_WBITS) != Z_OK)
+    {
+      ret = -ENOMEM;
+      goto err_with_file;
+    }
+
+  return OK;
+
+err_with_file:
+  file_close(&fp->zfile);
+err_with_buf:
+  fs_heap_free(fp->inbuf);
+  return ret;
+}
+
+static void zipfs_data_close(FAR struct zipfs_file_s *fp)
+{
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+  int i;
+
+  for (i = 0; i < fp->npoints; i++)
+    {
+      fs_heap_free(fp->points[i].window);
+    }
+#endif
+
+  if (fp->method == Z_DEFLATED)
+    {
+      inflateEnd(&fp->zs);
+    }
+
+  file_close(&fp->zfile);
+  fs_heap_free(fp->inbuf);
+}
+
+static ssize_t zipfs_data_fill(FAR struct zipfs_file_s *fp)
+{
+  off_t remain = fp->zsize - fp->zpos;
+  ssize_t nread;
+  off_t ret;
+
+  if (remain <= 0)
+    {
+      return 0;
+    }
+
+  if (remain > CONFIG_ZIPFS_READ_BUFSIZE)
+    {
+      remain = CONFIG_ZIPFS_READ_BUFSIZE;
+    }
+
+  ret = file_seek(&fp->zfile, fp->zbase + fp->zpos, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nread = file_read(&fp->zfile, fp->inbuf, remain);
+  if (nread > 0)
+    {
+      fp->zs.next_in  = fp->inbuf;
+      fp->zs.avail_in = nread;
+      fp->zpos       += nread;
+    }
+
+  return nread;
+}
+
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+static bool zipfs_point_due(FAR struct zipfs_file_s *fp, off_t out)
+{
+  off_t last = fp->npoints > 0 ? fp->points[fp->npoints - 1].out : 0;
+
+  return fp->npoints < CONFIG_ZIPFS_SEEK_POINTS &&
+         out - last >= CONFIG_ZIPFS_SEEK_SPAN;
+}
+
+/* Record a checkpoint at a deflate block boundary */
+
+static void zipfs_point_add(FAR struct zipfs_file_s *fp, off_t out)
+{
+  FAR struct zipfs_point_s *point = &fp->points[fp->npoints];
+
+  point->window = fs_heap_malloc(ZIPFS_WINDOW_SIZE);
+  if (point->window == NULL)
+    {
+      return;
+    }
+
+  if (inflateGetDictionary(&fp->zs, point->window,
+                           &point->wsize) != Z_OK)
+    {
+      fs_heap_free(point->window);
+      return;
+    }
+
+  point->out  = out;
+  point->in   = fp->zpos - fp->zs.avail_in;
+  point->bits = fp->zs.data_type & 7;
+  fp->npoints++;
+}
+
+static int zipfs_point_restore(FAR struct zipfs_file_s *fp,
+                               FAR const struct zipfs_point_s *point)
+{
+  ssize_t nread;
+  uint8_t ch;
+
+  inflateReset(&fp->zs);
+  fp->zs.avail_in = 0;
+  fp->zpos        = point->in;
+
+  /* The point may be in the middle of a byte */
+
+  if (point->bits)
+    {
+      fp->zpos--;
+      nread = zipfs_data_fill(fp);
+      if (nread <= 0)
+        {
+          return nread < 0 ? nread : -EIO;
+        }
+
+      ch = *fp->zs.next_in++;
+      fp->zs.avail_in--;
+      inflatePrime(&fp->zs, point->bits, ch >> (8 - point->bits));
+    }
+
+  inflateSetDictionary(&fp->zs, point->window, point->wsize);
+  fp->upos  = point->out;
+  fp->crcok = false;
+  return OK;
+}
+#endif
+
+static void zipfs_data_rewind(FAR struct zipfs_file_s *fp)
+{
+  if (fp->method == Z_DEFLATED)
+    {
+      inflateReset(&fp->zs);
+    }
+
+  fp->zs.avail_in = 0;
+  fp->zpos        = 0;
+  fp->upos        = 0;
+  fp->crcsum      = crc32(0, Z_NULL, 0);
+  fp->crcok       = true;
+}
+
+static ssize_t zipfs_data_inflate(FAR struct zipfs_file_s *fp,
+                                  FAR uint8_t *buffer, size_t buflen)
+{
+  ssize_t ret = 0;
+  int flush = Z_NO_FLUSH;
+
+  fp->zs.next_out  = buffer;
+  fp->zs.avail_out = buflen;
+
+  while (fp->zs.avail_out > 0)
+    {
+      if (fp->zs.avail_in == 0)
+        {
+          ret = zipfs_data_fill(fp);
+          if (ret <= 0)
+            {
+              ret = ret < 0 ? ret : -EIO;
+              break;
+            }
+        }
+
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+      /* Stop at each block boundary once the next point is due */
+
+      flush = zipfs_point_due(fp, fp->upos + buflen - fp->zs.avail_out) ?
+              Z_BLOCK : Z_NO_FLUSH;
+#endif
+
+      ret = inflate(&fp->zs, flush);
+      if (ret == Z_STREAM_END)
+        {
+          break;
+        }
+      else if (ret != Z_OK)
+        {
+          ret = ret == Z_MEM_ERROR ? -ENOMEM : -EIO;
+          break;
+        }
+
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+      if (flush == Z_BLOCK && (fp->zs.data_type & 128) != 0 &&
+          (fp->zs.data_type & 64) == 0)
+        {
+          zipfs_point_add(fp, fp->upos + buflen - fp->zs.avail_out);
+        }
+#endif
+    }
+
+  buflen -= fp->zs.avail_out;
+  return buflen > 0 ? buflen : ret;
+}
+
+static ssize_t zipfs_data_read(FAR struct zipfs_file_s *fp,
+                               FAR char *buffer, size_t buflen)
+{
+  ssize_t ret;
+
+  if (fp->upos >= fp->usize)
+    {
+      return 0;
+    }
+
+  if (buflen > fp->usize - fp->upos)
+    {
+      buflen = fp->usize - fp->upos;
+    }
+
+  if (fp->method == Z_DEFLATED)
+    {
+      ret = zipfs_data_inflate(fp, (FAR uint8_t *)buffer, buflen);
+    }
+  else
+    {
+      ret = file_seek(&fp->zfile, fp->zbase + fp->upos, SEEK_SET);
+      if (ret >= 0)
+        {
+          ret = file_read(&fp->zfile, buffer, buflen);
+        }
+    }
+
+  if (ret > 0)
+    {
+      if (fp->crcok)
+        {
+          fp->crcsum = crc32(fp->crcsum, (FAR const Bytef *)buffer, ret);
+        }
+
+      fp->upos += ret;
+      if (fp->upos == fp->usize && fp->crcok && fp->crcsum != fp->crc)
+        {
+          ret = -ESTALE;
+        }
+    }
+
+  return ret;
+}
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -252,7 +587,7 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
 
   DEBUGASSERT(fs != NULL);
 
-  fp = fs_heap_malloc(sizeof(*fp) + strlen(relpath));
+  fp = fs_heap_zalloc(sizeof(*fp) + strlen(relpath));
   if (fp == NULL)
     {
       return -ENOMEM;
@@ -277,12 +612,13 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_zip;
     }
 
-  ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+  ret = zipfs_convert_result(unzOpenCurrentFile2(fp->uf, NULL, NULL, 1));
   if (ret < 0)
     {
       goto err_with_zip;
     }
 
+  ret = zipfs_data_open(fp, fs->abspath);
   if (ret == OK)
     {
       fp->seekbuf = NULL;
@@ -307,6 +643,7 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+  zipfs_data_close(fp);
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -321,7 +658,7 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+  ret = zipfs_data_read(fp, buffer, buflen);
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -353,8 +690,7 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
           remain = CONFIG_ZIPFS_SEEK_BUFSIZE;
         }
 
-      remain = unzReadCurrentFile(fp->uf, fp->seekbuf, remain);
-      remain = zipfs_convert_result(remain);
+      remain = zipfs_data_read(fp, fp->seekbuf, remain);
       if (remain <= 0)
         {
           return next ? next : remain;
@@ -369,9 +705,11 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 static off_t zipfs_seek(FAR struct file *filep, off_t offset,
                         int whence)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp = filep->f_priv;
-  unz_file_info64 file_info;
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+  FAR struct zipfs_point_s *point = NULL;
+  int i;
+#endif
   off_t ret = 0;
 
   nxmutex_lock(&fp->lock);
@@ -383,52 +721,71 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         offset += filep->f_pos;
         break;
       case SEEK_END:
-        ret = unzGetCurrentFileInfo64(fp->uf, &file_info,
-                                      NULL, 0, NULL, 0, NULL, 0);
-        ret = zipfs_convert_result(ret);
-        if (ret < 0)
-          {
-            goto err_with_lock;
-          }
-
-          offset += file_info.uncompressed_size;
+        offset += fp->usize;
         break;
       default:
         ret = -EINVAL;
         goto err_with_lock;
     }
 
+  if (offset < 0)
+    {
+      ret = -EINVAL;
+      goto err_with_lock;
+    }
+
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
     }
-  else if (filep->f_pos > offset)
+
+  /* The stored data is read in place */
+
+  if (fp->method == ZIPFS_METHOD_STORE)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
-      if (ret < 0)
+      if (offset == 0)
         {
-          goto err_with_lock;
+          zipfs_data_rewind(fp);
         }
-
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
+      else
         {
-          ret = -EINVAL;
-          goto err_with_lock;
+          fp->upos  = offset;
+          fp->crcok = false;
         }
 
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
-      if (ret < 0)
+      filep->f_pos = offset;
+      goto err_with_lock;
+    }
+
+  /* Inflate from the closest point below offset, if it is ahead of the
+   * current position or the seek goes backward.
+   */
+
+#if CONFIG_ZIPFS_SEEK_POINTS > 0
+  for (i = fp->npoints - 1; i >= 0; i--)
+    {
+      if (fp->points[i].out <= offset)
         {
-          goto err_with_lock;
+          point = &fp->points[i];
+          break;
         }
+    }
 
-      ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+  if (point != NULL && (point->out > filep->f_pos || filep->f_pos > offset))
+    {
+      ret = zipfs_point_restore(fp, point);
       if (ret < 0)
         {
-          goto err_with_lock;
+          zipfs_data_rewind(fp);
         }
 
+      filep->f_pos = fp->upos;
+    }
+#endif
+
+  if (filep->f_pos > offset)
+    {
+      zipfs_data_rewind(fp);
       filep->f_pos = 0;
     }
 
@@ -448,6 +805,24 @@ err_with_lock:
   return ret < 0 ? ret : filep->f_pos;
 }
 
+static int zipfs_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  FAR struct zipfs_file_s *fp = filep->f_priv;
+  ZPOS64_T key;
+
+  /* Entries are identified by the offset of their central directory
+   * record, all of the read-only mappings of an entry share one
+   * decompressed copy.
+   */
+
+  nxmutex_lock(&fp->lock);
+  key = unzGetOffset64(fp->uf);
+  nxmutex_unlock(&fp->lock);
+
+  return rammap_shared(filep, map, key);
+}
+
 static int zipfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
   FAR struct zipfs_file_s *fp;
@@ -177,6 +177,17 @@ struct nxbe_plane_s
 
   NX_DRIVERTYPE *driver;
   NX_PLANEINFOTYPE pinfo;
+
+#ifdef CONFIG_NX_ACCEL
+  uint8_t planeno;                  /* Plane number in the driver */
+#endif
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+  /* Device regions updated since the last nxbe_notify_flush() */
+
+  struct nxgl_rect_s damage[CONFIG_NX_UPDATE_NRECTS];
+  uint8_t ndamage;
+#endif
 };
 
 /* Clipping *****************************************************************/
@@ -307,13 +318,56 @@ int nxbe_colormap(FAR NX_DRIVERTYPE *dev);
  *   interface.  This is the function that will handle the notification.  It
  *   receives the rectangular region that was updated on the provided plane.
  *
+ *   With CONFIG_NX_UPDATE_BATCH, the regions are only collected here and
+ *   are passed on by nxbe_notify_flush().
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect);
 #endif
 
+/****************************************************************************
+ * Name: nxbe_notify_flush
+ *
+ * Description:
+ *   Pass the regions collected by nxbe_notify_rectangle() to the driver.
+ *   This is called at the end of a frame, when the server has no more
+ *   queued requests, and when a client synchronizes with the server.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+void nxbe_notify_flush(FAR struct nxbe_state_s *be);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_accel_fill and nxbe_accel_copy
+ *
+ * Description:
+ *   Fill a rectangle or copy a bitmap region to the device with the
+ *   fillarea() or copyarea() method of the framebuffer driver.  The
+ *   arguments are those of the fillrectangle and copyrectangle raster
+ *   operations.
+ *
+ * Returned Value:
+ *   OK if the driver drew the rectangle; a negated errno value if the
+ *   caller must draw it with the raster operation instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_ACCEL
+int nxbe_accel_fill(FAR struct nxbe_plane_s *plane,
+                    FAR const struct nxgl_rect_s *rect,
+                    nxgl_mxpixel_t color);
+int nxbe_accel_copy(FAR struct nxbe_plane_s *plane,
+                    FAR const struct nxgl_rect_s *dest,
+                    FAR const void *src,
+                    FAR const struct nxgl_point_s *origin,
+                    unsigned int srcstride);
+#endif
+
 /****************************************************************************
  * Name: nx_configure
  *
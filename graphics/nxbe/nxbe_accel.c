@@ -0,0 +1,118 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/video/fb.h>
+#include <nuttx/nx/nxglib.h>
+
+#include "nxbe.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_accel_area
+ *
+ * Description:
+ *   Convert a device rectangle to a framebuffer area.  Return false if the
+ *   rectangle is too small to be worth the accelerator or the pixels are
+ *   not byte aligned.
+ *
+ ****************************************************************************/
+
+static bool nxbe_accel_area(FAR struct nxbe_plane_s *plane,
+                            FAR const struct nxgl_rect_s *rect,
+                            FAR struct fb_area_s *area)
+{
+  if (plane->pinfo.bpp < 8)
+    {
+      return false;
+    }
+
+  area->x = rect->pt1.x;
+  area->y = rect->pt1.y;
+  area->w = rect->pt2.x - rect->pt1.x + 1;
+  area->h = rect->pt2.y - rect->pt1.y + 1;
+
+  return (uint32_t)area->w * area->h >= CONFIG_NX_ACCEL_MINPIXELS;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_accel_fill
+ ****************************************************************************/
+
+int nxbe_accel_fill(FAR struct nxbe_plane_s *plane,
+                    FAR const struct nxgl_rect_s *rect,
+                    nxgl_mxpixel_t color)
+{
+  FAR struct fb_vtable_s *vtable = plane->driver;
+  struct fb_area_s area;
+
+  if (vtable->fillarea == NULL || !nxbe_accel_area(plane, rect, &area))
+    {
+      return -ENOTSUP;
+    }
+
+  return vtable->fillarea(vtable, plane->planeno, &area, color);
+}
+
+/****************************************************************************
+ * Name: nxbe_accel_copy
+ ****************************************************************************/
+
+int nxbe_accel_copy(FAR struct nxbe_plane_s *plane,
+                    FAR const struct nxgl_rect_s *dest,
+                    FAR const void *src,
+                    FAR const struct nxgl_point_s *origin,
+                    unsigned int srcstride)
+{
+  FAR struct fb_vtable_s *vtable = plane->driver;
+  FAR const uint8_t *sline;
+  struct fb_area_s area;
+
+  if (vtable->copyarea == NULL || !nxbe_accel_area(plane, dest, &area))
+    {
+      return -ENOTSUP;
+    }
+
+  /* Address of the first source pixel, as in nxgl_copyrectangle_*bpp */
+
+  sline = (FAR const uint8_t *)src +
+          (dest->pt1.x - origin->x) * (plane->pinfo.bpp >> 3) +
+          (dest->pt1.y - origin->y) * srcstride;
+
+  return vtable->copyarea(vtable, plane->planeno, &area, sline, srcstride);
+}
@@ -108,6 +108,9 @@ int nxbe_configure(FAR NX_DRIVERTYPE *dev, FAR struct nxbe_state_s *be)
         }
 
       be->plane[i].driver = dev;
+#ifdef CONFIG_NX_ACCEL
+      be->plane[i].planeno = i;
+#endif
 
       /* Select rasterizers to match the BPP reported for this plane.
        * NOTE that there are configuration options to eliminate support
@@ -26,10 +26,70 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 #include <nuttx/nx/nxglib.h>
 
 #include "nxbe.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+static uint32_t nxbe_rectarea(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: nxbe_damage_coalesce
+ *
+ * Description:
+ *   A grown damage rectangle may now overlap others.  Merge it with every
+ *   rectangle whose union does not cover more pixels than the two do
+ *   separately.
+ *
+ ****************************************************************************/
+
+static void nxbe_damage_coalesce(FAR struct nxbe_plane_s *plane, int slot)
+{
+  struct nxgl_rect_s merged;
+  bool again;
+  int i;
+
+  do
+    {
+      again = false;
+      for (i = 0; i < plane->ndamage; i++)
+        {
+          if (i == slot)
+            {
+              continue;
+            }
+
+          nxgl_rectunion(&merged, &plane->damage[i], &plane->damage[slot]);
+          if (nxbe_rectarea(&merged) <=
+              nxbe_rectarea(&plane->damage[i]) +
+              nxbe_rectarea(&plane->damage[slot]))
+            {
+              plane->damage[slot] = merged;
+              plane->damage[i]    = plane->damage[--plane->ndamage];
+              if (slot == plane->ndamage)
+                {
+                  slot = i;
+                }
+
+              again = true;
+              break;
+            }
+        }
+    }
+  while (again);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -56,12 +116,74 @@
  ****************************************************************************/
 
 #ifdef CONFIG_NX_UPDATE
-void nxbe_notify_rectangle(FAR NX_DRIVERTYPE *dev,
+void nxbe_notify_rectangle(FAR struct nxbe_plane_s *plane,
                            FAR const struct nxgl_rect_s *rect)
 {
+#ifdef CONFIG_NX_UPDATE_BATCH
+  struct nxgl_rect_s merged;
+  uint32_t growth;
+  uint32_t best = UINT32_MAX;
+  int slot = -1;
+  int i;
+
+  /* Find the damage rectangle that grows the least by adding rect */
+
+  for (i = 0; i < plane->ndamage; i++)
+    {
+      nxgl_rectunion(&merged, &plane->damage[i], rect);
+      growth = nxbe_rectarea(&merged) - nxbe_rectarea(&plane->damage[i]);
+      if (growth < best)
+        {
+          best = growth;
+          slot = i;
+        }
+    }
+
+  /* Keep rect separate unless merging sends no extra pixels, or there is
+   * no free slot left.
+   */
+
+  if (slot >= 0 && (best <= nxbe_rectarea(rect) ||
+                    plane->ndamage >= CONFIG_NX_UPDATE_NRECTS))
+    {
+      nxgl_rectunion(&plane->damage[slot], &plane->damage[slot], rect);
+      nxbe_damage_coalesce(plane, slot);
+    }
+  else
+    {
+      plane->damage[plane->ndamage++] = *rect;
+    }
+#else
   struct fb_area_s area;
 
   nxgl_rect2area(&area, rect);
-  dev->updatearea(dev, &area);
+  plane->driver->updatearea(plane->driver, &area);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: nxbe_notify_flush
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_UPDATE_BATCH
+void nxbe_notify_flush(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_plane_s *plane;
+  struct fb_area_s area;
+  int i;
+  int j;
+
+  for (i = 0; i < CONFIG_NX_NPLANES; i++)
+    {
+      plane = &be->plane[i];
+      for (j = 0; j < plane->ndamage; j++)
+        {
+          nxgl_rect2area(&area, &plane->damage[j]);
+          plane->driver->updatearea(plane->driver, &area);
+        }
+
+      plane->ndamage = 0;
+    }
 }
 #endif
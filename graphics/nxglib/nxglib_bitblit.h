@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -106,53 +107,23 @@
 #  define NXGL_ALIGNDOWN(x)        ((x) & ~NXGL_PIXELMASK)
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
 
+/* The row copies use memmove(), the C library version is usually the
+ * fastest copy loop available and rows of a move may overlap.
+ */
+
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
-     int        _nby = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
+   memset((dest), (uint8_t)(value), NXGL_SCALEX(width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     int        _nby  = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr  = (FAR uint8_t*)(dest); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_ptr++ = (value); \
-         *_ptr++ = (value) >> 8; \
-         *_ptr++ = (value) >> 16; \
-       } \
-   }
+   nxgl_memset24((FAR uint8_t *)(dest), (value), (width))
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -173,6 +144,10 @@
 #endif /* CONFIG_NX_ANTIALIASING */
 #else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
 
+#if NXGLIB_BITSPERPIXEL == 16
+#  define NXGL_MEMSET(dest,value,width) \
+   nxgl_memset16((FAR uint16_t *)(dest), (value), (width))
+#else
 #  define NXGL_MEMSET(dest,value,width) \
    { \
      FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
@@ -182,17 +157,10 @@
          *_ptr++ = (value); \
        } \
    }
+#endif
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+   memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -211,6 +179,81 @@
 #define _NXGL_FUNCNAME(a,b) a ## b
 #define NXGL_FUNCNAME(a,b)  _NXGL_FUNCNAME(a,b)
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+/* Fill a run of 16-bit pixels two at a time with aligned word stores */
+
+static inline void nxgl_memset16(FAR uint16_t *dest, uint16_t value,
+                                 nxgl_coord_t npix)
+{
+  FAR uint32_t *dest2;
+  uint32_t value2 = (uint32_t)value << 16 | value;
+
+  if (npix > 0 && ((uintptr_t)dest & 2) != 0)
+    {
+      *dest++ = value;
+      npix--;
+    }
+
+  for (dest2 = (FAR uint32_t *)dest; npix >= 2; npix -= 2)
+    {
+      *dest2++ = value2;
+    }
+
+  if (npix > 0)
+    {
+      *(FAR uint16_t *)dest2 = value;
+    }
+}
+
+#elif NXGLIB_BITSPERPIXEL == 24
+/* Fill a run of 24-bit pixels, four pixels with three aligned word stores
+ * once the destination is aligned.
+ */
+
+static inline void nxgl_memset24(FAR uint8_t *dest, uint32_t value,
+                                 nxgl_coord_t npix)
+{
+#ifndef CONFIG_ENDIAN_BIG
+  FAR uint32_t *dest3;
+  uint32_t w0;
+  uint32_t w1;
+  uint32_t w2;
+
+  for (; npix > 0 && ((uintptr_t)dest & 3) != 0; npix--)
+    {
+      *dest++ = value;
+      *dest++ = value >> 8;
+      *dest++ = value >> 16;
+    }
+
+  value &= 0xffffff;
+  w0 = value | value << 24;
+  w1 = value >> 8 | value << 16;
+  w2 = value >> 16 | value << 8;
+
+  for (dest3 = (FAR uint32_t *)dest; npix >= 4; npix -= 4)
+    {
+      *dest3++ = w0;
+      *dest3++ = w1;
+      *dest3++ = w2;
+    }
+
+  dest = (FAR uint8_t *)dest3;
+#endif
+
+  for (; npix > 0; npix--)
+    {
+      *dest++ = value;
+      *dest++ = value >> 8;
+      *dest++ = value >> 16;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -418,6 +418,23 @@ struct crypt_op
   caddr_t aad;
 };
 
+/* One operation of a batch for CIOCCRYPTMULTI, CIOCNCRYPTM and
+ * CIOCNCRYPTRETM
+ */
+
+struct crypt_n_op
+{
+  struct crypt_op cop;
+  uint32_t reqid;     /* Identifies the request in the completions */
+  int status;         /* returns: result of the operation */
+};
+
+struct crypt_mop
+{
+  unsigned count;     /* returns: number of completions (CIOCNCRYPTRETM) */
+  FAR struct crypt_n_op *reqs;
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -439,6 +456,9 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCCRYPTMULTI          107 /* Perform a batch of operations */
+#define CIOCNCRYPTM             108 /* Queue a batch of operations */
+#define CIOCNCRYPTRETM          109 /* Collect completed operations */
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
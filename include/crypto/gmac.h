@@ -48,6 +48,8 @@ AES_GMAC_CTX;
 
 extern void (*ghash_update)(FAR GHASH_CTX *, FAR uint8_t *, size_t);
 
+void ghash_update_mi(FAR GHASH_CTX *, FAR uint8_t *, size_t);
+
 void aes_gmac_init(FAR void *);
 void aes_gmac_setkey(FAR void *, FAR const uint8_t *, uint16_t);
 void aes_gmac_reinit(FAR void *, FAR const uint8_t *, uint16_t);
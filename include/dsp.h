@@ -512,6 +512,16 @@ void park_transform(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
                     FAR dq_frame_f32_t *dq);
 void inv_park_transform(FAR phase_angle_f32_t *angle, FAR dq_frame_f32_t *dq,
                         FAR ab_frame_f32_t *ab);
+void clarke_transform_batch(FAR abc_frame_f32_t *abc, FAR ab_frame_f32_t *ab,
+                            int n);
+void inv_clarke_transform_batch(FAR ab_frame_f32_t *ab,
+                                FAR abc_frame_f32_t *abc, int n);
+void park_transform_batch(FAR phase_angle_f32_t *angle,
+                          FAR ab_frame_f32_t *ab, FAR dq_frame_f32_t *dq,
+                          int n);
+void inv_park_transform_batch(FAR phase_angle_f32_t *angle,
+                              FAR dq_frame_f32_t *dq, FAR ab_frame_f32_t *ab,
+                              int n);
 
 /* Phase angle related functions */
 
@@ -541,6 +551,12 @@ void foc_current_control(FAR struct foc_data_f32_s *foc,
                          FAR dq_frame_f32_t *idq_ref,
                          FAR dq_frame_f32_t *vdq_comp,
                          FAR dq_frame_f32_t *v_dq_ref);
+void foc_voltage_control_batch(FAR struct foc_data_f32_s *foc,
+                               FAR dq_frame_f32_t *vdq_ref, int n);
+void foc_current_control_batch(FAR struct foc_data_f32_s *foc,
+                               FAR dq_frame_f32_t *idq_ref,
+                               FAR dq_frame_f32_t *vdq_comp,
+                               FAR dq_frame_f32_t *v_dq_ref, int n);
 void foc_vabmod_get(FAR struct foc_data_f32_s *foc,
                     FAR ab_frame_f32_t *v_ab_mod);
 void foc_vdq_mag_max_get(FAR struct foc_data_f32_s *foc, FAR float *max);
@@ -494,6 +494,16 @@ void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
                         FAR dq_frame_b16_t *dq);
 void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
                             FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
+void clarke_transform_batch_b16(FAR abc_frame_b16_t *abc,
+                                FAR ab_frame_b16_t *ab, int n);
+void inv_clarke_transform_batch_b16(FAR ab_frame_b16_t *ab,
+                                    FAR abc_frame_b16_t *abc, int n);
+void park_transform_batch_b16(FAR phase_angle_b16_t *angle,
+                              FAR ab_frame_b16_t *ab,
+                              FAR dq_frame_b16_t *dq, int n);
+void inv_park_transform_batch_b16(FAR phase_angle_b16_t *angle,
+                                  FAR dq_frame_b16_t *dq,
+                                  FAR ab_frame_b16_t *ab, int n);
 
 /* Phase angle related functions */
 
@@ -523,6 +533,12 @@ void foc_current_control_b16(FAR struct foc_data_b16_s *foc,
                              FAR dq_frame_b16_t *idq_ref,
                              FAR dq_frame_b16_t *vdq_comp,
                              FAR dq_frame_b16_t *v_dq_ref);
+void foc_voltage_control_batch_b16(FAR struct foc_data_b16_s *foc,
+                                   FAR dq_frame_b16_t *vdq_ref, int n);
+void foc_current_control_batch_b16(FAR struct foc_data_b16_s *foc,
+                                   FAR dq_frame_b16_t *idq_ref,
+                                   FAR dq_frame_b16_t *vdq_comp,
+                                   FAR dq_frame_b16_t *v_dq_ref, int n);
 void foc_vabmod_get_b16(FAR struct foc_data_b16_s *foc,
                         FAR ab_frame_b16_t *v_ab_mod);
 void foc_vdq_mag_max_get_b16(FAR struct foc_data_b16_s *foc, FAR b16_t *max);
@@ -113,6 +113,8 @@
 #define F_DUPFD_CLOEXEC 18 /* Duplicate file descriptor with close-on-exit set.  */
 #define F_SETPIPE_SZ    19 /* Modify the capacity of the pipe to arg bytes, but not larger than CONFIG_DEV_PIPE_MAXSIZE */
 #define F_GETPIPE_SZ    20 /* Return the capacity of the pipe */
+#define F_SETPIPE_LOWAT 21 /* Set the bytes a blocking pipe read waits for */
+#define F_GETPIPE_LOWAT 22 /* Return the read low watermark of the pipe */
 
 /* For posix fcntl() and lockf() */
 
@@ -160,6 +162,13 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Flags for splice() and tee(), accepted as hints only */
+
+#define SPLICE_F_MOVE       0x0001 /* Move pages instead of copying */
+#define SPLICE_F_NONBLOCK   0x0002 /* Don't block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* More data will be coming */
+#define SPLICE_F_GIFT       0x0008 /* Pages passed in are a gift */
+
 #if defined(CONFIG_FS_LARGEFILE)
 #  define F_GETLK64         F_GETLK
 #  define F_SETLK64         F_SETLK
@@ -215,6 +224,10 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int infd, FAR off_t *inoff, int outfd, FAR off_t *outoff,
+               size_t count, unsigned int flags);
+ssize_t tee(int infd, int outfd, size_t count, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
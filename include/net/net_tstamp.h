@@ -0,0 +1,99 @@
+/****************************************************************************
+ * include/net/net_tstamp.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NET_NET_TSTAMP_H
+#define __INCLUDE_NET_NET_TSTAMP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags of the SO_TIMESTAMPING socket option, compatible with Linux.  The
+ * *_HARDWARE and *_SOFTWARE generation flags select which timestamps are
+ * taken, SOF_TIMESTAMPING_SOFTWARE and SOF_TIMESTAMPING_RAW_HARDWARE
+ * select which of them are reported.
+ */
+
+#define SOF_TIMESTAMPING_TX_HARDWARE  (1 << 0) /* NIC time of transmission */
+#define SOF_TIMESTAMPING_TX_SOFTWARE  (1 << 1) /* Time handed to the NIC */
+#define SOF_TIMESTAMPING_RX_HARDWARE  (1 << 2) /* NIC time of arrival */
+#define SOF_TIMESTAMPING_RX_SOFTWARE  (1 << 3) /* Time taken from the NIC */
+#define SOF_TIMESTAMPING_SOFTWARE     (1 << 4) /* Report ts[0] */
+#define SOF_TIMESTAMPING_SYS_HARDWARE (1 << 5) /* Deprecated, ignored */
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6) /* Report ts[2] */
+#define SOF_TIMESTAMPING_OPT_ID       (1 << 7) /* Key reports in ee_data */
+
+/* Reports carry no payload, accepted as this is the only mode */
+
+#define SOF_TIMESTAMPING_OPT_TSONLY   (1 << 11)
+
+#define SOF_TIMESTAMPING_TX_RECORD_MASK \
+  (SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_TX_SOFTWARE)
+#define SOF_TIMESTAMPING_RX_RECORD_MASK \
+  (SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE)
+#define SOF_TIMESTAMPING_MASK         ((SOF_TIMESTAMPING_OPT_TSONLY << 1) - 1)
+
+/* Transmit timestamping modes of struct hwtstamp_config tx_type */
+
+#define HWTSTAMP_TX_OFF               0 /* Do not stamp sent packets */
+#define HWTSTAMP_TX_ON                1 /* Stamp packets that ask for it */
+
+/* Receive filters of struct hwtstamp_config rx_filter */
+
+#define HWTSTAMP_FILTER_NONE            0  /* Do not stamp received packets */
+#define HWTSTAMP_FILTER_ALL             1  /* Stamp all received packets */
+#define HWTSTAMP_FILTER_PTP_V2_L2_EVENT 9  /* 802.1AS event messages */
+#define HWTSTAMP_FILTER_PTP_V2_EVENT    12 /* PTPv2 events, any layer */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* Payload of the SCM_TIMESTAMPING control message: ts[0] holds the
+ * software timestamp and ts[2] the hardware timestamp, ts[1] is unused.
+ * Timestamps that were not taken are zero.
+ */
+
+struct scm_timestamping
+{
+  struct timespec ts[3];
+};
+
+/* Argument of the SIOCSHWTSTAMP and SIOCGHWTSTAMP ioctls, passed through
+ * ifr_data.  The driver may widen rx_filter to a filter it supports and
+ * returns the filter it applied.
+ */
+
+struct hwtstamp_config
+{
+  int flags;      /* Reserved, must be zero */
+  int tx_type;    /* HWTSTAMP_TX_* */
+  int rx_filter;  /* HWTSTAMP_FILTER_* */
+};
+
+#endif /* __INCLUDE_NET_NET_TSTAMP_H */
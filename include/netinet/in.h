@@ -114,6 +114,8 @@
 #define IP_TTL                (__SO_PROTOCOL + 14) /* The IP TTL (time to live)
                                                     * of IP packets sent by the
                                                     * network stack */
+#define IP_RECVERR            (__SO_PROTOCOL + 15) /* Extended error reports
+                                                    * from the error queue */
 
 /* SOL_IPV6 protocol-level socket options. */
 
@@ -136,6 +138,19 @@
                                                     * field */
 #define IPV6_RECVHOPLIMIT     (__SO_PROTOCOL + 11) /* Access the hop limit field */
 #define IPV6_HOPLIMIT         (__SO_PROTOCOL + 12) /* Hop limit */
+#define IPV6_RECVERR          (__SO_PROTOCOL + 13) /* Extended error reports
+                                                    * from the error queue */
+
+/* Values of sock_extended_err ee_origin and ee_code */
+
+#define SO_EE_ORIGIN_NONE     0
+#define SO_EE_ORIGIN_LOCAL    1
+#define SO_EE_ORIGIN_ICMP     2
+#define SO_EE_ORIGIN_ICMP6    3
+#define SO_EE_ORIGIN_TIMESTAMPING 4
+#define SO_EE_ORIGIN_ZEROCOPY 5
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
 
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
@@ -356,6 +371,24 @@ struct in6_ifreq
   int             ifr6_ifindex;     /* The interface index of the request */
 };
 
+/* Error queue report carried by IP_RECVERR/IPV6_RECVERR control messages.
+ * For SO_EE_ORIGIN_ZEROCOPY, ee_info and ee_data hold the first and the
+ * last of a range of completed MSG_ZEROCOPY send calls.  For
+ * SO_EE_ORIGIN_TIMESTAMPING, ee_data holds the SOF_TIMESTAMPING_OPT_ID key
+ * of the packet the timestamps belong to.
+ */
+
+struct sock_extended_err
+{
+  uint32_t        ee_errno;         /* Error number */
+  uint8_t         ee_origin;        /* Where the error originated */
+  uint8_t         ee_type;          /* Type */
+  uint8_t         ee_code;          /* Code */
+  uint8_t         ee_pad;           /* Padding */
+  uint32_t        ee_info;          /* Additional information */
+  uint32_t        ee_data;          /* Other data */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -59,4 +59,16 @@
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 #define TCP_CORK      (__SO_PROTOCOL + 5) /* Coalescing of small segments */
 
+/* Congestion control algorithm.  Argument: name string */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 6)
+
+#define TCP_ULP       (__SO_PROTOCOL + 7) /* Upper layer protocol ("tls"),
+                                           * see include/netinet/tls.h
+                                           * Argument: name string */
+
+/* The longest name of a congestion control algorithm, including the NUL */
+
+#define TCP_CA_NAME_MAX 16
+
 #endif /* __INCLUDE_NETINET_TCP_H */
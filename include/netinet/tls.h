@@ -0,0 +1,124 @@
+/****************************************************************************
+ * include/netinet/tls.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NETINET_TLS_H
+#define __INCLUDE_NETINET_TLS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/socket.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Kernel TLS record layer, compatible with the Linux interface.  After the
+ * handshake, the "tls" upper layer protocol is attached with
+ * setsockopt(SOL_TCP, TCP_ULP, "tls") and the keys of each direction are
+ * installed with setsockopt(SOL_TLS, TLS_TX or TLS_RX, &crypto_info).
+ * From then on send() and recv() carry plaintext and the kernel does the
+ * record framing and the AEAD encryption.
+ */
+
+#define SOL_TLS                 282
+
+/* SOL_TLS socket options */
+
+#define TLS_TX                  1  /* Install the transmit keys */
+#define TLS_RX                  2  /* Install the receive keys */
+
+/* Control message type of recvmsg(): the content type of a record that is
+ * not application data (alert, handshake).  Argument: unsigned char
+ */
+
+#define TLS_GET_RECORD_TYPE     2
+
+/* Protocol versions */
+
+#define TLS_1_2_VERSION         0x0303
+#define TLS_1_3_VERSION         0x0304
+
+/* Cipher suites */
+
+#define TLS_CIPHER_AES_GCM_128  51
+#define TLS_CIPHER_AES_GCM_128_IV_SIZE       8
+#define TLS_CIPHER_AES_GCM_128_KEY_SIZE      16
+#define TLS_CIPHER_AES_GCM_128_SALT_SIZE     4
+#define TLS_CIPHER_AES_GCM_128_TAG_SIZE      16
+#define TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE  8
+
+#define TLS_CIPHER_AES_GCM_256  52
+#define TLS_CIPHER_AES_GCM_256_IV_SIZE       8
+#define TLS_CIPHER_AES_GCM_256_KEY_SIZE      32
+#define TLS_CIPHER_AES_GCM_256_SALT_SIZE     4
+#define TLS_CIPHER_AES_GCM_256_TAG_SIZE      16
+#define TLS_CIPHER_AES_GCM_256_REC_SEQ_SIZE  8
+
+#define TLS_CIPHER_CHACHA20_POLY1305  54
+#define TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE       12
+#define TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE      32
+#define TLS_CIPHER_CHACHA20_POLY1305_SALT_SIZE     0
+#define TLS_CIPHER_CHACHA20_POLY1305_TAG_SIZE      16
+#define TLS_CIPHER_CHACHA20_POLY1305_REC_SEQ_SIZE  8
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The common prologue of the crypto_info structures */
+
+struct tls_crypto_info
+{
+  uint16_t version;       /* TLS_1_2_VERSION or TLS_1_3_VERSION */
+  uint16_t cipher_type;   /* TLS_CIPHER_* */
+};
+
+struct tls12_crypto_info_aes_gcm_128
+{
+  struct tls_crypto_info info;
+  uint8_t iv[TLS_CIPHER_AES_GCM_128_IV_SIZE];
+  uint8_t key[TLS_CIPHER_AES_GCM_128_KEY_SIZE];
+  uint8_t salt[TLS_CIPHER_AES_GCM_128_SALT_SIZE];
+  uint8_t rec_seq[TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE];
+};
+
+struct tls12_crypto_info_aes_gcm_256
+{
+  struct tls_crypto_info info;
+  uint8_t iv[TLS_CIPHER_AES_GCM_256_IV_SIZE];
+  uint8_t key[TLS_CIPHER_AES_GCM_256_KEY_SIZE];
+  uint8_t salt[TLS_CIPHER_AES_GCM_256_SALT_SIZE];
+  uint8_t rec_seq[TLS_CIPHER_AES_GCM_256_REC_SEQ_SIZE];
+};
+
+struct tls12_crypto_info_chacha20_poly1305
+{
+  struct tls_crypto_info info;
+  uint8_t iv[TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE];
+  uint8_t key[TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE];
+  uint8_t rec_seq[TLS_CIPHER_CHACHA20_POLY1305_REC_SEQ_SIZE];
+};
+
+#endif /* __INCLUDE_NETINET_TLS_H */
@@ -49,8 +49,40 @@
 #define PACKET_ADD_MEMBERSHIP  1 /* Add a multicast address to the interface */
 #define PACKET_DROP_MEMBERSHIP 2 /* Drop a multicast address from the interface */
 
+#define PACKET_RX_RING         5 /* Set up the memory mapped receive ring */
+#define PACKET_TX_RING        13 /* Set up the memory mapped transmit ring */
+#define PACKET_TX_TIMESTAMP   16 /* Control message type of a transmit
+                                  * timestamp report, see SO_TIMESTAMPING */
+
 #define PACKET_MR_MULTICAST    0 /* Multicast address */
 
+/* Frame status values in tpacket_hdr::tp_status.  Receive frames are owned
+ * by the kernel while TP_STATUS_KERNEL and by the application once
+ * TP_STATUS_USER is set; transmit frames are handed to the kernel by
+ * setting TP_STATUS_SEND_REQUEST and returned as TP_STATUS_AVAILABLE.
+ */
+
+#define TP_STATUS_KERNEL       0
+#define TP_STATUS_USER         (1 << 0)
+#define TP_STATUS_COPY         (1 << 1)
+#define TP_STATUS_LOSING       (1 << 2) /* Frames were dropped before */
+
+#define TP_STATUS_AVAILABLE    0
+#define TP_STATUS_SEND_REQUEST (1 << 0)
+#define TP_STATUS_SENDING      (1 << 1)
+#define TP_STATUS_WRONG_FORMAT (1 << 2)
+
+/* Ring frame layout: a tpacket_hdr, then a sockaddr_ll describing the
+ * frame, then the frame data at tp_mac.  Transmit data starts right after
+ * the aligned tpacket_hdr.
+ */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x)       (((x) + TPACKET_ALIGNMENT - 1) & \
+                                ~(TPACKET_ALIGNMENT - 1))
+#define TPACKET_HDRLEN         (TPACKET_ALIGN(sizeof(struct tpacket_hdr)) + \
+                                sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -74,4 +106,32 @@ struct packet_mreq
   unsigned char  mr_address[8];
 };
 
+/* Per-frame header at the start of every PACKET_RX_RING and PACKET_TX_RING
+ * frame.
+ */
+
+struct tpacket_hdr
+{
+  unsigned long  tp_status;
+  unsigned int   tp_len;           /* Length of the frame on the wire */
+  unsigned int   tp_snaplen;       /* Number of bytes stored in the ring */
+  unsigned short tp_mac;           /* Offset of the link layer header */
+  unsigned short tp_net;           /* Offset of the network header */
+  unsigned int   tp_sec;
+  unsigned int   tp_usec;
+};
+
+/* Ring geometry passed to PACKET_RX_RING and PACKET_TX_RING.  The ring is
+ * tp_block_nr blocks of tp_block_size bytes, each holding a whole number of
+ * tp_frame_size frames.  A tp_block_nr of zero releases the ring.
+ */
+
+struct tpacket_req
+{
+  unsigned int   tp_block_size;
+  unsigned int   tp_block_nr;
+  unsigned int   tp_frame_size;
+  unsigned int   tp_frame_nr;
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
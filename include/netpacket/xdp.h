@@ -0,0 +1,165 @@
+/****************************************************************************
+ * include/netpacket/xdp.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NETPACKET_XDP_H
+#define __INCLUDE_NETPACKET_XDP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bind flags in sockaddr_xdp::sxdp_flags.  Only copy mode is supported. */
+
+#define XDP_SHARED_UMEM          (1 << 0)
+#define XDP_COPY                 (1 << 1)
+#define XDP_ZEROCOPY             (1 << 2)
+
+/* AF_XDP socket options, level SOL_XDP */
+
+#define SOL_XDP                  283
+
+#define XDP_MMAP_OFFSETS         1  /* get: struct xdp_mmap_offsets */
+#define XDP_RX_RING              2  /* set: int, number of descriptors */
+#define XDP_TX_RING              3  /* set: int, number of descriptors */
+#define XDP_UMEM_REG             4  /* set: struct xdp_umem_reg */
+#define XDP_UMEM_FILL_RING       5  /* set: int, number of descriptors */
+#define XDP_UMEM_COMPLETION_RING 6  /* set: int, number of descriptors */
+#define XDP_STATISTICS           7  /* get: struct xdp_statistics */
+#define XDP_OPTIONS              8  /* get: struct xdp_options */
+#define XDP_FILTER               64 /* set: struct xdp_filter_insn[] */
+
+#define XDP_OPTIONS_ZEROCOPY     (1 << 0)
+
+/* mmap() offsets of the four rings.  These differ from Linux so that they
+ * fit into a 32-bit off_t.
+ */
+
+#define XDP_PGOFF_RX_RING              0
+#define XDP_PGOFF_TX_RING              0x10000000
+#define XDP_UMEM_PGOFF_FILL_RING       0x20000000
+#define XDP_UMEM_PGOFF_COMPLETION_RING 0x30000000
+
+/* Filter program actions.  A program is a list of clauses, each a run of
+ * XDP_FILTER_CONT instructions closed by one with a verdict; a clause
+ * whose comparisons all hold decides the frame's fate, else the next
+ * clause is tried.  A frame matching no clause goes to the stack, and an
+ * empty program redirects every frame.
+ */
+
+#define XDP_FILTER_CONT          0  /* Match required, continue clause */
+#define XDP_FILTER_DROP          1  /* Drop the frame */
+#define XDP_FILTER_PASS          2  /* Hand the frame to the stack */
+#define XDP_FILTER_REDIRECT      4  /* Deliver the frame to the socket */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct sockaddr_xdp
+{
+  uint16_t sxdp_family;          /* AF_XDP */
+  uint16_t sxdp_flags;           /* XDP_COPY */
+  uint32_t sxdp_ifindex;         /* Interface to attach to */
+  uint32_t sxdp_queue_id;        /* RX queue of the interface */
+  uint32_t sxdp_shared_umem_fd;  /* Not supported */
+};
+
+/* Byte offsets of the fields of a ring inside its mapping */
+
+struct xdp_ring_offset
+{
+  uint64_t producer;
+  uint64_t consumer;
+  uint64_t desc;
+  uint64_t flags;
+};
+
+struct xdp_mmap_offsets
+{
+  struct xdp_ring_offset rx;
+  struct xdp_ring_offset tx;
+  struct xdp_ring_offset fr;     /* Fill ring */
+  struct xdp_ring_offset cr;     /* Completion ring */
+};
+
+/* The UMEM: a buffer owned by the application and split into chunks of
+ * chunk_size bytes (a power of two).  Frames are stored headroom bytes
+ * into a chunk.
+ */
+
+struct xdp_umem_reg
+{
+  uint64_t addr;
+  uint64_t len;
+  uint32_t chunk_size;
+  uint32_t headroom;
+  uint32_t flags;
+};
+
+struct xdp_statistics
+{
+  uint64_t rx_dropped;               /* Frames dropped for other reasons */
+  uint64_t rx_invalid_descs;         /* Bad fill ring descriptors */
+  uint64_t tx_invalid_descs;         /* Bad TX ring descriptors */
+  uint64_t rx_ring_full;             /* Frames dropped, RX ring full */
+  uint64_t rx_fill_ring_empty_descs; /* Frames dropped, fill ring empty */
+  uint64_t tx_ring_empty_descs;      /* Flushes with nothing to send */
+};
+
+struct xdp_options
+{
+  uint32_t flags;
+};
+
+/* RX and TX ring descriptor: a frame at UMEM offset addr.  The fill and
+ * completion rings hold bare uint64_t UMEM offsets.
+ */
+
+struct xdp_desc
+{
+  uint64_t addr;
+  uint32_t len;
+  uint32_t options;
+};
+
+/* One filter instruction: compare the 'size' (1, 2 or 4) byte big endian
+ * field at frame offset 'off', masked with 'mask', against 'value'.
+ */
+
+struct xdp_filter_insn
+{
+  uint16_t off;
+  uint8_t  size;
+  uint8_t  action;
+  uint32_t mask;
+  uint32_t value;
+};
+
+#endif /* __INCLUDE_NETPACKET_XDP_H */
@@ -2551,6 +2551,27 @@ void nxsched_process_cpuload_ticks(clock_t ticks);
 
 void irq_dispatch(int irq, FAR void *context);
 
+/****************************************************************************
+ * Name: nxsched_fpu_trap
+ *
+ * Description:
+ *   Called by the architecture when the running task executes an FPU
+ *   instruction without FPU access (CONFIG_SCHED_LAZYFPU).
+ *
+ * Input Parameters:
+ *   tcb - The running task.
+ *
+ * Returned Value:
+ *   True if the task has been given the FPU and the instruction should be
+ *   retried.  False if the task already had access, in which case this is
+ *   a genuine fault.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LAZYFPU
+bool nxsched_fpu_trap(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: up_check_tcbstack and friends
  *
@@ -2897,6 +2918,28 @@ clock_t up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(clock_t elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_perf_counter_*
+ *
+ * Description:
+ *   Program the programmable hardware event counters of the current CPU.
+ *   up_perf_counter_start() makes counter 'index' count the PERF_EVENT_*
+ *   event 'event' (see include/nuttx/drivers/perf.h), starting from zero,
+ *   and returns -ENOTSUP if the event cannot be counted or -ENOSPC if there
+ *   is no such counter.  up_perf_counter_read() returns the low 32 bits of
+ *   the count; callers take care of the wrap-around.
+ *
+ * Assumptions:
+ *   Called with interrupts disabled, on the CPU whose counters they use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PERF_COUNTERS
+int up_perf_counter_start(int index, int event);
+void up_perf_counter_stop(int index);
+uint32_t up_perf_counter_read(int index);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
@@ -2947,6 +2990,39 @@ bool up_fpucmp(FAR const void *saveregs1, FAR const void *saveregs2);
 #define up_fpucmp(r1, r2) (true)
 #endif
 
+/****************************************************************************
+ * Name: up_fpu_access
+ *
+ * Description:
+ *   Grant or revoke FPU access for a task that is being resumed.  With
+ *   CONFIG_SCHED_LAZYFPU the scheduler calls this on every context switch.
+ *   A task without access traps on its first FPU instruction, and the
+ *   trap handler then calls nxsched_fpu_trap().
+ *
+ * Input Parameters:
+ *   tcb    - The task being resumed.
+ *   enable - True if the FPU registers already hold the task's state.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LAZYFPU
+void up_fpu_access(FAR struct tcb_s *tcb, bool enable);
+#endif
+
+/****************************************************************************
+ * Name: up_fpu_restore
+ *
+ * Description:
+ *   Load the saved FPU state of a task into the FPU and grant the task
+ *   FPU access.  The architecture saves the state when the task is
+ *   suspended, and only if the task has modified it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LAZYFPU
+void up_fpu_restore(FAR struct tcb_s *tcb);
+#endif
+
 /****************************************************************************
  * Name: up_regs_memcpy
  ****************************************************************************/
@@ -3071,6 +3147,27 @@ void up_release_irq_msi(FAR int *irq, int num);
 int up_connect_irq(FAR const int *irq, int num,
                    FAR uintptr_t *mar, FAR uint32_t *mdr);
 
+/****************************************************************************
+ * Name: up_affinity_irq_msi
+ *
+ * Description:
+ *  Get the MSI/MSI-X message that delivers an interrupt to a given CPU.
+ *  Only needed where the destination is encoded in the message.
+ *
+ * Input Parameters:
+ *   irq - connected vector
+ *   cpu - destination CPU
+ *   mar - returned value for Message Address Register
+ *   mdr - returned value for Message Data Register
+ *
+ * Returned Value:
+ *   OK on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int up_affinity_irq_msi(int irq, int cpu,
+                        FAR uintptr_t *mar, FAR uint32_t *mdr);
+
 /****************************************************************************
  * Name: up_get_legacy_irq
  *
@@ -331,6 +331,11 @@
 #define AUDIO_CALLBACK_COMPLETE     0x03
 #define AUDIO_CALLBACK_MESSAGE      0x04
 #define AUDIO_CALLBACK_UNDERRUN     0x05
+#define AUDIO_CALLBACK_PERIOD       0x06
+
+/* Memory mapped period ring flags ******************************************/
+
+#define AUDIO_RING_PLAYBACK         0x0001  /* Application produces periods */
 
 /* Audio Pipeline Buffer (AP Buffer) flags **********************************/
 
@@ -456,6 +461,29 @@ struct ap_buffer_info_s
   apb_samp_t  buffer_size;  /* Preferred size of the buffers */
 };
 
+/* Control block at the start of a memory mapped audio device, see
+ * CONFIG_AUDIO_MMAP.  The nperiods periods of period_bytes each follow at
+ * data_offset.  The counters run freely and wrap, the period an index n
+ * refers to is n % nperiods.
+ *
+ * The driver advances hw_period each time the DMA completes a period.  The
+ * application advances appl_period after it has written (playback) or
+ * read (capture) a period, after a memory barrier.  An application that
+ * finds hw_period past appl_period (playback) or more than nperiods ahead
+ * of it (capture) has lost data and restarts from hw_period.
+ */
+
+struct audio_ring_s
+{
+  uint32_t          flags;        /* AUDIO_RING_* flags */
+  uint32_t          period_bytes; /* Size of one period */
+  uint32_t          nperiods;     /* Number of periods in the ring */
+  uint32_t          data_offset;  /* Offset of period 0 in the mapping */
+  volatile uint32_t hw_period;    /* Periods completed by the hardware */
+  volatile uint32_t appl_period;  /* Periods completed by the application */
+  volatile uint32_t xruns;        /* Number of under- or overruns seen */
+};
+
 /* This structure describes an Audio Pipeline Buffer */
 
 struct ap_buffer_s
@@ -544,6 +572,7 @@ typedef CODE void (*audio_callback_t)(FAR void *priv, uint16_t reason,
  */
 
 struct audio_lowerhalf_s;
+struct mm_map_entry_s;
 struct audio_ops_s
 {
   /* This method is called to retrieve the lower-half device capabilities.
@@ -709,6 +738,16 @@ struct audio_ops_s
 #else
   CODE int (*release)(FAR struct audio_lowerhalf_s *dev);
 #endif
+
+#ifdef CONFIG_AUDIO_MMAP
+  /* Map the period ring of the device.  The driver sets dev->ring and
+   * reports each completed period with AUDIO_CALLBACK_PERIOD instead of
+   * dequeuing Audio Pipeline Buffers.
+   */
+
+  CODE int (*mmap)(FAR struct audio_lowerhalf_s *dev,
+                   FAR struct mm_map_entry_s *map);
+#endif
 };
 
 /* This structure is the generic form of state structure used by lower half
@@ -743,6 +782,12 @@ struct audio_lowerhalf_s
 
   FAR void *priv;
 
+#ifdef CONFIG_AUDIO_MMAP
+  /* The period ring while the device is memory mapped, NULL otherwise */
+
+  FAR struct audio_ring_s *ring;
+#endif
+
   /* The custom Audio device state structure may include additional fields
    * after the pointer to the Audio callback structure.
    */
@@ -33,6 +33,7 @@
 
 #include <stdint.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -450,6 +451,73 @@ void up_flush_dcache_all(void);
 #  define up_flush_dcache_all()
 #endif
 
+/****************************************************************************
+ * Name: up_invalidate_dcache_iov
+ *
+ * Description:
+ *   Invalidate the data cache over a list of buffers, as
+ *   up_invalidate_dcache() does for each of them, but with the memory
+ *   barriers issued once for the whole list.
+ *
+ * Input Parameters:
+ *   iov    - The buffers
+ *   iovcnt - The number of buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void up_invalidate_dcache_iov(FAR const struct iovec *iov, int iovcnt);
+#else
+#  define up_invalidate_dcache_iov(iov, iovcnt) ((void)(iov), (void)(iovcnt))
+#endif
+
+/****************************************************************************
+ * Name: up_clean_dcache_iov
+ *
+ * Description:
+ *   Clean the data cache over a list of buffers with the memory barriers
+ *   issued once for the whole list.
+ *
+ * Input Parameters:
+ *   iov    - The buffers
+ *   iovcnt - The number of buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void up_clean_dcache_iov(FAR const struct iovec *iov, int iovcnt);
+#else
+#  define up_clean_dcache_iov(iov, iovcnt) ((void)(iov), (void)(iovcnt))
+#endif
+
+/****************************************************************************
+ * Name: up_flush_dcache_iov
+ *
+ * Description:
+ *   Flush the data cache over a list of buffers with the memory barriers
+ *   issued once for the whole list.
+ *
+ * Input Parameters:
+ *   iov    - The buffers
+ *   iovcnt - The number of buffers
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void up_flush_dcache_iov(FAR const struct iovec *iov, int iovcnt);
+#else
+#  define up_flush_dcache_iov(iov, iovcnt) ((void)(iov), (void)(iovcnt))
+#endif
+
 /****************************************************************************
  * Name: up_lock_dcache
  *
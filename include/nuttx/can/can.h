@@ -73,6 +73,9 @@
  * CONFIG_CAN_RXFIFOSIZE - The size of the circular rx buffer
  *   of CAN messages.
  *   Default: 8
+ * CONFIG_CAN_NSWFILTERS - The number of acceptance filters kept by the
+ *   upper half for lower halves that cannot filter in hardware.
+ *   Default: 0
  * CONFIG_CAN_NPENDINGRTR - The size of the list of pending RTR requests.
  *   Default: 4
  * CONFIG_CAN_LOOPBACK - A CAN driver may or may not support a loopback
@@ -90,7 +93,8 @@
 
 /* Default configuration settings that may be overridden in the NuttX
  * configuration file or in the board configuration file.
- * The configured size is limited to 255 to fit into a uint8_t.
+ * The configured tx size is limited to 255 to fit into a uint8_t, the
+ * rx size to 65535 to fit into a uint16_t.
  */
 
 #if !defined(CONFIG_CAN_TXFIFOSIZE)
@@ -102,9 +106,13 @@
 
 #if !defined(CONFIG_CAN_RXFIFOSIZE)
 #  define CONFIG_CAN_RXFIFOSIZE 8
-#elif CONFIG_CAN_RXFIFOSIZE > 255
+#elif CONFIG_CAN_RXFIFOSIZE > 65535
 #  undef  CONFIG_CAN_RXFIFOSIZE
-#  define CONFIG_CAN_RXFIFOSIZE 255
+#  define CONFIG_CAN_RXFIFOSIZE 65535
+#endif
+
+#ifndef CONFIG_CAN_NSWFILTERS
+#  define CONFIG_CAN_NSWFILTERS 0
 #endif
 
 #if !defined(CONFIG_CAN_NPENDINGRTR)
@@ -143,6 +151,10 @@
  *
  * CANIOC_ADD_STDFILTER:
  *   Description:    Add an address filter for a standard 11 bit address.
+ *                   The filter is set up in the hardware if the lower half
+ *                   supports it, else in the upper half if
+ *                   CONFIG_CAN_NSWFILTERS > 0.  Once any filter is set,
+ *                   only messages matching a filter are received.
  *   Argument:       A reference to struct canioc_stdfilter_s
  *   Returned Value: A non-negative filter ID is returned on success.
  *                   Otherwise -1 (ERROR) is returned with the errno
@@ -665,6 +677,8 @@ struct can_rxfifo_s
   /* Binary semaphore. Indicates whether FIFO is available for reading
    * AND not empty. Only take this sem inside a critical section to guarantee
    * exclusive access to both the semaphore and the head/tail FIFO indices.
+   * The reader holding the semaphore copies messages out of the buffer
+   * without the critical section, only the index updates need it.
    */
 
   sem_t         rx_sem;
@@ -672,8 +686,10 @@ struct can_rxfifo_s
 #ifdef CONFIG_CAN_ERRORS
   uint8_t       rx_error;                /* Flags to indicate internal device errors */
 #endif
-  uint8_t       rx_head;                 /* Index to the head [IN] in the circular buffer */
-  uint8_t       rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
+  bool          rx_busy;                 /* A reader is copying messages */
+  bool          rx_flush;                /* Flush requested while rx_busy */
+  uint16_t      rx_head;                 /* Index to the head [IN] in the circular buffer */
+  uint16_t      rx_tail;                 /* Index to the tail [OUT] in the circular buffer */
                                          /* Circular buffer of CAN messages */
   struct can_msg_s rx_buffer[CONFIG_CAN_RXFIFOSIZE];
 };
@@ -838,6 +854,21 @@ struct can_reader_s
   FAR struct pollfd   *cd_fds;
 };
 
+#if CONFIG_CAN_NSWFILTERS > 0
+/* An acceptance filter applied by the upper half.  These are used only
+ * when the lower half returns -ENOTTY for CANIOC_ADD_STDFILTER or
+ * CANIOC_ADD_EXTFILTER.
+ */
+
+struct can_swfilter_s
+{
+  uint32_t             sw_id1;           /* ID, lower ID of a range */
+  uint32_t             sw_id2;           /* ID, mask or upper ID of a range */
+  uint8_t              sw_type;          /* CAN_FILTER_* + 1, 0 if unused */
+  bool                 sw_extid;         /* Matches extended IDs */
+};
+#endif
+
 struct can_transv_s
 {
   FAR const struct can_transv_ops_s *ct_ops;    /* Arch-specific operations */
@@ -860,6 +891,10 @@ struct can_dev_s
   FAR const struct can_ops_s *cd_ops;    /* Arch-specific operations */
   FAR void            *cd_priv;          /* Used by the arch-specific logic */
   FAR struct can_transv_s *cd_transv;    /* Describes CAN transceiver */
+#if CONFIG_CAN_NSWFILTERS > 0
+                                         /* Upper half acceptance filters */
+  struct can_swfilter_s cd_filters[CONFIG_CAN_NSWFILTERS];
+#endif
 };
 
 /* Structures used with ioctl calls */
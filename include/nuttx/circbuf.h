@@ -24,16 +24,20 @@
 #define __INCLUDE_NUTTX_CIRCBUF_H
 
 /* Note about locking: There is no locking required while only one reader
- * and one writer is using the circular buffer.
+ * and one writer is using the circular buffer, e.g. an interrupt handler
+ * and a thread.
  * For multiple writer and one reader there is only a need to lock the
- * writer. And vice versa for only one writer and multiple reader there is
- * only a need to lock the reader.
+ * writer, or to use circbuf_write_mp(). And vice versa for only one writer
+ * and multiple reader there is only a need to lock the reader.
  */
 
 /****************************************************************************
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
 #include <stdbool.h>
 #include <sys/types.h>
 
@@ -41,7 +45,15 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define CIRCBUF_INITIALIZER(base, size) { base, size, 0, 0, true }
+#define CIRCBUF_INITIALIZER(base, size) { base, size, 0, 0, 0, true }
+
+/* Keep the writer and the reader index in separate cache lines */
+
+#if defined(CONFIG_LIBC_CIRCBUF_ALIGN) && CONFIG_LIBC_CIRCBUF_ALIGN > 0
+#  define CIRCBUF_ALIGNED aligned_data(CONFIG_LIBC_CIRCBUF_ALIGN)
+#else
+#  define CIRCBUF_ALIGNED
+#endif
 
 /****************************************************************************
  * Public Types
@@ -51,11 +63,12 @@
 
 struct circbuf_s
 {
-  FAR void *base;     /* The pointer to buffer space */
-  size_t    size;     /* The size of buffer space */
-  size_t    head;     /* The head of buffer space */
-  size_t    tail;     /* The tail of buffer space */
-  bool      external; /* The flag for external buffer */
+  FAR void *base;                     /* The pointer to buffer space */
+  size_t    size;                     /* The size of buffer space */
+  size_t    head CIRCBUF_ALIGNED;     /* The head of buffer space */
+  size_t    reserve;                  /* The head claimed by writers */
+  size_t    tail CIRCBUF_ALIGNED;     /* The tail of buffer space */
+  bool      external;                 /* The flag for external buffer */
 };
 
 /****************************************************************************
@@ -320,6 +333,31 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes);
 ssize_t circbuf_write(FAR struct circbuf_s *circ,
                        FAR const void *src, size_t bytes);
 
+/****************************************************************************
+ * Name: circbuf_write_mp
+ *
+ * Description:
+ *   Write data to the circular buffer with several concurrent writers and
+ *   one reader, without a lock.
+ *
+ * Note:
+ *   All writers of the buffer must use this function, the reader can use
+ *   any of the read APIs.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   src   - The data to be added.
+ *   bytes - Number of bytes to be added.
+ *
+ * Returned Value:
+ *   The bytes written, all of them or zero if there is not enough space;
+ *   A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t circbuf_write_mp(FAR struct circbuf_s *circ,
+                         FAR const void *src, size_t bytes);
+
 /****************************************************************************
  * Name: circbuf_overwrite
  *
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * include/nuttx/clock_vdso.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CLOCK_VDSO_H
+#define __INCLUDE_NUTTX_CLOCK_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/seqlock.h>
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The time page.  It lives in user memory, is written by the kernel on
+ * every scheduler tick and on clock_settime(), and is read by the
+ * clock_gettime() of the user-space C library without entering the
+ * kernel.
+ */
+
+struct clock_vdso_s
+{
+  seqcount_t      seq;      /* Changes on every update */
+  clock_t         ticks;    /* Scheduler ticks, the CLOCK_MONOTONIC time */
+  struct timespec basetime; /* CLOCK_REALTIME when ticks was zero */
+  bool            realtime; /* basetime + ticks is CLOCK_REALTIME */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxclock_vdso
+ *
+ * Description:
+ *   Return the time page, it is the same for all tasks.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_vdso_s *nxclock_vdso(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CLOCK_VDSO */
+#endif /* __INCLUDE_NUTTX_CLOCK_VDSO_H */
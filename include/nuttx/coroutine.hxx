@@ -0,0 +1,429 @@
+//***************************************************************************
+// include/nuttx/coroutine.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_COROUTINE_HXX
+#define __INCLUDE_NUTTX_COROUTINE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <cstdlib>
+
+#include <sys/epoll.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_LIBXX_CORO
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The number of epoll events taken by one wait of an event loop
+
+#ifndef CONFIG_LIBXX_CORO_NEVENTS
+#  define CONFIG_LIBXX_CORO_NEVENTS 16
+#endif
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+namespace nuttx
+{
+namespace coro
+{
+
+// A suspended coroutine waiting to be resumed by an executor.  The node
+// lives in the suspended frame, so queuing a coroutine allocates nothing.
+
+struct waiter
+{
+  sq_entry_t node;
+  std::coroutine_handle<> handle;
+};
+
+// Where the coroutines run
+
+class executor
+{
+public:
+  virtual ~executor() = default;
+
+  // Queue a suspended coroutine to be resumed on this executor.  This may
+  // be called from any thread.
+
+  virtual void post(waiter &w) = 0;
+
+  // An awaitable that moves the calling coroutine to this executor
+
+  auto schedule()
+  {
+    struct awaiter : waiter
+    {
+      executor *exec;
+
+      bool await_ready() noexcept
+      {
+        return false;
+      }
+
+      void await_suspend(std::coroutine_handle<> h) noexcept
+      {
+        handle = h;
+        exec->post(*this);
+      }
+
+      void await_resume() noexcept
+      {
+      }
+    };
+
+    awaiter a;
+    a.exec = this;
+    return a;
+  }
+};
+
+// A coroutine returning nothing.  It is either awaited by another
+// coroutine, which then resumes when it finishes, or detached with
+// spawn(), in which case its frame is freed when it finishes.
+
+class task
+{
+public:
+  struct promise_type
+  {
+    waiter start;
+    std::coroutine_handle<> continuation;
+
+    task get_return_object() noexcept
+    {
+      return task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    auto final_suspend() noexcept
+    {
+      struct final_awaiter
+      {
+        bool await_ready() noexcept
+        {
+          return false;
+        }
+
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<promise_type> h) noexcept
+        {
+          std::coroutine_handle<> next = h.promise().continuation;
+
+          // A detached task has nobody left to free its frame
+
+          if (!next)
+            {
+              h.destroy();
+              return std::noop_coroutine();
+            }
+
+          return next;
+        }
+
+        void await_resume() noexcept
+        {
+        }
+      };
+
+      return final_awaiter();
+    }
+
+    void return_void() noexcept
+    {
+    }
+
+    void unhandled_exception() noexcept
+    {
+      std::abort();
+    }
+  };
+
+  task(task &&other) noexcept
+    : m_handle(other.m_handle)
+  {
+    other.m_handle = nullptr;
+  }
+
+  task(const task &) = delete;
+  task &operator=(const task &) = delete;
+
+  ~task()
+  {
+    if (m_handle)
+      {
+        m_handle.destroy();
+      }
+  }
+
+  // Run the task to completion inside the awaiting coroutine
+
+  auto operator co_await() noexcept
+  {
+    struct awaiter
+    {
+      std::coroutine_handle<promise_type> child;
+
+      bool await_ready() noexcept
+      {
+        return false;
+      }
+
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> parent) noexcept
+      {
+        child.promise().continuation = parent;
+        return child;
+      }
+
+      void await_resume() noexcept
+      {
+      }
+    };
+
+    return awaiter{m_handle};
+  }
+
+  // Start the task on an executor and give up its ownership
+
+  friend void spawn(executor &exec, task &&t)
+  {
+    std::coroutine_handle<promise_type> h = t.m_handle;
+
+    t.m_handle = nullptr;
+    h.promise().start.handle = h;
+    exec.post(h.promise().start);
+  }
+
+private:
+  explicit task(std::coroutine_handle<promise_type> h) noexcept
+    : m_handle(h)
+  {
+  }
+
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+class event_loop;
+
+// Wait for events on a file descriptor.  The descriptor is registered
+// with the loop while the coroutine is suspended only.
+
+class poll_awaiter : public waiter
+{
+public:
+  poll_awaiter(event_loop &loop, int fd, uint32_t events,
+               executor *resume_on) noexcept
+    : m_loop(loop), m_resume_on(resume_on), m_fd(fd), m_events(events),
+      m_revents(0)
+  {
+  }
+
+  bool await_ready() noexcept
+  {
+    return false;
+  }
+
+  bool await_suspend(std::coroutine_handle<> h) noexcept;
+
+  // The events that resumed the coroutine, EPOLLERR if the descriptor
+  // could not be watched
+
+  uint32_t await_resume() noexcept
+  {
+    return m_revents;
+  }
+
+protected:
+  friend class event_loop;
+
+  event_loop &m_loop;
+  executor *m_resume_on;
+  int m_fd;
+  uint32_t m_events;
+  uint32_t m_revents;
+};
+
+// Wait for a relative time, with a timerfd of its own
+
+class sleep_awaiter : public poll_awaiter
+{
+public:
+  sleep_awaiter(event_loop &loop, uint32_t msec,
+                executor *resume_on) noexcept;
+  ~sleep_awaiter();
+
+  bool await_suspend(std::coroutine_handle<> h) noexcept;
+
+  void await_resume() noexcept
+  {
+  }
+
+private:
+  uint32_t m_msec;
+};
+
+// Wait until an eventfd counter is not zero, then take its value
+
+class event_awaiter : public poll_awaiter
+{
+public:
+  event_awaiter(event_loop &loop, int fd, executor *resume_on) noexcept
+    : poll_awaiter(loop, fd, EPOLLIN, resume_on)
+  {
+  }
+
+  uint64_t await_resume() noexcept;
+};
+
+// A counter other threads or coroutines signal, wrapping an eventfd
+
+class event
+{
+public:
+  event();
+  ~event();
+
+  event(const event &) = delete;
+  event &operator=(const event &) = delete;
+
+  // Add to the counter and wake up a waiter; may be called from any thread
+
+  void signal(uint64_t count = 1);
+
+  // Wait until the counter is not zero, then take and return its value
+
+  event_awaiter wait(event_loop &loop,
+                     executor *resume_on = nullptr) noexcept
+  {
+    return event_awaiter(loop, m_fd, resume_on);
+  }
+
+  int fd() const
+  {
+    return m_fd;
+  }
+
+private:
+  int m_fd;
+};
+
+// A single threaded reactor: run() waits on an epoll set for the watched
+// descriptors and runs the ready coroutines in between.  Use one loop per
+// CPU, each run() by a thread pinned to its CPU, to spread the load.
+
+class event_loop : public executor
+{
+public:
+  event_loop();
+  ~event_loop();
+
+  event_loop(const event_loop &) = delete;
+  event_loop &operator=(const event_loop &) = delete;
+
+  void post(waiter &w) override;
+
+  // Run the loop in the calling thread until stop() is called
+
+  void run();
+  void stop();
+
+  // Awaitables.  The coroutine is resumed on resume_on, or on this loop
+  // if it is null.
+
+  poll_awaiter poll(int fd, uint32_t events,
+                    executor *resume_on = nullptr) noexcept
+  {
+    return poll_awaiter(*this, fd, events, resume_on);
+  }
+
+  sleep_awaiter sleep_for(uint32_t msec,
+                          executor *resume_on = nullptr) noexcept
+  {
+    return sleep_awaiter(*this, msec, resume_on);
+  }
+
+private:
+  friend class poll_awaiter;
+
+  int watch(poll_awaiter &pw);
+
+  sq_queue_t m_ready;
+  mutex_t m_lock;
+  int m_epfd;
+  int m_wakefd;
+  std::atomic<bool> m_stop;
+};
+
+#if defined(CONFIG_SCHED_WORKQUEUE) || defined(CONFIG_LIBC_USRWORK)
+
+// Resume the coroutines on a work queue, one at a time and in order, so
+// that the CPU bound parts of the coroutines of a loop leave it free to
+// serve the descriptors.
+
+class work_executor : public executor
+{
+public:
+  explicit work_executor(int qid = USRWORK);
+  ~work_executor();
+
+  work_executor(const work_executor &) = delete;
+  work_executor &operator=(const work_executor &) = delete;
+
+  void post(waiter &w) override;
+
+private:
+  static void worker(FAR void *arg);
+
+  struct work_s m_work;
+  sq_queue_t m_ready;
+  mutex_t m_lock;
+  int m_qid;
+  bool m_queued;
+};
+
+#endif
+
+} // namespace coro
+} // namespace nuttx
+
+#endif // CONFIG_LIBXX_CORO
+#endif // __INCLUDE_NUTTX_COROUTINE_HXX
@@ -70,6 +70,20 @@ uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val);
 
 uint32_t crc32(FAR const uint8_t *src, size_t len);
 
+/****************************************************************************
+ * Name: crc32part_c
+ *
+ * Description:
+ *   Continue CRC calculation on a part of the buffer with the Castagnoli
+ *   polynomial 0x1edc6f41 (bit reflected 0x82f63b78).  It is provided by
+ *   the architecture specific implementations only.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ARCH_CRC32
+uint32_t crc32part_c(FAR const uint8_t *src, size_t len, uint32_t crc32val);
+#endif
+
 /****************************************************************************
  * Name: crc32h04c11db7_part
  *
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * include/nuttx/dma/dma_pool.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DMA_DMA_POOL_H
+#define __INCLUDE_NUTTX_DMA_DMA_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#ifdef CONFIG_DMA_POOL
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct dma_pool_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dma_pool_initialize
+ *
+ * Description:
+ *   Create a pool of fixed size blocks in a memory region set aside by the
+ *   board for DMA, typically one mapped non-cacheable so that the blocks
+ *   need no cache maintenance.  The block size is rounded up to the D-Cache
+ *   line size, and the blocks are aligned on it.
+ *
+ * Input Parameters:
+ *   base    - The start of the region
+ *   size    - The size of the region in bytes
+ *   blksize - The size of one block
+ *
+ * Returned Value:
+ *   The new pool on success; NULL if the pool cannot be allocated or the
+ *   region does not hold a single block.
+ *
+ ****************************************************************************/
+
+FAR struct dma_pool_s *dma_pool_initialize(FAR void *base, size_t size,
+                                           size_t blksize);
+
+/****************************************************************************
+ * Name: dma_pool_uninitialize
+ *
+ * Description:
+ *   Release a pool.  The region itself belongs to the board.
+ *
+ ****************************************************************************/
+
+void dma_pool_uninitialize(FAR struct dma_pool_s *pool);
+
+/****************************************************************************
+ * Name: dma_pool_alloc
+ *
+ * Description:
+ *   Take a block from a pool.  This may be called from interrupt handlers.
+ *
+ * Returned Value:
+ *   The block, or NULL if all blocks are in use.
+ *
+ ****************************************************************************/
+
+FAR void *dma_pool_alloc(FAR struct dma_pool_s *pool);
+
+/****************************************************************************
+ * Name: dma_pool_free
+ *
+ * Description:
+ *   Return a block to its pool.  This may be called from interrupt
+ *   handlers.
+ *
+ ****************************************************************************/
+
+void dma_pool_free(FAR struct dma_pool_s *pool, FAR void *blk);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_DMA_POOL */
+#endif /* __INCLUDE_NUTTX_DMA_DMA_POOL_H */
@@ -32,6 +32,15 @@
 #include <sys/types.h>
 #include <stdbool.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Dispatch policies of blkqueue_register() */
+
+#define BLKQUEUE_POLICY_NONE      0 /* Arrival order */
+#define BLKQUEUE_POLICY_DEADLINE  1 /* Sector order with request deadlines */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -158,6 +167,30 @@ void devcrypto_register(void);
 int devmem_register(void);
 #endif
 
+/****************************************************************************
+ * Name: devperf_register
+ *
+ * Description:
+ *   Register /dev/perf driver
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PERF
+int devperf_register(void);
+#endif
+
+/****************************************************************************
+ * Name: devbench_register
+ *
+ * Description:
+ *   Register /dev/bench driver
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_BENCH
+int devbench_register(void);
+#endif
+
 /****************************************************************************
  * Name: devzero_register
  *
@@ -197,6 +230,32 @@ int bchdev_register(FAR const char *blkdev, FAR const char *chardev,
 
 int bchdev_unregister(FAR const char *chardev);
 
+/****************************************************************************
+ * Name: blkqueue_register
+ *
+ * Description:
+ *   Export the block driver 'blkdev' as the block driver 'qdev', whose
+ *   read and write requests are queued, merged and dispatched according to
+ *   'policy'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_BLKQUEUE
+int blkqueue_register(FAR const char *blkdev, FAR const char *qdev,
+                      int policy);
+
+/****************************************************************************
+ * Name: blkqueue_unregister
+ *
+ * Description:
+ *   Remove a request queue created by a previous call to
+ *   blkqueue_register().
+ *
+ ****************************************************************************/
+
+int blkqueue_unregister(FAR const char *qdev);
+#endif
+
 /* Low level, direct access. NOTE: low-level access and character driver
  * access are incompatible. One and only one access method should be
  * implemented.
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * include/nuttx/drivers/perf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_PERF_H
+#define __INCLUDE_NUTTX_DRIVERS_PERF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+#ifdef CONFIG_DEV_PERF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each open of /dev/perf holds a group of up to CONFIG_DEV_PERF_NEVENTS
+ * counters virtualized for one thread: they only count while that thread
+ * runs.  A read() returns a struct perf_values_s with all of the counts of
+ * the group, sampled together.
+ *
+ * PERFIOC_ATTACH
+ *              - Select the thread and the events of the group.  The
+ *                counters start out disabled and zeroed.
+ *                Argument: A read-only pointer to struct perf_attr_s
+ * PERFIOC_ENABLE
+ *              - Start counting
+ *                Argument: Ignored
+ * PERFIOC_DISABLE
+ *              - Stop counting
+ *                Argument: Ignored
+ * PERFIOC_RESET
+ *              - Zero the counts
+ *                Argument: Ignored
+ */
+
+#define PERFIOC_ATTACH    _PERFIOC(0x0001)
+#define PERFIOC_ENABLE    _PERFIOC(0x0002)
+#define PERFIOC_DISABLE   _PERFIOC(0x0003)
+#define PERFIOC_RESET     _PERFIOC(0x0004)
+
+/* Events.  The software events are always available; the others need
+ * hardware counters (CONFIG_ARCH_HAVE_PERF_COUNTERS) and PERFIOC_ATTACH
+ * fails with ENOTSUP if the hardware cannot count them.
+ */
+
+#define PERF_EVENT_CPU_CLOCK         0  /* perf_gettime() units */
+#define PERF_EVENT_CONTEXT_SWITCHES  1  /* Times the thread was resumed */
+#define PERF_EVENT_CYCLES            2  /* CPU cycles */
+#define PERF_EVENT_INSTRUCTIONS      3  /* Instructions retired */
+#define PERF_EVENT_CACHE_REFERENCES  4  /* Level 1 data cache accesses */
+#define PERF_EVENT_CACHE_MISSES      5  /* Level 1 data cache refills */
+#define PERF_EVENT_BRANCHES          6  /* Branches retired */
+#define PERF_EVENT_BRANCH_MISSES     7  /* Mispredicted branches */
+
+#define PERF_EVENT_FIRST_HW          PERF_EVENT_CYCLES
+#define PERF_EVENT_NEVENTS           8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct perf_attr_s
+{
+  pid_t   pid;                                /* Thread, 0 for the caller */
+  uint8_t nevents;                            /* Number of events */
+  uint8_t events[CONFIG_DEV_PERF_NEVENTS];    /* PERF_EVENT_* values */
+};
+
+struct perf_values_s
+{
+  uint8_t  nevents;                           /* Number of counts */
+  uint64_t values[CONFIG_DEV_PERF_NEVENTS];   /* In the order of events[] */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#if defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT)
+
+struct tcb_s;
+
+/****************************************************************************
+ * Name: devperf_switch
+ *
+ * Description:
+ *   Account the counters of the thread being suspended and start those of
+ *   the thread being resumed.  Called by the scheduler on every context
+ *   switch.
+ *
+ ****************************************************************************/
+
+void devperf_switch(FAR struct tcb_s *from, FAR struct tcb_s *to);
+
+#endif /* __KERNEL__ || CONFIG_BUILD_FLAT */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_DEV_PERF */
+#endif /* __INCLUDE_NUTTX_DRIVERS_PERF_H */
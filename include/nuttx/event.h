@@ -38,13 +38,14 @@
 /* Initializers */
 
 #define EVENT_WAITLIST_INITIALIZER {NULL, NULL}
-#define NXEVENT_INITIALIZER(e, v) {EVENT_WAITLIST_INITIALIZER, (v)}
+#define NXEVENT_INITIALIZER(e, v) {EVENT_WAITLIST_INITIALIZER, (v), 0}
 
 /* Event Wait Flags */
 
 #define NXEVENT_WAIT_ALL     (1 << 0) /* Bit 0: Wait ALL */
 #define NXEVENT_WAIT_RESET   (1 << 1) /* Bit 1: Reset events before wait */
 #define NXEVENT_WAIT_NOCLEAR (1 << 2) /* Bit 2: Do not clear events after wait */
+#define NXEVENT_WAIT_EXCL    (1 << 3) /* Bit 3: Exclusive (wake-one) */
 
 /* Event Post Flags */
 
@@ -64,6 +65,7 @@ struct nxevent_s
 {
   dq_queue_t             waitlist; /* Waiting list of nxevent_wait_t */
   volatile nxevent_mask_t  events; /* Pending Events */
+  nxevent_mask_t         waitmask; /* Events expected by the waiters */
 };
 
 #ifdef CONFIG_FS_NAMED_EVENTS
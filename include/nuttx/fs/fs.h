@@ -189,6 +189,7 @@ struct statfs;
 struct pollfd;
 struct mtd_dev_s;
 struct uio;
+struct select_cache_s;
 
 /* The internal representation of type DIR is just a container for an inode
  * reference, and the path of directory.
@@ -360,6 +361,23 @@ struct mountpt_operations
   CODE int     (*chstat)(FAR struct inode *mountpt, FAR const char *relpath,
                          FAR const struct stat *buf, int flags);
   CODE int     (*syncfs)(FAR struct inode *mountpt);
+
+#ifdef CONFIG_FS_PAGECACHE
+  /* Page cache support, left NULL by file systems that do not opt in.
+   * pagekey identifies the file of an open file within the mountpoint,
+   * and fails for files that must not be cached.  readpage and writepage
+   * transfer data at an offset of the file, without using or moving
+   * f_pos.
+   */
+
+  CODE int     (*pagekey)(FAR const struct file *filep,
+                          FAR uint64_t *key);
+  CODE ssize_t (*readpage)(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen, off_t offset);
+  CODE ssize_t (*writepage)(FAR struct file *filep,
+                            FAR const char *buffer, size_t buflen,
+                            off_t offset);
+#endif
 };
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 
@@ -464,6 +482,11 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              f_locked;   /* Filelock state: false - unlocked, true - locked */
 #endif
+#ifdef CONFIG_FS_READAHEAD
+  off_t             f_ranext;   /* Readahead: expected next read position */
+  off_t             f_raend;    /* Readahead: end of the requested pages */
+  uint16_t          f_rawin;    /* Readahead: window size in pages */
+#endif
 };
 
 struct fd
@@ -1636,6 +1659,31 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoff,
+                    FAR struct file *outfile, FAR off_t *outoff,
+                    size_t count, unsigned int flags);
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t count, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1785,6 +1833,22 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: select_cache_release
+ *
+ * Description:
+ *   Tear down the poll setups cached by the select() calls of a thread and
+ *   free the cache.  Called when the thread exits.
+ *
+ * Input Parameters:
+ *   cache - The cache of the thread, may be NULL
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_SELECT_CACHE
+void select_cache_release(FAR struct select_cache_s *cache);
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -113,6 +113,8 @@
 #define _1WIREBASE      (0x4500) /* 1WIRE ioctl commands */
 #define _EEPIOCBASE     (0x4600) /* EEPROM driver ioctl commands */
 #define _PTPBASE        (0x4700) /* PTP ioctl commands */
+#define _IORINGBASE     (0x4800) /* I/O ring ioctl commands */
+#define _PERFIOCBASE    (0x4900) /* Performance counter ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -248,6 +250,16 @@
 #define FIOGCLEX            _FIOC(0x0018) /* IN:  FAR int *
                                            * OUT: None
                                            */
+#define FIOC_AIOSUBMIT      _FIOC(0x0019) /* IN:  FAR struct ioring_async_s *
+                                           * OUT: OK if the driver will call
+                                           *      the completion callback,
+                                           *      -ENOTTY if the request
+                                           *      must be done synchronously
+                                           */
+#define FIOC_CACHESTATS     _FIOC(0x001a) /* IN:  FAR struct fs_cachestats_s *
+                                           * OUT: Read cache statistics of
+                                           *      the volume of the file
+                                           */
 
 /* NuttX character driver ioctl definitions *********************************/
 
@@ -366,6 +378,19 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_TRIM       _BIOC(0x0012)     /* Tell the device that a range of
+                                           * sectors is no longer in use
+                                           * IN:  Pointer to blkcnt_t[2], the
+                                           *      start sector and the number
+                                           *      of sectors
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_ZEROOUT    _BIOC(0x0013)     /* Zero a range of sectors
+                                           * IN:  Pointer to blkcnt_t[2], the
+                                           *      start sector and the number
+                                           *      of sectors
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -526,6 +551,18 @@
                                                * IN: None
                                                * OUT: int */
 
+#define PIPEIOC_SETLOWAT    _PIPEIOC(0x0007)  /* Set the read low watermark
+                                               * IN: unsigned long integer.
+                                               *     A blocking read waits
+                                               *     for this many bytes
+                                               *     (or as many as asked
+                                               *     for if less).
+                                               * OUT: None */
+
+#define PIPEIOC_GETLOWAT    _PIPEIOC(0x0008)  /* Get the read low watermark
+                                               * IN: None
+                                               * OUT: int */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -807,6 +844,20 @@
 #define _PTPIOCVALID(c)       (_IOC_TYPE(c)==_PTPBASE)
 #define _PTPIOC(nr)           _IOC(_PTPBASE,nr)
 
+/* I/O ring driver ioctl definitions ****************************************/
+
+/* see nuttx/include/fs/ioring.h */
+
+#define _IORINGIOCVALID(c)    (_IOC_TYPE(c)==_IORINGBASE)
+#define _IORINGIOC(nr)        _IOC(_IORINGBASE,nr)
+
+/* Performance counter driver ioctl definitions *****************************/
+
+/* see nuttx/include/drivers/perf.h */
+
+#define _PERFIOCVALID(c)      (_IOC_TYPE(c)==_PERFIOCBASE)
+#define _PERFIOC(nr)          _IOC(_PERFIOCBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -845,6 +896,17 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* Returned by FIOC_CACHESTATS.  The counters are totals since the volume
+ * was mounted and may wrap.
+ */
+
+struct fs_cachestats_s
+{
+  uint32_t hits;      /* Reads served from the cache */
+  uint32_t misses;    /* Reads that went to the media */
+  uint32_t size;      /* Size of the read cache in bytes */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,224 @@
+/****************************************************************************
+ * include/nuttx/fs/ioring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_IORING_H
+#define __INCLUDE_NUTTX_FS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* I/O ring IOCTL commands.  These are issued on a file descriptor opened
+ * on /dev/ioring;  each open of the device is a separate ring.
+ */
+
+/* Command:      IORINGIOC_SETUP
+ * Description:  Allocate the submission and completion rings.  The rings
+ *               are then mapped with mmap(), at offset 0 and with the
+ *               ring_size returned in the parameters.
+ * Argument:     A pointer to an instance of struct ioring_params_s
+ */
+
+/* Command:      IORINGIOC_ENTER
+ * Description:  Submit queued entries and/or wait for completions.
+ *               The number of entries consumed from the submission ring
+ *               is returned.
+ * Argument:     A pointer to a read-only instance of struct ioring_enter_s
+ */
+
+/* Command:      IORINGIOC_REGISTER_BUFFERS
+ * Description:  Register the buffers used by the *_FIXED operations.  The
+ *               buffers must stay valid until they are unregistered.
+ * Argument:     A pointer to a read-only instance of struct
+ *               ioring_buffers_s
+ */
+
+/* Command:      IORINGIOC_UNREGISTER_BUFFERS
+ * Description:  Forget the registered buffers.  This fails with EBUSY
+ *               while operations are in flight.
+ * Argument:     None
+ */
+
+#define IORINGIOC_SETUP              _IORINGIOC(0x0001)
+#define IORINGIOC_ENTER              _IORINGIOC(0x0002)
+#define IORINGIOC_REGISTER_BUFFERS   _IORINGIOC(0x0003)
+#define IORINGIOC_UNREGISTER_BUFFERS _IORINGIOC(0x0004)
+
+/* Submission entry operations */
+
+#define IORING_OP_NOP                0  /* Complete with no I/O */
+#define IORING_OP_READ               1  /* Read into addr */
+#define IORING_OP_WRITE              2  /* Write from addr */
+#define IORING_OP_FSYNC              3  /* Flush the file */
+#define IORING_OP_SEND               4  /* Send on a socket */
+#define IORING_OP_RECV               5  /* Receive from a socket */
+#define IORING_OP_READ_FIXED         6  /* Read into a registered buffer */
+#define IORING_OP_WRITE_FIXED        7  /* Write from a registered buffer */
+
+/* struct ioring_params_s flags */
+
+#define IORING_SETUP_SQPOLL          (1 << 0) /* Kernel thread polls the SQ */
+
+/* struct ioring_rings_s sq_flags */
+
+#define IORING_SQ_NEED_WAKEUP        (1 << 0) /* The SQ thread is asleep */
+
+/* struct ioring_enter_s flags */
+
+#define IORING_ENTER_GETEVENTS       (1 << 0) /* Wait for min_complete */
+#define IORING_ENTER_SQ_WAKEUP       (1 << 1) /* Wake up the SQ thread */
+
+/* An sqe off of -1 uses (and advances) the current file position */
+
+#define IORING_OFF_CURRENT           ((int64_t)-1)
+
+/* Locate the entries within the mapped rings */
+
+#define IORING_SQES(r,p) \
+  ((FAR struct ioring_sqe_s *)((FAR uint8_t *)(r) + (p)->sqe_off))
+#define IORING_CQES(r,p) \
+  ((FAR struct ioring_cqe_s *)((FAR uint8_t *)(r) + (p)->cqe_off))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Submission queue entry.  The application fills the entry at
+ * sq_tail & sq_mask and then advances sq_tail.
+ */
+
+struct ioring_sqe_s
+{
+  uint8_t   opcode;    /* IORING_OP_* */
+  uint8_t   flags;     /* Reserved, must be zero */
+  uint16_t  buf_index; /* Registered buffer of the *_FIXED operations */
+  int32_t   fd;        /* File descriptor of the operation */
+  int64_t   off;       /* File offset or IORING_OFF_CURRENT */
+  FAR void *addr;      /* Buffer address */
+  uint32_t  len;       /* Buffer length */
+  uint32_t  msg_flags; /* Flags of the SEND and RECV operations */
+  uint64_t  user_data; /* Copied to the completion entry */
+};
+
+/* Completion queue entry.  The application consumes the entry at
+ * cq_head & cq_mask and then advances cq_head.
+ */
+
+struct ioring_cqe_s
+{
+  uint64_t  user_data; /* From the submission entry */
+  int32_t   res;       /* Result of the operation or a negated errno */
+  uint32_t  flags;     /* Reserved */
+};
+
+/* The shared header at the start of the mapped rings.  Each index is only
+ * ever written by one side: sq_tail and cq_head by the application,
+ * sq_head, cq_tail and sq_flags by the kernel.  Indices run freely and
+ * are masked on access.
+ */
+
+struct ioring_rings_s
+{
+  volatile uint32_t sq_head;
+  volatile uint32_t sq_tail;
+  uint32_t          sq_mask;
+  volatile uint32_t sq_flags;
+  volatile uint32_t cq_head;
+  volatile uint32_t cq_tail;
+  uint32_t          cq_mask;
+  uint32_t          reserved;
+};
+
+/* This is the structure referred to in the argument to the
+ * IORINGIOC_SETUP IOCTL command.
+ */
+
+struct ioring_params_s
+{
+  uint32_t sq_entries;     /* IN:  Rounded up to a power of two
+                            * OUT: The submission ring size */
+  uint32_t cq_entries;     /* OUT: The completion ring size */
+  uint32_t flags;          /* IN:  IORING_SETUP_* */
+  uint32_t sq_thread_idle; /* IN:  Milliseconds the SQ thread polls
+                            *      before it goes to sleep */
+  size_t   ring_size;      /* OUT: Length to mmap() */
+  size_t   sqe_off;        /* OUT: Offset of the submission entries */
+  size_t   cqe_off;        /* OUT: Offset of the completion entries */
+};
+
+/* This is the structure referred to in the argument to the
+ * IORINGIOC_ENTER IOCTL command.
+ */
+
+struct ioring_enter_s
+{
+  uint32_t to_submit;      /* Maximum number of entries to submit */
+  uint32_t min_complete;   /* Completions to wait for with GETEVENTS */
+  uint32_t flags;          /* IORING_ENTER_* */
+};
+
+/* This is the structure referred to in the argument to the
+ * IORINGIOC_REGISTER_BUFFERS IOCTL command.
+ */
+
+struct ioring_buffers_s
+{
+  FAR const struct iovec *iov;
+  unsigned int nr;
+};
+
+/* Drivers that can complete transfers without blocking the caller accept
+ * this structure with the FIOC_AIOSUBMIT ioctl.  Returning OK means the
+ * driver owns the request and will call complete() exactly once, from
+ * thread context, when the transfer is done.  Any other return value makes
+ * the caller fall back to doing the transfer from a worker thread.
+ */
+
+struct file;
+struct ioring_async_s;
+typedef CODE void (*ioring_complete_t)(FAR struct ioring_async_s *req,
+                                       ssize_t result);
+
+struct ioring_async_s
+{
+  FAR struct file *filep;     /* The file of the transfer */
+  uint8_t opcode;             /* IORING_OP_READ, _WRITE or _FSYNC */
+  FAR void *buf;              /* Buffer of the transfer */
+  size_t len;                 /* Length of the transfer */
+  off_t off;                  /* File offset, or -1 for the current one */
+  ioring_complete_t complete; /* Completion callback */
+  FAR void *priv;             /* For use by the driver */
+};
+
+#endif /* __INCLUDE_NUTTX_FS_IORING_H */
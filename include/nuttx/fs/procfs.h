@@ -34,6 +34,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Version of the /proc/snapshot binary layout.  It is incremented on any
+ * change that is not a plain addition of fields at the end of a record.
+ */
+
+#define PROCFS_SNAPSHOT_VERSION  1
+#define PROCFS_SNAPSHOT_NAMELEN  32
+
 /* Data entry declaration prototypes ****************************************/
 
 /* Procfs operations are a subset of the mountpt_operations */
@@ -152,6 +159,43 @@ struct procfs_meminfo_entry_s
 #endif
 };
 
+/* /proc/snapshot returns the header below, followed by ntasks records of
+ * tasksize bytes each.  Readers should use hdrsize and tasksize to step
+ * through the data, so that fields added later are simply skipped.  The
+ * snapshot is re-collected each time it is read from offset zero.
+ */
+
+begin_packed_struct struct procfs_snapshot_s
+{
+  uint16_t version;           /* PROCFS_SNAPSHOT_VERSION */
+  uint16_t hdrsize;           /* Size of this header */
+  uint16_t tasksize;          /* Size of one task record */
+  uint16_t ncpus;             /* Number of CPUs (IDLE tasks are PIDs 0..) */
+  uint32_t ntasks;            /* Number of task records that follow */
+  uint32_t systicks;          /* System time at collection, in ticks */
+  uint32_t cputotal;          /* CPU load sample period, in ticks */
+  uint32_t heap_arena;        /* Total size of the heap */
+  uint32_t heap_used;         /* Bytes allocated from the heap */
+  uint32_t heap_free;         /* Bytes free in the heap */
+  uint32_t heap_largest;      /* Largest free chunk in the heap */
+} end_packed_struct;
+
+begin_packed_struct struct procfs_snapshot_task_s
+{
+  int32_t  pid;               /* Thread ID */
+  int32_t  group;             /* ID of the main thread of the task group */
+  uint32_t cputicks;          /* Ticks on this thread in the CPU period */
+  uint32_t stacksize;         /* Stack size */
+  uint8_t  state;             /* tstate_t value */
+  uint8_t  priority;          /* Current priority */
+  uint8_t  type;              /* TCB_FLAG_TTYPE_* value */
+  uint8_t  cpu;               /* CPU running or assigned to the thread */
+
+  /* Task name, NUL terminated */
+
+  char     name[PROCFS_SNAPSHOT_NAMELEN];
+} end_packed_struct;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
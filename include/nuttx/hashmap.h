@@ -0,0 +1,213 @@
+/****************************************************************************
+ * include/nuttx/hashmap.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HASHMAP_H
+#define __INCLUDE_NUTTX_HASHMAP_H
+
+/* An open addressing hash table of entries owned by the caller.  Each slot
+ * keeps the 32-bit hash next to the entry pointer, so that a probe only
+ * touches an entry when its hash matches.  The table grows incrementally:
+ * after a resize, the following updates move a few slots of the previous
+ * table each, lookups search both tables meanwhile.
+ *
+ * Note about locking: The updates (insert and remove) must be serialized
+ * by the caller.  Lookups take no lock, they are retried when an update
+ * ran concurrently.  A lookup running at the same time as a remove may
+ * still pass the removed entry to the match function, so it must not be
+ * freed while such lookups are possible.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <nuttx/spinlock_type.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Return true if entry has the key */
+
+typedef CODE bool (*hashmap_match_t)(FAR const void *entry,
+                                     FAR const void *key);
+
+/* The callback type of hashmap_foreach() */
+
+typedef CODE void (*hashmap_foreach_t)(FAR void *entry, FAR void *arg);
+
+struct hashmap_slot_s
+{
+  uint32_t  hash;                   /* The hash of entry */
+  FAR void *entry;                  /* NULL if free or a removed marker */
+};
+
+struct hashmap_table_s
+{
+  size_t                mask;       /* The number of slots minus one */
+  size_t                used;       /* Slots in use, removed ones included */
+  struct hashmap_slot_s slot[1];    /* The slots (variable) */
+};
+
+struct hashmap_s
+{
+  FAR struct hashmap_table_s *table; /* The table for new entries */
+  FAR struct hashmap_table_s *old;   /* The table being moved, or NULL */
+  size_t                      move;  /* The next slot of old to move */
+  size_t                      count; /* The number of entries */
+  hashmap_match_t             match; /* The key compare function */
+  seqcount_t                  seq;   /* Updated around each change */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hashmap_init
+ *
+ * Description:
+ *   Initialize a hash table.
+ *
+ * Input Parameters:
+ *   map      - Address of the hash table to be used.
+ *   nentries - The number of entries expected, the table grows beyond it.
+ *   match    - The function comparing an entry with a key.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int hashmap_init(FAR struct hashmap_s *map, size_t nentries,
+                 hashmap_match_t match);
+
+/****************************************************************************
+ * Name: hashmap_uninit
+ *
+ * Description:
+ *   Free the hash table.  The entries are not freed, use hashmap_foreach()
+ *   first if they need to.
+ *
+ * Input Parameters:
+ *   map - Address of the hash table to be used.
+ *
+ ****************************************************************************/
+
+void hashmap_uninit(FAR struct hashmap_s *map);
+
+/****************************************************************************
+ * Name: hashmap_find
+ *
+ * Description:
+ *   Find an entry without taking a lock.
+ *
+ * Input Parameters:
+ *   map  - Address of the hash table to be used.
+ *   hash - The hash of key.
+ *   key  - The key passed to the match function.
+ *
+ * Returned Value:
+ *   The entry found, or NULL.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_find(FAR struct hashmap_s *map, uint32_t hash,
+                       FAR const void *key);
+
+/****************************************************************************
+ * Name: hashmap_insert
+ *
+ * Description:
+ *   Add an entry.  It is not checked whether an entry with the same key is
+ *   present already.
+ *
+ * Input Parameters:
+ *   map   - Address of the hash table to be used.
+ *   hash  - The hash of the entry's key.
+ *   entry - The entry to add.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int hashmap_insert(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry);
+
+/****************************************************************************
+ * Name: hashmap_remove
+ *
+ * Description:
+ *   Remove the entry with the key.
+ *
+ * Input Parameters:
+ *   map  - Address of the hash table to be used.
+ *   hash - The hash of key.
+ *   key  - The key passed to the match function.
+ *
+ * Returned Value:
+ *   The entry removed, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_remove(FAR struct hashmap_s *map, uint32_t hash,
+                         FAR const void *key);
+
+/****************************************************************************
+ * Name: hashmap_foreach
+ *
+ * Description:
+ *   Call a function for each entry.  It is an update for the locking, and
+ *   the function must not change the table.
+ *
+ * Input Parameters:
+ *   map     - Address of the hash table to be used.
+ *   handler - The function to call.
+ *   arg     - The argument of the function.
+ *
+ ****************************************************************************/
+
+void hashmap_foreach(FAR struct hashmap_s *map, hashmap_foreach_t handler,
+                     FAR void *arg);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_HASHMAP_H */
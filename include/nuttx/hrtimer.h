@@ -30,7 +30,6 @@
 #include <nuttx/config.h>
 #include <nuttx/clock.h>
 #include <nuttx/compiler.h>
-#include <nuttx/spinlock.h>
 #include <nuttx/list.h>
 
 #include <stdint.h>
@@ -95,6 +94,9 @@ typedef struct hrtimer_s
   hrtimer_node_t  node; /* Node for sorted insertion */
   hrtimer_entry_t func; /* Expiration callback function */
   uint64_t     expired; /* Absolute expiration time (ns) */
+#ifdef CONFIG_SMP
+  uint8_t          cpu; /* CPU of the base the timer is armed on */
+#endif
 } hrtimer_t;
 
 /****************************************************************************
@@ -196,7 +198,8 @@ int hrtimer_cancel_sync(FAR hrtimer_t *hrtimer);
  *   Start a high-resolution timer with the specified expiration time.
  *
  *   The expiration time may be specified as either an absolute time or
- *   a relative timeout, depending on the selected mode.
+ *   a relative timeout, depending on the selected mode.  The timer is
+ *   armed on the calling CPU, where its callback will run.
  *
  * Input Parameters:
  *   hrtimer - Pointer to high-resolution timer.
@@ -227,6 +230,55 @@ int hrtimer_start(FAR hrtimer_t *hrtimer, hrtimer_entry_t func,
   return hrtimer_start_absolute(hrtimer, func, next_expired);
 }
 
+/****************************************************************************
+ * Name: hrtimer_start_slack
+ *
+ * Description:
+ *   Start a high-resolution timer that may expire anywhere within
+ *   [expired, expired + slack].  The expiration is rounded to the time
+ *   with the most trailing zero bits in that window, so that timers with
+ *   overlapping windows tend to expire together.
+ *
+ * Input Parameters:
+ *   hrtimer - Pointer to high-resolution timer.
+ *   func    - Expiration callback function
+ *   expired - Expiration time in nanoseconds
+ *   slack   - Acceptable delay of the expiration in nanoseconds
+ *   mode    - HRTIMER_MODE_ABS or HRTIMER_MODE_REL
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static inline_function
+int hrtimer_start_slack(FAR hrtimer_t *hrtimer, hrtimer_entry_t func,
+                        uint64_t expired, uint64_t slack,
+                        enum hrtimer_mode_e mode)
+{
+  uint64_t next_expired = mode == HRTIMER_MODE_ABS ? expired :
+                          clock_systime_nsec() +
+                          (expired <= HRTIMER_MAX_DELAY ?
+                           expired : HRTIMER_MAX_DELAY);
+  uint64_t limit = next_expired + (slack <= HRTIMER_MAX_DELAY ?
+                                   slack : HRTIMER_MAX_DELAY);
+  uint64_t mask  = next_expired ^ limit;
+
+  if (mask != 0)
+    {
+      /* Keep only the highest bit in which the window bounds differ */
+
+      while ((mask & (mask - 1)) != 0)
+        {
+          mask &= mask - 1;
+        }
+
+      next_expired = limit & ~(mask - 1);
+    }
+
+  return hrtimer_start_absolute(hrtimer, func, next_expired);
+}
+
 /****************************************************************************
  * Name: hrtimer_gettime
  *
@@ -246,6 +298,24 @@ int hrtimer_start(FAR hrtimer_t *hrtimer, hrtimer_entry_t func,
 
 uint64_t hrtimer_gettime(FAR hrtimer_t *timer);
 
+/****************************************************************************
+ * Name: hrtimer_migrate
+ *
+ * Description:
+ *   Move the pending timers of a CPU that goes offline to the calling CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU that goes offline.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void hrtimer_migrate(int cpu);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
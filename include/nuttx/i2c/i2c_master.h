@@ -33,6 +33,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -270,6 +271,30 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_QUEUE
+/* This describes one transfer queued with i2c_queue_submit().  The request
+ * and its messages belong to the queue until the callback is called.
+ * Requests are served by decreasing priority and in submission order
+ * within one priority.
+ */
+
+struct i2c_request_s
+{
+  sq_entry_t flink;           /* Used internally by the queue */
+  FAR struct i2c_msg_s *msgv; /* Array of I2C messages for the transfer */
+  int msgc;                   /* Number of messages in the array */
+  uint8_t priority;           /* Higher values are served first */
+  int result;                 /* Result of I2C_TRANSFER() */
+
+  /* Called from the queue thread when the transfer is done */
+
+  CODE void (*callback)(FAR struct i2c_request_s *req, FAR void *arg);
+  FAR void *arg;              /* Argument of the callback */
+};
+
+struct i2c_queue_s;
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +408,74 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_QUEUE
+
+/****************************************************************************
+ * Name: i2c_queue_initialize
+ *
+ * Description:
+ *   Create a request queue for an I2C bus and the kernel thread that
+ *   serves it.  Drivers that call I2C_TRANSFER() directly keep working
+ *   next to the queue.
+ *
+ * Input Parameters:
+ *   i2c - An instance of the lower half I2C driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_queue_s *i2c_queue_initialize(FAR struct i2c_master_s *i2c);
+
+/****************************************************************************
+ * Name: i2c_queue_submit
+ *
+ * Description:
+ *   Queue a request for asynchronous transfer.  req->msgv, req->msgc,
+ *   req->priority and req->callback must be set.  This function does not
+ *   block and may be called from interrupt handlers.
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_queue_submit(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_queue_cancel
+ *
+ * Description:
+ *   Remove a request that has not been started yet from the queue.  The
+ *   callback of a cancelled request is not called.
+ *
+ * Returned Value:
+ *   0: the request was removed, -EBUSY: it is in progress or done
+ *
+ ****************************************************************************/
+
+int i2c_queue_cancel(FAR struct i2c_queue_s *queue,
+                     FAR struct i2c_request_s *req);
+
+/****************************************************************************
+ * Name: i2c_queue_transfer
+ *
+ * Description:
+ *   Queue messages with the given priority and wait for them.
+ *
+ * Returned Value:
+ *   0: success, <0: A negated errno
+ *
+ ****************************************************************************/
+
+int i2c_queue_transfer(FAR struct i2c_queue_s *queue,
+                       FAR struct i2c_msg_s *msgv, int msgc,
+                       uint8_t priority);
+
+#endif /* CONFIG_I2C_QUEUE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
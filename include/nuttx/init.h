@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -77,6 +78,22 @@ enum nx_initstate_e
   OSINIT_PANIC     = 8   /* Fatal error happened. */
 };
 
+#ifdef CONFIG_BOARD_INITCALL
+/* One entry of an init-call table passed to nx_initcall_run().  Entries of
+ * the same level may run concurrently, a level starts only after all
+ * entries of the lower levels have returned.
+ */
+
+struct initcall_s
+{
+  CODE int (*func)(void);  /* Initialization function */
+  FAR const char *name;    /* Name shown in the trace and timeline */
+  uint8_t level;           /* Dependency level, lower levels run first */
+};
+
+#  define INITCALL(level, func) { func, #func, level }
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -106,6 +123,14 @@ EXTERN volatile enum nx_initstate_e g_nx_initstate;  /* See enum nx_initstate_e
 
 void nx_start(void);
 
+/* Functions contained in nx_initcall.c *************************************/
+
+/* Run a table of leveled init-calls, see CONFIG_BOARD_INITCALL */
+
+#ifdef CONFIG_BOARD_INITCALL
+int nx_initcall_run(FAR const struct initcall_s *calls, size_t ncalls);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
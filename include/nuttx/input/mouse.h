@@ -56,9 +56,17 @@
 /* Common mouse IOCTL commands */
 
 #define MSIOC_VENDOR         _MSIOC(0x0001)  /* Vendor-specific commands */
+#define MSIOC_SETCOALESCE    _MSIOC(0x0002)  /* arg: Pointer to
+                                              * struct mouse_coalesce_s */
 
 #define MSC_FIRST            0x0001          /* First common command */
-#define MSC_NCMDS            1               /* One common commands */
+#define MSC_NCMDS            2               /* Two common commands */
+
+/* These definitions provide the meaning of all of the bits that may be
+ * set in the struct mouse_coalesce_s flags.
+ */
+
+#define MOUSE_COALESCE_LATEST (1 << 0) /* Replace unread moves by the newest */
 
 /* Vendor-specific command structure
  *
@@ -110,13 +118,48 @@ struct mouse_vendor_cmd_s
 
 struct mouse_report_s
 {
-  uint8_t buttons;  /* See MOUSE_* definitions above */
-                    /* Possibly padded with 1 byte here */
-  int16_t x;        /* X coordinate of the mouse position */
-  int16_t y;        /* Y coordinate of the mouse position */
-  int16_t wheel;    /* Mouse wheel position */
+  uint8_t  buttons;   /* See MOUSE_* definitions above */
+                      /* Possibly padded with 1 byte here */
+  int16_t  x;         /* X coordinate of the mouse position */
+  int16_t  y;         /* Y coordinate of the mouse position */
+  int16_t  wheel;     /* Mouse wheel position */
+                      /* Possibly padded here */
+  uint64_t timestamp; /* Report time stamp, in microseconds */
 };
 
+/* MSIOC_SETCOALESCE argument.  Per open file, a reader is woken at most
+ * once per interval and gets all reports queued meanwhile in one read().
+ * With MOUSE_COALESCE_LATEST, a report with the same buttons replaces the
+ * unread report before it, so a slow reader sees the newest position only.
+ */
+
+struct mouse_coalesce_s
+{
+  uint32_t interval;  /* Minimum time between wakeups in us, or 0 */
+  uint32_t flags;     /* See MOUSE_COALESCE_* definitions above */
+};
+
+/* The event ring returned by mmap() on a mouse device.  Once an open file
+ * is mapped, its reports go to the ring instead of to read().  Slot n
+ * holds report n % nslots for n from tail up to head.  The driver only
+ * writes head and dropped, the application advances tail when it has
+ * consumed reports.  A report is dropped if the ring is full.
+ */
+
+struct mouse_ring_s
+{
+  uint32_t          nslots;   /* Number of slots in the ring */
+  uint32_t          slotsize; /* Size of a slot in bytes */
+  volatile uint32_t head;     /* Reports written by the driver */
+  volatile uint32_t tail;     /* Reports consumed by the application */
+  volatile uint32_t dropped;  /* Reports lost while the ring was full */
+  uint32_t          reserved;
+};
+
+#define MOUSE_RING_SLOT(ring, n) \
+  ((FAR struct mouse_report_s *)((FAR uint8_t *)((ring) + 1) + \
+   ((n) % (ring)->nslots) * (ring)->slotsize))
+
 /* This structure is for mouse lower half driver */
 
 struct mouse_lowerhalf_s
@@ -95,8 +95,12 @@
                                              * int for enable grab
                                              */
 
+#define TSIOC_SETCOALESCE    _TSIOC(0x000f) /* arg: Pointer to
+                                             * struct touch_coalesce_s
+                                             */
+
 #define TSC_FIRST            0x0001          /* First common command */
-#define TSC_NCMDS            14              /* Fourteen common commands */
+#define TSC_NCMDS            15              /* Fifteen common commands */
 
 /* Backward compatible IOCTL */
 
@@ -149,6 +153,12 @@
 #define TOUCH_FLAG_MIRRORX   (1 << 1) /* Mirror X coordinate */
 #define TOUCH_FLAG_MIRRORY   (1 << 2) /* Mirror Y coordinate */
 
+/* These definitions provide the meaning of all of the bits that may be
+ * set in the struct touch_coalesce_s flags.
+ */
+
+#define TOUCH_COALESCE_LATEST (1 << 0) /* Replace unread moves by the newest */
+
 /* These are definitions for touch gesture */
 
 #define TOUCH_DOUBLE_CLICK   (0x00)
@@ -235,6 +245,39 @@ struct touch_sample_s
 #define SIZEOF_TOUCH_SAMPLE_S(n) \
   (sizeof(struct touch_sample_s) + ((n) - 1) * sizeof(struct touch_point_s))
 
+/* TSIOC_SETCOALESCE argument.  Per open file, a reader is woken at most
+ * once per interval and gets all samples queued meanwhile in one read().
+ * With TOUCH_COALESCE_LATEST, a move of the same contacts replaces the
+ * unread move before it, so a slow reader sees the newest position only.
+ */
+
+struct touch_coalesce_s
+{
+  uint32_t interval;             /* Minimum us between wakeups, or 0 */
+  uint32_t flags;                /* See TOUCH_COALESCE_* definitions above */
+};
+
+/* The event ring returned by mmap() on a touchscreen device.  Once an open
+ * file is mapped, its samples go to the ring instead of to read().  Slot
+ * n holds sample n % nslots for n from tail up to head.  The driver only
+ * writes head and dropped, the application advances tail when it has
+ * consumed samples.  A sample is dropped if the ring is full.
+ */
+
+struct touch_ring_s
+{
+  uint32_t          nslots;      /* Number of slots in the ring */
+  uint32_t          slotsize;    /* Size of a slot in bytes */
+  volatile uint32_t head;        /* Samples written by the driver */
+  volatile uint32_t tail;        /* Samples consumed by the application */
+  volatile uint32_t dropped;     /* Samples lost while the ring was full */
+  uint32_t          reserved;
+};
+
+#define TOUCH_RING_SLOT(ring, n) \
+  ((FAR struct touch_sample_s *)((FAR uint8_t *)((ring) + 1) + \
+   ((n) % (ring)->nslots) * (ring)->slotsize))
+
 #ifdef CONFIG_INPUT_TOUCHSCREEN
 
 /* This structure is for touchscreen lower half driver */
@@ -0,0 +1,101 @@
+/****************************************************************************
+ * include/nuttx/interval_tree.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INTERVAL_TREE_H
+#define __INCLUDE_NUTTX_INTERVAL_TREE_H
+
+/* An intrusive tree of closed intervals [start, last], which may overlap.
+ * It is a red-black tree ordered by start where each node keeps the
+ * largest last of its subtree, so the intervals overlapping a range are
+ * found in O(log n) plus one step per interval reported.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/rbtree.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define interval_entry(ptr, type, member) container_of(ptr, type, member)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct interval_node_s
+{
+  struct rb_node_s rb;           /* The node in the tree */
+  uintptr_t        start;        /* First value covered */
+  uintptr_t        last;         /* Last value covered */
+  uintptr_t        subtree_last; /* Largest last of the subtree */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Add a node with start and last set, or remove it.  The interval must not
+ * change while the node is in the tree.
+ */
+
+void interval_tree_insert(FAR struct rb_root_s *root,
+                          FAR struct interval_node_s *node);
+void interval_tree_remove(FAR struct rb_root_s *root,
+                          FAR struct interval_node_s *node);
+
+/* Iterate over the intervals overlapping [start, last] by increasing
+ * start:
+ *
+ *   for (node = interval_tree_iter_first(root, start, last); node != NULL;
+ *        node = interval_tree_iter_next(node, start, last))
+ */
+
+FAR struct interval_node_s *
+interval_tree_iter_first(FAR const struct rb_root_s *root,
+                         uintptr_t start, uintptr_t last);
+FAR struct interval_node_s *
+interval_tree_iter_next(FAR const struct interval_node_s *node,
+                        uintptr_t start, uintptr_t last);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_INTERVAL_TREE_H */
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <sys/types.h>
 #  include <stdint.h>
 #  include <stdbool.h>
 #endif
@@ -154,6 +155,10 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION -1
 #endif
 
+#ifndef CONFIG_SCHED_CRITMONITOR_HOLDERS
+#  define CONFIG_SCHED_CRITMONITOR_HOLDERS 0
+#endif
+
 #ifndef CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT -1
 #endif
@@ -302,6 +307,42 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 int irq_attach_wqueue(int irq, xcpt_t isr, xcpt_t isrwork,
                       FAR void *arg, int priority);
 
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset' and, if the IRQ was
+ *   attached with irq_attach_thread(), bind its handler thread to the same
+ *   CPUs.  Interrupts that the controller cannot route, like private
+ *   per-CPU interrupts, are left unchanged by the architecture.
+ *
+ * Input Parameters:
+ *   irq    - Irq num
+ *   cpuset - The CPUs allowed to take the interrupt
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int irq_set_affinity(int irq, cpu_set_t cpuset);
+#endif
+
+/****************************************************************************
+ * Name: irq_balance
+ *
+ * Description:
+ *   Spread the attached interrupts over the CPUs according to the number
+ *   of interrupts each of them took since its counters were last reset,
+ *   every IRQ goes to the CPU with the smallest load so far.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IRQMONITOR)
+void irq_balance(void);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #else
@@ -221,6 +221,11 @@ struct mod_loadinfo_s
   FAR Elf_Shdr *shdr;        /* Buffered module section headers */
   FAR void     *exported;    /* Module exports */
   FAR uint8_t  *iobuffer;    /* File I/O buffer */
+#ifdef CONFIG_LIBC_ELF_CACHE_STRTAB
+  FAR char     *strtab;      /* Cached symbol string table */
+  off_t         strtaboff;   /* File offset of the cached string table */
+  size_t        strtablen;   /* Size of the cached string table */
+#endif
   uintptr_t     datasec;     /* ET_DYN - data area start from Phdr */
   uintptr_t     segpad;      /* Padding between text and data */
   uintptr_t     initarr;     /* .init_array */
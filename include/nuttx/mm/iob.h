@@ -80,7 +80,24 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
+
+/* Checksum offload state of a network packet, kept in its head IOB */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define IOB_CSUM_NEEDED   (1 << 0) /* TX: TCP/UDP checksum left to NIC */
+#  define IOB_CSUM_VERIFIED (1 << 1) /* RX: Checksums verified by NIC */
+#endif
+
+/* Hardware timestamp of a network packet, kept in its head IOB.  On RX
+ * it is the time of arrival in nanoseconds of the NIC clock, zero if the
+ * NIC did not stamp the packet.  On TX the value IOB_TSTAMP_REQUEST asks
+ * the NIC to stamp the packet when it leaves the wire.
+ */
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  define IOB_TSTAMP_REQUEST UINT64_MAX
+#endif
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -123,6 +140,12 @@ struct iob_s
 #  ifdef CONFIG_IOB_ALLOC
   uint16_t io_bufsize;  /* Total length of the data buffer */
 #  endif
+#endif
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  uint8_t  io_csum;     /* Checksum offload state, see IOB_CSUM_* */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+  uint64_t io_tstamp;   /* Hardware timestamp, see IOB_TSTAMP_REQUEST */
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
@@ -161,12 +184,25 @@ struct iob_queue_s
 };
 #endif /* CONFIG_IOB_NCHAINS > 0 */
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+struct iob_cpustats_s
+{
+  int      ncached;      /* Free buffers in the cache of the CPU */
+  uint32_t hits;         /* Allocations served from the cache */
+  uint32_t misses;       /* Allocations that refilled the cache */
+};
+#endif
+
 struct iob_stats_s
 {
   int ntotal;
   int nfree;
   int nwait;
   int nthrottle;
+  uint32_t nexhausted;   /* Allocations that found no free buffer */
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  struct iob_cpustats_s cpu[CONFIG_SMP_NCPUS];
+#endif
 };
 
 /****************************************************************************
@@ -220,6 +256,27 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_alloc_bulk
+ *
+ * Description:
+ *   Try to allocate a number of I/O buffers from the free list in one
+ *   locked operation, without waiting for buffers to become free.  Either
+ *   all of them are allocated or none.
+ *
+ * Input Parameters:
+ *   throttled - An indication of the IOB allocation is "throttled"
+ *   count     - The number of I/O buffers to allocate
+ *
+ * Returned Value:
+ *   The I/O buffers linked through io_flink, or NULL if there are not
+ *   enough free buffers.  They are not a packet: io_pktlen is zero in
+ *   every one of them.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_bulk(bool throttled, unsigned int count);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
@@ -292,6 +349,28 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
 FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
                                      iob_free_cb_t free_cb);
 
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate one I/O buffer whose payload holds at least size
+ *   bytes, without waiting for a buffer to become free.  The smallest
+ *   size class with a free buffer is used (see CONFIG_IOB_SIZE_CLASSES);
+ *   a buffer larger than every class comes from the heap, unless the
+ *   caller is an interrupt handler.
+ *
+ * Input Parameters:
+ *   size      - The payload size required in one piece
+ *   throttled - An indication of the IOB allocation is "throttled", only
+ *               applies to buffers of the CONFIG_IOB_BUFSIZE pool
+ *
+ * Returned Value:
+ *   The I/O buffer, NULL if none is available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(uint16_t size, bool throttled);
+
 #endif
 
 /****************************************************************************
@@ -687,6 +766,40 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
 
 int iob_count(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_clean_dcache
+ *
+ * Description:
+ *   Clean the data cache over the data of an I/O buffer chain before a DMA
+ *   transfer reads it, with the memory barriers shared by several buffers
+ *   at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void iob_clean_dcache(FAR struct iob_s *iob);
+#else
+#  define iob_clean_dcache(iob) ((void)(iob))
+#endif
+
+/****************************************************************************
+ * Name: iob_invalidate_dcache
+ *
+ * Description:
+ *   Invalidate the data cache over the buffers of an I/O buffer chain after
+ *   a DMA transfer wrote them, with the memory barriers shared by several
+ *   buffers at a time.  The whole of each buffer, from the start of
+ *   io_data, is invalidated so that io_offset and io_len may be set
+ *   afterwards.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void iob_invalidate_dcache(FAR struct iob_s *iob);
+#else
+#  define iob_invalidate_dcache(iob) ((void)(iob))
+#endif
+
 /****************************************************************************
  * Name: iob_dump
  *
@@ -717,10 +830,7 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
  *
  ****************************************************************************/
 
-#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
-    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
 void iob_getstats(FAR struct iob_stats_s *stats);
-#endif
 
 #endif /* CONFIG_MM_IOB */
 #endif /* __INCLUDE_NUTTX_MM_IOB_H */
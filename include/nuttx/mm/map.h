@@ -28,7 +28,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
-#include <nuttx/queue.h>
+#include <nuttx/interval_tree.h>
 #include <nuttx/mutex.h>
 #include <nuttx/mm/gran.h>
 
@@ -42,11 +42,13 @@ struct task_group_s;
  * Public Types
  ****************************************************************************/
 
-/* A memory mapping list item */
+/* A memory mapping.  Once added, length may only shrink, the tree keeps
+ * the span it was added with.
+ */
 
 struct mm_map_entry_s
 {
-  FAR struct mm_map_entry_s *flink;  /* this is used as sq_entry_t */
+  struct interval_node_s node;       /* The node in the mappings tree */
   FAR void *vaddr;
   size_t length;
   off_t offset;
@@ -78,8 +80,8 @@ struct mm_map_entry_s
 
 struct mm_map_s
 {
-  sq_queue_t mm_map_sq;         /* mappings list */
-  size_t map_count;             /* mappings list length */
+  struct rb_root_s mm_map_tree; /* mappings by address */
+  size_t map_count;             /* number of mappings */
 
 #ifdef CONFIG_ARCH_VMA_MAPPING
   GRAN_HANDLE mm_map_vpages;    /* SHM virtual zone allocator */
@@ -264,7 +266,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry);
  * Name: mm_map_next
  *
  * Description:
- *   Returns the next mapping in the list, following the argument.
+ *   Returns the next mapping by address, following the argument.
  *   Can be used to iterate through all the mappings. Returns the first
  *   mapping when the argument "entry" is NULL.
  *
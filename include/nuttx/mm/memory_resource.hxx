@@ -0,0 +1,128 @@
+//***************************************************************************
+// include/nuttx/mm/memory_resource.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
+#define __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <nuttx/mm/mempool.h>
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+
+// A memory resource serving the allocations from a set of fixed block
+// pools, as the heap does for its small allocations, but with pools owned
+// by the resource: the containers using it do not contend for the heap
+// lock, and freeing a block is a push to its pool.  The requests larger
+// than the biggest block go to the upstream resource.
+
+class mempool_resource : public std::pmr::memory_resource
+{
+public:
+  // name       - The name of the pools in procfs
+  // poolsize   - The block sizes in increasing order
+  // npools     - The number of block sizes
+  // expandsize - The amount of memory taken from the heap at a time
+  // chunksize  - The chunk size of the pools, zero for none
+  // upstream   - The resource used for the large requests
+
+  mempool_resource(FAR const char *name, FAR const size_t *poolsize,
+                   size_t npools, size_t expandsize = 4096,
+                   size_t chunksize = 0,
+                   FAR std::pmr::memory_resource *upstream =
+                     std::pmr::new_delete_resource());
+  ~mempool_resource();
+
+  mempool_resource(const mempool_resource &) = delete;
+  mempool_resource &operator=(const mempool_resource &) = delete;
+
+  FAR std::pmr::memory_resource *upstream_resource() const
+  {
+    return m_upstream;
+  }
+
+protected:
+  FAR void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(FAR void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept override;
+
+private:
+  FAR struct mempool_multiple_s *m_mpool;
+  FAR std::pmr::memory_resource *m_upstream;
+};
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+#if CONFIG_TLS_TASK_NELEM > 0
+
+//***************************************************************************
+// Name: task_arena_resource
+//
+// Description:
+//   Return the arena of the calling task: a monotonic buffer resource for
+//   the short lived containers of the task, created on first use and
+//   destroyed with the task.  Deallocation is a no-op, the memory is only
+//   given back by task_arena_release() or at task exit.  The arena must
+//   not be shared with other tasks.
+//
+//***************************************************************************
+
+FAR std::pmr::memory_resource *task_arena_resource();
+
+//***************************************************************************
+// Name: task_arena_release
+//
+// Description:
+//   Release all memory of the calling task's arena.  No object allocated
+//   from it may be used afterwards.
+//
+//***************************************************************************
+
+void task_arena_release();
+
+#endif // CONFIG_TLS_TASK_NELEM > 0
+
+} // namespace pmr
+} // namespace nuttx
+
+#endif // CONFIG_LIBXX_PMR
+#endif // __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
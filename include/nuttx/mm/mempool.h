@@ -29,6 +29,7 @@
 
 #include <sys/types.h>
 
+#include <nuttx/atomic.h>
 #include <nuttx/list.h>
 #include <nuttx/queue.h>
 #include <nuttx/mm/mm.h>
@@ -42,9 +43,41 @@
  ****************************************************************************/
 
 #if CONFIG_MM_BACKTRACE >= 0
+#  define MEMPOOL_BACKTRACESIZE sizeof(struct mempool_backtrace_s)
+#else
+#  define MEMPOOL_BACKTRACESIZE 0
+#endif
+
+/* The owner tag of a block follows the backtrace, if any */
+
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+#  define MEMPOOL_OWNERSIZE     sizeof(uint8_t)
+#else
+#  define MEMPOOL_OWNERSIZE     0
+#endif
+
+/* Memory tiers and policies of a pool */
+
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+#  define MEMPOOL_TIER_PREFERRED 0
+#  define MEMPOOL_TIER_FALLBACK  1
+#  define MEMPOOL_NTIERS         2
+
+/* Expansions try the preferred heap first, or go to the fallback heap */
+
+#  define MEMPOOL_EXPAND_PREFERRED 0
+#  define MEMPOOL_EXPAND_FALLBACK  1
+
+/* Keep all chunks, or return the fallback chunks when the pool is idle */
+
+#  define MEMPOOL_SHRINK_NONE      0
+#  define MEMPOOL_SHRINK_FALLBACK  1
+#endif
+
+#if CONFIG_MM_BACKTRACE >= 0 || defined(CONFIG_MM_MEMPOOL_REMOTE_FREE)
 #  define MEMPOOL_REALBLOCKSIZE(pool) (ALIGN_UP((pool)->blocksize + \
-                                       sizeof(struct mempool_backtrace_s), \
-                                       MM_ALIGN))
+                                       MEMPOOL_BACKTRACESIZE + \
+                                       MEMPOOL_OWNERSIZE, MM_ALIGN))
 #else
 #  define MEMPOOL_REALBLOCKSIZE(pool) ((pool)->blocksize)
 #endif
@@ -87,6 +120,32 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+/* This structure describes the per-CPU cache of free blocks of a pool */
+
+struct mempool_magazine_s
+{
+  size_t    nblks;                                 /* The number of cached blocks */
+  FAR void *blks[CONFIG_MM_MEMPOOL_MAGAZINE_SIZE]; /* The cached free blocks */
+};
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+/* This structure describes the lock-free queue of the blocks which other
+ * CPUs released back to the CPU owning them.
+ */
+
+struct mempool_remote_s
+{
+#  if UINTPTR_MAX <= UINT32_MAX
+  atomic_t   head;  /* The first queued block (uintptr_t) */
+#  else
+  atomic64_t head;  /* The first queued block (uintptr_t) */
+#  endif
+  atomic_t   nblks; /* The number of queued blocks */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -100,6 +159,18 @@ struct mempool_s
   mempool_alloc_t alloc;    /* The alloc function for mempool */
   mempool_free_t  free;     /* The free function for mempool */
   mempool_check_t check;    /* The check function for mempool */
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+
+  /* The preferred and fallback heaps replace alloc and free if the
+   * preferred one is set.  tierlimit bounds the memory taken from the
+   * preferred heap, zero means no limit.
+   */
+
+  FAR struct mm_heap_s *tier[MEMPOOL_NTIERS];
+  size_t     tierlimit;
+  uint8_t    expandpolicy;  /* See MEMPOOL_EXPAND_* */
+  uint8_t    shrinkpolicy;  /* See MEMPOOL_SHRINK_* */
+#endif
 
   /* Private data for memory pool */
 
@@ -110,6 +181,15 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  struct mempool_magazine_s magazine[CONFIG_SMP_NCPUS]; /* Per-CPU caches */
+#endif
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+  struct mempool_remote_s remote[CONFIG_SMP_NCPUS];     /* Remote frees */
+#endif
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  size_t     tiersize[MEMPOOL_NTIERS];                  /* Memory per tier */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
@@ -139,6 +219,9 @@ struct mempoolinfo_s
   unsigned long aordblks; /* This is the number of used blocks */
   unsigned long sizeblks; /* This is the size of a mempool blocks */
   unsigned long nwaiter;  /* This is the number of waiter for mempool */
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  unsigned long tierarena[MEMPOOL_NTIERS]; /* Memory taken from each tier */
+#endif
 };
 
 /****************************************************************************
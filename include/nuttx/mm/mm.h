@@ -198,6 +198,38 @@ struct mm_heap_config_s
   bool                  nokasan;
 };
 
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+/* Fragmentation and latency statistics of a heap, see mm_telemetry().
+ * Bucket n of the histograms counts values in [2^n, 2^(n+1)), bucket 0
+ * also counts 0.  Latency histograms count perf_gettime() ticks, the
+ * percentiles derived from them are bucket upper bounds.  This is also
+ * the record format of /proc/memstat.
+ */
+
+#  define MM_TELEMETRY_NBUCKETS 32
+
+struct mm_telemetry_s
+{
+  char          name[16];              /* Heap name */
+  size_t        mxordblk;              /* Largest free chunk */
+
+  /* Free chunks by size, mm_malloc() and mm_free() calls by ticks */
+
+  uint32_t      freehist[MM_TELEMETRY_NBUCKETS];
+  uint32_t      mallochist[MM_TELEMETRY_NBUCKETS];
+  uint32_t      freelathist[MM_TELEMETRY_NBUCKETS];
+
+  /* Latency percentiles and maxima in ns */
+
+  unsigned long malloc_p50;
+  unsigned long malloc_p99;
+  unsigned long malloc_max;
+  unsigned long free_p50;
+  unsigned long free_p99;
+  unsigned long free_max;
+};
+#endif
+
 struct mempool_init_s
 {
   FAR const size_t *poolsize;
@@ -446,6 +478,13 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
 size_t mm_heapfree(FAR struct mm_heap_s *heap);
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap);
 
+/* Functions contained in mm_telemetry.c ************************************/
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+void mm_telemetry(FAR struct mm_heap_s *heap,
+                  FAR struct mm_telemetry_s *info);
+#endif
+
 /* Functions contained in kmm_mallinfo.c ************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -128,6 +128,13 @@ struct mqueue_inode_s
   struct sigwork_s ntwork;    /* Notification work */
 #endif
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
+#ifdef CONFIG_MQ_RING
+  FAR char *ring;             /* Inline message slots */
+  int16_t ringhead;           /* Next slot to write */
+  int16_t ringtail;           /* Next slot to read */
+  int16_t ringcount;          /* Number of messages in the slots */
+  uint8_t ringprio;           /* Priority of the messages in the slots */
+#endif
 };
 
 /****************************************************************************
@@ -58,6 +58,12 @@
  *   ioctl argument:  Pointer to a config_data_s structure to receive the
  *                    config data.  All fields of the structure must be
  *                    specified (i.e. id, instance, pointer and len).
+ *
+ * CFGDIOC_SETCONFIGS - Set several Config Data items under one lock
+ *
+ *   ioctl argument:  Pointer to a config_batch_s structure.  The items are
+ *                    all checked before the first one is written, and no
+ *                    reader sees a part of the batch.
  */
 
 #define CFGDIOC_GETCONFIG    _CFGDIOC(1)
@@ -66,6 +72,7 @@
 #define CFGDIOC_FINDCONFIG   _CFGDIOC(4)
 #define CFGDIOC_FIRSTCONFIG  _CFGDIOC(5)
 #define CFGDIOC_NEXTCONFIG   _CFGDIOC(6)
+#define CFGDIOC_SETCONFIGS   _CFGDIOC(7)
 
 /****************************************************************************
  * Public Types
@@ -85,6 +92,14 @@ struct config_data_s
   size_t      len;          /* Length of the config data buffer */
 };
 
+/* This structure is used to set several config data items at once */
+
+struct config_batch_s
+{
+  FAR struct config_data_s *items;  /* The items to set */
+  size_t                    nitems; /* Number of items */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
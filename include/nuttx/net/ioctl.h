@@ -159,6 +159,13 @@
 #define SIOCGIFVLAN        _SIOC(0x0043)  /* Get VLAN interface */
 #define SIOCSIFVLAN        _SIOC(0x0044)  /* Set VLAN interface */
 
+/* Hardware timestamping ****************************************************/
+
+/* ifr_data points to a struct hwtstamp_config */
+
+#define SIOCSHWTSTAMP      _SIOC(0x0045)  /* Set hardware timestamping */
+#define SIOCGHWTSTAMP      _SIOC(0x0046)  /* Get hardware timestamping */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
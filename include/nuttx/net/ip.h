@@ -217,6 +217,19 @@ struct ipv6_stats_s
                            * were neither ICMP, UDP nor TCP */
 };
 #endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPFRAG
+struct ipfrag_stats_s
+{
+  net_stats_t reasm;      /* Number of datagrams reassembled */
+  net_stats_t timeout;    /* Number of datagrams dropped on reassembly
+                           * timeout */
+  net_stats_t evict;      /* Number of datagrams evicted to keep the
+                           * reassembly cache within its limits */
+  net_stats_t overlap;    /* Number of fragments dropped since they
+                           * overlapped another fragment */
+};
+#endif /* CONFIG_NET_IPFRAG */
 #endif /* CONFIG_NET_STATISTICS */
 
 #ifdef CONFIG_NET_ARP_ACD
@@ -137,10 +137,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;            /* Forward reference */
+struct stat;            /* Forward reference */
+struct socket;          /* Forward reference */
+struct pollfd;          /* Forward reference */
+struct mm_map_entry_s;  /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +182,27 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+
+  /* Optional batched transfers.  These return the number of messages
+   * transferred, or a negated errno value if the first one failed.  When
+   * NULL or returning -ENOSYS, psock_sendmmsg() and psock_recvmmsg() fall
+   * back to a loop over si_sendmsg() and si_recvmsg().
+   */
+
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR const struct timespec *timeout);
+
+  /* Optional mapping of socket owned memory into the caller's address
+   * space, reached through mmap() on the socket descriptor.  When NULL,
+   * mmap() falls back to its default handling.
+   */
+
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -227,6 +249,9 @@ struct socket_conn_s
   uint8_t       s_boundto;   /* Index of the interface we are bound to.
                               * Unbound: 0, Bound: 1-MAX_IFINDEX */
 #  endif
+#  ifdef CONFIG_NET_BUSY_POLL
+  uint32_t      s_busypoll;  /* Busy poll time of receive (in usec) */
+#  endif
 #endif
 
   /* Definitions of 8-bit socket flags */
@@ -262,6 +287,17 @@ struct socket
   FAR const struct sock_intf_s *s_sockif;
 };
 
+/* net_lock() hold statistics, see net_lockstats() */
+
+#ifdef CONFIG_NET_LOCK_STATS
+struct net_lockstats_s
+{
+  uint32_t nholds;           /* Outermost holds completed */
+  clock_t  total;            /* Sum of the hold times */
+  clock_t  max;              /* Longest hold */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -333,6 +369,13 @@ ssize_t net_ioctl_arglen(uint8_t domain, int cmd);
  *                       momentarily to wait for an IOB to become
  *                       available.
  *
+ * The protocol stack itself does not depend on this lock any more:
+ * connection state is protected by the per-connection lock (conn_lock()),
+ * device RX/TX by the per-device lock (netdev_lock()), and the routing,
+ * ARP and Neighbor tables by locks of their own, always taken in that
+ * order.  net_lock() is kept for drivers and out-of-tree code that still
+ * serialize against each other with it.
+ *
  ****************************************************************************/
 
 /****************************************************************************
@@ -387,6 +430,26 @@ int net_trylock(void);
 
 void net_unlock(void);
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return the net_lock() hold statistics, optionally starting them over.
+ *   The times are in perf_gettime() units.
+ *
+ * Input Parameters:
+ *   stats - Receives the statistics
+ *   reset - Clear the statistics after reading them
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats, bool reset);
+#endif
+
 /****************************************************************************
  * Name: net_sem_timedwait
  *
@@ -914,6 +977,70 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends a vector of messages to a socket.  This is an
+ *   internal OS interface. It is functionally equivalent to sendmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Messages to send; msg_len receives the bytes sent for each
+ *   vlen      Number of entries in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  Otherwise, if not
+ *   even the first message could be sent, a negated errno value is
+ *   returned (see comments with sendmsg() for a list of appropriate errno
+ *   values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  This is
+ *   an internal OS interface. It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages; msg_len receives the bytes
+ *             received for each
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags
+ *   timeout   If not NULL, no more messages are received once this time
+ *             has elapsed after the call
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  Otherwise, if
+ *   not even the first message could be received, a negated errno value is
+ *   returned (see comments with recvmsg() for a list of appropriate errno
+ *   values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -84,6 +84,31 @@
 
 #define NETDEV_TX_CSUM  (1 << 1) /* Netdev support hardware tx checksum */
 #define NETDEV_RX_CSUM  (1 << 2) /* Netdev support hardware rx checksum */
+#define NETDEV_TX_TSO   (1 << 3) /* Netdev support hardware TCP segments */
+#define NETDEV_TX_GSO   (1 << 4) /* Netdev accepts TCP above the MTU */
+
+/* Checksum offload of the packet in d_iob.  The NIC verified the RX
+ * checksums either of every packet (NETDEV_RX_CSUM) or of this one
+ * (IOB_CSUM_VERIFIED, set by the lower half).  NETDEV_TX_CSUM_OFFLOAD()
+ * tells whether the TCP/UDP checksum of an outgoing packet is left to
+ * the NIC, and records that in the packet for the lower half.
+ */
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define NETDEV_PKT_CSUM_VERIFIED(dev) \
+     (((dev)->d_iob->io_csum & IOB_CSUM_VERIFIED) != 0)
+#  define NETDEV_TX_CSUM_OFFLOAD(dev) \
+     (((dev)->d_features & NETDEV_TX_CSUM) != 0 ? \
+      ((dev)->d_iob->io_csum |= IOB_CSUM_NEEDED, true) : \
+      ((dev)->d_iob->io_csum &= ~IOB_CSUM_NEEDED, false))
+#else
+#  define NETDEV_PKT_CSUM_VERIFIED(dev) false
+#  define NETDEV_TX_CSUM_OFFLOAD(dev) \
+     (((dev)->d_features & NETDEV_TX_CSUM) != 0)
+#endif
+
+#define NETDEV_RX_CSUM_OK(dev) \
+  (((dev)->d_features & NETDEV_RX_CSUM) != 0 || NETDEV_PKT_CSUM_VERIFIED(dev))
 
 /* Determine the largest possible address */
 
@@ -108,6 +133,8 @@
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
+#  define NETDEV_RXBATCH_NBUCKETS 8
+
 #  define NETDEV_RESET_STATISTICS(dev) \
      memset(&(dev)->d_statistics, 0, sizeof(struct netdev_statistics_s))
 
@@ -169,6 +196,21 @@
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
 
+/* Account one RX poll that drained n packets in the batch-size histogram,
+ * bucket i counts the polls with 2^i <= n < 2^(i+1), the last bucket
+ * collects everything above.
+ */
+
+#  define NETDEV_RXBATCH(dev,n) \
+    do { \
+        unsigned int _b = 0; \
+        while (_b < NETDEV_RXBATCH_NBUCKETS - 1 && ((n) >> (_b + 1)) != 0) \
+          { \
+            _b++; \
+          } \
+        (dev)->d_statistics.rx_batch[_b]++; \
+    } while (0)
+
 #  define NETDEV_TXPACKETS(dev) \
     do { \
         _NETDEV_STATISTIC_LOG(dev,tx_packets); \
@@ -189,6 +231,7 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXBATCH(dev,n)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
@@ -262,6 +305,10 @@ struct netdev_statistics_s
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
   uint64_t rx_bytes;       /* Number of bytes received */
 
+  /* Histogram of the number of packets taken per RX poll */
+
+  uint32_t rx_batch[NETDEV_RXBATCH_NBUCKETS];
+
   /* Tx Status */
 
   uint32_t tx_packets;     /* Number of Tx packets queued */
@@ -322,6 +369,23 @@ struct netdev_rss_s
 
 struct devif_callback_s; /* Forward reference */
 
+#ifdef CONFIG_NET_XDP
+/* The hook that an AF_XDP socket attaches to one RX queue of a device with
+ * d_xdpattach().  rx() is called from the RX poll, with the device locked,
+ * for every frame received on the queue before packet sockets or the stack
+ * see it.  It returns true if it consumed the frame, which the driver then
+ * frees, or false to let the frame go on to the stack.
+ */
+
+struct net_driver_s;
+
+struct netdev_xdp_s
+{
+  CODE bool (*rx)(FAR struct netdev_xdp_s *xdp,
+                  FAR struct net_driver_s *dev, FAR struct iob_s *pkt);
+};
+#endif
+
 struct net_driver_s
 {
   /* This link is used to maintain a single-linked list of ethernet drivers.
@@ -505,6 +569,15 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_GSO
+  /* When the outgoing TCP packet exceeds the MTU on a NETDEV_TX_GSO device,
+   * d_gso_size is the MSS it must be segmented into.  Only meaningful
+   * until the packet has been passed to the driver.
+   */
+
+  uint16_t d_gso_size;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -572,6 +645,21 @@ struct net_driver_s
   CODE int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd,
                       unsigned long arg);
 #endif
+#ifdef CONFIG_NET_BUSY_POLL
+  CODE int (*d_busypoll)(FAR struct net_driver_s *dev);
+#endif
+#ifdef CONFIG_NET_XDP
+  /* AF_XDP support: attach (or, with NULL, detach) the hook of an RX
+   * queue, and transmit a whole L2 frame on a TX queue bypassing the
+   * stack.  d_xdpxmit() returns -EAGAIN when the device is out of TX
+   * buffers.
+   */
+
+  CODE int (*d_xdpattach)(FAR struct net_driver_s *dev, unsigned int queue,
+                          FAR struct netdev_xdp_s *xdp);
+  CODE int (*d_xdpxmit)(FAR struct net_driver_s *dev, unsigned int queue,
+                        FAR const uint8_t *frame, unsigned int len);
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -820,6 +908,48 @@ int netdev_ifdown(FAR struct net_driver_s *dev);
 void netdev_carrier_on(FAR struct net_driver_s *dev);
 void netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer of any alignment to a partial
+ *   checksum, the kernel of all of the checksum helpers.  Optimized
+ *   versions can come from the C library of the architecture
+ *   (CONFIG_LIBC_ARCH_CHKSUM).
+ *
+ * Input Parameters:
+ *   sum  - Partial checksum in host byte order.
+ *   data - Beginning of the data, its first byte is the high byte of the
+ *          first word.
+ *   len  - Length of the data, an odd last byte is padded with zero.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_block(uint16_t sum, FAR const uint8_t *data, size_t len);
+
+/****************************************************************************
+ * Name: net_toeplitz_hash
+ *
+ * Description:
+ *   Calculate the Toeplitz hash of the data with the default RSS key of
+ *   most NICs, as the software fallback of the hardware RSS hash.
+ *
+ * Input Parameters:
+ *   data - The data to hash, e.g. the addresses and ports of a flow
+ *   len  - The length of the data in bytes, at most 36
+ *
+ * Returned Value:
+ *   The hash value.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_RSS) || defined(CONFIG_NETDEV_MULTIQUEUE)
+uint32_t net_toeplitz_hash(FAR const uint8_t *data, size_t len);
+#endif
+
 /****************************************************************************
  * Name: chksum
  *
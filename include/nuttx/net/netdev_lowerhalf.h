@@ -127,11 +127,22 @@ struct netdev_lowerhalf_s
   uint8_t rxtype;
   uint8_t priority;
 
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* Number of RX/TX queue pairs, 0 is taken as 1.  With more than one,
+   * the *_queue operations are used instead of transmit/receive/rxenable.
+   */
+
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
    * Fields that lowerhalf should never touch (used by upper half):
    *   d_ifup, d_ifdown, d_txavail, d_addmac, d_rmmac, d_ioctl, d_private
+   *
+   * The checksum offload capabilities (NETDEV_TX_CSUM, NETDEV_RX_CSUM) go
+   * into d_features before the device is registered.
    */
 
   struct net_driver_s netdev;
@@ -180,6 +191,34 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+  /* rxenable - Optional, re-enable the RX interrupt.  A driver may mask
+   *            its RX interrupt before calling netdev_lower_rxready(), the
+   *            upper half then calls rxenable once it has drained the
+   *            device without using up CONFIG_NETDEV_RX_BUDGET.  If the
+   *            budget is used up, the poll is rescheduled instead and the
+   *            interrupt stays masked.
+   */
+
+  CODE void (*rxenable)(FAR struct netdev_lowerhalf_s *dev);
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+  /* transmit_queue/receive_queue/rxenable_queue - The same as above, on
+   *   one of the nqueues queue pairs, required if nqueues > 1.  A packet
+   *   goes to TX queue (hash % nqueues), hash being the Toeplitz hash
+   *   (net_toeplitz_hash) of its flow with the source and destination
+   *   swapped, i.e. the RSS hash of the replies, so a driver that fills
+   *   its RSS indirection table round robin with the same key gets both
+   *   directions of a flow on the same queue pair.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, unsigned int queue);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      unsigned int queue);
+  CODE void (*rxenable_queue)(FAR struct netdev_lowerhalf_s *dev,
+                              unsigned int queue);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -303,6 +342,26 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one RX queue of a multi-queue device.  The queue is polled by its own
+ *   work (NETDEV_RX_WORK), or by the thread of CPU
+ *   (queue % CONFIG_SMP_NCPUS) in NETDEV_RX_THREAD_RSS mode.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the RX queue, less than nqueues
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_MULTIQUEUE
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                unsigned int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -316,6 +375,26 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_txtstamp
+ *
+ * Description:
+ *   Report the hardware transmit timestamp of a packet for which
+ *   netpkt_tstamp_requested() was true, before the packet is freed.  Must
+ *   not be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   dev - The lower half device driver structure
+ *   pkt - The net packet that was sent
+ *   ns  - The time the packet left the wire, in ns of the NIC clock
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+void netdev_lower_txtstamp(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt, uint64_t ns);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -386,6 +465,29 @@ int netdev_lower_vlan_del(FAR struct netdev_lowerhalf_s *dev, uint16_t vid);
 FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
                            enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_alloc_size
+ *
+ * Description:
+ *   Allocate a netpkt structure whose first buffer holds len bytes of data
+ *   in one piece, e.g. a whole jumbo frame.  The buffer comes from the
+ *   smallest I/O buffer size class that fits (see CONFIG_IOB_SIZE_CLASSES).
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   type - Whether used for TX or RX
+ *   len  - The contiguous data length required
+ *
+ * Returned Value:
+ *   Pointer to the packet, NULL on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ALLOC
+FAR netpkt_t *netpkt_alloc_size(FAR struct netdev_lowerhalf_s *dev,
+                                enum netpkt_type_e type, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: netpkt_free
  *
@@ -505,6 +607,98 @@ int netpkt_setdatalen(FAR struct netdev_lowerhalf_s *dev,
 unsigned int netpkt_getdatalen(FAR struct netdev_lowerhalf_s *dev,
                                FAR netpkt_t *pkt);
 
+/****************************************************************************
+ * Name: netpkt_gso_size
+ *
+ * Description:
+ *   Get the MSS that a TCP packet larger than the MTU must be segmented
+ *   into, for drivers that set NETDEV_TX_TSO.  Only valid for the packet
+ *   being passed to transmit(), during that call.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   pkt    - The net packet
+ *
+ * Returned Value:
+ *   The MSS of the segments, or zero if the packet is sent as it is.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_GSO
+uint16_t netpkt_gso_size(FAR struct netdev_lowerhalf_s *dev,
+                         FAR netpkt_t *pkt);
+#endif
+
+/****************************************************************************
+ * Name: netpkt_csum_needed
+ *
+ * Description:
+ *   Check whether the TCP/UDP checksum of a packet being transmitted was
+ *   left to the hardware, with the checksum field zeroed.  Only set for
+ *   drivers having NETDEV_TX_CSUM; other packets are complete.
+ *
+ * Input Parameters:
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netpkt_csum_needed(pkt) (((pkt)->io_csum & IOB_CSUM_NEEDED) != 0)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_set_csum_verified
+ *
+ * Description:
+ *   Mark a received packet as having had its IP and TCP/UDP/ICMP checksums
+ *   verified by the hardware, so that the stack skips them.  For drivers
+ *   that tell it per packet instead of setting NETDEV_RX_CSUM.
+ *
+ * Input Parameters:
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+#  define netpkt_set_csum_verified(pkt) ((pkt)->io_csum |= IOB_CSUM_VERIFIED)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_tstamp_requested
+ *
+ * Description:
+ *   Check whether the hardware transmit timestamp of a packet being
+ *   transmitted was asked for, to be returned with
+ *   netdev_lower_txtstamp().
+ *
+ * Input Parameters:
+ *   pkt    - The net packet
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  define netpkt_tstamp_requested(pkt) \
+     ((pkt)->io_tstamp == IOB_TSTAMP_REQUEST)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_set_timestamp
+ *
+ * Description:
+ *   Record the hardware receive timestamp of a received packet, in
+ *   nanoseconds of the NIC clock.  The value is reported to the sockets
+ *   that asked for SOF_TIMESTAMPING_RX_HARDWARE.
+ *
+ * Input Parameters:
+ *   pkt    - The net packet
+ *   ns     - The time of arrival
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  define netpkt_set_timestamp(pkt, ns) ((pkt)->io_tstamp = (ns))
+#endif
+
 /****************************************************************************
  * Name: netpkt_reset_reserved
  *
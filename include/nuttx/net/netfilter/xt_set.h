@@ -0,0 +1,116 @@
+/****************************************************************************
+ * include/nuttx/net/netfilter/xt_set.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NET_NETFILTER_XT_SET_H
+#define __INCLUDE_NUTTX_NET_NETFILTER_XT_SET_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define XT_MATCH_NAME_SET       "set"
+
+/* getsockopt() option of IPPROTO_IP for the set requests */
+
+#define SO_IP_SET               83
+
+#define IPSET_MAXNAMELEN        32
+#define IPSET_INVALID_ID        65535
+
+/* Flags of struct xt_set_info, same as Linux */
+
+#define IPSET_INV_MATCH         0x01 /* Invert the sense of the match */
+#define IPSET_DIM_ONE_SRC       0x02 /* Match the source address */
+
+/* Request operations, GET_BYNAME is the one of Linux.  The others replace
+ * the ipset netlink protocol and use struct ip_set_req_adt.
+ */
+
+#define IP_SET_OP_GET_BYNAME    0x00000006 /* Get the index of a set */
+#define IP_SET_OP_CREATE        0x00001000 /* Create a hash:ip set */
+#define IP_SET_OP_DESTROY       0x00001001 /* Destroy an unused set */
+#define IP_SET_OP_FLUSH         0x00001002 /* Remove all addresses */
+#define IP_SET_OP_ADD           0x00001003 /* Add an address */
+#define IP_SET_OP_DEL           0x00001004 /* Remove an address */
+#define IP_SET_OP_TEST          0x00001005 /* -ENOENT if not in the set */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef uint16_t ip_set_id_t;
+
+union ip_set_name_index
+{
+  char name[IPSET_MAXNAMELEN];
+  ip_set_id_t index;
+};
+
+/* The argument of IP_SET_OP_GET_BYNAME, the index is returned in set */
+
+struct ip_set_req_get_set
+{
+  unsigned int op;
+  unsigned int version;
+  union ip_set_name_index set;
+};
+
+/* The argument of the other operations.  CREATE takes the name and the
+ * family and returns the index in set, the others take the index.
+ */
+
+struct ip_set_req_adt
+{
+  unsigned int op;
+  unsigned int version;
+  union ip_set_name_index set;
+  sa_family_t family;
+  union
+  {
+    struct in_addr in;
+    struct in6_addr in6;
+  } addr;
+};
+
+/* The "set" match, revision 1 */
+
+struct xt_set_info
+{
+  ip_set_id_t index;
+  uint8_t dim;
+  uint8_t flags;
+};
+
+struct xt_set_info_match_v1
+{
+  struct xt_set_info match_set;
+};
+
+#endif /* __INCLUDE_NUTTX_NET_NETFILTER_XT_SET_H */
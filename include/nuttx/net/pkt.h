@@ -70,4 +70,29 @@
 struct net_driver_s; /* Forward reference */
 int pkt_input(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: pkt_txtstamp
+ *
+ * Description:
+ *   Report the hardware transmit timestamp of a packet that was sent with
+ *   IOB_TSTAMP_REQUEST in io_tstamp.  The report is queued on the error
+ *   queue of the packet socket that sent it, if it is still waiting.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure that sent the packet
+ *   iob - The packet, which must not have been freed yet
+ *   ns  - The time the packet left the wire, in nanoseconds of the NIC
+ *         clock
+ *
+ * Assumptions:
+ *   Called from the network driver with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+struct iob_s;        /* Forward reference */
+void pkt_txtstamp(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                  uint64_t ns);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_PKT_H */
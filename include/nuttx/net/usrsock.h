@@ -407,6 +407,12 @@ void usrsock_abort(void);
 
 /****************************************************************************
  * Name: usrsock_response() - handle usrsock request's ack/response
+ *
+ * Description:
+ *   Handle one or more messages stored back to back in buffer.  Returns
+ *   the number of bytes consumed or a negated errno value if nothing could
+ *   be handled.
+ *
  ****************************************************************************/
 
 ssize_t usrsock_response(FAR const char *buffer, size_t len,
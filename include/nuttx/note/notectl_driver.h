@@ -65,6 +65,9 @@
  *              - Set IRQ filter setting
  *                Argument: A read-only pointer to struct
  *                          note_filter_irq_s
+ * NOTECTL_SETSAMPLERATE
+ *              - Start or stop the sampling profiler
+ *                Argument: Samples per second on each CPU, 0 to stop
  */
 
 #ifdef CONFIG_DRIVERS_NOTECTL
@@ -79,6 +82,9 @@
 #define NOTECTL_GETIRQFILTER        _NOTECTLIOC(0x05)
 #define NOTECTL_SETIRQFILTER        _NOTECTLIOC(0x06)
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+#define NOTECTL_SETSAMPLERATE       _NOTECTLIOC(0x07)
+#endif
 
 #endif
 
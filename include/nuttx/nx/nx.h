@@ -551,6 +551,35 @@ int nx_block(NXWINDOW hwnd, FAR void *arg);
 
 int nx_synch(NXWINDOW hwnd, FAR void *arg);
 
+/****************************************************************************
+ * Name: nx_beginbatch and nx_endbatch
+ *
+ * Description:
+ *   Between nx_beginbatch() and nx_endbatch(), the pixel, fill, trapezoid,
+ *   move and bitmap requests of all windows of the connection are
+ *   collected in a buffer and sent to the server with one message when
+ *   the buffer is full, when a request that is not a drawing command is
+ *   made, or at nx_endbatch().  A client can draw a whole frame with a
+ *   few server wakeups instead of one message per request.
+ *
+ *   Drawing may not be visible before nx_endbatch().  nx_bitmap() still
+ *   returns only when the bitmap has been copied, it submits the batch
+ *   and waits for it.  Calls may be nested, the batch is submitted by the
+ *   outermost nx_endbatch().
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nx_beginbatch(NXHANDLE handle);
+int nx_endbatch(NXHANDLE handle);
+#endif
+
 /****************************************************************************
  * Name: nx_requestbkgd
  *
@@ -33,6 +33,7 @@
 #include <stdbool.h>
 #include <mqueue.h>
 
+#include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/nx/nx.h>
 #include <nuttx/nx/nxcursor.h>
@@ -67,6 +68,14 @@
 #define NX_CLIMSG_PRIO 42
 #define NX_SVRMSG_PRIO 42
 
+/* Each command in a batch is preceded by its length in bytes and starts on
+ * a pointer aligned offset.
+ */
+
+#define NXMU_BATCH_HDRLEN    sizeof(uintptr_t)
+#define NXMU_BATCH_ALIGN(n)  (((n) + sizeof(uintptr_t) - 1) & \
+                              ~(sizeof(uintptr_t) - 1))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -82,6 +91,21 @@ enum nx_clistate_e
   NX_CLISTATE_DISCONNECT_PENDING, /* Waiting for server to acknowledge disconnect */
 };
 
+/* A buffer of drawing commands collected by a client, see nx_beginbatch().
+ * The buffer belongs to the server from the NX_SVRMSG_BATCH message until
+ * the server posts done.
+ */
+
+#ifdef CONFIG_NX_BATCH
+struct nxmu_batch_s
+{
+  sem_t done;             /* Posted when the server has executed the batch */
+  bool inflight;          /* Sent to the server, done not yet taken */
+  size_t nbytes;          /* Number of bytes used in buf[] */
+  uintptr_t buf[CONFIG_NX_BATCH_SIZE / sizeof(uintptr_t)];
+};
+#endif
+
 /* This structure represents a connection between the client and the server */
 
 struct nxmu_conn_s
@@ -99,6 +123,15 @@ struct nxmu_conn_s
   /* These are only usable on the server side of the connection */
 
   mqd_t swrmq;            /* MQ to write to the client */
+
+#ifdef CONFIG_NX_BATCH
+  /* Client side command batching */
+
+  mutex_t batchlock;      /* Protects the fields below */
+  uint8_t batchdepth;     /* Nesting level of nx_beginbatch() */
+  uint8_t batchcur;       /* Index of the batch being filled */
+  struct nxmu_batch_s batch[CONFIG_NX_BATCH_NBUFFERS];
+#endif
 };
 
 /* Message IDs **************************************************************/
@@ -144,7 +177,8 @@ enum nxmsg_e
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_BATCH             /* Execute a batch of drawing commands */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -522,6 +556,16 @@ struct nxsvrmsg_redrawreq_s
   struct nxgl_rect_s rect;         /* Describes the rectangular region to be redrawn */
 };
 
+/* Execute the drawing commands collected in a batch buffer */
+
+#ifdef CONFIG_NX_BATCH
+struct nxsvrmsg_batch_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_BATCH */
+  FAR struct nxmu_batch_s *batch;  /* The batch to be executed */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -584,6 +628,50 @@ int nxmu_start(int display, int plane);
 int nxmu_sendserver(FAR struct nxmu_conn_s *conn,
                     FAR const void *msg, size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_batch_send
+ *
+ * Description:
+ *  Add a message to the current batch of the connection if batching is
+ *  active and the message is a drawing command.  Otherwise submit the
+ *  commands collected so far, so that they execute before the message.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK if the message was batched; 1 if the caller must send the message
+ *   itself; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_batch_send(FAR struct nxmu_conn_s *conn,
+                    FAR const void *msg, size_t msglen);
+#endif
+
+/****************************************************************************
+ * Name: nxmu_batch_flush
+ *
+ * Description:
+ *  Submit the commands collected in the current batch of the connection
+ *  with a single NX_SVRMSG_BATCH message.
+ *
+ * Input Parameters:
+ *   conn - A pointer to the server connection structure
+ *   wait - Also wait until the server has executed all submitted batches
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_batch_flush(FAR struct nxmu_conn_s *conn, bool wait);
+#endif
+
 /****************************************************************************
  * Name: nxmu_sendwindow
  *
@@ -56,6 +56,14 @@
 #  error "Need extended definitions for CONFIG_PAGING_PAGESIZE"
 #endif
 
+/* CONFIG_PAGING_READAHEAD - The number of extra pages to fill after each
+ *   page fault.  Zero (the default) disables read-ahead.
+ */
+
+#ifndef CONFIG_PAGING_READAHEAD
+#  define CONFIG_PAGING_READAHEAD 0
+#endif
+
 /* Common page macros */
 
 #  define PAGESIZE                 (1 << PAGESHIFT)
@@ -450,6 +458,35 @@ int up_fillpage(FAR struct tcb_s *tcb, FAR void *vpage,
                 up_pgcallback_t pg_callback);
 #endif
 
+/****************************************************************************
+ * Name: up_readahead()
+ *
+ * Description:
+ *  Prepare the architecture-specific page fault information of ratcb so
+ *  that it describes a fault on the page following the one that tcb
+ *  faulted on.  ratcb is not a real task, it is only passed to
+ *  up_checkmapping(), up_allocpage() and up_fillpage() to read ahead the
+ *  pages that will probably be needed next.  tcb and ratcb may be the
+ *  same.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB holding the fault information to start from.
+ *   ratcb - The TCB receiving the fault information of the next page.
+ *
+ * Returned Value:
+ *   true if ratcb was set up; false if the next page is outside of the
+ *   paged region.
+ *
+ * Assumptions:
+ *   - This function is called from the normal tasking context (but with
+ *     interrupts disabled).
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_READAHEAD > 0
+bool up_readahead(FAR struct tcb_s *tcb, FAR struct tcb_s *ratcb);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
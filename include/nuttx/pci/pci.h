@@ -27,6 +27,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/list.h>
@@ -344,6 +345,11 @@ struct pci_ops_s
 
   CODE int (*connect_irq)(FAR struct pci_bus_s *bus, FAR int *irq,
                           int num, FAR uintptr_t *mar, FAR uint32_t *mdr);
+
+  /* Get the MSI/MSI-X message that delivers an interrupt to a given CPU */
+
+  CODE int (*affinity_irq)(FAR struct pci_bus_s *bus, int irq, int cpu,
+                           FAR uintptr_t *mar, FAR uint32_t *mdr);
 };
 
 /* Each pci channel is a top-level PCI bus seem by CPU.  A machine with
@@ -834,6 +840,45 @@ void pci_release_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
 int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
+/****************************************************************************
+ * Name: pci_affinity_irq
+ *
+ * Description:
+ *   Deliver a connected MSI-X vector to a given CPU.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - MSI-X table entry of the vector
+ *   irq   - interrupt connected to the entry
+ *   cpu   - destination CPU
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_affinity_irq(FAR struct pci_device_s *dev, int index, int irq,
+                     int cpu);
+
+/****************************************************************************
+ * Name: pci_mask_irq
+ *
+ * Description:
+ *   Mask or unmask a single MSI-X vector.  While masked the device only
+ *   records the pending message, which is sent on unmask.
+ *
+ * Input Parameters:
+ *   dev   - PCI device
+ *   index - MSI-X table entry of the vector
+ *   mask  - true to mask the vector, false to unmask it
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_mask_irq(FAR struct pci_device_s *dev, int index, bool mask);
+
 /****************************************************************************
  * Name: pci_enable_irq
  *
@@ -61,6 +61,7 @@
 #include <nuttx/wdog.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifdef CONFIG_PM
@@ -386,6 +387,23 @@ struct pm_wakelock_s
 #endif
 };
 
+/* A wakeup latency constraint of a driver, see pm_qos_add() */
+
+struct pm_qos_s
+{
+  struct dq_entry_s node;
+  int domain;
+  uint32_t latency;   /* The longest acceptable wakeup latency in us */
+};
+
+/* The cost of one power state, as used by the menu governor */
+
+struct pm_idlestate_s
+{
+  uint32_t latency;   /* Time to resume from the state in us */
+  uint32_t residency; /* Shortest idle time saving power in the state, us */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -463,6 +481,38 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_menu_governor_initialize
+ *
+ * Description:
+ *   Return the menu governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_menu_governor_initialize(void);
+
+/****************************************************************************
+ * Name: pm_menu_governor_setstates
+ *
+ * Description:
+ *   Replace the exit latency and target residency of the power states of a
+ *   domain, which default to the CONFIG_PM_GOVERNOR_MENU_* values.
+ *
+ * Input Parameters:
+ *   domain - The PM domain
+ *   states - PM_COUNT entries indexed by the power state, the PM_NORMAL
+ *            one is ignored.  The table must stay valid while it is used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PM_GOVERNOR_MENU
+void pm_menu_governor_setstates(int domain,
+                                FAR const struct pm_idlestate_s *states);
+#endif
+
 /****************************************************************************
  * Name: pm_set_governor
  *
@@ -894,6 +944,69 @@ void pm_auto_updatestate(int domain);
 
 void pm_idle(pm_idle_handler_t handler);
 
+#ifdef CONFIG_PM_QOS
+
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Declare the longest wakeup latency a driver can accept in a domain.
+ *   The governors aware of exit latencies keep the domain out of the power
+ *   states that resume slower than the tightest of these constraints.
+ *
+ * Input Parameters:
+ *   qos     - The constraint, owned by the caller until pm_qos_remove()
+ *   domain  - The PM domain
+ *   latency - The latency in microseconds
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+int pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a constraint added with pm_qos_add().
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Drop a constraint added with pm_qos_add().
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos);
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the tightest latency constraint of a domain in microseconds, or
+ *   UINT32_MAX if there is none.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain);
+
+#else
+#  define pm_qos_add(qos,domain,latency)      (0)
+#  define pm_qos_update(qos,latency)
+#  define pm_qos_remove(qos)
+#  define pm_qos_latency(domain)              UINT32_MAX
+#endif
+
 /****************************************************************************
  * Name: pm_idle_unlock
  *
@@ -983,6 +1096,10 @@ bool pm_idle_lock(int cpu);
 #  define pm_idle(handler)
 #  define pm_idle_unlock()
 #  define pm_idle_lock(cpu)                   (0)
+#  define pm_qos_add(qos,domain,latency)      (0)
+#  define pm_qos_update(qos,latency)
+#  define pm_qos_remove(qos)
+#  define pm_qos_latency(domain)              UINT32_MAX
 
 #endif /* CONFIG_PM */
 #endif /* __INCLUDE_NUTTX_POWER_PM_H */
@@ -0,0 +1,157 @@
+/****************************************************************************
+ * include/nuttx/rbtree.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RBTREE_H
+#define __INCLUDE_NUTTX_RBTREE_H
+
+/* An intrusive red-black tree.  The node is embedded in the caller's
+ * structure and the caller does the descent to find the insertion point,
+ * so the tree knows nothing of keys and never allocates:
+ *
+ *   link = &root->rb_node;
+ *   while (*link != NULL)
+ *     {
+ *       parent = *link;
+ *       link = key < rb_entry(parent, ..)->key ?
+ *              &parent->rb_left : &parent->rb_right;
+ *     }
+ *
+ *   rb_link_node(&item->node, parent, link);
+ *   rb_insert_color(root, &item->node);
+ *
+ * The augmented variants keep a value computed from each node's subtree,
+ * like the largest end address of interval_tree.h, up to date.  The
+ * callback recomputes it for one node from the node and its children.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/nuttx.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RB_RED                  0
+#define RB_BLACK                1
+
+#define RB_ROOT_INITIALIZER     { NULL }
+
+#define rb_entry(ptr, type, member) container_of(ptr, type, member)
+#define rb_empty(root)          ((root)->rb_node == NULL)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct rb_node_s
+{
+  FAR struct rb_node_s *rb_parent;
+  FAR struct rb_node_s *rb_left;
+  FAR struct rb_node_s *rb_right;
+  uint8_t               rb_color;
+};
+
+struct rb_root_s
+{
+  FAR struct rb_node_s *rb_node;
+};
+
+/* Recompute the augmented value of node from its children */
+
+typedef CODE void (*rb_augment_t)(FAR struct rb_node_s *node);
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+static inline void rb_init(FAR struct rb_root_s *root)
+{
+  root->rb_node = NULL;
+}
+
+/* Attach a new leaf node at link, a child pointer of parent found by the
+ * caller's descent, before rebalancing with rb_insert_color().
+ */
+
+static inline void rb_link_node(FAR struct rb_node_s *node,
+                                FAR struct rb_node_s *parent,
+                                FAR struct rb_node_s **link)
+{
+  node->rb_parent = parent;
+  node->rb_left   = NULL;
+  node->rb_right  = NULL;
+  node->rb_color  = RB_RED;
+  *link           = node;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Rebalance after rb_link_node() and remove a node, O(log n) */
+
+void rb_insert_color(FAR struct rb_root_s *root, FAR struct rb_node_s *node);
+void rb_erase(FAR struct rb_root_s *root, FAR struct rb_node_s *node);
+
+/* The same for a tree with an augmented value */
+
+void rb_insert_augmented(FAR struct rb_root_s *root,
+                         FAR struct rb_node_s *node, rb_augment_t update);
+void rb_erase_augmented(FAR struct rb_root_s *root,
+                        FAR struct rb_node_s *node, rb_augment_t update);
+
+/* Recompute the augmented value from node up to the root, after a change
+ * of the node's own contribution.
+ */
+
+void rb_augment_propagate(FAR struct rb_node_s *node, rb_augment_t update);
+
+/* In-order traversal, NULL at either end */
+
+FAR struct rb_node_s *rb_first(FAR const struct rb_root_s *root);
+FAR struct rb_node_s *rb_last(FAR const struct rb_root_s *root);
+FAR struct rb_node_s *rb_next(FAR const struct rb_node_s *node);
+FAR struct rb_node_s *rb_prev(FAR const struct rb_node_s *node);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_RBTREE_H */
@@ -63,6 +63,10 @@ typedef CODE int (*write_t)(FAR struct regmap_bus_s *bus,
 
 typedef CODE void (*exit_t)(FAR struct regmap_bus_s *bus);
 
+/* Return true for a register that must not be cached. */
+
+typedef CODE bool (*volatile_reg_t)(unsigned int reg);
+
 /* Description of a hardware bus for the register map infrastructure. */
 
 struct regmap_bus_s
@@ -100,6 +104,20 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+  /* Highest register address kept in the register cache.  The cache is
+   * disabled if this is zero.  Reads of cached registers are served
+   * without a bus transaction, writes go through to the device unless
+   * regmap_cache_only() is enabled.
+   */
+
+  unsigned int max_register;
+
+  /* Optional.  Registers the device changes by itself (status, data,
+   * FIFO) are never cached.  All registers are cacheable if NULL.
+   */
+
+  volatile_reg_t volatile_reg;
 };
 
 struct regmap_s;
@@ -312,6 +330,76 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write the bits of mask in a register.  With the cache, the
+ *   read costs no bus transaction and the write is skipped if the value
+ *   does not change.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - bits to be updated.
+ *   val  - new value of the bits in mask.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+/****************************************************************************
+ * Name: regmap_cache_only
+ *
+ * Description:
+ *   While enabled, writes of cacheable registers only update the cache and
+ *   are sent by regmap_cache_sync().  This combines the configuration
+ *   writes of a driver into a few burst transfers.
+ *
+ * Input Parameters:
+ *   map    - regmap handler, from regmap bus init function return.
+ *   enable - true to defer writes, false to write through again.
+ *
+ ****************************************************************************/
+
+void regmap_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regmap_cache_sync
+ *
+ * Description:
+ *   Write all dirty registers of the cache to the device.  Runs of
+ *   consecutive registers are combined into one bulk write if the bus
+ *   supports it.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_cache_sync(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regmap_cache_invalidate
+ *
+ * Description:
+ *   Forget all cached values, e.g. after a reset of the device.  Dirty
+ *   registers are dropped.
+ *
+ * Input Parameters:
+ *   map - regmap handler, from regmap bus init function return.
+ *
+ ****************************************************************************/
+
+void regmap_cache_invalidate(FAR struct regmap_s *map);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -81,6 +81,8 @@ struct rpmsg_timestamp_s
  * wait: wait sem.
  * post: post sem.
  * get_cpuname: get cpu name.
+ * batch: open (begin = true) or close a batch of sends, nestable; the
+ *        remote is notified once when the outermost batch is closed.
  */
 
 struct rpmsg_ops_s
@@ -92,6 +94,7 @@ struct rpmsg_ops_s
   CODE void (*dump)(FAR struct rpmsg_s *rpmsg);
   CODE int (*get_timestamp)(FAR struct rpmsg_s *rpmsg, FAR const void *data,
                             FAR struct rpmsg_timestamp_s *ts);
+  CODE void (*batch)(FAR struct rpmsg_s *rpmsg, bool begin);
 };
 
 CODE typedef void (*rpmsg_dev_cb_t)(FAR struct rpmsg_device *rdev,
@@ -124,6 +127,15 @@ int rpmsg_get_signals(FAR struct rpmsg_device *rdev);
 int rpmsg_get_timestamp(FAR struct rpmsg_device *rdev, FAR const void *data,
                         FAR struct rpmsg_timestamp_s *ts);
 
+/* Messages sent on the device of ept between rpmsg_batch_begin() and
+ * rpmsg_batch_end() are announced to the remote with a single
+ * notification.  Batches nest and are shared by all senders on the device,
+ * so keep them short.  Transports without support just notify per send.
+ */
+
+void rpmsg_batch_begin(FAR struct rpmsg_endpoint *ept);
+void rpmsg_batch_end(FAR struct rpmsg_endpoint *ept);
+
 static inline_function bool rpmsg_is_running(FAR struct rpmsg_device *rdev)
 {
   return rpmsg_get_signals(rdev) & RPMSG_SIGNAL_RUNNING;
@@ -45,6 +45,9 @@
 #include <nuttx/event.h>
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
+#ifdef CONFIG_HRTIMER
+#  include <nuttx/hrtimer.h>
+#endif
 #include <nuttx/fs/fs.h>
 #include <nuttx/mm/map.h>
 #include <nuttx/tls.h>
@@ -98,6 +101,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 5)                      /* Bit 5: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 6)                      /* Bit 6: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 7)                      /* Bit 7: In a system call */
@@ -347,6 +351,26 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+/* struct deadline_s ********************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/* The SCHED_DEADLINE state is private to the scheduler.  Like the sporadic
+ * plug-in, it is only allocated for threads using that policy.
+ */
+
+struct deadline_s;
+
+#endif /* CONFIG_SCHED_DEADLINE */
+
+/* The counters attached to a thread through /dev/perf */
+
+struct perf_group_s;
+
+/* The poll setups cached by select(), see fs/vfs/fs_select.c */
+
+struct select_cache_s;
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -408,6 +432,64 @@ struct stackinfo_s
                                          /* from the stack.                  */
 };
 
+/* struct critmon_holder_s **************************************************/
+
+/* Used to rank the code locations holding the critical section */
+
+#if CONFIG_SCHED_CRITMONITOR_HOLDERS > 0
+struct critmon_holder_s
+{
+  FAR void *caller;                      /* Caller entering the section     */
+  clock_t   max;                         /* Max holding time                */
+  clock_t   total;                       /* Total holding time              */
+  uint32_t  count;                       /* Number of holding intervals     */
+};
+#endif
+
+/* struct pressure_s ********************************************************/
+
+/* Pressure stall information of one state, see nxsched_get_pressure() */
+
+#ifdef CONFIG_SCHED_PRESSURE
+enum pressure_state_e
+{
+  PRESSURE_CPU_SOME = 0,                 /* Some task ready but not running */
+  PRESSURE_IO_SOME,                      /* Some task blocked on I/O        */
+  PRESSURE_IO_FULL,                      /* I/O stall with all CPUs idle    */
+  PRESSURE_NSTATES
+};
+
+struct pressure_s
+{
+  uint32_t avg10;                        /* 10s stall share, 1/100 percent  */
+  uint32_t avg60;                        /* 60s stall share, 1/100 percent  */
+  uint32_t avg300;                       /* 300s stall share, 1/100 percent */
+  uint64_t total;                        /* Total stall time in us          */
+};
+#endif
+
+/* struct critmon_wakeup_s **************************************************/
+
+/* The longest wakeup-to-run latency and what held the CPU meanwhile.  The
+ * latency histograms have log2 buckets of <1us, <2us, ... <16ms, >=16ms,
+ * the per-priority ones cover bands of 32 priorities.
+ */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+#define CRITMON_WAKEUP_NBUCKETS 16
+#define CRITMON_WAKEUP_NBANDS   8
+
+struct critmon_wakeup_s
+{
+  clock_t   latency;                     /* Wakeup to run latency           */
+  pid_t     pid;                         /* The thread woken up             */
+  uint8_t   priority;                    /* Its priority                    */
+  pid_t     holder;                      /* Thread that ran until it ran    */
+  FAR void *csection;                    /* Last csection of the holder     */
+  FAR void *preemption;                  /* Last sched_lock of the holder   */
+};
+#endif
+
 /* struct task_join_s *******************************************************/
 
 /* Used to save task join information */
@@ -551,6 +633,16 @@ struct task_group_s
 
   struct mm_map_s tg_mm_map;        /* Task group virtual memory mappings   */
 
+#ifdef CONFIG_SCHED_PRESSURE
+  /* Pressure stall information *********************************************/
+
+  clock_t  tg_cpustall;             /* Ticks with a member ready to run     */
+  clock_t  tg_cpustamp;             /* Last sample charged to tg_cpustall   */
+  clock_t  tg_iostall;              /* Ticks with a member blocked on I/O   */
+  clock_t  tg_iostart;              /* Start of the current I/O stall       */
+  uint16_t tg_niowait;              /* Number of members blocked on I/O     */
+#endif
+
   spinlock_t tg_lock;               /* SpinLock for group */
   rmutex_t   tg_mutex;              /* Mutex for group */
 };
@@ -631,8 +723,21 @@ struct tcb_s
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  FAR struct deadline_s *deadline;       /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_HRTIMER
+  hrtimer_t waithrtimer;                 /* Timer of sub-tick timed waits   */
+#endif
+#ifdef CONFIG_SCHED_LAZYFPU
+  uint8_t  fpu_count;                    /* Recent slices using the FPU     */
+  uint8_t  fpu_cpu;                      /* 1 + CPU last loaded on, 0: none */
+#endif
+#ifdef CONFIG_TIMER_SLACK
+  uint32_t timer_slack;                  /* Slack of timed waits (nsec)     */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -701,6 +806,25 @@ struct tcb_s
   void   *crit_max_caller;               /* Caller of max critical section  */
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+  clock_t wakeup_start;                  /* Time when thread was woken up   */
+  clock_t wakeup_max;                    /* Max wakeup to run latency       */
+
+  /* Histogram of the wakeup to run latencies */
+
+  uint32_t wakeup_hist[CRITMON_WAKEUP_NBUCKETS];
+#endif
+
+  /* Performance counter support ********************************************/
+
+#ifdef CONFIG_DEV_PERF
+  FAR struct perf_group_s *perf;         /* Counters attached by /dev/perf  */
+#endif
+
+#ifdef CONFIG_FS_SELECT_CACHE
+  FAR struct select_cache_s *selcache;   /* Poll setups of last select()    */
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0
   clock_t busywait_start;                /* Time when thread busywait       */
   clock_t busywait_max;                  /* Max time of busywait            */
@@ -829,11 +953,33 @@ EXTERN clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+/* Code locations holding the critical section the longest. */
+
+#if CONFIG_SCHED_CRITMONITOR_HOLDERS > 0
+EXTERN struct critmon_holder_s
+       g_crit_holders[CONFIG_SCHED_CRITMONITOR_HOLDERS];
+#endif
+
+/* Wakeup-to-run latency by priority band and the worst wakeup. */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+EXTERN uint32_t
+       g_wakeup_hist[CRITMON_WAKEUP_NBANDS][CRITMON_WAKEUP_NBUCKETS];
+EXTERN struct critmon_wakeup_s g_wakeup_worst;
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0
 EXTERN clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0 */
 
+/* Per-CPU counters of the tasks moved between CPUs. */
+
+#ifdef CONFIG_SCHED_SMP_BALANCE
+EXTERN uint32_t g_migrate_in[CONFIG_SMP_NCPUS];
+EXTERN uint32_t g_migrate_out[CONFIG_SMP_NCPUS];
+#endif /* CONFIG_SCHED_SMP_BALANCE */
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -1562,6 +1708,73 @@ void nxsched_dumponexit(void);
 #  define nxsched_dumponexit()
 #endif /* CONFIG_SCHED_DUMP_ON_EXIT */
 
+/****************************************************************************
+ * Name: nxsched_iowait_enter and nxsched_iowait_leave
+ *
+ * Description:
+ *   Bracket an access to a block device that the calling thread waits
+ *   for.  The time spent in between is accounted as I/O pressure of the
+ *   system and of the task group of the caller.  The calls may nest.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRESSURE
+void nxsched_iowait_enter(void);
+void nxsched_iowait_leave(void);
+#else
+#  define nxsched_iowait_enter()
+#  define nxsched_iowait_leave()
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+/****************************************************************************
+ * Name: nxsched_get_pressure
+ *
+ * Description:
+ *   Return the system wide pressure stall information of one state.
+ *
+ * Input Parameters:
+ *   state    - One of enum pressure_state_e
+ *   pressure - The location to return the information
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the state is not valid.
+ *
+ ****************************************************************************/
+
+int nxsched_get_pressure(int state, FAR struct pressure_s *pressure);
+
+/****************************************************************************
+ * Name: nxsched_get_grouppressure
+ *
+ * Description:
+ *   Return the total time in microseconds that at least one member of a
+ *   task group was ready to run but not running (cpu) or blocked on I/O
+ *   (io).
+ *
+ ****************************************************************************/
+
+void nxsched_get_grouppressure(FAR struct task_group_s *group,
+                               FAR uint64_t *cpu, FAR uint64_t *io);
+
+/****************************************************************************
+ * Name: nxsched_notify_pressure
+ *
+ * Description:
+ *   Called on every pressure sample with the total stall time of each
+ *   state in microseconds, fires the triggers of /proc/pressure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
+void nxsched_notify_pressure(FAR const uint64_t *total);
+#else
+static inline void nxsched_notify_pressure(FAR const uint64_t *total)
+{
+}
+#endif
+#endif /* CONFIG_SCHED_PRESSURE */
+
 #ifdef CONFIG_SMP
 /****************************************************************************
  * Name: nxsched_smp_call_handler
@@ -273,6 +273,7 @@ enum note_type_e
   NOTE_DUMP_MARK,
   NOTE_DUMP_BINARY,
   NOTE_DUMP_COUNTER,
+  NOTE_SAMPLE,
 
   /* Always last */
 
@@ -468,6 +469,19 @@ struct note_heap_s
   size_t used;
 };
 
+/* This is the specific form of the NOTE_SAMPLE note.  The return
+ * addresses are stored innermost first.
+ */
+
+struct note_sample_s
+{
+  struct note_common_s nsm_cmn;      /* Common note parameters */
+  uintptr_t nsm_pc[1];               /* Backtrace of the sampled thread */
+};
+
+#define SIZEOF_NOTE_SAMPLE(n) (sizeof(struct note_sample_s) + \
+                               ((n) - 1) * sizeof(uintptr_t))
+
 struct note_printf_s
 {
   struct note_common_s npt_cmn; /* Common note parameters */
@@ -669,6 +683,14 @@ void sched_note_heap(uint8_t event, FAR void *heap, FAR void *mem,
 #  define sched_note_heap(e,h,m,s,c)
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SAMPLE
+void sched_note_sample(void);
+int sched_note_sample_rate(unsigned int rate);
+#else
+#  define sched_note_sample()
+#  define sched_note_sample_rate(r) (-ENOSYS)
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
 void sched_note_event_ip(uint32_t tag, uintptr_t ip, uint8_t event,
                          FAR const void *buf, size_t len);
@@ -352,6 +352,28 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
 
 int nxsem_tickwait(FAR sem_t *sem, uint32_t delay);
 
+/****************************************************************************
+ * Name: nxsem_nsecwait
+ *
+ * Description:
+ *   This function is the same as nxsem_tickwait(), except that the delay
+ *   is in nanoseconds and is kept by the high resolution timer.
+ *
+ * Input Parameters:
+ *   sem     - Semaphore object
+ *   delay   - Nanoseconds to wait until the semaphore is posted.  If delay
+ *             is zero, then this function is equivalent to sem_trywait().
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned
+ *   on failure; -ETIMEDOUT is returned on the timeout condition.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+int nxsem_nsecwait(FAR sem_t *sem, uint64_t delay);
+#endif
+
 /****************************************************************************
  * Name: nxsem_post / nxsem_post_slow
  *
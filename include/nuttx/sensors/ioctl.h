@@ -509,6 +509,16 @@
 
 #define SNIOC_SET_NONWAKEUP           _SNIOC(0x00A9)
 
+/* Command:      SNIOC_SET_READPOS
+ * Description:  Tell the upper half how far a subscriber that maps the
+ *               event buffer has read, so that poll() only reports newer
+ *               events (CONFIG_SENSORS_MMAP).
+ * Argument:     The index of the next unread event (uint32_t), in the
+ *               same space as sensor_mmap_s.head.
+ */
+
+#define SNIOC_SET_READPOS             _SNIOC(0x00AA)
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
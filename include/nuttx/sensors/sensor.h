@@ -641,6 +641,24 @@ struct sensor_lowerhalf_s
   bool persist;
 };
 
+/* This structure describes one topic of a sensor group.  The topic events
+ * start with a uint64_t timestamp, as every uORB topic does; the nfloat
+ * float fields that follow it are linearly interpolated to the bundle
+ * timestamp, the other fields are taken from the nearer sample.
+ *
+ * A bundle is the uint64_t bundle timestamp followed by one event of every
+ * topic in order, each one starting at an 8 bytes aligned offset.
+ */
+
+struct sensor_group_topic_s
+{
+  FAR const char *path;        /* The path of topic, ex: /dev/uorb/xxx */
+  size_t          esize;       /* The element size of topic */
+  uint8_t         nfloat;      /* The number of float fields to interpolate */
+};
+
+struct sensor_group_s;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -865,6 +883,51 @@ int sensor_monitor_initialize(void);
 int sensor_monitor_level(FAR const char *name);
 #endif
 
+/****************************************************************************
+ * Name: sensor_group_register
+ *
+ * Description:
+ *   This function registers a topic that subscribes to several topics and
+ *   publishes their samples aligned to one timestamp as a single bundle,
+ *   so that a fusion application wakes up once per bundle. The topics are
+ *   only subscribed while the bundle topic has subscribers, and the bundle
+ *   interval follows SNIOC_SET_INTERVAL of its subscribers. This API
+ *   corresponds to the sensor_group_unregister.
+ *
+ * Input Parameters:
+ *   path     - The path of the bundle topic, ex: /dev/uorb/xxx.
+ *   topics   - The topics to bundle, in bundle order.
+ *   ntopics  - The number of topics.
+ *   interval - The default bundle interval, in us.
+ *
+ * Returned Value:
+ *   The group handle on success, NULL on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_GROUP
+FAR struct sensor_group_s *
+sensor_group_register(FAR const char *path,
+                      FAR const struct sensor_group_topic_s *topics,
+                      int ntopics, uint32_t interval);
+#endif
+
+/****************************************************************************
+ * Name: sensor_group_unregister
+ *
+ * Description:
+ *   This function unregisters the bundle topic and releases the group.
+ *   This API corresponds to the sensor_group_register.
+ *
+ * Input Parameters:
+ *   group - The group handle returned by sensor_group_register.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SENSORS_GROUP
+void sensor_group_unregister(FAR struct sensor_group_s *group);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
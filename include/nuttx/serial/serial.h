@@ -37,6 +37,9 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+#  include <nuttx/wdog.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -367,6 +370,9 @@ struct uart_dev_s
 #ifdef CONFIG_SERIAL_RXDMA
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
 #endif
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+  struct wdog_s         rxidle;      /* Wakes readers below the watermark */
+#endif
 
   /* Driver interface */
 
@@ -546,6 +552,20 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_idle
+ *
+ * Description:
+ *  Called by the lower half on RX idle-line detection, after the received
+ *  bytes have been accounted for by uart_recvchars_done().  Wakes up any
+ *  readers waiting for data still below CONFIG_SERIAL_RXDMA_WATERMARK.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA_IDLE
+void uart_recvchars_idle(FAR uart_dev_t *dev);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 #include <nuttx/spi/spi.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
@@ -114,6 +115,32 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_QUEUE
+/* This describes one message queued with spi_queue_submit().  The message
+ * and its sequence belong to the queue until the callback is called.
+ *
+ * Messages are served by decreasing priority and in submission order
+ * within one priority, one whole sequence at a time.  A short, high
+ * priority message (e.g. a periodic sensor read) waits at most for the
+ * sequence in progress, not for all the messages queued before it.
+ */
+
+struct spi_message_s
+{
+  sq_entry_t flink;                 /* Used internally by the queue */
+  FAR struct spi_sequence_s *seq;   /* The transfers to perform */
+  uint8_t priority;                 /* Higher values are served first */
+  int result;                       /* Result of spi_transfer() */
+
+  /* Called from the queue thread when the sequence is done */
+
+  CODE void (*callback)(FAR struct spi_message_s *msg, FAR void *arg);
+  FAR void *arg;                    /* Argument of the callback */
+};
+
+struct spi_queue_s;
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -163,6 +190,81 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+#ifdef CONFIG_SPI_QUEUE
+
+/****************************************************************************
+ * Name: spi_queue_initialize
+ *
+ * Description:
+ *   Create a message queue for an SPI bus and the kernel thread that
+ *   serves it.  There should be one queue per bus, shared by all devices
+ *   on the bus.  Drivers that use the bus directly keep working, the
+ *   queue thread takes the bus with SPI_LOCK() like them.
+ *
+ * Input Parameters:
+ *   spi - An instance of the lower half SPI driver
+ *
+ * Returned Value:
+ *   The new queue on success; NULL on failure.
+ *
+ ****************************************************************************/
+
+FAR struct spi_queue_s *spi_queue_initialize(FAR struct spi_dev_s *spi);
+
+/****************************************************************************
+ * Name: spi_queue_submit
+ *
+ * Description:
+ *   Queue a message for asynchronous transfer.  msg->seq, msg->priority
+ *   and msg->callback must be set.  This function does not block and may
+ *   be called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   queue - The queue of the bus
+ *   msg   - The message to transfer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_submit(FAR struct spi_queue_s *queue,
+                     FAR struct spi_message_s *msg);
+
+/****************************************************************************
+ * Name: spi_queue_cancel
+ *
+ * Description:
+ *   Remove a message that has not been started yet from the queue.  The
+ *   callback of a cancelled message is not called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was removed; -EBUSY if it is in progress or
+ *   done.
+ *
+ ****************************************************************************/
+
+int spi_queue_cancel(FAR struct spi_queue_s *queue,
+                     FAR struct spi_message_s *msg);
+
+/****************************************************************************
+ * Name: spi_queue_transfer
+ *
+ * Description:
+ *   Queue a sequence with the given priority and wait for it.  This is a
+ *   drop-in replacement of spi_transfer() for drivers sharing a queued
+ *   bus.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_queue_transfer(FAR struct spi_queue_s *queue,
+                       FAR struct spi_sequence_s *seq, uint8_t priority);
+
+#endif /* CONFIG_SPI_QUEUE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -72,6 +72,31 @@ void nxsched_critmon_busywait(bool state, FAR void *caller);
 #  define nxsched_critmon_busywait(state, caller)
 #endif
 
+/* Lock contention statistics are collected by the kernel only */
+
+#if defined(CONFIG_SPINLOCK_STATISTICS) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+void spin_stat_locked(FAR volatile spinlock_t *lock, clock_t start,
+                      bool contended);
+void spin_stat_unlock(FAR volatile spinlock_t *lock);
+#  define spin_stat_start()  up_perf_gettime()
+#else
+#  undef CONFIG_SPINLOCK_STATISTICS
+#  define spin_stat_locked(lock, start, contended)
+#  define spin_stat_unlock(lock)
+#  define spin_stat_start()  0
+#endif
+
+/* spin_unlock() can only be a plain store of SP_UNLOCKED when releasing
+ * the lock needs neither an atomic operation nor instrumentation.
+ */
+
+#if defined(CONFIG_ARCH_HAVE_TESTSET) || defined(CONFIG_TICKET_SPINLOCK) || \
+    defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) || \
+    defined(CONFIG_SPINLOCK_STATISTICS)
+#  define __SP_UNLOCK_FUNCTION 1
+#endif
+
 /****************************************************************************
  * Public Data Types
  ****************************************************************************/
@@ -182,6 +207,10 @@ static inline_function void rspin_lock_init(FAR rspinlock_t *lock)
 #ifdef CONFIG_SPINLOCK
 static inline_function void spin_lock_notrace(FAR volatile spinlock_t *lock)
 {
+#ifdef CONFIG_SPINLOCK_STATISTICS
+  clock_t start = spin_stat_start();
+  bool contended = false;
+#endif
 #ifdef CONFIG_TICKET_SPINLOCK
   int ticket = atomic_fetch_add(&lock->next, 1);
   while (atomic_read(&lock->owner) != ticket)
@@ -189,11 +218,15 @@ static inline_function void spin_lock_notrace(FAR volatile spinlock_t *lock)
   while (up_testset(lock) == SP_LOCKED)
 #endif
     {
+#ifdef CONFIG_SPINLOCK_STATISTICS
+      contended = true;
+#endif
       UP_DSB();
       UP_WFE();
     }
 
   UP_DMB();
+  spin_stat_locked(lock, start, contended);
 }
 #else
 #  define spin_lock_notrace(lock)
@@ -287,6 +320,7 @@ spin_trylock_notrace(FAR volatile spinlock_t *lock)
     }
 
   UP_DMB();
+  spin_stat_locked(lock, spin_stat_start(), false);
   return true;
 }
 #endif /* CONFIG_SPINLOCK */
@@ -363,6 +397,7 @@ static inline_function bool spin_trylock(FAR volatile spinlock_t *lock)
 static inline_function void
 spin_unlock_notrace(FAR volatile spinlock_t *lock)
 {
+  spin_stat_unlock(lock);
   UP_DMB();
 #ifdef CONFIG_TICKET_SPINLOCK
   atomic_fetch_add(&lock->owner, 1);
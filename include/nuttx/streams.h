@@ -820,6 +820,18 @@ int lib_sprintf(FAR struct lib_outstream_s *stream,
 int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
                  FAR const void *buf);
 
+/****************************************************************************
+ * Name: lib_vbspack
+ *
+ * Description:
+ *  Pack the arguments of a format into a buffer in the layout expected by
+ *  lib_bsprintf(), to format the message later.
+ *
+ ****************************************************************************/
+
+size_t lib_vbspack(FAR void *buf, size_t size, FAR const IPTR char *fmt,
+                   va_list ap);
+
 /****************************************************************************
  * Name: lib_sprintf_internal
  *
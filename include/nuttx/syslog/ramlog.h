@@ -41,6 +41,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/syslog/syslog.h>
 
 #ifdef CONFIG_RAMLOG
@@ -75,12 +78,51 @@
 #  define CONFIG_RAMLOG_BUFSIZE 1024
 #endif
 
+/* Zero-copy reading (CONFIG_RAMLOG_MMAP) ***********************************/
+
+/* mmap() maps the whole RAM log read-only into the reader, then the byte at
+ * the free running position 'pos' of the log is at
+ * base + offset + pos % size, see struct ramlog_cursor_s.  The read
+ * position of the file descriptor is shared with read().
+ *
+ * RAMLOGIOC_GETCURSOR - Get the cursor of this file descriptor.  A read
+ *   position that was overrun by the writer is first moved to the oldest
+ *   byte still in the log.
+ *   Argument: FAR struct ramlog_cursor_s *
+ * RAMLOGIOC_ADVANCE - Consume bytes from the read position without copying
+ *   them.  Returns the number of the consumed bytes that were overwritten
+ *   by the writer while being consumed (zero normally), or -EINVAL if
+ *   there are fewer bytes in the log.
+ *   Argument: uint32_t, the number of bytes consumed
+ *
+ * poll() keeps reporting POLLIN once PIPEIOC_POLLINTHRD bytes are pending,
+ * so a mapped reader can batch its wakeups.
+ */
+
+#define RAMLOGIOC_GETCURSOR _SYSLOGIOC(0x0005)
+#define RAMLOGIOC_ADVANCE   _SYSLOGIOC(0x0006)
+
 /****************************************************************************
- * Public Data
+ * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* The argument of RAMLOGIOC_GETCURSOR */
+
+struct ramlog_cursor_s
+{
+  uint32_t offset;  /* Offset of the ring in the mapping */
+  uint32_t size;    /* Size of the ring in bytes */
+  uint32_t head;    /* Position after the newest byte */
+  uint32_t tail;    /* Position of the oldest unread byte */
+  uint32_t lost;    /* Bytes overrun since the last call */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -150,6 +192,22 @@ ssize_t ramlog_write(FAR syslog_channel_t *channel,
                      FAR const char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: ramlog_vsyslog
+ *
+ * Description:
+ *   Record a syslog message in the syslog RAM log as its format string
+ *   pointer and raw arguments, to be formatted when the log is read.
+ *   nx_vsyslog() uses this instead of formatting the message when
+ *   CONFIG_RAMLOG_DEFERRED is enabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_DEFERRED
+int ramlog_vsyslog(int priority, FAR const IPTR char *fmt,
+                   FAR va_list *ap);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -1260,6 +1260,22 @@ struct sensor_ustate_s
   uint32_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is the head of the event buffer that a subscriber maps
+ * with mmap() (CONFIG_SENSORS_MMAP).  nbuffer events of esize bytes follow
+ * it and event n lives at slot n % nbuffer.  head is the number of events
+ * published so far.  begin is moved ahead before events are overwritten,
+ * so an event n that has been copied out is only valid if begin - n is
+ * still no more than nbuffer after the copy.
+ */
+
+struct sensor_mmap_s
+{
+  volatile uint32_t head;      /* The number of events published */
+  volatile uint32_t begin;     /* head plus the events being written */
+  uint32_t esize;              /* The element size of circular buffer */
+  uint32_t nbuffer;            /* The number of events in circular buffer */
+};
+
 /* This structure describes the context custom ioctl for device */
 
 struct sensor_ioctl_s
@@ -33,6 +33,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include <nuttx/queue.h>
 #include <nuttx/usb/pl2303.h>
 #include <nuttx/usb/cdcacm.h>
 #include <nuttx/usb/usbmsc.h>
@@ -387,6 +388,29 @@ struct usbdevclass_driver_s
   uint8_t speed;                  /* Highest speed that the driver handles */
 };
 
+/* A pool of requests with buffers for one endpoint.  Class drivers keep
+ * several bulk requests in flight with it so that the DCD always has a
+ * buffer queued while the previous one is being processed.  The priv
+ * field of every request points to its usbdev_poolreq_s container, which
+ * the class driver may link into its own queues while it owns the
+ * request.
+ */
+
+struct usbdev_poolreq_s
+{
+  sq_entry_t               flink;  /* Supports a singly linked list */
+  FAR struct usbdev_req_s *req;    /* The contained request */
+};
+
+struct usbdev_reqpool_s
+{
+  FAR struct usbdev_ep_s      *ep;     /* The endpoint of the requests */
+  FAR struct usbdev_poolreq_s *reqs;   /* Array of nreqs containers */
+  sq_queue_t                   freeq;  /* Requests not owned by anyone */
+  uint16_t                     nreqs;  /* Number of requests in the pool */
+  uint16_t                     nfree;  /* Number of requests in freeq */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -426,6 +450,70 @@ FAR struct usbdev_req_s *usbdev_allocreq(FAR struct usbdev_ep_s *ep,
 void usbdev_freereq(FAR struct usbdev_ep_s *ep,
                     FAR struct usbdev_req_s *req);
 
+/****************************************************************************
+ * Name: usbdev_reqpool_init
+ *
+ * Description:
+ *   Allocate nreqs requests of len bytes for ep and put them in the free
+ *   list of the pool.  Must not be called from interrupt processing.
+ *
+ ****************************************************************************/
+
+int usbdev_reqpool_init(FAR struct usbdev_reqpool_s *pool,
+                        FAR struct usbdev_ep_s *ep, int nreqs, size_t len,
+                        CODE void (*callback)(FAR struct usbdev_ep_s *ep,
+                                              FAR struct usbdev_req_s *req));
+
+/****************************************************************************
+ * Name: usbdev_reqpool_uninit
+ *
+ * Description:
+ *   Free all requests of the pool.  The endpoint must have been disabled
+ *   so that no request is still in flight.
+ *
+ ****************************************************************************/
+
+void usbdev_reqpool_uninit(FAR struct usbdev_reqpool_s *pool);
+
+/****************************************************************************
+ * Name: usbdev_reqpool_get
+ *
+ * Description:
+ *   Take a request from the free list, or return NULL if there is none.
+ *   May be called from interrupt processing.
+ *
+ ****************************************************************************/
+
+FAR struct usbdev_req_s *usbdev_reqpool_get(
+                                      FAR struct usbdev_reqpool_s *pool);
+
+/****************************************************************************
+ * Name: usbdev_reqpool_put
+ *
+ * Description:
+ *   Return a request to the free list.  May be called from interrupt
+ *   processing.
+ *
+ ****************************************************************************/
+
+void usbdev_reqpool_put(FAR struct usbdev_reqpool_s *pool,
+                        FAR struct usbdev_req_s *req);
+
+/****************************************************************************
+ * Name: usbdev_reqpool_submit
+ *
+ * Description:
+ *   Submit every request of the free list to the endpoint.  This is how
+ *   an OUT endpoint is primed with all of its read requests.
+ *
+ * Returned Value:
+ *   The number of requests submitted, or a negated errno value if none
+ *   could be submitted.
+ *
+ ****************************************************************************/
+
+int usbdev_reqpool_submit(FAR struct usbdev_reqpool_s *pool);
+
 /****************************************************************************
  * Name: usbdev_copy_devdesc
  *
@@ -324,6 +324,9 @@
 #define FBIOGET_PANINFOCNT    _FBIOC(0x001d)  /* Get pan info count */
                                               /* Argument: read-only
                                                *           unsigned long */
+#define FBIOGET_PANSTATE      _FBIOC(0x001e)  /* Get pan queue state
+                                               * Argument: read/write struct
+                                               *           fb_panstate_s* */
 
 #define FB_TYPE_PACKED_PIXELS        0      /* Packed Pixels */
 #define FB_TYPE_PLANES               1      /* Non interleaved planes */
@@ -545,6 +548,26 @@ struct fb_planeinfo_s
   uint32_t   yoffset;      /* Offset from virtual to visible resolution */
 };
 
+/* This structure reports the state of the pan queue of the primary plane
+ * or of an overlay.  The frames passed to FBIOPAN_DISPLAY or
+ * FBIOPAN_OVERLAY are numbered from 1 in the order they are queued, queued
+ * is the number of the latest one.  The driver removes a frame from the
+ * queue when the following frame is on display, so once retired reaches
+ * the number of a frame its buffer may be drawn again.  This works as a
+ * release fence for back buffer rendering: poll() reports POLLOUT when a
+ * frame is retired and POLLPRI on each vertical sync.
+ */
+
+struct fb_panstate_s
+{
+  int        overlay;     /* In: overlay number or FB_NO_OVERLAY */
+  uint32_t   queued;      /* Number of the latest queued frame */
+  uint32_t   retired;     /* Number of the latest retired frame */
+  uint32_t   vsyncs;      /* Vertical syncs reported by the driver */
+  uint32_t   xoffset;     /* Pan offset of the latest retired frame */
+  uint32_t   yoffset;
+};
+
 /* This structure describes an area. */
 
 struct fb_area_s
@@ -761,6 +784,23 @@ struct fb_vtable_s
                     FAR const struct fb_area_s *area);
 #endif
 
+#ifdef CONFIG_FB_ACCEL
+  /* The following are provided only if the video hardware can fill and
+   * copy rectangles in video memory, e.g. with a 2D DMA engine.  Either
+   * may be NULL.  src is the first pixel of the source rectangle in CPU
+   * memory and srcstride is its line length in bytes.  The operation is
+   * complete when the method returns.  A negated errno value, e.g.
+   * -ENOTSUP for an unsupported pixel format, makes the caller draw the
+   * area with the CPU instead.
+   */
+
+  int (*fillarea)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, uint32_t color);
+  int (*copyarea)(FAR struct fb_vtable_s *vtable, int planeno,
+                  FAR const struct fb_area_s *area, FAR const void *src,
+                  fb_coord_t srcstride);
+#endif
+
 #ifdef CONFIG_FB_SYNC
   /* The following are provided only if the video hardware signals
    * vertical sync.
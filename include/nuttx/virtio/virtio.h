@@ -37,6 +37,20 @@
 
 #include <openamp/open_amp.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Ring features the transports offer on behalf of every driver, since they
+ * are implemented by the common virtqueue code.
+ */
+
+#ifdef CONFIG_DRIVERS_VIRTIO_EVENT_IDX
+#  define VIRTIO_TRANSPORT_FEATURES (1ULL << VIRTIO_RING_F_EVENT_IDX)
+#else
+#  define VIRTIO_TRANSPORT_FEATURES 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -196,6 +196,91 @@ int wd_start(FAR struct wdog_s *wdog, clock_t delay,
   return ret;
 }
 
+/****************************************************************************
+ * Name: wd_slack_expire
+ *
+ * Description:
+ *   Pick the expiration tick of a watchdog that may fire anywhere within
+ *   [expired, expired + slack]: the tick with the most trailing zero bits
+ *   in that window.  Watchdogs with overlapping windows thus tend to get
+ *   the same expiration and are served by a single timer interrupt.
+ *
+ * Input Parameters:
+ *   expired - Nominal expiration, absolute time in clock ticks
+ *   slack   - Acceptable delay of the expiration in clock ticks
+ *
+ * Returned Value:
+ *   The rounded expiration, absolute time in clock ticks.
+ *
+ ****************************************************************************/
+
+static inline_function clock_t wd_slack_expire(clock_t expired,
+                                               clock_t slack)
+{
+  clock_t limit = expired + slack;
+  clock_t mask  = expired ^ limit;
+
+  if (mask == 0)
+    {
+      return expired;
+    }
+
+  /* Keep only the highest bit in which the window bounds differ */
+
+  while ((mask & (mask - 1)) != 0)
+    {
+      mask &= mask - 1;
+    }
+
+  return limit & ~(mask - 1);
+}
+
+/****************************************************************************
+ * Name: wd_start_slack
+ *
+ * Description:
+ *   This function is the same as wd_start(), but the watchdog may expire
+ *   up to 'slack' ticks late, as chosen by wd_slack_expire(), so that it
+ *   can share a timer interrupt with other watchdogs.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   slack    - Acceptable additional delay in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ *   NOTE:  The parameter must be of type wdparm_t.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ * Assumptions:
+ *   The watchdog routine runs in the context of the timer interrupt handler
+ *   and is subject to all ISR restrictions.
+ *
+ ****************************************************************************/
+
+static inline_function
+int wd_start_slack(FAR struct wdog_s *wdog, clock_t delay, clock_t slack,
+                   wdentry_t wdentry, wdparm_t arg)
+{
+  int ret = -EINVAL;
+
+  /* Ensure delay is within the range the wdog can handle. */
+
+  if (delay <= WDOG_MAX_DELAY && slack <= WDOG_MAX_DELAY - delay)
+    {
+      ret = wd_start_abstick(wdog,
+                             wd_slack_expire(clock_delay2abstick(delay),
+                                             slack),
+                             wdentry, arg);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: wd_start_abstime
  *
@@ -376,6 +461,22 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_getnext
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means a watchdog expires now, a negative value that there is no
+ *   active watchdog.
+ *
+ ****************************************************************************/
+
+sclock_t wd_getnext(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -214,6 +214,7 @@
 #  define USRWORK  2          /* User mode work queue */
 #  define HPWORK   USRWORK    /* Redirect kernel-mode references */
 #  define LPWORK   USRWORK
+#  define ISRWORK  USRWORK
 
 #else
 /* Kernel mode */
@@ -226,6 +227,15 @@
 #  endif
 #  define USRWORK  LPWORK     /* Redirect user-mode references */
 
+#  ifdef CONFIG_SCHED_HPWORK_PERCPU
+#    define CPUWORK(cpu) (LPWORK + 1 + (cpu)) /* Per-CPU high priority */
+#  endif
+#  ifdef CONFIG_SCHED_ISRWORK
+#    define ISRWORK (LPWORK + 1 + CONFIG_SMP_NCPUS) /* Interrupt context */
+#  else
+#    define ISRWORK HPWORK    /* Redirect interrupt context references */
+#  endif
+
 #endif /* CONFIG_LIBC_USRWORK && !__KERNEL__ */
 
 /****************************************************************************
@@ -409,6 +419,41 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
                   FAR struct work_s *work, worker_t worker,
                   FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_on
+ *
+ * Description:
+ *   Queue work on the high priority work queue of a CPU, so that it is
+ *   performed by a worker thread bound to that CPU.  If the worker of that
+ *   CPU is busy with a backlog, the work is queued on the shared HPWORK
+ *   queue instead.  Without CONFIG_SCHED_HPWORK_PERCPU the work always goes
+ *   to HPWORK.
+ *
+ *   Unlike work_queue(), the work must not be pending on any queue, since
+ *   it may not end up on the same queue as last time.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU to perform the work on, or -1 for the current CPU
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   The ID of the work queue that the work was queued on (CPUWORK(cpu) or
+ *   HPWORK), to be used with work_cancel(), on success.  A negated errno
+ *   value on failure:  -EBUSY if the work is still pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+int work_queue_on(int cpu, FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay);
+#endif
+
 /****************************************************************************
  * Name: work_queue_next/work_queue_next_wq
  *
@@ -50,6 +50,7 @@
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
 #define SCHED_BATCH               4  /* Batch scheduling policy */
 #define SCHED_IDLE                5  /* Idle scheduling policy */
+#define SCHED_DEADLINE            6  /* Deadline (EDF) scheduling policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -203,6 +204,22 @@ struct sched_param
 #endif
 };
 
+/* This is the Linux-compatible extended scheduling attribute structure used
+ * by sched_setattr() and sched_getattr().  All times are in nanoseconds.
+ */
+
+struct sched_attr
+{
+  uint32_t size;                        /* Size of this structure */
+  uint32_t sched_policy;                /* Scheduling policy */
+  uint64_t sched_flags;                 /* Must be zero */
+  int32_t  sched_nice;                  /* Not used */
+  uint32_t sched_priority;              /* Priority for SCHED_FIFO/RR */
+  uint64_t sched_runtime;               /* SCHED_DEADLINE runtime budget */
+  uint64_t sched_deadline;              /* SCHED_DEADLINE relative deadline */
+  uint64_t sched_period;                /* SCHED_DEADLINE period */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -250,6 +267,13 @@ int    sched_get_priority_max(int policy);
 int    sched_get_priority_min(int policy);
 int    sched_rr_get_interval(pid_t pid, FAR struct timespec *interval);
 
+#ifdef CONFIG_SCHED_DEADLINE
+int    sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                     unsigned int flags);
+int    sched_getattr(pid_t pid, FAR struct sched_attr *attr,
+                     unsigned int size, unsigned int flags);
+#endif
+
 #ifdef CONFIG_SMP
 /* Task affinity */
 
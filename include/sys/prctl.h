@@ -69,6 +69,19 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME_EXT, myname, pid);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the timer slack of the calling thread to (unsigned long) arg2
+ *    nanoseconds.  Timed waits of the thread may expire that much later so
+ *    that they can be coalesced with other timers.  A value of zero
+ *    restores the default slack.  Requires CONFIG_TIMER_SLACK.  As an
+ *    example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 1000000);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the timer slack of the calling thread in nanoseconds as the
+ *    result of the call.
  */
 
 #define PR_SET_NAME     1
@@ -79,6 +92,9 @@
 #define PR_SET_DUMPABLE 5
 #define PR_GET_DUMPABLE 6
 
+#define PR_SET_TIMERSLACK 7
+#define PR_GET_TIMERSLACK 8
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -53,6 +53,7 @@
 #define PF_BLUETOOTH  31         /* Bluetooth sockets */
 #define PF_IEEE802154 36         /* Low level IEEE 802.15.4 radio frame interface */
 #define PF_VSOCK      40         /* vSockets */
+#define PF_XDP        44         /* AF_XDP user space fast path */
 #define PF_PKTRADIO   64         /* Low level packet radio interface */
 #define PF_RPMSG      65         /* Remote core communication */
 
@@ -72,6 +73,7 @@
 #define AF_BLUETOOTH   PF_BLUETOOTH
 #define AF_IEEE802154  PF_IEEE802154
 #define AF_VSOCK       PF_VSOCK
+#define AF_XDP         PF_XDP
 #define AF_PKTRADIO    PF_PKTRADIO
 #define AF_RPMSG       PF_RPMSG
 
@@ -136,10 +138,15 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): block until 1+ packets. */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
 
+/* Send the caller's data in place. */
+
+#define MSG_ZEROCOPY     0x4000000
+
 /* Protocol levels supported by get/setsockopt(): */
 
 #define SOL_SOCKET       1 /* Only socket-level options supported */
@@ -224,6 +231,23 @@
                             * arg: integer value
                             */
 
+/* Caps the pacing rate in bytes per second, zero for no limit (get/set).
+ * arg: unsigned integer value
+ */
+
+#define SO_MAX_PACING_RATE 21
+
+#define SO_BUSY_POLL    22 /* Time in us a blocking receive polls the device
+                            * before sleeping (get/set).
+                            * arg: integer value
+                            */
+#define SO_TIMESTAMPING 23 /* Selects the software and hardware timestamps
+                            * reported for sent and received packets
+                            * (get/set).
+                            * arg: integer value, see SOF_TIMESTAMPING_* in
+                            * include/net/net_tstamp.h
+                            */
+
 /* The options are unsupported but included for compatibility
  * and portability
  */
@@ -301,6 +325,7 @@
 #define SCM_CREDENTIALS 0x02    /* rw: struct ucred */
 #define SCM_SECURITY    0x03    /* rw: security label */
 #define SCM_TIMESTAMP   SO_TIMESTAMP
+#define SCM_TIMESTAMPING SO_TIMESTAMPING /* r: struct scm_timestamping */
 
 /* Desired design of maximum size and alignment (see RFC2553) */
 
@@ -377,6 +402,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* One entry of the message vector of sendmmsg() and recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -464,6 +497,13 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR const struct msghdr *msg, int flags);
 
+struct timespec; /* Forward reference */
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
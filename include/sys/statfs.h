@@ -48,6 +48,7 @@
 #define CRAMFS_MAGIC          0x28cd3d45
 #define DEVFS_SUPER_MAGIC     0x1373
 #define EFS_SUPER_MAGIC       0x00414a53
+#define EXFAT_SUPER_MAGIC     0x2011bab0
 #define EXT_SUPER_MAGIC       0x137d
 #define EXT2_OLD_SUPER_MAGIC  0xef51
 #define EXT2_SUPER_MAGIC      0xef53
@@ -66,6 +66,17 @@ enum
 #  undef SYSCALL_LOOKUP
 };
 
+#ifdef CONFIG_SYSCALL_BATCH
+/* One call of a syscall_batch() list */
+
+struct syscall_batch_s
+{
+  unsigned int nbr;                  /* SYS_ number of the call */
+  uintptr_t    parm[6];              /* Parameters, the unused ones ignored */
+  uintptr_t    result;               /* Return value of the call */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -100,6 +111,23 @@ EXTERN const char *g_funcnames[SYS_nsyscalls];
  * Public Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_SYSCALL_BATCH
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Perform a list of system calls with a single entry into the kernel.
+ *   The return value of each call is stored in its result field.
+ *
+ * Returned Value:
+ *   The number of calls made; ERROR with errno set to EINVAL, and no call
+ *   made, if an entry has an invalid system call number.
+ *
+ ****************************************************************************/
+
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
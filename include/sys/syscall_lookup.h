@@ -55,6 +55,11 @@ SYSCALL_LOOKUP(nxsched_get_stackinfo,      2)
   SYSCALL_LOOKUP(sched_setaffinity,        3)
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  SYSCALL_LOOKUP(sched_getattr,            4)
+  SYSCALL_LOOKUP(sched_setattr,            3)
+#endif
+
 SYSCALL_LOOKUP(sysinfo,                    1)
 
 SYSCALL_LOOKUP(gethostname,                2)
@@ -172,7 +177,12 @@ SYSCALL_LOOKUP(clock_nanosleep,            4)
  */
 
 SYSCALL_LOOKUP(clock,                      0)
-SYSCALL_LOOKUP(clock_gettime,              2)
+#ifdef CONFIG_CLOCK_VDSO
+  SYSCALL_LOOKUP(nxclock_gettime,          2)
+  SYSCALL_LOOKUP(nxclock_vdso,             0)
+#else
+  SYSCALL_LOOKUP(clock_gettime,            2)
+#endif
 SYSCALL_LOOKUP(clock_settime,              2)
 #ifdef CONFIG_CLOCK_ADJTIME
   SYSCALL_LOOKUP(clock_adjtime,            2)
@@ -253,6 +263,8 @@ SYSCALL_LOOKUP(fstat,                      2)
 SYSCALL_LOOKUP(statfs,                     2)
 SYSCALL_LOOKUP(fstatfs,                    2)
 SYSCALL_LOOKUP(sendfile,                   4)
+SYSCALL_LOOKUP(splice,                     6)
+SYSCALL_LOOKUP(tee,                        4)
 SYSCALL_LOOKUP(sync,                       0)
 SYSCALL_LOOKUP(fsync,                      1)
 SYSCALL_LOOKUP(chmod,                      2)
@@ -369,9 +381,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -403,3 +417,9 @@ SYSCALL_LOOKUP(signal,                     2)
   SYSCALL_LOOKUP(sched_note_vprintf_ip,    5)
   SYSCALL_LOOKUP(sched_note_event_ip,      5)
 #endif
+
+/* Several system calls with one trap */
+
+#ifdef CONFIG_SYSCALL_BATCH
+  SYSCALL_LOOKUP(syscall_batch,            2)
+#endif
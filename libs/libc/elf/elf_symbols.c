@@ -76,6 +76,75 @@ extern int nglobals;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: libelf_loadstrtab
+ *
+ * Description:
+ *   Read the string table section at file offset sh_offset into memory,
+ *   unless it is the one already cached.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure, in which case the caller falls back to piecewise reads.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_ELF_CACHE_STRTAB
+static int libelf_loadstrtab(FAR struct mod_loadinfo_s *loadinfo,
+                             Elf_Off sh_offset)
+{
+  FAR Elf_Shdr *shdr = NULL;
+  int ret;
+  int i;
+
+  if (loadinfo->strtab != NULL && loadinfo->strtaboff == sh_offset)
+    {
+      return OK;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      if (loadinfo->shdr[i].sh_type == SHT_STRTAB &&
+          loadinfo->shdr[i].sh_offset == sh_offset)
+        {
+          shdr = &loadinfo->shdr[i];
+          break;
+        }
+    }
+
+  if (shdr == NULL || shdr->sh_size == 0 ||
+      sh_offset + shdr->sh_size > loadinfo->filelen)
+    {
+      return -ENOENT;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      lib_free(loadinfo->strtab);
+      loadinfo->strtab = NULL;
+    }
+
+  loadinfo->strtab = lib_malloc(shdr->sh_size);
+  if (loadinfo->strtab == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = libelf_read(loadinfo, (FAR uint8_t *)loadinfo->strtab,
+                    shdr->sh_size, sh_offset);
+  if (ret < 0)
+    {
+      lib_free(loadinfo->strtab);
+      loadinfo->strtab = NULL;
+      return ret;
+    }
+
+  loadinfo->strtaboff = sh_offset;
+  loadinfo->strtablen = shdr->sh_size;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: libelf_symname
  *
@@ -122,6 +191,45 @@ static int libelf_symname(FAR struct mod_loadinfo_s *loadinfo,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_LIBC_ELF_CACHE_STRTAB
+  /* Copy the name from the cached string table if possible */
+
+  if (libelf_loadstrtab(loadinfo, sh_offset) == OK)
+    {
+      FAR const char *name;
+      size_t maxlen;
+      size_t len;
+
+      if (sym->st_name >= loadinfo->strtablen)
+        {
+          berr("ERROR: Symbol name out of the string table\n");
+          return -EINVAL;
+        }
+
+      name   = loadinfo->strtab + sym->st_name;
+      maxlen = loadinfo->strtablen - sym->st_name;
+      len    = strnlen(name, maxlen);
+      if (len >= maxlen)
+        {
+          berr("ERROR: Unterminated symbol name\n");
+          return -EINVAL;
+        }
+
+      if (len >= loadinfo->buflen)
+        {
+          ret = libelf_reallocbuffer(loadinfo, len + 1 - loadinfo->buflen);
+          if (ret < 0)
+            {
+              berr("ERROR: mod_reallocbuffer failed: %d\n", ret);
+              return ret;
+            }
+        }
+
+      memcpy(loadinfo->iobuffer, name, len + 1);
+      return OK;
+    }
+#endif
+
   offset = sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -104,5 +104,14 @@ int libelf_freebuffers(FAR struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen   = 0;
     }
 
+#ifdef CONFIG_LIBC_ELF_CACHE_STRTAB
+  if (loadinfo->strtab != NULL)
+    {
+      lib_free(loadinfo->strtab);
+      loadinfo->strtab    = NULL;
+      loadinfo->strtablen = 0;
+    }
+#endif
+
   return OK;
 }
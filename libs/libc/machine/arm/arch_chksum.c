@@ -0,0 +1,124 @@
+/****************************************************************************
+ * libs/libc/machine/arm/arch_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <arm_neon.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_tail
+ *
+ * Description:
+ *   Sum the last bytes in native order, add the vector accumulator and
+ *   fold the result into the 16-bit partial checksum.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_tail(uint16_t sum, FAR const uint8_t *data,
+                            size_t len, uint64_t acc)
+{
+  uint32_t word;
+  uint16_t half = 0;
+
+  for (; len >= sizeof(word); data += sizeof(word), len -= sizeof(word))
+    {
+      memcpy(&word, data, sizeof(word));
+      acc += word;
+    }
+
+  if (len >= sizeof(half))
+    {
+      memcpy(&half, data, sizeof(half));
+      acc  += half;
+      data += sizeof(half);
+      len  -= sizeof(half);
+    }
+
+  if (len > 0)
+    {
+      half = 0;
+      memcpy(&half, data, 1);
+      acc += half;
+    }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  acc = (uint64_t)sum + ntohs((uint16_t)acc);
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer to a partial Internet checksum.  The
+ *   32-bit lanes of each NEON vector are pairwise added into 64-bit lanes
+ *   (vpadal), which cannot overflow, with two accumulators to hide the
+ *   latency.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_block(uint16_t sum, FAR const uint8_t *data, size_t len)
+{
+  uint64x2_t vacc0 = vdupq_n_u64(0);
+  uint64x2_t vacc1 = vdupq_n_u64(0);
+  uint64_t acc;
+
+  for (; len >= 32; data += 32, len -= 32)
+    {
+      vacc0 = vpadalq_u32(vacc0, vreinterpretq_u32_u8(vld1q_u8(data)));
+      vacc1 = vpadalq_u32(vacc1, vreinterpretq_u32_u8(vld1q_u8(data + 16)));
+    }
+
+  if (len >= 16)
+    {
+      vacc0 = vpadalq_u32(vacc0, vreinterpretq_u32_u8(vld1q_u8(data)));
+      data += 16;
+      len  -= 16;
+    }
+
+  vacc0 = vaddq_u64(vacc0, vacc1);
+  acc   = vgetq_lane_u64(vacc0, 0) + vgetq_lane_u64(vacc0, 1);
+
+  return chksum_tail(sum, data, len, acc);
+}
@@ -0,0 +1,124 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <riscv_vector.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_tail
+ *
+ * Description:
+ *   Sum the last bytes in native order, add the vector accumulator and
+ *   fold the result into the 16-bit partial checksum.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_tail(uint16_t sum, FAR const uint8_t *data,
+                            size_t len, uint64_t acc)
+{
+  uint32_t word;
+  uint16_t half = 0;
+
+  for (; len >= sizeof(word); data += sizeof(word), len -= sizeof(word))
+    {
+      memcpy(&word, data, sizeof(word));
+      acc += word;
+    }
+
+  if (len >= sizeof(half))
+    {
+      memcpy(&half, data, sizeof(half));
+      acc  += half;
+      data += sizeof(half);
+      len  -= sizeof(half);
+    }
+
+  if (len > 0)
+    {
+      half = 0;
+      memcpy(&half, data, 1);
+      acc += half;
+    }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  acc = (uint64_t)sum + ntohs((uint16_t)acc);
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer to a partial Internet checksum.  The
+ *   data is loaded as bytes, so any alignment works, and summed as 32-bit
+ *   elements widened into 64-bit accumulator lanes (vwaddu.wv), which are
+ *   reduced once at the end.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_block(uint16_t sum, FAR const uint8_t *data, size_t len)
+{
+  size_t vlmax = __riscv_vsetvlmax_e64m8();
+  vuint64m8_t vacc = __riscv_vmv_v_x_u64m8(0, vlmax);
+  vuint64m1_t vsum;
+  uint64_t acc;
+
+  while (len >= sizeof(uint32_t))
+    {
+      size_t vl = __riscv_vsetvl_e32m4(len / sizeof(uint32_t));
+      vuint8m4_t v = __riscv_vle8_v_u8m4(data, vl * sizeof(uint32_t));
+      vuint32m4_t w = __riscv_vreinterpret_v_u8m4_u32m4(v);
+
+      vacc  = __riscv_vwaddu_wv_u64m8_tu(vacc, vacc, w, vl);
+      data += vl * sizeof(uint32_t);
+      len  -= vl * sizeof(uint32_t);
+    }
+
+  vsum = __riscv_vredsum_vs_u64m8_u64m1(vacc, __riscv_vmv_s_x_u64m1(0, 1),
+                                        vlmax);
+  acc  = __riscv_vmv_x_s_u64m1_u64(vsum);
+
+  return chksum_tail(sum, data, len, acc);
+}
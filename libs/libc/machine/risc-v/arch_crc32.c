@@ -0,0 +1,135 @@
+/****************************************************************************
+ * libs/libc/machine/risc-v/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* CRC32 and CRC32C with the Zbc carry-less multiply instructions.  Each
+ * 64-bit word is folded into the CRC with one Barrett reduction.  The
+ * quotient constants are floor(x^96 / P(x)) without the x^64 term, bit
+ * reflected; the missing term is the shift and xor below.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <nuttx/crc32.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CRC32_POLY        0xedb88320
+#define CRC32_POLY_QT     0x5a72d812fb808b20
+#define CRC32C_POLY       0x82f63b78
+#define CRC32C_POLY_QT    0xa434f61c6f5389f8
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32_reduce
+ *
+ * Description:
+ *   Return the CRC of the 64 bits in s with a zero initial value.
+ *
+ ****************************************************************************/
+
+static inline uint32_t crc32_reduce(uint64_t s, uint64_t qt, uint64_t poly)
+{
+  uint64_t crc;
+
+  /* There is no clmulrh, clmul followed by a shift gives the same bits */
+
+  __asm__ ("clmul  %0, %1, %2\n"
+           "slli   %0, %0, 1\n"
+           "xor    %0, %0, %1\n"
+           "clmulr %0, %0, %3\n"
+           "srli   %0, %0, 32\n"
+           : "=&r" (crc)
+           : "r" (s), "r" (qt), "r" (poly << 32));
+
+  return crc;
+}
+
+static uint32_t crc32_zbc(FAR const uint8_t *src, size_t len,
+                          uint32_t crc32val, uint64_t qt, uint64_t poly)
+{
+  uint64_t data;
+
+  for (; len >= sizeof(data); src += sizeof(data), len -= sizeof(data))
+    {
+      memcpy(&data, src, sizeof(data));
+      crc32val = crc32_reduce(crc32val ^ data, qt, poly);
+    }
+
+  /* The tail is a shorter word, shifted up so that the reduction sees
+   * leading zero bits which leave a zero CRC unchanged.
+   */
+
+  if (len > 0)
+    {
+      data = 0;
+      memcpy(&data, src, len);
+      data ^= crc32val;
+      data &= UINT64_MAX >> (64 - 8 * len);
+      crc32val = (uint32_t)((uint64_t)crc32val >> (8 * len)) ^
+                 crc32_reduce(data << (64 - 8 * len), qt, poly);
+    }
+
+  return crc32val;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   crc32 polynomial 0x04C11DB7 (bitreflected 0xEDB88320)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  return crc32_zbc(src, len, crc32val, CRC32_POLY_QT, CRC32_POLY);
+}
+
+/****************************************************************************
+ * Name: crc32part_c
+ *
+ * Description:
+ *   crc32 Castagnoli polynomial 0x1EDC6F41 (bitreflected 0x82F63B78)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part_c(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  return crc32_zbc(src, len, crc32val, CRC32C_POLY_QT, CRC32C_POLY);
+}
@@ -0,0 +1,135 @@
+/****************************************************************************
+ * libs/libc/machine/x86_64/arch_chksum.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <immintrin.h>
+
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_tail
+ *
+ * Description:
+ *   Sum the last bytes in native order, add the vector accumulator and
+ *   fold the result into the 16-bit partial checksum.
+ *
+ ****************************************************************************/
+
+static uint16_t chksum_tail(uint16_t sum, FAR const uint8_t *data,
+                            size_t len, uint64_t acc)
+{
+  uint32_t word;
+  uint16_t half = 0;
+
+  for (; len >= sizeof(word); data += sizeof(word), len -= sizeof(word))
+    {
+      memcpy(&word, data, sizeof(word));
+      acc += word;
+    }
+
+  if (len >= sizeof(half))
+    {
+      memcpy(&half, data, sizeof(half));
+      acc  += half;
+      data += sizeof(half);
+      len  -= sizeof(half);
+    }
+
+  if (len > 0)
+    {
+      half = 0;
+      memcpy(&half, data, 1);
+      acc += half;
+    }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  acc = (uint64_t)sum + ntohs((uint16_t)acc);
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer to a partial Internet checksum.  The
+ *   32-bit lanes of each vector are widened to 64 bits and summed, which
+ *   cannot overflow, with AVX2 when the compiler targets it and SSE2
+ *   otherwise.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_block(uint16_t sum, FAR const uint8_t *data, size_t len)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i vacc = zero;
+  uint64_t acc;
+
+#ifdef __AVX2__
+  __m256i zero2 = _mm256_setzero_si256();
+  __m256i vacc2 = zero2;
+
+  for (; len >= 32; data += 32, len -= 32)
+    {
+      __m256i v = _mm256_loadu_si256((FAR const __m256i *)data);
+
+      vacc2 = _mm256_add_epi64(vacc2, _mm256_unpacklo_epi32(v, zero2));
+      vacc2 = _mm256_add_epi64(vacc2, _mm256_unpackhi_epi32(v, zero2));
+    }
+
+  vacc = _mm_add_epi64(_mm256_castsi256_si128(vacc2),
+                       _mm256_extracti128_si256(vacc2, 1));
+#endif
+
+  for (; len >= 16; data += 16, len -= 16)
+    {
+      __m128i v = _mm_loadu_si128((FAR const __m128i *)data);
+
+      vacc = _mm_add_epi64(vacc, _mm_unpacklo_epi32(v, zero));
+      vacc = _mm_add_epi64(vacc, _mm_unpackhi_epi32(v, zero));
+    }
+
+  acc = (uint64_t)_mm_cvtsi128_si64(vacc) +
+        (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(vacc, vacc));
+
+  return chksum_tail(sum, data, len, acc);
+}
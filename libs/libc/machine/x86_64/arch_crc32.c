@@ -0,0 +1,220 @@
+/****************************************************************************
+ * libs/libc/machine/x86_64/arch_crc32.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* CRC32C with the SSE4.2 CRC32 instruction.  SSE4.2 has no instruction for
+ * the IEEE polynomial, CRC32 uses PCLMULQDQ instead: four 128-bit
+ * accumulators are folded 64 bytes ahead with x^544 and x^480 mod P(x),
+ * then into one with x^160 and x^96 mod P(x).  What is left, and buffers
+ * too short to fold, go through a Barrett reduction per 64-bit word whose
+ * quotient constant is floor(x^96 / P(x)) without the x^64 term.  All
+ * constants are bit reflected.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#pragma GCC target ("pclmul")
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <immintrin.h>
+
+#include <nuttx/crc32.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CRC32_POLY        0xedb88320
+#define CRC32_POLY_QT     0x5a72d812fb808b20
+
+#define CRC32_FOLD4_LO    0x154442bd4
+#define CRC32_FOLD4_HI    0x1c6e41596
+#define CRC32_FOLD1_LO    0x1751997d0
+#define CRC32_FOLD1_HI    0x0ccaa009e
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32_reduce
+ *
+ * Description:
+ *   Return the CRC of the 64 bits in s with a zero initial value.
+ *
+ ****************************************************************************/
+
+static inline uint32_t crc32_reduce(uint64_t s)
+{
+  __m128i t;
+  uint64_t lo;
+  uint64_t hi;
+
+  /* The low half of s * qt, plus s for the x^64 term of the quotient */
+
+  t  = _mm_clmulepi64_si128(_mm_cvtsi64_si128(s),
+                            _mm_cvtsi64_si128(CRC32_POLY_QT), 0x00);
+  lo = ((uint64_t)_mm_cvtsi128_si64(t) << 1) ^ s;
+
+  /* Bits 63 to 126 of lo * poly * x^32, of which the top half is the
+   * remainder.
+   */
+
+  t  = _mm_clmulepi64_si128(_mm_cvtsi64_si128(lo),
+                            _mm_cvtsi64_si128((uint64_t)CRC32_POLY << 32),
+                            0x00);
+  lo = _mm_cvtsi128_si64(t);
+  hi = _mm_extract_epi64(t, 1);
+
+  return ((hi << 1) | (lo >> 63)) >> 32;
+}
+
+static inline __m128i crc32_fold(__m128i acc, __m128i k, __m128i data)
+{
+  return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x00),
+                                     _mm_clmulepi64_si128(acc, k, 0x11)),
+                       data);
+}
+
+/****************************************************************************
+ * Name: crc32_fold64
+ *
+ * Description:
+ *   Fold len bytes, a multiple of 16 and at least 64, down to 128 bits
+ *   and return their CRC.
+ *
+ ****************************************************************************/
+
+static uint32_t crc32_fold64(FAR const uint8_t *src, size_t len,
+                             uint32_t crc32val)
+{
+  FAR const __m128i *p = (FAR const __m128i *)src;
+  __m128i x0;
+  __m128i x1;
+  __m128i x2;
+  __m128i x3;
+  __m128i k;
+
+  x0 = _mm_xor_si128(_mm_loadu_si128(p), _mm_cvtsi32_si128(crc32val));
+  x1 = _mm_loadu_si128(p + 1);
+  x2 = _mm_loadu_si128(p + 2);
+  x3 = _mm_loadu_si128(p + 3);
+
+  k  = _mm_set_epi64x(CRC32_FOLD4_HI, CRC32_FOLD4_LO);
+  for (p += 4, len -= 64; len >= 64; p += 4, len -= 64)
+    {
+      x0 = crc32_fold(x0, k, _mm_loadu_si128(p));
+      x1 = crc32_fold(x1, k, _mm_loadu_si128(p + 1));
+      x2 = crc32_fold(x2, k, _mm_loadu_si128(p + 2));
+      x3 = crc32_fold(x3, k, _mm_loadu_si128(p + 3));
+    }
+
+  k  = _mm_set_epi64x(CRC32_FOLD1_HI, CRC32_FOLD1_LO);
+  x0 = crc32_fold(x0, k, x1);
+  x0 = crc32_fold(x0, k, x2);
+  x0 = crc32_fold(x0, k, x3);
+  for (; len >= 16; p++, len -= 16)
+    {
+      x0 = crc32_fold(x0, k, _mm_loadu_si128(p));
+    }
+
+  crc32val = crc32_reduce(_mm_cvtsi128_si64(x0));
+  return crc32_reduce(crc32val ^ _mm_extract_epi64(x0, 1));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crc32part
+ *
+ * Description:
+ *   crc32 polynomial 0x04C11DB7 (bitreflected 0xEDB88320)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  uint64_t data;
+
+  if (len >= 64)
+    {
+      crc32val = crc32_fold64(src, len & ~(size_t)15, crc32val);
+      src += len & ~(size_t)15;
+      len &= 15;
+    }
+
+  for (; len >= sizeof(data); src += sizeof(data), len -= sizeof(data))
+    {
+      memcpy(&data, src, sizeof(data));
+      crc32val = crc32_reduce(crc32val ^ data);
+    }
+
+  /* The tail is a shorter word, shifted up so that the reduction sees
+   * leading zero bits which leave a zero CRC unchanged.
+   */
+
+  if (len > 0)
+    {
+      data = 0;
+      memcpy(&data, src, len);
+      data ^= crc32val;
+      data &= UINT64_MAX >> (64 - 8 * len);
+      crc32val = (uint32_t)((uint64_t)crc32val >> (8 * len)) ^
+                 crc32_reduce(data << (64 - 8 * len));
+    }
+
+  return crc32val;
+}
+
+/****************************************************************************
+ * Name: crc32part_c
+ *
+ * Description:
+ *   crc32 Castagnoli polynomial 0x1EDC6F41 (bitreflected 0x82F63B78)
+ *
+ ****************************************************************************/
+
+uint32_t crc32part_c(FAR const uint8_t *src, size_t len, uint32_t crc32val)
+{
+  uint64_t crc = crc32val;
+  uint64_t data;
+
+  for (; len >= sizeof(data); src += sizeof(data), len -= sizeof(data))
+    {
+      memcpy(&data, src, sizeof(data));
+      crc = _mm_crc32_u64(crc, data);
+    }
+
+  for (; len > 0; src++, len--)
+    {
+      crc = _mm_crc32_u8(crc, *src);
+    }
+
+  return crc;
+}
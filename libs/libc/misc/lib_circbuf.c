@@ -23,8 +23,13 @@
 /* Note about locking: There is no locking required while only one reader
  * and one writer is using the circular buffer.
  * For multiple writer and one reader there is only a need to lock the
- * writer. And vice versa for only one writer and multiple reader there is
- * only a need to lock the reader.
+ * writer, or to use circbuf_write_mp(). And vice versa for only one writer
+ * and multiple reader there is only a need to lock the reader.
+ *
+ * The writer only stores head and the reader only stores tail.  Loading
+ * the other side's index is followed by a barrier before touching the
+ * data, and the data copies are completed before the own index is
+ * stored, so that the index published is the acquire/release point.
  */
 
 /****************************************************************************
@@ -34,14 +39,66 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <sched.h>
+#include <stdint.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/circbuf.h>
+#include <nuttx/irq.h>
 #include <nuttx/lib/lib.h>
 
 /****************************************************************************
- * Private Types
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#if SIZE_MAX > UINT32_MAX
+#  define circbuf_cmpxchg(p, e, d) \
+     atomic64_cmpxchg((FAR atomic64_t *)(p), e, d)
+#else
+#  define circbuf_cmpxchg(p, e, d) \
+     atomic_cmpxchg((FAR atomic_t *)(p), e, d)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Read an index stored by the other side exactly once */
+
+static inline size_t circbuf_load(FAR const size_t *index)
+{
+  return *(FAR const volatile size_t *)index;
+}
+
+static inline void circbuf_store(FAR size_t *index, size_t value)
+{
+  *(FAR volatile size_t *)index = value;
+}
+
+/* The producers of circbuf_write_mp() wait for the reservations before
+ * theirs to be published, they must not be preempted on their own CPU.
+ */
+
+static inline irqstate_t circbuf_mp_enter(void)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  return up_irq_save();
+#else
+  sched_lock();
+  return 0;
+#endif
+}
+
+static inline void circbuf_mp_leave(irqstate_t flags)
+{
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  up_irq_restore(flags);
+#else
+  sched_unlock();
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,10 +138,11 @@ int circbuf_init(FAR struct circbuf_s *circ, FAR void *base, size_t bytes)
         }
     }
 
-  circ->base = base;
-  circ->size = bytes;
-  circ->head = 0;
-  circ->tail = 0;
+  circ->base    = base;
+  circ->size    = bytes;
+  circ->head    = 0;
+  circ->reserve = 0;
+  circ->tail    = 0;
 
   return 0;
 }
@@ -136,10 +194,11 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes)
 
   lib_free(circ->base);
 
-  circ->base = tmp;
-  circ->size = bytes;
-  circ->head = len;
-  circ->tail = 0;
+  circ->base    = tmp;
+  circ->size    = bytes;
+  circ->head    = len;
+  circ->reserve = len;
+  circ->tail    = 0;
 
   return 0;
 }
@@ -157,7 +216,7 @@ int circbuf_resize(FAR struct circbuf_s *circ, size_t bytes)
 void circbuf_reset(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  circ->head = circ->tail = 0;
+  circ->head = circ->reserve = circ->tail = 0;
 }
 
 /****************************************************************************
@@ -211,7 +270,7 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+  return circbuf_load(&circ->head) - circbuf_load(&circ->tail);
 }
 
 /****************************************************************************
@@ -298,6 +357,7 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
   size_t len;
   size_t off;
 
@@ -308,12 +368,15 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  head = circbuf_load(&circ->head);
+  SMP_RMB();
+
+  if (head - pos > head - circ->tail)
     {
       pos = circ->tail;
     }
 
-  len = circ->head - pos;
+  len = head - pos;
   off = pos % circ->size;
 
   if (bytes > len)
@@ -386,7 +449,8 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  SMP_MB();
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -423,7 +487,8 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  SMP_MB();
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -463,6 +528,8 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
     }
 
   space = circbuf_space(circ);
+  SMP_MB();
+
   off = circ->head % circ->size;
   if (bytes > space)
     {
@@ -477,11 +544,94 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  SMP_WMB();
+  circbuf_store(&circ->head, circ->head + bytes);
 
   return bytes;
 }
 
+/****************************************************************************
+ * Name: circbuf_write_mp
+ *
+ * Description:
+ *   Write data to the circular buffer with several concurrent writers and
+ *   one reader, without a lock.
+ *
+ * Note:
+ *   A writer claims its range by moving the reservation index with a
+ *   compare and exchange, copies the data and then waits for the writers
+ *   with earlier ranges to publish theirs before it moves head.  The
+ *   writer is not preemptible on its CPU meanwhile, so the wait is bounded
+ *   by the copies in progress on the other CPUs.  All writers of the
+ *   buffer must use this function.
+ *
+ * Input Parameters:
+ *   circ  - Address of the circular buffer to be used.
+ *   src   - The data to be added.
+ *   bytes - Number of bytes to be added.
+ *
+ * Returned Value:
+ *   The bytes written, all of them or zero if there is not enough space;
+ *   A negated errno value is returned on any failure.
+ ****************************************************************************/
+
+ssize_t circbuf_write_mp(FAR struct circbuf_s *circ,
+                         FAR const void *src, size_t bytes)
+{
+  irqstate_t flags;
+  size_t start;
+  size_t space;
+  size_t off;
+
+  DEBUGASSERT(circ);
+  DEBUGASSERT(src || !bytes);
+
+  if (!circ->size)
+    {
+      return 0;
+    }
+
+  flags = circbuf_mp_enter();
+
+  /* A partial write would interleave with the data of the next writer,
+   * the data is written completely or not at all.
+   */
+
+  start = circbuf_load(&circ->reserve);
+  do
+    {
+      space = circ->size - (start - circbuf_load(&circ->tail));
+      if (bytes > space)
+        {
+          circbuf_mp_leave(flags);
+          return 0;
+        }
+    }
+  while (!circbuf_cmpxchg(&circ->reserve, &start, start + bytes));
+
+  SMP_MB();
+
+  off   = start % circ->size;
+  space = circ->size - off;
+  if (bytes < space)
+    {
+      space = bytes;
+    }
+
+  memcpy((FAR char *)circ->base + off, src, space);
+  memcpy(circ->base, (FAR char *)src + space, bytes - space);
+
+  while (circbuf_load(&circ->head) != start)
+    {
+    }
+
+  SMP_WMB();
+  circbuf_store(&circ->head, start + bytes);
+
+  circbuf_mp_leave(flags);
+  return bytes;
+}
+
 /****************************************************************************
  * Name: circbuf_overwrite
  *
@@ -571,6 +721,8 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_space(circ);
+  SMP_MB();
+
   off = circ->head % circ->size;
   if (off + *size > circ->size)
     {
@@ -602,6 +754,8 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
   DEBUGASSERT(circ);
 
   *size = circbuf_used(circ);
+  SMP_RMB();
+
   off = circ->tail % circ->size;
   if (off + *size > circ->size)
     {
@@ -628,7 +782,8 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  SMP_WMB();
+  circbuf_store(&circ->head, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -648,5 +803,6 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  SMP_MB();
+  circbuf_store(&circ->tail, circ->tail + readsize);
 }
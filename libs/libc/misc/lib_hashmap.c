@@ -0,0 +1,501 @@
+/****************************************************************************
+ * libs/libc/misc/lib_hashmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/hashmap.h>
+#include <nuttx/lib/lib.h>
+#include <nuttx/seqlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HASHMAP_MINSLOTS  8
+
+/* The slots of the previous table moved by each update */
+
+#define HASHMAP_NMOVE     8
+
+/* The entry of a removed slot, probes continue beyond it */
+
+#define HASHMAP_REMOVED   ((FAR void *)1)
+
+/* Returned by a probe that raced with an update */
+
+#define HASHMAP_RETRY     ((FAR void *)2)
+
+/* Keep the load at 3/4 at most, probes always end on a free slot */
+
+#define hashmap_is_full(t) (((t)->used + 1) * 4 > ((t)->mask + 1) * 3)
+#define hashmap_is_live(e) ((e) != NULL && (e) != HASHMAP_REMOVED)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct hashmap_table_s *hashmap_alloc(size_t nentries)
+{
+  FAR struct hashmap_table_s *table;
+  size_t nslots = HASHMAP_MINSLOTS;
+
+  while (nslots / 4 * 3 < nentries + 1)
+    {
+      nslots <<= 1;
+    }
+
+  table = lib_zalloc(sizeof(struct hashmap_table_s) +
+                     (nslots - 1) * sizeof(struct hashmap_slot_s));
+  if (table != NULL)
+    {
+      table->mask = nslots - 1;
+    }
+
+  return table;
+}
+
+/****************************************************************************
+ * Name: hashmap_lookup
+ *
+ * Description:
+ *   Return the slot of key, for the updates which are serialized.
+ *
+ ****************************************************************************/
+
+static FAR struct hashmap_slot_s *
+hashmap_lookup(FAR struct hashmap_s *map, FAR struct hashmap_table_s *table,
+               uint32_t hash, FAR const void *key)
+{
+  FAR struct hashmap_slot_s *slot;
+  size_t i;
+
+  for (i = hash & table->mask; ; i = (i + 1) & table->mask)
+    {
+      slot = &table->slot[i];
+      if (slot->entry == NULL)
+        {
+          return NULL;
+        }
+
+      if (slot->entry != HASHMAP_REMOVED && slot->hash == hash &&
+          map->match(slot->entry, key))
+        {
+          return slot;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: hashmap_probe
+ *
+ * Description:
+ *   Search key in table without a lock.  The table may be freed under
+ *   the reader, but not before an update ran since seq: its size is only
+ *   trusted if there was none, the heap block stays readable after that,
+ *   and an entry is passed to the match function only if there was none.
+ *
+ ****************************************************************************/
+
+static FAR void *hashmap_probe(FAR struct hashmap_s *map,
+                               FAR struct hashmap_table_s *table,
+                               uint32_t hash, FAR const void *key,
+                               uint32_t seq)
+{
+  FAR struct hashmap_slot_s *slot;
+  FAR void *entry;
+  size_t mask = table->mask;
+  size_t i = hash & mask;
+  size_t n;
+
+  if (read_seqretry(&map->seq, seq))
+    {
+      return HASHMAP_RETRY;
+    }
+
+  for (n = 0; n <= mask; n++, i = (i + 1) & mask)
+    {
+      slot  = &table->slot[i];
+      entry = *(FAR void *volatile *)&slot->entry;
+      if (entry == NULL)
+        {
+          return NULL;
+        }
+
+      /* The hash is stored before the entry is published */
+
+      SMP_RMB();
+      if (entry == HASHMAP_REMOVED || slot->hash != hash)
+        {
+          continue;
+        }
+
+      if (read_seqretry(&map->seq, seq))
+        {
+          break;
+        }
+
+      if (map->match(entry, key))
+        {
+          return entry;
+        }
+    }
+
+  return HASHMAP_RETRY;
+}
+
+/****************************************************************************
+ * Name: hashmap_place
+ *
+ * Description:
+ *   Put an entry into the first free or removed slot of its probe
+ *   sequence.
+ *
+ ****************************************************************************/
+
+static void hashmap_place(FAR struct hashmap_table_s *table, uint32_t hash,
+                          FAR void *entry)
+{
+  FAR struct hashmap_slot_s *slot;
+  size_t i;
+
+  for (i = hash & table->mask; ; i = (i + 1) & table->mask)
+    {
+      slot = &table->slot[i];
+      if (!hashmap_is_live(slot->entry))
+        {
+          break;
+        }
+    }
+
+  if (slot->entry == NULL)
+    {
+      table->used++;
+    }
+
+  slot->hash = hash;
+  SMP_WMB();
+  slot->entry = entry;
+}
+
+/****************************************************************************
+ * Name: hashmap_move
+ *
+ * Description:
+ *   Move up to nmove slots of the previous table into the current one.
+ *
+ * Returned Value:
+ *   The previous table once it is empty, to be freed by the caller after
+ *   the update, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct hashmap_table_s *hashmap_move(FAR struct hashmap_s *map,
+                                                size_t nmove)
+{
+  FAR struct hashmap_table_s *old = map->old;
+  FAR struct hashmap_slot_s *slot;
+
+  if (old == NULL)
+    {
+      return NULL;
+    }
+
+  for (; nmove > 0 && map->move <= old->mask; nmove--, map->move++)
+    {
+      slot = &old->slot[map->move];
+      if (hashmap_is_live(slot->entry))
+        {
+          hashmap_place(map->table, slot->hash, slot->entry);
+          slot->entry = HASHMAP_REMOVED;
+        }
+    }
+
+  if (map->move <= old->mask)
+    {
+      return NULL;
+    }
+
+  map->old = NULL;
+  return old;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hashmap_init
+ *
+ * Description:
+ *   Initialize a hash table.
+ *
+ * Input Parameters:
+ *   map      - Address of the hash table to be used.
+ *   nentries - The number of entries expected, the table grows beyond it.
+ *   match    - The function comparing an entry with a key.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int hashmap_init(FAR struct hashmap_s *map, size_t nentries,
+                 hashmap_match_t match)
+{
+  DEBUGASSERT(map != NULL && match != NULL);
+
+  memset(map, 0, sizeof(*map));
+
+  map->table = hashmap_alloc(nentries);
+  if (map->table == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->match = match;
+  seqlock_init(&map->seq);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hashmap_uninit
+ *
+ * Description:
+ *   Free the hash table.  The entries are not freed, use hashmap_foreach()
+ *   first if they need to.
+ *
+ * Input Parameters:
+ *   map - Address of the hash table to be used.
+ *
+ ****************************************************************************/
+
+void hashmap_uninit(FAR struct hashmap_s *map)
+{
+  DEBUGASSERT(map != NULL);
+
+  lib_free(map->table);
+  lib_free(map->old);
+  memset(map, 0, sizeof(*map));
+}
+
+/****************************************************************************
+ * Name: hashmap_find
+ *
+ * Description:
+ *   Find an entry without taking a lock.
+ *
+ * Input Parameters:
+ *   map  - Address of the hash table to be used.
+ *   hash - The hash of key.
+ *   key  - The key passed to the match function.
+ *
+ * Returned Value:
+ *   The entry found, or NULL.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_find(FAR struct hashmap_s *map, uint32_t hash,
+                       FAR const void *key)
+{
+  FAR struct hashmap_table_s *table;
+  FAR struct hashmap_table_s *old;
+  FAR void *entry;
+  uint32_t seq;
+
+  DEBUGASSERT(map != NULL);
+
+  do
+    {
+      seq   = read_seqbegin(&map->seq);
+      table = *(FAR struct hashmap_table_s *volatile *)&map->table;
+      old   = *(FAR struct hashmap_table_s *volatile *)&map->old;
+
+      /* The entries not moved yet are still in the previous table */
+
+      entry = hashmap_probe(map, table, hash, key, seq);
+      if (entry == NULL && old != NULL)
+        {
+          entry = hashmap_probe(map, old, hash, key, seq);
+        }
+    }
+  while (entry == HASHMAP_RETRY || read_seqretry(&map->seq, seq));
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: hashmap_insert
+ *
+ * Description:
+ *   Add an entry.  It is not checked whether an entry with the same key is
+ *   present already.
+ *
+ * Input Parameters:
+ *   map   - Address of the hash table to be used.
+ *   hash  - The hash of the entry's key.
+ *   entry - The entry to add.
+ *
+ * Returned Value:
+ *   Zero on success; A negated errno value is returned on any failure.
+ *
+ ****************************************************************************/
+
+int hashmap_insert(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry)
+{
+  FAR struct hashmap_table_s *table = NULL;
+  FAR struct hashmap_table_s *done = NULL;
+  FAR struct hashmap_table_s *moved;
+  irqstate_t flags;
+
+  DEBUGASSERT(map != NULL && hashmap_is_live(entry));
+
+  /* Start a resize for twice the entries when the table is getting full,
+   * it is sized from the live entries and so drops the removed slots too.
+   * Without memory, carry on as long as a free slot is left.
+   */
+
+  if (hashmap_is_full(map->table))
+    {
+      table = hashmap_alloc(2 * (map->count + 1));
+      if (table == NULL && map->table->used + 1 > map->table->mask)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  flags = write_seqlock_irqsave(&map->seq);
+
+  if (table != NULL)
+    {
+      /* A resize still running is completed first */
+
+      done       = hashmap_move(map, SIZE_MAX);
+      map->old   = map->table;
+      map->move  = 0;
+      map->table = table;
+    }
+
+  moved = hashmap_move(map, HASHMAP_NMOVE);
+  hashmap_place(map->table, hash, entry);
+  map->count++;
+
+  write_sequnlock_irqrestore(&map->seq, flags);
+
+  lib_free(done);
+  lib_free(moved);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: hashmap_remove
+ *
+ * Description:
+ *   Remove the entry with the key.
+ *
+ * Input Parameters:
+ *   map  - Address of the hash table to be used.
+ *   hash - The hash of key.
+ *   key  - The key passed to the match function.
+ *
+ * Returned Value:
+ *   The entry removed, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_remove(FAR struct hashmap_s *map, uint32_t hash,
+                         FAR const void *key)
+{
+  FAR struct hashmap_table_s *moved;
+  FAR struct hashmap_slot_s *slot;
+  FAR void *entry = NULL;
+  irqstate_t flags;
+
+  DEBUGASSERT(map != NULL);
+
+  slot = hashmap_lookup(map, map->table, hash, key);
+  if (slot == NULL && map->old != NULL)
+    {
+      slot = hashmap_lookup(map, map->old, hash, key);
+    }
+
+  flags = write_seqlock_irqsave(&map->seq);
+
+  if (slot != NULL)
+    {
+      entry       = slot->entry;
+      slot->entry = HASHMAP_REMOVED;
+      map->count--;
+    }
+
+  moved = hashmap_move(map, HASHMAP_NMOVE);
+
+  write_sequnlock_irqrestore(&map->seq, flags);
+
+  lib_free(moved);
+  return entry;
+}
+
+/****************************************************************************
+ * Name: hashmap_foreach
+ *
+ * Description:
+ *   Call a function for each entry.  It is an update for the locking, and
+ *   the function must not change the table.
+ *
+ * Input Parameters:
+ *   map     - Address of the hash table to be used.
+ *   handler - The function to call.
+ *   arg     - The argument of the function.
+ *
+ ****************************************************************************/
+
+void hashmap_foreach(FAR struct hashmap_s *map, hashmap_foreach_t handler,
+                     FAR void *arg)
+{
+  FAR struct hashmap_table_s *table;
+  size_t i;
+
+  DEBUGASSERT(map != NULL && handler != NULL);
+
+  for (table = map->table; table != NULL;
+       table = table == map->table ? map->old : NULL)
+    {
+      for (i = 0; i <= table->mask; i++)
+        {
+          if (hashmap_is_live(table->slot[i].entry))
+            {
+              handler(table->slot[i].entry, arg);
+            }
+        }
+    }
+}
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * libs/libc/misc/lib_interval_tree.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/interval_tree.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline FAR struct interval_node_s *
+interval_node(FAR const struct rb_node_s *rb)
+{
+  return rb != NULL ? rb_entry(rb, struct interval_node_s, rb) : NULL;
+}
+
+static void interval_tree_update(FAR struct rb_node_s *rb)
+{
+  FAR struct interval_node_s *node = interval_node(rb);
+  FAR struct interval_node_s *child;
+  uintptr_t last = node->last;
+
+  child = interval_node(rb->rb_left);
+  if (child != NULL && child->subtree_last > last)
+    {
+      last = child->subtree_last;
+    }
+
+  child = interval_node(rb->rb_right);
+  if (child != NULL && child->subtree_last > last)
+    {
+      last = child->subtree_last;
+    }
+
+  node->subtree_last = last;
+}
+
+/****************************************************************************
+ * Name: interval_tree_search
+ *
+ * Description:
+ *   Return the leftmost interval of the subtree overlapping [start, last],
+ *   given that the subtree reaches start.
+ *
+ ****************************************************************************/
+
+static FAR struct interval_node_s *
+interval_tree_search(FAR struct interval_node_s *node,
+                     uintptr_t start, uintptr_t last)
+{
+  FAR struct interval_node_s *child;
+
+  for (; ; )
+    {
+      /* Anything reaching start on the left comes first */
+
+      child = interval_node(node->rb.rb_left);
+      if (child != NULL && child->subtree_last >= start)
+        {
+          node = child;
+          continue;
+        }
+
+      /* Nothing to the right begins before this node */
+
+      if (node->start > last)
+        {
+          return NULL;
+        }
+
+      if (node->last >= start)
+        {
+          return node;
+        }
+
+      child = interval_node(node->rb.rb_right);
+      if (child == NULL || child->subtree_last < start)
+        {
+          return NULL;
+        }
+
+      node = child;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: interval_tree_insert
+ *
+ * Description:
+ *   Add an interval to the tree.
+ *
+ ****************************************************************************/
+
+void interval_tree_insert(FAR struct rb_root_s *root,
+                          FAR struct interval_node_s *node)
+{
+  FAR struct rb_node_s **link = &root->rb_node;
+  FAR struct rb_node_s *parent = NULL;
+
+  DEBUGASSERT(node->start <= node->last);
+
+  while (*link != NULL)
+    {
+      parent = *link;
+      link   = node->start < interval_node(parent)->start ?
+               &parent->rb_left : &parent->rb_right;
+    }
+
+  node->subtree_last = node->last;
+  rb_link_node(&node->rb, parent, link);
+  rb_insert_augmented(root, &node->rb, interval_tree_update);
+}
+
+/****************************************************************************
+ * Name: interval_tree_remove
+ *
+ * Description:
+ *   Remove an interval from the tree.
+ *
+ ****************************************************************************/
+
+void interval_tree_remove(FAR struct rb_root_s *root,
+                          FAR struct interval_node_s *node)
+{
+  rb_erase_augmented(root, &node->rb, interval_tree_update);
+}
+
+/****************************************************************************
+ * Name: interval_tree_iter_first
+ *
+ * Description:
+ *   Return the interval with the lowest start overlapping [start, last],
+ *   or NULL.
+ *
+ ****************************************************************************/
+
+FAR struct interval_node_s *
+interval_tree_iter_first(FAR const struct rb_root_s *root,
+                         uintptr_t start, uintptr_t last)
+{
+  FAR struct interval_node_s *node = interval_node(root->rb_node);
+
+  if (node == NULL || node->subtree_last < start)
+    {
+      return NULL;
+    }
+
+  return interval_tree_search(node, start, last);
+}
+
+/****************************************************************************
+ * Name: interval_tree_iter_next
+ *
+ * Description:
+ *   Return the interval after node overlapping [start, last], or NULL.
+ *
+ ****************************************************************************/
+
+FAR struct interval_node_s *
+interval_tree_iter_next(FAR const struct interval_node_s *node,
+                        uintptr_t start, uintptr_t last)
+{
+  FAR struct interval_node_s *child;
+  FAR struct rb_node_s *prev;
+  FAR struct rb_node_s *rb = node->rb.rb_right;
+
+  for (; ; )
+    {
+      /* The right subtree follows node */
+
+      child = interval_node(rb);
+      if (child != NULL && child->subtree_last >= start)
+        {
+          return interval_tree_search(child, start, last);
+        }
+
+      /* Else go up to the first ancestor reached from its left */
+
+      do
+        {
+          prev = (FAR struct rb_node_s *)&node->rb;
+          node = interval_node(node->rb.rb_parent);
+          if (node == NULL)
+            {
+              return NULL;
+            }
+
+          rb = node->rb.rb_right;
+        }
+      while (prev == rb);
+
+      if (node->start > last)
+        {
+          return NULL;
+        }
+
+      if (node->last >= start)
+        {
+          return (FAR struct interval_node_s *)node;
+        }
+    }
+}
@@ -0,0 +1,519 @@
+/****************************************************************************
+ * libs/libc/misc/lib_rbtree.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/rbtree.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The missing children are the black leaves */
+
+#define rb_is_black(n) ((n) == NULL || (n)->rb_color == RB_BLACK)
+#define rb_is_red(n)   ((n) != NULL && (n)->rb_color == RB_RED)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void rb_replace_child(FAR struct rb_root_s *root,
+                             FAR struct rb_node_s *parent,
+                             FAR struct rb_node_s *old,
+                             FAR struct rb_node_s *node)
+{
+  if (parent == NULL)
+    {
+      root->rb_node = node;
+    }
+  else if (parent->rb_left == old)
+    {
+      parent->rb_left = node;
+    }
+  else
+    {
+      parent->rb_right = node;
+    }
+}
+
+/* Rotations keep the set of nodes below the top position, only the two
+ * nodes which swap places need their augmented value recomputed.
+ */
+
+static void rb_rotate_left(FAR struct rb_root_s *root,
+                           FAR struct rb_node_s *node,
+                           rb_augment_t update)
+{
+  FAR struct rb_node_s *right = node->rb_right;
+
+  node->rb_right = right->rb_left;
+  if (right->rb_left != NULL)
+    {
+      right->rb_left->rb_parent = node;
+    }
+
+  right->rb_parent = node->rb_parent;
+  rb_replace_child(root, node->rb_parent, node, right);
+  right->rb_left  = node;
+  node->rb_parent = right;
+
+  if (update != NULL)
+    {
+      update(node);
+      update(right);
+    }
+}
+
+static void rb_rotate_right(FAR struct rb_root_s *root,
+                            FAR struct rb_node_s *node,
+                            rb_augment_t update)
+{
+  FAR struct rb_node_s *left = node->rb_left;
+
+  node->rb_left = left->rb_right;
+  if (left->rb_right != NULL)
+    {
+      left->rb_right->rb_parent = node;
+    }
+
+  left->rb_parent = node->rb_parent;
+  rb_replace_child(root, node->rb_parent, node, left);
+  left->rb_right  = node;
+  node->rb_parent = left;
+
+  if (update != NULL)
+    {
+      update(node);
+      update(left);
+    }
+}
+
+static void rb_insert_fixup(FAR struct rb_root_s *root,
+                            FAR struct rb_node_s *node,
+                            rb_augment_t update)
+{
+  FAR struct rb_node_s *parent;
+  FAR struct rb_node_s *gparent;
+  FAR struct rb_node_s *uncle;
+
+  /* A red parent is never the root, so there is a grandparent */
+
+  while (rb_is_red(parent = node->rb_parent))
+    {
+      gparent = parent->rb_parent;
+      if (parent == gparent->rb_left)
+        {
+          uncle = gparent->rb_right;
+          if (rb_is_red(uncle))
+            {
+              uncle->rb_color   = RB_BLACK;
+              parent->rb_color  = RB_BLACK;
+              gparent->rb_color = RB_RED;
+              node              = gparent;
+              continue;
+            }
+
+          if (node == parent->rb_right)
+            {
+              rb_rotate_left(root, parent, update);
+              node   = parent;
+              parent = node->rb_parent;
+            }
+
+          parent->rb_color  = RB_BLACK;
+          gparent->rb_color = RB_RED;
+          rb_rotate_right(root, gparent, update);
+        }
+      else
+        {
+          uncle = gparent->rb_left;
+          if (rb_is_red(uncle))
+            {
+              uncle->rb_color   = RB_BLACK;
+              parent->rb_color  = RB_BLACK;
+              gparent->rb_color = RB_RED;
+              node              = gparent;
+              continue;
+            }
+
+          if (node == parent->rb_left)
+            {
+              rb_rotate_right(root, parent, update);
+              node   = parent;
+              parent = node->rb_parent;
+            }
+
+          parent->rb_color  = RB_BLACK;
+          gparent->rb_color = RB_RED;
+          rb_rotate_left(root, gparent, update);
+        }
+    }
+
+  root->rb_node->rb_color = RB_BLACK;
+}
+
+/* Restore the black height after a black node was taken out above node,
+ * which may be a NULL leaf and so comes with its parent.
+ */
+
+static void rb_erase_fixup(FAR struct rb_root_s *root,
+                           FAR struct rb_node_s *node,
+                           FAR struct rb_node_s *parent,
+                           rb_augment_t update)
+{
+  FAR struct rb_node_s *sibling;
+
+  while (node != root->rb_node && rb_is_black(node))
+    {
+      if (node == parent->rb_left)
+        {
+          sibling = parent->rb_right;
+          if (rb_is_red(sibling))
+            {
+              sibling->rb_color = RB_BLACK;
+              parent->rb_color  = RB_RED;
+              rb_rotate_left(root, parent, update);
+              sibling = parent->rb_right;
+            }
+
+          if (rb_is_black(sibling->rb_left) &&
+              rb_is_black(sibling->rb_right))
+            {
+              sibling->rb_color = RB_RED;
+              node              = parent;
+              parent            = node->rb_parent;
+              continue;
+            }
+
+          if (rb_is_black(sibling->rb_right))
+            {
+              sibling->rb_left->rb_color = RB_BLACK;
+              sibling->rb_color          = RB_RED;
+              rb_rotate_right(root, sibling, update);
+              sibling = parent->rb_right;
+            }
+
+          sibling->rb_color           = parent->rb_color;
+          parent->rb_color            = RB_BLACK;
+          sibling->rb_right->rb_color = RB_BLACK;
+          rb_rotate_left(root, parent, update);
+        }
+      else
+        {
+          sibling = parent->rb_left;
+          if (rb_is_red(sibling))
+            {
+              sibling->rb_color = RB_BLACK;
+              parent->rb_color  = RB_RED;
+              rb_rotate_right(root, parent, update);
+              sibling = parent->rb_left;
+            }
+
+          if (rb_is_black(sibling->rb_left) &&
+              rb_is_black(sibling->rb_right))
+            {
+              sibling->rb_color = RB_RED;
+              node              = parent;
+              parent            = node->rb_parent;
+              continue;
+            }
+
+          if (rb_is_black(sibling->rb_left))
+            {
+              sibling->rb_right->rb_color = RB_BLACK;
+              sibling->rb_color           = RB_RED;
+              rb_rotate_left(root, sibling, update);
+              sibling = parent->rb_left;
+            }
+
+          sibling->rb_color          = parent->rb_color;
+          parent->rb_color           = RB_BLACK;
+          sibling->rb_left->rb_color = RB_BLACK;
+          rb_rotate_right(root, parent, update);
+        }
+
+      node = root->rb_node;
+      break;
+    }
+
+  if (node != NULL)
+    {
+      node->rb_color = RB_BLACK;
+    }
+}
+
+static void rb_erase_node(FAR struct rb_root_s *root,
+                          FAR struct rb_node_s *node,
+                          rb_augment_t update)
+{
+  FAR struct rb_node_s *child;
+  FAR struct rb_node_s *parent;
+  FAR struct rb_node_s *next;
+  uint8_t color;
+
+  if (node->rb_left == NULL || node->rb_right == NULL)
+    {
+      child  = node->rb_left != NULL ? node->rb_left : node->rb_right;
+      parent = node->rb_parent;
+      color  = node->rb_color;
+
+      if (child != NULL)
+        {
+          child->rb_parent = parent;
+        }
+
+      rb_replace_child(root, parent, node, child);
+    }
+  else
+    {
+      /* Put the successor, which has no left child, in place of node */
+
+      next = node->rb_right;
+      while (next->rb_left != NULL)
+        {
+          next = next->rb_left;
+        }
+
+      child = next->rb_right;
+      color = next->rb_color;
+
+      if (next->rb_parent == node)
+        {
+          parent = next;
+        }
+      else
+        {
+          parent          = next->rb_parent;
+          parent->rb_left = child;
+          if (child != NULL)
+            {
+              child->rb_parent = parent;
+            }
+
+          next->rb_right             = node->rb_right;
+          node->rb_right->rb_parent  = next;
+        }
+
+      next->rb_left             = node->rb_left;
+      node->rb_left->rb_parent  = next;
+      next->rb_parent           = node->rb_parent;
+      next->rb_color            = node->rb_color;
+      rb_replace_child(root, node->rb_parent, node, next);
+    }
+
+  /* The nodes from where the tree changed up to the root lost a member,
+   * the successor is among them.
+   */
+
+  if (update != NULL && parent != NULL)
+    {
+      rb_augment_propagate(parent, update);
+    }
+
+  if (color == RB_BLACK)
+    {
+      rb_erase_fixup(root, child, parent, update);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rb_insert_color
+ *
+ * Description:
+ *   Rebalance the tree after a node was attached with rb_link_node().
+ *
+ ****************************************************************************/
+
+void rb_insert_color(FAR struct rb_root_s *root, FAR struct rb_node_s *node)
+{
+  DEBUGASSERT(root != NULL && node != NULL);
+
+  rb_insert_fixup(root, node, NULL);
+}
+
+/****************************************************************************
+ * Name: rb_erase
+ *
+ * Description:
+ *   Remove a node from the tree.
+ *
+ ****************************************************************************/
+
+void rb_erase(FAR struct rb_root_s *root, FAR struct rb_node_s *node)
+{
+  DEBUGASSERT(root != NULL && node != NULL);
+
+  rb_erase_node(root, node, NULL);
+}
+
+/****************************************************************************
+ * Name: rb_insert_augmented
+ *
+ * Description:
+ *   Rebalance the tree after a node was attached with rb_link_node(), and
+ *   update the augmented values on the way.
+ *
+ ****************************************************************************/
+
+void rb_insert_augmented(FAR struct rb_root_s *root,
+                         FAR struct rb_node_s *node, rb_augment_t update)
+{
+  DEBUGASSERT(root != NULL && node != NULL && update != NULL);
+
+  rb_augment_propagate(node, update);
+  rb_insert_fixup(root, node, update);
+}
+
+/****************************************************************************
+ * Name: rb_erase_augmented
+ *
+ * Description:
+ *   Remove a node from the tree and update the augmented values.
+ *
+ ****************************************************************************/
+
+void rb_erase_augmented(FAR struct rb_root_s *root,
+                        FAR struct rb_node_s *node, rb_augment_t update)
+{
+  DEBUGASSERT(root != NULL && node != NULL && update != NULL);
+
+  rb_erase_node(root, node, update);
+}
+
+/****************************************************************************
+ * Name: rb_augment_propagate
+ *
+ * Description:
+ *   Recompute the augmented value of node and all of its ancestors.
+ *
+ ****************************************************************************/
+
+void rb_augment_propagate(FAR struct rb_node_s *node, rb_augment_t update)
+{
+  for (; node != NULL; node = node->rb_parent)
+    {
+      update(node);
+    }
+}
+
+/****************************************************************************
+ * Name: rb_first / rb_last
+ *
+ * Description:
+ *   Return the smallest or the largest node, NULL if the tree is empty.
+ *
+ ****************************************************************************/
+
+FAR struct rb_node_s *rb_first(FAR const struct rb_root_s *root)
+{
+  FAR struct rb_node_s *node = root->rb_node;
+
+  if (node != NULL)
+    {
+      while (node->rb_left != NULL)
+        {
+          node = node->rb_left;
+        }
+    }
+
+  return node;
+}
+
+FAR struct rb_node_s *rb_last(FAR const struct rb_root_s *root)
+{
+  FAR struct rb_node_s *node = root->rb_node;
+
+  if (node != NULL)
+    {
+      while (node->rb_right != NULL)
+        {
+          node = node->rb_right;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: rb_next / rb_prev
+ *
+ * Description:
+ *   Return the following or the preceding node in order, NULL at the end.
+ *
+ ****************************************************************************/
+
+FAR struct rb_node_s *rb_next(FAR const struct rb_node_s *node)
+{
+  FAR struct rb_node_s *parent;
+
+  if (node->rb_right != NULL)
+    {
+      node = node->rb_right;
+      while (node->rb_left != NULL)
+        {
+          node = node->rb_left;
+        }
+
+      return (FAR struct rb_node_s *)node;
+    }
+
+  while ((parent = node->rb_parent) != NULL && node == parent->rb_right)
+    {
+      node = parent;
+    }
+
+  return parent;
+}
+
+FAR struct rb_node_s *rb_prev(FAR const struct rb_node_s *node)
+{
+  FAR struct rb_node_s *parent;
+
+  if (node->rb_left != NULL)
+    {
+      node = node->rb_left;
+      while (node->rb_right != NULL)
+        {
+          node = node->rb_right;
+        }
+
+      return (FAR struct rb_node_s *)node;
+    }
+
+  while ((parent = node->rb_parent) != NULL && node == parent->rb_left)
+    {
+      node = parent;
+    }
+
+  return parent;
+}
@@ -30,6 +30,31 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_bspack_put
+ *
+ * Description:
+ *   Append one argument to a lib_vbspack() buffer.
+ *
+ ****************************************************************************/
+
+static bool lib_bspack_put(FAR char *buf, size_t size, FAR size_t *offset,
+                           FAR const void *arg, size_t len)
+{
+  if (*offset + len > size)
+    {
+      return false;
+    }
+
+  memcpy(buf + *offset, arg, len);
+  *offset += len;
+  return true;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -83,6 +108,7 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           len = 0;
           infmt = true;
+          prec = NULL;
           memset(fmtstr, 0, sizeof(fmtstr));
         }
 
@@ -167,6 +193,13 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
           sprintf(fmtstr + len - 1, "%d", var->i);
           len = strlen(fmtstr);
           offset += sizeof(var->i);
+
+          /* Parse a '*' precision back from the format string */
+
+          if (prec != NULL)
+            {
+              prec = strchr(fmtstr, '.') + 1;
+            }
         }
       else if (c == 's')
         {
@@ -193,7 +226,201 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           prec = fmt;
         }
+      else if (c == '%' && len == 2)
+        {
+          lib_stream_putc(s, c);
+          ret++;
+          infmt = false;
+        }
     }
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: lib_vbspack
+ *
+ * Description:
+ *   The reverse of lib_bsprintf(): pack the arguments of a format into a
+ *   buffer in the layout that lib_bsprintf() expects, so that a message
+ *   can be formatted later from the format string and the buffer.  Strings
+ *   are copied into the buffer.  The arguments that do not fit are dropped.
+ *
+ * Input Parameters:
+ *   buf  - The buffer receiving the packed arguments
+ *   size - The size of the buffer
+ *   fmt  - The format string
+ *   ap   - The arguments of the format
+ *
+ * Returned Value:
+ *   The number of bytes used in the buffer.
+ *
+ ****************************************************************************/
+
+size_t lib_vbspack(FAR void *buf, size_t size, FAR const IPTR char *fmt,
+                   va_list ap)
+{
+  FAR char *data = buf;
+  FAR const char *prec = NULL;
+  bool infmt = false;
+  size_t offset = 0;
+  long precval = -1;
+  bool ok = true;
+  char c;
+
+  while (ok && (c = *fmt++) != '\0')
+    {
+      if (c != '%' && !infmt)
+        {
+          continue;
+        }
+
+      if (!infmt)
+        {
+          infmt = true;
+          prec = NULL;
+          precval = -1;
+          continue;
+        }
+
+      if (c == '%' && *(fmt - 2) == '%')
+        {
+          infmt = false;
+        }
+      else if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+          c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              intmax_t im = va_arg(ap, intmax_t);
+              ok = lib_bspack_put(data, size, &offset, &im, sizeof(im));
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              long long ll = va_arg(ap, long long);
+              ok = lib_bspack_put(data, size, &offset, &ll, sizeof(ll));
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              long l = va_arg(ap, long);
+              ok = lib_bspack_put(data, size, &offset, &l, sizeof(l));
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              size_t sz = va_arg(ap, size_t);
+              ok = lib_bspack_put(data, size, &offset, &sz, sizeof(sz));
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              ptrdiff_t pd = va_arg(ap, ptrdiff_t);
+              ok = lib_bspack_put(data, size, &offset, &pd, sizeof(pd));
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              char ch = (char)va_arg(ap, int);
+              ok = lib_bspack_put(data, size, &offset, &ch, sizeof(ch));
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              short int si = (short int)va_arg(ap, int);
+              ok = lib_bspack_put(data, size, &offset, &si, sizeof(si));
+            }
+          else
+            {
+              int i = va_arg(ap, int);
+              ok = lib_bspack_put(data, size, &offset, &i, sizeof(i));
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              float f = (float)va_arg(ap, double);
+              ok = lib_bspack_put(data, size, &offset, &f, sizeof(f));
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              long double ld = va_arg(ap, long double);
+              ok = lib_bspack_put(data, size, &offset, &ld, sizeof(ld));
+            }
+#  endif
+          else
+            {
+              double d = va_arg(ap, double);
+              ok = lib_bspack_put(data, size, &offset, &d, sizeof(d));
+            }
+
+          infmt = false;
+#endif
+        }
+      else if (c == '*')
+        {
+          int i = va_arg(ap, int);
+
+          ok = lib_bspack_put(data, size, &offset, &i, sizeof(i));
+          if (prec != NULL)
+            {
+              precval = i;
+            }
+        }
+      else if (c == 's')
+        {
+          FAR const char *s = va_arg(ap, FAR const char *);
+          size_t slen;
+          size_t n;
+
+          if (s == NULL)
+            {
+              s = "(null)";
+            }
+
+          /* lib_bsprintf() expects exactly 'precision' bytes if given,
+           * the NUL terminated string otherwise.
+           */
+
+          slen = strlen(s);
+          if (prec != NULL)
+            {
+              n = precval >= 0 ? precval : strtol(prec, NULL, 10);
+            }
+          else
+            {
+              n = slen + 1;
+            }
+
+          if (offset + n > size)
+            {
+              break;
+            }
+
+          if (slen > n)
+            {
+              slen = n;
+            }
+
+          memcpy(data + offset, s, slen);
+          memset(data + offset + slen, 0, n - slen);
+          offset += n;
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+          uintptr_t p = (uintptr_t)va_arg(ap, FAR void *);
+          ok = lib_bspack_put(data, size, &offset, &p, sizeof(p));
+          infmt = false;
+        }
+      else if (c == '.')
+        {
+          prec = fmt;
+        }
+    }
+
+  return offset;
+}
@@ -68,6 +68,12 @@
 #define stream_putc(c,stream)  (total_len++, lib_stream_putc(stream, c))
 #define stream_puts(buf, len, stream) \
         (total_len += len, lib_stream_puts(stream, buf, len))
+#define stream_fill(c, len, stream) \
+        (total_len += len, vsprintf_fill(stream, c, len))
+
+/* Size of the constant runs used to emit padding with puts() */
+
+#define FILL_CHUNK         16
 
 /* Order is relevant here and matches order in format string */
 
@@ -141,6 +147,8 @@ struct arg_s
  ****************************************************************************/
 
 static const char g_nullstring[] = "(null)";
+static const char g_spaces[FILL_CHUNK + 1] = "                ";
+static const char g_zeros[FILL_CHUNK + 1] = "0000000000000000";
 
 /****************************************************************************
  * Private Function Prototypes
@@ -155,6 +163,29 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: vsprintf_fill
+ *
+ * Description:
+ *   Emit 'len' copies of a space or '0' in chunks, so field padding costs
+ *   one puts() call per FILL_CHUNK characters instead of one putc() each.
+ *
+ ****************************************************************************/
+
+static void vsprintf_fill(FAR struct lib_outstream_s *stream, char c,
+                          int len)
+{
+  FAR const char *pad = c == '0' ? g_zeros : g_spaces;
+
+  while (len > 0)
+    {
+      int n = MIN(len, FILL_CHUNK);
+
+      lib_stream_puts(stream, pad, n);
+      len -= n;
+    }
+}
+
 static int vsprintf_internal(FAR struct lib_outstream_s *stream,
                              FAR struct arg_s *arglist, int numargs,
                              FAR const IPTR char *fmt, va_list ap)
@@ -194,6 +225,27 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Copy a run of literal text with a single puts() */
+
+          pnt = fmt;
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+          size = fmt - pnt;
+          if (size > 0)
+            {
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+              if (stream != NULL)
+#  endif
+                {
+                  stream_puts(pnt, size, stream);
+                }
+            }
+
+#endif
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -933,13 +985,10 @@ flt_oper:
           size = strnlen(pnt, (flags & FL_PREC) ? prec : ~0);
 
 str_lpad:
-          if ((flags & FL_LPAD) == 0)
+          if ((flags & FL_LPAD) == 0 && size < width)
             {
-              while (size < width)
-                {
-                  stream_putc(' ', stream);
-                  width--;
-                }
+              stream_fill(' ', width - size, stream);
+              width = size;
             }
 
           stream_puts(pnt, size, stream);
@@ -1274,10 +1323,10 @@ str_lpad:
                 }
             }
 
-          while (len < width)
+          if (len < width)
             {
-              stream_putc(' ', stream);
-              len++;
+              stream_fill(' ', width - len, stream);
+              len = width;
             }
         }
 
@@ -1307,25 +1356,39 @@ str_lpad:
           stream_putc(z, stream);
         }
 
-      while (prec > c)
+      if (prec > c)
         {
-          stream_putc('0', stream);
-          prec--;
+          stream_fill('0', prec - c, stream);
         }
 
-      while (c)
+      /* __ultoa_invert() leaves the digits in reverse order, put them
+       * right in place and emit the whole number with one puts().
+       */
+
+      if (c > 0)
         {
-          stream_putc(buf[--c], stream);
+          FAR char *lo = buf;
+          FAR char *hi = buf + c - 1;
+
+          while (lo < hi)
+            {
+              char tmp = *lo;
+
+              *lo++ = *hi;
+              *hi-- = tmp;
+            }
+
+          stream_puts(buf, c, stream);
         }
 
 tail:
 
       /* Tail is possible.  */
 
-      while (width)
+      if (width > 0)
         {
-          stream_putc(' ', stream);
-          width--;
+          stream_fill(' ', width, stream);
+          width = 0;
         }
     }
 
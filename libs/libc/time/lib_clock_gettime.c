@@ -0,0 +1,113 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/clock_vdso.h>
+
+/* The kernel keeps its own clock_gettime(), only user space reads the page */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct clock_vdso_s *g_clock_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Read CLOCK_MONOTONIC, CLOCK_BOOTTIME and, where the kernel allows it,
+ *   CLOCK_REALTIME from the time page published by the kernel.  All other
+ *   clocks, and all clocks before the page is known, go through the
+ *   nxclock_gettime() system call.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct clock_vdso_s *vdso = g_clock_vdso;
+  struct timespec base;
+  clock_t ticks;
+  uint32_t seq;
+  bool realtime;
+  int ret;
+
+  if (vdso == NULL)
+    {
+      /* Racing tasks all get the same pointer */
+
+      vdso = nxclock_vdso();
+      g_clock_vdso = vdso;
+    }
+
+  if (vdso != NULL && tp != NULL &&
+      (clock_id == CLOCK_MONOTONIC || clock_id == CLOCK_BOOTTIME ||
+       (clock_id == CLOCK_REALTIME && vdso->realtime)))
+    {
+      realtime = clock_id == CLOCK_REALTIME;
+
+      do
+        {
+          seq   = read_seqbegin(&vdso->seq);
+          ticks = vdso->ticks;
+          if (realtime)
+            {
+              base = vdso->basetime;
+            }
+        }
+      while (read_seqretry(&vdso->seq, seq));
+
+      clock_ticks2time(tp, ticks);
+      if (realtime)
+        {
+          clock_timespec_add(&base, tp, tp);
+        }
+
+      return OK;
+    }
+
+  ret = nxclock_gettime(clock_id, tp);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
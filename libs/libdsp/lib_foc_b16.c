@@ -462,3 +462,64 @@ void foc_vdq_mag_max_get_b16(FAR struct foc_data_b16_s *foc, FAR b16_t *max)
 
   *max = foc->vdq_mag_max;
 }
+
+/****************************************************************************
+ * Name: foc_current_control_batch_b16
+ *
+ * Description:
+ *   Process FOC current control of n motors in one call.
+ *
+ * Input Parameters:
+ *   foc      - (in/out) array of n FOC data
+ *   idq_ref  - (in) array of n current dq reference frames
+ *   vdq_comp - (in) array of n voltage dq compensation frames
+ *   vdq_ref  - (out) array of n voltage dq reference frames
+ *   n        - number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_current_control_batch_b16(FAR struct foc_data_b16_s *foc,
+                                   FAR dq_frame_b16_t *idq_ref,
+                                   FAR dq_frame_b16_t *vdq_comp,
+                                   FAR dq_frame_b16_t *vdq_ref,
+                                   int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      foc_current_control_b16(&foc[i], &idq_ref[i], &vdq_comp[i],
+                              &vdq_ref[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: foc_voltage_control_batch_b16
+ *
+ * Description:
+ *   Process FOC voltage control of n motors in one call.
+ *
+ * Input Parameters:
+ *   foc     - (in/out) array of n FOC data
+ *   vdq_ref - (in) array of n voltage dq reference frames
+ *   n       - number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void foc_voltage_control_batch_b16(FAR struct foc_data_b16_s *foc,
+                                   FAR dq_frame_b16_t *vdq_ref,
+                                   int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      foc_voltage_control_b16(&foc[i], &vdq_ref[i]);
+    }
+}
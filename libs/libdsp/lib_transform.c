@@ -149,3 +149,144 @@ void inv_park_transform(FAR phase_angle_f32_t *angle,
   ab->a = angle->cos * dq->d - angle->sin * dq->q;
   ab->b = angle->cos * dq->q + angle->sin * dq->d;
 }
+
+/****************************************************************************
+ * Name: clarke_transform_batch
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame) of n frames, e.g. of n
+ *   motors, in one call.
+ *
+ *   The loop makes no calls, so that the compiler can vectorize it for
+ *   the SIMD unit of the target (Helium, NEON, RISC-V V).
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch(FAR abc_frame_f32_t *abc,
+                            FAR ab_frame_f32_t *ab,
+                            int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = abc[i].a;
+      ab[i].b = ONE_BY_SQRT3_F*abc[i].a + TWO_BY_SQRT3_F*abc[i].b;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch
+ *
+ * Description:
+ *   Inverse Clarke transform (ab frame -> abc frame) of n frames.
+ *
+ * Input Parameters:
+ *   ab  - (in) array of n alpha-beta frames
+ *   abc - (out) array of n abc frames
+ *   n   - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch(FAR ab_frame_f32_t *ab,
+                                FAR abc_frame_f32_t *abc,
+                                int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      abc[i].a = ab[i].a;
+      abc[i].b = -0.5f*ab[i].a + SQRT3_BY_TWO_F*ab[i].b;
+      abc[i].c = -abc[i].a - abc[i].b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame) of n frames, each with its
+ *   own phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch(FAR phase_angle_f32_t *angle,
+                          FAR ab_frame_f32_t *ab,
+                          FAR dq_frame_f32_t *dq,
+                          int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      dq[i].d = angle[i].cos * ab[i].a + angle[i].sin * ab[i].b;
+      dq[i].q = angle[i].cos * ab[i].b - angle[i].sin * ab[i].a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame) of n frames, each
+ *   with its own phase angle.
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - number of frames
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch(FAR phase_angle_f32_t *angle,
+                              FAR dq_frame_f32_t *dq,
+                              FAR ab_frame_f32_t *ab,
+                              int n)
+{
+  int i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = angle[i].cos * dq[i].d - angle[i].sin * dq[i].q;
+      ab[i].b = angle[i].cos * dq[i].q + angle[i].sin * dq[i].d;
+    }
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_atan2f.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TAN_PI_8        0.414213562373095049F
+#define PI_4_F          ((float)M_PI_4)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* atan(t) for t in [0, 1], minimax polynomial on [0, tan(pi/8)]
+ * (coefficients as in Cephes)
+ */
+
+static float atanf_kernel(float t)
+{
+  float a = 0.0F;
+  float z;
+
+  if (t > TAN_PI_8)
+    {
+      a = PI_4_F;
+      t = (t - 1.0F) / (t + 1.0F);
+    }
+
+  z = t * t;
+  return a + (((8.05374449538E-2F * z - 1.38776856032E-1F) * z +
+                1.99777106478E-1F) * z - 3.33329491539E-1F) * z * t + t;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float atan2f(float y, float x)
+{
+  float ax = fabsf(x);
+  float ay = fabsf(y);
+  float a;
+
+  if (isnanf(x) || isnanf(y))
+    {
+      return x + y;
+    }
+
+  if (ay == 0.0F && ax == 0.0F)
+    {
+      a = 0.0F;
+    }
+  else if (isinff(ax) && isinff(ay))
+    {
+      a = PI_4_F;
+    }
+  else if (ay <= ax)
+    {
+      a = atanf_kernel(ay / ax);
+    }
+  else
+    {
+      a = M_PI_2_F - atanf_kernel(ax / ay);
+    }
+
+  if (signbit(x))
+    {
+      a = M_PI_F - a;
+    }
+
+  return signbit(y) ? -a : a;
+}
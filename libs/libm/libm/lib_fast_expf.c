@@ -0,0 +1,127 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_expf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define EXPF_MAX_X      88.7228394F
+#define EXPF_MIN_X      -103.972084F
+
+/* 32 / ln(2) and ln(2) / 32 split in two parts */
+
+#define INV_LN2_32      46.1662413084F
+#define LN2_32_HI       2.16522216796875E-2F
+#define LN2_32_LO       8.627713214082178E-6F
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 2^(j/32), j = 0..31, as IEEE 754 single precision bit patterns */
+
+static const uint32_t g_exp2_tab[32] =
+{
+  0x3f800000, 0x3f82cd87, 0x3f85aac3, 0x3f88980f,
+  0x3f8b95c2, 0x3f8ea43a, 0x3f91c3d3, 0x3f94f4f0,
+  0x3f9837f0, 0x3f9b8d3a, 0x3f9ef532, 0x3fa27043,
+  0x3fa5fed7, 0x3fa9a15b, 0x3fad583f, 0x3fb123f6,
+  0x3fb504f3, 0x3fb8fbaf, 0x3fbd08a4, 0x3fc12c4d,
+  0x3fc5672a, 0x3fc9b9be, 0x3fce248c, 0x3fd2a81e,
+  0x3fd744fd, 0x3fdbfbb8, 0x3fe0ccdf, 0x3fe5b907,
+  0x3feac0c7, 0x3fefe4ba, 0x3ff5257d, 0x3ffa83b3,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static float expf_scale(float y, int32_t e)
+{
+  union
+  {
+    float    f;
+    uint32_t u;
+  } s;
+
+  if (e > 127)
+    {
+      y *= 2.0F;
+      e--;
+    }
+  else if (e < -126)
+    {
+      y *= 5.42101086e-20F; /* 2^-64 */
+      e += 64;
+    }
+
+  s.u = (uint32_t)(e + 127) << 23;
+  return y * s.f;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* exp(x) = 2^(k/32) * exp(r), with k = round(x * 32 / ln2) and
+ * |r| <= ln2 / 64, so that a degree 4 polynomial is enough for exp(r).
+ */
+
+float expf(float x)
+{
+  union
+  {
+    float    f;
+    uint32_t u;
+  } t;
+
+  int32_t k;
+  float r;
+  float p;
+
+  if (isnanf(x))
+    {
+      return x;
+    }
+  else if (x > EXPF_MAX_X)
+    {
+      return INFINITY_F;
+    }
+  else if (x < EXPF_MIN_X)
+    {
+      return 0.0F;
+    }
+
+  k = (int32_t)(x * INV_LN2_32 + (x < 0.0F ? -0.5F : 0.5F));
+  r = (x - k * LN2_32_HI) - k * LN2_32_LO;
+  p = r + r * r * (0.5F + r * (1.6666667163E-1F + r * 4.1666667908E-2F));
+
+  t.u = g_exp2_tab[k & 31];
+  return expf_scale(t.f + t.f * p, (k - (k & 31)) / 32);
+}
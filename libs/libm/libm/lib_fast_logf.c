@@ -0,0 +1,117 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_logf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <math.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SQRT_HALF       0.707106781186547524F
+
+/* ln(2) split in two parts */
+
+#define LN2_HI          0.693359375F
+#define LN2_LO          -2.12194440E-4F
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* log(x) = e * ln2 + log(m), with x = m * 2^e and m in [sqrt(1/2),
+ * sqrt(2)), log(1 + f) comes from a minimax polynomial (coefficients as
+ * in Cephes).
+ */
+
+float logf(float x)
+{
+  union
+  {
+    float    f;
+    uint32_t u;
+  } m;
+
+  int32_t e = 0;
+  float f;
+  float y;
+  float z;
+
+  if (isnanf(x))
+    {
+      return x;
+    }
+  else if (x < 0.0F)
+    {
+      set_errno(EDOM);
+      return NAN_F;
+    }
+  else if (x == 0.0F)
+    {
+      set_errno(ERANGE);
+      return -INFINITY_F;
+    }
+  else if (isinff(x))
+    {
+      return x;
+    }
+
+  m.f = x;
+  if ((m.u >> 23) == 0)
+    {
+      /* Subnormal, normalize it first */
+
+      m.f *= 33554432.0F; /* 2^25 */
+      e = -25;
+    }
+
+  e += (int32_t)(m.u >> 23) - 126;
+  m.u = (m.u & 0x007fffff) | 0x3f000000;
+
+  if (m.f < SQRT_HALF)
+    {
+      e--;
+      f = m.f + m.f - 1.0F;
+    }
+  else
+    {
+      f = m.f - 1.0F;
+    }
+
+  z = f * f;
+  y = ((((((((7.0376836292E-2F * f - 1.1514610310E-1F) * f +
+             1.1676998740E-1F) * f - 1.2420140846E-1F) * f +
+             1.4249322787E-1F) * f - 1.6668057665E-1F) * f +
+             2.0000714765E-1F) * f - 2.4999993993E-1F) * f +
+             3.3333331174E-1F) * f * z;
+
+  y += LN2_LO * e;
+  y -= 0.5F * z;
+  return f + y + LN2_HI * e;
+}
@@ -0,0 +1,182 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_sincosf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi/2 split in four parts for the Cody-Waite reduction; the first three
+ * have short mantissas so that k * part is exact for |k| < 2^15.
+ */
+
+#define PIO2_1      1.5703125F
+#define PIO2_2      4.8351287841796875E-4F
+#define PIO2_3      3.1385570764541626E-7F
+#define PIO2_4      6.077094383272197E-11F
+#define TWO_BY_PI   0.636619772367581343F
+
+/* Beyond this the reduction loses precision, fall back to fmodf() */
+
+#define REDUCE_MAX  32768.0F
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Reduce x to r in [-pi/4, pi/4] and return the quadrant x lies in */
+
+static int sincosf_reduce(float x, FAR float *r)
+{
+  int32_t k;
+
+  if (!(fabsf(x) < REDUCE_MAX))
+    {
+      x = fmodf(x, 2 * M_PI_F);
+    }
+
+  k = (int32_t)(x * TWO_BY_PI + (x < 0.0F ? -0.5F : 0.5F));
+  *r = (((x - k * PIO2_1) - k * PIO2_2) - k * PIO2_3) - k * PIO2_4;
+  return (int)k;
+}
+
+/* Minimax polynomials on [-pi/4, pi/4] (coefficients as in Cephes) */
+
+static float sinf_kernel(float r)
+{
+  float z = r * r;
+
+  return r + r * z * (-1.6666654611E-1F + z * (8.3321608736E-3F +
+                      z * -1.9515295891E-4F));
+}
+
+static float cosf_kernel(float r)
+{
+  float z = r * r;
+
+  return 1.0F - 0.5F * z + z * z * (4.166664568298827E-2F +
+         z * (-1.388731625493765E-3F + z * 2.443315711809948E-5F));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+float sinf(float x)
+{
+  float r;
+
+  if (isnanf(x) || isinff(x))
+    {
+      return NAN_F;
+    }
+
+  switch (sincosf_reduce(x, &r) & 3)
+    {
+      case 0:
+        return sinf_kernel(r);
+
+      case 1:
+        return cosf_kernel(r);
+
+      case 2:
+        return -sinf_kernel(r);
+
+      default:
+        return -cosf_kernel(r);
+    }
+}
+
+float cosf(float x)
+{
+  float r;
+
+  if (isnanf(x) || isinff(x))
+    {
+      return NAN_F;
+    }
+
+  switch (sincosf_reduce(x, &r) & 3)
+    {
+      case 0:
+        return cosf_kernel(r);
+
+      case 1:
+        return -sinf_kernel(r);
+
+      case 2:
+        return -cosf_kernel(r);
+
+      default:
+        return sinf_kernel(r);
+    }
+}
+
+void sincosf(float x, FAR float *s, FAR float *c)
+{
+  float sr;
+  float cr;
+  float r;
+  int q;
+
+  if (isnanf(x) || isinff(x))
+    {
+      *s = NAN_F;
+      *c = NAN_F;
+      return;
+    }
+
+  q = sincosf_reduce(x, &r);
+  sr = sinf_kernel(r);
+  cr = cosf_kernel(r);
+
+  switch (q & 3)
+    {
+      case 0:
+        *s = sr;
+        *c = cr;
+        break;
+
+      case 1:
+        *s = cr;
+        *c = -sr;
+        break;
+
+      case 2:
+        *s = -sr;
+        *c = -cr;
+        break;
+
+      default:
+        *s = -cr;
+        *c = sr;
+        break;
+    }
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fast_sqrtf.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdint.h>
+#include <math.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* 1 / sqrt(x) from the bit pattern of x refined by two Newton steps,
+ * then sqrt(x) = x / sqrt(x) with one more correction step: there is no
+ * division at all, which is what soft-float parts pay most for.
+ */
+
+#ifndef CONFIG_LIBM_ARCH_SQRTF
+float sqrtf(float x)
+{
+  union
+  {
+    float    f;
+    uint32_t u;
+  } r;
+
+  float scale = 1.0F;
+  float y;
+
+  if (isnanf(x))
+    {
+      return x;
+    }
+  else if (x < 0.0F)
+    {
+      set_errno(EDOM);
+      return NAN_F;
+    }
+  else if (x == 0.0F || isinff(x))
+    {
+      return x;
+    }
+
+  r.f = x;
+  if ((r.u >> 23) == 0)
+    {
+      /* Subnormal, sqrt(x * 2^24) = sqrt(x) * 2^12 */
+
+      x *= 16777216.0F;
+      scale = 2.44140625E-4F;
+      r.f = x;
+    }
+
+  r.u = 0x5f3759df - (r.u >> 1);
+  r.f = r.f * (1.5F - 0.5F * x * r.f * r.f);
+  r.f = r.f * (1.5F - 0.5F * x * r.f * r.f);
+
+  y = x * r.f;
+  y = y + 0.5F * r.f * (x - y * y);
+  return y * scale;
+}
+#endif
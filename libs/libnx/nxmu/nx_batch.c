@@ -0,0 +1,122 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nx_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_beginbatch
+ *
+ * Description:
+ *   Start collecting the drawing requests of the connection.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_beginbatch(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+  int ret = OK;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  nxmutex_lock(&conn->batchlock);
+  if (conn->batchdepth == UINT8_MAX)
+    {
+      set_errno(EOVERFLOW);
+      ret = ERROR;
+    }
+  else
+    {
+      conn->batchdepth++;
+    }
+
+  nxmutex_unlock(&conn->batchlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_endbatch
+ *
+ * Description:
+ *   End the innermost nx_beginbatch(), at the outermost level submit the
+ *   drawing requests collected so far.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_endbatch(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+  bool submit;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  nxmutex_lock(&conn->batchlock);
+  if (conn->batchdepth == 0)
+    {
+      nxmutex_unlock(&conn->batchlock);
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  submit = --conn->batchdepth == 0;
+  nxmutex_unlock(&conn->batchlock);
+
+  return submit ? nxmu_batch_flush(conn, false) : OK;
+}
@@ -92,6 +92,9 @@ NXHANDLE nx_connectinstance(FAR const char *svrmqname)
   char                    climqname[NX_CLIENT_MXNAMELEN];
   struct mq_attr          attr;
   int                     ret;
+#ifdef CONFIG_NX_BATCH
+  int                     i;
+#endif
 
   /* Sanity checking */
 
@@ -112,6 +115,14 @@ NXHANDLE nx_connectinstance(FAR const char *svrmqname)
       goto errout;
     }
 
+#ifdef CONFIG_NX_BATCH
+  nxmutex_init(&conn->batchlock);
+  for (i = 0; i < CONFIG_NX_BATCH_NBUFFERS; i++)
+    {
+      nxsem_init(&conn->batch[i].done, 0, 0);
+    }
+#endif
+
   /* Create the client MQ name */
 
   nxmutex_lock(&g_nxliblock);
@@ -64,11 +64,23 @@ static inline void nx_connected(FAR struct nxmu_conn_s *conn)
 
 static inline void nx_disconnected(FAR struct nxmu_conn_s *conn)
 {
+#ifdef CONFIG_NX_BATCH
+  int i;
+#endif
+
   /* Close the server and client MQs */
 
   _MQ_CLOSE(conn->cwrmq);
   _MQ_CLOSE(conn->crdmq);
 
+#ifdef CONFIG_NX_BATCH
+  nxmutex_destroy(&conn->batchlock);
+  for (i = 0; i < CONFIG_NX_BATCH_NBUFFERS; i++)
+    {
+      nxsem_destroy(&conn->batch[i].done);
+    }
+#endif
+
   /* And free the client structure */
 
   lib_ufree(conn);
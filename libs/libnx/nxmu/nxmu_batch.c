@@ -0,0 +1,225 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nxmu_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/mqueue.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batch_reclaim
+ *
+ * Description:
+ *   Wait until the server has executed a submitted batch, then empty it.
+ *
+ ****************************************************************************/
+
+static int nxmu_batch_reclaim(FAR struct nxmu_batch_s *batch)
+{
+  int ret;
+
+  if (batch->inflight)
+    {
+      ret = nxsem_wait_uninterruptible(&batch->done);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      batch->inflight = false;
+    }
+
+  batch->nbytes = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmu_batch_submit
+ *
+ * Description:
+ *   Send the current batch to the server and make the next buffer current.
+ *   Called with batchlock held.
+ *
+ ****************************************************************************/
+
+static int nxmu_batch_submit(FAR struct nxmu_conn_s *conn)
+{
+  FAR struct nxmu_batch_s *batch = &conn->batch[conn->batchcur];
+  struct nxsvrmsg_batch_s outmsg;
+  int ret;
+
+  if (batch->nbytes == 0)
+    {
+      return OK;
+    }
+
+  outmsg.msgid = NX_SVRMSG_BATCH;
+  outmsg.batch = batch;
+
+  ret = _MQ_SEND(conn->cwrmq, (FAR const char *)&outmsg,
+                 sizeof(struct nxsvrmsg_batch_s), NX_SVRMSG_PRIO);
+  if (ret < 0)
+    {
+      _NX_SETERRNO(ret);
+      gerr("ERROR: _MQ_SEND failed: %d\n", _NX_GETERRNO(ret));
+
+      /* The commands are lost, as they would be without batching */
+
+      batch->nbytes = 0;
+      return ERROR;
+    }
+
+  batch->inflight = true;
+
+  conn->batchcur = (conn->batchcur + 1) % CONFIG_NX_BATCH_NBUFFERS;
+  return nxmu_batch_reclaim(&conn->batch[conn->batchcur]);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batch_send
+ ****************************************************************************/
+
+int nxmu_batch_send(FAR struct nxmu_conn_s *conn,
+                    FAR const void *msg, size_t msglen)
+{
+  FAR const struct nxsvrmsg_s *svrmsg = msg;
+  FAR struct nxsvrmsg_bitmap_s *bmpmsg = NULL;
+  FAR sem_t *sem_done = NULL;
+  FAR struct nxmu_batch_s *batch;
+  FAR uint8_t *rec;
+  size_t reclen;
+  bool batchable;
+  int ret;
+
+  switch (svrmsg->msgid)
+    {
+      case NX_SVRMSG_SETPIXEL:
+      case NX_SVRMSG_FILL:
+      case NX_SVRMSG_FILLTRAP:
+      case NX_SVRMSG_MOVE:
+      case NX_SVRMSG_BITMAP:
+        batchable = true;
+        break;
+
+      default:
+        batchable = false;
+        break;
+    }
+
+  nxmutex_lock(&conn->batchlock);
+
+  if (conn->batchdepth == 0 || !batchable)
+    {
+      /* Whatever was batched must execute before this message */
+
+      ret = nxmu_batch_submit(conn);
+      nxmutex_unlock(&conn->batchlock);
+      return ret < 0 ? ret : 1;
+    }
+
+  reclen = NXMU_BATCH_HDRLEN + NXMU_BATCH_ALIGN(msglen);
+  DEBUGASSERT(reclen <= sizeof(conn->batch[0].buf));
+
+  batch = &conn->batch[conn->batchcur];
+  if (batch->nbytes + reclen > sizeof(batch->buf))
+    {
+      ret = nxmu_batch_submit(conn);
+      if (ret < 0)
+        {
+          nxmutex_unlock(&conn->batchlock);
+          return ret;
+        }
+
+      batch = &conn->batch[conn->batchcur];
+    }
+
+  rec = (FAR uint8_t *)batch->buf + batch->nbytes;
+  *(FAR uintptr_t *)rec = msglen;
+  memcpy(rec + NXMU_BATCH_HDRLEN, msg, msglen);
+  batch->nbytes += reclen;
+
+  /* nx_bitmap() waits for its completion semaphore before the caller may
+   * release the source image.  Take the semaphore out of the command and
+   * post it once the whole batch has executed.
+   */
+
+  if (svrmsg->msgid == NX_SVRMSG_BITMAP)
+    {
+      bmpmsg = (FAR struct nxsvrmsg_bitmap_s *)(rec + NXMU_BATCH_HDRLEN);
+      sem_done = bmpmsg->sem_done;
+      bmpmsg->sem_done = NULL;
+    }
+
+  nxmutex_unlock(&conn->batchlock);
+
+  if (sem_done != NULL)
+    {
+      ret = nxmu_batch_flush(conn, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nxsem_post(sem_done);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmu_batch_flush
+ ****************************************************************************/
+
+int nxmu_batch_flush(FAR struct nxmu_conn_s *conn, bool wait)
+{
+  int ret;
+  int i;
+
+  nxmutex_lock(&conn->batchlock);
+
+  ret = nxmu_batch_submit(conn);
+  for (i = 0; ret >= 0 && wait && i < CONFIG_NX_BATCH_NBUFFERS; i++)
+    {
+      ret = nxmu_batch_reclaim(&conn->batch[i]);
+    }
+
+  nxmutex_unlock(&conn->batchlock);
+  return ret;
+}
@@ -68,6 +68,16 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn, FAR const void *msg,
     }
 #endif
 
+#ifdef CONFIG_NX_BATCH
+  /* Collect drawing commands between nx_beginbatch() and nx_endbatch() */
+
+  ret = nxmu_batch_send(conn, msg, msglen);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Send the message to the server */
 
   ret = _MQ_SEND(conn->cwrmq, msg, msglen, NX_SVRMSG_PRIO);
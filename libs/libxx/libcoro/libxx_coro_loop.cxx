@@ -0,0 +1,289 @@
+//***************************************************************************
+// libs/libxx/libcoro/libxx_coro_loop.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cerrno>
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include <nuttx/coroutine.hxx>
+
+namespace nuttx
+{
+namespace coro
+{
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: poll_awaiter::await_suspend
+//***************************************************************************
+
+bool poll_awaiter::await_suspend(std::coroutine_handle<> h) noexcept
+{
+  handle = h;
+
+  // Resume at once with EPOLLERR if the descriptor cannot be watched
+
+  if (m_loop.watch(*this) < 0)
+    {
+      m_revents = EPOLLERR;
+      return false;
+    }
+
+  return true;
+}
+
+//***************************************************************************
+// Name: sleep_awaiter
+//***************************************************************************
+
+sleep_awaiter::sleep_awaiter(event_loop &loop, uint32_t msec,
+                             executor *resume_on) noexcept
+  : poll_awaiter(loop, -1, EPOLLIN, resume_on), m_msec(msec)
+{
+}
+
+sleep_awaiter::~sleep_awaiter()
+{
+  if (m_fd >= 0)
+    {
+      close(m_fd);
+    }
+}
+
+bool sleep_awaiter::await_suspend(std::coroutine_handle<> h) noexcept
+{
+  struct itimerspec its =
+  {
+  };
+
+  if (m_msec == 0)
+    {
+      return false;
+    }
+
+  m_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (m_fd < 0)
+    {
+      return false;
+    }
+
+  its.it_value.tv_sec  = m_msec / 1000;
+  its.it_value.tv_nsec = (m_msec % 1000) * 1000000;
+
+  if (timerfd_settime(m_fd, 0, &its, NULL) < 0)
+    {
+      return false;
+    }
+
+  return poll_awaiter::await_suspend(h);
+}
+
+//***************************************************************************
+// Name: event
+//***************************************************************************
+
+event::event()
+{
+  m_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+event::~event()
+{
+  if (m_fd >= 0)
+    {
+      close(m_fd);
+    }
+}
+
+void event::signal(uint64_t count)
+{
+  eventfd_write(m_fd, count);
+}
+
+uint64_t event_awaiter::await_resume() noexcept
+{
+  eventfd_t value = 0;
+
+  if ((m_revents & EPOLLIN) != 0)
+    {
+      eventfd_read(m_fd, &value);
+    }
+
+  return value;
+}
+
+//***************************************************************************
+// Name: event_loop
+//***************************************************************************
+
+event_loop::event_loop()
+  : m_stop(false)
+{
+  struct epoll_event ev;
+
+  sq_init(&m_ready);
+  nxmutex_init(&m_lock);
+
+  m_epfd   = epoll_create1(EPOLL_CLOEXEC);
+  m_wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  // The wakeup descriptor is told apart by its null pointer
+
+  ev.events   = EPOLLIN;
+  ev.data.ptr = NULL;
+  epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_wakefd, &ev);
+}
+
+event_loop::~event_loop()
+{
+  close(m_wakefd);
+  close(m_epfd);
+  nxmutex_destroy(&m_lock);
+}
+
+//***************************************************************************
+// Name: event_loop::post
+//
+// Description:
+//   Queue a coroutine and wake up the loop.  The eventfd write is cheap
+//   when the loop is busy, the counter just grows until the next wait.
+//
+//***************************************************************************
+
+void event_loop::post(waiter &w)
+{
+  nxmutex_lock(&m_lock);
+  sq_addlast(&w.node, &m_ready);
+  nxmutex_unlock(&m_lock);
+
+  eventfd_write(m_wakefd, 1);
+}
+
+//***************************************************************************
+// Name: event_loop::watch
+//
+// Description:
+//   Watch a descriptor for one event.  It is removed from the set before
+//   the coroutine resumes, so that it can be closed right away.
+//
+//***************************************************************************
+
+int event_loop::watch(poll_awaiter &pw)
+{
+  struct epoll_event ev;
+
+  ev.events   = pw.m_events | EPOLLONESHOT;
+  ev.data.ptr = &pw;
+
+  return epoll_ctl(m_epfd, EPOLL_CTL_ADD, pw.m_fd, &ev);
+}
+
+//***************************************************************************
+// Name: event_loop::run
+//***************************************************************************
+
+void event_loop::run()
+{
+  struct epoll_event evs[CONFIG_LIBXX_CORO_NEVENTS];
+  FAR poll_awaiter *pw;
+  FAR waiter *w;
+  sq_queue_t ready;
+  eventfd_t value;
+  int timeout;
+  int nevs;
+  int i;
+
+  while (!m_stop)
+    {
+      // Run what is ready, including what these coroutines post
+
+      for (; ; )
+        {
+          nxmutex_lock(&m_lock);
+          ready = m_ready;
+          sq_init(&m_ready);
+          nxmutex_unlock(&m_lock);
+
+          if (sq_empty(&ready))
+            {
+              break;
+            }
+
+          while ((w = reinterpret_cast<FAR waiter *>(sq_remfirst(&ready)))
+                 != NULL)
+            {
+              w->handle.resume();
+            }
+        }
+
+      timeout = m_stop ? 0 : -1;
+      nevs = epoll_wait(m_epfd, evs, CONFIG_LIBXX_CORO_NEVENTS, timeout);
+
+      for (i = 0; i < nevs; i++)
+        {
+          pw = static_cast<FAR poll_awaiter *>(evs[i].data.ptr);
+          if (pw == NULL)
+            {
+              eventfd_read(m_wakefd, &value);
+              continue;
+            }
+
+          epoll_ctl(m_epfd, EPOLL_CTL_DEL, pw->m_fd, NULL);
+          pw->m_revents = evs[i].events;
+
+          if (pw->m_resume_on != NULL && pw->m_resume_on != this)
+            {
+              pw->m_resume_on->post(*pw);
+            }
+          else
+            {
+              pw->handle.resume();
+            }
+        }
+    }
+}
+
+//***************************************************************************
+// Name: event_loop::stop
+//***************************************************************************
+
+void event_loop::stop()
+{
+  m_stop = true;
+  eventfd_write(m_wakefd, 1);
+}
+
+} // namespace coro
+} // namespace nuttx
@@ -0,0 +1,112 @@
+//***************************************************************************
+// libs/libxx/libcoro/libxx_coro_work.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstring>
+
+#include <nuttx/coroutine.hxx>
+
+#if defined(CONFIG_SCHED_WORKQUEUE) || defined(CONFIG_LIBC_USRWORK)
+
+namespace nuttx
+{
+namespace coro
+{
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+//***************************************************************************
+// Name: work_executor::worker
+//
+// Description:
+//   Drain the queue on the work queue thread.  A single work item serves
+//   the whole queue, so the coroutines of one executor never run
+//   concurrently.
+//
+//***************************************************************************
+
+void work_executor::worker(FAR void *arg)
+{
+  FAR work_executor *self = static_cast<FAR work_executor *>(arg);
+  FAR waiter *w;
+
+  for (; ; )
+    {
+      nxmutex_lock(&self->m_lock);
+      w = reinterpret_cast<FAR waiter *>(sq_remfirst(&self->m_ready));
+      if (w == NULL)
+        {
+          self->m_queued = false;
+          nxmutex_unlock(&self->m_lock);
+          break;
+        }
+
+      nxmutex_unlock(&self->m_lock);
+      w->handle.resume();
+    }
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+work_executor::work_executor(int qid)
+  : m_qid(qid), m_queued(false)
+{
+  memset(&m_work, 0, sizeof(m_work));
+  sq_init(&m_ready);
+  nxmutex_init(&m_lock);
+}
+
+work_executor::~work_executor()
+{
+  work_cancel(m_qid, &m_work);
+  nxmutex_destroy(&m_lock);
+}
+
+void work_executor::post(waiter &w)
+{
+  bool queue;
+
+  nxmutex_lock(&m_lock);
+  sq_addlast(&w.node, &m_ready);
+  queue    = !m_queued;
+  m_queued = true;
+  nxmutex_unlock(&m_lock);
+
+  if (queue)
+    {
+      work_queue(m_qid, &m_work, worker, this, 0);
+    }
+}
+
+} // namespace coro
+} // namespace nuttx
+
+#endif // CONFIG_SCHED_WORKQUEUE || CONFIG_LIBC_USRWORK
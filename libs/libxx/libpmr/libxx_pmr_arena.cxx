@@ -0,0 +1,117 @@
+//***************************************************************************
+// libs/libxx/libpmr/libxx_pmr_arena.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstdint>
+
+#include <nuttx/tls.h>
+#include <nuttx/mm/memory_resource.hxx>
+
+#if CONFIG_TLS_TASK_NELEM > 0
+
+namespace nuttx
+{
+namespace pmr
+{
+
+//***************************************************************************
+// Private Types
+//***************************************************************************
+
+typedef std::pmr::monotonic_buffer_resource task_arena_t;
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static void task_arena_destroy(FAR void *arg)
+{
+  delete static_cast<FAR task_arena_t *>(arg);
+}
+
+static int task_arena_index()
+{
+  // Allocated once, the first time any task asks for its arena
+
+  static int index = task_tls_alloc(task_arena_destroy);
+
+  return index;
+}
+
+static FAR task_arena_t *task_arena_get(bool create)
+{
+  FAR task_arena_t *arena;
+  int index = task_arena_index();
+
+  if (index < 0)
+    {
+      return nullptr;
+    }
+
+  arena = reinterpret_cast<FAR task_arena_t *>(task_tls_get_value(index));
+  if (arena == nullptr && create)
+    {
+      arena = new task_arena_t(CONFIG_LIBXX_PMR_ARENA_SIZE,
+                               std::pmr::new_delete_resource());
+      task_tls_set_value(index, reinterpret_cast<uintptr_t>(arena));
+    }
+
+  return arena;
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+FAR std::pmr::memory_resource *task_arena_resource()
+{
+  FAR task_arena_t *arena = task_arena_get(true);
+
+  // Without a TLS slot, fall back to the heap
+
+  if (arena == nullptr)
+    {
+      return std::pmr::new_delete_resource();
+    }
+
+  return arena;
+}
+
+void task_arena_release()
+{
+  FAR task_arena_t *arena = task_arena_get(false);
+
+  if (arena != nullptr)
+    {
+      arena->release();
+    }
+}
+
+} // namespace pmr
+} // namespace nuttx
+
+#endif // CONFIG_TLS_TASK_NELEM > 0
@@ -0,0 +1,131 @@
+//***************************************************************************
+// libs/libxx/libpmr/libxx_pmr_mempool.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstdlib>
+#include <malloc.h>
+
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/memory_resource.hxx>
+
+namespace nuttx
+{
+namespace pmr
+{
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// The pools grow from the heap of the caller
+
+static FAR void *mempool_resource_alloc(FAR void *arg, size_t alignment,
+                                        size_t size)
+{
+  return memalign(alignment, size);
+}
+
+static size_t mempool_resource_alloc_size(FAR void *arg, FAR void *addr)
+{
+  return malloc_size(addr);
+}
+
+static void mempool_resource_free(FAR void *arg, FAR void *addr)
+{
+  free(addr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+mempool_resource::mempool_resource(FAR const char *name,
+                                   FAR const size_t *poolsize,
+                                   size_t npools, size_t expandsize,
+                                   size_t chunksize,
+                                   FAR std::pmr::memory_resource *upstream)
+  : m_upstream(upstream)
+{
+  m_mpool = mempool_multiple_init(name, poolsize, npools,
+                                  mempool_resource_alloc,
+                                  mempool_resource_alloc_size,
+                                  mempool_resource_free, nullptr,
+                                  chunksize, expandsize, expandsize);
+}
+
+mempool_resource::~mempool_resource()
+{
+  if (m_mpool != nullptr)
+    {
+      mempool_multiple_deinit(m_mpool);
+    }
+}
+
+FAR void *mempool_resource::do_allocate(std::size_t bytes,
+                                        std::size_t alignment)
+{
+  FAR void *p = nullptr;
+
+  if (m_mpool != nullptr)
+    {
+      if (alignment <= MM_ALIGN)
+        {
+          p = mempool_multiple_alloc(m_mpool, bytes);
+        }
+      else
+        {
+          p = mempool_multiple_memalign(m_mpool, alignment, bytes);
+        }
+    }
+
+  // Too large for the pools, or the pools are exhausted
+
+  if (p == nullptr)
+    {
+      p = m_upstream->allocate(bytes, alignment);
+    }
+
+  return p;
+}
+
+void mempool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                     std::size_t alignment)
+{
+  if (m_mpool == nullptr || mempool_multiple_free(m_mpool, p) < 0)
+    {
+      m_upstream->deallocate(p, bytes, alignment);
+    }
+}
+
+bool mempool_resource::do_is_equal(const std::pmr::memory_resource &other)
+  const noexcept
+{
+  return this == &other;
+}
+
+} // namespace pmr
+} // namespace nuttx
@@ -51,6 +51,32 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+/* The per-CPU caches move this many I/O buffers to or from the pool */
+
+#if CONFIG_IOB_PERCPU_CACHE > 1
+#  define IOB_CACHE_BATCH        (CONFIG_IOB_PERCPU_CACHE / 2)
+#else
+#  define IOB_CACHE_BATCH        1
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The free I/O buffers cached by one CPU.  Only that CPU touches it, with
+ * its interrupts disabled.
+ */
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+struct iob_cache_s
+{
+  FAR struct iob_s *head;  /* The cached I/O buffers */
+  int16_t  count;          /* The number of cached I/O buffers */
+  uint32_t hits;           /* Allocations served from the cache */
+  uint32_t misses;         /* Allocations that refilled the cache */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -81,6 +107,10 @@ extern sem_t g_iob_sem;
 
 extern int16_t g_iob_count;
 
+/* Allocations that found no free I/O buffer, waited or failed */
+
+extern uint32_t g_iob_nexhausted;
+
 #if CONFIG_IOB_THROTTLE > 0
 extern sem_t g_throttle_sem;
 
@@ -98,6 +128,12 @@ extern int16_t g_qentry_wait;
 
 extern volatile spinlock_t g_iob_lock;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The free I/O buffers cached by each CPU */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -137,6 +173,44 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a list of pre-allocated I/O buffers, linked through io_flink, to
+ *   the free or committed list in one locked operation.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers in the per-CPU caches.  This function
+ *   is intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+int iob_cache_navail(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the pools of the I/O buffer size classes.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+void iob_class_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -95,6 +95,12 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_flink  = NULL; /* Not in a chain */
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum   = 0;    /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp = 0;    /* No timestamp */
+#endif
       iob->io_pktlen = 0;    /* Total length of the packet */
     }
 
@@ -134,6 +140,12 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
           iob->io_flink  = NULL; /* Not in a chain */
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+          iob->io_csum   = 0;    /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+          iob->io_tstamp = 0;    /* No timestamp */
+#endif
           iob->io_pktlen = 0;    /* Total length of the packet */
           return iob;
         }
@@ -142,6 +154,81 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
   return NULL;
 }
 
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU, refilling a batch of the
+ *   cache from the pool first if it is empty.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+static FAR struct iob_s *iob_cache_alloc(bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* Cached buffers are not counted in the pool, keep them from throttled
+   * allocations once the pool is down to the throttle.
+   */
+
+  if (throttled && g_iob_count <= CONFIG_IOB_THROTTLE)
+    {
+      return NULL;
+    }
+#endif
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+
+  if (cache->head == NULL)
+    {
+      cache->misses++;
+
+      spin_lock(&g_iob_lock);
+      while (cache->count < IOB_CACHE_BATCH &&
+             (iob = iob_tryalloc_internal(throttled)) != NULL)
+        {
+          iob->io_flink = cache->head;
+          cache->head   = iob;
+          cache->count++;
+        }
+
+      spin_unlock(&g_iob_lock);
+    }
+  else
+    {
+      cache->hits++;
+    }
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum   = 0;    /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp = 0;    /* No timestamp */
+#endif
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  up_irq_restore(flags);
+  return iob;
+}
+#endif
+
 /****************************************************************************
  * Name: iob_allocwait
  *
@@ -180,6 +267,8 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   iob = iob_tryalloc_internal(throttled);
   if (iob == NULL)
     {
+      g_iob_nexhausted++;
+
 #if CONFIG_IOB_THROTTLE > 0
       if (throttled)
         {
@@ -268,6 +357,15 @@ FAR struct iob_s *iob_timedalloc(bool throttled, unsigned int timeout)
     }
   else
     {
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      FAR struct iob_s *iob = iob_cache_alloc(throttled);
+
+      if (iob != NULL)
+        {
+          return iob;
+        }
+#endif
+
       /* Then allocate an I/O buffer, waiting as necessary */
 
       return iob_allocwait(throttled, timeout);
@@ -301,16 +399,76 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
   FAR struct iob_s *iob;
   irqstate_t flags;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  iob = iob_cache_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
   /* We don't know what context we are called from so we use extreme measures
    * to protect the free list:  We disable interrupts very briefly.
    */
 
   flags = spin_lock_irqsave(&g_iob_lock);
   iob = iob_tryalloc_internal(throttled);
+  if (iob == NULL)
+    {
+      g_iob_nexhausted++;
+    }
+
   spin_unlock_irqrestore(&g_iob_lock, flags);
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_alloc_bulk
+ *
+ * Description:
+ *   Try to allocate a number of I/O buffers from the free list in one
+ *   locked operation, without waiting for buffers to become free.  Either
+ *   all of them are allocated or none.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_bulk(bool throttled, unsigned int count)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int avail;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  avail = g_iob_count;
+#if CONFIG_IOB_THROTTLE > 0
+  if (throttled)
+    {
+      avail -= CONFIG_IOB_THROTTLE;
+    }
+#endif
+
+  if (avail >= 0 && count <= (unsigned int)avail)
+    {
+      while (count-- > 0)
+        {
+          iob = iob_tryalloc_internal(throttled);
+          DEBUGASSERT(iob != NULL);
+
+          iob->io_flink = head;
+          head          = iob;
+        }
+    }
+  else
+    {
+      g_iob_nexhausted++;
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return head;
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -344,6 +502,12 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_len     = 0;                /* Length of the data in the entry */
       iob->io_offset  = 0;                /* Offset to the beginning of data */
       iob->io_bufsize = size;             /* Total length of the iob buffer */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum    = 0;                /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp  = 0;                /* No timestamp */
+#endif
       iob->io_pktlen  = 0;                /* Total length of the packet */
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
@@ -390,6 +554,12 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_len     = 0;       /* Length of the data in the entry */
       iob->io_offset  = 0;       /* Offset to the beginning of data */
       iob->io_bufsize = size;    /* Total length of the iob buffer */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum    = 0;       /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp  = 0;       /* No timestamp */
+#endif
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
@@ -429,6 +599,12 @@ FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
   iob->io_flink   = NULL;    /* Not in a chain */
   iob->io_len     = 0;       /* Length of the data in the entry */
   iob->io_offset  = 0;       /* Offset to the beginning of data */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+  iob->io_csum    = 0;       /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+  iob->io_tstamp  = 0;       /* No timestamp */
+#endif
   iob->io_pktlen  = 0;       /* Total length of the packet */
   iob->io_free    = free_cb; /* Customer free callback */
   iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
@@ -0,0 +1,334 @@
+/****************************************************************************
+ * mm/iob/iob_alloc_size.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_ALLOC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+#  if CONFIG_IOB_SMALL_BUFSIZE >= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_SMALL_BUFSIZE must be smaller than CONFIG_IOB_BUFSIZE
+#  endif
+#  if CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_LARGE_BUFSIZE must be larger than CONFIG_IOB_BUFSIZE
+#  endif
+#  if CONFIG_IOB_JUMBO_BUFSIZE <= CONFIG_IOB_LARGE_BUFSIZE
+#    error CONFIG_IOB_JUMBO_BUFSIZE must exceed CONFIG_IOB_LARGE_BUFSIZE
+#  endif
+#  if CONFIG_IOB_JUMBO_BUFSIZE > UINT16_MAX
+#    error CONFIG_IOB_JUMBO_BUFSIZE does not fit in io_bufsize
+#  endif
+
+/* One buffer of a class: the IOB, padded so that io_data is aligned, and
+ * its payload.
+ */
+
+#  define IOB_CLASS_ALIGN_SIZE(size) \
+     ALIGN_UP(ALIGN_UP(sizeof(struct iob_s), IOB_ALIGNMENT) + (size), \
+              IOB_ALIGNMENT)
+
+#  define IOB_CLASS_POOL_SIZE(size, n) \
+     (IOB_CLASS_ALIGN_SIZE(size) * (n) + IOB_ALIGNMENT - 1)
+
+#  ifdef IOB_SECTION
+#    define IOB_CLASS_POOL(name, size, n) \
+       static uint8_t name[IOB_CLASS_POOL_SIZE(size, n)] \
+         locate_data(IOB_SECTION)
+#  else
+#    define IOB_CLASS_POOL(name, size, n) \
+       static uint8_t name[IOB_CLASS_POOL_SIZE(size, n)]
+#  endif
+
+#  define IOB_CLASS_SMALL  0
+#  define IOB_CLASS_LARGE  1
+#  define IOB_CLASS_JUMBO  2
+#  define IOB_NCLASSES     3
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+/* The pre-allocated pool of one size class */
+
+struct iob_class_s
+{
+  FAR struct iob_s *freelist; /* The free buffers of the class */
+  FAR uint8_t *pool;          /* The raw pool memory */
+  size_t   poolsize;          /* The size of the raw pool memory */
+  uint16_t bufsize;           /* The payload size of one buffer */
+  uint16_t nbuffers;          /* The number of buffers in the pool */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+#  if CONFIG_IOB_SMALL_NBUFFERS > 0
+IOB_CLASS_POOL(g_iob_small, CONFIG_IOB_SMALL_BUFSIZE,
+               CONFIG_IOB_SMALL_NBUFFERS);
+#  endif
+#  if CONFIG_IOB_LARGE_NBUFFERS > 0
+IOB_CLASS_POOL(g_iob_large, CONFIG_IOB_LARGE_BUFSIZE,
+               CONFIG_IOB_LARGE_NBUFFERS);
+#  endif
+#  if CONFIG_IOB_JUMBO_NBUFFERS > 0
+IOB_CLASS_POOL(g_iob_jumbo, CONFIG_IOB_JUMBO_BUFSIZE,
+               CONFIG_IOB_JUMBO_NBUFFERS);
+#  endif
+
+static struct iob_class_s g_iob_classes[IOB_NCLASSES] =
+{
+#  if CONFIG_IOB_SMALL_NBUFFERS > 0
+  {
+    NULL, g_iob_small, sizeof(g_iob_small),
+    CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS
+  },
+#  else
+  {
+    NULL, NULL, 0, CONFIG_IOB_SMALL_BUFSIZE, 0
+  },
+#  endif
+#  if CONFIG_IOB_LARGE_NBUFFERS > 0
+  {
+    NULL, g_iob_large, sizeof(g_iob_large),
+    CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS
+  },
+#  else
+  {
+    NULL, NULL, 0, CONFIG_IOB_LARGE_BUFSIZE, 0
+  },
+#  endif
+#  if CONFIG_IOB_JUMBO_NBUFFERS > 0
+  {
+    NULL, g_iob_jumbo, sizeof(g_iob_jumbo),
+    CONFIG_IOB_JUMBO_BUFSIZE, CONFIG_IOB_JUMBO_NBUFFERS
+  }
+#  else
+  {
+    NULL, NULL, 0, CONFIG_IOB_JUMBO_BUFSIZE, 0
+  }
+#  endif
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+/****************************************************************************
+ * Name: iob_class_free
+ *
+ * Description:
+ *   The io_free callback of the buffers of all size classes: return the
+ *   buffer to the free list of the class whose pool holds it.
+ *
+ ****************************************************************************/
+
+static void iob_class_free(FAR void *data)
+{
+  FAR struct iob_s *iob = data;
+  FAR struct iob_class_s *cls;
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < IOB_NCLASSES; i++)
+    {
+      cls = &g_iob_classes[i];
+      if ((FAR uint8_t *)iob >= cls->pool &&
+          (FAR uint8_t *)iob < cls->pool + cls->poolsize)
+        {
+          flags = spin_lock_irqsave(&g_iob_lock);
+          iob->io_flink = cls->freelist;
+          cls->freelist = iob;
+          spin_unlock_irqrestore(&g_iob_lock, flags);
+          return;
+        }
+    }
+
+  DEBUGPANIC();
+}
+
+/****************************************************************************
+ * Name: iob_class_tryalloc
+ *
+ * Description:
+ *   Take a buffer from the free list of one size class.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_class_tryalloc(int ndx, uint16_t size)
+{
+  FAR struct iob_class_s *cls = &g_iob_classes[ndx];
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  if (size > cls->bufsize)
+    {
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  iob = cls->freelist;
+  if (iob != NULL)
+    {
+      cls->freelist = iob->io_flink;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+      iob->io_csum   = 0;    /* No checksum offload */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+      iob->io_tstamp = 0;    /* No timestamp */
+#endif
+      iob->io_pktlen = 0;    /* Total length of the packet */
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return iob;
+}
+#endif /* CONFIG_IOB_SIZE_CLASSES */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+/****************************************************************************
+ * Name: iob_class_initialize
+ *
+ * Description:
+ *   Set up the pools of the I/O buffer size classes.
+ *
+ ****************************************************************************/
+
+void iob_class_initialize(void)
+{
+  FAR struct iob_class_s *cls;
+  FAR struct iob_s *iob;
+  uintptr_t buf;
+  int i;
+  int j;
+
+  for (i = 0; i < IOB_NCLASSES; i++)
+    {
+      cls = &g_iob_classes[i];
+      buf = ALIGN_UP((uintptr_t)cls->pool, IOB_ALIGNMENT);
+
+      for (j = 0; j < cls->nbuffers; j++)
+        {
+          iob = (FAR struct iob_s *)
+                (buf + j * IOB_CLASS_ALIGN_SIZE(cls->bufsize));
+
+          /* io_data right behind the IOB makes iob_free() hand the IOB
+           * itself to the free callback.
+           */
+
+          iob->io_bufsize = cls->bufsize;
+          iob->io_free    = iob_class_free;
+          iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
+                                                    IOB_ALIGNMENT);
+          iob->io_flink   = cls->freelist;
+          cls->freelist   = iob;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate one I/O buffer whose payload holds at least size
+ *   bytes, without waiting for a buffer to become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(uint16_t size, bool throttled)
+{
+  FAR struct iob_s *iob = NULL;
+
+  /* Take the smallest buffer that fits, falling back to the next larger
+   * size when a class has run out.
+   */
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+  iob = iob_class_tryalloc(IOB_CLASS_SMALL, size);
+#endif
+
+  if (iob == NULL && size <= CONFIG_IOB_BUFSIZE)
+    {
+      iob = iob_tryalloc(throttled);
+    }
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+  if (iob == NULL)
+    {
+      iob = iob_class_tryalloc(IOB_CLASS_LARGE, size);
+    }
+
+  if (iob == NULL)
+    {
+      iob = iob_class_tryalloc(IOB_CLASS_JUMBO, size);
+    }
+#endif
+
+  /* The heap is the last resort, it cannot be used from interrupt
+   * handlers.
+   */
+
+  if (iob == NULL && size > CONFIG_IOB_BUFSIZE && !up_interrupt_context())
+    {
+      iob = iob_alloc_dynamic(size);
+    }
+
+  return iob;
+}
+
+#endif /* CONFIG_IOB_ALLOC */
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * mm/iob/iob_dcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/uio.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_ARCH_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of buffers handed to the cache at once */
+
+#define IOB_DCACHE_NIOV 8
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_clean_dcache
+ *
+ * Description:
+ *   Clean the data cache over the data of an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+void iob_clean_dcache(FAR struct iob_s *iob)
+{
+  struct iovec iov[IOB_DCACHE_NIOV];
+  int n = 0;
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      if (iob->io_len == 0)
+        {
+          continue;
+        }
+
+      iov[n].iov_base = IOB_DATA(iob);
+      iov[n].iov_len  = iob->io_len;
+
+      if (++n == IOB_DCACHE_NIOV)
+        {
+          up_clean_dcache_iov(iov, n);
+          n = 0;
+        }
+    }
+
+  if (n > 0)
+    {
+      up_clean_dcache_iov(iov, n);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_invalidate_dcache
+ *
+ * Description:
+ *   Invalidate the data cache over the buffers of an I/O buffer chain.
+ *
+ ****************************************************************************/
+
+void iob_invalidate_dcache(FAR struct iob_s *iob)
+{
+  struct iovec iov[IOB_DCACHE_NIOV];
+  int n = 0;
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      iov[n].iov_base = iob->io_data;
+      iov[n].iov_len  = IOB_BUFSIZE(iob);
+
+      if (++n == IOB_DCACHE_NIOV)
+        {
+          up_invalidate_dcache_iov(iov, n);
+          n = 0;
+        }
+    }
+
+  if (n > 0)
+    {
+      up_invalidate_dcache_iov(iov, n);
+    }
+}
+
+#endif /* CONFIG_ARCH_DCACHE */
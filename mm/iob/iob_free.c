@@ -64,10 +64,184 @@
 
 #define IOB_MASK      (IOB_DIVIDER - 1)
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a free I/O buffer in the cache of this CPU, draining a batch of the
+ *   cache to the pool first if it is full.  Nothing is cached while a task
+ *   waits for an I/O buffer: those go to the committed list.
+ *
+ * Returned Value:
+ *   true if the I/O buffer was cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+static bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *drain = NULL;
+  irqstate_t flags;
+
+  /* The counters are only peeked at: a waiter missed here is woken up by
+   * the next free that goes to the pool.
+   */
+
+  if (g_iob_count < 0
+#if CONFIG_IOB_THROTTLE > 0
+      || g_throttle_wait > 0
+#endif
+     )
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+
+  if (cache->count >= CONFIG_IOB_PERCPU_CACHE)
+    {
+      FAR struct iob_s *tail;
+      int i;
+
+      /* Detach a batch from the head of the cache */
+
+      drain = cache->head;
+      for (i = 1, tail = drain; i < IOB_CACHE_BATCH; i++)
+        {
+          tail = tail->io_flink;
+        }
+
+      cache->head    = tail->io_flink;
+      cache->count  -= IOB_CACHE_BATCH;
+      tail->io_flink = NULL;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  cache->count++;
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      iob_free_pool(drain);
+    }
+
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a list of pre-allocated I/O buffers, linked through io_flink, to
+ *   the free or committed list in one locked operation.  This function is
+ *   intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  int nposts = 0;
+#if CONFIG_IOB_THROTTLE > 0
+  int nthrottle = 0;
+#endif
+#ifdef CONFIG_IOB_NOTIFIER
+  int nfreed = 0;
+  int16_t navail;
+#endif
+
+  /* We don't know what context we are called from so we use extreme
+   * measures to protect the free list:  We disable interrupts very
+   * briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  for (; iob != NULL; iob = next)
+    {
+      next = iob->io_flink;
+
+      /* Which list?  If there is a task waiting for an IOB, then put
+       * the IOB on either the free list or on the committed list where
+       * it is reserved for that allocation (and not available to
+       * iob_tryalloc()). This is true for both throttled and non-throttled
+       * cases.
+       */
+
+      if (g_iob_count < 0)
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          nposts++;
+        }
+#if CONFIG_IOB_THROTTLE > 0
+      else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
+        {
+          iob->io_flink   = g_iob_committed;
+          g_iob_committed = iob;
+          g_throttle_wait--;
+          nthrottle++;
+        }
+#endif
+      else
+        {
+          g_iob_count++;
+          iob->io_flink   = g_iob_freelist;
+          g_iob_freelist  = iob;
+        }
+
+#ifdef CONFIG_IOB_NOTIFIER
+      nfreed++;
+#endif
+    }
+
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+
+  while (nposts-- > 0)
+    {
+      nxsem_post(&g_iob_sem);
+    }
+
+#if CONFIG_IOB_THROTTLE > 0
+  while (nthrottle-- > 0)
+    {
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+
+#ifdef CONFIG_IOB_NOTIFIER
+  /* Check if the IOB was claimed by a thread that is blocked waiting
+   * for an IOB.  A list may step over the multiple of the divider.
+   */
+
+  navail = iob_navail(false);
+  if (navail > 0 && (nfreed > 1 || (navail & IOB_MASK) == 0))
+    {
+      /* Signal any threads that have requested a signal notification
+       * when an IOB becomes available.
+       */
+
+      iob_notifier_signal();
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -80,10 +254,6 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
-  irqstate_t flags;
-#ifdef CONFIG_IOB_NOTIFIER
-  int16_t navail;
-#endif
 
   iobinfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
           iob, iob->io_pktlen, iob->io_len, next);
@@ -104,6 +274,12 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 
           next->io_pktlen = iob->io_pktlen - iob->io_len;
           DEBUGASSERT(next->io_pktlen >= next->io_len);
+#ifdef CONFIG_NETDEV_CSUM_OFFLOAD
+          next->io_csum   = iob->io_csum;
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+          next->io_tstamp = iob->io_tstamp;
+#endif
         }
       else
         {
@@ -137,64 +313,19 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
-
-  if (g_iob_count < 0)
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_iob_sem);
-    }
-#if CONFIG_IOB_THROTTLE > 0
-  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  if (iob_cache_free(iob))
     {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      g_throttle_wait--;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_throttle_sem);
+      return next;
     }
 #endif
-  else
-    {
-      g_iob_count++;
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-    }
-
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
 
-#ifdef CONFIG_IOB_NOTIFIER
-  /* Check if the IOB was claimed by a thread that is blocked waiting
-   * for an IOB.
+  /* Free the I/O buffer by adding it to the head of the free or the
+   * committed list.
    */
 
-  navail = iob_navail(false);
-  if (navail > 0 && (navail & IOB_MASK) == 0)
-    {
-      /* Signal any threads that have requested a signal notification
-       * when an IOB becomes available.
-       */
-
-      iob_notifier_signal();
-    }
-#endif
+  iob->io_flink = NULL;
+  iob_free_pool(iob);
 
   /* And return the I/O buffer after the one that was freed */
 
@@ -40,18 +40,36 @@
  *
  * Description:
  *   Free an entire buffer chain, starting at the beginning of the I/O
- *   buffer chain
+ *   buffer chain.  The pre-allocated buffers of the chain are returned to
+ *   the pool in one locked operation.
  *
  ****************************************************************************/
 
 void iob_free_chain(FAR struct iob_s *iob)
 {
+  FAR struct iob_s *pool = NULL;
   FAR struct iob_s *next;
 
-  /* Free each IOB in the chain -- one at a time to keep the count straight */
-
   for (; iob; iob = next)
     {
-      next = iob_free(iob);
+      next = iob->io_flink;
+
+#ifdef CONFIG_IOB_ALLOC
+      /* Dynamic buffers have their own free callback */
+
+      if (iob->io_free != NULL)
+        {
+          iob_free(iob);
+          continue;
+        }
+#endif
+
+      iob->io_flink = pool;
+      pool          = iob;
+    }
+
+  if (pool != NULL)
+    {
+      iob_free_pool(pool);
     }
 }
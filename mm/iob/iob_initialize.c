@@ -98,6 +98,10 @@ sem_t g_iob_sem = SEM_INITIALIZER(0);
 
 int16_t g_iob_count = CONFIG_IOB_NBUFFERS;
 
+/* Allocations that found no free I/O buffer */
+
+uint32_t g_iob_nexhausted;
+
 #if CONFIG_IOB_THROTTLE > 0
 
 sem_t g_throttle_sem = SEM_INITIALIZER(0);
@@ -117,6 +121,12 @@ int16_t g_qentry_wait = 0;
 
 volatile spinlock_t g_iob_lock = SP_UNLOCKED;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The free I/O buffers cached by each CPU */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -174,4 +184,8 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#ifdef CONFIG_IOB_SIZE_CLASSES
+  iob_class_initialize();
+#endif
 }
@@ -60,6 +60,17 @@ int iob_navail(bool throttled)
     }
 #endif
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Cached buffers are free as well, but not to throttled allocations
+   * once the pool is down to the throttle.
+   */
+
+  if (ret > 0 || (ret == 0 && !throttled))
+    {
+      ret += iob_cache_navail();
+    }
+#endif
+
   if (ret < 0)
     {
       ret = 0;
@@ -71,3 +82,29 @@ int iob_navail(bool throttled)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: iob_cache_navail
+ *
+ * Description:
+ *   Return the number of I/O buffers in the per-CPU caches.  This function
+ *   is intended only for internal use by the IOB module.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+int iob_cache_navail(void)
+{
+  int ret = 0;
+  int cpu;
+
+  /* The caches are read without their CPUs, the sum is a snapshot */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ret += g_iob_cache[cpu].count;
+    }
+
+  return ret;
+}
+#endif
@@ -30,9 +30,6 @@
 
 #include "iob.h"
 
-#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
-    !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -54,7 +51,12 @@
 
 void iob_getstats(FAR struct iob_stats_s *stats)
 {
-  stats->ntotal = CONFIG_IOB_NBUFFERS;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  int cpu;
+#endif
+
+  stats->ntotal     = CONFIG_IOB_NBUFFERS;
+  stats->nexhausted = g_iob_nexhausted;
 
   stats->nfree = g_iob_count;
   if (stats->nfree < 0)
@@ -74,7 +76,16 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
-}
 
-#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
-        * !CONFIG_FS_PROCFS_EXCLUDE_IOBINFO */
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct iob_cache_s *cache = &g_iob_cache[cpu];
+
+      stats->cpu[cpu].ncached = cache->count;
+      stats->cpu[cpu].hits    = cache->hits;
+      stats->cpu[cpu].misses  = cache->misses;
+      stats->nfree           += cache->count;
+    }
+#endif
+}
@@ -54,6 +54,22 @@ static bool in_range(FAR const void *start, size_t length,
           u_end >= r_start && u_end <= r_end);     /* End is in range. */
 }
 
+static inline FAR struct mm_map_entry_s *
+mm_map_entry(FAR struct interval_node_s *node)
+{
+  return node != NULL ?
+         container_of(node, struct mm_map_entry_s, node) : NULL;
+}
+
+static inline FAR struct mm_map_entry_s *
+mm_map_first(FAR struct mm_map_s *mm)
+{
+  FAR struct rb_node_s *rb = rb_first(&mm->mm_map_tree);
+
+  return rb != NULL ?
+         mm_map_entry(rb_entry(rb, struct interval_node_s, rb)) : NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,7 +127,7 @@ void mm_map_unlock(void)
 
 void mm_map_initialize(FAR struct mm_map_s *mm, bool kernel)
 {
-  sq_init(&mm->mm_map_sq);
+  rb_init(&mm->mm_map_tree);
   nxrmutex_init(&mm->mm_map_mutex);
   mm->map_count = 0;
 
@@ -146,8 +162,10 @@ void mm_map_destroy(FAR struct mm_map_s *mm)
 {
   FAR struct mm_map_entry_s *entry;
 
-  while ((entry = (FAR struct mm_map_entry_s *)sq_remfirst(&mm->mm_map_sq)))
+  while ((entry = mm_map_first(mm)) != NULL)
     {
+      interval_tree_remove(&mm->mm_map_tree, &entry->node);
+
       /* Pass null as group argument to indicate that actual MMU mappings
        * must not be touched. The process is being deleted and we don't
        * know in which context we are. Only kernel memory allocations
@@ -205,7 +223,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
       return -EINVAL;
     }
 
-  /* Copy the provided mapping and add to the list */
+  /* Copy the provided mapping and add to the tree */
 
   new_entry = kmm_malloc(sizeof(struct mm_map_entry_s));
   if (!new_entry)
@@ -214,6 +232,9 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
     }
 
   *new_entry = *entry;
+  new_entry->node.start = (uintptr_t)entry->vaddr;
+  new_entry->node.last  = (uintptr_t)entry->vaddr +
+                          (entry->length > 0 ? entry->length - 1 : 0);
 
   ret = nxrmutex_lock(&mm->mm_map_mutex);
   if (ret < 0)
@@ -233,7 +254,7 @@ int mm_map_add(FAR struct mm_map_s *mm, FAR struct mm_map_entry_s *entry)
 
   mm->map_count++;
 
-  sq_addfirst((sq_entry_t *)new_entry, &mm->mm_map_sq);
+  interval_tree_insert(&mm->mm_map_tree, &new_entry->node);
 
   nxrmutex_unlock(&mm->mm_map_mutex);
 
@@ -257,12 +278,17 @@ FAR struct mm_map_entry_s *mm_map_next(FAR struct mm_map_s *mm,
     {
       if (entry == NULL)
         {
-          next_entry = (struct mm_map_entry_s *)sq_peek(&mm->mm_map_sq);
+          next_entry = mm_map_first(mm);
         }
       else
         {
-          next_entry = (struct mm_map_entry_s *)
-            sq_next(((sq_entry_t *)entry));
+          FAR struct rb_node_s *rb = rb_next(&entry->node.rb);
+
+          if (rb != NULL)
+            {
+              next_entry = mm_map_entry(rb_entry(rb, struct interval_node_s,
+                                                 rb));
+            }
         }
 
       nxrmutex_unlock(&mm->mm_map_mutex);
@@ -284,17 +310,25 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
                                        size_t length)
 {
   FAR struct mm_map_entry_s *found_entry = NULL;
+  FAR struct interval_node_s *node;
+  uintptr_t start = (uintptr_t)vaddr;
 
   if (nxrmutex_lock(&mm->mm_map_mutex) == OK)
     {
-      found_entry = (struct mm_map_entry_s *)sq_peek(&mm->mm_map_sq);
+      /* A mapping containing the range contains its start */
 
-      while (found_entry && !in_range(vaddr, length,
-                                      found_entry->vaddr,
-                                      found_entry->length))
+      for (node = interval_tree_iter_first(&mm->mm_map_tree, start, start);
+           node != NULL;
+           node = interval_tree_iter_next(node, start, start))
         {
-          found_entry = (struct mm_map_entry_s *)
-            sq_next(((sq_entry_t *)found_entry));
+          found_entry = mm_map_entry(node);
+          if (in_range(vaddr, length, found_entry->vaddr,
+                       found_entry->length))
+            {
+              break;
+            }
+
+          found_entry = NULL;
         }
 
       nxrmutex_unlock(&mm->mm_map_mutex);
@@ -314,8 +348,9 @@ FAR struct mm_map_entry_s *mm_map_find(FAR struct mm_map_s *mm,
 int mm_map_remove(FAR struct mm_map_s *mm,
                   FAR struct mm_map_entry_s *entry)
 {
-  FAR struct mm_map_entry_s *prev_entry;
   FAR struct mm_map_entry_s *removed_entry = NULL;
+  FAR struct interval_node_s *node;
+  uintptr_t start;
   int ret;
 
   if (!mm || !entry)
@@ -329,39 +364,19 @@ int mm_map_remove(FAR struct mm_map_s *mm,
       return ret;
     }
 
-  prev_entry = (struct mm_map_entry_s *)sq_peek(&mm->mm_map_sq);
+  /* Look the entry up by its start to make sure that it is in the tree */
 
-  /* Check if the list was empty */
-
-  if (!prev_entry)
-    {
-      nxrmutex_unlock(&mm->mm_map_mutex);
-      return -ENOENT;
-    }
-
-  /* Check if removing the first item */
-
-  if (entry == prev_entry)
+  start = entry->node.start;
+  for (node = interval_tree_iter_first(&mm->mm_map_tree, start, start);
+       node != NULL;
+       node = interval_tree_iter_next(node, start, start))
     {
-      sq_remfirst(&mm->mm_map_sq);
-      mm->map_count--;
-      removed_entry = prev_entry;
-    }
-  else
-    {
-      /* Loop through the remaining items to find the one to be removed */
-
-      while ((removed_entry = (struct mm_map_entry_s *)
-              sq_next(((sq_entry_t *)prev_entry))))
+      if (node == &entry->node)
         {
-          if (entry == removed_entry)
-            {
-              sq_remafter((sq_entry_t *)prev_entry, &mm->mm_map_sq);
-              mm->map_count--;
-              break;
-            }
-
-          prev_entry = removed_entry;
+          interval_tree_remove(&mm->mm_map_tree, node);
+          mm->map_count--;
+          removed_entry = entry;
+          break;
         }
     }
 
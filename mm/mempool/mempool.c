@@ -28,6 +28,7 @@
 #include <execinfo.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
 
 #include <nuttx/kmalloc.h>
@@ -42,6 +43,34 @@
 
 #define MEMPOOL_HEADER_SIZE (sizeof(sq_entry_t) + CONFIG_MM_NODE_GUARDSIZE)
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+#  define MEMPOOL_MAGAZINE_BATCH (CONFIG_MM_MEMPOOL_MAGAZINE_SIZE / 2)
+
+/* Pools which block waiting for a free block must see every release */
+
+#  define MEMPOOL_MAGAZINE_ENABLED(pool) \
+     (!(pool)->wait || (pool)->expandsize != 0)
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+#  define MEMPOOL_OWNER_NONE     UINT8_MAX
+#  define MEMPOOL_OWNER(pool, blk) \
+     (*((FAR uint8_t *)(blk) + (pool)->blocksize + MEMPOOL_BACKTRACESIZE))
+
+#  if UINTPTR_MAX <= UINT32_MAX
+#    define mempool_remote_head_t           int32_t
+#    define mempool_remote_read(h)          atomic_read(h)
+#    define mempool_remote_xchg(h, v)       atomic_xchg(h, v)
+#    define mempool_remote_cmpxchg(h, e, v) atomic_try_cmpxchg_release(h, e, v)
+#  else
+#    define mempool_remote_head_t           int64_t
+#    define mempool_remote_read(h)          atomic64_read(h)
+#    define mempool_remote_xchg(h, v)       atomic64_xchg(h, v)
+#    define mempool_remote_cmpxchg(h, e, v) \
+       atomic64_try_cmpxchg_release(h, e, v)
+#  endif
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 #define MEMPOOL_MAGIC_FREE  0x55555555
 #define MEMPOOL_MAGIC_ALLOC 0xAAAAAAAA
@@ -100,6 +129,456 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+/****************************************************************************
+ * Name: mempool_tier_alloc
+ *
+ * Description:
+ *   Allocate backing memory for the pool.  If the pool has tiers, take it
+ *   from the preferred heap unless that reached tierlimit, or this is an
+ *   expansion and the policy sends those to the fallback heap.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_tier_alloc(FAR struct mempool_s *pool,
+                                    size_t size, bool expand)
+{
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  FAR struct mm_heap_s *preferred = pool->tier[MEMPOOL_TIER_PREFERRED];
+  FAR struct mm_heap_s *fallback = pool->tier[MEMPOOL_TIER_FALLBACK];
+  int tier = MEMPOOL_TIER_PREFERRED;
+  FAR void *base = NULL;
+  irqstate_t flags;
+
+  if (preferred == NULL)
+    {
+      base = pool->alloc(pool, size);
+    }
+  else
+    {
+      if ((!expand || fallback == NULL ||
+           pool->expandpolicy == MEMPOOL_EXPAND_PREFERRED) &&
+          (pool->tierlimit == 0 ||
+           pool->tiersize[MEMPOOL_TIER_PREFERRED] + size <=
+           pool->tierlimit))
+        {
+          base = mm_malloc(preferred, size);
+        }
+
+      if (base == NULL && fallback != NULL)
+        {
+          base = mm_malloc(fallback, size);
+          tier = MEMPOOL_TIER_FALLBACK;
+        }
+    }
+
+  if (base != NULL)
+    {
+      flags = spin_lock_irqsave(&pool->lock);
+      pool->tiersize[tier] += size;
+      spin_unlock_irqrestore(&pool->lock, flags);
+    }
+
+  return base;
+#else
+  return pool->alloc(pool, size);
+#endif
+}
+
+/****************************************************************************
+ * Name: mempool_tier_free
+ *
+ * Description:
+ *   Free backing memory allocated by mempool_tier_alloc().
+ *
+ ****************************************************************************/
+
+static void mempool_tier_free(FAR struct mempool_s *pool, FAR void *base,
+                              size_t size)
+{
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  FAR struct mm_heap_s *fallback = pool->tier[MEMPOOL_TIER_FALLBACK];
+  int tier = MEMPOOL_TIER_PREFERRED;
+  irqstate_t flags;
+
+  if (pool->tier[MEMPOOL_TIER_PREFERRED] == NULL)
+    {
+      pool->free(pool, base);
+    }
+  else
+    {
+      if (fallback != NULL && mm_heapmember(fallback, base))
+        {
+          tier = MEMPOOL_TIER_FALLBACK;
+        }
+
+      mm_free(pool->tier[tier], base);
+    }
+
+  flags = spin_lock_irqsave(&pool->lock);
+  pool->tiersize[tier] -= size;
+  spin_unlock_irqrestore(&pool->lock, flags);
+#else
+  pool->free(pool, base);
+#endif
+}
+
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+/****************************************************************************
+ * Name: mempool_tier_shrink
+ *
+ * Description:
+ *   Unlink the expansion chunks taken from the fallback heap, and their
+ *   blocks from the free queue.  Called with the pool lock held and no
+ *   block allocated, so that all blocks of the chunks are free.  The chunk
+ *   headers are collected in freeq, the caller frees the chunks after
+ *   dropping the lock.
+ *
+ ****************************************************************************/
+
+static void mempool_tier_shrink(FAR struct mempool_s *pool,
+                                FAR sq_queue_t *freeq)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  size_t nexpand = (pool->expandsize - MEMPOOL_HEADER_SIZE) / blocksize;
+  FAR sq_entry_t *prev = NULL;
+  FAR sq_entry_t *bprev;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  FAR sq_entry_t *blk;
+  FAR char *start;
+
+  entry = pool->equeue.head;
+
+  /* The initial chunk is the baseline of the pool, keep it */
+
+  if (entry != NULL &&
+      pool->initialsize >= blocksize + MEMPOOL_HEADER_SIZE)
+    {
+      prev  = entry;
+      entry = entry->flink;
+    }
+
+  for (; entry != NULL; entry = next)
+    {
+      next  = entry->flink;
+      start = (FAR char *)entry - nexpand * blocksize;
+      if (!mm_heapmember(pool->tier[MEMPOOL_TIER_FALLBACK], start))
+        {
+          prev = entry;
+          continue;
+        }
+
+      if (prev == NULL)
+        {
+          sq_remfirst(&pool->equeue);
+        }
+      else
+        {
+          sq_remafter(prev, &pool->equeue);
+        }
+
+      sq_addlast(entry, freeq);
+
+      /* Drop the blocks of the chunk from the free queue */
+
+      bprev = NULL;
+      blk   = pool->queue.head;
+      while (blk != NULL)
+        {
+          FAR sq_entry_t *bnext = blk->flink;
+
+          if ((FAR char *)blk >= start &&
+              (FAR char *)blk < (FAR char *)entry)
+            {
+              if (bprev == NULL)
+                {
+                  sq_remfirst(&pool->queue);
+                }
+              else
+                {
+                  sq_remafter(bprev, &pool->queue);
+                }
+            }
+          else
+            {
+              bprev = blk;
+            }
+
+          blk = bnext;
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+static size_t mempool_magazine_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->magazine[cpu].nblks;
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+      count += atomic_read(&pool->remote[cpu].nblks);
+#endif
+    }
+
+  return count;
+}
+
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+/****************************************************************************
+ * Name: mempool_remote_push
+ *
+ * Description:
+ *   Queue a free block to the CPU which owns it.  This may be called from
+ *   any CPU and any context, without holding any lock.
+ *
+ ****************************************************************************/
+
+static void mempool_remote_push(FAR struct mempool_s *pool, int cpu,
+                                FAR sq_entry_t *blk)
+{
+  FAR struct mempool_remote_s *remote = &pool->remote[cpu];
+  mempool_remote_head_t head;
+
+  head = mempool_remote_read(&remote->head);
+  do
+    {
+      blk->flink = (FAR sq_entry_t *)(uintptr_t)head;
+    }
+  while (!mempool_remote_cmpxchg(&remote->head, &head, (uintptr_t)blk));
+
+  atomic_fetch_add(&remote->nblks, 1);
+}
+
+/****************************************************************************
+ * Name: mempool_remote_drain
+ *
+ * Description:
+ *   Move the blocks which other CPUs released to this CPU into its
+ *   magazine.  Only the owner consumes its queue, and it always takes the
+ *   whole chain at once, so a plain exchange is enough (no ABA issue).
+ *   Whatever does not fit into the magazine goes back to the pool queue.
+ *
+ ****************************************************************************/
+
+static void mempool_remote_drain(FAR struct mempool_s *pool, int cpu,
+                                 FAR struct mempool_magazine_s *mag)
+{
+  FAR struct mempool_remote_s *remote = &pool->remote[cpu];
+  FAR sq_entry_t *blk;
+  bool locked = false;
+  int count = 0;
+
+  if (mempool_remote_read(&remote->head) == 0)
+    {
+      return;
+    }
+
+  blk = (FAR sq_entry_t *)(uintptr_t)mempool_remote_xchg(&remote->head, 0);
+  while (blk != NULL)
+    {
+      FAR sq_entry_t *next = blk->flink;
+
+      if (mag->nblks < CONFIG_MM_MEMPOOL_MAGAZINE_SIZE)
+        {
+          mag->blks[mag->nblks++] = blk;
+        }
+      else
+        {
+          if (!locked)
+            {
+              spin_lock(&pool->lock);
+              locked = true;
+            }
+
+          sq_addlast(blk, &pool->queue);
+          pool->nalloc--;
+        }
+
+      count++;
+      blk = next;
+    }
+
+  if (locked)
+    {
+      spin_unlock(&pool->lock);
+    }
+
+  atomic_fetch_sub(&remote->nblks, count);
+}
+#endif
+
+/****************************************************************************
+ * Name: mempool_magazine_flush
+ *
+ * Description:
+ *   Return the oldest nblks cached blocks of a magazine to the shared free
+ *   queue.  The caller must own the magazine, i.e. run with the local
+ *   interrupts disabled on the CPU it belongs to (or be the last user of
+ *   the pool), and must not hold the pool lock.
+ *
+ ****************************************************************************/
+
+static void mempool_magazine_flush(FAR struct mempool_s *pool,
+                                   FAR struct mempool_magazine_s *mag,
+                                   size_t nblks)
+{
+  size_t i;
+
+  DEBUGASSERT(nblks <= mag->nblks);
+
+  spin_lock(&pool->lock);
+  for (i = 0; i < nblks; i++)
+    {
+      sq_addlast(mag->blks[i], &pool->queue);
+    }
+
+  pool->nalloc -= nblks;
+  spin_unlock(&pool->lock);
+
+  mag->nblks -= nblks;
+  memmove(mag->blks, mag->blks + nblks, mag->nblks * sizeof(FAR void *));
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_alloc
+ *
+ * Description:
+ *   Take a free block from the magazine of the current CPU, refilling the
+ *   magazine from the shared free queue first if it is empty.  The blocks
+ *   held by a magazine keep their free state (magic, kasan poison), but
+ *   are accounted in nalloc since they are no longer in the pool queue.
+ *
+ * Returned Value:
+ *   A free block, or NULL if both the magazine and the queue are empty.
+ *
+ ****************************************************************************/
+
+static FAR void *mempool_magazine_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *mag;
+  FAR void *blk = NULL;
+  irqstate_t flags;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu = this_cpu();
+  mag = &pool->magazine[cpu];
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+  if (mag->nblks == 0)
+    {
+      mempool_remote_drain(pool, cpu, mag);
+    }
+#endif
+
+  if (mag->nblks == 0)
+    {
+      spin_lock(&pool->lock);
+      while (mag->nblks < MEMPOOL_MAGAZINE_BATCH)
+        {
+          FAR sq_entry_t *entry = mempool_remove_queue(pool, &pool->queue);
+
+          if (entry == NULL)
+            {
+              break;
+            }
+
+          mag->blks[mag->nblks++] = entry;
+        }
+
+      pool->nalloc += mag->nblks;
+      spin_unlock(&pool->lock);
+    }
+
+  if (mag->nblks > 0)
+    {
+      blk = mag->blks[--mag->nblks];
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+      MEMPOOL_OWNER(pool, blk) = cpu;
+#endif
+    }
+
+  up_irq_restore(flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_magazine_release
+ *
+ * Description:
+ *   Put a block into the magazine of the current CPU, flushing half of the
+ *   magazine to the shared free queue first if it is full.
+ *
+ * Returned Value:
+ *   true if the block was cached, false if the caller has to release it
+ *   to the pool queue itself.
+ *
+ ****************************************************************************/
+
+static bool mempool_magazine_release(FAR struct mempool_s *pool,
+                                     FAR void *blk)
+{
+  FAR struct mempool_magazine_s *mag;
+  irqstate_t flags;
+  int cpu;
+#if CONFIG_MM_BACKTRACE >= 0
+  FAR struct mempool_backtrace_s *buf;
+#endif
+
+  /* The interrupt reserve always goes back to its own queue */
+
+  if (!MEMPOOL_MAGAZINE_ENABLED(pool) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  buf = (FAR struct mempool_backtrace_s *)((FAR char *)blk +
+                                           pool->blocksize);
+
+  /* Check double free or out of out of bounds */
+
+  DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
+  buf->magic = MEMPOOL_MAGIC_FREE;
+#endif
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#endif
+
+  kasan_poison(blk, pool->blocksize);
+
+  flags = up_irq_save();
+  cpu = this_cpu();
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+  if (MEMPOOL_OWNER(pool, blk) != MEMPOOL_OWNER_NONE &&
+      MEMPOOL_OWNER(pool, blk) != cpu)
+    {
+      /* Hand the block back to the CPU whose magazine it came from */
+
+      up_irq_restore(flags);
+      mempool_remote_push(pool, MEMPOOL_OWNER(pool, blk), blk);
+      return true;
+    }
+#endif
+
+  mag = &pool->magazine[cpu];
+  if (mag->nblks == CONFIG_MM_MEMPOOL_MAGAZINE_SIZE)
+    {
+      mempool_magazine_flush(pool, mag, MEMPOOL_MAGAZINE_BATCH);
+    }
+
+  mag->blks[mag->nblks++] = blk;
+  up_irq_restore(flags);
+  return true;
+}
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -268,13 +747,18 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
   sq_init(&pool->equeue);
+  spin_lock_init(&pool->lock);
   pool->nalloc = 0;
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  memset(pool->tiersize, 0, sizeof(pool->tiersize));
+#endif
+
   if (pool->interruptsize >= blocksize)
     {
       size_t ninterrupt = pool->interruptsize / blocksize;
       size_t size = ninterrupt * blocksize;
 
-      pool->ibase = pool->alloc(pool, size);
+      pool->ibase = mempool_tier_alloc(pool, size, false);
       if (pool->ibase == NULL)
         {
           return -ENOMEM;
@@ -296,12 +780,14 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
       size_t size = ninitial * blocksize + MEMPOOL_HEADER_SIZE;
       FAR char *base;
 
-      base = pool->alloc(pool, size);
+      base = mempool_tier_alloc(pool, size, false);
       if (base == NULL)
         {
           if (pool->ibase)
             {
-              pool->free(pool, pool->ibase);
+              mempool_tier_free(pool, pool->ibase,
+                                pool->interruptsize / blocksize *
+                                blocksize);
             }
 
           return -ENOMEM;
@@ -314,7 +800,13 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
       kasan_poison(base, size);
     }
 
-  spin_lock_init(&pool->lock);
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  memset(pool->magazine, 0, sizeof(pool->magazine));
+#endif
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+  memset(pool->remote, 0, sizeof(pool->remote));
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
@@ -354,6 +846,17 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  if (MEMPOOL_MAGAZINE_ENABLED(pool))
+    {
+      blk = mempool_magazine_alloc(pool);
+      if (blk != NULL)
+        {
+          goto out;
+        }
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -378,7 +881,7 @@ retry:
               size_t nexpand = (pool->expandsize - MEMPOOL_HEADER_SIZE) /
                                blocksize;
               size_t size = nexpand * blocksize + MEMPOOL_HEADER_SIZE;
-              FAR char *base = pool->alloc(pool, size);
+              FAR char *base = mempool_tier_alloc(pool, size, true);
 
               if (base == NULL)
                 {
@@ -408,6 +911,12 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+  MEMPOOL_OWNER(pool, blk) = MEMPOOL_OWNER_NONE;
+#endif
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+out:
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -434,11 +943,25 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  irqstate_t flags;
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  FAR sq_entry_t *entry;
+  sq_queue_t freeq;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  if (mempool_magazine_release(pool, blk))
+    {
+      return;
+    }
+#endif
 
+  flags = spin_lock_irqsave(&pool->lock);
+#if CONFIG_MM_BACKTRACE >= 0
   /* Check double free or out of out of bounds */
 
   DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
@@ -470,7 +993,35 @@ void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
     }
 
   kasan_poison(blk, pool->blocksize);
+
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  sq_init(&freeq);
+  if (pool->nalloc == 0 && pool->shrinkpolicy == MEMPOOL_SHRINK_FALLBACK &&
+      pool->tiersize[MEMPOOL_TIER_FALLBACK] > 0 &&
+      pool->expandsize >= MEMPOOL_REALBLOCKSIZE(pool) +
+                          MEMPOOL_HEADER_SIZE &&
+      !up_interrupt_context())
+    {
+      mempool_tier_shrink(pool, &freeq);
+    }
+#endif
+
   spin_unlock_irqrestore(&pool->lock, flags);
+
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  while ((entry = sq_remfirst(&freeq)) != NULL)
+    {
+      size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+      size_t nexpand = (pool->expandsize - MEMPOOL_HEADER_SIZE) /
+                       blocksize;
+      size_t size = nexpand * blocksize + MEMPOOL_HEADER_SIZE;
+      FAR char *base = (FAR char *)entry - nexpand * blocksize;
+
+      base = kasan_unpoison(base, size);
+      mempool_tier_free(pool, base, size);
+    }
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       int semcount;
@@ -501,6 +1052,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   irqstate_t flags;
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  size_t count;
+#endif
 
   DEBUGASSERT(pool != NULL && info != NULL);
 
@@ -508,8 +1062,20 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   info->ordblks = sq_count(&pool->queue);
   info->iordblks = sq_count(&pool->iqueue);
   info->aordblks = pool->nalloc;
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  count = mempool_magazine_count(pool);
+  info->ordblks += count;
+  info->aordblks -= count;
+#endif
+
   info->arena = sq_count(&pool->equeue) * MEMPOOL_HEADER_SIZE +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
+#ifdef CONFIG_MM_MEMPOOL_TIERS
+  info->tierarena[MEMPOOL_TIER_PREFERRED] =
+    pool->tiersize[MEMPOOL_TIER_PREFERRED];
+  info->tierarena[MEMPOOL_TIER_FALLBACK] =
+    pool->tiersize[MEMPOOL_TIER_FALLBACK];
+#endif
   spin_unlock_irqrestore(&pool->lock, flags);
   info->sizeblks = blocksize;
   if (pool->wait && pool->expandsize == 0)
@@ -547,14 +1113,22 @@ mempool_info_task(FAR struct mempool_s *pool,
       size_t count = sq_count(&pool->queue) +
                      sq_count(&pool->iqueue);
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+      count += mempool_magazine_count(pool);
+#endif
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
       info.uordblks += count * blocksize;
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc;
+
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+      count -= mempool_magazine_count(pool);
+#endif
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -623,6 +1197,23 @@ int mempool_deinit(FAR struct mempool_s *pool)
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
   FAR sq_entry_t *blk;
   size_t count = 0;
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  irqstate_t flags;
+  int cpu;
+
+  /* Give the cached blocks of every CPU back to the pool queue */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      flags = up_irq_save();
+#ifdef CONFIG_MM_MEMPOOL_REMOTE_FREE
+      mempool_remote_drain(pool, cpu, &pool->magazine[cpu]);
+#endif
+      mempool_magazine_flush(pool, &pool->magazine[cpu],
+                             pool->magazine[cpu].nblks);
+      up_irq_restore(flags);
+    }
+#endif
 
   if (pool->nalloc != 0)
     {
@@ -651,7 +1242,7 @@ int mempool_deinit(FAR struct mempool_s *pool)
       blk = (FAR sq_entry_t *)((FAR char *)blk - count * blocksize);
 
       blk = kasan_unpoison(blk, count * blocksize + MEMPOOL_HEADER_SIZE);
-      pool->free(pool, blk);
+      mempool_tier_free(pool, blk, count * blocksize + MEMPOOL_HEADER_SIZE);
       if (pool->expandsize >= blocksize + MEMPOOL_HEADER_SIZE)
         {
           count = (pool->expandsize - MEMPOOL_HEADER_SIZE) / blocksize;
@@ -662,7 +1253,8 @@ int mempool_deinit(FAR struct mempool_s *pool)
     {
       pool->ibase = kasan_unpoison(pool->ibase,
                       pool->interruptsize / blocksize * blocksize);
-      pool->free(pool, pool->ibase);
+      mempool_tier_free(pool, pool->ibase,
+                        pool->interruptsize / blocksize * blocksize);
     }
 
   if (pool->wait && pool->expandsize == 0)
@@ -266,9 +266,21 @@ int gran_search(const gran_t *gran, size_t size)
       return ret;
     }
 
+  /* Start at the first cell with a free granule and step over full cells
+   * without matching them bit by bit.
+   */
+
   ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  for (size_t i = gran->firstfree * GATC_BITS(gran);
+       i <= gran->ngranules - size; i++)
     {
+      if ((i % GATC_BITS(gran)) == 0 &&
+          gran->gat[i / GATC_BITS(gran)] == GATCFULL)
+        {
+          i += GATC_BITS(gran) - 1;
+          continue;
+        }
+
       if (gran_match(gran, i, size, 0, &i))
         {
           ret = i;
@@ -289,6 +301,17 @@ int gran_set(gran_t *gran, size_t posi, size_t size)
   if (ret == OK)
     {
       gran_set_(gran, &rang, true);
+
+      /* Advance the hint past the cells that became full */
+
+      if (rang.sidx <= gran->firstfree)
+        {
+          while (gran->firstfree < SIZEOF_GAT(gran->ngranules) &&
+                 gran->gat[gran->firstfree] == GATCFULL)
+            {
+              gran->firstfree++;
+            }
+        }
     }
 
   return ret;
@@ -304,6 +327,10 @@ int gran_clear(gran_t *gran, size_t posi, size_t size)
   if (ret == OK)
     {
       gran_set_(gran, &rang, false);
+      if (rang.sidx < gran->firstfree)
+        {
+          gran->firstfree = rang.sidx;
+        }
     }
 
   return ret;
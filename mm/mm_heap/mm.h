@@ -29,8 +29,10 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -216,6 +218,17 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* This describes one slot for a sampled guarded allocation */
+
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+struct mm_guard_s
+{
+  FAR uint8_t *mem;         /* The guarded block */
+  size_t       size;        /* The size requested by the caller */
+  uint8_t      state;       /* See MM_GUARD_* */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -265,12 +278,33 @@ struct mm_heap_s
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   size_t                         mm_threshold;
   FAR struct mempool_multiple_s *mm_mpool;
+#  if CONFIG_MM_HEAP_MEMPOOL_ARENA_SIZE > 0
+  FAR struct mm_heap_s          *mm_poolheap;
+#  endif
 #endif
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
 
+  /* Latency histograms in perf_gettime() ticks */
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+  uint32_t mm_malloclat[MM_TELEMETRY_NBUCKETS];
+  uint32_t mm_freelat[MM_TELEMETRY_NBUCKETS];
+  clock_t  mm_mallocmax;
+  clock_t  mm_freemax;
+#endif
+
+  /* Sampled guarded allocations, see mm_guard.c */
+
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+  spinlock_t         mm_guardlock;
+  int                mm_guardcount;
+  uint32_t           mm_guardseed;
+  struct mm_guard_s  mm_guard[CONFIG_MM_HEAP_GUARD_SLOTS];
+#endif
+
   /* Kasan is disable or enable for this heap */
 
   bool mm_nokasan;
@@ -292,6 +326,31 @@ void mm_unlock(FAR struct mm_heap_s *heap);
 irqstate_t mm_lock_irq(FAR struct mm_heap_s *heap);
 void mm_unlock_irq(FAR struct mm_heap_s *heap, irqstate_t state);
 
+/* Functions contained in mm_guard.c ****************************************/
+
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+void mm_guard_initialize(FAR struct mm_heap_s *heap);
+FAR void *mm_guard_malloc(FAR struct mm_heap_s *heap, size_t size);
+bool mm_guard_free(FAR struct mm_heap_s *heap, FAR void *mem);
+ssize_t mm_guard_size(FAR struct mm_heap_s *heap, FAR void *mem);
+#endif
+
+/* Functions contained in mm_telemetry.c ************************************/
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+void mm_telemetry_latency(FAR uint32_t *hist, FAR clock_t *max,
+                          clock_t start);
+#  define MM_TELEMETRY_START(s) clock_t s = perf_gettime()
+#  define MM_TELEMETRY_MALLOC(h, s) \
+     mm_telemetry_latency((h)->mm_malloclat, &(h)->mm_mallocmax, s)
+#  define MM_TELEMETRY_FREE(h, s) \
+     mm_telemetry_latency((h)->mm_freelat, &(h)->mm_freemax, s)
+#else
+#  define MM_TELEMETRY_START(s)
+#  define MM_TELEMETRY_MALLOC(h, s)
+#  define MM_TELEMETRY_FREE(h, s)
+#endif
+
 /* Functions contained in mm_shrinkchunk.c **********************************/
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
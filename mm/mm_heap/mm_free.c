@@ -231,6 +231,8 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
+  MM_TELEMETRY_START(start);
+
   minfo("Freeing %p\n", mem);
 
   /* Protect against attempts to free a NULL reference */
@@ -242,15 +244,24 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
   DEBUGASSERT(mm_heapmember(heap, mem));
 
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+  if (mm_guard_free(heap, mem))
+    {
+      return;
+    }
+#endif
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
     {
       if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
         {
+          MM_TELEMETRY_FREE(heap, start);
           return;
         }
     }
 #endif
 
   mm_delayfree(heap, mem, CONFIG_MM_FREE_DELAYCOUNT_MAX > 0);
+  MM_TELEMETRY_FREE(heap, start);
 }
@@ -0,0 +1,338 @@
+/****************************************************************************
+ * mm/mm_heap/mm_guard.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <string.h>
+
+#include <nuttx/mm/mm.h>
+#include <nuttx/spinlock.h>
+
+#include "mm_heap/mm.h"
+
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_MM_HEAP_GUARD_SAMPLE < 2
+#  error CONFIG_MM_HEAP_GUARD_SAMPLE must be 0 or at least 2
+#endif
+
+/* Slot states */
+
+#define MM_GUARD_EMPTY    0  /* Unused slot */
+#define MM_GUARD_BUSY     1  /* Claimed, being set up or recycled */
+#define MM_GUARD_LIVE     2  /* Holds an allocated block */
+#define MM_GUARD_FREED    3  /* Holds a quarantined, freed block */
+
+#define MM_GUARD_CANARY   0xfd
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_guard_fault
+ ****************************************************************************/
+
+static void mm_guard_fault(FAR const char *what, FAR void *mem,
+                           size_t size, size_t offset)
+{
+  _alert("Heap guard: %s, block %p size %zu at offset %zu\n",
+         what, mem, size, offset);
+  PANIC();
+}
+
+/****************************************************************************
+ * Name: mm_guard_check
+ *
+ * Description:
+ *   Return the offset of the first byte in [from, to) of the block that
+ *   differs from value, or to if there is none.
+ *
+ ****************************************************************************/
+
+static size_t mm_guard_check(FAR const uint8_t *mem, size_t from,
+                             size_t to, uint8_t value)
+{
+  for (; from < to; from++)
+    {
+      if (mem[from] != value)
+        {
+          break;
+        }
+    }
+
+  return from;
+}
+
+/****************************************************************************
+ * Name: mm_guard_find
+ *
+ * Description:
+ *   Find the slot holding mem.  Called with mm_guardlock held.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_guard_s *mm_guard_find(FAR struct mm_heap_s *heap,
+                                            FAR void *mem)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_MM_HEAP_GUARD_SLOTS; i++)
+    {
+      if (heap->mm_guard[i].mem == mem &&
+          heap->mm_guard[i].state != MM_GUARD_EMPTY)
+        {
+          return &heap->mm_guard[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mm_guard_claim
+ *
+ * Description:
+ *   Claim an empty slot, or recycle the quarantined block of a freed slot.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_guard_s *mm_guard_claim(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_guard_s *slot = NULL;
+  FAR uint8_t *victim = NULL;
+  irqstate_t flags;
+  size_t offset;
+  size_t size = 0;
+  int i;
+
+  flags = spin_lock_irqsave(&heap->mm_guardlock);
+  for (i = 0; i < CONFIG_MM_HEAP_GUARD_SLOTS; i++)
+    {
+      if (heap->mm_guard[i].state == MM_GUARD_EMPTY)
+        {
+          slot = &heap->mm_guard[i];
+          break;
+        }
+      else if (slot == NULL && heap->mm_guard[i].state == MM_GUARD_FREED)
+        {
+          slot = &heap->mm_guard[i];
+        }
+    }
+
+  if (slot != NULL)
+    {
+      if (slot->state == MM_GUARD_FREED)
+        {
+          victim = slot->mem;
+          size   = slot->size;
+        }
+
+      slot->state = MM_GUARD_BUSY;
+      slot->mem   = NULL;
+    }
+
+  spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+
+  /* The quarantined block must still hold the free pattern */
+
+  if (victim != NULL)
+    {
+      offset = mm_guard_check(victim, 0, size + CONFIG_MM_HEAP_GUARD_SIZE,
+                              MM_FREE_MAGIC);
+      if (offset < size + CONFIG_MM_HEAP_GUARD_SIZE)
+        {
+          mm_guard_fault("write after free", victim, size, offset);
+        }
+
+      mm_free(heap, victim);
+    }
+
+  return slot;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_guard_initialize
+ ****************************************************************************/
+
+void mm_guard_initialize(FAR struct mm_heap_s *heap)
+{
+  spin_lock_init(&heap->mm_guardlock);
+  heap->mm_guardseed  = (uint32_t)(uintptr_t)heap;
+  heap->mm_guardcount = CONFIG_MM_HEAP_GUARD_SAMPLE;
+}
+
+/****************************************************************************
+ * Name: mm_guard_malloc
+ *
+ * Description:
+ *   Count an allocation, and if it is sampled, place it in a guarded slot.
+ *   The counter is updated without a lock, a lost update only shifts the
+ *   sampling point.
+ *
+ * Returned Value:
+ *   The guarded block, or NULL if the allocation is not sampled or cannot
+ *   be guarded.  The caller then allocates normally.
+ *
+ ****************************************************************************/
+
+FAR void *mm_guard_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_guard_s *slot;
+  FAR uint8_t *mem;
+  irqstate_t flags;
+  uint32_t seed;
+
+  if (--heap->mm_guardcount > 0)
+    {
+      return NULL;
+    }
+
+  /* Restart the countdown somewhere in [N/2 + 1, 3N/2] */
+
+  seed = heap->mm_guardseed * 1103515245 + 12345;
+  heap->mm_guardseed  = seed;
+  heap->mm_guardcount = CONFIG_MM_HEAP_GUARD_SAMPLE / 2 + 1 +
+                        (seed >> 8) % CONFIG_MM_HEAP_GUARD_SAMPLE;
+
+  if (size + CONFIG_MM_HEAP_GUARD_SIZE < size)
+    {
+      return NULL;
+    }
+
+  slot = mm_guard_claim(heap);
+  if (slot == NULL)
+    {
+      return NULL;
+    }
+
+  mem = mm_malloc(heap, size + CONFIG_MM_HEAP_GUARD_SIZE);
+
+  flags = spin_lock_irqsave(&heap->mm_guardlock);
+  if (mem != NULL)
+    {
+      memset(mem + size, MM_GUARD_CANARY, CONFIG_MM_HEAP_GUARD_SIZE);
+      slot->mem   = mem;
+      slot->size  = size;
+      slot->state = MM_GUARD_LIVE;
+    }
+  else
+    {
+      slot->state = MM_GUARD_EMPTY;
+    }
+
+  spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+  return mem;
+}
+
+/****************************************************************************
+ * Name: mm_guard_free
+ *
+ * Description:
+ *   Check and quarantine a guarded block.
+ *
+ * Returned Value:
+ *   true if mem was a guarded block and must not be freed by the caller.
+ *
+ ****************************************************************************/
+
+bool mm_guard_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_guard_s *slot;
+  irqstate_t flags;
+  size_t offset;
+  size_t size;
+
+  flags = spin_lock_irqsave(&heap->mm_guardlock);
+  slot = mm_guard_find(heap, mem);
+  if (slot == NULL)
+    {
+      spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+      return false;
+    }
+
+  size = slot->size;
+  if (slot->state != MM_GUARD_LIVE)
+    {
+      spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+      mm_guard_fault("double free", mem, size, 0);
+    }
+
+  slot->state = MM_GUARD_BUSY;
+  spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+
+  offset = mm_guard_check(mem, size, size + CONFIG_MM_HEAP_GUARD_SIZE,
+                          MM_GUARD_CANARY);
+  if (offset < size + CONFIG_MM_HEAP_GUARD_SIZE)
+    {
+      mm_guard_fault("write past end", mem, size, offset);
+    }
+
+  memset(mem, MM_FREE_MAGIC, size + CONFIG_MM_HEAP_GUARD_SIZE);
+
+  flags = spin_lock_irqsave(&heap->mm_guardlock);
+  slot->state = MM_GUARD_FREED;
+  spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_guard_size
+ *
+ * Description:
+ *   Return the requested size of a live guarded block, or -1 if mem is not
+ *   one.
+ *
+ ****************************************************************************/
+
+ssize_t mm_guard_size(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  FAR struct mm_guard_s *slot;
+  irqstate_t flags;
+  ssize_t size = -1;
+
+  flags = spin_lock_irqsave(&heap->mm_guardlock);
+  slot = mm_guard_find(heap, mem);
+  if (slot != NULL && slot->state == MM_GUARD_LIVE)
+    {
+      size = slot->size;
+    }
+
+  spin_unlock_irqrestore(&heap->mm_guardlock, flags);
+  return size;
+}
+
+#endif /* CONFIG_MM_HEAP_GUARD_SAMPLE > 0 */
@@ -78,6 +78,47 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
 #  define mempool_memalign mm_memalign
 #endif
 
+/****************************************************************************
+ * Name: mm_initialize_arena
+ *
+ * Description:
+ *   Reserve the arena that backs the multiple mempool of the heap.  It is
+ *   allocated right after the heap is initialized, so it is contiguous and
+ *   sits below the later allocations.
+ *
+ * Returned Value:
+ *   The heap to expand the pools from: the arena, or the heap itself if
+ *   the arena cannot be allocated.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL) && CONFIG_MM_HEAP_MEMPOOL_ARENA_SIZE > 0
+static FAR struct mm_heap_s *
+mm_initialize_arena(FAR struct mm_heap_s *heap,
+                    FAR const struct mm_heap_config_s *config)
+{
+  struct mm_heap_config_s arena;
+
+  memset(&arena, 0, sizeof(arena));
+  arena.name    = "mempool";
+  arena.start   = mm_malloc(heap, CONFIG_MM_HEAP_MEMPOOL_ARENA_SIZE);
+  arena.size    = CONFIG_MM_HEAP_MEMPOOL_ARENA_SIZE;
+
+  /* The arena is an allocation of the heap, KASan already tracks it */
+
+  arena.nokasan = true;
+
+  if (arena.start == NULL)
+    {
+      mwarn("WARNING: No memory for the %s mempool arena\n", config->name);
+      return heap;
+    }
+
+  heap->mm_poolheap = mm_initialize_heap(&arena);
+  return heap->mm_poolheap;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -271,6 +312,10 @@ mm_initialize_heap(FAR const struct mm_heap_config_s *config)
   memset(heap, 0, sizeof(struct mm_heap_s));
   heap->mm_nokasan = config->nokasan;
 
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+  mm_guard_initialize(heap);
+#endif
+
   /* Initialize the node array */
 
   for (i = 1; i < MM_NNODES; i++)
@@ -315,6 +360,7 @@ mm_initialize_pool(FAR const struct mm_heap_config_s *config,
                    FAR const struct mempool_init_s *init)
 {
   FAR struct mm_heap_s *heap;
+  FAR struct mm_heap_s *poolheap;
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD > 0
   size_t poolsize[MEMPOOL_NPOOLS];
   struct mempool_init_s def;
@@ -346,17 +392,22 @@ mm_initialize_pool(FAR const struct mm_heap_config_s *config,
 #endif
 
   heap = mm_initialize_heap(config);
+  poolheap = heap;
 
   /* Initialize the multiple mempool in heap */
 
   if (init != NULL && init->poolsize != NULL && init->npools != 0)
     {
+#if CONFIG_MM_HEAP_MEMPOOL_ARENA_SIZE > 0
+      poolheap = mm_initialize_arena(heap, config);
+#endif
+
       heap->mm_threshold = init->threshold;
       heap->mm_mpool     = mempool_multiple_init(config->name,
                                init->poolsize, init->npools,
                                (mempool_multiple_alloc_t)mempool_memalign,
                                (mempool_multiple_alloc_size_t)mm_malloc_size,
-                               (mempool_multiple_free_t)mm_free, heap,
+                               (mempool_multiple_free_t)mm_free, poolheap,
                                init->chunksize, init->expandsize,
                                init->dict_expendsize);
     }
@@ -385,6 +436,14 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   mempool_multiple_deinit(heap->mm_mpool);
+#  if CONFIG_MM_HEAP_MEMPOOL_ARENA_SIZE > 0
+  heap->mm_mpool = NULL;
+  if (heap->mm_poolheap != NULL)
+    {
+      mm_uninitialize(heap->mm_poolheap);
+      mm_free(heap, heap->mm_poolheap);
+    }
+#  endif
 #endif
 
   mm_free_delaylist(heap);
@@ -174,6 +174,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   size_t nodesize;
   FAR void *ret = NULL;
   int ndx;
+  MM_TELEMETRY_START(start);
+
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+  /* Place a sampled allocation in a guarded slot */
+
+  ret = mm_guard_malloc(heap, size);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
 
   /* Free the delay list first */
 
@@ -185,6 +196,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       ret = mempool_multiple_alloc(heap->mm_mpool, size);
       if (ret != NULL)
         {
+          MM_TELEMETRY_MALLOC(heap, start);
           return ret;
         }
     }
@@ -408,6 +420,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+  MM_TELEMETRY_MALLOC(heap, start);
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
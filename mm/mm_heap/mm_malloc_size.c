@@ -45,6 +45,15 @@ size_t mm_malloc_size(FAR struct mm_heap_s *heap, FAR void *mem)
   bool flag;
 
   flag = kasan_bypass(true);
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+  size = mm_guard_size(heap, mem);
+  if (size >= 0)
+    {
+      kasan_bypass(flag);
+      return size;
+    }
+#endif
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
     {
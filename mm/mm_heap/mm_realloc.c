@@ -86,6 +86,22 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
 
   DEBUGASSERT(mm_heapmember(heap, oldmem));
 
+#if CONFIG_MM_HEAP_GUARD_SAMPLE > 0
+  /* A guarded block cannot be resized in place, its canary would move */
+
+  if (mm_guard_size(heap, oldmem) >= 0)
+    {
+      newmem = mm_malloc(heap, size);
+      if (newmem != NULL)
+        {
+          memcpy(newmem, oldmem, MIN(size, mm_malloc_size(heap, oldmem)));
+          mm_free(heap, oldmem);
+        }
+
+      return newmem;
+    }
+#endif
+
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   if (heap->mm_mpool)
     {
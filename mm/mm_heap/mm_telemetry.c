@@ -0,0 +1,183 @@
+/****************************************************************************
+ * mm/mm_heap/mm_telemetry.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: telemetry_bucket
+ ****************************************************************************/
+
+static int telemetry_bucket(uint64_t value)
+{
+  int bucket;
+
+  if (value == 0)
+    {
+      return 0;
+    }
+
+  bucket = flsll(value) - 1;
+  return bucket < MM_TELEMETRY_NBUCKETS ?
+         bucket : MM_TELEMETRY_NBUCKETS - 1;
+}
+
+/****************************************************************************
+ * Name: telemetry_ns
+ ****************************************************************************/
+
+static unsigned long telemetry_ns(clock_t ticks)
+{
+  struct timespec ts;
+
+  perf_convert(ticks, &ts);
+  return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: telemetry_percentile
+ *
+ * Description:
+ *   Return the upper bound in ns of the bucket that holds the given
+ *   percentile of the latency histogram.
+ *
+ ****************************************************************************/
+
+static unsigned long telemetry_percentile(FAR const uint32_t *hist,
+                                          unsigned int percent)
+{
+  uint64_t total = 0;
+  uint64_t count = 0;
+  int i;
+
+  for (i = 0; i < MM_TELEMETRY_NBUCKETS; i++)
+    {
+      total += hist[i];
+    }
+
+  if (total == 0)
+    {
+      return 0;
+    }
+
+  for (i = 0; i < MM_TELEMETRY_NBUCKETS - 1; i++)
+    {
+      count += hist[i];
+      if (count * 100 >= total * percent)
+        {
+          break;
+        }
+    }
+
+  return telemetry_ns(((clock_t)2 << i) - 1);
+}
+
+/****************************************************************************
+ * Name: telemetry_handler
+ ****************************************************************************/
+
+static void telemetry_handler(FAR struct mm_allocnode_s *node,
+                              FAR void *arg)
+{
+  FAR struct mm_telemetry_s *info = arg;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+
+  if (!MM_NODE_IS_ALLOC(node))
+    {
+      info->freehist[telemetry_bucket(nodesize)]++;
+      if (nodesize > info->mxordblk)
+        {
+          info->mxordblk = nodesize;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_telemetry_latency
+ *
+ * Description:
+ *   Account one mm_malloc() or mm_free() call that started at the given
+ *   perf_gettime() value.  The counters are updated without the heap lock,
+ *   concurrent callers may rarely lose a count.
+ *
+ ****************************************************************************/
+
+void mm_telemetry_latency(FAR uint32_t *hist, FAR clock_t *max,
+                          clock_t start)
+{
+  clock_t elapsed = perf_gettime() - start;
+
+  hist[telemetry_bucket(elapsed)]++;
+  if (elapsed > *max)
+    {
+      *max = elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_telemetry
+ *
+ * Description:
+ *   Collect the free chunk histogram and the latency statistics of a heap.
+ *   Free space inside the multiple mempool is not included.  The name
+ *   field is left to the caller.
+ *
+ ****************************************************************************/
+
+void mm_telemetry(FAR struct mm_heap_s *heap,
+                  FAR struct mm_telemetry_s *info)
+{
+  DEBUGASSERT(heap != NULL && info != NULL);
+
+  memset(info, 0, sizeof(*info));
+  mm_foreach(heap, telemetry_handler, info);
+
+  memcpy(info->mallochist, heap->mm_malloclat, sizeof(info->mallochist));
+  memcpy(info->freelathist, heap->mm_freelat, sizeof(info->freelathist));
+
+  info->malloc_p50 = telemetry_percentile(info->mallochist, 50);
+  info->malloc_p99 = telemetry_percentile(info->mallochist, 99);
+  info->malloc_max = telemetry_ns(heap->mm_mallocmax);
+  info->free_p50   = telemetry_percentile(info->freelathist, 50);
+  info->free_p99   = telemetry_percentile(info->freelathist, 99);
+  info->free_max   = telemetry_ns(heap->mm_freemax);
+}
@@ -164,6 +164,8 @@ struct arp_entry_s
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
   clock_t                  at_time;     /* Time of last usage */
+  uint32_t                 at_used;     /* Tick of last lookup, for LRU */
+  uint16_t                 at_hnext;    /* Next in hash chain + 1, or 0 */
   uint8_t                  at_flags;    /* Flags, examples: ATF_PERM */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
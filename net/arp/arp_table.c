@@ -56,6 +56,8 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/mutex.h>
+#include <nuttx/seqlock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -75,6 +77,14 @@
 #define ARP_MAXAGE_UNREACHABLE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE_UNREACHABLE)
 #define ARP_INPROGRESS_TICK MSEC2TICK(CONFIG_ARP_SEND_MAXTRIES * CONFIG_ARP_SEND_DELAYMSEC)
 
+#if (CONFIG_NET_ARPTAB_NBUCKETS & (CONFIG_NET_ARPTAB_NBUCKETS - 1)) != 0
+#  error CONFIG_NET_ARPTAB_NBUCKETS must be a power of two
+#endif
+
+/* The hash chains link the table entries by index + 1, 0 ends a chain */
+
+#define ARP_NDX(tabptr) ((uint16_t)((tabptr) - g_arptable + 1))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -93,6 +103,25 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries in use, hashed by IP address */
+
+static uint16_t g_arphash[CONFIG_NET_ARPTAB_NBUCKETS];
+
+/* The ARP table is shared by all devices, so it has a lock of its own
+ * rather than relying on the lock of the device being serviced.  It is
+ * always taken after the device and connection locks.
+ */
+
+static rmutex_t g_arp_lock = NXRMUTEX_INITIALIZER;
+
+/* The writers, which hold g_arp_lock, also publish each change of an
+ * entry or of the hash chains through g_arp_seq, so that arp_find() on
+ * the TX path reads the table without taking any lock: it retries if a
+ * change overlapped with its lookup.
+ */
+
+static seqcount_t g_arp_seq = SEQLOCK_INITIALIZER;
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -150,11 +179,97 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+/****************************************************************************
+ * Name: arp_hash
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & (CONFIG_NET_ARPTAB_NBUCKETS - 1);
+}
+
+/****************************************************************************
+ * Name: arp_hash_link and arp_hash_unlink
+ *
+ * Description:
+ *   Add an entry to, or remove it from, the hash chain of its IP address.
+ *
+ * Assumptions:
+ *   The caller holds g_arp_lock and g_arp_seq for writing.
+ *
+ ****************************************************************************/
+
+static void arp_hash_link(FAR struct arp_entry_s *tabptr)
+{
+  FAR uint16_t *head = &g_arphash[arp_hash(tabptr->at_ipaddr)];
+
+  tabptr->at_hnext = *head;
+  *head = ARP_NDX(tabptr);
+}
+
+static void arp_hash_unlink(FAR struct arp_entry_s *tabptr)
+{
+  FAR uint16_t *link = &g_arphash[arp_hash(tabptr->at_ipaddr)];
+
+  while (*link != 0)
+    {
+      if (*link == ARP_NDX(tabptr))
+        {
+          *link = tabptr->at_hnext;
+          break;
+        }
+
+      link = &g_arptable[*link - 1].at_hnext;
+    }
+
+  tabptr->at_hnext = 0;
+}
+
+/****************************************************************************
+ * Name: arp_hash_find
+ *
+ * Description:
+ *   Find the ARP entry of this IP address and device, whatever its age.
+ *
+ * Assumptions:
+ *   The caller holds g_arp_lock, or reads g_arp_seq and retries the lookup
+ *   when it overlapped with a change: the walk is bounded, in case the
+ *   chains moved under it.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_hash_find(in_addr_t ipaddr,
+                                             FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+  uint16_t ndx = g_arphash[arp_hash(ipaddr)];
+  int hops;
+
+  for (hops = 0; ndx != 0 && hops < CONFIG_NET_ARPTAB_SIZE; hops++)
+    {
+      tabptr = &g_arptable[ndx - 1];
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+
+      ndx = tabptr->at_hnext;
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: arp_return_old_entry
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Compare and return the ARP table entry to replace first: a free one,
+ *   else the least recently used one which is not permanent.
  *
  ****************************************************************************/
 
@@ -173,7 +288,7 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
     {
       return (e1->at_flags & ATF_PERM) == 0 ? e1 : e2;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+  else if ((int32_t)(e1->at_used - e2->at_used) <= 0)
     {
       return e1;
     }
@@ -194,8 +309,8 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
  *   dev    - Device structure
  *
  * Assumptions:
- *   The network is locked to assure exclusive access to the ARP table.
- *   The return value will become unstable when the network is unlocked.
+ *   The caller holds g_arp_lock.  The return value will become unstable
+ *   once the lock is released.
  *
  ****************************************************************************/
 
@@ -203,29 +318,17 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_hash_find(ipaddr, dev);
+  if (tabptr != NULL && (tabptr->at_flags & ATF_PERM) == 0 &&
+      clock_systime_ticks() - tabptr->at_time > ARP_MAXAGE_TICK)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          if ((tabptr->at_flags & ATF_PERM) != 0 ||
-              clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-            {
-              return tabptr;
-            }
-
-          return NULL;  /* Expired */
-        }
+      return NULL;  /* Expired */
     }
 
-  /* Not found */
-
-  return NULL;
+  return tabptr;
 }
 
 /****************************************************************************
@@ -288,56 +391,42 @@ static void arp_unreach_work(FAR void *param)
  *   errno value is returned on any error.
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr, uint8_t flags)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
   bool new_entry;
 #endif
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-  bool found = false;
-#endif
+  irqstate_t irqflags;
+  bool found;
   int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Look up the entry to update.  If none is found, the IP -> MAC address
+   * mapping replaces a free or the least recently used entry.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
-    {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
+  nxrmutex_lock(&g_arp_lock);
+  tabptr = ipaddr != 0 ? arp_hash_find(ipaddr, dev) : NULL;
+  found  = tabptr != NULL;
 
-          tabptr = &g_arptable[i];
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-          found = true;
-#endif
-          break;
-        }
-      else
+  if (!found)
+    {
+      tabptr = &g_arptable[0];
+      for (i = 1; i < CONFIG_NET_ARPTAB_SIZE; ++i)
         {
-          /* Record the oldest entry. */
-
           tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
         }
     }
 
   if ((tabptr->at_flags & ATF_PERM) != 0 && (flags & ATF_PERM) == 0)
     {
+      nxrmutex_unlock(&g_arp_lock);
       return -ENOSPC;
     }
 
@@ -380,12 +469,27 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
    * information.
    */
 
+  irqflags = write_seqlock_irqsave(&g_arp_seq);
+
+  if (!found && tabptr->at_ipaddr != 0)
+    {
+      arp_hash_unlink(tabptr);
+    }
+
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_ipaddr = ipaddr;
   tabptr->at_time   = clock_systime_ticks();
+  tabptr->at_used   = (uint32_t)tabptr->at_time;
   tabptr->at_flags  = flags;
   tabptr->at_dev    = dev;
 
+  if (!found && ipaddr != 0)
+    {
+      arp_hash_link(tabptr);
+    }
+
+  write_sequnlock_irqrestore(&g_arp_seq, irqflags);
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -396,6 +500,12 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
     }
 #endif
 
+  /* The pending packets were moved to the device, so they can go out
+   * without holding up the other users of the table.
+   */
+
+  nxrmutex_unlock(&g_arp_lock);
+
 #ifdef CONFIG_NET_ARP_SEND_QUEUE
   if (!IOB_QEMPTY(&dev->d_arpout))
     {
@@ -438,7 +548,7 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
  *   errno value is returned on any error.
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
@@ -468,7 +578,7 @@ void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
  *   dev     - Device structure
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table.
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
@@ -477,32 +587,54 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
 {
   FAR struct arp_entry_s *tabptr;
   struct arp_table_info_s info;
+  struct ether_addr at_ethaddr;
+  clock_t at_time = 0;
+  uint32_t seq;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is already in the ARP table.  This runs for
+   * each packet sent, so it takes no lock but copies the entry out and
+   * retries if the table changed meanwhile.
+   */
+
+  do
+    {
+      seq    = read_seqbegin(&g_arp_seq);
+      tabptr = arp_lookup(ipaddr, dev);
+      if (tabptr != NULL)
+        {
+          at_ethaddr = tabptr->at_ethaddr;
+          at_time    = tabptr->at_time;
+        }
+    }
+  while (read_seqretry(&g_arp_seq, seq));
 
-  tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
+      int ret = OK;
+
+      /* A racy store, it only steers the replacement of entries */
+
+      tabptr->at_used = (uint32_t)clock_systime_ticks();
+
       /* Addresses that have failed to be searched will return a special
        * error code so that the upper layer can return faster.
        */
 
-      if (memcmp(&tabptr->at_ethaddr, &g_zero_ethaddr,
-                 sizeof(tabptr->at_ethaddr)) == 0)
+      if (memcmp(&at_ethaddr, &g_zero_ethaddr, sizeof(at_ethaddr)) == 0)
         {
           clock_t elapsed;
-          elapsed = clock_systime_ticks() - tabptr->at_time;
+          elapsed = clock_systime_ticks() - at_time;
           if (elapsed <= ARP_INPROGRESS_TICK)
             {
-              return -EINPROGRESS;
+              ret = -EINPROGRESS;
             }
           else if (elapsed <= ARP_MAXAGE_UNREACHABLE_TICK)
             {
-              return -ENETUNREACH;
+              ret = -ENETUNREACH;
             }
           else
             {
-              return -ENOENT;
+              ret = -ENOENT;
             }
         }
 
@@ -510,16 +642,16 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
        * non-NULL address in 'ethaddr'.
        */
 
-      if (ethaddr != NULL)
+      else if (ethaddr != NULL)
         {
-          memcpy(ethaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
+          memcpy(ethaddr, &at_ethaddr, ETHER_ADDR_LEN);
         }
 
       /* Return success meaning that a valid Ethernet MAC address mapping
        * is available for the IP address.
        */
 
-      return OK;
+      return ret;
     }
 
   /* No.. check if the IPv4 address is the address assigned to a local
@@ -551,7 +683,7 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
  *   dev    - Device structure
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table.
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
@@ -561,8 +693,11 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
 #endif
+  irqstate_t flags;
+
   /* Check if the IPv4 address is in the ARP table. */
 
+  nxrmutex_lock(&g_arp_lock);
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr != NULL)
     {
@@ -575,10 +710,15 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
       /* Yes.. Set the IP address to zero to "delete" it */
 
+      flags = write_seqlock_irqsave(&g_arp_seq);
+      arp_hash_unlink(tabptr);
       tabptr->at_ipaddr = 0;
+      write_sequnlock_irqrestore(&g_arp_seq, flags);
+      nxrmutex_unlock(&g_arp_lock);
       return OK;
     }
 
+  nxrmutex_unlock(&g_arp_lock);
   return -ENOENT;
 }
 
@@ -592,14 +732,16 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
  *   dev  - The device driver structure
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table.
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
+  irqstate_t flags;
   int i;
 
+  nxrmutex_lock(&g_arp_lock);
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
       if (dev == g_arptable[i].at_dev)
@@ -609,9 +751,18 @@ void arp_cleanup(FAR struct net_driver_s *dev)
           iob_free_queue(&g_arptable[i].at_queue);
 #endif
 
+          flags = write_seqlock_irqsave(&g_arp_seq);
+          if (g_arptable[i].at_ipaddr != 0)
+            {
+              arp_hash_unlink(&g_arptable[i]);
+            }
+
           memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          write_sequnlock_irqrestore(&g_arp_seq, flags);
         }
     }
+
+  nxrmutex_unlock(&g_arp_lock);
 }
 
 /****************************************************************************
@@ -630,7 +781,7 @@ void arp_cleanup(FAR struct net_driver_s *dev)
  *   entries are not returned.
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
@@ -645,6 +796,7 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
 
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
+  nxrmutex_lock(&g_arp_lock);
   for (i = 0, now = clock_systime_ticks(), ncopied = 0;
        nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
        i++)
@@ -658,6 +810,8 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
         }
     }
 
+  nxrmutex_unlock(&g_arp_lock);
+
   /* Return the number of entries copied into the user buffer */
 
   return ncopied;
@@ -681,7 +835,7 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
  *   errno value is returned on any error.
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table
+ *   The ARP table is locked internally.
  *
  ****************************************************************************/
 
@@ -690,13 +844,16 @@ int arp_queue_iob(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                   FAR struct iob_s *iob)
 {
   FAR struct arp_entry_s *tabptr;
+  int ret = -ENOENT;
 
   /* the IPv4 address should in the ARP table and arp in progress. */
 
+  nxrmutex_lock(&g_arp_lock);
   tabptr = arp_lookup(ipaddr, dev);
   if (tabptr && memcmp(&tabptr->at_ethaddr, &g_zero_ethaddr,
                        sizeof(tabptr->at_ethaddr)) == 0)
     {
+      ret = -ENOMEM;
       if (iob_tryadd_queue(iob, &tabptr->at_queue) == 0)
         {
           if (work_available(&tabptr->at_work))
@@ -705,13 +862,12 @@ int arp_queue_iob(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                          tabptr, ARP_INPROGRESS_TICK);
             }
 
-          return OK;
+          ret = OK;
         }
-
-      return -ENOMEM;
     }
 
-  return -ENOENT;
+  nxrmutex_unlock(&g_arp_lock);
+  return ret;
 }
 #endif
 #endif /* CONFIG_NET_ARP */
@@ -289,6 +289,29 @@ int can_datahandler(FAR struct net_driver_s *dev,
 ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of frames, draining the read-ahead queue under one
+ *   hold of the connection lock.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of frames received, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: can_poll
  *
@@ -38,6 +38,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -398,6 +399,41 @@ static ssize_t can_recvfrom_result(int result,
   return pstate->pr_recvlen;
 }
 
+/****************************************************************************
+ * Name: can_recvfrom_init
+ *
+ * Description:
+ *   Set up the receive state for one message.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+static void can_recvfrom_init(FAR struct can_recvfrom_s *pstate,
+                              FAR struct can_conn_s *conn,
+                              FAR struct msghdr *msg)
+{
+  memset(pstate, 0, sizeof(struct can_recvfrom_s));
+
+  pstate->pr_buflen = msg->msg_iov->iov_len;
+  pstate->pr_buffer = msg->msg_iov->iov_base;
+
+#ifdef CONFIG_NET_TIMESTAMP
+  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
+    {
+      pstate->pr_msgbuf = cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP,
+                                      NULL, sizeof(struct timeval));
+      if (pstate->pr_msgbuf != NULL)
+        {
+          pstate->pr_msglen = sizeof(struct timeval);
+        }
+    }
+#endif
+
+  pstate->pr_conn = conn;
+}
+
 /****************************************************************************
  * Name: can_recvmsg
  *
@@ -442,26 +478,9 @@ ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   /* Initialize the state structure. */
 
-  memset(&state, 0, sizeof(struct can_recvfrom_s));
+  can_recvfrom_init(&state, conn, msg);
   nxsem_init(&state.pr_sem, 0, 0); /* Doesn't really fail */
 
-  state.pr_buflen = msg->msg_iov->iov_len;
-  state.pr_buffer = msg->msg_iov->iov_base;
-
-#ifdef CONFIG_NET_TIMESTAMP
-  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
-    {
-      state.pr_msgbuf = cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP,
-                                    NULL, sizeof(struct timeval));
-      if (state.pr_msgbuf != NULL)
-        {
-          state.pr_msglen = sizeof(struct timeval);
-        }
-    }
-#endif
-
-  state.pr_conn = conn;
-
   /* Handle any any CAN data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
    * socket has been disconnected.
@@ -544,4 +563,105 @@ errout_with_state:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of frames under one hold of the connection lock: the
+ *   read-ahead queue is drained into successive messages and only an
+ *   empty queue makes the caller wait in can_recvmsg().
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of frames received, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR const struct timespec *timeout)
+{
+  FAR struct can_conn_s *conn = psock->s_conn;
+  struct can_recvfrom_s state;
+  FAR struct msghdr *msg;
+  unsigned long controllen;
+  FAR void *control;
+  clock_t end = 0;
+  unsigned int i;
+  ssize_t ret = 0;
+
+  if (psock->s_type != SOCK_RAW)
+    {
+      nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
+      return -ENOSYS;
+    }
+
+  if (timeout != NULL)
+    {
+      end = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  conn_lock(&conn->sconn);
+
+  for (i = 0; i < vlen; i++)
+    {
+      if (i > 0 && timeout != NULL &&
+          clock_compare(end, clock_systime_ticks()))
+        {
+          break;
+        }
+
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_iovlen != 1)
+        {
+          ret = -ENOTSUP;
+          break;
+        }
+
+      /* Return the true control message length like psock_recvmsg() */
+
+      control    = msg->msg_control;
+      controllen = msg->msg_controllen;
+
+      can_recvfrom_init(&state, conn, msg);
+      ret = can_readahead(&state);
+      if (ret <= 0)
+        {
+          /* Nothing queued, wait for the next frame like recvmsg() */
+
+          msg->msg_control    = control;
+          msg->msg_controllen = controllen;
+
+          conn_unlock(&conn->sconn);
+          ret = can_recvmsg(psock, msg, flags);
+          conn_lock(&conn->sconn);
+        }
+
+      msg->msg_control    = control;
+      msg->msg_controllen = controllen - msg->msg_controllen;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+
+  return i > 0 ? i : ret;
+}
+
 #endif /* CONFIG_NET_CAN */
@@ -1264,11 +1264,11 @@ void devif_out(FAR struct net_driver_s *dev)
 int devif_poll_out(FAR struct net_driver_s *dev,
                    devif_poll_callback_t callback)
 {
-  int bstop;
+  int bstop = 0;
 
   if (dev->d_len == 0)
     {
-      return 0;
+      goto out;
     }
 
   devif_out(dev);
@@ -1276,7 +1276,7 @@ int devif_poll_out(FAR struct net_driver_s *dev,
   bstop = devif_loopback(dev);
   if (bstop)
     {
-      return bstop;
+      goto out;
     }
 
   if (callback)
@@ -1285,18 +1285,27 @@ int devif_poll_out(FAR struct net_driver_s *dev,
       if (ip_fragout(dev) != OK)
         {
           netdev_iob_release(dev);
-          return 1;
+          bstop = 1;
+          goto out;
         }
       else if (iob_peek_queue(&dev->d_fragout) != NULL)
         {
-          return devif_poll_ipfrag(dev, callback);
+          bstop = devif_poll_ipfrag(dev, callback);
+          goto out;
         }
 #endif
 
-      return callback(dev);
+      bstop = callback(dev);
     }
 
-  return 0;
+out:
+#ifdef CONFIG_NET_GSO
+  /* The GSO hint only applies to the packet just handed to the driver */
+
+  dev->d_gso_size = 0;
+#endif
+
+  return bstop;
 }
 
 /****************************************************************************
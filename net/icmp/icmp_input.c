@@ -326,7 +326,10 @@ void icmp_input(FAR struct net_driver_s *dev)
   icmp = IPBUF(iphdrlen);
 
 #ifdef CONFIG_NET_ICMP_CHECKSUMS
-  csum = icmp_chksum_iob(dev->d_iob);
+  /* NETDEV_RX_CSUM does not cover ICMP, only a per-packet verdict does */
+
+  csum = NETDEV_PKT_CSUM_VERIFIED(dev) ? 0xffff :
+         icmp_chksum_iob(dev->d_iob);
   if (csum != 0xffff)
     {
       ninfo("ICMP checksum error\n");
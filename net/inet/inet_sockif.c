@@ -33,6 +33,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <netinet/tls.h>
+
 #include <nuttx/net/net.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/tcp.h>
@@ -115,6 +117,13 @@ static ssize_t    inet_sendfile(FAR struct socket *psock,
                                 FAR struct file *infile, FAR off_t *offset,
                                 size_t count);
 #endif
+static int        inet_sendmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                                FAR struct mmsghdr *msgvec,
+                                unsigned int vlen, int flags,
+                                FAR const struct timespec *timeout);
 
 /****************************************************************************
  * Private Data
@@ -145,6 +154,8 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+  , inet_sendmmsg   /* si_sendmmsg */
+  , inet_recvmmsg   /* si_recvmmsg */
 };
 
 /****************************************************************************
@@ -690,6 +701,26 @@ static int inet_get_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TCP_PACING
+      case SO_MAX_PACING_RATE: /* Reports the pacing rate limit */
+        {
+          FAR struct tcp_conn_s *tcp = psock->s_conn;
+
+          if (*value_len != sizeof(unsigned int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_STREAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          *(FAR unsigned int *)value = tcp->pacing.max_rate;
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
       case SO_KEEPALIVE:
         {
@@ -1017,6 +1048,28 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TCP_PACING
+      case SO_MAX_PACING_RATE: /* Caps the pacing rate */
+        {
+          FAR struct tcp_conn_s *tcp = psock->s_conn;
+
+          if (value_len != sizeof(unsigned int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_STREAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          conn_lock(psock->s_conn);
+          tcp->pacing.max_rate = *(FAR const unsigned int *)value;
+          conn_unlock(psock->s_conn);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP: /* Report receive timestamps as cmsg */
         {
@@ -1091,6 +1144,16 @@ static int inet_setsockopt(FAR struct socket *psock, int level, int option,
         return tcp_setsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_TCP_TLS
+      case SOL_TLS: /* TLS record layer options (see include/netinet/tls.h) */
+        if (psock->s_type != SOCK_STREAM)
+          {
+            return -ENOPROTOOPT;
+          }
+
+        return tcp_tls_setsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_UDPPROTO_OPTIONS
       case IPPROTO_UDP:/* UDP protocol socket options (see include/netinet/udp.h) */
         return udp_setsockopt(psock, option, value, value_len);
@@ -1686,6 +1749,16 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 #ifdef CONFIG_NET_TCP
       case SOCK_STREAM:
         {
+#ifdef CONFIG_NET_TCP_TLS
+          /* Seal the data in TLS records once the keys are installed */
+
+          if (tcp_tls_enabled(psock->s_conn, TLS_TX))
+            {
+              ret = tcp_tls_send(psock, buf, len, flags);
+              break;
+            }
+#endif
+
 #ifdef CONFIG_NET_6LOWPAN
           /* Try 6LoWPAN TCP packet send */
 
@@ -1755,33 +1828,26 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 }
 
 /****************************************************************************
- * Name: inet_sendto
+ * Name: inet_sendto_checkaddr
  *
  * Description:
- *   Implements the sendto() operation for the case of the AF_INET and
- *   AF_INET6 sockets.
+ *   Verify the destination address of a sendto() on an AF_INET or AF_INET6
+ *   socket.
  *
  * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
  *
  * Returned Value:
- *   On success, returns the number of characters sent.  On  error, a negated
- *   errno value is returned (see send_to() for the list of appropriate error
- *   values.
+ *   The minimum length of an address of this family on success, or a
+ *   negated errno value.
  *
  ****************************************************************************/
 
-static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags,
-                           FAR const struct sockaddr *to, socklen_t tolen)
+static int inet_sendto_checkaddr(FAR const struct sockaddr *to,
+                                 socklen_t tolen)
 {
   socklen_t minlen;
-  ssize_t nsent;
 
   /* Verify that a valid address has been provided */
 
@@ -1810,6 +1876,45 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EBADF;
     }
 
+  return minlen;
+}
+
+/****************************************************************************
+ * Name: inet_sendto
+ *
+ * Description:
+ *   Implements the sendto() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
+                           size_t len, int flags,
+                           FAR const struct sockaddr *to, socklen_t tolen)
+{
+  ssize_t nsent;
+
+  /* On success, nsent holds the minimum address length */
+
+  nsent = inet_sendto_checkaddr(to, tolen);
+  if (nsent < 0)
+    {
+      return nsent;
+    }
+
 #ifdef CONFIG_NET_UDP
   if (psock->s_type != SOCK_DGRAM)
     {
@@ -1822,7 +1927,7 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
 #if defined(CONFIG_NET_6LOWPAN)
   /* Try 6LoWPAN UDP packet sendto() */
 
-  nsent = psock_6lowpan_udp_sendto(psock, buf, len, flags, to, minlen);
+  nsent = psock_6lowpan_udp_sendto(psock, buf, len, flags, to, nsent);
 
 #ifdef NET_UDP_HAVE_STACK
   if (nsent < 0)
@@ -1906,6 +2011,15 @@ static ssize_t inet_sendmsg(FAR struct socket *psock,
       len += iov->iov_len;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The gathered data is freed below, so it cannot be sent in place */
+
+  if (psock->s_type == SOCK_STREAM && (flags & MSG_ZEROCOPY) != 0)
+    {
+      flags |= TCP_MSG_ZCCOPY;
+    }
+#endif
+
   ret = to ? inet_sendto(psock, buf, len, flags, to, tolen) :
              inet_send(psock, buf, len, flags);
 
@@ -2154,6 +2268,15 @@ static ssize_t inet_sendfile(FAR struct socket *psock,
 #ifdef NET_TCP_HAVE_STACK
   if (psock->s_type == SOCK_STREAM)
     {
+      /* The file content must go through the TLS record layer: let the
+       * generic sendfile() read chunks and send them.
+       */
+
+      if (tcp_tls_enabled(psock->s_conn, TLS_TX))
+        {
+          return -ENOSYS;
+        }
+
       return tcp_sendfile(psock, infile, offset, count);
     }
 #endif
@@ -2243,6 +2366,15 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
 #ifdef CONFIG_NET_TCP
     case SOCK_STREAM:
       {
+#ifdef CONFIG_NET_TCP_TLS
+        if (tcp_tls_enabled(psock->s_conn, TLS_RX) &&
+            (flags & MSG_ERRQUEUE) == 0)
+          {
+            ret = tcp_tls_recvmsg(psock, msg, flags);
+            break;
+          }
+#endif
+
 #ifdef NET_TCP_HAVE_STACK
         ret = psock_tcp_recvfrom(psock, msg, flags);
 #else
@@ -2275,6 +2407,138 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  Buffered UDP sockets queue the whole batch at once;
+ *   everything else is left to the generic loop over inet_sendmsg().
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, or a negated errno value if not even the
+ *   first one could be.  -ENOSYS if the batch is not handled here.
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags)
+{
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+    !defined(CONFIG_NET_6LOWPAN)
+  FAR struct msghdr *msg;
+  unsigned int i;
+  int ret;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* Only the messages before the first bad destination are sent */
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_name != NULL)
+        {
+          ret = inet_sendto_checkaddr(msg->msg_name, msg->msg_namelen);
+          if (ret < 0)
+            {
+              if (i == 0)
+                {
+                  return ret;
+                }
+
+              vlen = i;
+              break;
+            }
+        }
+    }
+
+  return psock_udp_sendmmsg(psock, msgvec, vlen, flags);
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements the recvmmsg() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.  UDP sockets receive the whole batch at once;
+ *   everything else is left to the generic loop over inet_recvmsg().
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of messages received, or a negated errno value if not even
+ *   the first one could be.  -ENOSYS if the batch is not handled here.
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec,
+                         unsigned int vlen, int flags,
+                         FAR const struct timespec *timeout)
+{
+#ifdef NET_UDP_HAVE_STACK
+  FAR struct msghdr *msg;
+  socklen_t minlen;
+  unsigned int i;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  minlen = psock->s_domain == PF_INET ? sizeof(struct sockaddr_in) :
+                                        sizeof(struct sockaddr_in6);
+#elif defined(CONFIG_NET_IPv4)
+  minlen = sizeof(struct sockaddr_in);
+#else
+  minlen = sizeof(struct sockaddr_in6);
+#endif
+
+  /* Only the buffers before the first too small 'from' address are
+   * filled.
+   */
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_name != NULL && msg->msg_namelen < minlen)
+        {
+          if (i == 0)
+            {
+              return -EINVAL;
+            }
+
+          vlen = i;
+          break;
+        }
+    }
+
+  return psock_udp_recvmmsg(psock, msgvec, vlen, flags, timeout);
+#else
+  return -ENOSYS;
+#endif
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
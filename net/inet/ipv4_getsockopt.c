@@ -83,6 +83,9 @@ int ipv4_getsockopt(FAR struct socket *psock, int option,
 #ifdef CONFIG_NET_IPTABLES
       case IPT_SO_GET_INFO:
       case IPT_SO_GET_ENTRIES:
+#  ifdef CONFIG_NET_IPFILTER_SET
+      case SO_IP_SET:
+#  endif
         ret = ipt_getsockopt(psock, option, value, value_len);
         break;
 #endif
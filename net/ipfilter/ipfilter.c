@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <errno.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/icmpv6.h>
@@ -65,21 +67,108 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The packet fields the compiled chains are hashed on.  A rule gives a
+ * value and a mask of the same layout, addresses are in network byte
+ * order and the port in host byte order.
+ */
+
+struct ipfilter_key_s
+{
+  uint32_t src[IPFILTER_ADDRWORDS];
+  uint32_t dst[IPFILTER_ADDRWORDS];
+  uint16_t dport;
+  uint8_t  proto;
+};
+
+/* The packet under test */
+
+struct ipfilter_packet_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  FAR const void *iphdr;
+  FAR const void *l4hdr;
+  uint32_t len;                  /* For the byte counters */
+  struct ipfilter_key_s key;
+};
+
+/* A compiled chain is a tuple space: the rules are grouped by the mask of
+ * their key, and each group is looked up with one probe of a hash table
+ * over the masked key.  The cost of a packet depends on the number of
+ * distinct masks, not on the number of rules.  Fields a rule cannot be
+ * hashed on (inverted matches, port ranges, devices, sets) are masked out
+ * and checked on the candidates only.
+ */
+
+struct ipfilter_tuple_s
+{
+  struct ipfilter_key_s mask;
+  uint32_t first;                /* Index of the first rule of the group */
+};
+
+struct ipfilter_table_s
+{
+  FAR struct ipfilter_entry_s **buckets; /* Rules by increasing index */
+  FAR struct ipfilter_tuple_s *tuples;   /* By increasing first rule */
+  uint32_t ntuples;
+  uint32_t mask;                         /* Number of buckets - 1 */
+};
+
+struct ipfilter_chain_s
+{
+  sq_queue_t entries;
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  FAR struct ipfilter_table_s *table;    /* NULL: match linearly */
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
+static struct ipfilter_chain_s g_ipv4_filters[IPFILTER_CHAIN_MAX];
 #endif
 #ifdef CONFIG_NET_IPv6
-static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
+static struct ipfilter_chain_s g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ipfilter_chain
+ *
+ * Description:
+ *   Get the chain of the given address family.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_chain_s *
+ipfilter_chain(sa_family_t family, enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      return &g_ipv4_filters[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      return &g_ipv6_filters[chain];
+    }
+#endif
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: ipfilter_match_device
  *
@@ -189,161 +278,471 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
 }
 
 /****************************************************************************
- * Name: ipv4_filter_match / ipv6_filter_match
+ * Name: ipfilter_match_addr
  *
  * Description:
- *   Match the input packet with the filter entries in the specified chain.
- *
- * Input Parameters:
- *   indev     - The network device that the packet comes from
- *   outdev    - The network device that the packet goes to
- *   ipv4/ipv6 - The IPv4/IPv6 header
- *   chain     - The chain to match the filter entries
- *
- * Returned Value:
- *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
- *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
- *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *   Match the packet with the filter entry on addresses.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
-static int ipv4_filter_match(FAR const struct net_driver_s *indev,
-                             FAR const struct net_driver_s *outdev,
-                             FAR const struct ipv4_hdr_s *ipv4,
-                             enum ipfilter_chain_e chain)
+static bool ipfilter_match_addr(FAR const struct ipfilter_entry_s *entry,
+                                sa_family_t family,
+                                FAR const struct ipfilter_packet_s *pkt)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+  bool matched = false;
 
-  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR const struct ipv4_filter_entry_s *filter =
+        (FAR const struct ipv4_filter_entry_s *)entry;
 
-  if ((indev == NULL && outdev == NULL) || ipv4 == NULL)
+      matched = (net_ipv4addr_maskcmp(filter->sip, pkt->key.src[0],
+                                      filter->smsk) ^ entry->inv_srcip) &&
+                (net_ipv4addr_maskcmp(filter->dip, pkt->key.dst[0],
+                                      filter->dmsk) ^ entry->inv_dstip);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
     {
-      return IPFILTER_TARGET_ACCEPT;
+      FAR const struct ipv6_filter_entry_s *filter =
+        (FAR const struct ipv6_filter_entry_s *)entry;
+      FAR const struct ipv6_hdr_s *ipv6 = pkt->iphdr;
+
+      matched = (net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                      filter->smsk) ^ entry->inv_srcip) &&
+                (net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                      filter->dmsk) ^ entry->inv_dstip);
     }
+#endif
 
-  l4hdr = IPv4_L4HDR(ipv4);
+#ifdef CONFIG_NET_IPFILTER_SET
+  if (matched && entry->sset != NULL)
+    {
+      matched = ipfilter_set_match(entry->sset, pkt->key.src) ^
+                entry->inv_sset;
+    }
 
-  sq_for_every(queue, entry)
+  if (matched && entry->dset != NULL)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
+      matched = ipfilter_set_match(entry->dset, pkt->key.dst) ^
+                entry->inv_dset;
+    }
+#endif
+
+  return matched;
+}
+
+/****************************************************************************
+ * Name: ipfilter_match_entry
+ *
+ * Description:
+ *   Match the packet with one filter entry.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_match_entry(FAR const struct ipfilter_entry_s *entry,
+                                 sa_family_t family,
+                                 FAR const struct ipfilter_packet_s *pkt)
+{
+  return ipfilter_match_device(entry, pkt->indev, pkt->outdev) &&
+         ipfilter_match_addr(entry, family, pkt) &&
+         ipfilter_match_proto(entry, pkt->l4hdr, pkt->key.proto);
+}
+
+/****************************************************************************
+ * Name: ipfilter_search
+ *
+ * Description:
+ *   Find the first entry of the chain matching the packet, linearly.
+ *
+ ****************************************************************************/
 
-      /* Match device */
+static FAR struct ipfilter_entry_s *
+ipfilter_search(FAR const sq_queue_t *queue, sa_family_t family,
+                FAR const struct ipfilter_packet_s *pkt)
+{
+  FAR sq_entry_t *entry;
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+  sq_for_every(queue, entry)
+    {
+      if (ipfilter_match_entry((FAR struct ipfilter_entry_s *)entry,
+                               family, pkt))
         {
-          continue;
+          return (FAR struct ipfilter_entry_s *)entry;
         }
+    }
 
-      /* Match addresses */
+  return NULL;
+}
 
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+
+/****************************************************************************
+ * Name: ipfilter_key_hash
+ *
+ * Description:
+ *   Hash the masked key of a packet or a rule in one tuple.
+ *
+ ****************************************************************************/
+
+static uint32_t ipfilter_key_hash(FAR const struct ipfilter_key_s *key,
+                                  FAR const struct ipfilter_key_s *mask,
+                                  uint32_t tuple)
+{
+  uint32_t hash = 2166136261u ^ tuple;
+  int i;
+
+  for (i = 0; i < IPFILTER_ADDRWORDS; i++)
+    {
+      hash = (hash ^ (key->src[i] & mask->src[i])) * 16777619u;
+      hash = (hash ^ (key->dst[i] & mask->dst[i])) * 16777619u;
+    }
+
+  hash = (hash ^ (key->dport & mask->dport)) * 16777619u;
+  hash = (hash ^ (key->proto & mask->proto)) * 16777619u;
+
+  return hash ^ (hash >> 16);
+}
+
+/****************************************************************************
+ * Name: ipfilter_entry_key
+ *
+ * Description:
+ *   Get the key and mask of a rule, the fields it does not match exactly
+ *   and without inversion are left out of the mask.
+ *
+ ****************************************************************************/
+
+static void ipfilter_entry_key(FAR const struct ipfilter_entry_s *entry,
+                               sa_family_t family,
+                               FAR struct ipfilter_key_s *key,
+                               FAR struct ipfilter_key_s *mask)
+{
+  memset(key, 0, sizeof(*key));
+  memset(mask, 0, sizeof(*mask));
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR const struct ipv4_filter_entry_s *filter =
+        (FAR const struct ipv4_filter_entry_s *)entry;
+
+      if (!entry->inv_srcip)
         {
-          continue;
+          key->src[0]  = filter->sip;
+          mask->src[0] = filter->smsk;
         }
 
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+      if (!entry->inv_dstip)
         {
-          continue;
+          key->dst[0]  = filter->dip;
+          mask->dst[0] = filter->dmsk;
         }
+    }
+#endif
 
-      /* Match protocol */
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      FAR const struct ipv6_filter_entry_s *filter =
+        (FAR const struct ipv6_filter_entry_s *)entry;
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
+      if (!entry->inv_srcip)
         {
-          continue;
+          memcpy(key->src, filter->sip, sizeof(net_ipv6addr_t));
+          memcpy(mask->src, filter->smsk, sizeof(net_ipv6addr_t));
         }
 
-      /* Return the target action if matched. */
-
-      return filter->common.target;
+      if (!entry->inv_dstip)
+        {
+          memcpy(key->dst, filter->dip, sizeof(net_ipv6addr_t));
+          memcpy(mask->dst, filter->dmsk, sizeof(net_ipv6addr_t));
+        }
     }
+#endif
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  if (entry->proto != 0 && !entry->inv_proto)
+    {
+      key->proto  = entry->proto;
+      mask->proto = 0xff;
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+      if ((entry->proto == IP_PROTO_TCP || entry->proto == IP_PROTO_UDP) &&
+          entry->match_tcpudp && !entry->inv_dport &&
+          entry->match.tcpudp.dports[0] == entry->match.tcpudp.dports[1])
+        {
+          key->dport  = entry->match.tcpudp.dports[0];
+          mask->dport = 0xffff;
+        }
+    }
 }
-#endif
 
-#ifdef CONFIG_NET_IPv6
-static int ipv6_filter_match(FAR const struct net_driver_s *indev,
-                             FAR const struct net_driver_s *outdev,
-                             FAR const struct ipv6_hdr_s *ipv6,
-                             enum ipfilter_chain_e chain)
+/****************************************************************************
+ * Name: ipfilter_compile
+ *
+ * Description:
+ *   Build the tuple space of a chain.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_table_s *
+ipfilter_compile(FAR sq_queue_t *queue, sa_family_t family)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
-  uint8_t proto;
-  bool matched;
+  FAR struct ipfilter_entry_s **slot;
+  FAR struct ipfilter_entry_s *entry;
+  FAR struct ipfilter_table_s *table;
+  FAR sq_entry_t *node;
+  struct ipfilter_key_s mask;
+  struct ipfilter_key_s key;
+  uint32_t nbuckets = 8;
+  uint32_t count = 0;
+  uint32_t t;
+
+  sq_for_every(queue, node)
+    {
+      count++;
+    }
 
-  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+  while (nbuckets < 2 * count)
+    {
+      nbuckets <<= 1;
+    }
 
-  if ((indev == NULL && outdev == NULL) || ipv6 == NULL)
+  table = kmm_zalloc(sizeof(*table) + nbuckets * sizeof(*table->buckets) +
+                     count * sizeof(*table->tuples));
+  if (table == NULL)
     {
-      return IPFILTER_TARGET_ACCEPT;
+      return NULL;
     }
 
-  l4hdr = IPv6_L4HDR(ipv6, proto);
+  table->buckets = (FAR struct ipfilter_entry_s **)(table + 1);
+  table->tuples  = (FAR struct ipfilter_tuple_s *)
+                   (table->buckets + nbuckets);
+  table->mask    = nbuckets - 1;
 
-  sq_for_every(queue, entry)
+  count = 0;
+  sq_for_every(queue, node)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
+      entry = (FAR struct ipfilter_entry_s *)node;
+      ipfilter_entry_key(entry, family, &key, &mask);
 
-      /* Match device */
+      /* The groups are created in the order of their first rule */
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
+      for (t = 0; t < table->ntuples; t++)
         {
-          continue;
+          if (memcmp(&table->tuples[t].mask, &mask, sizeof(mask)) == 0)
+            {
+              break;
+            }
         }
 
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
+      if (t == table->ntuples)
         {
-          continue;
+          memcpy(&table->tuples[t].mask, &mask, sizeof(mask));
+          table->tuples[t].first = count;
+          table->ntuples++;
         }
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
+      entry->index = count++;
+      entry->tuple = t;
+      entry->hlink = NULL;
+
+      /* Append to keep the buckets in rule order */
+
+      slot = &table->buckets[ipfilter_key_hash(&key, &mask, t) &
+                             table->mask];
+      while (*slot != NULL)
         {
-          continue;
+          slot = &(*slot)->hlink;
         }
 
-      /* Match protocol */
+      *slot = entry;
+    }
+
+  return table;
+}
+
+/****************************************************************************
+ * Name: ipfilter_lookup
+ *
+ * Description:
+ *   Find the first entry of a compiled chain matching the packet.  A
+ *   group whose first rule comes after the best match so far cannot
+ *   improve it, so the search stops there.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_entry_s *
+ipfilter_lookup(FAR const struct ipfilter_table_s *table,
+                sa_family_t family, FAR const struct ipfilter_packet_s *pkt)
+{
+  FAR const struct ipfilter_tuple_s *tuple;
+  FAR struct ipfilter_entry_s *best = NULL;
+  FAR struct ipfilter_entry_s *entry;
+  uint32_t t;
+
+  for (t = 0; t < table->ntuples; t++)
+    {
+      tuple = &table->tuples[t];
+      if (best != NULL && tuple->first > best->index)
+        {
+          break;
+        }
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
+      entry = table->buckets[ipfilter_key_hash(&pkt->key, &tuple->mask, t) &
+                             table->mask];
+      for (; entry != NULL; entry = entry->hlink)
         {
-          continue;
+          if (best != NULL && entry->index > best->index)
+            {
+              break;
+            }
+
+          if (entry->tuple == t &&
+              ipfilter_match_entry(entry, family, pkt))
+            {
+              best = entry;
+              break;
+            }
         }
+    }
+
+  return best;
+}
+#endif /* CONFIG_NET_IPFILTER_COMPILE */
+
+/****************************************************************************
+ * Name: ipfilter_match
+ *
+ * Description:
+ *   Match the packet with the filter entries in the specified chain and
+ *   count the hit.
+ *
+ * Returned Value:
+ *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
+ *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
+ *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *
+ ****************************************************************************/
+
+static int ipfilter_match(sa_family_t family, enum ipfilter_chain_e chain,
+                          FAR struct ipfilter_packet_s *pkt)
+{
+  FAR struct ipfilter_chain_s *filters = ipfilter_chain(family, chain);
+  FAR struct ipfilter_entry_s *entry;
+
+  /* Ports in TCP & UDP headers have same offset. */
 
-      /* Return the target action if matched. */
+  if (pkt->key.proto == IP_PROTO_TCP || pkt->key.proto == IP_PROTO_UDP)
+    {
+      FAR const struct udp_hdr_s *udp = pkt->l4hdr;
+      pkt->key.dport = NTOHS(udp->destport);
+    }
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  if (filters->table != NULL)
+    {
+      entry = ipfilter_lookup(filters->table, family, pkt);
+    }
+  else
+#endif
+    {
+      entry = ipfilter_search(&filters->entries, family, pkt);
+    }
+
+  if (entry == NULL)
+    {
+      /* Normally there should be a default rule in chain. */
 
-      return filter->common.target;
+      ninfo("No filter matched, maybe uninitialized.\n");
+      return IPFILTER_TARGET_ACCEPT;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  entry->pcnt++;
+  entry->bcnt += pkt->len;
+
+  /* Return the target action if matched. */
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  return entry->target;
+}
+
+/****************************************************************************
+ * Name: ipv4_filter_match / ipv6_filter_match
+ *
+ * Description:
+ *   Match the input packet with the filter entries in the specified chain.
+ *
+ * Input Parameters:
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   chain     - The chain to match the filter entries
+ *
+ * Returned Value:
+ *   IPFILTER_TARGET_ACCEPT(0)  - The input packet is accepted
+ *   IPFILTER_TARGET_DROP(-1)   - The input packet needs to be dropped
+ *   IPFILTER_TARGET_REJECT(-2) - The input packet is rejected
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int ipv4_filter_match(FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv4_hdr_s *ipv4,
+                             enum ipfilter_chain_e chain)
+{
+  struct ipfilter_packet_s pkt;
+
+  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+
+  if ((indev == NULL && outdev == NULL) || ipv4 == NULL)
+    {
+      return IPFILTER_TARGET_ACCEPT;
+    }
+
+  memset(&pkt, 0, sizeof(pkt));
+  pkt.indev      = indev;
+  pkt.outdev     = outdev;
+  pkt.iphdr      = ipv4;
+  pkt.l4hdr      = IPv4_L4HDR(ipv4);
+  pkt.len        = (ipv4->len[0] << 8) | ipv4->len[1];
+  pkt.key.src[0] = net_ip4addr_conv32(ipv4->srcipaddr);
+  pkt.key.dst[0] = net_ip4addr_conv32(ipv4->destipaddr);
+  pkt.key.proto  = ipv4->proto;
+
+  return ipfilter_match(PF_INET, chain, &pkt);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int ipv6_filter_match(FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv6_hdr_s *ipv6,
+                             enum ipfilter_chain_e chain)
+{
+  struct ipfilter_packet_s pkt;
+  uint8_t proto;
+
+  /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
+
+  if ((indev == NULL && outdev == NULL) || ipv6 == NULL)
+    {
+      return IPFILTER_TARGET_ACCEPT;
+    }
+
+  memset(&pkt, 0, sizeof(pkt));
+  pkt.indev     = indev;
+  pkt.outdev    = outdev;
+  pkt.iphdr     = ipv6;
+  pkt.l4hdr     = IPv6_L4HDR(ipv6, proto);
+  pkt.len       = ((ipv6->len[0] << 8) | ipv6->len[1]) + IPv6_HDRLEN;
+  pkt.key.proto = proto;
+  memcpy(pkt.key.src, ipv6->srcipaddr, sizeof(net_ipv6addr_t));
+  memcpy(pkt.key.dst, ipv6->destipaddr, sizeof(net_ipv6addr_t));
+
+  return ipfilter_match(PF_INET6, chain, &pkt);
 }
 #endif
 
@@ -407,19 +806,19 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain)
 {
-#ifdef CONFIG_NET_IPv4
-  if (family == PF_INET)
-    {
-      sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
-    }
-#endif
+  FAR struct ipfilter_chain_s *filters = ipfilter_chain(family, chain);
 
-#ifdef CONFIG_NET_IPv6
-  if (family == PF_INET6)
+  if (filters != NULL)
     {
-      sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
-    }
+      sq_addlast((FAR sq_entry_t *)entry, &filters->entries);
+
+      /* The chain is matched linearly until it is committed again */
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+      kmm_free(filters->table);
+      filters->table = NULL;
 #endif
+    }
 }
 
 /****************************************************************************
@@ -440,27 +839,90 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 {
-#ifdef CONFIG_NET_IPv4
-  if (family == PF_INET)
+  FAR struct ipfilter_chain_s *filters = ipfilter_chain(family, chain);
+  FAR struct ipfilter_entry_s *entry;
+
+  if (filters == NULL)
     {
-      FAR sq_queue_t *queue = &g_ipv4_filters[chain];
-      while (!sq_empty(queue))
-        {
-          kmm_free(sq_remfirst(queue));
-        }
+      return;
     }
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  kmm_free(filters->table);
+  filters->table = NULL;
 #endif
 
-#ifdef CONFIG_NET_IPv6
-  if (family == PF_INET6)
+  while (!sq_empty(&filters->entries))
     {
-      FAR sq_queue_t *queue = &g_ipv6_filters[chain];
-      while (!sq_empty(queue))
+      entry = (FAR struct ipfilter_entry_s *)
+              sq_remfirst(&filters->entries);
+
+#ifdef CONFIG_NET_IPFILTER_SET
+      ipfilter_set_put(entry->sset);
+      ipfilter_set_put(entry->dset);
+#endif
+      kmm_free(entry);
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Compile the entries of a chain into hash tables once all of them are
+ *   added.  Without it, or if it fails, the chain is matched linearly.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_chain_s *filters = ipfilter_chain(family, chain);
+
+  if (filters == NULL)
+    {
+      return -EAFNOSUPPORT;
+    }
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  kmm_free(filters->table);
+  filters->table = NULL;
+
+  /* Short chains are faster to walk than to hash */
+
+  if (sq_count(&filters->entries) >= CONFIG_NET_IPFILTER_COMPILE_MIN)
+    {
+      filters->table = ipfilter_compile(&filters->entries, family);
+      if (filters->table == NULL)
         {
-          kmm_free(sq_remfirst(queue));
+          return -ENOMEM;
         }
     }
 #endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfilter_cfg_chain
+ *
+ * Description:
+ *   Return the entries of a chain in order, e.g. to read their counters.
+ *
+ ****************************************************************************/
+
+FAR const sq_queue_t *ipfilter_cfg_chain(sa_family_t family,
+                                         enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_chain_s *filters = ipfilter_chain(family, chain);
+
+  return filters != NULL ? &filters->entries : NULL;
 }
 
 /****************************************************************************
@@ -29,10 +29,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/compiler.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_NET_IPFILTER
 
@@ -44,6 +46,18 @@
 #define IPFILTER_TARGET_DROP   (-1)
 #define IPFILTER_TARGET_REJECT (-2)
 
+/* Addresses are handled as 32-bit words in network byte order by the
+ * compiled tables and the address sets.
+ */
+
+#ifdef CONFIG_NET_IPv6
+#  define IPFILTER_ADDRWORDS   4
+#else
+#  define IPFILTER_ADDRWORDS   1
+#endif
+
+#define IPFILTER_SET_MAXNAMELEN 32
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -56,11 +70,22 @@ enum ipfilter_chain_e
   IPFILTER_CHAIN_MAX
 };
 
+struct ipfilter_set_s;
+
 /* The filter configuration entry */
 
 struct ipfilter_entry_s
 {
   FAR struct ipfilter_entry_s *flink;
+  FAR struct ipfilter_entry_s *hlink; /* Next rule in the hash bucket */
+
+  uint32_t index;         /* Position in the chain */
+  uint16_t tuple;         /* Mask group in the compiled chain */
+
+  /* Hit counters */
+
+  uint64_t pcnt;
+  uint64_t bcnt;
 
   FAR struct net_driver_s *indev;
   FAR struct net_driver_s *outdev;
@@ -79,6 +104,11 @@ struct ipfilter_entry_s
     } icmp;
   } match;
 
+#ifdef CONFIG_NET_IPFILTER_SET
+  FAR struct ipfilter_set_s *sset; /* Source address set to match */
+  FAR struct ipfilter_set_s *dset; /* Destination address set to match */
+#endif
+
   uint8_t proto;          /* Protocol to match, 0 = ALL (Same as Linux) */
   int8_t  target;
 
@@ -97,6 +127,8 @@ struct ipfilter_entry_s
   uint8_t inv_sport  : 1; /* Inverse source port */
   uint8_t inv_dport  : 1; /* Inverse destination port */
   uint8_t inv_icmp   : 1; /* Inverse ICMP type */
+  uint8_t inv_sset   : 1; /* Inverse source address set */
+  uint8_t inv_dset   : 1; /* Inverse destination address set */
 };
 
 struct ipv4_filter_entry_s
@@ -182,6 +214,120 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Compile the entries of a chain into hash tables once all of them are
+ *   added.  Without it, or if it fails, the chain is matched linearly.
+ *
+ * Input Parameters:
+ *   family - The address family of the chain
+ *   chain  - The chain to compile
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain);
+
+/****************************************************************************
+ * Name: ipfilter_cfg_chain
+ *
+ * Description:
+ *   Return the entries of a chain in order, e.g. to read their counters.
+ *
+ ****************************************************************************/
+
+FAR const sq_queue_t *ipfilter_cfg_chain(sa_family_t family,
+                                         enum ipfilter_chain_e chain);
+
+/****************************************************************************
+ * Name: ipfilter_set_create
+ *
+ * Description:
+ *   Create an empty set of addresses of the given family.
+ *
+ * Returned Value:
+ *   The index of the new set on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_SET
+int ipfilter_set_create(FAR const char *name, sa_family_t family);
+
+/****************************************************************************
+ * Name: ipfilter_set_find
+ *
+ * Description:
+ *   Return the index of a set by name, or -ENOENT.
+ *
+ ****************************************************************************/
+
+int ipfilter_set_find(FAR const char *name);
+
+/****************************************************************************
+ * Name: ipfilter_set_destroy / ipfilter_set_flush
+ *
+ * Description:
+ *   Remove a set that is not referenced by any entry, or all of its
+ *   addresses.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ipfilter_set_destroy(int index);
+int ipfilter_set_flush(int index);
+
+/****************************************************************************
+ * Name: ipfilter_set_add / ipfilter_set_del / ipfilter_set_test
+ *
+ * Description:
+ *   Add, remove or look for an address.  addr is an in_addr_t or a
+ *   net_ipv6addr_t in network byte order, as for the family of the set.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  Test returns
+ *   -ENOENT if the address is not in the set.
+ *
+ ****************************************************************************/
+
+int ipfilter_set_add(int index, FAR const void *addr);
+int ipfilter_set_del(int index, FAR const void *addr);
+int ipfilter_set_test(int index, FAR const void *addr);
+
+/****************************************************************************
+ * Name: ipfilter_set_get / ipfilter_set_put
+ *
+ * Description:
+ *   Take and drop a reference of a set for an entry.  A referenced set
+ *   cannot be destroyed.  ipfilter_set_get() returns NULL if there is no
+ *   set of the family at index.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_set_s *ipfilter_set_get(int index, sa_family_t family);
+void ipfilter_set_put(FAR struct ipfilter_set_s *set);
+
+/****************************************************************************
+ * Name: ipfilter_set_match
+ *
+ * Description:
+ *   Whether the address is in the set, addr holds the address words as in
+ *   ipfilter_set_add().
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool ipfilter_set_match(FAR const struct ipfilter_set_s *set,
+                        FAR const uint32_t *addr);
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
@@ -0,0 +1,493 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_set.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER_SET
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The buckets double when there are more addresses than this per bucket */
+
+#define SET_LOAD_FACTOR   2
+#define SET_MIN_BUCKETS   8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ipfilter_setelem_s
+{
+  FAR struct ipfilter_setelem_s *flink;
+  uint32_t addr[IPFILTER_ADDRWORDS];
+};
+
+struct ipfilter_set_s
+{
+  char        name[IPFILTER_SET_MAXNAMELEN];
+  sa_family_t family;
+  uint8_t     nwords;     /* Words per address, 1 or 4 */
+  uint16_t    refs;       /* Entries referencing the set */
+  uint32_t    count;      /* Addresses in the set */
+  uint32_t    nbuckets;   /* Power of two */
+  FAR struct ipfilter_setelem_s **buckets;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct ipfilter_set_s *
+g_ipfilter_sets[CONFIG_NET_IPFILTER_SET_MAX];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t ipfilter_set_hash(FAR const struct ipfilter_set_s *set,
+                                  FAR const uint32_t *addr)
+{
+  uint32_t hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < set->nwords; i++)
+    {
+      hash = (hash ^ addr[i]) * 16777619u;
+    }
+
+  return (hash ^ (hash >> 16)) & (set->nbuckets - 1);
+}
+
+static FAR struct ipfilter_setelem_s **
+ipfilter_set_slot(FAR struct ipfilter_set_s *set, FAR const uint32_t *addr)
+{
+  FAR struct ipfilter_setelem_s **slot;
+
+  slot = &set->buckets[ipfilter_set_hash(set, addr)];
+  while (*slot != NULL &&
+         memcmp((*slot)->addr, addr, set->nwords * sizeof(uint32_t)) != 0)
+    {
+      slot = &(*slot)->flink;
+    }
+
+  return slot;
+}
+
+static int ipfilter_set_resize(FAR struct ipfilter_set_s *set,
+                               uint32_t nbuckets)
+{
+  FAR struct ipfilter_setelem_s **old = set->buckets;
+  FAR struct ipfilter_setelem_s *elem;
+  uint32_t oldsize = set->nbuckets;
+  uint32_t i;
+
+  set->buckets = kmm_zalloc(nbuckets * sizeof(*set->buckets));
+  if (set->buckets == NULL)
+    {
+      set->buckets = old;
+      return -ENOMEM;
+    }
+
+  set->nbuckets = nbuckets;
+  for (i = 0; i < oldsize; i++)
+    {
+      while ((elem = old[i]) != NULL)
+        {
+          FAR struct ipfilter_setelem_s **slot;
+
+          old[i] = elem->flink;
+          slot   = &set->buckets[ipfilter_set_hash(set, elem->addr)];
+
+          elem->flink = *slot;
+          *slot       = elem;
+        }
+    }
+
+  kmm_free(old);
+  return OK;
+}
+
+static FAR struct ipfilter_set_s *ipfilter_set_byindex(int index)
+{
+  if (index < 0 || index >= CONFIG_NET_IPFILTER_SET_MAX)
+    {
+      return NULL;
+    }
+
+  return g_ipfilter_sets[index];
+}
+
+static void ipfilter_set_clear(FAR struct ipfilter_set_s *set)
+{
+  FAR struct ipfilter_setelem_s *elem;
+  uint32_t i;
+
+  for (i = 0; i < set->nbuckets; i++)
+    {
+      while ((elem = set->buckets[i]) != NULL)
+        {
+          set->buckets[i] = elem->flink;
+          kmm_free(elem);
+        }
+    }
+
+  set->count = 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_set_create
+ ****************************************************************************/
+
+int ipfilter_set_create(FAR const char *name, sa_family_t family)
+{
+  FAR struct ipfilter_set_s *set;
+  int index = -ENOSPC;
+  int nwords;
+  int i;
+
+  switch (family)
+    {
+#ifdef CONFIG_NET_IPv4
+      case PF_INET:
+        nwords = 1;
+        break;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      case PF_INET6:
+        nwords = 4;
+        break;
+#endif
+
+      default:
+        return -EAFNOSUPPORT;
+    }
+
+  if (name[0] == '\0' || strlen(name) >= IPFILTER_SET_MAXNAMELEN)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  if (ipfilter_set_find(name) >= 0)
+    {
+      index = -EEXIST;
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_NET_IPFILTER_SET_MAX; i++)
+    {
+      if (g_ipfilter_sets[i] == NULL)
+        {
+          index = i;
+          break;
+        }
+    }
+
+  if (index < 0)
+    {
+      goto out;
+    }
+
+  set = kmm_zalloc(sizeof(*set));
+  if (set == NULL)
+    {
+      index = -ENOMEM;
+      goto out;
+    }
+
+  set->family = family;
+  set->nwords = nwords;
+  strlcpy(set->name, name, sizeof(set->name));
+
+  if (ipfilter_set_resize(set, SET_MIN_BUCKETS) < 0)
+    {
+      kmm_free(set);
+      index = -ENOMEM;
+      goto out;
+    }
+
+  g_ipfilter_sets[index] = set;
+
+out:
+  net_unlock();
+  return index;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_find
+ ****************************************************************************/
+
+int ipfilter_set_find(FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFILTER_SET_MAX; i++)
+    {
+      if (g_ipfilter_sets[i] != NULL &&
+          strcmp(g_ipfilter_sets[i]->name, name) == 0)
+        {
+          return i;
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_destroy
+ ****************************************************************************/
+
+int ipfilter_set_destroy(int index)
+{
+  FAR struct ipfilter_set_s *set;
+  int ret = OK;
+
+  net_lock();
+  set = ipfilter_set_byindex(index);
+  if (set == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else if (set->refs > 0)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      g_ipfilter_sets[index] = NULL;
+      ipfilter_set_clear(set);
+      kmm_free(set->buckets);
+      kmm_free(set);
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_flush
+ ****************************************************************************/
+
+int ipfilter_set_flush(int index)
+{
+  FAR struct ipfilter_set_s *set;
+  int ret = OK;
+
+  net_lock();
+  set = ipfilter_set_byindex(index);
+  if (set == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      ipfilter_set_clear(set);
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_add
+ ****************************************************************************/
+
+int ipfilter_set_add(int index, FAR const void *addr)
+{
+  FAR struct ipfilter_setelem_s **slot;
+  FAR struct ipfilter_setelem_s *elem;
+  FAR struct ipfilter_set_s *set;
+  uint32_t words[IPFILTER_ADDRWORDS];
+  int ret = OK;
+
+  net_lock();
+  set = ipfilter_set_byindex(index);
+  if (set == NULL)
+    {
+      ret = -ENOENT;
+      goto out;
+    }
+
+  memcpy(words, addr, set->nwords * sizeof(uint32_t));
+  slot = ipfilter_set_slot(set, words);
+  if (*slot != NULL)
+    {
+      ret = -EEXIST;
+      goto out;
+    }
+
+  elem = kmm_malloc(sizeof(*elem));
+  if (elem == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  memcpy(elem->addr, words, set->nwords * sizeof(uint32_t));
+  elem->flink = NULL;
+  *slot       = elem;
+
+  /* A failed resize only makes the chains longer */
+
+  if (++set->count > set->nbuckets * SET_LOAD_FACTOR)
+    {
+      ipfilter_set_resize(set, set->nbuckets * 2);
+    }
+
+out:
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_del
+ ****************************************************************************/
+
+int ipfilter_set_del(int index, FAR const void *addr)
+{
+  FAR struct ipfilter_setelem_s **slot;
+  FAR struct ipfilter_setelem_s *elem;
+  FAR struct ipfilter_set_s *set;
+  uint32_t words[IPFILTER_ADDRWORDS];
+  int ret = -ENOENT;
+
+  net_lock();
+  set = ipfilter_set_byindex(index);
+  if (set != NULL)
+    {
+      memcpy(words, addr, set->nwords * sizeof(uint32_t));
+      slot = ipfilter_set_slot(set, words);
+      elem = *slot;
+      if (elem != NULL)
+        {
+          *slot = elem->flink;
+          set->count--;
+          kmm_free(elem);
+          ret = OK;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_test
+ ****************************************************************************/
+
+int ipfilter_set_test(int index, FAR const void *addr)
+{
+  FAR struct ipfilter_set_s *set;
+  uint32_t words[IPFILTER_ADDRWORDS];
+  int ret = -ENOENT;
+
+  net_lock();
+  set = ipfilter_set_byindex(index);
+  if (set != NULL)
+    {
+      memcpy(words, addr, set->nwords * sizeof(uint32_t));
+      if (ipfilter_set_match(set, words))
+        {
+          ret = OK;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_get
+ ****************************************************************************/
+
+FAR struct ipfilter_set_s *ipfilter_set_get(int index, sa_family_t family)
+{
+  FAR struct ipfilter_set_s *set;
+
+  net_lock();
+  set = ipfilter_set_byindex(index);
+  if (set != NULL && set->family == family)
+    {
+      set->refs++;
+    }
+  else
+    {
+      set = NULL;
+    }
+
+  net_unlock();
+  return set;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_put
+ ****************************************************************************/
+
+void ipfilter_set_put(FAR struct ipfilter_set_s *set)
+{
+  if (set != NULL)
+    {
+      net_lock();
+      set->refs--;
+      net_unlock();
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_match
+ ****************************************************************************/
+
+bool ipfilter_set_match(FAR const struct ipfilter_set_s *set,
+                        FAR const uint32_t *addr)
+{
+  FAR const struct ipfilter_setelem_s *elem;
+
+  elem = set->buckets[ipfilter_set_hash(set, addr)];
+  while (elem != NULL &&
+         memcmp(elem->addr, addr, set->nwords * sizeof(uint32_t)) != 0)
+    {
+      elem = elem->flink;
+    }
+
+  return elem != NULL;
+}
+
+#endif /* CONFIG_NET_IPFILTER_SET */
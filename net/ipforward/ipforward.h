@@ -355,5 +355,64 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_fwdflow_lookup
+ *
+ * Description:
+ *   Look up the forwarding device of the flow of an IPv4 packet in the
+ *   flow cache.
+ *
+ * Input Parameters:
+ *   ipv4  - A pointer to the IPv4 header in within the IPv4 packet to be
+ *           forwarded.
+ *
+ * Returned Value:
+ *   The forwarding device, NULL if the flow is not cached.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct net_driver_s *ipv4_fwdflow_lookup(FAR struct ipv4_hdr_s *ipv4);
+
+/****************************************************************************
+ * Name: ipv4_fwdflow_add
+ *
+ * Description:
+ *   Remember the forwarding device of the flow of an IPv4 packet, evicting
+ *   any flow that shares its cache entry.
+ *
+ * Input Parameters:
+ *   ipv4   - A pointer to the IPv4 header in within the IPv4 packet to be
+ *            forwarded.
+ *   fwddev - The device on which the packet is forwarded.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_fwdflow_add(FAR struct ipv4_hdr_s *ipv4,
+                      FAR struct net_driver_s *fwddev);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Invalidate every entry of the forwarding flow cache.  Called whenever
+ *   the routing decision of a flow may have changed: a route is added or
+ *   deleted, or a network device changes its state or its addresses.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipfwd_flow_flush(void);
+#else
+#  define ipfwd_flow_flush()
+#endif
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -0,0 +1,197 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flow.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FWDFLOW_NENTRIES  CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE
+#define FWDFLOW_MASK      (FWDFLOW_NENTRIES - 1)
+
+#if (FWDFLOW_NENTRIES & FWDFLOW_MASK) != 0
+#  error CONFIG_NET_IPFORWARD_FLOWCACHE_SIZE must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached IPv4 flow.  An entry is valid only while its generation
+ * matches g_fwdflow_gen, so that the whole cache is invalidated at once.
+ */
+
+struct ipv4_fwdflow_s
+{
+  in_addr_t srcipaddr;               /* Source address */
+  in_addr_t destipaddr;              /* Destination address */
+  uint16_t  srcport;                 /* TCP/UDP source port, or zero */
+  uint16_t  destport;                /* TCP/UDP destination port, or zero */
+  uint8_t   proto;                   /* L4 protocol */
+  uint32_t  gen;                     /* Generation of the entry */
+  FAR struct net_driver_s *dev;      /* Forwarding device */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipv4_fwdflow_s g_ipv4_fwdflow[FWDFLOW_NENTRIES];
+
+/* Generation zero is never current, so that the zeroed entries start out
+ * invalid.
+ */
+
+static uint32_t g_fwdflow_gen = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_fwdflow_key
+ *
+ * Description:
+ *   Extract the flow key of an IPv4 packet and return the cache entry it
+ *   maps to.  The ports are only part of the key for unfragmented TCP and
+ *   UDP packets, fragments carry no L4 header after the first one.
+ *
+ ****************************************************************************/
+
+static FAR struct ipv4_fwdflow_s *
+ipv4_fwdflow_key(FAR struct ipv4_hdr_s *ipv4,
+                 FAR struct ipv4_fwdflow_s *key)
+{
+  FAR uint16_t *ports;
+  uint32_t hash;
+
+  key->srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->proto      = ipv4->proto;
+  key->srcport    = 0;
+  key->destport   = 0;
+
+  if ((ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP) &&
+      ((ipv4->ipoffset[0] & ~(IP_FLAG_DONTFRAG >> 8)) |
+       ipv4->ipoffset[1]) == 0)
+    {
+      ports = (FAR uint16_t *)((FAR uint8_t *)ipv4 +
+                               ((ipv4->vhl & IPv4_HLMASK) << 2));
+      key->srcport  = ports[0];
+      key->destport = ports[1];
+    }
+
+  hash = NTOHL(key->srcipaddr) ^ NTOHL(key->destipaddr) * 31 ^
+         ((uint32_t)key->srcport << 16 | key->destport) ^ key->proto;
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+
+  return &g_ipv4_fwdflow[hash & FWDFLOW_MASK];
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_fwdflow_lookup
+ *
+ * Description:
+ *   Look up the forwarding device of the flow of an IPv4 packet in the
+ *   flow cache.
+ *
+ ****************************************************************************/
+
+FAR struct net_driver_s *ipv4_fwdflow_lookup(FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_fwdflow_s *flow;
+  struct ipv4_fwdflow_s key;
+
+  flow = ipv4_fwdflow_key(ipv4, &key);
+  if (flow->gen == g_fwdflow_gen &&
+      flow->srcipaddr == key.srcipaddr &&
+      flow->destipaddr == key.destipaddr &&
+      flow->srcport == key.srcport &&
+      flow->destport == key.destport &&
+      flow->proto == key.proto)
+    {
+      return flow->dev;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipv4_fwdflow_add
+ *
+ * Description:
+ *   Remember the forwarding device of the flow of an IPv4 packet.
+ *
+ ****************************************************************************/
+
+void ipv4_fwdflow_add(FAR struct ipv4_hdr_s *ipv4,
+                      FAR struct net_driver_s *fwddev)
+{
+  FAR struct ipv4_fwdflow_s *flow;
+  struct ipv4_fwdflow_s key;
+
+  flow      = ipv4_fwdflow_key(ipv4, &key);
+  *flow     = key;
+  flow->gen = g_fwdflow_gen;
+  flow->dev = fwddev;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Invalidate every entry of the forwarding flow cache.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_flush(void)
+{
+  if (++g_fwdflow_gen == 0)
+    {
+      /* Old entries would become valid again after the wrap around */
+
+      memset(g_ipv4_fwdflow, 0, sizeof(g_ipv4_fwdflow));
+      g_fwdflow_gen = 1;
+    }
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE */
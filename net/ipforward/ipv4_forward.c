@@ -486,12 +486,24 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Established flows reuse the forwarding device of their first packet */
+
+  fwddev     = ipv4_fwdflow_lookup(ipv4);
   if (fwddev == NULL)
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      ret = -ENETUNREACH;
-      goto drop;
+      fwddev = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          ret = -ENETUNREACH;
+          goto drop;
+        }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      ipv4_fwdflow_add(ipv4, fwddev);
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
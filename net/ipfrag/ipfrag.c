@@ -96,6 +96,17 @@ do  \
 
 #define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
 
+/* The bytes accounted to a fragment: its data and its bookkeeping */
+
+#define FRAGLINK_BYTES(link)           ((link)->frag->io_pktlen + \
+                                        sizeof(struct ip_fraglink_s))
+
+#if (CONFIG_NET_IPFRAG_NBUCKETS & (CONFIG_NET_IPFRAG_NBUCKETS - 1)) != 0
+#  error CONFIG_NET_IPFRAG_NBUCKETS must be a power of two
+#endif
+
+#define REASSEMBLY_BUCKETMASK          (CONFIG_NET_IPFRAG_NBUCKETS - 1)
+
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
 #define LOOPBACK_IPFRAME_NOFRAGMENT    0
@@ -115,29 +126,36 @@ static struct wdog_s g_wdfragtimeout;
 
 static struct work_s g_wkfragtimeout;
 
-/* Remember the number of I/O buffers currently in reassembly cache */
+/* Remember the number of I/O buffers and bytes currently in reassembly
+ * cache
+ */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
+static uint32_t      g_byteoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Hash buckets, each links the fragment nodes of all NICs whose datagram
+ * key hashes to it.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblybucket[CONFIG_NET_IPFRAG_NBUCKETS];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
  */
 
-static sq_queue_t    g_assemblyhead_time;
+static dq_queue_t    g_assemblyhead_time;
+
+/* Queue header definition, which connects all fragments of all NICs from the
+ * least to the most recently updated.
+ */
+
+static dq_queue_t    g_assemblyhead_lru;
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
- */
+/* Only one thread can access the reassembly buckets and queues at a time */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
 
@@ -147,9 +165,10 @@ mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
 
 static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
+static FAR sq_queue_t *ip_fragin_bucket(FAR const struct ip_fragkey_s *key);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
@@ -193,8 +212,8 @@ static void ip_fragin_timerwork(FAR void *arg)
 {
   clock_t curtick = clock_systime_ticks();
   sclock_t interval = 0;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
   ninfo("Start reassembly work queue\n");
@@ -205,10 +224,10 @@ static void ip_fragin_timerwork(FAR void *arg)
    * interval
    */
 
-  entry = sq_peek(&g_assemblyhead_time);
+  entry = dq_peek(&g_assemblyhead_time);
   while (entry != NULL)
     {
-      entrynext = sq_next(entry);
+      entrynext = dq_next(entry);
 
       node = (FAR struct ip_fragsnode_s *)
              container_of(entry, FAR struct ip_fragsnode_s, flinkat);
@@ -238,7 +257,7 @@ static void ip_fragin_timerwork(FAR void *arg)
               node->frags->frag = NULL;
 
 #ifdef CONFIG_NET_IPv4
-              if (node->frags->isipv4)
+              if (node->key.isipv4)
                 {
                   icmp_reply(dev, ICMP_TIME_EXCEEDED,
                             ICMP_EXC_FRAGTIME);
@@ -246,7 +265,7 @@ static void ip_fragin_timerwork(FAR void *arg)
 #endif
 
 #ifdef CONFIG_NET_IPv6
-              if (!node->frags->isipv4)
+              if (!node->key.isipv4)
                 {
                   icmpv6_reply(dev, ICMPv6_PACKET_TIME_EXCEEDED,
                               ICMPV6_EXC_FRAGTIME, 0);
@@ -262,7 +281,7 @@ static void ip_fragin_timerwork(FAR void *arg)
                    */
 
                   ninfo("Send Time Exceeded ICMP%s Message to source "
-                        "host\n", node->frags->isipv4 ? "v4" : "v6");
+                        "host\n", node->key.isipv4 ? "v4" : "v6");
                   netdev_txnotify_dev(dev, IPFRAG_POLL);
                 }
 
@@ -270,22 +289,13 @@ static void ip_fragin_timerwork(FAR void *arg)
             }
 #endif
 
-          /* Remove fragments of this node */
+          /* Remove fragments of this node and free node memory */
 
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
+          ip_fragin_freenode(node);
 
-              while (fraglink)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          /* Remove node from single-list and free node memory */
-
-          ip_frag_remnode(node);
-          kmm_free(node);
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipfrag.timeout++;
+#endif
         }
       else
         {
@@ -305,7 +315,7 @@ static void ip_fragin_timerwork(FAR void *arg)
 
   /* Be sure to start the timer, if there are nodes in the linked list */
 
-  if (sq_peek(&g_assemblyhead_time) != NULL)
+  if (dq_peek(&g_assemblyhead_time) != NULL)
     {
       clock_t delay = REASSEMBLY_TIMEOUT_MINIMALTICKS;
 
@@ -331,6 +341,37 @@ static void ip_fragin_timerwork(FAR void *arg)
   nxmutex_unlock(&g_ipfrag_lock);
 }
 
+/****************************************************************************
+ * Name: ip_fragin_bucket
+ *
+ * Description:
+ *   Return the hash bucket of a datagram key.
+ *
+ * Input Parameters:
+ *   key - The datagram key
+ *
+ * Returned Value:
+ *   The bucket the fragment nodes with this key are linked to
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *ip_fragin_bucket(FAR const struct ip_fragkey_s *key)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)key;
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  /* FNV-1a over the whole key, which is zero padded */
+
+  for (i = 0; i < sizeof(struct ip_fragkey_s); i++)
+    {
+      hash ^= ptr[i];
+      hash *= 16777619u;
+    }
+
+  return &g_assemblybucket[hash & REASSEMBLY_BUCKETMASK];
+}
+
 /****************************************************************************
  * Name: ip_fragin_freelink
  *
@@ -363,56 +404,41 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 }
 
 /****************************************************************************
- * Name: ip_fragin_check
+ * Name: ip_fragin_freenode
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
+ *   Remove a node from the reassembly cache and free it along with all of
+ *   its fragments.
  *
  * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
+ *   node - node of the upper-level linked list, it maintains information
+ *          about all fragments belonging to an IP datagram
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node)
 {
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
+  FAR struct ip_fraglink_s *fraglink = node->frags;
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
+  while (fraglink != NULL)
     {
-      entry = fragsnode->frags;
-      while (entry != NULL)
-        {
-          if (entry->morefrags)
-            {
-              formerlen += entry->fraglen;
-            }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
-
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
-
-          entry = entry->flink;
-        }
+      fraglink = ip_fragin_freelink(fraglink);
     }
+
+  ip_frag_remnode(node);
+  kmm_free(node);
 }
 
 /****************************************************************************
  * Name: ip_fragin_cachemonitor
  *
  * Description:
- *   Check the reassembly cache buffer size, if it exceeds the configured
- *   threshold, some I/O buffers need to be freed
+ *   Check the reassembly cache size, if it exceeds the configured
+ *   thresholds, evict the least recently updated datagrams until it fits
+ *   again.
  *
  * Input Parameters:
  *   curnode - node of the upper-level linked list, it maintains information
@@ -425,52 +451,31 @@ static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
 
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode)
 {
-  uint32_t        cleancnt = 0;
-  uint32_t        bufcnt;
-  FAR sq_entry_t *entry;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *entrynext;
   FAR struct ip_fragsnode_s *node;
 
-  /* Start cache cleaning if g_bufoccupy exceeds the cache threshold */
-
-  if (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB)
+  entry = dq_peek(&g_assemblyhead_lru);
+  while (entry != NULL && (g_bufoccupy > REASSEMBLY_MAXOCCUPYIOB ||
+                           g_byteoccupy > CONFIG_NET_IPFRAG_MAXBYTES))
     {
-      cleancnt = g_bufoccupy - REASSEMBLY_MAXOCCUPYIOB;
-      entry = sq_peek(&g_assemblyhead_time);
-
-      while (entry != NULL && cleancnt > 0)
-        {
-          entrynext = sq_next(entry);
-
-          node = (FAR struct ip_fragsnode_s *)
-                 container_of(entry, FAR struct ip_fragsnode_s, flinkat);
-
-          /* Skip specified node */
-
-          if (node != curnode)
-            {
-              /* Remove fragments of this node */
+      entrynext = dq_next(entry);
 
-              if (node->frags != NULL)
-                {
-                  FAR struct ip_fraglink_s *fraglink = node->frags;
-
-                  while (fraglink != NULL)
-                    {
-                      fraglink = ip_fragin_freelink(fraglink);
-                    }
-                }
-
-              /* Remove node from single-list and free node memory */
+      node = (FAR struct ip_fragsnode_s *)
+             container_of(entry, FAR struct ip_fragsnode_s, flinklru);
 
-              bufcnt = ip_frag_remnode(node);
-              kmm_free(node);
+      /* Skip specified node */
 
-              cleancnt = cleancnt > bufcnt ? cleancnt - bufcnt : 0;
-            }
+      if (node != curnode)
+        {
+          ip_fragin_freenode(node);
 
-          entry = entrynext;
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipfrag.evict++;
+#endif
         }
+
+      entry = entrynext;
     }
 }
 
@@ -527,11 +532,13 @@ ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq)
 
 uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
 {
-  g_bufoccupy -= node->bufcnt;
+  g_bufoccupy  -= node->bufcnt;
+  g_byteoccupy -= node->bytecnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-  sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+  sq_rem((FAR sq_entry_t *)node, ip_fragin_bucket(&node->key));
+  dq_rem(&node->flinkat, &g_assemblyhead_time);
+  dq_rem(&node->flinklru, &g_assemblyhead_lru);
 
   return node->bufcnt;
 }
@@ -542,8 +549,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are
+ *   hashed by the datagram key into the reassembly buckets.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -551,83 +558,72 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   OK if the fragment was taken over; curfraglink->fragsnode is then the
+ *   node of its datagram.  Otherwise a negated errno, and the fragment is
+ *   left to the caller:
+ *
+ *   ENOMEM - No memory
+ *   EINVAL - The fragment overlaps another fragment of the datagram
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink)
 {
   FAR struct ip_fragsnode_s *node;
-  FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
-  bool                       empty;
+  FAR struct ip_fraglink_s  *fraglink = NULL;
+  FAR struct ip_fraglink_s  *lastlink = NULL;
+  FAR sq_queue_t            *bucket;
+  uint32_t                   fragend;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  fragend = curfraglink->fragoff + curfraglink->fraglen;
+
+  /* Look for the node of this datagram in its hash bucket, otherwise need
+   * to create a new node and add it to the bucket.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  bucket = ip_fragin_bucket(&curfraglink->key);
+  node   = (FAR struct ip_fragsnode_s *)sq_peek(bucket);
 
-  while (entry != NULL)
+  while (node != NULL)
     {
-      node = (struct ip_fragsnode_s *)entry;
-
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (dev == node->dev &&
+          memcmp(&node->key, &curfraglink->key,
+                 sizeof(struct ip_fragkey_s)) == 0)
         {
           break;
         }
 
-      entrylast = entry;
-      entry = sq_next(entry);
+      node = node->flink;
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
-
       /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
+       * ip_fraglink_s to the subchain of this node, which is ordered by
+       * fragment offset value.  Fragments mostly arrive in order, so try
+       * after the last one first.
        */
 
-      fraglink = node->frags;
-
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
-       */
-
-      while (fraglink != NULL)
+      if (curfraglink->fragoff > node->fragtail->fragoff)
         {
-          /* The fragment list is ordered by fragment offset value */
-
-          if (curfraglink->fragoff <= fraglink->fragoff)
+          lastlink = node->fragtail;
+        }
+      else
+        {
+          fraglink = node->frags;
+          while (fraglink != NULL &&
+                 fraglink->fragoff < curfraglink->fragoff)
             {
-              break;
+              lastlink = fraglink;
+              fraglink = fraglink->flink;
             }
-
-          lastlink = fraglink;
-          fraglink = fraglink->flink;
         }
 
-      if (fraglink == NULL)
-        {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
-
-          lastlink->flink      = curfraglink;
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
+      if (fraglink != NULL &&
+          fraglink->fragoff == curfraglink->fragoff &&
+          fraglink->fraglen == curfraglink->fraglen &&
+          fraglink->morefrags == curfraglink->morefrags)
         {
           /* Fragments with same offset value contain the same data, use the
            * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
@@ -644,9 +640,37 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
               lastlink->flink = curfraglink;
             }
 
+          if (node->fragtail == fraglink)
+            {
+              node->fragtail = curfraglink;
+            }
+
+          node->bufcnt  -= IOBUF_CNT(fraglink->frag);
+          node->bytecnt -= FRAGLINK_BYTES(fraglink);
+          g_bufoccupy   -= IOBUF_CNT(fraglink->frag);
+          g_byteoccupy  -= FRAGLINK_BYTES(fraglink);
+
           iob_free_chain(fraglink->frag);
           kmm_free(fraglink);
         }
+      else if ((lastlink != NULL &&
+                lastlink->fragoff + lastlink->fraglen >
+                curfraglink->fragoff) ||
+               (fraglink != NULL &&
+                (fragend > fraglink->fragoff || !curfraglink->morefrags)) ||
+               ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+                fragend > node->totallen))
+        {
+          /* Any other fragment overlapping the received ones, or going past
+           * the end of the datagram, is dropped.  IPv6 requires it
+           * (RFC5722) and the reassembly relies on it.
+           */
+
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipfrag.overlap++;
+#endif
+          return -EINVAL;
+        }
       else
         {
           /* Insert into the fragment list */
@@ -666,77 +690,82 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
               lastlink->flink = curfraglink;
             }
 
-          /* Remember I/O buffer count */
+          if (curfraglink->flink == NULL)
+            {
+              node->fragtail = curfraglink;
+            }
 
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+          node->recvdlen += curfraglink->fraglen;
         }
+
+      /* This node is now the most recently updated one */
+
+      dq_rem(&node->flinklru, &g_assemblyhead_lru);
+      dq_addlast(&node->flinklru, &g_assemblyhead_lru);
     }
   else
     {
-      /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
-       */
+      /* It's a new datagram, malloc a new node and add it to the bucket */
 
-      node = kmm_malloc(sizeof(struct ip_fragsnode_s));
+      node = kmm_zalloc(sizeof(struct ip_fragsnode_s));
       if (node == NULL)
         {
           nerr("ERROR: Failed to allocate buffer.\n");
           return -ENOMEM;
         }
 
-      node->flink      = NULL;
-      node->flinkat    = NULL;
-      node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
-      node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
-      node->verifyflag = 0;
-      node->outgoframe = NULL;
-
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      node->dev      = dev;
+      node->key      = curfraglink->key;
+      node->frags    = curfraglink;
+      node->fragtail = curfraglink;
+      node->tick     = clock_systime_ticks();
+      node->recvdlen = curfraglink->fraglen;
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, bucket);
 
-      /* Add this new node to the tail of linked list identified by
-       * g_assemblyhead_time
+      /* Add this new node to the tail of the queues identified by
+       * g_assemblyhead_time and g_assemblyhead_lru
        */
 
-      sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
+      dq_addlast(&node->flinkat, &g_assemblyhead_time);
+      dq_addlast(&node->flinklru, &g_assemblyhead_lru);
     }
 
+  /* Remember I/O buffer and byte count */
+
+  node->bufcnt  += IOBUF_CNT(curfraglink->frag);
+  node->bytecnt += FRAGLINK_BYTES(curfraglink);
+  g_bufoccupy   += IOBUF_CNT(curfraglink->frag);
+  g_byteoccupy  += FRAGLINK_BYTES(curfraglink);
+
   if (curfraglink->fragoff == 0)
     {
       /* Have received the zero fragment */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDZEROFRAG;
     }
-  else if (!curfraglink->morefrags)
+
+  if (!curfraglink->morefrags)
     {
-      /* Have received the tail fragment */
+      /* Have received the tail fragment, which gives the datagram length */
 
       node->verifyflag |= IP_FRAGVERIFY_RECVDTAILFRAG;
+      node->totallen    = fragend;
     }
 
-  /* For indexing convenience */
+  /* Check receiving status: with no overlaps, all fragments are here once
+   * they add up to the datagram length
+   */
 
-  curfraglink->fragsnode = node;
+  if ((node->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG) != 0 &&
+      node->recvdlen == node->totallen)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
+    }
 
-  /* Check receiving status */
+  /* For indexing convenience */
 
-  ip_fragin_check(node);
+  curfraglink->fragsnode = node;
 
   /* Buffer is take away, clear original pointers in NIC */
 
@@ -748,7 +777,7 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
 
   ip_fragin_cachemonitor(node);
 
-  return empty;
+  return OK;
 }
 
 /****************************************************************************
@@ -1110,36 +1139,26 @@ int32_t ip_frag_uninit(void)
 
 void ip_frag_stop(FAR struct net_driver_s *dev)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry = NULL;
+  FAR dq_entry_t *entrynext;
 
   ninfo("Stop frag processing for NIC:%p\n", dev);
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = dq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
+      entrynext = dq_next(entry);
 
       if (dev == node->dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_freenode(node);
         }
 
       entry = entrynext;
@@ -1166,45 +1185,20 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
 void ip_frag_remallfrags(void)
 {
-  FAR sq_entry_t *entry = NULL;
-  FAR sq_entry_t *entrynext;
+  FAR dq_entry_t *entry;
   FAR struct net_driver_s *dev;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-
   /* Drop all unassembled incoming fragments */
 
-  while (entry != NULL)
+  while ((entry = dq_peek(&g_assemblyhead_time)) != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
-      entrynext = sq_next(entry);
-
-      if (node->frags != NULL)
-        {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
-
-          while (fraglink != NULL)
-            {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
-
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
-
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
-
-      entry = entrynext;
+      ip_fragin_freenode((FAR struct ip_fragsnode_s *)
+                         container_of(entry, FAR struct ip_fragsnode_s,
+                                      flinkat));
     }
 
-  sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
-
   nxmutex_unlock(&g_ipfrag_lock);
 
   /* Drop all unsent outgoing fragments */
@@ -1251,6 +1245,15 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return OK;
     }
 
+#ifdef CONFIG_NET_GSO
+  /* A GSO packet is segmented by the driver instead */
+
+  if (dev->d_gso_size != 0)
+    {
+      return OK;
+    }
+#endif
+
 #ifdef CONFIG_NET_6LOWPAN
   if (dev->d_lltype == NET_LL_IEEE802154 ||
       dev->d_lltype == NET_LL_PKTRADIO)
@@ -70,6 +70,40 @@ enum ip_fragverify_e
   IP_FRAGVERIFY_RECVDTAILFRAG  = 0x01 << 2,
 };
 
+/* The identity of an IP datagram: the fragments of one datagram share the
+ * same source and destination addresses, protocol and identification.
+ * Compared as a whole with memcmp(), so always zero the key before filling
+ * it.
+ */
+
+struct ip_fragkey_s
+{
+  /* The identification field is 16 bits in IPv4 header but 32 bits in IPv6
+   * fragment header
+   */
+
+  uint32_t                   ipid;
+  uint8_t                    isipv4;    /* IPv4 or IPv6 */
+  uint8_t                    proto;     /* Protocol or next header */
+  union
+  {
+#ifdef CONFIG_NET_IPv4
+    struct
+    {
+      in_addr_t              srcipaddr;
+      in_addr_t              destipaddr;
+    } ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+    struct
+    {
+      net_ipv6addr_t         srcipaddr;
+      net_ipv6addr_t         destipaddr;
+    } ipv6;
+#endif
+  } addr;
+};
+
 struct ip_fraglink_s
 {
   /* This link is used to maintain a single-linked list of ip_fraglink_s,
@@ -80,22 +114,20 @@ struct ip_fraglink_s
 
   FAR struct ip_fragsnode_s *fragsnode; /* Point to parent struct */
   FAR struct iob_s          *frag;      /* Point to fragment data */
-  uint8_t                    isipv4;    /* IPv4 or IPv6 */
   uint16_t                   fragoff;   /* Fragment offset */
   uint16_t                   fraglen;   /* Payload length */
   uint16_t                   morefrags; /* The more frag flag */
 
-  /* The identification field is 16 bits in IPv4 header but 32 bits in IPv6
-   * fragment header
-   */
+  /* The datagram this fragment belongs to */
 
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
 };
 
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
-   * Must be the first field in the structure due to flink type casting.
+  /* This link is used to maintain the single-linked list of the hash
+   * bucket of the node.  Must be the first field in the structure due to
+   * flink type casting.
    */
 
   FAR struct ip_fragsnode_s *flink;
@@ -104,17 +136,21 @@ struct ip_fragsnode_s
    * time
    */
 
-  FAR sq_entry_t            *flinkat;
+  dq_entry_t                 flinkat;
+
+  /* And one which connects them from the least to the most recently
+   * updated, for the eviction when the reassembly cache is full
+   */
+
+  dq_entry_t                 flinklru;
 
   /* Interface understood by the network */
 
   FAR struct net_driver_s   *dev;
 
-  /* IP Identification (IP ID) field defined in ipv4 header or in ipv6
-   * fragment header.
-   */
+  /* The datagram being reassembled */
 
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
 
   /* Count ticks, used by ressembly timer */
 
@@ -128,9 +164,24 @@ struct ip_fragsnode_s
 
   uint32_t                   bufcnt;
 
-  /* Linked all fragments with the same IP ID. */
+  /* Remember the total number of bytes held by this node */
+
+  uint32_t                   bytecnt;
+
+  /* The number of payload bytes received, and the datagram payload length
+   * once the tail fragment is known.  Fragments never overlap, so all of
+   * them are here when the two are equal.
+   */
+
+  uint32_t                   recvdlen;
+  uint32_t                   totallen;
+
+  /* Linked all fragments of the datagram, by ascending offset, and the
+   * last one of them to append in order arrivals directly.
+   */
 
   FAR struct ip_fraglink_s  *frags;
+  FAR struct ip_fraglink_s  *fragtail;
 
   /* Points to the reassembled outgoing IP frame */
 
@@ -149,9 +200,7 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time
- */
+/* Only one thread can access the reassembly buckets and queues at a time */
 
 extern mutex_t g_ipfrag_lock;
 
@@ -182,8 +231,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  * Description:
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
- *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are
+ *   hashed by the datagram key into the reassembly buckets.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -191,12 +240,17 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *                 information of one fragment
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   OK if the fragment was taken over; curfraglink->fragsnode is then the
+ *   node of its datagram.  Otherwise a negated errno, and the fragment is
+ *   left to the caller:
+ *
+ *   ENOMEM - No memory
+ *   EINVAL - The fragment overlaps another fragment of the datagram
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink);
 
 /****************************************************************************
  * Name: ipv4_fragin
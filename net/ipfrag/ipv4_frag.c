@@ -91,16 +91,21 @@ ipv4_fragin_getinfo(FAR struct iob_s *iob,
 
   fraglink->flink     = NULL;
   fraglink->fragsnode = NULL;
-  fraglink->isipv4    = true;
 
   offset = (ipv4->ipoffset[0] << 8) + ipv4->ipoffset[1];
   fraglink->morefrags = offset & IP_FLAG_MOREFRAGS;
   fraglink->fragoff   = ((offset & 0x1fff) << 3);
 
   fraglink->fraglen   = (ipv4->len[0] << 8) + ipv4->len[1] - IPv4_HDRLEN;
-  fraglink->ipid      = (ipv4->ipid[0] << 8) + ipv4->ipid[1];
   fraglink->frag      = iob;
 
+  memset(&fraglink->key, 0, sizeof(struct ip_fragkey_s));
+  fraglink->key.ipid   = (ipv4->ipid[0] << 8) + ipv4->ipid[1];
+  fraglink->key.isipv4 = true;
+  fraglink->key.proto  = ipv4->proto;
+  fraglink->key.addr.ipv4.srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  fraglink->key.addr.ipv4.destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+
   return OK;
 }
 
@@ -261,7 +266,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
-  bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -282,9 +287,13 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  /* Need to restart reassembly worker if the original linked list is empty */
-
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
 
@@ -315,18 +324,18 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
       kmm_free(node);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.reasm++;
+#endif
+
       return ipv4_input(dev);
     }
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
-    {
-      /* Restart the work queue for fragment processing */
-
-      ip_frag_startwdog();
-    }
+  /* Make sure the reassembly timer runs while fragments are pending */
 
+  ip_frag_startwdog();
   return OK;
 }
 
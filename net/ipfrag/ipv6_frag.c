@@ -126,7 +126,7 @@ static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
     {
       FAR struct ipv6_fragment_extension_s *fraghdr;
 
-      fraghdr = (FAR struct ipv6_fragment_extension_s *)exthdr;
+      fraghdr = (FAR struct ipv6_fragment_extension_s *)payload;
 
       /* Cut the size of fragment header, notice fragment header don't has a
        * length filed.
@@ -137,16 +137,22 @@ static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
       fraglink->flink     = NULL;
       fraglink->fragsnode = NULL;
 
-      fraglink->isipv4    = FALSE;
       fraglink->fragoff   = (fraghdr->msoffset << 8) + fraghdr->lsoffset;
       fraglink->morefrags = fraglink->fragoff & 0x1;
       fraglink->fragoff  &= 0xfff8;
       fraglink->fraglen   = paylen;
-      fraglink->ipid      = NTOHL(
+      fraglink->frag      = iob;
+
+      memset(&fraglink->key, 0, sizeof(struct ip_fragkey_s));
+      fraglink->key.ipid   = NTOHL(
         ((uint32_t)(*(FAR uint16_t *)(&fraghdr->id[0])) << 16) +
          (uint32_t)(*(FAR uint16_t *)(&fraghdr->id[2])));
-
-      fraglink->frag      = iob;
+      fraglink->key.isipv4 = false;
+      fraglink->key.proto  = fraghdr->nxthdr;
+      net_ipv6addr_copy(fraglink->key.addr.ipv6.srcipaddr,
+                        ipv6->srcipaddr);
+      net_ipv6addr_copy(fraglink->key.addr.ipv6.destipaddr,
+                        ipv6->destipaddr);
 
       return OK;
     }
@@ -468,7 +474,7 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 {
   FAR struct ip_fragsnode_s *node = NULL;
   FAR struct ip_fraglink_s *fraginfo = NULL;
-  bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -485,13 +491,21 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
   /* Populate fragment information from input packet data */
 
-  ipv6_fragin_getinfo(dev->d_iob, fraginfo);
+  if (ipv6_fragin_getinfo(dev->d_iob, fraginfo) < 0)
+    {
+      kmm_free(fraginfo);
+      return -EINVAL;
+    }
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  /* Need to restart reassembly worker if the original linked list is empty */
-
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      kmm_free(fraginfo);
+      return ret;
+    }
 
   node = fraginfo->fragsnode;
   if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
@@ -521,18 +535,18 @@ int32_t ipv6_fragin(FAR struct net_driver_s *dev)
 
       kmm_free(node);
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipfrag.reasm++;
+#endif
+
       return ipv6_input(dev);
     }
 
   nxmutex_unlock(&g_ipfrag_lock);
 
-  if (restartwdog)
-    {
-      /* Restart the work queue for fragment processing */
-
-      ip_frag_startwdog();
-    }
+  /* Make sure the reassembly timer runs while fragments are pending */
 
+  ip_frag_startwdog();
   return OK;
 }
 
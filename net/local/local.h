@@ -58,6 +58,16 @@ typedef uint16_t lc_size_t;  /* 16-bit index */
 typedef uint8_t lc_size_t;   /*  8-bit index */
 #endif
 
+/* Connected stream sockets move their data through a pair of rings
+ * instead of the FIFOs once local_ring_alloc() succeeded.
+ */
+
+#ifdef CONFIG_NET_LOCAL_RING
+#  define LOCAL_HAS_RING(c) ((c)->lc_rxring != NULL)
+#else
+#  define LOCAL_HAS_RING(c) false
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -109,6 +119,7 @@ enum local_state_s
  */
 
 struct devif_callback_s;       /* Forward reference */
+struct local_ring_s;           /* Forward reference */
 
 struct local_conn_s
 {
@@ -155,6 +166,14 @@ struct local_conn_s
   FAR struct pollfd *lc_event_fds[LOCAL_NPOLLWAITERS];
   struct pollfd lc_inout_fds[2*LOCAL_NPOLLWAITERS];
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* The data rings of a connected peer, shared with lc_peer */
+
+  FAR struct local_ring_s *lc_rxring;
+  FAR struct local_ring_s *lc_txring;
+  mutex_t lc_recvlock;         /* Make receiving multi-thread safe */
+#endif
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -758,6 +777,92 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 
 int32_t local_generate_instance_id(void);
 
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Connect a pair of stream connections with one ring per direction.
+ *   rxsize is the size of the ring from peer to conn, txsize the size of
+ *   the ring from conn to peer.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *conn,
+                     FAR struct local_conn_s *peer,
+                     size_t rxsize, size_t txsize);
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Close and drop the rings of a connection that goes away.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Close the receive (SHUT_RD) and/or send (SHUT_WR) ring of a connection.
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy data into the send ring of a connection.  The caller holds
+ *   lc_sendlock.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *iov, size_t iovcnt,
+                        bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy data out of the receive ring of a connection.  The caller holds
+ *   lc_recvlock.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags, bool nonblock);
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Set up or tear down the poll of the receive ('in') or send ring of a
+ *   connection.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup, bool in);
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   FIONREAD, FIONWRITE and FIONSPACE on the rings of a connection.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg);
+
+#endif /* CONFIG_NET_LOCAL_RING */
+
 /****************************************************************************
  * Name: local_set_pollthreshold
  *
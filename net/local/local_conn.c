@@ -176,6 +176,9 @@ FAR struct local_conn_s *local_alloc(void)
 
       nxmutex_init(&conn->lc_sendlock);
       nxmutex_init(&conn->lc_polllock);
+#ifdef CONFIG_NET_LOCAL_RING
+      nxmutex_init(&conn->lc_recvlock);
+#endif
       nxrmutex_init(&conn->lc_conn.s_lock);
 
 #ifdef CONFIG_NET_LOCAL_SCM
@@ -232,9 +235,15 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   strlcpy(conn->lc_path, server->lc_path, sizeof(conn->lc_path));
   conn->lc_instance_id = client->lc_instance_id;
 
-  /* Create the FIFOs needed for the connection */
+  /* Create the FIFOs needed for the connection.  With the rings, they
+   * only carry the connection state and need no room for the data.
+   */
 
+#ifdef CONFIG_NET_LOCAL_RING
+  ret = local_create_fifos(conn, 1, 1);
+#else
   ret = local_create_fifos(conn, server->lc_rcvsize, client->lc_rcvsize);
+#endif
   if (ret < 0)
     {
       nerr("ERROR: Failed to create FIFOs for %s: %d\n",
@@ -274,6 +283,18 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   /* Do we have a connection?  Are the FIFOs opened? */
 
   DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+
+#ifdef CONFIG_NET_LOCAL_RING
+  ret = local_ring_alloc(conn, client, server->lc_rcvsize,
+                         client->lc_rcvsize);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to allocate rings for %s: %d\n",
+           conn->lc_path, ret);
+      goto errout_with_fifos;
+    }
+#endif
+
   *accept = conn;
   return OK;
 
@@ -315,6 +336,12 @@ void local_free(FAR struct local_conn_s *conn)
       conn->lc_peer = NULL;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  /* Let the peer see the end of the stream */
+
+  local_ring_release(conn);
+#endif
+
   /* Make sure that the read-only FIFO is closed */
 
   if (conn->lc_infile.f_inode != NULL)
@@ -356,6 +383,9 @@ void local_free(FAR struct local_conn_s *conn)
 
   nxmutex_destroy(&conn->lc_sendlock);
   nxmutex_destroy(&conn->lc_polllock);
+#ifdef CONFIG_NET_LOCAL_RING
+  nxmutex_destroy(&conn->lc_recvlock);
+#endif
   nxrmutex_destroy(&conn->lc_conn.s_lock);
 
   /* And free the connection structure */
@@ -118,6 +118,28 @@ static void local_inout_poll_cb(FAR struct pollfd *fds)
 
   poll_notify(&originfds, 1, fds->revents);
 }
+
+/****************************************************************************
+ * Name: local_stream_poll
+ *
+ * Description:
+ *   Set up or tear down the poll of the receive ('in') or send direction of
+ *   a connected peer, on its ring or else on its FIFO.
+ *
+ ****************************************************************************/
+
+static int local_stream_poll(FAR struct local_conn_s *conn,
+                             FAR struct pollfd *fds, bool setup, bool in)
+{
+#ifdef CONFIG_NET_LOCAL_RING
+  if (LOCAL_HAS_RING(conn))
+    {
+      return local_ring_poll(conn, fds, setup, in);
+    }
+#endif
+
+  return file_poll(in ? &conn->lc_infile : &conn->lc_outfile, fds, setup);
+}
 #endif
 
 /****************************************************************************
@@ -222,13 +244,13 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
           /* Setup poll for both shadow pollfds. */
 
-          ret = file_poll(&conn->lc_infile, &shadowfds[0], true);
+          ret = local_stream_poll(conn, &shadowfds[0], true, true);
           if (ret >= 0)
             {
-              ret = file_poll(&conn->lc_outfile, &shadowfds[1], true);
+              ret = local_stream_poll(conn, &shadowfds[1], true, false);
               if (ret < 0)
                 {
-                  file_poll(&conn->lc_infile, &shadowfds[0], false);
+                  local_stream_poll(conn, &shadowfds[0], false, true);
                 }
             }
 
@@ -255,7 +277,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
               goto pollerr;
             }
 
-          ret = file_poll(&conn->lc_infile, fds, true);
+          ret = local_stream_poll(conn, fds, true, true);
         }
         break;
 
@@ -269,7 +291,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
               goto pollerr;
             }
 
-          ret = file_poll(&conn->lc_outfile, fds, true);
+          ret = local_stream_poll(conn, fds, true, false);
         }
         break;
 
@@ -338,8 +360,8 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 
           /* Teardown for both shadow pollfds. */
 
-          ret = file_poll(&conn->lc_infile, &shadowfds[0], false);
-          ret2 = file_poll(&conn->lc_outfile, &shadowfds[1], false);
+          ret = local_stream_poll(conn, &shadowfds[0], false, true);
+          ret2 = local_stream_poll(conn, &shadowfds[1], false, false);
           if (ret2 < 0)
             {
               ret = ret2;
@@ -358,7 +380,7 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
               return OK;
             }
 
-          ret = file_poll(&conn->lc_infile, fds, false);
+          ret = local_stream_poll(conn, fds, false, true);
         }
         break;
 
@@ -369,7 +391,7 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
               return OK;
             }
 
-          ret = file_poll(&conn->lc_outfile, fds, false);
+          ret = local_stream_poll(conn, fds, false, false);
         }
         break;
 
@@ -248,6 +248,31 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return 0;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (LOCAL_HAS_RING(conn))
+    {
+      ssize_t nread;
+
+      ret = nxmutex_lock(&conn->lc_recvlock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nread = local_ring_recv(conn, buf, len, flags,
+                              _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                              (flags & MSG_DONTWAIT) != 0);
+      nxmutex_unlock(&conn->lc_recvlock);
+      if (nread < 0)
+        {
+          return nread;
+        }
+
+      readlen = nread;
+      goto out_with_data;
+    }
+#endif
+
   /* If it is non-blocking mode, the data in fifo is 0 and
    * returns directly
    */
@@ -275,6 +300,10 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
       return ret;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+out_with_data:
+#endif
+
   /* Return the address family */
 
   if (from)
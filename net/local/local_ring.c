@@ -0,0 +1,653 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <poll.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_RING
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One direction of a connected stream: a single producer, single consumer
+ * byte ring shared by the sending and the receiving connection.  The
+ * producer only writes lr_head and the consumer only writes lr_tail, so
+ * the data path takes no lock; the semaphores are only posted when the
+ * other side announced that it is about to wait.
+ */
+
+struct local_ring_s
+{
+  atomic_t           lr_crefs;      /* The sender and the receiver */
+  uint32_t           lr_mask;       /* Size of lr_buffer - 1 */
+  FAR uint8_t       *lr_buffer;
+
+  volatile uint32_t  lr_head;       /* Written by the sender */
+  volatile uint32_t  lr_tail;       /* Written by the receiver */
+  volatile bool      lr_wrclosed;   /* No more data will be sent */
+  volatile bool      lr_rdclosed;   /* No more data will be received */
+
+  atomic_t           lr_rdwait;     /* The receiver waits on lr_rdsem */
+  atomic_t           lr_wrwait;     /* The sender waits on lr_wrsem */
+  sem_t              lr_rdsem;
+  sem_t              lr_wrsem;
+
+  /* The poll waiters, only locked when there are some */
+
+  atomic_t           lr_npolls;
+  mutex_t            lr_polllock;
+  FAR struct pollfd *lr_rdfds[LOCAL_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_create
+ ****************************************************************************/
+
+static FAR struct local_ring_s *local_ring_create(size_t size)
+{
+  FAR struct local_ring_s *ring;
+  uint32_t bufsize = 1;
+
+  /* Round the buffer size up to a power of two */
+
+  while (bufsize < size)
+    {
+      bufsize <<= 1;
+    }
+
+  ring = kmm_zalloc(sizeof(struct local_ring_s) + bufsize);
+  if (ring == NULL)
+    {
+      return NULL;
+    }
+
+  ring->lr_mask   = bufsize - 1;
+  ring->lr_buffer = (FAR uint8_t *)(ring + 1);
+  atomic_set(&ring->lr_crefs, 2);
+
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  nxmutex_init(&ring->lr_polllock);
+  return ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_put
+ ****************************************************************************/
+
+static void local_ring_put(FAR struct local_ring_s *ring)
+{
+  if (atomic_fetch_sub(&ring->lr_crefs, 1) == 1)
+    {
+      nxsem_destroy(&ring->lr_rdsem);
+      nxsem_destroy(&ring->lr_wrsem);
+      nxmutex_destroy(&ring->lr_polllock);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_revents
+ *
+ * Description:
+ *   The poll events of one end of the ring, with pipe semantics.
+ *
+ ****************************************************************************/
+
+static pollevent_t local_ring_revents(FAR struct local_ring_s *ring,
+                                      bool reader)
+{
+  uint32_t used = ring->lr_head - ring->lr_tail;
+  pollevent_t eventset = 0;
+
+  if (reader)
+    {
+      if (used > 0)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (ring->lr_wrclosed)
+        {
+          eventset |= POLLHUP;
+        }
+    }
+  else
+    {
+      if (ring->lr_rdclosed)
+        {
+          eventset |= POLLERR;
+        }
+      else if (used <= ring->lr_mask)
+        {
+          eventset |= POLLOUT;
+        }
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: local_ring_notify
+ *
+ * Description:
+ *   Wake up the other end of the ring after it moved: the receiver if
+ *   'reader', else the sender.
+ *
+ ****************************************************************************/
+
+static void local_ring_notify(FAR struct local_ring_s *ring, bool reader)
+{
+  /* Order the ring update before the check of the wait flag, the waiter
+   * orders its flag before its re-check of the ring.
+   */
+
+  SMP_MB();
+
+  if (atomic_xchg(reader ? &ring->lr_rdwait : &ring->lr_wrwait, 0) != 0)
+    {
+      nxsem_post(reader ? &ring->lr_rdsem : &ring->lr_wrsem);
+    }
+
+  if (atomic_read(&ring->lr_npolls) > 0)
+    {
+      nxmutex_lock(&ring->lr_polllock);
+      poll_notify(reader ? ring->lr_rdfds : ring->lr_wrfds,
+                  LOCAL_NPOLLWAITERS, local_ring_revents(ring, reader));
+      nxmutex_unlock(&ring->lr_polllock);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait for the other end of the ring to move, unless 'ready' already
+ *   holds once the wait is announced.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR struct local_ring_s *ring, bool reader,
+                           bool (*ready)(FAR struct local_ring_s *))
+{
+  FAR atomic_t *wait = reader ? &ring->lr_rdwait : &ring->lr_wrwait;
+  int ret;
+
+  atomic_set(wait, 1);
+  SMP_MB();
+
+  if (ready(ring))
+    {
+      atomic_set(wait, 0);
+      return OK;
+    }
+
+  /* A stale post from an earlier race only causes a spurious wake up,
+   * the callers loop on the ring state.
+   */
+
+  ret = nxsem_wait(reader ? &ring->lr_rdsem : &ring->lr_wrsem);
+  if (ret < 0)
+    {
+      atomic_set(wait, 0);
+    }
+
+  return ret;
+}
+
+static bool local_ring_readable(FAR struct local_ring_s *ring)
+{
+  return ring->lr_head != ring->lr_tail || ring->lr_wrclosed ||
+         ring->lr_rdclosed;
+}
+
+static bool local_ring_writable(FAR struct local_ring_s *ring)
+{
+  return ring->lr_head - ring->lr_tail <= ring->lr_mask ||
+         ring->lr_rdclosed || ring->lr_wrclosed;
+}
+
+/****************************************************************************
+ * Name: local_ring_close
+ *
+ * Description:
+ *   Close one end of a ring and wake up the other end.
+ *
+ ****************************************************************************/
+
+static void local_ring_close(FAR struct local_ring_s *ring, bool reader)
+{
+  if (reader)
+    {
+      ring->lr_rdclosed = true;
+    }
+  else
+    {
+      ring->lr_wrclosed = true;
+    }
+
+  local_ring_notify(ring, !reader);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Connect a pair of stream connections with one ring per direction.
+ *
+ * Input Parameters:
+ *   conn   - One connection of the pair
+ *   peer   - The other one
+ *   rxsize - The size of the ring from peer to conn
+ *   txsize - The size of the ring from conn to peer
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings could not be allocated.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *conn,
+                     FAR struct local_conn_s *peer,
+                     size_t rxsize, size_t txsize)
+{
+  FAR struct local_ring_s *rx;
+  FAR struct local_ring_s *tx;
+
+  rx = local_ring_create(rxsize);
+  if (rx == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  tx = local_ring_create(txsize);
+  if (tx == NULL)
+    {
+      kmm_free(rx);
+      return -ENOMEM;
+    }
+
+  conn->lc_rxring = rx;
+  conn->lc_txring = tx;
+  peer->lc_rxring = tx;
+  peer->lc_txring = rx;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Close both ends of the rings of a connection that goes away.  The peer
+ *   sees the end of the stream once it has drained its receive ring, and
+ *   EPIPE on send.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+  if (conn->lc_rxring != NULL)
+    {
+      local_ring_close(conn->lc_rxring, true);
+      local_ring_put(conn->lc_rxring);
+      conn->lc_rxring = NULL;
+    }
+
+  if (conn->lc_txring != NULL)
+    {
+      local_ring_close(conn->lc_txring, false);
+      local_ring_put(conn->lc_txring);
+      conn->lc_txring = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Close the receive end (SHUT_RD) and/or the send end (SHUT_WR) of the
+ *   rings of a connection.
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how)
+{
+  if ((how & SHUT_RD) != 0 && conn->lc_rxring != NULL)
+    {
+      local_ring_close(conn->lc_rxring, true);
+    }
+
+  if ((how & SHUT_WR) != 0 && conn->lc_txring != NULL)
+    {
+      local_ring_close(conn->lc_txring, false);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Copy data into the send ring of a connection, waiting for room unless
+ *   'nonblock'.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno if none could be.
+ *
+ * Assumptions:
+ *   The caller holds conn->lc_sendlock, which makes it the only producer.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *iov, size_t iovcnt,
+                        bool nonblock)
+{
+  FAR struct local_ring_s *ring = conn->lc_txring;
+  FAR const struct iovec *end = iov + iovcnt;
+  FAR const uint8_t *src;
+  size_t remain;
+  ssize_t nsent = 0;
+  int ret = OK;
+
+  for (; iov != end && ret >= 0; iov++)
+    {
+      src    = iov->iov_base;
+      remain = iov->iov_len;
+
+      while (remain > 0)
+        {
+          uint32_t head = ring->lr_head;
+          uint32_t off  = head & ring->lr_mask;
+          uint32_t room;
+          uint32_t ncopy;
+
+          if (ring->lr_rdclosed || ring->lr_wrclosed)
+            {
+              ret = -EPIPE;
+              break;
+            }
+
+          room = ring->lr_mask + 1 - (head - ring->lr_tail);
+          if (room == 0)
+            {
+              if (nonblock)
+                {
+                  ret = -EAGAIN;
+                  break;
+                }
+
+              ret = local_ring_wait(ring, false, local_ring_writable);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
+          /* Don't read the data before seeing the room made for it */
+
+          SMP_RMB();
+
+          ncopy = MIN(room, remain);
+          if (ncopy > ring->lr_mask + 1 - off)
+            {
+              uint32_t first = ring->lr_mask + 1 - off;
+
+              memcpy(ring->lr_buffer + off, src, first);
+              memcpy(ring->lr_buffer, src + first, ncopy - first);
+            }
+          else
+            {
+              memcpy(ring->lr_buffer + off, src, ncopy);
+            }
+
+          /* Publish the data */
+
+          SMP_WMB();
+          ring->lr_head = head + ncopy;
+          local_ring_notify(ring, true);
+
+          src    += ncopy;
+          remain -= ncopy;
+          nsent  += ncopy;
+        }
+    }
+
+  return nsent > 0 ? nsent : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Copy the data available in the receive ring of a connection, waiting
+ *   for some unless 'nonblock'.  With MSG_PEEK the data stays in the ring.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at the end of the stream, or a
+ *   negated errno.
+ *
+ * Assumptions:
+ *   The caller holds conn->lc_recvlock, which makes it the only consumer.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags, bool nonblock)
+{
+  FAR struct local_ring_s *ring = conn->lc_rxring;
+  uint32_t tail;
+  uint32_t used;
+  uint32_t off;
+  uint32_t ncopy;
+  int ret;
+
+  for (; ; )
+    {
+      tail = ring->lr_tail;
+      used = ring->lr_head - tail;
+
+      if (used > 0 || ring->lr_rdclosed)
+        {
+          break;
+        }
+
+      if (ring->lr_wrclosed)
+        {
+          /* Check the ring again, the sender may have closed right after
+           * sending its last data.
+           */
+
+          SMP_RMB();
+          used = ring->lr_head - tail;
+          break;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(ring, true, local_ring_readable);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (used == 0 || len == 0)
+    {
+      return 0;
+    }
+
+  /* Don't read the data before seeing it published */
+
+  SMP_RMB();
+
+  off   = tail & ring->lr_mask;
+  ncopy = MIN(used, len);
+  if (ncopy > ring->lr_mask + 1 - off)
+    {
+      uint32_t first = ring->lr_mask + 1 - off;
+
+      memcpy(buf, ring->lr_buffer + off, first);
+      memcpy((FAR uint8_t *)buf + first, ring->lr_buffer, ncopy - first);
+    }
+  else
+    {
+      memcpy(buf, ring->lr_buffer + off, ncopy);
+    }
+
+  if ((flags & MSG_PEEK) == 0)
+    {
+      /* Release the room only once the data is copied out */
+
+      SMP_MB();
+      ring->lr_tail = tail + ncopy;
+      local_ring_notify(ring, false);
+    }
+
+  return ncopy;
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Set up or tear down the poll of the receive ('in') or send ring of a
+ *   connection, like file_poll() on the matching FIFO.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup, bool in)
+{
+  FAR struct local_ring_s *ring = in ? conn->lc_rxring : conn->lc_txring;
+  FAR struct pollfd **slots = in ? ring->lr_rdfds : ring->lr_wrfds;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&ring->lr_polllock);
+
+  if (setup)
+    {
+      for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+        {
+          if (slots[i] == NULL)
+            {
+              slots[i]  = fds;
+              fds->priv = &slots[i];
+              break;
+            }
+        }
+
+      if (i >= LOCAL_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+        }
+      else
+        {
+          atomic_fetch_add(&ring->lr_npolls, 1);
+          poll_notify(&fds, 1, local_ring_revents(ring, in));
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      *(FAR struct pollfd **)fds->priv = NULL;
+      fds->priv = NULL;
+      atomic_fetch_sub(&ring->lr_npolls, 1);
+    }
+
+  nxmutex_unlock(&ring->lr_polllock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   The queue size ioctls of a connection using rings.
+ *
+ * Returned Value:
+ *   -ENOTTY if 'cmd' is not handled here.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg)
+{
+  FAR int *value = (FAR int *)((uintptr_t)arg);
+  FAR struct local_ring_s *ring;
+
+  switch (cmd)
+    {
+      case FIONREAD:
+        ring   = conn->lc_rxring;
+        *value = ring->lr_head - ring->lr_tail;
+        return OK;
+
+      case FIONWRITE:
+        ring   = conn->lc_txring;
+        *value = ring->lr_head - ring->lr_tail;
+        return OK;
+
+      case FIONSPACE:
+        ring   = conn->lc_txring;
+        *value = ring->lr_mask + 1 - (ring->lr_head - ring->lr_tail);
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+#endif /* CONFIG_NET_LOCAL_RING */
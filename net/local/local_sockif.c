@@ -663,7 +663,11 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
                 {
                   rcvsize = MIN(*(FAR const int *)value,
                                 CONFIG_DEV_PIPE_MAXSIZE);
-                  if (conn->lc_peer->lc_infile.f_inode != NULL)
+
+                  /* A ring keeps the size it was connected with */
+
+                  if (conn->lc_peer->lc_infile.f_inode != NULL &&
+                      !LOCAL_HAS_RING(conn->lc_peer))
                     {
                       ret = file_ioctl(&conn->lc_peer->lc_infile,
                                        PIPEIOC_SETSIZE, rcvsize);
@@ -707,7 +711,11 @@ static int local_setsockopt(FAR struct socket *psock, int level, int option,
 #endif
 
               rcvsize = MIN(rcvsize, CONFIG_DEV_PIPE_MAXSIZE);
-              if (conn->lc_infile.f_inode != NULL)
+              if (LOCAL_HAS_RING(conn))
+                {
+                  /* A ring keeps the size it was connected with */
+                }
+              else if (conn->lc_infile.f_inode != NULL)
                 {
                   ret = file_ioctl(&conn->lc_infile, PIPEIOC_SETSIZE,
                                    rcvsize);
@@ -929,6 +937,19 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
   FAR struct local_conn_s *conn = psock->s_conn;
   int ret = OK;
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (LOCAL_HAS_RING(conn))
+    {
+      ret = local_ring_ioctl(conn, cmd, arg);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+
+      ret = OK;
+    }
+#endif
+
   switch (cmd)
     {
       case FIONBIO:
@@ -1034,10 +1055,22 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
-  /* Create the FIFOs needed for the connection */
+  /* Create the FIFOs needed for the connection.  With the rings, stream
+   * FIFOs only carry the connection state and need no room for the data.
+   */
+
+#ifdef CONFIG_NET_LOCAL_RING
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      ret = local_create_fifos(conns[0], 1, 1);
+    }
+  else
+#endif
+    {
+      ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
+                               conns[1]->lc_rcvsize);
+    }
 
-  ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
-                           conns[1]->lc_rcvsize);
   if (ret < 0)
     {
       goto errout;
@@ -1077,6 +1110,18 @@ static int local_socketpair(FAR struct socket *psocks[2])
       goto errout;
     }
 
+#ifdef CONFIG_NET_LOCAL_RING
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      ret = local_ring_alloc(conns[0], conns[1], conns[0]->lc_rcvsize,
+                             conns[1]->lc_rcvsize);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+#endif
+
   conns[0]->lc_state = conns[1]->lc_state
                      = LOCAL_STATE_CONNECTED;
 
@@ -1132,6 +1177,11 @@ static int local_shutdown(FAR struct socket *psock, int how)
       case SOCK_STREAM:
         {
           FAR struct local_conn_s *conn = psock->s_conn;
+
+#ifdef CONFIG_NET_LOCAL_RING
+          local_ring_shutdown(conn, how);
+#endif
+
           if (how & SHUT_RD)
             {
               if (conn->lc_infile.f_inode != NULL)
@@ -47,6 +47,11 @@
 static DECLARE_HASHTABLE(g_nat66_inbound, CONFIG_NET_NAT_HASH_BITS);
 static DECLARE_HASHTABLE(g_nat66_outbound, CONFIG_NET_NAT_HASH_BITS);
 
+/* Entries by expiration time and the last second the wheel was turned to */
+
+static dq_queue_t g_nat66_wheel[NAT_WHEEL_SIZE];
+static int32_t g_nat66_wheel_time;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -86,6 +91,22 @@ static void ipv6_nat_entry_refresh(FAR ipv6_nat_entry_t *entry)
   entry->expire_time = nat_expire_time(entry->protocol);
 }
 
+/****************************************************************************
+ * Name: ipv6_nat_wheel_add
+ *
+ * Description:
+ *   File an entry in the timing wheel slot of its expiration time.  A
+ *   refresh only moves the expiration time, the entry is filed again when
+ *   the wheel reaches its old slot.
+ *
+ ****************************************************************************/
+
+static void ipv6_nat_wheel_add(FAR ipv6_nat_entry_t *entry)
+{
+  entry->wheel_slot = entry->expire_time & NAT_WHEEL_MASK;
+  dq_addlast(&entry->wheel, &g_nat66_wheel[entry->wheel_slot]);
+}
+
 /****************************************************************************
  * Name: ipv6_nat_entry_create
  *
@@ -132,6 +153,7 @@ ipv6_nat_entry_create(uint8_t protocol, const net_ipv6addr_t external_ip,
 #endif
 
   ipv6_nat_entry_refresh(entry);
+  ipv6_nat_wheel_add(entry);
 
   hashtable_add(g_nat66_inbound, &entry->hash_inbound,
                 ipv6_nat_hash_key(external_ip, external_port, protocol));
@@ -175,6 +197,8 @@ static void ipv6_nat_entry_delete(FAR ipv6_nat_entry_t *entry)
                                      entry->local_port,
                                      entry->protocol));
 
+  dq_rem(&entry->wheel, &g_nat66_wheel[entry->wheel_slot]);
+
 #ifdef CONFIG_NETLINK_NETFILTER
   netlink_conntrack_notify(IPCTNL_MSG_CT_DELETE, PF_INET6, entry);
 #endif
@@ -183,47 +207,56 @@ static void ipv6_nat_entry_delete(FAR ipv6_nat_entry_t *entry)
 }
 
 /****************************************************************************
- * Name: ipv6_nat_reclaim_entry
+ * Name: ipv6_nat_wheel_expire
  *
  * Description:
- *   Try reclaim all expired NAT entries.
- *   Only works after every CONFIG_NET_NAT_ENTRY_RECLAIM_SEC (low frequency).
- *
- *   Although expired entries will be automatically reclaimed when matching
- *   inbound/outbound entries, there might be some situations that entries
- *   will be kept in memory, e.g. big hashtable with only a few connections.
+ *   Turn the timing wheel up to the current time, reclaim the expired
+ *   entries in the slots passed and file the refreshed ones again.  Only
+ *   the slots of the seconds since the last call are visited, each at most
+ *   once, so the cost follows the number of expiring entries instead of
+ *   the size of the table.
  *
  * Assumptions:
  *   NAT is initialized.
  *
  ****************************************************************************/
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-static void ipv6_nat_reclaim_entry_cb(FAR ipv6_nat_entry_t *entry,
-                                      FAR void *arg)
+static void ipv6_nat_wheel_expire(int32_t current_time)
 {
-  int32_t current_time = *(FAR int32_t *)arg;
+  FAR ipv6_nat_entry_t *entry;
+  FAR dq_queue_t *slot;
+  FAR dq_entry_t *p;
+  FAR dq_entry_t *tmp;
+  int32_t time = g_nat66_wheel_time;
 
-  if (entry->expire_time - current_time <= 0)
+  if (current_time - time > NAT_WHEEL_SIZE)
     {
-      ipv6_nat_entry_delete(entry);
+      time = current_time - NAT_WHEEL_SIZE;
     }
-}
-
-static void ipv6_nat_reclaim_entry(int32_t current_time)
-{
-  static int32_t next_reclaim_time = CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
 
-  if (next_reclaim_time - current_time <= 0)
+  while (time - current_time < 0)
     {
-      ninfo("INFO: Reclaiming all expired NAT66 entries.\n");
-      ipv6_nat_entry_foreach(ipv6_nat_reclaim_entry_cb, &current_time);
-      next_reclaim_time = current_time + CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
+      time++;
+      slot = &g_nat66_wheel[time & NAT_WHEEL_MASK];
+
+      dq_for_every_safe(slot, p, tmp)
+        {
+          entry = container_of(p, ipv6_nat_entry_t, wheel);
+          if (entry->expire_time - current_time <= 0)
+            {
+              ipv6_nat_entry_delete(entry);
+            }
+          else if ((entry->expire_time & NAT_WHEEL_MASK) !=
+                   entry->wheel_slot)
+            {
+              dq_rem(&entry->wheel, slot);
+              ipv6_nat_wheel_add(entry);
+            }
+        }
     }
+
+  g_nat66_wheel_time = current_time;
 }
-#else
-#  define ipv6_nat_reclaim_entry(t)
-#endif
 
 /****************************************************************************
  * Name: ipv6_nat_entry_clear_cb
@@ -331,7 +364,7 @@ ipv6_nat_inbound_entry_find(uint8_t protocol,
 #endif
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-  ipv6_nat_reclaim_entry(current_time);
+  ipv6_nat_wheel_expire(current_time);
 
   hashtable_for_every_possible_safe(g_nat66_inbound, p, tmp,
                     ipv6_nat_hash_key(external_ip, external_port, protocol))
@@ -412,7 +445,7 @@ ipv6_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
   uint16_t external_port;
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-  ipv6_nat_reclaim_entry(current_time);
+  ipv6_nat_wheel_expire(current_time);
 
   hashtable_for_every_possible_safe(g_nat66_outbound, p, tmp,
                           ipv6_nat_hash_key(local_ip, local_port, protocol))
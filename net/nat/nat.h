@@ -44,6 +44,13 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The expiry timing wheel has one slot per second, an entry is filed at
+ * its expiration time modulo the wheel size.
+ */
+
+#define NAT_WHEEL_SIZE (1 << CONFIG_NET_NAT_WHEEL_BITS)
+#define NAT_WHEEL_MASK (NAT_WHEEL_SIZE - 1)
+
 /* Adjust checksums in headers. */
 
 #define nat_chksum_adjust(chksum,optr,nptr,len) \
@@ -74,6 +81,7 @@ struct ipv4_nat_entry_s
 {
   hash_node_t hash_inbound;
   hash_node_t hash_outbound;
+  dq_entry_t  wheel;         /* Link in the expiry timing wheel. */
 
   /*  Local Network                             External Network
    *                |----------------|
@@ -100,12 +108,14 @@ struct ipv4_nat_entry_s
   uint8_t    protocol;       /* L4 protocol (TCP, UDP etc). */
 
   int32_t    expire_time;    /* The expiration time of this entry. */
+  uint16_t   wheel_slot;     /* The timing wheel slot holding this entry. */
 };
 
 struct ipv6_nat_entry_s
 {
   hash_node_t    hash_inbound;
   hash_node_t    hash_outbound;
+  dq_entry_t     wheel;         /* Link in the expiry timing wheel. */
 
   net_ipv6addr_t local_ip;      /* IP address of the local host. */
   net_ipv6addr_t external_ip;   /* External IP address. */
@@ -120,6 +130,7 @@ struct ipv6_nat_entry_s
   uint8_t        protocol;      /* L4 protocol (TCP, UDP etc). */
 
   int32_t        expire_time;   /* The expiration time of this entry. */
+  uint16_t       wheel_slot;    /* The timing wheel slot of this entry. */
 };
 
 typedef struct ipv4_nat_entry_s ipv4_nat_entry_t;
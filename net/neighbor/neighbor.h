@@ -31,6 +31,8 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/mutex.h>
+#include <nuttx/seqlock.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -38,15 +40,40 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The hash chains link the table entries by index + 1, 0 ends a chain */
+
+#define NEIGHBOR_NDX(n) ((uint16_t)((n) - g_neighbors + 1))
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+/* This is the Neighbor table.  g_neighbor_lock must be held when
+ * accessing this table.
  */
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern rmutex_t g_neighbor_lock;
+
+/* The entries in use hashed by IPv6 address, and the tick of their last
+ * lookup for the replacement of the least recently used one.
+ */
+
+extern uint16_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_NBUCKETS];
+extern uint16_t g_neighbor_hnext[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern uint32_t g_neighbor_used[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The writers, which hold g_neighbor_lock, also publish each change of an
+ * entry or of the hash chains through g_neighbor_seq, so that
+ * neighbor_lookup() on the TX path reads the table without taking any
+ * lock: it retries if a change overlapped with its lookup.
+ */
+
+extern seqcount_t g_neighbor_seq;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -54,12 +81,41 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_lock and neighbor_unlock
+ *
+ * Description:
+ *   Lock and unlock the Neighbor Table.  The table is shared by all
+ *   devices, so it is not covered by the device lock; the lock is always
+ *   taken after the device and connection locks.
+ *
+ ****************************************************************************/
+
+#define neighbor_lock()   nxrmutex_lock(&g_neighbor_lock)
+#define neighbor_unlock() nxrmutex_unlock(&g_neighbor_lock)
+
+/****************************************************************************
+ * Name: neighbor_hash_link and neighbor_hash_unlink
+ *
+ * Description:
+ *   Add an entry to, or remove it from, the hash chain of its IPv6
+ *   address.  The caller holds the Neighbor Table lock and g_neighbor_seq
+ *   for writing.
+ *
+ ****************************************************************************/
+
+void neighbor_hash_link(FAR struct neighbor_entry_s *neighbor);
+void neighbor_hash_unlink(FAR struct neighbor_entry_s *neighbor);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
  * Description:
  *   Find an entry in the Neighbor Table.  This interface is internal to
  *   the neighbor implementation; Consider using neighbor_lookup() instead;
+ *   The caller must hold the Neighbor Table lock as long as it uses the
+ *   returned entry, or read g_neighbor_seq and retry the lookup if it
+ *   overlapped with a change.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
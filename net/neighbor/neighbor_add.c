@@ -37,6 +37,7 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
 
+#include "inet/inet.h"
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
 #include "neighbor/neighbor.h"
@@ -65,45 +66,56 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  irqstate_t flags;
   uint8_t lltype;
-  clock_t oldest_time;
   int     oldest_ndx;
-  bool    found = false;
+  bool    inuse;
+  bool    found;
   bool    new_entry;
   int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* Find the matching entry, else the first unused entry or the least
+   * recently used one.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  neighbor_lock();
+  lltype   = dev->d_lltype;
+  neighbor = neighbor_findentry(ipaddr);
+  found    = neighbor != NULL;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  if (found)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          found = true;
-          break;
-        }
-
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      oldest_ndx = NEIGHBOR_NDX(neighbor) - 1;
+    }
+  else
+    {
+      oldest_ndx = 0;
+      for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          if (net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr,
+                               g_ipv6_unspecaddr))
+            {
+              oldest_ndx = i;
+              break;
+            }
+
+          if ((int32_t)(g_neighbor_used[i] -
+                        g_neighbor_used[oldest_ndx]) < 0)
+            {
+              oldest_ndx = i;
+            }
         }
     }
 
+  inuse = !net_ipv6addr_cmp(g_neighbors[oldest_ndx].ne_ipaddr,
+                            g_ipv6_unspecaddr);
+
   /* When overwrite old entry, need to notify RTM_DELNEIGH */
 
-  if (!found && g_neighbors[oldest_ndx].ne_time != 0)
+  if (!found && inuse)
     {
       netlink_neigh_notify(&g_neighbors[oldest_ndx], RTM_DELNEIGH,
                            AF_INET6);
@@ -114,12 +126,20 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   new_entry = !found || memcmp(&g_neighbors[oldest_ndx].ne_addr.u, addr,
                              g_neighbors[oldest_ndx].ne_addr.na_llsize) != 0;
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
+  /* Use the least recently used or first free entry (either pointed to by
+   * the "oldest_ndx" variable).
    */
 
+  flags = write_seqlock_irqsave(&g_neighbor_seq);
+
+  if (!found && inuse)
+    {
+      neighbor_hash_unlink(&g_neighbors[oldest_ndx]);
+    }
+
   g_neighbors[oldest_ndx].ne_dev  = dev;
   g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
+  g_neighbor_used[oldest_ndx] = (uint32_t)g_neighbors[oldest_ndx].ne_time;
   net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
 
   g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
@@ -128,6 +148,13 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
          g_neighbors[oldest_ndx].ne_addr.na_llsize);
 
+  if (!found)
+    {
+      neighbor_hash_link(&g_neighbors[oldest_ndx]);
+    }
+
+  write_sequnlock_irqrestore(&g_neighbor_seq, flags);
+
   /* Notify the new entry */
 
   if (new_entry)
@@ -139,4 +166,5 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
   /* Dump the contents of the new entry */
 
   neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_unlock();
 }
@@ -31,10 +31,84 @@
 
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPv6_NCONF_NBUCKETS & \
+     (CONFIG_NET_IPv6_NCONF_NBUCKETS - 1)) != 0
+#  error CONFIG_NET_IPv6_NCONF_NBUCKETS must be a power of two
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash
+ ****************************************************************************/
+
+static FAR uint16_t *neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = (hash << 5) ^ (hash >> 27) ^ ipaddr[i];
+    }
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_neighbor_hash[hash & (CONFIG_NET_IPv6_NCONF_NBUCKETS - 1)];
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_hash_link
+ *
+ * Description:
+ *   Add an entry to the hash chain of its IPv6 address.
+ *
+ ****************************************************************************/
+
+void neighbor_hash_link(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR uint16_t *head = neighbor_hash(neighbor->ne_ipaddr);
+
+  g_neighbor_hnext[NEIGHBOR_NDX(neighbor) - 1] = *head;
+  *head = NEIGHBOR_NDX(neighbor);
+}
+
+/****************************************************************************
+ * Name: neighbor_hash_unlink
+ *
+ * Description:
+ *   Remove an entry from the hash chain of its IPv6 address.
+ *
+ ****************************************************************************/
+
+void neighbor_hash_unlink(FAR struct neighbor_entry_s *neighbor)
+{
+  FAR uint16_t *link = neighbor_hash(neighbor->ne_ipaddr);
+
+  while (*link != 0)
+    {
+      if (*link == NEIGHBOR_NDX(neighbor))
+        {
+          *link = g_neighbor_hnext[*link - 1];
+          break;
+        }
+
+      link = &g_neighbor_hnext[*link - 1];
+    }
+
+  g_neighbor_hnext[NEIGHBOR_NDX(neighbor) - 1] = 0;
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -53,17 +127,24 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  uint16_t ndx = *neighbor_hash(ipaddr);
+  int hops;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  /* The walk is bounded, in case the chains moved under a reader that
+   * does not hold the lock.
+   */
+
+  for (hops = 0; ndx != 0 && hops < CONFIG_NET_IPv6_NCONF_ENTRIES; hops++)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &g_neighbors[ndx - 1];
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
           return neighbor;
         }
+
+      ndx = g_neighbor_hnext[ndx - 1];
     }
 
   neighbor_dumpipaddr("Not found", ipaddr);
@@ -32,11 +32,19 @@
  * Public Data
  ****************************************************************************/
 
-/* This is the Neighbor table.  The network should be locked when accessing
- * this table.
+/* This is the Neighbor table.  g_neighbor_lock must be held when
+ * accessing this table.
  */
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+rmutex_t g_neighbor_lock = NXRMUTEX_INITIALIZER;
+
+/* The hash index of the table and the replacement order of its entries */
+
+uint16_t g_neighbor_hash[CONFIG_NET_IPv6_NCONF_NBUCKETS];
+uint16_t g_neighbor_hnext[CONFIG_NET_IPv6_NCONF_ENTRIES];
+uint32_t g_neighbor_used[CONFIG_NET_IPv6_NCONF_ENTRIES];
+seqcount_t g_neighbor_seq = SEQLOCK_INITIALIZER;
 
 /****************************************************************************
  * Public Functions
@@ -117,19 +117,39 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
 {
   FAR struct neighbor_entry_s *neighbor;
   struct neighbor_table_info_s info;
+  struct neighbor_addr_s ne_addr;
+  uint32_t seq;
 
-  /* Check if the IPv6 address is already in the neighbor table. */
+  /* Check if the IPv6 address is already in the neighbor table.  This runs
+   * for each packet sent, so it takes no lock but copies the entry out and
+   * retries if the table changed meanwhile.
+   */
+
+  do
+    {
+      seq      = read_seqbegin(&g_neighbor_seq);
+      neighbor = neighbor_findentry(ipaddr);
+      if (neighbor != NULL)
+        {
+          ne_addr = neighbor->ne_addr;
+        }
+    }
+  while (read_seqretry(&g_neighbor_seq, seq));
 
-  neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      /* A racy store, it only steers the replacement of entries */
+
+      g_neighbor_used[NEIGHBOR_NDX(neighbor) - 1] =
+        (uint32_t)clock_systime_ticks();
+
       /* Yes.. return the link layer address if the caller has provided a
        * non-NULL address in 'laddr'.
        */
 
       if (laddr != NULL)
         {
-          memcpy(laddr, &neighbor->ne_addr, sizeof(*laddr));
+          memcpy(laddr, &ne_addr, sizeof(*laddr));
         }
 
       /* Return success in any case meaning that a valid link layer
@@ -56,7 +56,7 @@
  *   entries are not returned.
  *
  * Assumptions
- *   The network is locked to assure exclusive access to the ARP table
+ *   The Neighbor Table is locked internally.
  *
  ****************************************************************************/
 
@@ -68,6 +68,7 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
 
   /* Copy all non-empty entries in the Neighbor table. */
 
+  neighbor_lock();
   for (i = 0, ncopied = 0;
        nentries > ncopied && i < CONFIG_NET_IPv6_NCONF_ENTRIES;
        i++)
@@ -87,6 +88,8 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
         }
     }
 
+  neighbor_unlock();
+
   /* Return the number of entries copied into the user buffer */
 
   return ncopied;
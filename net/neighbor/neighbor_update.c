@@ -52,9 +52,14 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
 {
   struct neighbor_entry_s *neighbor;
 
+  neighbor_lock();
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
       neighbor->ne_time = clock_systime_ticks();
+      g_neighbor_used[NEIGHBOR_NDX(neighbor) - 1] =
+        (uint32_t)neighbor->ne_time;
     }
+
+  neighbor_unlock();
 }
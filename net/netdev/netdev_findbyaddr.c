@@ -186,8 +186,10 @@ netdev_prefixlen_findby_lipv6addr(const net_ipv6addr_t lipaddr,
    * multiple devices.
    */
 
+  neighbor_lock();
   ne   = neighbor_findentry(lipaddr);
   hint = ne ? ne->ne_dev : NULL;
+  neighbor_unlock();
 #endif
 
   /* Examine each registered network device */
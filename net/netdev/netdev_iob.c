@@ -108,9 +108,9 @@ void netdev_iob_prepare_dynamic(FAR struct net_driver_s *dev, uint16_t size)
       return;
     }
 
-  /* alloc new iob for jumbo frame */
+  /* alloc new iob for jumbo frame, from a size class pool if possible */
 
-  iob = iob_alloc_dynamic(size);
+  iob = iob_tryalloc_size(size, false);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to allocate an I/O buffer.");
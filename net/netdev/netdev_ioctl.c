@@ -84,6 +84,7 @@
 #include "devif/devif.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipforward/ipforward.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
@@ -778,6 +779,8 @@ static ssize_t net_ioctl_ifreq_arglen(uint8_t domain, int cmd)
       case SIOCSIFNAME:
       case SIOCGIFNAME:
       case SIOCGIFINDEX:
+      case SIOCSHWTSTAMP:
+      case SIOCGHWTSTAMP:
         return sizeof(struct ifreq);
 
       case SIOCSIFADDR:
@@ -1314,11 +1317,42 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
         break;
 #endif
 
+#if defined(CONFIG_NETDEV_IOCTL) && defined(CONFIG_NET_TIMESTAMPING)
+      case SIOCSHWTSTAMP:  /* Configure hardware timestamping */
+      case SIOCGHWTSTAMP:  /* Get the hardware timestamping configuration */
+        if (req->ifr_data == NULL)
+          {
+            ret = -EINVAL;
+          }
+        else if (dev->d_ioctl)
+          {
+            ret = dev->d_ioctl(dev, cmd,
+                               (unsigned long)(uintptr_t)req->ifr_data);
+          }
+        else
+          {
+            ret = -EOPNOTSUPP;
+          }
+        break;
+#endif
+
       default:
         ret = -ENOTTY;
         break;
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* New addresses may change the forwarding device of cached flows */
+
+  if (ret >= 0 &&
+      (cmd == SIOCSIFADDR || cmd == SIOCDIFADDR || cmd == SIOCSLIFADDR ||
+       cmd == SIOCSIFNETMASK || cmd == SIOCSLIFNETMASK ||
+       cmd == SIOCSIFDSTADDR || cmd == SIOCSLIFDSTADDR))
+    {
+      ipfwd_flow_flush();
+    }
+#endif
+
   netdev_unlock(dev);
   return ret;
 }
@@ -2051,6 +2085,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipfwd_flow_flush();
 
               /* Update the driver status */
 
@@ -2085,6 +2120,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipfwd_flow_flush();
 
               /* Update the driver status */
 
@@ -34,7 +34,6 @@
  ****************************************************************************/
 
 #define PACKET_BYTE_SIZE        36
-#define RANDOM_KEY_SIZE         40
 
 /****************************************************************************
  * Private Types
@@ -53,27 +52,10 @@ typedef enum hashcal_type_e
   HASHCAL_TYPE_2TUPLE,
 } hashcal_type_e;
 
-typedef union toeplitz_key_u
-{
-  uint8_t u8[RANDOM_KEY_SIZE];
-  uint32_t u32[10];
-} toeplitz_key_u;
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static const toeplitz_key_u g_random_key =
-{
-  .u8 =
-  {
-    0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67,
-    0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0, 0xd0, 0xca, 0x2b, 0xcb,
-    0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30,
-    0xf2, 0x0c, 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
-  }
-};
-
 static const uint32_t g_crc32c_table[256] =
 {
   0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
@@ -125,53 +107,6 @@ static const uint32_t g_crc32c_table[256] =
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: compute_toeplitz_hash
- *
- * Description:
- *   HASHCAL_ALGO_TOEPLITZ is a hash algorithm that uses Toeplitz matrix to
- *   calculate hash values. Toeplitz matrix is a special matrix where each
- *   diagonal has the same elements.
- *
- * Input Parameters:
- *   packet - The packet data
- *   len    - The packet length in bytes
- *
- * Returned Value:
- *   The hash value with toeplitz matrix calculation
- *
- ****************************************************************************/
-
-static uint32_t compute_toeplitz_hash(FAR const uint8_t *packet,
-                                      uint32_t len)
-{
-  uint32_t key = (g_random_key.u8[0] << 24) | (g_random_key.u8[1] << 16) |
-                 (g_random_key.u8[2] << 8) | g_random_key.u8[3];
-  uint32_t ret = 0;
-  int i;
-  int j;
-
-  for (i = 0; i < len; i++)
-    {
-      for (j = 0; j < 8; j++)
-        {
-          if (packet[i] & (1 << (7 - j)))
-            {
-              ret ^= key;
-            }
-
-          key <<= 1;
-          if ((i + 4) < RANDOM_KEY_SIZE &&
-              (g_random_key.u8[i + 4] & (1 << (7 - j))))
-            {
-              key |= 1;
-            }
-        }
-    }
-
-  return ret;
-}
-
 /****************************************************************************
  * Name: compute_xor_hash
  *
@@ -368,7 +303,7 @@ static uint32_t compute_hash(hashcal_algo_e hash_algo,
   switch (hash_algo)
     {
       case HASHCAL_ALGO_TOEPLITZ:
-        hash_val = compute_toeplitz_hash(packet, cal_len);
+        hash_val = net_toeplitz_hash(packet, cal_len);
         break;
 
       case HASHCAL_ALGO_XOR:
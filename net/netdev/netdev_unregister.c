@@ -37,6 +37,7 @@
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
 
+#include "ipforward/ipforward.h"
 #include "mld/mld.h"
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -148,6 +149,10 @@ int netdev_unregister(FAR struct net_driver_s *dev)
           curr->flink = NULL;
         }
 
+      /* Cached flows must not keep forwarding to the removed device */
+
+      ipfwd_flow_flush();
+
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
@@ -55,6 +55,8 @@ struct ip6t_table_s
   FAR struct ip6t_replace *repl;
   FAR struct ip6t_replace *(*init_func)(void);
   FAR int (*apply_func)(FAR const struct ip6t_replace *);
+  FAR void (*counters_func)(FAR const struct ip6t_replace *,
+                            FAR struct ip6t_entry *);
 };
 
 /* Following structs represent the layout of an entry with standard/error
@@ -82,9 +84,9 @@ struct ip6t_error_entry_s
 static struct ip6t_table_s g_tables[] =
 {
 #ifdef CONFIG_NET_IPFILTER
-  {NULL, ip6t_filter_init, ip6t_filter_apply},
+  {NULL, ip6t_filter_init, ip6t_filter_apply, ip6t_filter_counters},
 #else
-  {NULL, NULL, NULL}
+  {NULL, NULL, NULL, NULL}
 #endif
 };
 
@@ -199,6 +201,7 @@ static int get_info(FAR struct ip6t_getinfo *get, FAR socklen_t *len)
 
 static int get_entries(FAR struct ip6t_get_entries *get, FAR socklen_t *len)
 {
+  FAR struct ip6t_table_s *table;
   FAR struct ip6t_replace *repl;
 
   if (*len < sizeof(*get) || *len != sizeof(*get) + get->size)
@@ -206,18 +209,23 @@ static int get_entries(FAR struct ip6t_get_entries *get, FAR socklen_t *len)
       return -EINVAL;
     }
 
-  repl = ip6t_table_repl(get->name);
-  if (repl == NULL)
+  table = ip6t_table(get->name);
+  if (table == NULL)
     {
       return -ENOENT;
     }
 
+  repl = table->repl;
   if (get->size != repl->size)
     {
       return -EAGAIN;
     }
 
   memcpy(get->entrytable, repl->entries, get->size);
+  if (table->counters_func != NULL)
+    {
+      table->counters_func(repl, get->entrytable);
+    }
 
   return OK;
 }
@@ -32,8 +32,10 @@
 #include <string.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netfilter/ip_tables.h>
 #include <nuttx/net/netfilter/x_tables.h>
+#include <nuttx/net/netfilter/xt_set.h>
 
 #include "ipfilter/ipfilter.h"
 #include "netdev/netdev.h"
@@ -47,6 +49,15 @@
                             (1 << NF_INET_FORWARD)  | \
                             (1 << NF_INET_LOCAL_OUT))
 
+/* Walk all matches of an entry, they end where the target begins. */
+
+#define xt_match_for_every(match, first, target) \
+  for ((match) = (first); \
+       (FAR const uint8_t *)(match) < (FAR const uint8_t *)(target) && \
+       (match)->u.match_size != 0; \
+       (match) = (FAR const struct xt_entry_match *) \
+                 ((FAR const uint8_t *)(match) + (match)->u.match_size))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -147,6 +158,102 @@ static void convert_icmp(FAR struct ipfilter_entry_s *entry, uint8_t type,
   entry->match_icmp = 1;
 }
 
+/****************************************************************************
+ * Name: convert_sets
+ *
+ * Description:
+ *   Convert the iptables set matches of an entry, a rule takes at most
+ *   one source and one destination set.
+ *
+ * Input Parameters:
+ *   entry  - The ipfilter entry to be filled.
+ *   family - The address family of the entry.
+ *   first  - The first match of the iptables entry.
+ *   target - The target of the iptables entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_SET
+static void convert_sets(FAR struct ipfilter_entry_s *entry,
+                         sa_family_t family,
+                         FAR const struct xt_entry_match *first,
+                         FAR const struct xt_entry_target *target)
+{
+  FAR const struct xt_set_info_match_v1 *info;
+  FAR const struct xt_entry_match *match;
+  FAR struct ipfilter_set_s *set;
+
+  xt_match_for_every(match, first, target)
+    {
+      if (strcmp(match->u.user.name, XT_MATCH_NAME_SET) != 0)
+        {
+          continue;
+        }
+
+      info = (FAR const struct xt_set_info_match_v1 *)(match + 1);
+      set  = ipfilter_set_get(info->match_set.index, family);
+      if (set == NULL)
+        {
+          continue;
+        }
+
+      if ((info->match_set.flags & IPSET_DIM_ONE_SRC) != 0 &&
+          entry->sset == NULL)
+        {
+          entry->sset     = set;
+          entry->inv_sset = !!(info->match_set.flags & IPSET_INV_MATCH);
+        }
+      else if ((info->match_set.flags & IPSET_DIM_ONE_SRC) == 0 &&
+               entry->dset == NULL)
+        {
+          entry->dset     = set;
+          entry->inv_dset = !!(info->match_set.flags & IPSET_INV_MATCH);
+        }
+      else
+        {
+          ipfilter_set_put(set);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: check_sets
+ *
+ * Description:
+ *   Check that the set matches of an entry refer to sets of the family.
+ *
+ ****************************************************************************/
+
+static int check_sets(sa_family_t family,
+                      FAR const struct xt_entry_match *first,
+                      FAR const struct xt_entry_target *target)
+{
+  FAR const struct xt_set_info_match_v1 *info;
+  FAR const struct xt_entry_match *match;
+  FAR struct ipfilter_set_s *set;
+
+  xt_match_for_every(match, first, target)
+    {
+      if (strcmp(match->u.user.name, XT_MATCH_NAME_SET) != 0)
+        {
+          continue;
+        }
+
+      info = (FAR const struct xt_set_info_match_v1 *)(match + 1);
+      set  = ipfilter_set_get(info->match_set.index, family);
+      if (set == NULL)
+        {
+          nwarn("WARNING: No set %u\n", info->match_set.index);
+          return -ENOENT;
+        }
+
+      ipfilter_set_put(set);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: convert_target
  *
@@ -271,6 +378,10 @@ convert_ipv4entry(FAR const struct ipt_entry *entry)
         break;
     }
 
+#ifdef CONFIG_NET_IPFILTER_SET
+  convert_sets(&filter->common, PF_INET, match, target);
+#endif
+
 skip_match:
   return filter;
 }
@@ -347,6 +458,10 @@ convert_ipv6entry(FAR const struct ip6t_entry *entry)
         break;
     }
 
+#ifdef CONFIG_NET_IPFILTER_SET
+  convert_sets(&filter->common, PF_INET6, match, target);
+#endif
+
 skip_match:
   return filter;
 }
@@ -372,6 +487,9 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
   enum nf_inet_hooks hook;
   size_t size;
 
+  /* Swap the rules at once for the packets being filtered */
+
+  net_lock();
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
     {
       /* Clear all filter config first. */
@@ -400,7 +518,14 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
               nwarn("WARNING: Failed to convert entry!\n");
             }
         }
+
+      if (ipfilter_cfg_commit(PF_INET, chain) < 0)
+        {
+          nwarn("WARNING: Failed to compile chain, match linearly\n");
+        }
     }
+
+  net_unlock();
 }
 #endif
 
@@ -413,6 +538,9 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
   enum nf_inet_hooks hook;
   size_t size;
 
+  /* Swap the rules at once for the packets being filtered */
+
+  net_lock();
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
     {
       /* Clear all filter config first. */
@@ -441,7 +569,14 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
               nwarn("WARNING: Failed to convert entry!\n");
             }
         }
+
+      if (ipfilter_cfg_commit(PF_INET6, chain) < 0)
+        {
+          nwarn("WARNING: Failed to compile chain, match linearly\n");
+        }
     }
+
+  net_unlock();
 }
 #endif
 
@@ -522,6 +657,13 @@ int ipt_filter_apply(FAR const struct ipt_replace *repl)
             }
         }
 
+#ifdef CONFIG_NET_IPFILTER_SET
+      if (check_sets(PF_INET, match, target) < 0)
+        {
+          return -ENOENT;
+        }
+#endif
+
       /* Check target type */
 
       if (strcmp(target->u.user.name, XT_REJECT_TARGET) != 0 &&
@@ -581,6 +723,13 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl)
             }
         }
 
+#ifdef CONFIG_NET_IPFILTER_SET
+      if (check_sets(PF_INET6, match, target) < 0)
+        {
+          return -ENOENT;
+        }
+#endif
+
       /* Check target type */
 
       if (strcmp(target->u.user.name, XT_REJECT_TARGET) != 0 &&
@@ -599,3 +748,92 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl)
   return OK;
 }
 #endif
+
+/****************************************************************************
+ * Name: ipt_filter_counters
+ *
+ * Description:
+ *   Copy the hit counters of the filter rules into a copy of the entries,
+ *   e.g. for IPT_SO_GET_ENTRIES.
+ *
+ * Input Parameters:
+ *   repl    - The config applied to the filter table.
+ *   entries - The copy of repl->entries to fill.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipt_filter_counters(FAR const struct ipt_replace *repl,
+                         FAR struct ipt_entry *entries)
+{
+  FAR const struct ipfilter_entry_s *filter;
+  FAR const sq_queue_t *queue;
+  FAR struct ipt_entry *entry;
+  enum nf_inet_hooks hook;
+  FAR uint8_t *head;
+  size_t size;
+
+  net_lock();
+  for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
+    {
+      /* The rules are in the same order as the entries of the hook */
+
+      queue  = ipfilter_cfg_chain(PF_INET, convert_chain(hook));
+      filter = (FAR const struct ipfilter_entry_s *)sq_peek(queue);
+      head   = (FAR uint8_t *)entries + repl->hook_entry[hook];
+      size   = repl->underflow[hook] - repl->hook_entry[hook] + 1;
+
+      ipt_entry_for_every(entry, head, size)
+        {
+          if (filter == NULL)
+            {
+              break;
+            }
+
+          entry->counters.pcnt = filter->pcnt;
+          entry->counters.bcnt = filter->bcnt;
+          filter = filter->flink;
+        }
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void ip6t_filter_counters(FAR const struct ip6t_replace *repl,
+                          FAR struct ip6t_entry *entries)
+{
+  FAR const struct ipfilter_entry_s *filter;
+  FAR const sq_queue_t *queue;
+  FAR struct ip6t_entry *entry;
+  enum nf_inet_hooks hook;
+  FAR uint8_t *head;
+  size_t size;
+
+  net_lock();
+  for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
+    {
+      /* The rules are in the same order as the entries of the hook */
+
+      queue  = ipfilter_cfg_chain(PF_INET6, convert_chain(hook));
+      filter = (FAR const struct ipfilter_entry_s *)sq_peek(queue);
+      head   = (FAR uint8_t *)entries + repl->hook_entry[hook];
+      size   = repl->underflow[hook] - repl->hook_entry[hook] + 1;
+
+      ip6t_entry_for_every(entry, head, size)
+        {
+          if (filter == NULL)
+            {
+              break;
+            }
+
+          entry->counters.pcnt = filter->pcnt;
+          entry->counters.bcnt = filter->bcnt;
+          filter = filter->flink;
+        }
+    }
+
+  net_unlock();
+}
+#endif
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * net/netfilter/ipt_set.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/net/netfilter/xt_set.h>
+
+#include "ipfilter/ipfilter.h"
+#include "netfilter/iptables.h"
+
+#ifdef CONFIG_NET_IPFILTER_SET
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipt_set_adt
+ *
+ * Description:
+ *   Handle the set management requests.
+ *
+ ****************************************************************************/
+
+static int ipt_set_adt(FAR struct ip_set_req_adt *req)
+{
+  int ret;
+
+  switch (req->op)
+    {
+      case IP_SET_OP_CREATE:
+        req->set.name[IPSET_MAXNAMELEN - 1] = '\0';
+        ret = ipfilter_set_create(req->set.name, req->family);
+        if (ret >= 0)
+          {
+            req->set.index = ret;
+            ret = OK;
+          }
+        break;
+
+      case IP_SET_OP_DESTROY:
+        ret = ipfilter_set_destroy(req->set.index);
+        break;
+
+      case IP_SET_OP_FLUSH:
+        ret = ipfilter_set_flush(req->set.index);
+        break;
+
+      case IP_SET_OP_ADD:
+        ret = ipfilter_set_add(req->set.index, &req->addr);
+        break;
+
+      case IP_SET_OP_DEL:
+        ret = ipfilter_set_del(req->set.index, &req->addr);
+        break;
+
+      case IP_SET_OP_TEST:
+        ret = ipfilter_set_test(req->set.index, &req->addr);
+        break;
+
+      default:
+        ret = -EBADMSG;
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipt_set_sockopt
+ *
+ * Description:
+ *   The SO_IP_SET getsockopt() requests.
+ *
+ ****************************************************************************/
+
+int ipt_set_sockopt(FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct ip_set_req_get_set *get = value;
+  int ret;
+
+  if (*value_len < sizeof(unsigned int))
+    {
+      return -EINVAL;
+    }
+
+  if (get->op == IP_SET_OP_GET_BYNAME)
+    {
+      if (*value_len != sizeof(*get))
+        {
+          return -EINVAL;
+        }
+
+      get->set.name[IPSET_MAXNAMELEN - 1] = '\0';
+      ret = ipfilter_set_find(get->set.name);
+      get->set.index = ret >= 0 ? ret : IPSET_INVALID_ID;
+      return OK;
+    }
+
+  if (*value_len != sizeof(struct ip_set_req_adt))
+    {
+      return -EINVAL;
+    }
+
+  return ipt_set_adt(value);
+}
+
+#endif /* CONFIG_NET_IPFILTER_SET */
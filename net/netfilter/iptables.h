@@ -32,6 +32,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netfilter/ip_tables.h>
 #include <nuttx/net/netfilter/ip6_tables.h>
+#include <nuttx/net/netfilter/xt_set.h>
 
 #ifdef CONFIG_NET_IPTABLES
 
@@ -163,5 +164,41 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl);
 #  endif
 #endif
 
+/****************************************************************************
+ * Name: ipt_filter_counters
+ *
+ * Description:
+ *   Copy the hit counters of the filter rules into a copy of the entries,
+ *   e.g. for IPT_SO_GET_ENTRIES.
+ *
+ * Input Parameters:
+ *   repl    - The config applied to the filter table.
+ *   entries - The copy of repl->entries to fill.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER
+#  ifdef CONFIG_NET_IPv4
+void ipt_filter_counters(FAR const struct ipt_replace *repl,
+                         FAR struct ipt_entry *entries);
+#  endif
+#  ifdef CONFIG_NET_IPv6
+void ip6t_filter_counters(FAR const struct ip6t_replace *repl,
+                          FAR struct ip6t_entry *entries);
+#  endif
+#endif
+
+/****************************************************************************
+ * Name: ipt_set_sockopt
+ *
+ * Description:
+ *   The SO_IP_SET getsockopt() requests to manage the address sets.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFILTER_SET) && defined(CONFIG_NET_IPv4)
+int ipt_set_sockopt(FAR void *value, FAR socklen_t *value_len);
+#endif
+
 #endif /* CONFIG_NET_IPTABLES */
 #endif /* __NET_NETFILTER_IPTABLES_H */
@@ -178,6 +178,16 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* Produce the next batch of a dump.  pos counts the entries queued by the
+ * earlier batches and is advanced by the function.  Returns a negated
+ * errno value on failure, zero when the dump is complete and a positive
+ * value when more entries remain.
+ */
+
+typedef CODE int (*netlink_dump_t)(NETLINK_HANDLE handle,
+                                   FAR const struct nlmsghdr *req,
+                                   FAR unsigned int *pos);
+
 /* This connection structure describes the underlying state of the socket. */
 
 struct netlink_conn_s
@@ -202,6 +212,12 @@ struct netlink_conn_s
   /* Queued response data */
 
   sq_queue_t resplist;               /* Singly linked list of responses */
+
+  /* Dump in progress, continued when resplist drains */
+
+  netlink_dump_t dump;               /* Produces the next batch, or NULL */
+  struct nlmsghdr dumpreq;           /* The request being answered */
+  unsigned int dumppos;              /* Entries produced so far */
 };
 
 /* Standard attribute types to specify validation policy */
@@ -416,6 +432,43 @@ void netlink_notifier_signal(FAR struct netlink_conn_s *conn);
 int netlink_add_terminator(NETLINK_HANDLE handle,
                            FAR const struct nlmsghdr *req, int group);
 
+/****************************************************************************
+ * Name: netlink_dump_start
+ *
+ * Description:
+ *   Answer a request with a dump that is produced in batches.  The first
+ *   batch is queued immediately, the following ones each time the pending
+ *   responses have been read, and NLMSG_DONE after the last one.  Every
+ *   part carries NLM_F_MULTI.
+ *
+ * Input Parameters:
+ *   handle - The Netlink connection
+ *   req    - The request header of the dump
+ *   dump   - The function producing one batch
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int netlink_dump_start(NETLINK_HANDLE handle,
+                       FAR const struct nlmsghdr *req, netlink_dump_t dump);
+
+/****************************************************************************
+ * Name: netlink_dump_continue
+ *
+ * Description:
+ *   Produce the next batch of the dump in progress, if any, once the
+ *   pending responses have all been read.  Must be called without the
+ *   netlink lock held, the dump takes the locks of the table it walks.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int netlink_dump_continue(FAR struct netlink_conn_s *conn);
+
 /****************************************************************************
  * Name: netlink_tryget_response
  *
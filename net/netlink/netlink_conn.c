@@ -384,6 +384,90 @@ void netlink_add_broadcast(int group, FAR struct netlink_response_s *data)
     }
 }
 
+/****************************************************************************
+ * Name: netlink_dump_start
+ *
+ * Description:
+ *   Answer a request with a dump that is produced in batches.
+ *
+ ****************************************************************************/
+
+int netlink_dump_start(NETLINK_HANDLE handle,
+                       FAR const struct nlmsghdr *req, netlink_dump_t dump)
+{
+  FAR struct netlink_conn_s *conn = handle;
+
+  DEBUGASSERT(conn != NULL && req != NULL && dump != NULL);
+
+  /* A new request replaces any dump that was not read to the end */
+
+  netlink_lock();
+  conn->dump     = dump;
+  conn->dumpreq  = *req;
+  conn->dumpreq.nlmsg_flags |= NLM_F_MULTI;
+  conn->dumppos  = 0;
+  netlink_unlock();
+
+  return netlink_dump_continue(conn);
+}
+
+/****************************************************************************
+ * Name: netlink_dump_continue
+ *
+ * Description:
+ *   Produce the next batch of the dump in progress once the pending
+ *   responses have all been read.
+ *
+ ****************************************************************************/
+
+int netlink_dump_continue(FAR struct netlink_conn_s *conn)
+{
+  struct nlmsghdr req;
+  netlink_dump_t dump;
+  unsigned int pos;
+  int ret;
+
+  DEBUGASSERT(conn != NULL);
+
+  /* Claim the dump so that only one caller produces the batch */
+
+  netlink_lock();
+  dump = conn->dump;
+  if (dump == NULL || !sq_empty(&conn->resplist))
+    {
+      netlink_unlock();
+      return OK;
+    }
+
+  req        = conn->dumpreq;
+  pos        = conn->dumppos;
+  conn->dump = NULL;
+  netlink_unlock();
+
+  ret = dump(conn, &req, &pos);
+  if (ret > 0)
+    {
+      /* More entries remain, keep the dump unless it was replaced */
+
+      netlink_lock();
+      if (conn->dump == NULL)
+        {
+          conn->dump    = dump;
+          conn->dumppos = pos;
+        }
+
+      netlink_unlock();
+      return OK;
+    }
+  else if (ret < 0)
+    {
+      nerr("ERROR: Netlink dump failed: %d\n", ret);
+      return ret;
+    }
+
+  return netlink_add_terminator(conn, &req, 0);
+}
+
 /****************************************************************************
  * Name: netlink_tryget_response
  *
@@ -516,10 +600,11 @@ bool netlink_check_response(FAR struct netlink_conn_s *conn)
   DEBUGASSERT(conn != NULL);
 
   /* Check if the response is available.  It is not necessary to lock the
-   * network because the sq_peek() is an atomic operation.
+   * network because the sq_peek() is an atomic operation.  A dump in
+   * progress makes the next batch available to the reader.
    */
 
-  return (sq_peek(&conn->resplist) != NULL);
+  return (sq_peek(&conn->resplist) != NULL || conn->dump != NULL);
 }
 
 /****************************************************************************
@@ -45,6 +45,7 @@
 
 #include "netdev/netdev.h"
 #include "arp/arp.h"
+#include "ipforward/ipforward.h"
 #include "net/if_arp.h"
 #include "neighbor/neighbor.h"
 #include "route/route.h"
@@ -222,6 +223,17 @@ struct nlroute_info_s
   FAR const struct nlroute_sendto_request_s *req;
 };
 
+/* One batch of a routing table dump */
+
+struct nlroute_dump_s
+{
+  NETLINK_HANDLE handle;
+  FAR const struct nlroute_sendto_request_s *req;
+  FAR unsigned int *pos;        /* Entries queued by the earlier batches */
+  unsigned int index;           /* Entries visited by this batch */
+  unsigned int budget;          /* Entries left in this batch */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -812,9 +824,20 @@ netlink_get_ipv4_route(FAR const struct net_route_ipv4_s *route, int type,
 static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
                                       FAR void *arg)
 {
-  FAR struct nlroute_info_s *info = arg;
+  FAR struct nlroute_dump_s *info = arg;
   FAR struct netlink_response_s *resp;
 
+  /* Skip the entries sent earlier, stop when the batch is full */
+
+  if (info->index++ < *info->pos)
+    {
+      return OK;
+    }
+  else if (info->budget == 0)
+    {
+      return 1;
+    }
+
   resp = netlink_get_ipv4_route(route, RTM_NEWROUTE, info->req);
   if (resp == NULL)
     {
@@ -824,6 +847,8 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
   /* Finally, add the response to the list of pending responses */
 
   netlink_add_response(info->handle, resp);
+  (*info->pos)++;
+  info->budget--;
   return OK;
 }
 #endif
@@ -832,31 +857,28 @@ static int netlink_ipv4route_callback(FAR struct net_route_ipv4_s *route,
  * Name: netlink_list_ipv4_route
  *
  * Description:
- *   Dump a list of all network devices of the specified type.
+ *   Queue the next batch of a dump of the IPv4 routing table.
  *
  ****************************************************************************/
 
 #if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static int netlink_list_ipv4_route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+                                   FAR const struct nlmsghdr *req,
+                                   FAR unsigned int *pos)
 {
-  struct nlroute_info_s info;
-  int ret;
+  struct nlroute_dump_s info;
 
-  /* Visit each routing table entry */
+  /* Visit each routing table entry.  Only the header of the request is
+   * used to format the responses.
+   */
 
   info.handle = handle;
-  info.req    = req;
-
-  ret = net_foreachroute_ipv4(netlink_ipv4route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Terminate the routing table */
+  info.req    = (FAR const struct nlroute_sendto_request_s *)req;
+  info.pos    = pos;
+  info.index  = 0;
+  info.budget = CONFIG_NETLINK_DUMP_BATCH;
 
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return net_foreachroute_ipv4(netlink_ipv4route_callback, &info);
 }
 #endif
 
@@ -931,9 +953,20 @@ netlink_get_ipv6_route(FAR const struct net_route_ipv6_s *route, int type,
 static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
                                       FAR void *arg)
 {
-  FAR struct nlroute_info_s *info = arg;
+  FAR struct nlroute_dump_s *info = arg;
   FAR struct netlink_response_s *resp;
 
+  /* Skip the entries sent earlier, stop when the batch is full */
+
+  if (info->index++ < *info->pos)
+    {
+      return OK;
+    }
+  else if (info->budget == 0)
+    {
+      return 1;
+    }
+
   resp = netlink_get_ipv6_route(route, RTM_NEWROUTE, info->req);
   if (resp == NULL)
     {
@@ -943,40 +976,39 @@ static int netlink_ipv6route_callback(FAR struct net_route_ipv6_s *route,
   /* Finally, add the response to the list of pending responses */
 
   netlink_add_response(info->handle, resp);
+  (*info->pos)++;
+  info->budget--;
 
   return OK;
 }
 #endif
 
 /****************************************************************************
- * Name: netlink_get_ipv6route
+ * Name: netlink_list_ipv6_route
  *
  * Description:
- *   Dump a list of all network devices of the specified type.
+ *   Queue the next batch of a dump of the IPv6 routing table.
  *
  ****************************************************************************/
 
 #if defined(CONFIG_NET_IPv6) && !defined(CONFIG_NETLINK_DISABLE_GETROUTE)
 static int netlink_list_ipv6_route(NETLINK_HANDLE handle,
-                              FAR const struct nlroute_sendto_request_s *req)
+                                   FAR const struct nlmsghdr *req,
+                                   FAR unsigned int *pos)
 {
-  struct nlroute_info_s info;
-  int ret;
+  struct nlroute_dump_s info;
 
-  /* Visit each routing table entry */
+  /* Visit each routing table entry.  Only the header of the request is
+   * used to format the responses.
+   */
 
   info.handle = handle;
-  info.req    = req;
+  info.req    = (FAR const struct nlroute_sendto_request_s *)req;
+  info.pos    = pos;
+  info.index  = 0;
+  info.budget = CONFIG_NETLINK_DUMP_BATCH;
 
-  ret = net_foreachroute_ipv6(netlink_ipv6route_callback, &info);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  /* Terminate the routing table */
-
-  return netlink_add_terminator(handle, &req->hdr, 0);
+  return net_foreachroute_ipv6(netlink_ipv6route_callback, &info);
 }
 #endif
 
@@ -1020,6 +1052,7 @@ static int netlink_new_ipv4addr(NETLINK_HANDLE handle,
   netdev_lock(dev);
   dev->d_ipaddr  = nla_get_in_addr(tb[IFA_LOCAL]);
   dev->d_netmask = make_mask(ifm->ifa_prefixlen);
+  ipfwd_flow_flush();
 
   netlink_device_notify_ipaddr(dev, RTM_NEWADDR, AF_INET, &dev->d_ipaddr,
                                ifm->ifa_prefixlen);
@@ -1122,6 +1155,7 @@ static int netlink_del_ipv4addr(NETLINK_HANDLE handle,
   netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET, &dev->d_ipaddr,
                                net_ipv4_mask2pref(dev->d_netmask));
   dev->d_ipaddr  = 0;
+  ipfwd_flow_flush();
 
   netdev_unlock(dev);
 
@@ -1397,14 +1431,16 @@ ssize_t netlink_route_sendto(NETLINK_HANDLE handle,
 #ifdef CONFIG_NET_IPv4
         if (req->gen.rtgen_family == AF_INET)
           {
-            ret = netlink_list_ipv4_route(handle, req);
+            ret = netlink_dump_start(handle, &req->hdr,
+                                     netlink_list_ipv4_route);
           }
         else
 #endif
 #ifdef CONFIG_NET_IPv6
         if (req->gen.rtgen_family == AF_INET6)
           {
-            ret = netlink_list_ipv6_route(handle, req);
+            ret = netlink_dump_start(handle, &req->hdr,
+                                     netlink_list_ipv6_route);
           }
         else
 #endif
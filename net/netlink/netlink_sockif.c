@@ -684,6 +684,14 @@ static ssize_t netlink_recvmsg(FAR struct socket *psock,
       return -ENOTSUP;
     }
 
+  /* Queue the next batch of a dump in progress, if it was all read */
+
+  ret = netlink_dump_continue(psock->s_conn);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Find the response to this message.  The return value */
 
   entry = netlink_tryget_response(psock->s_conn);
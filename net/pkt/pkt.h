@@ -33,6 +33,15 @@
 
 #include <nuttx/net/net.h>
 
+#ifdef CONFIG_NET_PKT_MMAP
+#  include <nuttx/atomic.h>
+#  include <nuttx/mutex.h>
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  include <net/net_tstamp.h>
+#endif
+
 #ifdef CONFIG_NET_PKT
 
 /****************************************************************************
@@ -46,6 +55,19 @@
 #define pkt_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->sconn.list, &conn->sconn.list_tail)
 
+/* Whether received packets are stamped for the socket */
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  define pkt_rxtstamp_enabled(conn) \
+     (_SO_GETOPT((conn)->sconn.s_options, SO_TIMESTAMP) || \
+      _SO_GETOPT((conn)->sconn.s_options, SO_TIMESTAMPNS) || \
+      ((conn)->tsflags & SOF_TIMESTAMPING_RX_RECORD_MASK) != 0)
+#elif defined(CONFIG_NET_TIMESTAMP)
+#  define pkt_rxtstamp_enabled(conn) \
+     (_SO_GETOPT((conn)->sconn.s_options, SO_TIMESTAMP) || \
+      _SO_GETOPT((conn)->sconn.s_options, SO_TIMESTAMPNS))
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -64,6 +86,50 @@ struct pkt_poll_s
   FAR struct devif_callback_s *cb;   /* Needed to teardown the poll */
 };
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* One direction of a PACKET_MMAP ring */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;              /* First frame of the ring */
+  size_t       size;              /* Size of the ring in bytes */
+  uint32_t     block_size;        /* Size of one block */
+  uint32_t     frame_size;        /* Size of one frame */
+  uint32_t     frame_nr;          /* Number of frames, zero if no ring */
+  uint32_t     frames_per_block;  /* Frames in each block */
+  uint32_t     head;              /* Next frame the kernel will look at */
+};
+
+/* The RX and TX rings of a packet socket share one user accessible region,
+ * RX first, so that a single mmap() exposes both.  The region is reference
+ * counted by the socket and by each mapping so that it outlives a close()
+ * while still mapped.
+ */
+
+struct pkt_mmap_s
+{
+  atomic_t          crefs;        /* Socket plus active mappings */
+  mutex_t           txlock;       /* Serializes TX ring flushes */
+  uint32_t          drops;        /* RX frames lost since the last one */
+  size_t            size;         /* Size of the whole region */
+  FAR uint8_t      *base;         /* The region itself */
+  struct pkt_ring_s rx;
+  struct pkt_ring_s tx;
+};
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMP
+/* The receive timestamps kept ahead of a packet in the read-ahead queue */
+
+struct pkt_rxtstamp_s
+{
+  struct timespec sw;             /* Software timestamp, dev->d_rxtime */
+#ifdef CONFIG_NET_TIMESTAMPING
+  uint64_t        hw;             /* Hardware timestamp, zero if none */
+#endif
+};
+#endif
+
 struct pkt_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -98,14 +164,34 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_PKT_MMAP
+  FAR struct pkt_mmap_s *ring;    /* PACKET_RX_RING/PACKET_TX_RING */
+#endif
+
   FAR struct iob_s  *pendiob;     /* The iob currently being sent */
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* SO_TIMESTAMPING.  One transmit timestamp is outstanding at a time: a
+   * packet sent before the previous report was complete replaces it.
+   */
+
+  uint32_t           tsflags;     /* SOF_TIMESTAMPING_* */
+  uint32_t           tskey;       /* OPT_ID key of the next packet sent */
+  uint32_t           tsreqkey;    /* OPT_ID key of tsiob */
+  FAR struct iob_s  *tsiob;       /* Sent packet awaiting its NIC stamp */
+  struct timespec    tssw;        /* Software timestamp of tsiob */
+  bool               tsready;     /* tsreport is ready to be read */
+  uint32_t           tsreportkey; /* OPT_ID key of tsreport */
+
+  /* The completed transmit timestamp */
+
+  struct scm_timestamping tsreport;
+#endif
+
   /* The following is a list of poll structures of threads waiting for
    * socket events.
    */
@@ -305,6 +391,29 @@ uint32_t pkt_callback(FAR struct net_driver_s *dev,
 ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_recvmmsg
+ *
+ * Description:
+ *   Implements the socket recvmmsg interface for packet sockets, receiving
+ *   the whole batch under one hold of the connection and device locks.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of packets received, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+int pkt_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: pkt_find_device
  *
@@ -400,6 +509,31 @@ int pkt_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_sendmmsg
+ *
+ * Description:
+ *   Implements the socket sendmmsg interface for packet sockets with write
+ *   buffers: the batch is queued under one hold of the connection and
+ *   device locks, and the device driver is notified once.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   Messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, or a negated errno value if not even the
+ *   first one could be.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_PKT_WRITE_BUFFERS
+int pkt_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags);
+#endif
+
 #ifdef CONFIG_NET_PKTPROTO_OPTIONS
 /****************************************************************************
  * Name: pkt_getsockopt
@@ -463,6 +597,155 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+/****************************************************************************
+ * Name: pkt_tstamp_setsockopt
+ *
+ * Description:
+ *   Set the SO_TIMESTAMPING flags of a packet socket.  Setting
+ *   SOF_TIMESTAMPING_OPT_ID restarts the OPT_ID keys at zero.
+ *
+ ****************************************************************************/
+
+int pkt_tstamp_setsockopt(FAR struct pkt_conn_s *conn,
+                          FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: pkt_tstamp_txrequest
+ *
+ * Description:
+ *   Called when the packet in dev->d_iob is handed to the driver on behalf
+ *   of a packet socket: take the software transmit timestamp and ask the
+ *   NIC for the hardware one, as selected by SO_TIMESTAMPING.
+ *
+ * Assumptions:
+ *   Called from the network driver with the network locked.
+ *
+ ****************************************************************************/
+
+void pkt_tstamp_txrequest(FAR struct net_driver_s *dev,
+                          FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_tstamp_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): return the completed transmit
+ *   timestamp as an SCM_TIMESTAMPING control message, followed by a
+ *   PACKET_TX_TIMESTAMP control message with the struct sock_extended_err
+ *   naming the packet.  No payload is returned.  Never blocks.
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if there is nothing to report.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_tstamp_recverr(FAR struct pkt_conn_s *conn,
+                           FAR struct msghdr *msg);
+
+#  define pkt_tstamp_pending(conn) ((conn)->tsready)
+#else
+#  define pkt_tstamp_txrequest(dev, conn)
+#  define pkt_tstamp_pending(conn) false
+#endif
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_mmap_setring
+ *
+ * Description:
+ *   Implement PACKET_RX_RING and PACKET_TX_RING: replace (or, with a zero
+ *   tp_block_nr, release) one ring of the socket.  This fails with -EBUSY
+ *   while the rings are mapped.
+ *
+ * Input Parameters:
+ *   conn   - The packet connection
+ *   option - PACKET_RX_RING or PACKET_TX_RING
+ *   req    - The requested ring geometry
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+struct tpacket_req; /* Forward reference */
+
+int pkt_mmap_setring(FAR struct pkt_conn_s *conn, int option,
+                     FAR const struct tpacket_req *req);
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   The si_mmap method of packet sockets: map the RX and TX rings, which
+ *   must be mapped as a whole, into the caller's address space.
+ *
+ ****************************************************************************/
+
+int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_mmap_release
+ *
+ * Description:
+ *   Drop the socket's reference to its rings when the connection is
+ *   closed.  Rings still mapped are freed by the last munmap().
+ *
+ ****************************************************************************/
+
+void pkt_mmap_release(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_mmap_input
+ *
+ * Description:
+ *   Store the packet in dev->d_iob in the next frame of the RX ring.
+ *
+ * Returned Value:
+ *   OK if the frame was stored, -ENOBUFS if the ring was full and the frame
+ *   was dropped, or -ENOENT if the socket has no RX ring.
+ *
+ * Assumptions:
+ *   Called from pkt_input() with the device locked.
+ *
+ ****************************************************************************/
+
+int pkt_mmap_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_mmap_rxready
+ *
+ * Description:
+ *   Return true if the RX ring holds frames not yet released by the
+ *   application, i.e. poll() should report POLLIN.
+ *
+ ****************************************************************************/
+
+bool pkt_mmap_rxready(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_mmap_send
+ *
+ * Description:
+ *   Flush the TX ring: a send() with no data on a socket with a TX ring
+ *   transmits every frame marked TP_STATUS_SEND_REQUEST, in ring order,
+ *   through pkt_sendmsg().  The destination in 'msg', if any, applies to
+ *   all of them.
+ *
+ * Returned Value:
+ *   The number of bytes sent, a negated errno value if the first frame
+ *   could not be sent, or -ENOENT if this is not a TX ring flush.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_mmap_send(FAR struct socket *psock,
+                      FAR const struct msghdr *msg, int flags);
+#else
+#  define pkt_mmap_release(conn)
+#  define pkt_mmap_rxready(conn) false
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
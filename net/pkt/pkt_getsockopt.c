@@ -81,6 +81,22 @@ int pkt_getsockopt(FAR struct socket *psock, int level, int option,
 
   DEBUGASSERT(value != NULL && value_len != NULL);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  if (level == SOL_SOCKET && option == SO_TIMESTAMPING)
+    {
+      FAR struct pkt_conn_s *conn = psock->s_conn;
+
+      if (*value_len < sizeof(int))
+        {
+          return -EINVAL;
+        }
+
+      *(FAR int *)value = conn->tsflags;
+      *value_len        = sizeof(int);
+      return OK;
+    }
+#endif
+
   if (level != SOL_PACKET)
     {
       return -ENOPROTOOPT;
@@ -71,18 +71,24 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
     }
 
 #ifdef CONFIG_NET_TIMESTAMP
-  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) ||
-      _SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMPNS))
+  if (pkt_rxtstamp_enabled(conn))
     {
-      ret = iob_trycopyin(iob, (FAR const uint8_t *)&dev->d_rxtime,
-                          sizeof(struct timespec), 0, true);
-      if (ret != sizeof(struct timespec))
+      struct pkt_rxtstamp_s ts;
+
+      ts.sw = dev->d_rxtime;
+#ifdef CONFIG_NET_TIMESTAMPING
+      ts.hw = dev->d_iob->io_tstamp;
+#endif
+
+      ret = iob_trycopyin(iob, (FAR const uint8_t *)&ts, sizeof(ts), 0,
+                          true);
+      if (ret != sizeof(ts))
         {
           nerr("ERROR: Failed to write timestamp: %d\n", ret);
           goto errout;
         }
 
-      iob_reserve(iob, sizeof(struct timespec));
+      iob_reserve(iob, sizeof(ts));
     }
 #endif
 
@@ -174,13 +180,34 @@ static int pkt_in(FAR struct net_driver_s *dev)
 #if defined(CONFIG_NET_TIMESTAMP) && !defined(CONFIG_ARCH_HAVE_NETDEV_TIMESTAMP)
       /* Get system as timestamp if no hardware timestamp */
 
-      if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) ||
-          _SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMPNS))
+      if (pkt_rxtstamp_enabled(conn))
         {
           clock_gettime(CLOCK_REALTIME, &dev->d_rxtime);
         }
 #endif /* CONFIG_NET_TIMESTAMP */
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* With an RX ring the packet goes to the ring, or is dropped if the
+       * ring is full; the callback then only serves to wake up poll().
+       */
+
+      ret = pkt_mmap_input(dev, conn);
+      if (ret != -ENOENT)
+        {
+          if (ret == OK)
+            {
+              dev->d_appdata = dev->d_buf;
+              dev->d_sndlen  = 0;
+              pkt_callback(dev, conn, PKT_NEWDATA);
+            }
+
+          pkt_conn_list_unlock();
+          return OK;
+        }
+
+      ret = OK;
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
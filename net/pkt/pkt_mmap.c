@@ -0,0 +1,585 @@
+/****************************************************************************
+ * net/pkt/pkt_mmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/packet.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_MMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Offsets inside a ring frame */
+
+#define PKT_MMAP_SLLOFF   TPACKET_ALIGN(sizeof(struct tpacket_hdr))
+#define PKT_MMAP_MACOFF   TPACKET_ALIGN(TPACKET_HDRLEN)
+#define PKT_MMAP_TXOFF    PKT_MMAP_SLLOFF
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_frame
+ *
+ * Description:
+ *   Return the header of frame 'index' of a ring.
+ *
+ ****************************************************************************/
+
+static FAR struct tpacket_hdr *pkt_ring_frame(FAR struct pkt_ring_s *ring,
+                                              uint32_t index)
+{
+  uint32_t block = index / ring->frames_per_block;
+  uint32_t frame = index % ring->frames_per_block;
+
+  return (FAR struct tpacket_hdr *)(ring->base +
+                                    (size_t)block * ring->block_size +
+                                    (size_t)frame * ring->frame_size);
+}
+
+/* The status word is shared with the application, which polls it */
+
+static unsigned long pkt_ring_getstatus(FAR struct tpacket_hdr *hdr)
+{
+  return *(FAR volatile unsigned long *)&hdr->tp_status;
+}
+
+static void pkt_ring_setstatus(FAR struct tpacket_hdr *hdr,
+                               unsigned long status)
+{
+  /* Everything else in the frame must be visible before ownership
+   * changes hands.
+   */
+
+  SMP_WMB();
+  *(FAR volatile unsigned long *)&hdr->tp_status = status;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Validate a tpacket_req and describe the ring it asks for.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_setup(FAR struct pkt_ring_s *ring,
+                          FAR const struct tpacket_req *req)
+{
+  memset(ring, 0, sizeof(*ring));
+
+  if (req->tp_block_nr == 0)
+    {
+      return OK;
+    }
+
+  if (req->tp_block_size == 0 ||
+      req->tp_frame_size < TPACKET_HDRLEN ||
+      (req->tp_frame_size & (TPACKET_ALIGNMENT - 1)) != 0 ||
+      req->tp_block_size < req->tp_frame_size ||
+      req->tp_block_nr > SIZE_MAX / req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  ring->frames_per_block = req->tp_block_size / req->tp_frame_size;
+  if ((uint64_t)ring->frames_per_block * req->tp_block_nr !=
+      req->tp_frame_nr)
+    {
+      return -EINVAL;
+    }
+
+  ring->size       = (size_t)req->tp_block_size * req->tp_block_nr;
+  ring->block_size = req->tp_block_size;
+  ring->frame_size = req->tp_frame_size;
+  ring->frame_nr   = req->tp_frame_nr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap_addref / pkt_mmap_put
+ ****************************************************************************/
+
+static void pkt_mmap_addref(FAR struct pkt_mmap_s *ring)
+{
+  atomic_fetch_add(&ring->crefs, 1);
+}
+
+static void pkt_mmap_put(FAR struct pkt_mmap_s *ring)
+{
+  if (atomic_fetch_sub(&ring->crefs, 1) == 1)
+    {
+      nxmutex_destroy(&ring->txlock);
+      kumm_free(ring->base);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_munmap
+ ****************************************************************************/
+
+static int pkt_munmap(FAR struct task_group_s *group,
+                      FAR struct mm_map_entry_s *entry,
+                      FAR void *start, size_t length)
+{
+  FAR struct pkt_mmap_s *ring = entry->priv.p;
+  int ret;
+
+  /* The rings are only ever unmapped as a whole */
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  pkt_mmap_put(ring);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_mmap_setring
+ *
+ * Description:
+ *   Implement PACKET_RX_RING and PACKET_TX_RING: replace (or, with a zero
+ *   tp_block_nr, release) one ring of the socket.  This fails with -EBUSY
+ *   while the rings are mapped.
+ *
+ * Input Parameters:
+ *   conn   - The packet connection
+ *   option - PACKET_RX_RING or PACKET_TX_RING
+ *   req    - The requested ring geometry
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int pkt_mmap_setring(FAR struct pkt_conn_s *conn, int option,
+                     FAR const struct tpacket_req *req)
+{
+  FAR struct pkt_mmap_s *oldring;
+  FAR struct pkt_mmap_s *newring = NULL;
+  struct pkt_ring_s rx;
+  struct pkt_ring_s tx;
+  int ret;
+
+  ret = pkt_ring_setup(option == PACKET_RX_RING ? &rx : &tx, req);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  conn_lock(&conn->sconn);
+
+  /* Frames already handed out through a mapping cannot be moved */
+
+  oldring = conn->ring;
+  if (oldring != NULL && atomic_read(&oldring->crefs) > 1)
+    {
+      conn_unlock(&conn->sconn);
+      return -EBUSY;
+    }
+
+  /* Keep the geometry of the other direction */
+
+  if (option == PACKET_RX_RING)
+    {
+      if (oldring != NULL)
+        {
+          tx = oldring->tx;
+        }
+      else
+        {
+          memset(&tx, 0, sizeof(tx));
+        }
+    }
+  else
+    {
+      if (oldring != NULL)
+        {
+          rx = oldring->rx;
+        }
+      else
+        {
+          memset(&rx, 0, sizeof(rx));
+        }
+    }
+
+  if (rx.size + tx.size > 0)
+    {
+      newring = kmm_zalloc(sizeof(struct pkt_mmap_s));
+      if (newring == NULL)
+        {
+          conn_unlock(&conn->sconn);
+          return -ENOMEM;
+        }
+
+      /* The frames are read and written directly by the application, so
+       * they come from the user heap.  Zeroed frames are TP_STATUS_KERNEL
+       * (RX) and TP_STATUS_AVAILABLE (TX).
+       */
+
+      newring->size = rx.size + tx.size;
+      newring->base = kumm_zalloc(newring->size);
+      if (newring->base == NULL)
+        {
+          kmm_free(newring);
+          conn_unlock(&conn->sconn);
+          return -ENOMEM;
+        }
+
+      rx.base = newring->base;
+      rx.head = 0;
+      tx.base = newring->base + rx.size;
+      tx.head = 0;
+
+      newring->rx = rx;
+      newring->tx = tx;
+      atomic_set(&newring->crefs, 1);
+      nxmutex_init(&newring->txlock);
+    }
+
+  conn->ring = newring;
+  conn_unlock(&conn->sconn);
+
+  if (oldring != NULL)
+    {
+      pkt_mmap_put(oldring);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   The si_mmap method of packet sockets: map the RX and TX rings, which
+ *   must be mapped as a whole, into the caller's address space.
+ *
+ ****************************************************************************/
+
+int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_mmap_s *ring;
+  int ret = -EINVAL;
+
+  conn_lock(&conn->sconn);
+
+  ring = conn->ring;
+  if (ring != NULL && map->offset == 0 && map->length == ring->size)
+    {
+      map->vaddr  = ring->base;
+      map->priv.p = ring;
+      map->munmap = pkt_munmap;
+
+      pkt_mmap_addref(ring);
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret < 0)
+        {
+          pkt_mmap_put(ring);
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap_release
+ *
+ * Description:
+ *   Drop the socket's reference to its rings when the connection is
+ *   closed.  Rings still mapped are freed by the last munmap().
+ *
+ ****************************************************************************/
+
+void pkt_mmap_release(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_mmap_s *ring;
+
+  conn_lock(&conn->sconn);
+  ring = conn->ring;
+  conn->ring = NULL;
+  conn_unlock(&conn->sconn);
+
+  if (ring != NULL)
+    {
+      pkt_mmap_put(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_mmap_input
+ *
+ * Description:
+ *   Store the packet in dev->d_iob in the next frame of the RX ring.
+ *
+ * Returned Value:
+ *   OK if the frame was stored, -ENOBUFS if the ring was full and the frame
+ *   was dropped, or -ENOENT if the socket has no RX ring.
+ *
+ * Assumptions:
+ *   Called from pkt_input() with the device locked.
+ *
+ ****************************************************************************/
+
+int pkt_mmap_input(FAR struct net_driver_s *dev,
+                   FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_mmap_s *ring;
+  FAR struct tpacket_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  unsigned long status;
+  int llhdrlen = NET_LL_HDRLEN(dev);
+  int ret;
+
+  conn_lock(&conn->sconn);
+
+  ring = conn->ring;
+  if (ring == NULL || ring->rx.frame_nr == 0)
+    {
+      conn_unlock(&conn->sconn);
+      return -ENOENT;
+    }
+
+  /* The application has not released the next frame yet: the ring is
+   * full.  Drop the packet and flag the loss on the next stored frame.
+   */
+
+  hdr = pkt_ring_frame(&ring->rx, ring->rx.head);
+  if (pkt_ring_getstatus(hdr) != TP_STATUS_KERNEL)
+    {
+      ring->drops++;
+      conn_unlock(&conn->sconn);
+      return -ENOBUFS;
+    }
+
+  ret = iob_copyout((FAR uint8_t *)hdr + PKT_MMAP_MACOFF, dev->d_iob,
+                    MIN(dev->d_len, ring->rx.frame_size - PKT_MMAP_MACOFF),
+                    -llhdrlen);
+  if (ret < 0)
+    {
+      conn_unlock(&conn->sconn);
+      return ret;
+    }
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_snaplen = ret;
+  hdr->tp_mac     = PKT_MMAP_MACOFF;
+  hdr->tp_net     = PKT_MMAP_MACOFF + llhdrlen;
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_usec    = ts.tv_nsec / NSEC_PER_USEC;
+
+  sll = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr + PKT_MMAP_SLLOFF);
+  memset(sll, 0, sizeof(*sll));
+  sll->sll_family  = AF_PACKET;
+  sll->sll_ifindex = dev->d_ifindex;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET && ret >= ETH_HDRLEN)
+    {
+      FAR struct eth_hdr_s *eth =
+        (FAR struct eth_hdr_s *)((FAR uint8_t *)hdr + PKT_MMAP_MACOFF);
+
+      sll->sll_protocol = eth->type;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, eth->src, ETHER_ADDR_LEN);
+    }
+#endif
+
+  status = TP_STATUS_USER;
+  if (ring->drops > 0)
+    {
+      status |= TP_STATUS_LOSING;
+      ring->drops = 0;
+    }
+
+  pkt_ring_setstatus(hdr, status);
+
+  if (++ring->rx.head >= ring->rx.frame_nr)
+    {
+      ring->rx.head = 0;
+    }
+
+  conn_unlock(&conn->sconn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap_rxready
+ *
+ * Description:
+ *   Return true if the RX ring holds frames not yet released by the
+ *   application, i.e. poll() should report POLLIN.
+ *
+ ****************************************************************************/
+
+bool pkt_mmap_rxready(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_mmap_s *ring = conn->ring;
+  uint32_t prev;
+
+  if (ring == NULL || ring->rx.frame_nr == 0)
+    {
+      return false;
+    }
+
+  /* The frame most recently filled is the last one still owned by the
+   * application if any is.
+   */
+
+  prev = ring->rx.head == 0 ? ring->rx.frame_nr - 1 : ring->rx.head - 1;
+  return pkt_ring_getstatus(pkt_ring_frame(&ring->rx, prev)) !=
+         TP_STATUS_KERNEL;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap_send
+ *
+ * Description:
+ *   Flush the TX ring: a send() with no data on a socket with a TX ring
+ *   transmits every frame marked TP_STATUS_SEND_REQUEST, in ring order,
+ *   through pkt_sendmsg().  The destination in 'msg', if any, applies to
+ *   all of them.
+ *
+ * Returned Value:
+ *   The number of bytes sent, a negated errno value if the first frame
+ *   could not be sent, or -ENOENT if this is not a TX ring flush.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_mmap_send(FAR struct socket *psock,
+                      FAR const struct msghdr *msg, int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_mmap_s *ring;
+  FAR struct tpacket_hdr *hdr;
+  struct msghdr txmsg;
+  struct iovec iov;
+  ssize_t total = 0;
+  ssize_t ret = 0;
+  uint32_t n;
+
+  if (msg->msg_iovlen > 1 ||
+      (msg->msg_iovlen == 1 && msg->msg_iov->iov_len > 0))
+    {
+      return -ENOENT;
+    }
+
+  conn_lock(&conn->sconn);
+  ring = conn->ring;
+  if (ring == NULL || ring->tx.frame_nr == 0)
+    {
+      conn_unlock(&conn->sconn);
+      return -ENOENT;
+    }
+
+  pkt_mmap_addref(ring);
+  conn_unlock(&conn->sconn);
+
+  nxmutex_lock(&ring->txlock);
+
+  txmsg = *msg;
+  txmsg.msg_iov    = &iov;
+  txmsg.msg_iovlen = 1;
+
+  for (n = 0; n < ring->tx.frame_nr; n++)
+    {
+      hdr = pkt_ring_frame(&ring->tx, ring->tx.head);
+      if (pkt_ring_getstatus(hdr) != TP_STATUS_SEND_REQUEST)
+        {
+          break;
+        }
+
+      /* An empty frame would be taken for another ring flush */
+
+      if (hdr->tp_len == 0 ||
+          hdr->tp_len > ring->tx.frame_size - PKT_MMAP_TXOFF)
+        {
+          pkt_ring_setstatus(hdr, TP_STATUS_WRONG_FORMAT);
+          ret = -EINVAL;
+        }
+      else
+        {
+          pkt_ring_setstatus(hdr, TP_STATUS_SENDING);
+
+          iov.iov_base = (FAR uint8_t *)hdr + PKT_MMAP_TXOFF;
+          iov.iov_len  = hdr->tp_len;
+
+          ret = pkt_sendmsg(psock, &txmsg, flags);
+          if (ret < 0)
+            {
+              /* Leave the frame queued for the next flush */
+
+              pkt_ring_setstatus(hdr, TP_STATUS_SEND_REQUEST);
+              break;
+            }
+
+          total += ret;
+          pkt_ring_setstatus(hdr, TP_STATUS_AVAILABLE);
+        }
+
+      if (++ring->tx.head >= ring->tx.frame_nr)
+        {
+          ring->tx.head = 0;
+        }
+    }
+
+  nxmutex_unlock(&ring->txlock);
+  pkt_mmap_put(ring);
+
+  return total > 0 ? total : ret;
+}
+
+#endif /* CONFIG_NET_PKT_MMAP */
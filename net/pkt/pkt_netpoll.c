@@ -134,6 +134,13 @@ static uint32_t pkt_poll_eventhandler(FAR struct net_driver_s *dev,
           eventset |= POLLOUT;
         }
 
+      /* Completed transmit timestamps are reported as POLLERR */
+
+      if (pkt_tstamp_pending(info->conn))
+        {
+          eventset |= POLLERR;
+        }
+
       /* Awaken the caller of poll() is requested event occurred. */
 
       poll_notify(&info->fds, 1, eventset);
@@ -245,7 +252,8 @@ int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
   /* Check for read data availability now */
 
-  if (iob_peek_queue(&conn->readahead) != NULL)
+  if (iob_peek_queue(&conn->readahead) != NULL ||
+      pkt_mmap_rxready(conn))
     {
       /* Normal data may be read without blocking. */
 
@@ -261,6 +269,11 @@ int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLWRNORM;
     }
 
+  if (pkt_tstamp_pending(conn))
+    {
+      eventset |= POLLERR;
+    }
+
   /* Check if any requested events are already in effect */
 
   poll_notify(&fds, 1, eventset);
@@ -39,6 +39,7 @@
 
 #include <arch/irq.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -86,22 +87,46 @@ struct pkt_recvfrom_s
 
 #ifdef CONFIG_NET_TIMESTAMP
 static void pkt_store_cmsg_timestamp(FAR struct pkt_recvfrom_s *pstate,
-                                     FAR struct timespec *timestamp)
+                                     FAR struct pkt_rxtstamp_s *timestamp)
 {
+  FAR struct pkt_conn_s *conn = pstate->pr_conn;
   FAR struct msghdr *msg = pstate->pr_msg;
   struct timeval tv;
 
-  if (_SO_GETOPT(pstate->pr_conn->sconn.s_options, SO_TIMESTAMPNS))
+  if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMPNS))
     {
-      cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMPNS, timestamp,
+      cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMPNS, &timestamp->sw,
                   sizeof(struct timespec));
     }
-  else
+  else if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP))
     {
-      TIMESPEC_TO_TIMEVAL(&tv, timestamp);
+      TIMESPEC_TO_TIMEVAL(&tv, &timestamp->sw);
       cmsg_append(msg, SOL_SOCKET, SO_TIMESTAMP, &tv,
                   sizeof(struct timeval));
     }
+
+#ifdef CONFIG_NET_TIMESTAMPING
+  if ((conn->tsflags & SOF_TIMESTAMPING_RX_RECORD_MASK) != 0)
+    {
+      struct scm_timestamping tss;
+
+      memset(&tss, 0, sizeof(tss));
+      if ((conn->tsflags & SOF_TIMESTAMPING_RX_SOFTWARE) != 0 &&
+          (conn->tsflags & SOF_TIMESTAMPING_SOFTWARE) != 0)
+        {
+          tss.ts[0] = timestamp->sw;
+        }
+
+      if ((conn->tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0 &&
+          timestamp->hw != 0)
+        {
+          tss.ts[2].tv_sec  = timestamp->hw / NSEC_PER_SEC;
+          tss.ts[2].tv_nsec = timestamp->hw % NSEC_PER_SEC;
+        }
+
+      cmsg_append(msg, SOL_SOCKET, SCM_TIMESTAMPING, &tss, sizeof(tss));
+    }
+#endif
 }
 #endif
 
@@ -160,10 +185,15 @@ static void pkt_recvfrom_newdata(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_TIMESTAMP
   /* Unpack stored timestamp if SO_TIMESTAMP socket option is enabled */
 
-  if (_SO_GETOPT(pstate->pr_conn->sconn.s_options, SO_TIMESTAMP) ||
-      _SO_GETOPT(pstate->pr_conn->sconn.s_options, SO_TIMESTAMPNS))
+  if (pkt_rxtstamp_enabled(pstate->pr_conn))
     {
-      pkt_store_cmsg_timestamp(pstate, &dev->d_rxtime);
+      struct pkt_rxtstamp_s ts;
+
+      ts.sw = dev->d_rxtime;
+#ifdef CONFIG_NET_TIMESTAMPING
+      ts.hw = dev->d_iob->io_tstamp;
+#endif
+      pkt_store_cmsg_timestamp(pstate, &ts);
     }
 #endif
 
@@ -389,14 +419,12 @@ static inline void pkt_readahead(FAR struct pkt_recvfrom_s *pstate)
        * is enabled
        */
 
-      if (_SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMP) ||
-          _SO_GETOPT(conn->sconn.s_options, SO_TIMESTAMPNS))
+      if (pkt_rxtstamp_enabled(conn))
         {
-          struct timespec ts;
-          recvlen = iob_copyout((FAR uint8_t *)&ts, iob,
-                                sizeof(struct timespec),
-                                -sizeof(struct timespec));
-          DEBUGASSERT(recvlen == sizeof(struct timespec));
+          struct pkt_rxtstamp_s ts;
+          recvlen = iob_copyout((FAR uint8_t *)&ts, iob, sizeof(ts),
+                                -(int)sizeof(ts));
+          DEBUGASSERT(recvlen == sizeof(ts));
 
           pkt_store_cmsg_timestamp(pstate, &ts);
         }
@@ -441,44 +469,33 @@ static inline void pkt_readahead(FAR struct pkt_recvfrom_s *pstate)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: pkt_recvmsg
+ * Name: pkt_recvmsg_locked
  *
  * Description:
- *   Implements the socket recvmsg interface for the case of the AF_INET
- *   and AF_INET6 address families.  pkt_recvmsg() receives messages from
- *   a socket, and may be used to receive data on a socket whether or not it
- *   is connection-oriented.
- *
- *   If 'msg_name' is not NULL, and the underlying protocol provides the
- *   source address, this source address is filled in.  The argument
- *   'msg_namelen' is initialized to the size of the buffer associated with
- *   msg_name, and modified on return to indicate the actual size of the
- *   address stored there.
+ *   Receive one packet into msg, waiting for it unless the socket is
+ *   non-blocking or MSG_DONTWAIT is set.
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   dev      The device bound to the socket
  *   msg      Buffer to receive the message
  *   flags    Receive flags
  *
  * Returned Value:
- *   On success, returns the number of characters received. If no data is
- *   available to be received and the peer has performed an orderly shutdown,
- *   recvmsg() will return 0.  Otherwise, on errors, a negated errno value is
- *   returned (see recvmsg() for the list of appropriate error values).
+ *   The number of bytes received, or a negated errno value.
+ *
+ * Assumptions:
+ *   The caller holds the connection and device locks.
  *
  ****************************************************************************/
 
-ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
-                    int flags)
+static ssize_t pkt_recvmsg_locked(FAR struct socket *psock,
+                                  FAR struct net_driver_s *dev,
+                                  FAR struct msghdr *msg, int flags)
 {
   FAR struct sockaddr *from = msg->msg_name;
   FAR socklen_t *fromlen = &msg->msg_namelen;
   FAR struct pkt_conn_s *conn = psock->s_conn;
-  FAR struct net_driver_s *dev;
   struct pkt_recvfrom_s state;
   ssize_t ret = 0;
 
@@ -496,20 +513,6 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       return -ENOTSUP;
     }
 
-  if (psock->s_type != SOCK_DGRAM && psock->s_type != SOCK_RAW)
-    {
-      nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
-      return -ENOSYS;
-    }
-
-  /* Get the device driver that will service this transfer */
-
-  dev  = pkt_find_device(conn);
-  if (dev == NULL)
-    {
-      return -ENODEV;
-    }
-
   /* Perform the packet recvfrom() operation */
 
   /* Initialize the state structure.  This is done with the network
@@ -518,8 +521,6 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 
   pkt_recvfrom_initialize(conn, msg, &state, psock->s_type);
 
-  conn_dev_lock(&conn->sconn, dev);
-
   /* Check if there is buffered read-ahead data for this socket.  We may have
    * already received the response to previous command.
    */
@@ -580,11 +581,167 @@ ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
         }
     }
 
-  conn_dev_unlock(&conn->sconn, dev);
-
   pkt_recvfrom_uninitialize(&state);
 
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_recvmsg
+ *
+ * Description:
+ *   Implements the socket recvmsg interface for the case of the AF_INET
+ *   and AF_INET6 address families.  pkt_recvmsg() receives messages from
+ *   a socket, and may be used to receive data on a socket whether or not it
+ *   is connection-oriented.
+ *
+ *   If 'msg_name' is not NULL, and the underlying protocol provides the
+ *   source address, this source address is filled in.  The argument
+ *   'msg_namelen' is initialized to the size of the buffer associated with
+ *   msg_name, and modified on return to indicate the actual size of the
+ *   address stored there.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msg      Buffer to receive the message
+ *   flags    Receive flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received. If no data is
+ *   available to be received and the peer has performed an orderly shutdown,
+ *   recvmsg() will return 0.  Otherwise, on errors, a negated errno value is
+ *   returned (see recvmsg() for the list of appropriate error values).
+ *
+ ****************************************************************************/
+
+ssize_t pkt_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                    int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  ssize_t ret;
+
+  if (psock->s_type != SOCK_DGRAM && psock->s_type != SOCK_RAW)
+    {
+      nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
+      return -ENOSYS;
+    }
+
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* Transmit timestamps are read from the error queue */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      return pkt_tstamp_recverr(conn, msg);
+    }
+#endif
+
+  /* Get the device driver that will service this transfer */
+
+  dev  = pkt_find_device(conn);
+  if (dev == NULL)
+    {
+      return -ENODEV;
+    }
+
+  conn_dev_lock(&conn->sconn, dev);
+  ret = pkt_recvmsg_locked(psock, dev, msg, flags);
+  conn_dev_unlock(&conn->sconn, dev);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of packets under one hold of the connection and device
+ *   locks: the read-ahead queue is drained into successive messages and
+ *   only an empty queue makes the caller wait.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Buffers to receive the messages
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of packets received, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+int pkt_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR const struct timespec *timeout)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  FAR struct msghdr *msg;
+  unsigned long controllen;
+  FAR void *control;
+  clock_t end = 0;
+  unsigned int i;
+  ssize_t ret = 0;
+
+  if (psock->s_type != SOCK_DGRAM && psock->s_type != SOCK_RAW)
+    {
+      nerr("ERROR: Unsupported socket type: %d\n", psock->s_type);
+      return -ENOSYS;
+    }
+
+  dev = pkt_find_device(conn);
+  if (dev == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (timeout != NULL)
+    {
+      end = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  conn_dev_lock(&conn->sconn, dev);
+
+  for (i = 0; i < vlen; i++)
+    {
+      if (i > 0 && timeout != NULL &&
+          clock_compare(end, clock_systime_ticks()))
+        {
+          break;
+        }
+
+      /* Return the true control message length like psock_recvmsg() */
+
+      msg        = &msgvec[i].msg_hdr;
+      control    = msg->msg_control;
+      controllen = msg->msg_controllen;
+
+      ret = pkt_recvmsg_locked(psock, dev, msg, flags);
+
+      msg->msg_control    = control;
+      msg->msg_controllen = controllen - msg->msg_controllen;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  conn_dev_unlock(&conn->sconn, dev);
+
+  return i > 0 ? i : ret;
+}
+
 #endif /* CONFIG_NET */
@@ -137,6 +137,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       netdev_iob_replace(dev, iob);
       conn->pendiob = iob;
+      pkt_tstamp_txrequest(dev, conn);
 
       /* Get the amount of data that we can send in the next packet.
        * We will send either the remaining data in the buffer I/O
@@ -182,55 +183,43 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: pkt_sendmsg
+ * Name: pkt_sendmsg_locked
  *
  * Description:
- *   The pkt_sendmsg() call may be used only when the packet socket is in
- *   a connected state (so that the intended recipient is known).
+ *   Queue one packet for sending.  The device driver is not notified.
  *
  * Input Parameters:
  *   psock    An instance of the internal socket structure.
- *   msg      Message to send
+ *   dev      The device that will send the packet
+ *   msg      Message to send, already checked by pkt_sendmsg_is_valid()
  *   flags    Send flags
  *
  * Returned Value:
- *   On success, returns the number of characters sent. On error, a negated
- *   errno value is returned (see sendmsg() for the complete list of return
- *   values.
+ *   The number of characters queued, or a negated errno value.
+ *
+ * Assumptions:
+ *   The caller holds the connection and device locks.
  *
  ****************************************************************************/
 
-ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
-                    int flags)
+static ssize_t pkt_sendmsg_locked(FAR struct socket *psock,
+                                  FAR struct net_driver_s *dev,
+                                  FAR const struct msghdr *msg, int flags)
 {
   FAR const void *buf = msg->msg_iov->iov_base;
   size_t len = msg->msg_iov->iov_len;
   FAR struct sockaddr_ll *addr = msg->msg_name;
-  FAR struct net_driver_s *dev;
-  FAR struct pkt_conn_s *conn;
+  FAR struct pkt_conn_s *conn = psock->s_conn;
   FAR struct iob_s *iob;
   bool nonblock;
   int offset = 0;
   int ret = OK;
 
-  /* Validity check */
-
-  ret = pkt_sendmsg_is_valid(psock, msg, &dev);
-  if (ret != OK)
-    {
-      return ret;
-    }
-
   if (len <= 0)
     {
       return 0;
     }
 
-  conn = psock->s_conn;
   if (psock->s_type == SOCK_DGRAM)
     {
       /* Set the interface index for devif_poll can match the conn */
@@ -238,7 +227,6 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
       conn->ifindex = addr->sll_ifindex;
     }
 
-  conn_dev_lock(&conn->sconn, dev);
   nonblock = _SS_ISNONBLOCK(conn->sconn.s_flags) ||
              (flags & MSG_DONTWAIT) != 0;
 
@@ -250,8 +238,7 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
       if (nonblock)
         {
           nerr("ERROR: Buffer overflow\n");
-          ret = -EAGAIN;
-          goto errout_with_lock;
+          return -EAGAIN;
         }
 
       ret = conn_dev_sem_timedwait(&conn->sndsem, false,
@@ -259,7 +246,7 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
                                    &conn->sconn, dev);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
     }
 #endif
@@ -279,16 +266,7 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
 
       nerr("ERROR: Failed to allocate write buffer\n");
 
-      if (nonblock)
-        {
-          ret = -EAGAIN;
-        }
-      else
-        {
-          ret = -ENOMEM;
-        }
-
-      goto errout_with_lock;
+      return nonblock ? -EAGAIN : -ENOMEM;
     }
 
   iob_reserve(iob, CONFIG_NET_LL_GUARDSIZE);
@@ -373,20 +351,166 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
       conn->sndcb->flags = PKT_POLL;
       conn->sndcb->priv  = conn;
       conn->sndcb->event = psock_send_eventhandler;
-
-      /* Notify the device driver that new TX data is available. */
-
-      netdev_txnotify_dev(dev, PKT_POLL);
-      conn_dev_unlock(&conn->sconn, dev);
     }
 
   return len;
 
 errout_with_iob:
   iob_free_chain(iob);
+  return ret;
+}
 
-errout_with_lock:
-  conn_dev_unlock(&conn->sconn, dev);
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_sendmsg
+ *
+ * Description:
+ *   The pkt_sendmsg() call may be used only when the packet socket is in
+ *   a connected state (so that the intended recipient is known).
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msg      Message to send
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent. On error, a negated
+ *   errno value is returned (see sendmsg() for the complete list of return
+ *   values.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
+                    int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  ssize_t ret;
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* A send() without data flushes the TX ring, if any */
 
+  ret = pkt_mmap_send(psock, msg, flags);
+  if (ret != -ENOENT)
+    {
+      return ret;
+    }
+#endif
+
+  /* Validity check */
+
+  ret = pkt_sendmsg_is_valid(psock, msg, &dev);
+  if (ret != OK)
+    {
+      return ret;
+    }
+
+  conn_dev_lock(&conn->sconn, dev);
+
+  ret = pkt_sendmsg_locked(psock, dev, msg, flags);
+  if (ret > 0)
+    {
+      /* Notify the device driver that new TX data is available. */
+
+      netdev_txnotify_dev(dev, PKT_POLL);
+    }
+
+  conn_dev_unlock(&conn->sconn, dev);
   return ret;
 }
+
+/****************************************************************************
+ * Name: pkt_sendmmsg
+ *
+ * Description:
+ *   Queue a batch of packets under one hold of the connection and device
+ *   locks, notifying the device driver once when done.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   msgvec   Messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of messages sent, or a negated errno value if not even the
+ *   first one could be.
+ *
+ ****************************************************************************/
+
+int pkt_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev = NULL;
+  FAR struct net_driver_s *msgdev;
+  FAR struct msghdr *msg;
+  bool queued = false;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      ret = pkt_sendmsg_is_valid(psock, msg, &msgdev);
+      if (ret != OK)
+        {
+          break;
+        }
+
+      if (msgdev != dev)
+        {
+          /* Hand what was queued so far over to its device */
+
+          if (dev != NULL)
+            {
+              if (queued)
+                {
+                  netdev_txnotify_dev(dev, PKT_POLL);
+                }
+
+              conn_dev_unlock(&conn->sconn, dev);
+            }
+
+          dev    = msgdev;
+          queued = false;
+          conn_dev_lock(&conn->sconn, dev);
+        }
+
+      /* Nothing may wait for buffers while the packets that would free
+       * them are held back: notify the device first, and retry.
+       */
+
+      ret = pkt_sendmsg_locked(psock, dev, msg,
+                               queued ? flags | MSG_DONTWAIT : flags);
+      if (ret == -EAGAIN && queued)
+        {
+          netdev_txnotify_dev(dev, PKT_POLL);
+          queued = false;
+          ret = pkt_sendmsg_locked(psock, dev, msg, flags);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+      queued |= ret > 0;
+    }
+
+  if (dev != NULL)
+    {
+      if (queued)
+        {
+          netdev_txnotify_dev(dev, PKT_POLL);
+        }
+
+      conn_dev_unlock(&conn->sconn, dev);
+    }
+
+  return i > 0 ? i : ret;
+}
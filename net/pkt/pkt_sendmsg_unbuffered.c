@@ -130,6 +130,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           dev->d_len                = dev->d_sndlen;
           pstate->snd_sent          = pstate->snd_buflen;
           pstate->snd_conn->pendiob = dev->d_iob;
+          pkt_tstamp_txrequest(dev, pstate->snd_conn);
 
           if (pstate->snd_sock->s_type == SOCK_DGRAM)
             {
@@ -191,6 +192,16 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR const struct msghdr *msg,
   struct send_s state;
   int ret = OK;
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* A send() without data flushes the TX ring, if any */
+
+  ret = pkt_mmap_send(psock, msg, flags);
+  if (ret != -ENOENT)
+    {
+      return ret;
+    }
+#endif
+
   /* Validity check */
 
   ret = pkt_sendmsg_is_valid(psock, msg, &dev);
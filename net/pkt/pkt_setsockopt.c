@@ -79,6 +79,13 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
   DEBUGASSERT(value_len == 0 || value != NULL);
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  if (level == SOL_SOCKET && option == SO_TIMESTAMPING)
+    {
+      return pkt_tstamp_setsockopt(psock->s_conn, value, value_len);
+    }
+#endif
+
   if (level != SOL_PACKET)
     {
       return -ENOPROTOOPT;
@@ -123,6 +130,21 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_PKT_MMAP
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        {
+          if (value == NULL || value_len < sizeof(struct tpacket_req))
+            {
+              return -EINVAL;
+            }
+
+          ret = pkt_mmap_setring(psock->s_conn, option,
+                                 (FAR const struct tpacket_req *)value);
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_MCASTGROUP
       case PACKET_ADD_MEMBERSHIP:
       case PACKET_DROP_MEMBERSHIP:
@@ -86,6 +86,23 @@ const struct sock_intf_s g_pkt_sockif =
 #if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_PKTPROTO_OPTIONS)
   , pkt_getsockopt /* si_getsockopt */
   , pkt_setsockopt /* si_setsockopt */
+#elif defined(CONFIG_NET_SOCKOPTS)
+  , NULL           /* si_getsockopt */
+  , NULL           /* si_setsockopt */
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+#ifdef CONFIG_NET_PKT_WRITE_BUFFERS
+  , pkt_sendmmsg   /* si_sendmmsg */
+#else
+  , NULL           /* si_sendmmsg */
+#endif
+  , pkt_recvmmsg   /* si_recvmmsg */
+#ifdef CONFIG_NET_PKT_MMAP
+  , pkt_mmap       /* si_mmap */
+#else
+  , NULL           /* si_mmap */
 #endif
 };
 
@@ -367,6 +384,7 @@ static int pkt_close(FAR struct socket *psock)
               /* Yes... free any read-ahead data */
 
               iob_free_queue(&conn->readahead);
+              pkt_mmap_release(conn);
 
 #ifdef CONFIG_NET_PKT_WRITE_BUFFERS
               /* Free write buffer callback. */
@@ -0,0 +1,295 @@
+/****************************************************************************
+ * net/pkt/pkt_tstamp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+#include <netpacket/packet.h>
+#include <net/net_tstamp.h>
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/pkt.h>
+
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_TIMESTAMPING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_tstamp_report
+ *
+ * Description:
+ *   Complete the transmit timestamp of the packet with OPT_ID 'key' and
+ *   wake up the poll() waiters with POLLERR.  'ns' is the hardware
+ *   timestamp, zero if none.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+static void pkt_tstamp_report(FAR struct pkt_conn_s *conn, uint32_t key,
+                              FAR const struct timespec *sw, uint64_t ns)
+{
+  int i;
+
+  memset(&conn->tsreport, 0, sizeof(conn->tsreport));
+
+  if ((conn->tsflags & SOF_TIMESTAMPING_SOFTWARE) != 0)
+    {
+      conn->tsreport.ts[0] = *sw;
+    }
+
+  if ((conn->tsflags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0 && ns != 0)
+    {
+      conn->tsreport.ts[2].tv_sec  = ns / NSEC_PER_SEC;
+      conn->tsreport.ts[2].tv_nsec = ns % NSEC_PER_SEC;
+    }
+
+  conn->tsreportkey = key;
+  conn->tsready     = true;
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      poll_notify(&conn->pollinfo[i].fds, 1, POLLERR);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_tstamp_setsockopt
+ *
+ * Description:
+ *   Set the SO_TIMESTAMPING flags of a packet socket.  Setting
+ *   SOF_TIMESTAMPING_OPT_ID restarts the OPT_ID keys at zero.
+ *
+ ****************************************************************************/
+
+int pkt_tstamp_setsockopt(FAR struct pkt_conn_s *conn,
+                          FAR const void *value, socklen_t value_len)
+{
+  uint32_t flags;
+
+  if (value == NULL || value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  flags = *(FAR const int *)value;
+  if ((flags & ~SOF_TIMESTAMPING_MASK) != 0)
+    {
+      return -EINVAL;
+    }
+
+  conn_lock(&conn->sconn);
+
+  if ((flags & SOF_TIMESTAMPING_OPT_ID) != 0 &&
+      (conn->tsflags & SOF_TIMESTAMPING_OPT_ID) == 0)
+    {
+      conn->tskey = 0;
+    }
+
+  if ((flags & SOF_TIMESTAMPING_TX_HARDWARE) == 0)
+    {
+      conn->tsiob = NULL;
+    }
+
+  conn->tsflags = flags;
+
+  conn_unlock(&conn->sconn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_tstamp_txrequest
+ *
+ * Description:
+ *   Called when the packet in dev->d_iob is handed to the driver on behalf
+ *   of a packet socket: take the software transmit timestamp and ask the
+ *   NIC for the hardware one, as selected by SO_TIMESTAMPING.
+ *
+ * Assumptions:
+ *   Called from the network driver with the network locked.
+ *
+ ****************************************************************************/
+
+void pkt_tstamp_txrequest(FAR struct net_driver_s *dev,
+                          FAR struct pkt_conn_s *conn)
+{
+  struct timespec sw;
+  uint32_t key;
+
+  if ((conn->tsflags & SOF_TIMESTAMPING_TX_RECORD_MASK) == 0 ||
+      dev->d_iob == NULL)
+    {
+      return;
+    }
+
+  memset(&sw, 0, sizeof(sw));
+  if ((conn->tsflags & SOF_TIMESTAMPING_TX_SOFTWARE) != 0)
+    {
+      clock_gettime(CLOCK_REALTIME, &sw);
+    }
+
+  key = conn->tskey++;
+
+  if ((conn->tsflags & SOF_TIMESTAMPING_TX_HARDWARE) != 0)
+    {
+      /* The report completes when the driver returns the NIC time */
+
+      dev->d_iob->io_tstamp = IOB_TSTAMP_REQUEST;
+      conn->tsiob           = dev->d_iob;
+      conn->tssw            = sw;
+      conn->tsreqkey        = key;
+    }
+  else
+    {
+      pkt_tstamp_report(conn, key, &sw, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_txtstamp
+ *
+ * Description:
+ *   Report the hardware transmit timestamp of a packet that was sent with
+ *   IOB_TSTAMP_REQUEST in io_tstamp.  The report is queued on the error
+ *   queue of the packet socket that sent it, if it is still waiting.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure that sent the packet
+ *   iob - The packet, which must not have been freed yet
+ *   ns  - The time the packet left the wire, in nanoseconds of the NIC
+ *         clock
+ *
+ * Assumptions:
+ *   Called from the network driver with the network locked.
+ *
+ ****************************************************************************/
+
+void pkt_txtstamp(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                  uint64_t ns)
+{
+  FAR struct pkt_conn_s *conn;
+
+  if (iob->io_tstamp != IOB_TSTAMP_REQUEST)
+    {
+      return;
+    }
+
+  iob->io_tstamp = 0;
+
+  pkt_conn_list_lock();
+
+  for (conn = pkt_nextconn(NULL); conn != NULL; conn = pkt_nextconn(conn))
+    {
+      if (conn->tsiob == iob && conn->ifindex == dev->d_ifindex)
+        {
+          conn_lock(&conn->sconn);
+          conn->tsiob = NULL;
+          pkt_tstamp_report(conn, conn->tsreqkey, &conn->tssw, ns);
+          conn_unlock(&conn->sconn);
+          break;
+        }
+    }
+
+  pkt_conn_list_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_tstamp_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): return the completed transmit
+ *   timestamp as an SCM_TIMESTAMPING control message, followed by a
+ *   PACKET_TX_TIMESTAMP control message with the struct sock_extended_err
+ *   naming the packet.  No payload is returned.  Never blocks.
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if there is nothing to report.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_tstamp_recverr(FAR struct pkt_conn_s *conn,
+                           FAR struct msghdr *msg)
+{
+  struct scm_timestamping report;
+  struct sock_extended_err serr;
+
+  conn_lock(&conn->sconn);
+
+  if (!conn->tsready)
+    {
+      conn_unlock(&conn->sconn);
+      return -EAGAIN;
+    }
+
+  report = conn->tsreport;
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_errno  = ENOMSG;
+  serr.ee_origin = SO_EE_ORIGIN_TIMESTAMPING;
+  if ((conn->tsflags & SOF_TIMESTAMPING_OPT_ID) != 0)
+    {
+      serr.ee_data = conn->tsreportkey;
+    }
+
+  conn->tsready = false;
+
+  conn_unlock(&conn->sconn);
+
+  /* Like Linux, the report is consumed even if it did not fit */
+
+  if (cmsg_append(msg, SOL_SOCKET, SCM_TIMESTAMPING,
+                  &report, sizeof(report)) == NULL ||
+      cmsg_append(msg, SOL_PACKET, PACKET_TX_TIMESTAMP,
+                  &serr, sizeof(serr)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+    }
+
+  msg->msg_namelen = 0;
+  msg->msg_flags  |= MSG_ERRQUEUE;
+  return 0;
+}
+
+#endif /* CONFIG_NET_TIMESTAMPING */
@@ -58,6 +58,9 @@ static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_IPv6
 static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_IPv4 */
+#ifdef CONFIG_NET_IPFRAG
+static int netprocfs_ipfrag(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPFRAG */
 static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
@@ -89,6 +92,10 @@ static const linegen_t g_stat_linegen[] =
   netprocfs_ipv6_dropped,
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_IPFRAG
+  netprocfs_ipfrag,
+#endif /* CONFIG_NET_IPFRAG */
+
   netprocfs_checksum,
 
 #ifdef CONFIG_NET_TCP
@@ -262,6 +269,21 @@ static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: netprocfs_ipfrag
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFRAG)
+static int netprocfs_ipfrag(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  Reassembly  Rsm: %04x   Tmo: %04x   Evc: %04x   "
+                  "Ovl: %04x\n",
+                  g_netstats.ipfrag.reasm, g_netstats.ipfrag.timeout,
+                  g_netstats.ipfrag.evict, g_netstats.ipfrag.overlap);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPFRAG */
+
 /****************************************************************************
  * Name: netprocfs_checksum
  ****************************************************************************/
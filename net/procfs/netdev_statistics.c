@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdio.h>
 #include <string.h>
@@ -77,6 +78,8 @@ static int netprocfs_rxstatistics_header(
 static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxpackets_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_rxbatch_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_rxbatch(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
@@ -114,6 +117,8 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxstatistics,
   netprocfs_rxpackets_header,
   netprocfs_rxpackets,
+  netprocfs_rxbatch_header,
+  netprocfs_rxbatch,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
   netprocfs_errors
@@ -518,6 +523,69 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_rxbatch_header
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_rxbatch_header(FAR struct netprocfs_file_s *netfile)
+{
+  int len;
+  int i;
+
+  DEBUGASSERT(netfile != NULL);
+
+  /* One column per power-of-two batch size, the last one is open ended */
+
+  len = snprintf(netfile->line, NET_LINELEN, "\tRX batch:");
+  for (i = 0; i < NETDEV_RXBATCH_NBUCKETS && len < NET_LINELEN; i++)
+    {
+      len += snprintf(&netfile->line[len], NET_LINELEN - len,
+                      i < NETDEV_RXBATCH_NBUCKETS - 1 ? " %-7u" : " %u+",
+                      1u << i);
+    }
+
+  if (len < NET_LINELEN)
+    {
+      len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+    }
+
+  return MIN(len, NET_LINELEN - 1);
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
+/****************************************************************************
+ * Name: netprocfs_rxbatch
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_STATISTICS
+static int netprocfs_rxbatch(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+  int len;
+  int i;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  len = snprintf(netfile->line, NET_LINELEN, "\t         ");
+  for (i = 0; i < NETDEV_RXBATCH_NBUCKETS && len < NET_LINELEN; i++)
+    {
+      len += snprintf(&netfile->line[len], NET_LINELEN - len, " %-7lu",
+                      (unsigned long)stats->rx_batch[i]);
+    }
+
+  if (len < NET_LINELEN)
+    {
+      len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+    }
+
+  return MIN(len, NET_LINELEN - 1);
+}
+#endif /* CONFIG_NETDEV_STATISTICS */
+
 /****************************************************************************
  * Name: netprocfs_txstatistics_header
  ****************************************************************************/
@@ -35,9 +35,11 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -89,6 +91,8 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_closeroute_ipv4(&fshandle);
 
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
+  net_rebuildtrie_ipv4();
+  ipfwd_flow_flush();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
@@ -125,6 +129,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   net_closeroute_ipv6(&fshandle);
 
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
+  net_rebuildtrie_ipv6();
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
 #endif
@@ -36,9 +36,11 @@
 
 #include <arch/irq.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -91,6 +93,8 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   net_unlockroute_ipv4();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET);
+  net_rebuildtrie_ipv4();
+  ipfwd_flow_flush();
   return OK;
 }
 #endif
@@ -126,6 +130,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   net_unlockroute_ipv6();
 
   netlink_route_notify(route, RTM_NEWROUTE, AF_INET6);
+  net_rebuildtrie_ipv6();
   return OK;
 }
 #endif
@@ -38,10 +38,12 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
 
@@ -317,12 +319,19 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   ret = file_truncate(&fshandle, filesize);
 
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET);
+  ipfwd_flow_flush();
 
 errout_with_fshandle:
   net_closeroute_ipv4(&fshandle);
 
 errout_with_lock:
   net_unlockroute_ipv4();
+
+  if (ret >= 0)
+    {
+      net_rebuildtrie_ipv4();
+    }
+
   return ret;
 }
 #endif
@@ -476,6 +485,12 @@ errout_with_fshandle:
 
 errout_with_lock:
   net_unlockroute_ipv6();
+
+  if (ret >= 0)
+    {
+      net_rebuildtrie_ipv6();
+    }
+
   return ret;
 }
 #endif
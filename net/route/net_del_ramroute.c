@@ -34,9 +34,11 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 
@@ -114,6 +116,7 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
         }
 
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
+      ipfwd_flow_flush();
 
       /* And free the routing table entry by adding it to the free list */
 
@@ -219,7 +222,13 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv4(net_del_ipv4route, &match) ? OK : -ENOENT;
+  if (!net_foreachroute_ipv4(net_del_ipv4route, &match))
+    {
+      return -ENOENT;
+    }
+
+  net_rebuildtrie_ipv4();
+  return OK;
 }
 #endif
 
@@ -236,7 +245,13 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   /* Then remove the entry from the routing table */
 
-  return net_foreachroute_ipv6(net_del_ipv6route, &match) ? OK : -ENOENT;
+  if (!net_foreachroute_ipv6(net_del_ipv6route, &match))
+    {
+      return -ENOENT;
+    }
+
+  net_rebuildtrie_ipv6();
+  return OK;
 }
 #endif
 
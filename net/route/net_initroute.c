@@ -29,6 +29,7 @@
 #include "route/ramroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 
 #ifdef CONFIG_NET_ROUTE
 
@@ -55,6 +56,15 @@ void net_init_route(void)
 #if defined(CONFIG_ROUTE_IPv4_CACHEROUTE) || defined(CONFIG_ROUTE_IPv6_CACHEROUTE)
   net_init_cacheroute();
 #endif
+
+  /* Index any routes that exist already, e.g. a read-only table */
+
+#ifdef CONFIG_NET_IPv4
+  net_rebuildtrie_ipv4();
+#endif
+#ifdef CONFIG_NET_IPv6
+  net_rebuildtrie_ipv6();
+#endif
 }
 
 #endif /* CONFIG_NET_ROUTE */
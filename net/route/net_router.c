@@ -37,6 +37,7 @@
 #include "devif/devif.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 #include "utils/utils.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -248,6 +249,9 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
                     int8_t prefixlen)
 {
   struct route_ipv4_match_s match;
+#ifdef CONFIG_ROUTE_TRIE
+  in_addr_t trierouter;
+#endif
   int ret;
 
   /* Just early return for long prefix, maybe already got exact match. */
@@ -264,6 +268,24 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_TRIE
+  /* The trie gives the longest match directly, unless the routing table
+   * does not fit in it.
+   */
+
+  ret = net_lookuptrie_ipv4(target, &trierouter);
+  if (ret != -ENOSPC)
+    {
+      if (ret <= prefixlen)
+        {
+          return -ENOENT;
+        }
+
+      net_ipv4addr_copy(*router, trierouter);
+      return OK;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -342,6 +364,9 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
                     int16_t prefixlen)
 {
   struct route_ipv6_match_s match;
+#ifdef CONFIG_ROUTE_TRIE
+  net_ipv6addr_t trierouter;
+#endif
   int ret;
 
   /* Just early return for long prefix, maybe already got exact match. */
@@ -358,6 +383,24 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
       return -ENOENT;
     }
 
+#ifdef CONFIG_ROUTE_TRIE
+  /* The trie gives the longest match directly, unless the routing table
+   * does not fit in it.
+   */
+
+  ret = net_lookuptrie_ipv6(target, trierouter);
+  if (ret != -ENOSPC)
+    {
+      if (ret <= prefixlen)
+        {
+          return -ENOENT;
+        }
+
+      net_ipv6addr_copy(router, trierouter);
+      return OK;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
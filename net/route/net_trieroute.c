@@ -0,0 +1,635 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/seqlock.h>
+#include <nuttx/net/ip.h>
+
+#include "route/trieroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TRIE_NONE                 UINT16_MAX
+
+#define TRIE_KEY(t, e)            ((t)->keys + (size_t)(e) * (t)->stride)
+
+#ifdef CONFIG_NET_IPv4
+#  define TRIE_IPv4_NENTRIES      CONFIG_ROUTE_TRIE_MAX_IPv4ROUTES
+#  define TRIE_IPv4_NNODES        (2 * TRIE_IPv4_NENTRIES)
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  define TRIE_IPv6_NENTRIES      CONFIG_ROUTE_TRIE_MAX_IPv6ROUTES
+#  define TRIE_IPv6_NNODES        (2 * TRIE_IPv6_NENTRIES)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path compressed binary trie.  The prefix bits of a node
+ * are not stored in the node, they are the leading plen bits of the
+ * target of any route below it, the route "key".
+ */
+
+struct trie_node_s
+{
+  uint16_t child[2];             /* Children by the bit after the prefix */
+  uint16_t key;                  /* Route holding the prefix bits */
+  uint16_t route;                /* Route of this node, or TRIE_NONE */
+  uint8_t  plen;                 /* Prefix length of the node */
+};
+
+/* The address family independent view of one trie */
+
+struct trie_s
+{
+  FAR struct trie_node_s *nodes; /* The nodes of the trie */
+  FAR const uint8_t *keys;       /* The target address of the first route */
+  size_t   stride;               /* Distance between two route targets */
+  uint16_t nentries;             /* Capacity of route entries */
+  uint16_t nnodes;               /* Capacity of nodes */
+  uint16_t used;                 /* Nodes in use */
+  uint16_t root;                 /* The root node, or TRIE_NONE */
+  uint8_t  nbits;                /* Address length in bits */
+};
+
+/* Two copies of each trie are kept: lookups use the active one without
+ * any lock while the routing table is rebuilt into the other one, then a
+ * sequence counter publishes the switch.  A lookup that overlaps with the
+ * rebuild of the copy it is reading just tries again.
+ */
+
+#ifdef CONFIG_NET_IPv4
+struct trie_ipv4_route_s
+{
+  in_addr_t target;              /* The destination network */
+  in_addr_t router;              /* Route packets via this router */
+  uint8_t   plen;                /* The prefix length of the network */
+};
+
+struct trie_ipv4_s
+{
+  bool     valid;                /* The whole routing table is indexed */
+  uint16_t root;                 /* The root node, or TRIE_NONE */
+  uint16_t nroutes;              /* The number of routes */
+  struct trie_ipv4_route_s routes[TRIE_IPv4_NENTRIES];
+  struct trie_node_s nodes[TRIE_IPv4_NNODES];
+};
+
+struct trie_ipv4_build_s
+{
+  FAR struct trie_ipv4_s *trie;
+  struct trie_s view;
+  bool overflow;
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct trie_ipv6_route_s
+{
+  net_ipv6addr_t target;         /* The destination network */
+  net_ipv6addr_t router;         /* Route packets via this router */
+  uint8_t        plen;           /* The prefix length of the network */
+};
+
+struct trie_ipv6_s
+{
+  bool     valid;                /* The whole routing table is indexed */
+  uint16_t root;                 /* The root node, or TRIE_NONE */
+  uint16_t nroutes;              /* The number of routes */
+  struct trie_ipv6_route_s routes[TRIE_IPv6_NENTRIES];
+  struct trie_node_s nodes[TRIE_IPv6_NNODES];
+};
+
+struct trie_ipv6_build_s
+{
+  FAR struct trie_ipv6_s *trie;
+  struct trie_s view;
+  bool overflow;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Serializes the rebuilds */
+
+static mutex_t g_trie_lock = NXMUTEX_INITIALIZER;
+
+#ifdef CONFIG_NET_IPv4
+static struct trie_ipv4_s g_ipv4_trie[2];
+static seqcount_t g_ipv4_trie_seq = SEQLOCK_INITIALIZER;
+static uint8_t g_ipv4_trie_active;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct trie_ipv6_s g_ipv6_trie[2];
+static seqcount_t g_ipv6_trie_seq = SEQLOCK_INITIALIZER;
+static uint8_t g_ipv6_trie_active;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return bit n, counted from the most significant one, of an address in
+ *   network order.
+ *
+ ****************************************************************************/
+
+static inline unsigned int trie_bit(FAR const uint8_t *addr, unsigned int n)
+{
+  return (addr[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to len, that two addresses in
+ *   network order have in common.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                                unsigned int len)
+{
+  unsigned int n = 0;
+  uint8_t diff;
+
+  while (n + 8 <= len && a[n >> 3] == b[n >> 3])
+    {
+      n += 8;
+    }
+
+  if (n >= len)
+    {
+      return len;
+    }
+
+  diff = a[n >> 3] ^ b[n >> 3];
+  while (n < len && (diff & (0x80 >> (n & 7))) == 0)
+    {
+      n++;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: trie_alloc
+ *
+ * Description:
+ *   Allocate a node without children.
+ *
+ ****************************************************************************/
+
+static uint16_t trie_alloc(FAR struct trie_s *trie, uint16_t route,
+                           unsigned int plen)
+{
+  FAR struct trie_node_s *node;
+
+  if (trie->used >= trie->nnodes)
+    {
+      return TRIE_NONE;
+    }
+
+  node           = &trie->nodes[trie->used];
+  node->child[0] = TRIE_NONE;
+  node->child[1] = TRIE_NONE;
+  node->key      = route;
+  node->route    = route;
+  node->plen     = plen;
+
+  return trie->used++;
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Insert a route into a trie.  Of several routes to the same network,
+ *   the first one is kept, as the linear routing table search does.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct trie_s *trie, uint16_t route,
+                       unsigned int plen)
+{
+  FAR const uint8_t *target = TRIE_KEY(trie, route);
+  FAR uint16_t *link = &trie->root;
+  FAR struct trie_node_s *node;
+  FAR const uint8_t *key;
+  unsigned int common;
+  uint16_t leaf;
+  uint16_t branch;
+
+  while (*link != TRIE_NONE)
+    {
+      node   = &trie->nodes[*link];
+      key    = TRIE_KEY(trie, node->key);
+      common = trie_common(target, key, MIN(plen, node->plen));
+
+      if (common == node->plen && plen > node->plen)
+        {
+          /* The node prefix covers the route, go further down */
+
+          link = &node->child[trie_bit(target, node->plen)];
+          continue;
+        }
+
+      if (common == plen && plen == node->plen)
+        {
+          /* The node has the prefix of the route */
+
+          if (node->route == TRIE_NONE)
+            {
+              node->route = route;
+            }
+
+          return OK;
+        }
+
+      leaf = trie_alloc(trie, route, plen);
+      if (leaf == TRIE_NONE)
+        {
+          return -ENOSPC;
+        }
+
+      if (common == plen)
+        {
+          /* The route prefix covers the node, put it above */
+
+          trie->nodes[leaf].child[trie_bit(key, plen)] = *link;
+          *link = leaf;
+          return OK;
+        }
+
+      /* The prefixes differ at bit common, branch there */
+
+      branch = trie_alloc(trie, route, common);
+      if (branch == TRIE_NONE)
+        {
+          return -ENOSPC;
+        }
+
+      trie->nodes[branch].route = TRIE_NONE;
+      trie->nodes[branch].child[trie_bit(target, common)] = leaf;
+      trie->nodes[branch].child[trie_bit(key, common)]    = *link;
+      *link = branch;
+      return OK;
+    }
+
+  leaf = trie_alloc(trie, route, plen);
+  if (leaf == TRIE_NONE)
+    {
+      return -ENOSPC;
+    }
+
+  *link = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_lookup
+ *
+ * Description:
+ *   Return the route with the longest prefix matching target, or
+ *   TRIE_NONE.  The trie may be rewritten under the lookup, so every index
+ *   is checked and the walk is bounded; the caller discards the result
+ *   then.
+ *
+ ****************************************************************************/
+
+static uint16_t trie_lookup(FAR const struct trie_s *trie,
+                            FAR const uint8_t *target)
+{
+  FAR const struct trie_node_s *node;
+  uint16_t best = TRIE_NONE;
+  uint16_t ndx = trie->root;
+  unsigned int depth;
+
+  for (depth = 0; ndx < trie->nnodes && depth <= trie->nbits; depth++)
+    {
+      node = &trie->nodes[ndx];
+      if (node->plen > trie->nbits || node->key >= trie->nentries ||
+          trie_common(target, TRIE_KEY(trie, node->key), node->plen) <
+          node->plen)
+        {
+          break;
+        }
+
+      if (node->route < trie->nentries)
+        {
+          best = node->route;
+        }
+
+      if (node->plen == trie->nbits)
+        {
+          break;
+        }
+
+      ndx = node->child[trie_bit(target, node->plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: trie_ipv4_view and trie_ipv6_view
+ *
+ * Description:
+ *   Set up the address family independent view of one trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static void trie_ipv4_view(FAR struct trie_ipv4_s *trie,
+                           FAR struct trie_s *view)
+{
+  view->nodes    = trie->nodes;
+  view->keys     = (FAR const uint8_t *)&trie->routes[0].target;
+  view->stride   = sizeof(struct trie_ipv4_route_s);
+  view->nentries = TRIE_IPv4_NENTRIES;
+  view->nnodes   = TRIE_IPv4_NNODES;
+  view->used     = 0;
+  view->root     = trie->root;
+  view->nbits    = 32;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static void trie_ipv6_view(FAR struct trie_ipv6_s *trie,
+                           FAR struct trie_s *view)
+{
+  view->nodes    = trie->nodes;
+  view->keys     = (FAR const uint8_t *)trie->routes[0].target;
+  view->stride   = sizeof(struct trie_ipv6_route_s);
+  view->nentries = TRIE_IPv6_NENTRIES;
+  view->nnodes   = TRIE_IPv6_NNODES;
+  view->used     = 0;
+  view->root     = trie->root;
+  view->nbits    = 128;
+}
+#endif
+
+/****************************************************************************
+ * Name: trie_ipv4_add and trie_ipv6_add
+ *
+ * Description:
+ *   The net_foreachroute_ipv[4|6]() callback of a rebuild.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int trie_ipv4_add(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  FAR struct trie_ipv4_build_s *build = arg;
+  FAR struct trie_ipv4_s *trie = build->trie;
+  FAR struct trie_ipv4_route_s *entry;
+
+  if (trie->nroutes >= TRIE_IPv4_NENTRIES)
+    {
+      build->overflow = true;
+      return 1;
+    }
+
+  entry = &trie->routes[trie->nroutes];
+  net_ipv4addr_copy(entry->target, route->target);
+  net_ipv4addr_copy(entry->router, route->router);
+  entry->plen = net_ipv4_mask2pref(route->netmask);
+
+  if (trie_insert(&build->view, trie->nroutes, entry->plen) < 0)
+    {
+      build->overflow = true;
+      return 1;
+    }
+
+  trie->nroutes++;
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int trie_ipv6_add(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  FAR struct trie_ipv6_build_s *build = arg;
+  FAR struct trie_ipv6_s *trie = build->trie;
+  FAR struct trie_ipv6_route_s *entry;
+
+  if (trie->nroutes >= TRIE_IPv6_NENTRIES)
+    {
+      build->overflow = true;
+      return 1;
+    }
+
+  entry = &trie->routes[trie->nroutes];
+  net_ipv6addr_copy(entry->target, route->target);
+  net_ipv6addr_copy(entry->router, route->router);
+  entry->plen = net_ipv6_mask2pref(route->netmask);
+
+  if (trie_insert(&build->view, trie->nroutes, entry->plen) < 0)
+    {
+      build->overflow = true;
+      return 1;
+    }
+
+  trie->nroutes++;
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rebuildtrie_ipv4 and net_rebuildtrie_ipv6
+ *
+ * Description:
+ *   Rebuild the longest prefix match trie from the routing table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_rebuildtrie_ipv4(void)
+{
+  struct trie_ipv4_build_s build;
+  irqstate_t flags;
+  int ret;
+
+  nxmutex_lock(&g_trie_lock);
+
+  build.trie          = &g_ipv4_trie[g_ipv4_trie_active ^ 1];
+  build.trie->root    = TRIE_NONE;
+  build.trie->nroutes = 0;
+  build.overflow      = false;
+  trie_ipv4_view(build.trie, &build.view);
+
+  ret = net_foreachroute_ipv4(trie_ipv4_add, &build);
+
+  build.trie->root  = build.view.root;
+  build.trie->valid = ret >= 0 && !build.overflow;
+
+  flags = write_seqlock_irqsave(&g_ipv4_trie_seq);
+  g_ipv4_trie_active ^= 1;
+  write_sequnlock_irqrestore(&g_ipv4_trie_seq, flags);
+
+  nxmutex_unlock(&g_trie_lock);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_rebuildtrie_ipv6(void)
+{
+  struct trie_ipv6_build_s build;
+  irqstate_t flags;
+  int ret;
+
+  nxmutex_lock(&g_trie_lock);
+
+  build.trie          = &g_ipv6_trie[g_ipv6_trie_active ^ 1];
+  build.trie->root    = TRIE_NONE;
+  build.trie->nroutes = 0;
+  build.overflow      = false;
+  trie_ipv6_view(build.trie, &build.view);
+
+  ret = net_foreachroute_ipv6(trie_ipv6_add, &build);
+
+  build.trie->root  = build.view.root;
+  build.trie->valid = ret >= 0 && !build.overflow;
+
+  flags = write_seqlock_irqsave(&g_ipv6_trie_seq);
+  g_ipv6_trie_active ^= 1;
+  write_sequnlock_irqrestore(&g_ipv6_trie_seq, flags);
+
+  nxmutex_unlock(&g_trie_lock);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lookuptrie_ipv4 and net_lookuptrie_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix matching the target address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookuptrie_ipv4(in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct trie_ipv4_s *trie;
+  struct trie_s view;
+  uint16_t route;
+  uint32_t seq;
+  int ret;
+
+  do
+    {
+      seq  = read_seqbegin(&g_ipv4_trie_seq);
+      trie = &g_ipv4_trie[g_ipv4_trie_active & 1];
+
+      if (!trie->valid)
+        {
+          ret = -ENOSPC;
+          continue;
+        }
+
+      trie_ipv4_view(trie, &view);
+      route = trie_lookup(&view, (FAR const uint8_t *)&target);
+      if (route == TRIE_NONE)
+        {
+          ret = -ENOENT;
+          continue;
+        }
+
+      net_ipv4addr_copy(*router, trie->routes[route].router);
+      ret = trie->routes[route].plen;
+    }
+  while (read_seqretry(&g_ipv4_trie_seq, seq));
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookuptrie_ipv6(FAR const net_ipv6addr_t target,
+                        FAR net_ipv6addr_t router)
+{
+  FAR struct trie_ipv6_s *trie;
+  struct trie_s view;
+  uint16_t route;
+  uint32_t seq;
+  int ret;
+
+  do
+    {
+      seq  = read_seqbegin(&g_ipv6_trie_seq);
+      trie = &g_ipv6_trie[g_ipv6_trie_active & 1];
+
+      if (!trie->valid)
+        {
+          ret = -ENOSPC;
+          continue;
+        }
+
+      trie_ipv6_view(trie, &view);
+      route = trie_lookup(&view, (FAR const uint8_t *)target);
+      if (route == TRIE_NONE)
+        {
+          ret = -ENOENT;
+          continue;
+        }
+
+      net_ipv6addr_copy(router, trie->routes[route].router);
+      ret = trie->routes[route].plen;
+    }
+  while (read_seqretry(&g_ipv6_trie_seq, seq));
+
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
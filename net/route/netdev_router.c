@@ -36,6 +36,7 @@
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
+#include "route/trieroute.h"
 #include "utils/utils.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -262,8 +263,24 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
   struct route_ipv4_devmatch_s match;
+#ifdef CONFIG_ROUTE_TRIE
+  in_addr_t trierouter;
+#endif
   int ret;
 
+#ifdef CONFIG_ROUTE_TRIE
+  /* The longest match of the whole table is also the longest one through
+   * dev if its router is on the network of dev.
+   */
+
+  if (net_lookuptrie_ipv4(target, &trierouter) >= 0 &&
+      net_ipv4addr_maskcmp(trierouter, dev->d_ipaddr, dev->d_netmask))
+    {
+      net_ipv4addr_copy(*router, trierouter);
+      return;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_devmatch_s));
@@ -349,8 +366,24 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR net_ipv6addr_t router)
 {
   struct route_ipv6_devmatch_s match;
+#ifdef CONFIG_ROUTE_TRIE
+  net_ipv6addr_t trierouter;
+#endif
   int ret;
 
+#ifdef CONFIG_ROUTE_TRIE
+  /* The longest match of the whole table is also the longest one through
+   * dev if its router is on the network of dev.
+   */
+
+  if (net_lookuptrie_ipv6(target, trierouter) >= 0 &&
+      NETDEV_V6ADDR_ONLINK(dev, trierouter))
+    {
+      net_ipv6addr_copy(router, trierouter);
+      return;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_devmatch_s));
@@ -0,0 +1,95 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_rebuildtrie_ipv4 and net_rebuildtrie_ipv6
+ *
+ * Description:
+ *   Rebuild the longest prefix match trie from the routing table.  Must be
+ *   called after every change of the routing table.  Readers keep using
+ *   the previous trie until the new one is complete.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_rebuildtrie_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_rebuildtrie_ipv6(void);
+#endif
+
+/****************************************************************************
+ * Name: net_lookuptrie_ipv4 and net_lookuptrie_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix matching the target address.
+ *   This does not take any lock.
+ *
+ * Input Parameters:
+ *   target - An IP address on a remote network to use in the lookup.
+ *   router - The address of the router of the matched route.
+ *
+ * Returned Value:
+ *   The prefix length of the matched route on success; -ENOENT if no
+ *   route matches; -ENOSPC if the routing table does not fit in the trie,
+ *   the caller must then search the routing table itself.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookuptrie_ipv4(in_addr_t target, FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookuptrie_ipv6(FAR const net_ipv6addr_t target,
+                        FAR net_ipv6addr_t router);
+#endif
+
+#else
+#  define net_rebuildtrie_ipv4()
+#  define net_rebuildtrie_ipv6()
+#endif /* CONFIG_ROUTE_TRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
@@ -101,6 +101,23 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+/* The compressed address fields of a recent destination */
+
+struct sixlowpan_hc06cache_s
+{
+  FAR struct radio_driver_s *hc_radio;  /* Sending radio, NULL if unused */
+  net_ipv6addr_t hc_srcipaddr;          /* The IP addresses compressed */
+  net_ipv6addr_t hc_destipaddr;
+  struct netdev_varaddr_s hc_srcmac;    /* The MAC addresses they depend on */
+  struct netdev_varaddr_s hc_destmac;
+  uint8_t hc_iphc1;                     /* Second IPHC byte */
+  uint8_t hc_cid;                       /* [ SCI | DCI ] if CID is set */
+  uint8_t hc_addrlen;                   /* Length of hc_addr */
+  uint8_t hc_addr[32];                  /* Inline address fields */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -120,6 +137,13 @@ static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
 #endif
 
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+/* Address fields by destination, looked up before compressing a header */
+
+static struct sixlowpan_hc06cache_s
+  g_hc06_cache[CONFIG_NET_6LOWPAN_HC06_CACHE];
+#endif
+
 /* Pointer to the byte where to write next inline field. */
 
 static FAR uint8_t *g_hc06ptr;
@@ -568,6 +592,276 @@ static void uncompress_addr(FAR const struct netdev_varaddr_s *addr,
         NTOHS(ipaddr[6]), NTOHS(ipaddr[7]));
 }
 
+/****************************************************************************
+ * Name: compress_addrs
+ *
+ * Description:
+ *   Compress the source and destination addresses of an IPv6 header at
+ *   g_hc06ptr.  The address context numbers are set in iphc[2].
+ *
+ * Returned Value:
+ *   The SAC, SAM, M, DAC and DAM bits of the second IPHC byte.
+ *
+ ****************************************************************************/
+
+static uint8_t
+compress_addrs(FAR struct radio_driver_s *radio,
+               FAR const struct ipv6_hdr_s *ipv6,
+               FAR const struct netdev_varaddr_s *destmac,
+               FAR struct sixlowpan_addrcontext_s *saddrcontext,
+               FAR struct sixlowpan_addrcontext_s *daddrcontext,
+               FAR uint8_t *iphc)
+{
+  uint8_t iphc1 = 0;
+
+  /* Source address - cannot be multicast */
+
+  if (net_is_addr_unspecified(ipv6->srcipaddr))
+    {
+      ninfo("Compressing unspecified srcipaddr.  Setting SAC\n");
+
+      iphc1 |= SIXLOWPAN_IPHC_SAC;
+      iphc1 |= SIXLOWPAN_IPHC_SAM_128;
+    }
+  else if (saddrcontext != NULL)
+    {
+      /* Elide the prefix - indicate by CID and set address context + SAC */
+
+      ninfo("Compressing src with address context."
+            " Setting SAC. Context: %d\n",
+            saddrcontext->number);
+
+      iphc1   |= SIXLOWPAN_IPHC_SAC;
+      iphc[2] |= saddrcontext->number << 4;
+
+      /* Compression compare with this nodes address (source) */
+
+      iphc1   |= compress_laddr(ipv6->srcipaddr,
+                                &radio->r_dev.d_mac.radio,
+                                SIXLOWPAN_IPHC_SAM_BIT);
+    }
+
+  /* No address context found for the source address */
+
+  else if (net_is_addr_linklocal(ipv6->srcipaddr) &&
+           ipv6->srcipaddr[1] == 0 &&  ipv6->srcipaddr[2] == 0 &&
+           ipv6->srcipaddr[3] == 0)
+    {
+      iphc1   |= compress_laddr(ipv6->srcipaddr,
+                                &radio->r_dev.d_mac.radio,
+                                SIXLOWPAN_IPHC_SAM_BIT);
+    }
+  else
+    {
+      /* Send the full source address ipaddr:  SAC = 0, SAM = 00 */
+
+      ninfo("Uncompressable "
+            "srcipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
+            NTOHS(ipv6->srcipaddr[0]), NTOHS(ipv6->srcipaddr[1]),
+            NTOHS(ipv6->srcipaddr[2]), NTOHS(ipv6->srcipaddr[3]),
+            NTOHS(ipv6->srcipaddr[4]), NTOHS(ipv6->srcipaddr[5]),
+            NTOHS(ipv6->srcipaddr[6]), NTOHS(ipv6->srcipaddr[7]));
+
+      iphc1 |= SIXLOWPAN_IPHC_SAM_128;   /* 128-bits */
+      memcpy(g_hc06ptr, ipv6->srcipaddr, 16);
+      g_hc06ptr += 16;
+    }
+
+  /* Destination address */
+
+  if (net_is_addr_mcast(ipv6->destipaddr))
+    {
+      /* Address is multicast, try to compress */
+
+      iphc1 |= SIXLOWPAN_IPHC_M;
+      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
+        {
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
+
+          /* Use "last" byte ("last" meaning the LS byte in host order.
+           * destipaddr is in big-endian network order).
+           */
+
+#ifdef CONFIG_ENDIAN_BIG
+          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
+#else
+          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
+#endif
+          g_hc06ptr += 1;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
+
+          /* Second byte + the last three */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[13], 3);
+          g_hc06ptr += 4;
+        }
+      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
+        {
+          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
+
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
+
+          /* Second byte + the last five */
+
+          *g_hc06ptr = iptr[1];
+          memcpy(g_hc06ptr + 1, &iptr[11], 5);
+          g_hc06ptr += 6;
+        }
+      else
+        {
+          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
+
+          /* Full address */
+
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+  else
+    {
+      /* Address is unicast, try to compress */
+
+      if (daddrcontext != NULL)
+        {
+          /* Elide the prefix */
+
+          ninfo("Compressing dest with address context. "
+                "Setting DAC. Context: %d\n",
+                daddrcontext->number);
+
+          iphc1   |= SIXLOWPAN_IPHC_DAC;
+          iphc[2] |= daddrcontext->number;
+
+          /* Compession compare with link address (destination) */
+
+          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                      SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* No address context found for this address */
+
+      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
+               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
+               ipv6->destipaddr[3] == 0)
+        {
+          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
+                                    SIXLOWPAN_IPHC_DAM_BIT);
+        }
+
+      /* Send the full address */
+
+      else
+        {
+          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
+          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
+          g_hc06ptr += 16;
+        }
+    }
+
+  return iphc1;
+}
+
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+/****************************************************************************
+ * Name: hc06_cache_maccmp
+ *
+ * Description:
+ *   Return true if two MAC addresses are the same.
+ *
+ ****************************************************************************/
+
+static bool hc06_cache_maccmp(FAR const struct netdev_varaddr_s *addr1,
+                              FAR const struct netdev_varaddr_s *addr2)
+{
+  return addr1->nv_addrlen == addr2->nv_addrlen &&
+         memcmp(addr1->nv_addr, addr2->nv_addr, addr1->nv_addrlen) == 0;
+}
+
+/****************************************************************************
+ * Name: hc06_cache_slot
+ *
+ * Description:
+ *   Get the address cache slot of a destination.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_hc06cache_s *
+  hc06_cache_slot(FAR const struct ipv6_hdr_s *ipv6)
+{
+  return &g_hc06_cache[(ipv6->destipaddr[7] ^ ipv6->destipaddr[6]) %
+                       CONFIG_NET_6LOWPAN_HC06_CACHE];
+}
+
+/****************************************************************************
+ * Name: hc06_cache_find
+ *
+ * Description:
+ *   Look up the compressed address fields of a packet.  They only depend
+ *   on the IP addresses, the MAC addresses of both ends and the address
+ *   contexts, which are fixed after sixlowpan_hc06_initialize().
+ *
+ * Returned Value:
+ *   The cache entry on a hit; NULL on a miss.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_hc06cache_s *
+  hc06_cache_find(FAR struct radio_driver_s *radio,
+                  FAR const struct ipv6_hdr_s *ipv6,
+                  FAR const struct netdev_varaddr_s *destmac)
+{
+  FAR struct sixlowpan_hc06cache_s *cache = hc06_cache_slot(ipv6);
+
+  if (cache->hc_radio == radio &&
+      net_ipv6addr_cmp(cache->hc_destipaddr, ipv6->destipaddr) &&
+      net_ipv6addr_cmp(cache->hc_srcipaddr, ipv6->srcipaddr) &&
+      hc06_cache_maccmp(&cache->hc_destmac, destmac) &&
+      hc06_cache_maccmp(&cache->hc_srcmac, &radio->r_dev.d_mac.radio))
+    {
+      return cache;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hc06_cache_add
+ *
+ * Description:
+ *   Remember the compressed address fields of a packet, replacing the
+ *   previous destination in the same slot.
+ *
+ ****************************************************************************/
+
+static void hc06_cache_add(FAR struct radio_driver_s *radio,
+                           FAR const struct ipv6_hdr_s *ipv6,
+                           FAR const struct netdev_varaddr_s *destmac,
+                           uint8_t iphc1, uint8_t cid,
+                           FAR const uint8_t *addr, size_t addrlen)
+{
+  FAR struct sixlowpan_hc06cache_s *cache = hc06_cache_slot(ipv6);
+
+  DEBUGASSERT(addrlen <= sizeof(cache->hc_addr));
+
+  cache->hc_radio   = radio;
+  net_ipv6addr_copy(cache->hc_srcipaddr, ipv6->srcipaddr);
+  net_ipv6addr_copy(cache->hc_destipaddr, ipv6->destipaddr);
+  memcpy(&cache->hc_srcmac, &radio->r_dev.d_mac.radio,
+         sizeof(struct netdev_varaddr_s));
+  memcpy(&cache->hc_destmac, destmac, sizeof(struct netdev_varaddr_s));
+  cache->hc_iphc1   = iphc1;
+  cache->hc_cid     = cid;
+  cache->hc_addrlen = addrlen;
+  memcpy(cache->hc_addr, addr, addrlen);
+}
+#endif /* CONFIG_NET_6LOWPAN_HC06_CACHE > 0 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -746,6 +1040,10 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
   FAR uint8_t *iphc = fptr + g_frame_hdrlen;
   FAR struct sixlowpan_addrcontext_s *saddrcontext;
   FAR struct sixlowpan_addrcontext_s *daddrcontext;
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+  FAR struct sixlowpan_hc06cache_s *cache;
+  FAR uint8_t *addrptr;
+#endif
   uint8_t iphc0;
   uint8_t iphc1;
   uint8_t tmp;
@@ -771,18 +1069,35 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
    * byte with [ SCI | DCI ]
    */
 
-  /* Check if dest address context exists (for allocating third byte) */
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+  cache = hc06_cache_find(radio, ipv6, destmac);
+  if (cache != NULL)
+    {
+      iphc1 = cache->hc_iphc1;
+      if ((iphc1 & SIXLOWPAN_IPHC_CID) != 0)
+        {
+          iphc[2] = cache->hc_cid;
+          g_hc06ptr++;
+        }
+    }
+  else
+#endif
+    {
+      /* Check if dest address context exists (for allocating third
+       * byte)
+       */
 
-  daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
-  saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
+      daddrcontext = find_addrcontext_byprefix(ipv6->destipaddr);
+      saddrcontext = find_addrcontext_byprefix(ipv6->srcipaddr);
 
-  if (daddrcontext != NULL || saddrcontext != NULL)
-    {
-      /* set address context flag and increase g_hc06ptr */
+      if (daddrcontext != NULL || saddrcontext != NULL)
+        {
+          /* set address context flag and increase g_hc06ptr */
 
-      ninfo("Compressing dest or src ipaddr. Setting CID\n");
-      iphc1 |= SIXLOWPAN_IPHC_CID;
-      g_hc06ptr++;
+          ninfo("Compressing dest or src ipaddr. Setting CID\n");
+          iphc1 |= SIXLOWPAN_IPHC_CID;
+          g_hc06ptr++;
+        }
     }
 
   /* Traffic class, flow label
@@ -888,154 +1203,26 @@ int sixlowpan_compresshdr_hc06(FAR struct radio_driver_s *radio,
       break;
     }
 
-  /* Source address - cannot be multicast */
-
-  if (net_is_addr_unspecified(ipv6->srcipaddr))
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+  if (cache != NULL)
     {
-      ninfo("Compressing unspecified srcipaddr.  Setting SAC\n");
+      /* Reuse the address fields of the last packet to this destination */
 
-      iphc1 |= SIXLOWPAN_IPHC_SAC;
-      iphc1 |= SIXLOWPAN_IPHC_SAM_128;
-    }
-  else if (saddrcontext != NULL)
-    {
-      /* Elide the prefix - indicate by CID and set address context + SAC */
-
-      ninfo("Compressing src with address context."
-            " Setting SAC. Context: %d\n",
-            saddrcontext->number);
-
-      iphc1   |= SIXLOWPAN_IPHC_SAC;
-      iphc[2] |= saddrcontext->number << 4;
-
-      /* Compression compare with this nodes address (source) */
-
-      iphc1   |= compress_laddr(ipv6->srcipaddr,
-                                &radio->r_dev.d_mac.radio,
-                                SIXLOWPAN_IPHC_SAM_BIT);
-    }
-
-  /* No address context found for the source address */
-
-  else if (net_is_addr_linklocal(ipv6->srcipaddr) &&
-           ipv6->srcipaddr[1] == 0 &&  ipv6->srcipaddr[2] == 0 &&
-           ipv6->srcipaddr[3] == 0)
-    {
-      iphc1   |= compress_laddr(ipv6->srcipaddr,
-                                &radio->r_dev.d_mac.radio,
-                                SIXLOWPAN_IPHC_SAM_BIT);
+      memcpy(g_hc06ptr, cache->hc_addr, cache->hc_addrlen);
+      g_hc06ptr += cache->hc_addrlen;
     }
   else
-    {
-      /* Send the full source address ipaddr:  SAC = 0, SAM = 00 */
-
-      ninfo("Uncompressable "
-            "srcipaddr=%04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
-            NTOHS(ipv6->srcipaddr[0]), NTOHS(ipv6->srcipaddr[1]),
-            NTOHS(ipv6->srcipaddr[2]), NTOHS(ipv6->srcipaddr[3]),
-            NTOHS(ipv6->srcipaddr[4]), NTOHS(ipv6->srcipaddr[5]),
-            NTOHS(ipv6->srcipaddr[6]), NTOHS(ipv6->srcipaddr[7]));
-
-      iphc1 |= SIXLOWPAN_IPHC_SAM_128;   /* 128-bits */
-      memcpy(g_hc06ptr, ipv6->srcipaddr, 16);
-      g_hc06ptr += 16;
-    }
-
-  /* Destination address */
-
-  if (net_is_addr_mcast(ipv6->destipaddr))
-    {
-      /* Address is multicast, try to compress */
-
-      iphc1 |= SIXLOWPAN_IPHC_M;
-      if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE8(ipv6->destipaddr))
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_8;
-
-          /* Use "last" byte ("last" meaning the LS byte in host order.
-           * destipaddr is in big-endian network order).
-           */
-
-#ifdef CONFIG_ENDIAN_BIG
-          *g_hc06ptr = (ipv6->destipaddr[7] & 0xff);
-#else
-          *g_hc06ptr = (ipv6->destipaddr[7] >> 8);
 #endif
-          g_hc06ptr += 1;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE32(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_32;
-
-          /* Second byte + the last three */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[13], 3);
-          g_hc06ptr += 4;
-        }
-      else if (SIXLOWPAN_IS_MCASTADDR_COMPRESSABLE48(ipv6->destipaddr))
-        {
-          FAR uint8_t *iptr = (FAR uint8_t *)ipv6->destipaddr;
-
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_48;
-
-          /* Second byte + the last five */
-
-          *g_hc06ptr = iptr[1];
-          memcpy(g_hc06ptr + 1, &iptr[11], 5);
-          g_hc06ptr += 6;
-        }
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_MDAM_128;
-
-          /* Full address */
-
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
-    }
-  else
     {
-      /* Address is unicast, try to compress */
-
-      if (daddrcontext != NULL)
-        {
-          /* Elide the prefix */
-
-          ninfo("Compressing dest with address context. "
-                "Setting DAC. Context: %d\n",
-                daddrcontext->number);
-
-          iphc1   |= SIXLOWPAN_IPHC_DAC;
-          iphc[2] |= daddrcontext->number;
-
-          /* Compession compare with link address (destination) */
-
-          iphc1   |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                      SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* No address context found for this address */
-
-      else if (net_is_addr_linklocal(ipv6->destipaddr) &&
-               ipv6->destipaddr[1] == 0 && ipv6->destipaddr[2] == 0 &&
-               ipv6->destipaddr[3] == 0)
-        {
-          iphc1 |= compress_tagaddr(ipv6->destipaddr, destmac,
-                                    SIXLOWPAN_IPHC_DAM_BIT);
-        }
-
-      /* Send the full address */
-
-      else
-        {
-          iphc1 |= SIXLOWPAN_IPHC_DAM_128;       /* 128-bits */
-          memcpy(g_hc06ptr, ipv6->destipaddr, 16);
-          g_hc06ptr += 16;
-        }
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+      addrptr = g_hc06ptr;
+#endif
+      iphc1  |= compress_addrs(radio, ipv6, destmac, saddrcontext,
+                               daddrcontext, iphc);
+#if CONFIG_NET_6LOWPAN_HC06_CACHE > 0
+      hc06_cache_add(radio, ipv6, destmac, iphc1, iphc[2], addrptr,
+                     g_hc06ptr - addrptr);
+#endif
     }
 
   g_uncomp_hdrlen = IPv6_HDRLEN;
@@ -46,6 +46,11 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* Active reassembly buffers are hashed by tag and fragment source */
+
+#define REASS_NBUCKETS (1 << CONFIG_NET_6LOWPAN_REASS_HASH_BITS)
+#define REASS_MASK     (REASS_NBUCKETS - 1)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -57,9 +62,9 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* These are the lists of active, allocated reassemby buffers */
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_NBUCKETS];
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -67,9 +72,32 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Get the active list of a reassembly tag and fragment source.
+ *
  ****************************************************************************/
 
+static FAR struct sixlowpan_reassbuf_s **
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  uint32_t hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash = hash * 31 + fragsrc->nv_addr[i];
+    }
+
+  return &g_active_reass[(hash ^ (hash >> 8)) & REASS_MASK];
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -124,36 +152,43 @@ static void sixlowpan_reass_expire(void)
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
   clock_t elapsed;
+  clock_t now = clock_systime_ticks();
+  int i;
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_NBUCKETS; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not certain.
-       */
-
-      if (!reass->rb_active)
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
         {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
-          /* Get the elpased time of the reassembly */
+          /* Needed if 'reass' is freed */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          next = reass->rb_flink;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* Free any inactive reassembly buffers.  This is done because the
+           * life the reassembly buffer is not certain.
+           */
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          if (!reass->rb_active)
             {
-              nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
+          else
+            {
+              /* Get the elpased time of the reassembly */
+
+              elapsed = now - reass->rb_time;
+
+              /* If the reassembly has expired, then free the reassembly
+               * buffer
+               */
+
+              if (elapsed >= NET_6LOWPAN_TIMEOUT)
+                {
+                  nwarn("WARNING: Reassembly timed out\n");
+                  sixlowpan_reass_free(reass);
+                }
+            }
         }
     }
 }
@@ -177,12 +212,14 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = sixlowpan_reass_hash(reass->rb_reasstag, &reass->rb_fragsrc);
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -196,7 +233,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -281,6 +318,7 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
@@ -328,8 +366,9 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head              = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink   = *head;
+      *head             = reass;
     }
 
   return reass;
@@ -359,27 +398,37 @@ FAR struct sixlowpan_reassbuf_s *
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  FAR struct sixlowpan_reassbuf_s *next;
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
-   */
-
-  sixlowpan_reass_expire();
-
-  /* Now search for the matching reassembly buffer in the remainng, active
-   * reassembly buffers.
+  /* Search for the matching reassembly buffer in the active reassembly
+   * buffers of the same hash.  The full sweep of expired buffers is left
+   * to sixlowpan_reass_allocate(), this runs for every fragment.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = *sixlowpan_reass_hash(reasstag, fragsrc); reass != NULL;
+       reass = next)
     {
+      next = reass->rb_flink;
+
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
        * reassembly tag).
        */
 
-      if (reass->rb_reasstag == reasstag &&
+      if (reass->rb_active && reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the same
+           * tag.
+           */
+
+          if (clock_systime_ticks() - reass->rb_time >= NET_6LOWPAN_TIMEOUT)
+            {
+              nwarn("WARNING: Reassembly timed out\n");
+              sixlowpan_reass_free(reass);
+              continue;
+            }
+
           return reass;
         }
     }
@@ -412,10 +461,13 @@ FAR struct sixlowpan_reassbuf_s *
 void sixlowpan_reass_free(FAR struct sixlowpan_reassbuf_s *reass)
 {
   /* First, remove the reassembly buffer from the list of active reassembly
-   * buffers.
+   * buffers.  Buffers provided by the radio driver were never in it.
    */
 
-  sixlowpan_remove_active(reass);
+  if (reass->rb_pool != REASS_POOL_RADIO)
+    {
+      sixlowpan_remove_active(reass);
+    }
 
   /* If this is a pre-allocated reassembly buffer structure, then just put it
    * back in the free list.
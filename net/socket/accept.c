@@ -150,6 +150,13 @@ int psock_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   ret = psock->s_sockif->si_accept(psock, addr, addrlen, newsock, flags);
   if (ret >= 0)
     {
+#ifdef CONFIG_NET_BUSY_POLL
+      /* The accepted socket inherits the busy poll time */
+
+      ((FAR struct socket_conn_s *)newsock->s_conn)->s_busypoll =
+        conn->s_busypoll;
+#endif
+
       /* Mark the new socket as connected. */
 
       conn = newsock->s_conn;
@@ -205,6 +205,19 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:  /* Busy poll time of blocking receive */
+        {
+          if (*value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = (int)conn->s_busypoll;
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -42,6 +42,7 @@
 #include "bluetooth/bluetooth.h"
 #include "ieee802154/ieee802154.h"
 #include "socket/socket.h"
+#include "xdp/xdp.h"
 
 /****************************************************************************
  * Private Function Prototypes
@@ -266,6 +267,12 @@ net_sockif(sa_family_t family, int type, int protocol)
       break;
 #endif
 
+#ifdef CONFIG_NET_XDP
+    case PF_XDP:
+      sockif = &g_xdp_sockif;
+      break;
+#endif
+
     default:
       nerr("ERROR: Address family unsupported: %d\n", family);
     }
@@ -0,0 +1,228 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives a vector of messages from a socket.  This is
+ *   an internal OS interface. It is functionally equivalent to recvmmsg()
+ *   except that:
+ *
+ *   - It is not a cancellation point,
+ *   - It does not modify the errno variable, and
+ *   - It accepts the internal socket structure as an input rather than an
+ *     task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Buffers to receive the messages; msg_len receives the bytes
+ *             received for each
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags
+ *   timeout   If not NULL, no more messages are received once this time
+ *             has elapsed after the call
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  Otherwise, if
+ *   not even the first message could be received, a negated errno value is
+ *   returned (see comments with recvmsg() for a list of appropriate errno
+ *   values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout)
+{
+  FAR struct msghdr *msg;
+  clock_t end = 0;
+  unsigned int i;
+  ssize_t ret;
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_conn == NULL)
+    {
+      return -EBADF;
+    }
+
+  if (msgvec == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Only the buffers before the first malformed one are filled */
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL ||
+          (msg->msg_name != NULL && msg->msg_namelen <= 0))
+        {
+          if (i == 0)
+            {
+              return -EINVAL;
+            }
+
+          vlen = i;
+          break;
+        }
+    }
+
+  if (vlen == 0)
+    {
+      return 0;
+    }
+
+  /* Let logic specific to this address family receive the batch, if it
+   * can.
+   */
+
+  DEBUGASSERT(psock->s_sockif != NULL &&
+              psock->s_sockif->si_recvmsg != NULL);
+
+  if (psock->s_sockif->si_recvmmsg != NULL)
+    {
+      ret = psock->s_sockif->si_recvmmsg(psock, msgvec, vlen, flags,
+                                         timeout);
+      if (ret != -ENOSYS)
+        {
+          return ret;
+        }
+    }
+
+  /* If not, revert to receiving the messages one by one */
+
+  if (timeout != NULL)
+    {
+      end = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  for (i = 0; i < vlen; i++)
+    {
+      if (i > 0 && timeout != NULL &&
+          clock_compare(end, clock_systime_ticks()))
+        {
+          break;
+        }
+
+      ret = psock_recvmsg(psock, &msgvec[i].msg_hdr, flags);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      /* MSG_WAITFORONE: only the first message may block */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  return i > 0 ? i : ret;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   The recvmmsg() call receives several messages with a single call, as
+ *   if by a recvmsg() for each entry of msgvec.
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Buffers to receive the messages; msg_len receives the bytes
+ *            received for each
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags.  MSG_WAITFORONE sets MSG_DONTWAIT after the
+ *            first message has been received.
+ *   timeout  If not NULL, no more messages are received once this time
+ *            has elapsed.  It is only checked after each message, so it
+ *            does not bound the wait for any single one.
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received, which may be
+ *   less than vlen.  If not even the first message could be received, -1
+ *   is returned, and errno is set as for recvmsg().
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  ret = sockfd_socket(sockfd, &filep, &psock);
+
+  /* Let psock_recvmmsg() do all of the work */
+
+  if (ret == OK)
+    {
+      ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+      file_put(filep);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
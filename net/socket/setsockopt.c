@@ -178,6 +178,27 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:   /* Busy poll time of blocking receive */
+        {
+          int usec;
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          usec = *(FAR int *)value;
+          if (usec < 0)
+            {
+              return -EINVAL;
+            }
+
+          conn->s_busypoll = usec;
+        }
+        break;
+#endif
+
 #ifdef CONFIG_NET_BINDTODEVICE
       /* Handle the SO_BINDTODEVICE socket-level option.
        *
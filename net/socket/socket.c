@@ -151,6 +151,10 @@ int psock_socket(int domain, int type, int protocol,
           conn->s_flags |= _SF_NONBLOCK;
         }
 
+#ifdef CONFIG_NET_BUSY_POLL
+      conn->s_busypoll = CONFIG_NET_BUSY_POLL_DEFAULT;
+#endif
+
       /* The socket has been successfully initialized */
 
       conn->s_flags |= _SF_INITD;
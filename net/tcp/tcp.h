@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -40,6 +41,10 @@
 #include <nuttx/net/tcp.h>
 #include <nuttx/wqueue.h>
 
+#ifdef CONFIG_NET_TCP_PACING
+#  include <nuttx/hrtimer.h>
+#endif
+
 #ifdef NET_TCP_HAVE_STACK
 
 /****************************************************************************
@@ -69,7 +74,7 @@
 #  define TCP_WBPKTLEN(wrb)          ((wrb)->wb_iob->io_pktlen)
 #  define TCP_WBSENT(wrb)            ((wrb)->wb_sent)
 #  define TCP_WBNRTX(wrb)            ((wrb)->wb_nrtx)
-#if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
+#if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC)
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
@@ -106,7 +111,7 @@
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
 /* The TCP flags for congestion control */
 
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
@@ -127,6 +132,19 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+/* Internal psock_tcp_send() flag: the MSG_ZEROCOPY data was gathered into
+ * a temporary buffer and must be copied, but still gets a completion.
+ */
+
+#  define TCP_MSG_ZCCOPY      0x40000000
+
+/* True if MSG_ZEROCOPY completions wait to be read from the error queue */
+
+#  define tcp_zerocopy_pending(conn) \
+     ((conn)->zc_done != (conn)->zc_reported)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -135,6 +153,7 @@ struct file;      /* Forward reference */
 struct sockaddr;  /* Forward reference */
 struct socket;    /* Forward reference */
 struct pollfd;    /* Forward reference */
+struct tcp_tls_s; /* Forward reference */
 
 /* Representation of a TCP connection.
  *
@@ -176,6 +195,94 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_CC
+/* A congestion control algorithm.  The framework in tcp_cc.c detects the
+ * losses and runs fast retransmit and fast recovery, the algorithm decides
+ * how the window grows and how far it backs off.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+
+  /* init - Optional, reset the private state of the algorithm (conn->cc),
+   *        cwnd and ssthresh are already initialized.
+   */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* ssthresh - Return the slow start threshold after a loss, detected by
+   *            duplicate ACKs or by a retransmission timeout.
+   */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* cong_avoid - Grow cwnd on an ACK of new data outside fast recovery,
+   *              in slow start as well as in congestion avoidance.
+   */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* pkts_acked - Optional, called on every ACK of new data, including
+   *              those during fast recovery.
+   */
+
+  CODE void (*pkts_acked)(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                          uint32_t acked);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+struct tcp_cubic_s
+{
+  clock_t  epoch;         /* Start of the current growth epoch */
+  uint32_t w_max;         /* Window before the last reduction */
+  uint32_t origin;        /* Window at the plateau of the cubic curve */
+  uint32_t w_est;         /* Window estimate of a Reno flow */
+  uint32_t k;             /* Time from the epoch to the plateau, in ms */
+  bool     in_epoch;      /* The growth epoch has started */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+struct tcp_bbr_s
+{
+  clock_t  round_start;   /* Start of the current round trip */
+  clock_t  min_rtt_stamp; /* When min_rtt was measured */
+  clock_t  probe_rtt_end; /* End of the current PROBE_RTT phase */
+  uint32_t round_end;     /* The ACK of this sequence ends the round */
+  uint32_t delivered;     /* Bytes ACKed in the current round */
+  uint32_t btl_bw;        /* Bottleneck bandwidth, bytes per second */
+  uint32_t full_bw;       /* Bandwidth at the last STARTUP growth */
+  uint32_t min_rtt;       /* Minimum RTT, in ms */
+  uint32_t prior_cwnd;    /* cwnd before PROBE_RTT */
+  uint8_t  bw_age;        /* Rounds since btl_bw was measured */
+  uint8_t  full_cnt;      /* Rounds without STARTUP growth */
+  uint8_t  mode;          /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  cycle;         /* Phase of the PROBE_BW gain cycle */
+  bool     filled;        /* STARTUP found the bottleneck bandwidth */
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC */
+
+#ifdef CONFIG_NET_TCP_PACING
+/* Pacing of the write queue.  All times are in nanoseconds of the high
+ * resolution clock.
+ */
+
+struct tcp_pacing_s
+{
+  hrtimer_t     timer;    /* Releases the next segment */
+  struct work_s work;     /* Polls the device out of the timer context */
+  uint64_t      next;     /* Earliest time to send the next segment */
+  uint64_t      stamp;    /* When the RTT sample was sent */
+  uint32_t      seq;      /* The ACK of this sequence ends the sample */
+  uint32_t      srtt;     /* Smoothed RTT in us, zero until measured */
+  uint32_t      max_rate; /* SO_MAX_PACING_RATE in bytes/s, zero: none */
+  bool          sampling; /* An RTT sample is in flight */
+  bool          armed;    /* The timer is started */
+};
+#endif
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -208,6 +315,10 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hash_node_t hnode;      /* Link in the connection hashtable, or in the
+                           * listener hashtable while listening */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -243,7 +354,7 @@ struct tcp_conn_s
                            * connection */
 #endif
   uint32_t rcv_adv;       /* The right edge of the recv window advertised */
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
   uint32_t last_ackno;    /* The ack number at the last receive ack */
   uint32_t dupacks;       /* The number of duplicate ack */
   uint32_t fr_recover;    /* The snd_seq at the retransmissions */
@@ -251,6 +362,21 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  /* The congestion control algorithm and its private state */
+
+  FAR const struct tcp_cc_ops_s *cc_ops;
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_BBR)
+  union
+  {
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+    struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+    struct tcp_bbr_s bbr;
+#endif
+  } cc;
+#endif
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -325,6 +451,21 @@ struct tcp_conn_s
   uint32_t   isn;         /* Initial sequence number */
   uint32_t   sndseq_max;  /* The sequence number of next not-retransmitted
                            * segment (next greater sndseq) */
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY completion counters, in units of send calls:
+   *
+   *   zc_next     - The number of MSG_ZEROCOPY calls queued so far
+   *   zc_done     - The number of calls whose data has been released
+   *   zc_reported - The number of completions read from the error queue
+   */
+
+  uint32_t   zc_next;
+  uint32_t   zc_done;
+  uint32_t   zc_reported;
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  struct tcp_pacing_s pacing;
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCPBACKLOG
@@ -360,6 +501,12 @@ struct tcp_conn_s
 #endif
   bool       zero_probe;   /* TCP zero window probe timer */
 
+#ifdef CONFIG_NET_TCP_TLS
+  /* The kernel TLS state, NULL until the "tls" ULP is attached */
+
+  FAR struct tcp_tls_s *tls;
+#endif
+
   /* connevents is a list of callbacks for each socket the uses this
    * connection (there can be more that one in the event that the the socket
    * was dup'ed).  It is used with the network monitor to handle
@@ -410,8 +557,12 @@ struct tcp_wrbuffer_s
   uint16_t   wb_sent;      /* Number of bytes sent from the I/O buffer chain */
   uint8_t    wb_nrtx;      /* The number of retransmissions for the last
                             * segment sent */
-#if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
+#if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  uint32_t   wb_zcid;      /* zc_next of the last MSG_ZEROCOPY call with
+                            * data in this buffer, zero if none */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -454,6 +605,18 @@ extern "C"
 {
 #endif
 
+/* The congestion control algorithms */
+
+#ifdef CONFIG_NET_TCP_CC
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#endif
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -1960,6 +2123,189 @@ void tcp_wrbuffer_dump(FAR const char *msg, FAR struct tcp_wrbuffer_s *wrb,
 #endif
 #endif /* CONFIG_NET_TCP_WRITE_BUFFERS */
 
+/****************************************************************************
+ * Name: tcp_zerocopy_append
+ *
+ * Description:
+ *   Append caller's data to a write buffer without copying it: the data is
+ *   referenced in place by a heap allocated IOB that has no free space, so
+ *   that later copies into the chain can never write into it.
+ *
+ * Input Parameters:
+ *   wrb - The write buffer to append to
+ *   buf - The data, which must stay unmodified until the send completes
+ *   len - The number of bytes to append
+ *
+ * Returned Value:
+ *   The number of bytes appended, which may be less than len, or -ENOMEM.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+ssize_t tcp_zerocopy_append(FAR struct tcp_wrbuffer_s *wrb,
+                            FAR const void *buf, size_t len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   Account for the release of a write buffer of the connection: all of
+ *   the MSG_ZEROCOPY calls up to the one tagged on the buffer are complete.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+void tcp_zerocopy_release(FAR struct tcp_conn_s *conn,
+                          FAR struct tcp_wrbuffer_s *wrb);
+#else
+#  define tcp_zerocopy_release(conn,wrb)
+#endif
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): report the range of MSG_ZEROCOPY
+ *   calls that completed since the last report in an IP_RECVERR (or
+ *   IPV6_RECVERR) control message.  Never blocks.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket
+ *   msg   - Receives the control message
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if there is nothing to report.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+ssize_t tcp_zerocopy_recverr(FAR struct socket *psock,
+                             FAR struct msghdr *msg);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_attach
+ *
+ * Description:
+ *   Attach the "tls" upper layer protocol (TCP_ULP) to a connected socket.
+ *   The record layer is not active until the keys are installed.
+ *
+ * Returned Value:
+ *   Zero on success, -EEXIST if already attached, -ENOTCONN if the socket
+ *   is not connected or -ENOMEM.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+int tcp_tls_attach(FAR struct socket *psock);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_setsockopt
+ *
+ * Description:
+ *   Handle the SOL_TLS socket options: install the keys of one direction
+ *   (TLS_TX or TLS_RX) from a tls12_crypto_info_* structure.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOPROTOOPT if the ULP is not attached, -EBUSY if
+ *   the keys of that direction are already installed, -EINVAL for a bad
+ *   crypto_info, -ENOTSUP if no crypto driver supports the cipher.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+int tcp_tls_setsockopt(FAR struct socket *psock, int option,
+                       FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_enabled
+ *
+ * Description:
+ *   True if the keys of the direction (TLS_TX or TLS_RX) are installed and
+ *   the data of the socket goes through the record layer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+bool tcp_tls_enabled(FAR struct tcp_conn_s *conn, int dir);
+#else
+#  define tcp_tls_enabled(conn,dir) false
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_rxpending
+ *
+ * Description:
+ *   True if decrypted data is buffered and can be read without blocking.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+bool tcp_tls_rxpending(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_send
+ *
+ * Description:
+ *   Send plaintext through the record layer: the data is cut into records
+ *   of at most 16KiB, each one sealed and queued as a whole on the TCP
+ *   connection.
+ *
+ * Returned Value:
+ *   The number of plaintext bytes consumed, or a negated errno value if
+ *   none was.  A record only partially queued by a non-blocking send is
+ *   completed by the next call.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+ssize_t tcp_tls_send(FAR struct socket *psock, FAR const void *buf,
+                     size_t len, int flags);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_recvmsg
+ *
+ * Description:
+ *   Receive plaintext through the record layer.  The data of one record
+ *   is returned at most per call; a record that is not application data
+ *   has its content type reported in a TLS_GET_RECORD_TYPE control
+ *   message, or fails with -EIO if msg has no room for it.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero at the end of the stream, or a
+ *   negated errno value: -EBADMSG if a record fails authentication, in
+ *   which case the connection can no longer be read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+ssize_t tcp_tls_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                        int flags);
+#endif
+
+/****************************************************************************
+ * Name: tcp_tls_free
+ *
+ * Description:
+ *   Release the kernel TLS state of a connection being freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TLS
+void tcp_tls_free(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_pollsetup
  *
@@ -2313,7 +2659,7 @@ bool tcp_reorder_ofosegs(int nofosegs, FAR struct tcp_ofoseg_s *ofosegs);
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
 void tcp_cc_init(FAR struct tcp_conn_s *conn);
 
 /****************************************************************************
@@ -2356,6 +2702,157 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout:
+ *   leave fast recovery and restart from slow start.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_rto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by the acknowledged bytes, at most one MSS (RFC 5681), for
+ *   the congestion control algorithms.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of newly acknowledged bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The name of the algorithm.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_PACING
+/****************************************************************************
+ * Name: tcp_pacing_ready
+ *
+ * Description:
+ *   Check if the pacing of a connection allows to send a segment now.  If
+ *   not, the pacing timer is started to poll the device when it does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   true if a segment may be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_ready(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account a segment sent on a connection: delay the next one by the
+ *   time the segment takes at the pacing rate and start an RTT sample if
+ *   none is in flight.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   seq    - The sequence number of the first byte of the segment
+ *   len    - The length of the segment
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t seq,
+                     uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_pacing_ack
+ *
+ * Description:
+ *   Complete the RTT sample of a connection once it has been ACKed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackno  - The received ACK number
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_ack(FAR struct tcp_conn_s *conn, uint32_t ackno);
+
+/****************************************************************************
+ * Name: tcp_pacing_stop
+ *
+ * Description:
+ *   Stop the pacing timer of a connection when it is freed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_pacing_stop(FAR struct tcp_conn_s *conn);
 #endif
 
 #ifdef __cplusplus
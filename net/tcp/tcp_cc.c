@@ -24,7 +24,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+
 #include <debug.h>
+#include <errno.h>
+#include <string.h>
 
 #include "tcp/tcp.h"
 
@@ -74,10 +78,102 @@
     } \
  } while(0)
 
+/* The algorithm of new connections */
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_BBR)
+#  define TCP_CC_DEFAULT (&g_tcp_cc_bbr)
+#else
+#  define TCP_CC_DEFAULT (&g_tcp_cc_newreno)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                               uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",          /* name */
+  NULL,               /* init */
+  newreno_ssthresh,   /* ssthresh */
+  newreno_cong_avoid, /* cong_avoid */
+  NULL,               /* pkts_acked */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Slow start and congestion avoidance of RFC 5681.
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +199,11 @@
 
 void tcp_cc_init(FAR struct tcp_conn_s *conn)
 {
+  if (conn->cc_ops == NULL)
+    {
+      conn->cc_ops = TCP_CC_DEFAULT;
+    }
+
   CC_INIT_CWND(conn->cwnd, conn->mss);
 
   /* RFC 5681 recommends setting ssthresh arbitrarily high and
@@ -117,6 +218,11 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  if (conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -140,15 +246,14 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
+  /* After Fast retransmitted, let the algorithm set ssthresh and enter to
+   * Fast Recovery.
    * cwnd=ssthresh + 3*SMSS  referring to rfc5681
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc_ops->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -243,6 +348,11 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       conn->dupacks = 0;
       conn->last_ackno = ackno;
 
+      if (conn->cc_ops->pkts_acked != NULL)
+        {
+          conn->cc_ops->pkts_acked(conn, ackno, acked);
+        }
+
       /* When the ackno covers more than the fr_recover, exit the
        * fast recovery. Then, reset the "IN Fast Recovery" flags.
        * Also reset the congestion window to the slow start threshold.
@@ -269,34 +379,141 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc_ops->cong_avoid(conn, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_rto
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout:
+ *   leave fast recovery and restart from slow start.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_rto(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
-            {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+  conn->flags &= ~TCP_INFR;
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+  /* update the max_cwnd */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
-            }
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc_ops->ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Grow cwnd by the acknowledged bytes, at most one MSS (RFC 5681), for
+ *   the congestion control algorithms.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   acked  - The number of newly acknowledged bytes
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  /* slow start (RFC 5681):
+   * Grow cwnd exponentially by maxseg(smss) per ACK.
+   */
+
+  uint32_t increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+  CC_CWND_INC(conn->cwnd, increase);
+  ninfo("update slow start cwnd to %u\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no such algorithm.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc); i++)
+    {
+      if (strcmp(g_tcp_cc[i]->name, name) == 0)
+        {
+          break;
         }
     }
+
+  if (i >= nitems(g_tcp_cc))
+    {
+      return -ENOENT;
+    }
+
+  /* A connection already under way keeps its window, only the private
+   * state of the new algorithm starts afresh.
+   */
+
+  conn->cc_ops = g_tcp_cc[i];
+  if ((conn->tcpstateflags & TCP_STATE_MASK) > TCP_ALLOCATED &&
+      conn->cc_ops->init != NULL)
+    {
+      conn->cc_ops->init(conn);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_name
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The name of the algorithm.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_name(FAR struct tcp_conn_s *conn)
+{
+  return conn->cc_ops != NULL ? conn->cc_ops->name : TCP_CC_DEFAULT->name;
 }
@@ -0,0 +1,335 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Gains are scaled by BBR_UNIT */
+
+#define BBR_UNIT             256
+#define BBR_HIGH_GAIN        739  /* 2 / ln(2), STARTUP and DRAIN */
+#define BBR_CWND_GAIN        512  /* 2, PROBE_BW */
+#define BBR_FULL_BW_GAIN     320  /* 1.25, growth expected in STARTUP */
+
+#define BBR_FULL_BW_CNT      3     /* Rounds without growth to leave
+                                    * STARTUP */
+#define BBR_BW_RTTS          10    /* Rounds the bandwidth is kept */
+#define BBR_MIN_RTT_WIN_MS   10000 /* How long min_rtt is kept */
+#define BBR_PROBE_RTT_MS     200   /* Time spent in PROBE_RTT */
+#define BBR_MIN_CWND_SEGS    4
+
+#define BBR_CYCLE_LEN        8
+
+/* Smoothed RTT in milliseconds, conn->sa is eight times the RTT in half
+ * seconds.  It only seeds min_rtt until the first round is measured.
+ */
+
+#define BBR_SRTT_MS(conn)    ((uint32_t)(conn)->sa * 500 / 8)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum bbr_mode_e
+{
+  BBR_STARTUP,   /* Ramp up to find the bottleneck bandwidth */
+  BBR_DRAIN,     /* Drain the queue built up in STARTUP */
+  BBR_PROBE_BW,  /* Cycle around the bandwidth-delay product */
+  BBR_PROBE_RTT  /* Shrink the window to measure min_rtt again */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn);
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void bbr_pkts_acked(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                           uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",            /* name */
+  bbr_init,         /* init */
+  bbr_ssthresh,     /* ssthresh */
+  bbr_cong_avoid,   /* cong_avoid */
+  bbr_pkts_acked,   /* pkts_acked */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The PROBE_BW gains: probe for more bandwidth, drain what that queued,
+ * then cruise.  With no pacing in the stack they scale the window gain.
+ */
+
+static const uint16_t g_bbr_cycle_gain[BBR_CYCLE_LEN] =
+{
+  320, 192, 256, 256, 256, 256, 256, 256
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_target
+ *
+ * Description:
+ *   The window of the current phase: gain * bottleneck bandwidth * min_rtt,
+ *   or zero while there is no model yet.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_target(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint64_t bdp;
+  uint32_t gain;
+
+  if (bbr->btl_bw == 0 || bbr->min_rtt == UINT32_MAX)
+    {
+      return 0;
+    }
+
+  switch (bbr->mode)
+    {
+      case BBR_PROBE_BW:
+        gain = BBR_CWND_GAIN * g_bbr_cycle_gain[bbr->cycle] / BBR_UNIT;
+        break;
+
+      case BBR_PROBE_RTT:
+        return BBR_MIN_CWND_SEGS * conn->mss;
+
+      default:
+        gain = BBR_HIGH_GAIN;
+        break;
+    }
+
+  bdp = (uint64_t)bbr->btl_bw * bbr->min_rtt / 1000;
+  bdp = bdp * gain / BBR_UNIT;
+
+  return MAX(MIN(bdp, UINT32_MAX / 2), BBR_MIN_CWND_SEGS * conn->mss);
+}
+
+/****************************************************************************
+ * Name: bbr_new_round
+ *
+ * Description:
+ *   Run the state machine once a round trip.
+ *
+ ****************************************************************************/
+
+static void bbr_new_round(FAR struct tcp_conn_s *conn, clock_t now)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+
+        /* The pipe is full once the bandwidth stops growing by 25% per
+         * round, for a few rounds.
+         */
+
+        if ((uint64_t)bbr->btl_bw * BBR_UNIT >=
+            (uint64_t)bbr->full_bw * BBR_FULL_BW_GAIN)
+          {
+            bbr->full_bw  = bbr->btl_bw;
+            bbr->full_cnt = 0;
+          }
+        else if (++bbr->full_cnt >= BBR_FULL_BW_CNT)
+          {
+            bbr->filled = true;
+            bbr->mode   = BBR_DRAIN;
+          }
+        break;
+
+      case BBR_DRAIN:
+        if (conn->tx_unacked <= (uint64_t)bbr->btl_bw * bbr->min_rtt / 1000)
+          {
+            bbr->mode  = BBR_PROBE_BW;
+            bbr->cycle = 2;
+          }
+        break;
+
+      case BBR_PROBE_BW:
+        bbr->cycle = (bbr->cycle + 1) % BBR_CYCLE_LEN;
+        break;
+
+      case BBR_PROBE_RTT:
+        if ((sclock_t)(now - bbr->probe_rtt_end) >= 0)
+          {
+            bbr->min_rtt_stamp = now;
+            bbr->mode          = bbr->filled ? BBR_PROBE_BW : BBR_STARTUP;
+            conn->cwnd         = MAX(conn->cwnd, bbr->prior_cwnd);
+          }
+        break;
+    }
+
+  /* min_rtt was not seen for long, shrink the window to drain the queue
+   * and measure it again.
+   */
+
+  if (bbr->mode != BBR_PROBE_RTT &&
+      now - bbr->min_rtt_stamp > MSEC2TICK(BBR_MIN_RTT_WIN_MS))
+    {
+      bbr->mode          = BBR_PROBE_RTT;
+      bbr->prior_cwnd    = conn->cwnd;
+      bbr->probe_rtt_end = now + MSEC2TICK(BBR_PROBE_RTT_MS);
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t now = clock_systime_ticks();
+
+  memset(bbr, 0, sizeof(*bbr));
+  bbr->round_start   = now;
+  bbr->min_rtt_stamp = now;
+  bbr->round_end     = tcp_getsequence(conn->sndseq);
+  bbr->min_rtt       = conn->sa != 0 ? BBR_SRTT_MS(conn) : UINT32_MAX;
+  bbr->mode          = BBR_STARTUP;
+}
+
+/****************************************************************************
+ * Name: bbr_ssthresh
+ *
+ * Description:
+ *   BBR does not back off on a loss, the window is restored after the
+ *   recovery or the retransmission timeout.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->cwnd, BBR_MIN_CWND_SEGS * conn->mss);
+}
+
+/****************************************************************************
+ * Name: bbr_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd by the acknowledged bytes up to the window of the model,
+ *   without limit until the model says the pipe is full.
+ *
+ ****************************************************************************/
+
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  uint32_t target = bbr_target(conn);
+  uint32_t cwnd = conn->cwnd;
+
+  if (bbr->mode == BBR_PROBE_RTT)
+    {
+      cwnd = MIN(cwnd, target);
+    }
+  else if (bbr->filled && target != 0)
+    {
+      cwnd = MIN(cwnd + acked, target);
+    }
+  else if (target == 0 || cwnd < target)
+    {
+      cwnd = cwnd + acked > cwnd ? cwnd + acked : cwnd;
+    }
+
+  conn->cwnd = MAX(cwnd, BBR_MIN_CWND_SEGS * conn->mss);
+  ninfo("update bbr cwnd to %" PRIu32 "\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: bbr_pkts_acked
+ *
+ * Description:
+ *   Count the delivered bytes, and once a round trip sample the
+ *   bandwidth and the RTT: a round ends with the ACK of the data sent
+ *   when it started.
+ *
+ ****************************************************************************/
+
+static void bbr_pkts_acked(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                           uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->cc.bbr;
+  clock_t now;
+  uint32_t rtt;
+  uint64_t bw;
+
+  bbr->delivered += acked;
+  if (TCP_SEQ_LT(ackno, bbr->round_end))
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+  rtt = MAX(TICK2MSEC(now - bbr->round_start), 1);
+
+  /* Windowed min of the RTT and max of the bandwidth */
+
+  if (rtt <= bbr->min_rtt ||
+      now - bbr->min_rtt_stamp > MSEC2TICK(BBR_MIN_RTT_WIN_MS))
+    {
+      bbr->min_rtt       = rtt;
+      bbr->min_rtt_stamp = now;
+    }
+
+  bw = (uint64_t)bbr->delivered * 1000 / rtt;
+  bw = MIN(bw, UINT32_MAX);
+  if (bw >= bbr->btl_bw || ++bbr->bw_age > BBR_BW_RTTS)
+    {
+      bbr->btl_bw = bw;
+      bbr->bw_age = 0;
+    }
+
+  bbr->delivered   = 0;
+  bbr->round_start = now;
+  bbr->round_end   = tcp_getsequence(conn->sndseq);
+
+  bbr_new_round(conn, now);
+}
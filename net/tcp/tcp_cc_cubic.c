@@ -0,0 +1,254 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 9438 constants, scaled by 1000: C = 0.4 segments/s^3, beta = 0.7 and
+ * alpha = 3 * (1 - beta) / (1 + beta) of the Reno-friendly region.
+ */
+
+#define CUBIC_C        400
+#define CUBIC_BETA     700
+#define CUBIC_ALPHA    529
+
+/* The largest |t - K| on the curve, in ms */
+
+#define CUBIC_MAX_DELTA_MS 100000
+
+/* Smoothed RTT in milliseconds, conn->sa is eight times the RTT in half
+ * seconds.  NOTE: this is the coarse estimation that the retransmission
+ * timer uses.
+ */
+
+#define CUBIC_SRTT_MS(conn) ((uint32_t)(conn)->sa * 500 / 8)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",          /* name */
+  cubic_init,       /* init */
+  cubic_ssthresh,   /* ssthresh */
+  cubic_cong_avoid, /* cong_avoid */
+  NULL,             /* pkts_acked */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t a)
+{
+  uint64_t root = 0;
+  int shift;
+
+  for (shift = 63; shift >= 0; shift -= 3)
+    {
+      uint64_t next = root << 1;
+
+      root = next;
+      next++;
+      if ((a >> shift) >= 3 * next * (next - 1) + 1)
+        {
+          a -= (3 * next * (next - 1) + 1) << shift;
+          root = next;
+        }
+    }
+
+  return (uint32_t)root;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->cc.cubic, 0, sizeof(conn->cc.cubic));
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   Back off to beta * cwnd and remember where the loss happened as the
+ *   plateau of the next epoch, lowered further if the window is shrinking
+ *   (fast convergence).
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_cubic_s *ca = &conn->cc.cubic;
+  uint32_t cwnd = conn->cwnd;
+
+  ca->in_epoch = false;
+  if (cwnd < ca->w_max)
+    {
+      ca->w_max = (uint64_t)cwnd * (1000 + CUBIC_BETA) / 2000;
+    }
+  else
+    {
+      ca->w_max = cwnd;
+    }
+
+  return MAX((uint64_t)cwnd * CUBIC_BETA / 1000, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards W_cubic(t + RTT) = C * (t - K)^3 + W_max, or along
+ *   the Reno-friendly estimate if that is larger.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *ca = &conn->cc.cubic;
+  clock_t now = clock_systime_ticks();
+  uint64_t delta;
+  uint64_t target;
+  uint32_t increase;
+  uint32_t t;
+
+  /* Only grow a window that is used, an application sending less than
+   * half of it could not tell whether the path takes more.
+   */
+
+  if (2 * ((uint64_t)conn->tx_unacked + acked) < conn->cwnd)
+    {
+      return;
+    }
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  if (!ca->in_epoch)
+    {
+      ca->in_epoch = true;
+      ca->epoch    = now;
+      ca->w_est    = conn->cwnd;
+
+      if (conn->cwnd < ca->w_max)
+        {
+          /* K = cubic_root((W_max - cwnd) / C), in ms */
+
+          ca->k      = cubic_root((uint64_t)(ca->w_max - conn->cwnd) *
+                                  (1000000000000ull / CUBIC_C) /
+                                  conn->mss);
+          ca->origin = ca->w_max;
+        }
+      else
+        {
+          ca->k      = 0;
+          ca->origin = conn->cwnd;
+        }
+    }
+
+  /* The window one RTT from now on the cubic curve, in bytes.  The
+   * distance from the plateau is limited to keep the cube in range, the
+   * curve is far beyond any window by then.
+   */
+
+  t     = TICK2MSEC(now - ca->epoch) + CUBIC_SRTT_MS(conn);
+  delta = MIN(t > ca->k ? t - ca->k : ca->k - t, CUBIC_MAX_DELTA_MS);
+  delta = (delta * delta / 1000) * delta / 1000 * CUBIC_C * conn->mss /
+          1000000;
+
+  if (t > ca->k)
+    {
+      target = ca->origin + delta;
+    }
+  else
+    {
+      target = ca->origin > delta ? ca->origin - delta : 0;
+    }
+
+  /* Reno-friendly region: a Reno flow would have grown by alpha segments
+   * per RTT since the epoch.
+   */
+
+  ca->w_est += (uint64_t)acked * conn->mss * CUBIC_ALPHA / 1000 /
+               conn->cwnd;
+  target     = MAX(target, ca->w_est);
+
+  /* Reach the target within one RTT but grow by at most half of the
+   * window per RTT, or creep up slowly at the plateau.
+   */
+
+  if (target > conn->cwnd)
+    {
+      target   = MIN(target, conn->cwnd + conn->cwnd / 2);
+      increase = (target - conn->cwnd) * acked / conn->cwnd;
+    }
+  else
+    {
+      increase = (uint64_t)acked * conn->mss / (100 * (uint64_t)conn->cwnd);
+    }
+
+  increase = MAX(increase, 1);
+  if (conn->cwnd + increase > conn->cwnd)
+    {
+      conn->cwnd += increase;
+    }
+
+  ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+}
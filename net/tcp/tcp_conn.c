@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -95,10 +96,112 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* The same connections, hashed by local port, remote port and remote IP
+ * address.  The local IP address is left out of the key so that a
+ * connection bound to the unspecified address hashes the same way as the
+ * segments addressed to it.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_conn_hash, CONFIG_NET_TCP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/****************************************************************************
+ * Name: tcp_ipv4_key and tcp_ipv6_key
+ *
+ * Description:
+ *   Create the connection hash key from the ports and the remote address.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_key(uint16_t lport, uint16_t rport,
+                                    in_addr_t raddr)
+{
+  return NTOHL(raddr) ^ ((uint32_t)lport << 16) ^ rport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_key(uint16_t lport, uint16_t rport,
+                                    FAR const uint16_t *raddr)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      key ^= ((uint32_t)raddr[i] << 16) | raddr[i + 1];
+    }
+
+  return key;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_key
+ *
+ * Description:
+ *   Return the hash key of a connection.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_conn_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      return tcp_ipv6_key(conn->lport, conn->rport, conn->u.ipv6.raddr);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      return tcp_ipv4_key(conn->lport, conn->rport, conn->u.ipv4.raddr);
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+#endif /* CONFIG_NET_TCP_CONN_HASH */
+
+/****************************************************************************
+ * Name: tcp_activate and tcp_deactivate
+ *
+ * Description:
+ *   Add a connection to, or remove it from, the list of active connections
+ *   (and the connection hashtable).  The ports and addresses must not
+ *   change while the connection is active.
+ *
+ * Assumptions:
+ *   The caller holds the TCP connection list lock.
+ *
+ ****************************************************************************/
+
+static void tcp_activate(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_add(g_tcp_conn_hash, &conn->hnode, tcp_conn_key(conn));
+#endif
+}
+
+static void tcp_deactivate(FAR struct tcp_conn_s *conn)
+{
+  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_delete(g_tcp_conn_hash, &conn->hnode, tcp_conn_key(conn));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -150,6 +253,44 @@ static FAR struct tcp_conn_s *
 #endif
 }
 
+/****************************************************************************
+ * Name: tcp_ipv4_match
+ *
+ * Description:
+ *   Check whether the TCP/IP header is destined for the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline bool tcp_ipv4_match(FAR struct tcp_conn_s *conn,
+                                  FAR struct tcp_hdr_s *tcp,
+                                  in_addr_t srcipaddr, in_addr_t destipaddr)
+{
+  /* Find an open connection matching the TCP input. The following
+   * checks are performed:
+   *
+   * - The local port number is checked against the destination port
+   *   number in the received packet.
+   * - The remote port number is checked if the connection is bound
+   *   to a remote port.
+   * - Insist that the destination IP matches the bound address. If
+   *   a socket is bound to INADDRY_ANY, then it should receive all
+   *   packets directed to the port.
+   * - Finally, if the connection is bound to a remote IP address,
+   *   the source IP address of the packet is checked.
+   *
+   * If all of the above are true then the newly received TCP packet
+   * is destined for this TCP connection.
+   */
+
+  return conn->tcpstateflags != TCP_CLOSED &&
+         tcp->destport == conn->lport &&
+         tcp->srcport  == conn->rport &&
+         (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
+          net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
+         net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr);
+}
+
 /****************************************************************************
  * Name: tcp_ipv4_active
  *
@@ -162,7 +303,6 @@ static FAR struct tcp_conn_s *
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
 static inline FAR struct tcp_conn_s *
   tcp_ipv4_active(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp)
 {
@@ -170,53 +310,85 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *p;
+#endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
-  while (conn)
-    {
-      /* Find an open connection matching the TCP input. The following
-       * checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - Insist that the destination IP matches the bound address. If
-       *   a socket is bound to INADDRY_ANY, then it should receive all
-       *   packets directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked.
-       *
-       * If all of the above are true then the newly received TCP packet
-       * is destined for this TCP connection.
-       */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  /* Only the connections hashing to the same bucket can match */
 
-      if (conn->tcpstateflags != TCP_CLOSED &&
-          tcp->destport == conn->lport &&
-          tcp->srcport  == conn->rport &&
-          (net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY) ||
-           net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
-          net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
+  hashtable_for_every_possible(g_tcp_conn_hash, p,
+                               tcp_ipv4_key(tcp->destport, tcp->srcport,
+                                            srcipaddr))
+    {
+      conn = container_of(p, struct tcp_conn_s, hnode);
+      if (tcp_ipv4_match(conn, tcp, srcipaddr, destipaddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
+    }
+#else
+  for (conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+       conn != NULL;
+       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink)
+    {
+      if (tcp_ipv4_match(conn, tcp, srcipaddr, destipaddr))
+        {
+          /* Matching connection found.. return a reference to it. */
 
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+          return conn;
+        }
     }
+#endif
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
+/****************************************************************************
+ * Name: tcp_ipv6_match
+ *
+ * Description:
+ *   Check whether the TCP/IP header is destined for the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static inline bool tcp_ipv6_match(FAR struct tcp_conn_s *conn,
+                                  FAR struct tcp_hdr_s *tcp,
+                                  FAR net_ipv6addr_t *srcipaddr,
+                                  FAR net_ipv6addr_t *destipaddr)
+{
+  /* Find an open connection matching the TCP input. The following
+   * checks are performed:
+   *
+   * - The local port number is checked against the destination port
+   *   number in the received packet.
+   * - The remote port number is checked if the connection is bound
+   *   to a remote port.
+   * - Insist that the destination IP matches the bound address. If
+   *   a socket is bound to the IPv6 unspecified address, then it
+   *   should receive all packets directed to the port.
+   * - Finally, if the connection is bound to a remote IP address,
+   *   the source IP address of the packet is checked.
+   *
+   * If all of the above are true then the newly received TCP packet
+   * is destined for this TCP connection.
+   */
+
+  return conn->tcpstateflags != TCP_CLOSED &&
+         tcp->destport == conn->lport &&
+         tcp->srcport  == conn->rport &&
+         (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
+          net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
+         net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr);
+}
+
 /****************************************************************************
  * Name: tcp_ipv6_active
  *
@@ -229,7 +401,6 @@ static inline FAR struct tcp_conn_s *
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
 static inline FAR struct tcp_conn_s *
   tcp_ipv6_active(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp)
 {
@@ -237,50 +408,43 @@ static inline FAR struct tcp_conn_s *
   FAR struct tcp_conn_s *conn;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *p;
+#endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
-  while (conn)
-    {
-      /* Find an open connection matching the TCP input. The following
-       * checks are performed:
-       *
-       * - The local port number is checked against the destination port
-       *   number in the received packet.
-       * - The remote port number is checked if the connection is bound
-       *   to a remote port.
-       * - Insist that the destination IP matches the bound address. If
-       *   a socket is bound to the IPv6 unspecified address, then it
-       *   should receive all packets directed to the port.
-       * - Finally, if the connection is bound to a remote IP address,
-       *   the source IP address of the packet is checked.
-       *
-       * If all of the above are true then the newly received TCP packet
-       * is destined for this TCP connection.
-       */
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  /* Only the connections hashing to the same bucket can match */
 
-      if (conn->tcpstateflags != TCP_CLOSED &&
-          tcp->destport == conn->lport &&
-          tcp->srcport  == conn->rport &&
-          (net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr) ||
-           net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
-          net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
+  hashtable_for_every_possible(g_tcp_conn_hash, p,
+                               tcp_ipv6_key(tcp->destport, tcp->srcport,
+                                            *srcipaddr))
+    {
+      conn = container_of(p, struct tcp_conn_s, hnode);
+      if (tcp_ipv6_match(conn, tcp, srcipaddr, destipaddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
+    }
+#else
+  for (conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+       conn != NULL;
+       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink)
+    {
+      if (tcp_ipv6_match(conn, tcp, srcipaddr, destipaddr))
+        {
+          /* Matching connection found.. return a reference to it. */
 
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+          return conn;
+        }
     }
+#endif
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -812,17 +976,24 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_deactivate(conn);
       tcp_conn_list_unlock();
     }
 
   /* Cancel tcp timer */
 
   tcp_stop_timer(conn);
+#ifdef CONFIG_NET_TCP_PACING
+  tcp_pacing_stop(conn);
+#endif
 
   nxrmutex_destroy(&conn->sconn.s_lock);
   tcp_free_rx_buffers(conn);
 
+#ifdef CONFIG_NET_TCP_TLS
+  tcp_tls_free(conn);
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -1132,6 +1303,12 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC
+      conn->cc_ops           = listener->cc_ops;
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+      conn->pacing.max_rate  = listener->pacing.max_rate;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1154,7 +1331,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sndseq_max       = tcp_getsequence(conn->sndseq) + 1;
 #endif
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
       /* Initialize the variables of congestion control */
 
       tcp_cc_init(conn);
@@ -1181,7 +1358,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_activate(conn);
       tcp_conn_list_unlock();
 
       tcp_update_retrantimer(conn, TCP_RTO);
@@ -1470,7 +1647,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
   conn->rexmit_seq = tcp_getsequence(conn->sndseq);
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
   /* Initialize the variables of congestion control. */
 
   tcp_cc_init(conn);
@@ -1490,7 +1667,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_activate(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1535,7 +1712,9 @@ void tcp_conn_list_unlock(void)
 
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
-  dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_conn_list_lock();
+  tcp_deactivate(conn);
+  tcp_conn_list_unlock();
 }
 
 /****************************************************************************
@@ -31,6 +31,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <netinet/tcp.h>
 
@@ -240,6 +241,23 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        if (*value_len == 0)
+          {
+            ret          = -EINVAL;
+          }
+        else
+          {
+            FAR const char *name = tcp_cc_name(conn);
+
+            *value_len   = MIN(*value_len, strlen(name) + 1);
+            strlcpy(value, name, *value_len);
+            ret          = OK;
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -726,8 +726,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (((dev->d_features & NETDEV_RX_CSUM) == 0)
-      && (tcp_chksum(dev) != 0xffff))
+  if (!NETDEV_RX_CSUM_OK(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -1357,7 +1356,7 @@ skip_rtt:
   if ((tcp->flags & TCP_ACK) != 0 &&
       (conn->tcpstateflags & TCP_STATE_MASK) != TCP_SYN_RCVD)
     {
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
       /* If the packet is ack, update the cc var. */
 
       tcp_cc_recv_ack(conn, tcp);
@@ -1428,7 +1427,7 @@ skip_rtt:
             tcp_snd_wnd_init(conn, tcp);
             tcp_snd_wnd_update(conn, tcp);
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
             tcp_cc_update(conn, tcp);
 #endif
             flags               = TCP_CONNECTED;
@@ -1476,7 +1475,7 @@ skip_rtt:
             tcp_snd_wnd_init(conn, tcp);
             tcp_snd_wnd_update(conn, tcp);
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
             tcp_cc_update(conn, tcp);
 #endif
             net_incr32(conn->rcvseq, 1); /* ack SYN */
@@ -50,6 +50,7 @@
 #include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
@@ -61,9 +62,18 @@
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+/* All currently listening connections, hashed by local port.  The number
+ * of listeners is still limited to CONFIG_NET_MAX_LISTENPORTS.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_listen_hash, CONFIG_NET_TCP_CONN_HASH_BITS);
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -89,11 +99,37 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *p;
+#else
   int ndx;
+#endif
 
   /* Examine each connection structure in each slot of the listener list */
 
   tcp_conn_list_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_for_every_possible(g_tcp_listen_hash, p, portno)
+    {
+      /* Only the listeners hashing to the same bucket can have the same
+       * local port number.
+       */
+
+      FAR struct tcp_conn_s *conn =
+        container_of(p, struct tcp_conn_s, hnode);
+
+#  if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
+                       conn))
+#  else
+      if (tcp_conn_cmp((FAR const union ip_addr_u *)uaddr, portno, conn))
+#  endif
+        {
+          tcp_conn_list_unlock();
+          return conn;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       /* Is this slot assigned?  If so, does the connection have the same
@@ -101,17 +137,19 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        */
 
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+
+#  if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
                        conn))
-#else
+#  else
       if (tcp_conn_cmp((FAR const union ip_addr_u *)uaddr, portno, conn))
-#endif
+#  endif
         {
           tcp_conn_list_unlock();
           return conn;
         }
     }
+#endif
 
   /* No listener for this port */
 
@@ -136,10 +174,27 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  FAR hash_node_t *p;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   tcp_conn_list_lock();
+#ifdef CONFIG_NET_TCP_CONN_HASH
+  hashtable_for_every_possible(g_tcp_listen_hash, p, conn->lport)
+    {
+      if (p == &conn->hnode)
+        {
+          hashtable_delete(g_tcp_listen_hash, p, conn->lport);
+          g_tcp_nlisteners--;
+          tcp_remove_syn_backlog(conn);
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
@@ -150,6 +205,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
           break;
         }
     }
+#endif
 
   tcp_conn_list_unlock();
   return ret;
@@ -168,7 +224,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifndef CONFIG_NET_TCP_CONN_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -197,6 +255,22 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_CONN_HASH
+      /* The hash node is shared with the connection hashtable, which only
+       * holds connections that have left the TCP_ALLOCATED state.
+       */
+
+      if (conn->tcpstateflags != TCP_ALLOCATED)
+        {
+          ret = -EINVAL;
+        }
+      else if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          hashtable_add(g_tcp_listen_hash, &conn->hnode, conn->lport);
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -212,6 +286,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   tcp_conn_list_unlock();
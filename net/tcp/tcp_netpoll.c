@@ -158,6 +158,15 @@ static uint32_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
           eventset |= POLLOUT;
         }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      /* Completed MSG_ZEROCOPY sends are reported as POLLERR */
+
+      if (tcp_zerocopy_pending(info->conn))
+        {
+          eventset |= POLLERR;
+        }
+#endif
+
       /* Awaken the caller of poll() if requested event occurred. */
 
       poll_notify(&info->fds, 1, eventset);
@@ -302,6 +311,12 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       cb->flags |= TCP_NEWDATA | TCP_BACKLOG | TCP_RXCLOSE;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY sends complete as data is ACKed */
+
+  cb->flags |= TCP_ACKDATA;
+#endif
+
   /* Save the reference in the poll info structure as fds private as well
    * for use during poll teardown as well.
    */
@@ -318,6 +333,15 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLRDNORM;
     }
 
+#ifdef CONFIG_NET_TCP_TLS
+  /* Or decrypted data of the last record */
+
+  if (tcp_tls_rxpending(conn))
+    {
+      eventset |= POLLRDNORM;
+    }
+#endif
+
   /* Check for a loss of connection events.  We need to be careful here.
    * There are four possibilities:
    *
@@ -383,6 +407,13 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLWRNORM;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (tcp_zerocopy_pending(conn))
+    {
+      eventset |= POLLERR;
+    }
+#endif
+
   /* Check if any requested events are already in effect */
 
 notify:
@@ -0,0 +1,303 @@
+/****************************************************************************
+ * net/tcp/tcp_pacing.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <inttypes.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The window is paced over the RTT with some headroom (in percent), more
+ * in slow start so that the window can still double every round trip.
+ */
+
+#define TCP_PACING_SS_GAIN   200
+#define TCP_PACING_CA_GAIN   120
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_pacing_rate
+ *
+ * Description:
+ *   Return the pacing rate of a connection in bytes per second, or zero if
+ *   it is not paced.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_pacing_rate(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_pacing_s *pacing = &conn->pacing;
+  uint64_t rate = 0;
+  uint32_t wnd;
+  uint32_t gain;
+
+#ifdef CONFIG_NET_TCP_CC
+  wnd  = MIN(conn->cwnd, conn->snd_wnd);
+  gain = conn->cwnd < conn->ssthresh ? TCP_PACING_SS_GAIN :
+                                       TCP_PACING_CA_GAIN;
+#else
+  wnd  = conn->snd_wnd;
+  gain = TCP_PACING_CA_GAIN;
+#endif
+
+  if (pacing->srtt != 0)
+    {
+      /* wnd bytes per srtt us, scaled by gain percent */
+
+      rate = (uint64_t)wnd * gain * (USEC_PER_SEC / 100) / pacing->srtt;
+    }
+
+  if (pacing->max_rate != 0 && (rate == 0 || rate > pacing->max_rate))
+    {
+      rate = pacing->max_rate;
+    }
+
+  return MIN(rate, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_work
+ *
+ * Description:
+ *   Poll the device of a paced connection, if it still exists, once its
+ *   next segment may be sent.
+ *
+ ****************************************************************************/
+
+static void tcp_pacing_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  tcp_conn_list_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          tcp_conn_list_unlock();
+          if (conn->dev != NULL)
+            {
+              netdev_lock(conn->dev);
+              netdev_txnotify_dev(conn->dev, TCP_POLL);
+              netdev_unlock(conn->dev);
+            }
+
+          return;
+        }
+    }
+
+  tcp_conn_list_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_expiry
+ *
+ * Description:
+ *   The pacing timer runs in the timer context, defer the poll to the
+ *   work queue.
+ *
+ ****************************************************************************/
+
+static uint64_t tcp_pacing_expiry(FAR const hrtimer_t *timer,
+                                  uint64_t expired)
+{
+  FAR struct tcp_conn_s *conn =
+    container_of(timer, struct tcp_conn_s, pacing.timer);
+
+  conn->pacing.armed = false;
+  work_queue(LPWORK, &conn->pacing.work, tcp_pacing_work, conn, 0);
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_pacing_ready
+ *
+ * Description:
+ *   Check if the pacing of a connection allows to send a segment now.  If
+ *   not, the pacing timer is started to poll the device when it does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   true if a segment may be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_ready(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_pacing_s *pacing = &conn->pacing;
+
+  if (pacing->next <= clock_systime_nsec())
+    {
+      return true;
+    }
+
+  if (!pacing->armed)
+    {
+      pacing->armed = true;
+      hrtimer_start(&pacing->timer, tcp_pacing_expiry, pacing->next,
+                    HRTIMER_MODE_ABS);
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account a segment sent on a connection: delay the next one by the
+ *   time the segment takes at the pacing rate and start an RTT sample if
+ *   none is in flight.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   seq    - The sequence number of the first byte of the segment
+ *   len    - The length of the segment
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t seq,
+                     uint32_t len)
+{
+  FAR struct tcp_pacing_s *pacing = &conn->pacing;
+  uint64_t now = clock_systime_nsec();
+  uint32_t rate;
+
+  /* Only new data is sampled, and a sample whose data is sent again is
+   * dropped: its ACK cannot tell which transmission it answers.
+   */
+
+  if (pacing->sampling)
+    {
+      if (TCP_SEQ_LT(seq, pacing->seq))
+        {
+          pacing->sampling = false;
+        }
+    }
+  else if (TCP_SEQ_GTE(seq, conn->sndseq_max))
+    {
+      pacing->sampling = true;
+      pacing->stamp    = now;
+      pacing->seq      = TCP_SEQ_ADD(seq, len);
+    }
+
+  rate = tcp_pacing_rate(conn);
+  if (rate != 0)
+    {
+      pacing->next = now + (uint64_t)len * NSEC_PER_SEC / rate;
+      ninfo("pacing %" PRIu32 " bytes at %" PRIu32 " B/s\n", len, rate);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_ack
+ *
+ * Description:
+ *   Complete the RTT sample of a connection once it has been ACKed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   ackno  - The received ACK number
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_ack(FAR struct tcp_conn_s *conn, uint32_t ackno)
+{
+  FAR struct tcp_pacing_s *pacing = &conn->pacing;
+  int32_t rtt;
+
+  if (!pacing->sampling || TCP_SEQ_LT(ackno, pacing->seq))
+    {
+      return;
+    }
+
+  pacing->sampling = false;
+  rtt = MAX((clock_systime_nsec() - pacing->stamp) / NSEC_PER_USEC, 1);
+
+  /* srtt = 7/8 srtt + 1/8 rtt, as in RFC 6298 */
+
+  if (pacing->srtt == 0)
+    {
+      pacing->srtt = rtt;
+    }
+  else
+    {
+      pacing->srtt += (rtt - (int32_t)pacing->srtt) / 8;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_stop
+ *
+ * Description:
+ *   Stop the pacing timer of a connection when it is freed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ ****************************************************************************/
+
+void tcp_pacing_stop(FAR struct tcp_conn_s *conn)
+{
+  hrtimer_cancel_sync(&conn->pacing.timer);
+  work_cancel(LPWORK, &conn->pacing.work);
+  conn->pacing.armed = false;
+}
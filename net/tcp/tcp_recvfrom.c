@@ -808,9 +808,16 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
            * terminate if a signal is received.
            */
 
-          ret = conn_dev_sem_timedwait(&state.ir_sem, true,
-                                       _SO_TIMEOUT(conn->sconn.s_rcvtimeo),
-                                       &conn->sconn, conn->dev);
+#ifdef CONFIG_NET_BUSY_POLL
+          ret = conn_dev_busy_poll(&state.ir_sem, &conn->sconn, conn->dev);
+          if (ret < 0)
+#endif
+            {
+              ret = conn_dev_sem_timedwait(&state.ir_sem, true,
+                                   _SO_TIMEOUT(conn->sconn.s_rcvtimeo),
+                                   &conn->sconn, conn->dev);
+            }
+
           tls_cleanup_pop(tls_get_info(), 0);
           if (ret == -ETIMEDOUT)
             {
@@ -877,6 +884,13 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   ssize_t                ret     = 0;
   int                    i;
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      return tcp_zerocopy_recverr(psock, msg);
+    }
+#endif
+
   conn = psock->s_conn;
   conn_dev_lock(&conn->sconn, conn->dev);
   for (i = 0; i < msg->msg_iovlen; i++)
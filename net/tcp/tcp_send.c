@@ -65,6 +65,21 @@
 #include "tcp/tcp.h"
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Whether the stack computes the TCP checksum of an outgoing packet.  A
+ * GSO packet gets its checksums per segment, from the driver.
+ */
+
+#ifdef CONFIG_NET_GSO
+#  define TCP_SW_CHKSUM(dev) \
+     (!NETDEV_TX_CSUM_OFFLOAD(dev) && (dev)->d_gso_size == 0)
+#else
+#  define TCP_SW_CHKSUM(dev) (!NETDEV_TX_CSUM_OFFLOAD(dev))
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -200,7 +215,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (TCP_SW_CHKSUM(dev))
         {
           tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
         }
@@ -227,7 +242,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (TCP_SW_CHKSUM(dev))
         {
           tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
         }
@@ -513,7 +528,7 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (!NETDEV_TX_CSUM_OFFLOAD(dev))
         {
           tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
         }
@@ -536,7 +551,7 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (!NETDEV_TX_CSUM_OFFLOAD(dev))
         {
           tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
         }
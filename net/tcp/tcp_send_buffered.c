@@ -184,6 +184,7 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
 
       /* Return the write buffer to the free list */
 
+      tcp_zerocopy_release(conn, wrb);
       tcp_wrbuffer_release(wrb);
 
       /* Notify any waiters if the write buffers have been
@@ -282,12 +283,14 @@ static inline void psock_lost_connection(FAR struct tcp_conn_s *conn,
   for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
     {
       next = sq_next(entry);
+      tcp_zerocopy_release(conn, (FAR struct tcp_wrbuffer_s *)entry);
       tcp_wrbuffer_release((FAR struct tcp_wrbuffer_s *)entry);
     }
 
   for (entry = sq_peek(&conn->write_q); entry; entry = next)
     {
       next = sq_next(entry);
+      tcp_zerocopy_release(conn, (FAR struct tcp_wrbuffer_s *)entry);
       tcp_wrbuffer_release((FAR struct tcp_wrbuffer_s *)entry);
     }
 
@@ -411,6 +414,31 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: tcp_gso_maxlen
+ *
+ * Description:
+ *   Get the largest amount of data to send as one GSO packet: a whole
+ *   number of segments that still fits in a 16-bit packet length.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_GSO
+static uint32_t tcp_gso_maxlen(FAR struct tcp_conn_s *conn,
+                               FAR struct net_driver_s *dev)
+{
+  uint32_t maxlen = (uint32_t)conn->mss * CONFIG_NET_GSO_MAXSEGS;
+  uint32_t limit  = UINT16_MAX - NET_LL_HDRLEN(dev) - tcpip_hdrsize(conn);
+
+  if (maxlen > limit)
+    {
+      maxlen = limit - limit % conn->mss;
+    }
+
+  return maxlen;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -507,6 +535,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%" PRIu32 " flags=%" PRIx32 "\n", ackno, flags);
 
+#ifdef CONFIG_NET_TCP_PACING
+      tcp_pacing_ack(conn, ackno);
+#endif
+
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -550,6 +582,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                    * buffers
                    */
 
+                  tcp_zerocopy_release(conn, wrb);
                   tcp_wrbuffer_release(wrb);
 
                   /* Notify any waiters if the write buffers have been
@@ -590,7 +623,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
           else if (ackno == TCP_WBSEQNO(wrb))
             {
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
               if (conn->dupacks >= TCP_FAST_RETRANSMISSION_THRESH)
 #else
               /* Duplicate ACK? Retransmit data if need */
@@ -600,7 +633,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   /* Fast retransmission has been triggered */
 
-#ifndef CONFIG_NET_TCP_CC_NEWRENO
+#ifndef CONFIG_NET_TCP_CC
                   /* Reset counter */
 
                   TCP_WBNACK(wrb) = 0;
@@ -660,7 +693,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #endif
                     }
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
                   conn->dupacks = 0;
 #endif
                 }
@@ -797,7 +830,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
           /* After Fast retransmitted, set ssthresh to the maximum of
            * the unacked and the 2*SMSS, and enter to Fast Recovery.
            * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
@@ -869,7 +902,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
         }
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
           /* After Fast retransmitted, set ssthresh to the maximum of
            * the unacked and the 2*SMSS, and enter to Fast Recovery.
            * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
@@ -922,6 +955,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
               /* And return the write buffer to the free list */
 
+              tcp_zerocopy_release(conn, wrb);
               tcp_wrbuffer_release(wrb);
 
               /* Notify any waiters if the write buffers have been
@@ -1051,7 +1085,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       seq = TCP_WBSEQNO(wrb) + TCP_WBSENT(wrb);
 
-#ifdef CONFIG_NET_TCP_CC_NEWRENO
+#ifdef CONFIG_NET_TCP_CC
       snd_wnd_edge = conn->snd_wl2 + MIN(conn->snd_wnd, conn->cwnd);
 #else
       snd_wnd_edge = conn->snd_wl2 + conn->snd_wnd;
@@ -1059,12 +1093,38 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen = conn->mss;
           int ret;
 
+#ifdef CONFIG_NET_TCP_PACING
+          /* Hold the segment until the previous one has drained at the
+           * pacing rate, the pacing timer polls again then.
+           */
+
+          if (!tcp_pacing_ready(conn))
+            {
+              return flags;
+            }
+#endif
+
+#ifdef CONFIG_NET_GSO
+          /* Send several segments at once as a GSO packet on the poll
+           * path.  Packets sent in reply to input are queued by the
+           * driver without room for the MSS hint, so they stay single
+           * segments.
+           */
+
+          if ((dev->d_features & NETDEV_TX_GSO) != 0 &&
+              (flags & TCP_POLL) != 0)
+            {
+              maxlen = tcp_gso_maxlen(conn, dev);
+            }
+#endif
+
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1135,6 +1195,12 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_GSO
+          /* Tell the driver how to segment a packet above the MSS */
+
+          dev->d_gso_size = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           /* Remember how much data we send out now so that we know
            * when everything has been acknowledged.  Just increment
            * the amount of data sent. This will be needed in sequence
@@ -1144,6 +1210,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
 
+#ifdef CONFIG_NET_TCP_PACING
+          tcp_pacing_sent(conn, seq, sndlen);
+#endif
+
           /* Below prediction will become true,
            * unless retransmission occurrence
            */
@@ -1342,6 +1412,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   bool       nonblock;
   int        ret = OK;
   clock_t    start;
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  uint32_t   zcid = 0;
+  bool       zerocopy;
+#endif
 
   if (psock == NULL || psock->s_type != SOCK_STREAM ||
       psock->s_conn == NULL)
@@ -1403,6 +1477,14 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY data is referenced in place rather than copied, unless
+   * it only lives in a temporary buffer of the caller.
+   */
+
+  zerocopy = (flags & (MSG_ZEROCOPY | TCP_MSG_ZCCOPY)) == MSG_ZEROCOPY;
+#endif
+
   /* Dump the incoming buffer */
 
   BUF_DUMP("psock_tcp_send", buf, len);
@@ -1578,7 +1660,23 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          /* Fall back to copying if the IOB referencing the data cannot
+           * be allocated.
+           */
+
+          chunk_result = -ENOMEM;
+          if (zerocopy)
+            {
+              chunk_result = tcp_zerocopy_append(wrb, cp, chunk_len);
+            }
+
+          if (chunk_result < 0)
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1603,7 +1701,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             }
           else
             {
-              DEBUGASSERT(chunk_result == chunk_len);
+              DEBUGASSERT(chunk_result <= chunk_len);
             }
 
           if (chunk_result > 0)
@@ -1648,6 +1746,22 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             }
         }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      /* All of the MSG_ZEROCOPY data of one call shares the same
+       * completion, reported once the last buffer holding it is released.
+       */
+
+      if ((flags & MSG_ZEROCOPY) != 0 && chunk_result > 0)
+        {
+          if (zcid == 0)
+            {
+              zcid = ++conn->zc_next;
+            }
+
+          wrb->wb_zcid = zcid;
+        }
+#endif
+
       /* Dump I/O buffer chain */
 
       TCP_WBDUMP("I/O buffer chain", wrb, TCP_WBPKTLEN(wrb), 0);
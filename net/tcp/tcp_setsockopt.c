@@ -31,6 +31,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <netinet/tcp.h>
 
@@ -263,6 +264,56 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        if (value == NULL || value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            char name[TCP_CA_NAME_MAX];
+
+            /* The name need not be NUL terminated */
+
+            strlcpy(name, value, MIN(value_len + 1, sizeof(name)));
+
+            conn_dev_lock(&conn->sconn, conn->dev);
+            ret = tcp_cc_select(conn, name);
+            conn_dev_unlock(&conn->sconn, conn->dev);
+
+            if (ret < 0)
+              {
+                nerr("ERROR: Unknown congestion control: %s\n", name);
+              }
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_TCP_TLS
+      case TCP_ULP: /* Upper layer protocol */
+        if (value == NULL || value_len == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            char name[TCP_CA_NAME_MAX];
+
+            strlcpy(name, value, MIN(value_len + 1, sizeof(name)));
+            if (strcmp(name, "tls") != 0)
+              {
+                nerr("ERROR: Unknown upper layer protocol: %s\n", name);
+                ret = -ENOENT;
+              }
+            else
+              {
+                ret = tcp_tls_attach(psock);
+              }
+          }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -0,0 +1,919 @@
+/****************************************************************************
+ * net/tcp/tcp_tls.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <netinet/tls.h>
+#include <crypto/cryptodev.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_TLS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Record content types */
+
+#define TLS_RECORD_DATA         23
+
+#define TLS_HEADER_SIZE         5      /* type, version, length */
+#define TLS_IV_SIZE             8      /* Explicit part of the nonce */
+#define TLS_SALT_SIZE           4      /* Implicit part of the nonce */
+#define TLS_TAG_SIZE            16
+#define TLS_MAX_KEY_SIZE        32
+#define TLS_MAX_PAYLOAD         16384
+#define TLS_MAX_CIPHERTEXT      (TLS_MAX_PAYLOAD + 256)
+
+/* The additional data: seq, type, version and length in TLS 1.2, the
+ * record header in TLS 1.3.
+ */
+
+#define TLS_AAD_SIZE            13
+
+/* A record and, past its end, the additional data: the crypto API reads
+ * it at a positive offset from the payload.
+ */
+
+#define TLS_BUFSIZE \
+  (TLS_HEADER_SIZE + TLS_MAX_CIPHERTEXT + TLS_AAD_SIZE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of one direction.  The 12 byte nonce is salt || iv: the iv is
+ * sent in each record with TLS 1.2 AES-GCM, and is XORed with the record
+ * sequence number otherwise.
+ */
+
+struct tcp_tls_ctx_s
+{
+  uint64_t sid;                   /* Crypto session */
+  int      encalg;                /* CRYPTO_AES_GCM_16, ... */
+  int      macalg;                /* Matching CRYPTO_*_GMAC, ... */
+  uint16_t version;               /* TLS_1_2_VERSION or TLS_1_3_VERSION */
+  bool     explicit;              /* The iv is sent in the records */
+  bool     plain;                 /* RX: rec holds a decrypted record */
+  uint8_t  type;                  /* RX: content type of that record */
+  uint8_t  klen;                  /* Key length with the salt, bytes */
+  uint8_t  key[TLS_MAX_KEY_SIZE + TLS_SALT_SIZE];
+  uint8_t  iv[TLS_IV_SIZE];
+  uint8_t  seq[8];                /* Record sequence number, big endian */
+  uint16_t off;                   /* Start of the unread or unsent data */
+  uint16_t len;                   /* End of the data in rec */
+  uint8_t  rec[1];                /* TLS_BUFSIZE bytes of record buffer */
+};
+
+struct tcp_tls_s
+{
+  mutex_t txlock;                 /* Serializes senders */
+  mutex_t rxlock;                 /* Serializes receivers */
+  int     rxerr;                  /* Sticky error of the receive side */
+  FAR struct tcp_tls_ctx_s *tx;
+  FAR struct tcp_tls_ctx_s *rx;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_tls_incr
+ *
+ * Description:
+ *   Increment a 64-bit big endian counter.
+ *
+ ****************************************************************************/
+
+static void tcp_tls_incr(FAR uint8_t *ctr)
+{
+  int i;
+
+  for (i = 7; i >= 0; i--)
+    {
+      if (++ctr[i] != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_tls_nonce
+ *
+ * Description:
+ *   Return the explicit part of the nonce of the next record: the iv sent
+ *   in the record with TLS 1.2 AES-GCM, or the iv XORed with the record
+ *   sequence number.
+ *
+ ****************************************************************************/
+
+static void tcp_tls_nonce(FAR struct tcp_tls_ctx_s *ctx, FAR uint8_t *iv)
+{
+  int i;
+
+  if (ctx->explicit)
+    {
+      memcpy(iv, ctx->iv, TLS_IV_SIZE);
+      tcp_tls_incr(ctx->iv);
+    }
+  else
+    {
+      for (i = 0; i < TLS_IV_SIZE; i++)
+        {
+          iv[i] = ctx->iv[i] ^ ctx->seq[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_tls_crypt
+ *
+ * Description:
+ *   Encrypt or decrypt the payload of a record in place.  The tag follows
+ *   the payload; it is written when encrypting and checked in constant
+ *   time when decrypting.  The payload must be followed by room for the
+ *   tag and the additional data.
+ *
+ * Returned Value:
+ *   Zero on success, -EBADMSG if the record fails authentication, or the
+ *   error of the crypto driver.
+ *
+ ****************************************************************************/
+
+static int tcp_tls_crypt(FAR struct tcp_tls_ctx_s *ctx, FAR uint8_t *data,
+                         size_t len, FAR const uint8_t *iv,
+                         FAR const uint8_t *aad, size_t aadlen,
+                         bool encrypt)
+{
+  struct cryptodesc crde;
+  struct cryptodesc crda;
+  struct cryptop crp;
+  uint8_t tag[TLS_TAG_SIZE];
+  uint8_t diff = 0;
+  int ret;
+  int i;
+
+  memcpy(data + len + TLS_TAG_SIZE, aad, aadlen);
+
+  memset(&crde, 0, sizeof(crde));
+  crde.crd_len   = len;
+  crde.crd_flags = CRD_F_IV_EXPLICIT | CRD_F_IV_PRESENT;
+  crde.crd_alg   = ctx->encalg;
+  crde.crd_key   = (caddr_t)ctx->key;
+  crde.crd_klen  = ctx->klen * 8;
+  crde.crd_next  = &crda;
+  memcpy(crde.crd_iv, iv, TLS_IV_SIZE);
+
+  if (encrypt)
+    {
+      crde.crd_flags |= CRD_F_ENCRYPT;
+    }
+
+  memset(&crda, 0, sizeof(crda));
+  crda.crd_skip  = len + TLS_TAG_SIZE;
+  crda.crd_len   = aadlen;
+  crda.crd_alg   = ctx->macalg;
+  crda.crd_key   = (caddr_t)ctx->key;
+  crda.crd_klen  = ctx->klen * 8;
+
+  memset(&crp, 0, sizeof(crp));
+  crp.crp_sid    = ctx->sid;
+  crp.crp_ilen   = len;
+  crp.crp_flags  = CRYPTO_F_IOV;
+  crp.crp_buf    = data;
+  crp.crp_dst    = (caddr_t)data;
+  crp.crp_desc   = &crde;
+  crp.crp_aad    = (caddr_t)data + len + TLS_TAG_SIZE;
+  crp.crp_aadlen = aadlen;
+  crp.crp_mac    = encrypt ? (caddr_t)data + len : (caddr_t)tag;
+
+  ret = crypto_invoke(&crp);
+  if (ret == 0)
+    {
+      ret = crp.crp_etype;
+    }
+
+  /* The session may have migrated to another driver */
+
+  ctx->sid = crp.crp_sid;
+  if (ret < 0 || encrypt)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < TLS_TAG_SIZE; i++)
+    {
+      diff |= tag[i] ^ data[len + i];
+    }
+
+  return diff != 0 ? -EBADMSG : OK;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_seal
+ *
+ * Description:
+ *   Build the application data record of the plaintext in the transmit
+ *   buffer.
+ *
+ ****************************************************************************/
+
+static int tcp_tls_seal(FAR struct tcp_tls_ctx_s *ctx, FAR const void *buf,
+                        size_t len)
+{
+  FAR uint8_t *hdr = ctx->rec;
+  FAR uint8_t *data = hdr + TLS_HEADER_SIZE;
+  uint8_t aad[TLS_AAD_SIZE];
+  uint8_t iv[TLS_IV_SIZE];
+  size_t aadlen;
+  size_t clen = len;
+  size_t reclen;
+  int ret;
+
+  tcp_tls_nonce(ctx, iv);
+  if (ctx->explicit)
+    {
+      memcpy(data, iv, TLS_IV_SIZE);
+      data += TLS_IV_SIZE;
+    }
+
+  memcpy(data, buf, len);
+
+  /* TLS 1.3 hides the content type at the end of the plaintext */
+
+  if (ctx->version == TLS_1_3_VERSION)
+    {
+      data[clen++] = TLS_RECORD_DATA;
+    }
+
+  reclen = data - hdr - TLS_HEADER_SIZE + clen + TLS_TAG_SIZE;
+  hdr[0] = TLS_RECORD_DATA;
+  hdr[1] = TLS_1_2_VERSION >> 8;
+  hdr[2] = TLS_1_2_VERSION & 0xff;
+  hdr[3] = reclen >> 8;
+  hdr[4] = reclen & 0xff;
+
+  if (ctx->version == TLS_1_3_VERSION)
+    {
+      memcpy(aad, hdr, TLS_HEADER_SIZE);
+      aadlen = TLS_HEADER_SIZE;
+    }
+  else
+    {
+      memcpy(aad, ctx->seq, sizeof(ctx->seq));
+      memcpy(aad + 8, hdr, 3);
+      aad[11] = len >> 8;
+      aad[12] = len & 0xff;
+      aadlen  = TLS_AAD_SIZE;
+    }
+
+  ret = tcp_tls_crypt(ctx, data, clen, iv, aad, aadlen, true);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  tcp_tls_incr(ctx->seq);
+  ctx->off = 0;
+  ctx->len = TLS_HEADER_SIZE + reclen;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_read
+ *
+ * Description:
+ *   Fill the receive buffer from the TCP stream up to 'want' bytes.  What
+ *   was read is kept if the call does not complete.
+ *
+ * Returned Value:
+ *   A positive value when complete, zero at the end of the stream, or a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t tcp_tls_read(FAR struct socket *psock,
+                            FAR struct tcp_tls_ctx_s *ctx, size_t want,
+                            int flags)
+{
+  struct msghdr msg;
+  struct iovec iov;
+  ssize_t ret;
+
+  while (ctx->len < want)
+    {
+      iov.iov_base = ctx->rec + ctx->len;
+      iov.iov_len  = want - ctx->len;
+
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_iov    = &iov;
+      msg.msg_iovlen = 1;
+
+      ret = psock_tcp_recvfrom(psock, &msg, flags);
+      if (ret <= 0)
+        {
+          /* The end of the stream inside of a record is an error */
+
+          return ret == 0 && ctx->len > 0 ? -EBADMSG : ret;
+        }
+
+      ctx->len += ret;
+    }
+
+  return want;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_open
+ *
+ * Description:
+ *   Read the next record and decrypt it in the receive buffer.
+ *
+ * Returned Value:
+ *   A positive value when a record is ready, zero at the end of the
+ *   stream, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static ssize_t tcp_tls_open(FAR struct socket *psock,
+                            FAR struct tcp_tls_ctx_s *ctx, int flags)
+{
+  FAR uint8_t *hdr = ctx->rec;
+  FAR uint8_t *data = hdr + TLS_HEADER_SIZE;
+  uint8_t aad[TLS_AAD_SIZE];
+  uint8_t iv[TLS_IV_SIZE];
+  size_t overhead = TLS_TAG_SIZE;
+  size_t aadlen;
+  size_t reclen;
+  size_t clen;
+  ssize_t ret;
+
+  ret = tcp_tls_read(psock, ctx, TLS_HEADER_SIZE, flags);
+  if (ret <= 0)
+    {
+      return ret;
+    }
+
+  if (ctx->explicit)
+    {
+      overhead += TLS_IV_SIZE;
+    }
+
+  if (ctx->version == TLS_1_3_VERSION)
+    {
+      overhead++;
+    }
+
+  reclen = ((size_t)hdr[3] << 8) | hdr[4];
+  if (reclen < overhead || reclen > TLS_MAX_CIPHERTEXT)
+    {
+      nerr("ERROR: Bad record length %zu\n", reclen);
+      return -EBADMSG;
+    }
+
+  ret = tcp_tls_read(psock, ctx, TLS_HEADER_SIZE + reclen, flags);
+  if (ret <= 0)
+    {
+      return ret == 0 ? -EBADMSG : ret;
+    }
+
+  clen = reclen - TLS_TAG_SIZE;
+  if (ctx->explicit)
+    {
+      memcpy(iv, data, TLS_IV_SIZE);
+      data += TLS_IV_SIZE;
+      clen -= TLS_IV_SIZE;
+    }
+  else
+    {
+      tcp_tls_nonce(ctx, iv);
+    }
+
+  if (ctx->version == TLS_1_3_VERSION)
+    {
+      memcpy(aad, hdr, TLS_HEADER_SIZE);
+      aadlen = TLS_HEADER_SIZE;
+    }
+  else
+    {
+      memcpy(aad, ctx->seq, sizeof(ctx->seq));
+      memcpy(aad + 8, hdr, 3);
+      aad[11] = clen >> 8;
+      aad[12] = clen & 0xff;
+      aadlen  = TLS_AAD_SIZE;
+    }
+
+  ret = tcp_tls_crypt(ctx, data, clen, iv, aad, aadlen, false);
+  if (ret < 0)
+    {
+      nerr("ERROR: Record decryption failed: %zd\n", ret);
+      return ret;
+    }
+
+  tcp_tls_incr(ctx->seq);
+  ctx->type = hdr[0];
+
+  /* Strip the padding of TLS 1.3, the last nonzero byte is the type */
+
+  if (ctx->version == TLS_1_3_VERSION)
+    {
+      while (clen > 0 && data[clen - 1] == 0)
+        {
+          clen--;
+        }
+
+      if (clen == 0)
+        {
+          return -EBADMSG;
+        }
+
+      ctx->type = data[--clen];
+    }
+
+  ctx->off   = data - ctx->rec;
+  ctx->len   = ctx->off + clen;
+  ctx->plain = true;
+  return 1;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_release
+ *
+ * Description:
+ *   Free the state of one direction, wiping the keys and the plaintext.
+ *
+ ****************************************************************************/
+
+static void tcp_tls_release(FAR struct tcp_tls_ctx_s *ctx)
+{
+  crypto_freesession(ctx->sid);
+  explicit_bzero(ctx, sizeof(*ctx) + TLS_BUFSIZE);
+  kmm_free(ctx);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_tls_attach
+ *
+ * Description:
+ *   Attach the "tls" upper layer protocol (TCP_ULP) to a connected socket.
+ *   The record layer is not active until the keys are installed.
+ *
+ ****************************************************************************/
+
+int tcp_tls_attach(FAR struct socket *psock)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  FAR struct tcp_tls_s *tls;
+
+  if (!_SS_ISCONNECTED(conn->sconn.s_flags))
+    {
+      return -ENOTCONN;
+    }
+
+  if (conn->tls != NULL)
+    {
+      return -EEXIST;
+    }
+
+  tls = kmm_zalloc(sizeof(*tls));
+  if (tls == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&tls->txlock);
+  nxmutex_init(&tls->rxlock);
+  conn->tls = tls;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_setsockopt
+ *
+ * Description:
+ *   Handle the SOL_TLS socket options: install the keys of one direction
+ *   (TLS_TX or TLS_RX) from a tls12_crypto_info_* structure.
+ *
+ ****************************************************************************/
+
+int tcp_tls_setsockopt(FAR struct socket *psock, int option,
+                       FAR const void *value, socklen_t value_len)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  FAR const struct tls_crypto_info *info = value;
+  FAR struct tcp_tls_s *tls = conn->tls;
+  FAR struct tcp_tls_ctx_s **slot;
+  FAR struct tcp_tls_ctx_s *ctx;
+  FAR const uint8_t *salt;
+  FAR const uint8_t *key;
+  FAR const uint8_t *iv;
+  FAR const uint8_t *seq;
+  FAR mutex_t *lock;
+  struct cryptoini crie;
+  struct cryptoini cria;
+  socklen_t size;
+  size_t klen;
+  int encalg;
+  int macalg;
+  int ret;
+
+  if (tls == NULL || (option != TLS_TX && option != TLS_RX))
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len < sizeof(*info) ||
+      (info->version != TLS_1_2_VERSION &&
+       info->version != TLS_1_3_VERSION))
+    {
+      return -EINVAL;
+    }
+
+  switch (info->cipher_type)
+    {
+      case TLS_CIPHER_AES_GCM_128:
+        {
+          FAR const struct tls12_crypto_info_aes_gcm_128 *gcm = value;
+
+          size   = sizeof(*gcm);
+          encalg = CRYPTO_AES_GCM_16;
+          macalg = CRYPTO_AES_128_GMAC;
+          klen   = sizeof(gcm->key);
+          key    = gcm->key;
+          salt   = gcm->salt;
+          iv     = gcm->iv;
+          seq    = gcm->rec_seq;
+        }
+        break;
+
+      case TLS_CIPHER_AES_GCM_256:
+        {
+          FAR const struct tls12_crypto_info_aes_gcm_256 *gcm = value;
+
+          size   = sizeof(*gcm);
+          encalg = CRYPTO_AES_GCM_16;
+          macalg = CRYPTO_AES_256_GMAC;
+          klen   = sizeof(gcm->key);
+          key    = gcm->key;
+          salt   = gcm->salt;
+          iv     = gcm->iv;
+          seq    = gcm->rec_seq;
+        }
+        break;
+
+      case TLS_CIPHER_CHACHA20_POLY1305:
+        {
+          FAR const struct tls12_crypto_info_chacha20_poly1305 *cc = value;
+
+          /* The whole 12 byte iv is the nonce mask */
+
+          size   = sizeof(*cc);
+          encalg = CRYPTO_CHACHA20_POLY1305;
+          macalg = CRYPTO_CHACHA20_POLY1305_MAC;
+          klen   = sizeof(cc->key);
+          key    = cc->key;
+          salt   = cc->iv;
+          iv     = cc->iv + TLS_SALT_SIZE;
+          seq    = cc->rec_seq;
+        }
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  if (value_len < size)
+    {
+      return -EINVAL;
+    }
+
+  ctx = kmm_zalloc(sizeof(*ctx) + TLS_BUFSIZE);
+  if (ctx == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ctx->encalg   = encalg;
+  ctx->macalg   = macalg;
+  ctx->version  = info->version;
+  ctx->explicit = info->version == TLS_1_2_VERSION &&
+                  encalg == CRYPTO_AES_GCM_16;
+  ctx->klen     = klen + TLS_SALT_SIZE;
+  memcpy(ctx->key, key, klen);
+  memcpy(ctx->key + klen, salt, TLS_SALT_SIZE);
+  memcpy(ctx->iv, iv, TLS_IV_SIZE);
+  memcpy(ctx->seq, seq, sizeof(ctx->seq));
+
+  /* The crypto API uses a hardware engine when one supports the suite */
+
+  memset(&crie, 0, sizeof(crie));
+  crie.cri_alg  = encalg;
+  crie.cri_klen = ctx->klen * 8;
+  crie.cri_key  = (caddr_t)ctx->key;
+  crie.cri_next = &cria;
+
+  memset(&cria, 0, sizeof(cria));
+  cria.cri_alg  = macalg;
+  cria.cri_klen = ctx->klen * 8;
+  cria.cri_key  = (caddr_t)ctx->key;
+
+  ret = crypto_newsession(&ctx->sid, &crie, 0);
+  if (ret < 0)
+    {
+      nerr("ERROR: No crypto driver for cipher %u: %d\n",
+           info->cipher_type, ret);
+      explicit_bzero(ctx, sizeof(*ctx));
+      kmm_free(ctx);
+      return -ENOTSUP;
+    }
+
+  lock = option == TLS_TX ? &tls->txlock : &tls->rxlock;
+  slot = option == TLS_TX ? &tls->tx : &tls->rx;
+
+  nxmutex_lock(lock);
+  if (*slot != NULL)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      *slot = ctx;
+    }
+
+  nxmutex_unlock(lock);
+
+  if (ret < 0)
+    {
+      tcp_tls_release(ctx);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_enabled
+ *
+ * Description:
+ *   True if the keys of the direction (TLS_TX or TLS_RX) are installed and
+ *   the data of the socket goes through the record layer.
+ *
+ ****************************************************************************/
+
+bool tcp_tls_enabled(FAR struct tcp_conn_s *conn, int dir)
+{
+  FAR struct tcp_tls_s *tls = conn->tls;
+
+  if (tls == NULL)
+    {
+      return false;
+    }
+
+  return (dir == TLS_TX ? tls->tx : tls->rx) != NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_rxpending
+ *
+ * Description:
+ *   True if decrypted data is buffered and can be read without blocking.
+ *
+ ****************************************************************************/
+
+bool tcp_tls_rxpending(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_tls_s *tls = conn->tls;
+
+  return tls != NULL && tls->rx != NULL && tls->rx->plain &&
+         tls->rx->off < tls->rx->len;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_send
+ *
+ * Description:
+ *   Send plaintext through the record layer: the data is cut into records
+ *   of at most 16KiB, each one sealed and queued as a whole on the TCP
+ *   connection.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_tls_send(FAR struct socket *psock, FAR const void *buf,
+                     size_t len, int flags)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  FAR struct tcp_tls_s *tls = conn->tls;
+  FAR struct tcp_tls_ctx_s *ctx = tls->tx;
+  size_t total = 0;
+  size_t chunk;
+  ssize_t ret = OK;
+
+  /* The data is copied into the record, MSG_ZEROCOPY makes no sense */
+
+  flags &= ~MSG_ZEROCOPY;
+
+  nxmutex_lock(&tls->txlock);
+
+  for (; ; )
+    {
+      /* Queue what is left of the last record first */
+
+      while (ctx->off < ctx->len)
+        {
+          ret = psock_tcp_send(psock, ctx->rec + ctx->off,
+                               ctx->len - ctx->off, flags);
+          if (ret < 0)
+            {
+              goto out;
+            }
+
+          ctx->off += ret;
+        }
+
+      if (total >= len)
+        {
+          break;
+        }
+
+      chunk = MIN(len - total, TLS_MAX_PAYLOAD);
+      ret = tcp_tls_seal(ctx, (FAR const uint8_t *)buf + total, chunk);
+      if (ret < 0)
+        {
+          goto out;
+        }
+
+      total += chunk;
+    }
+
+out:
+  nxmutex_unlock(&tls->txlock);
+
+  /* The data sealed in a record is consumed, even if the record could
+   * not be queued yet.
+   */
+
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_recvmsg
+ *
+ * Description:
+ *   Receive plaintext through the record layer.  The data of one record
+ *   is returned at most per call.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_tls_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
+                        int flags)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  FAR struct tcp_tls_s *tls = conn->tls;
+  FAR struct tcp_tls_ctx_s *ctx = tls->rx;
+  size_t copied = 0;
+  size_t n;
+  ssize_t ret;
+  int i;
+
+  nxmutex_lock(&tls->rxlock);
+
+  if (tls->rxerr < 0)
+    {
+      ret = tls->rxerr;
+      goto out;
+    }
+
+  /* Skip the empty records, which are legal */
+
+  for (; ; )
+    {
+      if (ctx->plain)
+        {
+          if (ctx->off < ctx->len)
+            {
+              break;
+            }
+
+          ctx->plain = false;
+          ctx->len   = 0;
+        }
+
+      ret = tcp_tls_open(psock, ctx, flags & MSG_DONTWAIT);
+      if (ret <= 0)
+        {
+          /* A corrupt record leaves the stream out of sync */
+
+          if (ret == -EBADMSG)
+            {
+              tls->rxerr = ret;
+            }
+
+          goto out;
+        }
+    }
+
+  if (ctx->type != TLS_RECORD_DATA &&
+      cmsg_append(msg, SOL_TLS, TLS_GET_RECORD_TYPE, &ctx->type,
+                  sizeof(ctx->type)) == NULL)
+    {
+      ret = -EIO;
+      goto out;
+    }
+
+  for (i = 0; i < msg->msg_iovlen && ctx->off + copied < ctx->len; i++)
+    {
+      n = MIN(msg->msg_iov[i].iov_len, ctx->len - ctx->off - copied);
+      memcpy(msg->msg_iov[i].iov_base, ctx->rec + ctx->off + copied, n);
+      copied += n;
+    }
+
+  if ((flags & MSG_PEEK) == 0)
+    {
+      ctx->off += copied;
+    }
+
+  ret = copied;
+
+out:
+  nxmutex_unlock(&tls->rxlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_tls_free
+ *
+ * Description:
+ *   Release the kernel TLS state of a connection being freed.
+ *
+ ****************************************************************************/
+
+void tcp_tls_free(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_tls_s *tls = conn->tls;
+
+  if (tls == NULL)
+    {
+      return;
+    }
+
+  if (tls->tx != NULL)
+    {
+      tcp_tls_release(tls->tx);
+    }
+
+  if (tls->rx != NULL)
+    {
+      tcp_tls_release(tls->rx);
+    }
+
+  nxmutex_destroy(&tls->txlock);
+  nxmutex_destroy(&tls->rxlock);
+  kmm_free(tls);
+  conn->tls = NULL;
+}
+
+#endif /* CONFIG_NET_TCP_TLS */
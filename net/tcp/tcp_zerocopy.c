@@ -0,0 +1,209 @@
+/****************************************************************************
+ * net/tcp/tcp_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_free
+ *
+ * Description:
+ *   IOB free callback of the IOBs referencing caller's data.  The data
+ *   belongs to the caller; completion is accounted per write buffer by
+ *   tcp_zerocopy_release().
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_free(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_append
+ *
+ * Description:
+ *   Append caller's data to a write buffer without copying it: the data is
+ *   referenced in place by a heap allocated IOB that has no free space, so
+ *   that later copies into the chain can never write into it.
+ *
+ * Input Parameters:
+ *   wrb - The write buffer to append to
+ *   buf - The data, which must stay unmodified until the send completes
+ *   len - The number of bytes to append
+ *
+ * Returned Value:
+ *   The number of bytes appended, which may be less than len, or -ENOMEM.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_append(FAR struct tcp_wrbuffer_s *wrb,
+                            FAR const void *buf, size_t len)
+{
+  FAR struct iob_s *iob;
+
+  if (len > UINT16_MAX)
+    {
+      len = UINT16_MAX;
+    }
+
+  iob = iob_alloc_with_data((FAR void *)buf, len, tcp_zerocopy_free);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  iob->io_len    = len;
+  iob->io_pktlen = len;
+
+  /* A freshly allocated write buffer still holds its empty head IOB */
+
+  if (TCP_WBPKTLEN(wrb) == 0)
+    {
+      iob_free_chain(TCP_WBIOB(wrb));
+      TCP_WBIOB(wrb) = iob;
+    }
+  else
+    {
+      iob_concat(TCP_WBIOB(wrb), iob);
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   Account for the release of a write buffer of the connection: all of
+ *   the MSG_ZEROCOPY calls up to the one tagged on the buffer are complete.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_release(FAR struct tcp_conn_s *conn,
+                          FAR struct tcp_wrbuffer_s *wrb)
+{
+  /* Write buffers are released in sequence order (or all at once when
+   * the connection is lost), so a later tag covers the earlier calls too.
+   */
+
+  if (wrb->wb_zcid != 0 &&
+      (int32_t)(wrb->wb_zcid - conn->zc_done) > 0)
+    {
+      conn->zc_done = wrb->wb_zcid;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): report the range of MSG_ZEROCOPY
+ *   calls that completed since the last report in an IP_RECVERR (or
+ *   IPV6_RECVERR) control message.  Never blocks.
+ *
+ * Input Parameters:
+ *   psock - The TCP socket
+ *   msg   - Receives the control message
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if there is nothing to report.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct socket *psock,
+                             FAR struct msghdr *msg)
+{
+  FAR struct tcp_conn_s *conn = psock->s_conn;
+  struct sock_extended_err serr;
+  int level = SOL_IP;
+  int type = IP_RECVERR;
+
+  conn_dev_lock(&conn->sconn, conn->dev);
+
+  if (!tcp_zerocopy_pending(conn))
+    {
+      conn_dev_unlock(&conn->sconn, conn->dev);
+      return -EAGAIN;
+    }
+
+  memset(&serr, 0, sizeof(serr));
+  serr.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr.ee_info   = conn->zc_reported;
+  serr.ee_data   = conn->zc_done - 1;
+  conn->zc_reported = conn->zc_done;
+
+  conn_dev_unlock(&conn->sconn, conn->dev);
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      level = SOL_IPV6;
+      type  = IPV6_RECVERR;
+    }
+#endif
+
+  /* Like Linux, the report is consumed even if it did not fit */
+
+  if (cmsg_append(msg, level, type, &serr, sizeof(serr)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+    }
+
+  msg->msg_flags |= MSG_ERRQUEUE;
+  return 0;
+}
+
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -110,6 +111,9 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  hash_node_t hnode;      /* Link in the local port hashtable */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -279,6 +283,22 @@ void udp_conn_list_lock(void);
 
 void udp_conn_list_unlock(void);
 
+/****************************************************************************
+ * Name: udp_conn_setport
+ *
+ * Description:
+ *   Set the local port number of a UDP connection.  This must be used
+ *   instead of assigning lport directly so that the connection can be
+ *   found by its new port.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection
+ *   portno - The new local port in network byte order, zero to unbind
+ *
+ ****************************************************************************/
+
+void udp_conn_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+
 /****************************************************************************
  * Name: udp_select_port
  *
@@ -767,6 +787,30 @@ void udp_callback_cleanup(FAR void *arg);
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM, receiving the
+ *   whole batch under one hold of the connection lock.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Buffers to receive the datagrams
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of datagrams received; -errno if none was (see recvmmsg
+ *   for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags, FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -796,6 +840,31 @@ ssize_t psock_udp_sendto(FAR struct socket *psock,
                          FAR const void *buf, size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the sendmmsg()
+ *   socket operation: the datagrams are copied into write buffers first,
+ *   then queued for transfer together.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of datagrams queued for sending, or a negated errno value
+ *   if not even the first one could be.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
@@ -57,6 +57,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/net/netconfig.h>
@@ -96,10 +97,55 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_CONN_HASH
+/* The bound connections, hashed by local port.  Each bucket is kept in
+ * bind order, which is the order the list walk would find them in for a
+ * given port.
+ */
+
+static DECLARE_HASHTABLE(g_udp_port_hash, CONFIG_NET_UDP_CONN_HASH_BITS);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nextport
+ *
+ * Description:
+ *   Return the connection following conn which may be bound to the local
+ *   port portno, or the first one if conn is NULL.  Without the hashtable
+ *   this is every allocated connection.
+ *
+ * Assumptions:
+ *   This function must be called with the udp_conn_list_lock.
+ *
+ ****************************************************************************/
+
+static inline FAR struct udp_conn_s *
+udp_nextport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  FAR hash_node_t *p;
+
+  if (conn == NULL)
+    {
+      p = g_udp_port_hash[HASH(portno,
+                               hashtable_bits(g_udp_port_hash))].head;
+    }
+  else
+    {
+      p = conn->hnode.flink;
+    }
+
+  return p != NULL ? container_of(p, struct udp_conn_s, hnode) : NULL;
+#else
+  UNUSED(portno);
+  return udp_nextconn(conn);
+#endif
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -130,7 +176,7 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   /* Now search each connection structure. */
 
   udp_conn_list_lock();
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nextport(conn, portno)) != NULL)
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -204,7 +250,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn)
     {
@@ -318,7 +364,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -344,7 +390,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -458,7 +504,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -606,7 +652,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_conn_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -735,6 +781,45 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_conn_setport
+ *
+ * Description:
+ *   Set the local port number of a UDP connection.  This must be used
+ *   instead of assigning lport directly so that the connection can be
+ *   found by its new port.
+ *
+ * Input Parameters:
+ *   conn   - The UDP connection
+ *   portno - The new local port in network byte order, zero to unbind
+ *
+ ****************************************************************************/
+
+void udp_conn_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+#ifdef CONFIG_NET_UDP_CONN_HASH
+  udp_conn_list_lock();
+
+  if (conn->lport != 0)
+    {
+      hashtable_delete(g_udp_port_hash, &conn->hnode, conn->lport);
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      dq_addlast(&conn->hnode,
+                 &g_udp_port_hash[HASH(portno,
+                                       hashtable_bits(g_udp_port_hash))]);
+    }
+
+  udp_conn_list_unlock();
+#else
+  conn->lport = portno;
+#endif
+}
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -876,7 +961,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_conn_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +986,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_conn_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -953,7 +1038,8 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_conn_setport(conn, HTONS(udp_select_port(conn->domain,
+                                                   &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
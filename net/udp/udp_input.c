@@ -256,7 +256,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  if ((dev->d_features & NETDEV_RX_CSUM) == 0)
+  if (!NETDEV_RX_CSUM_OK(dev))
     {
       chksum = udp->udpchksum;
     }
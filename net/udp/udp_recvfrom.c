@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include <sys/time.h>
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -653,38 +654,34 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
 #endif /* CONFIG_NETDEV_RSS */
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: psock_udp_recvfrom
+ * Name: udp_recvfrom_locked
  *
  * Description:
- *   Perform the recvfrom operation for a UDP SOCK_DGRAM
+ *   Receive one datagram into msg, waiting for it unless the socket is
+ *   non-blocking or MSG_DONTWAIT is set.
  *
  * Input Parameters:
- *   psock  Pointer to the socket structure for the SOCK_DRAM socket
+ *   conn   The UDP connection
+ *   dev    The device bound to the connection, if any
  *   msg    Receive info and buffer for receive data
+ *   flags  Receive flags
  *
  * Returned Value:
- *   On success, returns the number of characters received.  On  error,
- *   -errno is returned (see recvfrom for list of errnos).
+ *   The number of bytes received, or a negated errno value.
  *
  * Assumptions:
+ *   The caller holds the connection lock and the device lock, if any.
  *
  ****************************************************************************/
 
-ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
-                           int flags)
+static ssize_t udp_recvfrom_locked(FAR struct udp_conn_s *conn,
+                                   FAR struct net_driver_s *dev,
+                                   FAR struct msghdr *msg, int flags)
 {
-  FAR struct udp_conn_s *conn = psock->s_conn;
-  FAR struct net_driver_s *dev;
   struct udp_callback_s info;
   struct udp_recvfrom_s state;
   ssize_t ret;
 
-  /* Perform the UDP recvfrom() operation */
-
   if (msg->msg_iovlen != 1)
     {
       return -ENOTSUP;
@@ -696,15 +693,6 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   udp_recvfrom_initialize(conn, msg, &state, flags);
 
-  /* Get the device that will handle the packet transfers.  This may be
-   * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
-   * NETDEV_DOWN notifications will be received.
-   */
-
-  dev = udp_find_laddr_device(conn);
-
-  conn_dev_lock(&conn->sconn, dev);
-
   /* Copy the read-ahead data from the packet */
 
   udp_readahead(&state);
@@ -769,9 +757,16 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
            * signal is received.
            */
 
-          ret = conn_dev_sem_timedwait(&state.ir_sem, true,
-                                       _SO_TIMEOUT(conn->sconn.s_rcvtimeo),
-                                       &conn->sconn, dev);
+#ifdef CONFIG_NET_BUSY_POLL
+          ret = conn_dev_busy_poll(&state.ir_sem, &conn->sconn, dev);
+          if (ret < 0)
+#endif
+            {
+              ret = conn_dev_sem_timedwait(&state.ir_sem, true,
+                                   _SO_TIMEOUT(conn->sconn.s_rcvtimeo),
+                                   &conn->sconn, dev);
+            }
+
           tls_cleanup_pop(tls_get_info(), 0);
           if (ret == -ETIMEDOUT)
             {
@@ -789,11 +784,136 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
         }
     }
 
+  udp_recvfrom_uninitialize(&state);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_recvfrom
+ *
+ * Description:
+ *   Perform the recvfrom operation for a UDP SOCK_DGRAM
+ *
+ * Input Parameters:
+ *   psock  Pointer to the socket structure for the SOCK_DRAM socket
+ *   msg    Receive info and buffer for receive data
+ *
+ * Returned Value:
+ *   On success, returns the number of characters received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
+                           int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  ssize_t ret;
+
+  /* Get the device that will handle the packet transfers.  This may be
+   * NULL if the UDP socket is bound to INADDR_ANY.  In that case, no
+   * NETDEV_DOWN notifications will be received.
+   */
+
+  dev = udp_find_laddr_device(conn);
+
+  /* Perform the UDP recvfrom() operation */
+
+  conn_dev_lock(&conn->sconn, dev);
+  ret = udp_recvfrom_locked(conn, dev, msg, flags);
   conn_dev_unlock(&conn->sconn, dev);
-  udp_notify_recvcpu(conn);
 
-  udp_recvfrom_uninitialize(&state);
+  udp_notify_recvcpu(conn);
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM.  The whole batch
+ *   is received under one hold of the connection lock: the read-ahead
+ *   queue is drained into successive messages and only an empty queue
+ *   makes the caller wait.
+ *
+ * Input Parameters:
+ *   psock   Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec  Buffers to receive the datagrams
+ *   vlen    Number of entries in msgvec
+ *   flags   Receive flags
+ *   timeout If not NULL, stop receiving once this time has elapsed
+ *
+ * Returned Value:
+ *   The number of datagrams received; -errno if none was (see recvmmsg
+ *   for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock,
+                       FAR struct mmsghdr *msgvec, unsigned int vlen,
+                       int flags, FAR const struct timespec *timeout)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  FAR struct msghdr *msg;
+  unsigned long controllen;
+  FAR void *control;
+  clock_t end = 0;
+  unsigned int i;
+  ssize_t ret = 0;
+
+  if (timeout != NULL)
+    {
+      end = clock_systime_ticks() + clock_time2ticks(timeout);
+    }
+
+  dev = udp_find_laddr_device(conn);
+
+  conn_dev_lock(&conn->sconn, dev);
+
+  for (i = 0; i < vlen; i++)
+    {
+      if (i > 0 && timeout != NULL &&
+          clock_compare(end, clock_systime_ticks()))
+        {
+          break;
+        }
+
+      /* Return the true control message length like psock_recvmsg() */
+
+      msg        = &msgvec[i].msg_hdr;
+      control    = msg->msg_control;
+      controllen = msg->msg_controllen;
+
+      ret = udp_recvfrom_locked(conn, dev, msg, flags);
+
+      msg->msg_control    = control;
+      msg->msg_controllen = controllen - msg->msg_controllen;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+    }
+
+  conn_dev_unlock(&conn->sconn, dev);
+
+  udp_notify_recvcpu(conn);
+  return i > 0 ? i : ret;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
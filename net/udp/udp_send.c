@@ -250,7 +250,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
 #ifdef CONFIG_NET_UDP_CHECKSUMS
       /* Calculate UDP checksum. */
 
-      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+      if (!NETDEV_TX_CSUM_OFFLOAD(dev))
         {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
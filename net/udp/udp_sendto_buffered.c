@@ -231,7 +231,7 @@ static inline void sendto_ipselect(FAR struct net_driver_s *dev,
  *
  * Description:
  *   Setup for the next packet transfer.  That function is called (1)
- *   psock_udp_sendto() by when the new UDP packet is buffered at the head of
+ *   udp_sendto_queue() by when the new UDP packet is buffered at the head of
  *   the write queue and (2) by sendto_writebuffer_release() when that
  *   previously queued write buffer was sent and a new write buffer lies at
  *   the head of the write queue.
@@ -269,7 +269,8 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_conn_setport(conn, HTONS(udp_select_port(conn->domain,
+                                                   &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -536,46 +537,43 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: psock_udp_sendto
+ * Name: udp_sendto_prepare
  *
  * Description:
- *   This function implements the UDP-specific logic of the standard
- *   sendto() socket operation.
+ *   Validate one datagram and copy it into a newly allocated write buffer,
+ *   ready to be queued by udp_sendto_queue().
  *
  * Input Parameters:
  *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
+ *   iov      Data to send
+ *   iovcnt   Number of entries in iov
  *   flags    Send flags
  *   to       Address of recipient
  *   tolen    The length of the address structure
- *
- *   NOTE: All input parameters were verified by sendto() before this
- *   function was called.
+ *   pending  Bytes already prepared by the caller but not yet queued
+ *   wrbp     Location to return the write buffer
  *
  * Returned Value:
- *   On success, returns the number of characters sent.  On  error,
- *   a negated errno value is returned.  See the description in
- *   net/socket/sendto.c for the list of appropriate return value.
+ *   The length of the datagram, or a negated errno value.
  *
  ****************************************************************************/
 
-ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
-                         size_t len, int flags,
-                         FAR const struct sockaddr *to, socklen_t tolen)
+static ssize_t udp_sendto_prepare(FAR struct socket *psock,
+                                  FAR const struct iovec *iov, int iovcnt,
+                                  int flags, FAR const struct sockaddr *to,
+                                  socklen_t tolen, size_t pending,
+                                  FAR struct udp_wrbuffer_s **wrbp)
 {
   FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
   unsigned int timeout;
   uint16_t udpiplen;
+  uint16_t offset;
+  size_t len;
   bool nonblock;
-  bool empty;
   int ret = OK;
   clock_t start;
+  int i;
 
   /* Get the underlying the UDP connection structure.  */
 
@@ -583,6 +581,11 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   /* The length of a datagram to be up to 65,535 octets */
 
+  for (len = 0, i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   if (len > 65535)
     {
       return -EMSGSIZE;
@@ -700,22 +703,22 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
-  nonblock = _SS_ISNONBLOCK(conn->sconn.s_flags) ||
-                            (flags & MSG_DONTWAIT) != 0;
+  /* While the caller holds a part of a batch in write buffers, nothing
+   * may wait for buffers to be freed: they may be the ones held.
+   */
+
+  nonblock = pending > 0 || _SS_ISNONBLOCK(conn->sconn.s_flags) ||
+             (flags & MSG_DONTWAIT) != 0;
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
-  /* Dump the incoming buffer */
-
-  BUF_DUMP("psock_udp_sendto", buf, len);
-
 #if CONFIG_NET_SEND_BUFSIZE > 0
   /* If the send buffer size exceeds the send limit,
    * wait for the write buffer to be released
    */
 
   conn_lock(&conn->sconn);
-  while (udp_wrbuffer_inqueue_size(conn) + len > conn->sndbufs)
+  while (udp_wrbuffer_inqueue_size(conn) + pending + len > conn->sndbufs)
     {
       if (nonblock)
         {
@@ -838,29 +841,70 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
    * buffer space if the socket was opened non-blocking.
    */
 
-  if (len > 0)
+  for (offset = udpiplen, i = 0; i < iovcnt; i++)
     {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
       if (nonblock)
         {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                              len, udpiplen, false);
+          ret = iob_trycopyin(wrb->wb_iob, iov[i].iov_base,
+                              iov[i].iov_len, offset, false);
         }
       else
         {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                           len, udpiplen, false);
+          ret = iob_copyin(wrb->wb_iob, iov[i].iov_base,
+                           iov[i].iov_len, offset, false);
         }
 
       if (ret < 0)
         {
-          goto errout_with_wrb;
+          udp_wrbuffer_release(wrb);
+          return ret;
         }
+
+      offset += iov[i].iov_len;
     }
 
   /* Dump I/O buffer chain */
 
   UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
 
+  *wrbp = wrb;
+  return len;
+}
+
+/****************************************************************************
+ * Name: udp_sendto_queue
+ *
+ * Description:
+ *   Move a batch of prepared write buffers to the write queue, with a
+ *   single hold of the connection lock.  Only a write buffer landing on an
+ *   empty queue needs to set up the next transfer, so the device is
+ *   normally only notified once per batch.
+ *
+ * Input Parameters:
+ *   conn     The UDP connection structure
+ *   batch    The write buffers, in sending order
+ *   nqueued  Incremented for each write buffer queued
+ *
+ * Returned Value:
+ *   OK if the whole batch was queued.  Otherwise, the negated errno value
+ *   that stopped it, the failed write buffer is freed and the rest are
+ *   left in the batch.
+ *
+ ****************************************************************************/
+
+static int udp_sendto_queue(FAR struct udp_conn_s *conn,
+                            FAR sq_queue_t *batch,
+                            FAR unsigned int *nqueued)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  bool empty;
+  int ret = OK;
+
   /* sendto_eventhandler() will send data in FIFO order from the
    * conn->write_q.
    *
@@ -873,40 +917,204 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
    */
 
   conn_lock(&conn->sconn);
-  empty = sq_empty(&conn->write_q);
-
-  sq_addlast(&wrb->wb_node, &conn->write_q);
-  ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
-        wrb, wrb->wb_iob->io_pktlen,
-        conn->write_q.head, conn->write_q.tail);
 
-  if (empty)
+  while ((wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(batch)) != NULL)
     {
-      /* The new write buffer lies at the head of the write queue.  Set
-       * up for the next packet transfer by setting the connection
-       * address to the address of the next packet now at the header of
-       * the write buffer queue.
-       */
+      empty = sq_empty(&conn->write_q);
 
-      ret = sendto_next_transfer(conn);
-      if (ret < 0)
+      sq_addlast(&wrb->wb_node, &conn->write_q);
+      ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
+            wrb, wrb->wb_iob->io_pktlen,
+            conn->write_q.head, conn->write_q.tail);
+
+      if (empty)
         {
-          sq_remlast(&conn->write_q);
-          conn_unlock(&conn->sconn);
-          goto errout_with_wrb;
+          /* The new write buffer lies at the head of the write queue.
+           * Set up for the next packet transfer by setting the
+           * connection address to the address of the next packet now at
+           * the header of the write buffer queue.
+           */
+
+          ret = sendto_next_transfer(conn);
+          if (ret < 0)
+            {
+              sq_remlast(&conn->write_q);
+              udp_wrbuffer_release(wrb);
+              break;
+            }
         }
 
-      conn_unlock(&conn->sconn);
+      (*nqueued)++;
     }
 
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: udp_sendto_discard
+ *
+ * Description:
+ *   Free the write buffers left in a batch.
+ *
+ ****************************************************************************/
+
+static void udp_sendto_discard(FAR sq_queue_t *batch)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+
+  while ((wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(batch)) != NULL)
+    {
+      udp_wrbuffer_release(wrb);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: psock_udp_sendto
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the standard
+ *   sendto() socket operation.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ *   NOTE: All input parameters were verified by sendto() before this
+ *   function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error,
+ *   a negated errno value is returned.  See the description in
+ *   net/socket/sendto.c for the list of appropriate return value.
+ *
+ ****************************************************************************/
+
+ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
+                         size_t len, int flags,
+                         FAR const struct sockaddr *to, socklen_t tolen)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  unsigned int nqueued = 0;
+  struct iovec iov;
+  sq_queue_t batch;
+  ssize_t ret;
+  int err;
+
+  /* Dump the incoming buffer */
+
+  BUF_DUMP("psock_udp_sendto", buf, len);
+
+  iov.iov_base = (FAR void *)buf;
+  iov.iov_len  = len;
+
+  ret = udp_sendto_prepare(psock, &iov, 1, flags, to, tolen, 0, &wrb);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sq_init(&batch);
+  sq_addlast(&wrb->wb_node, &batch);
+
+  err = udp_sendto_queue(psock->s_conn, &batch, &nqueued);
+
   /* Return the number of bytes that will be sent */
 
-  return len;
+  return err < 0 ? err : ret;
+}
 
-errout_with_wrb:
-  udp_wrbuffer_release(wrb);
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   This function implements the UDP-specific logic of the sendmmsg()
+ *   socket operation.  All of the datagrams are copied into write buffers
+ *   first, then queued for transfer together.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Messages to send
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   The number of datagrams queued for sending, or a negated errno value
+ *   if not even the first one could be.
+ *
+ ****************************************************************************/
 
-  return ret;
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR struct udp_wrbuffer_s *wrb;
+  FAR struct msghdr *msg;
+  unsigned int nqueued = 0;
+  unsigned int i;
+  sq_queue_t batch;
+  size_t pending = 0;
+  ssize_t ret = OK;
+  int err;
+
+  sq_init(&batch);
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      ret = udp_sendto_prepare(psock, msg->msg_iov, msg->msg_iovlen, flags,
+                               msg->msg_name, msg->msg_namelen, pending,
+                               &wrb);
+      if (ret < 0 && pending > 0)
+        {
+          /* Maybe out of buffers: queue the datagrams prepared so far,
+           * which lets them drain, and try once more as a lone datagram.
+           */
+
+          ret = udp_sendto_queue(conn, &batch, &nqueued);
+          pending = 0;
+          if (ret < 0)
+            {
+              udp_sendto_discard(&batch);
+              return nqueued > 0 ? nqueued : ret;
+            }
+
+          ret = udp_sendto_prepare(psock, msg->msg_iov, msg->msg_iovlen,
+                                   flags, msg->msg_name, msg->msg_namelen,
+                                   0, &wrb);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+      sq_addlast(&wrb->wb_node, &batch);
+      pending += ret;
+    }
+
+  /* Queue whatever was prepared, up to the first failure */
+
+  if (!sq_empty(&batch))
+    {
+      err = udp_sendto_queue(conn, &batch, &nqueued);
+      if (err < 0)
+        {
+          udp_sendto_discard(&batch);
+          ret = err;
+        }
+    }
+
+  return nqueued > 0 ? nqueued : ret;
 }
 
 /****************************************************************************
@@ -194,7 +194,8 @@ out:
  * Name: usrsock_handle_event
  ****************************************************************************/
 
-static ssize_t usrsock_handle_event(FAR const void *buffer, size_t len)
+static ssize_t usrsock_handle_event(FAR const void *buffer, size_t len,
+                                    FAR struct usrsock_conn_s **pending)
 {
   FAR const struct usrsock_message_common_s *common = buffer;
 
@@ -235,14 +236,29 @@ static ssize_t usrsock_handle_event(FAR const void *buffer, size_t len)
         add_sw_randomness((hdr->head.events << 16) - hdr->usockid);
 #endif
 
-        /* Handle event. */
+        /* Events for the same socket that arrive back to back in one
+         * batch are merged and handled once.
+         */
 
-        conn->resp.events = hdr->head.events & ~USRSOCK_EVENT_INTERNAL_MASK;
-        ret = usrsock_event(conn);
-        if (ret < 0)
+        if (*pending == conn)
           {
-            return ret;
+            conn->resp.events |= hdr->head.events &
+                                 ~USRSOCK_EVENT_INTERNAL_MASK;
+            return len;
           }
+
+        if (*pending != NULL)
+          {
+            ret = usrsock_event(*pending);
+            *pending = NULL;
+            if (ret < 0)
+              {
+                return ret;
+              }
+          }
+
+        conn->resp.events = hdr->head.events & ~USRSOCK_EVENT_INTERNAL_MASK;
+        *pending = conn;
       }
       break;
 
@@ -512,13 +528,27 @@ unlock_out:
  ****************************************************************************/
 
 static ssize_t usrsock_handle_message(FAR const void *buffer, size_t len,
-                                      FAR bool *req_done)
+                                      FAR bool *req_done,
+                                      FAR struct usrsock_conn_s **pending)
 {
   FAR const struct usrsock_message_common_s *common = buffer;
+  int ret;
 
   if (USRSOCK_MESSAGE_IS_EVENT(common->flags))
     {
-      return usrsock_handle_event(buffer, len);
+      return usrsock_handle_event(buffer, len, pending);
+    }
+
+  /* Deliver the merged events before a response changes the state */
+
+  if (*pending != NULL)
+    {
+      ret = usrsock_event(*pending);
+      *pending = NULL;
+      if (ret < 0)
+        {
+          return ret;
+        }
     }
 
   if (USRSOCK_MESSAGE_IS_REQ_RESPONSE(common->flags))
@@ -536,78 +566,111 @@ static ssize_t usrsock_handle_message(FAR const void *buffer, size_t len,
 
 /****************************************************************************
  * Name: usrsock_response() - handle usrsock request's ack/response
+ *
+ * Description:
+ *   The buffer may hold several messages back to back, each with its
+ *   data, so that the daemon can hand over a batch of responses and events
+ *   in one call.  Consecutive events of a socket are coalesced.  Returns
+ *   the number of bytes consumed, a trailing partial message is left to
+ *   the caller.
+ *
  ****************************************************************************/
 
 ssize_t usrsock_response(FAR const char *buffer, size_t len,
                          FAR bool *req_done)
 {
   FAR struct usrsock_req_s *req = &g_usrsock_req;
+  FAR struct usrsock_conn_s *pending = NULL;
   FAR struct usrsock_conn_s *conn;
   size_t origlen = len;
-  int ret = 0;
+  ssize_t ret = 0;
 
-  if (!req->datain_conn)
-    {
-      /* Start of message, buffer length should be at least size of common
-       * message header.
-       */
+  usrsock_lock();
 
-      if (len < sizeof(struct usrsock_message_common_s))
+  while (len > 0)
+    {
+      if (!req->datain_conn)
         {
-          nerr("message too short, %zu < %zu.\n", len,
-               sizeof(struct usrsock_message_common_s));
-          return -EINVAL;
-        }
+          /* Start of message, buffer length should be at least size of
+           * common message header.
+           */
 
-      /* Handle message. */
+          if (len < sizeof(struct usrsock_message_common_s))
+            {
+              if (len == origlen)
+                {
+                  nerr("message too short, %zu < %zu.\n", len,
+                       sizeof(struct usrsock_message_common_s));
+                  ret = -EINVAL;
+                }
+
+              break;
+            }
+
+          /* Handle message. */
+
+          ret = usrsock_handle_message(buffer, len, req_done, &pending);
+          if (ret < 0)
+            {
+              break;
+            }
 
-      ret = usrsock_handle_message(buffer, len, req_done);
-      if (ret >= 0)
-        {
           buffer += ret;
           len -= ret;
-          ret = origlen - len;
         }
-    }
 
-  if (req->datain_conn)
-    {
-      conn = req->datain_conn;
+      if (req->datain_conn)
+        {
+          conn = req->datain_conn;
 
-      /* Copy data from user-space. */
+          /* Copy data from user-space. */
 
-      if (len != 0)
-        {
-          ret = usrsock_iovec_put(conn->resp.datain.iov,
-                                  conn->resp.datain.iovcnt,
-                                  conn->resp.datain.pos, buffer, len);
-          if (ret < 0)
+          if (len != 0)
             {
-              /* Tried writing beyond buffer. */
+              ret = usrsock_iovec_put(conn->resp.datain.iov,
+                                      conn->resp.datain.iovcnt,
+                                      conn->resp.datain.pos, buffer, len);
+              if (ret < 0)
+                {
+                  /* Tried writing beyond buffer. */
+
+                  conn->resp.result = ret;
+                  conn->resp.datain.pos = conn->resp.datain.total;
+                }
+              else
+                {
+                  conn->resp.datain.pos += ret;
+                  buffer += ret;
+                  len -= ret;
+                }
+            }
 
-              conn->resp.result = ret;
-              conn->resp.datain.pos = conn->resp.datain.total;
+          if (conn->resp.datain.pos == conn->resp.datain.total)
+            {
+              req->datain_conn = NULL;
+
+              /* Done with data response. */
+
+              usrsock_event(conn);
             }
-          else
+
+          if (ret < 0)
             {
-              conn->resp.datain.pos += ret;
-              buffer += ret;
-              len -= ret;
-              ret = origlen - len;
+              break;
             }
         }
+    }
 
-      if (conn->resp.datain.pos == conn->resp.datain.total)
-        {
-          req->datain_conn = NULL;
+  if (pending != NULL)
+    {
+      usrsock_event(pending);
+    }
 
-          /* Done with data response. */
+  usrsock_unlock();
 
-          usrsock_event(conn);
-        }
-    }
+  /* Report what was consumed, an error only if nothing was */
 
-  return ret;
+  return len < origlen ? (ssize_t)(origlen - len) : ret;
 }
 
 /****************************************************************************
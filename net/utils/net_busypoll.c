@@ -0,0 +1,95 @@
+/****************************************************************************
+ * net/utils/net_busypoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: conn_dev_busy_poll
+ *
+ * Description:
+ *   Before a blocking receive sleeps on the connection semaphore, poll the
+ *   receive queues of the device directly for the SO_BUSY_POLL time of the
+ *   socket, unlocking the device and connection locks around each poll.
+ *
+ * Input Parameters:
+ *   sem   - The semaphore posted when the receive completes
+ *   sconn - The connection of the socket
+ *   dev   - The device the data is expected from, may be NULL
+ *
+ * Returned Value:
+ *   Zero (OK) if the semaphore was taken while polling, -EAGAIN if the
+ *   caller still has to wait for it.
+ *
+ * Assumptions:
+ *   The caller holds the connection and device locks once.
+ *
+ ****************************************************************************/
+
+int conn_dev_busy_poll(FAR sem_t *sem, FAR struct socket_conn_s *sconn,
+                       FAR struct net_driver_s *dev)
+{
+  uint64_t deadline;
+
+  if (sconn->s_busypoll == 0 || dev == NULL || dev->d_busypoll == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  deadline = clock_systime_nsec() +
+             (uint64_t)sconn->s_busypoll * NSEC_PER_USEC;
+
+  do
+    {
+      /* The receive path takes the locks itself, and other users of the
+       * connection or the device must not be kept out while spinning.
+       */
+
+      conn_dev_unlock(sconn, dev);
+      dev->d_busypoll(dev);
+      conn_dev_lock(sconn, dev);
+
+      if (nxsem_trywait(sem) == OK)
+        {
+          return OK;
+        }
+    }
+  while (clock_systime_nsec() < deadline);
+
+  return -EAGAIN;
+}
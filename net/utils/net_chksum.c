@@ -27,6 +27,8 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <string.h>
+
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -53,56 +55,25 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
-                    uint16_t len, bool *odd)
+static uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
+                         uint16_t len, FAR bool *odd)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  if (*odd == true)
+  if (*odd)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      /* The data starts with the second byte of a 16-bit word.  Summing
+       * it one byte off is the same as summing it byte swapped.
+       */
 
-      dataptr += 1;
+      sum = (uint16_t)((sum << 8) | (sum >> 8));
+      sum = chksum_block(sum, data, len);
+      sum = (uint16_t)((sum << 8) | (sum >> 8));
     }
-
-  while (dataptr < last_byte)
+  else
     {
-      /* At least two more bytes */
-
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      dataptr += 2;
+      sum = chksum_block(sum, data, len);
     }
 
-  *odd = false;
-
-  if (dataptr == last_byte)
-    {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
-
-      *odd = true;
-    }
+  *odd ^= (len & 1) != 0;
 
   /* Return sum in host byte order. */
 
@@ -113,6 +84,77 @@ uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Add the 16-bit words of a buffer of any alignment and length to a
+ *   partial checksum.  The words are summed in the native byte order,
+ *   32 bits at a time into a 64-bit accumulator: the one's complement
+ *   sum does not depend on the word size or the byte order, so only the
+ *   folded result needs to be swapped on little-endian targets.
+ *
+ *   If CONFIG_LIBC_ARCH_CHKSUM is defined, then this function is provided
+ *   by the architecture-specific C library (libs/libc/machine).
+ *
+ * Input Parameters:
+ *   sum  - Partial checksum in host byte order.
+ *   data - Beginning of the data, its first byte is the high byte of the
+ *          first word.
+ *   len  - Length of the data, an odd last byte is padded with zero.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_LIBC_ARCH_CHKSUM
+uint16_t chksum_block(uint16_t sum, FAR const uint8_t *data, size_t len)
+{
+  uint64_t acc = 0;
+  uint32_t word[4];
+  uint16_t half = 0;
+
+  for (; len >= sizeof(word); data += sizeof(word), len -= sizeof(word))
+    {
+      memcpy(word, data, sizeof(word));
+      acc += (uint64_t)word[0] + word[1] + word[2] + word[3];
+    }
+
+  for (; len >= sizeof(word[0]); data += sizeof(word[0]),
+                                 len -= sizeof(word[0]))
+    {
+      memcpy(word, data, sizeof(word[0]));
+      acc += word[0];
+    }
+
+  if (len >= sizeof(half))
+    {
+      memcpy(&half, data, sizeof(half));
+      acc  += half;
+      data += sizeof(half);
+      len  -= sizeof(half);
+    }
+
+  if (len > 0)
+    {
+      half = 0;
+      memcpy(&half, data, 1);
+      acc += half;
+    }
+
+  /* Fold to 16 bits, then add the result to sum */
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  acc = (uint64_t)sum + NTOHS((uint16_t)acc);
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+#endif /* CONFIG_LIBC_ARCH_CHKSUM */
+
 /****************************************************************************
  * Name: chksum
  *
@@ -132,6 +174,7 @@ uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
   bool odd = false;
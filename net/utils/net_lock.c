@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
+#include <string.h>
 #include <time.h>
 
 #include <nuttx/irq.h>
@@ -54,6 +55,56 @@
 
 static rmutex_t g_netlock = NXRMUTEX_INITIALIZER;
 
+#ifdef CONFIG_NET_LOCK_STATS
+static clock_t g_netlock_start;             /* When the hold began */
+static struct net_lockstats_s g_netlock_stats;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lock_acquired/net_lock_releasing
+ *
+ * Description:
+ *   Start and end the measure of an outermost hold of the network lock,
+ *   called with mutex held.  'all' is true if the whole nesting is taken
+ *   or released at once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+static void net_lock_acquired(FAR rmutex_t *mutex, bool all)
+{
+  if (mutex == &g_netlock && nxrmutex_is_hold(mutex) &&
+      (all || g_netlock.count == 1))
+    {
+      g_netlock_start = perf_gettime();
+    }
+}
+
+static void net_lock_releasing(FAR rmutex_t *mutex, bool all)
+{
+  clock_t elapsed;
+
+  if (mutex == &g_netlock && nxrmutex_is_hold(mutex) &&
+      (all || g_netlock.count == 1))
+    {
+      elapsed = perf_gettime() - g_netlock_start;
+      g_netlock_stats.nholds++;
+      g_netlock_stats.total += elapsed;
+      if (elapsed > g_netlock_stats.max)
+        {
+          g_netlock_stats.max = elapsed;
+        }
+    }
+}
+#else
+#  define net_lock_acquired(mutex, all)
+#  define net_lock_releasing(mutex, all)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,11 +129,13 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
 
   if (mutex1 != NULL)
     {
+      net_lock_releasing(mutex1, true);
       blresult1 = nxrmutex_breaklock(mutex1, &count1);
     }
 
   if (mutex2 != NULL)
     {
+      net_lock_releasing(mutex2, true);
       blresult2 = nxrmutex_breaklock(mutex2, &count2);
     }
 
@@ -120,11 +173,13 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
   if (blresult2 >= 0)
     {
       nxrmutex_restorelock(mutex2, count2);
+      net_lock_acquired(mutex2, true);
     }
 
   if (blresult1 >= 0)
     {
       nxrmutex_restorelock(mutex1, count1);
+      net_lock_acquired(mutex1, true);
     }
 
   return ret;
@@ -147,7 +202,15 @@ int net_sem_timedwait2(FAR sem_t *sem, bool interruptible,
 
 int net_lock(void)
 {
-  return nxrmutex_lock(&g_netlock);
+  int ret;
+
+  ret = nxrmutex_lock(&g_netlock);
+  if (ret >= 0)
+    {
+      net_lock_acquired(&g_netlock, false);
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -169,7 +232,15 @@ int net_lock(void)
 
 int net_trylock(void)
 {
-  return nxrmutex_trylock(&g_netlock);
+  int ret;
+
+  ret = nxrmutex_trylock(&g_netlock);
+  if (ret >= 0)
+    {
+      net_lock_acquired(&g_netlock, false);
+    }
+
+  return ret;
 }
 
 /****************************************************************************
@@ -188,9 +259,34 @@ int net_trylock(void)
 
 void net_unlock(void)
 {
+  net_lock_releasing(&g_netlock, false);
   nxrmutex_unlock(&g_netlock);
 }
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return the net_lock() hold statistics, optionally starting them over.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCK_STATS
+void net_lockstats(FAR struct net_lockstats_s *stats, bool reset)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  *stats = g_netlock_stats;
+  if (reset)
+    {
+      memset(&g_netlock_stats, 0, sizeof(g_netlock_stats));
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: net_breaklock
  *
@@ -203,6 +299,8 @@ void net_unlock(void)
 int net_breaklock(FAR unsigned int *count)
 {
   DEBUGASSERT(count != NULL);
+
+  net_lock_releasing(&g_netlock, true);
   return nxrmutex_breaklock(&g_netlock, count);
 }
 
@@ -220,7 +318,15 @@ int net_breaklock(FAR unsigned int *count)
 
 int net_restorelock(unsigned int count)
 {
-  return nxrmutex_restorelock(&g_netlock, count);
+  int ret;
+
+  ret = nxrmutex_restorelock(&g_netlock, count);
+  if (ret >= 0)
+    {
+      net_lock_acquired(&g_netlock, true);
+    }
+
+  return ret;
 }
 
 /****************************************************************************
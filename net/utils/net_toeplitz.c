@@ -0,0 +1,101 @@
+/****************************************************************************
+ * net/utils/net_toeplitz.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/net/netdev.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TOEPLITZ_KEY_SIZE 40
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The default RSS key of most NICs, so that the software hash matches the
+ * one computed by the hardware.
+ */
+
+static const uint8_t g_toeplitz_key[TOEPLITZ_KEY_SIZE] =
+{
+  0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2, 0x41, 0x67,
+  0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0, 0xd0, 0xca, 0x2b, 0xcb,
+  0xae, 0x7b, 0x30, 0xb4, 0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30,
+  0xf2, 0x0c, 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_toeplitz_hash
+ *
+ * Description:
+ *   Calculate the Toeplitz hash of the data with the default RSS key.
+ *   Toeplitz matrix is a special matrix where each diagonal has the same
+ *   elements.
+ *
+ * Input Parameters:
+ *   data - The data to hash, e.g. the addresses and ports of a flow
+ *   len  - The length of the data in bytes, at most 36
+ *
+ * Returned Value:
+ *   The hash value with toeplitz matrix calculation
+ *
+ ****************************************************************************/
+
+uint32_t net_toeplitz_hash(FAR const uint8_t *data, size_t len)
+{
+  uint32_t key = ((uint32_t)g_toeplitz_key[0] << 24) |
+                 ((uint32_t)g_toeplitz_key[1] << 16) |
+                 ((uint32_t)g_toeplitz_key[2] << 8) | g_toeplitz_key[3];
+  uint32_t ret = 0;
+  size_t i;
+  int j;
+
+  for (i = 0; i < len; i++)
+    {
+      for (j = 0; j < 8; j++)
+        {
+          if (data[i] & (1 << (7 - j)))
+            {
+              ret ^= key;
+            }
+
+          key <<= 1;
+          if ((i + 4) < TOEPLITZ_KEY_SIZE &&
+              (g_toeplitz_key[i + 4] & (1 << (7 - j))))
+            {
+              key |= 1;
+            }
+        }
+    }
+
+  return ret;
+}
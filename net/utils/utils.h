@@ -223,6 +223,30 @@ conn_dev_sem_timedwait(FAR sem_t *sem, bool interruptible,
 struct net_driver_s;      /* Forward reference */
 struct timeval;           /* Forward reference */
 
+/****************************************************************************
+ * Name: conn_dev_busy_poll
+ *
+ * Description:
+ *   Before a blocking receive sleeps on the connection semaphore, poll the
+ *   receive queues of the device directly for the SO_BUSY_POLL time of the
+ *   socket, unlocking the device and connection locks around each poll.
+ *
+ * Input Parameters:
+ *   sem   - The semaphore posted when the receive completes
+ *   sconn - The connection of the socket
+ *   dev   - The device the data is expected from, may be NULL
+ *
+ * Returned Value:
+ *   Zero (OK) if the semaphore was taken while polling, -EAGAIN if the
+ *   caller still has to wait for it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+int conn_dev_busy_poll(FAR sem_t *sem, FAR struct socket_conn_s *sconn,
+                       FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: net_breaklock
  *
@@ -0,0 +1,194 @@
+/****************************************************************************
+ * net/xdp/xdp.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_XDP_XDP_H
+#define __NET_XDP_XDP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <poll.h>
+
+#include <netpacket/xdp.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#ifdef CONFIG_NET_XDP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of a ring mapping: the producer and consumer indices on their own
+ * cache lines, then the flags and the descriptors.
+ */
+
+#define XDP_RING_PRODUCER  0
+#define XDP_RING_CONSUMER  64
+#define XDP_RING_FLAGS     128
+#define XDP_RING_DESC      192
+
+#define XDP_MAX_ENTRIES    32768
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A user accessible block backing one ring, reference counted by the
+ * socket and by each of its mappings.
+ */
+
+struct xdp_umap_s
+{
+  atomic_t     crefs;
+  size_t       size;
+  FAR uint8_t *base;
+};
+
+/* Kernel view of one ring.  The producer is owned by the kernel for the RX
+ * and completion rings and by the application for the TX and fill rings;
+ * the consumer the other way round.
+ */
+
+struct xdp_ring_s
+{
+  FAR struct xdp_umap_s  *map;      /* NULL if the ring is not set up */
+  FAR volatile uint32_t  *producer;
+  FAR volatile uint32_t  *consumer;
+  FAR uint8_t            *desc;
+  uint32_t                mask;     /* Number of entries - 1 */
+};
+
+struct xdp_conn_s
+{
+  /* Common prologue of all connection structures. */
+
+  struct socket_conn_s    sconn;
+
+  /* XDP socket-specific content follows */
+
+  struct netdev_xdp_s     hook;     /* Attached to the bound RX queue */
+  int                     ifindex;  /* Bound interface, 0 if not bound */
+  uint32_t                queue;    /* Bound queue */
+  uint16_t                crefs;    /* Reference counts on this instance */
+
+  /* The UMEM registered with XDP_UMEM_REG */
+
+  FAR uint8_t            *umem;
+  size_t                  umem_len;
+  uint32_t                chunk_size;
+  uint32_t                headroom;
+
+  /* The RX and fill rings, the filter program, the statistics and the
+   * poll waiters are protected by sconn.s_lock, which the RX path takes
+   * with the device locked.  The TX and completion rings are protected by
+   * txlock, which the TX path holds while it locks the device.
+   */
+
+  struct xdp_ring_s       rx;
+  struct xdp_ring_s       fill;
+  struct xdp_ring_s       tx;
+  struct xdp_ring_s       comp;
+  mutex_t                 txlock;
+
+  FAR struct xdp_filter_insn *prog;
+  uint16_t                proglen;
+
+  struct xdp_statistics   stats;
+
+  FAR struct pollfd      *fds[CONFIG_NET_XDP_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+/* The AF_XDP socket interface */
+
+EXTERN const struct sock_intf_s g_xdp_sockif;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: xdp_input
+ *
+ * Description:
+ *   The RX hook of a bound AF_XDP socket: run the filter program over the
+ *   frame and, if redirected, copy it into a UMEM chunk taken from the
+ *   fill ring and post it on the RX ring.
+ *
+ * Input Parameters:
+ *   xdp - The hook, embedded in struct xdp_conn_s
+ *   dev - The network device that received the frame
+ *   pkt - The frame
+ *
+ * Returned Value:
+ *   true if the frame was consumed (redirected or dropped), false if it
+ *   should go on to the network stack.
+ *
+ * Assumptions:
+ *   Called from the RX poll of the device with the device locked.
+ *
+ ****************************************************************************/
+
+bool xdp_input(FAR struct netdev_xdp_s *xdp, FAR struct net_driver_s *dev,
+               FAR struct iob_s *pkt);
+
+/****************************************************************************
+ * Name: xdp_filter_verify
+ *
+ * Description:
+ *   Check a filter program given to XDP_FILTER.
+ *
+ * Returned Value:
+ *   Zero (OK) if the program is valid; -EINVAL otherwise.
+ *
+ ****************************************************************************/
+
+int xdp_filter_verify(FAR const struct xdp_filter_insn *prog,
+                      unsigned int proglen);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_NET_XDP */
+#endif /* __NET_XDP_XDP_H */
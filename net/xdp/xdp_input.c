@@ -0,0 +1,328 @@
+/****************************************************************************
+ * net/xdp/xdp_input.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+#include "xdp/xdp.h"
+
+#ifdef CONFIG_NET_XDP
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: xdp_filter_load
+ *
+ * Description:
+ *   Load the big endian field of an instruction from the frame.
+ *
+ * Returned Value:
+ *   true if the field is inside the frame.
+ *
+ ****************************************************************************/
+
+static bool xdp_filter_load(FAR const struct xdp_filter_insn *insn,
+                            FAR struct iob_s *pkt, int llhdrlen,
+                            unsigned int len, FAR uint32_t *value)
+{
+  FAR const uint8_t *field;
+  uint8_t buf[4];
+  unsigned int i;
+
+  if (insn->off + insn->size > len)
+    {
+      return false;
+    }
+
+  /* The link layer header and the first IOB are contiguous */
+
+  if (insn->off + insn->size <= llhdrlen + pkt->io_len)
+    {
+      field = IOB_DATA(pkt) - llhdrlen + insn->off;
+    }
+  else
+    {
+      if (iob_copyout(buf, pkt, insn->size, insn->off - llhdrlen) !=
+          insn->size)
+        {
+          return false;
+        }
+
+      field = buf;
+    }
+
+  *value = 0;
+  for (i = 0; i < insn->size; i++)
+    {
+      *value = (*value << 8) | field[i];
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: xdp_filter_run
+ *
+ * Description:
+ *   Run the filter program of a socket over a frame.
+ *
+ * Returned Value:
+ *   XDP_FILTER_DROP, XDP_FILTER_PASS or XDP_FILTER_REDIRECT.
+ *
+ ****************************************************************************/
+
+static int xdp_filter_run(FAR struct xdp_conn_s *conn,
+                          FAR struct net_driver_s *dev,
+                          FAR struct iob_s *pkt, unsigned int len)
+{
+  FAR const struct xdp_filter_insn *insn = conn->prog;
+  FAR const struct xdp_filter_insn *end = insn + conn->proglen;
+  int llhdrlen = NET_LL_HDRLEN(dev);
+  uint32_t value;
+
+  if (conn->proglen == 0)
+    {
+      return XDP_FILTER_REDIRECT;
+    }
+
+  while (insn < end)
+    {
+      if (xdp_filter_load(insn, pkt, llhdrlen, len, &value) &&
+          (value & insn->mask) == insn->value)
+        {
+          if (insn->action != XDP_FILTER_CONT)
+            {
+              return insn->action;
+            }
+
+          insn++;
+          continue;
+        }
+
+      /* The clause failed, skip to the start of the next one */
+
+      while (insn->action == XDP_FILTER_CONT)
+        {
+          insn++;
+        }
+
+      insn++;
+    }
+
+  return XDP_FILTER_PASS;
+}
+
+/****************************************************************************
+ * Name: xdp_deliver
+ *
+ * Description:
+ *   Copy a redirected frame into the chunk at the head of the fill ring
+ *   and post it on the RX ring.
+ *
+ * Returned Value:
+ *   true if the frame was posted.
+ *
+ ****************************************************************************/
+
+static bool xdp_deliver(FAR struct xdp_conn_s *conn,
+                        FAR struct net_driver_s *dev,
+                        FAR struct iob_s *pkt, unsigned int len)
+{
+  FAR struct xdp_desc *desc;
+  uint32_t prod = *conn->rx.producer;
+  uint32_t cons = *conn->fill.consumer;
+  uint64_t addr;
+
+  if (prod - *conn->rx.consumer > conn->rx.mask)
+    {
+      conn->stats.rx_ring_full++;
+      return false;
+    }
+
+  if (cons == *conn->fill.producer)
+    {
+      conn->stats.rx_fill_ring_empty_descs++;
+      return false;
+    }
+
+  /* Read the fill descriptor only after seeing the producer move */
+
+  SMP_RMB();
+  addr = ((FAR uint64_t *)conn->fill.desc)[cons & conn->fill.mask];
+
+  SMP_MB();
+  *conn->fill.consumer = cons + 1;
+
+  addr &= ~(uint64_t)(conn->chunk_size - 1);
+  if (addr >= conn->umem_len)
+    {
+      conn->stats.rx_invalid_descs++;
+      return false;
+    }
+
+  if (conn->headroom + len > conn->chunk_size)
+    {
+      conn->stats.rx_dropped++;
+      return false;
+    }
+
+  addr += conn->headroom;
+  if (iob_copyout(conn->umem + addr, pkt, len, -NET_LL_HDRLEN(dev)) !=
+      len)
+    {
+      conn->stats.rx_dropped++;
+      return false;
+    }
+
+  desc = (FAR struct xdp_desc *)conn->rx.desc + (prod & conn->rx.mask);
+  desc->addr    = addr;
+  desc->len     = len;
+  desc->options = 0;
+
+  SMP_WMB();
+  *conn->rx.producer = prod + 1;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: xdp_filter_verify
+ *
+ * Description:
+ *   Check a filter program given to XDP_FILTER.
+ *
+ * Returned Value:
+ *   Zero (OK) if the program is valid; -EINVAL otherwise.
+ *
+ ****************************************************************************/
+
+int xdp_filter_verify(FAR const struct xdp_filter_insn *prog,
+                      unsigned int proglen)
+{
+  unsigned int i;
+
+  if (proglen > CONFIG_NET_XDP_FILTER_MAXINSNS)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < proglen; i++)
+    {
+      if (prog[i].size != 1 && prog[i].size != 2 && prog[i].size != 4)
+        {
+          return -EINVAL;
+        }
+
+      switch (prog[i].action)
+        {
+          case XDP_FILTER_CONT:
+          case XDP_FILTER_DROP:
+          case XDP_FILTER_PASS:
+          case XDP_FILTER_REDIRECT:
+            break;
+
+          default:
+            return -EINVAL;
+        }
+    }
+
+  /* The last clause must have a verdict */
+
+  if (proglen > 0 && prog[proglen - 1].action == XDP_FILTER_CONT)
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: xdp_input
+ *
+ * Description:
+ *   The RX hook of a bound AF_XDP socket: run the filter program over the
+ *   frame and, if redirected, copy it into a UMEM chunk taken from the
+ *   fill ring and post it on the RX ring.
+ *
+ * Input Parameters:
+ *   xdp - The hook, embedded in struct xdp_conn_s
+ *   dev - The network device that received the frame
+ *   pkt - The frame
+ *
+ * Returned Value:
+ *   true if the frame was consumed (redirected or dropped), false if it
+ *   should go on to the network stack.
+ *
+ * Assumptions:
+ *   Called from the RX poll of the device with the device locked.
+ *
+ ****************************************************************************/
+
+bool xdp_input(FAR struct netdev_xdp_s *xdp, FAR struct net_driver_s *dev,
+               FAR struct iob_s *pkt)
+{
+  FAR struct xdp_conn_s *conn =
+    container_of(xdp, struct xdp_conn_s, hook);
+  unsigned int len = pkt->io_pktlen + NET_LL_HDRLEN(dev);
+  int verdict;
+
+  conn_lock(&conn->sconn);
+
+  verdict = xdp_filter_run(conn, dev, pkt, len);
+  if (verdict == XDP_FILTER_PASS)
+    {
+      conn_unlock(&conn->sconn);
+      return false;
+    }
+
+  if (verdict == XDP_FILTER_REDIRECT && conn->rx.map != NULL)
+    {
+      if (xdp_deliver(conn, dev, pkt, len))
+        {
+          poll_notify(conn->fds, CONFIG_NET_XDP_NPOLLWAITERS, POLLIN);
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+  return true;
+}
+
+#endif /* CONFIG_NET_XDP */
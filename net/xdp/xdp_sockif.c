@@ -0,0 +1,846 @@
+/****************************************************************************
+ * net/xdp/xdp_sockif.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netpacket/xdp.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "xdp/xdp.h"
+
+#ifdef CONFIG_NET_XDP
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int        xdp_setup(FAR struct socket *psock);
+static sockcaps_t xdp_sockcaps(FAR struct socket *psock);
+static void       xdp_addref(FAR struct socket *psock);
+static int        xdp_bind(FAR struct socket *psock,
+                           FAR const struct sockaddr *addr,
+                           socklen_t addrlen);
+static int        xdp_poll(FAR struct socket *psock,
+                           FAR struct pollfd *fds, bool setup);
+static ssize_t    xdp_sendmsg(FAR struct socket *psock,
+                              FAR const struct msghdr *msg, int flags);
+static ssize_t    xdp_recvmsg(FAR struct socket *psock,
+                              FAR struct msghdr *msg, int flags);
+static int        xdp_close(FAR struct socket *psock);
+#ifdef CONFIG_NET_SOCKOPTS
+static int        xdp_getsockopt(FAR struct socket *psock, int level,
+                                 int option, FAR void *value,
+                                 FAR socklen_t *value_len);
+static int        xdp_setsockopt(FAR struct socket *psock, int level,
+                                 int option, FAR const void *value,
+                                 socklen_t value_len);
+#endif
+static int        xdp_mmap(FAR struct socket *psock,
+                           FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct sock_intf_s g_xdp_sockif =
+{
+  xdp_setup,       /* si_setup */
+  xdp_sockcaps,    /* si_sockcaps */
+  xdp_addref,      /* si_addref */
+  xdp_bind,        /* si_bind */
+  NULL,            /* si_getsockname */
+  NULL,            /* si_getpeername */
+  NULL,            /* si_listen */
+  NULL,            /* si_connect */
+  NULL,            /* si_accept */
+  xdp_poll,        /* si_poll */
+  xdp_sendmsg,     /* si_sendmsg */
+  xdp_recvmsg,     /* si_recvmsg */
+  xdp_close,       /* si_close */
+  NULL,            /* si_ioctl */
+  NULL,            /* si_socketpair */
+  NULL             /* si_shutdown */
+#ifdef CONFIG_NET_SOCKOPTS
+  , xdp_getsockopt /* si_getsockopt */
+  , xdp_setsockopt /* si_setsockopt */
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+  , NULL           /* si_sendmmsg */
+  , NULL           /* si_recvmmsg */
+  , xdp_mmap       /* si_mmap */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: xdp_umap_put
+ *
+ * Description:
+ *   Drop a reference to a ring block, freeing it with the last one.
+ *
+ ****************************************************************************/
+
+static void xdp_umap_put(FAR struct xdp_umap_s *map)
+{
+  if (atomic_fetch_sub(&map->crefs, 1) == 1)
+    {
+      kumm_free(map->base);
+      kmm_free(map);
+    }
+}
+
+/****************************************************************************
+ * Name: xdp_ring_create
+ *
+ * Description:
+ *   Allocate a ring of 'nentries' descriptors of 'descsize' bytes.
+ *
+ ****************************************************************************/
+
+static int xdp_ring_create(FAR struct xdp_ring_s *ring, int nentries,
+                           size_t descsize)
+{
+  FAR struct xdp_umap_s *map;
+
+  if (nentries <= 0 || nentries > XDP_MAX_ENTRIES ||
+      (nentries & (nentries - 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (ring->map != NULL)
+    {
+      return -EBUSY;
+    }
+
+  map = kmm_zalloc(sizeof(struct xdp_umap_s));
+  if (map == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The ring is read and written directly by the application */
+
+  map->size = XDP_RING_DESC + nentries * descsize;
+  map->base = kumm_zalloc(map->size);
+  if (map->base == NULL)
+    {
+      kmm_free(map);
+      return -ENOMEM;
+    }
+
+  atomic_set(&map->crefs, 1);
+
+  ring->map      = map;
+  ring->producer = (FAR uint32_t *)(map->base + XDP_RING_PRODUCER);
+  ring->consumer = (FAR uint32_t *)(map->base + XDP_RING_CONSUMER);
+  ring->desc     = map->base + XDP_RING_DESC;
+  ring->mask     = nentries - 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: xdp_ring_destroy
+ ****************************************************************************/
+
+static void xdp_ring_destroy(FAR struct xdp_ring_s *ring)
+{
+  if (ring->map != NULL)
+    {
+      xdp_umap_put(ring->map);
+      ring->map = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: xdp_munmap
+ ****************************************************************************/
+
+static int xdp_munmap(FAR struct task_group_s *group,
+                      FAR struct mm_map_entry_s *entry,
+                      FAR void *start, size_t length)
+{
+  FAR struct xdp_umap_s *map = entry->priv.p;
+  int ret;
+
+  /* A ring is only ever unmapped as a whole */
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  xdp_umap_put(map);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: xdp_setup
+ *
+ * Description:
+ *   Called for socket() to verify that the provided socket type and
+ *   protocol are usable by this address family.  Only SOCK_RAW is
+ *   supported.
+ *
+ ****************************************************************************/
+
+static int xdp_setup(FAR struct socket *psock)
+{
+  FAR struct xdp_conn_s *conn;
+
+  if (psock->s_type != SOCK_RAW)
+    {
+      return -EPROTONOSUPPORT;
+    }
+
+  conn = kmm_zalloc(sizeof(struct xdp_conn_s));
+  if (conn == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxrmutex_init(&conn->sconn.s_lock);
+  nxmutex_init(&conn->txlock);
+  conn->hook.rx = xdp_input;
+  conn->crefs   = 1;
+
+  psock->s_conn = conn;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: xdp_sockcaps
+ ****************************************************************************/
+
+static sockcaps_t xdp_sockcaps(FAR struct socket *psock)
+{
+  return SOCKCAP_NONBLOCKING;
+}
+
+/****************************************************************************
+ * Name: xdp_addref
+ ****************************************************************************/
+
+static void xdp_addref(FAR struct socket *psock)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+
+  DEBUGASSERT(conn->crefs > 0 && conn->crefs < UINT16_MAX);
+  conn->crefs++;
+}
+
+/****************************************************************************
+ * Name: xdp_bind
+ *
+ * Description:
+ *   Attach the socket to an RX queue of an interface.  The UMEM, the fill
+ *   ring and at least one of the RX and TX rings must be set up first, and
+ *   the interface driver must provide the AF_XDP methods.
+ *
+ ****************************************************************************/
+
+static int xdp_bind(FAR struct socket *psock,
+                    FAR const struct sockaddr *addr, socklen_t addrlen)
+{
+  FAR const struct sockaddr_xdp *sxdp =
+    (FAR const struct sockaddr_xdp *)addr;
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  int ret = OK;
+
+  if (addrlen < sizeof(struct sockaddr_xdp) ||
+      sxdp->sxdp_family != AF_XDP)
+    {
+      return -EINVAL;
+    }
+
+  if ((sxdp->sxdp_flags & (XDP_SHARED_UMEM | XDP_ZEROCOPY)) != 0)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  conn_lock(&conn->sconn);
+
+  if (conn->ifindex != 0)
+    {
+      ret = -EINVAL;
+    }
+  else if (conn->umem == NULL ||
+           (conn->rx.map == NULL && conn->tx.map == NULL) ||
+           (conn->rx.map != NULL && conn->fill.map == NULL) ||
+           (conn->tx.map != NULL && conn->comp.map == NULL))
+    {
+      ret = -EINVAL;
+    }
+
+  conn_unlock(&conn->sconn);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev = netdev_findbyindex(sxdp->sxdp_ifindex);
+  if (dev == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (dev->d_xdpattach == NULL || dev->d_xdpxmit == NULL)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  /* Only a socket with an RX ring takes frames from the queue */
+
+  if (conn->rx.map != NULL)
+    {
+      ret = dev->d_xdpattach(dev, sxdp->sxdp_queue_id, &conn->hook);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  conn_lock(&conn->sconn);
+  conn->ifindex = sxdp->sxdp_ifindex;
+  conn->queue   = sxdp->sxdp_queue_id;
+  conn_unlock(&conn->sconn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: xdp_poll
+ *
+ * Description:
+ *   POLLIN while the RX ring holds frames, POLLOUT while the TX ring has
+ *   room.
+ *
+ ****************************************************************************/
+
+static int xdp_poll(FAR struct socket *psock, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+  pollevent_t eventset = 0;
+  int ret = OK;
+  int i;
+
+  conn_lock(&conn->sconn);
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_NET_XDP_NPOLLWAITERS; i++)
+        {
+          if (conn->fds[i] == NULL)
+            {
+              conn->fds[i] = fds;
+              fds->priv    = &conn->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_NET_XDP_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+        }
+      else
+        {
+          if (conn->rx.map != NULL &&
+              *conn->rx.producer != *conn->rx.consumer)
+            {
+              eventset |= POLLIN;
+            }
+
+          if (conn->tx.map != NULL &&
+              *conn->tx.producer - *conn->tx.consumer <= conn->tx.mask)
+            {
+              eventset |= POLLOUT;
+            }
+
+          poll_notify(&fds, 1, eventset);
+        }
+    }
+  else if (fds->priv != NULL)
+    {
+      *(FAR struct pollfd **)fds->priv = NULL;
+      fds->priv = NULL;
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: xdp_sendmsg
+ *
+ * Description:
+ *   Any send() on a bound socket flushes its TX ring: every descriptor
+ *   queued by the application is transmitted straight by the device and
+ *   its UMEM address posted on the completion ring.  The message itself is
+ *   ignored.
+ *
+ ****************************************************************************/
+
+static ssize_t xdp_sendmsg(FAR struct socket *psock,
+                           FAR const struct msghdr *msg, int flags)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  FAR struct xdp_desc *desc;
+  uint32_t cons;
+  uint32_t prod;
+  int nsent = 0;
+  int ret = OK;
+
+  if (conn->ifindex == 0 || conn->tx.map == NULL)
+    {
+      return -ENXIO;
+    }
+
+  dev = netdev_findbyindex(conn->ifindex);
+  if (dev == NULL)
+    {
+      return -ENETDOWN;
+    }
+
+  nxmutex_lock(&conn->txlock);
+
+  cons = *conn->tx.consumer;
+  if (cons == *conn->tx.producer)
+    {
+      conn_lock(&conn->sconn);
+      conn->stats.tx_ring_empty_descs++;
+      conn_unlock(&conn->sconn);
+    }
+
+  while (cons != *conn->tx.producer)
+    {
+      prod = *conn->comp.producer;
+      if (prod - *conn->comp.consumer > conn->comp.mask)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      SMP_RMB();
+      desc = (FAR struct xdp_desc *)conn->tx.desc + (cons & conn->tx.mask);
+
+      if (desc->len == 0 ||
+          (desc->addr & (conn->chunk_size - 1)) + desc->len >
+          conn->chunk_size || desc->addr >= conn->umem_len)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = dev->d_xdpxmit(dev, conn->queue, conn->umem + desc->addr,
+                               desc->len);
+          if (ret == -EAGAIN || ret == -ENETDOWN)
+            {
+              break;
+            }
+        }
+
+      if (ret < 0)
+        {
+          /* Invalid descriptors are skipped without completion */
+
+          conn_lock(&conn->sconn);
+          conn->stats.tx_invalid_descs++;
+          conn_unlock(&conn->sconn);
+        }
+      else
+        {
+          ((FAR uint64_t *)conn->comp.desc)[prod & conn->comp.mask] =
+            desc->addr;
+
+          SMP_WMB();
+          *conn->comp.producer = prod + 1;
+          nsent++;
+        }
+
+      SMP_MB();
+      *conn->tx.consumer = ++cons;
+    }
+
+  nxmutex_unlock(&conn->txlock);
+
+  return nsent > 0 || ret == OK ? 0 : ret;
+}
+
+/****************************************************************************
+ * Name: xdp_recvmsg
+ *
+ * Description:
+ *   Frames are only received through the RX ring.
+ *
+ ****************************************************************************/
+
+static ssize_t xdp_recvmsg(FAR struct socket *psock,
+                           FAR struct msghdr *msg, int flags)
+{
+  return -EOPNOTSUPP;
+}
+
+/****************************************************************************
+ * Name: xdp_close
+ *
+ * Description:
+ *   Detach the socket from its queue and drop its references to the
+ *   rings.  Rings still mapped are freed by their last munmap().
+ *
+ ****************************************************************************/
+
+static int xdp_close(FAR struct socket *psock)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+
+  if (conn->crefs > 1)
+    {
+      conn->crefs--;
+      return OK;
+    }
+
+  if (conn->ifindex != 0 && conn->rx.map != NULL)
+    {
+      dev = netdev_findbyindex(conn->ifindex);
+      if (dev != NULL)
+        {
+          dev->d_xdpattach(dev, conn->queue, NULL);
+        }
+    }
+
+  xdp_ring_destroy(&conn->rx);
+  xdp_ring_destroy(&conn->tx);
+  xdp_ring_destroy(&conn->fill);
+  xdp_ring_destroy(&conn->comp);
+
+  if (conn->prog != NULL)
+    {
+      kmm_free(conn->prog);
+    }
+
+  nxmutex_destroy(&conn->txlock);
+  nxrmutex_destroy(&conn->sconn.s_lock);
+  kmm_free(conn);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: xdp_getsockopt
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static int xdp_getsockopt(FAR struct socket *psock, int level, int option,
+                          FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+
+  if (level != SOL_XDP)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case XDP_MMAP_OFFSETS:
+        {
+          FAR struct xdp_mmap_offsets *off = value;
+          struct xdp_ring_offset ring;
+
+          if (*value_len < sizeof(struct xdp_mmap_offsets))
+            {
+              return -EINVAL;
+            }
+
+          ring.producer = XDP_RING_PRODUCER;
+          ring.consumer = XDP_RING_CONSUMER;
+          ring.desc     = XDP_RING_DESC;
+          ring.flags    = XDP_RING_FLAGS;
+
+          off->rx    = ring;
+          off->tx    = ring;
+          off->fr    = ring;
+          off->cr    = ring;
+          *value_len = sizeof(struct xdp_mmap_offsets);
+        }
+        break;
+
+      case XDP_STATISTICS:
+        if (*value_len < sizeof(struct xdp_statistics))
+          {
+            return -EINVAL;
+          }
+
+        conn_lock(&conn->sconn);
+        memcpy(value, &conn->stats, sizeof(struct xdp_statistics));
+        conn_unlock(&conn->sconn);
+        *value_len = sizeof(struct xdp_statistics);
+        break;
+
+      case XDP_OPTIONS:
+        if (*value_len < sizeof(struct xdp_options))
+          {
+            return -EINVAL;
+          }
+
+        ((FAR struct xdp_options *)value)->flags = 0;
+        *value_len = sizeof(struct xdp_options);
+        break;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: xdp_setsockopt
+ *
+ * Description:
+ *   The UMEM and the rings are set up once, before bind(); the filter
+ *   program may be replaced at any time.
+ *
+ ****************************************************************************/
+
+static int xdp_setsockopt(FAR struct socket *psock, int level, int option,
+                          FAR const void *value, socklen_t value_len)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+  FAR struct xdp_filter_insn *prog = NULL;
+  FAR struct xdp_filter_insn *old;
+  int ret = OK;
+
+  if (level != SOL_XDP)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (option == XDP_FILTER)
+    {
+      unsigned int proglen = value_len / sizeof(struct xdp_filter_insn);
+
+      if (value_len % sizeof(struct xdp_filter_insn) != 0)
+        {
+          return -EINVAL;
+        }
+
+      ret = xdp_filter_verify(value, proglen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (proglen > 0)
+        {
+          prog = kmm_malloc(value_len);
+          if (prog == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          memcpy(prog, value, value_len);
+        }
+
+      conn_lock(&conn->sconn);
+      old           = conn->prog;
+      conn->prog    = prog;
+      conn->proglen = proglen;
+      conn_unlock(&conn->sconn);
+
+      if (old != NULL)
+        {
+          kmm_free(old);
+        }
+
+      return OK;
+    }
+
+  conn_lock(&conn->sconn);
+
+  if (conn->ifindex != 0)
+    {
+      conn_unlock(&conn->sconn);
+      return -EBUSY;
+    }
+
+  switch (option)
+    {
+      case XDP_UMEM_REG:
+        {
+          FAR const struct xdp_umem_reg *reg = value;
+
+          if (value_len < sizeof(struct xdp_umem_reg))
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          if (conn->umem != NULL)
+            {
+              ret = -EBUSY;
+              break;
+            }
+
+          /* Chunks are naturally aligned powers of two, big enough for a
+           * full size Ethernet frame.
+           */
+
+          if (reg->addr == 0 || reg->chunk_size < 2048 ||
+              reg->chunk_size > 65536 ||
+              (reg->chunk_size & (reg->chunk_size - 1)) != 0 ||
+              reg->len < reg->chunk_size || reg->len > SIZE_MAX ||
+              reg->headroom >= reg->chunk_size || reg->flags != 0)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          conn->umem       = (FAR uint8_t *)(uintptr_t)reg->addr;
+          conn->umem_len   = reg->len & ~(uint64_t)(reg->chunk_size - 1);
+          conn->chunk_size = reg->chunk_size;
+          conn->headroom   = reg->headroom;
+        }
+        break;
+
+      case XDP_RX_RING:
+      case XDP_TX_RING:
+      case XDP_UMEM_FILL_RING:
+      case XDP_UMEM_COMPLETION_RING:
+        if (value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else if (option == XDP_RX_RING)
+          {
+            ret = xdp_ring_create(&conn->rx, *(FAR const int *)value,
+                                  sizeof(struct xdp_desc));
+          }
+        else if (option == XDP_TX_RING)
+          {
+            ret = xdp_ring_create(&conn->tx, *(FAR const int *)value,
+                                  sizeof(struct xdp_desc));
+          }
+        else if (option == XDP_UMEM_FILL_RING)
+          {
+            ret = xdp_ring_create(&conn->fill, *(FAR const int *)value,
+                                  sizeof(uint64_t));
+          }
+        else
+          {
+            ret = xdp_ring_create(&conn->comp, *(FAR const int *)value,
+                                  sizeof(uint64_t));
+          }
+        break;
+
+      default:
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
+/****************************************************************************
+ * Name: xdp_mmap
+ *
+ * Description:
+ *   Map one of the rings, selected by the mmap() offset, into the caller's
+ *   address space.
+ *
+ ****************************************************************************/
+
+static int xdp_mmap(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map)
+{
+  FAR struct xdp_conn_s *conn = psock->s_conn;
+  FAR struct xdp_ring_s *ring;
+  int ret = -EINVAL;
+
+  switch (map->offset)
+    {
+      case XDP_PGOFF_RX_RING:
+        ring = &conn->rx;
+        break;
+
+      case XDP_PGOFF_TX_RING:
+        ring = &conn->tx;
+        break;
+
+      case XDP_UMEM_PGOFF_FILL_RING:
+        ring = &conn->fill;
+        break;
+
+      case XDP_UMEM_PGOFF_COMPLETION_RING:
+        ring = &conn->comp;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  conn_lock(&conn->sconn);
+
+  if (ring->map != NULL && map->length <= ring->map->size)
+    {
+      map->vaddr  = ring->map->base;
+      map->priv.p = ring->map;
+      map->munmap = xdp_munmap;
+
+      atomic_fetch_add(&ring->map->crefs, 1);
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret < 0)
+        {
+          xdp_umap_put(ring->map);
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+  return ret;
+}
+
+#endif /* CONFIG_NET_XDP */
@@ -78,6 +78,13 @@ void clock_increase_sched_ticks(clock_t ticks);
 
 clock_t clock_get_sched_ticks(void);
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_initialize(void);
+void clock_vdso_update(clock_t ticks);
+#else
+#  define clock_vdso_update(ticks)
+#endif
+
 #ifdef CONFIG_SCHED_CPULOAD_SYSCLK
 void cpuload_init(void);
 #endif
@@ -65,12 +65,21 @@ static clock_t clock_process_runtime(FAR struct tcb_s *tcb)
     {
       tcb = container_of(curr, struct tcb_s, member);
 
+      /* Charge the slice of a member that is running right now */
+
+      nxsched_update_critmon(tcb);
       runtime += tcb->run_time;
     }
 
   spin_unlock_irqrestore(&group->tg_lock, flags);
   return runtime;
 # else  /* HAVE_GROUP_MEMBERS */
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  nxsched_update_critmon(tcb);
+  leave_critical_section(flags);
+
   return tcb->run_time;
 # endif /* HAVE_GROUP_MEMBERS */
 }
@@ -172,6 +181,12 @@ int nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp)
             }
           else if (clock_type == CLOCK_THREAD_CPUTIME_ID)
             {
+              irqstate_t flags;
+
+              flags = enter_critical_section();
+              nxsched_update_critmon(tcb);
+              leave_critical_section(flags);
+
               up_perf_convert(tcb->run_time, tp);
             }
           else
@@ -233,6 +233,10 @@ void clock_initialize(void)
   cpuload_init();
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+  clock_vdso_initialize();
+#endif
+
   sched_trace_end();
 }
 
@@ -70,7 +70,10 @@ void clock_increase_sched_ticks(clock_t ticks)
 
   flags = write_seqlock_irqsave(&g_system_tick_lock);
   g_system_ticks += ticks;
+  ticks = g_system_ticks;
   write_sequnlock_irqrestore(&g_system_tick_lock, flags);
+
+  clock_vdso_update(ticks);
 }
 
 /****************************************************************************
@@ -76,6 +76,7 @@ static void nxclock_set_realtime(FAR const struct timespec *tp)
   clock_notifier_call_chain(CLOCK_REALTIME, tp);
 
   spin_unlock_irqrestore(&g_basetime_lock, flags);
+  clock_vdso_update(clock_get_sched_ticks());
 
   /* Setup the RTC (lo- or high-res) */
 
@@ -0,0 +1,118 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/clock_vdso.h>
+#include <nuttx/kmalloc.h>
+
+#include "clock/clock.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CLOCK_REALTIME can be derived from the tick count alone only when the
+ * system time itself is the tick count, see clock_systime_timespec().
+ */
+
+#if !defined(CONFIG_CLOCK_TIMEKEEPING) && !defined(CONFIG_RTC_HIRES) && \
+    !defined(CONFIG_ALARM_ARCH) && !defined(CONFIG_TIMER_ARCH) && \
+    !defined(CONFIG_SCHED_TICKLESS)
+#  define CLOCK_VDSO_REALTIME 1
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct clock_vdso_s *g_clock_vdso;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_initialize
+ *
+ * Description:
+ *   Allocate the time page from the user heap so that every task can read
+ *   it.
+ *
+ ****************************************************************************/
+
+void clock_vdso_initialize(void)
+{
+  FAR struct clock_vdso_s *vdso;
+
+  vdso = kumm_zalloc(sizeof(struct clock_vdso_s));
+  if (vdso != NULL)
+    {
+      seqlock_init(&vdso->seq);
+#ifdef CLOCK_VDSO_REALTIME
+      vdso->realtime = true;
+#endif
+      g_clock_vdso = vdso;
+      clock_vdso_update(clock_get_sched_ticks());
+    }
+}
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Publish the tick count and the base time to the time page.
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(clock_t ticks)
+{
+  FAR struct clock_vdso_s *vdso = g_clock_vdso;
+  irqstate_t flags;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  flags = write_seqlock_irqsave(&vdso->seq);
+  vdso->ticks = ticks;
+#ifdef CLOCK_VDSO_REALTIME
+  spin_lock(&g_basetime_lock);
+  vdso->basetime = g_basetime;
+  spin_unlock(&g_basetime_lock);
+#endif
+  write_sequnlock_irqrestore(&vdso->seq, flags);
+}
+
+/****************************************************************************
+ * Name: nxclock_vdso
+ ****************************************************************************/
+
+FAR const struct clock_vdso_s *nxclock_vdso(void)
+{
+  return g_clock_vdso;
+}
@@ -43,7 +43,14 @@
  * Description:
  *   Post one or more events to the specified event object.  This function
  *   wakes up any tasks that are waiting for the posted events, depending
- *   on their wait condition (any/all).
+ *   on their wait condition (any/all).  Of the tasks waiting with
+ *   NXEVENT_WAIT_EXCL, only the first one is woken unless NXEVENT_POST_ALL
+ *   is given.
+ *
+ *   The waiters are only walked if the pending events intersect the union
+ *   of the events they expect, so posting events nobody waits for is
+ *   O(1).  The context switch, if any, is done once after all the
+ *   waiters were made ready.
  *
  * Input Parameters:
  *   event  - Pointer to the event object.
@@ -62,12 +69,15 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
   FAR struct tcb_s *wtcb;
   FAR struct tcb_s *rtcb;
   nxevent_mask_t clear = 0;
+  nxevent_mask_t waitmask = 0;
   FAR dq_entry_t *entry;
   FAR dq_entry_t *tmp;
   irqstate_t flags;
   dq_queue_t *waitlist;
   bool waitall;
   bool postall;
+  bool exclusive;
+  bool woken_excl = false;
   bool need_switch = false;
 
   if (event == NULL)
@@ -90,15 +100,28 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
   rtcb    = this_task();
   waitlist = EVENT_WAITLIST(event);
 
+  /* Nobody waits for the pending events */
+
+  if ((event->events & event->waitmask) == 0)
+    {
+      goto out;
+    }
+
   dq_for_every_safe(waitlist, entry, tmp)
     {
       wtcb = (FAR struct tcb_s *)entry;
       waitall = ((wtcb->eflags & NXEVENT_WAIT_ALL) != 0);
+      exclusive = ((wtcb->eflags & NXEVENT_WAIT_EXCL) != 0);
 
       /* Check if this task's wait condition is satisfied */
 
-      if ((!waitall && (wtcb->expect & event->events) != 0) ||
-          (waitall && ((wtcb->expect & event->events) == wtcb->expect)))
+      if (exclusive && woken_excl && !postall)
+        {
+          waitmask |= wtcb->expect;
+        }
+      else if ((!waitall && (wtcb->expect & event->events) != 0) ||
+               (waitall &&
+                ((wtcb->expect & event->events) == wtcb->expect)))
         {
           dq_rem((FAR dq_entry_t *)wtcb, waitlist);
 
@@ -128,13 +151,24 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
               clear |= wtcb->expect;
             }
 
+          woken_excl |= exclusive;
+
           if (!postall && (event->events & ~clear) == 0)
             {
+              /* The waiters left are not visited, keep their events */
+
+              waitmask = event->waitmask;
               break;
             }
         }
+      else
+        {
+          waitmask |= wtcb->expect;
+        }
     }
 
+  event->waitmask = waitmask;
+
   if (clear != 0)
     {
       event->events &= ~clear;
@@ -147,6 +181,7 @@ int nxevent_post(FAR nxevent_t *event, nxevent_mask_t events,
       up_switch_context(this_task(), rtcb);
     }
 
+out:
   leave_critical_section(flags);
 
   return OK;
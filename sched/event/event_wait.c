@@ -199,6 +199,7 @@ nxevent_mask_t nxevent_tickwait(FAR nxevent_t *event, nxevent_mask_t events,
 
       rtcb->task_state = TSTATE_WAIT_EVENT;
       nxsched_add_prioritized(rtcb, EVENT_WAITLIST(event));
+      event->waitmask |= events;
 
       /* Now, perform the context switch if one is needed */
 
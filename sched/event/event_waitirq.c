@@ -57,6 +57,10 @@ void nxevent_wait_irq(FAR struct tcb_s *wtcb, int errcode)
   /* Remove the task from the event waiting list */
 
   dq_rem((FAR dq_entry_t *)wtcb, EVENT_WAITLIST(event));
+  if (dq_empty(EVENT_WAITLIST(event)))
+    {
+      event->waitmask = 0;
+    }
 
   /* Indicate that the wait is over */
 
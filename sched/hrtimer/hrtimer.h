@@ -32,6 +32,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/hrtimer.h>
 #include <nuttx/seqlock.h>
+#include <nuttx/spinlock.h>
 
 #include "sched/sched.h"
 
@@ -45,8 +46,8 @@
 
 #define HRTIMER_CANCEL_SYNC_DELAY_US CONFIG_USEC_PER_TICK
 
-/* The pending state indicates the timer belongs to the shared hrtimer queue
- * and is waiting for the next hrtimer expiry.
+/* The pending state indicates the timer belongs to the queue of a hrtimer
+ * base and is waiting for the next hrtimer expiry.
  */
 
 #define hrtimer_is_pending(hrtimer)    ((hrtimer)->func != NULL)
@@ -58,6 +59,15 @@
 #define HRTIMER_TIME_BEFORE(t1, t2)    ((int64_t)((t2) - (t1)) > 0)
 #define HRTIMER_TIME_BEFORE_EQ(t1, t2) ((int64_t)((t2) - (t1)) >= 0)
 
+/* The base a timer was last armed on */
+
+#ifdef CONFIG_SMP
+#  define hrtimer_base_of(timer) \
+  (&g_hrtimer_base[*(FAR volatile uint8_t *)&(timer)->cpu])
+#else
+#  define hrtimer_base_of(timer) (&g_hrtimer_base[0])
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -72,45 +82,95 @@
 RB_HEAD(hrtimer_tree_s, hrtimer_s);
 #endif
 
-/****************************************************************************
- * Public Data
- ****************************************************************************/
+/* The hrtimer base of one CPU.  A timer is armed on the base of the CPU
+ * that starts it, and the callbacks of the base run on that CPU, so the
+ * CPUs do not contend on the queues.  The lock of a base is only taken by
+ * another CPU when a timer moves between bases.
+ */
 
-/* Seqcount protecting access to the hrtimer queue and timer state */
+struct hrtimer_base_s
+{
+  /* Seqcount protecting access to the queue and timer state */
 
-extern seqcount_t g_hrtimer_lock;
+  seqcount_t lock;
 
 #ifdef CONFIG_HRTIMER_TREE
-/* Red-Black tree containing all active high-resolution timers */
+  /* Red-Black tree containing the active timers of the base */
 
-extern struct hrtimer_tree_s g_hrtimer_tree;
-extern struct hrtimer_s      g_hrtimer_guard;
-extern struct FAR hrtimer_s *g_hrtimer_head;
+  struct hrtimer_tree_s tree;
+  FAR hrtimer_t        *head;
 #else
-/* List containing all active high-resolution timers */
+  /* List containing the active timers of the base */
+
+  struct list_node list;
+#endif
+
+  /* The guard expires last, so that the queue is never empty */
+
+  hrtimer_t guard;
+
+  /* The expiration of the head, protected by g_hrtimer_hwlock */
+
+  uint64_t next;
+
+#ifdef CONFIG_SMP
+  /* The currently running timer of the CPU */
+
+  uintptr_t running;
+
+  /* The CPU was asked to process its expired timers */
 
-extern struct list_node g_hrtimer_list;
+  bool kicked;
+  struct smp_call_data_s call;
 #endif
+};
 
-/* Array of pointers to currently running high-resolution timers
- * for each CPU in SMP configurations. Index corresponds to CPU ID.
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The hrtimer bases, index corresponds to CPU ID */
+
+extern struct hrtimer_base_s g_hrtimer_base[CONFIG_SMP_NCPUS];
+
+/* Spinlock serializing the programming of the hardware timer, which is
+ * shared by all the bases.
  */
 
 #ifdef CONFIG_SMP
-extern uintptr_t g_hrtimer_running[CONFIG_SMP_NCPUS];
+extern spinlock_t g_hrtimer_hwlock;
 #endif
 
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: hrtimer_initialize
+ *
+ * Description:
+ *   Initialize the hrtimer bases.  Called once from nx_start() before any
+ *   timer is started.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void hrtimer_initialize(void);
+
 /****************************************************************************
  * Name: hrtimer_process
  *
  * Description:
  *   Called from the timer interrupt handler to process expired
- *   high-resolution timers. If a timer has expired, its callback
- *   function will be executed in the context of the timer interrupt.
+ *   high-resolution timers of this CPU. If a timer has expired, its
+ *   callback function will be executed in the context of the timer
+ *   interrupt.  The other CPUs with expired timers are asked to process
+ *   them.
  *
  * Input Parameters:
  *   now - The current time (nsecs).
@@ -122,15 +182,54 @@ extern uintptr_t g_hrtimer_running[CONFIG_SMP_NCPUS];
 
 void hrtimer_process(uint64_t now);
 
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Record the new head of a base and program the hardware timer to the
+ *   earliest expiration of all bases.
+ *
+ * Input Parameters:
+ *   base - The base whose head changed.
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumption:
+ *   The caller must hold the lock of the base.
+ *
+ ****************************************************************************/
+
+void hrtimer_reprogram(FAR struct hrtimer_base_s *base);
+
+/****************************************************************************
+ * Name: hrtimer_lock_base
+ *
+ * Description:
+ *   Lock the base a timer belongs to.  The timer may move to another base
+ *   until the lock is held, in which case the new base is locked instead.
+ *
+ * Input Parameters:
+ *   timer - The timer.
+ *   flags - Location to return the interrupt state.
+ *
+ * Returned Value:
+ *   The locked base.
+ *
+ ****************************************************************************/
+
+FAR struct hrtimer_base_s *hrtimer_lock_base(FAR hrtimer_t *timer,
+                                             FAR irqstate_t *flags);
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: hrtimer_reprogram
+ * Name: hrtimer_program
  *
  * Description:
- *   Reprogram the hardware timer to expire at a specified nanosecond time.
+ *   Program the hardware timer to expire at a specified nanosecond time.
  *   Converts the nanosecond time to timespec and calls the platform-specific
  *   timer start function.
  *
@@ -145,7 +244,7 @@ void hrtimer_process(uint64_t now);
  *
  ****************************************************************************/
 
-static inline_function void hrtimer_reprogram(uint64_t next_expired)
+static inline_function void hrtimer_program(uint64_t next_expired)
 {
   /* `hrtimer_reprogram` relies on the underlying timer being a non-periodic
    * timer. If the underlying timer hardware is a periodic timer like
@@ -222,31 +321,32 @@ RB_PROTOTYPE(hrtimer_tree_s, hrtimer_s, node, hrtimer_compare);
  * Name: hrtimer_remove
  *
  * Description:
- *   Remove a timer from the queue and mark it as dequeued.
+ *   Remove a timer from the queue of a base and mark it as dequeued.
  *
  * Returned Value:
  *   true if the timer is the head of the queue, otherwise false.
  *
  * Assumption:
- *   The caller must hold the queue lock.
+ *   The caller must hold the lock of the base.
  *   The caller must ensure that the timer is in the queue.
  *
  ****************************************************************************/
 
-static inline_function bool hrtimer_remove(FAR hrtimer_t *hrtimer)
+static inline_function bool hrtimer_remove(FAR struct hrtimer_base_s *base,
+                                           FAR hrtimer_t *hrtimer)
 {
   bool is_head;
 #ifdef CONFIG_HRTIMER_TREE
-  is_head = g_hrtimer_head == hrtimer;
+  is_head = base->head == hrtimer;
 
-  RB_REMOVE(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
+  RB_REMOVE(hrtimer_tree_s, &base->tree, hrtimer);
 
   if (is_head)
     {
-      g_hrtimer_head = RB_MIN(hrtimer_tree_s, &g_hrtimer_tree);
+      base->head = RB_MIN(hrtimer_tree_s, &base->tree);
     }
 #else
-  is_head = list_is_head(&g_hrtimer_list, &hrtimer->node);
+  is_head = list_is_head(&base->list, &hrtimer->node);
   list_delete_fast(&hrtimer->node);
 #endif
 
@@ -261,27 +361,29 @@ static inline_function bool hrtimer_remove(FAR hrtimer_t *hrtimer)
  * Name: hrtimer_insert
  *
  * Description:
- *   Insert a timer into the hrtimer queue according to its expiration time.
+ *   Insert a timer into the queue of a base according to its expiration
+ *   time.
  *
  * Returned Value:
  *   true if the timer is added to the head of the queue, otherwise false.
  *
  * Assumption:
- *   The caller must hold the queue lock.
- *   The caller must ensure that the timer is in the queue.
+ *   The caller must hold the lock of the base.
+ *   The caller must ensure that the timer is not in any queue.
  *
  ****************************************************************************/
 
-static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
+static inline_function bool hrtimer_insert(FAR struct hrtimer_base_s *base,
+                                           FAR hrtimer_t *hrtimer)
 {
 #ifdef CONFIG_HRTIMER_TREE
   bool is_head = false;
-  RB_INSERT(hrtimer_tree_s, &g_hrtimer_tree, hrtimer);
+  RB_INSERT(hrtimer_tree_s, &base->tree, hrtimer);
 
-  if (HRTIMER_TIME_BEFORE(hrtimer->expired, g_hrtimer_head->expired))
+  if (HRTIMER_TIME_BEFORE(hrtimer->expired, base->head->expired))
     {
-      g_hrtimer_head = hrtimer;
-      is_head        = true;
+      base->head = hrtimer;
+      is_head    = true;
     }
 
   return is_head;
@@ -289,7 +391,7 @@ static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
   FAR hrtimer_t *curr;
   uint64_t expired = hrtimer->expired;
 
-  list_for_every_entry(&g_hrtimer_list, curr, hrtimer_t, node)
+  list_for_every_entry(&base->list, curr, hrtimer_t, node)
     {
       /* Until curr->expired has not timed out relative to expired */
 
@@ -300,7 +402,7 @@ static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
     }
 
   list_add_before(&curr->node, &hrtimer->node);
-  return list_is_head(&g_hrtimer_list, &hrtimer->node);
+  return list_is_head(&base->list, &hrtimer->node);
 #endif
 }
 
@@ -308,19 +410,20 @@ static inline_function bool hrtimer_insert(FAR hrtimer_t *hrtimer)
  * Name: hrtimer_get_first
  *
  * Description:
- *   Return the earliest expiring pending timer.
+ *   Return the earliest expiring pending timer of a base.
  *
  * Returned Value:
- *   Pointer to the earliest timer, or NULL if none are pending.
+ *   Pointer to the earliest timer, the guard if none are pending.
  *
  ****************************************************************************/
 
-static inline_function FAR hrtimer_t *hrtimer_get_first(void)
+static inline_function
+FAR hrtimer_t *hrtimer_get_first(FAR struct hrtimer_base_s *base)
 {
 #ifdef CONFIG_HRTIMER_TREE
-  return g_hrtimer_head;
+  return base->head;
 #else
-  return list_first_entry(&g_hrtimer_list, FAR hrtimer_t, node);
+  return list_first_entry(&base->list, FAR hrtimer_t, node);
 #endif
 }
 
@@ -333,7 +436,8 @@ static inline_function FAR hrtimer_t *hrtimer_get_first(void)
  *   of the value you are reading.
  *
  * Input Parameters:
- *   ptr - The pointer to be read.
+ *   lock - The lock of the base the value belongs to.
+ *   ptr  - The pointer to be read.
  *
  * Returned Value:
  *   The value in the queue.
@@ -342,20 +446,20 @@ static inline_function FAR hrtimer_t *hrtimer_get_first(void)
 
 #ifdef CONFIG_ARCH_64BIT
 /* On 64-bit architectures, read/write uint64_t is atomic. */
-#  define hrtimer_read_64(ptr) (*(FAR volatile uint64_t *)(ptr))
+#  define hrtimer_read_64(lock, ptr) (*(FAR volatile uint64_t *)(ptr))
 #else
 static inline_function
-uint64_t hrtimer_read_64(FAR const uint64_t *ptr)
+uint64_t hrtimer_read_64(FAR const seqcount_t *lock, FAR const uint64_t *ptr)
 {
   uint64_t val;
   uint32_t seq;
 
   do
     {
-      seq = read_seqbegin(&g_hrtimer_lock);
+      seq = read_seqbegin(lock);
       val = *ptr;
     }
-  while (read_seqretry(&g_hrtimer_lock, seq));
+  while (read_seqretry(lock, seq));
 
   return val;
 }
@@ -363,20 +467,20 @@ uint64_t hrtimer_read_64(FAR const uint64_t *ptr)
 
 #if UINT_MAX >= UINT32_MAX
 /* On 32/64-bit architectures, read/write uint32_t is atomic. */
-#  define hrtimer_read_32(ptr) (*(FAR volatile uint32_t *)(ptr))
+#  define hrtimer_read_32(lock, ptr) (*(FAR volatile uint32_t *)(ptr))
 #else
 static inline_function
-uint32_t hrtimer_read_32(FAR const uint32_t *ptr)
+uint32_t hrtimer_read_32(FAR const seqcount_t *lock, FAR const uint32_t *ptr)
 {
   uint32_t val;
   uint32_t seq;
 
   do
     {
-      seq = read_seqbegin(&g_hrtimer_lock);
+      seq = read_seqbegin(lock);
       val = *ptr;
     }
-  while (read_seqretry(&g_hrtimer_lock, seq));
+  while (read_seqretry(lock, seq));
 
   return val;
 }
@@ -384,11 +488,11 @@ uint32_t hrtimer_read_32(FAR const uint32_t *ptr)
 
 /* Generic function to read the value in the queue atomically. */
 
-#define hrtimer_read(ptr) \
+#define hrtimer_read(lock, ptr) \
   (sizeof(*(ptr)) == 8u ? \
-   hrtimer_read_64((FAR const uint64_t *)(ptr)) : \
+   hrtimer_read_64(lock, (FAR const uint64_t *)(ptr)) : \
    (sizeof(*(ptr)) == 4u ? \
-    hrtimer_read_32((FAR const uint32_t *)(ptr)) : 0u))
+    hrtimer_read_32(lock, (FAR const uint32_t *)(ptr)) : 0u))
 
 /****************************************************************************
  * Name: hrtimer_mark_running
@@ -404,13 +508,13 @@ uint32_t hrtimer_read_32(FAR const uint32_t *ptr)
  *   None.
  *
  * Assumption:
- *   The caller must hold the lock.
+ *   The caller must hold the lock of the base of the CPU.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_SMP
 #  define hrtimer_mark_running(timer, cpu) \
-  (g_hrtimer_running[cpu] = (uintptr_t)(timer))
+  (g_hrtimer_base[cpu].running = (uintptr_t)(timer))
 #else
 #  define hrtimer_mark_running(timer, cpu) UNUSED(cpu)
 #endif
@@ -433,7 +537,8 @@ uint32_t hrtimer_read_32(FAR const uint32_t *ptr)
 
 #ifdef CONFIG_SMP
 #  define hrtimer_is_running(timer, cpu) \
-  (hrtimer_read(&g_hrtimer_running[cpu]) == (uintptr_t)(timer))
+  (hrtimer_read(&g_hrtimer_base[cpu].lock, \
+                &g_hrtimer_base[cpu].running) == (uintptr_t)(timer))
 #else
 #  define hrtimer_is_running(timer, cpu) (true)
 #endif
@@ -448,24 +553,40 @@ uint32_t hrtimer_read_32(FAR const uint32_t *ptr)
  *   return the references count to the timer.
  *
  * Input Parameters:
+ *   base    - The base of the timer.
  *   hrtimer - The cancelled timer.
  *
  * Returned Value:
  *   The references count to the timer.
  *
  * Assumption:
- *   The caller must hold the queue lock.
+ *   The caller must hold the lock of the base.
  *
  ****************************************************************************/
 
 static inline_function
-int hrtimer_cancel_running(FAR hrtimer_t *timer)
+int hrtimer_cancel_running(FAR struct hrtimer_base_s *base,
+                           FAR hrtimer_t *timer)
 {
   int refs            = 0;
 #ifdef CONFIG_SMP
   uintptr_t cancelled = (uintptr_t)timer | 0x1u;
   int cpu;
 
+  /* A callback of the timer can only be running without the cancelled
+   * mark on the base the timer belongs to, since the callbacks running on
+   * the other bases were revoked when the timer moved away from them.
+   */
+
+  if (base->running == (uintptr_t)timer)
+    {
+      /* Set the timer to the cancelled state and revoke the write
+       * ownership of the timer from the queue.
+       */
+
+      base->running = cancelled;
+    }
+
   /* Check if the timer is referenced by any CPU core.
    * Generally, only one reference to a timer can exist at the same time.
    * However, when a timer may be restarted at the cancelled state,
@@ -476,19 +597,8 @@ int hrtimer_cancel_running(FAR hrtimer_t *timer)
 
   for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
     {
-      /* This is a faster implementation equivalent to
-       * (g_hrtimer_running[cpu] & (~(uintptr_t)0x1u)) == timer,
-       * Assuming the pointer of the timer is at least 2-bytes aligned
-       * (the last bit must be zero).
-       */
-
-      if ((g_hrtimer_running[cpu] ^ cancelled) <= 0x1u)
+      if (hrtimer_is_cancelling(timer, cpu))
         {
-          /* Set the timer to the cancelled state and revoke the write
-           * ownership of the timer from the queue.
-           */
-
-          g_hrtimer_running[cpu] = cancelled;
           refs++;
         }
     }
@@ -74,7 +74,7 @@
 
 int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 {
-  FAR hrtimer_t *first;
+  FAR struct hrtimer_base_s *base;
   irqstate_t flags;
   int ret;
 
@@ -82,26 +82,25 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 
   /* Acquire the lock and seize the ownership of the hrtimer queue. */
 
-  flags = write_seqlock_irqsave(&g_hrtimer_lock);
+  base = hrtimer_lock_base(hrtimer, &flags);
 
   /* Ensure no core can write the hrtimer. */
 
-  ret = hrtimer_cancel_running(hrtimer);
+  ret = hrtimer_cancel_running(base, hrtimer);
 
   if (hrtimer_is_pending(hrtimer))
     {
       /* Update the hardware timer if the queue head changed. */
 
-      if (hrtimer_remove(hrtimer))
+      if (hrtimer_remove(base, hrtimer))
         {
-          first = hrtimer_get_first();
-          hrtimer_reprogram(first->expired);
+          hrtimer_reprogram(base);
         }
     }
 
   /* Release the lock and give up the ownership of the hrtimer queue. */
 
-  write_sequnlock_irqrestore(&g_hrtimer_lock, flags);
+  write_sequnlock_irqrestore(&base->lock, flags);
   return ret;
 }
 
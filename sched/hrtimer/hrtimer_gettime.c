@@ -51,7 +51,8 @@
 
 uint64_t hrtimer_gettime(FAR hrtimer_t *timer)
 {
-  uint64_t expire = hrtimer_read_64(&timer->expired);
+  uint64_t expire = hrtimer_read_64(&hrtimer_base_of(timer)->lock,
+                                    &timer->expired);
   int64_t  remain = expire - clock_systime_nsec();
 
   return remain < 0 ? 0u : remain;
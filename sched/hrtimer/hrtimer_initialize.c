@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/clock.h>
 
 #include "hrtimer/hrtimer.h"
 
@@ -32,60 +33,163 @@
  * Public Data
  ****************************************************************************/
 
-/* Array of pointers to currently running high-resolution timers
- * for each CPU in SMP configurations. Index corresponds to CPU ID.
+/* The hrtimer bases of the CPUs.
+ *
+ * When CONFIG_HRTIMER_TREE is enabled, timers are stored in a tree.
+ * When disabled, timers are stored in a linked list.
+ *
+ * The queues are ordered by absolute expiration time in
+ * both configurations.
+ */
+
+struct hrtimer_base_s g_hrtimer_base[CONFIG_SMP_NCPUS];
+
+/* Spinlock serializing the programming of the hardware timer.
+ *
+ * It is only taken when the head of a base changes, arming a timer
+ * behind the head only needs the lock of the base.
  */
 
 #ifdef CONFIG_SMP
-uintptr_t g_hrtimer_running[CONFIG_SMP_NCPUS];
+spinlock_t g_hrtimer_hwlock = SP_UNLOCKED;
 #endif
 
-/* Global spinlock protecting the high-resolution timer subsystem.
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_kicked
  *
- * This spinlock serializes access to the hrtimer queue and
- * protects timer state transitions. It must be held whenever the
- * timer queue is modified.
- */
+ * Description:
+ *   Process the expired timers of this CPU on the request of the CPU that
+ *   received the timer interrupt.
+ *
+ ****************************************************************************/
 
-seqcount_t g_hrtimer_lock = SEQLOCK_INITIALIZER;
+#ifdef CONFIG_SMP
+static int hrtimer_kicked(FAR void *arg)
+{
+  FAR struct hrtimer_base_s *base = arg;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_hrtimer_hwlock);
+  base->kicked = false;
+  spin_unlock_irqrestore(&g_hrtimer_hwlock, flags);
+
+  hrtimer_process(clock_systime_nsec());
+  return OK;
+}
+#endif
 
-/* HRTimer queue for all active high-resolution timers.
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_initialize
  *
- * When CONFIG_HRTIMER_TREE is enabled, timers are stored in a queue.
- * When disabled, timers are stored in a linked list.
+ * Description:
+ *   Initialize the hrtimer bases.  Called once from nx_start() before any
+ *   timer is started.
  *
- * The queue is ordered by absolute expiration time in
- * both configurations.
- */
+ ****************************************************************************/
 
-struct hrtimer_s g_hrtimer_guard =
+void hrtimer_initialize(void)
 {
+  FAR struct hrtimer_base_s *base;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      base = &g_hrtimer_base[cpu];
+
+      seqlock_init(&base->lock);
+      base->guard.expired = INT64_MAX;
+      base->next          = INT64_MAX;
+
 #ifdef CONFIG_HRTIMER_TREE
-  { NULL },
+      RB_INIT(&base->tree);
+      RB_INSERT(hrtimer_tree_s, &base->tree, &base->guard);
+      base->head = &base->guard;
 #else
-  { &g_hrtimer_list, &g_hrtimer_list },
+      list_initialize(&base->list);
+      list_add_tail(&base->list, &base->guard.node);
 #endif
-  NULL,
-  INT64_MAX
-};
 
-#ifdef CONFIG_HRTIMER_TREE
-struct hrtimer_tree_s g_hrtimer_tree =
-{
-  &g_hrtimer_guard
-};
-struct FAR hrtimer_s *g_hrtimer_head = &g_hrtimer_guard;
-#else
-struct list_node g_hrtimer_list =
-{
-  &g_hrtimer_guard.node, &g_hrtimer_guard.node
-};
+#ifdef CONFIG_SMP
+      base->guard.cpu = cpu;
+      nxsched_smp_call_init(&base->call, hrtimer_kicked, base);
 #endif
+    }
+}
 
 /****************************************************************************
- * Public Functions
+ * Name: hrtimer_lock_base
+ *
+ * Description:
+ *   Lock the base a timer belongs to.  The timer may move to another base
+ *   until the lock is held, in which case the new base is locked instead.
+ *
  ****************************************************************************/
 
+FAR struct hrtimer_base_s *hrtimer_lock_base(FAR hrtimer_t *timer,
+                                             FAR irqstate_t *flags)
+{
+  FAR struct hrtimer_base_s *base;
+
+  for (; ; )
+    {
+      base   = hrtimer_base_of(timer);
+      *flags = write_seqlock_irqsave(&base->lock);
+
+      if (base == hrtimer_base_of(timer))
+        {
+          return base;
+        }
+
+      write_sequnlock_irqrestore(&base->lock, *flags);
+    }
+}
+
+/****************************************************************************
+ * Name: hrtimer_reprogram
+ *
+ * Description:
+ *   Record the new head of a base and program the hardware timer to the
+ *   earliest expiration of all bases.  The bases whose CPU was asked to
+ *   process its expired timers are skipped, that CPU reprograms the timer
+ *   when it is done.
+ *
+ ****************************************************************************/
+
+void hrtimer_reprogram(FAR struct hrtimer_base_s *base)
+{
+  uint64_t next = hrtimer_get_first(base)->expired;
+#ifdef CONFIG_SMP
+  FAR struct hrtimer_base_s *other;
+  int cpu;
+
+  spin_lock(&g_hrtimer_hwlock);
+
+  base->next = next;
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      other = &g_hrtimer_base[cpu];
+      if (!other->kicked && HRTIMER_TIME_BEFORE(other->next, next))
+        {
+          next = other->next;
+        }
+    }
+
+  hrtimer_program(next);
+  spin_unlock(&g_hrtimer_hwlock);
+#else
+  base->next = next;
+  hrtimer_program(next);
+#endif
+}
+
 /****************************************************************************
  * Name: RB_GENERATE
  *
@@ -102,8 +206,8 @@ struct list_node g_hrtimer_list =
  * Assumptions/Notes:
  *   - The tree key is the absolute expiration time stored in
  *     hrtimer_node_s and compared via hrtimer_compare().
- *   - All accesses to the tree must be serialized using
- *     g_hrtimer_lock.
+ *   - All accesses to a tree must be serialized using
+ *     the lock of its base.
  *   - These generated functions are used internally by the hrtimer
  *     core (e.g., hrtimer_start(), hrtimer_cancel(), and expire paths).
  ****************************************************************************/
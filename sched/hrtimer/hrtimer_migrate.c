@@ -0,0 +1,113 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_migrate.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <assert.h>
+
+#include "hrtimer/hrtimer.h"
+
+#ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_migrate
+ *
+ * Description:
+ *   Move the pending timers of a CPU that goes offline to the base of the
+ *   calling CPU.  The timers keep their expiration, their callbacks run on
+ *   the calling CPU from now on.
+ *
+ * Input Parameters:
+ *   cpu - The CPU that goes offline.
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumption:
+ *   The CPU that goes offline does not run timer callbacks anymore.
+ *
+ ****************************************************************************/
+
+void hrtimer_migrate(int cpu)
+{
+  FAR struct hrtimer_base_s *src;
+  FAR struct hrtimer_base_s *dst;
+  FAR struct hrtimer_base_s *first;
+  FAR struct hrtimer_base_s *second;
+  FAR hrtimer_t *timer;
+  hrtimer_entry_t func;
+  irqstate_t flags;
+  irqstate_t flags1;
+  irqstate_t flags2;
+  bool reprogram = false;
+  int self;
+
+  flags = up_irq_save();
+  self  = this_cpu();
+
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS && cpu != self);
+
+  src = &g_hrtimer_base[cpu];
+  dst = &g_hrtimer_base[self];
+
+  /* Hold both locks while the timers move, so that they are not seen in
+   * between by a cancel.  The other paths hold one lock at a time, the
+   * order of the CPU IDs prevents a deadlock of two migrations.
+   */
+
+  first  = cpu < self ? src : dst;
+  second = cpu < self ? dst : src;
+
+  flags1 = write_seqlock_irqsave(&first->lock);
+  flags2 = write_seqlock_irqsave(&second->lock);
+
+  while ((timer = hrtimer_get_first(src)) != &src->guard)
+    {
+      func = timer->func;
+      hrtimer_remove(src, timer);
+
+      timer->func = func;
+      timer->cpu  = self;
+      reprogram  |= hrtimer_insert(dst, timer);
+    }
+
+  hrtimer_reprogram(src);
+  if (reprogram)
+    {
+      hrtimer_reprogram(dst);
+    }
+
+  write_sequnlock_irqrestore(&second->lock, flags2);
+  write_sequnlock_irqrestore(&first->lock, flags1);
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SMP */
@@ -31,6 +31,45 @@
 
 #include "hrtimer/hrtimer.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_kick
+ *
+ * Description:
+ *   Ask the other CPUs whose timers have expired to process them, so that
+ *   the callbacks run on the CPU that armed the timers.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static void hrtimer_kick(uint64_t now, int self)
+{
+  FAR struct hrtimer_base_s *base;
+  irqstate_t flags;
+  int cpu;
+
+  flags = spin_lock_irqsave(&g_hrtimer_hwlock);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      base = &g_hrtimer_base[cpu];
+      if (cpu != self && !base->kicked &&
+          HRTIMER_TIME_BEFORE_EQ(base->next, now))
+        {
+          base->kicked = true;
+          nxsched_smp_call_single_async(cpu, &base->call);
+        }
+    }
+
+  spin_unlock_irqrestore(&g_hrtimer_hwlock, flags);
+}
+#else
+#  define hrtimer_kick(now, self)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -39,11 +78,11 @@
  * Name: hrtimer_process
  *
  * Description:
- *   Process all expired high-resolution timers. This function repeatedly
- *   retrieves the earliest timer from the active timer queue, checks
- *   if it has expired relative to the current time, removes it from the
- *   queue, and invokes its callback function. Processing continues
- *   until:
+ *   Process all expired high-resolution timers of this CPU. This function
+ *   repeatedly retrieves the earliest timer from the queue of the base of
+ *   this CPU, checks if it has expired relative to the current time,
+ *   removes it from the queue, and invokes its callback function.
+ *   Processing continues until:
  *
  *     1. No additional timers have expired, or
  *     2. The active timer set is empty.
@@ -51,10 +90,13 @@
  *   After all expired timers are processed, the next expiration event is
  *   scheduled based on:
  *
- *     - The earliest remaining timer, or
+ *     - The earliest remaining timer of all bases, or
  *     - A fallback expiration (current time + HRTIMER_DEFAULT_INCREMENT)
  *       if no timers remain.
  *
+ *   The expired timers of the other CPUs are processed by those CPUs in
+ *   an SMP call.
+ *
  * Input Parameters:
  *   now - Current high-resolution timestamp.
  *
@@ -62,7 +104,7 @@
  *   None.
  *
  * Assumptions/Notes:
- *   - This function acquires a spinlock to protect the timer queue.
+ *   - This function acquires the lock of the base of this CPU.
  *   - Timer callbacks are invoked with interrupts enabled
  *     to avoid deadlocks.
  *   - DEBUGASSERT ensures that timer callbacks are valid.
@@ -70,6 +112,7 @@
 
 void hrtimer_process(uint64_t now)
 {
+  FAR struct hrtimer_base_s *base;
   FAR hrtimer_t *hrtimer;
   irqstate_t flags;
   hrtimer_entry_t func;
@@ -77,15 +120,17 @@ void hrtimer_process(uint64_t now)
   uint64_t delay;
   int cpu = this_cpu();
 
+  base = &g_hrtimer_base[cpu];
+
   /* Acquire the lock and seize the ownership of the hrtimer queue. */
 
-  flags = write_seqlock_irqsave(&g_hrtimer_lock);
+  flags = write_seqlock_irqsave(&base->lock);
 
   for (; ; )
     {
       /* Fetch the earliest active timer */
 
-      hrtimer = hrtimer_get_first();
+      hrtimer = hrtimer_get_first(base);
       expired = hrtimer->expired;
 
       /* Check if the timer has expired */
@@ -98,13 +143,13 @@ void hrtimer_process(uint64_t now)
       /* Remove the expired timer from the timer queue */
 
       func = hrtimer->func;
-      hrtimer_remove(hrtimer);
+      hrtimer_remove(base, hrtimer);
 
       hrtimer_mark_running(hrtimer, cpu);
 
       /* Leave critical section before invoking the callback */
 
-      write_sequnlock_irqrestore(&g_hrtimer_lock, flags);
+      write_sequnlock_irqrestore(&base->lock, flags);
 
       /* Invoke the timer callback */
 
@@ -117,7 +162,7 @@ void hrtimer_process(uint64_t now)
 
       /* Re-enter critical section to update timer state */
 
-      flags = write_seqlock_irqsave(&g_hrtimer_lock);
+      flags = write_seqlock_irqsave(&base->lock);
 
       /* If the timer is periodic and has not been rearmed or
        * cancelled concurrently, calculate next expiration and
@@ -128,22 +173,21 @@ void hrtimer_process(uint64_t now)
         {
           hrtimer->expired = expired + delay;
           hrtimer->func    = func;
-          hrtimer_insert(hrtimer);
+          hrtimer_insert(base, hrtimer);
         }
     }
 
   hrtimer_unmark_running(cpu);
 
-  /* Schedule the next timer expiration */
+  /* Hand the expired timers of the other bases to their CPUs */
 
-  if (expired != now)
-    {
-      /* Start timer for the next earliest expiration */
+  hrtimer_kick(now, cpu);
 
-      hrtimer_reprogram(expired);
-    }
+  /* Start timer for the next earliest expiration */
+
+  hrtimer_reprogram(base);
 
   /* Release the lock and give up the ownership of the hrtimer queue. */
 
-  write_sequnlock_irqrestore(&g_hrtimer_lock, flags);
+  write_sequnlock_irqrestore(&base->lock, flags);
 }
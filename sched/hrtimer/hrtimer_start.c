@@ -40,7 +40,8 @@
  *
  * Description:
  *   Start a high-resolution timer to expire after a specified duration
- *   in nanoseconds.
+ *   in nanoseconds.  The timer is armed on the base of the calling CPU,
+ *   and moves there if it was armed on another CPU before.
  *
  * Input Parameters:
  *   hrtimer - Pointer to the hrtimer.
@@ -58,23 +59,69 @@
 int hrtimer_start_absolute(FAR hrtimer_t *hrtimer, hrtimer_entry_t func,
                            uint64_t expired)
 {
+  FAR struct hrtimer_base_s *base;
   irqstate_t flags;
-  bool       reprogram = false;
+  bool       reprogram;
   int        ret       = OK;
+#ifdef CONFIG_SMP
+  int        cpu;
+#endif
 
   DEBUGASSERT(hrtimer != NULL && func != NULL);
 
-  /* Acquire the lock and seize the ownership of the hrtimer queue. */
+  for (; ; )
+    {
+      /* Acquire the lock and seize the ownership of the hrtimer queue. */
 
-  flags = write_seqlock_irqsave(&g_hrtimer_lock);
+      base      = hrtimer_lock_base(hrtimer, &flags);
+      reprogram = false;
 
-  /* Ensure no running core can write the hrtimer. */
+      /* Ensure no running core can write the hrtimer. */
 
-  hrtimer_cancel_running(hrtimer);
+      hrtimer_cancel_running(base, hrtimer);
 
-  if (hrtimer_is_pending(hrtimer))
-    {
-      reprogram = hrtimer_remove(hrtimer);
+      if (hrtimer_is_pending(hrtimer))
+        {
+          reprogram = hrtimer_remove(base, hrtimer);
+        }
+
+#ifdef CONFIG_SMP
+      /* Interrupts are disabled while a lock is held, so the CPU can only
+       * change between the two locks below, the loop starts over then.
+       */
+
+      cpu = this_cpu();
+      if (base != &g_hrtimer_base[cpu])
+        {
+          /* Move the timer to this CPU.  The old base is reprogrammed
+           * before its lock is released, and the new base is only locked
+           * afterwards, so that the lock of one base is held at a time.
+           */
+
+          hrtimer->cpu = cpu;
+          if (reprogram)
+            {
+              hrtimer_reprogram(base);
+            }
+
+          write_sequnlock_irqrestore(&base->lock, flags);
+
+          /* The timer may have been moved again before the lock is held,
+           * start over then.
+           */
+
+          base = hrtimer_lock_base(hrtimer, &flags);
+          if (base != &g_hrtimer_base[cpu] || hrtimer_is_pending(hrtimer))
+            {
+              write_sequnlock_irqrestore(&base->lock, flags);
+              continue;
+            }
+
+          reprogram = false;
+        }
+#endif
+
+      break;
     }
 
   hrtimer->func    = func;
@@ -82,18 +129,18 @@ int hrtimer_start_absolute(FAR hrtimer_t *hrtimer, hrtimer_entry_t func,
 
   /* Insert the timer into the hrtimer queue. */
 
-  reprogram |= hrtimer_insert(hrtimer);
+  reprogram |= hrtimer_insert(base, hrtimer);
 
   /* If the inserted timer is now the earliest, start hardware timer */
 
   if (reprogram)
     {
-      hrtimer_reprogram(hrtimer->expired);
+      hrtimer_reprogram(base);
     }
 
   /* Release the lock and give up the ownership of the hrtimer queue. */
 
-  write_sequnlock_irqrestore(&g_hrtimer_lock, flags);
+  write_sequnlock_irqrestore(&base->lock, flags);
 
   return ret;
 }
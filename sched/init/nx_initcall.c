@@ -0,0 +1,334 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <syslog.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/trace.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+struct initcall_time_s
+{
+  clock_t start;               /* Start time relative to the run */
+  clock_t elapsed;             /* Duration of the init-call */
+  int     result;              /* Value returned by the init-call */
+};
+#endif
+
+struct initcall_ctx_s
+{
+  FAR const struct initcall_s *calls;
+  size_t  ncalls;
+  size_t  next;                /* Next entry to examine in this level */
+  int     level;               /* The level being run */
+  int     result;              /* First error returned by an init-call */
+  mutex_t lock;                /* Protects next and result */
+  sem_t   done;                /* Posted by each exiting helper thread */
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+  FAR struct initcall_time_s *times;
+  clock_t base;                /* Start time of the run */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* nx_initcall_run() is only used during bring-up and is not reentrant, so
+ * the state shared with the helper threads can be static.
+ */
+
+static struct initcall_ctx_s g_initcall =
+{
+  .lock = NXMUTEX_INITIALIZER,
+  .done = SEM_INITIALIZER(0),
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_worker
+ *
+ * Description:
+ *   Run the not yet started init-calls of the current level until none is
+ *   left.  This is done by the caller of nx_initcall_run() and by all of
+ *   the helper threads.
+ *
+ ****************************************************************************/
+
+static void initcall_worker(FAR struct initcall_ctx_s *ctx)
+{
+  FAR const struct initcall_s *call;
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+  clock_t start;
+#endif
+  size_t index;
+  int ret;
+
+  for (; ; )
+    {
+      nxmutex_lock(&ctx->lock);
+      while (ctx->next < ctx->ncalls &&
+             ctx->calls[ctx->next].level != ctx->level)
+        {
+          ctx->next++;
+        }
+
+      index = ctx->next++;
+      nxmutex_unlock(&ctx->lock);
+
+      if (index >= ctx->ncalls)
+        {
+          break;
+        }
+
+      call = &ctx->calls[index];
+
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+      start = perf_gettime();
+#endif
+      sched_trace_beginex(call->name);
+      ret = call->func();
+      sched_trace_endex(call->name);
+
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+      if (ctx->times != NULL)
+        {
+          ctx->times[index].start   = start - ctx->base;
+          ctx->times[index].elapsed = perf_gettime() - start;
+          ctx->times[index].result  = ret;
+        }
+#endif
+
+      if (ret < 0)
+        {
+          serr("ERROR: %s failed: %d\n", call->name, ret);
+
+          nxmutex_lock(&ctx->lock);
+          if (ctx->result == OK)
+            {
+              ctx->result = ret;
+            }
+
+          nxmutex_unlock(&ctx->lock);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: initcall_thread
+ *
+ * Description:
+ *   Entry point of the helper threads.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BOARD_INITCALL_NTHREADS > 1
+static int initcall_thread(int argc, FAR char **argv)
+{
+  initcall_worker(&g_initcall);
+  nxsem_post(&g_initcall.done);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: initcall_dump
+ *
+ * Description:
+ *   Print the timeline of the completed run to the syslog.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+static void initcall_dump(FAR struct initcall_ctx_s *ctx)
+{
+  struct timespec start;
+  struct timespec elapsed;
+  size_t i;
+
+  if (ctx->times == NULL)
+    {
+      return;
+    }
+
+  syslog(LOG_INFO, "%-24s %5s %10s %10s %6s\n",
+         "INITCALL", "LEVEL", "START(us)", "TIME(us)", "RESULT");
+
+  for (i = 0; i < ctx->ncalls; i++)
+    {
+      perf_convert(ctx->times[i].start, &start);
+      perf_convert(ctx->times[i].elapsed, &elapsed);
+
+      syslog(LOG_INFO, "%-24s %5u %10lu %10lu %6d\n",
+             ctx->calls[i].name, ctx->calls[i].level,
+             (unsigned long)(start.tv_sec * USEC_PER_SEC +
+                             start.tv_nsec / NSEC_PER_USEC),
+             (unsigned long)(elapsed.tv_sec * USEC_PER_SEC +
+                             elapsed.tv_nsec / NSEC_PER_USEC),
+             ctx->times[i].result);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_initcall_run
+ *
+ * Description:
+ *   Run a table of init-calls level by level.  All init-calls of a level
+ *   are started, on up to CONFIG_BOARD_INITCALL_NTHREADS threads, before
+ *   the next level begins, and the next level begins only after all of
+ *   them returned.  A failing init-call does not stop the others.
+ *
+ *   This is intended to be called from board_late_initialize(), which
+ *   runs on a kernel thread where waiting is allowed.
+ *
+ * Input Parameters:
+ *   calls  - The init-call table, in any order
+ *   ncalls - The number of entries in the table
+ *
+ * Returned Value:
+ *   OK if all init-calls succeeded, otherwise the first negated errno
+ *   value returned by an init-call.
+ *
+ ****************************************************************************/
+
+int nx_initcall_run(FAR const struct initcall_s *calls, size_t ncalls)
+{
+  FAR struct initcall_ctx_s *ctx = &g_initcall;
+  int level;
+  int next;
+  size_t i;
+
+  DEBUGASSERT(calls != NULL || ncalls == 0);
+
+  ctx->calls  = calls;
+  ctx->ncalls = ncalls;
+  ctx->result = OK;
+
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+  ctx->times  = kmm_zalloc(ncalls * sizeof(struct initcall_time_s));
+  ctx->base   = perf_gettime();
+#endif
+
+  /* Find the lowest level */
+
+  level = -1;
+  for (i = 0; i < ncalls; i++)
+    {
+      if (level < 0 || calls[i].level < level)
+        {
+          level = calls[i].level;
+        }
+    }
+
+  while (level >= 0)
+    {
+#if CONFIG_BOARD_INITCALL_NTHREADS > 1
+      int nhelpers = 0;
+      int count = 0;
+#endif
+
+      ctx->level = level;
+      ctx->next  = 0;
+
+      /* Count the entries of this level and find the next higher level */
+
+      next = -1;
+      for (i = 0; i < ncalls; i++)
+        {
+#if CONFIG_BOARD_INITCALL_NTHREADS > 1
+          if (calls[i].level == level)
+            {
+              count++;
+            }
+#endif
+
+          if (calls[i].level > level &&
+              (next < 0 || calls[i].level < next))
+            {
+              next = calls[i].level;
+            }
+        }
+
+#if CONFIG_BOARD_INITCALL_NTHREADS > 1
+      /* Start the helper threads, this thread is one of the workers.  If
+       * no thread can be created, this thread simply does all the work.
+       */
+
+      while (nhelpers < count - 1 &&
+             nhelpers < CONFIG_BOARD_INITCALL_NTHREADS - 1)
+        {
+          if (kthread_create("initcall", CONFIG_BOARD_INITTHREAD_PRIORITY,
+                             CONFIG_BOARD_INITCALL_STACKSIZE,
+                             initcall_thread, NULL) < 0)
+            {
+              break;
+            }
+
+          nhelpers++;
+        }
+#endif
+
+      initcall_worker(ctx);
+
+#if CONFIG_BOARD_INITCALL_NTHREADS > 1
+      while (nhelpers-- > 0)
+        {
+          nxsem_wait_uninterruptible(&ctx->done);
+        }
+#endif
+
+      level = next;
+    }
+
+#ifdef CONFIG_BOARD_INITCALL_TIMELINE
+  initcall_dump(ctx);
+  kmm_free(ctx->times);
+  ctx->times = NULL;
+#endif
+
+  return ctx->result;
+}
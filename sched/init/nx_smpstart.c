@@ -87,6 +87,10 @@ void nx_idle_trampoline(void)
 
   for (; ; )
     {
+      /* Steal ready-to-run work that is waiting for a busy CPU */
+
+      nxsched_balance_idle();
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
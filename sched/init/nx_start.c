@@ -56,6 +56,7 @@
 #include "mqueue/mqueue.h"
 #include "mqueue/msg.h"
 #include "clock/clock.h"
+#include "hrtimer/hrtimer.h"
 #include "timer/timer.h"
 #include "irq/irq.h"
 #include "group/group.h"
@@ -170,6 +171,7 @@ volatile pid_t g_lastpid;
 
 FAR struct tcb_s **g_pidhash;
 volatile int g_npidhash;
+seqcount_t g_pidhash_seq;
 
 /* This is a table of task lists.  This table is indexed by the task state
  * enumeration type (tstate_t) and provides a pointer to the associated
@@ -387,6 +389,12 @@ static void idle_task_initialize(void)
       tcb->flags = TCB_FLAG_TTYPE_KERNEL;
 #endif
 
+#ifdef CONFIG_TIMER_SLACK
+      /* All tasks inherit the timer slack of the IDLE task by default */
+
+      tcb->timer_slack = CONFIG_TIMER_SLACK_DEFAULT;
+#endif
+
 #if CONFIG_TASK_NAME_SIZE > 0
       /* Set the IDLE task name */
 
@@ -399,7 +407,9 @@ static void idle_task_initialize(void)
 #endif /* CONFIG_TASK_NAME_SIZE */
 
       /* Then add the idle task's TCB to the head of the current ready to
-       * run list.
+       * run list.  It is added directly rather than with nxsched_rtr_add():
+       * its priority 0 is below SCHED_PRIORITY_MIN, and as it always stays
+       * last in the list it needs no index entry.
        */
 
 #ifdef CONFIG_SMP
@@ -633,6 +643,12 @@ void nx_start(void)
 
   irq_initialize();
 
+#ifdef CONFIG_HRTIMER
+  /* Initialize the high resolution timer bases */
+
+  hrtimer_initialize();
+#endif
+
   /* Initialize the POSIX timer facility (if included in the link) */
 
   clock_initialize();
@@ -764,6 +780,10 @@ void nx_start(void)
 #ifndef CONFIG_DISABLE_IDLE_LOOP
   for (; ; )
     {
+      /* Steal ready-to-run work that is waiting for a busy CPU */
+
+      nxsched_balance_idle();
+
       /* Perform any processor-specific idle state operations */
 
       up_idle();
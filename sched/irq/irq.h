@@ -37,6 +37,16 @@
 #include <nuttx/irq.h>
 #include <nuttx/spinlock.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bucket n of the handler latency histogram counts the executions that
+ * took less than 2^n microseconds, the last bucket gets the rest.
+ */
+
+#define IRQ_HIST_NBUCKETS 8
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -55,9 +65,30 @@ struct irq_info_s
   clock_t start;     /* Time interrupt attached */
   clock_t time;      /* Maximum execution time on this IRQ */
   uint32_t count;    /* Number of interrupts on this IRQ */
+  clock_t runtime;   /* Total execution time on this IRQ */
+#endif
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  uint32_t hist[IRQ_HIST_NBUCKETS]; /* Execution time histogram */
 #endif
 };
 
+#ifdef CONFIG_SPINLOCK_STATISTICS
+/* Contention statistics of one spinlock.  All fields but lock are written
+ * only by the CPU holding the lock.  Times are in up_perf_gettime() units.
+ */
+
+struct spinlock_stat_s
+{
+  FAR volatile spinlock_t *volatile lock;  /* The lock, NULL if unused */
+  uint32_t acquired;                       /* Number of acquisitions */
+  uint32_t contended;                      /* Acquisitions that waited */
+  clock_t spintotal;                       /* Total time spent waiting */
+  clock_t spinmax;                         /* Longest wait */
+  clock_t holdmax;                         /* Longest hold */
+  clock_t locked;                          /* Time of last acquisition */
+};
+#endif
+
 #ifdef CONFIG_SCHED_IRQMONITOR
 /* This is the type of the callback from irq_foreach(). */
 
@@ -96,6 +127,13 @@ extern volatile cpu_set_t g_cpu_irqset;
 extern volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_SPINLOCK_STATISTICS
+/* Statistics of every spinlock taken so far, see irq_spinstat.c */
+
+extern struct spinlock_stat_s
+g_spinlock_stat[CONFIG_SPINLOCK_STATISTICS_NLOCKS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -159,6 +197,17 @@ int irq_unexpected_isr(int irq, FAR void *context, FAR void *arg);
 int irq_foreach(irq_foreach_t callback, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_thread_pid
+ *
+ * Description:
+ *   Return the handler thread of an IRQ attached with irq_attach_thread(),
+ *   zero if there is none.
+ *
+ ****************************************************************************/
+
+pid_t irq_thread_pid(int irq);
+
 #ifdef CONFIG_IRQCHAIN
 void irqchain_initialize(void);
 bool is_irqchain(int ndx, xcpt_t isr);
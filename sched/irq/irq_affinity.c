@@ -0,0 +1,131 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_SMP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IRQ_ALLCPUS ((cpu_set_t)((1ul << CONFIG_SMP_NCPUS) - 1))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+static int irq_balance_callback(int irq, FAR struct irq_info_s *info,
+                                FAR void *arg)
+{
+  FAR uint32_t *load = arg;
+  int best = 0;
+  int cpu;
+
+  for (cpu = 1; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (load[cpu] < load[best])
+        {
+          best = cpu;
+        }
+    }
+
+  /* An IRQ that was never taken is moved anyway, so that new interrupt
+   * sources do not all pile up on the boot CPU.
+   */
+
+  load[best] += info->count + 1;
+  irq_set_affinity(irq, (cpu_set_t)1 << best);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset' and, if the IRQ was
+ *   attached with irq_attach_thread(), bind its handler thread to the same
+ *   CPUs.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, cpu_set_t cpuset)
+{
+  pid_t pid;
+
+  cpuset &= IRQ_ALLCPUS;
+  if (IRQ_TO_NDX(irq) < 0 || cpuset == 0)
+    {
+      return -EINVAL;
+    }
+
+  up_affinity_irq(irq, cpuset);
+
+  /* Keep the deferred half next to the hardware interrupt */
+
+  pid = irq_thread_pid(irq);
+  if (pid > 0)
+    {
+      return nxsched_set_affinity(pid, sizeof(cpuset), &cpuset);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_balance
+ *
+ * Description:
+ *   Spread the attached interrupts over the CPUs by their recent rate.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR
+void irq_balance(void)
+{
+  uint32_t load[CONFIG_SMP_NCPUS];
+
+  memset(load, 0, sizeof(load));
+  irq_foreach(irq_balance_callback, load);
+}
+#endif
+
+#endif /* CONFIG_SMP */
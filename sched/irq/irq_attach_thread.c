@@ -53,6 +53,14 @@ struct irq_thread_info_s
   FAR sem_t *sem;     /* irq sem used to notify irq thread */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if NR_IRQS > 0
+static pid_t g_irq_thread_pid[NR_IRQS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -147,8 +155,6 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
 {
   int ret = OK;
 #if NR_IRQS > 0
-  static pid_t irq_thread_pid[NR_IRQS];
-
   FAR char *argv[5];
   char arg1[32];  /* irq */
   char arg2[32];  /* isr */
@@ -165,11 +171,11 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
       /* If the isrthread is NULL, then the ISR is being detached. */
 
       irq_detach(irq);
-      DEBUGASSERT(irq_thread_pid[ndx] != 0);
-      kthread_delete(irq_thread_pid[ndx]);
-      irq_thread_pid[ndx] = 0;
+      DEBUGASSERT(g_irq_thread_pid[ndx] != 0);
+      kthread_delete(g_irq_thread_pid[ndx]);
+      g_irq_thread_pid[ndx] = 0;
     }
-  else if(irq_thread_pid[ndx] != 0)
+  else if(g_irq_thread_pid[ndx] != 0)
     {
       ret = -EINVAL;
     }
@@ -192,9 +198,32 @@ int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread, FAR void *arg,
           ret = pid;
         }
 
-      irq_thread_pid[ndx] = pid;
+      g_irq_thread_pid[ndx] = pid;
     }
 #endif /* NR_IRQS */
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: irq_thread_pid
+ *
+ * Description:
+ *   Return the handler thread of an IRQ attached with irq_attach_thread(),
+ *   zero if there is none.
+ *
+ ****************************************************************************/
+
+pid_t irq_thread_pid(int irq)
+{
+#if NR_IRQS > 0
+  int ndx = IRQ_TO_NDX(irq);
+
+  if (ndx >= 0)
+    {
+      return g_irq_thread_pid[ndx];
+    }
+#endif
+
+  return 0;
+}
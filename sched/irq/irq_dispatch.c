@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <debug.h>
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
@@ -36,6 +37,7 @@
 #include "irq/irq.h"
 #include "clock/clock.h"
 #include "sched/sched.h"
+#include "wqueue/wqueue.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -47,26 +49,29 @@
 #  define NUSER_IRQS NR_IRQS
 #endif
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define IRQ_HISTOGRAM(ndx, elapsed) irq_histogram(ndx, elapsed)
+#else
+#  define IRQ_HISTOGRAM(ndx, elapsed)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this
  * interrupt request
  */
 
 #ifdef CONFIG_SCHED_IRQMONITOR
-#  define CALL_VECTOR(ndx, vector, irq, context, arg) \
+#  define IRQ_MONITOR(ndx, vector, irq, elapsed) \
      do \
        { \
-         clock_t start; \
-         clock_t elapsed; \
-         start = perf_gettime(); \
-         vector(irq, context, arg); \
-         elapsed = perf_gettime() - start; \
          if (ndx < NUSER_IRQS) \
            { \
              g_irqvector[ndx].count++; \
+             g_irqvector[ndx].runtime += elapsed; \
              if (elapsed > g_irqvector[ndx].time) \
                { \
                  g_irqvector[ndx].time = elapsed; \
                } \
+             IRQ_HISTOGRAM(ndx, elapsed); \
            } \
          if (CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ > 0 && \
              elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ) \
@@ -77,9 +82,122 @@
        } \
      while (0)
 #else
+#  define IRQ_MONITOR(ndx, vector, irq, elapsed)
+#endif
+
+/* The time spent in a handler is not charged to the interrupted thread */
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+#  define IRQ_RUNTIME_ENTER() irq_runtime_enter()
+#  define IRQ_RUNTIME_LEAVE(start, elapsed) irq_runtime_leave(start, elapsed)
+#else
+#  define IRQ_RUNTIME_ENTER()
+#  define IRQ_RUNTIME_LEAVE(start, elapsed)
+#endif
+
+#if defined(CONFIG_SCHED_IRQMONITOR) || \
+    CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+#  define CALL_VECTOR(ndx, vector, irq, context, arg) \
+     do \
+       { \
+         clock_t start; \
+         clock_t elapsed; \
+         IRQ_RUNTIME_ENTER(); \
+         start = perf_gettime(); \
+         vector(irq, context, arg); \
+         elapsed = perf_gettime() - start; \
+         IRQ_MONITOR(ndx, vector, irq, elapsed); \
+         IRQ_RUNTIME_LEAVE(start, elapsed); \
+       } \
+     while (0)
+#else
 #  define CALL_VECTOR(ndx, vector, irq, context, arg) \
      vector(irq, context, arg)
-#endif /* CONFIG_SCHED_IRQMONITOR */
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+/* Upper bounds of the histogram buckets in up_perf_gettime() units */
+
+static clock_t g_irq_histlimit[IRQ_HIST_NBUCKETS - 1];
+#endif
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+/* Handler nesting depth of each CPU */
+
+static uint8_t g_irq_nesting[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+static void irq_histogram(int ndx, clock_t elapsed)
+{
+  int i;
+
+  /* The perf timer may not be running yet at irq_initialize() */
+
+  if (g_irq_histlimit[0] == 0)
+    {
+      uint64_t freq = perf_getfreq();
+
+      for (i = 0; i < IRQ_HIST_NBUCKETS - 1; i++)
+        {
+          g_irq_histlimit[i] = MAX((clock_t)((freq << i) / 1000000), 1);
+        }
+    }
+
+  for (i = 0; i < IRQ_HIST_NBUCKETS - 1; i++)
+    {
+      if (elapsed < g_irq_histlimit[i])
+        {
+          break;
+        }
+    }
+
+  g_irqvector[ndx].hist[i]++;
+}
+#endif
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+static inline_function void irq_runtime_enter(void)
+{
+  g_irq_nesting[this_cpu()]++;
+}
+
+static inline_function void irq_runtime_leave(clock_t start,
+                                              clock_t elapsed)
+{
+  FAR struct tcb_s *tcb;
+
+  /* Only the outermost handler moves the start of the running slice,
+   * nested ones are already part of its elapsed time.
+   */
+
+  if (--g_irq_nesting[this_cpu()] == 0)
+    {
+      tcb = this_task();
+
+      /* If the slice was restarted inside the handler, by a context
+       * switch or by the CPU load sampling, it starts now.
+       */
+
+      if ((sclock_t)(tcb->run_start - start) <= 0)
+        {
+          tcb->run_start += elapsed;
+        }
+      else
+        {
+          tcb->run_start = start + elapsed;
+        }
+    }
+}
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -149,6 +267,12 @@ void irq_dispatch(int irq, FAR void *context)
   sched_note_irqhandler(irq, vector, false);
 #endif
 
+#ifdef CONFIG_SCHED_ISRWORK
+  /* Run the work the handler queued, still on the interrupt stack */
+
+  work_isr_dispatch();
+#endif
+
 #ifdef CONFIG_DEBUG_MM
   if ((rtcb->flags & TCB_FLAG_HEAP_CHECK) ||
       (this_task()->flags & TCB_FLAG_HEAP_CHECK))
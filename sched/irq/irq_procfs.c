@@ -49,26 +49,45 @@
 
 /* Output format:
  *
- *            1111111111222222222233333333334444444444
- *   1234567890123456789012345678901234567890123456789
+ *            111111111122222222223333333333444444444455555555556
+ *   1234567890123456789012345678901234567890123456789012345678901
  *
- *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME
- *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD
+ *   IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME      TOTAL
+ *   DDD XXXXXXXX XXXXXXXX DDDDDDDDDD DDDD.DDD DDDD DDDDDDDDDD
+ *
+ * TIME is the longest and TOTAL the accumulated execution time in
+ * microseconds since the last read.
  *
  * NOTE:  This assumes that an address can be represented in 32-bits.  In
  * the typical configuration where CONFIG_HAVE_LONG_LONG=y, the COUNT field
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME      TOTAL"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu %10lu"
+
+/* With CONFIG_SCHED_IRQMONITOR_HISTOGRAM every line is followed by the
+ * number of executions in each bucket of the latency histogram.
+ */
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define HIST_HDR "   <1us   <2us   <4us   <8us  <16us  <32us  <64us" \
+                   " >=64us"
+#  define HIST_FMT " %6lu"
+#else
+#  define HIST_HDR ""
+#endif
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+#  define IRQ_LINELEN (61 + IRQ_HIST_NBUCKETS * 11)
+#else
+#  define IRQ_LINELEN 61
+#endif
 
 /****************************************************************************
  * Private Types
@@ -147,6 +166,7 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   FAR struct irq_file_s *irqfile = (FAR struct irq_file_s *)arg;
   struct irq_info_s copy;
   struct timespec delta;
+  struct timespec total;
   irqstate_t flags;
   clock_t elapsed;
   clock_t now;
@@ -155,6 +175,9 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  int i;
+#endif
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -164,8 +187,12 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   memcpy(&copy, info, sizeof(struct irq_info_s));
   now         = clock_systime_ticks();
   info->start = now;
-  info->time  = 0;
-  info->count = 0;
+  info->time    = 0;
+  info->runtime = 0;
+  info->count   = 0;
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  memset(info->hist, 0, sizeof(info->hist));
+#endif
   leave_critical_section(flags);
 
   /* Don't bother if count == 0.
@@ -200,6 +227,7 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
 
   elapsed = now - copy.start;
   perf_convert(copy.time, &delta);
+  perf_convert(copy.runtime, &total);
 
 #ifdef CONFIG_HAVE_LONG_LONG
   /* elapsed = <current-time> - <start-time>, units=clock ticks
@@ -241,7 +269,21 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       (unsigned long)((uintptr_t)copy.handler),
                       (unsigned long)((uintptr_t)copy.arg),
                       count, intpart, fracpart,
-                      (unsigned long)delta.tv_nsec / 1000);
+                      (unsigned long)delta.tv_nsec / 1000,
+                      (unsigned long)total.tv_sec * 1000000 +
+                      (unsigned long)total.tv_nsec / 1000);
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HISTOGRAM
+  for (i = 0; i < IRQ_HIST_NBUCKETS; i++)
+    {
+      linesize += snprintf(irqfile->line + linesize,
+                           IRQ_LINELEN - linesize, HIST_FMT,
+                           (unsigned long)copy.hist[i]);
+    }
+#endif
+
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       "\n");
 
   copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                             irqfile->remaining, &irqfile->offset);
@@ -346,7 +388,7 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 
   /* The first line to output is the header */
 
-  linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
+  linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT HIST_HDR "\n");
 
   copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
                            irqfile->remaining, &irqfile->offset);
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * sched/irq/irq_spinprocfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "irq/irq.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SPINLOCK_STATISTICS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output format, times are in microseconds:
+ *
+ *   LOCK       ACQUIRED  CONTENDED    SPIN   SPINMAX   HOLDMAX
+ *   XXXXXXXX DDDDDDDDDD DDDDDDDDDD DDDDDDDD DDDDDDDD DDDDDDDD
+ */
+
+#define HDR_FMT  "LOCK       ACQUIRED  CONTENDED     SPIN  SPINMAX  HOLDMAX\n"
+#define SPIN_FMT "%08lx %10lu %10lu %8lu %8lu %8lu\n"
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SPIN_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct spinlock_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  char line[SPIN_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     spinlock_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     spinlock_close(FAR struct file *filep);
+static ssize_t spinlock_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     spinlock_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     spinlock_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_spinlock_operations =
+{
+  spinlock_open,  /* open */
+  spinlock_close, /* close */
+  spinlock_read,  /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+
+  spinlock_dup,   /* dup */
+
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+
+  spinlock_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spinlock_usec
+ ****************************************************************************/
+
+static unsigned long spinlock_usec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return (unsigned long)ts.tv_sec * USEC_PER_SEC +
+         (unsigned long)ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: spinlock_open
+ ****************************************************************************/
+
+static int spinlock_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct spinlock_file_s *spinfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* This PROCFS file is read-only.  Any attempt to open with write access
+   * is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  spinfile = kmm_zalloc(sizeof(struct spinlock_file_s));
+  if (!spinfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)spinfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_close
+ ****************************************************************************/
+
+static int spinlock_close(FAR struct file *filep)
+{
+  FAR struct spinlock_file_s *spinfile;
+
+  /* Recover our private data from the struct file instance */
+
+  spinfile = (FAR struct spinlock_file_s *)filep->f_priv;
+  DEBUGASSERT(spinfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(spinfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_read
+ ****************************************************************************/
+
+static ssize_t spinlock_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct spinlock_file_s *spinfile;
+  off_t offset;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  spinfile = (FAR struct spinlock_file_s *)filep->f_priv;
+  DEBUGASSERT(spinfile);
+
+  offset   = filep->f_pos;
+  linesize = snprintf(spinfile->line, SPIN_LINELEN, HDR_FMT);
+  copysize = procfs_memcpy(spinfile->line, linesize, buffer, buflen,
+                           &offset);
+  totalsize = copysize;
+
+  /* Every claimed entry keeps its slot, so the order of the lines is
+   * stable between reads.  The counters are sampled without the lock and
+   * may be slightly inconsistent with each other.
+   */
+
+  for (i = 0; i < CONFIG_SPINLOCK_STATISTICS_NLOCKS && totalsize < buflen;
+       i++)
+    {
+      FAR struct spinlock_stat_s *stat = &g_spinlock_stat[i];
+
+      if (stat->lock == NULL)
+        {
+          continue;
+        }
+
+      linesize = snprintf(spinfile->line, SPIN_LINELEN, SPIN_FMT,
+                          (unsigned long)(uintptr_t)stat->lock,
+                          (unsigned long)stat->acquired,
+                          (unsigned long)stat->contended,
+                          spinlock_usec(stat->spintotal),
+                          spinlock_usec(stat->spinmax),
+                          spinlock_usec(stat->holdmax));
+      copysize = procfs_memcpy(spinfile->line, linesize,
+                               buffer + totalsize, buflen - totalsize,
+                               &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file position */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spinlock_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int spinlock_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct spinlock_file_s *oldattr;
+  FAR struct spinlock_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct spinlock_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct spinlock_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct spinlock_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spinlock_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int spinlock_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "spinlocks" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SPINLOCK_STATISTICS */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
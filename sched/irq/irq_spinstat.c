@@ -0,0 +1,201 @@
+/****************************************************************************
+ * sched/irq/irq_spinstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#include "irq/irq.h"
+
+#ifdef CONFIG_SPINLOCK_STATISTICS
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* One entry per lock, claimed the first time the lock is taken */
+
+struct spinlock_stat_s g_spinlock_stat[CONFIG_SPINLOCK_STATISTICS_NLOCKS];
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Serializes claiming a free entry.  A spinlock cannot be used here since
+ * it would recurse into the statistics.
+ */
+
+static atomic_t g_spinstat_claim;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_stat_find
+ *
+ * Description:
+ *   Return the statistics entry of the lock, claiming a free entry if the
+ *   lock has none yet.  NULL is returned when the table is full.
+ *
+ ****************************************************************************/
+
+static FAR struct spinlock_stat_s *
+spin_stat_find(FAR volatile spinlock_t *lock)
+{
+  FAR struct spinlock_stat_s *stat = NULL;
+  unsigned int hash;
+  unsigned int i;
+  irqstate_t flags;
+
+  hash = ((uintptr_t)lock / sizeof(uintptr_t)) %
+         CONFIG_SPINLOCK_STATISTICS_NLOCKS;
+
+  for (i = 0; i < CONFIG_SPINLOCK_STATISTICS_NLOCKS; i++)
+    {
+      stat = &g_spinlock_stat[(hash + i) %
+                              CONFIG_SPINLOCK_STATISTICS_NLOCKS];
+      if (stat->lock == lock)
+        {
+          return stat;
+        }
+      else if (stat->lock == NULL)
+        {
+          break;
+        }
+    }
+
+  if (i == CONFIG_SPINLOCK_STATISTICS_NLOCKS)
+    {
+      return NULL;
+    }
+
+  /* Claim the free entry, another CPU may have raced us to it */
+
+  flags = up_irq_save();
+  while (atomic_xchg_acquire(&g_spinstat_claim, 1) != 0);
+
+  for (; i < CONFIG_SPINLOCK_STATISTICS_NLOCKS; i++)
+    {
+      stat = &g_spinlock_stat[(hash + i) %
+                              CONFIG_SPINLOCK_STATISTICS_NLOCKS];
+      if (stat->lock == NULL)
+        {
+          stat->lock = lock;
+          break;
+        }
+      else if (stat->lock == lock)
+        {
+          break;
+        }
+    }
+
+  atomic_set_release(&g_spinstat_claim, 0);
+  up_irq_restore(flags);
+
+  return i < CONFIG_SPINLOCK_STATISTICS_NLOCKS ? stat : NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_stat_locked
+ *
+ * Description:
+ *   Account one acquisition of the lock.  Called with the lock held, so
+ *   the entry is only ever updated by the lock owner.
+ *
+ * Input Parameters:
+ *   lock      - The spinlock that was just acquired
+ *   start     - up_perf_gettime() when the caller started to acquire it
+ *   contended - True if the caller had to wait for it
+ *
+ ****************************************************************************/
+
+void spin_stat_locked(FAR volatile spinlock_t *lock, clock_t start,
+                      bool contended)
+{
+  FAR struct spinlock_stat_s *stat = spin_stat_find(lock);
+  clock_t now;
+
+  if (stat == NULL)
+    {
+      return;
+    }
+
+  now = up_perf_gettime();
+  stat->acquired++;
+  if (contended)
+    {
+      clock_t spin = now - start;
+
+      stat->contended++;
+      stat->spintotal += spin;
+      if (spin > stat->spinmax)
+        {
+          stat->spinmax = spin;
+        }
+    }
+
+  stat->locked = now;
+}
+
+/****************************************************************************
+ * Name: spin_stat_unlock
+ *
+ * Description:
+ *   Account the hold time of the lock, called just before it is released.
+ *
+ ****************************************************************************/
+
+void spin_stat_unlock(FAR volatile spinlock_t *lock)
+{
+  FAR struct spinlock_stat_s *stat = spin_stat_find(lock);
+  clock_t hold;
+
+  if (stat == NULL || stat->locked == 0)
+    {
+      return;
+    }
+
+  hold = up_perf_gettime() - stat->locked;
+  if (hold > stat->holdmax)
+    {
+      stat->holdmax = hold;
+    }
+
+  stat->locked = 0;
+}
+
+#endif /* CONFIG_SPINLOCK_STATISTICS */
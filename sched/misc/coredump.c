@@ -32,6 +32,7 @@
 
 #include <nuttx/coredump.h>
 #include <nuttx/elf.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 
@@ -55,6 +56,11 @@
 
 #define PROGRAM_ALIGNMENT 64
 
+#if defined(CONFIG_BOARD_COREDUMP_SKIPZERO) || \
+    defined(CONFIG_BOARD_COREDUMP_MINIDUMP)
+#  define ELF_SEGMENTS
+#endif
+
 /* Architecture can overwrite the default XCPTCONTEXT alignment */
 
 #ifndef XCPTCONTEXT_ALIGN
@@ -102,7 +108,8 @@ static struct lib_blkoutstream_s g_devstream;
 static struct lib_mtdoutstream_s g_devstream;
 #endif
 
-#ifdef CONFIG_BOARD_MEMORY_RANGE
+#if defined(CONFIG_BOARD_MEMORY_RANGE) && \
+    !defined(CONFIG_BOARD_COREDUMP_MINIDUMP)
 static struct memory_region_s g_memory_region[] =
   {
     CONFIG_BOARD_MEMORY_RANGE
@@ -110,6 +117,12 @@ static struct memory_region_s g_memory_region[] =
 #endif
 static const struct memory_region_s *g_regions;
 
+/* The memory segments really dumped, prepared from the regions */
+
+#ifdef ELF_SEGMENTS
+static struct memory_region_s g_segments[CONFIG_BOARD_COREDUMP_MAXSEGS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -513,6 +526,170 @@ static void elf_emit_memory(FAR struct elf_dumpinfo_s *cinfo, int memsegs)
     }
 }
 
+/****************************************************************************
+ * Name: elf_page_skip
+ *
+ * Description:
+ *   Return true if the memory holds nothing worth dumping, all zero or
+ *   all free heap fill.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP_SKIPZERO
+static bool elf_page_skip(uintptr_t start, uintptr_t end)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)start;
+  FAR const uint8_t *last = (FAR const uint8_t *)end;
+  uint8_t fill = *ptr;
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  if (fill != 0 && fill != MM_FREE_MAGIC)
+#else
+  if (fill != 0)
+#endif
+    {
+      return false;
+    }
+
+  for (; ptr < last && ((uintptr_t)ptr & (sizeof(uintptr_t) - 1)); ptr++)
+    {
+      if (*ptr != fill)
+        {
+          return false;
+        }
+    }
+
+  for (; ptr + sizeof(uintptr_t) <= last; ptr += sizeof(uintptr_t))
+    {
+      if (*(FAR const uintptr_t *)ptr != (UINTPTR_MAX / 0xff) * fill)
+        {
+          return false;
+        }
+    }
+
+  for (; ptr < last; ptr++)
+    {
+      if (*ptr != fill)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Name: elf_prepare_segments
+ *
+ * Description:
+ *   Fill g_segments with the memory segments to dump: the TCBs for a
+ *   minidump, then the regions without their skipped pages.  An entry is
+ *   kept for every region still to come, so a full table only stops the
+ *   splitting.
+ *
+ * Returned Value:
+ *   The number of segments.
+ *
+ ****************************************************************************/
+
+#ifdef ELF_SEGMENTS
+static int elf_prepare_segments(FAR struct elf_dumpinfo_s *cinfo,
+                                int memsegs)
+{
+  FAR const struct memory_region_s *region;
+  uintptr_t start;
+  uintptr_t end;
+  int nsegs = 0;
+  int i;
+
+  if (memsegs > CONFIG_BOARD_COREDUMP_MAXSEGS)
+    {
+      return memsegs;
+    }
+
+#ifdef CONFIG_BOARD_COREDUMP_MINIDUMP
+  for (i = 0; i < g_npidhash; i++)
+    {
+      FAR struct tcb_s *tcb = g_pidhash[i];
+
+      if (tcb == NULL || nsegs + memsegs >= CONFIG_BOARD_COREDUMP_MAXSEGS ||
+          (cinfo->pid != INVALID_PROCESS_ID && tcb->pid != cinfo->pid))
+        {
+          continue;
+        }
+
+      g_segments[nsegs].start   = (uintptr_t)tcb;
+      g_segments[nsegs].end     = (uintptr_t)tcb + sizeof(struct tcb_s);
+      g_segments[nsegs++].flags = PF_R | PF_W;
+    }
+#endif
+
+  for (i = 0; i < memsegs; i++)
+    {
+      region = &cinfo->regions[i];
+      start  = region->start;
+
+      while (start < region->end)
+        {
+#ifdef CONFIG_BOARD_COREDUMP_SKIPZERO
+          /* Registers are read as they are dumped only */
+
+          if ((region->flags & PF_REGISTER) == 0)
+            {
+              for (; start < region->end; start = end)
+                {
+                  end = MIN(ALIGN_DOWN(start, ELF_PAGESIZE) + ELF_PAGESIZE,
+                            region->end);
+                  if (!elf_page_skip(start, end))
+                    {
+                      break;
+                    }
+                }
+
+              if (start >= region->end)
+                {
+                  break;
+                }
+            }
+#endif
+
+          /* Split off the pages up to the next skipped one while an entry
+           * is left for the rest of this region and each later one.
+           */
+
+          end = region->end;
+#ifdef CONFIG_BOARD_COREDUMP_SKIPZERO
+          if ((region->flags & PF_REGISTER) == 0 &&
+              nsegs + memsegs - i < CONFIG_BOARD_COREDUMP_MAXSEGS)
+            {
+              for (end = start; end < region->end; )
+                {
+                  uintptr_t next = MIN(ALIGN_DOWN(end, ELF_PAGESIZE) +
+                                       ELF_PAGESIZE, region->end);
+
+                  if (end > start && elf_page_skip(end, next))
+                    {
+                      break;
+                    }
+
+                  end = next;
+                }
+            }
+#endif
+
+          g_segments[nsegs].start   = start;
+          g_segments[nsegs].end     = end;
+          g_segments[nsegs++].flags = region->flags;
+          start = end;
+        }
+    }
+
+  cinfo->regions = g_segments;
+  return nsegs;
+}
+#endif
+
 /****************************************************************************
  * Name: elf_emit_info_note
  *
@@ -774,7 +951,8 @@ static void coredump_dump_dev(pid_t pid)
 
 static int coredump_initialize_memory_region(void)
 {
-#ifdef CONFIG_BOARD_MEMORY_RANGE
+#if defined(CONFIG_BOARD_MEMORY_RANGE) && \
+    !defined(CONFIG_BOARD_COREDUMP_MINIDUMP)
   if (g_regions == NULL)
     {
       g_regions = g_memory_region;
@@ -860,7 +1038,8 @@ int coredump_add_memory_region(FAR const void *ptr, size_t size,
   memcpy(region, g_regions, sizeof(struct memory_region_s) * count);
 
   if (g_regions != NULL
-#ifdef CONFIG_BOARD_MEMORY_RANGE
+#if defined(CONFIG_BOARD_MEMORY_RANGE) && \
+    !defined(CONFIG_BOARD_COREDUMP_MINIDUMP)
     && g_regions != g_memory_region
 #endif
     )
@@ -985,6 +1164,10 @@ int coredump(FAR const struct memory_region_s *regions,
              cinfo.regions[memsegs].end; memsegs++);
     }
 
+#ifdef ELF_SEGMENTS
+  memsegs = elf_prepare_segments(&cinfo, memsegs);
+#endif
+
   /* Fill notes section, with additional one for program header,
    * and one for the core file info defined by NuttX.
    */
@@ -81,8 +81,17 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
 
   /* Allocate memory for the new message queue. */
 
+#ifdef CONFIG_MQ_RING
+  /* The inline message slots follow the message queue structure */
+
+  msgq = (FAR struct mqueue_inode_s *)
+    kmm_zalloc(sizeof(struct mqueue_inode_s) +
+               (attr ? attr->mq_maxmsg : MQ_MAX_MSGS) *
+               MQ_RING_SLOT_SIZE(attr ? attr->mq_msgsize : MQ_MAX_BYTES));
+#else
   msgq = (FAR struct mqueue_inode_s *)
     kmm_zalloc(sizeof(struct mqueue_inode_s));
+#endif
 
   if (msgq)
     {
@@ -104,6 +113,10 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
 
+#ifdef CONFIG_MQ_RING
+      msgq->ring = (FAR char *)(msgq + 1);
+#endif
+
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
     }
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * sched/mqueue/mq_msgring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_RING
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_slot
+ *
+ * Description:
+ *   Return the message structure stored in the given ring slot.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct mqueue_msg_s *
+nxmq_ring_slot(FAR struct mqueue_inode_s *msgq, int index)
+{
+  return (FAR struct mqueue_msg_s *)
+    (msgq->ring + index * MQ_RING_SLOT_SIZE(msgq->maxmsgsize));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_send
+ *
+ * Description:
+ *   Copy a message into the next free ring slot of the message queue.
+ *
+ * Input Parameters:
+ *   msgq   - Message queue descriptor
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - The queue is not full and nxmq_ring_usable() is true.
+ *
+ ****************************************************************************/
+
+void nxmq_ring_send(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                    size_t msglen, unsigned int prio)
+{
+  FAR struct mqueue_msg_s *mqmsg = nxmq_ring_slot(msgq, msgq->ringhead);
+
+  DEBUGASSERT(msgq->ringcount < msgq->maxmsgs);
+
+  mqmsg->type     = MQ_ALLOC_RING;
+  mqmsg->priority = prio;
+  mqmsg->msglen   = msglen;
+  memcpy(mqmsg->mail, msg, msglen);
+
+  if (++msgq->ringhead >= msgq->maxmsgs)
+    {
+      msgq->ringhead = 0;
+    }
+
+  msgq->ringprio = prio;
+  msgq->ringcount++;
+}
+
+/****************************************************************************
+ * Name: nxmq_remove_msg
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   queue.  The messages in the ring are always older than the messages
+ *   of the same priority in the list, so the ring wins ties.
+ *
+ * Input Parameters:
+ *   msgq - Message queue descriptor
+ *
+ * Returned Value:
+ *   The removed message, or NULL if the queue is empty.  A message of type
+ *   MQ_ALLOC_RING still lives in the ring slot, the caller must copy it out
+ *   before leaving the critical section and must not free it.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *nxmq_remove_msg(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  mqmsg = list_peek_head_type(&msgq->msglist, struct mqueue_msg_s, node);
+  if (msgq->ringcount > 0 &&
+      (mqmsg == NULL || msgq->ringprio >= mqmsg->priority))
+    {
+      mqmsg = nxmq_ring_slot(msgq, msgq->ringtail);
+      if (++msgq->ringtail >= msgq->maxmsgs)
+        {
+          msgq->ringtail = 0;
+        }
+
+      msgq->ringcount--;
+    }
+  else if (mqmsg != NULL)
+    {
+      list_delete(&mqmsg->node);
+    }
+
+  return mqmsg;
+}
+
+#endif /* CONFIG_MQ_RING */
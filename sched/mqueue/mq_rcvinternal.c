@@ -160,8 +160,7 @@ int nxmq_wait_receive(FAR struct mqueue_inode_s *msgq,
 
   /* Get the message from the head of the queue */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)
-                   list_remove_head(&msgq->msglist)) == NULL)
+  while ((newmsg = nxmq_remove_msg(msgq)) == NULL)
     {
       msgq->cmn.nwaitnotempty++;
 
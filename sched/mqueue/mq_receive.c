@@ -181,7 +181,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   /* Get the message from the message queue */
 
-  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+  mqmsg = nxmq_remove_msg(msgq);
   if (mqmsg == NULL)
     {
       if ((mq->f_oflags & O_NONBLOCK) != 0)
@@ -200,6 +200,24 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
         }
     }
 
+#ifdef CONFIG_MQ_RING
+  /* A message in a ring slot must be copied out before a sender can reuse
+   * the slot, i.e. before we leave the critical section.
+   */
+
+  if (mqmsg->type == MQ_ALLOC_RING)
+    {
+      if (prio)
+        {
+          *prio = mqmsg->priority;
+        }
+
+      memcpy(msg, mqmsg->mail, mqmsg->msglen);
+      ret   = mqmsg->msglen;
+      mqmsg = NULL;
+    }
+#endif
+
   /* If we got message, then decrement the number of messages in
    * the queue while we are still in the critical section
    */
@@ -215,6 +233,13 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   leave_critical_section(flags);
 
+#ifdef CONFIG_MQ_RING
+  if (mqmsg == NULL)
+    {
+      return ret;
+    }
+#endif
+
   /* Return the message to the caller */
 
   if (prio)
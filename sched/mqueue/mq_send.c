@@ -306,17 +306,27 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
-  /* Pre-allocate a message structure */
+#ifdef CONFIG_MQ_RING
+  /* Skip the allocation if the message will likely go to the ring.  This
+   * is only a hint, it is checked again within the critical section.
+   */
 
-  mqmsg = nxmq_alloc_msg(msglen);
-  if (!mqmsg)
+  mqmsg = NULL;
+  if (!nxmq_ring_usable(msgq, prio))
+#endif
     {
-      return -ENOMEM;
-    }
+      /* Pre-allocate a message structure */
+
+      mqmsg = nxmq_alloc_msg(msglen);
+      if (!mqmsg)
+        {
+          return -ENOMEM;
+        }
 
-  memcpy(mqmsg->mail, msg, msglen);
-  mqmsg->priority = prio;
-  mqmsg->msglen   = msglen;
+      memcpy(mqmsg->mail, msg, msglen);
+      mqmsg->priority = prio;
+      mqmsg->msglen   = msglen;
+    }
 
   /* Disable interruption */
 
@@ -343,9 +353,43 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
         }
     }
 
+#ifdef CONFIG_MQ_RING
+  if (nxmq_ring_usable(msgq, prio))
+    {
+      /* Store the message inline, a pre-allocated one is not needed */
+
+      nxmq_ring_send(msgq, msg, msglen, prio);
+      if (mqmsg != NULL)
+        {
+          nxmq_free_msg(mqmsg);
+          mqmsg = NULL;
+        }
+    }
+  else
+    {
+      if (mqmsg == NULL)
+        {
+          /* The ring became unusable since the hint, allocate now */
+
+          mqmsg = nxmq_alloc_msg(msglen);
+          if (!mqmsg)
+            {
+              ret = -ENOMEM;
+              goto out;
+            }
+
+          memcpy(mqmsg->mail, msg, msglen);
+          mqmsg->priority = prio;
+          mqmsg->msglen   = msglen;
+        }
+
+      nxmq_add_queue(msgq, mqmsg, prio);
+    }
+#else
   /* Add the message to the message queue */
 
   nxmq_add_queue(msgq, mqmsg, prio);
+#endif
 
   /* Increment the count of messages in the queue */
 
@@ -361,7 +405,7 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 out:
   leave_critical_section(flags);
 
-  if (ret < 0)
+  if (ret < 0 && mqmsg != NULL)
     {
       nxmq_free_msg(mqmsg);
     }
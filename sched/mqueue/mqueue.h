@@ -37,6 +37,8 @@
 #include <mqueue.h>
 #include <sched.h>
 
+#include <nuttx/nuttx.h>
+#include <nuttx/list.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/mqueue.h>
 
@@ -52,6 +54,23 @@
 
 #define MQ_MSG_SIZE(n) (sizeof(struct mqueue_msg_s) + (n) - 1)
 
+#ifdef CONFIG_MQ_RING
+/* Size of one inline ring slot, which holds a struct mqueue_msg_s */
+
+#  define MQ_RING_SLOT_SIZE(n) ALIGN_UP(MQ_MSG_SIZE(n), sizeof(uintptr_t))
+
+/* A message goes to the ring only if it keeps the messages in order:
+ * nothing is waiting in the list and the ring holds the same priority.
+ */
+
+#  define nxmq_ring_usable(msgq, prio) \
+     (list_is_empty(&(msgq)->msglist) && \
+      ((msgq)->ringcount == 0 || (msgq)->ringprio == (prio)))
+#else
+#  define nxmq_remove_msg(msgq) \
+     ((FAR struct mqueue_msg_s *)list_remove_head(&(msgq)->msglist))
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -60,7 +79,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_RING        /* Inline slot of the message queue; never freed */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -138,6 +158,14 @@ int nxmq_wait_send(FAR struct mqueue_inode_s *msgq,
                    sclock_t ticks);
 void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
+/* mq_msgring.c *************************************************************/
+
+#ifdef CONFIG_MQ_RING
+void nxmq_ring_send(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                    size_t msglen, unsigned int prio);
+FAR struct mqueue_msg_s *nxmq_remove_msg(FAR struct mqueue_inode_s *msgq);
+#endif
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
@@ -55,6 +55,14 @@
 #  define CONFIG_PAGING_STACKSIZE  CONFIG_IDLETHREAD_STACKSIZE
 #endif
 
+#ifndef CONFIG_PAGING_READAHEAD
+#  define CONFIG_PAGING_READAHEAD 0
+#endif
+
+#if CONFIG_PAGING_READAHEAD >= CONFIG_PAGING_NPPAGED
+#  error CONFIG_PAGING_READAHEAD must be less than CONFIG_PAGING_NPPAGED
+#endif
+
 #define SIGPAGING SIGRTMIN
 
 /****************************************************************************
@@ -89,6 +89,14 @@ static clock_t g_starttime;
 #endif
 #endif
 
+#if CONFIG_PAGING_READAHEAD > 0
+/* This holds the fault information of the next page to read ahead.  Only
+ * the architecture-specific fault information of it is used.
+ */
+
+static struct tcb_s g_ratcb;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -420,6 +428,61 @@ static inline bool pg_startfill(void)
   return false;
 }
 
+/****************************************************************************
+ * Name: pg_readahead
+ *
+ * Description:
+ *   Fill the pages following the one just filled for the task in g_pftcb,
+ *   as long as no other task is waiting for a fill.  The fault information
+ *   of the first page to read ahead must have been placed in g_ratcb by
+ *   up_readahead() before that task was restarted.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Executing in the context of the page fill worker thread with interrupts
+ *   disabled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_PAGING_READAHEAD > 0
+static void pg_readahead(void)
+{
+  FAR void *vpage;
+  int result;
+  int i;
+
+  for (i = 0; i < CONFIG_PAGING_READAHEAD; i++)
+    {
+      if (!dq_empty(list_waitingforfill()))
+        {
+          break;
+        }
+
+      if (!up_checkmapping(&g_ratcb))
+        {
+          pginfo("Read ahead\n");
+          result = up_allocpage(&g_ratcb, &vpage);
+          DEBUGASSERT(result == OK);
+
+          result = up_fillpage(&g_ratcb, vpage);
+          DEBUGASSERT(result == OK);
+        }
+
+      if (!up_readahead(&g_ratcb, &g_ratcb))
+        {
+          break;
+        }
+    }
+
+  UNUSED(result);
+}
+#endif
+
 /****************************************************************************
  * Name: pg_alldone
  *
@@ -528,6 +591,9 @@ static inline void pg_fillcomplete(void)
 int pg_worker(int argc, FAR char *argv[])
 {
   FAR struct tcb_s *wtcb = this_task();
+#if CONFIG_PAGING_READAHEAD > 0
+  bool readahead;
+#endif
 
   /* Loop forever -- Notice that interrupts will be disabled at all times
    * that this thread runs.  That is so that we can't lose signals or have
@@ -676,6 +742,14 @@ int pg_worker(int argc, FAR char *argv[])
 
           pginfo("Restarting TCB: %p\n", g_pftcb);
 
+#if CONFIG_PAGING_READAHEAD > 0
+          /* Remember where to read ahead, the task may fault again as soon
+           * as it runs.
+           */
+
+          readahead = up_readahead(g_pftcb, &g_ratcb);
+#endif
+
           /* Add the task to ready-to-run task list and
            * perform the context switch if one is needed
            */
@@ -684,6 +758,13 @@ int pg_worker(int argc, FAR char *argv[])
             {
               up_switch_context(this_task(), wtcb);
             }
+
+#if CONFIG_PAGING_READAHEAD > 0
+          if (readahead)
+            {
+              pg_readahead();
+            }
+#endif
         }
 
       /* All queued fills have been processed */
@@ -42,6 +42,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_PTHREAD_TCB_CACHE
+#  define CONFIG_PTHREAD_TCB_CACHE 0
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -60,6 +64,11 @@ extern "C"
 
 struct task_group_s;  /* Forward reference */
 
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+FAR struct tcb_s *pthread_tcbcache_alloc(size_t tcbsize, size_t stacksize);
+bool pthread_tcbcache_free(FAR struct tcb_s *tcb);
+#endif
+
 int pthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
                             start_t start, pthread_startroutine_t entry);
 
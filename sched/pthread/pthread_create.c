@@ -211,16 +211,32 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
       attr = &default_attr;
     }
 
-  /* Allocate a TCB for the new task. */
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+  /* Try to reuse the TCB and stack of an exited pthread */
 
-  ptcb = kmm_zalloc(sizeof(struct tcb_s) + sizeof(struct pthread_entry_s));
-  if (!ptcb)
+  ptcb = NULL;
+  if (!attr->stackaddr)
     {
-      serr("ERROR: Failed to allocate TCB\n");
-      return ENOMEM;
+      ptcb = pthread_tcbcache_alloc(sizeof(struct tcb_s) +
+                                    sizeof(struct pthread_entry_s),
+                                    attr->stacksize + attr->guardsize);
     }
 
-  ptcb->flags |= TCB_FLAG_FREE_TCB;
+  if (ptcb == NULL)
+#endif
+    {
+      /* Allocate a TCB for the new task. */
+
+      ptcb = kmm_zalloc(sizeof(struct tcb_s) +
+                        sizeof(struct pthread_entry_s));
+      if (!ptcb)
+        {
+          serr("ERROR: Failed to allocate TCB\n");
+          return ENOMEM;
+        }
+
+      ptcb->flags |= TCB_FLAG_FREE_TCB;
+    }
 
   /* Initialize the task join */
 
@@ -248,7 +264,13 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
       ptcb->flags |= TCB_FLAG_DETACHED;
     }
 
-  if (attr->stackaddr)
+  if (ptcb->stack_alloc_ptr)
+    {
+      /* The stack came with the cached TCB */
+
+      ret = OK;
+    }
+  else if (attr->stackaddr)
     {
       /* Use pre-allocated stack */
 
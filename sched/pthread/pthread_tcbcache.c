@@ -0,0 +1,172 @@
+/****************************************************************************
+ * sched/pthread/pthread_tcbcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+
+#include "pthread/pthread.h"
+
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define TCBCACHE_FLAGS \
+  (TCB_FLAG_TTYPE_MASK | TCB_FLAG_FREE_TCB | TCB_FLAG_FREE_STACK)
+#define TCBCACHE_MATCH \
+  (TCB_FLAG_TTYPE_PTHREAD | TCB_FLAG_FREE_TCB | TCB_FLAG_FREE_STACK)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Exited pthread TCBs still owning their stacks, linked through flink */
+
+static FAR struct tcb_s *g_tcbcache;
+static int g_ntcbcache;
+static spinlock_t g_tcbcache_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_tcbcache_alloc
+ *
+ * Description:
+ *   Take a TCB and its stack from the cache of exited pthreads.  The TCB is
+ *   zeroed and the stack is attached as if it had been created by
+ *   up_create_stack().
+ *
+ * Input Parameters:
+ *   tcbsize   - The size of the TCB allocation, including the pthread
+ *               entry data that follows it.
+ *   stacksize - The requested stack size.
+ *
+ * Returned Value:
+ *   A TCB with an attached stack, or NULL if the cache is empty or the
+ *   cached stack does not fit.  In the latter case the cached entry is
+ *   released, so that the cache follows the current stack sizes.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *pthread_tcbcache_alloc(size_t tcbsize, size_t stacksize)
+{
+  FAR struct tcb_s *tcb;
+  FAR void *stack;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_tcbcache_lock);
+  tcb = g_tcbcache;
+  if (tcb != NULL)
+    {
+      g_tcbcache = tcb->flink;
+      g_ntcbcache--;
+    }
+
+  spin_unlock_irqrestore(&g_tcbcache_lock, flags);
+
+  if (tcb == NULL)
+    {
+      return NULL;
+    }
+
+  /* Reuse the stack only if the request is not smaller than the stack of
+   * the previous owner and still fits into the allocated block.
+   */
+
+  stack = tcb->stack_alloc_ptr;
+  if (stacksize < tcb->adj_stack_size ||
+      stacksize > kumm_malloc_size(stack))
+    {
+      up_release_stack(tcb, TCB_FLAG_TTYPE_PTHREAD);
+      kmm_free(tcb);
+      return NULL;
+    }
+
+  memset(tcb, 0, tcbsize);
+  tcb->flags = TCB_FLAG_FREE_TCB;
+
+  if (up_use_stack(tcb, stack, stacksize) != OK)
+    {
+      kumm_free(stack);
+      kmm_free(tcb);
+      return NULL;
+    }
+
+  /* The stack belongs to the TCB again, free it on exit */
+
+  tcb->flags |= TCB_FLAG_FREE_STACK;
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: pthread_tcbcache_free
+ *
+ * Description:
+ *   Keep the TCB of an exited pthread and its stack for reuse.  Only
+ *   pthreads whose TCB and stack were allocated by the OS are kept.
+ *
+ * Input Parameters:
+ *   tcb - The fully released TCB, still owning its stack.
+ *
+ * Returned Value:
+ *   true if the TCB was cached; false if the caller must free it.
+ *
+ ****************************************************************************/
+
+bool pthread_tcbcache_free(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  bool cached = false;
+
+  if ((tcb->flags & TCBCACHE_FLAGS) != TCBCACHE_MATCH ||
+      tcb->stack_alloc_ptr == NULL)
+    {
+      return false;
+    }
+
+  flags = spin_lock_irqsave(&g_tcbcache_lock);
+  if (g_ntcbcache < CONFIG_PTHREAD_TCB_CACHE)
+    {
+      tcb->flink = g_tcbcache;
+      g_tcbcache = tcb;
+      g_ntcbcache++;
+      cached = true;
+    }
+
+  spin_unlock_irqrestore(&g_tcbcache_lock, flags);
+  return cached;
+}
+
+#endif /* CONFIG_PTHREAD_TCB_CACHE > 0 */
@@ -36,8 +36,13 @@
 #include <nuttx/arch.h>
 #include <nuttx/queue.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/seqlock.h>
 #include <nuttx/spinlock.h>
 
+#ifdef CONFIG_SCHED_DEADLINE
+#  include <nuttx/hrtimer.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -119,6 +124,33 @@
 #  define CRITMONITOR_PANIC(fmt, ...) _alert(fmt, ##__VA_ARGS__)
 #endif
 
+/* Threads with the SCHED_DEADLINE policy and the same priority are ordered
+ * by their absolute deadline (earliest deadline first) in every prioritized
+ * task list.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define nxsched_is_deadline(t) \
+     (((t)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+#  define nxsched_deadline_before(a, b) \
+     (nxsched_is_deadline(a) && nxsched_is_deadline(b) && \
+      (int64_t)((a)->deadline->abs_deadline - \
+                (b)->deadline->abs_deadline) < 0)
+#else
+#  define nxsched_deadline_before(a, b) false
+#endif
+
+/* The slack of the timed waits of a thread, in clock ticks or nanoseconds */
+
+#ifdef CONFIG_TIMER_SLACK
+#  define nxsched_timer_slack(t) \
+     ((clock_t)((t)->timer_slack / NSEC_PER_TICK))
+#  define nxsched_timer_slack_nsec(t) ((uint64_t)(t)->timer_slack)
+#else
+#  define nxsched_timer_slack(t) ((clock_t)0)
+#  define nxsched_timer_slack_nsec(t) ((uint64_t)0)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -144,6 +176,29 @@ enum task_deliver_e
                       */
 };
 
+#ifdef CONFIG_SCHED_DEADLINE
+/* This structure is the SCHED_DEADLINE "plug-in" to the TCB.  It is
+ * allocated when the deadline scheduling policy is assigned to a thread.
+ * All times are in nanoseconds of the hrtimer time base.
+ */
+
+struct deadline_s
+{
+  sq_entry_t node;                      /* Link while waiting to be freed */
+  FAR struct tcb_s *tcb;                /* The parent TCB, NULL if retired */
+  hrtimer_t period_timer;               /* Starts the next period */
+  hrtimer_t budget_timer;               /* Fires when the budget runs out */
+  uint64_t  runtime;                    /* Runtime budget per period */
+  uint64_t  rel_deadline;               /* Deadline relative to the period */
+  uint64_t  period;                     /* Period */
+  uint64_t  abs_deadline;               /* Deadline of the current period */
+  uint64_t  budget;                     /* Budget left in this period */
+  uint64_t  eventtime;                  /* Time the thread was resumed */
+  uint32_t  bandwidth;                  /* runtime / period, fixed point */
+  bool      throttled;                  /* Budget exhausted */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -244,10 +299,15 @@ extern volatile pid_t g_lastpid;
  * 1. This hash table greatly speeds the determination of a new unique
  *    process ID for a task, and
  * 2. Is used to quickly map a process ID into a TCB.
+ *
+ * It is modified in a critical section.  g_pidhash_seq is updated around
+ * the replacement of the table by a larger one, so that nxsched_get_tcb()
+ * can read it without any lock.
  */
 
 extern FAR struct tcb_s **g_pidhash;
 extern volatile int g_npidhash;
+extern seqcount_t g_pidhash_seq;
 
 /* This is a table of task lists.  This table is indexed by the task stat
  * enumeration type (tstate_t) and provides a pointer to the associated
@@ -330,6 +390,33 @@ bool nxsched_merge_pending(void);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 #endif
 
+/* Ready-to-run list insertion and removal */
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool nxsched_rtr_add(FAR struct tcb_s *tcb);
+void nxsched_rtr_remove(FAR struct tcb_s *tcb);
+void nxsched_rtr_setpriority(FAR struct tcb_s *tcb, int sched_priority);
+#else
+#  define nxsched_rtr_add(t) \
+     nxsched_add_prioritized(t, list_readytorun())
+#  define nxsched_rtr_remove(t) \
+     dq_rem((FAR dq_entry_t *)(t), list_readytorun())
+#  define nxsched_rtr_setpriority(t, p) \
+     ((t)->sched_priority = (uint8_t)(p))
+#endif
+
+/* SMP work stealing */
+
+#ifdef CONFIG_SCHED_SMP_BALANCE
+void nxsched_balance_migrate(FAR struct tcb_s *tcb, int cpu);
+void nxsched_balance_kick(FAR struct tcb_s *tcb);
+void nxsched_balance_idle(void);
+#else
+#  define nxsched_balance_migrate(t, c)
+#  define nxsched_balance_kick(t)
+#  define nxsched_balance_idle()
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -366,10 +453,22 @@ clock_t nxsched_process_sporadic(FAR struct tcb_s *tcb, clock_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb, uint64_t runtime,
+                            uint64_t deadline, uint64_t period);
+int  nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_resume_deadline(FAR struct tcb_s *tcb);
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_LAZYFPU
+void nxsched_switch_fpu(FAR struct tcb_s *from, FAR struct tcb_s *to);
+#endif
+
 #if defined(up_this_task)
 #  define this_task()            up_this_task()
 #elif !defined(CONFIG_SMP)
@@ -424,6 +523,12 @@ void nxsched_process_cpuload_ticks(clock_t ticks);
 #define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+/* Pressure stall information */
+
+#ifdef CONFIG_SCHED_PRESSURE
+void nxsched_process_pressure(void);
+#endif
+
 /* Critical section monitor */
 
 void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to);
@@ -445,6 +550,12 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+void nxsched_critmon_wakeup(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_critmon_wakeup(t)
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
@@ -472,11 +583,14 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
   /* Search the list to find the location to insert the new Tcb.
-   * Each is list is maintained in descending sched_priority order.
+   * Each is list is maintained in descending sched_priority order and,
+   * within one priority, SCHED_DEADLINE threads by earliest deadline.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && (sched_priority < next->sched_priority ||
+                 (sched_priority == next->sched_priority &&
+                  !nxsched_deadline_before(tcb, next))));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
@@ -78,7 +78,9 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    */
 
   if (nxsched_islocked_tcb(rtcb) &&
-      rtcb->sched_priority < btcb->sched_priority)
+      (rtcb->sched_priority < btcb->sched_priority ||
+       (rtcb->sched_priority == btcb->sched_priority &&
+        nxsched_deadline_before(btcb, rtcb))))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -91,7 +93,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
 
   /* Otherwise, add the new task to the ready-to-run task list */
 
-  else if (nxsched_add_prioritized(btcb, list_readytorun()))
+  else if (nxsched_rtr_add(btcb))
     {
       /* The new btcb was added at the head of the ready-to-run list.  It
        * is now the new active task!
@@ -188,14 +190,18 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
         {
           /* Found a task, remove it from ready-to-run list */
 
-          dq_rem((FAR struct dq_entry_s *)btcb, list_readytorun());
+          nxsched_rtr_remove(btcb);
 
           if (!is_idle_task(rtcb))
             {
               /* Put currently running task back to ready-to-run list */
 
               rtcb->task_state = TSTATE_TASK_READYTORUN;
-              nxsched_add_prioritized(rtcb, list_readytorun());
+              nxsched_rtr_add(rtcb);
+
+              /* Let an idle CPU pick it up rather than leave it waiting */
+
+              nxsched_balance_kick(rtcb);
             }
           else
             {
@@ -205,6 +211,7 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
           g_assignedtasks[cpu] = btcb;
           up_update_task(btcb);
 
+          nxsched_balance_migrate(btcb, cpu);
           btcb->cpu = cpu;
           btcb->task_state = TSTATE_TASK_RUNNING;
           ret = true;
@@ -262,7 +269,7 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_READYTORUN;
-  nxsched_add_prioritized(btcb, list_readytorun());
+  nxsched_rtr_add(btcb);
 
   /* In some cases, such as setaffinity, cpu need to be used. */
 
@@ -272,6 +279,14 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
       doswitch = nxsched_deliver_task(this_cpu(), target_cpu,
                                       SWITCH_HIGHER);
     }
+  else if (tcb->sched_priority == btcb->sched_priority &&
+           nxsched_deadline_before(btcb, tcb))
+    {
+      /* An earlier deadline preempts a deadline thread of equal priority */
+
+      doswitch = nxsched_deliver_task(this_cpu(), target_cpu,
+                                      SWITCH_EQUAL);
+    }
 
   return doswitch;
 }
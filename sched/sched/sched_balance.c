@@ -0,0 +1,244 @@
+/****************************************************************************
+ * sched/sched/sched_balance.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Number of tasks that started running on a CPU other than the one they
+ * were queued for, counted on both sides of the migration.
+ */
+
+uint32_t g_migrate_in[CONFIG_SMP_NCPUS];
+uint32_t g_migrate_out[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_balance_eligible
+ *
+ * Description:
+ *   Return true if the ready-to-run task may be run by the given CPU.  This
+ *   uses the same rules as nxsched_switch_running().
+ *
+ ****************************************************************************/
+
+static bool nxsched_balance_eligible(FAR struct tcb_s *tcb, int cpu)
+{
+  return CPU_ISSET(cpu, &tcb->affinity) &&
+         ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || tcb->cpu == cpu);
+}
+
+/****************************************************************************
+ * Name: nxsched_balance_pick
+ *
+ * Description:
+ *   Select the ready-to-run task that an idle CPU should steal.  Strict
+ *   priority order is kept: only tasks of the highest eligible priority
+ *   are candidates.  Among those, the task queued for the most loaded CPU
+ *   is taken, the load of a CPU being its running task plus the number of
+ *   ready-to-run tasks queued for it.
+ *
+ * Input Parameters:
+ *   cpu - The idle CPU
+ *
+ * Returned Value:
+ *   The selected TCB, still linked in the ready-to-run list, or NULL if
+ *   there is no task that the CPU may run.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *nxsched_balance_pick(int cpu)
+{
+  unsigned int load[CONFIG_SMP_NCPUS];
+  FAR struct tcb_s *btcb = NULL;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      load[i] = is_idle_task(current_task(i)) ? 0 : 1;
+    }
+
+  for (tcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+       tcb != NULL; tcb = tcb->flink)
+    {
+      load[tcb->cpu]++;
+    }
+
+  for (tcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+       tcb != NULL; tcb = tcb->flink)
+    {
+      if (btcb != NULL && tcb->sched_priority < btcb->sched_priority)
+        {
+          break;
+        }
+
+      if (nxsched_balance_eligible(tcb, cpu) &&
+          (btcb == NULL || load[tcb->cpu] > load[btcb->cpu]))
+        {
+          btcb = tcb;
+        }
+    }
+
+  return btcb;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_balance_migrate
+ *
+ * Description:
+ *   Account for a ready-to-run task that is about to start running on the
+ *   given CPU.  This must be called before tcb->cpu is updated.
+ *
+ * Input Parameters:
+ *   tcb - The TCB about to run
+ *   cpu - The CPU that will run it
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_balance_migrate(FAR struct tcb_s *tcb, int cpu)
+{
+  if (tcb->cpu != cpu)
+    {
+      g_migrate_out[tcb->cpu]++;
+      g_migrate_in[cpu]++;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_balance_kick
+ *
+ * Description:
+ *   A running task has just been preempted and parked in the ready-to-run
+ *   list.  If another CPU that may run it is executing its IDLE task, ask
+ *   that CPU to reschedule so that it pulls the task instead of leaving it
+ *   waiting for its original CPU.
+ *
+ * Input Parameters:
+ *   tcb - The TCB that was put back in the ready-to-run list
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_balance_kick(FAR struct tcb_s *tcb)
+{
+  int me = this_cpu();
+  int cpu;
+
+  if ((tcb->flags & TCB_FLAG_CPU_LOCKED) != 0)
+    {
+      return;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me && CPU_ISSET(cpu, &tcb->affinity) &&
+          is_idle_task(current_task(cpu)))
+        {
+          nxsched_deliver_task(me, cpu, SWITCH_HIGHER);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_balance_idle
+ *
+ * Description:
+ *   Called from the IDLE loop of every CPU.  If the CPU is still idle and
+ *   there is ready-to-run work that it may execute, steal it (see
+ *   nxsched_balance_pick()) and switch to it.
+ *
+ * Assumptions:
+ *   Called by the IDLE task, with pre-emption enabled.
+ *
+ ****************************************************************************/
+
+void nxsched_balance_idle(void)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
+  int cpu;
+
+  /* Unlocked peek: the list is checked again in the critical section */
+
+  if (dq_peek(list_readytorun()) == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  cpu  = this_cpu();
+  rtcb = current_task(cpu);
+
+  if (is_idle_task(rtcb) && !nxsched_islocked_tcb(rtcb))
+    {
+      btcb = nxsched_balance_pick(cpu);
+      if (btcb != NULL)
+        {
+          nxsched_rtr_remove(btcb);
+
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+          g_assignedtasks[cpu] = btcb;
+          up_update_task(btcb);
+
+          nxsched_balance_migrate(btcb, cpu);
+          btcb->cpu = cpu;
+          btcb->task_state = TSTATE_TASK_RUNNING;
+
+          up_switch_context(this_task(), rtcb);
+        }
+    }
+
+  leave_critical_section(flags);
+}
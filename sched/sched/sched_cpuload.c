@@ -198,6 +198,10 @@ void nxsched_process_cpuload_ticks(clock_t ticks)
       FAR struct tcb_s *rtcb = current_task(i);
       nxsched_process_taskload_ticks(rtcb, ticks);
     }
+
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_process_pressure();
+#endif
 }
 
 /****************************************************************************
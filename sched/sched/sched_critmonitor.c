@@ -26,12 +26,15 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sched.h>
 #include <assert.h>
 #include <debug.h>
 #include <time.h>
 
+#include <nuttx/sched_note.h>
+
 #include "sched/sched.h"
 
 /****************************************************************************
@@ -110,6 +113,12 @@
 static spinlock_t g_crimonitor_lock = SP_UNLOCKED;
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+/* Upper limits of the histogram buckets in perf counts */
+
+static clock_t g_wakeup_limit[CRITMON_WAKEUP_NBUCKETS - 1];
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -129,10 +138,154 @@ clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif
 
+/* Code locations holding the critical section the longest. */
+
+#if CONFIG_SCHED_CRITMONITOR_HOLDERS > 0
+struct critmon_holder_s g_crit_holders[CONFIG_SCHED_CRITMONITOR_HOLDERS];
+#endif
+
+/* Wakeup-to-run latency by priority band and the worst wakeup. */
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+uint32_t g_wakeup_hist[CRITMON_WAKEUP_NBANDS][CRITMON_WAKEUP_NBUCKETS];
+struct critmon_wakeup_s g_wakeup_worst;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxsched_critmon_holder
+ *
+ * Description:
+ *   Account one critical section holding interval to its caller.  If the
+ *   caller is not ranked yet, it replaces the entry with the smallest
+ *   maximum, provided it held the section longer.
+ *
+ * Assumptions:
+ *   - Called within the critical section, which serializes the updates.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_HOLDERS > 0
+static void nxsched_critmon_holder(FAR void *caller, clock_t elapsed)
+{
+  FAR struct critmon_holder_s *holder = &g_crit_holders[0];
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_HOLDERS; i++)
+    {
+      if (g_crit_holders[i].caller == caller)
+        {
+          holder = &g_crit_holders[i];
+          break;
+        }
+
+      if (g_crit_holders[i].max < holder->max)
+        {
+          holder = &g_crit_holders[i];
+        }
+    }
+
+  if (holder->caller != caller)
+    {
+      if (holder->caller != NULL && elapsed <= holder->max)
+        {
+          return;
+        }
+
+      holder->caller = caller;
+      holder->max    = 0;
+      holder->total  = 0;
+      holder->count  = 0;
+    }
+
+  if (elapsed > holder->max)
+    {
+      holder->max = elapsed;
+    }
+
+  holder->total += elapsed;
+  holder->count++;
+}
+#else
+#  define nxsched_critmon_holder(caller, elapsed)
+#endif
+
+/****************************************************************************
+ * Name: nxsched_critmon_latency
+ *
+ * Description:
+ *   Account the wakeup-to-run latency of a thread that is switched in.
+ *
+ * Input Parameters:
+ *   from    - The thread that ran until now.
+ *   to      - The thread woken up.
+ *   elapsed - The time since the wakeup in perf counts.
+ *
+ * Assumptions:
+ *   - Called within the critical section, which serializes the updates.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+static void nxsched_critmon_latency(FAR struct tcb_s *from,
+                                    FAR struct tcb_s *to, clock_t elapsed)
+{
+  int band;
+  int i;
+
+  if (g_wakeup_limit[0] == 0)
+    {
+      uint64_t freq = perf_getfreq();
+
+      for (i = 0; i < CRITMON_WAKEUP_NBUCKETS - 1; i++)
+        {
+          g_wakeup_limit[i] = MAX((clock_t)((freq << i) / 1000000), 1);
+        }
+    }
+
+  for (i = 0; i < CRITMON_WAKEUP_NBUCKETS - 1; i++)
+    {
+      if (elapsed < g_wakeup_limit[i])
+        {
+          break;
+        }
+    }
+
+  band = to->sched_priority * CRITMON_WAKEUP_NBANDS /
+         (SCHED_PRIORITY_MAX + 1);
+
+  to->wakeup_hist[i]++;
+  if (elapsed > to->wakeup_max)
+    {
+      to->wakeup_max = elapsed;
+    }
+
+  g_wakeup_hist[band][i]++;
+  if (elapsed <= g_wakeup_worst.latency)
+    {
+      return;
+    }
+
+  g_wakeup_worst.latency  = elapsed;
+  g_wakeup_worst.pid      = to->pid;
+  g_wakeup_worst.priority = to->sched_priority;
+  g_wakeup_worst.holder   = from->pid;
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0
+  g_wakeup_worst.csection = from->crit_caller;
+#endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
+  g_wakeup_worst.preemption = from->preemp_caller;
+#endif
+
+  sched_note_printf(NOTE_TAG_SCHED,
+                    "worst wakeup pid %d latency %lu holder %d",
+                    to->pid, (unsigned long)elapsed, from->pid);
+}
+#endif
+
 /****************************************************************************
  * Name: nxsched_critmon_cpuload
  *
@@ -291,6 +444,8 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
         {
           g_crit_max[cpu] = elapsed;
         }
+
+      nxsched_critmon_holder(tcb->crit_caller, elapsed);
     }
 }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
@@ -377,9 +532,19 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
   nxsched_critmon_cpuload(from, current, tick);
 #endif
 
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+  /* Was the new thread just woken up? */
+
+  if (to->wakeup_start != 0)
+    {
+      nxsched_critmon_latency(from, to, current - to->wakeup_start);
+      to->wakeup_start = 0;
+    }
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
   from->run_time += elapsed;
-  to->run_time = current;
+  to->run_start = current;
   if (elapsed > from->run_max)
     {
       from->run_max = elapsed;
@@ -417,7 +582,7 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
 
   if (to->lockcount > 0)
     {
-      to->premp_start = current;
+      to->preemp_start = current;
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 
@@ -445,6 +610,8 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
         {
           g_crit_max[cpu] = elapsed;
         }
+
+      nxsched_critmon_holder(from->crit_caller, elapsed);
     }
 
   if (to->irqcount > 0)
@@ -462,11 +629,27 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to)
     {
       /* Yes.. Save the start time */
 
-      to->premp_start = current;
+      to->preemp_start = current;
     }
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION */
 }
 
+/****************************************************************************
+ * Name: nxsched_critmon_wakeup
+ *
+ * Description:
+ *   Called when a blocked thread is released, the latency is accounted
+ *   when it is switched in.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_WAKEUP
+void nxsched_critmon_wakeup(FAR struct tcb_s *tcb)
+{
+  tcb->wakeup_start = perf_gettime();
+}
+#endif
+
 void nxsched_update_critmon(FAR struct tcb_s *tcb)
 {
   clock_t current = perf_gettime();
@@ -0,0 +1,525 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidths (runtime / period) are accounted in 1 / 2^20 of a CPU */
+
+#define DEADLINE_BW_SHIFT   20
+#define DEADLINE_BW_LIMIT \
+  ((uint32_t)(((uint64_t)CONFIG_SCHED_DEADLINE_BANDWIDTH * \
+               CONFIG_SMP_NCPUS << DEADLINE_BW_SHIFT) / 100))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of the bandwidths of all admitted deadline threads */
+
+static uint32_t g_deadline_bw;
+
+/* Deadline structures whose timer callback was still running on another
+ * CPU when the thread left the policy.  They cannot be waited for in the
+ * critical section (the callback needs it), so they are released by the
+ * next nxsched_start_deadline() instead.
+ */
+
+static sq_queue_t g_deadline_retired;
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint64_t deadline_budget_expire(FAR const hrtimer_t *hrtimer,
+                                       uint64_t expired);
+static uint64_t deadline_period_expire(FAR const hrtimer_t *hrtimer,
+                                       uint64_t expired);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: deadline_set_priority
+ *
+ * Description:
+ *   Move the thread to a new priority.  If the priority does not change,
+ *   the thread is repositioned according to its (new) absolute deadline.
+ *
+ * Input Parameters:
+ *   tcb      - TCB of the deadline thread
+ *   priority - CONFIG_SCHED_DEADLINE_PRIORITY or SCHED_PRIORITY_MIN
+ *
+ ****************************************************************************/
+
+static void deadline_set_priority(FAR struct tcb_s *tcb, int priority)
+{
+  FAR struct tcb_s *nxttcb;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* If the priority is boosted by priority inheritance, just change the
+   * priority that the thread will return to.
+   */
+
+  if (tcb->sched_priority > tcb->base_priority &&
+      tcb->sched_priority >= priority)
+    {
+      tcb->base_priority = priority;
+      return;
+    }
+#endif
+
+  /* A running thread that keeps its priority is only switched out if a
+   * ready-to-run deadline thread now has an earlier deadline.  Setting the
+   * same priority would otherwise yield to any peer.
+   */
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING &&
+      tcb->sched_priority == priority)
+    {
+#ifdef CONFIG_SMP
+      nxttcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+#else
+      nxttcb = tcb->flink;
+#endif
+
+      if (nxttcb == NULL || nxttcb->sched_priority != priority ||
+          !nxsched_deadline_before(nxttcb, tcb))
+        {
+          return;
+        }
+    }
+
+  nxsched_reprioritize(tcb, priority);
+}
+
+/****************************************************************************
+ * Name: deadline_charge
+ *
+ * Description:
+ *   Charge the time the thread ran since dl->eventtime to its budget.
+ *
+ ****************************************************************************/
+
+static void deadline_charge(FAR struct deadline_s *dl, uint64_t now)
+{
+  uint64_t elapsed = now - dl->eventtime;
+
+  dl->budget    = elapsed < dl->budget ? dl->budget - elapsed : 0;
+  dl->eventtime = now;
+}
+
+/****************************************************************************
+ * Name: deadline_reap
+ *
+ * Description:
+ *   Free the retired deadline structures once their timer callbacks have
+ *   completed.
+ *
+ ****************************************************************************/
+
+static void deadline_reap(void)
+{
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      dl = (FAR struct deadline_s *)sq_remfirst(&g_deadline_retired);
+      leave_critical_section(flags);
+
+      if (dl == NULL)
+        {
+          break;
+        }
+
+      hrtimer_cancel_sync(&dl->period_timer);
+      hrtimer_cancel_sync(&dl->budget_timer);
+      kmm_free(dl);
+    }
+}
+
+/****************************************************************************
+ * Name: deadline_budget_expire
+ *
+ * Description:
+ *   The running thread consumed its budget for the current period:
+ *   throttle it to the lowest priority until its next period begins.
+ *
+ ****************************************************************************/
+
+static uint64_t deadline_budget_expire(FAR const hrtimer_t *hrtimer,
+                                       uint64_t expired)
+{
+  FAR struct deadline_s *dl =
+    container_of(hrtimer, struct deadline_s, budget_timer);
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* Nothing to do if the thread left the policy or was switched out (its
+   * budget was charged when it was suspended).
+   */
+
+  tcb = dl->tcb;
+  if (tcb != NULL && !dl->throttled &&
+      tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      deadline_charge(dl, clock_systime_nsec());
+      if (dl->budget > 0)
+        {
+          /* Woken up a little early */
+
+          hrtimer_start(&dl->budget_timer, deadline_budget_expire,
+                        dl->budget, HRTIMER_MODE_REL);
+        }
+      else
+        {
+          dl->throttled = true;
+          deadline_set_priority(tcb, SCHED_PRIORITY_MIN);
+        }
+    }
+
+  leave_critical_section(flags);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: deadline_period_expire
+ *
+ * Description:
+ *   A new period begins: replenish the budget, move the absolute deadline
+ *   and return the thread to the deadline priority.
+ *
+ ****************************************************************************/
+
+static uint64_t deadline_period_expire(FAR const hrtimer_t *hrtimer,
+                                       uint64_t expired)
+{
+  FAR struct deadline_s *dl =
+    container_of(hrtimer, struct deadline_s, period_timer);
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  uint64_t period = 0;
+
+  flags = enter_critical_section();
+
+  tcb = dl->tcb;
+  if (tcb != NULL)
+    {
+      dl->abs_deadline = expired + dl->rel_deadline;
+      dl->budget       = dl->runtime;
+      dl->throttled    = false;
+
+      if (tcb->task_state == TSTATE_TASK_RUNNING)
+        {
+          dl->eventtime = clock_systime_nsec();
+          hrtimer_start(&dl->budget_timer, deadline_budget_expire,
+                        dl->budget, HRTIMER_MODE_REL);
+        }
+
+      deadline_set_priority(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+      period = dl->period;
+    }
+
+  leave_critical_section(flags);
+  return period;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Switch a thread to the SCHED_DEADLINE policy, or change the parameters
+ *   of a thread that already uses it.  The first period starts now.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the thread
+ *   runtime  - Execution budget per period in nanoseconds
+ *   deadline - Deadline relative to the start of each period
+ *   period   - Period in nanoseconds, zero to use the deadline
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure:
+ *
+ *   EINVAL The parameters do not satisfy runtime <= deadline <= period.
+ *   EBUSY  Admitting the thread would exceed the bandwidth limit.
+ *   ENOMEM The deadline state could not be allocated.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb, uint64_t runtime,
+                           uint64_t deadline, uint64_t period)
+{
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+  uint32_t oldbw = 0;
+  uint32_t bw;
+  uint64_t now;
+
+  DEBUGASSERT(tcb != NULL && !is_idle_task(tcb));
+
+  if (period == 0)
+    {
+      period = deadline;
+    }
+
+  if (runtime == 0 || runtime > deadline || deadline > period ||
+      runtime > (UINT64_MAX >> DEADLINE_BW_SHIFT) ||
+      period > HRTIMER_MAX_DELAY)
+    {
+      return -EINVAL;
+    }
+
+  bw = (uint32_t)((runtime << DEADLINE_BW_SHIFT) / period);
+  if (bw == 0)
+    {
+      bw = 1;
+    }
+
+  /* Release what is left over from threads that left the policy */
+
+  deadline_reap();
+
+  dl = kmm_zalloc(sizeof(struct deadline_s));
+  if (dl == NULL)
+    {
+      serr("ERROR: Failed to allocate deadline data structure\n");
+      return -ENOMEM;
+    }
+
+  flags = enter_critical_section();
+
+  if (nxsched_is_deadline(tcb))
+    {
+      oldbw = tcb->deadline->bandwidth;
+    }
+
+  /* Admission control */
+
+  if (g_deadline_bw - oldbw + bw > DEADLINE_BW_LIMIT)
+    {
+      leave_critical_section(flags);
+      kmm_free(dl);
+      return -EBUSY;
+    }
+
+  if (nxsched_is_deadline(tcb))
+    {
+      /* Changing the parameters: drop the old state and start over */
+
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#ifdef CONFIG_SCHED_SPORADIC
+  else if ((tcb->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_SPORADIC)
+    {
+      DEBUGVERIFY(nxsched_stop_sporadic(tcb));
+    }
+#endif
+
+  g_deadline_bw   += bw;
+
+  now              = clock_systime_nsec();
+  dl->tcb          = tcb;
+  dl->runtime      = runtime;
+  dl->rel_deadline = deadline;
+  dl->period       = period;
+  dl->abs_deadline = now + deadline;
+  dl->budget       = runtime;
+  dl->eventtime    = now;
+  dl->bandwidth    = bw;
+
+  tcb->deadline    = dl;
+  tcb->flags       = (tcb->flags & ~TCB_FLAG_POLICY_MASK) |
+                     TCB_FLAG_SCHED_DEADLINE;
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+  tcb->timeslice   = 0;
+#endif
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      hrtimer_start(&dl->budget_timer, deadline_budget_expire,
+                    runtime, HRTIMER_MODE_REL);
+    }
+
+  hrtimer_start(&dl->period_timer, deadline_period_expire,
+                now + period, HRTIMER_MODE_ABS);
+
+  /* An explicit policy change discards any priority inheritance boost */
+
+  nxsched_reprioritize(tcb, CONFIG_SCHED_DEADLINE_PRIORITY);
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Terminate deadline scheduling on a thread, release its bandwidth and
+ *   the resources associated with the policy.  The thread is left with the
+ *   SCHED_FIFO policy at its current priority.  This function is called:
+ *
+ *     - When any thread exits with deadline scheduling active.
+ *     - When a deadline thread is changed to another policy or to new
+ *       deadline parameters.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success or a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The thread is currently using the deadline scheduling policy.
+ *
+ ****************************************************************************/
+
+int nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl;
+  irqstate_t flags;
+  int busy;
+
+  DEBUGASSERT(tcb != NULL && nxsched_is_deadline(tcb) &&
+              tcb->deadline != NULL);
+
+  flags = enter_critical_section();
+
+  dl             = tcb->deadline;
+  dl->tcb        = NULL;
+  tcb->deadline  = NULL;
+  tcb->flags    &= ~TCB_FLAG_POLICY_MASK;
+  g_deadline_bw -= dl->bandwidth;
+
+  /* A callback running on another CPU will find dl->tcb == NULL and do
+   * nothing, but it still references the structure.
+   */
+
+  busy  = hrtimer_cancel(&dl->period_timer) > 0;
+  busy |= hrtimer_cancel(&dl->budget_timer) > 0;
+
+  if (busy)
+    {
+      sq_addlast(&dl->node, &g_deadline_retired);
+    }
+  else
+    {
+      kmm_free(dl);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_deadline
+ *
+ * Description:
+ *   Called when a deadline thread is switched in: start consuming its
+ *   budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_resume_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  dl->eventtime = clock_systime_nsec();
+  if (!dl->throttled)
+    {
+      hrtimer_start(&dl->budget_timer, deadline_budget_expire,
+                    dl->budget, HRTIMER_MODE_REL);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_deadline
+ *
+ * Description:
+ *   Called when a deadline thread is switched out: charge the time it ran
+ *   to its budget.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = tcb->deadline;
+
+  DEBUGASSERT(dl != NULL);
+
+  if (!dl->throttled)
+    {
+      hrtimer_cancel(&dl->budget_timer);
+      deadline_charge(dl, clock_systime_nsec());
+    }
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -94,6 +94,15 @@ int nxsched_get_scheduler(pid_t pid)
       policy = (tcb->flags & TCB_FLAG_POLICY_MASK) >> TCB_FLAG_POLICY_SHIFT;
 
       ret = policy + 1;
+
+#ifdef CONFIG_SCHED_DEADLINE
+      /* SCHED_DEADLINE does not follow the numbering of the others */
+
+      if (nxsched_is_deadline(tcb))
+        {
+          ret = SCHED_DEADLINE;
+        }
+#endif
     }
 
   return ret;
@@ -43,52 +43,52 @@
  *   Given a task ID, this function will return the a pointer to the
  *   corresponding TCB (or NULL if there is no such task ID).
  *
- *   NOTE:  This function holds a critical section while examining TCB data
- *   data structures but releases that critical section before returning.
- *   When it is released, the TCB may become unstable.  If the caller
- *   requires absolute stability while using the TCB, then the caller
- *   should establish the critical section BEFORE calling this function and
- *   hold that critical section as long as necessary.
+ *   NOTE:  This function takes no lock, so that lookups on different CPUs
+ *   do not serialize.  The TCB may become unstable as soon as it returns.
+ *   If the caller requires absolute stability while using the TCB, then
+ *   the caller should establish the critical section BEFORE calling this
+ *   function and hold that critical section as long as necessary.
  *
  ****************************************************************************/
 
 FAR struct tcb_s *nxsched_get_tcb(pid_t pid)
 {
-  FAR struct tcb_s *ret = NULL;
+  FAR struct tcb_s **pidhash;
+  FAR struct tcb_s *ret;
   irqstate_t flags;
-  int hash_ndx;
+  uint32_t seq;
+  int npidhash;
 
-  flags = enter_critical_section();
-
-  /* Verify whether g_pidhash hash table has already been allocated and
-   * whether the PID is within range.
-   */
-
-  if (g_pidhash != NULL && pid >= 0)
+  if (pid < 0)
     {
-      /* The test and the return setup should be atomic.  This still does
-       * not provide proper protection if the recipient of the TCB does not
-       * also protect against the task associated with the TCB from
-       * terminating asynchronously.
-       */
-
-      /* Get the hash_ndx associated with the pid */
-
-      hash_ndx = PIDHASH(pid);
+      return NULL;
+    }
 
-      /* Verify that the correct TCB was found. */
+  /* Disabling the local interrupts keeps the table from being freed under
+   * us, see nxtask_assign_pid().  The size and the table are only trusted
+   * together if the table was not replaced meanwhile.
+   */
 
-      if (g_pidhash[hash_ndx] != NULL && pid == g_pidhash[hash_ndx]->pid)
-        {
-          /* Return the TCB associated with this pid (if any) */
+  flags = up_irq_save();
 
-          ret = g_pidhash[hash_ndx];
-        }
+  do
+    {
+      seq      = read_seqbegin(&g_pidhash_seq);
+      npidhash = g_npidhash;
+      pidhash  = g_pidhash;
+      ret      = pidhash != NULL ? pidhash[pid & (npidhash - 1)] : NULL;
     }
+  while (read_seqretry(&g_pidhash_seq, seq));
 
-  leave_critical_section(flags);
+  /* Verify that the correct TCB was found.  A TCB released meanwhile is
+   * still readable, its pid was valid when the slot was read.
+   */
 
-  /* Return the TCB. */
+  if (ret != NULL && ret->pid != pid)
+    {
+      ret = NULL;
+    }
 
+  up_irq_restore(flags);
   return ret;
 }
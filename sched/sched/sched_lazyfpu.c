@@ -0,0 +1,158 @@
+/****************************************************************************
+ * sched/sched/sched_lazyfpu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The FPU of one CPU.  The architecture saves the state of a task that
+ * modified the FPU registers when the task is suspended, so the registers
+ * keep a valid copy of the owner's state until another task is loaded.
+ * fpu_cpu in the TCB tells whether the owner has run on another CPU since.
+ */
+
+struct nxsched_fpu_s
+{
+  FAR struct tcb_s *owner;    /* Task whose state is in the registers */
+  bool used;                  /* The running task has FPU access */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct nxsched_fpu_s g_fpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_fpu_load
+ *
+ * Description:
+ *   Load the state of a task into the FPU of this CPU.
+ *
+ ****************************************************************************/
+
+static void nxsched_fpu_load(FAR struct nxsched_fpu_s *fpu,
+                             FAR struct tcb_s *tcb, int cpu)
+{
+  up_fpu_restore(tcb);
+
+  tcb->fpu_cpu = cpu + 1;
+  fpu->owner   = tcb;
+  fpu->used    = true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_switch_fpu
+ *
+ * Description:
+ *   Give the resumed task FPU access if the registers still hold its
+ *   state, load its state now if it used the FPU in each of its last
+ *   CONFIG_SCHED_LAZYFPU_EAGER slices, or let its first FPU instruction
+ *   trap otherwise.
+ *
+ * Input Parameters:
+ *   from - The TCB of the task to be suspended.
+ *   to   - The TCB of the task to be resumed.
+ *
+ ****************************************************************************/
+
+void nxsched_switch_fpu(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+  int cpu = this_cpu();
+  FAR struct nxsched_fpu_s *fpu = &g_fpu[cpu];
+
+  /* A task that ran a whole slice without the FPU starts over */
+
+  if (!fpu->used)
+    {
+      from->fpu_count = 0;
+    }
+
+  fpu->used = false;
+
+  if (fpu->owner == to && to->fpu_cpu == cpu + 1)
+    {
+      up_fpu_access(to, true);
+      fpu->used = true;
+    }
+  else if (to->fpu_count >= CONFIG_SCHED_LAZYFPU_EAGER)
+    {
+      /* The count wraps around once in a while, so that a task which
+       * stopped using the FPU goes back to the trap.
+       */
+
+      to->fpu_count++;
+      nxsched_fpu_load(fpu, to, cpu);
+    }
+  else
+    {
+      up_fpu_access(to, false);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_fpu_trap
+ *
+ * Description:
+ *   Give the FPU to the running task on its first FPU instruction.
+ *
+ ****************************************************************************/
+
+bool nxsched_fpu_trap(FAR struct tcb_s *tcb)
+{
+  int cpu = this_cpu();
+  FAR struct nxsched_fpu_s *fpu = &g_fpu[cpu];
+
+  if (fpu->used && fpu->owner == tcb)
+    {
+      return false;
+    }
+
+  if (tcb->fpu_count < UINT8_MAX)
+    {
+      tcb->fpu_count++;
+    }
+
+  nxsched_fpu_load(fpu, tcb, cpu);
+  return true;
+}
@@ -80,6 +80,32 @@ bool nxsched_merge_pending(void)
 
   if (!nxsched_islocked_tcb(rtcb))
     {
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      /* The ready-to-run index finds each insertion point directly */
+
+      for (ptcb = (FAR struct tcb_s *)list_pendingtasks()->head;
+           ptcb;
+           ptcb = pnext)
+        {
+          pnext = ptcb->flink;
+
+          if (nxsched_rtr_add(ptcb))
+            {
+              /* Inserted at the head, ptcb becomes the running task */
+
+              ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state        = TSTATE_TASK_RUNNING;
+              up_update_task(ptcb);
+              ret                     = true;
+            }
+          else
+            {
+              ptcb->task_state        = TSTATE_TASK_READYTORUN;
+            }
+        }
+
+      UNUSED(rprev);
+#else
       for (ptcb = (FAR struct tcb_s *)list_pendingtasks()->head;
            ptcb;
            ptcb = pnext)
@@ -96,7 +122,9 @@ bool nxsched_merge_pending(void)
            */
 
           for (;
-               (ptcb->sched_priority <= rtcb->sched_priority);
+               (ptcb->sched_priority < rtcb->sched_priority ||
+                (ptcb->sched_priority == rtcb->sched_priority &&
+                 !nxsched_deadline_before(ptcb, rtcb)));
                rtcb = rtcb->flink)
             {
             }
@@ -141,6 +169,7 @@ bool nxsched_merge_pending(void)
 
           rtcb = ptcb;
         }
+#endif
 
       /* Mark the input list empty */
 
@@ -0,0 +1,339 @@
+/****************************************************************************
+ * sched/sched/sched_pressure.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The averages are updated every two seconds as exponentially decaying
+ * averages of the stall share in the period, with 11 bits of fraction.
+ * The factors are exp(-2/10), exp(-2/60) and exp(-2/300).
+ */
+
+#define PRESSURE_PERIOD   SEC2TICK(2)
+#define PRESSURE_FSHIFT   11
+#define PRESSURE_FIXED_1  (1 << PRESSURE_FSHIFT)
+#define PRESSURE_EXP_10   1677
+#define PRESSURE_EXP_60   1981
+#define PRESSURE_EXP_300  2034
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pressure_state_s
+{
+  clock_t  stall;                 /* Total stall ticks */
+  clock_t  last;                  /* stall at the start of the period */
+  uint32_t avg[3];                /* Fixed point percent */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pressure_state_s g_pressure[PRESSURE_NSTATES];
+static spinlock_t g_pressure_lock = SP_UNLOCKED;
+static uint16_t g_pressure_niowait;
+static clock_t g_pressure_sample;
+static clock_t g_pressure_period;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t pressure_decay(uint32_t avg, uint32_t exp, uint32_t pct)
+{
+  uint32_t newavg = avg * exp + pct * (PRESSURE_FIXED_1 - exp);
+
+  if (pct >= avg)
+    {
+      newavg += PRESSURE_FIXED_1 - 1;
+    }
+
+  return newavg >> PRESSURE_FSHIFT;
+}
+
+static void pressure_update_avgs(clock_t now)
+{
+  clock_t period = now - g_pressure_period;
+  uint32_t pct;
+  int i;
+
+  g_pressure_period = now;
+  for (i = 0; i < PRESSURE_NSTATES; i++)
+    {
+      FAR struct pressure_state_s *state = &g_pressure[i];
+
+      pct = (uint32_t)((uint64_t)(state->stall - state->last) * 100 *
+                       PRESSURE_FIXED_1 / period);
+      state->last   = state->stall;
+      state->avg[0] = pressure_decay(state->avg[0], PRESSURE_EXP_10, pct);
+      state->avg[1] = pressure_decay(state->avg[1], PRESSURE_EXP_60, pct);
+      state->avg[2] = pressure_decay(state->avg[2], PRESSURE_EXP_300, pct);
+    }
+}
+
+/* Charge a task that is ready to run but not running to its group, once
+ * per sample no matter how many members are waiting.
+ */
+
+static bool pressure_charge_queue(FAR dq_queue_t *queue, clock_t now,
+                                  clock_t elapsed)
+{
+  FAR struct task_group_s *group;
+  FAR dq_entry_t *entry;
+  FAR struct tcb_s *tcb;
+  bool stalled = false;
+
+  for (entry = dq_peek(queue); entry != NULL; entry = dq_next(entry))
+    {
+      tcb = (FAR struct tcb_s *)entry;
+
+#ifndef CONFIG_SMP
+      /* The head of the ready-to-run list is the running task */
+
+      if (tcb == this_task())
+        {
+          continue;
+        }
+#endif
+
+      if (is_idle_task(tcb) || tcb->group == NULL)
+        {
+          continue;
+        }
+
+      stalled = true;
+      group   = tcb->group;
+      if (group->tg_cpustamp != now)
+        {
+          group->tg_cpustamp  = now;
+          group->tg_cpustall += elapsed;
+        }
+    }
+
+  return stalled;
+}
+
+static uint32_t pressure_percent(uint32_t avg)
+{
+  return (uint32_t)(((uint64_t)avg * 100) >> PRESSURE_FSHIFT);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_process_pressure
+ *
+ * Description:
+ *   Sample the CPU and I/O stall states.  The time since the previous
+ *   sample is attributed to the states observed now.
+ *
+ * Assumptions:
+ *   Called from nxsched_process_cpuload_ticks() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_process_pressure(void)
+{
+#ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
+  uint64_t total[PRESSURE_NSTATES];
+#endif
+  clock_t now = clock_systime_ticks();
+  clock_t elapsed;
+  irqstate_t flags;
+  bool cpusome;
+  bool iofull;
+  int i;
+
+  /* The critical section keeps the task lists stable */
+
+  flags = enter_critical_section();
+  spin_lock(&g_pressure_lock);
+
+  elapsed = now - g_pressure_sample;
+  g_pressure_sample = now;
+
+  cpusome = pressure_charge_queue(list_readytorun(), now, elapsed);
+#ifndef CONFIG_SMP
+  cpusome |= pressure_charge_queue(list_pendingtasks(), now, elapsed);
+#endif
+
+  iofull = g_pressure_niowait > 0;
+  for (i = 0; iofull && i < CONFIG_SMP_NCPUS; i++)
+    {
+      iofull = is_idle_task(current_task(i));
+    }
+
+  if (cpusome)
+    {
+      g_pressure[PRESSURE_CPU_SOME].stall += elapsed;
+    }
+
+  if (g_pressure_niowait > 0)
+    {
+      g_pressure[PRESSURE_IO_SOME].stall += elapsed;
+    }
+
+  if (iofull)
+    {
+      g_pressure[PRESSURE_IO_FULL].stall += elapsed;
+    }
+
+  if (now - g_pressure_period >= PRESSURE_PERIOD)
+    {
+      pressure_update_avgs(now);
+    }
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
+  /* Hand the totals over to the /proc/pressure triggers */
+
+  for (i = 0; i < PRESSURE_NSTATES; i++)
+    {
+      total[i] = TICK2USEC((uint64_t)g_pressure[i].stall);
+    }
+#endif
+
+  spin_unlock(&g_pressure_lock);
+  leave_critical_section(flags);
+
+#ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
+  nxsched_notify_pressure(total);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_iowait_enter
+ ****************************************************************************/
+
+void nxsched_iowait_enter(void)
+{
+  FAR struct task_group_s *group;
+  irqstate_t flags;
+
+  if (up_interrupt_context())
+    {
+      return;
+    }
+
+  group = this_task()->group;
+  flags = spin_lock_irqsave(&g_pressure_lock);
+
+  if (group->tg_niowait++ == 0)
+    {
+      group->tg_iostart = clock_systime_ticks();
+    }
+
+  g_pressure_niowait++;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_iowait_leave
+ ****************************************************************************/
+
+void nxsched_iowait_leave(void)
+{
+  FAR struct task_group_s *group;
+  irqstate_t flags;
+
+  if (up_interrupt_context())
+    {
+      return;
+    }
+
+  group = this_task()->group;
+  flags = spin_lock_irqsave(&g_pressure_lock);
+
+  DEBUGASSERT(group->tg_niowait > 0 && g_pressure_niowait > 0);
+  if (--group->tg_niowait == 0)
+    {
+      group->tg_iostall += clock_systime_ticks() - group->tg_iostart;
+    }
+
+  g_pressure_niowait--;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_get_pressure
+ ****************************************************************************/
+
+int nxsched_get_pressure(int state, FAR struct pressure_s *pressure)
+{
+  irqstate_t flags;
+
+  if (state < 0 || state >= PRESSURE_NSTATES || pressure == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  pressure->avg10  = pressure_percent(g_pressure[state].avg[0]);
+  pressure->avg60  = pressure_percent(g_pressure[state].avg[1]);
+  pressure->avg300 = pressure_percent(g_pressure[state].avg[2]);
+  pressure->total  = TICK2USEC((uint64_t)g_pressure[state].stall);
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_get_grouppressure
+ ****************************************************************************/
+
+void nxsched_get_grouppressure(FAR struct task_group_s *group,
+                               FAR uint64_t *cpu, FAR uint64_t *io)
+{
+  irqstate_t flags;
+  clock_t iostall;
+
+  flags   = spin_lock_irqsave(&g_pressure_lock);
+  iostall = group->tg_iostall;
+  if (group->tg_niowait > 0)
+    {
+      iostall += clock_systime_ticks() - group->tg_iostart;
+    }
+
+  *cpu = TICK2USEC((uint64_t)group->tg_cpustall);
+  *io  = TICK2USEC((uint64_t)iostall);
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
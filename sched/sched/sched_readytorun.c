@@ -0,0 +1,263 @@
+/****************************************************************************
+ * sched/sched/sched_readytorun.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+#include <strings.h>
+
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NPRIORITIES   (SCHED_PRIORITY_MAX + 1)
+#define RTR_NWORDS        ((RTR_NPRIORITIES + 31) / 32)
+
+#define RTR_WORD(prio)    ((prio) >> 5)
+#define RTR_BIT(prio)     (UINT32_C(1) << ((prio) & 31))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* g_readytorun stays a single list, kept in descending priority order so
+ * that all of the existing list walks are unaffected.  It is indexed by
+ * the last TCB of every priority level present in the list and by a
+ * bitmap of those levels: a newly ready TCB always goes right after the
+ * last TCB of the lowest priority level that is not lower than its own.
+ */
+
+static FAR struct tcb_s *g_rtr_tail[RTR_NPRIORITIES];
+static uint32_t g_rtr_bitmap[RTR_NWORDS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_above
+ *
+ * Description:
+ *   Return the lowest priority level strictly above sched_priority which
+ *   has tasks in the ready-to-run list, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int nxsched_rtr_above(int sched_priority)
+{
+  int ndx = RTR_WORD(sched_priority);
+  uint32_t word;
+
+  /* Mask out the levels up to and including sched_priority */
+
+  word = g_rtr_bitmap[ndx] & ~((RTR_BIT(sched_priority) << 1) - 1);
+
+  while (word == 0)
+    {
+      if (++ndx >= RTR_NWORDS)
+        {
+          return -1;
+        }
+
+      word = g_rtr_bitmap[ndx];
+    }
+
+  return (ndx << 5) + ffs(word) - 1;
+}
+
+static void nxsched_rtr_index(FAR struct tcb_s *tcb)
+{
+  int sched_priority = tcb->sched_priority;
+
+  g_rtr_tail[sched_priority] = tcb;
+  g_rtr_bitmap[RTR_WORD(sched_priority)] |= RTR_BIT(sched_priority);
+}
+
+static void nxsched_rtr_unindex(FAR struct tcb_s *tcb)
+{
+  int sched_priority = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_rtr_tail[sched_priority] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == sched_priority)
+        {
+          g_rtr_tail[sched_priority] = prev;
+        }
+      else
+        {
+          g_rtr_tail[sched_priority] = NULL;
+          g_rtr_bitmap[RTR_WORD(sched_priority)] &= ~RTR_BIT(sched_priority);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_add
+ *
+ * Description:
+ *   Insert a TCB into the g_readytorun list after all of the TCBs with the
+ *   same or higher priority.  This is equivalent to
+ *   nxsched_add_prioritized(tcb, list_readytorun()), but runs in constant
+ *   time.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to the ready-to-run list
+ *
+ * Returned Value:
+ *   true if the TCB was added to the head of the list.
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+bool nxsched_rtr_add(FAR struct tcb_s *tcb)
+{
+  FAR dq_queue_t *list = list_readytorun();
+  FAR struct tcb_s *prev;
+  int sched_priority = tcb->sched_priority;
+
+  DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN &&
+              sched_priority <= SCHED_PRIORITY_MAX);
+
+  prev = g_rtr_tail[sched_priority];
+  if (prev == NULL)
+    {
+      int above = nxsched_rtr_above(sched_priority);
+
+      prev = above >= 0 ? g_rtr_tail[above] : NULL;
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Deadline threads are ordered by deadline within their level, which
+   * needs a walk back from the tail of the level.
+   */
+
+  while (prev != NULL && prev->sched_priority == sched_priority &&
+         nxsched_deadline_before(tcb, prev))
+    {
+      prev = prev->blink;
+    }
+#endif
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb, list);
+    }
+
+  if (g_rtr_tail[sched_priority] == NULL ||
+      g_rtr_tail[sched_priority] == prev)
+    {
+      nxsched_rtr_index(tcb);
+    }
+
+  return prev == NULL;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_remove
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the ready-to-run list
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_remove(FAR struct tcb_s *tcb)
+{
+  nxsched_rtr_unindex(tcb);
+  dq_rem((FAR dq_entry_t *)tcb, list_readytorun());
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_setpriority
+ *
+ * Description:
+ *   Change the priority of a task in place.  If the task is linked into the
+ *   g_readytorun list, it must be the head of the list and stay there with
+ *   its new priority (e.g. a running task raising its priority, or
+ *   lowering it while still above everything behind it).
+ *
+ * Input Parameters:
+ *   tcb            - Points to the TCB to reprioritize
+ *   sched_priority - The new priority
+ *
+ * Assumptions:
+ *   The caller holds the critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_setpriority(FAR struct tcb_s *tcb, int sched_priority)
+{
+  bool linked = tcb->task_state == TSTATE_TASK_READYTORUN;
+
+#ifndef CONFIG_SMP
+  linked |= tcb->task_state == TSTATE_TASK_RUNNING;
+#endif
+
+  if (!linked)
+    {
+      tcb->sched_priority = (uint8_t)sched_priority;
+      return;
+    }
+
+  DEBUGASSERT(tcb->blink == NULL);
+  DEBUGASSERT(tcb->flink == NULL ||
+              tcb->flink->sched_priority <= sched_priority);
+
+  nxsched_rtr_unindex(tcb);
+  tcb->sched_priority = (uint8_t)sched_priority;
+
+  /* Being the head, the TCB can only be the last one of its level if the
+   * level was empty.
+   */
+
+  if (g_rtr_tail[sched_priority] == NULL)
+    {
+      nxsched_rtr_index(tcb);
+    }
+}
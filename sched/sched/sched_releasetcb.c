@@ -38,6 +38,10 @@
 #include "group/group.h"
 #include "timer/timer.h"
 
+#ifndef CONFIG_DISABLE_PTHREAD
+#  include "pthread/pthread.h"
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -100,6 +104,7 @@ static void nxsched_releasepid(pid_t pid)
 
 int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 {
+  bool keepstack = false;
   int ret = OK;
 
   if (tcb)
@@ -129,9 +134,17 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+      /* A pthread may be cached together with its stack, see below */
+
+      keepstack = ttype == TCB_FLAG_TTYPE_PTHREAD &&
+                  (tcb->flags & TCB_FLAG_FREE_TCB) != 0 &&
+                  (tcb->flags & TCB_FLAG_FREE_STACK) != 0;
+#endif
+
       /* Delete the thread's stack if one has been allocated */
 
-      if (tcb->stack_alloc_ptr)
+      if (tcb->stack_alloc_ptr && !keepstack)
         {
           up_release_stack(tcb, ttype);
         }
@@ -178,6 +191,18 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->flags & TCB_FLAG_FREE_TCB)
         {
+#if CONFIG_PTHREAD_TCB_CACHE > 0
+          if (keepstack && pthread_tcbcache_free(tcb))
+            {
+              return ret;
+            }
+#endif
+
+          if (keepstack)
+            {
+              up_release_stack(tcb, ttype);
+            }
+
           kmm_free(tcb);
         }
     }
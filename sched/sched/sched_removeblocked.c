@@ -73,6 +73,7 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
   /* Indicate that the wait is over. */
 
   btcb->waitobj = NULL;
+  nxsched_critmon_wakeup(btcb);
 
   /* Make sure the TCB's state corresponds to not being in
    * any list
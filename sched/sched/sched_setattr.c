@@ -0,0 +1,248 @@
+/****************************************************************************
+ * sched/sched/sched_setattr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/arch.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_set_attr
+ *
+ * Description:
+ *   See sched_setattr().  On failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+static int nxsched_set_attr(pid_t pid, FAR const struct sched_attr *attr,
+                            unsigned int flags)
+{
+  FAR struct tcb_s *tcb;
+  struct sched_param param;
+  int ret;
+
+  if (attr == NULL || flags != 0 || attr->sched_flags != 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The other policies are only a different way to call
+   * sched_setscheduler().
+   */
+
+  if (attr->sched_policy != SCHED_DEADLINE)
+    {
+      memset(&param, 0, sizeof(param));
+      param.sched_priority = attr->sched_priority;
+      return nxsched_set_scheduler(pid, attr->sched_policy, &param);
+    }
+
+  if (pid == 0)
+    {
+      tcb = this_task();
+    }
+  else
+    {
+      tcb = nxsched_get_tcb(pid);
+    }
+
+  if (tcb == NULL)
+    {
+      return -ESRCH;
+    }
+
+  if (is_idle_task(tcb))
+    {
+      return -EPERM;
+    }
+
+  sched_lock();
+  ret = nxsched_start_deadline(tcb, attr->sched_runtime,
+                               attr->sched_deadline, attr->sched_period);
+  sched_unlock();
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_get_attr
+ *
+ * Description:
+ *   See sched_getattr().  On failure, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+static int nxsched_get_attr(pid_t pid, FAR struct sched_attr *attr,
+                            unsigned int size, unsigned int flags)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t irqflags;
+  int ret = -ESRCH;
+
+  if (attr == NULL || flags != 0 || size < sizeof(struct sched_attr))
+    {
+      return -EINVAL;
+    }
+
+  memset(attr, 0, sizeof(struct sched_attr));
+  attr->size = sizeof(struct sched_attr);
+
+  irqflags = enter_critical_section();
+
+  if (pid == 0)
+    {
+      tcb = this_task();
+    }
+  else
+    {
+      tcb = nxsched_get_tcb(pid);
+    }
+
+  if (tcb != NULL)
+    {
+      ret = nxsched_get_scheduler(pid);
+      if (ret >= 0)
+        {
+          attr->sched_policy = ret;
+
+          if (nxsched_is_deadline(tcb))
+            {
+              attr->sched_runtime  = tcb->deadline->runtime;
+              attr->sched_deadline = tcb->deadline->rel_deadline;
+              attr->sched_period   = tcb->deadline->period;
+            }
+          else
+            {
+#ifdef CONFIG_PRIORITY_INHERITANCE
+              attr->sched_priority = tcb->base_priority;
+#else
+              attr->sched_priority = tcb->sched_priority;
+#endif
+            }
+
+          ret = OK;
+        }
+    }
+
+  leave_critical_section(irqflags);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_setattr
+ *
+ * Description:
+ *   sched_setattr() sets the scheduling policy and attributes of the
+ *   thread identified by pid, or of the calling thread if pid is zero.
+ *
+ *   For SCHED_DEADLINE, sched_runtime, sched_deadline and sched_period
+ *   (nanoseconds) describe the thread.  It is admitted only if
+ *   sched_runtime <= sched_deadline <= sched_period and the total
+ *   bandwidth of the deadline threads stays within
+ *   CONFIG_SCHED_DEADLINE_BANDWIDTH.  A sched_period of zero means the same
+ *   as sched_deadline.
+ *
+ *   Any other policy is handled like sched_setscheduler() with
+ *   sched_priority.
+ *
+ * Input Parameters:
+ *   pid   - The ID of the thread to modify, or zero for the calling thread
+ *   attr  - The new scheduling attributes
+ *   flags - Must be zero
+ *
+ * Returned Value:
+ *   On success, sched_setattr() returns OK (zero).  On error, ERROR (-1) is
+ *   returned, and errno is set appropriately:
+ *
+ *   EINVAL The policy or its parameters are invalid.
+ *   EBUSY  The deadline admission control rejected the thread.
+ *   ESRCH  The thread whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                  unsigned int flags)
+{
+  int ret = nxsched_set_attr(pid, attr, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: sched_getattr
+ *
+ * Description:
+ *   sched_getattr() returns the scheduling policy and attributes of the
+ *   thread identified by pid, or of the calling thread if pid is zero.
+ *
+ * Input Parameters:
+ *   pid   - The ID of the thread to query, or zero for the calling thread
+ *   attr  - The location to return the attributes
+ *   size  - The size of the attr buffer
+ *   flags - Must be zero
+ *
+ * Returned Value:
+ *   On success, sched_getattr() returns OK (zero).  On error, ERROR (-1) is
+ *   returned, and errno is set appropriately:
+ *
+ *   EINVAL attr is NULL, size is too small or flags is not zero.
+ *   ESRCH  The thread whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_getattr(pid_t pid, FAR struct sched_attr *attr,
+                  unsigned int size, unsigned int flags)
+{
+  int ret = nxsched_get_attr(pid, attr, size, flags);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  return ret;
+}
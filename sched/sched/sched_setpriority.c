@@ -120,7 +120,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
-          tcb->sched_priority = (uint8_t)sched_priority;
+          nxsched_rtr_setpriority(tcb, sched_priority);
         }
       else
         {
@@ -140,7 +140,7 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
-      tcb->sched_priority = (uint8_t)sched_priority;
+      nxsched_rtr_setpriority(tcb, sched_priority);
     }
 }
 
@@ -169,7 +169,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
   rtcb = this_task();
 
 #ifdef CONFIG_SMP
-  dq_rem((FAR struct dq_entry_s *)tcb, list_readytorun());
+  nxsched_rtr_remove(tcb);
   tcb->sched_priority = sched_priority;
   if (nxsched_add_readytorun(tcb))
 #else
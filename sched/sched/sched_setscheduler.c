@@ -207,6 +207,15 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         {
           ret = OK;
 
+#ifdef CONFIG_SCHED_DEADLINE
+          /* Leave deadline scheduling and release its bandwidth */
+
+          if (nxsched_is_deadline(tcb))
+            {
+              DEBUGVERIFY(nxsched_stop_deadline(tcb));
+            }
+#endif
+
           /* Further, disable timer interrupts
            * while we set up scheduling policy.
            */
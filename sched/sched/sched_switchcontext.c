@@ -27,6 +27,7 @@
 #include "sched/sched.h"
 
 #include <nuttx/sched_note.h>
+#include <nuttx/drivers/perf.h>
 
 /****************************************************************************
  * Public Functions
@@ -65,12 +66,38 @@ void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to)
     }
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Account the runtime budget of deadline threads */
+
+  if (nxsched_is_deadline(from))
+    {
+      nxsched_suspend_deadline(from);
+    }
+
+  if (nxsched_is_deadline(to))
+    {
+      nxsched_resume_deadline(to);
+    }
+#endif
+
   /* Indicate that the task has been suspended */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_switch_critmon(from, to);
 #endif
 
+#ifdef CONFIG_DEV_PERF
+  /* Save and restore the per-thread performance counters */
+
+  devperf_switch(from, to);
+#endif
+
+#ifdef CONFIG_SCHED_LAZYFPU
+  /* Decide whether the resumed task gets the FPU now or on first use */
+
+  nxsched_switch_fpu(from, to);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(from);
   sched_note_resume(to);
@@ -49,6 +49,21 @@
 typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
                                FAR sem_t *sem, FAR void *arg);
 
+/* Walk state when propagating a boost down a chain of blocked holders */
+
+struct semboost_s
+{
+  FAR struct tcb_s *rtcb;         /* The waiter the boost comes from      */
+  int depth;                      /* Number of chain links followed       */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int nxsem_restorechainprio(FAR struct semholder_s *pholder,
+                                  FAR sem_t *sem, FAR void *arg);
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -297,6 +312,37 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
   return ret;
 }
 
+/****************************************************************************
+ * Name: nxsem_recoverholders
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_blocked_on
+ *
+ * Description:
+ *   Return the priority inheritance semaphore that htcb is blocked on, or
+ *   NULL if it is not waiting for one.
+ *
+ ****************************************************************************/
+
+static FAR sem_t *nxsem_blocked_on(FAR struct tcb_s *htcb)
+{
+  FAR sem_t *sem;
+
+  if (htcb->task_state != TSTATE_WAIT_SEM)
+    {
+      return NULL;
+    }
+
+  sem = htcb->waitobj;
+  if (sem == NULL || (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_INHERIT)
+    {
+      return NULL;
+    }
+
+  return sem;
+}
+
 /****************************************************************************
  * Name: nxsem_recoverholders
  ****************************************************************************/
@@ -315,8 +361,9 @@ static int nxsem_recoverholders(FAR struct semholder_s *pholder,
 static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
                                  FAR sem_t *sem, FAR void *arg)
 {
+  FAR struct semboost_s *boost = (FAR struct semboost_s *)arg;
   FAR struct tcb_s *htcb = pholder->htcb;
-  FAR struct tcb_s *rtcb = (FAR struct tcb_s *)arg;
+  FAR struct tcb_s *rtcb = boost->rtcb;
 
   /* If the priority of the thread that is waiting for a count is less than
    * or equal to the priority of the thread holding a count, then do nothing
@@ -325,6 +372,8 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
 
   if (rtcb && htcb && rtcb->sched_priority > htcb->sched_priority)
     {
+      FAR sem_t *next;
+
       /* Raise the priority of the holder of the semaphore.  This
        * cannot cause a context switch because we have preemption
        * disabled.  The task will be marked "pending" and the switch
@@ -332,6 +381,18 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
        */
 
       nxsched_set_priority(htcb, rtcb->sched_priority);
+
+      /* If the holder is itself waiting for another semaphore, pass the
+       * boost on to the holders of that one as well.
+       */
+
+      next = nxsem_blocked_on(htcb);
+      if (next != NULL && boost->depth < CONFIG_SEM_PI_CHAIN_DEPTH)
+        {
+          boost->depth++;
+          nxsem_foreachholder(next, nxsem_boostholderprio, boost);
+          boost->depth--;
+        }
     }
 
   return 0;
@@ -388,7 +449,7 @@ static int nxsem_dumpholder(FAR struct semholder_s *pholder, FAR sem_t *sem,
  * Name: nxsem_restore_priority
  ****************************************************************************/
 
-static void nxsem_restore_priority(FAR struct tcb_s *htcb)
+static void nxsem_restore_priority(FAR struct tcb_s *htcb, int depth)
 {
   int hpriority;
 
@@ -430,9 +491,39 @@ static void nxsem_restore_priority(FAR struct tcb_s *htcb)
        */
 
       nxsched_set_priority(htcb, hpriority);
+
+      /* A boost that htcb passed on down the chain has to be recomputed
+       * too.  The running task is restored by its own caller.
+       */
+
+      if (depth < CONFIG_SEM_PI_CHAIN_DEPTH)
+        {
+          FAR sem_t *next = nxsem_blocked_on(htcb);
+
+          if (next != NULL)
+            {
+              nxsem_foreachholder(next, nxsem_restorechainprio,
+                                  (FAR void *)(uintptr_t)(depth + 1));
+            }
+        }
     }
 }
 
+/****************************************************************************
+ * Name: nxsem_restorechainprio
+ ****************************************************************************/
+
+static int nxsem_restorechainprio(FAR struct semholder_s *pholder,
+                                  FAR sem_t *sem, FAR void *arg)
+{
+  if (pholder->htcb != this_task())
+    {
+      nxsem_restore_priority(pholder->htcb, (int)(uintptr_t)arg);
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: nxsem_restoreholderprio
  ****************************************************************************/
@@ -453,7 +544,7 @@ static int nxsem_restoreholderprio(FAR struct semholder_s *pholder,
       nxsem_freeholder(sem, pholder);
     }
 
-  nxsem_restore_priority(htcb);
+  nxsem_restore_priority(htcb, 0);
 
   return 0;
 }
@@ -686,7 +777,10 @@ void nxsem_add_holder(FAR sem_t *sem)
 
 void nxsem_boost_priority(FAR sem_t *sem)
 {
-  FAR struct tcb_s *rtcb = this_task();
+  struct semboost_s boost;
+
+  boost.rtcb  = this_task();
+  boost.depth = 0;
 
   /* Boost the priority of every thread holding counts on this semaphore
    * that are lower in priority than the new thread that is waiting for a
@@ -694,9 +788,9 @@ void nxsem_boost_priority(FAR sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  nxsem_foreachholder(sem, nxsem_boostholderprio, rtcb);
+  nxsem_foreachholder(sem, nxsem_boostholderprio, &boost);
 #else
-  nxsem_boostholderprio(&sem->holder, sem, rtcb);
+  nxsem_boostholderprio(&sem->holder, sem, &boost);
 #endif
 }
 
@@ -836,7 +930,7 @@ void nxsem_restore_baseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
        * the older owner when posted the count.
        */
 
-      nxsem_restore_priority(this_task());
+      nxsem_restore_priority(this_task(), 0);
 #endif
     }
   else
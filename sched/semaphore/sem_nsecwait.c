@@ -0,0 +1,120 @@
+/****************************************************************************
+ * sched/semaphore/sem_nsecwait.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/nuttx.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer of a semaphore wait expired.
+ *
+ ****************************************************************************/
+
+static uint64_t nxsem_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired)
+{
+  nxsem_timeout((uintptr_t)container_of(hrtimer, struct tcb_s,
+                                        waithrtimer));
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_nsecwait
+ *
+ * Description:
+ *   This function is the same as nxsem_tickwait(), except that the delay
+ *   is measured in nanoseconds by the high resolution timer instead of
+ *   being rounded up to clock ticks.
+ *
+ * Input Parameters:
+ *   sem     - Semaphore object
+ *   delay   - Nanoseconds to wait until the semaphore is posted.  If delay
+ *             is zero, then this function is equivalent to
+ *             nxsem_trywait().
+ *
+ * Returned Value:
+ *   This is an internal OS interface, not available to applications, and
+ *   hence follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *   -ETIMEDOUT is returned on the timeout condition.
+ *
+ ****************************************************************************/
+
+int nxsem_nsecwait(FAR sem_t *sem, uint64_t delay)
+{
+  FAR struct tcb_s *rtcb;
+  irqstate_t flags;
+  int ret;
+
+  flags = enter_critical_section();
+
+  /* Try to take the semaphore without waiting. */
+
+  ret = nxsem_trywait(sem);
+  if (ret == OK || delay == 0)
+    {
+      leave_critical_section(flags);
+      return ret == OK ? OK : -ETIMEDOUT;
+    }
+
+  rtcb = this_task();
+
+  /* Start the timer with interrupts still disabled */
+
+  hrtimer_start_slack(&rtcb->waithrtimer, nxsem_hrtimeout, delay,
+                      nxsched_timer_slack_nsec(rtcb), HRTIMER_MODE_REL);
+
+  /* Now perform the blocking wait */
+
+  ret = nxsem_wait(sem);
+  leave_critical_section(flags);
+
+  /* Stop the timer outside of the critical section, which a running
+   * callback may be spinning on.
+   */
+
+  hrtimer_cancel_sync(&rtcb->waithrtimer);
+  return ret;
+}
@@ -29,6 +29,7 @@
 #include <stdbool.h>
 #include <errno.h>
 #include <assert.h>
+#include <sys/param.h>
 
 #include <nuttx/init.h>
 #include <nuttx/irq.h>
@@ -38,6 +39,100 @@
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Longest backoff between two polls of a spinning mutex waiter */
+
+#define NXSEM_SPIN_MAXDELAY 64
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+
+/****************************************************************************
+ * Name: nxsem_holder_running
+ *
+ * Description:
+ *   Check whether the mutex holder is running on another CPU.  The result
+ *   is only a hint, the holder may be scheduled out right after the check.
+ *
+ ****************************************************************************/
+
+static bool nxsem_holder_running(uint32_t mholder)
+{
+  pid_t pid = mholder & ~NXSEM_MBLOCKING_BIT;
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (cpu != me && current_task(cpu)->pid == pid)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_spin_mutex
+ *
+ * Description:
+ *   Spin with exponential backoff while the holder of the mutex is running
+ *   on another CPU, hoping that it releases the mutex soon.
+ *
+ * Returned Value:
+ *   true if the mutex was acquired, false if the caller has to block.
+ *
+ ****************************************************************************/
+
+static bool nxsem_spin_mutex(FAR sem_t *sem)
+{
+  FAR atomic_t *val = NXSEM_MHOLDER(sem);
+  int budget = CONFIG_MUTEX_ADAPTIVE_SPIN_LOOPS;
+  int delay = 1;
+  int32_t old;
+  int i;
+
+  while (budget > 0)
+    {
+      old = atomic_read(val);
+      if (old == NXSEM_NO_MHOLDER)
+        {
+          if (atomic_try_cmpxchg_acquire(val, &old, nxsched_gettid()))
+            {
+              return true;
+            }
+
+          budget--;
+          continue;
+        }
+
+      /* Once there are blocked waiters the mutex is handed over to them,
+       * and a holder that is not running will not release it soon.
+       */
+
+      if (NXSEM_MBLOCKING(old) || !nxsem_holder_running(old))
+        {
+          break;
+        }
+
+      for (i = 0; i < delay && atomic_read(val) == old; i++);
+
+      budget -= delay;
+      delay = MIN(delay << 1, NXSEM_SPIN_MAXDELAY);
+    }
+
+  return false;
+}
+
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,6 +173,22 @@ int nxsem_wait_slow(FAR sem_t *sem)
   FAR struct tcb_s *htcb = NULL;
   bool mutex = NXSEM_IS_MUTEX(sem);
 
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+  /* On a contended mutex whose holder runs on another CPU, spin a while
+   * before paying for a context switch.  Priority protected mutexes must
+   * go the slow way to raise the priority of the caller.
+   */
+
+  if (mutex &&
+#  ifdef CONFIG_PRIORITY_PROTECT
+      (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_PROTECT &&
+#  endif
+      nxsem_spin_mutex(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
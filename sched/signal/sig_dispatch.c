@@ -124,6 +124,18 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb,
 
   if ((sigact) && (sigact->act.sa_u._sa_sigaction))
     {
+      /* Kernel handlers, e.g. the one of a signalfd, only notify the
+       * consumer.  Run them now instead of queueing an action for
+       * delivery on the recipient thread.
+       */
+
+      if ((sigact->act.sa_flags & SA_KERNELHAND) != 0)
+        {
+          info->si_user = sigact->act.sa_user;
+          (sigact->act.sa_sigaction)(info->si_signo, info, NULL);
+          return OK;
+        }
+
       /* Allocate a new element for the signal queue. NOTE:
        * nxsig_alloc_pendingsigaction will force a system crash if it is
        * unable to allocate memory for the signal data.
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <signal.h>
+#include <strings.h>
 
 #include <nuttx/signal.h>
 
@@ -46,13 +47,24 @@
 
 int nxsig_lowest(sigset_t *set)
 {
+  uint32_t elem;
   int signo;
+  int i;
 
-  for (signo = MIN_SIGNO; signo <= MAX_SIGNO; signo++)
+  /* Scan a word at a time, signal 0 is not a valid signal number */
+
+  for (i = 0; i < _SIGSET_NELEM; i++)
     {
-      if (nxsig_ismember(set, signo) == 1)
+      elem = set->_elem[i];
+      if (i == _SIGSET_NDX(0))
+        {
+          elem &= ~(1u << _SIGSET_BIT(0));
+        }
+
+      if (elem != 0)
         {
-          return signo;
+          signo = (i << 5) + ffs(elem) - 1;
+          return signo <= MAX_SIGNO ? signo : ERROR;
         }
     }
 
@@ -32,6 +32,16 @@
 
 #include "signal/signal.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of dynamically allocated entries moved to the free list */
+
+#if CONFIG_SIG_PENDING_KEEP > 0
+static int g_nkept;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,6 +95,22 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
 
   else if (sigq->type == SIG_ALLOC_DYN)
     {
+#if CONFIG_SIG_PENDING_KEEP > 0
+      /* Keep it for reuse, it becomes part of the pre-allocated pool */
+
+      flags = enter_critical_section();
+      if (g_nkept < CONFIG_SIG_PENDING_KEEP)
+        {
+          g_nkept++;
+          sigq->type = SIG_ALLOC_FIXED;
+          sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingaction);
+          leave_critical_section(flags);
+          return;
+        }
+
+      leave_critical_section(flags);
+#endif
+
       kmm_free(sigq);
     }
 }
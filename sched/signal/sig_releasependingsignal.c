@@ -40,6 +40,16 @@
 
 #include "signal/signal.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of dynamically allocated entries moved to the free list */
+
+#if CONFIG_SIG_PENDING_KEEP > 0
+static int g_nkept;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,6 +103,22 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
 
   else if (sigpend->type == SIG_ALLOC_DYN)
     {
+#if CONFIG_SIG_PENDING_KEEP > 0
+      /* Keep it for reuse, it becomes part of the pre-allocated pool */
+
+      flags = enter_critical_section();
+      if (g_nkept < CONFIG_SIG_PENDING_KEEP)
+        {
+          g_nkept++;
+          sigpend->type = SIG_ALLOC_FIXED;
+          sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingsignal);
+          leave_critical_section(flags);
+          return;
+        }
+
+      leave_critical_section(flags);
+#endif
+
       kmm_free(sigpend);
     }
 }
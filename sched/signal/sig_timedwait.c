@@ -91,6 +91,24 @@ static void nxsig_timeout(wdparm_t arg)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   The high resolution timer of a signal wait expired.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t nxsig_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired)
+{
+  nxsig_timeout((uintptr_t)container_of(hrtimer, struct tcb_s,
+                                        waithrtimer));
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -186,8 +204,13 @@ int nxsig_clockwait(int clockid, int flags,
 {
   FAR struct tcb_s *rtcb;
   irqstate_t        iflags;
+#ifdef CONFIG_HRTIMER
+  uint64_t expect = 0u;
+  uint64_t stop   = 0u;
+#else
   clock_t expect = 0u;
   clock_t stop   = 0u;
+#endif
 
   if (rqtp && (rqtp->tv_nsec < 0 || rqtp->tv_nsec >= 1000000000))
     {
@@ -233,6 +256,31 @@ int nxsig_clockwait(int clockid, int flags,
 
   if (rqtp)
     {
+#ifdef CONFIG_HRTIMER
+      /* Start the high resolution timer, in system time nanoseconds */
+
+      if ((flags & TIMER_ABSTIME) == 0)
+        {
+          expect = clock_systime_nsec() + clock_time2nsec(rqtp);
+        }
+      else if (clockid == CLOCK_REALTIME)
+        {
+          struct timespec now;
+          int64_t delay;
+
+          nxclock_gettime(CLOCK_REALTIME, &now);
+          delay  = clock_time2nsec(rqtp) - clock_time2nsec(&now);
+          expect = clock_systime_nsec() + (delay > 0 ? delay : 0);
+        }
+      else
+        {
+          expect = clock_time2nsec(rqtp);
+        }
+
+      hrtimer_start_slack(&rtcb->waithrtimer, nxsig_hrtimeout, expect,
+                          nxsched_timer_slack_nsec(rtcb),
+                          HRTIMER_MODE_ABS);
+#else
       /* Start the watchdog timer */
 
       if ((flags & TIMER_ABSTIME) == 0)
@@ -255,8 +303,12 @@ int nxsig_clockwait(int clockid, int flags,
           expect = clock_time2ticks(rqtp);
         }
 
-        wd_start_abstick(&rtcb->waitdog, expect,
-                         nxsig_timeout, (uintptr_t)rtcb);
+      /* Let the wakeup coalesce with other timers within the slack */
+
+      expect = wd_slack_expire(expect, nxsched_timer_slack(rtcb));
+      wd_start_abstick(&rtcb->waitdog, expect,
+                       nxsig_timeout, (uintptr_t)rtcb);
+#endif
     }
 
   /* Remove the tcb task from the ready-to-run list. */
@@ -276,16 +328,36 @@ int nxsig_clockwait(int clockid, int flags,
 
   if (rqtp)
     {
+#ifdef CONFIG_HRTIMER
+      stop = clock_systime_nsec();
+#else
       stop = clock_systime_ticks();
+#endif
     }
 
   leave_critical_section(iflags);
 
+#ifdef CONFIG_HRTIMER
+  /* A signal may have ended the wait before the timer.  Wait outside of
+   * the critical section, which a running callback may be spinning on.
+   */
+
+  if (rqtp)
+    {
+      hrtimer_cancel_sync(&rtcb->waithrtimer);
+    }
+
+  if (rqtp && rmtp && expect)
+    {
+      clock_nsec2time(rmtp, stop < expect ? expect - stop : 0);
+    }
+#else
   if (rqtp && rmtp && expect)
     {
       clock_ticks2time(rmtp,
                        clock_compare(stop, expect) ? expect - stop : 0);
     }
+#endif
 
   return 0;
 }
@@ -56,6 +56,10 @@
 #define NUM_PENDING_ACTIONS      4
 #define NUM_SIGNALS_PENDING      4
 
+#ifndef CONFIG_SIG_PENDING_KEEP
+#  define CONFIG_SIG_PENDING_KEEP 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
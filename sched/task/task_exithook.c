@@ -447,6 +447,13 @@ void nxtask_exithook(FAR struct tcb_s *tcb, int status)
 
   sched_unlock();
 
+#ifdef CONFIG_FS_SELECT_CACHE
+  /* Drop the poll setups and the file references cached by select() */
+
+  select_cache_release(tcb->selcache);
+  tcb->selcache = NULL;
+#endif
+
   /* Leave the task group.  Perhaps discarding any un-reaped child
    * status (no zombies here!)
    */
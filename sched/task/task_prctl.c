@@ -28,6 +28,7 @@
 
 #include <sys/prctl.h>
 #include <stdarg.h>
+#include <limits.h>
 #include <string.h>
 #include <errno.h>
 #include <debug.h>
@@ -52,6 +53,7 @@
  * Returned Value:
  *   The returned value may depend on the specific command.  For PR_SET_NAME
  *   and PR_GET_NAME, the returned value of 0 indicates successful operation.
+ *   PR_GET_TIMERSLACK returns the timer slack in nanoseconds.
  *   On any failure, -1 is retruend and the errno value is set appropriately.
  *
  *     EINVAL The value of 'option' is not recognized.
@@ -148,17 +150,49 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+      case PR_SET_TIMERSLACK:
+      case PR_GET_TIMERSLACK:
+#ifdef CONFIG_TIMER_SLACK
+        {
+          FAR struct tcb_s *tcb = this_task();
+          unsigned long slack;
+
+          if (option == PR_GET_TIMERSLACK)
+            {
+              va_end(ap);
+              return tcb->timer_slack;
+            }
+
+          /* Zero restores the default slack.  Keep the slack within the
+           * range of the returned value of PR_GET_TIMERSLACK.
+           */
+
+          slack = va_arg(ap, unsigned long);
+          if (slack == 0)
+            {
+              slack = CONFIG_TIMER_SLACK_DEFAULT;
+            }
+
+          tcb->timer_slack = slack < INT_MAX ? slack : INT_MAX;
+        }
+        break;
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
         goto errout;
     }
 
-  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0.  NOTE: This might
-   * change if additional commands are supported.
+  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0 or
+   * CONFIG_TIMER_SLACK is enabled.
    */
 
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_TIMER_SLACK)
   va_end(ap);
   return OK;
 #endif
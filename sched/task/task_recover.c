@@ -73,6 +73,9 @@ void nxtask_recover(FAR struct tcb_s *tcb)
   /* The task is being deleted.  Cancel in pending timeout events. */
 
   wd_cancel(&tcb->waitdog);
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel_sync(&tcb->waithrtimer);
+#endif
 
   /* If the thread holds semaphore counts or is waiting for a semaphore
    *  count, then release the counts.
@@ -94,4 +97,13 @@ void nxtask_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(nxsched_stop_sporadic(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (nxsched_is_deadline(tcb))
+    {
+      /* Stop deadline scheduling and release its bandwidth */
+
+      DEBUGVERIFY(nxsched_stop_deadline(tcb));
+    }
+#endif
 }
@@ -67,6 +67,24 @@ static const char g_noname[] = "<noname>";
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxtask_pidhash_sync
+ *
+ * Description:
+ *   Run on every CPU before the replaced g_pidhash table is freed.
+ *   nxsched_get_tcb() reads the table with the local interrupts disabled,
+ *   so once each CPU took this call none of them can still be reading the
+ *   old table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int nxtask_pidhash_sync(FAR void *arg)
+{
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nxtask_assign_pid
  *
@@ -85,7 +103,9 @@ static int nxtask_assign_pid(FAR struct tcb_s *tcb)
 {
   FAR struct tcb_s **pidhash;
   irqstate_t flags;
+  irqstate_t seqflags;
   pid_t next_pid;
+  int   npidhash;
   int   hash_ndx;
   void *temp;
   int   i;
@@ -167,13 +187,15 @@ retry:
       goto retry;
     }
 
-  g_npidhash *= 2;
+  npidhash = g_npidhash * 2;
 
   /* All original pid and hash_ndx are mismatch,
-   * so we need to rebuild their relationship
+   * so we need to rebuild their relationship.  The new table is filled
+   * before it is published, nxsched_get_tcb() may read g_pidhash at any
+   * time.
    */
 
-  for (i = 0; i < g_npidhash / 2; i++)
+  for (i = 0; i < g_npidhash; i++)
     {
       if (g_pidhash[i] == NULL)
         {
@@ -185,15 +207,27 @@ retry:
           continue;
         }
 
-      hash_ndx = PIDHASH(g_pidhash[i]->pid);
+      hash_ndx = g_pidhash[i]->pid & (npidhash - 1);
       DEBUGASSERT(pidhash[hash_ndx] == NULL);
       pidhash[hash_ndx] = g_pidhash[i];
     }
 
-  /* Release resource for original g_pidhash, using new g_pidhash */
+  /* Publish the new g_pidhash, the table and its size change together */
 
-  g_pidhash = pidhash;
+  seqflags   = write_seqlock_irqsave(&g_pidhash_seq);
+  g_pidhash  = pidhash;
+  g_npidhash = npidhash;
+  write_sequnlock_irqrestore(&g_pidhash_seq, seqflags);
   leave_critical_section(flags);
+
+  /* Release resource for original g_pidhash once no CPU can be reading
+   * it anymore.
+   */
+
+#ifdef CONFIG_SMP
+  nxsched_smp_call((1 << CONFIG_SMP_NCPUS) - 1, nxtask_pidhash_sync, NULL);
+#endif
+
   kmm_free(temp);
 
   /* Let's try every allowable pid again */
@@ -465,6 +499,12 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
       tcb->sigprocmask = rtcb->sigprocmask;
 #endif
 
+#ifdef CONFIG_TIMER_SLACK
+      /* The timer slack is inherited from the parent thread as well */
+
+      tcb->timer_slack = rtcb->timer_slack;
+#endif
+
       /* Initialize the task state.  It does not get a valid state
        * until it is activated.
        */
@@ -60,8 +60,8 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
-  FAR struct wdog_s *first;
   irqstate_t         flags;
+  bool               first;
   int                  ret = -EINVAL;
 
   if (wdog != NULL)
@@ -70,30 +70,28 @@ int wd_cancel(FAR struct wdog_s *wdog)
        * cancellation is complete
        */
 
-      flags = enter_critical_section();
+      flags = wd_lock();
 
       /* Make sure that the watchdog is valid and still active. */
 
       if (WDOG_ISACTIVE(wdog))
         {
-          first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
           /* Now, remove the watchdog from the timer queue */
 
-          list_delete_fast(&wdog->node);
+          first = wd_remove(wdog);
 
           /* Mark the watchdog inactive */
 
           wdog->func = NULL;
 
-          if (first == wdog && !wd_in_callback())
+          if (first && !wd_in_callback())
             {
               /* If the watchdog is at the head of the timer queue, then
                * we will need to re-adjust the interval timer that will
                * generate the next interval event.
                */
 
-              if (!list_is_empty(&g_wdactivelist))
+              if (!wd_is_empty())
                 {
                   wd_timer_start(wd_next_expire(), false);
                 }
@@ -106,7 +104,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
           ret = OK;
         }
 
-      leave_critical_section(flags);
+      wd_unlock(flags);
       sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
                       (FAR void *)(uintptr_t)wdog->expired);
     }
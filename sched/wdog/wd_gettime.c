@@ -61,10 +61,10 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
-      flags     = enter_critical_section();
+      flags     = wd_lock();
       is_active = WDOG_ISACTIVE(wdog);
       expired   = wdog->expired;
-      leave_critical_section(flags);
+      wd_unlock(flags);
 
       if (is_active)
         {
@@ -75,3 +75,43 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   return delay;
 }
+
+/****************************************************************************
+ * Name: wd_getnext
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires, which bounds how long the system can stay
+ *   idle.
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means a watchdog expires now, a negative value that there is no
+ *   active watchdog.
+ *
+ ****************************************************************************/
+
+sclock_t wd_getnext(void)
+{
+  irqstate_t flags;
+  clock_t    expired = 0;
+  bool       is_empty;
+  sclock_t   delay;
+
+  flags    = wd_lock();
+  is_empty = wd_is_empty();
+  if (!is_empty)
+    {
+      expired = wd_next_expire();
+    }
+
+  wd_unlock(flags);
+
+  if (is_empty)
+    {
+      return -1;
+    }
+
+  delay = (sclock_t)(expired - clock_systime_ticks());
+  return delay >= 0 ? delay : 0;
+}
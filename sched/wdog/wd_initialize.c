@@ -34,17 +34,29 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* The g_wdwheel data structure holds the active watchdogs in a
+ * hierarchical timing wheel.
+ */
+
+struct wd_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 #ifdef CONFIG_HRTIMER
 struct hrtimer_s g_wdtimer;
 #endif
 
+#ifdef CONFIG_WDOG_SPINLOCK
+spinlock_t g_wdspinlock = SP_UNLOCKED;
+#endif
+
 #if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
 bool g_wdtimernested;
 clock_t  g_wdexpired;
@@ -112,7 +112,7 @@ static inline_function clock_t wd_expiration(clock_t ticks)
   wdparm_t           arg;
   clock_t     next_ticks = ticks;
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 
   wd_update_expire(ticks);
 
@@ -122,24 +122,8 @@ static inline_function clock_t wd_expiration(clock_t ticks)
    * other watchdogs that became ready to run at this time
    */
 
-  while (!list_is_empty(&g_wdactivelist))
+  while ((wdog = wd_expired(ticks)) != NULL)
     {
-      wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
-
-      /* Check if watchdog has expired;
-       * re-evaluate after updating current ticks if needed
-       */
-
-      if (!clock_compare(wdog->expired, ticks))
-        {
-          next_ticks = wdog->expired;
-          break;
-        }
-
-      /* Remove the watchdog from the head of the list */
-
-      list_delete_fast(&wdog->node);
-
       /* Indicate that the watchdog is no longer active. */
 
       func = wdog->func;
@@ -148,8 +132,26 @@ static inline_function clock_t wd_expiration(clock_t ticks)
 
       /* Execute the watchdog function */
 
+#ifdef CONFIG_WDOG_SPINLOCK
+      /* Callbacks expect the critical section, but must not run with the
+       * queue locked since they may restart watchdogs.
+       */
+
+      wd_unlock(flags);
+      flags = enter_critical_section();
       up_setpicbase(wdog->picbase);
       CALL_FUNC(func, arg);
+      leave_critical_section(flags);
+      flags = wd_lock();
+#else
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, arg);
+#endif
+    }
+
+  if (!wd_is_empty())
+    {
+      next_ticks = wd_next_expire();
     }
 
   wd_set_nested(false);
@@ -159,7 +161,7 @@ static inline_function clock_t wd_expiration(clock_t ticks)
       wd_timer_start(next_ticks, true);
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
 
   return next_ticks;
 }
@@ -169,7 +171,8 @@ static inline_function clock_t wd_expiration(clock_t ticks)
  *
  * Description:
  *   Insert the timer into the global list to ensure that
- *   the list is sorted in increasing order of expiration absolute time.
+ *   the list is sorted in increasing order of expiration absolute time,
+ *   or into the timer wheel if CONFIG_WDOG_TIMER_WHEEL is enabled.
  *
  * Input Parameters:
  *   wdog     - Watchdog ID
@@ -181,7 +184,8 @@ static inline_function clock_t wd_expiration(clock_t ticks)
  *   wdog and wdentry is not NULL.
  *
  * Returned Value:
- *   Whether the head of the watchdog list has changed.
+ *   Whether the head of the watchdog list (the next timer event) has
+ *   changed.
  *
  ****************************************************************************/
 
@@ -189,9 +193,19 @@ static inline_function
 bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *head;
+#endif
 
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  return wd_wheel_insert(wdog);
+#else
   /* Traverse the watchdog list */
 
   head = list_first_entry(&g_wdactivelist, struct wdog_s, node);
@@ -215,14 +229,10 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
 
   list_add_before(&curr->node, &wdog->node);
 
-  wdog->func = wdentry;
-  up_getpicbase(&wdog->picbase);
-  wdog->arg = arg;
-  wdog->expired = expired;
-
   /* Return whether the head of the watchdog list has changed. */
 
   return head == curr;
+#endif
 }
 
 /****************************************************************************
@@ -281,7 +291,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
        * the critical section is established.
        */
 
-      flags = enter_critical_section();
+      flags = wd_lock();
 
       /* If the wdog is canceling, restarting the wdog is not allowed. */
 
@@ -292,8 +302,7 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
-          reassess |= list_is_head(&g_wdactivelist, &wdog->node);
-          list_delete_fast(&wdog->node);
+          reassess |= wd_remove(wdog);
         }
 
       reassess |= wd_insert(wdog, ticks, wdentry, arg);
@@ -315,12 +324,12 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
-          list_delete_fast(&wdog->node);
+          wd_remove(wdog);
         }
 
       wd_insert(wdog, ticks, wdentry, arg);
 #endif
-      leave_critical_section(flags);
+      wd_unlock(flags);
       sched_note_wdog(NOTE_WDOG_START, wdentry,
                       (FAR void *)(uintptr_t)ticks);
       ret = OK;
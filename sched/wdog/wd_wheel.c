@@ -0,0 +1,406 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WD_WHEEL_SHIFT(level)    ((level) * WD_WHEEL_BITS)
+#define WD_WHEEL_INDEX(t, level) \
+  ((unsigned int)((t) >> WD_WHEEL_SHIFT(level)) & WD_WHEEL_MASK)
+
+#define WD_WHEEL_WORD(ndx)       ((ndx) >> 5)
+#define WD_WHEEL_BIT(ndx)        (UINT32_C(1) << ((ndx) & 31))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_ffs
+ *
+ * Description:
+ *   Return the first used slot at or after 'from' in the map of a level,
+ *   or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_ffs(FAR const uint32_t *map, unsigned int from)
+{
+  unsigned int ndx = WD_WHEEL_WORD(from);
+  uint32_t word;
+
+  word = map[ndx] & ~(WD_WHEEL_BIT(from) - 1);
+
+  while (word == 0)
+    {
+      if (++ndx >= WD_WHEEL_WORDS)
+        {
+          return -1;
+        }
+
+      word = map[ndx];
+    }
+
+  return (ndx << 5) + ffs(word) - 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_search
+ *
+ * Description:
+ *   Return the distance from slot 'from' to the first used slot of a level,
+ *   searching circularly, or -1 if the level is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_search(int level, unsigned int from)
+{
+  FAR const uint32_t *map = g_wdwheel.map[level];
+  int ndx;
+
+  ndx = wd_wheel_ffs(map, from);
+  if (ndx < 0)
+    {
+      ndx = wd_wheel_ffs(map, 0);
+      if (ndx < 0)
+        {
+          return -1;
+        }
+    }
+
+  return (ndx - from) & WD_WHEEL_MASK;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   File a watchdog into the slot matching its distance from the wheel
+ *   base.  Overdue watchdogs go to the slot of the base tick, those beyond
+ *   the range of the top level go to its farthest slot and are re-filed
+ *   when that slot is cascaded.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot;
+  clock_t expired = wdog->expired;
+  sclock_t delta = (sclock_t)(expired - g_wdwheel.base);
+  unsigned int ndx;
+  int level = 0;
+
+  if (delta < 0)
+    {
+      expired = g_wdwheel.base;
+      delta   = 0;
+    }
+
+  while (level < WD_WHEEL_LEVELS - 1 &&
+         (delta >> WD_WHEEL_SHIFT(level + 1)) != 0)
+    {
+      level++;
+    }
+
+  if ((delta >> WD_WHEEL_SHIFT(level)) > WD_WHEEL_MASK)
+    {
+      expired = g_wdwheel.base +
+                ((clock_t)WD_WHEEL_MASK << WD_WHEEL_SHIFT(level));
+    }
+
+  ndx  = WD_WHEEL_INDEX(expired, level);
+  slot = &g_wdwheel.slot[level][ndx];
+
+  if ((g_wdwheel.map[level][WD_WHEEL_WORD(ndx)] & WD_WHEEL_BIT(ndx)) == 0)
+    {
+      list_initialize(slot);
+      g_wdwheel.map[level][WD_WHEEL_WORD(ndx)] |= WD_WHEEL_BIT(ndx);
+    }
+
+  list_add_tail(slot, &wdog->node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-file the watchdogs of the upper level slots that start at the
+ *   current base tick into the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(void)
+{
+  FAR struct list_node *slot;
+  FAR struct wdog_s *wdog;
+  struct list_node pending;
+  clock_t base = g_wdwheel.base;
+  unsigned int ndx;
+  int level;
+
+  for (level = 1; level < WD_WHEEL_LEVELS; level++)
+    {
+      /* A slot of this level starts here only if all of the lower level
+       * indexes have wrapped around.
+       */
+
+      if ((base & (((clock_t)1 << WD_WHEEL_SHIFT(level)) - 1)) != 0)
+        {
+          break;
+        }
+
+      ndx = WD_WHEEL_INDEX(base, level);
+      if ((g_wdwheel.map[level][WD_WHEEL_WORD(ndx)] &
+           WD_WHEEL_BIT(ndx)) == 0)
+        {
+          continue;
+        }
+
+      /* Detach the slot before re-filing its watchdogs */
+
+      slot = &g_wdwheel.slot[level][ndx];
+      pending.next = slot->next;
+      pending.prev = slot->prev;
+      pending.next->prev = &pending;
+      pending.prev->next = &pending;
+      g_wdwheel.map[level][WD_WHEEL_WORD(ndx)] &= ~WD_WHEEL_BIT(ndx);
+
+      while (!list_is_empty(&pending))
+        {
+          wdog = list_first_entry(&pending, struct wdog_s, node);
+          list_delete_fast(&wdog->node);
+          wd_wheel_add(wdog);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   File an active watchdog into the timer wheel according to its
+ *   wdog->expired.
+ *
+ * Returned Value:
+ *   Whether the next timer event (see wd_wheel_next) has changed.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t next;
+
+  if (g_wdwheel.count++ == 0)
+    {
+      /* Nothing is filed relative to the old base, so bring it up to date
+       * to keep the new watchdog in the lowest possible level.
+       */
+
+      g_wdwheel.base = clock_systime_ticks();
+      wd_wheel_add(wdog);
+      return true;
+    }
+
+  next = wd_wheel_next();
+  wd_wheel_add(wdog);
+  return wd_wheel_next() != next;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Returned Value:
+ *   Whether the next timer event may have changed.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct list_node *slot = wdog->node.prev;
+  bool last = slot == wdog->node.next;
+  unsigned int ndx;
+  int level;
+
+  DEBUGASSERT(g_wdwheel.count > 0);
+
+  if (last)
+    {
+      /* The slot becomes empty, locate it from its list head */
+
+      ndx   = slot - &g_wdwheel.slot[0][0];
+      level = ndx / WD_WHEEL_SLOTS;
+      ndx  &= WD_WHEEL_MASK;
+
+      g_wdwheel.map[level][WD_WHEEL_WORD(ndx)] &= ~WD_WHEEL_BIT(ndx);
+    }
+
+  list_delete_fast(&wdog->node);
+  g_wdwheel.count--;
+  return last;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Advance the timer wheel up to 'ticks' and remove the next watchdog that
+ *   has expired by then.
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if there is none left.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  unsigned int ndx;
+  clock_t next;
+
+  while (g_wdwheel.count > 0 && clock_compare(g_wdwheel.base, ticks))
+    {
+      ndx = WD_WHEEL_INDEX(g_wdwheel.base, 0);
+      if ((g_wdwheel.map[0][WD_WHEEL_WORD(ndx)] & WD_WHEEL_BIT(ndx)) != 0)
+        {
+          wdog = list_first_entry(&g_wdwheel.slot[0][ndx],
+                                  struct wdog_s, node);
+          wd_wheel_remove(wdog);
+          return wdog;
+        }
+
+      /* Skip the ticks without any event, but never beyond 'ticks' so that
+       * the base keeps tracking the time of the last expiration.
+       */
+
+      next = wd_wheel_next();
+      g_wdwheel.base = clock_compare(next, ticks) ? next : ticks + 1;
+      wd_wheel_cascade();
+    }
+
+  if (g_wdwheel.count == 0 && clock_compare(g_wdwheel.base, ticks))
+    {
+      g_wdwheel.base = ticks + 1;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the tick of the next timer wheel event.  This is either the
+ *   exact expiration of the first watchdog or an earlier point at which a
+ *   slot of an upper level has to be cascaded.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held and the wheel not empty.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_next(void)
+{
+  clock_t base = g_wdwheel.base;
+  clock_t next = base;
+  clock_t event;
+  bool found = false;
+  unsigned int ndx;
+  int level;
+  int dist;
+
+  DEBUGASSERT(g_wdwheel.count > 0);
+
+  for (level = 0; level < WD_WHEEL_LEVELS; level++)
+    {
+      ndx = WD_WHEEL_INDEX(base, level);
+
+      if (level == 0)
+        {
+          /* Level 0 slots hold the watchdogs of one tick each */
+
+          dist = wd_wheel_search(0, ndx);
+          if (dist < 0)
+            {
+              continue;
+            }
+
+          event = base + dist;
+        }
+      else
+        {
+          /* The current slot of an upper level was cascaded when the base
+           * entered it, anything filed there is for the next round.
+           */
+
+          dist = wd_wheel_search(level, (ndx + 1) & WD_WHEEL_MASK);
+          if (dist < 0)
+            {
+              continue;
+            }
+
+          event = ((base >> WD_WHEEL_SHIFT(level)) + dist + 1) <<
+                  WD_WHEEL_SHIFT(level);
+        }
+
+      if (!found || !clock_compare(next, event))
+        {
+          next  = event;
+          found = true;
+        }
+    }
+
+  return next;
+}
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -37,6 +38,7 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_HRTIMER
 #  include <nuttx/hrtimer.h> 
@@ -46,6 +48,33 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  define WD_WHEEL_BITS     CONFIG_WDOG_TIMER_WHEEL_BITS
+#  define WD_WHEEL_LEVELS   CONFIG_WDOG_TIMER_WHEEL_LEVELS
+#  define WD_WHEEL_SLOTS    (1 << WD_WHEEL_BITS)
+#  define WD_WHEEL_MASK     (WD_WHEEL_SLOTS - 1)
+#  define WD_WHEEL_WORDS    ((WD_WHEEL_SLOTS + 31) / 32)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* Level n of the wheel has WD_WHEEL_SLOTS slots of 2^(n * WD_WHEEL_BITS)
+ * ticks each.  The slot lists are initialized lazily: a slot list is only
+ * valid while its bit is set in the map of its level.
+ */
+
+struct wd_wheel_s
+{
+  clock_t          base;   /* First tick not processed yet */
+  size_t           count;  /* Number of active watchdogs */
+  uint32_t         map[WD_WHEEL_LEVELS][WD_WHEEL_WORDS];
+  struct list_node slot[WD_WHEEL_LEVELS][WD_WHEEL_SLOTS];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -63,12 +92,20 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+extern struct wd_wheel_s g_wdwheel;
+#else
 extern struct list_node g_wdactivelist;
+#endif
 
 #ifdef CONFIG_HRTIMER
 extern struct hrtimer_s g_wdtimer;
 #endif
 
+#ifdef CONFIG_WDOG_SPINLOCK
+extern spinlock_t g_wdspinlock;
+#endif
+
 #if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
 extern bool g_wdtimernested;
 extern clock_t  g_wdexpired;
@@ -110,10 +147,90 @@ void wd_timer(clock_t ticks);
 uint64_t wd_timer(const hrtimer_t *timer, uint64_t expired);
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   File an active watchdog into the timer wheel according to its
+ *   wdog->expired.
+ *
+ * Returned Value:
+ *   Whether the next timer event (see wd_wheel_next) has changed.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_insert(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the timer wheel.
+ *
+ * Returned Value:
+ *   Whether the next timer event may have changed.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Advance the timer wheel up to 'ticks' and remove the next watchdog that
+ *   has expired by then.
+ *
+ * Returned Value:
+ *   The expired watchdog, or NULL if there is none left.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(clock_t ticks);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the tick of the next timer wheel event.  This is either the
+ *   exact expiration of the first watchdog or an earlier point at which a
+ *   slot of an upper level has to be cascaded.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held and the wheel not empty.
+ *
+ ****************************************************************************/
+
+clock_t wd_wheel_next(void);
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
 
+/* Lock protecting the active watchdog queue and the timer state above */
+
+#ifdef CONFIG_WDOG_SPINLOCK
+#  define wd_lock()                 spin_lock_irqsave(&g_wdspinlock)
+#  define wd_unlock(flags) \
+     spin_unlock_irqrestore(&g_wdspinlock, flags)
+#else
+#  define wd_lock()                 enter_critical_section()
+#  define wd_unlock(flags)          leave_critical_section(flags)
+#endif
+
 #if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
 #  define wd_in_callback()          (g_wdtimernested)
 #  define wd_set_nested(f)          (g_wdtimernested = (f))
@@ -194,11 +311,47 @@ static inline_function void wd_timer_cancel(void)
 #  define wd_timer_cancel()
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  define wd_is_empty()     (g_wdwheel.count == 0)
+#  define wd_next_expire()  wd_wheel_next()
+#  define wd_remove(wdog)   wd_wheel_remove(wdog)
+#  define wd_expired(ticks) wd_wheel_expired(ticks)
+#else
+#  define wd_is_empty()     list_is_empty(&g_wdactivelist)
+
 static inline_function clock_t wd_next_expire(void)
 {
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
 }
 
+static inline_function bool wd_remove(FAR struct wdog_s *wdog)
+{
+  bool head = list_is_head(&g_wdactivelist, &wdog->node);
+
+  list_delete_fast(&wdog->node);
+  return head;
+}
+
+static inline_function FAR struct wdog_s *wd_expired(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+
+  if (list_is_empty(&g_wdactivelist))
+    {
+      return NULL;
+    }
+
+  wdog = list_first_entry(&g_wdactivelist, struct wdog_s, node);
+  if (!clock_compare(wdog->expired, ticks))
+    {
+      return NULL;
+    }
+
+  list_delete_fast(&wdog->node);
+  return wdog;
+}
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -206,14 +359,14 @@ static inline_function clock_t wd_next_expire(void)
 static inline_function clock_t wd_get_next_expire(clock_t curr)
 {
   clock_t     next = curr;
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags = wd_lock();
 
-  if (!list_is_empty(&g_wdactivelist))
+  if (!wd_is_empty())
     {
       next = wd_next_expire();
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return (sclock_t)(next - curr) <= 0 ? 0u : next;
 }
 
@@ -132,6 +132,13 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
 
 int work_cancel(int qid, FAR struct work_s *work)
 {
+#ifdef CONFIG_SCHED_ISRWORK
+  if (qid == ISRWORK)
+    {
+      return work_isr_cancel(work, false);
+    }
+#endif
+
   return work_qcancel(work_qid2wq(qid), false, work);
 }
 
@@ -165,6 +172,13 @@ int work_cancel_wq(FAR struct kwork_wqueue_s *wqueue,
 
 int work_cancel_sync(int qid, FAR struct work_s *work)
 {
+#ifdef CONFIG_SCHED_ISRWORK
+  if (qid == ISRWORK)
+    {
+      return work_isr_cancel(work, true);
+    }
+#endif
+
   return work_qcancel(work_qid2wq(qid), true, work);
 }
 
@@ -0,0 +1,330 @@
+/****************************************************************************
+ * sched/wqueue/kwork_isr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/list.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_ISRWORK
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The interrupt context work queue has no worker thread.  The expired work
+ * is run by whichever CPU leaves an interrupt handler next, on the
+ * interrupt stack of that CPU.
+ */
+
+struct isr_wqueue_s
+{
+  struct kwork_wqueue_s wq;
+
+  /* The work being run by each CPU, NULL if none */
+
+  FAR struct work_s * volatile running[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct isr_wqueue_s g_isrwork =
+{
+  {
+    LIST_INITIAL_VALUE(g_isrwork.wq.expired),
+    LIST_INITIAL_VALUE(g_isrwork.wq.pending),
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void work_isr_timer(wdparm_t arg);
+
+/****************************************************************************
+ * Name: work_isr_retimer
+ *
+ * Description:
+ *   Restart the timer for the earliest pending work.  Called with the
+ *   queue lock held.
+ *
+ ****************************************************************************/
+
+static void work_isr_retimer(void)
+{
+  FAR struct kwork_wqueue_s *wq = &g_isrwork.wq;
+  FAR struct work_s *work;
+
+  if (!list_is_empty(&wq->pending))
+    {
+      work = list_first_entry(&wq->pending, struct work_s, node);
+      wd_start_abstick(&wq->timer, work->qtime, work_isr_timer, 0);
+    }
+  else
+    {
+      wd_cancel(&wq->timer);
+    }
+}
+
+/****************************************************************************
+ * Name: work_isr_timer
+ *
+ * Description:
+ *   Move the pending work that has expired to the expired list and run
+ *   it, the timer callback already runs on the interrupt stack.
+ *
+ ****************************************************************************/
+
+static void work_isr_timer(wdparm_t arg)
+{
+  FAR struct kwork_wqueue_s *wq = &g_isrwork.wq;
+  FAR struct work_s *work;
+  FAR struct work_s *next;
+  irqstate_t flags;
+  clock_t ticks;
+
+  flags = spin_lock_irqsave(&wq->lock);
+  ticks = clock_systime_ticks();
+
+  list_for_every_entry_safe(&wq->pending, work, next, struct work_s, node)
+    {
+      if (!clock_compare(work->qtime, ticks))
+        {
+          wd_start_abstick(&wq->timer, work->qtime, work_isr_timer, 0);
+          break;
+        }
+
+      list_delete(&work->node);
+      list_add_tail(&wq->expired, &work->node);
+    }
+
+  spin_unlock_irqrestore(&wq->lock, flags);
+
+  work_isr_dispatch();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_isr_queue
+ *
+ * Description:
+ *   Queue work on the interrupt context work queue.  Work queued with no
+ *   delay from an interrupt handler runs when the handler returns, other
+ *   work runs from the timer interrupt once its time has come.
+ *
+ * Input Parameters:
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked in interrupt context
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked.
+ *   next   - True to count the delay from the last expiration time, as
+ *            work_queue_next() does.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_isr_queue(FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay, bool next)
+{
+  FAR struct kwork_wqueue_s *wq = &g_isrwork.wq;
+  irqstate_t flags;
+  bool retimer = false;
+
+  if (work == NULL || worker == NULL || delay > WDOG_MAX_DELAY)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&wq->lock);
+
+  if (next)
+    {
+      work->qtime += delay;
+    }
+  else
+    {
+      retimer = work_available(work) ? false : work_remove(wq, work);
+      work->qtime = delay ? clock_delay2abstick(delay) :
+                            clock_systime_ticks();
+    }
+
+  work->worker = worker;
+  work->arg    = arg;
+
+  if (delay == 0 && up_interrupt_context())
+    {
+      /* Run when the current interrupt handler returns */
+
+      list_add_tail(&wq->expired, &work->node);
+    }
+  else if (work_insert_pending(wq, work))
+    {
+      /* Work queued from a thread has to wait for the timer interrupt,
+       * even if no delay was requested.
+       */
+
+      retimer = false;
+      wd_start_abstick(&wq->timer, work->qtime, work_isr_timer, 0);
+    }
+
+  if (retimer)
+    {
+      work_isr_retimer();
+    }
+
+  spin_unlock_irqrestore(&wq->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_isr_cancel
+ *
+ * Description:
+ *   Remove work from the interrupt context work queue.  If sync is true
+ *   and the work is running on another CPU, wait for it to complete.
+ *
+ ****************************************************************************/
+
+int work_isr_cancel(FAR struct work_s *work, bool sync)
+{
+  FAR struct kwork_wqueue_s *wq = &g_isrwork.wq;
+  irqstate_t flags;
+#ifdef CONFIG_SMP
+  int cpu;
+#endif
+
+  if (work == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&wq->lock);
+
+  if (!work_available(work) && work_remove(wq, work))
+    {
+      work_isr_retimer();
+    }
+
+  spin_unlock_irqrestore(&wq->lock, flags);
+
+#ifdef CONFIG_SMP
+  /* The work runs to completion, so spinning for it to finish is short.
+   * On this CPU it has either completed or is the caller itself.
+   */
+
+  if (sync)
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          while (cpu != this_cpu() && g_isrwork.running[cpu] == work)
+            {
+              up_udelay(1);
+            }
+        }
+    }
+#else
+  UNUSED(sync);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_isr_dispatch
+ *
+ * Description:
+ *   Run the expired work of the interrupt context work queue.  This is
+ *   called on the way out of each interrupt handler.  A nested handler
+ *   leaves the work to the outer one, so the interrupt stack only ever
+ *   holds one worker frame per CPU.
+ *
+ ****************************************************************************/
+
+void work_isr_dispatch(void)
+{
+  FAR struct kwork_wqueue_s *wq = &g_isrwork.wq;
+  FAR struct work_s *work;
+  irqstate_t flags;
+  worker_t worker;
+  FAR void *arg;
+  int cpu;
+
+  /* Peek without the lock, work queued behind our back is caught by the
+   * next interrupt.
+   */
+
+  if (list_is_empty(&wq->expired))
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&wq->lock);
+  cpu   = this_cpu();
+
+  if (g_isrwork.running[cpu] == NULL)
+    {
+      while (!list_is_empty(&wq->expired))
+        {
+          work = list_first_entry(&wq->expired, struct work_s, node);
+          list_delete(&work->node);
+
+          worker       = work->worker;
+          arg          = work->arg;
+          work->worker = NULL;
+
+          g_isrwork.running[cpu] = work;
+          spin_unlock_irqrestore(&wq->lock, flags);
+
+          worker(arg);
+
+          flags = spin_lock_irqsave(&wq->lock);
+          g_isrwork.running[cpu] = NULL;
+        }
+    }
+
+  spin_unlock_irqrestore(&wq->lock, flags);
+}
+
+#endif /* CONFIG_SCHED_ISRWORK */
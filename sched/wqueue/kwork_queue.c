@@ -35,6 +35,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/list.h>
 #include <nuttx/wqueue.h>
+#include <nuttx/sched.h>
 
 #include "wqueue/wqueue.h"
 
@@ -121,6 +122,13 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
 int work_queue_next(int qid, FAR struct work_s *work, worker_t worker,
                     FAR void *arg, clock_t delay)
 {
+#ifdef CONFIG_SCHED_ISRWORK
+  if (qid == ISRWORK)
+    {
+      return work_isr_queue(work, worker, arg, delay, true);
+    }
+#endif
+
   return work_queue_next_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
@@ -226,7 +234,90 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
+#ifdef CONFIG_SCHED_ISRWORK
+  if (qid == ISRWORK)
+    {
+      return work_isr_queue(work, worker, arg, delay, false);
+    }
+#endif
+
   return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
+/****************************************************************************
+ * Name: work_queue_on
+ *
+ * Description:
+ *   Queue work on the high priority work queue of a CPU, so that it is
+ *   performed by a worker thread bound to that CPU.  If the worker of that
+ *   CPU is busy with a backlog, the work is queued on the shared HPWORK
+ *   queue instead.  Without CONFIG_SCHED_HPWORK_PERCPU the work always goes
+ *   to HPWORK.
+ *
+ *   Unlike work_queue(), the work must not be pending on any queue, since
+ *   it may not end up on the same queue as last time.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU to perform the work on, or -1 for the current CPU
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   The ID of the work queue that the work was queued on (CPUWORK(cpu) or
+ *   HPWORK), to be used with work_cancel(), on success.  A negated errno
+ *   value on failure:  -EBUSY if the work is still pending.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK
+int work_queue_on(int cpu, FAR struct work_s *work, worker_t worker,
+                  FAR void *arg, clock_t delay)
+{
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  FAR struct kwork_wqueue_s *wqueue;
+  FAR struct kworker_s *kworker;
+#endif
+  int qid = HPWORK;
+  int ret;
+
+  if (work == NULL || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  if (!work_available(work))
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (cpu < 0)
+    {
+      cpu = this_cpu();
+    }
+
+  /* The worker of the CPU is saturated if it is running some work and
+   * more work is already waiting for it.  This is only a hint, so no lock
+   * is needed.
+   */
+
+  wqueue  = work_qid2wq(CPUWORK(cpu));
+  kworker = wq_get_worker(wqueue);
+
+  if (kworker->work == NULL || list_is_empty(&wqueue->expired))
+    {
+      qid = CPUWORK(cpu);
+    }
+#endif
+
+  ret = work_queue(qid, work, worker, arg, delay);
+  return ret < 0 ? ret : qid;
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
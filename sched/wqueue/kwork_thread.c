@@ -95,6 +95,14 @@ struct hp_wqueue_s g_hpwork =
 
 #endif /* CONFIG_SCHED_HPWORK */
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues.  These are
+ * initialized by work_start_highpri().
+ */
+
+struct hp_cpu_wqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 #if defined(CONFIG_SCHED_LPWORK)
 /* The state of the kernel mode, low priority work queue(s). */
 
@@ -351,6 +359,70 @@ static int work_thread_create(FAR const char *name, int priority,
   return OK;
 }
 
+/****************************************************************************
+ * Name: work_start_cpu
+ *
+ * Description:
+ *   Initialize the per-CPU high priority work queues and start their worker
+ *   threads, each one bound to its CPU.
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+static int work_start_cpu(void)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  FAR struct kworker_s *kworker;
+  cpu_set_t cpuset;
+  char name[32];
+  int cpu;
+  int ret;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      wqueue  = (FAR struct kwork_wqueue_s *)&g_hpcpuwork[cpu];
+      kworker = wq_get_worker(wqueue);
+
+      list_initialize(&wqueue->expired);
+      list_initialize(&wqueue->pending);
+      nxsem_init(&wqueue->sem, 0, 0);
+      nxsem_init(&wqueue->exsem, 0, 0);
+      spin_lock_init(&wqueue->lock);
+      wqueue->nthreads = 1;
+
+      snprintf(name, sizeof(name), HPCPUWORKNAME, cpu);
+
+      /* Bind the worker to its CPU before it gets a chance to run */
+
+      sched_lock();
+      ret = work_thread_create(name, CONFIG_SCHED_HPWORKPRIORITY, NULL,
+                               CONFIG_SCHED_HPWORKSTACKSIZE, wqueue);
+      if (ret >= 0)
+        {
+          CPU_ZERO(&cpuset);
+          CPU_SET(cpu, &cpuset);
+          ret = nxsched_set_affinity(kworker->pid, sizeof(cpuset),
+                                     &cpuset);
+        }
+
+      sched_unlock();
+
+      if (ret < 0)
+        {
+          serr("ERROR: Failed to start the worker of CPU%d: %d\n",
+               cpu, ret);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -554,6 +626,8 @@ int work_queue_priority(int qid)
 #ifdef CONFIG_SCHED_HPWORK
 int work_start_highpri(void)
 {
+  int ret;
+
   /* Start the high-priority, kernel mode worker thread(s) */
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
@@ -563,16 +637,25 @@ int work_start_highpri(void)
                               [CONFIG_SCHED_HPWORKSTACKSIZE]
   locate_data(CONFIG_SCHED_HPWORKSTACKSECTION);
 
-  return work_thread_create(HPWORKNAME,
-                            CONFIG_SCHED_HPWORKPRIORITY,
-                            hp_work_stack,
-                            CONFIG_SCHED_HPWORKSTACKSIZE,
-                            (FAR struct kwork_wqueue_s *)&g_hpwork);
+  ret = work_thread_create(HPWORKNAME,
+                           CONFIG_SCHED_HPWORKPRIORITY,
+                           hp_work_stack,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           (FAR struct kwork_wqueue_s *)&g_hpwork);
 #else
-  return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, NULL,
-                            CONFIG_SCHED_HPWORKSTACKSIZE,
-                            (FAR struct kwork_wqueue_s *)&g_hpwork);
+  ret = work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, NULL,
+                           CONFIG_SCHED_HPWORKSTACKSIZE,
+                           (FAR struct kwork_wqueue_s *)&g_hpwork);
 #endif
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (ret >= 0)
+    {
+      ret = work_start_cpu();
+    }
+#endif
+
+  return ret;
 }
 #endif /* CONFIG_SCHED_HPWORK */
 
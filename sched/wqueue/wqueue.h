@@ -46,6 +46,7 @@
 /* Kernel thread names */
 
 #define HPWORKNAME "hpwork"
+#define HPCPUWORKNAME "hpwork%d"
 #define LPWORKNAME "lpwork"
 
 /* Get the worker structure from the work queue.
@@ -98,6 +99,21 @@ struct hp_wqueue_s
 };
 #endif
 
+/* This structure defines the state of the high-priority work queue of one
+ * CPU.  This structure must be cast-compatible with kwork_wqueue_s.
+ */
+
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+struct hp_cpu_wqueue_s
+{
+  struct kwork_wqueue_s wq;
+
+  /* The single worker thread, bound to the CPU */
+
+  struct kworker_s      worker[1];
+};
+#endif
+
 /* This structure defines the state of one low-priority work queue.  This
  * structure must be cast compatible with kwork_wqueue_s
  */
@@ -123,6 +139,12 @@ struct lp_wqueue_s
 extern struct hp_wqueue_s g_hpwork;
 #endif
 
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+/* The state of the per-CPU, high priority work queues. */
+
+extern struct hp_cpu_wqueue_s g_hpcpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_SCHED_LPWORK
 /* The state of the kernel mode, low priority work queue(s). */
 
@@ -148,6 +170,13 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
       return (FAR struct kwork_wqueue_s *)&g_lpwork;
     }
   else
+#endif
+#ifdef CONFIG_SCHED_HPWORK_PERCPU
+  if (qid >= CPUWORK(0) && qid < CPUWORK(CONFIG_SMP_NCPUS))
+    {
+      return (FAR struct kwork_wqueue_s *)&g_hpcpuwork[qid - CPUWORK(0)];
+    }
+  else
 #endif
     {
       return NULL;
@@ -338,5 +367,22 @@ int work_start_lowpri(void);
 void work_initialize_notifier(void);
 #endif
 
+/****************************************************************************
+ * Name: work_isr_queue, work_isr_cancel and work_isr_dispatch
+ *
+ * Description:
+ *   The interrupt context work queue behind ISRWORK.  work_queue(),
+ *   work_queue_next() and work_cancel() redirect to the first two,
+ *   irq_dispatch() calls work_isr_dispatch() when a handler returns.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_ISRWORK
+int work_isr_queue(FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay, bool next);
+int work_isr_cancel(FAR struct work_s *work, bool sync);
+void work_isr_dispatch(void);
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
 #endif /* __SCHED_WQUEUE_WQUEUE_H */
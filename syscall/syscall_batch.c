@@ -0,0 +1,113 @@
+/****************************************************************************
+ * syscall/syscall_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+#include <syscall.h>
+
+/* The batch runs in the kernel phase of the build, next to the stubs */
+
+#if defined(CONFIG_LIB_SYSCALL) && defined(CONFIG_SYSCALL_BATCH)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Every stub is called with all parameters, as the trap handlers do.  The
+ * stubs taking fewer parameters ignore the rest.
+ */
+
+typedef CODE uintptr_t (*syscall_stub_t)(int nbr, uintptr_t parm1,
+                                         uintptr_t parm2, uintptr_t parm3,
+                                         uintptr_t parm4, uintptr_t parm5,
+                                         uintptr_t parm6);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syscall_batch
+ *
+ * Description:
+ *   Perform a list of system calls with a single entry into the kernel.
+ *   The calls are made in order and the return value of each one is
+ *   stored in its result field.  Calls that fail set errno as usual, so
+ *   errno reflects the last failing call.
+ *
+ * Input Parameters:
+ *   calls  - The calls to make
+ *   ncalls - The number of calls
+ *
+ * Returned Value:
+ *   The number of calls made.  ERROR is returned with errno set to EINVAL,
+ *   and no call is made, if the list contains an invalid system call
+ *   number or syscall_batch() itself.
+ *
+ ****************************************************************************/
+
+int syscall_batch(FAR struct syscall_batch_s *calls, int ncalls)
+{
+  FAR struct syscall_batch_s *call;
+  syscall_stub_t stub;
+  int i;
+
+  if (calls == NULL || ncalls < 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* Check the whole list first so that a bad entry makes no partial batch */
+
+  for (i = 0; i < ncalls; i++)
+    {
+      if (calls[i].nbr < CONFIG_SYS_RESERVED ||
+          calls[i].nbr >= SYS_maxsyscall ||
+          calls[i].nbr == SYS_syscall_batch)
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+    }
+
+  for (i = 0; i < ncalls; i++)
+    {
+      call = &calls[i];
+      stub = (syscall_stub_t)
+        g_stublookup[call->nbr - CONFIG_SYS_RESERVED];
+
+      call->result = stub(call->nbr, call->parm[0], call->parm[1],
+                          call->parm[2], call->parm[3], call->parm[4],
+                          call->parm[5]);
+    }
+
+  return ncalls;
+}
+
+#endif /* CONFIG_LIB_SYSCALL && CONFIG_SYSCALL_BATCH */
@@ -374,6 +374,7 @@ static const char *g_white_content_list[] =
   "RMDIR3resok",
   "READDIR3args",
   "READDIR3resok",
+  "READDIRPLUS3args",
   "SETATTR3args",
   "SETATTR3resok",
   "FS3args",
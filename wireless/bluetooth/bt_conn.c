@@ -141,30 +141,34 @@ static int conn_tx_kthread(int argc, FAR char *argv[])
 
   while (conn->state == BT_CONN_CONNECTED)
     {
-      /* Wait until the controller can accept ACL packets */
-
-      wlinfo("calling nxsem_wait_uninterruptible()\n");
+      /* Get next ACL packet for connection.  The controller buffer credit
+       * is only taken once there is a packet to send, an idle connection
+       * must not hold a credit that another connection could use.
+       */
 
-      ret = nxsem_wait_uninterruptible(&g_btdev.le_pkts_sem);
-      if (ret < 0)
-        {
-          wlerr("nxsem_wait_uninterruptible() failed: %d\n", ret);
-          break;
-        }
+      ret = bt_queue_receive(&conn->tx_queue, &buf);
+      DEBUGASSERT(ret >= 0 && buf != NULL);
+      UNUSED(ret);
 
       /* Check for disconnection */
 
       if (conn->state != BT_CONN_CONNECTED)
         {
-          nxsem_post(&g_btdev.le_pkts_sem);
+          bt_buf_release(buf);
           break;
         }
 
-      /* Get next ACL packet for connection */
+      /* Wait until the controller can accept ACL packets */
 
-      ret = bt_queue_receive(&conn->tx_queue, &buf);
-      DEBUGASSERT(ret >= 0 && buf != NULL);
-      UNUSED(ret);
+      wlinfo("calling nxsem_wait_uninterruptible()\n");
+
+      ret = nxsem_wait_uninterruptible(&g_btdev.le_pkts_sem);
+      if (ret < 0)
+        {
+          wlerr("nxsem_wait_uninterruptible() failed: %d\n", ret);
+          bt_buf_release(buf);
+          break;
+        }
 
       if (conn->state != BT_CONN_CONNECTED)
         {
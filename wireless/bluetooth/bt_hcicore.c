@@ -116,6 +116,16 @@ static FAR struct bt_bufferlist_s g_hp_rxlist;
 static struct work_s g_lp_work;
 static struct work_s g_hp_work;
 
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+/* Received ACL packets consumed but not yet reported to the controller.
+ * The reports are deferred while hci_rx_work() is processing a batch.
+ */
+
+static struct bt_hci_handle_count_s g_completed[CONFIG_BLUETOOTH_MAX_CONN];
+static spinlock_t g_completed_lock;
+static bool g_completed_defer;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -1069,6 +1079,65 @@ static int hci_tx_kthread(int argc, FAR char *argv[])
   return EXIT_SUCCESS;
 }
 
+/****************************************************************************
+ * Name: hci_completed_flush
+ *
+ * Description:
+ *   Report all pending completed ACL packets in one Host Number Of
+ *   Completed Packets command.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+static void hci_completed_flush(void)
+{
+  FAR struct bt_hci_cp_host_num_completed_packets_s *cp;
+  FAR struct bt_hci_handle_count_s *hc;
+  struct bt_hci_handle_count_s h[CONFIG_BLUETOOTH_MAX_CONN];
+  FAR struct bt_buf_s *buf;
+  irqstate_t flags;
+  int nhandles = 0;
+  int i;
+
+  flags = spin_lock_irqsave(&g_completed_lock);
+  for (i = 0; i < CONFIG_BLUETOOTH_MAX_CONN; i++)
+    {
+      if (g_completed[i].count > 0)
+        {
+          h[nhandles++]        = g_completed[i];
+          g_completed[i].count = 0;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_completed_lock, flags);
+
+  if (nhandles == 0)
+    {
+      return;
+    }
+
+  buf = bt_hci_cmd_create(BT_HCI_OP_HOST_NUM_COMPLETED_PACKETS,
+                          sizeof(*cp) + nhandles * sizeof(*hc));
+  if (buf == NULL)
+    {
+      wlerr("ERROR: Unable to allocate new HCI command\n");
+      return;
+    }
+
+  cp              = bt_buf_extend(buf, sizeof(*cp));
+  cp->num_handles = nhandles;
+
+  for (i = 0; i < nhandles; i++)
+    {
+      hc          = bt_buf_extend(buf, sizeof(*hc));
+      hc->handle  = BT_HOST2LE16(h[i].handle);
+      hc->count   = BT_HOST2LE16(h[i].count);
+    }
+
+  bt_hci_cmd_send(BT_HCI_OP_HOST_NUM_COMPLETED_PACKETS, buf);
+}
+#endif
+
 /****************************************************************************
  * Name: hci_rx_work
  *
@@ -1088,10 +1157,21 @@ static void hci_rx_work(FAR void *arg)
 {
   FAR struct bt_bufferlist_s *list = (FAR struct bt_bufferlist_s *)arg;
   FAR struct bt_buf_s *buf;
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+  irqstate_t flags;
+#endif
 
   wlinfo("list %p\n", list);
   DEBUGASSERT(list != NULL);
 
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+  /* Report the ACL packets consumed during this batch together */
+
+  flags = spin_lock_irqsave(&g_completed_lock);
+  g_completed_defer = true;
+  spin_unlock_irqrestore(&g_completed_lock, flags);
+#endif
+
   while ((buf = bt_dequeue_bufwork(list)) != NULL)
     {
       wlinfo("buf %p type %u len %u\n", buf, buf->type, buf->len);
@@ -1118,6 +1198,14 @@ static void hci_rx_work(FAR void *arg)
 #endif
       bt_buf_release(buf);
     }
+
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+  flags = spin_lock_irqsave(&g_completed_lock);
+  g_completed_defer = false;
+  spin_unlock_irqrestore(&g_completed_lock, flags);
+
+  hci_completed_flush();
+#endif
 }
 
 /****************************************************************************
@@ -1655,6 +1743,9 @@ int bt_initialize(void)
 
   spin_lock_init(&g_hp_rxlist.lock);
   spin_lock_init(&g_lp_rxlist.lock);
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+  spin_lock_init(&g_completed_lock);
+#endif
 
   DEBUGASSERT(btdev != NULL);
   bt_buf_initialize();
@@ -1959,6 +2050,60 @@ int bt_hci_cmd_send(uint16_t opcode, FAR struct bt_buf_s *buf)
   return ret;
 }
 
+/****************************************************************************
+ * Name: bt_hci_acl_completed
+ *
+ * Description:
+ *   Count a consumed ACL packet of a connection.  The count is reported
+ *   right away, or at the end of the batch if hci_rx_work() is running.
+ *
+ ****************************************************************************/
+
+void bt_hci_acl_completed(uint16_t handle)
+{
+  FAR struct bt_hci_handle_count_s *hc;
+  irqstate_t flags;
+  bool defer;
+  int i;
+
+  for (; ; )
+    {
+      hc    = NULL;
+      flags = spin_lock_irqsave(&g_completed_lock);
+      for (i = 0; i < CONFIG_BLUETOOTH_MAX_CONN; i++)
+        {
+          if (g_completed[i].count > 0 && g_completed[i].handle == handle)
+            {
+              hc = &g_completed[i];
+              break;
+            }
+          else if (g_completed[i].count == 0 && hc == NULL)
+            {
+              hc = &g_completed[i];
+            }
+        }
+
+      if (hc != NULL)
+        {
+          hc->handle = handle;
+          hc->count++;
+          defer = g_completed_defer;
+          spin_unlock_irqrestore(&g_completed_lock, flags);
+          break;
+        }
+
+      /* All slots hold counts of other handles, report them first */
+
+      spin_unlock_irqrestore(&g_completed_lock, flags);
+      hci_completed_flush();
+    }
+
+  if (!defer)
+    {
+      hci_completed_flush();
+    }
+}
+
 int bt_hci_cmd_send_sync(uint16_t opcode, FAR struct bt_buf_s *buf,
                          FAR struct bt_buf_s **rsp)
 {
@@ -350,6 +350,13 @@ FAR struct bt_buf_s *bt_hci_cmd_create(uint16_t opcode, uint8_t param_len);
 /* Send HCI commands */
 
 int bt_hci_cmd_send(uint16_t opcode, FAR struct bt_buf_s *buf);
+
+/* Report a received ACL packet as consumed with Host Number Of Completed
+ * Packets.  The reports of one batch of received packets are merged into
+ * a single command.
+ */
+
+void bt_hci_acl_completed(uint16_t handle);
 int bt_hci_cmd_send_sync(uint16_t opcode, FAR struct bt_buf_s *buf,
                          FAR struct bt_buf_s **rsp);
 